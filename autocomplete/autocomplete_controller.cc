@@ -4,6 +4,7 @@
 
 #include "chrome/browser/autocomplete/autocomplete_controller.h"
 
+#include <algorithm>
 #include <set>
 #include <string>
 
@@ -127,10 +128,33 @@ bool IsTrivialAutocompletion(const AutocompleteMatch& match) {
       match.type == AutocompleteMatchType::SEARCH_OTHER_ENGINE;
 }
 
+// Adds |time| to the per-provider latency histogram |prefix| + |provider|.
+void RecordProviderTime(const std::string& prefix,
+                        const AutocompleteProvider* provider,
+                        base::TimeDelta time) {
+  base::HistogramBase* counter = base::Histogram::FactoryGet(
+      prefix + provider->GetName(), 1, 5000, 20,
+      base::Histogram::kUmaTargetedHistogramFlag);
+  counter->Add(static_cast<int>(time.InMilliseconds()));
+}
+
+// Records whether |provider| had to be stopped at its deadline.
+void RecordProviderDeadlineExceeded(const AutocompleteProvider* provider,
+                                    bool exceeded) {
+  base::HistogramBase* counter = base::BooleanHistogram::FactoryGet(
+      std::string("Omnibox.ProviderDeadlineExceeded.") + provider->GetName(),
+      base::Histogram::kUmaTargetedHistogramFlag);
+  counter->AddBoolean(exceeded);
+}
+
 }  // namespace
 
 const int AutocompleteController::kNoItemSelected = -1;
 
+AutocompleteController::ProviderTiming::ProviderTiming()
+    : running_async(false) {
+}
+
 AutocompleteController::AutocompleteController(
     Profile* profile,
     AutocompleteControllerDelegate* delegate,
@@ -234,25 +258,31 @@ void AutocompleteController::Start(const AutocompleteInput& input) {
 
   expire_timer_.Stop();
   stop_timer_.Stop();
+  provider_deadline_timer_.Stop();
+
+  OmniboxFieldTrial::ProviderDeadlinesMs deadlines;
+  OmniboxFieldTrial::GetProviderDeadlines(input_.current_page_classification(),
+                                          &deadlines);
 
   // Start the new query.
   in_zero_suggest_ = false;
   in_start_ = true;
+  provider_timings_.assign(providers_.size(), ProviderTiming());
   base::TimeTicks start_time = base::TimeTicks::Now();
-  for (ACProviders::iterator i(providers_.begin()); i != providers_.end();
-       ++i) {
-    // TODO(mpearson): Remove timing code once bugs 178705 / 237703 / 168933
-    // are resolved.
-    base::TimeTicks provider_start_time = base::TimeTicks::Now();
-    (*i)->Start(input_, minimal_changes);
+  for (size_t i = 0; i < providers_.size(); ++i) {
+    AutocompleteProvider* provider = providers_[i];
+    ProviderTiming& timing = provider_timings_[i];
+    timing.start_time = base::TimeTicks::Now();
+    provider->Start(input_, minimal_changes);
     if (input.matches_requested() != AutocompleteInput::ALL_MATCHES)
-      DCHECK((*i)->done());
-    base::TimeTicks provider_end_time = base::TimeTicks::Now();
-    std::string name = std::string("Omnibox.ProviderTime.") + (*i)->GetName();
-    base::HistogramBase* counter = base::Histogram::FactoryGet(
-        name, 1, 5000, 20, base::Histogram::kUmaTargetedHistogramFlag);
-    counter->Add(static_cast<int>(
-        (provider_end_time - provider_start_time).InMilliseconds()));
+      DCHECK(provider->done());
+    RecordProviderTime("Omnibox.ProviderTime.", provider,
+                       base::TimeTicks::Now() - timing.start_time);
+    timing.running_async = !provider->done();
+    OmniboxFieldTrial::ProviderDeadlinesMs::const_iterator deadline(
+        deadlines.find(provider->type()));
+    if (deadline != deadlines.end())
+      timing.deadline = base::TimeDelta::FromMilliseconds(deadline->second);
   }
   if (input.matches_requested() == AutocompleteInput::ALL_MATCHES &&
       (input.text().length() < 6)) {
@@ -283,6 +313,7 @@ void AutocompleteController::Start(const AutocompleteInput& input) {
   if (!done_) {
     StartExpireTimer();
     StartStopTimer();
+    StartProviderDeadlineTimer();
   }
 }
 
@@ -294,6 +325,9 @@ void AutocompleteController::Stop(bool clear_result) {
 
   expire_timer_.Stop();
   stop_timer_.Stop();
+  provider_deadline_timer_.Stop();
+  for (size_t i = 0; i < provider_timings_.size(); ++i)
+    provider_timings_[i].running_async = false;
   done_ = true;
   if (clear_result && !result_.empty()) {
     result_.Reset();
@@ -349,6 +383,7 @@ void AutocompleteController::OnProviderUpdate(bool updated_matches) {
     UpdateAssistedQueryStats(&result_);
     NotifyChanged(true);
   } else {
+    RecordAsyncProviderCompletions();
     CheckIfDone();
     // Multiple providers may provide synchronous results, so we only update the
     // results if we're not in Start().
@@ -445,6 +480,14 @@ void AutocompleteController::UpdateResult(
     result_.CopyOldMatches(input_, last_result, profile_);
   }
 
+  // Updates that are neither forced nor regenerating come from providers
+  // finishing after Start() has already shown the result.  Optionally keep
+  // what was shown in place and merge the late matches in below it.
+  if (!regenerate_result && !force_notify_default_match_changed &&
+      OmniboxFieldTrial::KeepVisibleOrder(
+          input_.current_page_classification()))
+    result_.KeepVisibleOrder(input_, last_result);
+
   UpdateKeywordDescriptions(&result_);
   UpdateAssociatedKeywords(&result_);
   UpdateAssistedQueryStats(&result_);
@@ -626,6 +669,60 @@ void AutocompleteController::StartExpireTimer() {
                         this, &AutocompleteController::ExpireCopiedEntries);
 }
 
+void AutocompleteController::RecordAsyncProviderCompletions() {
+  const base::TimeTicks now = base::TimeTicks::Now();
+  for (size_t i = 0; i < provider_timings_.size(); ++i) {
+    ProviderTiming& timing = provider_timings_[i];
+    if (!timing.running_async || !providers_[i]->done())
+      continue;
+    timing.running_async = false;
+    RecordProviderTime("Omnibox.ProviderAsyncTime.", providers_[i],
+                       now - timing.start_time);
+    if (timing.deadline != base::TimeDelta())
+      RecordProviderDeadlineExceeded(providers_[i], false);
+  }
+}
+
+void AutocompleteController::StartProviderDeadlineTimer() {
+  provider_deadline_timer_.Stop();
+  base::TimeTicks earliest_deadline;
+  for (size_t i = 0; i < provider_timings_.size(); ++i) {
+    const ProviderTiming& timing = provider_timings_[i];
+    if (!timing.running_async || (timing.deadline == base::TimeDelta()))
+      continue;
+    const base::TimeTicks deadline = timing.start_time + timing.deadline;
+    if (earliest_deadline.is_null() || (deadline < earliest_deadline))
+      earliest_deadline = deadline;
+  }
+  if (earliest_deadline.is_null())
+    return;
+  provider_deadline_timer_.Start(
+      FROM_HERE,
+      std::max(earliest_deadline - base::TimeTicks::Now(), base::TimeDelta()),
+      this, &AutocompleteController::OnProviderDeadline);
+}
+
+void AutocompleteController::OnProviderDeadline() {
+  RecordAsyncProviderCompletions();
+  const base::TimeTicks now = base::TimeTicks::Now();
+  for (size_t i = 0; i < provider_timings_.size(); ++i) {
+    ProviderTiming& timing = provider_timings_[i];
+    if (!timing.running_async || (timing.deadline == base::TimeDelta()) ||
+        (timing.start_time + timing.deadline > now))
+      continue;
+    timing.running_async = false;
+    RecordProviderDeadlineExceeded(providers_[i], true);
+    providers_[i]->Stop(false);
+  }
+  // The stopped providers' matches so far are already in |result_|; only
+  // let observers know if that completed the query.
+  CheckIfDone();
+  if (done_)
+    UpdateResult(false, false);
+  else
+    StartProviderDeadlineTimer();
+}
+
 void AutocompleteController::StartStopTimer() {
   if (!in_stop_timer_field_trial_)
     return;
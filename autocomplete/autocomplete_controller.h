@@ -5,6 +5,8 @@
 #ifndef CHROME_BROWSER_AUTOCOMPLETE_AUTOCOMPLETE_CONTROLLER_H_
 #define CHROME_BROWSER_AUTOCOMPLETE_AUTOCOMPLETE_CONTROLLER_H_
 
+#include <vector>
+
 #include "base/basictypes.h"
 #include "base/compiler_specific.h"
 #include "base/gtest_prod_util.h"
@@ -186,6 +188,29 @@ class AutocompleteController : public AutocompleteProviderListener {
   // Starts |stop_timer_|.
   void StartStopTimer();
 
+  // Records the async latency of every provider that has finished since the
+  // last call.
+  void RecordAsyncProviderCompletions();
+
+  // Starts |provider_deadline_timer_| for the earliest deadline among the
+  // providers still running, if any.
+  void StartProviderDeadlineTimer();
+
+  // Stops each provider that is still running past its deadline.
+  void OnProviderDeadline();
+
+  // Per-provider state for the current query.
+  struct ProviderTiming {
+    ProviderTiming();
+
+    // When the provider was started.
+    base::TimeTicks start_time;
+    // How long the provider may run before it is stopped; zero if unlimited.
+    base::TimeDelta deadline;
+    // True while the provider is finishing the query asynchronously.
+    bool running_async;
+  };
+
   AutocompleteControllerDelegate* delegate_;
 
   // A list of all providers.
@@ -224,6 +249,14 @@ class AutocompleteController : public AutocompleteProviderListener {
   // Timer used to tell the providers to Stop() searching for matches.
   base::OneShotTimer<AutocompleteController> stop_timer_;
 
+  // The state of each provider for the current query, in the same order as
+  // |providers_|.
+  std::vector<ProviderTiming> provider_timings_;
+
+  // Timer used to Stop() individual providers that have run past their
+  // deadlines.
+  base::OneShotTimer<AutocompleteController> provider_deadline_timer_;
+
   // True if the user is in the "stop timer" field trial.  If so, the
   // controller uses the |stop_timer_|.
   const bool in_stop_timer_field_trial_;
@@ -6,6 +6,7 @@
 
 #include <algorithm>
 #include <iterator>
+#include <vector>
 
 #include "base/logging.h"
 #include "chrome/browser/autocomplete/autocomplete_input.h"
@@ -187,6 +188,32 @@ void AutocompleteResult::SortAndCull(const AutocompleteInput& input,
       GURL() : ComputeAlternateNavUrl(input, *default_match_);
 }
 
+void AutocompleteResult::KeepVisibleOrder(const AutocompleteInput& input,
+                                          const AutocompleteResult& visible) {
+  ACMatches reordered;
+  reordered.reserve(matches_.size());
+  std::vector<bool> placed(matches_.size(), false);
+  for (const_iterator v(visible.begin()); v != visible.end(); ++v) {
+    for (size_t i = 0; i < matches_.size(); ++i) {
+      if (!placed[i] && (matches_[i].destination_url == v->destination_url)) {
+        reordered.push_back(matches_[i]);
+        placed[i] = true;
+        break;
+      }
+    }
+  }
+  if (reordered.empty() || !reordered.front().allowed_to_be_default_match)
+    return;
+  for (size_t i = 0; i < matches_.size(); ++i) {
+    if (!placed[i])
+      reordered.push_back(matches_[i]);
+  }
+  matches_.swap(reordered);
+
+  default_match_ = matches_.begin();
+  alternate_nav_url_ = ComputeAlternateNavUrl(input, *default_match_);
+}
+
 bool AutocompleteResult::HasCopiedMatches() const {
   for (ACMatches::const_iterator i(begin()); i != end(); ++i) {
     if (i->from_previous)
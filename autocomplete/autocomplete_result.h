@@ -81,6 +81,16 @@ class AutocompleteResult {
   // and updates the alternate nav URL.
   void SortAndCull(const AutocompleteInput& input, Profile* profile);
 
+  // Moves the matches that also appear in |visible| (the result the user is
+  // currently looking at) to the front, in the order they appear there,
+  // followed by the remaining matches in their current order.  This lets
+  // late-arriving matches be merged in without reshuffling what is already
+  // shown.  Does nothing if the reordering would leave a match that isn't
+  // allowed to be the default match on top.  Should only be called after
+  // SortAndCull().
+  void KeepVisibleOrder(const AutocompleteInput& input,
+                        const AutocompleteResult& visible);
+
   // Returns true if at least one match was copied from the last result.
   bool HasCopiedMatches() const;
 
@@ -428,3 +428,59 @@ TEST_F(AutocompleteResultTest, SortAndCullReorderForDefaultMatch) {
     EXPECT_EQ("http://d/", result.match_at(3)->destination_url.spec());
   }
 }
+
+TEST_F(AutocompleteResultTest, KeepVisibleOrder) {
+  TestData visible_data[] = {
+    { 0, 0, 1300 },
+    { 1, 0, 1200 },
+  };
+  TestData late_data[] = {
+    { 0, 0, 1100 },
+    { 1, 0, 1250 },
+    { 2, 1, 1400 },
+    { 3, 1, 1000 },
+  };
+  AutocompleteInput input(string16(), string16::npos, string16(), GURL(),
+                          AutocompleteInput::INVALID_SPEC, false, false, false,
+                          AutocompleteInput::ALL_MATCHES);
+
+  ACMatches visible_matches;
+  PopulateAutocompleteMatches(visible_data, arraysize(visible_data),
+                              &visible_matches);
+  AutocompleteResult visible;
+  visible.AppendMatches(visible_matches);
+  visible.SortAndCull(input, test_util_.profile());
+
+  {
+    // The shown matches stay on top in the order they were shown; the late
+    // matches follow in relevance order.
+    ACMatches matches;
+    PopulateAutocompleteMatches(late_data, arraysize(late_data), &matches);
+    AutocompleteResult result;
+    result.AppendMatches(matches);
+    result.SortAndCull(input, test_util_.profile());
+    result.KeepVisibleOrder(input, visible);
+    ASSERT_EQ(4U, result.size());
+    EXPECT_EQ("http://a/", result.match_at(0)->destination_url.spec());
+    EXPECT_EQ("http://b/", result.match_at(1)->destination_url.spec());
+    EXPECT_EQ("http://c/", result.match_at(2)->destination_url.spec());
+    EXPECT_EQ("http://d/", result.match_at(3)->destination_url.spec());
+    EXPECT_EQ(result.begin(), result.default_match());
+  }
+
+  {
+    // Nothing moves if the shown top match may no longer be the default.
+    ACMatches matches;
+    PopulateAutocompleteMatches(late_data, arraysize(late_data), &matches);
+    matches[0].allowed_to_be_default_match = false;
+    AutocompleteResult result;
+    result.AppendMatches(matches);
+    result.SortAndCull(input, test_util_.profile());
+    result.KeepVisibleOrder(input, visible);
+    ASSERT_EQ(4U, result.size());
+    EXPECT_EQ("http://c/", result.match_at(0)->destination_url.spec());
+    EXPECT_EQ("http://b/", result.match_at(1)->destination_url.spec());
+    EXPECT_EQ("http://a/", result.match_at(2)->destination_url.spec());
+    EXPECT_EQ("http://d/", result.match_at(3)->destination_url.spec());
+  }
+}
@@ -0,0 +1,358 @@
+// Copyright 2013 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Benchmarks for the history backend and the history-based omnibox providers
+// against a synthetic profile. The profile size defaults to kDefaultNumURLs
+// and can be changed with --history-perf-num-urls=N. Results are printed in
+// the perf_test RESULT format so that they can be tracked by the perf bots.
+
+#include <algorithm>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "base/bind.h"
+#include "base/command_line.h"
+#include "base/file_util.h"
+#include "base/files/file_path.h"
+#include "base/memory/ref_counted.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/message_loop/message_loop.h"
+#include "base/strings/string16.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/time/time.h"
+#include "chrome/browser/autocomplete/autocomplete_input.h"
+#include "chrome/browser/autocomplete/autocomplete_provider_listener.h"
+#include "chrome/browser/autocomplete/history_quick_provider.h"
+#include "chrome/browser/autocomplete/history_url_provider.h"
+#include "chrome/browser/history/history_database.h"
+#include "chrome/browser/history/history_service.h"
+#include "chrome/browser/history/history_service_factory.h"
+#include "chrome/browser/history/shortcuts_database.h"
+#include "chrome/browser/history/synthetic_history_generator.h"
+#include "chrome/browser/history/thumbnail_database.h"
+#include "chrome/browser/history/top_sites_database.h"
+#include "chrome/browser/history/url_index_private_data.h"
+#include "chrome/browser/search_engines/template_url_service.h"
+#include "chrome/browser/search_engines/template_url_service_factory.h"
+#include "chrome/common/cancelable_task_tracker.h"
+#include "chrome/common/chrome_constants.h"
+#include "chrome/test/base/testing_profile.h"
+#include "content/public/common/url_constants.h"
+#include "content/public/test/test_browser_thread_bundle.h"
+#include "sql/init_status.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_test.h"
+#include "url/gurl.h"
+
+using base::Time;
+using base::TimeDelta;
+using base::TimeTicks;
+
+namespace history {
+
+namespace {
+
+const char kNumURLsSwitch[] = "history-perf-num-urls";
+const size_t kDefaultNumURLs = 20000;
+
+// Roughly one host for every this many pages, as in real profiles.
+const size_t kURLsPerHost = 20;
+
+// The number of omnibox inputs typed, one keystroke at a time, per benchmark.
+const size_t kNumSearchTerms = 50;
+
+const char kLanguages[] = "en-US,en";
+
+size_t GetNumURLs() {
+  size_t num_urls;
+  std::string value = CommandLine::ForCurrentProcess()->GetSwitchValueASCII(
+      kNumURLsSwitch);
+  if (value.empty() || !base::StringToSizeT(value, &num_urls) || !num_urls)
+    return kDefaultNumURLs;
+  return num_urls;
+}
+
+void PrintTime(const std::string& measurement,
+               const std::string& trace,
+               TimeDelta time) {
+  perf_test::PrintResult(measurement, std::string(), trace,
+                         static_cast<size_t>(time.InMicroseconds()), "us",
+                         true);
+}
+
+void PrintFileSize(const std::string& trace, const base::FilePath& path) {
+  int64 size = 0;
+  file_util::GetFileSize(path, &size);
+  perf_test::PrintResult("ProfileSize", std::string(), trace,
+                         static_cast<size_t>(size), "bytes", false);
+}
+
+}  // namespace
+
+class HistoryPerfTest : public testing::Test,
+                        public AutocompleteProviderListener {
+ public:
+  HistoryPerfTest() {
+    HistoryQuickProvider::set_disabled(true);
+  }
+
+  virtual ~HistoryPerfTest() {
+    HistoryQuickProvider::set_disabled(false);
+  }
+
+  // AutocompleteProviderListener:
+  virtual void OnProviderUpdate(bool updated_matches) OVERRIDE {
+    if (history_url_provider_->done())
+      base::MessageLoop::current()->Quit();
+  }
+
+ protected:
+  static BrowserContextKeyedService* CreateTemplateURLService(
+      content::BrowserContext* profile) {
+    return new TemplateURLService(static_cast<Profile*>(profile));
+  }
+
+  // testing::Test
+  virtual void SetUp() OVERRIDE;
+  virtual void TearDown() OVERRIDE;
+
+  // Loads the HistoryService on the generated profile.
+  void CreateHistoryService();
+
+  // Returns the path of the file named |name| in the profile directory.
+  base::FilePath GetProfileFile(const base::FilePath::CharType* name) const;
+
+  void QueryHistoryComplete(HistoryService::Handle, QueryResults* results);
+
+  content::TestBrowserThreadBundle thread_bundle_;
+  scoped_ptr<TestingProfile> profile_;
+  SyntheticHistoryGenerator::Params params_;
+  scoped_ptr<SyntheticHistoryGenerator> generator_;
+  TimeDelta generation_time_;
+  std::vector<string16> search_terms_;
+
+  HistoryService* history_service_;
+  scoped_refptr<HistoryURLProvider> history_url_provider_;
+  CancelableRequestConsumer consumer_;
+  size_t query_result_count_;
+};
+
+void HistoryPerfTest::SetUp() {
+  profile_.reset(new TestingProfile());
+
+  params_.num_urls = GetNumURLs();
+  params_.num_hosts = std::max(params_.num_urls / kURLsPerHost,
+                               static_cast<size_t>(1));
+  TimeTicks start = TimeTicks::Now();
+  generator_.reset(new SyntheticHistoryGenerator(params_));
+  {
+    HistoryDatabase db;
+    ASSERT_EQ(sql::INIT_OK, db.Init(GetProfileFile(chrome::kHistoryFilename)));
+    ASSERT_TRUE(generator_->PopulateHistoryDatabase(&db));
+  }
+  {
+    ThumbnailDatabase db;
+    ASSERT_EQ(sql::INIT_OK,
+              db.Init(GetProfileFile(chrome::kFaviconsFilename)));
+    ASSERT_TRUE(generator_->PopulateThumbnailDatabase(&db));
+  }
+  {
+    TopSitesDatabase db;
+    ASSERT_TRUE(db.Init(GetProfileFile(chrome::kTopSitesFilename)));
+    generator_->PopulateTopSitesDatabase(&db);
+  }
+  {
+    scoped_refptr<ShortcutsDatabase> db(new ShortcutsDatabase(profile_.get()));
+    ASSERT_TRUE(db->Init());
+    ASSERT_TRUE(generator_->PopulateShortcutsDatabase(db.get()));
+  }
+  generation_time_ = TimeTicks::Now() - start;
+  search_terms_ = generator_->GenerateSearchTerms(kNumSearchTerms);
+
+  history_service_ = NULL;
+  query_result_count_ = 0;
+}
+
+void HistoryPerfTest::TearDown() {
+  history_url_provider_ = NULL;
+  if (history_service_)
+    profile_->BlockUntilHistoryProcessesPendingRequests();
+}
+
+void HistoryPerfTest::CreateHistoryService() {
+  // Keep the generated History file.
+  ASSERT_TRUE(profile_->CreateHistoryService(false, false));
+  profile_->BlockUntilHistoryProcessesPendingRequests();
+  history_service_ = HistoryServiceFactory::GetForProfile(
+      profile_.get(), Profile::EXPLICIT_ACCESS);
+  ASSERT_TRUE(history_service_);
+}
+
+base::FilePath HistoryPerfTest::GetProfileFile(
+    const base::FilePath::CharType* name) const {
+  return profile_->GetPath().Append(name);
+}
+
+void HistoryPerfTest::QueryHistoryComplete(HistoryService::Handle,
+                                           QueryResults* results) {
+  query_result_count_ = results->size();
+  base::MessageLoop::current()->Quit();
+}
+
+TEST_F(HistoryPerfTest, GenerateProfile) {
+  PrintTime("GenerateProfile", "total", generation_time_);
+  PrintFileSize("history", GetProfileFile(chrome::kHistoryFilename));
+  PrintFileSize("favicons", GetProfileFile(chrome::kFaviconsFilename));
+  PrintFileSize("top_sites", GetProfileFile(chrome::kTopSitesFilename));
+  PrintFileSize("shortcuts", GetProfileFile(chrome::kShortcutsDatabaseName));
+}
+
+// Times building the HistoryQuickProvider index from the History database,
+// writing it to the cache file and restoring it from there.
+TEST_F(HistoryPerfTest, InMemoryURLIndexRebuildAndRestore) {
+  HistoryDatabase db;
+  ASSERT_EQ(sql::INIT_OK, db.Init(GetProfileFile(chrome::kHistoryFilename)));
+  std::set<std::string> scheme_whitelist;
+  scheme_whitelist.insert(content::kHttpScheme);
+  scheme_whitelist.insert(content::kHttpsScheme);
+
+  TimeTicks start = TimeTicks::Now();
+  scoped_refptr<URLIndexPrivateData> data(
+      URLIndexPrivateData::RebuildFromHistory(&db, kLanguages,
+                                              scheme_whitelist));
+  PrintTime("InMemoryURLIndex", "rebuild", TimeTicks::Now() - start);
+  ASSERT_TRUE(data.get());
+  ASSERT_FALSE(data->Empty());
+
+  base::FilePath cache_path =
+      profile_->GetPath().Append(FILE_PATH_LITERAL("History Provider Cache"));
+  start = TimeTicks::Now();
+  ASSERT_TRUE(URLIndexPrivateData::WritePrivateDataToCacheFileTask(
+      data, cache_path));
+  PrintTime("InMemoryURLIndex", "save", TimeTicks::Now() - start);
+  PrintFileSize("url_index_cache", cache_path);
+
+  start = TimeTicks::Now();
+  scoped_refptr<URLIndexPrivateData> restored(
+      URLIndexPrivateData::RestoreFromFile(cache_path, kLanguages));
+  PrintTime("InMemoryURLIndex", "restore", TimeTicks::Now() - start);
+  ASSERT_TRUE(restored.get());
+  EXPECT_FALSE(restored->Empty());
+}
+
+// Times HistoryItemsForTerms() as the search terms are typed one character
+// at a time, so the search term cache is exercised as in the omnibox.
+TEST_F(HistoryPerfTest, HistoryItemsForTerms) {
+  HistoryDatabase db;
+  ASSERT_EQ(sql::INIT_OK, db.Init(GetProfileFile(chrome::kHistoryFilename)));
+  std::set<std::string> scheme_whitelist;
+  scheme_whitelist.insert(content::kHttpScheme);
+  scheme_whitelist.insert(content::kHttpsScheme);
+  scoped_refptr<URLIndexPrivateData> data(
+      URLIndexPrivateData::RebuildFromHistory(&db, kLanguages,
+                                              scheme_whitelist));
+  ASSERT_TRUE(data.get());
+
+  TimeDelta total;
+  TimeDelta slowest;
+  size_t keystrokes = 0;
+  size_t matches = 0;
+  for (size_t i = 0; i < search_terms_.size(); ++i) {
+    for (size_t length = 1; length <= search_terms_[i].size(); ++length) {
+      TimeTicks start = TimeTicks::Now();
+      ScoredHistoryMatches results = data->HistoryItemsForTerms(
+          search_terms_[i].substr(0, length), string16::npos, kLanguages,
+          NULL, 1, NULL);
+      TimeDelta elapsed = TimeTicks::Now() - start;
+      total += elapsed;
+      slowest = std::max(slowest, elapsed);
+      matches += results.size();
+      ++keystrokes;
+    }
+  }
+  ASSERT_GT(keystrokes, 0u);
+  PrintTime("HistoryItemsForTerms", "keystroke_mean", total / keystrokes);
+  PrintTime("HistoryItemsForTerms", "keystroke_max", slowest);
+  perf_test::PrintResult("HistoryItemsForTerms", std::string(), "matches",
+                         matches, "count", false);
+}
+
+// Times complete HistoryURLProvider passes, including the asynchronous pass
+// on the history thread, one keystroke at a time.
+TEST_F(HistoryPerfTest, HistoryURLProvider) {
+  ASSERT_NO_FATAL_FAILURE(CreateHistoryService());
+  TemplateURLServiceFactory::GetInstance()->SetTestingFactoryAndUse(
+      profile_.get(), &HistoryPerfTest::CreateTemplateURLService);
+  history_url_provider_ =
+      new HistoryURLProvider(this, profile_.get(), kLanguages);
+
+  TimeDelta total;
+  TimeDelta slowest;
+  size_t keystrokes = 0;
+  for (size_t i = 0; i < search_terms_.size(); ++i) {
+    for (size_t length = 1; length <= search_terms_[i].size(); ++length) {
+      AutocompleteInput input(search_terms_[i].substr(0, length),
+                              string16::npos, string16(), GURL(),
+                              AutocompleteInput::INVALID_SPEC, false, false,
+                              true, AutocompleteInput::ALL_MATCHES);
+      TimeTicks start = TimeTicks::Now();
+      history_url_provider_->Start(input, false);
+      if (!history_url_provider_->done())
+        base::MessageLoop::current()->Run();
+      TimeDelta elapsed = TimeTicks::Now() - start;
+      total += elapsed;
+      slowest = std::max(slowest, elapsed);
+      ++keystrokes;
+    }
+  }
+  ASSERT_GT(keystrokes, 0u);
+  PrintTime("HistoryURLProvider", "keystroke_mean", total / keystrokes);
+  PrintTime("HistoryURLProvider", "keystroke_max", slowest);
+}
+
+// Times the full text queries made by the history page.
+TEST_F(HistoryPerfTest, QueryHistory) {
+  ASSERT_NO_FATAL_FAILURE(CreateHistoryService());
+
+  // The unfiltered first page of chrome://history.
+  QueryOptions options;
+  options.max_count = 150;
+  TimeTicks start = TimeTicks::Now();
+  history_service_->QueryHistory(
+      string16(), options, &consumer_,
+      base::Bind(&HistoryPerfTest::QueryHistoryComplete,
+                 base::Unretained(this)));
+  base::MessageLoop::current()->Run();
+  PrintTime("QueryHistory", "recent", TimeTicks::Now() - start);
+  EXPECT_GT(query_result_count_, 0u);
+
+  TimeDelta total;
+  for (size_t i = 0; i < search_terms_.size(); ++i) {
+    start = TimeTicks::Now();
+    history_service_->QueryHistory(
+        search_terms_[i], options, &consumer_,
+        base::Bind(&HistoryPerfTest::QueryHistoryComplete,
+                   base::Unretained(this)));
+    base::MessageLoop::current()->Run();
+    total += TimeTicks::Now() - start;
+  }
+  PrintTime("QueryHistory", "text_mean", total / search_terms_.size());
+}
+
+// Times deleting the older half of the history, as "Clear browsing data"
+// does for a time range.
+TEST_F(HistoryPerfTest, ExpireHistoryBetween) {
+  ASSERT_NO_FATAL_FAILURE(CreateHistoryService());
+  CancelableTaskTracker tracker;
+  TimeTicks start = TimeTicks::Now();
+  history_service_->ExpireHistoryBetween(
+      std::set<GURL>(), Time(),
+      params_.now - TimeDelta::FromDays(params_.history_days / 2),
+      base::MessageLoop::QuitClosure(), &tracker);
+  base::MessageLoop::current()->Run();
+  PrintTime("ExpireHistoryBetween", "older_half", TimeTicks::Now() - start);
+}
+
+}  // namespace history
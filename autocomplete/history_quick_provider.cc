@@ -81,6 +81,7 @@ void HistoryQuickProvider::Start(const AutocompleteInput& input,
   // autocomplete behavior here.
   if (GetIndex()) {
     base::TimeTicks start_time = base::TimeTicks::Now();
+    scoring_cancel_flag_ = new history::ScoringCancellationFlag;
     DoAutocomplete();
     if (input.text().length() < 6) {
       base::TimeTicks end_time = base::TimeTicks::Now();
@@ -94,6 +95,12 @@ void HistoryQuickProvider::Start(const AutocompleteInput& input,
   }
 }
 
+void HistoryQuickProvider::Stop(bool clear_cached_results) {
+  if (scoring_cancel_flag_.get())
+    scoring_cancel_flag_->data.Set();
+  AutocompleteProvider::Stop(clear_cached_results);
+}
+
 void HistoryQuickProvider::DeleteMatch(const AutocompleteMatch& match) {
   DCHECK(match.deletable);
   DCHECK(match.destination_url.is_valid());
@@ -108,7 +115,8 @@ void HistoryQuickProvider::DoAutocomplete() {
   // Get the matching URLs from the DB.
   ScoredHistoryMatches matches = GetIndex()->HistoryItemsForTerms(
       autocomplete_input_.text(),
-      autocomplete_input_.cursor_position());
+      autocomplete_input_.cursor_position(),
+      scoring_cancel_flag_.get());
   if (matches.empty())
     return;
 
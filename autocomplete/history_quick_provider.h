@@ -36,6 +36,10 @@ class HistoryQuickProvider : public HistoryProvider {
   virtual void Start(const AutocompleteInput& input,
                      bool minimal_changes) OVERRIDE;
 
+  // AutocompleteProvider. Abandons any scoring still outstanding for the
+  // current query.
+  virtual void Stop(bool clear_cached_results) OVERRIDE;
+
   virtual void DeleteMatch(const AutocompleteMatch& match) OVERRIDE;
 
   // Disable this provider. For unit testing purposes only. This is required
@@ -79,6 +83,9 @@ class HistoryQuickProvider : public HistoryProvider {
   AutocompleteInput autocomplete_input_;
   std::string languages_;
 
+  // Set when the current query is stopped; a fresh flag is made per query.
+  scoped_refptr<history::ScoringCancellationFlag> scoring_cancel_flag_;
+
   // Only used for testing.
   scoped_ptr<history::InMemoryURLIndex> index_for_testing_;
 
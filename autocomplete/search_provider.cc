@@ -544,6 +544,7 @@ void SearchProvider::Start(const AutocompleteInput& input,
 void SearchProvider::Stop(bool clear_cached_results) {
   StopSuggest();
   done_ = true;
+  time_suggest_wait_started_ = base::TimeTicks();
 
   if (clear_cached_results)
     ClearAllResults();
@@ -608,6 +609,14 @@ void SearchProvider::OnURLFetchComplete(const net::URLFetcher* source) {
     results_updated = data.get() && ParseSuggestResults(data.get(), is_keyword);
   }
 
+  // Record how long the user waited for suggestions since they first needed
+  // new ones, including the time spent on the requests this one replaced.
+  if (results_updated && !time_suggest_wait_started_.is_null()) {
+    UMA_HISTOGRAM_TIMES("Omnibox.SuggestRequest.TimeToFirstResults",
+                        base::TimeTicks::Now() - time_suggest_wait_started_);
+    time_suggest_wait_started_ = base::TimeTicks();
+  }
+
   UpdateMatches();
   if (done_ || results_updated)
     listener_->OnProviderUpdate(results_updated);
@@ -694,6 +703,7 @@ void SearchProvider::StartOrStopSuggestQuery(bool minimal_changes) {
   if (!IsQuerySuitableForSuggest()) {
     StopSuggest();
     ClearAllResults();
+    time_suggest_wait_started_ = base::TimeTicks();
     return;
   }
 
@@ -719,11 +729,14 @@ void SearchProvider::StartOrStopSuggestQuery(bool minimal_changes) {
   if (input_.matches_requested() != AutocompleteInput::ALL_MATCHES)
     return;
 
+  base::TimeTicks now(base::TimeTicks::Now());
+  if (time_suggest_wait_started_.is_null())
+    time_suggest_wait_started_ = now;
+
   // To avoid flooding the suggest server, don't send a query until at
   // least 100 ms since the last query.
   base::TimeTicks next_suggest_time(time_suggest_request_sent_ +
       base::TimeDelta::FromMilliseconds(kMinimumTimeBetweenSuggestQueriesMs));
-  base::TimeTicks now(base::TimeTicks::Now());
   if (now >= next_suggest_time) {
     Run();
     return;
@@ -537,6 +537,11 @@ class SearchProvider : public AutocompleteProvider,
   // The time at which we sent a query to the suggest server.
   base::TimeTicks time_suggest_request_sent_;
 
+  // The time at which the input first needed new suggest results, if none
+  // have arrived since.  Requests cancelled by later keystrokes don't reset
+  // it.
+  base::TimeTicks time_suggest_wait_started_;
+
   // Fetchers used to retrieve results for the keyword and default providers.
   scoped_ptr<net::URLFetcher> keyword_fetcher_;
   scoped_ptr<net::URLFetcher> default_fetcher_;
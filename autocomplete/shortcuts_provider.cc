@@ -142,14 +142,20 @@ void ShortcutsProvider::GetMatches(const AutocompleteInput& input) {
       input.current_page_classification(), &max_relevance))
     max_relevance = AutocompleteResult::kLowestDefaultScore - 1;
 
-  for (history::ShortcutsBackend::ShortcutMap::const_iterator it =
-           FindFirstMatch(term_string, backend.get());
-       it != backend->shortcuts_map().end() &&
-           StartsWith(it->first, term_string, true); ++it) {
+  // The backend only returns the best few shortcuts of each decay rate when
+  // many of them start with |term_string|, so the time spent here does not
+  // grow with the number of shortcuts.
+  DCHECK_GE(history::ShortcutsBackend::kMaxCandidatesPerDecayRate,
+            AutocompleteProvider::kMaxMatches);
+  std::vector<const history::ShortcutsBackend::Shortcut*> shortcuts;
+  backend->GetShortcutsForPrefix(term_string, &shortcuts);
+  for (size_t i = 0; i < shortcuts.size(); ++i) {
     // Don't return shortcuts with zero relevance.
-    int relevance = CalculateScore(term_string, it->second, max_relevance);
-    if (relevance)
-      matches_.push_back(ShortcutToACMatch(relevance, term_string, it->second));
+    int relevance = CalculateScore(term_string, *shortcuts[i], max_relevance);
+    if (relevance) {
+      matches_.push_back(
+          ShortcutToACMatch(relevance, term_string, *shortcuts[i]));
+    }
   }
   std::partial_sort(matches_.begin(),
       matches_.begin() +
@@ -314,19 +320,6 @@ ACMatchClassifications ShortcutsProvider::ClassifyAllMatchesInString(
   return AutocompleteMatch::MergeClassifications(original_class, match_class);
 }
 
-history::ShortcutsBackend::ShortcutMap::const_iterator
-    ShortcutsProvider::FindFirstMatch(const string16& keyword,
-                                      history::ShortcutsBackend* backend) {
-  DCHECK(backend);
-  history::ShortcutsBackend::ShortcutMap::const_iterator it =
-      backend->shortcuts_map().lower_bound(keyword);
-  // Lower bound not necessarily matches the keyword, check for item pointed by
-  // the lower bound iterator to at least start with keyword.
-  return ((it == backend->shortcuts_map().end()) ||
-    StartsWith(it->first, keyword, true)) ? it :
-    backend->shortcuts_map().end();
-}
-
 int ShortcutsProvider::CalculateScore(
     const string16& terms,
     const history::ShortcutsBackend::Shortcut& shortcut,
@@ -351,14 +344,10 @@ int ShortcutsProvider::CalculateScore(
       time_passed.InMicroseconds()) / base::Time::kMicrosecondsPerWeek);
 
   // We modulate the decay factor based on how many times the shortcut has been
-  // used. Newly created shortcuts decay at full speed; otherwise, decaying by
-  // half takes |n| times as much time, where n increases by
-  // (1.0 / each 5 additional hits), up to a maximum of 5x as long.
-  const double kMaxDecaySpeedDivisor = 5.0;
-  const double kNumUsesPerDecaySpeedDivisorIncrement = 5.0;
-  double decay_divisor = std::min(kMaxDecaySpeedDivisor,
-      (shortcut.number_of_hits + kNumUsesPerDecaySpeedDivisorIncrement - 1) /
-      kNumUsesPerDecaySpeedDivisorIncrement);
+  // used. ShortcutsBackend ranks shortcuts by this formula, so keep the two in
+  // sync.
+  double decay_divisor = history::ShortcutsBackend::GetDecaySpeedDivisor(
+      shortcut.number_of_hits);
 
   return static_cast<int>((base_score / exp(decay_exponent / decay_divisor)) +
       0.5);
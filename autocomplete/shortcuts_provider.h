@@ -85,12 +85,6 @@ class ShortcutsProvider
       const string16& text,
       const ACMatchClassifications& original_class);
 
-  // Returns iterator to first item in |shortcuts_map_| matching |keyword|.
-  // Returns shortcuts_map_.end() if there are no matches.
-  history::ShortcutsBackend::ShortcutMap::const_iterator FindFirstMatch(
-      const string16& keyword,
-      history::ShortcutsBackend* backend);
-
   int CalculateScore(
       const string16& terms,
       const history::ShortcutsBackend::Shortcut& shortcut,
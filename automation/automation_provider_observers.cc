@@ -1487,6 +1487,8 @@ void AutomationProviderHistoryObserver::HistoryQueryComplete(
 
   scoped_ptr<DictionaryValue> return_value(new DictionaryValue);
 
+  BookmarkModel* bookmark_model =
+      BookmarkModelFactory::GetForProfile(provider_->profile());
   ListValue* history_list = new ListValue;
   for (size_t i = 0; i < results->size(); ++i) {
     DictionaryValue* page_value = new DictionaryValue;
@@ -1496,10 +1498,7 @@ void AutomationProviderHistoryObserver::HistoryQueryComplete(
     page_value->SetDouble("time",
                           static_cast<double>(page.visit_time().ToDoubleT()));
     page_value->SetString("snippet", page.snippet().text());
-    page_value->SetBoolean(
-        "starred",
-        BookmarkModelFactory::GetForProfile(
-            provider_->profile())->IsBookmarked(page.url()));
+    page_value->SetBoolean("starred", bookmark_model->IsBookmarked(page.url()));
     history_list->Append(page_value);
   }
 
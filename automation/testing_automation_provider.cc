@@ -188,6 +188,9 @@ using extensions::Manifest;
 
 namespace {
 
+// JSON commands taking longer than this to handle are logged.
+const int kSlowJSONCommandThresholdMs = 1000;
+
 // Helper to reply asynchronously if |automation| is still valid.
 void SendSuccessReply(base::WeakPtr<AutomationProvider> automation,
                       IPC::Message* reply_message) {
@@ -1934,6 +1937,10 @@ void TestingAutomationProvider::SendJSONRequest(Browser* browser,
   if (handler_map_.empty() || browser_handler_map_.empty())
     BuildJSONHandlerMaps();
 
+  // This only covers the synchronous part of the handling, which includes
+  // building and serializing the reply for most commands.
+  base::TimeTicks start_time = base::TimeTicks::Now();
+
   // Look for command in handlers that take a Browser.
   if (browser_handler_map_.find(std::string(command)) !=
       browser_handler_map_.end() && browser) {
@@ -1956,6 +1963,12 @@ void TestingAutomationProvider::SendJSONRequest(Browser* browser,
     }
     AutomationJSONReply(this, reply_message).SendError(error_string);
   }
+
+  base::TimeDelta elapsed = base::TimeTicks::Now() - start_time;
+  if (elapsed.InMilliseconds() > kSlowJSONCommandThresholdMs) {
+    LOG(WARNING) << "Automation command " << command << " took "
+                 << elapsed.InMilliseconds() << " ms to handle";
+  }
 }
 
 void TestingAutomationProvider::BringBrowserToFrontJSON(
@@ -2413,7 +2426,11 @@ void TestingAutomationProvider::GetNavigationInfo(
 }
 
 // Sample json input: { "command": "GetHistoryInfo",
-//                      "search_text": "some text" }
+//                      "search_text": "some text",
+//                      "max_count": 100,            # optional
+//                      "end_time": 1376000000.0 }   # optional
+// Large histories can be fetched in pages of |max_count| entries by passing
+// the time of the last entry of a page as the |end_time| of the next one.
 // Refer chrome/test/pyautolib/history_info.py for sample json output.
 void TestingAutomationProvider::GetHistoryInfo(Browser* browser,
                                                DictionaryValue* args,
@@ -2427,6 +2444,10 @@ void TestingAutomationProvider::GetHistoryInfo(Browser* browser,
   HistoryService* hs = HistoryServiceFactory::GetForProfile(
       browser->profile(), Profile::EXPLICIT_ACCESS);
   history::QueryOptions options;
+  args->GetInteger("max_count", &options.max_count);
+  double end_time;
+  if (args->GetDouble("end_time", &end_time))
+    options.end_time = base::Time::FromDoubleT(end_time);
   // The observer owns itself.  It deletes itself after it fetches history.
   AutomationProviderHistoryObserver* history_observer =
       new AutomationProviderHistoryObserver(this, reply_message);
@@ -0,0 +1,126 @@
+// Copyright 2013 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "chrome/browser/batched_utility_process_host.h"
+
+#include "base/logging.h"
+#include "base/message_loop/message_loop_proxy.h"
+#include "content/public/browser/browser_thread.h"
+#include "content/public/browser/utility_process_host.h"
+#include "ipc/ipc_message.h"
+
+using content::BrowserThread;
+using content::UtilityProcessHost;
+
+namespace {
+
+// How long the shared utility process is kept running after the last reply.
+const int kIdleTimeoutSeconds = 5;
+
+}  // namespace
+
+BatchedUtilityProcessHost::PendingRequest::PendingRequest(
+    const ReplyHandler& reply_handler,
+    const base::Closure& crash_handler)
+    : reply_handler(reply_handler),
+      crash_handler(crash_handler) {
+}
+
+BatchedUtilityProcessHost::PendingRequest::~PendingRequest() {}
+
+// static
+void BatchedUtilityProcessHost::Send(ProcessMode mode,
+                                     IPC::Message* message,
+                                     const ReplyHandler& reply_handler,
+                                     const base::Closure& crash_handler) {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
+  if (mode == SHARED_PROCESS) {
+    GetSharedInstance()->SendRequest(message, reply_handler, crash_handler);
+    return;
+  }
+  // The utility process host keeps a reference to its client, so this host
+  // lives until the dedicated process exits.
+  scoped_refptr<BatchedUtilityProcessHost> host(
+      new BatchedUtilityProcessHost(DEDICATED_PROCESS));
+  host->SendRequest(message, reply_handler, crash_handler);
+}
+
+BatchedUtilityProcessHost::BatchedUtilityProcessHost(ProcessMode mode)
+    : mode_(mode) {
+}
+
+BatchedUtilityProcessHost::~BatchedUtilityProcessHost() {}
+
+// static
+BatchedUtilityProcessHost* BatchedUtilityProcessHost::GetSharedInstance() {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
+  static BatchedUtilityProcessHost* instance = NULL;
+  if (!instance) {
+    // Never deleted, so that replies can always be dispatched.
+    instance = new BatchedUtilityProcessHost(SHARED_PROCESS);
+    instance->AddRef();
+  }
+  return instance;
+}
+
+void BatchedUtilityProcessHost::SendRequest(
+    IPC::Message* message,
+    const ReplyHandler& reply_handler,
+    const base::Closure& crash_handler) {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
+  // A dedicated process handles a single request.
+  DCHECK(mode_ == SHARED_PROCESS || !utility_host_);
+  idle_timer_.Stop();
+  if (!utility_host_) {
+    utility_host_ = UtilityProcessHost::Create(
+        this, base::MessageLoopProxy::current().get())->AsWeakPtr();
+    utility_host_->EnableZygote();
+    if (mode_ == SHARED_PROCESS)
+      utility_host_->StartBatchMode();
+  }
+
+  pending_requests_.push_back(PendingRequest(reply_handler, crash_handler));
+  utility_host_->Send(message);
+}
+
+bool BatchedUtilityProcessHost::OnMessageReceived(
+    const IPC::Message& message) {
+  if (pending_requests_.empty())
+    return false;
+
+  // Remove the request before handling the reply, which may send another
+  // request.
+  PendingRequest request = pending_requests_.front();
+  pending_requests_.pop_front();
+  if (!request.reply_handler.Run(message)) {
+    pending_requests_.push_front(request);
+    return false;
+  }
+
+  if (pending_requests_.empty() && utility_host_ && mode_ == SHARED_PROCESS) {
+    idle_timer_.Start(FROM_HERE,
+                      base::TimeDelta::FromSeconds(kIdleTimeoutSeconds),
+                      this, &BatchedUtilityProcessHost::ReleaseProcess);
+  }
+  return true;
+}
+
+void BatchedUtilityProcessHost::OnProcessCrashed(int exit_code) {
+  utility_host_.reset();
+  idle_timer_.Stop();
+  std::deque<PendingRequest> requests;
+  requests.swap(pending_requests_);
+  while (!requests.empty()) {
+    requests.front().crash_handler.Run();
+    requests.pop_front();
+  }
+}
+
+void BatchedUtilityProcessHost::ReleaseProcess() {
+  DCHECK(pending_requests_.empty());
+  if (utility_host_) {
+    utility_host_->EndBatchMode();
+    utility_host_.reset();
+  }
+}
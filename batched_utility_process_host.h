@@ -0,0 +1,96 @@
+// Copyright 2013 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CHROME_BROWSER_BATCHED_UTILITY_PROCESS_HOST_H_
+#define CHROME_BROWSER_BATCHED_UTILITY_PROCESS_HOST_H_
+
+#include <deque>
+
+#include "base/basictypes.h"
+#include "base/callback.h"
+#include "base/compiler_specific.h"
+#include "base/memory/weak_ptr.h"
+#include "base/timer/timer.h"
+#include "content/public/browser/utility_process_host_client.h"
+
+namespace content {
+class UtilityProcessHost;
+}
+
+namespace IPC {
+class Message;
+}
+
+// Sends requests to a utility process and hands each reply to the sender of
+// the request. The utility process handles the requests in the order they were
+// sent, so each reply is for the oldest pending request. Lives on the IO
+// thread.
+//
+// Requests with SHARED_PROCESS go to one utility process, which is kept running
+// for a few seconds after the last reply so that bursts of requests don't
+// launch a process each. Requests whose inputs come from different, untrusted
+// sources should use DEDICATED_PROCESS, so that a malicious input can't tamper
+// with the results of other requests.
+class BatchedUtilityProcessHost : public content::UtilityProcessHostClient {
+ public:
+  enum ProcessMode {
+    SHARED_PROCESS,
+    // The request gets a utility process of its own, which exits once it has
+    // replied.
+    DEDICATED_PROCESS,
+  };
+
+  // Handles a reply from the utility process. Returns false if |message| is
+  // not a reply to the request.
+  typedef base::Callback<bool(const IPC::Message& message)> ReplyHandler;
+
+  // Sends |message| to a utility process, as selected by |mode|, and takes
+  // ownership of it. |reply_handler| is called with the reply, or
+  // |crash_handler| if the process crashes before replying.
+  static void Send(ProcessMode mode,
+                   IPC::Message* message,
+                   const ReplyHandler& reply_handler,
+                   const base::Closure& crash_handler);
+
+ private:
+  struct PendingRequest {
+    PendingRequest(const ReplyHandler& reply_handler,
+                   const base::Closure& crash_handler);
+    ~PendingRequest();
+
+    ReplyHandler reply_handler;
+    base::Closure crash_handler;
+  };
+
+  explicit BatchedUtilityProcessHost(ProcessMode mode);
+  virtual ~BatchedUtilityProcessHost();
+
+  // Returns the host of the SHARED_PROCESS requests.
+  static BatchedUtilityProcessHost* GetSharedInstance();
+
+  // Sends |message|, launching the utility process as needed.
+  void SendRequest(IPC::Message* message,
+                   const ReplyHandler& reply_handler,
+                   const base::Closure& crash_handler);
+
+  // Overidden from UtilityProcessHostClient:
+  virtual bool OnMessageReceived(const IPC::Message& message) OVERRIDE;
+  virtual void OnProcessCrashed(int exit_code) OVERRIDE;
+
+  // Lets the shared utility process exit once no request is pending.
+  void ReleaseProcess();
+
+  const ProcessMode mode_;
+
+  base::WeakPtr<content::UtilityProcessHost> utility_host_;
+
+  // The requests waiting for a reply, oldest first.
+  std::deque<PendingRequest> pending_requests_;
+
+  base::OneShotTimer<BatchedUtilityProcessHost> idle_timer_;
+
+  DISALLOW_COPY_AND_ASSIGN(BatchedUtilityProcessHost);
+};
+
+#endif  // CHROME_BROWSER_BATCHED_UTILITY_PROCESS_HOST_H_
@@ -6,8 +6,12 @@
 
 #include <algorithm>
 
+#include "base/memory/scoped_ptr.h"
 #include "base/strings/string_number_conversions.h"
 #include "base/strings/string_util.h"
+#include "base/strings/utf_string_conversion_utils.h"
+#include "base/strings/utf_string_conversions.h"
+#include "base/third_party/icu/icu_utf.h"
 #include "base/values.h"
 #include "chrome/browser/bookmarks/bookmark_model.h"
 #include "grit/generated_resources.h"
@@ -37,6 +41,404 @@ const char* BookmarkCodec::kTypeFolder = "folder";
 // Current version of the file.
 static const int kCurrentVersion = 1;
 
+namespace {
+
+// Objects and lists can't be nested deeper than this, as in base::JSONReader.
+const size_t kMaxJSONDepth = 100;
+
+// Appends what UpdateChecksum would hash for |str| to |data|.
+void AppendChecksumData(const std::string& str, std::string* data) {
+  data->append(str);
+}
+
+void AppendChecksumData(const string16& str, std::string* data) {
+  data->append(reinterpret_cast<const char*>(str.data()),
+               str.length() * sizeof(str[0]));
+}
+
+// Deletes the children of |node|.
+void DeleteChildren(BookmarkNode* node) {
+  while (node->child_count())
+    delete node->Remove(node->GetChild(node->child_count() - 1));
+}
+
+// What DecodeJSON changes on a permanent node, to undo it if the file turns
+// out to be invalid.
+struct PermanentNodeState {
+  explicit PermanentNodeState(const BookmarkNode* node)
+      : id(node->id()),
+        date_added(node->date_added()),
+        date_folder_modified(node->date_folder_modified()),
+        meta_info(node->meta_info_str()) {
+  }
+
+  void Restore(BookmarkNode* node) const {
+    DeleteChildren(node);
+    node->set_id(id);
+    node->set_date_added(date_added);
+    node->set_date_folder_modified(date_folder_modified);
+    node->set_meta_info_str(meta_info);
+  }
+
+  int64 id;
+  Time date_added;
+  Time date_folder_modified;
+  std::string meta_info;
+};
+
+}  // namespace
+
+// Reads JSON text one value at a time, accepting the same syntax as
+// base::JSONReader with its default options: comments and a leading byte
+// order mark are allowed. The first syntax error makes the stream fail, after
+// which all reads fail.
+class BookmarkCodec::JSONStream {
+ public:
+  enum Type {
+    OBJECT,
+    LIST,
+    STRING,
+    OTHER,
+  };
+
+  explicit JSONStream(const base::StringPiece& json)
+      : json_(json),
+        pos_(0),
+        failed_(false) {
+    if (json_.starts_with("\xEF\xBB\xBF"))
+      pos_ = 3;
+  }
+
+  bool failed() const { return failed_; }
+
+  // Returns the type of the next value.
+  Type NextType() {
+    SkipWhitespace();
+    if (failed_ || pos_ == json_.size())
+      return OTHER;
+    switch (json_[pos_]) {
+      case '{':
+        return OBJECT;
+      case '[':
+        return LIST;
+      case '"':
+        return STRING;
+      default:
+        return OTHER;
+    }
+  }
+
+  // Consumes the '{' that starts an object. NextMember then steps through
+  // its members.
+  bool EnterObject() {
+    return Enter('{');
+  }
+
+  // Reads the key of the object's next member, up to the ':'. The caller
+  // must then read or skip its value. Returns false once it has consumed the
+  // '}' that ends the object, or on error.
+  bool NextMember(std::string* key) {
+    if (!Next('}'))
+      return false;
+    if (NextType() != STRING || !ParseString(key))
+      return Fail();
+    return Consume(':');
+  }
+
+  // Consumes the '[' that starts a list. NextElement then steps through its
+  // elements.
+  bool EnterList() {
+    return Enter('[');
+  }
+
+  // Returns true if the list has another element, which the caller must then
+  // read or skip. Returns false once it has consumed the ']' that ends the
+  // list, or on error.
+  bool NextElement() {
+    return Next(']');
+  }
+
+  // Reads a string into |value|. Returns false, skipping the value, if it
+  // isn't a string.
+  bool ReadString(std::string* value) {
+    if (NextType() != STRING) {
+      SkipValue();
+      return false;
+    }
+    return ParseString(value);
+  }
+
+  // Reads an integer into |value|. Returns false, skipping the value, if it
+  // isn't one. Like base::JSONReader, numbers with a fraction or exponent, or
+  // that don't fit an int, aren't integers.
+  bool ReadInteger(int* value) {
+    SkipWhitespace();
+    base::StringPiece number;
+    if (failed_ || pos_ == json_.size() ||
+        (json_[pos_] != '-' && !IsAsciiDigit(json_[pos_]))) {
+      SkipValue();
+      return false;
+    }
+    return ParseNumber(&number) &&
+        number.find_first_of(".eE") == base::StringPiece::npos &&
+        base::StringToInt(number, value);
+  }
+
+  // Skips the next value.
+  bool SkipValue() {
+    std::string ignored;
+    switch (NextType()) {
+      case OBJECT:
+        if (!EnterObject())
+          return false;
+        while (NextMember(&ignored))
+          SkipValue();
+        return !failed_;
+      case LIST:
+        if (!EnterList())
+          return false;
+        while (NextElement())
+          SkipValue();
+        return !failed_;
+      case STRING:
+        return ParseString(&ignored);
+      case OTHER:
+        break;
+    }
+    if (failed_ || pos_ == json_.size())
+      return Fail();
+    base::StringPiece number;
+    switch (json_[pos_]) {
+      case 't':
+        return ParseLiteral("true");
+      case 'f':
+        return ParseLiteral("false");
+      case 'n':
+        return ParseLiteral("null");
+      default:
+        return ParseNumber(&number);
+    }
+  }
+
+  // Returns true if there is nothing but whitespace left.
+  bool AtEnd() {
+    SkipWhitespace();
+    return !failed_ && pos_ == json_.size();
+  }
+
+ private:
+  bool Fail() {
+    failed_ = true;
+    return false;
+  }
+
+  // Consumes |c|, which must be next.
+  bool Consume(char c) {
+    SkipWhitespace();
+    if (failed_ || pos_ == json_.size() || json_[pos_] != c)
+      return Fail();
+    ++pos_;
+    return true;
+  }
+
+  bool Enter(char open) {
+    if (!Consume(open))
+      return false;
+    if (first_.size() == kMaxJSONDepth)
+      return Fail();
+    first_.push_back(true);
+    return true;
+  }
+
+  // Consumes |close| or the ',' before the next item of the innermost object
+  // or list. Returns true if there is another item.
+  bool Next(char close) {
+    SkipWhitespace();
+    if (failed_ || first_.empty() || pos_ == json_.size())
+      return Fail();
+    if (json_[pos_] == close) {
+      ++pos_;
+      first_.pop_back();
+      return false;
+    }
+    if (!first_.back() && !Consume(','))
+      return false;
+    first_.back() = false;
+    return true;
+  }
+
+  void SkipWhitespace() {
+    while (pos_ < json_.size()) {
+      char c = json_[pos_];
+      if (c == ' ' || c == '\t' || c == '\n' || c == '\r') {
+        ++pos_;
+      } else if (c == '/' && pos_ + 1 < json_.size() &&
+                 json_[pos_ + 1] == '/') {
+        size_t end = json_.find('\n', pos_);
+        pos_ = end == base::StringPiece::npos ? json_.size() : end + 1;
+      } else if (c == '/' && pos_ + 1 < json_.size() &&
+                 json_[pos_ + 1] == '*') {
+        size_t end = json_.find("*/", pos_ + 2);
+        if (end == base::StringPiece::npos) {
+          Fail();
+          return;
+        }
+        pos_ = end + 2;
+      } else {
+        return;
+      }
+    }
+  }
+
+  // Reads |count| hex digits as a number.
+  bool ParseHexDigits(int count, uint32* value) {
+    if (json_.size() - pos_ < static_cast<size_t>(count))
+      return Fail();
+    *value = 0;
+    for (int i = 0; i < count; ++i) {
+      char c = json_[pos_++];
+      if (!IsHexDigit(c))
+        return Fail();
+      *value = *value * 16 + HexDigitToInt(c);
+    }
+    return true;
+  }
+
+  // Reads the string starting at the current '"', undoing its escapes.
+  bool ParseString(std::string* value) {
+    DCHECK_EQ('"', json_[pos_]);
+    ++pos_;
+    std::string result;
+    while (pos_ < json_.size()) {
+      // Copy everything up to the next quote or escape at once. Both are
+      // ASCII, so they don't split multi-byte characters.
+      size_t end = json_.find_first_of("\"\\", pos_);
+      if (end == base::StringPiece::npos)
+        break;
+      json_.substr(pos_, end - pos_).AppendToString(&result);
+      pos_ = end + 1;
+      if (json_[end] == '"') {
+        if (!IsStringUTF8(result))
+          return Fail();
+        value->swap(result);
+        return true;
+      }
+
+      if (pos_ == json_.size())
+        break;
+      uint32 code_point;
+      switch (json_[pos_++]) {
+        case '"':
+          result.push_back('"');
+          break;
+        case '\\':
+          result.push_back('\\');
+          break;
+        case '/':
+          result.push_back('/');
+          break;
+        case 'b':
+          result.push_back('\b');
+          break;
+        case 'f':
+          result.push_back('\f');
+          break;
+        case 'n':
+          result.push_back('\n');
+          break;
+        case 'r':
+          result.push_back('\r');
+          break;
+        case 't':
+          result.push_back('\t');
+          break;
+        case 'v':
+          result.push_back('\v');
+          break;
+        case 'x':
+          if (!ParseHexDigits(2, &code_point))
+            return false;
+          base::WriteUnicodeCharacter(code_point, &result);
+          break;
+        case 'u':
+          if (!ParseHexDigits(4, &code_point))
+            return false;
+          if (CBU16_IS_SURROGATE(code_point)) {
+            // Only a lead surrogate followed by an escaped trail surrogate
+            // makes a character.
+            uint32 trail;
+            if (!CBU16_IS_LEAD(code_point) ||
+                !json_.substr(pos_).starts_with("\\u")) {
+              return Fail();
+            }
+            pos_ += 2;
+            if (!ParseHexDigits(4, &trail))
+              return false;
+            if (!CBU16_IS_TRAIL(trail))
+              return Fail();
+            code_point = CBU16_GET_SUPPLEMENTARY(code_point, trail);
+          }
+          base::WriteUnicodeCharacter(code_point, &result);
+          break;
+        default:
+          return Fail();
+      }
+    }
+    return Fail();
+  }
+
+  // Reads the number at the current position into |number|.
+  bool ParseNumber(base::StringPiece* number) {
+    const size_t start = pos_;
+    if (pos_ < json_.size() && json_[pos_] == '-')
+      ++pos_;
+    if (pos_ < json_.size() && json_[pos_] == '0') {
+      ++pos_;
+    } else if (!ParseDigits()) {
+      return false;
+    }
+    if (pos_ < json_.size() && json_[pos_] == '.') {
+      ++pos_;
+      if (!ParseDigits())
+        return false;
+    }
+    if (pos_ < json_.size() && (json_[pos_] == 'e' || json_[pos_] == 'E')) {
+      ++pos_;
+      if (pos_ < json_.size() && (json_[pos_] == '+' || json_[pos_] == '-'))
+        ++pos_;
+      if (!ParseDigits())
+        return false;
+    }
+    *number = json_.substr(start, pos_ - start);
+    return true;
+  }
+
+  // Reads one or more digits.
+  bool ParseDigits() {
+    const size_t start = pos_;
+    while (pos_ < json_.size() && IsAsciiDigit(json_[pos_]))
+      ++pos_;
+    return pos_ != start || Fail();
+  }
+
+  bool ParseLiteral(const base::StringPiece& literal) {
+    if (!json_.substr(pos_).starts_with(literal))
+      return Fail();
+    pos_ += literal.size();
+    return true;
+  }
+
+  const base::StringPiece json_;
+  size_t pos_;
+  bool failed_;
+
+  // For each object and list entered, and not yet left, whether its first
+  // item is still to come.
+  std::vector<bool> first_;
+
+  DISALLOW_COPY_AND_ASSIGN(JSONStream);
+};
+
 BookmarkCodec::BookmarkCodec()
     : ids_reassigned_(false),
       ids_valid_(true),
@@ -97,6 +499,57 @@ bool BookmarkCodec::Decode(BookmarkNode* bb_node,
   return success;
 }
 
+bool BookmarkCodec::DecodeJSON(BookmarkNode* bb_node,
+                               BookmarkNode* other_folder_node,
+                               BookmarkNode* mobile_folder_node,
+                               int64* max_id,
+                               const base::StringPiece& json) {
+  ids_.clear();
+  ids_reassigned_ = false;
+  ids_valid_ = true;
+  maximum_id_ = 0;
+  stored_checksum_.clear();
+  checksum_data_.clear();
+  const PermanentNodeState bb_state(bb_node);
+  const PermanentNodeState other_folder_state(other_folder_node);
+  const PermanentNodeState mobile_folder_state(mobile_folder_node);
+
+  JSONStream stream(json);
+  bool success = DecodeJSONHelper(&stream, bb_node, other_folder_node,
+                                  mobile_folder_node);
+  const bool parsed = stream.AtEnd();
+  if (!success || !parsed) {
+    // Decode doesn't get to decode the nodes of a file it rejects, but the
+    // file is only validated completely once it has been read to the end.
+    bb_state.Restore(bb_node);
+    other_folder_state.Restore(other_folder_node);
+    mobile_folder_state.Restore(mobile_folder_node);
+    ids_.clear();
+    ids_valid_ = true;
+    maximum_id_ = 0;
+    stored_checksum_.clear();
+    checksum_data_.clear();
+    model_meta_info_.clear();
+    success = false;
+  }
+  if (!parsed) {
+    *max_id = 1;
+    return false;
+  }
+
+  InitializeChecksum();
+  for (size_t i = 0; i < checksum_data_.size(); ++i)
+    UpdateChecksum(checksum_data_[i]);
+  std::vector<std::string>().swap(checksum_data_);
+  FinalizeChecksum();
+  // If either the checksums differ or some IDs were missing/not unique,
+  // reassign IDs.
+  if (!ids_valid_ || computed_checksum() != stored_checksum())
+    ReassignIDs(bb_node, other_folder_node, mobile_folder_node);
+  *max_id = maximum_id_ + 1;
+  return success;
+}
+
 Value* BookmarkCodec::EncodeNode(const BookmarkNode* node) {
   DictionaryValue* value = new DictionaryValue();
   std::string id = base::Int64ToString(node->id());
@@ -191,6 +644,13 @@ bool BookmarkCodec::DecodeHelper(BookmarkNode* bb_node,
 
   roots_d_value->GetString(kMetaInfo, &model_meta_info_);
 
+  InitializePermanentNodes(bb_node, other_folder_node, mobile_folder_node);
+  return true;
+}
+
+void BookmarkCodec::InitializePermanentNodes(BookmarkNode* bb_node,
+                                             BookmarkNode* other_folder_node,
+                                             BookmarkNode* mobile_folder_node) {
   // Need to reset the type as decoding resets the type to FOLDER. Similarly
   // we need to reset the title as the title is persisted and restored from
   // the file.
@@ -202,8 +662,6 @@ bool BookmarkCodec::DecodeHelper(BookmarkNode* bb_node,
       l10n_util::GetStringUTF16(IDS_BOOKMARK_BAR_OTHER_FOLDER_NAME));
   mobile_folder_node->SetTitle(
         l10n_util::GetStringUTF16(IDS_BOOKMARK_BAR_MOBILE_FOLDER_NAME));
-
-  return true;
 }
 
 bool BookmarkCodec::DecodeChildren(const ListValue& child_value_list,
@@ -319,6 +777,235 @@ bool BookmarkCodec::DecodeNode(const DictionaryValue& value,
   return true;
 }
 
+bool BookmarkCodec::DecodeJSONHelper(JSONStream* stream,
+                                     BookmarkNode* bb_node,
+                                     BookmarkNode* other_folder_node,
+                                     BookmarkNode* mobile_folder_node) {
+  if (stream->NextType() != JSONStream::OBJECT) {
+    stream->SkipValue();
+    return false;  // Unexpected type.
+  }
+
+  // The keys are sorted in files we write, so the version only comes after
+  // the roots have been decoded.
+  bool has_version = false;
+  int version = 0;
+  bool checksum_valid = true;
+  bool has_roots = false;
+  bool roots_valid = false;
+  std::string key;
+  stream->EnterObject();
+  while (stream->NextMember(&key)) {
+    if (key == kVersionKey) {
+      has_version = stream->ReadInteger(&version);
+    } else if (key == kChecksumKey) {
+      checksum_valid = stream->ReadString(&stored_checksum_);
+    } else if (key == kRootsKey && !has_roots) {
+      has_roots = true;
+      if (stream->NextType() == JSONStream::OBJECT) {
+        roots_valid = DecodeJSONRoots(stream, bb_node, other_folder_node,
+                                      mobile_folder_node);
+      } else {
+        stream->SkipValue();
+      }
+    } else {
+      stream->SkipValue();
+    }
+  }
+  if (stream->failed() || !has_version || version != kCurrentVersion ||
+      !checksum_valid || !roots_valid) {
+    return false;
+  }
+
+  InitializePermanentNodes(bb_node, other_folder_node, mobile_folder_node);
+  return true;
+}
+
+bool BookmarkCodec::DecodeJSONRoots(JSONStream* stream,
+                                    BookmarkNode* bb_node,
+                                    BookmarkNode* other_folder_node,
+                                    BookmarkNode* mobile_folder_node) {
+  // Decode checksums the permanent folders in this order, whatever the order
+  // of the file.
+  std::vector<std::string> checksum_data[3];
+  bool has_node[3] = { false, false, false };
+  BookmarkNode* nodes[3] = { bb_node, other_folder_node, mobile_folder_node };
+  const char* keys[3] = {
+    kRootFolderNameKey, kOtherBookmarkFolderNameKey,
+    kMobileBookmarkFolderNameKey
+  };
+
+  std::string key;
+  stream->EnterObject();
+  while (stream->NextMember(&key)) {
+    if (key == kMetaInfo) {
+      stream->ReadString(&model_meta_info_);
+      continue;
+    }
+    size_t i = std::find(keys, keys + arraysize(keys), key) - keys;
+    if (i == arraysize(keys) || has_node[i] ||
+        stream->NextType() != JSONStream::OBJECT) {
+      stream->SkipValue();
+      continue;
+    }
+    has_node[i] = true;
+    DecodeJSONNode(stream, NULL, nodes[i], &checksum_data[i]);
+  }
+  if (stream->failed() || !has_node[0] || !has_node[1])
+    return false;  // Invalid type for root folder and/or other folder.
+
+  for (size_t i = 0; i < arraysize(checksum_data); ++i) {
+    checksum_data_.insert(checksum_data_.end(), checksum_data[i].begin(),
+                          checksum_data[i].end());
+  }
+
+  // See DecodeHelper.
+  if (!has_node[2] && ids_valid_)
+    ReassignIDsHelper(mobile_folder_node);
+  return true;
+}
+
+void BookmarkCodec::DecodeJSONChildren(
+    JSONStream* stream,
+    BookmarkNode* parent,
+    std::vector<std::string>* checksum_data) {
+  stream->EnterList();
+  while (stream->NextElement()) {
+    if (stream->NextType() == JSONStream::OBJECT)
+      DecodeJSONNode(stream, parent, NULL, checksum_data);
+    else
+      stream->SkipValue();
+  }
+}
+
+void BookmarkCodec::DecodeJSONNode(JSONStream* stream,
+                                   BookmarkNode* parent,
+                                   BookmarkNode* node,
+                                   std::vector<std::string>* checksum_data) {
+  // Nodes start in the order Decode checksums them.
+  const size_t checksum_index = checksum_data->size();
+  checksum_data->push_back(std::string());
+
+  // The children are decoded into the node before it is known whether the
+  // node itself is valid. If no |node| is specified, we'll create one and add
+  // it to the |parent| once it is.
+  scoped_ptr<BookmarkNode> new_node;
+  if (!node) {
+    DCHECK(parent);
+    new_node.reset(new BookmarkNode(GURL()));
+    node = new_node.get();
+  }
+
+  std::string id_string;
+  bool has_id = false;
+  std::string title;
+  std::string date_added_string;
+  bool has_date_added = false;
+  std::string type_string;
+  bool has_type = false;
+  std::string url_string;
+  bool has_url = false;
+  std::string last_modified_date;
+  bool has_last_modified_date = false;
+  bool has_children = false;
+  std::string meta_info;
+  bool has_meta_info = false;
+
+  std::string key;
+  stream->EnterObject();
+  while (stream->NextMember(&key)) {
+    if (key == kChildrenKey && stream->NextType() == JSONStream::LIST) {
+      has_children = true;
+      DecodeJSONChildren(stream, node, checksum_data);
+    } else if (key == kIdKey) {
+      has_id = stream->ReadString(&id_string);
+    } else if (key == kNameKey) {
+      stream->ReadString(&title);
+    } else if (key == kDateAddedKey) {
+      has_date_added = stream->ReadString(&date_added_string);
+    } else if (key == kTypeKey) {
+      has_type = stream->ReadString(&type_string);
+    } else if (key == kURLKey) {
+      has_url = stream->ReadString(&url_string);
+    } else if (key == kDateModifiedKey) {
+      has_last_modified_date = stream->ReadString(&last_modified_date);
+    } else if (key == kMetaInfo) {
+      has_meta_info = stream->ReadString(&meta_info);
+    } else {
+      stream->SkipValue();
+    }
+  }
+  if (stream->failed())
+    return;
+
+  int64 id = 0;
+  if (ids_valid_) {
+    if (!has_id || !base::StringToInt64(id_string, &id) || ids_.count(id)) {
+      ids_valid_ = false;
+    } else {
+      ids_.insert(id);
+    }
+  }
+
+  maximum_id_ = std::max(maximum_id_, id);
+
+  if (!has_date_added)
+    date_added_string = base::Int64ToString(Time::Now().ToInternalValue());
+  int64 internal_time;
+  base::StringToInt64(date_added_string, &internal_time);
+
+  GURL url;
+  bool valid = has_type && (type_string == kTypeURL ||
+                            type_string == kTypeFolder);
+  if (valid && type_string == kTypeURL) {
+    url = GURL(url_string);
+    valid = has_url && new_node.get() != NULL && url.is_valid();
+  } else if (valid) {
+    valid = has_children;
+  }
+  if (!valid) {
+    // Drop the node and what was decoded into it.
+    checksum_data->resize(checksum_index);
+    if (!new_node.get())
+      DeleteChildren(node);
+    return;
+  }
+
+  if (type_string == kTypeURL) {
+    // Decode ignores the children of URLs.
+    checksum_data->resize(checksum_index + 1);
+    DeleteChildren(node);
+  }
+
+  const string16 title16 = UTF8ToUTF16(title);
+  std::string& node_checksum_data = (*checksum_data)[checksum_index];
+  AppendChecksumData(id_string, &node_checksum_data);
+  AppendChecksumData(title16, &node_checksum_data);
+  node->set_id(id);
+  if (type_string == kTypeURL) {
+    node->set_url(url);
+    node->set_type(BookmarkNode::URL);
+    AppendChecksumData(std::string(kTypeURL), &node_checksum_data);
+    AppendChecksumData(url_string, &node_checksum_data);
+  } else {
+    if (!has_last_modified_date)
+      last_modified_date = base::Int64ToString(Time::Now().ToInternalValue());
+    node->set_type(BookmarkNode::FOLDER);
+    int64 modified_time;
+    base::StringToInt64(last_modified_date, &modified_time);
+    node->set_date_folder_modified(Time::FromInternalValue(modified_time));
+    AppendChecksumData(std::string(kTypeFolder), &node_checksum_data);
+  }
+
+  node->SetTitle(title16);
+  node->set_date_added(base::Time::FromInternalValue(internal_time));
+  if (has_meta_info)
+    node->set_meta_info_str(meta_info);
+
+  if (new_node.get())
+    parent->Add(new_node.release(), parent->child_count());
+}
+
 void BookmarkCodec::ReassignIDs(BookmarkNode* bb_node,
                                 BookmarkNode* other_node,
                                 BookmarkNode* mobile_node) {
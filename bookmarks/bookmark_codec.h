@@ -7,10 +7,12 @@
 
 #include <set>
 #include <string>
+#include <vector>
 
 #include "base/basictypes.h"
 #include "base/md5.h"
 #include "base/strings/string16.h"
+#include "base/strings/string_piece.h"
 
 class BookmarkModel;
 class BookmarkNode;
@@ -57,6 +59,18 @@ class BookmarkCodec {
               int64* max_node_id,
               const base::Value& value);
 
+  // Decodes the JSON text |json| as Decode decodes its parsed value, but
+  // builds the nodes straight from the text. The Value tree of a large file
+  // takes several times the memory of the text and is only needed to be
+  // walked once. Returns false, leaving the nodes empty, if |json| isn't valid
+  // JSON either; the checksums and ids are then left alone, as if there had
+  // been nothing to decode.
+  bool DecodeJSON(BookmarkNode* bb_node,
+                  BookmarkNode* other_folder_node,
+                  BookmarkNode* mobile_folder_node,
+                  int64* max_node_id,
+                  const base::StringPiece& json);
+
   // Returns the checksum computed during last encoding/decoding call.
   const std::string& computed_checksum() const { return computed_checksum_; }
 
@@ -95,6 +109,9 @@ class BookmarkCodec {
   static const char* kTypeFolder;
 
  private:
+  // Reads the JSON text for DecodeJSON.
+  class JSONStream;
+
   // Encodes node and all its children into a Value object and returns it.
   // The caller takes ownership of the returned object.
   base::Value* EncodeNode(const BookmarkNode* node);
@@ -109,6 +126,34 @@ class BookmarkCodec {
   bool DecodeChildren(const base::ListValue& child_value_list,
                       BookmarkNode* parent);
 
+  // Sets the types and titles of the permanent nodes, which aren't persisted.
+  void InitializePermanentNodes(BookmarkNode* bb_node,
+                                BookmarkNode* other_folder_node,
+                                BookmarkNode* mobile_folder_node);
+
+  // The counterparts of DecodeHelper, DecodeChildren and DecodeNode for
+  // DecodeJSON, which read the value at the position of |stream|. Malformed
+  // JSON makes |stream| fail. Nodes that can't be decoded are dropped along
+  // with their children. As folders list their children before their own id
+  // and title, each node leaves its slot in |checksum_data| to be filled in
+  // when it's done, so the checksum covers the nodes in the same order as
+  // Decode.
+  bool DecodeJSONHelper(JSONStream* stream,
+                        BookmarkNode* bb_node,
+                        BookmarkNode* other_folder_node,
+                        BookmarkNode* mobile_folder_node);
+  bool DecodeJSONRoots(JSONStream* stream,
+                       BookmarkNode* bb_node,
+                       BookmarkNode* other_folder_node,
+                       BookmarkNode* mobile_folder_node);
+  void DecodeJSONChildren(JSONStream* stream,
+                          BookmarkNode* parent,
+                          std::vector<std::string>* checksum_data);
+  void DecodeJSONNode(JSONStream* stream,
+                      BookmarkNode* parent,
+                      BookmarkNode* node,
+                      std::vector<std::string>* checksum_data);
+
   // Reassigns bookmark IDs for all nodes.
   void ReassignIDs(BookmarkNode* bb_node,
                    BookmarkNode* other_node,
@@ -166,6 +211,9 @@ class BookmarkCodec {
   // Maximum ID assigned when decoding data.
   int64 maximum_id_;
 
+  // The checksum input of the nodes DecodeJSON decoded, in order.
+  std::vector<std::string> checksum_data_;
+
   // Meta info set on bookmark model root.
   std::string model_meta_info_;
 
@@ -7,6 +7,8 @@
 #include "base/file_util.h"
 #include "base/files/file_path.h"
 #include "base/json/json_file_value_serializer.h"
+#include "base/json/json_reader.h"
+#include "base/json/json_string_value_serializer.h"
 #include "base/memory/scoped_ptr.h"
 #include "base/path_service.h"
 #include "base/strings/string_util.h"
@@ -184,6 +186,40 @@ class BookmarkCodecTest : public testing::Test {
     return model.release();
   }
 
+  bool DecodeJSON(BookmarkCodec* codec,
+                  BookmarkModel* model,
+                  const std::string& json) {
+    int64 max_id;
+    bool result = codec->DecodeJSON(AsMutable(model->bookmark_bar_node()),
+                                    AsMutable(model->other_node()),
+                                    AsMutable(model->mobile_node()),
+                                    &max_id, json);
+    model->set_next_node_id(max_id);
+    AsMutable(model->root_node())->set_meta_info_str(codec->model_meta_info());
+    return result;
+  }
+
+  // Decodes |json| with both DecodeJSON and Decode, expecting the same
+  // results.
+  void ExpectDecodeJSONMatchesDecode(const std::string& json) {
+    scoped_ptr<Value> value(base::JSONReader::Read(json));
+    ASSERT_TRUE(value.get() != NULL);
+    BookmarkCodec expected_codec;
+    BookmarkModel expected_model(NULL);
+    bool expected_result = Decode(&expected_codec, &expected_model, *value);
+
+    BookmarkCodec codec;
+    BookmarkModel model(NULL);
+    EXPECT_EQ(expected_result, DecodeJSON(&codec, &model, json));
+    AssertModelsEqual(&expected_model, &model);
+    EXPECT_EQ(expected_codec.computed_checksum(), codec.computed_checksum());
+    EXPECT_EQ(expected_codec.stored_checksum(), codec.stored_checksum());
+    EXPECT_EQ(expected_codec.ids_reassigned(), codec.ids_reassigned());
+    EXPECT_EQ(expected_model.root_node()->meta_info_str(),
+              model.root_node()->meta_info_str());
+    EXPECT_EQ(expected_model.next_node_id(), model.next_node_id());
+  }
+
   void CheckIDs(const BookmarkNode* node, std::set<int64>* assigned_ids) {
     DCHECK(node);
     int64 node_id = node->id();
@@ -387,3 +423,104 @@ TEST_F(BookmarkCodecTest, EncodeAndDecodeMetaInfo) {
   EXPECT_EQ("value2", meta_value);
   EXPECT_FALSE(child->GetMetaInfo("other_key", &meta_value));
 }
+
+TEST_F(BookmarkCodecTest, DecodeJSON) {
+  scoped_ptr<BookmarkModel> model(CreateTestModel3());
+  model->SetTitle(model->bookmark_bar_node()->GetChild(0),
+                  UTF8ToUTF16("caf\xC3\xA9 <b>\"quoted\"</b>"));
+  model->SetNodeMetaInfo(model->root_node(), "model_info", "value1");
+  model->SetNodeMetaInfo(model->bookmark_bar_node()->GetChild(1),
+                         "node_info", "value2");
+  model->AddFolder(model->mobile_node(), 0, ASCIIToUTF16(kFolder2Title));
+  std::string checksum;
+  scoped_ptr<Value> value(EncodeHelper(model.get(), &checksum));
+
+  // Serialize the value like BookmarkStorage does.
+  std::string json;
+  JSONStringValueSerializer serializer(&json);
+  serializer.set_pretty_print(true);
+  ASSERT_TRUE(serializer.Serialize(*value));
+
+  BookmarkCodec decoder;
+  BookmarkModel decoded_model(NULL);
+  ASSERT_TRUE(DecodeJSON(&decoder, &decoded_model, json));
+  EXPECT_EQ(checksum, decoder.stored_checksum());
+  EXPECT_EQ(checksum, decoder.computed_checksum());
+  EXPECT_FALSE(decoder.ids_reassigned());
+  AssertModelsEqual(model.get(), &decoded_model);
+  ExpectDecodeJSONMatchesDecode(json);
+}
+
+TEST_F(BookmarkCodecTest, DecodeJSONHandEditedFile) {
+  // Keys in any order, comments, escapes, unknown keys and a bookmark with an
+  // invalid URL, which is dropped.
+  ExpectDecodeJSONMatchesDecode(
+      "\xEF\xBB\xBF// Edited by hand.\n"
+      "{ \"version\": 1, \"checksum\": \"0123\", \"roots\": {\n"
+      "  \"other\": { \"type\": \"folder\", \"id\": \"2\", "
+      "    \"name\": \"\", \"date_added\": \"1\", "
+      "    \"date_modified\": \"2\", \"children\": [] },\n"
+      "  \"bookmark_bar\": { \"children\": [\n"
+      "    { \"type\": \"url\", \"id\": \"4\", "
+      "      \"name\": \"caf\\u00e9 \\\"\\ud83d\\ude00\\\"\", "
+      "      \"date_added\": \"3\", \"url\": \"http://a.com/\" },\n"
+      "    { \"type\": \"url\", \"id\": \"5\", \"name\": \"x\", "
+      "      \"date_added\": \"3\", \"url\": \"not a url\" },\n"
+      "    /* A folder that lists its children last. */\n"
+      "    { \"id\": \"6\", \"name\": \"f\", \"type\": \"folder\", "
+      "      \"date_added\": \"4\", \"date_modified\": \"5\", "
+      "      \"unknown\": [ 1.5e3, { \"x\": null }, true ], \"children\": [\n"
+      "        { \"type\": \"url\", \"id\": \"7\", \"name\": \"b\", "
+      "          \"date_added\": \"6\", \"url\": \"http://b.com/\", "
+      "          \"meta_info\": \"m\" } ] } ],\n"
+      "    \"type\": \"folder\", \"id\": \"1\", \"name\": \"\", "
+      "    \"date_added\": \"1\", \"date_modified\": \"2\" },\n"
+      "  \"meta_info\": \"model\" } }\n");
+}
+
+TEST_F(BookmarkCodecTest, DecodeJSONUnknownVersion) {
+  // The version comes after the roots, which are decoded by then.
+  const std::string json =
+      "{ \"roots\": { "
+      "  \"bookmark_bar\": { \"children\": [ { \"type\": \"url\", "
+      "    \"id\": \"4\", \"name\": \"a\", \"date_added\": \"3\", "
+      "    \"url\": \"http://a.com/\" } ], \"type\": \"folder\", "
+      "    \"id\": \"1\", \"date_added\": \"1\", "
+      "    \"date_modified\": \"2\" },\n"
+      "  \"other\": { \"children\": [], \"type\": \"folder\", "
+      "    \"id\": \"2\", \"date_added\": \"1\", "
+      "    \"date_modified\": \"2\" } },\n"
+      "  \"version\": 2 }";
+  scoped_ptr<Value> value(base::JSONReader::Read(json));
+  ASSERT_TRUE(value.get() != NULL);
+  BookmarkCodec expected_decoder;
+  BookmarkModel expected_model(NULL);
+  EXPECT_FALSE(Decode(&expected_decoder, &expected_model, *value));
+
+  BookmarkCodec decoder;
+  BookmarkModel decoded_model(NULL);
+  EXPECT_FALSE(DecodeJSON(&decoder, &decoded_model, json));
+  EXPECT_EQ(0, decoded_model.bookmark_bar_node()->child_count());
+  EXPECT_EQ(expected_decoder.computed_checksum(), decoder.computed_checksum());
+  EXPECT_EQ(expected_decoder.ids_reassigned(), decoder.ids_reassigned());
+  ExpectIDsUnique(&decoded_model);
+}
+
+TEST_F(BookmarkCodecTest, DecodeJSONInvalidJSON) {
+  scoped_ptr<BookmarkModel> model(CreateTestModel3());
+  std::string checksum;
+  scoped_ptr<Value> value(EncodeHelper(model.get(), &checksum));
+  std::string json;
+  JSONStringValueSerializer serializer(&json);
+  ASSERT_TRUE(serializer.Serialize(*value));
+
+  // Cut the file short in the middle of the second bookmark.
+  json.resize(json.find(kUrl2Url));
+  BookmarkCodec decoder;
+  BookmarkModel decoded_model(NULL);
+  EXPECT_FALSE(DecodeJSON(&decoder, &decoded_model, json));
+  EXPECT_EQ(0, decoded_model.bookmark_bar_node()->child_count());
+  EXPECT_EQ(0, decoded_model.other_node()->child_count());
+  EXPECT_EQ("", decoder.computed_checksum());
+  EXPECT_FALSE(decoder.ids_reassigned());
+}
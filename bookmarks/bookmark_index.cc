@@ -31,23 +31,24 @@ struct BookmarkIndex::Match {
   //
   // Use nodes_begin() and nodes_end() to get an iterator over the set as
   // it handles the necessary switching between nodes and terms.front().
-  NodeSet nodes;
+  NodeVector nodes;
 
   // Returns an iterator to the beginning of the matching nodes. See
   // description of nodes for why this should be used over nodes.begin().
-  NodeSet::const_iterator nodes_begin() const;
+  NodeVector::const_iterator nodes_begin() const;
 
   // Returns an iterator to the beginning of the matching nodes. See
   // description of nodes for why this should be used over nodes.end().
-  NodeSet::const_iterator nodes_end() const;
+  NodeVector::const_iterator nodes_end() const;
 };
 
-BookmarkIndex::NodeSet::const_iterator
+BookmarkIndex::NodeVector::const_iterator
     BookmarkIndex::Match::nodes_begin() const {
   return nodes.empty() ? terms.front()->second.begin() : nodes.begin();
 }
 
-BookmarkIndex::NodeSet::const_iterator BookmarkIndex::Match::nodes_end() const {
+BookmarkIndex::NodeVector::const_iterator
+    BookmarkIndex::Match::nodes_end() const {
   return nodes.empty() ? terms.front()->second.end() : nodes.end();
 }
 
@@ -66,6 +67,45 @@ void BookmarkIndex::Add(const BookmarkNode* node) {
     RegisterNode(terms[i], node);
 }
 
+void BookmarkIndex::AddNodes(const std::vector<const BookmarkNode*>& nodes) {
+  typedef std::pair<string16, const BookmarkNode*> TermNodePair;
+  std::vector<TermNodePair> pairs;
+  for (size_t i = 0; i < nodes.size(); ++i) {
+    if (!nodes[i]->is_url())
+      continue;
+    std::vector<string16> terms = ExtractQueryWords(nodes[i]->GetTitle());
+    for (size_t j = 0; j < terms.size(); ++j)
+      pairs.push_back(TermNodePair(terms[j], nodes[i]));
+  }
+  std::sort(pairs.begin(), pairs.end());
+  pairs.erase(std::unique(pairs.begin(), pairs.end()), pairs.end());
+
+  // The terms arrive in order, so inserting each one next to the previous one
+  // takes amortized constant time, and each posting list is built in one go.
+  Index::iterator hint = index_.begin();
+  for (size_t begin = 0; begin < pairs.size(); ) {
+    size_t end = begin + 1;
+    while (end < pairs.size() && pairs[end].first == pairs[begin].first)
+      ++end;
+    hint = index_.insert(hint, Index::value_type(pairs[begin].first,
+                                                 NodeVector()));
+    NodeVector run;
+    run.reserve(end - begin);
+    for (size_t i = begin; i < end; ++i)
+      run.push_back(pairs[i].second);
+    if (hint->second.empty()) {
+      hint->second.swap(run);
+    } else {
+      // Patch in nodes for a term that was already indexed.
+      NodeVector merged;
+      std::set_union(hint->second.begin(), hint->second.end(),
+                     run.begin(), run.end(), std::back_inserter(merged));
+      hint->second.swap(merged);
+    }
+    begin = end;
+  }
+}
+
 void BookmarkIndex::Remove(const BookmarkNode* node) {
   if (!node->is_url())
     return;
@@ -135,7 +175,7 @@ void BookmarkIndex::ExtractBookmarkNodePairs(
     const Match& match,
     NodeTypedCountPairs* node_typed_counts) const {
 
-  for (NodeSet::const_iterator i = match.nodes_begin();
+  for (NodeVector::const_iterator i = match.nodes_begin();
        i != match.nodes_end(); ++i) {
     history::URLRow url;
     if (url_db)
@@ -212,10 +252,10 @@ void BookmarkIndex::CombineMatchesInPlace(const Index::const_iterator& index_i,
                                           Matches* matches) {
   for (size_t i = 0; i < matches->size(); ) {
     Match* match = &((*matches)[i]);
-    NodeSet intersection;
+    NodeVector intersection;
     std::set_intersection(match->nodes_begin(), match->nodes_end(),
                           index_i->second.begin(), index_i->second.end(),
-                          std::inserter(intersection, intersection.begin()));
+                          std::back_inserter(intersection));
     if (intersection.empty()) {
       matches->erase(matches->begin() + i);
     } else {
@@ -231,10 +271,10 @@ void BookmarkIndex::CombineMatches(const Index::const_iterator& index_i,
                                    Matches* result) {
   for (size_t i = 0; i < current_matches.size(); ++i) {
     const Match& match = current_matches[i];
-    NodeSet intersection;
+    NodeVector intersection;
     std::set_intersection(match.nodes_begin(), match.nodes_end(),
                           index_i->second.begin(), index_i->second.end(),
-                          std::inserter(intersection, intersection.begin()));
+                          std::back_inserter(intersection));
     if (!intersection.empty()) {
       result->push_back(Match());
       Match& combined_match = result->back();
@@ -258,7 +298,10 @@ std::vector<string16> BookmarkIndex::ExtractQueryWords(const string16& query) {
 
 void BookmarkIndex::RegisterNode(const string16& term,
                                  const BookmarkNode* node) {
-  index_[term].insert(node);
+  NodeVector& nodes = index_[term];
+  NodeVector::iterator i = std::lower_bound(nodes.begin(), nodes.end(), node);
+  if (i == nodes.end() || *i != node)
+    nodes.insert(i, node);
 }
 
 void BookmarkIndex::UnregisterNode(const string16& term,
@@ -269,7 +312,10 @@ void BookmarkIndex::UnregisterNode(const string16& term,
     // example, a bookmark with the title 'foo foo' would end up here.
     return;
   }
-  i->second.erase(node);
+  NodeVector::iterator node_i =
+      std::lower_bound(i->second.begin(), i->second.end(), node);
+  if (node_i != i->second.end() && *node_i == node)
+    i->second.erase(node_i);
   if (i->second.empty())
     index_.erase(i);
 }
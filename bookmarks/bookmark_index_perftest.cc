@@ -0,0 +1,138 @@
+// Copyright 2013 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Benchmarks title queries of |BookmarkIndex| on a synthetic bookmark model.
+// Each query is run a few times untimed first, so that the numbers do not
+// include the cost of warming up the caches. The queries are then timed in
+// several rounds, and the mean and standard deviation of the time per query
+// are printed in the perf_test RESULT format so that they can be tracked by
+// the perf bots.
+
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include "base/memory/scoped_ptr.h"
+#include "base/rand_util.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/strings/stringprintf.h"
+#include "base/strings/utf_string_conversions.h"
+#include "base/time/time.h"
+#include "chrome/browser/bookmarks/bookmark_model.h"
+#include "chrome/browser/bookmarks/bookmark_title_match.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_test.h"
+#include "url/gurl.h"
+
+using base::TimeTicks;
+
+namespace {
+
+// The number of bookmarks in the model, a large but real-world profile.
+const size_t kNumBookmarks = 10000;
+
+// The number of words in each bookmark title, and the number of distinct
+// words they are drawn from.
+const size_t kWordsPerTitle = 5;
+const size_t kVocabularySize = 2000;
+
+// The number of untimed runs of the queries, and of timed rounds.
+const int kNumWarmUpRuns = 2;
+const int kNumRounds = 10;
+
+// The maximum number of matches asked for, as the omnibox does.
+const size_t kMaxMatches = 10;
+
+std::string GetWord(size_t index) {
+  return "word" + base::IntToString(static_cast<int>(index));
+}
+
+class BookmarkIndexPerfTest : public testing::Test {
+ protected:
+  BookmarkIndexPerfTest() : model_(new BookmarkModel(NULL)) {}
+
+  virtual void SetUp() OVERRIDE {
+    for (size_t i = 0; i < kNumBookmarks; ++i) {
+      std::string title;
+      for (size_t j = 0; j < kWordsPerTitle; ++j) {
+        if (j)
+          title += ' ';
+        title += GetWord(base::RandGenerator(kVocabularySize));
+      }
+      model_->AddURL(model_->other_node(), static_cast<int>(i),
+                     ASCIIToUTF16(title),
+                     GURL(base::StringPrintf("http://www.%d.com/",
+                                             static_cast<int>(i))));
+    }
+  }
+
+  // Runs each of |queries| |kNumWarmUpRuns| times, then times them in
+  // |kNumRounds| rounds and prints the time per query.
+  void TimeQueries(const std::string& trace,
+                   const std::vector<string16>& queries) {
+    std::vector<BookmarkTitleMatch> matches;
+    for (int i = 0; i < kNumWarmUpRuns; ++i) {
+      for (size_t j = 0; j < queries.size(); ++j) {
+        matches.clear();
+        model_->GetBookmarksWithTitlesMatching(queries[j], kMaxMatches,
+                                               &matches);
+      }
+    }
+
+    std::vector<double> samples;
+    for (int i = 0; i < kNumRounds; ++i) {
+      const TimeTicks start = TimeTicks::Now();
+      for (size_t j = 0; j < queries.size(); ++j) {
+        matches.clear();
+        model_->GetBookmarksWithTitlesMatching(queries[j], kMaxMatches,
+                                               &matches);
+      }
+      samples.push_back((TimeTicks::Now() - start).InMicrosecondsF() /
+                        queries.size());
+    }
+
+    double mean = 0;
+    for (size_t i = 0; i < samples.size(); ++i)
+      mean += samples[i];
+    mean /= samples.size();
+    double variance = 0;
+    for (size_t i = 0; i < samples.size(); ++i)
+      variance += (samples[i] - mean) * (samples[i] - mean);
+    variance /= samples.size();
+
+    perf_test::PrintResultMeanAndError(
+        "BookmarkIndexQuery", std::string(), trace,
+        base::StringPrintf("%f,%f", mean, std::sqrt(variance)), "us", true);
+  }
+
+  scoped_ptr<BookmarkModel> model_;
+};
+
+}  // namespace
+
+TEST_F(BookmarkIndexPerfTest, SingleWord) {
+  std::vector<string16> queries;
+  for (size_t i = 0; i < kVocabularySize; i += 10)
+    queries.push_back(ASCIIToUTF16(GetWord(i)));
+  TimeQueries("single_word", queries);
+}
+
+// Two words, most of which are not in the same title, exercise the
+// intersection of the posting lists.
+TEST_F(BookmarkIndexPerfTest, TwoWords) {
+  std::vector<string16> queries;
+  for (size_t i = 0; i < kVocabularySize; i += 10) {
+    queries.push_back(ASCIIToUTF16(
+        GetWord(i) + " " + GetWord((i * 7 + 1) % kVocabularySize)));
+  }
+  TimeQueries("two_words", queries);
+}
+
+// A prefix, as typed in the omnibox, matches many words of the index.
+TEST_F(BookmarkIndexPerfTest, Prefix) {
+  std::vector<string16> queries;
+  for (int i = 1; i < 20; ++i)
+    queries.push_back(ASCIIToUTF16("word" + base::IntToString(i)));
+  TimeQueries("prefix", queries);
+}
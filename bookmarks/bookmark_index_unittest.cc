@@ -4,9 +4,11 @@
 
 #include "chrome/browser/bookmarks/bookmark_index.h"
 
+#include <set>
 #include <string>
 #include <vector>
 
+#include "base/memory/scoped_vector.h"
 #include "base/message_loop/message_loop.h"
 #include "base/strings/string_number_conversions.h"
 #include "base/strings/string_split.h"
@@ -310,3 +312,58 @@ TEST_F(BookmarkIndexTest, GetResultsSortedByTypedCount) {
   EXPECT_EQ(data[0].url, matches[0].node->url());
   EXPECT_EQ(data[3].url, matches[1].node->url());
 }
+
+// Makes sure an index built in bulk answers queries like one built a node at
+// a time, and keeps doing so as nodes are added and removed.
+TEST_F(BookmarkIndexTest, AddNodes) {
+  const char* titles[] = {
+    "abc def", "abcd", "xyz abc", "def ghi", "abc abc", "ghi", "Def Xyz",
+  };
+  ScopedVector<BookmarkNode> nodes;
+  std::vector<const BookmarkNode*> node_ptrs;
+  for (size_t i = 0; i < arraysize(titles); ++i) {
+    BookmarkNode* node = new BookmarkNode(GURL("http://www.google.com"));
+    node->SetTitle(ASCIIToUTF16(titles[i]));
+    nodes.push_back(node);
+    node_ptrs.push_back(node);
+  }
+
+  // Bulk add all but the last node, then patch in the last one.
+  BookmarkIndex bulk_index(NULL);
+  bulk_index.AddNodes(std::vector<const BookmarkNode*>(
+      node_ptrs.begin(), node_ptrs.end() - 1));
+  bulk_index.Add(node_ptrs.back());
+  BookmarkIndex incremental_index(NULL);
+  for (size_t i = 0; i < node_ptrs.size(); ++i)
+    incremental_index.Add(node_ptrs[i]);
+
+  const char* queries[] = {
+    "abc", "ab", "def", "abc def", "xyz", "g", "def x",
+  };
+  for (int pass = 0; pass < 2; ++pass) {
+    for (size_t i = 0; i < arraysize(queries); ++i) {
+      std::vector<BookmarkTitleMatch> bulk_matches;
+      bulk_index.GetBookmarksWithTitlesMatching(ASCIIToUTF16(queries[i]), 100,
+                                                &bulk_matches);
+      std::vector<BookmarkTitleMatch> incremental_matches;
+      incremental_index.GetBookmarksWithTitlesMatching(
+          ASCIIToUTF16(queries[i]), 100, &incremental_matches);
+      std::set<const BookmarkNode*> bulk_nodes;
+      for (size_t j = 0; j < bulk_matches.size(); ++j)
+        bulk_nodes.insert(bulk_matches[j].node);
+      std::set<const BookmarkNode*> incremental_nodes;
+      for (size_t j = 0; j < incremental_matches.size(); ++j)
+        incremental_nodes.insert(incremental_matches[j].node);
+      EXPECT_EQ(incremental_nodes.size(), bulk_matches.size()) << queries[i];
+      EXPECT_TRUE(bulk_nodes == incremental_nodes) << queries[i];
+    }
+    // Repeat after removing a node from both.
+    bulk_index.Remove(node_ptrs[0]);
+    incremental_index.Remove(node_ptrs[0]);
+  }
+
+  std::vector<BookmarkTitleMatch> matches;
+  bulk_index.GetBookmarksWithTitlesMatching(ASCIIToUTF16("abc"), 100,
+                                            &matches);
+  EXPECT_EQ(3U, matches.size());
+}
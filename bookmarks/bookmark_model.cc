@@ -377,7 +377,7 @@ void BookmarkModel::Move(const BookmarkNode* node,
   mutable_new_parent->Add(AsMutable(node), index);
 
   if (store_.get())
-    store_->ScheduleSave();
+    store_->NodeMoved(node);
 
   FOR_EACH_OBSERVER(BookmarkModelObserver, observers_,
                     BookmarkNodeMoved(this, old_parent, old_index,
@@ -403,11 +403,8 @@ void BookmarkModel::Copy(const BookmarkNode* node,
   BookmarkNodeData drag_data(node);
   std::vector<BookmarkNodeData::Element> elements(drag_data.elements);
   // CloneBookmarkNode will use BookmarkModel methods to do the job, so we
-  // don't need to send notifications here.
+  // don't need to send notifications or save here.
   bookmark_utils::CloneBookmarkNode(this, elements, new_parent, index, true);
-
-  if (store_.get())
-    store_->ScheduleSave();
 }
 
 const gfx::Image& BookmarkModel::GetFavicon(const BookmarkNode* node) {
@@ -443,7 +440,7 @@ void BookmarkModel::SetTitle(const BookmarkNode* node, const string16& title) {
   index_->Add(node);
 
   if (store_.get())
-    store_->ScheduleSave();
+    store_->NodeTitleChanged(node);
 
   FOR_EACH_OBSERVER(BookmarkModelObserver, observers_,
                     BookmarkNodeChanged(this, node));
@@ -525,7 +522,7 @@ void BookmarkModel::SetDateAdded(const BookmarkNode* node,
 
   // Syncing might result in dates newer than the folder's last modified date.
   if (date_added > node->parent()->date_folder_modified()) {
-    // Will trigger store_->ScheduleSave().
+    // Will tell the store about the change.
     SetDateFolderModified(node->parent(), date_added);
   } else if (store_.get()) {
     store_->ScheduleSave();
@@ -700,7 +697,7 @@ void BookmarkModel::SetDateFolderModified(const BookmarkNode* parent,
   AsMutable(parent)->set_date_folder_modified(time);
 
   if (store_.get())
-    store_->ScheduleSave();
+    store_->NodeDateFolderModifiedChanged(parent);
 }
 
 void BookmarkModel::ResetDateFolderModified(const BookmarkNode* node) {
@@ -840,7 +837,7 @@ void BookmarkModel::RemoveAndDeleteNode(BookmarkNode* delete_me) {
   }
 
   if (store_.get())
-    store_->ScheduleSave();
+    store_->NodeRemoved(node.get());
 
   NotifyHistoryAboutRemovedBookmarks(removed_urls);
 
@@ -896,7 +893,7 @@ BookmarkNode* BookmarkModel::AddNode(BookmarkNode* parent,
   parent->Add(node, index);
 
   if (store_.get())
-    store_->ScheduleSave();
+    store_->NodeAdded(node);
 
   FOR_EACH_OBSERVER(BookmarkModelObserver, observers_,
                     BookmarkNodeAdded(this, parent, index));
@@ -8,6 +8,7 @@
 #include "base/memory/singleton.h"
 #include "base/values.h"
 #include "chrome/browser/bookmarks/bookmark_model.h"
+#include "chrome/browser/performance_monitor/startup_tracer.h"
 #include "chrome/browser/profiles/incognito_helpers.h"
 #include "chrome/browser/profiles/profile.h"
 #include "chrome/browser/profiles/startup_task_runner_service.h"
@@ -42,6 +43,8 @@ BookmarkModelFactory::~BookmarkModelFactory() {}
 
 BrowserContextKeyedService* BookmarkModelFactory::BuildServiceInstanceFor(
     content::BrowserContext* context) const {
+  performance_monitor::ScopedStartupPhase startup_phase(
+      "BookmarkModelFactory::BuildServiceInstanceFor");
   Profile* profile = static_cast<Profile*>(context);
   BookmarkModel* bookmark_model = new BookmarkModel(profile);
   bookmark_model->Load(StartupTaskRunnerServiceFactory::GetForProfile(profile)->
@@ -4,22 +4,35 @@
 
 #include "chrome/browser/bookmarks/bookmark_storage.h"
 
+#include <algorithm>
+#include <vector>
+
 #include "base/bind.h"
 #include "base/compiler_specific.h"
+#include "base/containers/hash_tables.h"
 #include "base/file_util.h"
 #include "base/files/file_path.h"
-#include "base/json/json_file_value_serializer.h"
+#include "base/files/important_file_writer.h"
+#include "base/files/memory_mapped_file.h"
+#include "base/json/json_reader.h"
 #include "base/json/json_string_value_serializer.h"
+#include "base/json/json_writer.h"
 #include "base/metrics/histogram.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/strings/string_piece.h"
 #include "base/time/time.h"
+#include "base/values.h"
 #include "chrome/browser/bookmarks/bookmark_codec.h"
 #include "chrome/browser/bookmarks/bookmark_index.h"
 #include "chrome/browser/bookmarks/bookmark_model.h"
+#include "chrome/browser/performance_monitor/startup_tracer.h"
 #include "chrome/common/chrome_constants.h"
 #include "components/startup_metric_utils/startup_metric_utils.h"
 #include "content/public/browser/browser_context.h"
 #include "content/public/browser/browser_thread.h"
 
+using base::DictionaryValue;
+using base::Time;
 using base::TimeTicks;
 using content::BrowserThread;
 
@@ -28,23 +41,303 @@ namespace {
 // Extension used for backup files (copy of main file created during startup).
 const base::FilePath::CharType kBackupExtension[] = FILE_PATH_LITERAL("bak");
 
+// Extension used for the journal of changes since the file was last saved.
+const base::FilePath::CharType kJournalExtension[] =
+    FILE_PATH_LITERAL("journal");
+
 // How often we save.
 const int kSaveDelayMS = 2500;
 
+// How often the queued journal records are appended to the journal.
+const int kJournalDelayMS = 500;
+
+// Once the journal holds this many records, or bytes, the bookmarks are saved
+// in full, which starts a new journal. This keeps loading fast and the
+// journal small compared to the file.
+const size_t kMaxJournalRecords = 1000;
+const size_t kMaxJournalSize = 256 * 1024;
+
+// Keys of the journal. The header, which is the first line, holds
+// kChecksumKey. Every other line is a record holding kOperationKey and the
+// keys of BookmarkCodec the operation needs.
+const char kChecksumKey[] = "checksum";
+const char kOperationKey[] = "op";
+const char kParentKey[] = "parent";
+const char kIndexKey[] = "index";
+
+// Values of kOperationKey.
+const char kOperationAdd[] = "add";
+const char kOperationRemove[] = "remove";
+const char kOperationMove[] = "move";
+const char kOperationSetTitle[] = "title";
+const char kOperationSetDateFolderModified[] = "folder_modified";
+
+typedef base::hash_map<int64, BookmarkNode*> IDToNodeMap;
+
 void BackupCallback(const base::FilePath& path) {
   base::FilePath backup_path = path.ReplaceExtension(kBackupExtension);
   base::CopyFile(path, backup_path);
 }
 
-// Adds node to the model's index, recursing through all children as well.
-void AddBookmarksToIndex(BookmarkLoadDetails* details,
-                         BookmarkNode* node) {
+// Returns the header line of the journal for the bookmarks file with
+// |checksum|.
+std::string CreateJournalHeader(const std::string& checksum) {
+  DictionaryValue header;
+  header.SetString(kChecksumKey, checksum);
+  std::string line;
+  base::JSONWriter::Write(&header, &line);
+  return line + "\n";
+}
+
+// Returns a journal record of |operation| on |node|. The caller owns the
+// record.
+DictionaryValue* CreateJournalRecord(const char* operation,
+                                     const BookmarkNode* node) {
+  DictionaryValue* record = new DictionaryValue;
+  record->SetString(kOperationKey, operation);
+  record->SetString(BookmarkCodec::kIdKey, base::Int64ToString(node->id()));
+  return record;
+}
+
+// Adds the current parent and index of |node| to |record|.
+void SetJournalRecordPosition(const BookmarkNode* node,
+                              DictionaryValue* record) {
+  record->SetString(kParentKey, base::Int64ToString(node->parent()->id()));
+  record->SetInteger(kIndexKey, node->parent()->GetIndexOf(node));
+}
+
+bool GetJournalRecordTime(const DictionaryValue& record,
+                          const char* key,
+                          Time* time) {
+  std::string value;
+  int64 internal_value;
+  if (!record.GetString(key, &value) ||
+      !base::StringToInt64(value, &internal_value)) {
+    return false;
+  }
+  *time = Time::FromInternalValue(internal_value);
+  return true;
+}
+
+// Returns the node the id stored under |key| in |record| refers to, or NULL.
+BookmarkNode* GetJournalRecordNode(const DictionaryValue& record,
+                                   const char* key,
+                                   const IDToNodeMap& nodes) {
+  std::string value;
+  int64 id;
+  if (!record.GetString(key, &value) || !base::StringToInt64(value, &id))
+    return NULL;
+  IDToNodeMap::const_iterator i = nodes.find(id);
+  return i == nodes.end() ? NULL : i->second;
+}
+
+// Adds |node| and its descendants to |nodes|.
+void MapNodes(BookmarkNode* node, IDToNodeMap* nodes) {
+  (*nodes)[node->id()] = node;
+  for (int i = 0; i < node->child_count(); ++i)
+    MapNodes(node->GetChild(i), nodes);
+}
+
+// Removes |node| and its descendants from |nodes|.
+void UnmapNodes(BookmarkNode* node, IDToNodeMap* nodes) {
+  nodes->erase(node->id());
+  for (int i = 0; i < node->child_count(); ++i)
+    UnmapNodes(node->GetChild(i), nodes);
+}
+
+// Creates the node a kOperationAdd record describes, or returns NULL if
+// |record| is malformed.
+BookmarkNode* CreateNodeFromJournalRecord(const DictionaryValue& record) {
+  std::string id_string;
+  int64 id;
+  std::string type;
+  string16 title;
+  Time date_added;
+  if (!record.GetString(BookmarkCodec::kIdKey, &id_string) ||
+      !base::StringToInt64(id_string, &id) ||
+      !record.GetString(BookmarkCodec::kTypeKey, &type) ||
+      !record.GetString(BookmarkCodec::kNameKey, &title) ||
+      !GetJournalRecordTime(record, BookmarkCodec::kDateAddedKey,
+                            &date_added)) {
+    return NULL;
+  }
+
+  scoped_ptr<BookmarkNode> node;
+  if (type == BookmarkCodec::kTypeURL) {
+    std::string url;
+    if (!record.GetString(BookmarkCodec::kURLKey, &url))
+      return NULL;
+    node.reset(new BookmarkNode(id, GURL(url)));
+    node->set_type(BookmarkNode::URL);
+  } else if (type == BookmarkCodec::kTypeFolder) {
+    Time date_folder_modified;
+    if (!GetJournalRecordTime(record, BookmarkCodec::kDateModifiedKey,
+                              &date_folder_modified)) {
+      return NULL;
+    }
+    node.reset(new BookmarkNode(id, GURL()));
+    node->set_type(BookmarkNode::FOLDER);
+    node->set_date_folder_modified(date_folder_modified);
+  } else {
+    return NULL;
+  }
+  node->SetTitle(title);
+  node->set_date_added(date_added);
+  std::string meta_info;
+  if (record.GetString(BookmarkCodec::kMetaInfo, &meta_info))
+    node->set_meta_info_str(meta_info);
+  return node.release();
+}
+
+// Applies the journal |record| to the nodes in |nodes|, updating |max_id|.
+// Returns false, without changing anything, if |record| is malformed or
+// doesn't apply to the nodes.
+bool ApplyJournalRecord(const DictionaryValue& record,
+                        IDToNodeMap* nodes,
+                        int64* max_id) {
+  std::string operation;
+  if (!record.GetString(kOperationKey, &operation))
+    return false;
+
+  if (operation == kOperationAdd) {
+    BookmarkNode* parent = GetJournalRecordNode(record, kParentKey, *nodes);
+    int index;
+    if (!parent || !parent->is_folder() ||
+        !record.GetInteger(kIndexKey, &index) || index < 0 ||
+        index > parent->child_count()) {
+      return false;
+    }
+    scoped_ptr<BookmarkNode> node(CreateNodeFromJournalRecord(record));
+    if (!node.get() || nodes->count(node->id()))
+      return false;
+    *max_id = std::max(*max_id, node->id() + 1);
+    (*nodes)[node->id()] = node.get();
+    parent->Add(node.release(), index);
+    return true;
+  }
+
+  BookmarkNode* node =
+      GetJournalRecordNode(record, BookmarkCodec::kIdKey, *nodes);
+  if (!node)
+    return false;
+
+  if (operation == kOperationRemove) {
+    // The permanent nodes have no parent here and can't be removed.
+    if (!node->parent())
+      return false;
+    UnmapNodes(node, nodes);
+    delete node->parent()->Remove(node);
+    return true;
+  }
+
+  if (operation == kOperationMove) {
+    BookmarkNode* new_parent =
+        GetJournalRecordNode(record, kParentKey, *nodes);
+    int index;
+    if (!node->parent() || !new_parent || !new_parent->is_folder() ||
+        new_parent->HasAncestor(node) ||
+        !record.GetInteger(kIndexKey, &index) || index < 0) {
+      return false;
+    }
+    // |index| is the position after the node was taken out of its old parent.
+    int child_count = new_parent->child_count();
+    if (node->parent() == new_parent)
+      --child_count;
+    if (index > child_count)
+      return false;
+    new_parent->Add(node->parent()->Remove(node), index);
+    return true;
+  }
+
+  if (operation == kOperationSetTitle) {
+    string16 title;
+    if (!record.GetString(BookmarkCodec::kNameKey, &title))
+      return false;
+    node->SetTitle(title);
+    return true;
+  }
+
+  if (operation == kOperationSetDateFolderModified) {
+    Time date_folder_modified;
+    if (!node->is_folder() ||
+        !GetJournalRecordTime(record, BookmarkCodec::kDateModifiedKey,
+                              &date_folder_modified)) {
+      return false;
+    }
+    node->set_date_folder_modified(date_folder_modified);
+    return true;
+  }
+
+  return false;
+}
+
+// Replays the journal at |journal_path| onto the nodes of |details|, provided
+// it was started for the bookmarks file with |checksum|. Replay stops at the
+// first record that is incomplete, which is expected after a crash while
+// appending, or doesn't apply. Afterwards the journal is trimmed to the
+// records that were replayed, or replaced by an empty one, so that further
+// records can be appended to it.
+void ReplayJournal(const base::FilePath& journal_path,
+                   const std::string& checksum,
+                   BookmarkLoadDetails* details) {
+  std::string journal;
+  const std::string header = CreateJournalHeader(checksum);
+  base::ReadFileToString(journal_path, &journal);
+  if (journal.compare(0, header.size(), header) != 0) {
+    // There is no journal or it belongs to an older file: the journal is only
+    // replaced after the file it applies to, and the newer file contains
+    // all of its changes.
+    journal.clear();
+  }
+
+  IDToNodeMap nodes;
+  MapNodes(details->bb_node(), &nodes);
+  MapNodes(details->other_folder_node(), &nodes);
+  MapNodes(details->mobile_folder_node(), &nodes);
+  int64 max_id = details->max_id();
+
+  int record_count = 0;
+  size_t valid_size = journal.empty() ? 0 : header.size();
+  while (valid_size < journal.size()) {
+    size_t end = journal.find('\n', valid_size);
+    if (end == std::string::npos)
+      break;
+    scoped_ptr<Value> value(base::JSONReader::Read(
+        journal.substr(valid_size, end - valid_size)));
+    DictionaryValue* record = NULL;
+    if (!value.get() || !value->GetAsDictionary(&record) ||
+        !ApplyJournalRecord(*record, &nodes, &max_id)) {
+      break;
+    }
+    valid_size = end + 1;
+    ++record_count;
+  }
+  UMA_HISTOGRAM_COUNTS("Bookmarks.JournalRecordsReplayed", record_count);
+  details->set_max_id(max_id);
+  details->set_journal_record_count(record_count);
+
+  if (!valid_size || valid_size != journal.size()) {
+    journal.resize(valid_size);
+    if (journal.empty())
+      journal = header;
+    if (!base::ImportantFileWriter::WriteFileAtomically(journal_path,
+                                                        journal)) {
+      return;
+    }
+  }
+  details->set_journal_valid(true);
+}
+
+// Adds node to |nodes| for the model's index, recursing through all children
+// as well.
+void CollectBookmarksToIndex(BookmarkNode* node,
+                             std::vector<const BookmarkNode*>* nodes) {
   if (node->is_url()) {
     if (node->url().is_valid())
-      details->index()->Add(node);
+      nodes->push_back(node);
   } else {
     for (int i = 0; i < node->child_count(); ++i)
-      AddBookmarksToIndex(details, node->GetChild(i));
+      CollectBookmarksToIndex(node->GetChild(i), nodes);
   }
 }
 
@@ -53,19 +346,24 @@ void LoadCallback(const base::FilePath& path,
                   BookmarkLoadDetails* details) {
   startup_metric_utils::ScopedSlowStartupUMA
       scoped_timer("Startup.SlowStartupBookmarksLoad");
+  performance_monitor::ScopedStartupPhase startup_phase(
+      "BookmarkStorage::LoadBookmarks");
   bool bookmark_file_exists = base::PathExists(path);
   if (bookmark_file_exists) {
-    JSONFileValueSerializer serializer(path);
-    scoped_ptr<Value> root(serializer.Deserialize(NULL, NULL));
-
-    if (root.get()) {
+    // The nodes are decoded straight from the mapped file. Parsing it into a
+    // Value first would take several times the size of the file.
+    base::MemoryMappedFile file;
+    if (file.Initialize(path)) {
       // Building the index can take a while, so we do it on the background
       // thread.
       int64 max_node_id = 0;
       BookmarkCodec codec;
       TimeTicks start_time = TimeTicks::Now();
-      codec.Decode(details->bb_node(), details->other_folder_node(),
-                   details->mobile_folder_node(), &max_node_id, *root.get());
+      bool decoded = codec.DecodeJSON(
+          details->bb_node(), details->other_folder_node(),
+          details->mobile_folder_node(), &max_node_id,
+          base::StringPiece(reinterpret_cast<const char*>(file.data()),
+                            file.length()));
       details->set_max_id(std::max(max_node_id, details->max_id()));
       details->set_computed_checksum(codec.computed_checksum());
       details->set_stored_checksum(codec.stored_checksum());
@@ -74,10 +372,19 @@ void LoadCallback(const base::FilePath& path,
       UMA_HISTOGRAM_TIMES("Bookmarks.DecodeTime",
                           TimeTicks::Now() - start_time);
 
+      // Reassigned ids no longer match the ones in the journal. The model
+      // saves the bookmarks again in that case, which starts a new journal.
+      if (decoded && !codec.ids_reassigned()) {
+        ReplayJournal(path.ReplaceExtension(kJournalExtension),
+                      codec.stored_checksum(), details);
+      }
+
       start_time = TimeTicks::Now();
-      AddBookmarksToIndex(details, details->bb_node());
-      AddBookmarksToIndex(details, details->other_folder_node());
-      AddBookmarksToIndex(details, details->mobile_folder_node());
+      std::vector<const BookmarkNode*> nodes;
+      CollectBookmarksToIndex(details->bb_node(), &nodes);
+      CollectBookmarksToIndex(details->other_folder_node(), &nodes);
+      CollectBookmarksToIndex(details->mobile_folder_node(), &nodes);
+      details->index()->AddNodes(nodes);
       UMA_HISTOGRAM_TIMES("Bookmarks.CreateBookmarkIndexTime",
                           TimeTicks::Now() - start_time);
     }
@@ -88,6 +395,38 @@ void LoadCallback(const base::FilePath& path,
       base::Bind(&BookmarkStorage::OnLoadFinished, storage));
 }
 
+// Writes |value| to the bookmarks file at |path|, then starts a new journal
+// for it at |journal_path|.
+void SaveCallback(const base::FilePath& path,
+                  const base::FilePath& journal_path,
+                  scoped_ptr<Value> value,
+                  const std::string& checksum) {
+  std::string data;
+  JSONStringValueSerializer serializer(&data);
+  serializer.set_pretty_print(true);
+  // Without the new file, the old journal would be replayed on an outdated
+  // file. Drop it; changes would be lost either way.
+  if (!serializer.Serialize(*value) ||
+      !base::ImportantFileWriter::WriteFileAtomically(path, data)) {
+    base::DeleteFile(journal_path, false);
+    return;
+  }
+  // Crashing before the new journal is in place leaves the old one, whose
+  // header no longer matches the file, so it is ignored when loading.
+  if (!base::ImportantFileWriter::WriteFileAtomically(
+          journal_path, CreateJournalHeader(checksum))) {
+    base::DeleteFile(journal_path, false);
+  }
+}
+
+// Appends |records| to the journal. AppendToFile fails if the journal doesn't
+// exist, which is what we want: records must follow a header.
+void AppendToJournalCallback(const base::FilePath& journal_path,
+                             const std::string& records) {
+  file_util::AppendToFile(journal_path, records.data(),
+                          static_cast<int>(records.size()));
+}
+
 }  // namespace
 
 // BookmarkLoadDetails ---------------------------------------------------------
@@ -103,7 +442,9 @@ BookmarkLoadDetails::BookmarkLoadDetails(
       mobile_folder_node_(mobile_folder_node),
       index_(index),
       max_id_(max_id),
-      ids_reassigned_(false) {
+      ids_reassigned_(false),
+      journal_valid_(false),
+      journal_record_count_(0) {
 }
 
 BookmarkLoadDetails::~BookmarkLoadDetails() {
@@ -116,17 +457,18 @@ BookmarkStorage::BookmarkStorage(
     BookmarkModel* model,
     base::SequencedTaskRunner* sequenced_task_runner)
     : model_(model),
-      writer_(context->GetPath().Append(chrome::kBookmarksFileName),
-              sequenced_task_runner) {
+      path_(context->GetPath().Append(chrome::kBookmarksFileName)),
+      journal_path_(path_.ReplaceExtension(kJournalExtension)),
+      journal_valid_(false),
+      journal_record_count_(0),
+      journal_size_(0) {
   sequenced_task_runner_ = sequenced_task_runner;
-  writer_.set_commit_interval(base::TimeDelta::FromMilliseconds(kSaveDelayMS));
   sequenced_task_runner_->PostTask(FROM_HERE,
-                                   base::Bind(&BackupCallback, writer_.path()));
+                                   base::Bind(&BackupCallback, path_));
 }
 
 BookmarkStorage::~BookmarkStorage() {
-  if (writer_.HasPendingWrite())
-    writer_.DoScheduledWrite();
+  FlushJournal();
 }
 
 void BookmarkStorage::LoadBookmarks(BookmarkLoadDetails* details) {
@@ -135,35 +477,108 @@ void BookmarkStorage::LoadBookmarks(BookmarkLoadDetails* details) {
   details_.reset(details);
   sequenced_task_runner_->PostTask(
       FROM_HERE,
-      base::Bind(&LoadCallback, writer_.path(), make_scoped_refptr(this),
+      base::Bind(&LoadCallback, path_, make_scoped_refptr(this),
                  details_.get()));
 }
 
 void BookmarkStorage::ScheduleSave() {
-  writer_.ScheduleWrite(this);
+  if (!save_timer_.IsRunning()) {
+    save_timer_.Start(FROM_HERE,
+                      base::TimeDelta::FromMilliseconds(kSaveDelayMS), this,
+                      &BookmarkStorage::SaveNow);
+  }
+}
+
+void BookmarkStorage::NodeAdded(const BookmarkNode* node) {
+  if (!CanJournal()) {
+    ScheduleSave();
+    return;
+  }
+  scoped_ptr<DictionaryValue> record(
+      CreateJournalRecord(kOperationAdd, node));
+  SetJournalRecordPosition(node, record.get());
+  record->SetString(BookmarkCodec::kNameKey, node->GetTitle());
+  record->SetString(BookmarkCodec::kDateAddedKey,
+                    base::Int64ToString(node->date_added().ToInternalValue()));
+  if (node->is_url()) {
+    record->SetString(BookmarkCodec::kTypeKey, BookmarkCodec::kTypeURL);
+    record->SetString(BookmarkCodec::kURLKey,
+                      node->url().possibly_invalid_spec());
+  } else {
+    record->SetString(BookmarkCodec::kTypeKey, BookmarkCodec::kTypeFolder);
+    record->SetString(
+        BookmarkCodec::kDateModifiedKey,
+        base::Int64ToString(node->date_folder_modified().ToInternalValue()));
+  }
+  if (!node->meta_info_str().empty())
+    record->SetString(BookmarkCodec::kMetaInfo, node->meta_info_str());
+  AppendToJournal(*record);
+}
+
+void BookmarkStorage::NodeRemoved(const BookmarkNode* node) {
+  if (!CanJournal()) {
+    ScheduleSave();
+    return;
+  }
+  scoped_ptr<DictionaryValue> record(
+      CreateJournalRecord(kOperationRemove, node));
+  AppendToJournal(*record);
+}
+
+void BookmarkStorage::NodeMoved(const BookmarkNode* node) {
+  if (!CanJournal()) {
+    ScheduleSave();
+    return;
+  }
+  scoped_ptr<DictionaryValue> record(
+      CreateJournalRecord(kOperationMove, node));
+  SetJournalRecordPosition(node, record.get());
+  AppendToJournal(*record);
+}
+
+void BookmarkStorage::NodeTitleChanged(const BookmarkNode* node) {
+  if (!CanJournal()) {
+    ScheduleSave();
+    return;
+  }
+  scoped_ptr<DictionaryValue> record(
+      CreateJournalRecord(kOperationSetTitle, node));
+  record->SetString(BookmarkCodec::kNameKey, node->GetTitle());
+  AppendToJournal(*record);
+}
+
+void BookmarkStorage::NodeDateFolderModifiedChanged(const BookmarkNode* node) {
+  if (!CanJournal()) {
+    ScheduleSave();
+    return;
+  }
+  scoped_ptr<DictionaryValue> record(
+      CreateJournalRecord(kOperationSetDateFolderModified, node));
+  record->SetString(
+      BookmarkCodec::kDateModifiedKey,
+      base::Int64ToString(node->date_folder_modified().ToInternalValue()));
+  AppendToJournal(*record);
 }
 
 void BookmarkStorage::BookmarkModelDeleted() {
   // We need to save now as otherwise by the time SaveNow is invoked
   // the model is gone.
-  if (writer_.HasPendingWrite())
+  if (save_timer_.IsRunning())
     SaveNow();
+  else
+    FlushJournal();
   model_ = NULL;
 }
 
-bool BookmarkStorage::SerializeData(std::string* output) {
-  BookmarkCodec codec;
-  scoped_ptr<Value> value(codec.Encode(model_));
-  JSONStringValueSerializer serializer(output);
-  serializer.set_pretty_print(true);
-  return serializer.Serialize(*(value.get()));
-}
-
 void BookmarkStorage::OnLoadFinished() {
   if (!model_)
     return;
 
+  journal_valid_ = details_->journal_valid();
+  journal_record_count_ = details_->journal_record_count();
   model_->DoneLoading(details_.release());
+  if (journal_record_count_ >= kMaxJournalRecords)
+    ScheduleSave();
 }
 
 bool BookmarkStorage::SaveNow() {
@@ -174,9 +589,56 @@ bool BookmarkStorage::SaveNow() {
     return false;
   }
 
-  std::string data;
-  if (!SerializeData(&data))
+  save_timer_.Stop();
+  BookmarkCodec codec;
+  scoped_ptr<Value> value(codec.Encode(model_));
+  if (!value.get())
     return false;
-  writer_.WriteNow(data);
+
+  // The new file contains all the changes in the journal, including the
+  // queued ones, and replaces it with an empty journal. The task runner is
+  // sequenced, so anything appended from now on follows the new header.
+  journal_timer_.Stop();
+  pending_journal_.clear();
+  journal_valid_ = true;
+  journal_record_count_ = 0;
+  journal_size_ = 0;
+  sequenced_task_runner_->PostTask(
+      FROM_HERE,
+      base::Bind(&SaveCallback, path_, journal_path_, base::Passed(&value),
+                 codec.computed_checksum()));
   return true;
 }
+
+void BookmarkStorage::AppendToJournal(const DictionaryValue& record) {
+  std::string line;
+  base::JSONWriter::Write(&record, &line);
+  line += '\n';
+  pending_journal_ += line;
+  ++journal_record_count_;
+  journal_size_ += line.size();
+
+  if (journal_record_count_ >= kMaxJournalRecords ||
+      journal_size_ >= kMaxJournalSize) {
+    ScheduleSave();
+  }
+  if (!journal_timer_.IsRunning()) {
+    journal_timer_.Start(FROM_HERE,
+                         base::TimeDelta::FromMilliseconds(kJournalDelayMS),
+                         this, &BookmarkStorage::FlushJournal);
+  }
+}
+
+bool BookmarkStorage::CanJournal() const {
+  return journal_valid_ && !save_timer_.IsRunning();
+}
+
+void BookmarkStorage::FlushJournal() {
+  journal_timer_.Stop();
+  if (pending_journal_.empty())
+    return;
+  sequenced_task_runner_->PostTask(
+      FROM_HERE,
+      base::Bind(&AppendToJournalCallback, journal_path_, pending_journal_));
+  pending_journal_.clear();
+}
@@ -5,15 +5,20 @@
 #ifndef CHROME_BROWSER_BOOKMARKS_BOOKMARK_STORAGE_H_
 #define CHROME_BROWSER_BOOKMARKS_BOOKMARK_STORAGE_H_
 
-#include "base/files/important_file_writer.h"
+#include <string>
+
+#include "base/files/file_path.h"
 #include "base/memory/ref_counted.h"
 #include "base/memory/scoped_ptr.h"
+#include "base/timer/timer.h"
 
 class BookmarkIndex;
 class BookmarkModel;
+class BookmarkNode;
 class BookmarkPermanentNode;
 
 namespace base {
+class DictionaryValue;
 class SequencedTaskRunner;
 }
 
@@ -83,6 +88,16 @@ class BookmarkLoadDetails {
   void set_ids_reassigned(bool value) { ids_reassigned_ = value; }
   bool ids_reassigned() const { return ids_reassigned_; }
 
+  // Whether the journal on disk belongs to the loaded bookmarks file, so that
+  // further changes can be appended to it.
+  void set_journal_valid(bool value) { journal_valid_ = value; }
+  bool journal_valid() const { return journal_valid_; }
+
+  // Number of journal records that were replayed on top of the bookmarks
+  // file.
+  void set_journal_record_count(int count) { journal_record_count_ = count; }
+  int journal_record_count() const { return journal_record_count_; }
+
  private:
   scoped_ptr<BookmarkPermanentNode> bb_node_;
   scoped_ptr<BookmarkPermanentNode> other_folder_node_;
@@ -93,6 +108,8 @@ class BookmarkLoadDetails {
   std::string computed_checksum_;
   std::string stored_checksum_;
   bool ids_reassigned_;
+  bool journal_valid_;
+  int journal_record_count_;
 
   DISALLOW_COPY_AND_ASSIGN(BookmarkLoadDetails);
 };
@@ -102,8 +119,15 @@ class BookmarkLoadDetails {
 // as notifying the BookmarkStorage every time the model changes.
 //
 // Internally BookmarkStorage uses BookmarkCodec to do the actual read/write.
-class BookmarkStorage : public base::ImportantFileWriter::DataSerializer,
-                        public base::RefCountedThreadSafe<BookmarkStorage> {
+//
+// Rewriting the whole file for every change gets expensive for large models,
+// so adding, removing, moving and retitling nodes is instead appended to a
+// journal next to the bookmarks file. The journal starts with the checksum of
+// the bookmarks file it applies to and is replayed on top of it when loading.
+// Once the journal grows past a threshold, or for any change the journal can't
+// express, the full file is written again (in the background) and a new,
+// empty journal is started.
+class BookmarkStorage : public base::RefCountedThreadSafe<BookmarkStorage> {
  public:
   // Creates a BookmarkStorage for the specified model
   BookmarkStorage(content::BrowserContext* context,
@@ -117,6 +141,15 @@ class BookmarkStorage : public base::ImportantFileWriter::DataSerializer,
   // Schedules saving the bookmark bar model to disk.
   void ScheduleSave();
 
+  // Notifications of changes the journal can record. |node| has already been
+  // changed in the model. These are cheaper than ScheduleSave, which they fall
+  // back to when the journal can't be used.
+  void NodeAdded(const BookmarkNode* node);
+  void NodeRemoved(const BookmarkNode* node);
+  void NodeMoved(const BookmarkNode* node);
+  void NodeTitleChanged(const BookmarkNode* node);
+  void NodeDateFolderModifiedChanged(const BookmarkNode* node);
+
   // Notification the bookmark bar model is going to be deleted. If there is
   // a pending save, it is saved immediately.
   void BookmarkModelDeleted();
@@ -124,23 +157,47 @@ class BookmarkStorage : public base::ImportantFileWriter::DataSerializer,
   // Callback from backend after loading the bookmark file.
   void OnLoadFinished();
 
-  // ImportantFileWriter::DataSerializer implementation.
-  virtual bool SerializeData(std::string* output) OVERRIDE;
-
  private:
   friend class base::RefCountedThreadSafe<BookmarkStorage>;
 
-  virtual ~BookmarkStorage();
+  ~BookmarkStorage();
 
-  // Serializes the data and schedules save using ImportantFileWriter.
-  // Returns true on successful serialization.
+  // Encodes the model and writes it, and a new journal, in the background.
+  // Returns true on successful encoding.
   bool SaveNow();
 
+  // Queues |record| for appending to the journal, or schedules a full save if
+  // the journal has grown too large.
+  void AppendToJournal(const base::DictionaryValue& record);
+
+  // Whether changes can currently be recorded in the journal. They can't
+  // before the journal matches the file on disk, and needn't be while a full
+  // save is pending.
+  bool CanJournal() const;
+
+  // Appends the queued journal records to the file.
+  void FlushJournal();
+
   // The model. The model is NULL once BookmarkModelDeleted has been invoked.
   BookmarkModel* model_;
 
-  // Helper to write bookmark data safely.
-  base::ImportantFileWriter writer_;
+  // The bookmarks file and its journal.
+  const base::FilePath path_;
+  const base::FilePath journal_path_;
+
+  // Delays full saves, and journal appends, to batch up changes.
+  base::OneShotTimer<BookmarkStorage> save_timer_;
+  base::OneShotTimer<BookmarkStorage> journal_timer_;
+
+  // Set once the journal on disk applies to the last saved file.
+  bool journal_valid_;
+
+  // Journal records not yet handed to the task runner.
+  std::string pending_journal_;
+
+  // Number and size of the records in the journal since the last full save.
+  size_t journal_record_count_;
+  size_t journal_size_;
 
   // See class description of BookmarkLoadDetails for details on this.
   scoped_ptr<BookmarkLoadDetails> details_;
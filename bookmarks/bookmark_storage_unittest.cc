@@ -0,0 +1,224 @@
+// Copyright 2013 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "chrome/browser/bookmarks/bookmark_storage.h"
+
+#include <string>
+
+#include "base/file_util.h"
+#include "base/files/file_path.h"
+#include "base/files/scoped_temp_dir.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/run_loop.h"
+#include "base/strings/utf_string_conversions.h"
+#include "chrome/browser/bookmarks/bookmark_model.h"
+#include "chrome/browser/bookmarks/bookmark_model_factory.h"
+#include "chrome/browser/bookmarks/bookmark_test_helpers.h"
+#include "chrome/common/chrome_constants.h"
+#include "chrome/test/base/testing_profile.h"
+#include "content/public/test/test_browser_thread_bundle.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "url/gurl.h"
+
+namespace {
+
+class BookmarkStorageTest : public testing::Test {
+ public:
+  BookmarkStorageTest() : model_(NULL) {}
+
+  // testing::Test:
+  virtual void SetUp() OVERRIDE {
+    ASSERT_TRUE(temp_dir_.CreateUniqueTempDir());
+  }
+
+  virtual void TearDown() OVERRIDE {
+    UnloadModel();
+  }
+
+ protected:
+  // Creates a profile in |temp_dir_| and loads its bookmarks.
+  void LoadModel() {
+    UnloadModel();
+    TestingProfile::Builder builder;
+    builder.SetPath(temp_dir_.path());
+    profile_ = builder.Build();
+    profile_->CreateBookmarkModel(false);
+    model_ = BookmarkModelFactory::GetForProfile(profile_.get());
+    test::WaitForBookmarkModelToLoad(model_);
+  }
+
+  // Deletes the profile, and with it the model, and waits for the pending
+  // writes to finish. The files stay in |temp_dir_|.
+  void UnloadModel() {
+    model_ = NULL;
+    profile_.reset();
+    base::RunLoop().RunUntilIdle();
+  }
+
+  // Loads the bookmarks from an empty profile, adds "a f:[ b ]" to the
+  // bookmark bar and saves it, so that the next changes are journaled.
+  void CreateBookmarksFile() {
+    LoadModel();
+    const BookmarkNode* bar = model_->bookmark_bar_node();
+    model_->AddURL(bar, 0, ASCIIToUTF16("a"), GURL("http://a.com/"));
+    const BookmarkNode* folder = model_->AddFolder(bar, 1, ASCIIToUTF16("f"));
+    model_->AddURL(folder, 0, ASCIIToUTF16("b"), GURL("http://b.com/"));
+    UnloadModel();
+  }
+
+  std::string BookmarkBarString() {
+    return test::ModelStringFromNode(model_->bookmark_bar_node());
+  }
+
+  base::FilePath bookmarks_path() const {
+    return temp_dir_.path().Append(chrome::kBookmarksFileName);
+  }
+
+  base::FilePath journal_path() const {
+    return bookmarks_path().ReplaceExtension(FILE_PATH_LITERAL("journal"));
+  }
+
+  std::string ReadFile(const base::FilePath& path) {
+    std::string contents;
+    EXPECT_TRUE(base::ReadFileToString(path, &contents));
+    return contents;
+  }
+
+  void WriteFile(const base::FilePath& path, const std::string& contents) {
+    ASSERT_EQ(static_cast<int>(contents.size()),
+              file_util::WriteFile(path, contents.data(), contents.size()));
+  }
+
+  BookmarkModel* model_;
+
+ private:
+  content::TestBrowserThreadBundle thread_bundle_;
+  base::ScopedTempDir temp_dir_;
+  scoped_ptr<TestingProfile> profile_;
+
+  DISALLOW_COPY_AND_ASSIGN(BookmarkStorageTest);
+};
+
+}  // namespace
+
+// Adding, moving, retitling and removing nodes only appends to the journal,
+// which is replayed on top of the unchanged bookmarks file.
+TEST_F(BookmarkStorageTest, ReplayJournal) {
+  CreateBookmarksFile();
+  const std::string bookmarks = ReadFile(bookmarks_path());
+
+  LoadModel();
+  ASSERT_EQ("a f:[ b ] ", BookmarkBarString());
+  const BookmarkNode* bar = model_->bookmark_bar_node();
+  const BookmarkNode* folder = bar->GetChild(1);
+  model_->AddURL(folder, 1, ASCIIToUTF16("c"), GURL("http://c.com/"));
+  model_->Move(bar->GetChild(0), folder, 0);
+  model_->SetTitle(folder, ASCIIToUTF16("g"));
+  model_->Remove(folder, 1);
+  const BookmarkNode* added =
+      model_->AddFolder(model_->other_node(), 0, ASCIIToUTF16("h"));
+  const int64 added_id = added->id();
+  UnloadModel();
+  EXPECT_EQ(bookmarks, ReadFile(bookmarks_path()));
+
+  LoadModel();
+  EXPECT_EQ("g:[ a c ] ", BookmarkBarString());
+  EXPECT_EQ("h:[ ] ", test::ModelStringFromNode(model_->other_node()));
+  EXPECT_EQ(added_id, model_->other_node()->GetChild(0)->id());
+  // New nodes don't reuse the ids of the replayed ones.
+  EXPECT_GT(model_->AddURL(bar, 0, ASCIIToUTF16("d"),
+                           GURL("http://d.com/"))->id(), added_id);
+}
+
+// A crash can leave the last record incomplete. It is ignored, and later
+// records still apply.
+TEST_F(BookmarkStorageTest, IncompleteRecord) {
+  CreateBookmarksFile();
+
+  LoadModel();
+  const BookmarkNode* bar = model_->bookmark_bar_node();
+  model_->SetTitle(bar->GetChild(0), ASCIIToUTF16("x"));
+  model_->SetTitle(bar->GetChild(0), ASCIIToUTF16("y"));
+  UnloadModel();
+
+  std::string journal = ReadFile(journal_path());
+  ASSERT_FALSE(journal.empty());
+  journal.resize(journal.size() - 5);
+  WriteFile(journal_path(), journal);
+
+  LoadModel();
+  EXPECT_EQ("x f:[ b ] ", BookmarkBarString());
+  model_->SetTitle(model_->bookmark_bar_node()->GetChild(1),
+                   ASCIIToUTF16("z"));
+  UnloadModel();
+
+  LoadModel();
+  EXPECT_EQ("x z:[ b ] ", BookmarkBarString());
+}
+
+// Records that don't fit the bookmarks, which the journal never contains
+// unless it was corrupted, end the replay.
+TEST_F(BookmarkStorageTest, InvalidRecord) {
+  CreateBookmarksFile();
+
+  LoadModel();
+  model_->SetTitle(model_->bookmark_bar_node()->GetChild(0),
+                   ASCIIToUTF16("x"));
+  UnloadModel();
+
+  WriteFile(journal_path(), ReadFile(journal_path()) +
+            "{\"id\":\"12345\",\"op\":\"remove\"}\n"
+            "{\"id\":\"1\",\"name\":\"y\",\"op\":\"title\"}\n");
+
+  LoadModel();
+  EXPECT_EQ("x f:[ b ] ", BookmarkBarString());
+  EXPECT_NE(ASCIIToUTF16("y"), model_->bookmark_bar_node()->GetTitle());
+}
+
+// Saving the full file replaces the journal. A crash in between leaves a
+// journal whose changes are already in the file; it must not be replayed.
+TEST_F(BookmarkStorageTest, JournalOfOlderFile) {
+  CreateBookmarksFile();
+
+  LoadModel();
+  model_->SetTitle(model_->bookmark_bar_node()->GetChild(0),
+                   ASCIIToUTF16("x"));
+  UnloadModel();
+  const std::string old_journal = ReadFile(journal_path());
+
+  LoadModel();
+  EXPECT_EQ("x f:[ b ] ", BookmarkBarString());
+  // Changing the URL can't be journaled, so this saves the full file, and so
+  // does the change after it.
+  const BookmarkNode* node = model_->bookmark_bar_node()->GetChild(0);
+  model_->SetURL(node, GURL("http://x.com/"));
+  model_->SetTitle(node, ASCIIToUTF16("y"));
+  UnloadModel();
+  EXPECT_NE(old_journal, ReadFile(journal_path()));
+
+  WriteFile(journal_path(), old_journal);
+  LoadModel();
+  EXPECT_EQ("y f:[ b ] ", BookmarkBarString());
+}
+
+// Without a bookmarks file there is nothing for a journal to apply to.
+TEST_F(BookmarkStorageTest, JournalWithoutFile) {
+  CreateBookmarksFile();
+
+  LoadModel();
+  model_->SetTitle(model_->bookmark_bar_node()->GetChild(0),
+                   ASCIIToUTF16("x"));
+  UnloadModel();
+  ASSERT_TRUE(base::DeleteFile(bookmarks_path(), false));
+
+  LoadModel();
+  EXPECT_EQ("", BookmarkBarString());
+
+  // The first change saves the full file and starts a new journal.
+  model_->AddURL(model_->bookmark_bar_node(), 0, ASCIIToUTF16("d"),
+                 GURL("http://d.com/"));
+  UnloadModel();
+  LoadModel();
+  EXPECT_EQ("d ", BookmarkBarString());
+}
@@ -42,10 +42,12 @@
 #include "chrome/browser/intranet_redirect_detector.h"
 #include "chrome/browser/io_thread.h"
 #include "chrome/browser/lifetime/application_lifetime.h"
+#include "chrome/browser/memory_purger.h"
 #include "chrome/browser/metrics/metrics_service.h"
 #include "chrome/browser/metrics/thread_watcher.h"
 #include "chrome/browser/metrics/variations/variations_service.h"
 #include "chrome/browser/net/chrome_net_log.h"
+#include "chrome/browser/net/chrome_network_delegate.h"
 #include "chrome/browser/net/crl_set_fetcher.h"
 #include "chrome/browser/net/sdch_dictionary_fetcher.h"
 #include "chrome/browser/notifications/notification_ui_manager.h"
@@ -211,6 +213,11 @@ void BrowserProcessImpl::StartTearDown() {
   automation_provider_list_.reset();
 #endif
 
+  // The network delegates batch the data saving prefs, and the batch can no
+  // longer be posted to the UI thread. Add it to the local state while it is
+  // still there to be written.
+  ChromeNetworkDelegate::FlushContentLengthPrefs();
+
   // We need to shutdown the SdchDictionaryFetcher as it regularly holds
   // a pointer to a URLFetcher, and that URLFetcher (upon destruction) will do
   // a PostDelayedTask onto the IO thread.  This shutdown call will both discard
@@ -925,6 +932,7 @@ void BrowserProcessImpl::PreMainMessageLoopRun() {
 
 #if !defined(OS_ANDROID) && !defined(OS_IOS)
   storage_monitor_.reset(StorageMonitor::Create());
+  MemoryPurger::StartPurgingOnMemoryPressure();
 #endif
 
   platform_part_->PreMainMessageLoopRun();
@@ -6,6 +6,7 @@
 
 #include <map>
 #include <string>
+#include <vector>
 
 #include "base/bind.h"
 #include "base/command_line.h"
@@ -16,6 +17,7 @@
 #include "base/prefs/pref_registry_simple.h"
 #include "base/prefs/pref_service.h"
 #include "base/strings/string_number_conversions.h"
+#include "base/strings/string_split.h"
 #include "base/strings/stringprintf.h"
 #include "base/threading/thread.h"
 #include "base/threading/thread_restrictions.h"
@@ -74,6 +76,10 @@ ShutdownType shutdown_type_ = NOT_VALID;
 int shutdown_num_processes_;
 int shutdown_num_processes_slow_;
 
+// How long the browser windows took to close, from OnShutdownStarting() to
+// ShutdownPreThreadsStop().
+int64 shutdown_close_browsers_ms_ = 0;
+
 const char kShutdownMsFile[] = "chrome_shutdown_ms.txt";
 
 void RegisterPrefs(PrefRegistrySimple* registry) {
@@ -130,6 +136,11 @@ bool ShutdownPreThreadsStop() {
       "BrowserShutdownStarted", false);
 #endif
 
+  if (shutdown_started_) {
+    shutdown_close_browsers_ms_ =
+        (Time::Now() - *shutdown_started_).InMilliseconds();
+  }
+
   // Shutdown the IPC channel to the service processes.
   ServiceProcessControl::GetInstance()->Disconnect();
 
@@ -246,11 +257,13 @@ void ShutdownPostThreadsStop(bool restart_last_session) {
 
   if (shutdown_type_ > NOT_VALID && shutdown_num_processes_ > 0) {
     // Measure total shutdown time as late in the process as possible
-    // and then write it to a file to be read at startup.
+    // and then write it to a file to be read at startup, followed by the
+    // time it took to close the browser windows.
     // We can't use prefs since all services are shutdown at this point.
     TimeDelta shutdown_delta = Time::Now() - *shutdown_started_;
     std::string shutdown_ms =
-        base::Int64ToString(shutdown_delta.InMilliseconds());
+        base::Int64ToString(shutdown_delta.InMilliseconds()) + "," +
+        base::Int64ToString(shutdown_close_browsers_ms_);
     int len = static_cast<int>(shutdown_ms.length()) + 1;
     base::FilePath shutdown_ms_file = GetShutdownMsPath();
     file_util::WriteFile(shutdown_ms_file, shutdown_ms.c_str(), len);
@@ -269,8 +282,16 @@ void ReadLastShutdownFile(ShutdownType type,
   base::FilePath shutdown_ms_file = GetShutdownMsPath();
   std::string shutdown_ms_str;
   int64 shutdown_ms = 0;
-  if (base::ReadFileToString(shutdown_ms_file, &shutdown_ms_str))
-    base::StringToInt64(shutdown_ms_str, &shutdown_ms);
+  int64 close_browsers_ms = 0;
+  if (base::ReadFileToString(shutdown_ms_file, &shutdown_ms_str)) {
+    // The file ends with a NUL, and older versions only wrote the total.
+    std::vector<std::string> fields;
+    base::SplitString(shutdown_ms_str.c_str(), ',', &fields);
+    if (fields.size() > 0)
+      base::StringToInt64(fields[0], &shutdown_ms);
+    if (fields.size() > 1)
+      base::StringToInt64(fields[1], &close_browsers_ms);
+  }
   base::DeleteFile(shutdown_ms_file, false);
 
   if (type == NOT_VALID || shutdown_ms == 0 || num_procs == 0)
@@ -278,23 +299,23 @@ void ReadLastShutdownFile(ShutdownType type,
 
   const char* time_fmt = "Shutdown.%s.time";
   const char* time_per_fmt = "Shutdown.%s.time_per_process";
-  std::string time;
-  std::string time_per;
+  const char* time_close_fmt = "Shutdown.%s.time_close_browsers";
+  const char* time_teardown_fmt = "Shutdown.%s.time_teardown";
+  const char* type_name = NULL;
   if (type == WINDOW_CLOSE) {
-    time = base::StringPrintf(time_fmt, "window_close");
-    time_per = base::StringPrintf(time_per_fmt, "window_close");
+    type_name = "window_close";
   } else if (type == BROWSER_EXIT) {
-    time = base::StringPrintf(time_fmt, "browser_exit");
-    time_per = base::StringPrintf(time_per_fmt, "browser_exit");
+    type_name = "browser_exit";
   } else if (type == END_SESSION) {
-    time = base::StringPrintf(time_fmt, "end_session");
-    time_per = base::StringPrintf(time_per_fmt, "end_session");
+    type_name = "end_session";
   } else {
     NOTREACHED();
   }
 
-  if (time.empty())
+  if (!type_name)
     return;
+  std::string time = base::StringPrintf(time_fmt, type_name);
+  std::string time_per = base::StringPrintf(time_per_fmt, type_name);
 
   // TODO(erikkay): change these to UMA histograms after a bit more testing.
   UMA_HISTOGRAM_TIMES(time.c_str(),
@@ -303,6 +324,19 @@ void ReadLastShutdownFile(ShutdownType type,
                       TimeDelta::FromMilliseconds(shutdown_ms / num_procs));
   UMA_HISTOGRAM_COUNTS_100("Shutdown.renderers.total", num_procs);
   UMA_HISTOGRAM_COUNTS_100("Shutdown.renderers.slow", num_procs_slow);
+
+  // The time spent closing the browser windows, and the rest of the total
+  // spent tearing down the profiles, the services and the threads.
+  if (close_browsers_ms > 0 && close_browsers_ms <= shutdown_ms) {
+    std::string time_close = base::StringPrintf(time_close_fmt, type_name);
+    std::string time_teardown =
+        base::StringPrintf(time_teardown_fmt, type_name);
+    UMA_HISTOGRAM_TIMES(time_close.c_str(),
+                        TimeDelta::FromMilliseconds(close_browsers_ms));
+    UMA_HISTOGRAM_TIMES(
+        time_teardown.c_str(),
+        TimeDelta::FromMilliseconds(shutdown_ms - close_browsers_ms));
+  }
 }
 
 void ReadLastShutdownInfo() {
@@ -11,6 +11,7 @@
 #include "base/bind_helpers.h"
 #include "base/callback.h"
 #include "base/logging.h"
+#include "base/metrics/histogram.h"
 #include "base/platform_file.h"
 #include "base/prefs/pref_service.h"
 #include "chrome/browser/autofill/personal_data_manager_factory.h"
@@ -224,6 +225,7 @@ void BrowsingDataRemover::RemoveImpl(int remove_mask,
                                      int origin_set_mask) {
   DCHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
   set_removing(true);
+  remove_start_time_ = base::TimeTicks::Now();
   remove_mask_ = remove_mask;
   remove_origin_ = origin;
   origin_set_mask_ = origin_set_mask;
@@ -266,6 +268,7 @@ void BrowsingDataRemover::RemoveImpl(int remove_mask,
         restrict_urls.insert(remove_origin_);
       content::RecordAction(UserMetricsAction("ClearBrowsingData_History"));
       waiting_for_clear_history_ = true;
+      clear_history_start_time_ = base::TimeTicks::Now();
 
       history_service->ExpireLocalAndRemoteHistoryBetween(
           restrict_urls, delete_begin_, delete_end_,
@@ -529,6 +532,7 @@ void BrowsingDataRemover::RemoveImpl(int remove_mask,
 
     // Invoke DoClearCache on the IO thread.
     waiting_for_clear_cache_ = true;
+    clear_cache_start_time_ = base::TimeTicks::Now();
     content::RecordAction(UserMetricsAction("ClearBrowsingData_Cache"));
 
     BrowserThread::PostTask(
@@ -610,6 +614,9 @@ void BrowsingDataRemover::RemoveObserver(Observer* observer) {
 
 void BrowsingDataRemover::OnHistoryDeletionDone() {
   waiting_for_clear_history_ = false;
+  UMA_HISTOGRAM_MEDIUM_TIMES(
+      "History.ClearBrowsingData.TimeToClearHistory",
+      base::TimeTicks::Now() - clear_history_start_time_);
   NotifyAndDeleteIfDone();
 }
 
@@ -645,24 +652,38 @@ base::Time BrowsingDataRemover::CalculateBeginDeleteTime(
   return delete_begin_time - diff;
 }
 
+int BrowsingDataRemover::PendingTaskCount() const {
+  const bool waiting_for[] = {
+    waiting_for_clear_keyword_data_,
+    waiting_for_clear_autofill_origin_urls_,
+    waiting_for_clear_cache_,
+    waiting_for_clear_nacl_cache_,
+    waiting_for_clear_history_,
+    waiting_for_clear_local_storage_,
+    waiting_for_clear_logged_in_predictor_,
+    waiting_for_clear_session_storage_,
+    waiting_for_clear_networking_history_,
+    waiting_for_clear_server_bound_certs_,
+    waiting_for_clear_plugin_data_,
+    waiting_for_clear_pnacl_cache_,
+    waiting_for_clear_quota_managed_data_,
+    waiting_for_clear_content_licenses_,
+    waiting_for_clear_form_,
+    waiting_for_clear_hostname_resolution_cache_,
+    waiting_for_clear_network_predictor_,
+    waiting_for_clear_shader_cache_,
+    waiting_for_clear_webrtc_identity_store_,
+  };
+  int count = waiting_for_clear_cookies_count_;
+  for (size_t i = 0; i < arraysize(waiting_for); ++i) {
+    if (waiting_for[i])
+      ++count;
+  }
+  return count;
+}
+
 bool BrowsingDataRemover::AllDone() {
-  return !waiting_for_clear_keyword_data_ &&
-         !waiting_for_clear_autofill_origin_urls_ &&
-         !waiting_for_clear_cache_ && !waiting_for_clear_nacl_cache_ &&
-         !waiting_for_clear_cookies_count_ && !waiting_for_clear_history_ &&
-         !waiting_for_clear_local_storage_ &&
-         !waiting_for_clear_logged_in_predictor_ &&
-         !waiting_for_clear_session_storage_ &&
-         !waiting_for_clear_networking_history_ &&
-         !waiting_for_clear_server_bound_certs_ &&
-         !waiting_for_clear_plugin_data_ &&
-         !waiting_for_clear_pnacl_cache_ &&
-         !waiting_for_clear_quota_managed_data_ &&
-         !waiting_for_clear_content_licenses_ && !waiting_for_clear_form_ &&
-         !waiting_for_clear_hostname_resolution_cache_ &&
-         !waiting_for_clear_network_predictor_ &&
-         !waiting_for_clear_shader_cache_ &&
-         !waiting_for_clear_webrtc_identity_store_;
+  return PendingTaskCount() == 0;
 }
 
 void BrowsingDataRemover::OnKeywordsLoaded() {
@@ -682,10 +703,16 @@ void BrowsingDataRemover::NotifyAndDeleteIfDone() {
   // clearing (what about other things such as passwords, etc.?) and wait for
   // them to complete before continuing.
 
-  if (!AllDone())
+  int pending_task_count = PendingTaskCount();
+  if (pending_task_count) {
+    FOR_EACH_OBSERVER(Observer, observer_list_,
+                      OnBrowsingDataRemoverProgress(pending_task_count));
     return;
+  }
 
   set_removing(false);
+  UMA_HISTOGRAM_MEDIUM_TIMES("History.ClearBrowsingData.TimeToComplete",
+                             base::TimeTicks::Now() - remove_start_time_);
 
   // Send global notification, then notify any explicit observers.
   BrowsingDataRemover::NotificationDetails details(delete_begin_, remove_mask_,
@@ -787,6 +814,9 @@ void BrowsingDataRemover::OnClearedNetworkingHistory() {
 
 void BrowsingDataRemover::ClearedCache() {
   waiting_for_clear_cache_ = false;
+  UMA_HISTOGRAM_MEDIUM_TIMES(
+      "History.ClearBrowsingData.TimeToClearCache",
+      base::TimeTicks::Now() - clear_cache_start_time_);
 
   NotifyAndDeleteIfDone();
 }
@@ -130,6 +130,11 @@ class BrowsingDataRemover
    public:
     virtual void OnBrowsingDataRemoverDone() = 0;
 
+    // Called whenever one of the removal tasks completes, with the number of
+    // tasks which are still running. Tasks may start others as they go, so
+    // the count isn't guaranteed to decrease.
+    virtual void OnBrowsingDataRemoverProgress(int pending_task_count) {}
+
    protected:
     virtual ~Observer() {}
   };
@@ -371,6 +376,9 @@ class BrowsingDataRemover
   // Callback on UI thread when the WebRTC identities are cleared.
   void OnClearWebRTCIdentityStore();
 
+  // Returns the number of removal tasks which haven't completed yet.
+  int PendingTaskCount() const;
+
   // Returns true if we're all done.
   bool AllDone();
 
@@ -396,6 +404,12 @@ class BrowsingDataRemover
   // True if Remove has been invoked.
   static bool is_removing_;
 
+  // When the removal, and the removal of the history and of the cache,
+  // started. Used for UMA.
+  base::TimeTicks remove_start_time_;
+  base::TimeTicks clear_history_start_time_;
+  base::TimeTicks clear_cache_start_time_;
+
   CacheState next_cache_state_;
   disk_cache::Backend* cache_;
 
@@ -6,6 +6,7 @@
 
 #include <algorithm>
 #include <functional>
+#include <map>
 #include <vector>
 
 #include "base/bind.h"
@@ -1073,6 +1074,10 @@ void CookiesTreeModel::PopulateCookieInfoWithFilter(
   CookieTreeRootNode* root = static_cast<CookieTreeRootNode*>(GetRoot());
 
   notifier->StartBatchUpdate();
+  // The cookies of a host are spread over the list, so remember the cookies
+  // node of each source instead of looking up the host node for every cookie.
+  // Sources which don't match |filter| map to NULL.
+  std::map<std::string, CookieTreeCookiesNode*> cookies_nodes;
   for (CookieList::iterator it = container->cookie_list_.begin();
        it != container->cookie_list_.end(); ++it) {
     std::string source_string = it->Source();
@@ -1086,16 +1091,22 @@ void CookiesTreeModel::PopulateCookieInfoWithFilter(
           content::kStandardSchemeSeparator + domain + "/";
     }
 
-    GURL source(source_string);
-    if (!filter.size() ||
-        (CookieTreeHostNode::TitleForUrl(source).find(filter) !=
-        string16::npos)) {
-      CookieTreeHostNode* host_node = root->GetOrCreateHostNode(source);
-      CookieTreeCookiesNode* cookies_node =
-          host_node->GetOrCreateCookiesNode();
-      CookieTreeCookieNode* new_cookie = new CookieTreeCookieNode(it);
-      cookies_node->AddCookieNode(new_cookie);
+    std::map<std::string, CookieTreeCookiesNode*>::iterator node_it =
+        cookies_nodes.find(source_string);
+    if (node_it == cookies_nodes.end()) {
+      GURL source(source_string);
+      CookieTreeCookiesNode* cookies_node = NULL;
+      if (!filter.size() ||
+          (CookieTreeHostNode::TitleForUrl(source).find(filter) !=
+          string16::npos)) {
+        CookieTreeHostNode* host_node = root->GetOrCreateHostNode(source);
+        cookies_node = host_node->GetOrCreateCookiesNode();
+      }
+      node_it = cookies_nodes.insert(
+          std::make_pair(source_string, cookies_node)).first;
     }
+    if (node_it->second)
+      node_it->second->AddCookieNode(new CookieTreeCookieNode(it));
   }
 }
 
@@ -150,9 +150,12 @@ CaptivePortalService::CaptivePortalService(Profile* profile)
   ResetBackoffEntry(last_detection_result_);
 
   UpdateEnabledState();
+
+  net::NetworkChangeNotifier::AddConnectionTypeObserver(this);
 }
 
 CaptivePortalService::~CaptivePortalService() {
+  net::NetworkChangeNotifier::RemoveConnectionTypeObserver(this);
 }
 
 void CaptivePortalService::DetectCaptivePortal() {
@@ -264,6 +267,29 @@ void CaptivePortalService::Shutdown() {
   }
 }
 
+void CaptivePortalService::OnConnectionTypeChanged(
+    net::NetworkChangeNotifier::ConnectionType type) {
+  DCHECK(CalledOnValidThread());
+  if (type == net::NetworkChangeNotifier::CONNECTION_NONE)
+    return;
+
+  // Results from the previous network say nothing about the new one, so they
+  // shouldn't delay checking it.
+  ResetBackoffEntry(last_detection_result_);
+
+  if (state_ == STATE_CHECKING_FOR_PORTAL || state_ == STATE_TIMER_RUNNING) {
+    // Restart the pending or running check on the new network.
+    check_captive_portal_timer_.Stop();
+    captive_portal_detector_.Cancel();
+    state_ = STATE_IDLE;
+    DetectCaptivePortal();
+  } else if (last_detection_result_ == RESULT_BEHIND_CAPTIVE_PORTAL) {
+    // Check right away, so that the tabs broken by the old network's portal
+    // are reloaded as soon as the new network turns out to be connected.
+    DetectCaptivePortal();
+  }
+}
+
 void CaptivePortalService::OnResult(Result result) {
   DCHECK_EQ(STATE_CHECKING_FOR_PORTAL, state_);
   state_ = STATE_IDLE;
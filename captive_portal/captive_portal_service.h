@@ -14,6 +14,7 @@
 #include "chrome/browser/captive_portal/captive_portal_detector.h"
 #include "components/browser_context_keyed_service/browser_context_keyed_service.h"
 #include "net/base/backoff_entry.h"
+#include "net/base/network_change_notifier.h"
 #include "url/gurl.h"
 
 class Profile;
@@ -27,8 +28,10 @@ namespace captive_portal {
 // Captive portal checks are rate-limited.  The CaptivePortalService may only
 // be accessed on the UI thread.
 // Design doc: https://docs.google.com/document/d/1k-gP2sswzYNvryu9NcgN7q5XrsMlUdlUdoW9WRaEmfM/edit
-class CaptivePortalService : public BrowserContextKeyedService,
-                             public base::NonThreadSafe {
+class CaptivePortalService
+    : public BrowserContextKeyedService,
+      public net::NetworkChangeNotifier::ConnectionTypeObserver,
+      public base::NonThreadSafe {
  public:
   enum TestingState {
     NOT_TESTING,
@@ -117,6 +120,10 @@ class CaptivePortalService : public BrowserContextKeyedService,
   // BrowserContextKeyedService:
   virtual void Shutdown() OVERRIDE;
 
+  // net::NetworkChangeNotifier::ConnectionTypeObserver:
+  virtual void OnConnectionTypeChanged(
+      net::NetworkChangeNotifier::ConnectionType type) OVERRIDE;
+
   // Called when a captive portal check completes.  Passes the result to all
   // observers.
   void OnResult(Result result);
@@ -464,6 +464,38 @@ TEST_F(CaptivePortalServiceTest, CaptivePortalJitter) {
   }
 }
 
+// Check that a network change lifts the delay before the next check, and
+// starts one if the last check found a captive portal.
+TEST_F(CaptivePortalServiceTest, CaptivePortalNetworkChange) {
+  Initialize(CaptivePortalService::SKIP_OS_CHECK_FOR_TESTING);
+  set_initial_backoff_no_portal(base::TimeDelta::FromSeconds(100));
+  set_initial_backoff_portal(base::TimeDelta::FromSeconds(100));
+
+  RunTest(RESULT_INTERNET_CONNECTED, net::OK, 204, 0, NULL);
+  RunTest(RESULT_INTERNET_CONNECTED, net::OK, 204, 0, NULL);
+  EXPECT_EQ(base::TimeDelta::FromSeconds(100), GetTimeUntilNextRequest());
+
+  // Losing the connection changes nothing.
+  service()->OnConnectionTypeChanged(
+      net::NetworkChangeNotifier::CONNECTION_NONE);
+  EXPECT_EQ(base::TimeDelta::FromSeconds(100), GetTimeUntilNextRequest());
+
+  service()->OnConnectionTypeChanged(
+      net::NetworkChangeNotifier::CONNECTION_WIFI);
+  EXPECT_EQ(CaptivePortalService::STATE_IDLE, service()->state());
+  RunTest(RESULT_BEHIND_CAPTIVE_PORTAL, net::OK, 200, 0, NULL);
+
+  CaptivePortalObserver observer(profile(), service());
+  service()->OnConnectionTypeChanged(
+      net::NetworkChangeNotifier::CONNECTION_ETHERNET);
+  EXPECT_EQ(CaptivePortalService::STATE_TIMER_RUNNING, service()->state());
+  base::RunLoop().RunUntilIdle();
+  ASSERT_TRUE(FetchingURL());
+  CompleteURLFetch(net::OK, 204, NULL);
+  EXPECT_EQ(1, observer.num_results_received());
+  EXPECT_EQ(RESULT_INTERNET_CONNECTED, observer.captive_portal_result());
+}
+
 // Check a Retry-After header that contains a delay in seconds.
 TEST_F(CaptivePortalServiceTest, CaptivePortalRetryAfterSeconds) {
   Initialize(CaptivePortalService::SKIP_OS_CHECK_FOR_TESTING);
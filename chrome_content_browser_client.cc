@@ -1145,10 +1145,13 @@ bool ChromeContentBrowserClient::ShouldTryToUseExistingProcessHost(
   std::set<int> process_ids;
   size_t max_process_count =
       content::RenderProcessHost::GetMaxRendererProcessCount();
+  const double max_extension_process_count =
+      max_process_count * chrome::kMaxShareOfExtensionProcesses;
 
   // Go through all profiles to ensure we have total count of extension
   // processes containing background pages, otherwise one profile can
-  // starve the other.
+  // starve the other. This runs for navigations to extensions, so stop as
+  // soon as the limit is reached.
   std::vector<Profile*> profiles = g_browser_process->profile_manager()->
       GetLoadedProfiles();
   for (size_t i = 0; i < profiles.size(); ++i) {
@@ -1159,14 +1162,11 @@ bool ChromeContentBrowserClient::ShouldTryToUseExistingProcessHost(
          iter != epm->background_hosts().end(); ++iter) {
       const extensions::ExtensionHost* host = *iter;
       process_ids.insert(host->render_process_host()->GetID());
+      if (process_ids.size() > max_extension_process_count)
+        return true;
     }
   }
 
-  if (process_ids.size() >
-      (max_process_count * chrome::kMaxShareOfExtensionProcesses)) {
-    return true;
-  }
-
   return false;
 }
 
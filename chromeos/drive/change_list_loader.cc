@@ -9,7 +9,9 @@
 #include "base/callback.h"
 #include "base/callback_helpers.h"
 #include "base/metrics/histogram.h"
+#include "base/sequenced_task_runner.h"
 #include "base/strings/string_number_conversions.h"
+#include "base/task_runner_util.h"
 #include "chrome/browser/chromeos/drive/change_list_loader_observer.h"
 #include "chrome/browser/chromeos/drive/change_list_processor.h"
 #include "chrome/browser/chromeos/drive/file_system_util.h"
@@ -38,11 +40,24 @@ class ChangeListLoader::FeedFetcher {
 
 namespace {
 
+// Converts |resource_list| into a ChangeList. Runs on the blocking pool.
+scoped_ptr<ChangeList> ConvertToChangeList(
+    scoped_ptr<google_apis::ResourceList> resource_list) {
+  return make_scoped_ptr(new ChangeList(*resource_list));
+}
+
 // Fetches all the (currently available) resource entries from the server.
+// Each page is converted into a ChangeList on |blocking_task_runner| while
+// the next page is being fetched, so that the conversion of a large account
+// does not block the UI thread and overlaps with the network.
 class FullFeedFetcher : public ChangeListLoader::FeedFetcher {
  public:
-  explicit FullFeedFetcher(JobScheduler* scheduler)
+  FullFeedFetcher(JobScheduler* scheduler,
+                  base::SequencedTaskRunner* blocking_task_runner)
       : scheduler_(scheduler),
+        blocking_task_runner_(blocking_task_runner),
+        num_pending_conversions_(0),
+        all_pages_fetched_(false),
         weak_ptr_factory_(this) {
   }
 
@@ -72,20 +87,19 @@ class FullFeedFetcher : public ChangeListLoader::FeedFetcher {
 
     // Looks the UMA stats we take here is useless as many methods use this
     // callback. crbug.com/229407
-    if (change_lists_.empty()) {
+    if (change_lists_.empty() && num_pending_conversions_ == 0) {
       UMA_HISTOGRAM_TIMES("Drive.InitialFeedLoadTime",
                           base::TimeTicks::Now() - start_time_);
     }
 
     FileError error = GDataToFileError(status);
     if (error != FILE_ERROR_OK) {
+      // Pending conversions are dropped along with this fetcher.
       callback.Run(error, ScopedVector<ChangeList>());
       return;
     }
 
     DCHECK(resource_list);
-    change_lists_.push_back(new ChangeList(*resource_list));
-
     GURL next_url;
     if (resource_list->GetNextFeedURL(&next_url) && !next_url.is_empty()) {
       // There is the remaining result so fetch it.
@@ -93,12 +107,34 @@ class FullFeedFetcher : public ChangeListLoader::FeedFetcher {
           next_url,
           base::Bind(&FullFeedFetcher::OnFileListFetched,
                      weak_ptr_factory_.GetWeakPtr(), callback));
-      return;
+    } else {
+      // This UMA stats looks also different from what we want.
+      // crbug.com/229407
+      UMA_HISTOGRAM_TIMES("Drive.EntireFeedLoadTime",
+                          base::TimeTicks::Now() - start_time_);
+      all_pages_fetched_ = true;
     }
 
-    // This UMA stats looks also different from what we want. crbug.com/229407
-    UMA_HISTOGRAM_TIMES("Drive.EntireFeedLoadTime",
-                        base::TimeTicks::Now() - start_time_);
+    // The blocking task runner is sequenced, so the pages are converted and
+    // replied in the order they were fetched.
+    ++num_pending_conversions_;
+    base::PostTaskAndReplyWithResult(
+        blocking_task_runner_,
+        FROM_HERE,
+        base::Bind(&ConvertToChangeList, base::Passed(&resource_list)),
+        base::Bind(&FullFeedFetcher::OnChangeListConverted,
+                   weak_ptr_factory_.GetWeakPtr(), callback));
+  }
+
+  void OnChangeListConverted(const FeedFetcherCallback& callback,
+                             scoped_ptr<ChangeList> change_list) {
+    DCHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
+    DCHECK_GT(num_pending_conversions_, 0);
+
+    change_lists_.push_back(change_list.release());
+    --num_pending_conversions_;
+    if (!all_pages_fetched_ || num_pending_conversions_ > 0)
+      return;
 
     // Note: The fetcher is managed by ChangeListLoader, and the instance
     // will be deleted in the callback. Do not touch the fields after this
@@ -107,7 +143,10 @@ class FullFeedFetcher : public ChangeListLoader::FeedFetcher {
   }
 
   JobScheduler* scheduler_;
+  scoped_refptr<base::SequencedTaskRunner> blocking_task_runner_;
   ScopedVector<ChangeList> change_lists_;
+  int num_pending_conversions_;
+  bool all_pages_fetched_;
   base::TimeTicks start_time_;
   base::WeakPtrFactory<FullFeedFetcher> weak_ptr_factory_;
   DISALLOW_COPY_AND_ASSIGN(FullFeedFetcher);
@@ -633,7 +672,8 @@ void ChangeListLoader::LoadChangeListFromServer(
     change_feed_fetcher_.reset(
         new DeltaFeedFetcher(scheduler_, start_changestamp));
   } else {
-    change_feed_fetcher_.reset(new FullFeedFetcher(scheduler_));
+    change_feed_fetcher_.reset(
+        new FullFeedFetcher(scheduler_, blocking_task_runner_.get()));
   }
 
   change_feed_fetcher_->Run(
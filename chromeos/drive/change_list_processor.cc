@@ -142,9 +142,14 @@ FileError ChangeListProcessor::Apply(
     }
   }
 
+  // Group the writes of the possibly huge number of entries.
+  resource_metadata_->BeginBatch();
   FileError error = ApplyEntryMap(is_delta_update,
                                   largest_changestamp,
                                   about_resource.Pass());
+  FileError commit_error = resource_metadata_->CommitBatch();
+  if (error == FILE_ERROR_OK)
+    error = commit_error;
   if (error != FILE_ERROR_OK) {
     DLOG(ERROR) << "ApplyEntryMap failed: " << FileErrorToString(error);
     return error;
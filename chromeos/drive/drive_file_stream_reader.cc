@@ -40,28 +40,35 @@ void RunTaskOnUIThread(const base::Closure& task) {
 namespace internal {
 namespace {
 
-// Copies the content in |pending_data| into |buffer| at most
-// |buffer_length| bytes, and erases the copied data from
-// |pending_data|. Returns the number of copied bytes.
+// Copies the content in |pending_data|, starting at |first_data_offset| in
+// its first chunk, into |buffer| at most |buffer_length| bytes, and erases
+// the fully copied chunks from |pending_data|. Returns the number of copied
+// bytes. Partially copied chunks are not shifted: |first_data_offset| is
+// advanced instead, so that reading a large chunk with small buffers does not
+// move its remaining data again and again.
 int ReadInternal(ScopedVector<std::string>* pending_data,
+                 size_t* first_data_offset,
                  net::IOBuffer* buffer, int buffer_length) {
   size_t index = 0;
   int offset = 0;
   for (; index < pending_data->size() && offset < buffer_length; ++index) {
     const std::string& chunk = *(*pending_data)[index];
-    DCHECK(!chunk.empty());
+    DCHECK_LT(*first_data_offset, chunk.size());
 
     size_t bytes_to_read = std::min(
-        chunk.size(), static_cast<size_t>(buffer_length - offset));
-    std::memmove(buffer->data() + offset, chunk.data(), bytes_to_read);
+        chunk.size() - *first_data_offset,
+        static_cast<size_t>(buffer_length - offset));
+    std::memmove(buffer->data() + offset, chunk.data() + *first_data_offset,
+                 bytes_to_read);
     offset += bytes_to_read;
-    if (bytes_to_read < chunk.size()) {
+    if (*first_data_offset + bytes_to_read < chunk.size()) {
       // The chunk still has some remaining data.
-      // So remove leading (copied) bytes, and quit the loop so that
+      // So skip the leading (copied) bytes, and quit the loop so that
       // the remaining data won't be deleted in the following erase().
-      (*pending_data)[index]->erase(0, bytes_to_read);
+      *first_data_offset += bytes_to_read;
       break;
     }
+    *first_data_offset = 0;
   }
 
   // Consume the copied data.
@@ -131,7 +138,8 @@ NetworkReaderProxy::NetworkReaderProxy(
     int64 offset,
     int64 content_length,
     const base::Closure& job_canceller)
-    : remaining_offset_(offset),
+    : pending_first_data_offset_(0),
+      remaining_offset_(offset),
       remaining_content_length_(content_length),
       error_code_(net::OK),
       buffer_length_(0),
@@ -180,7 +188,8 @@ int NetworkReaderProxy::Read(net::IOBuffer* buffer, int buffer_length,
     return net::ERR_IO_PENDING;
   }
 
-  int result = ReadInternal(&pending_data_, buffer, buffer_length);
+  int result = ReadInternal(&pending_data_, &pending_first_data_offset_,
+                            buffer, buffer_length);
   remaining_content_length_ -= result;
   DCHECK_GE(remaining_content_length_, 0);
   return result;
@@ -197,8 +206,10 @@ void NetworkReaderProxy::OnGetContent(scoped_ptr<std::string> data) {
   }
 
   if (remaining_offset_ > 0) {
-    // Erase unnecessary leading bytes.
-    data->erase(0, static_cast<size_t>(remaining_offset_));
+    // Skip unnecessary leading bytes. No data has been queued yet, as the
+    // offset is not reached before.
+    DCHECK(pending_data_.empty());
+    pending_first_data_offset_ = static_cast<size_t>(remaining_offset_);
     remaining_offset_ = 0;
   }
 
@@ -208,7 +219,8 @@ void NetworkReaderProxy::OnGetContent(scoped_ptr<std::string> data) {
     return;
   }
 
-  int result = ReadInternal(&pending_data_, buffer_.get(), buffer_length_);
+  int result = ReadInternal(&pending_data_, &pending_first_data_offset_,
+                            buffer_.get(), buffer_length_);
   remaining_content_length_ -= result;
   DCHECK_GE(remaining_content_length_, 0);
 
@@ -230,6 +242,7 @@ void NetworkReaderProxy::OnCompleted(FileError error) {
 
   error_code_ = FileErrorToNetError(error);
   pending_data_.clear();
+  pending_first_data_offset_ = 0;
 
   if (callback_.is_null()) {
     // No pending Read operation.
@@ -103,6 +103,10 @@ class NetworkReaderProxy : public ReaderProxy {
   // The data received from the server, but not yet read.
   ScopedVector<std::string> pending_data_;
 
+  // The number of bytes of the first chunk in |pending_data_| which are
+  // already read (or skipped).
+  size_t pending_first_data_offset_;
+
   // The number of bytes to be skipped.
   int64 remaining_offset_;
 
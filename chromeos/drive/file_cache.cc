@@ -27,11 +27,38 @@ namespace {
 
 typedef std::map<std::string, FileCacheEntry> CacheMap;
 
+// The MD5 of a file is only reused if the file was last modified at least
+// this long before the MD5 was set. File systems may store the modification
+// time in whole seconds, so a file modified within the same second could
+// otherwise keep its size and modification time while its content changes.
+const int kMinStableFileAgeSeconds = 2;
+
 // Returns ID extracted from the path.
 std::string GetIdFromPath(const base::FilePath& path) {
   return util::UnescapeCacheFileName(path.BaseName().AsUTF8Unsafe());
 }
 
+// Sets |md5| to |cache_entry| along with the size and the last modified time
+// of |cache_file_path|, used to tell later if |md5| is still valid. They are
+// not recorded for a recently modified file, whose MD5 is then never reused.
+void SetMd5(const base::FilePath& cache_file_path,
+            const std::string& md5,
+            FileCacheEntry* cache_entry) {
+  cache_entry->set_md5(md5);
+
+  base::PlatformFileInfo file_info;
+  if (file_util::GetFileInfo(cache_file_path, &file_info) &&
+      base::Time::Now() - file_info.last_modified >=
+          base::TimeDelta::FromSeconds(kMinStableFileAgeSeconds)) {
+    cache_entry->set_md5_file_size(file_info.size);
+    cache_entry->set_md5_last_modified(
+        file_info.last_modified.ToInternalValue());
+  } else {
+    cache_entry->clear_md5_file_size();
+    cache_entry->clear_md5_last_modified();
+  }
+}
+
 // Scans cache subdirectory and insert found files to |cache_map|.
 void ScanCacheDirectory(const base::FilePath& directory_path,
                         CacheMap* cache_map) {
@@ -49,7 +76,7 @@ void ScanCacheDirectory(const base::FilePath& directory_path,
 
     // Determine cache state.
     FileCacheEntry cache_entry;
-    cache_entry.set_md5(md5);
+    SetMd5(current, md5, &cache_entry);
     cache_entry.set_is_present(true);
 
     // Create and insert new entry into cache map.
@@ -393,12 +420,34 @@ FileError FileCache::ClearDirty(const std::string& id, const std::string& md5) {
     return FILE_ERROR_INVALID_OPERATION;
   }
 
-  cache_entry.set_md5(md5);
+  SetMd5(GetCacheFilePath(id), md5, &cache_entry);
   cache_entry.set_is_dirty(false);
   return storage_->PutCacheEntry(id, cache_entry) ?
       FILE_ERROR_OK : FILE_ERROR_FAILED;
 }
 
+std::string FileCache::GetMd5(const std::string& id) {
+  AssertOnSequencedWorkerPool();
+
+  FileCacheEntry cache_entry;
+  if (!storage_->GetCacheEntry(id, &cache_entry) ||
+      !cache_entry.is_present())
+    return std::string();
+
+  const base::FilePath cache_file_path = GetCacheFilePath(id);
+  base::PlatformFileInfo file_info;
+  if (!file_util::GetFileInfo(cache_file_path, &file_info))
+    return std::string();
+
+  if (cache_entry.has_md5_file_size() &&
+      cache_entry.md5_file_size() == file_info.size &&
+      cache_entry.md5_last_modified() ==
+          file_info.last_modified.ToInternalValue())
+    return cache_entry.md5();
+
+  return util::GetMd5Digest(cache_file_path);
+}
+
 void FileCache::RemoveOnUIThread(const std::string& id,
                                  const FileOperationCallback& callback) {
   DCHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
@@ -556,7 +605,7 @@ FileError FileCache::StoreInternal(const std::string& id,
   }
 
   // Now that file operations have completed, update metadata.
-  cache_entry.set_md5(md5);
+  SetMd5(dest_path, md5, &cache_entry);
   cache_entry.set_is_present(true);
   cache_entry.set_is_dirty(false);
   return storage_->PutCacheEntry(id, cache_entry) ?
@@ -174,6 +174,11 @@ class FileCache {
   // Clears dirty state of the specified entry and updates its MD5.
   FileError ClearDirty(const std::string& id, const std::string& md5);
 
+  // Returns the MD5 of the cache file of the specified entry, or an empty
+  // string on failure. The file is read only if it was modified since the
+  // MD5 in the cache entry was set.
+  std::string GetMd5(const std::string& id);
+
   // Runs Remove() on |blocking_task_runner_| and runs |callback| with the
   // result.
   // Must be called on the UI thread.
@@ -943,6 +943,55 @@ TEST_F(FileCacheTest, RenameCacheFilesToNewFormat) {
   EXPECT_EQ("kyu", contents);
 }
 
+TEST_F(FileCacheTest, GetMd5) {
+  const std::string id("pdf:1a2b");
+  const std::string contents("abcdef0123456789");
+  const std::string md5(base::MD5String(contents));
+
+  // Not cached.
+  EXPECT_TRUE(cache_->GetMd5(id).empty());
+
+  // The MD5 of a file which was just written is never reused, since a
+  // change within the same second may not change its modification time.
+  const base::FilePath src_file = temp_dir_.path().AppendASCII("src");
+  ASSERT_TRUE(google_apis::test_util::WriteStringToFile(src_file, contents));
+  ASSERT_EQ(FILE_ERROR_OK,
+            cache_->Store(id, "fake_md5", src_file,
+                          FileCache::FILE_OPERATION_COPY));
+  EXPECT_EQ(md5, cache_->GetMd5(id));
+
+  // Store an older file with a fake MD5, which is returned without reading
+  // the file.
+  const base::Time kOldTime = base::Time::Now() - base::TimeDelta::FromHours(2);
+  ASSERT_TRUE(file_util::TouchFile(src_file, kOldTime, kOldTime));
+  ASSERT_EQ(FILE_ERROR_OK,
+            cache_->Store(id, "fake_md5", src_file,
+                          FileCache::FILE_OPERATION_MOVE));
+  EXPECT_EQ("fake_md5", cache_->GetMd5(id));
+
+  // Once modified, the file is read to compute its MD5.
+  base::FilePath cache_file_path;
+  ASSERT_EQ(FILE_ERROR_OK, cache_->MarkDirty(id));
+  ASSERT_EQ(FILE_ERROR_OK, cache_->GetFile(id, &cache_file_path));
+  ASSERT_TRUE(google_apis::test_util::WriteStringToFile(cache_file_path,
+                                                        contents + "x"));
+  EXPECT_EQ(base::MD5String(contents + "x"), cache_->GetMd5(id));
+
+  // Clearing the dirty state right after the write does not let GetMd5()
+  // trust the given MD5.
+  ASSERT_EQ(FILE_ERROR_OK, cache_->ClearDirty(id, "fake_md5"));
+  EXPECT_EQ(base::MD5String(contents + "x"), cache_->GetMd5(id));
+
+  // Once the file is old enough, the given MD5 is used.
+  const base::Time kModifiedTime =
+      base::Time::Now() - base::TimeDelta::FromHours(1);
+  ASSERT_TRUE(file_util::TouchFile(cache_file_path, kModifiedTime,
+                                   kModifiedTime));
+  ASSERT_EQ(FILE_ERROR_OK, cache_->MarkDirty(id));
+  ASSERT_EQ(FILE_ERROR_OK, cache_->ClearDirty(id, md5));
+  EXPECT_EQ(md5, cache_->GetMd5(id));
+}
+
 TEST_F(FileCacheTest, ClearAll) {
   const std::string id("pdf:1a2b");
   const std::string md5("abcdef0123456789");
@@ -8,7 +8,6 @@
 #include "chrome/browser/chromeos/drive/drive.pb.h"
 #include "chrome/browser/chromeos/drive/file_cache.h"
 #include "chrome/browser/chromeos/drive/file_system/operation_observer.h"
-#include "chrome/browser/chromeos/drive/file_system_util.h"
 #include "chrome/browser/chromeos/drive/job_scheduler.h"
 #include "chrome/browser/chromeos/drive/resource_entry_conversion.h"
 #include "chrome/browser/chromeos/drive/resource_metadata.h"
@@ -54,7 +53,7 @@ FileError GetFileLocalState(internal::ResourceMetadata* metadata,
     return error;
 
   if (check == UpdateOperation::RUN_CONTENT_CHECK) {
-    const std::string& md5 = util::GetMd5Digest(local_state->cache_file_path);
+    const std::string& md5 = cache->GetMd5(local_state->local_id);
     local_state->content_is_same =
         (md5 == local_state->entry.file_specific_info().md5());
     if (local_state->content_is_same)
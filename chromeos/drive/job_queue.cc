@@ -83,4 +83,9 @@ void JobQueue::Remove(JobID id) {
   }
 }
 
+void JobQueue::SetMaxConcurrentJobs(size_t num_max_concurrent_jobs) {
+  DCHECK_GT(num_max_concurrent_jobs, 0U);
+  num_max_concurrent_jobs_ = num_max_concurrent_jobs;
+}
+
 }  // namespace drive
@@ -52,6 +52,12 @@ class JobQueue {
   // Removes the job from the queue.
   void Remove(JobID id);
 
+  // Changes the limit of concurrent job count. Running jobs are not affected,
+  // but no job is popped until the count of running jobs is below the limit.
+  void SetMaxConcurrentJobs(size_t num_max_concurrent_jobs);
+
+  size_t num_max_concurrent_jobs() const { return num_max_concurrent_jobs_; }
+
  private:
   size_t num_max_concurrent_jobs_;
   std::vector<std::deque<JobID> > queue_;
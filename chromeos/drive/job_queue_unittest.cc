@@ -101,4 +101,38 @@ TEST(JobQueueTest, JobQueueRemove) {
   EXPECT_FALSE(queue.PopForRun(LOW_PRIORITY, &id));
 }
 
+TEST(JobQueueTest, SetMaxConcurrentJobs) {
+  const int kNumMaxConcurrentJobs = 3;
+  const int kNumPriorityLevels = 1;
+  const int kPriority = 0;
+
+  JobQueue queue(kNumMaxConcurrentJobs, kNumPriorityLevels);
+  queue.Push(101, kPriority);
+  queue.Push(102, kPriority);
+  queue.Push(103, kPriority);
+  queue.Push(104, kPriority);
+
+  JobID id;
+  EXPECT_TRUE(queue.PopForRun(kPriority, &id));
+  EXPECT_EQ(101, id);
+  EXPECT_TRUE(queue.PopForRun(kPriority, &id));
+  EXPECT_EQ(102, id);
+
+  // Lower the limit below the number of running jobs.
+  queue.SetMaxConcurrentJobs(1);
+  EXPECT_EQ(1U, queue.num_max_concurrent_jobs());
+  EXPECT_FALSE(queue.PopForRun(kPriority, &id));
+  queue.MarkFinished(101);
+  EXPECT_FALSE(queue.PopForRun(kPriority, &id));
+  queue.MarkFinished(102);
+  EXPECT_TRUE(queue.PopForRun(kPriority, &id));
+  EXPECT_EQ(103, id);
+  EXPECT_FALSE(queue.PopForRun(kPriority, &id));
+
+  // Raise the limit again.
+  queue.SetMaxConcurrentJobs(2);
+  EXPECT_TRUE(queue.PopForRun(kPriority, &id));
+  EXPECT_EQ(104, id);
+}
+
 }  // namespace drive
@@ -4,7 +4,10 @@
 
 #include "chrome/browser/chromeos/drive/job_scheduler.h"
 
+#include <algorithm>
+
 #include "base/message_loop/message_loop.h"
+#include "base/metrics/histogram.h"
 #include "base/prefs/pref_service.h"
 #include "base/rand_util.h"
 #include "base/strings/string_number_conversions.h"
@@ -196,6 +199,15 @@ void JobScheduler::GetAboutResource(
   DCHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
   DCHECK(!callback.is_null());
 
+  // The about resource is the same for all the callers, so share the job
+  // which is already queued or running.
+  about_resource_callbacks_.push_back(callback);
+  if (about_resource_callbacks_.size() > 1)
+    return;
+
+  const google_apis::AboutResourceCallback run_callbacks =
+      base::Bind(&JobScheduler::RunAboutResourceCallbacks,
+                 weak_ptr_factory_.GetWeakPtr());
   JobEntry* new_job = CreateNewJob(TYPE_GET_ABOUT_RESOURCE);
   new_job->task = base::Bind(
       &DriveServiceInterface::GetAboutResource,
@@ -203,8 +215,8 @@ void JobScheduler::GetAboutResource(
       base::Bind(&JobScheduler::OnGetAboutResourceJobDone,
                  weak_ptr_factory_.GetWeakPtr(),
                  new_job->job_info.job_id,
-                 callback));
-  new_job->abort_callback = google_apis::CreateErrorRunCallback(callback);
+                 run_callbacks));
+  new_job->abort_callback = google_apis::CreateErrorRunCallback(run_callbacks);
   StartJob(new_job);
 }
 
@@ -863,6 +875,42 @@ void JobScheduler::UpdateWait() {
   wait_until_ = std::max(wait_until_, base::Time::Now() + delay);
 }
 
+void JobScheduler::UpdateMaxConcurrentMetadataJobs(
+    QueueType queue_type,
+    google_apis::GDataErrorCode error) {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
+
+  // Only the metadata queue runs several jobs at once. A 403 is not a sign of
+  // overload: it is returned for a missing permission as well.
+  if (queue_type != METADATA_QUEUE)
+    return;
+
+  JobQueue* queue = queue_[METADATA_QUEUE].get();
+  const bool is_throttled =
+      error == google_apis::HTTP_SERVICE_UNAVAILABLE ||
+      error == google_apis::HTTP_INTERNAL_SERVER_ERROR;
+  size_t max_jobs = queue->num_max_concurrent_jobs();
+  if (is_throttled)
+    max_jobs = 1;
+  else if (error == google_apis::HTTP_SUCCESS)
+    max_jobs = std::min(max_jobs + 1,
+                        static_cast<size_t>(kMaxJobCount[METADATA_QUEUE]));
+  queue->SetMaxConcurrentJobs(max_jobs);
+}
+
+// static
+void JobScheduler::RecordJobLatency(JobType type,
+                                    const base::TimeDelta& latency) {
+  // Equivalent to UMA_HISTOGRAM_MEDIUM_TIMES, which needs a constant name.
+  base::HistogramBase* histogram = base::Histogram::FactoryTimeGet(
+      "Drive.JobLatency." + JobTypeToString(type),
+      base::TimeDelta::FromMilliseconds(10),
+      base::TimeDelta::FromMinutes(3),
+      50,
+      base::HistogramBase::kUmaTargetedHistogramFlag);
+  histogram->AddTime(latency);
+}
+
 bool JobScheduler::OnJobDone(JobID job_id, google_apis::GDataErrorCode error) {
   DCHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
 
@@ -892,6 +940,7 @@ bool JobScheduler::OnJobDone(JobID job_id, google_apis::GDataErrorCode error) {
   } else {
     throttle_count_ = 0;
   }
+  UpdateMaxConcurrentMetadataJobs(queue_type, error);
 
   const bool should_retry =
       is_server_error && job_entry->retry_count < kMaxRetryCount;
@@ -905,6 +954,8 @@ bool JobScheduler::OnJobDone(JobID job_id, google_apis::GDataErrorCode error) {
     // Requeue the job.
     QueueJob(job_id);
   } else {
+    if (success)
+      RecordJobLatency(job_info->job_type, elapsed);
     NotifyJobDone(*job_info, error);
     // The job has finished, no retry will happen in the scheduler. Now we can
     // remove the job info from the map.
@@ -956,6 +1007,28 @@ void JobScheduler::OnGetAboutResourceJobDone(
     callback.Run(error, about_resource.Pass());
 }
 
+void JobScheduler::RunAboutResourceCallbacks(
+    google_apis::GDataErrorCode error,
+    scoped_ptr<google_apis::AboutResource> about_resource) {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
+  DCHECK(!about_resource_callbacks_.empty());
+
+  std::vector<google_apis::AboutResourceCallback> callbacks;
+  callbacks.swap(about_resource_callbacks_);
+  for (size_t i = 0; i + 1 < callbacks.size(); ++i) {
+    scoped_ptr<google_apis::AboutResource> copy;
+    if (about_resource) {
+      copy.reset(new google_apis::AboutResource);
+      copy->set_largest_change_id(about_resource->largest_change_id());
+      copy->set_quota_bytes_total(about_resource->quota_bytes_total());
+      copy->set_quota_bytes_used(about_resource->quota_bytes_used());
+      copy->set_root_folder_id(about_resource->root_folder_id());
+    }
+    callbacks[i].Run(error, copy.Pass());
+  }
+  callbacks.back().Run(error, about_resource.Pass());
+}
+
 void JobScheduler::OnGetShareUrlJobDone(
     JobID job_id,
     const google_apis::GetShareUrlCallback& callback,
@@ -67,7 +67,9 @@ class JobScheduler
   // |callback| must not be null.
   void GetAppList(const google_apis::AppListCallback& callback);
 
-  // Adds a GetAboutResource operation to the queue.
+  // Adds a GetAboutResource operation to the queue. If another
+  // GetAboutResource operation is already queued or running, |callback| is
+  // run with its result instead.
   // |callback| must not be null.
   void GetAboutResource(const google_apis::AboutResourceCallback& callback);
 
@@ -273,6 +275,16 @@ class JobScheduler
   // Updates |wait_until_| to throttle requests.
   void UpdateWait();
 
+  // Adjusts the number of concurrent jobs of the metadata queue after a job
+  // of |queue_type| finished with |error|: it drops to one when the server is
+  // overloaded, and grows back by one with each successful job. Jobs of the
+  // other queues leave it unchanged.
+  void UpdateMaxConcurrentMetadataJobs(QueueType queue_type,
+                                       google_apis::GDataErrorCode error);
+
+  // Records the latency of a finished job to the histogram of its type.
+  static void RecordJobLatency(JobType type, const base::TimeDelta& latency);
+
   // Retries the job if needed and returns false. Otherwise returns true.
   bool OnJobDone(JobID job_id, google_apis::GDataErrorCode error);
 
@@ -297,6 +309,12 @@ class JobScheduler
       google_apis::GDataErrorCode error,
       scoped_ptr<google_apis::AboutResource> about_resource);
 
+  // Runs and clears |about_resource_callbacks_| with the result of a
+  // GetAboutResource job.
+  void RunAboutResourceCallbacks(
+      google_apis::GDataErrorCode error,
+      scoped_ptr<google_apis::AboutResource> about_resource);
+
   // Callback for job finishing with a GetShareUrlCallback.
   void OnGetShareUrlJobDone(
       JobID job_id,
@@ -383,6 +401,9 @@ class JobScheduler
   // The queues of jobs.
   scoped_ptr<JobQueue> queue_[NUM_QUEUES];
 
+  // The callbacks of the GetAboutResource calls waiting for the same job.
+  std::vector<google_apis::AboutResourceCallback> about_resource_callbacks_;
+
   // The list of queued job info indexed by job IDs.
   typedef IDMap<JobEntry, IDMapOwnPointer> JobIDMap;
   JobIDMap job_map_;
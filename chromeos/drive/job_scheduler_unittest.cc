@@ -144,6 +144,22 @@ class JobSchedulerTest : public testing::Test {
     return JobScheduler::kMaxJobCount[JobScheduler::METADATA_QUEUE];
   }
 
+  // Returns the current limit of concurrent jobs of the metadata queue.
+  int GetMetadataQueueConcurrentJobCount() {
+    return static_cast<int>(
+        scheduler_->queue_[JobScheduler::METADATA_QUEUE]->
+            num_max_concurrent_jobs());
+  }
+
+  // Updates the limits of concurrent jobs as if a job of the metadata queue,
+  // or of the file queue if |is_file_job|, had finished with |error|.
+  void UpdateConcurrencyAfterJob(bool is_file_job,
+                          google_apis::GDataErrorCode error) {
+    scheduler_->UpdateMaxConcurrentMetadataJobs(
+        is_file_job ? JobScheduler::FILE_QUEUE : JobScheduler::METADATA_QUEUE,
+        error);
+  }
+
   content::TestBrowserThreadBundle thread_bundle_;
   scoped_ptr<TestingPrefServiceSimple> pref_service_;
   scoped_ptr<test_util::FakeNetworkChangeNotifier>
@@ -165,6 +181,67 @@ TEST_F(JobSchedulerTest, GetAboutResource) {
   ASSERT_TRUE(about_resource);
 }
 
+TEST_F(JobSchedulerTest, GetAboutResource_Coalesced) {
+  ConnectToWifi();
+
+  google_apis::GDataErrorCode error1 = google_apis::GDATA_OTHER_ERROR;
+  google_apis::GDataErrorCode error2 = google_apis::GDATA_OTHER_ERROR;
+  scoped_ptr<google_apis::AboutResource> about_resource1;
+  scoped_ptr<google_apis::AboutResource> about_resource2;
+  scheduler_->GetAboutResource(
+      google_apis::test_util::CreateCopyResultCallback(
+          &error1, &about_resource1));
+  scheduler_->GetAboutResource(
+      google_apis::test_util::CreateCopyResultCallback(
+          &error2, &about_resource2));
+  base::RunLoop().RunUntilIdle();
+
+  // Both callers get the result of a single request.
+  EXPECT_EQ(1, fake_drive_service_->about_resource_load_count());
+  ASSERT_EQ(google_apis::HTTP_SUCCESS, error1);
+  ASSERT_EQ(google_apis::HTTP_SUCCESS, error2);
+  ASSERT_TRUE(about_resource1);
+  ASSERT_TRUE(about_resource2);
+  EXPECT_EQ(about_resource1->largest_change_id(),
+            about_resource2->largest_change_id());
+  EXPECT_EQ(about_resource1->root_folder_id(),
+            about_resource2->root_folder_id());
+
+  // A later call sends a new request.
+  scheduler_->GetAboutResource(
+      google_apis::test_util::CreateCopyResultCallback(
+          &error1, &about_resource1));
+  base::RunLoop().RunUntilIdle();
+  EXPECT_EQ(2, fake_drive_service_->about_resource_load_count());
+  EXPECT_EQ(google_apis::HTTP_SUCCESS, error1);
+}
+
+TEST_F(JobSchedulerTest, MetadataConcurrencyAdapts) {
+  const int kMaxJobCount = GetMetadataQueueMaxJobCount();
+  ASSERT_LT(2, kMaxJobCount);
+  EXPECT_EQ(kMaxJobCount, GetMetadataQueueConcurrentJobCount());
+
+  // Neither a 403 nor a failed file job is a sign that the server is
+  // overloaded.
+  UpdateConcurrencyAfterJob(false, google_apis::HTTP_FORBIDDEN);
+  EXPECT_EQ(kMaxJobCount, GetMetadataQueueConcurrentJobCount());
+  UpdateConcurrencyAfterJob(true, google_apis::HTTP_SERVICE_UNAVAILABLE);
+  EXPECT_EQ(kMaxJobCount, GetMetadataQueueConcurrentJobCount());
+
+  // A throttled metadata job drops the queue to one job.
+  UpdateConcurrencyAfterJob(false, google_apis::HTTP_SERVICE_UNAVAILABLE);
+  EXPECT_EQ(1, GetMetadataQueueConcurrentJobCount());
+
+  // Successful file jobs don't grow it back, successful metadata jobs do.
+  UpdateConcurrencyAfterJob(true, google_apis::HTTP_SUCCESS);
+  EXPECT_EQ(1, GetMetadataQueueConcurrentJobCount());
+  UpdateConcurrencyAfterJob(false, google_apis::HTTP_SUCCESS);
+  EXPECT_EQ(2, GetMetadataQueueConcurrentJobCount());
+  for (int i = 0; i < kMaxJobCount; ++i)
+    UpdateConcurrencyAfterJob(false, google_apis::HTTP_SUCCESS);
+  EXPECT_EQ(kMaxJobCount, GetMetadataQueueConcurrentJobCount());
+}
+
 TEST_F(JobSchedulerTest, GetAppList) {
   ConnectToWifi();
 
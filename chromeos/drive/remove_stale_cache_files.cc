@@ -20,6 +20,10 @@ void RemoveStaleCacheFiles(FileCache* cache,
                            ResourceMetadata* resource_metadata) {
   std::vector<std::string> resource_ids_to_be_removed;
 
+  // The cache entries are stored in the same storage as the metadata, so the
+  // removals below are grouped in the batch too.
+  resource_metadata->BeginBatch();
+
   scoped_ptr<FileCache::Iterator> it = cache->GetIterator();
   for (; !it->IsAtEnd(); it->Advance()) {
     ResourceEntry entry;
@@ -35,6 +39,10 @@ void RemoveStaleCacheFiles(FileCache* cache,
           << it->GetID();
     }
   }
+
+  FileError error = resource_metadata->CommitBatch();
+  LOG_IF(WARNING, error != FILE_ERROR_OK)
+      << "Failed to remove stale cache entries: " << FileErrorToString(error);
 }
 
 }  // namespace internal
@@ -8,6 +8,7 @@
 #include "base/strings/stringprintf.h"
 #include "base/sys_info.h"
 #include "chrome/browser/chromeos/drive/drive.pb.h"
+#include "chrome/browser/chromeos/drive/file_cache.h"
 #include "chrome/browser/chromeos/drive/file_system_util.h"
 #include "chrome/browser/chromeos/drive/resource_metadata_storage.h"
 #include "content/public/browser/browser_thread.h"
@@ -27,14 +28,6 @@ void SetBaseNameFromTitle(ResourceEntry* entry) {
   entry->set_base_name(util::NormalizeFileName(base_name));
 }
 
-// Returns true if enough disk space is available for DB operation.
-// TODO(hashimoto): Merge this with FileCache's FreeDiskSpaceGetterInterface.
-bool EnoughDiskSpaceIsAvailableForDBOperation(const base::FilePath& path) {
-  const int64 kRequiredDiskSpaceInMB = 128;  // 128 MB seems to be large enough.
-  return base::SysInfo::AmountOfFreeDiskSpace(path) >=
-      kRequiredDiskSpaceInMB * (1 << 20);
-}
-
 // Runs |callback| with arguments.
 void RunGetResourceEntryCallback(const GetResourceEntryCallback& callback,
                                  scoped_ptr<ResourceEntry> entry,
@@ -66,6 +59,7 @@ ResourceMetadata::ResourceMetadata(
     scoped_refptr<base::SequencedTaskRunner> blocking_task_runner)
     : blocking_task_runner_(blocking_task_runner),
       storage_(storage),
+      free_disk_space_getter_(NULL),
       weak_ptr_factory_(this) {
   DCHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
 }
@@ -73,7 +67,7 @@ ResourceMetadata::ResourceMetadata(
 FileError ResourceMetadata::Initialize() {
   DCHECK(blocking_task_runner_->RunsTasksOnCurrentThread());
 
-  if (!EnoughDiskSpaceIsAvailableForDBOperation(storage_->directory_path()))
+  if (!EnoughDiskSpaceIsAvailableForDBOperation())
     return FILE_ERROR_NO_LOCAL_SPACE;
 
   if (!SetUpDefaultEntries())
@@ -95,7 +89,7 @@ void ResourceMetadata::Destroy() {
 FileError ResourceMetadata::Reset() {
   DCHECK(blocking_task_runner_->RunsTasksOnCurrentThread());
 
-  if (!EnoughDiskSpaceIsAvailableForDBOperation(storage_->directory_path()))
+  if (!EnoughDiskSpaceIsAvailableForDBOperation())
     return FILE_ERROR_NO_LOCAL_SPACE;
 
   if (!storage_->SetLargestChangestamp(0) ||
@@ -138,6 +132,14 @@ bool ResourceMetadata::SetUpDefaultEntries() {
   return true;
 }
 
+bool ResourceMetadata::EnoughDiskSpaceIsAvailableForDBOperation() {
+  const int64 kRequiredDiskSpaceInMB = 128;  // 128 MB seems to be large enough.
+  const int64 free_disk_space = free_disk_space_getter_ ?
+      free_disk_space_getter_->AmountOfFreeDiskSpace() :
+      base::SysInfo::AmountOfFreeDiskSpace(storage_->directory_path());
+  return free_disk_space >= kRequiredDiskSpaceInMB * (1 << 20);
+}
+
 void ResourceMetadata::DestroyOnBlockingPool() {
   DCHECK(blocking_task_runner_->RunsTasksOnCurrentThread());
   delete this;
@@ -151,18 +153,41 @@ int64 ResourceMetadata::GetLargestChangestamp() {
 FileError ResourceMetadata::SetLargestChangestamp(int64 value) {
   DCHECK(blocking_task_runner_->RunsTasksOnCurrentThread());
 
-  if (!EnoughDiskSpaceIsAvailableForDBOperation(storage_->directory_path()))
+  if (!EnoughDiskSpaceIsAvailableForDBOperation())
     return FILE_ERROR_NO_LOCAL_SPACE;
 
   return storage_->SetLargestChangestamp(value) ?
       FILE_ERROR_OK : FILE_ERROR_FAILED;
 }
 
+void ResourceMetadata::BeginBatch() {
+  DCHECK(blocking_task_runner_->RunsTasksOnCurrentThread());
+  storage_->BeginBatch();
+}
+
+FileError ResourceMetadata::CommitBatch() {
+  DCHECK(blocking_task_runner_->RunsTasksOnCurrentThread());
+
+  // The batch has to be ended either way, or the storage would keep the
+  // later writes in memory.
+  if (!EnoughDiskSpaceIsAvailableForDBOperation()) {
+    storage_->AbortBatch();
+    return FILE_ERROR_NO_LOCAL_SPACE;
+  }
+
+  return storage_->CommitBatch() ? FILE_ERROR_OK : FILE_ERROR_FAILED;
+}
+
+void ResourceMetadata::SetFreeDiskSpaceGetterForTesting(
+    FreeDiskSpaceGetterInterface* getter) {
+  free_disk_space_getter_ = getter;
+}
+
 FileError ResourceMetadata::AddEntry(const ResourceEntry& entry,
                                      std::string* out_id) {
   DCHECK(blocking_task_runner_->RunsTasksOnCurrentThread());
 
-  if (!EnoughDiskSpaceIsAvailableForDBOperation(storage_->directory_path()))
+  if (!EnoughDiskSpaceIsAvailableForDBOperation())
     return FILE_ERROR_NO_LOCAL_SPACE;
 
   // Multiple entries with the same resource ID should not be present.
@@ -192,7 +217,7 @@ FileError ResourceMetadata::AddEntry(const ResourceEntry& entry,
 FileError ResourceMetadata::RemoveEntry(const std::string& id) {
   DCHECK(blocking_task_runner_->RunsTasksOnCurrentThread());
 
-  if (!EnoughDiskSpaceIsAvailableForDBOperation(storage_->directory_path()))
+  if (!EnoughDiskSpaceIsAvailableForDBOperation())
     return FILE_ERROR_NO_LOCAL_SPACE;
 
   // Disallow deletion of special entries "/drive" and "/drive/other".
@@ -321,7 +346,7 @@ FileError ResourceMetadata::RefreshEntry(const ResourceEntry& entry) {
   // TODO(hashimoto): Return an error if the operation will result in having
   // multiple entries with the same resource ID.
 
-  if (!EnoughDiskSpaceIsAvailableForDBOperation(storage_->directory_path()))
+  if (!EnoughDiskSpaceIsAvailableForDBOperation())
     return FILE_ERROR_NO_LOCAL_SPACE;
 
   ResourceEntry old_entry;
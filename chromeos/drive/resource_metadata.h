@@ -38,6 +38,8 @@ typedef base::Callback<void(const ResourceEntry& entry)> IterateCallback;
 
 namespace internal {
 
+class FreeDiskSpaceGetterInterface;
+
 // Storage for Drive Metadata.
 // All methods must be run with |blocking_task_runner| unless otherwise noted.
 class ResourceMetadata {
@@ -66,6 +68,19 @@ class ResourceMetadata {
   // Sets the largest changestamp.
   FileError SetLargestChangestamp(int64 value);
 
+  // Starts grouping the writes to the storage until CommitBatch() is called.
+  // See ResourceMetadataStorage::BeginBatch().
+  void BeginBatch();
+
+  // Writes the writes grouped since BeginBatch(). If there is not enough disk
+  // space, the writes not yet written are dropped. The batch is ended either
+  // way.
+  FileError CommitBatch();
+
+  // Makes the disk space checks use |getter| rather than the actual free disk
+  // space. |getter| is not owned. Passing NULL restores the default.
+  void SetFreeDiskSpaceGetterForTesting(FreeDiskSpaceGetterInterface* getter);
+
   // Adds |entry| to the metadata tree based on its parent_local_id.
   FileError AddEntry(const ResourceEntry& entry, std::string* out_id);
 
@@ -139,6 +154,9 @@ class ResourceMetadata {
   // Used to implement Destroy().
   void DestroyOnBlockingPool();
 
+  // Returns true if enough disk space is available for DB operation.
+  bool EnoughDiskSpaceIsAvailableForDBOperation();
+
   // Puts an entry under its parent directory. Removes the child from the old
   // parent if there is. This method will also do name de-duplication to ensure
   // that the exposed presentation path does not have naming conflicts. Two
@@ -152,6 +170,9 @@ class ResourceMetadata {
 
   ResourceMetadataStorage* storage_;
 
+  // Not owned. NULL unless set for testing.
+  FreeDiskSpaceGetterInterface* free_disk_space_getter_;
+
   // This should remain the last member so it'll be destroyed first and
   // invalidate its weak pointers before other members are destroyed.
   base::WeakPtrFactory<ResourceMetadata> weak_ptr_factory_;
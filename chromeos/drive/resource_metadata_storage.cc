@@ -4,6 +4,9 @@
 
 #include "chrome/browser/chromeos/drive/resource_metadata_storage.h"
 
+#include <map>
+#include <set>
+
 #include "base/bind.h"
 #include "base/file_util.h"
 #include "base/location.h"
@@ -77,6 +80,36 @@ bool IsCacheEntryKey(const leveldb::Slice& key) {
   return key_substring.compare(expected_suffix) == 0;
 }
 
+// Maximum number of pending writes to keep in memory while a batch is open.
+// Once exceeded, the pending writes are written to the DB.
+const size_t kMaxPendingWrites = 1000;
+
+// Records the operations of a leveldb::WriteBatch to pending writes.
+class PendingWriteRecorder : public leveldb::WriteBatch::Handler {
+ public:
+  PendingWriteRecorder(std::map<std::string, std::string>* pending_puts,
+                       std::set<std::string>* pending_deletes)
+      : pending_puts_(pending_puts),
+        pending_deletes_(pending_deletes) {}
+
+  virtual void Put(const leveldb::Slice& key,
+                   const leveldb::Slice& value) OVERRIDE {
+    (*pending_puts_)[key.ToString()] = value.ToString();
+    pending_deletes_->erase(key.ToString());
+  }
+
+  virtual void Delete(const leveldb::Slice& key) OVERRIDE {
+    pending_puts_->erase(key.ToString());
+    pending_deletes_->insert(key.ToString());
+  }
+
+ private:
+  std::map<std::string, std::string>* pending_puts_;
+  std::set<std::string>* pending_deletes_;
+
+  DISALLOW_COPY_AND_ASSIGN(PendingWriteRecorder);
+};
+
 // Converts leveldb::Status to DBInitStatus.
 DBInitStatus LevelDBStatusToDBInitStatus(const leveldb::Status status) {
   if (status.ok())
@@ -266,6 +299,7 @@ ResourceMetadataStorage::ResourceMetadataStorage(
     base::SequencedTaskRunner* blocking_task_runner)
     : directory_path_(directory_path),
       cache_file_scan_is_needed_(true),
+      batch_is_open_(false),
       blocking_task_runner_(blocking_task_runner) {
 }
 
@@ -405,6 +439,27 @@ int64 ResourceMetadataStorage::GetLargestChangestamp() {
   return header.largest_changestamp();
 }
 
+void ResourceMetadataStorage::BeginBatch() {
+  base::ThreadRestrictions::AssertIOAllowed();
+  DCHECK(!batch_is_open_);
+  batch_is_open_ = true;
+}
+
+bool ResourceMetadataStorage::CommitBatch() {
+  base::ThreadRestrictions::AssertIOAllowed();
+  DCHECK(batch_is_open_);
+  batch_is_open_ = false;
+  return WritePendingWrites();
+}
+
+void ResourceMetadataStorage::AbortBatch() {
+  base::ThreadRestrictions::AssertIOAllowed();
+  DCHECK(batch_is_open_);
+  batch_is_open_ = false;
+  pending_puts_.clear();
+  pending_deletes_.clear();
+}
+
 bool ResourceMetadataStorage::PutEntry(const ResourceEntry& entry) {
   base::ThreadRestrictions::AssertIOAllowed();
 
@@ -433,9 +488,7 @@ bool ResourceMetadataStorage::PutEntry(const ResourceEntry& entry) {
   // Put the entry itself.
   batch.Put(id, serialized_entry);
 
-  const leveldb::Status status = resource_map_->Write(leveldb::WriteOptions(),
-                                                      &batch);
-  return status.ok();
+  return Write(&batch);
 }
 
 bool ResourceMetadataStorage::GetEntry(const std::string& id,
@@ -444,10 +497,8 @@ bool ResourceMetadataStorage::GetEntry(const std::string& id,
   DCHECK(!id.empty());
 
   std::string serialized_entry;
-  const leveldb::Status status = resource_map_->Get(leveldb::ReadOptions(),
-                                                    leveldb::Slice(id),
-                                                    &serialized_entry);
-  return status.ok() && out_entry->ParseFromString(serialized_entry);
+  return Get(id, &serialized_entry) &&
+      out_entry->ParseFromString(serialized_entry);
 }
 
 bool ResourceMetadataStorage::RemoveEntry(const std::string& id) {
@@ -467,17 +518,21 @@ bool ResourceMetadataStorage::RemoveEntry(const std::string& id) {
   // Remove the entry itself.
   batch.Delete(id);
 
-  const leveldb::Status status = resource_map_->Write(leveldb::WriteOptions(),
-                                                      &batch);
-  return status.ok();
+  return Write(&batch);
 }
 
 scoped_ptr<ResourceMetadataStorage::Iterator>
 ResourceMetadataStorage::GetIterator() {
   base::ThreadRestrictions::AssertIOAllowed();
 
-  scoped_ptr<leveldb::Iterator> it(
-      resource_map_->NewIterator(leveldb::ReadOptions()));
+  if (!WritePendingWrites())
+    DLOG(ERROR) << "Failed to write the pending writes.";
+
+  // The iterator scans all the entries (e.g. for searching), which should not
+  // push the blocks used by point lookups out of the cache.
+  leveldb::ReadOptions options;
+  options.fill_cache = false;
+  scoped_ptr<leveldb::Iterator> it(resource_map_->NewIterator(options));
   return make_scoped_ptr(new Iterator(it.Pass()));
 }
 
@@ -486,9 +541,7 @@ std::string ResourceMetadataStorage::GetChild(const std::string& parent_id,
   base::ThreadRestrictions::AssertIOAllowed();
 
   std::string child_id;
-  resource_map_->Get(leveldb::ReadOptions(),
-                     leveldb::Slice(GetChildEntryKey(parent_id, child_name)),
-                     &child_id);
+  Get(GetChildEntryKey(parent_id, child_name), &child_id);
   return child_id;
 }
 
@@ -496,11 +549,18 @@ void ResourceMetadataStorage::GetChildren(const std::string& parent_id,
                                           std::vector<std::string>* children) {
   base::ThreadRestrictions::AssertIOAllowed();
 
-  // Iterate over all entries with keys starting with |parent_id|.
+  if (!WritePendingWrites())
+    DLOG(ERROR) << "Failed to write the pending writes.";
+
+  // Iterate over all entries with keys starting with |parent_id| followed by
+  // the delimiter, so that the entries of other IDs which |parent_id| is a
+  // prefix of are not scanned.
+  std::string prefix = parent_id;
+  prefix.push_back(kDBKeyDelimeter);
   scoped_ptr<leveldb::Iterator> it(
       resource_map_->NewIterator(leveldb::ReadOptions()));
-  for (it->Seek(parent_id);
-       it->Valid() && it->key().starts_with(leveldb::Slice(parent_id));
+  for (it->Seek(prefix);
+       it->Valid() && it->key().starts_with(leveldb::Slice(prefix));
        it->Next()) {
     if (IsChildEntryKey(it->key()))
       children->push_back(it->value().ToString());
@@ -519,11 +579,9 @@ bool ResourceMetadataStorage::PutCacheEntry(const std::string& id,
     return false;
   }
 
-  const leveldb::Status status = resource_map_->Put(
-      leveldb::WriteOptions(),
-      leveldb::Slice(GetCacheEntryKey(id)),
-      leveldb::Slice(serialized_entry));
-  return status.ok();
+  leveldb::WriteBatch batch;
+  batch.Put(GetCacheEntryKey(id), serialized_entry);
+  return Write(&batch);
 }
 
 bool ResourceMetadataStorage::GetCacheEntry(const std::string& id,
@@ -532,27 +590,26 @@ bool ResourceMetadataStorage::GetCacheEntry(const std::string& id,
   DCHECK(!id.empty());
 
   std::string serialized_entry;
-  const leveldb::Status status = resource_map_->Get(
-      leveldb::ReadOptions(),
-      leveldb::Slice(GetCacheEntryKey(id)),
-      &serialized_entry);
-  return status.ok() && out_entry->ParseFromString(serialized_entry);
+  return Get(GetCacheEntryKey(id), &serialized_entry) &&
+      out_entry->ParseFromString(serialized_entry);
 }
 
 bool ResourceMetadataStorage::RemoveCacheEntry(const std::string& id) {
   base::ThreadRestrictions::AssertIOAllowed();
   DCHECK(!id.empty());
 
-  const leveldb::Status status = resource_map_->Delete(
-      leveldb::WriteOptions(),
-      leveldb::Slice(GetCacheEntryKey(id)));
-  return status.ok();
+  leveldb::WriteBatch batch;
+  batch.Delete(GetCacheEntryKey(id));
+  return Write(&batch);
 }
 
 scoped_ptr<ResourceMetadataStorage::CacheEntryIterator>
 ResourceMetadataStorage::GetCacheEntryIterator() {
   base::ThreadRestrictions::AssertIOAllowed();
 
+  if (!WritePendingWrites())
+    DLOG(ERROR) << "Failed to write the pending writes.";
+
   scoped_ptr<leveldb::Iterator> it(
       resource_map_->NewIterator(leveldb::ReadOptions()));
   return make_scoped_ptr(new CacheEntryIterator(it.Pass()));
@@ -560,6 +617,7 @@ ResourceMetadataStorage::GetCacheEntryIterator() {
 
 ResourceMetadataStorage::~ResourceMetadataStorage() {
   base::ThreadRestrictions::AssertIOAllowed();
+  DCHECK(!batch_is_open_);
 }
 
 void ResourceMetadataStorage::DestroyOnBlockingPool() {
@@ -587,22 +645,74 @@ bool ResourceMetadataStorage::PutHeader(
     return false;
   }
 
-  const leveldb::Status status = resource_map_->Put(
-      leveldb::WriteOptions(),
-      leveldb::Slice(GetHeaderDBKey()),
-      leveldb::Slice(serialized_header));
-  return status.ok();
+  leveldb::WriteBatch batch;
+  batch.Put(GetHeaderDBKey(), serialized_header);
+  return Write(&batch);
 }
 
 bool ResourceMetadataStorage::GetHeader(ResourceMetadataHeader* header) {
   base::ThreadRestrictions::AssertIOAllowed();
 
   std::string serialized_header;
-  const leveldb::Status status = resource_map_->Get(
-      leveldb::ReadOptions(),
-      leveldb::Slice(GetHeaderDBKey()),
-      &serialized_header);
-  return status.ok() && header->ParseFromString(serialized_header);
+  return Get(GetHeaderDBKey(), &serialized_header) &&
+      header->ParseFromString(serialized_header);
+}
+
+bool ResourceMetadataStorage::Get(const std::string& key,
+                                  std::string* value) {
+  base::ThreadRestrictions::AssertIOAllowed();
+
+  if (pending_deletes_.count(key))
+    return false;
+  std::map<std::string, std::string>::const_iterator it =
+      pending_puts_.find(key);
+  if (it != pending_puts_.end()) {
+    *value = it->second;
+    return true;
+  }
+
+  const leveldb::Status status = resource_map_->Get(leveldb::ReadOptions(),
+                                                    leveldb::Slice(key),
+                                                    value);
+  return status.ok();
+}
+
+bool ResourceMetadataStorage::Write(leveldb::WriteBatch* batch) {
+  base::ThreadRestrictions::AssertIOAllowed();
+
+  if (!batch_is_open_) {
+    const leveldb::Status status = resource_map_->Write(
+        leveldb::WriteOptions(), batch);
+    return status.ok();
+  }
+
+  PendingWriteRecorder recorder(&pending_puts_, &pending_deletes_);
+  if (!batch->Iterate(&recorder).ok())
+    return false;
+  if (pending_puts_.size() + pending_deletes_.size() < kMaxPendingWrites)
+    return true;
+  return WritePendingWrites();
+}
+
+bool ResourceMetadataStorage::WritePendingWrites() {
+  base::ThreadRestrictions::AssertIOAllowed();
+
+  if (pending_puts_.empty() && pending_deletes_.empty())
+    return true;
+
+  leveldb::WriteBatch batch;
+  for (std::set<std::string>::const_iterator it = pending_deletes_.begin();
+       it != pending_deletes_.end(); ++it)
+    batch.Delete(*it);
+  for (std::map<std::string, std::string>::const_iterator it =
+           pending_puts_.begin(); it != pending_puts_.end(); ++it)
+    batch.Put(it->first, it->second);
+  pending_puts_.clear();
+  pending_deletes_.clear();
+
+  const leveldb::Status status = resource_map_->Write(leveldb::WriteOptions(),
+                                                      &batch);
+  return status.ok();
 }
 
 bool ResourceMetadataStorage::CheckValidity() {
@@ -5,6 +5,8 @@
 #ifndef CHROME_BROWSER_CHROMEOS_DRIVE_RESOURCE_METADATA_STORAGE_H_
 #define CHROME_BROWSER_CHROMEOS_DRIVE_RESOURCE_METADATA_STORAGE_H_
 
+#include <map>
+#include <set>
 #include <string>
 #include <vector>
 
@@ -21,6 +23,7 @@ class SequencedTaskRunner;
 namespace leveldb {
 class DB;
 class Iterator;
+class WriteBatch;
 }
 
 namespace drive {
@@ -125,6 +128,20 @@ class ResourceMetadataStorage {
   // Gets the largest changestamp.
   int64 GetLargestChangestamp();
 
+  // Starts a batch. Until CommitBatch() is called, the writes to this storage
+  // are kept in memory and written to the DB together, which is much faster
+  // than writing them one by one. Reads see the pending writes. Creating an
+  // iterator or getting children writes the pending writes first.
+  void BeginBatch();
+
+  // Writes the pending writes of the batch started with BeginBatch(), and
+  // ends the batch. Returns false if any of the writes failed.
+  bool CommitBatch();
+
+  // Drops the pending writes of the batch started with BeginBatch(), and ends
+  // the batch. The writes already written to the DB are kept.
+  void AbortBatch();
+
   // Puts the entry to this storage.
   bool PutEntry(const ResourceEntry& entry);
 
@@ -176,6 +193,16 @@ class ResourceMetadataStorage {
   // Gets header.
   bool GetHeader(ResourceMetadataHeader* out_header);
 
+  // Gets the value of |key|, including the pending writes.
+  bool Get(const std::string& key, std::string* value);
+
+  // Writes |batch| to the DB, or adds it to the pending writes if a batch is
+  // open.
+  bool Write(leveldb::WriteBatch* batch);
+
+  // Writes the pending writes to the DB.
+  bool WritePendingWrites();
+
   // Checks validity of the data.
   bool CheckValidity();
 
@@ -187,6 +214,14 @@ class ResourceMetadataStorage {
   // Entries stored in this storage.
   scoped_ptr<leveldb::DB> resource_map_;
 
+  // True while a batch started with BeginBatch() is open.
+  bool batch_is_open_;
+
+  // Writes not yet written to |resource_map_|. A key is in at most one of
+  // them.
+  std::map<std::string, std::string> pending_puts_;
+  std::set<std::string> pending_deletes_;
+
   scoped_refptr<base::SequencedTaskRunner> blocking_task_runner_;
 
   DISALLOW_COPY_AND_ASSIGN(ResourceMetadataStorage);
@@ -57,6 +57,13 @@ class ResourceMetadataStorageTest : public testing::Test {
         ResourceMetadataStorage::GetChildEntryKey(parent_id, child_base_name));
   }
 
+  // Returns true if |key| is written to |storage_|'s DB.
+  bool IsWrittenToDB(const std::string& key) {
+    std::string value;
+    return storage_->resource_map_->Get(leveldb::ReadOptions(),
+                                        key, &value).ok();
+  }
+
   content::TestBrowserThreadBundle thread_bundle_;
   base::ScopedTempDir temp_dir_;
   scoped_ptr<ResourceMetadataStorage,
@@ -303,6 +310,98 @@ TEST_F(ResourceMetadataStorageTest, GetChildren) {
   }
 }
 
+TEST_F(ResourceMetadataStorageTest, Batch) {
+  const std::string parent_id = "parent";
+  const std::string child_id = "child";
+  const std::string child_name = "child_name";
+  const std::string removed_id = "removed";
+
+  ResourceEntry entry;
+  entry.set_local_id(parent_id);
+  EXPECT_TRUE(storage_->PutEntry(entry));
+  entry.set_local_id(removed_id);
+  EXPECT_TRUE(storage_->PutEntry(entry));
+
+  storage_->BeginBatch();
+
+  // The writes are visible, but not written to the DB yet.
+  entry.set_local_id(child_id);
+  entry.set_parent_local_id(parent_id);
+  entry.set_base_name(child_name);
+  EXPECT_TRUE(storage_->PutEntry(entry));
+  EXPECT_TRUE(storage_->RemoveEntry(removed_id));
+  EXPECT_TRUE(storage_->PutCacheEntry(child_id, FileCacheEntry()));
+
+  ResourceEntry result;
+  FileCacheEntry cache_entry;
+  EXPECT_TRUE(storage_->GetEntry(child_id, &result));
+  EXPECT_EQ(child_name, result.base_name());
+  EXPECT_EQ(child_id, storage_->GetChild(parent_id, child_name));
+  EXPECT_TRUE(storage_->GetCacheEntry(child_id, &cache_entry));
+  EXPECT_FALSE(storage_->GetEntry(removed_id, &result));
+  EXPECT_FALSE(IsWrittenToDB(child_id));
+  EXPECT_TRUE(IsWrittenToDB(removed_id));
+
+  EXPECT_TRUE(storage_->CommitBatch());
+  EXPECT_TRUE(IsWrittenToDB(child_id));
+  EXPECT_FALSE(IsWrittenToDB(removed_id));
+  EXPECT_TRUE(storage_->GetEntry(child_id, &result));
+  EXPECT_TRUE(storage_->GetCacheEntry(child_id, &cache_entry));
+
+  // Getting children writes the pending writes first.
+  storage_->BeginBatch();
+  EXPECT_TRUE(storage_->RemoveEntry(child_id));
+  std::vector<std::string> children;
+  storage_->GetChildren(parent_id, &children);
+  EXPECT_TRUE(children.empty());
+  EXPECT_FALSE(IsWrittenToDB(child_id));
+  EXPECT_TRUE(storage_->CommitBatch());
+}
+
+TEST_F(ResourceMetadataStorageTest, AbortBatch) {
+  ResourceEntry entry;
+  entry.set_local_id("written");
+  EXPECT_TRUE(storage_->PutEntry(entry));
+
+  storage_->BeginBatch();
+  entry.set_local_id("dropped");
+  EXPECT_TRUE(storage_->PutEntry(entry));
+  EXPECT_TRUE(storage_->RemoveEntry("written"));
+  storage_->AbortBatch();
+
+  ResourceEntry result;
+  EXPECT_FALSE(storage_->GetEntry("dropped", &result));
+  EXPECT_TRUE(storage_->GetEntry("written", &result));
+
+  // Writes after the batch are written to the DB right away.
+  entry.set_local_id("after");
+  EXPECT_TRUE(storage_->PutEntry(entry));
+  EXPECT_TRUE(IsWrittenToDB("after"));
+}
+
+TEST_F(ResourceMetadataStorageTest, GetChildren_PrefixID) {
+  // "abc" is a prefix of "abcd", but the children of "abcd" are not the
+  // children of "abc".
+  const std::string parents_id[] = { "abc", "abcd" };
+  for (size_t i = 0; i < arraysize(parents_id); ++i) {
+    ResourceEntry entry;
+    entry.set_local_id(parents_id[i]);
+    EXPECT_TRUE(storage_->PutEntry(entry));
+  }
+  ResourceEntry child;
+  child.set_local_id("child");
+  child.set_parent_local_id("abcd");
+  child.set_base_name("child_name");
+  EXPECT_TRUE(storage_->PutEntry(child));
+
+  std::vector<std::string> children;
+  storage_->GetChildren("abc", &children);
+  EXPECT_TRUE(children.empty());
+  storage_->GetChildren("abcd", &children);
+  ASSERT_EQ(1U, children.size());
+  EXPECT_EQ("child", children[0]);
+}
+
 TEST_F(ResourceMetadataStorageTest, OpenExistingDB) {
   const std::string parent_id1 = "abcdefg";
   const std::string child_name1 = "WXYZABC";
@@ -13,6 +13,7 @@
 #include "base/threading/sequenced_worker_pool.h"
 #include "base/threading/thread_restrictions.h"
 #include "chrome/browser/chromeos/drive/drive.pb.h"
+#include "chrome/browser/chromeos/drive/fake_free_disk_space_getter.h"
 #include "chrome/browser/chromeos/drive/file_system_util.h"
 #include "chrome/browser/chromeos/drive/test_util.h"
 #include "chrome/browser/google_apis/test_util.h"
@@ -376,6 +377,28 @@ TEST_F(ResourceMetadataTest, LargestChangestamp) {
   EXPECT_EQ(kChangestamp, resource_metadata_->GetLargestChangestamp());
 }
 
+TEST_F(ResourceMetadataTest, CommitBatch_NoLocalSpace) {
+  FakeFreeDiskSpaceGetter free_disk_space_getter;
+  resource_metadata_->SetFreeDiskSpaceGetterForTesting(&free_disk_space_getter);
+
+  resource_metadata_->BeginBatch();
+  EXPECT_EQ(FILE_ERROR_OK, resource_metadata_->SetLargestChangestamp(100));
+  free_disk_space_getter.set_default_value(0);
+  EXPECT_EQ(FILE_ERROR_NO_LOCAL_SPACE, resource_metadata_->CommitBatch());
+
+  // The batch is ended, so later writes are not kept in memory, and a new
+  // batch can be started.
+  free_disk_space_getter.set_default_value(test_util::kLotsOfSpace);
+  const int64 kChangestamp = 123456;
+  EXPECT_EQ(FILE_ERROR_OK,
+            resource_metadata_->SetLargestChangestamp(kChangestamp));
+  EXPECT_EQ(kChangestamp, metadata_storage_->GetLargestChangestamp());
+  resource_metadata_->BeginBatch();
+  EXPECT_EQ(FILE_ERROR_OK, resource_metadata_->CommitBatch());
+
+  resource_metadata_->SetFreeDiskSpaceGetterForTesting(NULL);
+}
+
 TEST_F(ResourceMetadataTest, RefreshEntry) {
   base::FilePath drive_file_path;
   ResourceEntry entry;
@@ -22,17 +22,13 @@ namespace internal {
 namespace {
 
 struct ResultCandidate {
-  ResultCandidate(const std::string& local_id,
-                  const ResourceEntry& entry,
-                  const std::string& highlighted_base_name)
+  ResultCandidate(const std::string& local_id, const ResourceEntry& entry)
       : local_id(local_id),
-        entry(entry),
-        highlighted_base_name(highlighted_base_name) {
+        entry(entry) {
   }
 
   std::string local_id;
   ResourceEntry entry;
-  std::string highlighted_base_name;
 };
 
 // Used to sort the result candidates per the last accessed/modified time. The
@@ -150,16 +146,19 @@ void MaybeAddEntryToResult(
 
   // Add |entry| to the result if the entry is eligible for the given
   // |options| and matches the query. The base name of the entry must
-  // contain |query| to match the query.
-  std::string highlighted;
+  // contain |query| to match the query. The highlighted name is built only
+  // for the final results, as most candidates are pushed out by newer ones.
+  size_t match_start = 0;
+  size_t match_length = 0;
   if (!IsEligibleEntry(entry, it, options) ||
-      (query && !FindAndHighlight(entry.base_name(), query, &highlighted)))
+      (query && !query->Search(base::UTF8ToUTF16(entry.base_name()),
+                               &match_start, &match_length)))
     return;
 
   // Make space for |entry| when appropriate.
   if (result_candidates->size() == at_most_num_matches)
     result_candidates->pop();
-  result_candidates->push(new ResultCandidate(it->GetID(), entry, highlighted));
+  result_candidates->push(new ResultCandidate(it->GetID(), entry));
 }
 
 // Implements SearchMetadata().
@@ -193,8 +192,11 @@ FileError SearchMetadataOnBlockingPool(ResourceMetadata* resource_metadata,
     base::FilePath path = resource_metadata->GetFilePath(candidate.local_id);
     if (path.empty())
       return FILE_ERROR_FAILED;
-    results->push_back(MetadataSearchResult(
-        path, candidate.entry, candidate.highlighted_base_name));
+    std::string highlighted;
+    if (!query_text.empty())
+      FindAndHighlight(candidate.entry.base_name(), &query, &highlighted);
+    results->push_back(MetadataSearchResult(path, candidate.entry,
+                                            highlighted));
   }
 
   // Reverse the order here because |result_candidates| puts the most
@@ -12,7 +12,9 @@
 #include "ash/wm/window_animations.h"
 #include "base/logging.h"
 #include "base/memory/scoped_ptr.h"
+#include "base/metrics/histogram.h"
 #include "base/observer_list.h"
+#include "base/time/time.h"
 #include "chrome/browser/chromeos/input_method/candidate_window_view.h"
 #include "chrome/browser/chromeos/input_method/delayable_widget.h"
 #include "chrome/browser/chromeos/input_method/infolist_window_view.h"
@@ -213,8 +215,11 @@ void CandidateWindowControllerImpl::UpdateLookupTable(
     return;
   }
 
+  const base::TimeTicks update_start_time = base::TimeTicks::Now();
   candidate_window_view_->UpdateCandidates(candidate_window);
   candidate_window_view_->ShowLookupTable();
+  UMA_HISTOGRAM_TIMES("InputMethod.CandidateWindowUpdateTime",
+                      base::TimeTicks::Now() - update_start_time);
 
   size_t focused_index = 0;
   std::vector<InfolistWindowView::Entry> infolist_entries;
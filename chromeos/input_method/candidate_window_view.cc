@@ -450,16 +450,22 @@ void CandidateView::Init(int shortcut_column_width,
   UpdateLabelBackgroundColors();
 }
 
+// The setters below are called for every row on each lookup table update, and
+// setting the text of a label invalidates the layout of the whole window even
+// if the text did not change. Only set the labels whose text changed.
 void CandidateView::SetCandidateText(const string16& text) {
-  candidate_label_->SetText(text);
+  if (candidate_label_->text() != text)
+    candidate_label_->SetText(text);
 }
 
 void CandidateView::SetShortcutText(const string16& text) {
-  shortcut_label_->SetText(text);
+  if (shortcut_label_->text() != text)
+    shortcut_label_->SetText(text);
 }
 
 void CandidateView::SetAnnotationText(const string16& text) {
-  annotation_label_->SetText(text);
+  if (annotation_label_->text() != text)
+    annotation_label_->SetText(text);
 }
 
 void CandidateView::SetInfolistIcon(bool enable) {
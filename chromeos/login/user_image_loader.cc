@@ -75,6 +75,9 @@ void UserImageLoader::LoadImage(
 
   scoped_refptr<ImageDecoder> image_decoder =
       new ImageDecoder(this, image_data, image_codec_);
+  // The images of all the users are loaded at once, from local files that
+  // Chrome wrote.
+  image_decoder->set_process_mode(BatchedUtilityProcessHost::SHARED_PROCESS);
   {
     base::AutoLock lock(lock_);
     image_info_map_.insert(std::make_pair(image_decoder.get(), image_info));
@@ -71,6 +71,10 @@ const int kProfileRefreshIntervalSec = 24 * 3600;
 
 const char kSafeImagePathExtension[] = ".jpg";
 
+// Number of users whose images are loaded before those of the other users.
+// Matches the number of user pods the login screen shows.
+const size_t kMaxVisibleUsers = 18;
+
 // Enum for reporting histograms about profile picture download.
 enum ProfileDownloadResult {
   kDownloadSuccessChanged,
@@ -184,7 +188,8 @@ UserImageManagerImpl::UserImageManagerImpl()
       last_image_set_async_(false),
       downloaded_profile_image_data_url_(content::kAboutBlankURL),
       downloading_profile_image_(false),
-      migrate_current_user_on_load_(false) {
+      migrate_current_user_on_load_(false),
+      pending_visible_image_loads_(0) {
 }
 
 UserImageManagerImpl::~UserImageManagerImpl() {
@@ -199,7 +204,14 @@ void UserImageManagerImpl::LoadUserImages(const UserList& users) {
   if (!prefs_images && !prefs_images_unsafe)
     return;
 
-  for (UserList::const_iterator it = users.begin(); it != users.end(); ++it) {
+  // The images of the first users, which the login screen shows, are loaded
+  // first. The other images are loaded once these are done, so that they don't
+  // compete for the blocking pool and the decoder while the login screen is
+  // being shown.
+  image_load_start_time_ = base::TimeTicks::Now();
+  size_t user_index = 0;
+  for (UserList::const_iterator it = users.begin(); it != users.end();
+       ++it, ++user_index) {
     User* user = *it;
     const base::DictionaryValue* image_properties = NULL;
     bool needs_migration = false;  // |true| if user has image in old format.
@@ -254,17 +266,26 @@ void UserImageManagerImpl::LoadUserImages(const UserList& users) {
           // Load user image asynchronously - at this point we are able to use
           // JPEG image loaded since image comes from safe pref source
           // i.e. converted to JPEG.
-          image_loader_->Start(
-              image_path, 0  /* no resize */,
-              base::Bind(&UserImageManagerImpl::SetUserImage,
-                         base::Unretained(this),
-                         user->email(), image_index, image_gurl));
+          if (user_index < kMaxVisibleUsers) {
+            ++pending_visible_image_loads_;
+            image_loader_->Start(
+                image_path, 0  /* no resize */,
+                base::Bind(&UserImageManagerImpl::OnVisibleUserImageLoaded,
+                           base::Unretained(this),
+                           user->email(), image_index, image_gurl));
+          } else {
+            deferred_image_loads_.push_back(
+                ImageLoad(user->email(), image_path, image_index, image_gurl));
+          }
         }
       } else {
         NOTREACHED();
       }
     }
   }
+
+  if (!pending_visible_image_loads_)
+    StartDeferredImageLoads();
 }
 
 void UserImageManagerImpl::UserLoggedIn(const std::string& email,
@@ -473,6 +494,47 @@ void UserImageManagerImpl::SetUserImage(const std::string& username,
   }
 }
 
+void UserImageManagerImpl::OnVisibleUserImageLoaded(
+    const std::string& username,
+    int image_index,
+    const GURL& image_url,
+    const UserImage& user_image) {
+  SetUserImage(username, image_index, image_url, user_image);
+
+  DCHECK(pending_visible_image_loads_);
+  if (--pending_visible_image_loads_)
+    return;
+  UMA_HISTOGRAM_TIMES("UserImage.LoginScreenImagesLoadTime",
+                      base::TimeTicks::Now() - image_load_start_time_);
+  StartDeferredImageLoads();
+}
+
+void UserImageManagerImpl::StartDeferredImageLoads() {
+  std::vector<ImageLoad> loads;
+  loads.swap(deferred_image_loads_);
+  for (std::vector<ImageLoad>::const_iterator it = loads.begin();
+       it != loads.end(); ++it) {
+    image_loader_->Start(
+        it->image_path, 0  /* no resize */,
+        base::Bind(&UserImageManagerImpl::SetUserImage,
+                   base::Unretained(this),
+                   it->username, it->image_index, it->image_url));
+  }
+}
+
+UserImageManagerImpl::ImageLoad::ImageLoad(const std::string& username,
+                                           const std::string& image_path,
+                                           int image_index,
+                                           const GURL& image_url)
+    : username(username),
+      image_path(image_path),
+      image_index(image_index),
+      image_url(image_url) {
+}
+
+UserImageManagerImpl::ImageLoad::~ImageLoad() {
+}
+
 void UserImageManagerImpl::SaveUserImageInternal(const std::string& username,
                                                  int image_index,
                                                  const GURL& image_url,
@@ -7,6 +7,7 @@
 
 #include <set>
 #include <string>
+#include <vector>
 
 #include "base/basictypes.h"
 #include "base/memory/scoped_ptr.h"
@@ -59,6 +60,20 @@ class UserImageManagerImpl : public UserImageManager,
  private:
   friend class UserImageManagerTest;
 
+  // A user image waiting to be loaded from disk.
+  struct ImageLoad {
+    ImageLoad(const std::string& username,
+              const std::string& image_path,
+              int image_index,
+              const GURL& image_url);
+    ~ImageLoad();
+
+    std::string username;
+    std::string image_path;
+    int image_index;
+    GURL image_url;
+  };
+
   // Non-const for testing purposes.
   static int user_image_migration_delay_sec;
 
@@ -88,6 +103,16 @@ class UserImageManagerImpl : public UserImageManager,
                     const GURL& image_url,
                     const UserImage& user_image);
 
+  // Sets the image of one of the users shown on the login screen, and starts
+  // loading the images of the other users once all of those have been loaded.
+  void OnVisibleUserImageLoaded(const std::string& username,
+                                int image_index,
+                                const GURL& image_url,
+                                const UserImage& user_image);
+
+  // Starts the loads in |deferred_image_loads_|.
+  void StartDeferredImageLoads();
+
   // Saves image to file, updates local state preferences to given image index
   // and sends LOGIN_USER_IMAGE_CHANGED notification.
   void SaveUserImageInternal(const std::string& username,
@@ -181,6 +206,14 @@ class UserImageManagerImpl : public UserImageManager,
   // If |true|, current user image should be migrated right after it is loaded.
   bool migrate_current_user_on_load_;
 
+  // Number of images of users shown on the login screen still being loaded,
+  // and the time LoadUserImages() started loading them.
+  size_t pending_visible_image_loads_;
+  base::TimeTicks image_load_start_time_;
+
+  // Images of the other users, loaded once the ones above are.
+  std::vector<ImageLoad> deferred_image_loads_;
+
   // Sync observer attached to current user.
   scoped_ptr<UserImageSyncObserver> user_image_sync_observer_;
 
@@ -358,6 +358,9 @@ class CrxUpdateService : public ComponentUpdateService {
 
   CrxUpdateItem* FindUpdateItemById(const std::string& id);
 
+  // Returns the delay to use before the next update, if there is one.
+  StepDelayInterval GetNextUpdateDelay() const;
+
   void NotifyComponentObservers(ComponentObserver::Events event,
                                 int extra) const;
 
@@ -489,6 +492,19 @@ CrxUpdateItem* CrxUpdateService::FindUpdateItemById(const std::string& id) {
   return (*it);
 }
 
+// Updates found by the same update check are applied one after the other
+// without sleeping in between, so that components updated after a long time
+// offline do not queue behind each other for the medium delay each.
+CrxUpdateService::StepDelayInterval
+CrxUpdateService::GetNextUpdateDelay() const {
+  for (UpdateItems::const_iterator it = work_items_.begin();
+       it != work_items_.end(); ++it) {
+    if ((*it)->status == CrxUpdateItem::kCanUpdate)
+      return kStepDelayShort;
+  }
+  return kStepDelayMedium;
+}
+
 // Changes all the components in |work_items_| that have |from| status to
 // |to| status and returns how many have been changed.
 size_t CrxUpdateService::ChangeItemStatus(CrxUpdateItem::Status from,
@@ -880,7 +896,7 @@ void CrxUpdateService::OnURLFetchComplete(const net::URLFetcher* source,
     ping_manager_->OnUpdateComplete(crx);
 
     // Move on to the next update, if there is one available.
-    ScheduleNextRun(kStepDelayMedium);
+    ScheduleNextRun(GetNextUpdateDelay());
   } else {
     base::FilePath temp_crx_path;
     CHECK(source->GetResponseAsFilePath(true, &temp_crx_path));
@@ -988,7 +1004,7 @@ void CrxUpdateService::DoneInstalling(const std::string& component_id,
   ping_manager_->OnUpdateComplete(item);
 
   // Move on to the next update, if there is one available.
-  ScheduleNextRun(kStepDelayMedium);
+  ScheduleNextRun(GetNextUpdateDelay());
 }
 
 void CrxUpdateService::NotifyComponentObservers(
@@ -5,6 +5,7 @@
 #include "chrome/browser/content_settings/content_settings_custom_extension_provider.h"
 
 #include "base/memory/scoped_ptr.h"
+#include "chrome/browser/content_settings/content_settings_rule_index.h"
 #include "chrome/browser/content_settings/content_settings_utils.h"
 #include "chrome/browser/extensions/api/content_settings/content_settings_store.h"
 #include "chrome/common/content_settings_pattern.h"
@@ -31,6 +32,13 @@ RuleIterator* CustomExtensionProvider::GetRuleIterator(
                                                incognito);
 }
 
+scoped_refptr<RuleIndex> CustomExtensionProvider::GetRuleIndex(
+    ContentSettingsType content_type,
+    const ResourceIdentifier& resource_identifier,
+    bool incognito) const {
+  return NULL;
+}
+
 bool CustomExtensionProvider::SetWebsiteSetting(
     const ContentSettingsPattern& primary_pattern,
     const ContentSettingsPattern& secondary_pattern,
@@ -14,6 +14,7 @@
 #include "base/prefs/pref_service.h"
 #include "chrome/browser/chrome_notification_types.h"
 #include "chrome/browser/content_settings/content_settings_rule.h"
+#include "chrome/browser/content_settings/content_settings_rule_index.h"
 #include "chrome/browser/content_settings/content_settings_utils.h"
 #include "chrome/browser/prefs/scoped_user_pref_update.h"
 #include "chrome/common/content_settings.h"
@@ -252,6 +253,15 @@ RuleIterator* DefaultProvider::GetRuleIterator(
   return new EmptyRuleIterator();
 }
 
+scoped_refptr<RuleIndex> DefaultProvider::GetRuleIndex(
+    ContentSettingsType content_type,
+    const ResourceIdentifier& resource_identifier,
+    bool incognito) const {
+  // There is a single rule per content type, which matches any URL, so there
+  // is nothing to index.
+  return NULL;
+}
+
 void DefaultProvider::ClearAllContentSettingsRules(
     ContentSettingsType content_type) {
   // TODO(markusheintz): This method is only called when the
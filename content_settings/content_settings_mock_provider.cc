@@ -4,6 +4,8 @@
 
 #include "chrome/browser/content_settings/content_settings_mock_provider.h"
 
+#include "chrome/browser/content_settings/content_settings_rule_index.h"
+
 namespace content_settings {
 
 MockProvider::MockProvider()
@@ -22,6 +24,13 @@ RuleIterator* MockProvider::GetRuleIterator(
   return value_map_.GetRuleIterator(content_type, resource_identifier, NULL);
 }
 
+scoped_refptr<RuleIndex> MockProvider::GetRuleIndex(
+    ContentSettingsType content_type,
+    const ResourceIdentifier& resource_identifier,
+    bool incognito) const {
+  return value_map_.GetRuleIndex(content_type, resource_identifier, NULL);
+}
+
 bool MockProvider::SetWebsiteSetting(
     const ContentSettingsPattern& requesting_url_pattern,
     const ContentSettingsPattern& embedding_url_pattern,
@@ -27,6 +27,11 @@ class MockProvider : public ObservableProvider {
       const ResourceIdentifier& resource_identifier,
       bool incognito) const OVERRIDE;
 
+  virtual scoped_refptr<RuleIndex> GetRuleIndex(
+      ContentSettingsType content_type,
+      const ResourceIdentifier& resource_identifier,
+      bool incognito) const OVERRIDE;
+
   // The MockProvider is only able to store one content setting. So every time
   // this method is called the previously set content settings is overwritten.
   virtual bool SetWebsiteSetting(
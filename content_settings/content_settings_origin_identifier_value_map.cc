@@ -10,6 +10,7 @@
 #include "base/synchronization/lock.h"
 #include "base/values.h"
 #include "chrome/browser/content_settings/content_settings_rule.h"
+#include "chrome/browser/content_settings/content_settings_rule_index.h"
 #include "chrome/browser/content_settings/content_settings_utils.h"
 #include "chrome/common/content_settings_types.h"
 #include "url/gurl.h"
@@ -108,6 +109,23 @@ RuleIterator* OriginIdentifierValueMap::GetRuleIterator(
                               auto_lock.release());
 }
 
+scoped_refptr<RuleIndex> OriginIdentifierValueMap::GetRuleIndex(
+    ContentSettingsType content_type,
+    const ResourceIdentifier& resource_identifier,
+    base::Lock* lock) const {
+  EntryMapKey key(content_type, resource_identifier);
+  scoped_ptr<base::AutoLock> auto_lock;
+  if (lock)
+    auto_lock.reset(new base::AutoLock(*lock));
+  scoped_refptr<RuleIndex>& index = indexes_[key];
+  if (!index.get()) {
+    scoped_ptr<RuleIterator> rules(
+        GetRuleIterator(content_type, resource_identifier, NULL));
+    index = new RuleIndex(rules.get());
+  }
+  return index;
+}
+
 size_t OriginIdentifierValueMap::size() const {
   size_t size = 0;
   EntryMap::const_iterator it;
@@ -156,6 +174,7 @@ void OriginIdentifierValueMap::SetValue(
   PatternPair patterns(primary_pattern, secondary_pattern);
   // This will create the entry and the linked_ptr if needed.
   entries_[key][patterns].reset(value);
+  indexes_.erase(key);
 }
 
 void OriginIdentifierValueMap::DeleteValue(
@@ -169,6 +188,7 @@ void OriginIdentifierValueMap::DeleteValue(
   if (entries_[key].empty()) {
     entries_.erase(key);
   }
+  indexes_.erase(key);
 }
 
 void OriginIdentifierValueMap::DeleteValues(
@@ -176,11 +196,13 @@ void OriginIdentifierValueMap::DeleteValues(
       const ResourceIdentifier& resource_identifier) {
   EntryMapKey key(content_type, resource_identifier);
   entries_.erase(key);
+  indexes_.erase(key);
 }
 
 void OriginIdentifierValueMap::clear() {
   // Delete all owned value objects.
   entries_.clear();
+  indexes_.clear();
 }
 
 }  // namespace content_settings
@@ -9,6 +9,7 @@
 #include <string>
 
 #include "base/memory/linked_ptr.h"
+#include "base/memory/ref_counted.h"
 #include "chrome/common/content_settings_pattern.h"
 #include "chrome/common/content_settings_types.h"
 
@@ -21,6 +22,7 @@ class Value;
 
 namespace content_settings {
 
+class RuleIndex;
 class RuleIterator;
 
 class OriginIdentifierValueMap {
@@ -77,6 +79,15 @@ class OriginIdentifierValueMap {
                                 const ResourceIdentifier& resource_identifier,
                                 base::Lock* lock) const;
 
+  // Returns the index of the rules for |content_type| and
+  // |resource_identifier|. The index is built on the first call after the
+  // rules change, and stays valid after that. If |lock| is non-NULL, it is
+  // held while the index is looked up or built.
+  scoped_refptr<RuleIndex> GetRuleIndex(
+      ContentSettingsType content_type,
+      const ResourceIdentifier& resource_identifier,
+      base::Lock* lock) const;
+
   OriginIdentifierValueMap();
   ~OriginIdentifierValueMap();
 
@@ -119,6 +130,9 @@ class OriginIdentifierValueMap {
  private:
   EntryMap entries_;
 
+  // The indexes built since the rules they are for last changed.
+  mutable std::map<EntryMapKey, scoped_refptr<RuleIndex> > indexes_;
+
   DISALLOW_COPY_AND_ASSIGN(OriginIdentifierValueMap);
 };
 
@@ -7,6 +7,7 @@
 #include "base/memory/scoped_ptr.h"
 #include "base/values.h"
 #include "chrome/browser/content_settings/content_settings_rule.h"
+#include "chrome/browser/content_settings/content_settings_rule_index.h"
 #include "chrome/browser/content_settings/content_settings_utils.h"
 #include "testing/gtest/include/gtest/gtest.h"
 #include "url/gurl.h"
@@ -209,3 +210,67 @@ TEST(OriginIdentifierValueMapTest, IterateNonempty) {
   EXPECT_EQ(pattern, rule.primary_pattern);
   EXPECT_EQ(1, content_settings::ValueToContentSetting(rule.value.get()));
 }
+
+TEST(OriginIdentifierValueMapTest, RuleIndex) {
+  content_settings::OriginIdentifierValueMap map;
+  const ContentSettingsPattern wildcard = ContentSettingsPattern::Wildcard();
+  map.SetValue(ContentSettingsPattern::FromString("[*.]google.com"),
+               wildcard, CONTENT_SETTINGS_TYPE_COOKIES, std::string(),
+               Value::CreateIntegerValue(1));
+  map.SetValue(ContentSettingsPattern::FromString("http://mail.google.com"),
+               wildcard, CONTENT_SETTINGS_TYPE_COOKIES, std::string(),
+               Value::CreateIntegerValue(2));
+  map.SetValue(ContentSettingsPattern::FromString("[*.]example.com"),
+               ContentSettingsPattern::FromString("[*.]google.com"),
+               CONTENT_SETTINGS_TYPE_COOKIES, std::string(),
+               Value::CreateIntegerValue(3));
+  map.SetValue(wildcard, wildcard, CONTENT_SETTINGS_TYPE_COOKIES,
+               std::string(), Value::CreateIntegerValue(4));
+
+  // The index matches the same rule as walking all of them does.
+  const char* const kUrls[] = {
+    "http://google.com",
+    "http://mail.google.com",
+    "https://mail.google.com",
+    "http://a.b.google.com",
+    "http://www.example.com",
+    "http://example.org",
+    "http://[::1]",
+    "file:///tmp/file.html",
+  };
+  const char* const kSecondaryUrls[] = {
+    "http://www.google.com",
+    "http://www.youtube.com",
+  };
+  scoped_refptr<content_settings::RuleIndex> index =
+      map.GetRuleIndex(CONTENT_SETTINGS_TYPE_COOKIES, std::string(), NULL);
+  for (size_t i = 0; i < arraysize(kUrls); ++i) {
+    for (size_t j = 0; j < arraysize(kSecondaryUrls); ++j) {
+      GURL primary_url(kUrls[i]);
+      GURL secondary_url(kSecondaryUrls[j]);
+      ContentSettingsPattern primary_pattern;
+      ContentSettingsPattern secondary_pattern;
+      const Value* value = index->GetValue(primary_url, secondary_url,
+                                           &primary_pattern,
+                                           &secondary_pattern);
+      ASSERT_TRUE(value) << primary_url;
+      EXPECT_TRUE(value->Equals(map.GetValue(primary_url, secondary_url,
+                                             CONTENT_SETTINGS_TYPE_COOKIES,
+                                             std::string())))
+          << primary_url << " " << secondary_url;
+      EXPECT_TRUE(primary_pattern.Matches(primary_url));
+      EXPECT_TRUE(secondary_pattern.Matches(secondary_url));
+    }
+  }
+
+  // The index is a snapshot; the map builds a new one once the rules change.
+  map.DeleteValue(wildcard, wildcard, CONTENT_SETTINGS_TYPE_COOKIES,
+                  std::string());
+  const GURL url("http://example.org");
+  EXPECT_TRUE(index->GetValue(url, url, NULL, NULL));
+  index = map.GetRuleIndex(CONTENT_SETTINGS_TYPE_COOKIES, std::string(), NULL);
+  EXPECT_FALSE(index->GetValue(url, url, NULL, NULL));
+
+  index = map.GetRuleIndex(CONTENT_SETTINGS_TYPE_POPUPS, std::string(), NULL);
+  EXPECT_TRUE(index->empty());
+}
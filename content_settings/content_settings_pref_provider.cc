@@ -15,6 +15,7 @@
 #include "base/prefs/pref_service.h"
 #include "chrome/browser/chrome_notification_types.h"
 #include "chrome/browser/content_settings/content_settings_rule.h"
+#include "chrome/browser/content_settings/content_settings_rule_index.h"
 #include "chrome/browser/content_settings/content_settings_utils.h"
 #include "chrome/browser/content_settings/host_content_settings_map.h"
 #include "chrome/browser/prefs/scoped_user_pref_update.h"
@@ -227,6 +228,17 @@ RuleIterator* PrefProvider::GetRuleIterator(
   return value_map_.GetRuleIterator(content_type, resource_identifier, &lock_);
 }
 
+scoped_refptr<RuleIndex> PrefProvider::GetRuleIndex(
+    ContentSettingsType content_type,
+    const ResourceIdentifier& resource_identifier,
+    bool incognito) const {
+  if (incognito)
+    return incognito_value_map_.GetRuleIndex(content_type,
+                                             resource_identifier,
+                                             &lock_);
+  return value_map_.GetRuleIndex(content_type, resource_identifier, &lock_);
+}
+
 // ////////////////////////////////////////////////////////////////////////////
 // Private
 
@@ -12,6 +12,7 @@
 #include <string>
 #include <vector>
 
+#include "base/memory/ref_counted.h"
 #include "base/values.h"
 #include "chrome/common/content_settings_types.h"
 
@@ -20,6 +21,7 @@ class ContentSettingsPattern;
 namespace content_settings {
 
 struct Rule;
+class RuleIndex;
 class RuleIterator;
 
 typedef std::string ResourceIdentifier;
@@ -41,6 +43,15 @@ class ProviderInterface {
       const ResourceIdentifier& resource_identifier,
       bool incognito) const = 0;
 
+  // Returns the rules |GetRuleIterator| would return, indexed for lookups by
+  // URL, or NULL if the provider doesn't index its rules. Unlike a
+  // |RuleIterator|, the index doesn't hold on to the provider; it is a
+  // snapshot which can be matched against while the rules change.
+  virtual scoped_refptr<RuleIndex> GetRuleIndex(
+      ContentSettingsType content_type,
+      const ResourceIdentifier& resource_identifier,
+      bool incognito) const = 0;
+
   // Asks the provider to set the website setting for a particular
   // |primary_pattern|, |secondary_pattern|, |content_type| tuple. If the
   // provider accepts the setting it returns true and takes the ownership of the
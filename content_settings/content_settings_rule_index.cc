@@ -0,0 +1,125 @@
+// Copyright 2013 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "chrome/browser/content_settings/content_settings_rule_index.h"
+
+#include "base/logging.h"
+#include "base/strings/string_util.h"
+#include "base/values.h"
+#include "chrome/common/content_settings_pattern.h"
+#include "url/gurl.h"
+
+namespace content_settings {
+
+namespace {
+
+const char kDomainWildcard[] = "[*.]";
+
+enum HostKind {
+  HOST_EXACT,
+  HOST_DOMAIN,
+  HOST_ANY,
+};
+
+// Returns which hosts |pattern| can match, and sets |host| to the host or
+// domain it is for. Anything which isn't recognized as a plain host, such as
+// an IPv6 literal or a file pattern, is treated as matching any host; the
+// index only narrows down the rules to match, and each of them is matched in
+// full.
+HostKind GetHostKind(const ContentSettingsPattern& pattern,
+                     std::string* host) {
+  const std::string spec = pattern.ToString();
+  size_t begin = spec.find("://");
+  begin = begin == std::string::npos ? 0 : begin + 3;
+  size_t end = spec.find_first_of(":/", begin);
+  if (end == std::string::npos)
+    end = spec.size();
+  *host = spec.substr(begin, end - begin);
+
+  HostKind kind = HOST_EXACT;
+  if (StartsWithASCII(*host, kDomainWildcard, true)) {
+    host->erase(0, arraysize(kDomainWildcard) - 1);
+    kind = HOST_DOMAIN;
+  }
+  if (host->empty() || *host == "*" || (*host)[0] == '[')
+    return HOST_ANY;
+  return kind;
+}
+
+}  // namespace
+
+RuleIndex::RuleIndex(RuleIterator* rules) {
+  while (rules->HasNext()) {
+    const size_t rank = rules_.size();
+    rules_.push_back(rules->Next());
+
+    std::string host;
+    switch (GetHostKind(rules_.back().primary_pattern, &host)) {
+      case HOST_EXACT:
+        hosts_[host].push_back(rank);
+        break;
+      case HOST_DOMAIN:
+        domains_[host].push_back(rank);
+        break;
+      case HOST_ANY:
+        any_host_.push_back(rank);
+        break;
+    }
+  }
+}
+
+const base::Value* RuleIndex::GetValue(
+    const GURL& primary_url,
+    const GURL& secondary_url,
+    ContentSettingsPattern* primary_pattern,
+    ContentSettingsPattern* secondary_pattern) const {
+  size_t best = rules_.size();
+  const std::string& host = primary_url.host();
+  HostBuckets::const_iterator it = hosts_.find(host);
+  if (it != hosts_.end())
+    MatchBucket(it->second, primary_url, secondary_url, &best);
+
+  // Walk up the domains the host is in, from the host itself to its TLD.
+  if (!domains_.empty()) {
+    for (size_t begin = 0; begin < host.size();) {
+      it = domains_.find(host.substr(begin));
+      if (it != domains_.end())
+        MatchBucket(it->second, primary_url, secondary_url, &best);
+      const size_t dot = host.find('.', begin);
+      if (dot == std::string::npos)
+        break;
+      begin = dot + 1;
+    }
+  }
+
+  MatchBucket(any_host_, primary_url, secondary_url, &best);
+
+  if (best == rules_.size())
+    return NULL;
+  const Rule& rule = rules_[best];
+  if (primary_pattern)
+    *primary_pattern = rule.primary_pattern;
+  if (secondary_pattern)
+    *secondary_pattern = rule.secondary_pattern;
+  return rule.value.get();
+}
+
+RuleIndex::~RuleIndex() {}
+
+void RuleIndex::MatchBucket(const Bucket& bucket,
+                            const GURL& primary_url,
+                            const GURL& secondary_url,
+                            size_t* best) const {
+  for (Bucket::const_iterator rank = bucket.begin();
+       rank != bucket.end() && *rank < *best; ++rank) {
+    const Rule& rule = rules_[*rank];
+    if (rule.primary_pattern.Matches(primary_url) &&
+        rule.secondary_pattern.Matches(secondary_url)) {
+      *best = *rank;
+      return;
+    }
+  }
+}
+
+}  // namespace content_settings
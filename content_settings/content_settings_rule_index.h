@@ -0,0 +1,80 @@
+// Copyright 2013 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CHROME_BROWSER_CONTENT_SETTINGS_CONTENT_SETTINGS_RULE_INDEX_H_
+#define CHROME_BROWSER_CONTENT_SETTINGS_CONTENT_SETTINGS_RULE_INDEX_H_
+
+#include <string>
+#include <vector>
+
+#include "base/basictypes.h"
+#include "base/containers/hash_tables.h"
+#include "base/memory/ref_counted.h"
+#include "chrome/browser/content_settings/content_settings_rule.h"
+
+class ContentSettingsPattern;
+class GURL;
+
+namespace base {
+class Value;
+}
+
+namespace content_settings {
+
+// An immutable snapshot of the rules for one content type and resource
+// identifier, indexed by the host of their primary pattern. A lookup only
+// matches the rules whose primary pattern is for the host of the URL, for
+// one of its parent domains or for any host, so it scales with the number of
+// labels in the host rather than with the number of rules.
+//
+// Since the snapshot doesn't change, it can be used on any thread without
+// holding on to the lock of the provider which built it.
+class RuleIndex : public base::RefCountedThreadSafe<RuleIndex> {
+ public:
+  // Builds the index of the rules returned by |rules|, which come in the
+  // order of decreasing precedence.
+  explicit RuleIndex(RuleIterator* rules);
+
+  // Returns the value of the rule with the highest precedence which matches
+  // |primary_url| and |secondary_url|, or NULL. The index keeps the ownership
+  // of the value. If |primary_pattern| and |secondary_pattern| are non-NULL,
+  // they are set to the patterns of the rule.
+  const base::Value* GetValue(const GURL& primary_url,
+                              const GURL& secondary_url,
+                              ContentSettingsPattern* primary_pattern,
+                              ContentSettingsPattern* secondary_pattern) const;
+
+  bool empty() const { return rules_.empty(); }
+
+ private:
+  friend class base::RefCountedThreadSafe<RuleIndex>;
+
+  // The precedence ranks of rules, in increasing order.
+  typedef std::vector<size_t> Bucket;
+  typedef base::hash_map<std::string, Bucket> HostBuckets;
+
+  ~RuleIndex();
+
+  // Lowers |best| to the rank of the first rule in |bucket| which outranks it
+  // and matches the URLs.
+  void MatchBucket(const Bucket& bucket,
+                   const GURL& primary_url,
+                   const GURL& secondary_url,
+                   size_t* best) const;
+
+  // The rules, in the order of decreasing precedence.
+  std::vector<Rule> rules_;
+
+  // The rules for exactly one host, for a domain and its subdomains, and for
+  // any host.
+  HostBuckets hosts_;
+  HostBuckets domains_;
+  Bucket any_host_;
+
+  DISALLOW_COPY_AND_ASSIGN(RuleIndex);
+};
+
+}  // namespace content_settings
+
+#endif  // CHROME_BROWSER_CONTENT_SETTINGS_CONTENT_SETTINGS_RULE_INDEX_H_
@@ -14,6 +14,7 @@
 #include "base/values.h"
 #include "chrome/browser/content_settings/content_settings_provider.h"
 #include "chrome/browser/content_settings/content_settings_rule.h"
+#include "chrome/browser/content_settings/content_settings_rule_index.h"
 #include "chrome/browser/content_settings/host_content_settings_map.h"
 #include "chrome/common/chrome_switches.h"
 #include "chrome/common/content_settings_pattern.h"
@@ -129,6 +130,25 @@ base::Value* GetContentSettingValueAndPatterns(
     bool include_incognito,
     ContentSettingsPattern* primary_pattern,
     ContentSettingsPattern* secondary_pattern) {
+  // Prefer the index of the rules, which is matched against without holding
+  // the provider's lock and without copying every rule.
+  scoped_refptr<RuleIndex> index;
+  if (include_incognito) {
+    index = provider->GetRuleIndex(content_type, resource_identifier, true);
+    if (index.get()) {
+      const base::Value* value = index->GetValue(
+          primary_url, secondary_url, primary_pattern, secondary_pattern);
+      if (value)
+        return value->DeepCopy();
+    }
+  }
+  index = provider->GetRuleIndex(content_type, resource_identifier, false);
+  if (index.get()) {
+    const base::Value* value = index->GetValue(
+        primary_url, secondary_url, primary_pattern, secondary_pattern);
+    return value ? value->DeepCopy() : NULL;
+  }
+
   if (include_incognito) {
     // Check incognito-only specific settings. It's essential that the
     // |RuleIterator| gets out of scope before we get a rule iterator for the
@@ -7,6 +7,9 @@
 #include "base/command_line.h"
 #include "base/prefs/pref_service.h"
 #include "chrome/browser/chrome_notification_types.h"
+#include "chrome/browser/content_settings/content_settings_details.h"
+#include "chrome/browser/content_settings/content_settings_rule.h"
+#include "chrome/browser/content_settings/content_settings_rule_index.h"
 #include "chrome/browser/content_settings/content_settings_utils.h"
 #include "chrome/browser/content_settings/host_content_settings_map.h"
 #include "chrome/browser/profiles/incognito_helpers.h"
@@ -18,6 +21,7 @@
 #include "components/browser_context_keyed_service/browser_context_keyed_service.h"
 #include "components/user_prefs/pref_registry_syncable.h"
 #include "content/public/browser/browser_thread.h"
+#include "content/public/browser/notification_details.h"
 #include "content/public/browser/notification_service.h"
 #include "content/public/browser/notification_source.h"
 #include "content/public/browser/user_metrics.h"
@@ -43,6 +47,36 @@ bool IsAllowed(ContentSetting setting) {
           setting == CONTENT_SETTING_SESSION_ONLY);
 }
 
+// Iterates over the rules of |settings|, which come in precedence order.
+class SettingsRuleIterator : public content_settings::RuleIterator {
+ public:
+  explicit SettingsRuleIterator(const ContentSettingsForOneType& settings)
+      : current_(settings.begin()),
+        end_(settings.end()) {
+  }
+  virtual ~SettingsRuleIterator() {}
+
+  virtual bool HasNext() const OVERRIDE {
+    return current_ != end_;
+  }
+
+  virtual content_settings::Rule Next() OVERRIDE {
+    DCHECK(current_ != end_);
+    content_settings::Rule rule(current_->primary_pattern,
+                                current_->secondary_pattern,
+                                base::Value::CreateIntegerValue(
+                                    current_->setting));
+    ++current_;
+    return rule;
+  }
+
+ private:
+  ContentSettingsForOneType::const_iterator current_;
+  ContentSettingsForOneType::const_iterator end_;
+
+  DISALLOW_COPY_AND_ASSIGN(SettingsRuleIterator);
+};
+
 }  // namespace
 
 // static
@@ -92,7 +126,8 @@ CookieSettings::CookieSettings(
     PrefService* prefs)
     : host_content_settings_map_(host_content_settings_map),
       block_third_party_cookies_(
-          prefs->GetBoolean(prefs::kBlockThirdPartyCookies)) {
+          prefs->GetBoolean(prefs::kBlockThirdPartyCookies)),
+      cookie_rules_version_(0) {
   if (block_third_party_cookies_) {
     content::RecordAction(
         UserMetricsAction("ThirdPartyCookieBlockingEnabled"));
@@ -106,6 +141,10 @@ CookieSettings::CookieSettings(
       prefs::kBlockThirdPartyCookies,
       base::Bind(&CookieSettings::OnBlockThirdPartyCookiesChanged,
                  base::Unretained(this)));
+  notification_registrar_.Add(
+      this, chrome::NOTIFICATION_CONTENT_SETTINGS_CHANGED,
+      content::Source<HostContentSettingsMap>(
+          host_content_settings_map_.get()));
 }
 
 ContentSetting
@@ -172,6 +211,23 @@ void CookieSettings::ResetCookieSetting(
 void CookieSettings::ShutdownOnUIThread() {
   DCHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
   pref_change_registrar_.RemoveAll();
+  notification_registrar_.RemoveAll();
+}
+
+void CookieSettings::Observe(int type,
+                             const content::NotificationSource& source,
+                             const content::NotificationDetails& details) {
+  DCHECK_EQ(chrome::NOTIFICATION_CONTENT_SETTINGS_CHANGED, type);
+  const ContentSettingsDetails* settings_details =
+      content::Details<const ContentSettingsDetails>(details).ptr();
+  if (!settings_details->update_all_types() &&
+      settings_details->type() != CONTENT_SETTINGS_TYPE_COOKIES) {
+    return;
+  }
+
+  base::AutoLock auto_lock(lock_);
+  cookie_rules_ = NULL;
+  ++cookie_rules_version_;
 }
 
 ContentSetting CookieSettings::GetCookieSetting(
@@ -185,14 +241,25 @@ ContentSetting CookieSettings::GetCookieSetting(
 
   // First get any host-specific settings.
   content_settings::SettingInfo info;
-  scoped_ptr<base::Value> value(host_content_settings_map_->GetWebsiteSetting(
-      url,
-      first_party_url,
-      CONTENT_SETTINGS_TYPE_COOKIES,
-      std::string(),
-      &info));
-  if (source)
+  scoped_ptr<base::Value> website_setting;
+  scoped_refptr<content_settings::RuleIndex> cookie_rules;
+  const base::Value* value = NULL;
+  if (source) {
+    // Only the providers know where a setting comes from.
+    website_setting.reset(host_content_settings_map_->GetWebsiteSetting(
+        url,
+        first_party_url,
+        CONTENT_SETTINGS_TYPE_COOKIES,
+        std::string(),
+        &info));
+    value = website_setting.get();
     *source = info.source;
+  } else {
+    cookie_rules = GetCookieRules();
+    value = cookie_rules->GetValue(url, first_party_url,
+                                   &info.primary_pattern,
+                                   &info.secondary_pattern);
+  }
 
   // If no explicit exception has been made and third-party cookies are blocked
   // by default, apply that rule.
@@ -216,8 +283,8 @@ ContentSetting CookieSettings::GetCookieSetting(
   }
 
   // We should always have a value, at least from the default provider.
-  DCHECK(value.get());
-  return content_settings::ValueToContentSetting(value.get());
+  DCHECK(value);
+  return content_settings::ValueToContentSetting(value);
 }
 
 CookieSettings::~CookieSettings() {}
@@ -234,3 +301,27 @@ bool CookieSettings::ShouldBlockThirdPartyCookies() const {
   base::AutoLock auto_lock(lock_);
   return block_third_party_cookies_;
 }
+
+scoped_refptr<content_settings::RuleIndex>
+CookieSettings::GetCookieRules() const {
+  int version = 0;
+  {
+    base::AutoLock auto_lock(lock_);
+    if (cookie_rules_.get())
+      return cookie_rules_;
+    version = cookie_rules_version_;
+  }
+
+  // The rules are read without holding |lock_|, since reading them takes the
+  // locks of the providers.
+  ContentSettingsForOneType settings;
+  GetCookieSettings(&settings);
+  SettingsRuleIterator rule_iterator(settings);
+  scoped_refptr<content_settings::RuleIndex> cookie_rules(
+      new content_settings::RuleIndex(&rule_iterator));
+
+  base::AutoLock auto_lock(lock_);
+  if (version == cookie_rules_version_)
+    cookie_rules_ = cookie_rules;
+  return cookie_rules;
+}
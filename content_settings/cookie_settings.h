@@ -16,6 +16,8 @@
 #include "chrome/common/content_settings.h"
 #include "components/browser_context_keyed_service/refcounted_browser_context_keyed_service.h"
 #include "components/browser_context_keyed_service/refcounted_browser_context_keyed_service_factory.h"
+#include "content/public/browser/notification_observer.h"
+#include "content/public/browser/notification_registrar.h"
 
 class ContentSettingsPattern;
 class CookieSettingsWrapper;
@@ -23,10 +25,20 @@ class GURL;
 class PrefService;
 class Profile;
 
+namespace content_settings {
+class RuleIndex;
+}
+
 // A frontend to the cookie settings of |HostContentSettingsMap|. Handles
 // cookie-specific logic such as blocking third-party cookies. Written on the UI
 // thread and read on any thread. One instance per profile.
-class CookieSettings : public RefcountedBrowserContextKeyedService {
+//
+// The cookie checks match a snapshot of the cookie rules of all providers,
+// which is built on the first check after the content settings change. This
+// keeps the checks made for every request on the IO thread from taking the
+// locks of the providers.
+class CookieSettings : public RefcountedBrowserContextKeyedService,
+                       public content::NotificationObserver {
  public:
   CookieSettings(
       HostContentSettingsMap* host_content_settings_map,
@@ -92,7 +104,13 @@ class CookieSettings : public RefcountedBrowserContextKeyedService {
   // |Profile|. Afterwards, only const methods can be called.
   virtual void ShutdownOnUIThread() OVERRIDE;
 
-  // A helper for applying third party cookie blocking rules.
+  // content::NotificationObserver implementation.
+  virtual void Observe(int type,
+                       const content::NotificationSource& source,
+                       const content::NotificationDetails& details) OVERRIDE;
+
+  // A helper for applying third party cookie blocking rules. Unless |source|
+  // is requested, the snapshot of the cookie rules is matched.
   ContentSetting GetCookieSetting(
       const GURL& url,
       const GURL& first_party_url,
@@ -136,14 +154,28 @@ class CookieSettings : public RefcountedBrowserContextKeyedService {
   // This method may be called on any thread.
   bool ShouldBlockThirdPartyCookies() const;
 
+  // Returns the snapshot of the cookie rules, building it if the content
+  // settings changed since the last one.
+  //
+  // This method may be called on any thread.
+  scoped_refptr<content_settings::RuleIndex> GetCookieRules() const;
+
   scoped_refptr<HostContentSettingsMap> host_content_settings_map_;
   PrefChangeRegistrar pref_change_registrar_;
+  content::NotificationRegistrar notification_registrar_;
 
-  // Used around accesses to |block_third_party_cookies_| to guarantee thread
-  // safety.
+  // Used around accesses to |block_third_party_cookies_|, |cookie_rules_| and
+  // |cookie_rules_version_| to guarantee thread safety.
   mutable base::Lock lock_;
 
   bool block_third_party_cookies_;
+
+  // The snapshot of the cookie rules, NULL until the next check builds it.
+  mutable scoped_refptr<content_settings::RuleIndex> cookie_rules_;
+
+  // Incremented each time the content settings change, so that a snapshot
+  // which was being built meanwhile isn't kept.
+  int cookie_rules_version_;
 };
 
 #endif  // CHROME_BROWSER_CONTENT_SETTINGS_COOKIE_SETTINGS_H_
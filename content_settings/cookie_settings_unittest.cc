@@ -2,10 +2,14 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#include <vector>
+
 #include "base/auto_reset.h"
 #include "base/command_line.h"
 #include "base/message_loop/message_loop.h"
 #include "base/prefs/pref_service.h"
+#include "base/strings/stringprintf.h"
+#include "base/time/time.h"
 #include "chrome/browser/content_settings/cookie_settings.h"
 #include "chrome/common/chrome_switches.h"
 #include "chrome/common/content_settings_pattern.h"
@@ -14,6 +18,7 @@
 #include "content/public/test/test_browser_thread.h"
 #include "net/base/static_cookie_policy.h"
 #include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_test.h"
 #include "url/gurl.h"
 
 using content::BrowserThread;
@@ -291,4 +296,49 @@ TEST_F(CookieSettingsTest, ExtensionsThirdParty) {
       kBlockedSite, kExtensionURL));
 }
 
+// Prints the cost of a cookie check against the snapshot of the rules, and
+// of the same check through the providers, with thousands of exceptions.
+TEST_F(CookieSettingsTest, CheckCostWithManyRules) {
+  const int kNumRules = 10000;
+  const int kNumChecks = 10000;
+  // Each check through the providers walks all of the rules.
+  const int kNumProviderChecks = 100;
+  const int kNumSites = 100;
+  for (int i = 0; i < kNumRules; ++i) {
+    cookie_settings_->SetCookieSetting(
+        ContentSettingsPattern::FromString(
+            base::StringPrintf("[*.]site%d.com", i)),
+        ContentSettingsPattern::Wildcard(),
+        i % 2 ? CONTENT_SETTING_BLOCK : CONTENT_SETTING_ALLOW);
+  }
+
+  std::vector<GURL> sites;
+  for (int i = 0; i < kNumSites; ++i) {
+    sites.push_back(GURL(base::StringPrintf(
+        "http://www.site%d.com", i * (kNumRules / kNumSites) + i % 2)));
+    EXPECT_EQ(i % 2 == 0, cookie_settings_->IsReadingCookieAllowed(
+        sites.back(), kFirstPartySite));
+  }
+
+  base::TimeTicks start = base::TimeTicks::Now();
+  for (int i = 0; i < kNumChecks; ++i)
+    cookie_settings_->IsReadingCookieAllowed(sites[i % kNumSites],
+                                             kFirstPartySite);
+  perf_test::PrintResult(
+      "cookie_check", "", "snapshot",
+      (base::TimeTicks::Now() - start).InMicrosecondsF() / kNumChecks,
+      "us", true);
+
+  start = base::TimeTicks::Now();
+  for (int i = 0; i < kNumProviderChecks; ++i) {
+    content_settings::SettingSource source;
+    cookie_settings_->GetCookieSetting(sites[i % kNumSites], kFirstPartySite,
+                                       false, &source);
+  }
+  perf_test::PrintResult(
+      "cookie_check", "", "providers",
+      (base::TimeTicks::Now() - start).InMicrosecondsF() / kNumProviderChecks,
+      "us", true);
+}
+
 }  // namespace
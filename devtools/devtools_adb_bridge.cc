@@ -1125,13 +1125,16 @@ DevToolsAdbBridge::RefCountedAdbThread::~RefCountedAdbThread() {
 DevToolsAdbBridge::DevToolsAdbBridge(Profile* profile)
     : adb_thread_(RefCountedAdbThread::GetInstance()),
       has_message_loop_(adb_thread_->message_loop() != NULL),
-      discover_usb_devices_(false) {
+      discover_usb_devices_(false),
+      polling_(false) {
   rsa_key_.reset(AndroidRSAPrivateKey(profile));
 }
 
 void DevToolsAdbBridge::AddListener(Listener* listener) {
   DCHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
-  if (listeners_.empty())
+  // A listener may be added again before the polling loop noticed that there
+  // were no more listeners, in which case the loop simply goes on.
+  if (listeners_.empty() && !polling_)
     RequestRemoteDevices();
   listeners_.push_back(listener);
 }
@@ -1163,6 +1166,7 @@ void DevToolsAdbBridge::RequestRemoteDevices() {
   DCHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
   if (!has_message_loop_)
     return;
+  polling_ = true;
   new AdbPagesCommand(
       adb_thread_, rsa_key_.get(), discover_usb_devices_,
       base::Bind(&DevToolsAdbBridge::ReceivedRemoteDevices, this));
@@ -1177,8 +1181,10 @@ void DevToolsAdbBridge::ReceivedRemoteDevices(RemoteDevices* devices_ptr) {
   for (Listeners::iterator it = copy.begin(); it != copy.end(); ++it)
     (*it)->RemoteDevicesChanged(devices.get());
 
-  if (listeners_.empty())
+  if (listeners_.empty()) {
+    polling_ = false;
     return;
+  }
 
   BrowserThread::PostDelayedTask(
       BrowserThread::UI,
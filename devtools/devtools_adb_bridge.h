@@ -300,6 +300,9 @@ class DevToolsAdbBridge
   typedef std::vector<Listener*> Listeners;
   Listeners listeners_;
   bool discover_usb_devices_;
+  // True from the time devices are requested until the bridge stops polling
+  // for lack of listeners, so that only one polling loop runs at a time.
+  bool polling_;
   DISALLOW_COPY_AND_ASSIGN(DevToolsAdbBridge);
 };
 
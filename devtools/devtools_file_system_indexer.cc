@@ -4,6 +4,7 @@
 
 #include "chrome/browser/devtools/devtools_file_system_indexer.h"
 
+#include <algorithm>
 #include <iterator>
 
 #include "base/bind.h"
@@ -31,7 +32,6 @@ using base::PlatformFileError;
 using base::PlatformFileInfo;
 using content::BrowserThread;
 using std::map;
-using std::set;
 using std::string;
 using std::vector;
 
@@ -73,9 +73,15 @@ class Index {
 
   FileId GetFileId(const FilePath& file_path);
 
+  // Sorts the file ids of |trigram| and removes the duplicates left by files
+  // indexed again.
+  void NormalizeVector(Trigram trigram);
+
   typedef map<FilePath, FileId> FileIdsMap;
   FileIdsMap file_ids_;
   FileId last_file_id_;
+  // The index in this vector is the file id.
+  vector<FilePath> file_paths_;
   // The index in this vector is the trigram id.
   vector<vector<FileId> > index_;
   typedef map<FilePath, Time> IndexedFilesMap;
@@ -144,6 +150,8 @@ Trigram TrigramAtIndex(const vector<TrigramChar>& trigram_chars, size_t index) {
 }
 
 Index::Index() : last_file_id_(0) {
+  // File ids start at 1.
+  file_paths_.resize(1);
   index_.resize(kTrigramCount);
   is_normalized_.resize(kTrigramCount);
   std::fill(is_normalized_.begin(), is_normalized_.end(), true);
@@ -186,56 +194,66 @@ vector<FilePath> Index::Search(string query) {
     if (trigram != kUndefinedTrigram)
       trigrams.push_back(trigram);
   }
-  set<FileId> file_ids;
-  bool first = true;
-  vector<Trigram>::const_iterator it = trigrams.begin();
-  for (; it != trigrams.end(); ++it) {
-    Trigram trigram = *it;
-    if (first) {
-      std::copy(index_[trigram].begin(),
-                index_[trigram].end(),
-                std::inserter(file_ids, file_ids.begin()));
-      first = false;
+  vector<FilePath> result;
+  if (trigrams.empty()) {
+    FileIdsMap::const_iterator ids_it = file_ids_.begin();
+    for (; ids_it != file_ids_.end(); ++ids_it)
+      result.push_back(ids_it->first);
+    return result;
+  }
+
+  // The vectors of the query trigrams are normalized here, as files may still
+  // be being indexed.
+  vector<FileId> file_ids;
+  for (size_t i = 0; i < trigrams.size(); ++i) {
+    Trigram trigram = trigrams[i];
+    NormalizeVector(trigram);
+    if (i == 0) {
+      file_ids = index_[trigram];
       continue;
     }
-    set<FileId> intersection;
+    vector<FileId> intersection;
     std::set_intersection(file_ids.begin(),
                           file_ids.end(),
                           index_[trigram].begin(),
                           index_[trigram].end(),
-                          std::inserter(intersection, intersection.begin()));
+                          std::back_inserter(intersection));
     file_ids.swap(intersection);
   }
-  vector<FilePath> result;
-  FileIdsMap::const_iterator ids_it = file_ids_.begin();
-  for (; ids_it != file_ids_.end(); ++ids_it) {
-    if (trigrams.size() == 0 ||
-        file_ids.find(ids_it->second) != file_ids.end()) {
-      result.push_back(ids_it->first);
-    }
-  }
+  result.reserve(file_ids.size());
+  vector<FileId>::const_iterator ids_it = file_ids.begin();
+  for (; ids_it != file_ids.end(); ++ids_it)
+    result.push_back(file_paths_[*ids_it]);
+  std::sort(result.begin(), result.end());
   return result;
 }
 
 FileId Index::GetFileId(const FilePath& file_path) {
   DCHECK(BrowserThread::CurrentlyOn(BrowserThread::FILE));
-  string file_path_str = file_path.AsUTF8Unsafe();
-  if (file_ids_.find(file_path) != file_ids_.end())
-    return file_ids_[file_path];
+  FileIdsMap::const_iterator it = file_ids_.find(file_path);
+  if (it != file_ids_.end())
+    return it->second;
   file_ids_[file_path] = ++last_file_id_;
+  file_paths_.push_back(file_path);
   return last_file_id_;
 }
 
 void Index::NormalizeVectors() {
   DCHECK(BrowserThread::CurrentlyOn(BrowserThread::FILE));
-  for (size_t i = 0; i < kTrigramCount; ++i) {
-    if (!is_normalized_[i]) {
-      std::sort(index_[i].begin(), index_[i].end());
-      if (index_[i].capacity() > index_[i].size())
-        vector<FileId>(index_[i]).swap(index_[i]);
-      is_normalized_[i] = true;
-    }
-  }
+  for (size_t i = 0; i < kTrigramCount; ++i)
+    NormalizeVector(static_cast<Trigram>(i));
+}
+
+void Index::NormalizeVector(Trigram trigram) {
+  if (is_normalized_[trigram])
+    return;
+  vector<FileId>& file_ids = index_[trigram];
+  std::sort(file_ids.begin(), file_ids.end());
+  file_ids.erase(std::unique(file_ids.begin(), file_ids.end()),
+                 file_ids.end());
+  if (file_ids.capacity() > file_ids.size())
+    vector<FileId>(file_ids).swap(file_ids);
+  is_normalized_[trigram] = true;
 }
 
 void Index::PrintStats() {
@@ -148,6 +148,18 @@ bool ShouldUpdateHistory(const history::DownloadRow* previous,
           (previous->by_ext_name != current.by_ext_name));
 }
 
+// Returns true if |current| only differs from |previous| by its number of
+// received bytes.
+bool IsProgressUpdate(const history::DownloadRow& previous,
+                      const history::DownloadRow& current) {
+  history::DownloadRow progressed(previous);
+  progressed.received_bytes = current.received_bytes;
+  return !ShouldUpdateHistory(&progressed, current);
+}
+
+// How long progress updates are held back so they can be merged.
+const int kProgressUpdateDelaySeconds = 5;
+
 typedef std::vector<history::DownloadRow> InfoVector;
 
 }  // anonymous namespace
@@ -207,6 +219,10 @@ DownloadHistory::DownloadHistory(content::DownloadManager* manager,
 
 DownloadHistory::~DownloadHistory() {
   DCHECK(content::BrowserThread::CurrentlyOn(content::BrowserThread::UI));
+  for (std::map<uint32, history::DownloadRow>::const_iterator it =
+           updating_rows_.begin(); it != updating_rows_.end(); ++it) {
+    history_->UpdateDownload(it->second);
+  }
   FOR_EACH_OBSERVER(Observer, observers_, OnDownloadHistoryDestroyed());
   observers_.Clear();
 }
@@ -370,7 +386,13 @@ void DownloadHistory::OnDownloadUpdated(
   bool should_update = ShouldUpdateHistory(data->info(), current_info);
   UMA_HISTOGRAM_ENUMERATION("Download.HistoryPropagatedUpdate",
                             should_update, 2);
-  if (should_update) {
+  if (should_update && data->info() &&
+      item->GetState() == content::DownloadItem::IN_PROGRESS &&
+      IsProgressUpdate(*data->info(), current_info)) {
+    ScheduleUpdateDownload(current_info);
+  } else if (should_update) {
+    // |current_info| supersedes any scheduled progress update.
+    updating_rows_.erase(item->GetId());
     history_->UpdateDownload(current_info);
     FOR_EACH_OBSERVER(Observer, observers_, OnDownloadStored(
         item, current_info));
@@ -399,6 +421,7 @@ void DownloadHistory::OnDownloadRemoved(
     }
     return;
   }
+  updating_rows_.erase(item->GetId());
   ScheduleRemoveDownload(item->GetId());
   // This is important: another OnDownloadRemoved() handler could do something
   // that synchronously fires an OnDownloadUpdated().
@@ -429,3 +452,32 @@ void DownloadHistory::RemoveDownloadsBatch() {
   history_->RemoveDownloads(remove_ids);
   FOR_EACH_OBSERVER(Observer, observers_, OnDownloadsRemoved(remove_ids));
 }
+
+void DownloadHistory::ScheduleUpdateDownload(
+    const history::DownloadRow& info) {
+  DCHECK(content::BrowserThread::CurrentlyOn(content::BrowserThread::UI));
+  if (updating_rows_.empty()) {
+    content::BrowserThread::PostDelayedTask(
+        content::BrowserThread::UI, FROM_HERE,
+        base::Bind(&DownloadHistory::UpdateDownloadsBatch,
+                   weak_ptr_factory_.GetWeakPtr()),
+        base::TimeDelta::FromSeconds(kProgressUpdateDelaySeconds));
+  }
+  updating_rows_[info.id] = info;
+}
+
+void DownloadHistory::UpdateDownloadsBatch() {
+  DCHECK(content::BrowserThread::CurrentlyOn(content::BrowserThread::UI));
+  std::map<uint32, history::DownloadRow> update_rows;
+  updating_rows_.swap(update_rows);
+  for (std::map<uint32, history::DownloadRow>::const_iterator it =
+           update_rows.begin(); it != update_rows.end(); ++it) {
+    history_->UpdateDownload(it->second);
+    content::DownloadItem* item = notifier_.GetManager() ?
+        notifier_.GetManager()->GetDownload(it->first) : NULL;
+    if (item) {
+      FOR_EACH_OBSERVER(Observer, observers_, OnDownloadStored(
+          item, it->second));
+    }
+  }
+}
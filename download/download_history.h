@@ -5,6 +5,7 @@
 #ifndef CHROME_BROWSER_DOWNLOAD_DOWNLOAD_HISTORY_H_
 #define CHROME_BROWSER_DOWNLOAD_DOWNLOAD_HISTORY_H_
 
+#include <map>
 #include <set>
 #include <vector>
 
@@ -13,14 +14,11 @@
 #include "base/memory/weak_ptr.h"
 #include "base/observer_list.h"
 #include "chrome/browser/download/all_download_item_notifier.h"
+#include "chrome/browser/history/download_row.h"
 #include "chrome/browser/history/history_service.h"
 #include "content/public/browser/download_item.h"
 #include "content/public/browser/download_manager.h"
 
-namespace history {
-struct DownloadRow;
-}  // namespace history
-
 // Observes a single DownloadManager and all its DownloadItems, keeping the
 // DownloadDatabase up to date.
 class DownloadHistory : public AllDownloadItemNotifier::Observer {
@@ -115,6 +113,15 @@ class DownloadHistory : public AllDownloadItemNotifier::Observer {
   // Removes all |removing_ids_| from |history_|.
   void RemoveDownloadsBatch();
 
+  // Schedule |info| to be written to |history_| the next time
+  // UpdateDownloadsBatch() runs, replacing any update already scheduled for
+  // the same download. Schedule UpdateDownloadsBatch() to be run after a delay
+  // if it isn't already scheduled.
+  void ScheduleUpdateDownload(const history::DownloadRow& info);
+
+  // Writes all |updating_rows_| to |history_|.
+  void UpdateDownloadsBatch();
+
   AllDownloadItemNotifier notifier_;
 
   scoped_ptr<HistoryAdapter> history_;
@@ -128,6 +135,12 @@ class DownloadHistory : public AllDownloadItemNotifier::Observer {
   // facilitate batching removals together for database efficiency.
   IdSet removing_ids_;
 
+  // The latest progress updates of in-progress items, by |GetId()|, which
+  // haven't been written to history yet. Only the received bytes of a download
+  // change often, so those updates are delayed and merged, while any other
+  // change is written immediately.
+  std::map<uint32, history::DownloadRow> updating_rows_;
+
   // |GetId()|s of items that were removed while they were being added, so that
   // they can be removed when the database finishes adding them.
   // TODO(benjhayden) Can this be removed now that it doesn't need to wait for
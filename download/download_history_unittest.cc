@@ -618,6 +618,38 @@ TEST_F(DownloadHistoryTest, DownloadHistoryTest_Update) {
   ExpectDownloadUpdated(info);
 }
 
+// Test that progress updates of in-progress items are merged, and that other
+// changes are written immediately.
+TEST_F(DownloadHistoryTest, DownloadHistoryTest_MergeProgressUpdates) {
+  ExpectWillQueryDownloads(scoped_ptr<InfoVector>(new InfoVector()));
+
+  history::DownloadRow info;
+  InitBasicItem(FILE_PATH_LITERAL("/foo/bar.pdf"),
+                "http://example.com/bar.pdf",
+                "http://example.com/referrer.html",
+                &info);
+  EXPECT_CALL(item(0), GetState())
+      .WillRepeatedly(Return(content::DownloadItem::IN_PROGRESS));
+  info.state = content::DownloadItem::IN_PROGRESS;
+  CallOnDownloadCreated(0);
+  ExpectDownloadCreated(info);
+
+  EXPECT_CALL(item(0), GetReceivedBytes()).WillRepeatedly(Return(150));
+  item_observer()->OnDownloadUpdated(&item(0));
+  ExpectNoDownloadUpdated();
+  EXPECT_CALL(item(0), GetReceivedBytes()).WillRepeatedly(Return(160));
+  item_observer()->OnDownloadUpdated(&item(0));
+  ExpectNoDownloadUpdated();
+
+  EXPECT_CALL(item(0), GetState())
+      .WillRepeatedly(Return(content::DownloadItem::COMPLETE));
+  EXPECT_CALL(item(0), GetReceivedBytes()).WillRepeatedly(Return(200));
+  info.state = content::DownloadItem::COMPLETE;
+  info.received_bytes = 200;
+  item_observer()->OnDownloadUpdated(&item(0));
+  ExpectDownloadUpdated(info);
+}
+
 // Test creating a new item, saving it, removing it by setting it Temporary,
 // changing it without saving it back because it's Temporary, clearing
 // IsTemporary, saving it back, changing it, saving it back because it isn't
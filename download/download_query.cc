@@ -74,24 +74,31 @@ static bool MatchesQuery(
     const DownloadItem& item) {
   DCHECK(!query_terms.empty());
   string16 url_raw(UTF8ToUTF16(item.GetOriginalUrl().spec()));
-  string16 url_formatted = url_raw;
-  if (item.GetBrowserContext()) {
-    Profile* profile = Profile::FromBrowserContext(item.GetBrowserContext());
-    url_formatted = net::FormatUrl(
-        item.GetOriginalUrl(),
-        profile->GetPrefs()->GetString(prefs::kAcceptLanguages));
-  }
   string16 path(item.GetTargetFilePath().LossyDisplayName());
 
+  // Formatting the URL is the most expensive part, so only do it for the
+  // terms which are in neither the raw URL nor the path.
+  string16 url_formatted;
+  bool formatted_url = false;
   for (std::vector<string16>::const_iterator it = query_terms.begin();
        it != query_terms.end(); ++it) {
-    string16 term = base::i18n::ToLower(*it);
+    if (base::i18n::StringSearchIgnoringCaseAndAccents(
+            *it, url_raw, NULL, NULL) ||
+        base::i18n::StringSearchIgnoringCaseAndAccents(
+            *it, path, NULL, NULL)) {
+      continue;
+    }
+    if (!item.GetBrowserContext())
+      return false;
+    if (!formatted_url) {
+      Profile* profile = Profile::FromBrowserContext(item.GetBrowserContext());
+      url_formatted = net::FormatUrl(
+          item.GetOriginalUrl(),
+          profile->GetPrefs()->GetString(prefs::kAcceptLanguages));
+      formatted_url = true;
+    }
     if (!base::i18n::StringSearchIgnoringCaseAndAccents(
-            term, url_raw, NULL, NULL) &&
-        !base::i18n::StringSearchIgnoringCaseAndAccents(
-            term, url_formatted, NULL, NULL) &&
-        !base::i18n::StringSearchIgnoringCaseAndAccents(
-            term, path, NULL, NULL)) {
+            *it, url_formatted, NULL, NULL)) {
       return false;
     }
   }
@@ -284,9 +291,15 @@ bool DownloadQuery::AddFilter(DownloadQuery::FilterType type,
       return AddFilter(BuildFilter<bool>(value, EQ, &IsPaused));
     case FILTER_QUERY: {
       std::vector<string16> query_terms;
-      return GetAs(value, &query_terms) &&
-             (query_terms.empty() ||
-              AddFilter(base::Bind(&MatchesQuery, query_terms)));
+      if (!GetAs(value, &query_terms))
+        return false;
+      // Lower-case the terms once here rather than for every item.
+      for (std::vector<string16>::iterator it = query_terms.begin();
+           it != query_terms.end(); ++it) {
+        *it = base::i18n::ToLower(*it);
+      }
+      return query_terms.empty() ||
+             AddFilter(base::Bind(&MatchesQuery, query_terms));
     }
     case FILTER_ENDED_AFTER:
       return AddFilter(BuildFilter<std::string>(value, GT, &GetEndTime));
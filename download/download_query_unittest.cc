@@ -10,6 +10,7 @@
 #include "base/memory/scoped_ptr.h"
 #include "base/stl_util.h"
 #include "base/strings/string16.h"
+#include "base/strings/stringprintf.h"
 #include "base/time/time.h"
 #include "base/values.h"
 #include "chrome/browser/download/download_query.h"
@@ -616,3 +617,34 @@ TEST_F(DownloadQueryTest, DownloadQueryFilterPerformance) {
   std::cout << "Search took " << nanos_per_item_per_filter
             << " nanoseconds per item per filter.\n";
 }
+
+TEST_F(DownloadQueryTest, DownloadQueryQueryPerformance) {
+  static const int kNumItems = 1000;
+  CreateMocks(kNumItems);
+  std::vector<GURL> urls;
+  std::vector<base::FilePath> paths;
+  urls.reserve(kNumItems);
+  paths.reserve(kNumItems);
+  for (int i = 0; i < kNumItems; ++i) {
+    urls.push_back(GURL(base::StringPrintf("http://example.com/%d", i)));
+    paths.push_back(base::FilePath(FILE_PATH_LITERAL("file")));
+    EXPECT_CALL(mock(i), GetOriginalUrl()).WillRepeatedly(ReturnRef(urls[i]));
+    EXPECT_CALL(mock(i), GetTargetFilePath()).WillRepeatedly(ReturnRef(
+        paths[i]));
+    EXPECT_CALL(mock(i), GetBrowserContext()).WillRepeatedly(Return(
+        static_cast<content::BrowserContext*>(NULL)));
+  }
+  std::vector<std::string> query_terms;
+  query_terms.push_back("EXAMPLE");
+  query_terms.push_back("999");
+  AddFilter(DownloadQuery::FILTER_QUERY, query_terms);
+  base::Time start = base::Time::Now();
+  Search();
+  base::Time end = base::Time::Now();
+  ASSERT_EQ(1U, results()->size());
+  EXPECT_EQ(999U, results()->at(0)->GetId());
+  double micros_per_item = (end - start).InMillisecondsF() * 1000.0 /
+                           static_cast<double>(kNumItems);
+  std::cout << "Query search took " << micros_per_item
+            << " microseconds per item.\n";
+}
@@ -100,9 +100,11 @@ static const char kPolicyMiscSetup[] =
     "DROP VIEW IF EXISTS activitylog_uncompressed;\n"
     "CREATE VIEW activitylog_uncompressed AS\n"
     "SELECT count,\n"
+    "    extension_id_x,\n"
     "    x1.value AS extension_id,\n"
     "    time,\n"
     "    action_type,\n"
+    "    api_name_x,\n"
     "    x2.value AS api_name,\n"
     "    x3.value AS args,\n"
     "    x4.value AS page_url,\n"
@@ -123,7 +125,11 @@ static const char kPolicyMiscSetup[] =
     // the one in the right time range).
     "CREATE INDEX IF NOT EXISTS activitylog_compressed_index\n"
     "ON activitylog_compressed(extension_id_x, action_type, api_name_x,\n"
-    "    args_x, page_url_x, page_title_x, arg_url_x, other_x)";
+    "    args_x, page_url_x, page_title_x, arg_url_x, other_x);\n"
+    // Reads are limited to a range of days, and cleaning deletes the rows
+    // older than the retention time, so both are range scans on the time.
+    "CREATE INDEX IF NOT EXISTS activitylog_compressed_time_index\n"
+    "ON activitylog_compressed(time)";
 
 // SQL statements to clean old, unused entries out of the string and URL id
 // tables.
@@ -428,15 +434,29 @@ scoped_ptr<Action::ActionVector> CountingPolicy::DoReadFilteredData(
   if (!db)
     return actions.Pass();
 
+  // The extension ID and API name are compared by their identifiers, so that
+  // the indexes on the compressed table can be used. A string which isn't in
+  // the string table matches no row.
+  int64 extension_id_x = -1;
+  if (!extension_id.empty() &&
+      !string_table_.FindString(db, extension_id, &extension_id_x)) {
+    return actions.Pass();
+  }
+  int64 api_name_x = -1;
+  if (!api_name.empty() &&
+      !string_table_.FindString(db, api_name, &api_name_x)) {
+    return actions.Pass();
+  }
+
   // Build up the query based on which parameters were specified.
   std::string where_str = "";
   std::string where_next = "";
   if (!extension_id.empty()) {
-    where_str += "extension_id=?";
+    where_str += "extension_id_x=?";
     where_next = " AND ";
   }
   if (!api_name.empty()) {
-    where_str += where_next + "api_name=?";
+    where_str += where_next + "api_name_x=?";
     where_next = " AND ";
   }
   if (type != Action::ACTION_ANY) {
@@ -464,9 +484,9 @@ scoped_ptr<Action::ActionVector> CountingPolicy::DoReadFilteredData(
   sql::Statement query(db->GetUniqueStatement(query_str.c_str()));
   int i = -1;
   if (!extension_id.empty())
-    query.BindString(++i, extension_id);
+    query.BindInt64(++i, extension_id_x);
   if (!api_name.empty())
-    query.BindString(++i, api_name);
+    query.BindInt64(++i, api_name_x);
   if (type != Action::ACTION_ANY)
     query.BindInt(++i, static_cast<int>(type));
   if (!page_url.empty())
@@ -659,6 +679,9 @@ void CountingPolicy::DoDeleteDatabase() {
                << statement.GetSQLStatement();
     return;
   }
+  // The identifiers cached for the deleted strings may be reused.
+  string_table_.ClearCache();
+  url_table_.ClearCache();
   statement.Clear();
   statement.Assign(db->GetCachedStatement(sql::StatementID(SQL_FROM_HERE),
                                           "VACUUM"));
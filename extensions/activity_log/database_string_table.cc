@@ -80,6 +80,30 @@ bool DatabaseStringTable::StringToInt(sql::Connection* connection,
   return true;
 }
 
+bool DatabaseStringTable::FindString(sql::Connection* connection,
+                                     const std::string& value,
+                                     int64* id) {
+  std::map<std::string, int64>::const_iterator lookup =
+      value_to_id_.find(value);
+  if (lookup != value_to_id_.end()) {
+    *id = lookup->second;
+    return true;
+  }
+
+  sql::Statement query(connection->GetUniqueStatement(
+      StringPrintf("SELECT id FROM %s WHERE value = ?", table_.c_str())
+          .c_str()));
+  query.BindString(0, value);
+  if (!query.Step())
+    return false;
+
+  PruneCache();
+  *id = query.ColumnInt64(0);
+  id_to_value_[*id] = value;
+  value_to_id_[value] = *id;
+  return true;
+}
+
 bool DatabaseStringTable::IntToString(sql::Connection* connection,
                                       int64 id,
                                       std::string* value) {
@@ -46,6 +46,14 @@ class DatabaseStringTable {
                    const std::string& value,
                    int64* id);
 
+  // Like StringToInt, but doesn't insert the string if it isn't in the table
+  // yet.  Returns false if the string isn't found or on database error.  Used
+  // to translate query filters, since a string which was never interned
+  // can't match any row.
+  bool FindString(sql::Connection* connection,
+                  const std::string& value,
+                  int64* id);
+
   // Looks up an integer value and converts it to a string (which is stored in
   // *value).  Returns true on success.  A false return does not necessarily
   // indicate a database error; it might simply be that the value cannot be
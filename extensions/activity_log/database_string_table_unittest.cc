@@ -68,6 +68,22 @@ TEST_F(DatabaseStringTableTest, InsertMultiple) {
   ASSERT_EQ(id1, id1a);
 }
 
+// Check that looking up a string doesn't insert it.
+TEST_F(DatabaseStringTableTest, Find) {
+  DatabaseStringTable table("test");
+  table.Initialize(&db_);
+
+  int64 id;
+  ASSERT_FALSE(table.FindString(&db_, "string1", &id));
+  ASSERT_FALSE(db_.GetUniqueStatement("SELECT id FROM test").Step());
+
+  int64 inserted_id;
+  ASSERT_TRUE(table.StringToInt(&db_, "string1", &inserted_id));
+  table.ClearCache();
+  ASSERT_TRUE(table.FindString(&db_, "string1", &id));
+  ASSERT_EQ(inserted_id, id);
+}
+
 // Check that values can be read back from the database even after the
 // in-memory cache is cleared.
 TEST_F(DatabaseStringTableTest, CacheCleared) {
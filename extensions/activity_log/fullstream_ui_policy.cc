@@ -45,6 +45,15 @@ const char* FullStreamUIPolicy::kTableFieldTypes[] = {
 const int FullStreamUIPolicy::kTableFieldCount =
     arraysize(FullStreamUIPolicy::kTableContentFields);
 
+// Reads return the most recent actions, usually for one extension and a range
+// of days, so they are range scans on these indexes rather than full scans of
+// the table.
+static const char kPolicyIndexSetup[] =
+    "CREATE INDEX IF NOT EXISTS activitylog_full_time_index\n"
+    "ON activitylog_full(time);\n"
+    "CREATE INDEX IF NOT EXISTS activitylog_full_extension_index\n"
+    "ON activitylog_full(extension_id, time)";
+
 FullStreamUIPolicy::FullStreamUIPolicy(Profile* profile)
     : ActivityLogDatabasePolicy(
           profile,
@@ -57,11 +66,14 @@ bool FullStreamUIPolicy::InitDatabase(sql::Connection* db) {
     return false;
 
   // Create the unified activity log entry table.
-  return ActivityDatabase::InitializeTable(db,
-                                           kTableName,
-                                           kTableContentFields,
-                                           kTableFieldTypes,
-                                           arraysize(kTableContentFields));
+  if (!ActivityDatabase::InitializeTable(db,
+                                         kTableName,
+                                         kTableContentFields,
+                                         kTableFieldTypes,
+                                         arraysize(kTableContentFields)))
+    return false;
+
+  return db->Execute(kPolicyIndexSetup);
 }
 
 bool FullStreamUIPolicy::FlushDatabase(sql::Connection* db) {
@@ -13,6 +13,7 @@
 #include "base/lazy_instance.h"
 #include "base/memory/linked_ptr.h"
 #include "base/memory/scoped_ptr.h"
+#include "base/metrics/histogram.h"
 #include "base/time/time.h"
 #include "base/values.h"
 #include "chrome/browser/chrome_notification_types.h"
@@ -294,6 +295,7 @@ bool CookiesGetAllFunction::RunImpl() {
   if (!parsed_args_->details.store_id.get())
     parsed_args_->details.store_id.reset(new std::string(store_id));
 
+  start_time_ = base::TimeTicks::Now();
   bool rv = BrowserThread::PostTask(
       BrowserThread::IO, FROM_HERE,
       base::Bind(&CookiesGetAllFunction::GetAllCookiesOnIOThread, this));
@@ -322,7 +324,11 @@ void CookiesGetAllFunction::GetAllCookiesCallback(
         GetExtension(), &match_vector);
 
     results_ = GetAll::Results::Create(match_vector);
+    UMA_HISTOGRAM_CUSTOM_COUNTS("Extensions.CookiesGetAllCount",
+                                cookie_list.size(), 1, 100000, 50);
   }
+  UMA_HISTOGRAM_TIMES("Extensions.CookiesGetAllTime",
+                      base::TimeTicks::Now() - start_time_);
   bool rv = BrowserThread::PostTask(
       BrowserThread::UI, FROM_HERE,
       base::Bind(&CookiesGetAllFunction::RespondOnUIThread, this));
@@ -13,6 +13,7 @@
 #include "base/compiler_specific.h"
 #include "base/memory/ref_counted.h"
 #include "base/memory/scoped_ptr.h"
+#include "base/time/time.h"
 #include "chrome/browser/extensions/api/profile_keyed_api_factory.h"
 #include "chrome/browser/extensions/event_router.h"
 #include "chrome/browser/extensions/extension_function.h"
@@ -130,6 +131,9 @@ class CookiesGetAllFunction : public CookiesFunction {
   GURL url_;
   scoped_refptr<net::URLRequestContextGetter> store_context_;
   scoped_ptr<extensions::api::cookies::GetAll::Params> parsed_args_;
+
+  // When the call started, to record how long it took to get the cookies.
+  base::TimeTicks start_time_;
 };
 
 // Implements the cookies.set() extension function.
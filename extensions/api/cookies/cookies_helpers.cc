@@ -6,6 +6,8 @@
 
 #include "chrome/browser/extensions/api/cookies/cookies_helpers.h"
 
+#include <map>
+#include <utility>
 #include <vector>
 
 #include "base/logging.h"
@@ -130,19 +132,29 @@ void AppendMatchingCookiesToVector(const net::CookieList& all_cookies,
                                    const GetAll::Params::Details* details,
                                    const Extension* extension,
                                    LinkedCookieVec* match_vector) {
+  cookies_helpers::MatchFilter filter(details);
+  // Cookies of the same domain share the same host permission check, so the
+  // result is only computed once per domain.
+  typedef std::map<std::pair<std::string, bool>, bool> PermissionMap;
+  PermissionMap domain_permissions;
   net::CookieList::const_iterator it;
   for (it = all_cookies.begin(); it != all_cookies.end(); ++it) {
+    // Filter the cookie using the match filter.
+    if (!filter.MatchesCookie(*it))
+      continue;
     // Ignore any cookie whose domain doesn't match the extension's
     // host permissions.
-    GURL cookie_domain_url = GetURLFromCanonicalCookie(*it);
-    if (!PermissionsData::HasHostPermission(extension, cookie_domain_url))
-      continue;
-    // Filter the cookie using the match filter.
-    cookies_helpers::MatchFilter filter(details);
-    if (filter.MatchesCookie(*it)) {
-      match_vector->push_back(make_linked_ptr(
-          CreateCookie(*it, *details->store_id).release()));
+    std::pair<PermissionMap::iterator, bool> permission =
+        domain_permissions.insert(std::make_pair(
+            std::make_pair(it->Domain(), it->IsSecure()), false));
+    if (permission.second) {
+      permission.first->second = PermissionsData::HasHostPermission(
+          extension, GetURLFromCanonicalCookie(*it));
     }
+    if (!permission.first->second)
+      continue;
+    match_vector->push_back(make_linked_ptr(
+        CreateCookie(*it, *details->store_id).release()));
   }
 }
 
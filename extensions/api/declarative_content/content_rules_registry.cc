@@ -56,6 +56,7 @@ void ContentRulesRegistry::Observe(
       // in the map.  Similarly, tabs from other profiles won't be in
       // the map.
       active_rules_.erase(ExtensionTabUtil::GetTabId(tab));
+      last_match_data_.erase(ExtensionTabUtil::GetTabId(tab));
       break;
     }
   }
@@ -69,6 +70,17 @@ void ContentRulesRegistry::Apply(
   renderer_data.page_url_matches = url_matcher_.MatchURL(contents->GetURL());
   renderer_data.css_selectors.insert(matching_css_selectors.begin(),
                                      matching_css_selectors.end());
+
+  std::map<int, RendererContentMatchData>::iterator last_match_data =
+      last_match_data_.find(tab_id);
+  if (last_match_data != last_match_data_.end() &&
+      last_match_data->second.page_url_matches ==
+          renderer_data.page_url_matches &&
+      last_match_data->second.css_selectors == renderer_data.css_selectors) {
+    return;
+  }
+  last_match_data_[tab_id] = renderer_data;
+
   std::set<ContentRule*> matching_rules = GetMatches(renderer_data);
   if (matching_rules.empty() && !ContainsKey(active_rules_, tab_id))
     return;
@@ -188,6 +200,7 @@ std::string ContentRulesRegistry::AddRulesImpl(
   }
   url_matcher_.AddConditionSets(all_new_condition_sets);
 
+  last_match_data_.clear();
   UpdateConditionCache();
 
   return std::string();
@@ -243,6 +256,7 @@ std::string ContentRulesRegistry::RemoveRulesImpl(
   // Clear URLMatcher based on condition_set_ids that are not needed any more.
   url_matcher_.RemoveConditionSets(remove_from_url_matcher);
 
+  last_match_data_.clear();
   UpdateConditionCache();
 
   return std::string();
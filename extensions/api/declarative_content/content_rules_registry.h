@@ -134,6 +134,11 @@ class ContentRulesRegistry : public RulesRegistryWithCache,
   // lets us call Revert as appropriate.
   std::map<int, std::set<ContentRule*> > active_rules_;
 
+  // Maps tab_id to the data its rules were last evaluated against, so that
+  // updates which change neither the URL matches nor the matching CSS
+  // selectors don't evaluate the rules again.  Cleared when the rules change.
+  std::map<int, RendererContentMatchData> last_match_data_;
+
   // Matches URLs for the page_url condition.
   URLMatcher url_matcher_;
 
@@ -5,6 +5,7 @@
 #include "chrome/browser/extensions/api/declarative_webrequest/request_stage.h"
 
 #include "base/basictypes.h"
+#include "base/logging.h"
 
 namespace extensions {
 
@@ -27,4 +28,29 @@ struct HighestBit<1> {
 
 const unsigned int kLastActiveStage = HighestBit<kActiveStages>::VALUE;
 
+const char* GetRequestStageName(RequestStage stage) {
+  switch (stage) {
+    case ON_BEFORE_REQUEST:
+      return "OnBeforeRequest";
+    case ON_BEFORE_SEND_HEADERS:
+      return "OnBeforeSendHeaders";
+    case ON_SEND_HEADERS:
+      return "OnSendHeaders";
+    case ON_HEADERS_RECEIVED:
+      return "OnHeadersReceived";
+    case ON_AUTH_REQUIRED:
+      return "OnAuthRequired";
+    case ON_BEFORE_REDIRECT:
+      return "OnBeforeRedirect";
+    case ON_RESPONSE_STARTED:
+      return "OnResponseStarted";
+    case ON_COMPLETED:
+      return "OnCompleted";
+    case ON_ERROR:
+      return "OnError";
+  }
+  NOTREACHED();
+  return "Unknown";
+}
+
 }  // namespace extensions
@@ -31,6 +31,10 @@ extern const unsigned int kActiveStages;
 // stages in a "for" loop.
 extern const unsigned int kLastActiveStage;
 
+// Returns the name of |stage|, e.g. "OnBeforeRequest", for use in histogram
+// names.
+const char* GetRequestStageName(RequestStage stage);
+
 }  // namespace extensions
 
 #endif  // CHROME_BROWSER_EXTENSIONS_API_DECLARATIVE_WEBREQUEST_REQUEST_STAGE_H_
@@ -306,6 +306,9 @@ class HeaderMatcher {
   // Does |this| match the header "|name|: |value|"?
   bool TestNameValue(const std::string& name, const std::string& value) const;
 
+  // Does |this| consist of the same test groups as |other|, in the same order?
+  bool Equals(const HeaderMatcher& other) const;
+
  private:
   // Represents a single string-matching test.
   class StringMatchTest {
@@ -322,6 +325,8 @@ class HeaderMatcher {
     // Does |str| pass |this| StringMatchTest?
     bool Matches(const std::string& str) const;
 
+    bool Equals(const StringMatchTest& other) const;
+
    private:
     StringMatchTest(const std::string& data,
                     MatchType type,
@@ -347,6 +352,8 @@ class HeaderMatcher {
     // Does the header "|name|: |value|" match all tests in |this|?
     bool Matches(const std::string& name, const std::string& value) const;
 
+    bool Equals(const HeaderMatchTest& other) const;
+
    private:
     // Takes ownership of the content of both |name_match| and |value_match|.
     HeaderMatchTest(ScopedVector<const StringMatchTest>* name_match,
@@ -399,6 +406,16 @@ bool HeaderMatcher::TestNameValue(const std::string& name,
   return false;
 }
 
+bool HeaderMatcher::Equals(const HeaderMatcher& other) const {
+  if (tests_.size() != other.tests_.size())
+    return false;
+  for (size_t i = 0; i < tests_.size(); ++i) {
+    if (!tests_[i]->Equals(*other.tests_[i]))
+      return false;
+  }
+  return true;
+}
+
 HeaderMatcher::HeaderMatcher(ScopedVector<const HeaderMatchTest>* tests)
   : tests_(tests->Pass()) {}
 
@@ -440,6 +457,13 @@ bool HeaderMatcher::StringMatchTest::Matches(
   return false;
 }
 
+bool HeaderMatcher::StringMatchTest::Equals(
+    const StringMatchTest& other) const {
+  return data_ == other.data_ &&
+         type_ == other.type_ &&
+         case_sensitive_ == other.case_sensitive_;
+}
+
 HeaderMatcher::StringMatchTest::StringMatchTest(const std::string& data,
                                                 MatchType type,
                                                 bool case_sensitive)
@@ -536,6 +560,23 @@ bool HeaderMatcher::HeaderMatchTest::Matches(const std::string& name,
   return true;
 }
 
+bool HeaderMatcher::HeaderMatchTest::Equals(
+    const HeaderMatchTest& other) const {
+  if (name_match_.size() != other.name_match_.size() ||
+      value_match_.size() != other.value_match_.size()) {
+    return false;
+  }
+  for (size_t i = 0; i < name_match_.size(); ++i) {
+    if (!name_match_[i]->Equals(*other.name_match_[i]))
+      return false;
+  }
+  for (size_t i = 0; i < value_match_.size(); ++i) {
+    if (!value_match_[i]->Equals(*other.value_match_[i]))
+      return false;
+  }
+  return true;
+}
+
 //
 // WebRequestConditionAttributeRequestHeaders
 //
@@ -627,8 +668,12 @@ std::string WebRequestConditionAttributeRequestHeaders::GetName() const {
 
 bool WebRequestConditionAttributeRequestHeaders::Equals(
     const WebRequestConditionAttribute* other) const {
-  // Comparing headers is too heavy, so we skip it entirely.
-  return false;
+  if (!WebRequestConditionAttribute::Equals(other))
+    return false;
+  const WebRequestConditionAttributeRequestHeaders* casted_other =
+      static_cast<const WebRequestConditionAttributeRequestHeaders*>(other);
+  return positive_ == casted_other->positive_ &&
+         header_matcher_->Equals(*casted_other->header_matcher_);
 }
 
 //
@@ -705,7 +750,12 @@ std::string WebRequestConditionAttributeResponseHeaders::GetName() const {
 
 bool WebRequestConditionAttributeResponseHeaders::Equals(
     const WebRequestConditionAttribute* other) const {
-  return false;
+  if (!WebRequestConditionAttribute::Equals(other))
+    return false;
+  const WebRequestConditionAttributeResponseHeaders* casted_other =
+      static_cast<const WebRequestConditionAttributeResponseHeaders*>(other);
+  return positive_ == casted_other->positive_ &&
+         header_matcher_->Equals(*casted_other->header_matcher_);
 }
 
 //
@@ -670,4 +670,48 @@ TEST(WebRequestConditionAttributeTest, ResponseHeaders) {
   EXPECT_FALSE(result);
 }
 
+
+// Identical header conditions should share a single attribute instance.
+TEST(WebRequestConditionAttributeTest, HeadersAreDeduplicated) {
+  const std::string kCondition[] = {
+    keys::kNameEqualsKey, "custom-header",
+    keys::kValuePrefixKey, "custom"
+  };
+  std::vector<std::vector<const std::string*> > tests;
+  const size_t kConditionSizes[] = { arraysize(kCondition) };
+  GetArrayAsVector(kCondition, kConditionSizes, 1u, &tests);
+  ListValue headers;
+  headers.Append(GetDictionaryFromArray(tests[0]).release());
+
+  const std::string kOtherCondition[] = {
+    keys::kNameEqualsKey, "custom-header",
+    keys::kValuePrefixKey, "other"
+  };
+  const size_t kOtherConditionSizes[] = { arraysize(kOtherCondition) };
+  GetArrayAsVector(kOtherCondition, kOtherConditionSizes, 1u, &tests);
+  ListValue other_headers;
+  other_headers.Append(GetDictionaryFromArray(tests[0]).release());
+
+  std::string error;
+  scoped_refptr<const WebRequestConditionAttribute> attribute =
+      WebRequestConditionAttribute::Create(
+          keys::kResponseHeadersKey, &headers, &error);
+  ASSERT_EQ("", error);
+  ASSERT_TRUE(attribute.get());
+
+  scoped_refptr<const WebRequestConditionAttribute> same_attribute =
+      WebRequestConditionAttribute::Create(
+          keys::kResponseHeadersKey, &headers, &error);
+  ASSERT_EQ("", error);
+  EXPECT_EQ(attribute.get(), same_attribute.get());
+
+  scoped_refptr<const WebRequestConditionAttribute> other_attribute =
+      WebRequestConditionAttribute::Create(
+          keys::kResponseHeadersKey, &other_headers, &error);
+  ASSERT_EQ("", error);
+  ASSERT_TRUE(other_attribute.get());
+  EXPECT_NE(attribute.get(), other_attribute.get());
+  EXPECT_FALSE(attribute->Equals(other_attribute.get()));
+}
+
 }  // namespace extensions
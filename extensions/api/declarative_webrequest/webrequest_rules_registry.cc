@@ -9,7 +9,9 @@
 #include <utility>
 
 #include "base/bind.h"
+#include "base/metrics/histogram.h"
 #include "base/stl_util.h"
+#include "base/time/time.h"
 #include "chrome/browser/extensions/api/declarative_webrequest/webrequest_condition.h"
 #include "chrome/browser/extensions/api/declarative_webrequest/webrequest_constants.h"
 #include "chrome/browser/extensions/api/web_request/web_request_api_helpers.h"
@@ -30,6 +32,9 @@ const char kAllURLsPermissionNeeded[] =
     "To execute the action '*', you need to request host permission for all "
     "hosts.";
 
+const char kMatchTimeHistogramPrefix[] =
+    "Extensions.DeclarativeWebRequestMatchTime.";
+
 }  // namespace
 
 namespace extensions {
@@ -51,6 +56,8 @@ std::set<const WebRequestRule*> WebRequestRulesRegistry::GetMatches(
     const WebRequestData& request_data_without_ids) const {
   RuleSet result;
 
+  FlushURLMatcherChanges();
+
   WebRequestDataWithMatchIds request_data(&request_data_without_ids);
   request_data.url_match_ids = url_matcher_.MatchURL(
       request_data.data->request->url());
@@ -80,7 +87,17 @@ std::list<LinkedPtrEventResponseDelta> WebRequestRulesRegistry::CreateDeltas(
   if (webrequest_rules_.empty())
     return std::list<LinkedPtrEventResponseDelta>();
 
+  const base::TimeTicks match_start = base::TimeTicks::Now();
   std::set<const WebRequestRule*> matches = GetMatches(request_data);
+  // The stage is part of the name, so the histogram can't be cached by the
+  // UMA macros. Matching usually takes less than a millisecond, hence the
+  // microseconds.
+  base::HistogramBase* match_time = base::Histogram::FactoryGet(
+      std::string(kMatchTimeHistogramPrefix) +
+          GetRequestStageName(request_data.stage),
+      1, 100000, 50, base::HistogramBase::kUmaTargetedHistogramFlag);
+  match_time->Add(static_cast<int>(
+      (base::TimeTicks::Now() - match_start).InMicroseconds()));
 
   // Sort all matching rules by their priority so that they can be processed
   // in decreasing order.
@@ -192,7 +209,10 @@ std::string WebRequestRulesRegistry::AddRulesImpl(
   }
 
   if (!error.empty()) {
-    // Clean up temporary condition sets created during rule creation.
+    // Clean up temporary condition sets created during rule creation. The
+    // pending condition sets go to the matcher first, or their patterns would
+    // be forgotten along with the temporary ones.
+    FlushURLMatcherChanges();
     url_matcher_.ClearUnusedConditionSets();
     return error;
   }
@@ -222,7 +242,7 @@ std::string WebRequestRulesRegistry::AddRulesImpl(
     if (i->second->conditions().HasConditionsWithoutUrls())
       rules_with_untriggered_conditions_.insert(i->second.get());
   }
-  url_matcher_.AddConditionSets(all_new_condition_sets);
+  AddToURLMatcher(all_new_condition_sets);
 
   ClearCacheOnNavigation();
 
@@ -261,7 +281,7 @@ std::string WebRequestRulesRegistry::RemoveRulesImpl(
     webrequest_rules_.erase(extension_id);
 
   // Clear URLMatcher based on condition_set_ids that are not needed any more.
-  url_matcher_.RemoveConditionSets(remove_from_url_matcher);
+  RemoveFromURLMatcher(remove_from_url_matcher);
 
   ClearCacheOnNavigation();
 
@@ -278,7 +298,7 @@ std::string WebRequestRulesRegistry::RemoveAllRulesImpl(
        ++it) {
     CleanUpAfterRule(it->second.get(), &remove_from_url_matcher);
   }
-  url_matcher_.RemoveConditionSets(remove_from_url_matcher);
+  RemoveFromURLMatcher(remove_from_url_matcher);
 
   webrequest_rules_.erase(extension_id);
   ClearCacheOnNavigation();
@@ -299,6 +319,43 @@ void WebRequestRulesRegistry::CleanUpAfterRule(
   rules_with_untriggered_conditions_.erase(rule);
 }
 
+void WebRequestRulesRegistry::AddToURLMatcher(
+    const URLMatcherConditionSet::Vector& condition_sets) {
+  pending_condition_sets_.insert(pending_condition_sets_.end(),
+                                 condition_sets.begin(), condition_sets.end());
+}
+
+void WebRequestRulesRegistry::RemoveFromURLMatcher(
+    const std::vector<URLMatcherConditionSet::ID>& condition_set_ids) {
+  pending_removals_.insert(pending_removals_.end(),
+                           condition_set_ids.begin(), condition_set_ids.end());
+}
+
+void WebRequestRulesRegistry::FlushURLMatcherChanges() const {
+  if (pending_condition_sets_.empty() && pending_removals_.empty())
+    return;
+
+  std::set<URLMatcherConditionSet::ID> removals(pending_removals_.begin(),
+                                                pending_removals_.end());
+  URLMatcherConditionSet::Vector additions;
+  for (URLMatcherConditionSet::Vector::const_iterator i =
+           pending_condition_sets_.begin();
+       i != pending_condition_sets_.end(); ++i) {
+    if (removals.erase((*i)->id()) == 0)
+      additions.push_back(*i);
+  }
+  pending_condition_sets_.clear();
+  pending_removals_.clear();
+
+  if (!additions.empty())
+    url_matcher_.AddConditionSets(additions);
+  if (!removals.empty()) {
+    url_matcher_.RemoveConditionSets(
+        std::vector<URLMatcherConditionSet::ID>(removals.begin(),
+                                                removals.end()));
+  }
+}
+
 bool WebRequestRulesRegistry::IsEmpty() const {
   // Easy first.
   if (!rule_triggers_.empty() && url_matcher_.IsEmpty())
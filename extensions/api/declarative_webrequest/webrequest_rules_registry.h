@@ -162,6 +162,18 @@ class WebRequestRulesRegistry : public RulesRegistryWithCache {
       const WebRequestRule* rule,
       std::vector<URLMatcherConditionSet::ID>* remove_from_url_matcher);
 
+  // Adds |condition_sets| to the URL matcher, or removes the condition sets
+  // with the given ids, once it is needed. This keeps a change to the rules
+  // from rebuilding the matcher: the changes since the last match are applied
+  // all at once by FlushURLMatcherChanges().
+  void AddToURLMatcher(const URLMatcherConditionSet::Vector& condition_sets);
+  void RemoveFromURLMatcher(
+      const std::vector<URLMatcherConditionSet::ID>& condition_set_ids);
+
+  // Applies the pending changes to |url_matcher_|. Const because the changes
+  // are applied lazily on the first match after them.
+  void FlushURLMatcherChanges() const;
+
   // This is a helper function to GetMatches. Rules triggered by |url_matches|
   // get added to |result| if one of their conditions is fulfilled.
   // |request_data| gets passed to IsFulfilled of the rules' condition sets.
@@ -180,7 +192,13 @@ class WebRequestRulesRegistry : public RulesRegistryWithCache {
 
   std::map<WebRequestRule::ExtensionId, RulesMap> webrequest_rules_;
 
-  URLMatcher url_matcher_;
+  // Mutable so that FlushURLMatcherChanges() can be called on a match.
+  mutable URLMatcher url_matcher_;
+
+  // The changes to |url_matcher_| which are yet to be applied. A condition set
+  // which is removed before the next match never reaches the matcher.
+  mutable URLMatcherConditionSet::Vector pending_condition_sets_;
+  mutable std::vector<URLMatcherConditionSet::ID> pending_removals_;
 
   void* profile_id_;
   scoped_refptr<ExtensionInfoMap> extension_info_map_;
@@ -398,6 +398,44 @@ TEST_F(WebRequestRulesRegistryTest, RemoveAllRulesImpl) {
   EXPECT_TRUE(registry->IsEmpty());
 }
 
+// Test that the changes to the rules which are made between two matches are
+// all taken into account by the second one.
+TEST_F(WebRequestRulesRegistryTest, ChangesBetweenMatches) {
+  scoped_refptr<TestWebRequestRulesRegistry> registry(
+      new TestWebRequestRulesRegistry(extension_info_map_));
+  std::string error;
+
+  std::vector<linked_ptr<RulesRegistry::Rule> > rules_to_add(1);
+  rules_to_add[0] = CreateRule1();
+  error = registry->AddRules(kExtensionId, rules_to_add);
+  EXPECT_EQ("", error);
+  rules_to_add[0] = CreateRule1();
+  error = registry->AddRules(kExtensionId2, rules_to_add);
+  EXPECT_EQ("", error);
+
+  // The rule of the first extension goes away before it was ever matched.
+  std::vector<std::string> rules_to_remove(1, kRuleId1);
+  error = registry->RemoveRules(kExtensionId, rules_to_remove);
+  EXPECT_EQ("", error);
+
+  GURL http_url("http://www.example.com");
+  net::TestURLRequestContext context;
+  net::TestURLRequest http_request(http_url, NULL, &context, NULL);
+  WebRequestData request_data(&http_request, ON_BEFORE_REQUEST);
+  std::set<const WebRequestRule*> matches = registry->GetMatches(request_data);
+  ASSERT_EQ(1u, matches.size());
+  WebRequestRule::GlobalRuleId expected_pair =
+      std::make_pair(kExtensionId2, kRuleId1);
+  EXPECT_EQ(expected_pair, (*matches.begin())->id());
+
+  error = registry->RemoveAllRules(kExtensionId2);
+  EXPECT_EQ("", error);
+  matches = registry->GetMatches(request_data);
+  EXPECT_EQ(0u, matches.size());
+
+  EXPECT_TRUE(registry->IsEmpty());
+}
+
 // Test precedences between extensions.
 TEST_F(WebRequestRulesRegistryTest, Precedences) {
   scoped_refptr<WebRequestRulesRegistry> registry(
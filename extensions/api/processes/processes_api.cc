@@ -4,6 +4,9 @@
 
 #include "chrome/browser/extensions/api/processes/processes_api.h"
 
+#include <map>
+#include <vector>
+
 #include "base/callback.h"
 #include "base/json/json_writer.h"
 #include "base/lazy_instance.h"
@@ -99,9 +102,42 @@ void SetProcessType(base::DictionaryValue* result,
   result->SetString(keys::kTypeKey, type);
 }
 
-base::ListValue* GetTabsForProcess(int process_id) {
+// Maps a renderer process id to the ids of the tabs it hosts.
+typedef std::map<int, std::vector<int> > ProcessTabsMap;
+
+// Finds the tabs of all the renderer processes at once, to save the caller
+// from going through all the render widgets for each process.
+void GetTabsForAllProcesses(ProcessTabsMap* process_tabs) {
+  scoped_ptr<content::RenderWidgetHostIterator> widgets(
+      content::RenderWidgetHost::GetRenderWidgetHosts());
+  while (content::RenderWidgetHost* widget = widgets->GetNextHost()) {
+    if (!widget->IsRenderView())
+      continue;
+
+    content::RenderViewHost* host = content::RenderViewHost::From(widget);
+    content::WebContents* contents =
+        content::WebContents::FromRenderViewHost(host);
+    if (contents) {
+      int tab_id = ExtensionTabUtil::GetTabId(contents);
+      if (tab_id != -1)
+        (*process_tabs)[widget->GetProcess()->GetID()].push_back(tab_id);
+    }
+  }
+}
+
+base::ListValue* GetTabsForProcess(int process_id,
+                                   const ProcessTabsMap* process_tabs) {
   base::ListValue* tabs_list = new base::ListValue();
 
+  if (process_tabs) {
+    ProcessTabsMap::const_iterator it = process_tabs->find(process_id);
+    if (it != process_tabs->end()) {
+      for (size_t i = 0; i < it->second.size(); ++i)
+        tabs_list->Append(new base::FundamentalValue(it->second[i]));
+    }
+    return tabs_list;
+  }
+
   // The tabs list only makes sense for render processes, so if we don't find
   // one, just return the empty list.
   content::RenderProcessHost* rph =
@@ -135,11 +171,14 @@ base::ListValue* GetTabsForProcess(int process_id) {
 
 // This function creates a Process object to be returned to the extensions
 // using these APIs. For memory details, which are not added by this function,
-// the callers need to use AddMemoryDetails.
-base::DictionaryValue* CreateProcessFromModel(int process_id,
-                                              TaskManagerModel* model,
-                                              int index,
-                                              bool include_optional) {
+// the callers need to use AddMemoryDetails. Callers creating many objects can
+// pass the tabs of all processes in |process_tabs|, or NULL otherwise.
+base::DictionaryValue* CreateProcessFromModel(
+    int process_id,
+    TaskManagerModel* model,
+    int index,
+    bool include_optional,
+    const ProcessTabsMap* process_tabs) {
   base::DictionaryValue* result = new base::DictionaryValue();
   size_t mem;
 
@@ -149,7 +188,8 @@ base::DictionaryValue* CreateProcessFromModel(int process_id,
   result->SetString(keys::kProfileKey,
       model->GetResourceProfileName(index));
 
-  result->Set(keys::kTabsListKey, GetTabsForProcess(process_id));
+  result->Set(keys::kTabsListKey,
+              GetTabsForProcess(process_id, process_tabs));
 
   // If we don't need to include the optional properties, just return now.
   if (!include_optional)
@@ -308,7 +348,7 @@ void ProcessesEventRouter::OnItemsAdded(int start, int length) {
 
   scoped_ptr<base::ListValue> args(new base::ListValue());
   base::DictionaryValue* process = CreateProcessFromModel(
-      model_->GetUniqueChildProcessId(index), model_, index, false);
+      model_->GetUniqueChildProcessId(index), model_, index, false, NULL);
   DCHECK(process != NULL);
 
   if (process == NULL)
@@ -338,12 +378,16 @@ void ProcessesEventRouter::OnItemsChanged(int start, int length) {
 
   DCHECK(updated || updated_memory);
 
+  ProcessTabsMap process_tabs;
+  GetTabsForAllProcesses(&process_tabs);
+
   IDMap<base::DictionaryValue> processes_map;
   for (int i = start; i < start + length; i++) {
     if (model_->IsResourceFirstInGroup(i)) {
       int id = model_->GetUniqueChildProcessId(i);
       base::DictionaryValue* process = CreateProcessFromModel(id, model_, i,
-                                                              true);
+                                                              true,
+                                                              &process_tabs);
       processes_map.AddWithID(process, i);
     }
   }
@@ -362,8 +406,10 @@ void ProcessesEventRouter::OnItemsChanged(int start, int length) {
       processes->Set(base::IntToString(id), it.GetCurrentValue());
     }
 
+    // The event owns its arguments, so the onUpdatedWithMemory event below
+    // needs the processes to itself.
     scoped_ptr<base::ListValue> args(new base::ListValue());
-    args->Append(processes);
+    args->Append(updated_memory ? processes->DeepCopy() : processes);
     DispatchEvent(keys::kOnUpdated, args.Pass());
   }
 
@@ -429,7 +475,7 @@ void ProcessesEventRouter::ProcessHangEvent(content::RenderWidgetHost* widget) {
   for (int i = 0; i < count; ++i) {
     if (model_->IsResourceFirstInGroup(i)) {
       if (id == model_->GetUniqueChildProcessId(i)) {
-        process = CreateProcessFromModel(id, model_, i, false);
+        process = CreateProcessFromModel(id, model_, i, false, NULL);
         break;
       }
     }
@@ -711,12 +757,16 @@ void GetProcessInfoFunction::GatherProcessInfo() {
 
   // If there are no process IDs specified, it means we need to return all of
   // the ones we know of.
+  ProcessTabsMap process_tabs;
+  GetTabsForAllProcesses(&process_tabs);
+
   if (process_ids_.size() == 0) {
     int resources = model->ResourceCount();
     for (int i = 0; i < resources; ++i) {
       if (model->IsResourceFirstInGroup(i)) {
         int id = model->GetUniqueChildProcessId(i);
-        base::DictionaryValue* d = CreateProcessFromModel(id, model, i, false);
+        base::DictionaryValue* d =
+            CreateProcessFromModel(id, model, i, false, &process_tabs);
         if (memory_)
           AddMemoryDetails(d, model, i);
         processes->Set(base::IntToString(id), d);
@@ -731,7 +781,7 @@ void GetProcessInfoFunction::GatherProcessInfo() {
                                                        process_ids_.end(), id);
         if (proc_id != process_ids_.end()) {
           base::DictionaryValue* d =
-              CreateProcessFromModel(id, model, i, false);
+              CreateProcessFromModel(id, model, i, false, &process_tabs);
           if (memory_)
             AddMemoryDetails(d, model, i);
           processes->Set(base::IntToString(id), d);
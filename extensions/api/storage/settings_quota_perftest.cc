@@ -0,0 +1,100 @@
+// Copyright 2013 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Benchmarks the quota bookkeeping |SettingsStorageQuotaEnforcer| does for
+// each chrome.storage write and getBytesInUse call, on an extension which has
+// already stored many settings. Results are printed in the perf_test RESULT
+// format so that they can be tracked by the perf bots.
+
+#include <string>
+
+#include "base/compiler_specific.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/time/time.h"
+#include "base/values.h"
+#include "chrome/browser/extensions/api/storage/settings_storage_quota_enforcer.h"
+#include "chrome/browser/value_store/testing_value_store.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_test.h"
+
+using base::TimeTicks;
+
+namespace extensions {
+
+namespace {
+
+// The number of settings stored before timing, and of timed operations.
+const size_t kNumSettings = 10000;
+const size_t kNumOperations = 10000;
+
+// The number of settings written by each batched Set.
+const size_t kBatchSize = 10;
+
+std::string GetKey(size_t index) {
+  return "key" + base::Uint64ToString(index);
+}
+
+class SettingsQuotaPerfTest : public testing::Test {
+ protected:
+  virtual void SetUp() OVERRIDE {
+    SettingsStorageQuotaEnforcer::Limits limits =
+        { UINT_MAX, UINT_MAX, UINT_MAX };
+    storage_.reset(
+        new SettingsStorageQuotaEnforcer(limits, new TestingValueStore()));
+    base::DictionaryValue settings;
+    for (size_t i = 0; i < kNumSettings; ++i)
+      settings.SetWithoutPathExpansion(GetKey(i), new base::StringValue("x"));
+    ASSERT_FALSE(storage_->Set(ValueStore::DEFAULTS, settings)->HasError());
+  }
+
+  // Prints |time| in microseconds per each of |count| operations.
+  void PrintTimePerOperation(const std::string& trace,
+                             base::TimeDelta time,
+                             size_t count) {
+    perf_test::PrintResult("SettingsQuota", std::string(), trace,
+                           time.InMicrosecondsF() / count, "us", true);
+  }
+
+  scoped_ptr<SettingsStorageQuotaEnforcer> storage_;
+};
+
+}  // namespace
+
+TEST_F(SettingsQuotaPerfTest, Set) {
+  base::StringValue value("y");
+  const TimeTicks start = TimeTicks::Now();
+  for (size_t i = 0; i < kNumOperations; ++i) {
+    EXPECT_FALSE(storage_->Set(ValueStore::DEFAULTS,
+                               GetKey(i % kNumSettings), value)->HasError());
+  }
+  PrintTimePerOperation("set", TimeTicks::Now() - start, kNumOperations);
+}
+
+TEST_F(SettingsQuotaPerfTest, SetBatch) {
+  const size_t kNumBatches = kNumOperations / kBatchSize;
+  const TimeTicks start = TimeTicks::Now();
+  for (size_t i = 0; i < kNumBatches; ++i) {
+    base::DictionaryValue settings;
+    for (size_t j = 0; j < kBatchSize; ++j) {
+      settings.SetWithoutPathExpansion(
+          GetKey((i * kBatchSize + j) % kNumSettings),
+          new base::StringValue("y"));
+    }
+    EXPECT_FALSE(storage_->Set(ValueStore::DEFAULTS, settings)->HasError());
+  }
+  PrintTimePerOperation("set_batch", TimeTicks::Now() - start, kNumBatches);
+}
+
+TEST_F(SettingsQuotaPerfTest, GetBytesInUse) {
+  size_t bytes_in_use = 0;
+  const TimeTicks start = TimeTicks::Now();
+  for (size_t i = 0; i < kNumOperations; ++i)
+    bytes_in_use += storage_->GetBytesInUse();
+  PrintTimePerOperation("get_bytes_in_use", TimeTicks::Now() - start,
+                        kNumOperations);
+  EXPECT_LT(0u, bytes_in_use);
+}
+
+}  // namespace extensions
@@ -595,4 +595,28 @@ TEST_F(ExtensionSettingsQuotaTest, GetBytesInUse) {
   EXPECT_EQ(4u, storage_->GetBytesInUse(ab));
 }
 
+TEST_F(ExtensionSettingsQuotaTest, FailedWritesDontChangeBytesInUse) {
+  CreateStorage(UINT_MAX, UINT_MAX, UINT_MAX);
+
+  DictionaryValue settings;
+  settings.Set("b", byte_value_16_->DeepCopy());
+  settings.Set("c", byte_value_1_->DeepCopy());
+  EXPECT_FALSE(storage_->Set(DEFAULTS, "a", *byte_value_1_)->HasError());
+  EXPECT_EQ(2u, storage_->GetBytesInUse());
+
+  delegate_->set_error_code(ValueStore::CORRUPTION);
+  EXPECT_TRUE(storage_->Set(DEFAULTS, "a", *byte_value_16_)->HasError());
+  EXPECT_TRUE(storage_->Set(DEFAULTS, settings)->HasError());
+  EXPECT_EQ(2u, storage_->GetBytesInUse());
+  EXPECT_EQ(2u, storage_->GetBytesInUse("a"));
+  EXPECT_EQ(0u, storage_->GetBytesInUse("b"));
+
+  delegate_->set_error_code(ValueStore::OK);
+  settings.Set("a", byte_value_16_->DeepCopy());
+  EXPECT_FALSE(storage_->Set(DEFAULTS, settings)->HasError());
+  EXPECT_EQ(17u, storage_->GetBytesInUse("a"));
+  EXPECT_EQ(17u, storage_->GetBytesInUse("b"));
+  EXPECT_EQ(36u, storage_->GetBytesInUse());
+}
+
 }  // namespace extensions
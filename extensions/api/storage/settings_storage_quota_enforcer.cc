@@ -26,19 +26,23 @@ enum Resource {
   MAX_ITEMS
 };
 
+// Returns the size of a setting, based on its JSON serialization size.
+size_t GetSettingSize(const std::string& key, const Value& value) {
+  // TODO(kalman): Does this work with different encodings?
+  // TODO(kalman): This is duplicating work that the leveldb delegate
+  // implementation is about to do, and it would be nice to avoid this.
+  std::string value_as_json;
+  base::JSONWriter::Write(&value, &value_as_json);
+  return key.size() + value_as_json.size();
+}
+
 // Allocates a setting in a record of total and per-setting usage.
 void Allocate(
     const std::string& key,
     const Value& value,
     size_t* used_total,
     std::map<std::string, size_t>* used_per_setting) {
-  // Calculate the setting size based on its JSON serialization size.
-  // TODO(kalman): Does this work with different encodings?
-  // TODO(kalman): This is duplicating work that the leveldb delegate
-  // implementation is about to do, and it would be nice to avoid this.
-  std::string value_as_json;
-  base::JSONWriter::Write(&value, &value_as_json);
-  size_t new_size = key.size() + value_as_json.size();
+  size_t new_size = GetSettingSize(key, value);
   size_t existing_size = (*used_per_setting)[key];
 
   *used_total += (new_size - existing_size);
@@ -140,20 +144,27 @@ ValueStore::ReadResult SettingsStorageQuotaEnforcer::Get() {
 
 ValueStore::WriteResult SettingsStorageQuotaEnforcer::Set(
     WriteOptions options, const std::string& key, const Value& value) {
-  size_t new_used_total = used_total_;
-  std::map<std::string, size_t> new_used_per_setting = used_per_setting_;
-  Allocate(key, value, &new_used_total, &new_used_per_setting);
+  // Only the usage of |key| changes, so the records are updated once the
+  // write succeeded rather than copied.
+  size_t new_size = GetSettingSize(key, value);
+  std::map<std::string, size_t>::const_iterator existing =
+      used_per_setting_.find(key);
+  size_t existing_size =
+      existing == used_per_setting_.end() ? 0u : existing->second;
+  size_t new_used_total = used_total_ - existing_size + new_size;
+  size_t new_item_count = used_per_setting_.size() +
+      (existing == used_per_setting_.end() ? 1u : 0u);
 
   if (!(options & IGNORE_QUOTA)) {
     if (new_used_total > limits_.quota_bytes) {
       return MakeWriteResult(
           QuotaExceededError(QUOTA_BYTES, util::NewKey(key)));
     }
-    if (new_used_per_setting[key] > limits_.quota_bytes_per_item) {
+    if (new_size > limits_.quota_bytes_per_item) {
       return MakeWriteResult(
           QuotaExceededError(QUOTA_BYTES_PER_ITEM, util::NewKey(key)));
     }
-    if (new_used_per_setting.size() > limits_.max_items)
+    if (new_item_count > limits_.max_items)
       return MakeWriteResult(QuotaExceededError(MAX_ITEMS, util::NewKey(key)));
   }
 
@@ -163,29 +174,40 @@ ValueStore::WriteResult SettingsStorageQuotaEnforcer::Set(
   }
 
   used_total_ = new_used_total;
-  used_per_setting_.swap(new_used_per_setting);
+  used_per_setting_[key] = new_size;
   return result.Pass();
 }
 
 ValueStore::WriteResult SettingsStorageQuotaEnforcer::Set(
     WriteOptions options, const base::DictionaryValue& values) {
+  // The new sizes of the settings in |values|, which are only recorded once
+  // the write succeeded.
+  std::map<std::string, size_t> new_sizes;
   size_t new_used_total = used_total_;
-  std::map<std::string, size_t> new_used_per_setting = used_per_setting_;
+  size_t new_item_count = used_per_setting_.size();
   for (base::DictionaryValue::Iterator it(values); !it.IsAtEnd();
        it.Advance()) {
-    Allocate(it.key(), it.value(), &new_used_total, &new_used_per_setting);
-
-    if (!(options & IGNORE_QUOTA) &&
-        new_used_per_setting[it.key()] > limits_.quota_bytes_per_item) {
+    size_t new_size = GetSettingSize(it.key(), it.value());
+    if (!(options & IGNORE_QUOTA) && new_size > limits_.quota_bytes_per_item) {
       return MakeWriteResult(
           QuotaExceededError(QUOTA_BYTES_PER_ITEM, util::NewKey(it.key())));
     }
+
+    std::map<std::string, size_t>::const_iterator existing =
+        used_per_setting_.find(it.key());
+    if (existing == used_per_setting_.end()) {
+      ++new_item_count;
+    } else {
+      new_used_total -= existing->second;
+    }
+    new_used_total += new_size;
+    new_sizes[it.key()] = new_size;
   }
 
   if (!(options & IGNORE_QUOTA)) {
     if (new_used_total > limits_.quota_bytes)
       return MakeWriteResult(QuotaExceededError(QUOTA_BYTES, util::NoKey()));
-    if (new_used_per_setting.size() > limits_.max_items)
+    if (new_item_count > limits_.max_items)
       return MakeWriteResult(QuotaExceededError(MAX_ITEMS, util::NoKey()));
   }
 
@@ -195,7 +217,10 @@ ValueStore::WriteResult SettingsStorageQuotaEnforcer::Set(
   }
 
   used_total_ = new_used_total;
-  used_per_setting_ = new_used_per_setting;
+  for (std::map<std::string, size_t>::const_iterator it = new_sizes.begin();
+       it != new_sizes.end(); ++it) {
+    used_per_setting_[it->first] = it->second;
+  }
   return result.Pass();
 }
 
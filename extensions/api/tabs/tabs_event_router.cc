@@ -39,6 +39,7 @@ namespace tabs = api::tabs;
 
 void WillDispatchTabUpdatedEvent(WebContents* contents,
                                  const DictionaryValue* changed_properties,
+                                 const DictionaryValue* tab_value,
                                  Profile* profile,
                                  const Extension* extension,
                                  ListValue* event_args) {
@@ -51,7 +52,11 @@ void WillDispatchTabUpdatedEvent(WebContents* contents,
   event_args->Set(1, properties_value);
 
   // Overwrite the third arg with our tab value as seen by this extension.
-  event_args->Set(2, ExtensionTabUtil::CreateTabValue(contents, extension));
+  DictionaryValue* scrubbed_tab_value = tab_value->DeepCopy();
+  ExtensionTabUtil::ScrubTabValueForExtension(contents,
+                                              extension,
+                                              scrubbed_tab_value);
+  event_args->Set(2, scrubbed_tab_value);
 }
 
 }  // namespace
@@ -456,7 +461,10 @@ void TabsEventRouter::DispatchTabUpdatedEvent(
   // extension has the tabs permission.
 
   // Third arg: An object containing the state of the tab. Filled in by
-  // WillDispatchTabUpdatedEvent.
+  // WillDispatchTabUpdatedEvent from |tab_value|. The tabs seen here belong
+  // to tab strips, so their value only depends on the extension through the
+  // scrubbing, and is built once for all the listeners.
+  DictionaryValue* tab_value = ExtensionTabUtil::CreateTabValue(contents);
   Profile* profile = Profile::FromBrowserContext(contents->GetBrowserContext());
 
   scoped_ptr<Event> event(
@@ -466,7 +474,8 @@ void TabsEventRouter::DispatchTabUpdatedEvent(
   event->will_dispatch_callback =
       base::Bind(&WillDispatchTabUpdatedEvent,
                  contents,
-                 changed_properties.get());
+                 changed_properties.get(),
+                 base::Owned(tab_value));
   ExtensionSystem::Get(profile)->event_router()->BroadcastEvent(event.Pass());
 }
 
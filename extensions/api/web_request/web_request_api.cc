@@ -90,6 +90,12 @@ namespace {
 const char kWebRequest[] = "webRequest";
 const char kWebView[] = "webview";
 
+// How long a blocking listener of onBeforeRequest or onBeforeSendHeaders has
+// to respond. A listener which misses it is treated as having no opinion
+// about the request, so that a hung extension process doesn't stall every
+// page load.
+const int kListenerDeadlineSeconds = 5;
+
 // List of all the webRequest events.
 const char* const kWebRequestEvents[] = {
   keys::kOnBeforeRedirectEvent,
@@ -411,6 +417,13 @@ struct ExtensionWebRequestEventRouter::EventListener {
     return false;
   }
 
+  // Orders pointers to listeners like the listeners they point to.
+  struct PointerLess {
+    bool operator()(const EventListener* a, const EventListener* b) const {
+      return *a < *b;
+    }
+  };
+
   EventListener() : extra_info_spec(0) {}
 };
 
@@ -464,6 +477,11 @@ struct ExtensionWebRequestEventRouter::BlockedRequest {
   // Time the request was paused. Used for logging purposes.
   base::Time blocking_time;
 
+  // Identifies the deadlines of the listeners of the current event, so that
+  // the deadlines of an earlier event of the request are ignored. 0 if the
+  // listeners have no deadline.
+  uint64 deadline_id;
+
   // Changes requested by extensions.
   helpers::EventResponseDeltas response_deltas;
 
@@ -477,6 +495,7 @@ struct ExtensionWebRequestEventRouter::BlockedRequest {
         event(kInvalidEvent),
         num_handlers_blocking(0),
         net_log(NULL),
+        deadline_id(0),
         new_url(NULL),
         request_headers(NULL),
         override_response_headers(NULL),
@@ -591,7 +610,10 @@ ExtensionWebRequestEventRouter* ExtensionWebRequestEventRouter::GetInstance() {
 }
 
 ExtensionWebRequestEventRouter::ExtensionWebRequestEventRouter()
-    : request_time_tracker_(new ExtensionWebRequestTimeTracker) {
+    : request_time_tracker_(new ExtensionWebRequestTimeTracker),
+      last_deadline_id_(0),
+      listener_deadline_(
+          base::TimeDelta::FromSeconds(kListenerDeadlineSeconds)) {
 }
 
 ExtensionWebRequestEventRouter::~ExtensionWebRequestEventRouter() {
@@ -668,6 +690,8 @@ int ExtensionWebRequestEventRouter::OnBeforeRequest(
     return ExecuteDeltas(profile, request->identifier(),
                          false /* call_callback*/);
   } else {
+    StartListenerDeadlines(profile, web_request::OnBeforeRequest::kEventName,
+                           request->identifier(), listeners);
     return net::ERR_IO_PENDING;
   }
 }
@@ -725,6 +749,8 @@ int ExtensionWebRequestEventRouter::OnBeforeSendHeaders(
     return ExecuteDeltas(profile, request->identifier(),
                          false /* call_callback*/);
   } else {
+    StartListenerDeadlines(profile, keys::kOnBeforeSendHeadersEvent,
+                           request->identifier(), listeners);
     return net::ERR_IO_PENDING;
   }
 }
@@ -1157,8 +1183,13 @@ void ExtensionWebRequestEventRouter::OnEventHandled(
   // before we got here.
   std::set<EventListener>::iterator found =
       listeners_[profile][event_name].find(listener);
-  if (found != listeners_[profile][event_name].end())
-    found->blocked_requests.erase(request_id);
+  if (found != listeners_[profile][event_name].end() &&
+      found->blocked_requests.erase(request_id) == 0) {
+    // The listener missed its deadline, or the request was decided without
+    // it, and the request is no longer waiting for it.
+    delete response;
+    return;
+  }
 
   DecrementBlockCount(profile, extension_id, event_name, request_id, response);
 }
@@ -1194,7 +1225,9 @@ bool ExtensionWebRequestEventRouter::AddEventListener(
     // This is likely an abuse of the API by a malicious extension.
     return false;
   }
-  listeners_[profile][event_name].insert(listener);
+  const EventListener& added =
+      *listeners_[profile][event_name].insert(listener).first;
+  GetListenerIndex(profile, event_name)->Add(added.filter.urls, &added);
   return true;
 }
 
@@ -1229,7 +1262,8 @@ void ExtensionWebRequestEventRouter::RemoveEventListener(
     DecrementBlockCount(profile, extension_id, event_name, *it, NULL);
   }
 
-  listeners_[profile][event_name].erase(listener);
+  GetListenerIndex(profile, event_name)->Remove(found->filter.urls, &*found);
+  listeners_[profile][event_name].erase(found);
 
   helpers::ClearCacheOnNavigation();
 }
@@ -1359,39 +1393,49 @@ void ExtensionWebRequestEventRouter::GetMatchingListenersImpl(
   if (is_guest)
     web_request_event_name.replace(0, sizeof(kWebRequest) - 1, kWebView);
 
-  std::set<EventListener>& listeners =
-      listeners_[profile][web_request_event_name];
-  for (std::set<EventListener>::iterator it = listeners.begin();
+  // Only look at the listeners whose filter may match |url|, in the order of
+  // |listeners_|.
+  std::set<const EventListener*> candidates;
+  GetListenerIndex(profile, web_request_event_name)->GetCandidates(
+      url, &candidates);
+  std::vector<const EventListener*> listeners(candidates.begin(),
+                                              candidates.end());
+  std::sort(listeners.begin(), listeners.end(), EventListener::PointerLess());
+  for (std::vector<const EventListener*>::const_iterator it =
+           listeners.begin();
        it != listeners.end(); ++it) {
-    if (!it->ipc_sender.get()) {
+    const EventListener* listener = *it;
+    if (!listener->ipc_sender.get()) {
       // The IPC sender has been deleted. This listener will be removed soon
       // via a call to RemoveEventListener. For now, just skip it.
       continue;
     }
 
     if (is_guest &&
-        (it->embedder_process_id != webview_info.embedder_process_id ||
-         it->webview_instance_id != webview_info.instance_id))
+        (listener->embedder_process_id != webview_info.embedder_process_id ||
+         listener->webview_instance_id != webview_info.instance_id))
       continue;
 
-    if (!it->filter.urls.is_empty() && !it->filter.urls.MatchesURL(url))
+    if (!listener->filter.urls.is_empty() &&
+        !listener->filter.urls.MatchesURL(url))
       continue;
-    if (it->filter.tab_id != -1 && tab_id != it->filter.tab_id)
+    if (listener->filter.tab_id != -1 && tab_id != listener->filter.tab_id)
       continue;
-    if (it->filter.window_id != -1 && window_id != it->filter.window_id)
+    if (listener->filter.window_id != -1 &&
+        window_id != listener->filter.window_id)
       continue;
-    if (!it->filter.types.empty() &&
-        std::find(it->filter.types.begin(), it->filter.types.end(),
-                  resource_type) == it->filter.types.end())
+    if (!listener->filter.types.empty() &&
+        std::find(listener->filter.types.begin(), listener->filter.types.end(),
+                  resource_type) == listener->filter.types.end())
       continue;
 
     if (!is_guest && !WebRequestPermissions::CanExtensionAccessURL(
-            extension_info_map, it->extension_id, url, crosses_incognito,
+            extension_info_map, listener->extension_id, url, crosses_incognito,
             WebRequestPermissions::REQUIRE_HOST_PERMISSION))
       continue;
 
     bool blocking_listener =
-        (it->extra_info_spec &
+        (listener->extra_info_spec &
             (ExtraInfoSpec::BLOCKING | ExtraInfoSpec::ASYNC_BLOCKING)) != 0;
 
     // We do not want to notify extensions about XHR requests that are
@@ -1407,11 +1451,22 @@ void ExtensionWebRequestEventRouter::GetMatchingListenersImpl(
     if (blocking_listener && synchronous_xhr_from_extension)
       continue;
 
-    matching_listeners->push_back(&(*it));
-    *extra_info_spec |= it->extra_info_spec;
+    matching_listeners->push_back(listener);
+    *extra_info_spec |= listener->extra_info_spec;
   }
 }
 
+ExtensionWebRequestEventRouter::ListenerIndex*
+ExtensionWebRequestEventRouter::GetListenerIndex(
+    void* profile,
+    const std::string& event_name) {
+  linked_ptr<ListenerIndex>& index =
+      listener_indexes_[std::make_pair(profile, event_name)];
+  if (!index.get())
+    index.reset(new ListenerIndex());
+  return index.get();
+}
+
 std::vector<const ExtensionWebRequestEventRouter::EventListener*>
 ExtensionWebRequestEventRouter::GetMatchingListeners(
     void* profile,
@@ -1677,6 +1732,24 @@ void ExtensionWebRequestEventRouter::DecrementBlockCount(
 
     blocked_request.response_deltas.push_back(
         linked_ptr<helpers::EventResponseDelta>(delta));
+
+    // A cancel wins over whatever the other extensions answer, so the request
+    // doesn't wait for them. This is only possible when all of the handlers
+    // left are listeners, and not e.g. the rules registry being loaded.
+    if (delta->cancel && num_handlers_blocking > 0) {
+      std::vector<const EventListener*> listeners =
+          GetListenersBlockingRequest(profile, event_name, request_id);
+      if (static_cast<int>(listeners.size()) == num_handlers_blocking) {
+        base::TimeDelta block_time =
+            base::Time::Now() - blocked_request.blocking_time;
+        for (size_t i = 0; i < listeners.size(); ++i) {
+          listeners[i]->blocked_requests.erase(request_id);
+          request_time_tracker_->IncrementExtensionBlockTime(
+              listeners[i]->extension_id, request_id, block_time);
+        }
+        num_handlers_blocking = blocked_request.num_handlers_blocking = 0;
+      }
+    }
   }
 
   base::TimeDelta block_time =
@@ -1709,6 +1782,91 @@ void ExtensionWebRequestEventRouter::DecrementBlockCount(
   }
 }
 
+std::vector<const ExtensionWebRequestEventRouter::EventListener*>
+ExtensionWebRequestEventRouter::GetListenersBlockingRequest(
+    void* profile,
+    const std::string& event_name,
+    uint64 request_id) {
+  std::vector<const EventListener*> result;
+  void* profiles[] = { profile, GetCrossProfile(profile) };
+  for (size_t i = 0; i < arraysize(profiles); ++i) {
+    if (!profiles[i] || (i > 0 && profiles[i] == profile))
+      continue;
+    ListenerMap::iterator listeners = listeners_.find(profiles[i]);
+    if (listeners == listeners_.end())
+      continue;
+    ListenerMapForProfile::iterator event_listeners =
+        listeners->second.find(event_name);
+    if (event_listeners == listeners->second.end())
+      continue;
+    for (std::set<EventListener>::iterator it =
+             event_listeners->second.begin();
+         it != event_listeners->second.end(); ++it) {
+      if (it->blocked_requests.count(request_id))
+        result.push_back(&*it);
+    }
+  }
+  return result;
+}
+
+void ExtensionWebRequestEventRouter::StartListenerDeadlines(
+    void* profile,
+    const std::string& event_name,
+    uint64 request_id,
+    const std::vector<const EventListener*>& listeners) {
+  const uint64 deadline_id = ++last_deadline_id_;
+  blocked_requests_[request_id].deadline_id = deadline_id;
+  for (std::vector<const EventListener*>::const_iterator it = listeners.begin();
+       it != listeners.end(); ++it) {
+    if (!(*it)->blocked_requests.count(request_id))
+      continue;
+    // The router is only destroyed at exit, once the IO thread is gone.
+    BrowserThread::PostDelayedTask(
+        BrowserThread::IO,
+        FROM_HERE,
+        base::Bind(&ExtensionWebRequestEventRouter::OnListenerDeadline,
+                   base::Unretained(this), profile, (*it)->extension_id,
+                   event_name, (*it)->sub_event_name, request_id,
+                   deadline_id),
+        listener_deadline_);
+  }
+}
+
+void ExtensionWebRequestEventRouter::OnListenerDeadline(
+    void* profile,
+    const std::string& extension_id,
+    const std::string& event_name,
+    const std::string& sub_event_name,
+    uint64 request_id,
+    uint64 deadline_id) {
+  BlockedRequestMap::iterator blocked_request =
+      blocked_requests_.find(request_id);
+  if (blocked_request == blocked_requests_.end() ||
+      blocked_request->second.deadline_id != deadline_id) {
+    return;
+  }
+
+  std::vector<const EventListener*> listeners =
+      GetListenersBlockingRequest(profile, event_name, request_id);
+  for (size_t i = 0; i < listeners.size(); ++i) {
+    if (listeners[i]->extension_id != extension_id ||
+        listeners[i]->sub_event_name != sub_event_name) {
+      continue;
+    }
+    // Fail open: the response which comes in later is dropped by
+    // OnEventHandled().
+    listeners[i]->blocked_requests.erase(request_id);
+    RecordAction(content::UserMetricsAction("WebRequest.ListenerTimedOut"));
+    DecrementBlockCount(profile, extension_id, event_name, request_id, NULL);
+    return;
+  }
+}
+
+base::ListValue* ExtensionWebRequestEventRouter::GetExtensionDelaysAsValue()
+    const {
+  return request_time_tracker_->GetExtensionDelaysAsValue();
+}
+
 void ExtensionWebRequestEventRouter::SendMessages(
     void* profile,
     const BlockedRequest& blocked_request) {
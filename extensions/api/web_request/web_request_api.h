@@ -11,6 +11,7 @@
 #include <string>
 #include <vector>
 
+#include "base/memory/linked_ptr.h"
 #include "base/memory/singleton.h"
 #include "base/memory/weak_ptr.h"
 #include "base/time/time.h"
@@ -18,6 +19,7 @@
 #include "chrome/browser/extensions/api/web_request/web_request_api_helpers.h"
 #include "chrome/browser/extensions/api/web_request/web_request_permissions.h"
 #include "chrome/browser/extensions/extension_function.h"
+#include "chrome/browser/extensions/url_pattern_index.h"
 #include "chrome/browser/profiles/profile.h"
 #include "chrome/common/chrome_version_info.h"
 #include "extensions/common/url_pattern_set.h"
@@ -272,12 +274,25 @@ class ExtensionWebRequestEventRouter
   // The callback is then deleted.
   void AddCallbackForPageLoad(const base::Closure& callback);
 
+  // Returns the recent delays caused by each extension, see
+  // ExtensionWebRequestTimeTracker::GetExtensionDelaysAsValue(). The caller
+  // takes ownership.
+  base::ListValue* GetExtensionDelaysAsValue() const;
+
+  void set_listener_deadline_for_testing(base::TimeDelta deadline) {
+    listener_deadline_ = deadline;
+  }
+
  private:
   friend struct DefaultSingletonTraits<ExtensionWebRequestEventRouter>;
 
   struct EventListener;
   typedef std::map<std::string, std::set<EventListener> > ListenerMapForProfile;
   typedef std::map<void*, ListenerMapForProfile> ListenerMap;
+  // The listeners of an event in a profile, by the URLs of their filters.
+  typedef extensions::URLPatternIndex<const EventListener*> ListenerIndex;
+  typedef std::map<std::pair<void*, std::string>, linked_ptr<ListenerIndex> >
+      ListenerIndexMap;
   typedef std::map<uint64, BlockedRequest> BlockedRequestMap;
   // Map of request_id -> bit vector of EventTypes already signaled
   typedef std::map<uint64, int> SignaledRequestMap;
@@ -309,6 +324,10 @@ class ExtensionWebRequestEventRouter
       net::URLRequest* request,
       int* extra_info_spec);
 
+  // Returns the index of the listeners of |event_name| in |profile|, creating
+  // it if needed.
+  ListenerIndex* GetListenerIndex(void* profile, const std::string& event_name);
+
   // Helper for the above functions. This is called twice: once for the profile
   // of the event, the next time for the "cross" profile (i.e. the incognito
   // profile if the event is originally for the normal profile, or vice versa).
@@ -341,6 +360,32 @@ class ExtensionWebRequestEventRouter
       uint64 request_id,
       EventResponse* response);
 
+  // Returns the listeners to |event_name| which |request_id| is still waiting
+  // for, in the profile of the event and in its cross profile.
+  std::vector<const EventListener*> GetListenersBlockingRequest(
+      void* profile,
+      const std::string& event_name,
+      uint64 request_id);
+
+  // Gives each of the blocking |listeners| of |request_id| a deadline to
+  // respond to |event_name| by.
+  void StartListenerDeadlines(
+      void* profile,
+      const std::string& event_name,
+      uint64 request_id,
+      const std::vector<const EventListener*>& listeners);
+
+  // Called when the listener |sub_event_name| of |extension_id| didn't respond
+  // in time to the dispatch |deadline_id|. The request proceeds as if the
+  // listener had returned no response.
+  void OnListenerDeadline(
+      void* profile,
+      const std::string& extension_id,
+      const std::string& event_name,
+      const std::string& sub_event_name,
+      uint64 request_id,
+      uint64 deadline_id);
+
   // Processes the generated deltas from blocked_requests_ on the specified
   // request. If |call_back| is true, the callback registered in
   // |blocked_requests_| is called.
@@ -404,6 +449,11 @@ class ExtensionWebRequestEventRouter
   // are listening to that event.
   ListenerMap listeners_;
 
+  // Indexes of the listeners in |listeners_|, by profile and event name. Used
+  // to only consider the listeners whose filter may match the URL of a
+  // request.
+  ListenerIndexMap listener_indexes_;
+
   // A map of network requests that are waiting for at least one event handler
   // to respond.
   BlockedRequestMap blocked_requests_;
@@ -426,6 +476,12 @@ class ExtensionWebRequestEventRouter
   std::map<void*, scoped_refptr<extensions::WebRequestRulesRegistry> >
       rules_registries_;
 
+  // The id of the last dispatch whose listeners were given a deadline.
+  uint64 last_deadline_id_;
+
+  // How long blocking listeners have to respond.
+  base::TimeDelta listener_deadline_;
+
   DISALLOW_COPY_AND_ASSIGN(ExtensionWebRequestEventRouter);
 };
 
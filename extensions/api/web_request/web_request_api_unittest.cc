@@ -473,6 +473,103 @@ TEST_F(ExtensionWebRequestTest, SimulateChancelWhileBlocked) {
       &profile_, extension_id, kEventName2 + "/1");
 }
 
+// Tests that a request whose blocking listener never responds proceeds once
+// the listener's deadline has passed, and that the late response is dropped.
+TEST_F(ExtensionWebRequestTest, BlockingListenerDeadlineFailsOpen) {
+  std::string extension_id("1");
+  ExtensionWebRequestEventRouter::RequestFilter filter;
+  const std::string kEventName(web_request::OnBeforeRequest::kEventName);
+  base::WeakPtrFactory<TestIPCSender> ipc_sender_factory(&ipc_sender_);
+  ExtensionWebRequestEventRouter::GetInstance()->AddEventListener(
+    &profile_, extension_id, extension_id, kEventName, kEventName + "/1",
+    filter, ExtensionWebRequestEventRouter::ExtraInfoSpec::BLOCKING, -1, -1,
+    ipc_sender_factory.GetWeakPtr());
+  ExtensionWebRequestEventRouter::GetInstance()->
+      set_listener_deadline_for_testing(base::TimeDelta());
+
+  GURL request_url("about:blank");
+  net::URLRequest request(request_url, &delegate_, context_.get());
+
+  // The listener doesn't respond to onBeforeRequest.
+  ipc_sender_.PushTask(base::Bind(&base::DoNothing));
+
+  request.Start();
+  base::MessageLoop::current()->Run();
+
+  EXPECT_TRUE(!request.is_pending());
+  EXPECT_EQ(net::URLRequestStatus::SUCCESS, request.status().status());
+  EXPECT_EQ(0, request.status().error());
+  EXPECT_EQ(request_url, request.url());
+  EXPECT_EQ(1U, request.url_chain().size());
+  EXPECT_EQ(0U, ipc_sender_.GetNumTasks());
+
+  // The response which arrives after the deadline has no effect.
+  ExtensionWebRequestEventRouter::EventResponse* response =
+      new ExtensionWebRequestEventRouter::EventResponse(
+          extension_id, base::Time::FromDoubleT(1));
+  response->cancel = true;
+  EventHandledOnIOThread(&profile_, extension_id, kEventName,
+                         kEventName + "/1", request.identifier(), response);
+  base::MessageLoop::current()->RunUntilIdle();
+  EXPECT_EQ(net::URLRequestStatus::SUCCESS, request.status().status());
+
+  ExtensionWebRequestEventRouter::GetInstance()->
+      set_listener_deadline_for_testing(base::TimeDelta::FromSeconds(5));
+  ExtensionWebRequestEventRouter::GetInstance()->RemoveEventListener(
+      &profile_, extension_id, kEventName + "/1");
+}
+
+// Tests that once a blocking listener cancels a request, the request doesn't
+// wait for the other blocking listeners to respond.
+TEST_F(ExtensionWebRequestTest, CancelDoesNotWaitForOtherListeners) {
+  std::string extension1_id("1");
+  std::string extension2_id("2");
+  ExtensionWebRequestEventRouter::RequestFilter filter;
+  const std::string kEventName(web_request::OnBeforeRequest::kEventName);
+  base::WeakPtrFactory<TestIPCSender> ipc_sender_factory(&ipc_sender_);
+  ExtensionWebRequestEventRouter::GetInstance()->AddEventListener(
+    &profile_, extension1_id, extension1_id, kEventName, kEventName + "/1",
+    filter, ExtensionWebRequestEventRouter::ExtraInfoSpec::BLOCKING, -1, -1,
+    ipc_sender_factory.GetWeakPtr());
+  ExtensionWebRequestEventRouter::GetInstance()->AddEventListener(
+    &profile_, extension2_id, extension2_id, kEventName, kEventName + "/2",
+    filter, ExtensionWebRequestEventRouter::ExtraInfoSpec::BLOCKING, -1, -1,
+    ipc_sender_factory.GetWeakPtr());
+  // Waiting for extension1 would hang the test.
+  ExtensionWebRequestEventRouter::GetInstance()->
+      set_listener_deadline_for_testing(base::TimeDelta::FromDays(1));
+
+  GURL request_url("about:blank");
+  net::URLRequest request(request_url, &delegate_, context_.get());
+
+  // Extension1 never responds, extension2 cancels the request.
+  ipc_sender_.PushTask(base::Bind(&base::DoNothing));
+  ExtensionWebRequestEventRouter::EventResponse* response =
+      new ExtensionWebRequestEventRouter::EventResponse(
+          extension2_id, base::Time::FromDoubleT(2));
+  response->cancel = true;
+  ipc_sender_.PushTask(
+      base::Bind(&EventHandledOnIOThread,
+          &profile_, extension2_id, kEventName, kEventName + "/2",
+          request.identifier(), response));
+
+  request.Start();
+  base::MessageLoop::current()->Run();
+
+  EXPECT_TRUE(!request.is_pending());
+  EXPECT_EQ(net::URLRequestStatus::FAILED, request.status().status());
+  EXPECT_EQ(net::ERR_BLOCKED_BY_CLIENT, request.status().error());
+  EXPECT_EQ(request_url, request.url());
+  EXPECT_EQ(0U, ipc_sender_.GetNumTasks());
+
+  ExtensionWebRequestEventRouter::GetInstance()->
+      set_listener_deadline_for_testing(base::TimeDelta::FromSeconds(5));
+  ExtensionWebRequestEventRouter::GetInstance()->RemoveEventListener(
+      &profile_, extension1_id, kEventName + "/1");
+  ExtensionWebRequestEventRouter::GetInstance()->RemoveEventListener(
+      &profile_, extension2_id, kEventName + "/2");
+}
+
 namespace {
 
 // Create the numerical representation of |values|, strings passed as
@@ -4,9 +4,13 @@
 
 #include "chrome/browser/extensions/api/web_request/web_request_time_tracker.h"
 
+#include <algorithm>
+#include <vector>
+
 #include "base/bind.h"
 #include "base/compiler_specific.h"
 #include "base/metrics/histogram.h"
+#include "base/values.h"
 #include "chrome/browser/browser_process.h"
 #include "chrome/browser/extensions/extension_service.h"
 #include "chrome/browser/extensions/extension_warning_set.h"
@@ -35,6 +39,16 @@ const double kThresholdExcessiveDelay = 0.50;
 const size_t kNumModerateDelaysBeforeWarning = 50u;
 const size_t kNumExcessiveDelaysBeforeWarning = 10u;
 
+// The number of recent delays of each extension we keep track of.
+const size_t kMaxExtensionDelaysLogged = 200u;
+
+// Returns the |percentile| of the |sorted| delays, in milliseconds.
+double GetPercentileMs(const std::vector<base::TimeDelta>& sorted,
+                       size_t percentile) {
+  DCHECK(!sorted.empty());
+  return sorted[(sorted.size() - 1) * percentile / 100].InMillisecondsF();
+}
+
 // Default implementation for ExtensionWebRequestTimeTrackerDelegate
 // that sets a warning in the extension service of |profile|.
 class DefaultDelegate : public ExtensionWebRequestTimeTrackerDelegate {
@@ -216,6 +230,11 @@ void ExtensionWebRequestTimeTracker::IncrementExtensionBlockTime(
     const std::string& extension_id,
     int64 request_id,
     const base::TimeDelta& block_time) {
+  std::deque<base::TimeDelta>& delays = extension_delays_[extension_id];
+  delays.push_back(block_time);
+  if (delays.size() > kMaxExtensionDelaysLogged)
+    delays.pop_front();
+
   if (request_time_logs_.find(request_id) == request_time_logs_.end())
     return;
   RequestTimeLog& log = request_time_logs_[request_id];
@@ -252,3 +271,23 @@ void ExtensionWebRequestTimeTracker::SetDelegate(
     ExtensionWebRequestTimeTrackerDelegate* delegate) {
   delegate_.reset(delegate);
 }
+
+base::ListValue* ExtensionWebRequestTimeTracker::GetExtensionDelaysAsValue()
+    const {
+  base::ListValue* result = new base::ListValue;
+  for (std::map<std::string, std::deque<base::TimeDelta> >::const_iterator i =
+           extension_delays_.begin();
+       i != extension_delays_.end();
+       ++i) {
+    std::vector<base::TimeDelta> sorted(i->second.begin(), i->second.end());
+    std::sort(sorted.begin(), sorted.end());
+
+    base::DictionaryValue* extension = new base::DictionaryValue;
+    extension->SetString("id", i->first);
+    extension->SetInteger("count", static_cast<int>(sorted.size()));
+    extension->SetDouble("p50", GetPercentileMs(sorted, 50));
+    extension->SetDouble("p99", GetPercentileMs(sorted, 99));
+    result->Append(extension);
+  }
+  return result;
+}
@@ -5,6 +5,7 @@
 #ifndef CHROME_BROWSER_EXTENSIONS_API_WEB_REQUEST_WEB_REQUEST_TIME_TRACKER_H_
 #define CHROME_BROWSER_EXTENSIONS_API_WEB_REQUEST_WEB_REQUEST_TIME_TRACKER_H_
 
+#include <deque>
 #include <map>
 #include <queue>
 #include <set>
@@ -16,6 +17,7 @@
 #include "url/gurl.h"
 
 namespace base {
+class ListValue;
 class Time;
 }
 
@@ -76,6 +78,11 @@ class ExtensionWebRequestTimeTracker {
   // Takes ownership of |delegate|.
   void SetDelegate(ExtensionWebRequestTimeTrackerDelegate* delegate);
 
+  // Returns a list with a dictionary for each extension which recently
+  // delayed requests, with its id, the number of recent delays and their
+  // median and 99th percentile in milliseconds. The caller takes ownership.
+  base::ListValue* GetExtensionDelaysAsValue() const;
+
  private:
   // Timing information for a single request.
   struct RequestTimeLog {
@@ -109,6 +116,10 @@ class ExtensionWebRequestTimeTracker {
   std::set<int64> excessive_delays_;
   std::set<int64> moderate_delays_;
 
+  // The most recent delays caused by each extension, whichever request they
+  // were for, oldest first.
+  std::map<std::string, std::deque<base::TimeDelta> > extension_delays_;
+
   // Defaults to a delegate that sets warnings in the extension service.
   scoped_ptr<ExtensionWebRequestTimeTrackerDelegate> delegate_;
 
@@ -118,6 +129,8 @@ class ExtensionWebRequestTimeTracker {
   FRIEND_TEST_ALL_PREFIXES(ExtensionWebRequestTimeTrackerTest,
                            CancelOrRedirect);
   FRIEND_TEST_ALL_PREFIXES(ExtensionWebRequestTimeTrackerTest, Delays);
+  FRIEND_TEST_ALL_PREFIXES(ExtensionWebRequestTimeTrackerTest,
+                           ExtensionDelays);
 
   DISALLOW_COPY_AND_ASSIGN(ExtensionWebRequestTimeTracker);
 };
@@ -4,6 +4,8 @@
 
 #include "chrome/browser/extensions/api/web_request/web_request_time_tracker.h"
 
+#include "base/memory/scoped_ptr.h"
+#include "base/values.h"
 #include "testing/gmock/include/gmock/gmock.h"
 #include "testing/gtest/include/gtest/gtest.h"
 
@@ -145,3 +147,40 @@ TEST(ExtensionWebRequestTimeTrackerTest, Delegate) {
     Mock::VerifyAndClearExpectations(delegate);
   }
 }
+
+TEST(ExtensionWebRequestTimeTrackerTest, ExtensionDelays) {
+  ExtensionWebRequestTimeTracker tracker;
+
+  // Delays are kept for requests the tracker doesn't know about as well, and
+  // only the most recent ones are.
+  for (int i = 1; i <= 300; ++i) {
+    tracker.IncrementExtensionBlockTime(
+        "1", i, base::TimeDelta::FromMilliseconds(i));
+  }
+  tracker.IncrementExtensionBlockTime("2", 1, kModerateDelay);
+  EXPECT_EQ(200u, tracker.extension_delays_["1"].size());
+
+  scoped_ptr<base::ListValue> delays(tracker.GetExtensionDelaysAsValue());
+  ASSERT_EQ(2u, delays->GetSize());
+
+  const base::DictionaryValue* delay = NULL;
+  std::string id;
+  int count = 0;
+  double p50 = 0;
+  double p99 = 0;
+  ASSERT_TRUE(delays->GetDictionary(0, &delay));
+  EXPECT_TRUE(delay->GetString("id", &id));
+  EXPECT_EQ("1", id);
+  EXPECT_TRUE(delay->GetInteger("count", &count));
+  EXPECT_EQ(200, count);
+  EXPECT_TRUE(delay->GetDouble("p50", &p50));
+  EXPECT_DOUBLE_EQ(200, p50);
+  EXPECT_TRUE(delay->GetDouble("p99", &p99));
+  EXPECT_DOUBLE_EQ(298, p99);
+
+  ASSERT_TRUE(delays->GetDictionary(1, &delay));
+  EXPECT_TRUE(delay->GetString("id", &id));
+  EXPECT_EQ("2", id);
+  EXPECT_TRUE(delay->GetDouble("p99", &p99));
+  EXPECT_DOUBLE_EQ(kModerateDelay.InMillisecondsF(), p99);
+}
@@ -4,6 +4,7 @@
 
 #include "chrome/browser/extensions/event_listener_map.h"
 
+#include "base/json/json_writer.h"
 #include "base/values.h"
 
 #include "chrome/browser/extensions/event_router.h"
@@ -13,6 +14,14 @@ namespace extensions {
 
 typedef EventFilter::MatcherID MatcherID;
 
+namespace {
+
+// The number of filtered events whose matches are remembered. Navigation
+// events come in bursts for the same URL, so the most recent ones are enough.
+const size_t kMaxCachedMatches = 32u;
+
+}  // namespace
+
 EventListener::EventListener(const std::string& event_name,
                              const std::string& extension_id,
                              content::RenderProcessHost* process,
@@ -61,6 +70,7 @@ bool EventListenerMap::AddListener(scoped_ptr<EventListener> listener) {
     listener->matcher_id = id;
     listeners_by_matcher_id_[id] = listener.get();
     filtered_events_.insert(listener->event_name);
+    match_cache_.clear();
   }
   linked_ptr<EventListener> listener_ptr(listener.release());
   listeners_[listener_ptr->event_name].push_back(listener_ptr);
@@ -183,29 +193,53 @@ void EventListenerMap::LoadFilteredLazyListeners(
   }
 }
 
-std::set<const EventListener*> EventListenerMap::GetEventListeners(
-    const Event& event) {
-  std::set<const EventListener*> interested_listeners;
+void EventListenerMap::GetEventListeners(
+    const Event& event,
+    std::vector<const EventListener*>* listeners) {
+  listeners->clear();
   if (IsFilteredEvent(event)) {
-    // Look up the interested listeners via the EventFilter.
-    std::set<MatcherID> ids =
-        event_filter_.MatchEvent(event.event_name, event.filter_info,
-            MSG_ROUTING_NONE);
-    for (std::set<MatcherID>::iterator id = ids.begin(); id != ids.end();
-         id++) {
+    // Look up the interested listeners via the EventFilter, unless the same
+    // event was matched recently.
+    scoped_ptr<base::Value> filter_info(event.filter_info.AsValue());
+    std::string serialized_filter_info;
+    base::JSONWriter::Write(filter_info.get(), &serialized_filter_info);
+    const MatchCache::key_type key(event.event_name, serialized_filter_info);
+    MatchCache::iterator cached = match_cache_.find(key);
+    if (cached == match_cache_.end()) {
+      if (match_cache_.size() >= kMaxCachedMatches)
+        match_cache_.clear();
+      std::set<MatcherID> ids =
+          event_filter_.MatchEvent(event.event_name, event.filter_info,
+              MSG_ROUTING_NONE);
+      cached = match_cache_.insert(std::make_pair(
+          key, std::vector<MatcherID>(ids.begin(), ids.end()))).first;
+    }
+    const std::vector<MatcherID>& ids = cached->second;
+    listeners->reserve(ids.size());
+    for (std::vector<MatcherID>::const_iterator id = ids.begin();
+         id != ids.end(); id++) {
       EventListener* listener = listeners_by_matcher_id_[*id];
       CHECK(listener);
-      interested_listeners.insert(listener);
+      listeners->push_back(listener);
     }
   } else {
-    ListenerList& listeners = listeners_[event.event_name];
-    for (ListenerList::const_iterator it = listeners.begin();
-         it != listeners.end(); it++) {
-      interested_listeners.insert(it->get());
+    // A listener is only added once, so there are no duplicates to remove.
+    ListenerMap::const_iterator it = listeners_.find(event.event_name);
+    if (it == listeners_.end())
+      return;
+    listeners->reserve(it->second.size());
+    for (ListenerList::const_iterator it2 = it->second.begin();
+         it2 != it->second.end(); it2++) {
+      listeners->push_back(it2->get());
     }
   }
+}
 
-  return interested_listeners;
+std::set<const EventListener*> EventListenerMap::GetEventListeners(
+    const Event& event) {
+  std::vector<const EventListener*> listeners;
+  GetEventListeners(event, &listeners);
+  return std::set<const EventListener*>(listeners.begin(), listeners.end());
 }
 
 void EventListenerMap::RemoveListenersForProcess(
@@ -233,6 +267,7 @@ void EventListenerMap::CleanupListener(EventListener* listener) {
     return;
   event_filter_.RemoveEventMatcher(listener->matcher_id);
   CHECK_EQ(1u, listeners_by_matcher_id_.erase(listener->matcher_id));
+  match_cache_.clear();
 }
 
 bool EventListenerMap::IsFilteredEvent(const Event& event) const {
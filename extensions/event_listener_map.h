@@ -8,6 +8,7 @@
 #include <map>
 #include <set>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "base/memory/scoped_ptr.h"
@@ -92,6 +93,13 @@ class EventListenerMap {
   // Returns true if the listener was removed .
   bool RemoveListener(const EventListener* listener);
 
+  // Sets |listeners| to the listeners that want to be notified of |event|,
+  // each of them once. This doesn't build a set of the listeners, and the
+  // listeners of a filtered event are looked up once for each filtering info
+  // (e.g. URL) until the listeners to the event change.
+  void GetEventListeners(const Event& event,
+                         std::vector<const EventListener*>* listeners);
+
   // Returns the set of listeners that want to be notified of |event|.
   std::set<const EventListener*> GetEventListeners(const Event& event);
 
@@ -139,6 +147,11 @@ class EventListenerMap {
   // The key here is an event name.
   typedef std::map<std::string, ListenerList> ListenerMap;
 
+  // The matchers which matched an event, keyed by the event name and its
+  // serialized filtering info.
+  typedef std::map<std::pair<std::string, std::string>,
+                   std::vector<EventFilter::MatcherID> > MatchCache;
+
   void CleanupListener(EventListener* listener);
   bool IsFilteredEvent(const Event& event) const;
   scoped_ptr<EventMatcher> ParseEventMatcher(DictionaryValue* filter_dict);
@@ -153,6 +166,10 @@ class EventListenerMap {
 
   EventFilter event_filter_;
 
+  // The results of |event_filter_| for recent events, cleared whenever a
+  // matcher is added or removed.
+  MatchCache match_cache_;
+
   DISALLOW_COPY_AND_ASSIGN(EventListenerMap);
 };
 
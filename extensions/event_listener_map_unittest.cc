@@ -4,10 +4,15 @@
 
 #include "testing/gtest/include/gtest/gtest.h"
 
+#include <vector>
+
+#include "base/strings/stringprintf.h"
+#include "base/time/time.h"
 #include "chrome/browser/extensions/event_listener_map.h"
 #include "chrome/browser/extensions/event_router.h"
 #include "chrome/test/base/testing_profile.h"
 #include "content/public/test/mock_render_process_host.h"
+#include "testing/perf/perf_test.h"
 
 using base::DictionaryValue;
 using base::ListValue;
@@ -303,6 +308,66 @@ TEST_F(EventListenerMapUnittest, CorruptedExtensionPrefsShouldntCrash) {
   ASSERT_EQ(0u, targets.size());
 }
 
+TEST_F(EventListenerMapUnittest, MatchesReflectAddedAndRemovedListeners) {
+  listeners_->AddListener(scoped_ptr<EventListener>(new EventListener(
+      kEvent1Name, kExt1Id, NULL, CreateHostSuffixFilter("google.com"))));
+
+  scoped_ptr<Event> event(CreateEvent(kEvent1Name,
+                          GURL("http://www.google.com")));
+  std::vector<const EventListener*> targets;
+  listeners_->GetEventListeners(*event, &targets);
+  ASSERT_EQ(1u, targets.size());
+
+  // The same event again, once another listener matches it.
+  scoped_ptr<EventListener> listener(new EventListener(
+      kEvent1Name, kExt2Id, NULL, CreateHostSuffixFilter("google.com")));
+  listeners_->AddListener(listener->Copy());
+  listeners_->GetEventListeners(*event, &targets);
+  ASSERT_EQ(2u, targets.size());
+
+  listeners_->RemoveListener(listener.get());
+  listeners_->GetEventListeners(*event, &targets);
+  ASSERT_EQ(1u, targets.size());
+  EXPECT_EQ(kExt1Id, targets[0]->extension_id);
+}
+
+TEST_F(EventListenerMapUnittest, DispatchCost) {
+  const int kNumListeners = 500;
+  const int kNumDispatches = 1000;
+  for (int i = 0; i < kNumListeners; ++i) {
+    const std::string extension_id = base::StringPrintf("extension_%d", i);
+    listeners_->AddListener(scoped_ptr<EventListener>(new EventListener(
+        kEvent1Name, extension_id, process_.get(),
+        scoped_ptr<DictionaryValue>())));
+    listeners_->AddListener(scoped_ptr<EventListener>(new EventListener(
+        kEvent2Name, extension_id, process_.get(),
+        CreateHostSuffixFilter(base::StringPrintf("site%d.com", i)))));
+  }
+
+  scoped_ptr<Event> unfiltered(CreateNamedEvent(kEvent1Name));
+  scoped_ptr<Event> filtered(CreateEvent(kEvent2Name,
+                             GURL("http://www.site1.com/")));
+  std::vector<const EventListener*> targets;
+
+  base::TimeTicks start = base::TimeTicks::Now();
+  for (int i = 0; i < kNumDispatches; ++i)
+    listeners_->GetEventListeners(*unfiltered, &targets);
+  EXPECT_EQ(static_cast<size_t>(kNumListeners), targets.size());
+  perf_test::PrintResult(
+      "event_dispatch", "", "unfiltered",
+      (base::TimeTicks::Now() - start).InMicrosecondsF() / kNumDispatches,
+      "us", true);
+
+  start = base::TimeTicks::Now();
+  for (int i = 0; i < kNumDispatches; ++i)
+    listeners_->GetEventListeners(*filtered, &targets);
+  EXPECT_EQ(1u, targets.size());
+  perf_test::PrintResult(
+      "event_dispatch", "", "filtered_same_url",
+      (base::TimeTicks::Now() - start).InMicrosecondsF() / kNumDispatches,
+      "us", true);
+}
+
 }  // namespace
 
 }  // namespace extensions
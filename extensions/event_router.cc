@@ -512,8 +512,8 @@ void EventRouter::DispatchEventImpl(const std::string& restrict_to_extension_id,
   DCHECK(!event->restrict_to_profile ||
          profile_->IsSameProfile(event->restrict_to_profile));
 
-  std::set<const EventListener*> listeners(
-      listeners_.GetEventListeners(*event));
+  std::vector<const EventListener*> listeners;
+  listeners_.GetEventListeners(*event, &listeners);
 
   std::set<EventDispatchIdentifier> already_dispatched;
 
@@ -523,7 +523,7 @@ void EventRouter::DispatchEventImpl(const std::string& restrict_to_extension_id,
   // background page, and as that event needs to be delivered before we dispatch
   // the event we are dispatching here, we dispatch to the lazy listeners here
   // first.
-  for (std::set<const EventListener*>::iterator it = listeners.begin();
+  for (std::vector<const EventListener*>::iterator it = listeners.begin();
        it != listeners.end(); it++) {
     const EventListener* listener = *it;
     if (restrict_to_extension_id.empty() ||
@@ -534,7 +534,7 @@ void EventRouter::DispatchEventImpl(const std::string& restrict_to_extension_id,
     }
   }
 
-  for (std::set<const EventListener*>::iterator it = listeners.begin();
+  for (std::vector<const EventListener*>::iterator it = listeners.begin();
        it != listeners.end(); it++) {
     const EventListener* listener = *it;
     if (restrict_to_extension_id.empty() ||
@@ -5,6 +5,7 @@
 #include "chrome/browser/extensions/extension_function_dispatcher.h"
 
 #include "base/bind.h"
+#include "base/debug/trace_event.h"
 #include "base/json/json_string_value_serializer.h"
 #include "base/lazy_instance.h"
 #include "base/logging.h"
@@ -16,6 +17,7 @@
 #include "chrome/browser/extensions/activity_log/activity_log.h"
 #include "chrome/browser/extensions/api/activity_log_private/activity_log_private_api.h"
 #include "chrome/browser/extensions/extension_function_registry.h"
+#include "chrome/browser/extensions/extension_function_stats.h"
 #include "chrome/browser/extensions/extension_service.h"
 #include "chrome/browser/extensions/extension_system.h"
 #include "chrome/browser/extensions/extension_web_ui.h"
@@ -94,6 +96,9 @@ void KillBadMessageSender(base::ProcessHandle process) {
 void CommonResponseCallback(IPC::Sender* ipc_sender,
                             int routing_id,
                             base::ProcessHandle peer_process,
+                            bool incognito,
+                            const std::string& extension_id,
+                            const std::string& function_name,
                             int request_id,
                             ExtensionFunction::ResponseType type,
                             const base::ListValue& results,
@@ -117,14 +122,19 @@ void CommonResponseCallback(IPC::Sender* ipc_sender,
     return;
   }
 
-  ipc_sender->Send(new ExtensionMsg_Response(
+  IPC::Message* response = new ExtensionMsg_Response(
       routing_id, request_id, type == ExtensionFunction::SUCCEEDED, results,
-      error));
+      error);
+  ExtensionFunctionStats::GetInstance()->RecordResponse(
+      incognito, extension_id, function_name, response->size());
+  ipc_sender->Send(response);
 }
 
 void IOThreadResponseCallback(
     const base::WeakPtr<ChromeRenderMessageFilter>& ipc_sender,
     int routing_id,
+    const std::string& extension_id,
+    const std::string& function_name,
     int request_id,
     ExtensionFunction::ResponseType type,
     const base::ListValue& results,
@@ -135,12 +145,35 @@ void IOThreadResponseCallback(
   CommonResponseCallback(ipc_sender.get(),
                          routing_id,
                          ipc_sender->PeerHandle(),
+                         ipc_sender->off_the_record(),
+                         extension_id,
+                         function_name,
                          request_id,
                          type,
                          results,
                          error);
 }
 
+// Runs |function|, and records how long it took along with the time it took
+// to be created and checked against the quota. The stats are keyed by the
+// |extension_id| of the request, as its response is. |extension_id| is copied
+// since running the function may unload the extension.
+void RunFunction(ExtensionFunction* function,
+                 bool incognito,
+                 std::string extension_id,
+                 const std::string& function_name,
+                 base::TimeDelta create_time,
+                 base::TimeDelta quota_time) {
+  TRACE_EVENT2("extensions", "ExtensionFunction::Run",
+               "name", TRACE_STR_COPY(function_name.c_str()),
+               "extension_id", TRACE_STR_COPY(extension_id.c_str()));
+  base::TimeTicks run_start = base::TimeTicks::Now();
+  function->Run();
+  ExtensionFunctionStats::GetInstance()->RecordCall(
+      incognito, extension_id, function_name, create_time, quota_time,
+      base::TimeTicks::Now() - run_start);
+}
+
 }  // namespace
 
 class ExtensionFunctionDispatcher::UIThreadResponseCallbackWrapper
@@ -170,22 +203,32 @@ class ExtensionFunctionDispatcher::UIThreadResponseCallbackWrapper
     content::RenderViewHostObserver::RenderViewHostDestroyed(render_view_host);
   }
 
-  ExtensionFunction::ResponseCallback CreateCallback(int request_id) {
+  ExtensionFunction::ResponseCallback CreateCallback(
+      bool incognito,
+      const std::string& extension_id,
+      const std::string& function_name,
+      int request_id) {
     return base::Bind(
         &UIThreadResponseCallbackWrapper::OnExtensionFunctionCompleted,
         weak_ptr_factory_.GetWeakPtr(),
+        incognito,
+        extension_id,
+        function_name,
         request_id);
   }
 
  private:
-  void OnExtensionFunctionCompleted(int request_id,
+  void OnExtensionFunctionCompleted(bool incognito,
+                                    const std::string& extension_id,
+                                    const std::string& function_name,
+                                    int request_id,
                                     ExtensionFunction::ResponseType type,
                                     const base::ListValue& results,
                                     const std::string& error) {
     CommonResponseCallback(
         render_view_host(), render_view_host()->GetRoutingID(),
-        render_view_host()->GetProcess()->GetHandle(), request_id, type,
-        results, error);
+        render_view_host()->GetProcess()->GetHandle(), incognito,
+        extension_id, function_name, request_id, type, results, error);
   }
 
   base::WeakPtr<ExtensionFunctionDispatcher> dispatcher_;
@@ -239,13 +282,15 @@ void ExtensionFunctionDispatcher::DispatchOnIOThread(
 
   ExtensionFunction::ResponseCallback callback(
       base::Bind(&IOThreadResponseCallback, ipc_sender, routing_id,
-                 params.request_id));
+                 params.extension_id, params.name, params.request_id));
 
+  base::TimeTicks create_start = base::TimeTicks::Now();
   scoped_refptr<ExtensionFunction> function(
       CreateExtensionFunction(params, extension, render_process_id,
                               extension_info_map->process_map(),
                               g_global_io_data.Get().api.get(),
                               profile, callback));
+  base::TimeDelta create_time = base::TimeTicks::Now() - create_start;
   scoped_ptr<ListValue> args(params.arguments.DeepCopy());
 
   if (!function.get())
@@ -266,16 +311,19 @@ void ExtensionFunctionDispatcher::DispatchOnIOThread(
     return;
 
   ExtensionsQuotaService* quota = extension_info_map->GetQuotaService();
+  base::TimeTicks quota_start = base::TimeTicks::Now();
   std::string violation_error = quota->Assess(extension->id(),
                                               function.get(),
                                               &params.arguments,
-                                              base::TimeTicks::Now());
+                                              quota_start);
+  base::TimeDelta quota_time = base::TimeTicks::Now() - quota_start;
   if (violation_error.empty()) {
     LogSuccess(extension->id(),
                params.name,
                args.Pass(),
                profile_cast);
-    function->Run();
+    RunFunction(function.get(), ipc_sender->off_the_record(),
+                params.extension_id, params.name, create_time, quota_time);
   } else {
     function->OnQuotaExceeded(violation_error);
   }
@@ -305,7 +353,9 @@ void ExtensionFunctionDispatcher::Dispatch(
   }
 
   DispatchWithCallback(params, render_view_host,
-                       callback_wrapper->CreateCallback(params.request_id));
+                       callback_wrapper->CreateCallback(
+                           profile()->IsOffTheRecord(), params.extension_id,
+                           params.name, params.request_id));
 }
 
 void ExtensionFunctionDispatcher::DispatchWithCallback(
@@ -326,12 +376,14 @@ void ExtensionFunctionDispatcher::DispatchWithCallback(
   if (!extension)
     extension = service->extensions()->GetHostedAppByURL(params.source_url);
 
+  base::TimeTicks create_start = base::TimeTicks::Now();
   scoped_refptr<ExtensionFunction> function(
       CreateExtensionFunction(params, extension,
                               render_view_host->GetProcess()->GetID(),
                               *(service->process_map()),
                               extensions::ExtensionAPI::GetSharedInstance(),
                               profile(), callback));
+  base::TimeDelta create_time = base::TimeTicks::Now() - create_start;
   scoped_ptr<ListValue> args(params.arguments.DeepCopy());
 
   if (!function.get())
@@ -352,15 +404,18 @@ void ExtensionFunctionDispatcher::DispatchWithCallback(
     return;
 
   ExtensionsQuotaService* quota = service->quota_service();
+  base::TimeTicks quota_start = base::TimeTicks::Now();
   std::string violation_error = quota->Assess(extension->id(),
                                               function.get(),
                                               &params.arguments,
-                                              base::TimeTicks::Now());
+                                              quota_start);
+  base::TimeDelta quota_time = base::TimeTicks::Now() - quota_start;
   if (violation_error.empty()) {
     // See crbug.com/39178.
     ExternalProtocolHandler::PermitLaunchUrl();
     LogSuccess(extension->id(), params.name, args.Pass(), profile());
-    function->Run();
+    RunFunction(function.get(), profile()->IsOffTheRecord(),
+                params.extension_id, params.name, create_time, quota_time);
   } else {
     function->OnQuotaExceeded(violation_error);
   }
@@ -0,0 +1,68 @@
+// Copyright 2013 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "chrome/browser/extensions/extension_function_stats.h"
+
+#include "base/memory/singleton.h"
+#include "base/values.h"
+
+ExtensionFunctionStats::Stats::Stats() : calls(0), responses(0),
+                                         response_bytes(0) {}
+
+// static
+ExtensionFunctionStats* ExtensionFunctionStats::GetInstance() {
+  return Singleton<ExtensionFunctionStats>::get();
+}
+
+void ExtensionFunctionStats::RecordCall(bool incognito,
+                                        const std::string& extension_id,
+                                        const std::string& function_name,
+                                        base::TimeDelta create_time,
+                                        base::TimeDelta quota_time,
+                                        base::TimeDelta run_time) {
+  base::AutoLock auto_lock(lock_);
+  StatsMap& stats_map = incognito ? incognito_stats_ : stats_;
+  Stats& stats = stats_map[std::make_pair(extension_id, function_name)];
+  ++stats.calls;
+  stats.create_time += create_time;
+  stats.quota_time += quota_time;
+  stats.run_time += run_time;
+}
+
+void ExtensionFunctionStats::RecordResponse(bool incognito,
+                                            const std::string& extension_id,
+                                            const std::string& function_name,
+                                            size_t response_size) {
+  base::AutoLock auto_lock(lock_);
+  StatsMap& stats_map = incognito ? incognito_stats_ : stats_;
+  Stats& stats = stats_map[std::make_pair(extension_id, function_name)];
+  ++stats.responses;
+  stats.response_bytes += response_size;
+}
+
+base::ListValue* ExtensionFunctionStats::GetStatsAsValue(
+    bool incognito) const {
+  base::ListValue* list = new base::ListValue();
+  base::AutoLock auto_lock(lock_);
+  const StatsMap& stats_map = incognito ? incognito_stats_ : stats_;
+  for (StatsMap::const_iterator it = stats_map.begin(); it != stats_map.end();
+       ++it) {
+    const Stats& stats = it->second;
+    base::DictionaryValue* dict = new base::DictionaryValue();
+    dict->SetString("id", it->first.first);
+    dict->SetString("function", it->first.second);
+    dict->SetInteger("calls", stats.calls);
+    dict->SetDouble("createTime", stats.create_time.InMillisecondsF());
+    dict->SetDouble("quotaTime", stats.quota_time.InMillisecondsF());
+    dict->SetDouble("runTime", stats.run_time.InMillisecondsF());
+    dict->SetInteger("responses", stats.responses);
+    dict->SetDouble("responseBytes", static_cast<double>(stats.response_bytes));
+    list->Append(dict);
+  }
+  return list;
+}
+
+ExtensionFunctionStats::ExtensionFunctionStats() {}
+
+ExtensionFunctionStats::~ExtensionFunctionStats() {}
@@ -0,0 +1,87 @@
+// Copyright 2013 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CHROME_BROWSER_EXTENSIONS_EXTENSION_FUNCTION_STATS_H_
+#define CHROME_BROWSER_EXTENSIONS_EXTENSION_FUNCTION_STATS_H_
+
+#include <map>
+#include <string>
+#include <utility>
+
+#include "base/basictypes.h"
+#include "base/gtest_prod_util.h"
+#include "base/synchronization/lock.h"
+#include "base/time/time.h"
+
+template <typename T> struct DefaultSingletonTraits;
+
+namespace base {
+class ListValue;
+}
+
+// Records how long the calls to each extension function take to be created
+// (which includes copying their arguments), to be checked against the quota
+// and to run on the thread they were dispatched to, and how large their
+// responses are, split by extension. The calls made from incognito profiles
+// are kept apart, so that a regular chrome://extensions-internals/ page does
+// not show them. Functions are dispatched on both the UI and the IO thread,
+// so the stats may be used on any thread.
+class ExtensionFunctionStats {
+ public:
+  static ExtensionFunctionStats* GetInstance();
+
+  // Records a call of |function_name| by |extension_id|, made from an
+  // incognito profile if |incognito|. |run_time| only covers the synchronous
+  // part of the function.
+  void RecordCall(bool incognito,
+                  const std::string& extension_id,
+                  const std::string& function_name,
+                  base::TimeDelta create_time,
+                  base::TimeDelta quota_time,
+                  base::TimeDelta run_time);
+
+  // Records a response of |response_size| bytes to a call of |function_name|
+  // by |extension_id|, made from an incognito profile if |incognito|.
+  void RecordResponse(bool incognito,
+                      const std::string& extension_id,
+                      const std::string& function_name,
+                      size_t response_size);
+
+  // Returns a list with a dictionary for each function called by each
+  // extension from incognito profiles if |incognito|, or from regular
+  // profiles otherwise, with the number of calls, the total time in
+  // milliseconds of each step and the total size of the responses. The caller
+  // takes ownership.
+  base::ListValue* GetStatsAsValue(bool incognito) const;
+
+ private:
+  friend struct DefaultSingletonTraits<ExtensionFunctionStats>;
+  FRIEND_TEST_ALL_PREFIXES(ExtensionFunctionStatsTest, RecordsPerExtension);
+  FRIEND_TEST_ALL_PREFIXES(ExtensionFunctionStatsTest, KeepsIncognitoApart);
+
+  struct Stats {
+    Stats();
+
+    int calls;
+    base::TimeDelta create_time;
+    base::TimeDelta quota_time;
+    base::TimeDelta run_time;
+    int responses;
+    int64 response_bytes;
+  };
+
+  // Maps an extension ID and a function name to the stats of the calls.
+  typedef std::map<std::pair<std::string, std::string>, Stats> StatsMap;
+
+  ExtensionFunctionStats();
+  ~ExtensionFunctionStats();
+
+  mutable base::Lock lock_;
+  StatsMap stats_;
+  StatsMap incognito_stats_;
+
+  DISALLOW_COPY_AND_ASSIGN(ExtensionFunctionStats);
+};
+
+#endif  // CHROME_BROWSER_EXTENSIONS_EXTENSION_FUNCTION_STATS_H_
@@ -0,0 +1,78 @@
+// Copyright 2013 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "chrome/browser/extensions/extension_function_stats.h"
+
+#include "base/memory/scoped_ptr.h"
+#include "base/values.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+TEST(ExtensionFunctionStatsTest, RecordsPerExtension) {
+  ExtensionFunctionStats stats;
+  const base::TimeDelta kMillisecond = base::TimeDelta::FromMilliseconds(1);
+  stats.RecordCall(false, "a", "tabs.query", kMillisecond, kMillisecond,
+                   kMillisecond * 2);
+  stats.RecordCall(false, "a", "tabs.query", kMillisecond, kMillisecond,
+                   kMillisecond * 3);
+  stats.RecordResponse(false, "a", "tabs.query", 100);
+  stats.RecordCall(false, "b", "tabs.query", kMillisecond, kMillisecond,
+                   kMillisecond);
+
+  scoped_ptr<base::ListValue> list(stats.GetStatsAsValue(false));
+  ASSERT_EQ(2u, list->GetSize());
+
+  base::DictionaryValue* dict = NULL;
+  ASSERT_TRUE(list->GetDictionary(0, &dict));
+  std::string id;
+  EXPECT_TRUE(dict->GetString("id", &id));
+  EXPECT_EQ("a", id);
+  int calls = 0;
+  EXPECT_TRUE(dict->GetInteger("calls", &calls));
+  EXPECT_EQ(2, calls);
+  double run_time = 0;
+  EXPECT_TRUE(dict->GetDouble("runTime", &run_time));
+  EXPECT_DOUBLE_EQ(5, run_time);
+  double response_bytes = 0;
+  EXPECT_TRUE(dict->GetDouble("responseBytes", &response_bytes));
+  EXPECT_DOUBLE_EQ(100, response_bytes);
+
+  ASSERT_TRUE(list->GetDictionary(1, &dict));
+  EXPECT_TRUE(dict->GetString("id", &id));
+  EXPECT_EQ("b", id);
+  int responses = -1;
+  EXPECT_TRUE(dict->GetInteger("responses", &responses));
+  EXPECT_EQ(0, responses);
+}
+
+TEST(ExtensionFunctionStatsTest, KeepsIncognitoApart) {
+  ExtensionFunctionStats stats;
+  const base::TimeDelta kMillisecond = base::TimeDelta::FromMilliseconds(1);
+  stats.RecordCall(false, "a", "tabs.query", kMillisecond, kMillisecond,
+                   kMillisecond);
+  stats.RecordCall(true, "a", "tabs.query", kMillisecond, kMillisecond,
+                   kMillisecond);
+  stats.RecordResponse(true, "a", "tabs.query", 100);
+  stats.RecordCall(true, "b", "tabs.query", kMillisecond, kMillisecond,
+                   kMillisecond);
+
+  scoped_ptr<base::ListValue> list(stats.GetStatsAsValue(false));
+  ASSERT_EQ(1u, list->GetSize());
+  base::DictionaryValue* dict = NULL;
+  ASSERT_TRUE(list->GetDictionary(0, &dict));
+  int calls = 0;
+  EXPECT_TRUE(dict->GetInteger("calls", &calls));
+  EXPECT_EQ(1, calls);
+  int responses = -1;
+  EXPECT_TRUE(dict->GetInteger("responses", &responses));
+  EXPECT_EQ(0, responses);
+
+  list.reset(stats.GetStatsAsValue(true));
+  ASSERT_EQ(2u, list->GetSize());
+  ASSERT_TRUE(list->GetDictionary(0, &dict));
+  std::string id;
+  EXPECT_TRUE(dict->GetString("id", &id));
+  EXPECT_EQ("a", id);
+  EXPECT_TRUE(dict->GetInteger("responses", &responses));
+  EXPECT_EQ(1, responses);
+}
@@ -420,9 +420,22 @@ void ExtensionPrefs::UpdateExtensionPref(const std::string& extension_id,
     NOTREACHED() << "Invalid extension_id " << extension_id;
     return;
   }
+  // Don't touch the extension's dictionary if the value doesn't change: every
+  // update notifies the observers of all extension prefs and schedules a write
+  // of the whole Preferences file.
+  scoped_ptr<Value> value(data_value);
+  const DictionaryValue* extension = GetExtensionPref(extension_id);
+  const Value* old_value = NULL;
+  if (extension)
+    extension->Get(key, &old_value);
+  bool unchanged = value ? old_value && old_value->Equals(value.get()) :
+                           !old_value;
+  if (unchanged)
+    return;
+
   ScopedExtensionPrefUpdate update(prefs_, extension_id);
-  if (data_value)
-    update->Set(key, data_value);
+  if (value)
+    update->Set(key, value.release());
   else
     update->Remove(key, NULL);
 }
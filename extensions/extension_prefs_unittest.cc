@@ -19,6 +19,7 @@
 #include "chrome/browser/prefs/scoped_user_pref_update.h"
 #include "chrome/common/chrome_paths.h"
 #include "chrome/common/extensions/permissions/permission_set.h"
+#include "chrome/common/pref_names.h"
 #include "components/user_prefs/pref_registry_syncable.h"
 #include "content/public/browser/notification_details.h"
 #include "content/public/browser/notification_source.h"
@@ -30,6 +31,7 @@
 using base::Time;
 using base::TimeDelta;
 using content::BrowserThread;
+using testing::_;
 
 namespace extensions {
 
@@ -372,6 +374,37 @@ class ExtensionPrefsVersionString : public ExtensionPrefsTest {
 };
 TEST_F(ExtensionPrefsVersionString, VersionString) {}
 
+// Tests that updates which don't change an extension pref don't notify the
+// observers of the extension prefs.
+class ExtensionPrefsUnchangedUpdate : public ExtensionPrefsTest {
+ public:
+  virtual void Initialize() OVERRIDE {
+    extension_id_ = prefs_.AddExtensionAndReturnId("unchanged_update");
+    MockPrefChangeCallback observer(prefs_.pref_service());
+    PrefChangeRegistrar registrar;
+    registrar.Init(prefs_.pref_service());
+    registrar.Add(prefs::kExtensionsPref, observer.GetCallback());
+
+    EXPECT_CALL(observer, OnPreferenceChanged(_)).Times(2);
+    prefs()->UpdateExtensionPref(extension_id_, "key",
+                                 Value::CreateStringValue("value"));
+    prefs()->UpdateExtensionPref(extension_id_, "key",
+                                 Value::CreateStringValue("value"));
+    prefs()->UpdateExtensionPref(extension_id_, "key", NULL);
+    prefs()->UpdateExtensionPref(extension_id_, "key", NULL);
+    testing::Mock::VerifyAndClearExpectations(&observer);
+  }
+
+  virtual void Verify() OVERRIDE {
+    std::string value;
+    EXPECT_FALSE(prefs()->ReadPrefAsString(extension_id_, "key", &value));
+  }
+
+ private:
+  std::string extension_id_;
+};
+TEST_F(ExtensionPrefsUnchangedUpdate, UnchangedUpdate) {}
+
 class ExtensionPrefsAcknowledgment : public ExtensionPrefsTest {
  public:
   virtual void Initialize() OVERRIDE {
@@ -4,6 +4,8 @@
 
 #include "chrome/browser/extensions/extension_process_manager.h"
 
+#include <algorithm>
+
 #include "base/bind.h"
 #include "base/command_line.h"
 #include "base/lazy_instance.h"
@@ -66,6 +68,10 @@ std::string GetExtensionID(RenderViewHost* render_view_host) {
   return render_view_host->GetSiteInstance()->GetSiteURL().host();
 }
 
+// The longest an idle event page is kept alive when it keeps being woken up
+// soon after being suspended.
+const int kMaxEventPageIdleTimeSeconds = 120;
+
 void OnRenderViewHostUnregistered(Profile* profile,
                                   RenderViewHost* render_view_host) {
   content::NotificationService::current()->Notify(
@@ -128,8 +134,19 @@ struct ExtensionProcessManager::BackgroundPageData {
   // Keeps track of when this page was last suspended. Used for perf metrics.
   linked_ptr<base::ElapsedTimer> since_suspended;
 
+  // How long the page has to stay idle before it is suspended, or zero to use
+  // the default. Grows while the page keeps being woken up again shortly after
+  // being suspended, since the new wakeup costs more than keeping it alive.
+  base::TimeDelta idle_time;
+
+  // The number of times the lazy background page was loaded.
+  int wakeups;
+
   BackgroundPageData()
-      : lazy_keepalive_count(0), close_sequence_id(0), is_closing(false) {}
+      : lazy_keepalive_count(0),
+        close_sequence_id(0),
+        is_closing(false),
+        wakeups(0) {}
 };
 
 //
@@ -177,10 +194,12 @@ ExtensionProcessManager::ExtensionProcessManager(Profile* profile)
   }
 
   event_page_idle_time_ = base::TimeDelta::FromSeconds(10);
+  adapt_event_page_idle_time_ = true;
   unsigned idle_time_sec = 0;
   if (base::StringToUint(CommandLine::ForCurrentProcess()->GetSwitchValueASCII(
           switches::kEventPageIdleTime), &idle_time_sec)) {
     event_page_idle_time_ = base::TimeDelta::FromSeconds(idle_time_sec);
+    adapt_event_page_idle_time_ = false;
   }
   event_page_suspending_time_ = base::TimeDelta::FromSeconds(5);
   unsigned suspending_time_sec = 0;
@@ -434,20 +453,22 @@ int ExtensionProcessManager::DecrementLazyKeepaliveCount(
   if (!BackgroundInfo::HasLazyBackgroundPage(extension))
     return 0;
 
-  int& count = background_page_data_[extension->id()].lazy_keepalive_count;
+  BackgroundPageData& data = background_page_data_[extension->id()];
+  int& count = data.lazy_keepalive_count;
   DCHECK_GT(count, 0);
 
   // If we reach a zero keepalive count when the lazy background page is about
   // to be closed, incrementing close_sequence_id will cancel the close
   // sequence and cause the background page to linger. So check is_closing
   // before initiating another close sequence.
-  if (--count == 0 && !background_page_data_[extension->id()].is_closing) {
+  if (--count == 0 && !data.is_closing) {
     base::MessageLoop::current()->PostDelayedTask(
         FROM_HERE,
         base::Bind(&ExtensionProcessManager::OnLazyBackgroundPageIdle,
                    weak_ptr_factory_.GetWeakPtr(), extension->id(),
-                   ++background_page_data_[extension->id()].close_sequence_id),
-        event_page_idle_time_);
+                   ++data.close_sequence_id),
+        data.idle_time == base::TimeDelta() ? event_page_idle_time_ :
+                                              data.idle_time);
   }
 
   return count;
@@ -624,9 +645,15 @@ void ExtensionProcessManager::Observe(
     case chrome::NOTIFICATION_EXTENSION_HOST_DESTROYED: {
       ExtensionHost* host = content::Details<ExtensionHost>(details).ptr();
       if (background_hosts_.erase(host)) {
-        ClearBackgroundPageData(host->extension()->id());
-        background_page_data_[host->extension()->id()].since_suspended.reset(
-            new base::ElapsedTimer());
+        // Keep the wakeup history of the page across its suspension.
+        const std::string& id = host->extension()->id();
+        base::TimeDelta idle_time = background_page_data_[id].idle_time;
+        int wakeups = background_page_data_[id].wakeups;
+        ClearBackgroundPageData(id);
+        BackgroundPageData& data = background_page_data_[id];
+        data.since_suspended.reset(new base::ElapsedTimer());
+        data.idle_time = idle_time;
+        data.wakeups = wakeups;
       }
       break;
     }
@@ -754,17 +781,57 @@ void ExtensionProcessManager::OnExtensionHostCreated(ExtensionHost* host,
     background_hosts_.insert(host);
 
     if (BackgroundInfo::HasLazyBackgroundPage(host->extension())) {
+      BackgroundPageData& data = background_page_data_[host->extension()->id()];
+      ++data.wakeups;
       linked_ptr<base::ElapsedTimer> since_suspended(
-          background_page_data_[host->extension()->id()].
-              since_suspended.release());
+          data.since_suspended.release());
       if (since_suspended.get()) {
         UMA_HISTOGRAM_LONG_TIMES("Extensions.EventPageIdleTime",
                                  since_suspended->Elapsed());
+        if (adapt_event_page_idle_time_)
+          AdaptEventPageIdleTime(&data, since_suspended->Elapsed());
       }
     }
   }
 }
 
+void ExtensionProcessManager::AdaptEventPageIdleTime(
+    BackgroundPageData* data,
+    base::TimeDelta time_suspended) {
+  const base::TimeDelta current_idle_time =
+      data->idle_time == base::TimeDelta() ? event_page_idle_time_ :
+                                             data->idle_time;
+  const base::TimeDelta idle_time = GetAdaptedEventPageIdleTime(
+      current_idle_time, event_page_idle_time_, time_suspended);
+  if (idle_time == current_idle_time)
+    return;
+  data->idle_time = idle_time;
+  UMA_HISTOGRAM_CUSTOM_TIMES(
+      "Extensions.EventPageAdaptedIdleTime", idle_time,
+      base::TimeDelta::FromSeconds(1),
+      base::TimeDelta::FromSeconds(kMaxEventPageIdleTimeSeconds), 50);
+}
+
+// static
+base::TimeDelta ExtensionProcessManager::GetAdaptedEventPageIdleTime(
+    base::TimeDelta idle_time,
+    base::TimeDelta default_idle_time,
+    base::TimeDelta time_suspended) {
+  const base::TimeDelta max_idle_time =
+      base::TimeDelta::FromSeconds(kMaxEventPageIdleTimeSeconds);
+  if (time_suspended < idle_time) {
+    // The page was suspended for less time than it was kept alive for, so
+    // waiting longer would have saved this wakeup.
+    return std::min(idle_time * 2, max_idle_time);
+  }
+  if (time_suspended > max_idle_time) {
+    // The events have become rare enough that the page is best suspended
+    // quickly again.
+    return default_idle_time;
+  }
+  return idle_time;
+}
+
 void ExtensionProcessManager::CloseBackgroundHost(ExtensionHost* host) {
   CHECK(host->extension_host_type() ==
         extensions::VIEW_TYPE_EXTENSION_BACKGROUND_PAGE);
@@ -799,7 +866,15 @@ void ExtensionProcessManager::UnregisterExtension(
     }
   }
 
-  background_page_data_.erase(extension_id);
+  BackgroundPageDataMap::iterator data =
+      background_page_data_.find(extension_id);
+  if (data != background_page_data_.end()) {
+    if (data->second.wakeups > 0) {
+      UMA_HISTOGRAM_COUNTS_10000("Extensions.EventPageWakeups",
+                                 data->second.wakeups);
+    }
+    background_page_data_.erase(data);
+  }
 }
 
 void ExtensionProcessManager::ClearBackgroundPageData(
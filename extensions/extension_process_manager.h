@@ -11,6 +11,7 @@
 
 #include "base/callback.h"
 #include "base/compiler_specific.h"
+#include "base/gtest_prod_util.h"
 #include "base/memory/ref_counted.h"
 #include "base/memory/weak_ptr.h"
 #include "base/time/time.h"
@@ -174,6 +175,9 @@ class ExtensionProcessManager : public content::NotificationObserver {
   scoped_refptr<content::SiteInstance> site_instance_;
 
  private:
+  FRIEND_TEST_ALL_PREFIXES(ExtensionProcessManagerTest,
+                           AdaptsEventPageIdleTime);
+
   // Extra information we keep for each extension's background page.
   struct BackgroundPageData;
   typedef std::string ExtensionId;
@@ -196,6 +200,20 @@ class ExtensionProcessManager : public content::NotificationObserver {
   void CloseLazyBackgroundPageNow(const std::string& extension_id,
                                   int sequence_id);
 
+  // Lengthens the idle time of a lazy background page which was woken up
+  // again sooner than it had been kept alive for, and resets it once the page
+  // has been suspended for a long time.
+  void AdaptEventPageIdleTime(BackgroundPageData* data,
+                              base::TimeDelta time_suspended);
+
+  // Returns the idle time of a lazy background page which was kept alive for
+  // |idle_time| and then suspended for |time_suspended| before it was woken up
+  // again. |default_idle_time| is the idle time pages start with.
+  static base::TimeDelta GetAdaptedEventPageIdleTime(
+      base::TimeDelta idle_time,
+      base::TimeDelta default_idle_time,
+      base::TimeDelta time_suspended);
+
   // Potentially registers a RenderViewHost, if it is associated with an
   // extension. Does nothing if this is not an extension renderer.
   void RegisterRenderViewHost(content::RenderViewHost* render_view_host);
@@ -226,6 +244,10 @@ class ExtensionProcessManager : public content::NotificationObserver {
   // sending a ShouldSuspend message; read from command-line switch.
   base::TimeDelta event_page_idle_time_;
 
+  // True if the idle time of each lazy background page is adapted to how soon
+  // it is woken up again; false if the idle time is set on the command line.
+  bool adapt_event_page_idle_time_;
+
   // The time to delay between sending a ShouldSuspend message and
   // sending a Suspend message; read from command-line switch.
   base::TimeDelta event_page_suspending_time_;
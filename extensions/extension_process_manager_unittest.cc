@@ -62,3 +62,38 @@ TEST_F(ExtensionProcessManagerTest, ProcessGrouping) {
       manager2->GetSiteInstanceForURL(ext1_url1);
   EXPECT_NE(site11, other_profile_site);
 }
+
+// Test that the idle time of an event page grows while the page keeps being
+// woken up soon after being suspended, and drops back once it isn't.
+TEST_F(ExtensionProcessManagerTest, AdaptsEventPageIdleTime) {
+  const base::TimeDelta default_idle_time = base::TimeDelta::FromSeconds(10);
+  const base::TimeDelta max_idle_time = base::TimeDelta::FromSeconds(120);
+
+  // Woken up sooner than it was kept alive for: the idle time doubles.
+  base::TimeDelta idle_time = default_idle_time;
+  idle_time = ExtensionProcessManager::GetAdaptedEventPageIdleTime(
+      idle_time, default_idle_time, base::TimeDelta::FromSeconds(1));
+  EXPECT_EQ(base::TimeDelta::FromSeconds(20), idle_time);
+  idle_time = ExtensionProcessManager::GetAdaptedEventPageIdleTime(
+      idle_time, default_idle_time, base::TimeDelta::FromSeconds(15));
+  EXPECT_EQ(base::TimeDelta::FromSeconds(40), idle_time);
+
+  // It doesn't grow beyond the maximum.
+  for (int i = 0; i < 5; ++i) {
+    idle_time = ExtensionProcessManager::GetAdaptedEventPageIdleTime(
+        idle_time, default_idle_time, base::TimeDelta::FromSeconds(1));
+  }
+  EXPECT_EQ(max_idle_time, idle_time);
+
+  // Suspended for longer than it was kept alive for, but not for long: no
+  // change.
+  idle_time = ExtensionProcessManager::GetAdaptedEventPageIdleTime(
+      base::TimeDelta::FromSeconds(20), default_idle_time,
+      base::TimeDelta::FromSeconds(60));
+  EXPECT_EQ(base::TimeDelta::FromSeconds(20), idle_time);
+
+  // Suspended for longer than the maximum: back to the default.
+  idle_time = ExtensionProcessManager::GetAdaptedEventPageIdleTime(
+      max_idle_time, default_idle_time, base::TimeDelta::FromMinutes(5));
+  EXPECT_EQ(default_idle_time, idle_time);
+}
@@ -60,6 +60,7 @@
 #include "chrome/browser/extensions/unpacked_installer.h"
 #include "chrome/browser/extensions/update_observer.h"
 #include "chrome/browser/extensions/updater/extension_updater.h"
+#include "chrome/browser/performance_monitor/startup_tracer.h"
 #include "chrome/browser/profiles/profile.h"
 #include "chrome/browser/profiles/profile_manager.h"
 #include "chrome/browser/sync/sync_prefs.h"
@@ -546,6 +547,8 @@ const Extension* ExtensionService::GetExtensionById(
 
 void ExtensionService::Init() {
   CHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
+  performance_monitor::ScopedStartupPhase startup_phase(
+      "ExtensionService::Init");
 
   DCHECK(!is_ready());  // Can't redo init.
   DCHECK_EQ(extensions_.size(), 0u);
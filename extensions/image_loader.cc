@@ -9,15 +9,20 @@
 
 #include "base/callback.h"
 #include "base/compiler_specific.h"
+#include "base/containers/mru_cache.h"
 #include "base/file_util.h"
 #include "base/lazy_instance.h"
+#include "base/metrics/histogram.h"
 #include "base/path_service.h"
 #include "base/strings/string_number_conversions.h"
 #include "base/threading/sequenced_worker_pool.h"
+#include "chrome/browser/chrome_notification_types.h"
 #include "chrome/browser/extensions/image_loader_factory.h"
 #include "chrome/common/chrome_paths.h"
 #include "chrome/common/extensions/extension.h"
 #include "content/public/browser/browser_thread.h"
+#include "content/public/browser/notification_details.h"
+#include "content/public/browser/notification_service.h"
 #include "grit/chrome_unscaled_resources.h"
 #include "grit/component_extension_resources_map.h"
 #include "grit/theme_resources.h"
@@ -37,6 +42,9 @@ using extensions::Manifest;
 
 namespace {
 
+// The most memory the cache of loaded images may use.
+const size_t kMaxImageCacheBytes = 8 * 1024 * 1024;
+
 bool ShouldResizeImageRepresentation(
     ImageLoader::ImageRepresentation::ResizeCondition resize_method,
     const gfx::Size& decoded_size,
@@ -162,11 +170,109 @@ ImageLoader::LoadResult::LoadResult(
 ImageLoader::LoadResult::~LoadResult() {
 }
 
+////////////////////////////////////////////////////////////////////////////////
+// ImageLoader::ImageCache
+
+// The bitmaps loaded for image representations, least recently used first
+// out once they take up more than kMaxImageCacheBytes. Only used on the UI
+// thread.
+class ImageLoader::ImageCache {
+ public:
+  ImageCache() : cache_(Cache::NO_AUTO_EVICT), bytes_(0) {}
+
+  // Sets |bitmap| to the bitmap cached for |image_info|. Returns false if
+  // there is none.
+  bool Get(const ImageRepresentation& image_info, SkBitmap* bitmap) {
+    Cache::iterator it = cache_.Get(Key(image_info));
+    const bool hit = it != cache_.end();
+    UMA_HISTOGRAM_BOOLEAN("Extensions.ImageLoaderCacheHit", hit);
+    if (hit)
+      *bitmap = it->second;
+    return hit;
+  }
+
+  void Put(const ImageRepresentation& image_info, const SkBitmap& bitmap) {
+    const Key key(image_info);
+    Cache::iterator it = cache_.Peek(key);
+    if (it != cache_.end())
+      Erase(it);
+    cache_.Put(key, bitmap);
+    bytes_ += bitmap.getSize();
+    while (bytes_ > kMaxImageCacheBytes)
+      Erase(--cache_.end());
+  }
+
+  // Drops the images of the extension at |extension_root|.
+  void RemoveExtension(const base::FilePath& extension_root) {
+    for (Cache::iterator it = cache_.begin(); it != cache_.end();) {
+      if (it->first.extension_root == extension_root)
+        it = Erase(it);
+      else
+        ++it;
+    }
+  }
+
+  void Clear() {
+    cache_.Clear();
+    bytes_ = 0;
+  }
+
+ private:
+  struct Key {
+    explicit Key(const ImageRepresentation& image_info)
+        : extension_root(image_info.resource.extension_root()),
+          relative_path(image_info.resource.relative_path()),
+          resize_condition(image_info.resize_condition),
+          width(image_info.desired_size.width()),
+          height(image_info.desired_size.height()),
+          scale_factor(image_info.scale_factor) {}
+
+    bool operator<(const Key& other) const {
+      if (extension_root != other.extension_root)
+        return extension_root < other.extension_root;
+      if (relative_path != other.relative_path)
+        return relative_path < other.relative_path;
+      if (resize_condition != other.resize_condition)
+        return resize_condition < other.resize_condition;
+      if (width != other.width)
+        return width < other.width;
+      if (height != other.height)
+        return height < other.height;
+      return scale_factor < other.scale_factor;
+    }
+
+    base::FilePath extension_root;
+    base::FilePath relative_path;
+    ImageRepresentation::ResizeCondition resize_condition;
+    int width;
+    int height;
+    ui::ScaleFactor scale_factor;
+  };
+  typedef base::MRUCache<Key, SkBitmap> Cache;
+
+  Cache::iterator Erase(Cache::iterator it) {
+    bytes_ -= it->second.getSize();
+    return cache_.Erase(it);
+  }
+
+  Cache cache_;
+
+  // The memory used by the bitmaps in |cache_|.
+  size_t bytes_;
+
+  DISALLOW_COPY_AND_ASSIGN(ImageCache);
+};
+
 ////////////////////////////////////////////////////////////////////////////////
 // ImageLoader
 
 ImageLoader::ImageLoader()
-    : weak_ptr_factory_(this) {
+    : weak_ptr_factory_(this),
+      cache_(new ImageCache()) {
+  registrar_.Add(this, chrome::NOTIFICATION_EXTENSION_UNLOADED,
+                 content::NotificationService::AllSources());
+  memory_pressure_listener_.reset(new base::MemoryPressureListener(
+      base::Bind(&ImageLoader::OnMemoryPressure, base::Unretained(this))));
 }
 
 ImageLoader::~ImageLoader() {
@@ -265,12 +371,19 @@ void ImageLoader::LoadImagesAsync(
   std::vector<SkBitmap> bitmaps;
   bitmaps.resize(info_list.size());
 
+  bool all_cached = true;
   int i = 0;
   for (std::vector<ImageRepresentation>::const_iterator it = info_list.begin();
        it != info_list.end(); ++it, ++i) {
     DCHECK(it->resource.relative_path().empty() ||
            extension->path() == it->resource.extension_root());
 
+    if (it->resource.relative_path().empty() ||
+        cache_->Get(*it, &bitmaps[i])) {
+      continue;
+    }
+    all_cached = false;
+
     int resource_id;
     if (extension->location() == Manifest::COMPONENT &&
         IsComponentExtensionResource(extension->path(),
@@ -280,6 +393,21 @@ void ImageLoader::LoadImagesAsync(
     }
   }
 
+  if (all_cached) {
+    std::vector<LoadResult> load_result;
+    for (size_t j = 0; j < info_list.size(); ++j) {
+      if (bitmaps[j].isNull())
+        continue;
+      load_result.push_back(LoadResult(
+          bitmaps[j], gfx::Size(bitmaps[j].width(), bitmaps[j].height()),
+          info_list[j]));
+    }
+    if (!load_result.empty()) {
+      RunCallback(load_result, callback);
+      return;
+    }
+  }
+
   DCHECK(!BrowserThread::GetBlockingPool()->RunsTasksOnCurrentThread());
   std::vector<LoadResult>* load_result = new std::vector<LoadResult>;
   BrowserThread::PostBlockingPoolTaskAndReply(
@@ -326,10 +454,37 @@ void ImageLoader::ReplyBack(
     const base::Callback<void(const gfx::Image&)>& callback) {
   DCHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
 
-  gfx::ImageSkia image_skia;
-
   for (std::vector<LoadResult>::const_iterator it = load_result->begin();
        it != load_result->end(); ++it) {
+    cache_->Put(it->image_representation, it->bitmap);
+  }
+  RunCallback(*load_result, callback);
+}
+
+void ImageLoader::Observe(int type,
+                          const content::NotificationSource& source,
+                          const content::NotificationDetails& details) {
+  DCHECK_EQ(chrome::NOTIFICATION_EXTENSION_UNLOADED, type);
+  // An unpacked extension can be reloaded from the same path with different
+  // images.
+  const Extension* extension =
+      content::Details<UnloadedExtensionInfo>(details)->extension;
+  cache_->RemoveExtension(extension->path());
+}
+
+void ImageLoader::OnMemoryPressure(
+    base::MemoryPressureListener::MemoryPressureLevel memory_pressure_level) {
+  cache_->Clear();
+}
+
+// static
+void ImageLoader::RunCallback(
+    const std::vector<LoadResult>& load_result,
+    const base::Callback<void(const gfx::Image&)>& callback) {
+  gfx::ImageSkia image_skia;
+
+  for (std::vector<LoadResult>::const_iterator it = load_result.begin();
+       it != load_result.end(); ++it) {
     const SkBitmap& bitmap = it->bitmap;
     const ImageRepresentation& image_rep = it->image_representation;
 
@@ -9,8 +9,12 @@
 
 #include "base/callback_forward.h"
 #include "base/gtest_prod_util.h"
+#include "base/memory/memory_pressure_listener.h"
+#include "base/memory/scoped_ptr.h"
 #include "base/memory/weak_ptr.h"
 #include "components/browser_context_keyed_service/browser_context_keyed_service.h"
+#include "content/public/browser/notification_observer.h"
+#include "content/public/browser/notification_registrar.h"
 #include "extensions/common/extension_resource.h"
 #include "third_party/skia/include/core/SkBitmap.h"
 #include "ui/base/layout.h"
@@ -31,7 +35,11 @@ class Extension;
 // The views need to load their icons asynchronously might be deleted before
 // the images have loaded. If you pass your callback using a weak_ptr, this
 // will make sure the callback won't be called after the view is deleted.
-class ImageLoader : public BrowserContextKeyedService {
+//
+// The decoded and resized images are kept in a size-limited cache, so that
+// the UIs showing the same extension icons don't each decode them again.
+class ImageLoader : public BrowserContextKeyedService,
+                    public content::NotificationObserver {
  public:
   // Information about a singe image representation to load from an extension
   // resource.
@@ -99,8 +107,30 @@ class ImageLoader : public BrowserContextKeyedService {
                        const base::Callback<void(const gfx::Image&)>& callback);
 
  private:
+  class ImageCache;
+
+  // content::NotificationObserver:
+  virtual void Observe(int type,
+                       const content::NotificationSource& source,
+                       const content::NotificationDetails& details) OVERRIDE;
+
+  void OnMemoryPressure(
+      base::MemoryPressureListener::MemoryPressureLevel memory_pressure_level);
+
+  // Builds the image out of the loaded representations and runs |callback|
+  // with it.
+  static void RunCallback(
+      const std::vector<LoadResult>& load_result,
+      const base::Callback<void(const gfx::Image&)>& callback);
+
   base::WeakPtrFactory<ImageLoader> weak_ptr_factory_;
 
+  // The images which were loaded recently.
+  scoped_ptr<ImageCache> cache_;
+
+  content::NotificationRegistrar registrar_;
+  scoped_ptr<base::MemoryPressureListener> memory_pressure_listener_;
+
   static void LoadImagesOnBlockingPool(
       const std::vector<ImageRepresentation>& info_list,
       const std::vector<SkBitmap>& bitmaps,
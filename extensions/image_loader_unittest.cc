@@ -143,6 +143,46 @@ TEST_F(ImageLoaderTest, LoadImage) {
             image_.ToSkBitmap()->width());
 }
 
+// Tests that a loaded image is served from the cache until the extension is
+// unloaded.
+TEST_F(ImageLoaderTest, CachedImage) {
+  scoped_refptr<Extension> extension(CreateExtension(
+      "image_loading_tracker", Manifest::INVALID_LOCATION));
+  ASSERT_TRUE(extension.get() != NULL);
+
+  ExtensionResource image_resource = extensions::IconsInfo::GetIconResource(
+      extension.get(),
+      extension_misc::EXTENSION_ICON_SMALLISH,
+      ExtensionIconSet::MATCH_EXACTLY);
+  gfx::Size max_size(extension_misc::EXTENSION_ICON_SMALLISH,
+                     extension_misc::EXTENSION_ICON_SMALLISH);
+  ImageLoader loader;
+  base::Callback<void(const gfx::Image&)> callback =
+      base::Bind(&ImageLoaderTest::OnImageLoaded, base::Unretained(this));
+  loader.LoadImageAsync(extension.get(), image_resource, max_size, callback);
+  EXPECT_EQ(0, image_loaded_count());
+  WaitForImageLoad();
+  EXPECT_EQ(1, image_loaded_count());
+
+  // The image is cached now, so the callback runs right away.
+  loader.LoadImageAsync(extension.get(), image_resource, max_size, callback);
+  EXPECT_EQ(1, image_loaded_count());
+  EXPECT_EQ(extension_misc::EXTENSION_ICON_SMALLISH,
+            image_.ToSkBitmap()->width());
+
+  // Unloading the extension drops its images from the cache.
+  extensions::UnloadedExtensionInfo details(extension.get(),
+      extension_misc::UNLOAD_REASON_DISABLE);
+  content::NotificationService::current()->Notify(
+      chrome::NOTIFICATION_EXTENSION_UNLOADED,
+      content::NotificationService::AllSources(),
+      content::Details<extensions::UnloadedExtensionInfo>(&details));
+  loader.LoadImageAsync(extension.get(), image_resource, max_size, callback);
+  EXPECT_EQ(0, image_loaded_count());
+  WaitForImageLoad();
+  EXPECT_EQ(1, image_loaded_count());
+}
+
 // Tests deleting an extension while waiting for the image to load doesn't cause
 // problems.
 TEST_F(ImageLoaderTest, DeleteExtensionWhileWaitingForCache) {
@@ -4,10 +4,16 @@
 
 #include "chrome/browser/extensions/installed_loader.h"
 
+#include <vector>
+
+#include "base/bind.h"
 #include "base/files/file_path.h"
+#include "base/memory/scoped_ptr.h"
 #include "base/metrics/histogram.h"
 #include "base/strings/stringprintf.h"
 #include "base/strings/utf_string_conversions.h"
+#include "base/synchronization/lock.h"
+#include "base/threading/sequenced_worker_pool.h"
 #include "base/threading/thread_restrictions.h"
 #include "base/values.h"
 #include "chrome/browser/browser_process.h"
@@ -26,6 +32,7 @@
 #include "chrome/common/extensions/extension_l10n_util.h"
 #include "chrome/common/extensions/manifest_url_handler.h"
 #include "chrome/common/pref_names.h"
+#include "content/public/browser/browser_thread.h"
 #include "content/public/browser/notification_service.h"
 #include "content/public/browser/user_metrics.h"
 #include "extensions/common/manifest.h"
@@ -128,6 +135,115 @@ void DispatchOnInstalledEvent(
       profile, extension_id, old_version, chrome_updated);
 }
 
+// Creates the Extension of an installed extension, from the manifest in the
+// prefs or, if the manifest needs to be reloaded, from the extension's
+// directory. The job is posted to the blocking pool, while the UI thread runs
+// the jobs which no worker has started yet itself. The UI thread never waits
+// for a worker: it runs the jobs which are still running on a worker again.
+class ExtensionLoadJob : public base::RefCountedThreadSafe<ExtensionLoadJob> {
+ public:
+  ExtensionLoadJob(const ExtensionInfo& info, bool reload, int creation_flags)
+      : path_(info.extension_path),
+        location_(info.extension_location),
+        reload_(reload),
+        creation_flags_(creation_flags),
+        state_(PENDING) {
+    if (!reload && info.extension_manifest)
+      manifest_.reset(info.extension_manifest->DeepCopy());
+  }
+
+  // Runs the job on the blocking pool, unless the UI thread took it over.
+  void RunOnWorker() {
+    {
+      base::AutoLock auto_lock(lock_);
+      if (state_ != PENDING)
+        return;
+      state_ = RUNNING_ON_WORKER;
+    }
+    scoped_refptr<const Extension> extension;
+    std::string error;
+    Create(&extension, &error);
+
+    base::AutoLock auto_lock(lock_);
+    if (state_ != RUNNING_ON_WORKER)
+      return;
+    extension_ = extension;
+    error_ = error;
+    state_ = DONE;
+  }
+
+  // Runs the job on the UI thread, unless it is done already. A job which is
+  // running on a worker is left to it, unless |take_over| is true.
+  void RunOnUI(bool take_over) {
+    {
+      base::AutoLock auto_lock(lock_);
+      if (state_ == DONE || (state_ == RUNNING_ON_WORKER && !take_over))
+        return;
+      state_ = RUNNING_ON_UI;
+    }
+    scoped_refptr<const Extension> extension;
+    std::string error;
+    {
+      // See the comment in LoadAllExtensions() about reloading on the UI
+      // thread.
+      base::ThreadRestrictions::ScopedAllowIO allow_io;
+      Create(&extension, &error);
+    }
+
+    base::AutoLock auto_lock(lock_);
+    extension_ = extension;
+    error_ = error;
+    state_ = DONE;
+  }
+
+  bool reload() const { return reload_; }
+
+  // Only valid once RunOnUI(true) returned.
+  const scoped_refptr<const Extension>& extension() const {
+    return extension_;
+  }
+  const std::string& error() const { return error_; }
+
+ private:
+  friend class base::RefCountedThreadSafe<ExtensionLoadJob>;
+
+  enum State {
+    PENDING,
+    RUNNING_ON_WORKER,
+    RUNNING_ON_UI,
+    DONE,
+  };
+
+  ~ExtensionLoadJob() {}
+
+  void Create(scoped_refptr<const Extension>* extension,
+              std::string* error) const {
+    if (reload_) {
+      *extension = extension_file_util::LoadExtension(
+          path_, location_, creation_flags_, error);
+    } else if (manifest_) {
+      *extension = Extension::Create(
+          path_, location_, *manifest_, creation_flags_, error);
+    } else {
+      *error = errors::kManifestUnreadable;
+    }
+  }
+
+  const base::FilePath path_;
+  const Manifest::Location location_;
+  // The manifest from the prefs, NULL if the manifest is reloaded.
+  scoped_ptr<DictionaryValue> manifest_;
+  const bool reload_;
+  const int creation_flags_;
+
+  base::Lock lock_;
+  State state_;
+  scoped_refptr<const Extension> extension_;
+  std::string error_;
+
+  DISALLOW_COPY_AND_ASSIGN(ExtensionLoadJob);
+};
+
 }  // namespace
 
 InstalledLoader::InstalledLoader(ExtensionService* extension_service)
@@ -151,7 +267,14 @@ void InstalledLoader::Load(const ExtensionInfo& info, bool write_to_prefs) {
   } else {
     error = errors::kManifestUnreadable;
   }
+  AddCreatedExtension(info, extension, error, write_to_prefs);
+}
 
+void InstalledLoader::AddCreatedExtension(
+    const ExtensionInfo& info,
+    scoped_refptr<const Extension> extension,
+    std::string error,
+    bool write_to_prefs) {
   // Once installed, non-unpacked extensions cannot change their IDs (e.g., by
   // updating the 'key' field in their manifest).
   // TODO(jstritar): migrate preferences when unpacked extensions change IDs.
@@ -196,6 +319,11 @@ void InstalledLoader::LoadAllExtensions() {
   std::vector<int> reload_reason_counts(NUM_MANIFEST_RELOAD_REASONS, 0);
   bool should_write_prefs = false;
 
+  // The job creating the extension of each entry of |extensions_info|, or
+  // NULL if it isn't loaded.
+  std::vector<scoped_refptr<ExtensionLoadJob> > jobs(extensions_info->size());
+  base::SequencedWorkerPool* pool = BrowserThread::GetBlockingPool();
+
   for (size_t i = 0; i < extensions_info->size(); ++i) {
     ExtensionInfo* info = extensions_info->at(i).get();
 
@@ -209,40 +337,59 @@ void InstalledLoader::LoadAllExtensions() {
     UMA_HISTOGRAM_ENUMERATION("Extensions.ManifestReloadEnumValue",
                               reload_reason, 100);
 
-    if (reload_reason != NOT_NEEDED) {
-      // Reloading an extension reads files from disk.  We do this on the
-      // UI thread because reloads should be very rare, and the complexity
-      // added by delaying the time when the extensions service knows about
-      // all extensions is significant.  See crbug.com/37548 for details.
-      // |allow_io| disables tests that file operations run on the file
-      // thread.
-      base::ThreadRestrictions::ScopedAllowIO allow_io;
+    // Creating an extension parses its manifest, and reloading it also reads
+    // and localizes the manifest from disk. The UI thread doesn't wait for
+    // the blocking pool, since the complexity added by delaying the time when
+    // the extensions service knows about all extensions is significant (see
+    // crbug.com/37548), but it shares the work with the pool.
+    jobs[i] = new ExtensionLoadJob(*info, reload_reason != NOT_NEEDED,
+                                   GetCreationFlags(info));
+    pool->PostWorkerTaskWithShutdownBehavior(
+        FROM_HERE,
+        base::Bind(&ExtensionLoadJob::RunOnWorker, jobs[i]),
+        base::SequencedWorkerPool::SKIP_ON_SHUTDOWN);
+  }
 
-      std::string error;
-      scoped_refptr<const Extension> extension(
-          extension_file_util::LoadExtension(
-              info->extension_path,
-              info->extension_location,
-              GetCreationFlags(info),
-              &error));
-
-      if (!extension.get()) {
-        extension_service_->ReportExtensionLoadError(
-            info->extension_path, error, false);
-        continue;
-      }
+  // Run the jobs no worker has started, then take over the ones still
+  // running.
+  for (size_t i = 0; i < jobs.size(); ++i) {
+    if (jobs[i].get())
+      jobs[i]->RunOnUI(false);
+  }
+  for (size_t i = 0; i < jobs.size(); ++i) {
+    if (jobs[i].get())
+      jobs[i]->RunOnUI(true);
+  }
 
-      extensions_info->at(i)->extension_manifest.reset(
-          static_cast<DictionaryValue*>(
-              extension->manifest()->value()->DeepCopy()));
-      should_write_prefs = true;
+  // An extension which failed to reload is still loaded from the manifest in
+  // the prefs.
+  std::vector<bool> reload_failed(jobs.size(), false);
+  for (size_t i = 0; i < jobs.size(); ++i) {
+    if (!jobs[i].get() || !jobs[i]->reload())
+      continue;
+    ExtensionInfo* info = extensions_info->at(i).get();
+    const Extension* extension = jobs[i]->extension().get();
+    if (!extension) {
+      extension_service_->ReportExtensionLoadError(
+          info->extension_path, jobs[i]->error(), false);
+      reload_failed[i] = true;
+      continue;
     }
+
+    info->extension_manifest.reset(static_cast<DictionaryValue*>(
+        extension->manifest()->value()->DeepCopy()));
+    should_write_prefs = true;
   }
 
-  for (size_t i = 0; i < extensions_info->size(); ++i) {
-    if (extensions_info->at(i)->extension_location == Manifest::COMMAND_LINE)
+  for (size_t i = 0; i < jobs.size(); ++i) {
+    if (!jobs[i].get())
       continue;
-    Load(*extensions_info->at(i), should_write_prefs);
+    if (reload_failed[i]) {
+      Load(*extensions_info->at(i), should_write_prefs);
+    } else {
+      AddCreatedExtension(*extensions_info->at(i), jobs[i]->extension(),
+                          jobs[i]->error(), should_write_prefs);
+    }
   }
 
   extension_service_->OnLoadedInstalledExtensions();
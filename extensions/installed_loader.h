@@ -5,10 +5,15 @@
 #ifndef CHROME_BROWSER_EXTENSIONS_INSTALLED_LOADER_H_
 #define CHROME_BROWSER_EXTENSIONS_INSTALLED_LOADER_H_
 
+#include <string>
+
+#include "base/memory/ref_counted.h"
+
 class ExtensionService;
 
 namespace extensions {
 
+class Extension;
 class ExtensionPrefs;
 struct ExtensionInfo;
 
@@ -21,10 +26,19 @@ class InstalledLoader {
   // Loads extension from prefs.
   void Load(const ExtensionInfo& info, bool write_to_prefs);
 
-  // Loads all installed extensions (used by startup and testing code).
+  // Loads all installed extensions (used by startup and testing code). The
+  // extensions are created on the blocking pool and on the UI thread at the
+  // same time, and then added in the order of the prefs.
   void LoadAllExtensions();
 
  private:
+  // Adds |extension|, which was created for |info|, or reports |error| if it
+  // is NULL.
+  void AddCreatedExtension(const ExtensionInfo& info,
+                           scoped_refptr<const Extension> extension,
+                           std::string error,
+                           bool write_to_prefs);
+
   // Returns the flags that should be used with Extension::Create() for an
   // extension that is already installed.
   int GetCreationFlags(const ExtensionInfo* info);
@@ -62,54 +62,66 @@ ProcessMap::~ProcessMap() {
 
 bool ProcessMap::Insert(const std::string& extension_id, int process_id,
                         int site_instance_id) {
-  return items_.insert(Item(extension_id, process_id, site_instance_id)).second;
+  if (!items_.insert(Item(extension_id, process_id, site_instance_id)).second)
+    return false;
+  extensions_by_process_[process_id].insert(extension_id);
+  return true;
 }
 
 bool ProcessMap::Remove(const std::string& extension_id, int process_id,
                         int site_instance_id) {
-  return items_.erase(Item(extension_id, process_id, site_instance_id)) > 0;
+  if (!items_.erase(Item(extension_id, process_id, site_instance_id)))
+    return false;
+  std::multiset<std::string>& extensions = extensions_by_process_[process_id];
+  extensions.erase(extensions.find(extension_id));
+  if (extensions.empty())
+    extensions_by_process_.erase(process_id);
+  return true;
 }
 
 int ProcessMap::RemoveAllFromProcess(int process_id) {
+  ExtensionsByProcess::iterator extensions =
+      extensions_by_process_.find(process_id);
+  if (extensions == extensions_by_process_.end())
+    return 0;
+
+  // The items of each extension in the process are next to each other.
   int result = 0;
-  for (ItemSet::iterator iter = items_.begin(); iter != items_.end(); ) {
-    if (iter->process_id == process_id) {
+  for (std::multiset<std::string>::const_iterator id =
+           extensions->second.begin();
+       id != extensions->second.end();
+       id = extensions->second.upper_bound(*id)) {
+    ItemSet::iterator iter =
+        items_.lower_bound(Item(*id, process_id, kint32min));
+    while (iter != items_.end() && iter->extension_id == *id &&
+           iter->process_id == process_id) {
       items_.erase(iter++);
       ++result;
-    } else {
-      ++iter;
     }
   }
+  extensions_by_process_.erase(extensions);
   return result;
 }
 
 bool ProcessMap::Contains(const std::string& extension_id,
                           int process_id) const {
-  for (ItemSet::const_iterator iter = items_.begin(); iter != items_.end();
-       ++iter) {
-    if (iter->process_id == process_id && iter->extension_id == extension_id)
-      return true;
-  }
-  return false;
+  ExtensionsByProcess::const_iterator extensions =
+      extensions_by_process_.find(process_id);
+  return extensions != extensions_by_process_.end() &&
+         extensions->second.count(extension_id) > 0;
 }
 
 bool ProcessMap::Contains(int process_id) const {
-  for (ItemSet::const_iterator iter = items_.begin(); iter != items_.end();
-       ++iter) {
-    if (iter->process_id == process_id)
-      return true;
-  }
-  return false;
+  return extensions_by_process_.count(process_id) > 0;
 }
 
 std::set<std::string> ProcessMap::GetExtensionsInProcess(int process_id) const {
-  std::set<std::string> result;
-  for (ItemSet::const_iterator iter = items_.begin(); iter != items_.end();
-       ++iter) {
-    if (iter->process_id == process_id)
-      result.insert(iter->extension_id);
-  }
-  return result;
+  ExtensionsByProcess::const_iterator extensions =
+      extensions_by_process_.find(process_id);
+  if (extensions == extensions_by_process_.end())
+    return std::set<std::string>();
+  return std::set<std::string>(extensions->second.begin(),
+                               extensions->second.end());
 }
 
 }  // extensions
@@ -5,6 +5,7 @@
 #ifndef CHROME_BROWSER_EXTENSIONS_PROCESS_MAP_H_
 #define CHROME_BROWSER_EXTENSIONS_PROCESS_MAP_H_
 
+#include <map>
 #include <set>
 #include <string>
 
@@ -86,6 +87,11 @@ class ProcessMap {
   typedef std::set<Item> ItemSet;
   ItemSet items_;
 
+  // The extension of each item in |items_|, by process. Lets the lookups by
+  // process avoid scanning all the items.
+  typedef std::map<int, std::multiset<std::string> > ExtensionsByProcess;
+  ExtensionsByProcess extensions_by_process_;
+
   DISALLOW_COPY_AND_ASSIGN(ProcessMap);
 };
 
@@ -63,3 +63,31 @@ TEST(ExtensionProcessMapTest, Test) {
   EXPECT_EQ(0, map.RemoveAllFromProcess(2));
   EXPECT_EQ(1u, map.size());
 }
+
+TEST(ExtensionProcessMapTest, LookupsByProcess) {
+  ProcessMap map;
+  EXPECT_FALSE(map.Contains(1));
+  EXPECT_TRUE(map.GetExtensionsInProcess(1).empty());
+
+  EXPECT_TRUE(map.Insert("a", 1, 1));
+  EXPECT_TRUE(map.Insert("a", 1, 2));
+  EXPECT_TRUE(map.Insert("b", 1, 3));
+  EXPECT_TRUE(map.Insert("b", 2, 4));
+  EXPECT_TRUE(map.Contains(1));
+  EXPECT_TRUE(map.Contains(2));
+  EXPECT_FALSE(map.Contains(3));
+
+  std::set<std::string> extensions = map.GetExtensionsInProcess(1);
+  EXPECT_EQ(2u, extensions.size());
+  EXPECT_EQ(1u, extensions.count("a"));
+  EXPECT_EQ(1u, extensions.count("b"));
+
+  EXPECT_TRUE(map.Remove("b", 2, 4));
+  EXPECT_FALSE(map.Contains(2));
+  EXPECT_FALSE(map.Contains("b", 2));
+
+  EXPECT_EQ(3, map.RemoveAllFromProcess(1));
+  EXPECT_FALSE(map.Contains(1));
+  EXPECT_FALSE(map.Contains("a", 1));
+  EXPECT_EQ(0u, map.size());
+}
@@ -16,6 +16,7 @@
 #include "base/stl_util.h"
 #include "base/strings/string_number_conversions.h"
 #include "base/strings/string_split.h"
+#include "base/version.h"
 #include "chrome/browser/chrome_notification_types.h"
 #include "chrome/browser/extensions/api/module/module.h"
 #include "chrome/browser/extensions/crx_installer.h"
@@ -24,6 +25,7 @@
 #include "chrome/browser/extensions/updater/extension_downloader.h"
 #include "chrome/browser/profiles/profile.h"
 #include "chrome/common/extensions/extension.h"
+#include "chrome/common/extensions/extension_file_util.h"
 #include "chrome/common/extensions/extension_set.h"
 #include "chrome/common/pref_names.h"
 #include "content/public/browser/browser_thread.h"
@@ -102,10 +104,12 @@ ExtensionUpdater::FetchedCRXFile::FetchedCRXFile(
     const std::string& i,
     const base::FilePath& p,
     const GURL& u,
+    const std::string& v,
     const std::set<int>& request_ids)
     : extension_id(i),
       path(p),
       download_url(u),
+      version(v),
       request_ids(request_ids) {}
 
 ExtensionUpdater::FetchedCRXFile::FetchedCRXFile() : path(), download_url() {}
@@ -113,7 +117,8 @@ ExtensionUpdater::FetchedCRXFile::FetchedCRXFile() : path(), download_url() {}
 ExtensionUpdater::FetchedCRXFile::~FetchedCRXFile() {}
 
 ExtensionUpdater::InProgressCheck::InProgressCheck()
-    : install_immediately(false) {}
+    : install_immediately(false),
+      extension_count(0) {}
 
 ExtensionUpdater::InProgressCheck::~InProgressCheck() {}
 
@@ -380,6 +385,10 @@ void ExtensionUpdater::CheckNow(const CheckParams& params) {
   // extensions are going to be updated, and use that to figure out if
   // NotifyIfFinished should be called.
   bool noChecks = request.in_progress_ids_.empty();
+  if (params.ids.empty()) {
+    request.start_time = base::TimeTicks::Now();
+    request.extension_count = request.in_progress_ids_.size();
+  }
 
   // StartAllPending() will call OnExtensionDownloadFailed or
   // OnExtensionDownloadFinished for each extension that was checked.
@@ -478,7 +487,7 @@ void ExtensionUpdater::OnExtensionDownloadFinished(
 
   VLOG(2) << download_url << " written to " << path.value();
 
-  FetchedCRXFile fetched(id, path, download_url, request_ids);
+  FetchedCRXFile fetched(id, path, download_url, version, request_ids);
   fetched_crx_files_.push(fetched);
 
   // MaybeInstallCRXFile() removes extensions from |in_progress_ids_| after
@@ -546,13 +555,27 @@ void ExtensionUpdater::MaybeInstallCRXFile() {
     VLOG(2) << "updating " << crx_file.extension_id
             << " with " << crx_file.path.value();
 
-    // The ExtensionService is now responsible for cleaning up the temp file
-    // at |crx_file.path|.
+    bool started = false;
     CrxInstaller* installer = NULL;
-    if (service_->UpdateExtension(crx_file.extension_id,
-                                  crx_file.path,
-                                  crx_file.download_url,
-                                  &installer)) {
+    if (IsFetchedVersionInstalled(crx_file)) {
+      // Don't unpack and install the same version all over again.
+      VLOG(2) << crx_file.extension_id << " is already at version "
+              << crx_file.version;
+      if (!service_->GetFileTaskRunner()->PostTask(
+              FROM_HERE,
+              base::Bind(&extension_file_util::DeleteFile,
+                         crx_file.path, false)))
+        NOTREACHED();
+    } else {
+      // The ExtensionService is now responsible for cleaning up the temp file
+      // at |crx_file.path|.
+      started = service_->UpdateExtension(crx_file.extension_id,
+                                          crx_file.path,
+                                          crx_file.download_url,
+                                          &installer);
+    }
+
+    if (started) {
       crx_install_is_running_ = true;
       current_crx_file_ = crx_file;
 
@@ -588,6 +611,16 @@ void ExtensionUpdater::MaybeInstallCRXFile() {
   }
 }
 
+bool ExtensionUpdater::IsFetchedVersionInstalled(
+    const FetchedCRXFile& crx_file) {
+  Version version(crx_file.version);
+  if (!version.IsValid())
+    return false;
+  const Extension* extension =
+      service_->GetExtensionById(crx_file.extension_id, true);
+  return extension && extension->version()->CompareTo(version) >= 0;
+}
+
 void ExtensionUpdater::Observe(int type,
                                const content::NotificationSource& source,
                                const content::NotificationDetails& details) {
@@ -635,6 +668,14 @@ void ExtensionUpdater::NotifyIfFinished(int request_id) {
   const InProgressCheck& request = requests_in_progress_[request_id];
   if (request.in_progress_ids_.empty()) {
     VLOG(2) << "Finished update check " << request_id;
+    // Record how long it takes for all extensions to be up to date, from the
+    // manifest checks to the last install.
+    if (!request.start_time.is_null() && request.extension_count > 0) {
+      UMA_HISTOGRAM_LONG_TIMES("Extensions.UpdateCheckAllUpdatedTime",
+                               base::TimeTicks::Now() - request.start_time);
+      UMA_HISTOGRAM_CUSTOM_COUNTS("Extensions.UpdateCheckExtensionCount",
+                                  request.extension_count, 1, 1000, 50);
+    }
     if (!request.callback.is_null())
       request.callback.Run();
     requests_in_progress_.erase(request_id);
@@ -124,12 +124,15 @@ class ExtensionUpdater : public ExtensionDownloaderDelegate,
     FetchedCRXFile(const std::string& id,
                    const base::FilePath& path,
                    const GURL& download_url,
+                   const std::string& version,
                    const std::set<int>& request_ids);
     ~FetchedCRXFile();
 
     std::string extension_id;
     base::FilePath path;
     GURL download_url;
+    // The version advertised by the update manifest.
+    std::string version;
     std::set<int> request_ids;
   };
 
@@ -141,6 +144,10 @@ class ExtensionUpdater : public ExtensionDownloaderDelegate,
     FinishedCallback callback;
     // The ids of extensions that have in-progress update checks.
     std::list<std::string> in_progress_ids_;
+    // When a check of all extensions started, or null for other checks.
+    base::TimeTicks start_time;
+    // The number of extensions the check started with.
+    size_t extension_count;
   };
 
   struct ThrottleInfo;
@@ -197,6 +204,11 @@ class ExtensionUpdater : public ExtensionDownloaderDelegate,
   // Starts installing a crx file that has been fetched but not installed yet.
   void MaybeInstallCRXFile();
 
+  // Returns true if the extension |crx_file| is for is already installed at
+  // the version it was fetched for, or at a newer one; e.g. because another
+  // install of it completed while the file was being downloaded.
+  bool IsFetchedVersionInstalled(const FetchedCRXFile& crx_file);
+
   // content::NotificationObserver implementation.
   virtual void Observe(int type,
                        const content::NotificationSource& source,
@@ -11,6 +11,8 @@
 #include "base/bind_helpers.h"
 #include "base/command_line.h"
 #include "base/compiler_specific.h"
+#include "base/file_util.h"
+#include "base/files/scoped_temp_dir.h"
 #include "base/memory/scoped_ptr.h"
 #include "base/memory/weak_ptr.h"
 #include "base/message_loop/message_loop.h"
@@ -435,6 +437,33 @@ class ServiceForDownloadTests : public MockService {
   mutable std::string last_inquired_extension_id_;
 };
 
+// A service with installed extensions which records the updates it is asked
+// to install.
+class ServiceForInstallTests : public ServiceForManifestTests {
+ public:
+  explicit ServiceForInstallTests(TestExtensionPrefs* prefs)
+      : ServiceForManifestTests(prefs), update_count_(0) {
+  }
+
+  virtual bool UpdateExtension(
+      const std::string& id,
+      const base::FilePath& extension_path,
+      const GURL& download_url,
+      CrxInstaller** out_crx_installer) OVERRIDE {
+    ++update_count_;
+    return false;
+  }
+
+  virtual base::SequencedTaskRunner* GetFileTaskRunner() OVERRIDE {
+    return base::MessageLoopProxy::current().get();
+  }
+
+  int update_count() const { return update_count_; }
+
+ private:
+  int update_count_;
+};
+
 static const int kUpdateFrequencySecs = 15;
 
 // Takes a string with KEY=VALUE parameters separated by '&' in |params| and
@@ -1180,6 +1209,45 @@ class ExtensionUpdaterTest : public testing::Test {
     EXPECT_FALSE(updater.crx_install_is_running_);
   }
 
+  // A fetched update is only installed if the extension isn't at its version
+  // yet.
+  void TestSkipInstalledVersion() {
+    ServiceForInstallTests service(prefs_.get());
+    ExtensionList extensions;
+    service.CreateTestExtensions(1, 1, &extensions, NULL, Manifest::INTERNAL);
+    service.set_extensions(extensions);
+    ExtensionUpdater updater(
+        &service, service.extension_prefs(), service.pref_service(),
+        service.profile(), kUpdateFrequencySecs);
+    updater.Start();
+
+    const std::string id = extensions[0]->id();
+    const GURL url("http://localhost/extension.crx");
+    base::ScopedTempDir temp_dir;
+    ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
+    const base::FilePath path = temp_dir.path().AppendASCII("extension.crx");
+    ASSERT_EQ(0, file_util::WriteFile(path, "", 0));
+    std::set<int> requests;
+    requests.insert(0);
+
+    updater.requests_in_progress_[0].in_progress_ids_.push_back(id);
+    updater.OnExtensionDownloadFinished(id, path, url,
+                                        extensions[0]->VersionString(),
+                                        PingResult(), requests);
+    RunUntilIdle();
+    EXPECT_EQ(0, service.update_count());
+    EXPECT_FALSE(updater.crx_install_is_running_);
+    EXPECT_FALSE(ContainsKey(updater.requests_in_progress_, 0));
+    // The downloaded file which isn't installed is deleted.
+    EXPECT_FALSE(base::PathExists(path));
+
+    updater.requests_in_progress_[0].in_progress_ids_.push_back(id);
+    updater.OnExtensionDownloadFinished(id, path, url, "2.0.0.0",
+                                        PingResult(), requests);
+    RunUntilIdle();
+    EXPECT_EQ(1, service.update_count());
+  }
+
   void TestGalleryRequestsWithBrand(bool use_organic_brand_code) {
     google_util::BrandForTesting brand_for_testing(
         use_organic_brand_code ? "GGLS" : "TEST");
@@ -1454,6 +1522,10 @@ TEST_F(ExtensionUpdaterTest, TestMultipleExtensionDownloadingUpdatesSucceed) {
   TestMultipleExtensionDownloading(true);
 }
 
+TEST_F(ExtensionUpdaterTest, TestSkipInstalledVersion) {
+  TestSkipInstalledVersion();
+}
+
 TEST_F(ExtensionUpdaterTest, TestManifestRetryDownloading) {
   TestManifestRetryDownloading();
 }
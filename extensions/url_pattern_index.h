@@ -0,0 +1,133 @@
+// Copyright 2013 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CHROME_BROWSER_EXTENSIONS_URL_PATTERN_INDEX_H_
+#define CHROME_BROWSER_EXTENSIONS_URL_PATTERN_INDEX_H_
+
+#include <map>
+#include <set>
+#include <string>
+
+#include "base/basictypes.h"
+#include "base/strings/string_util.h"
+#include "extensions/common/url_pattern.h"
+#include "extensions/common/url_pattern_set.h"
+#include "url/gurl.h"
+
+namespace extensions {
+
+// An index of values by the hosts of URL patterns they were added with, used
+// to find the values which may match a URL without matching the patterns of
+// every value against it. A lookup scales with the number of labels in the
+// host of the URL instead of with the number of values.
+//
+// The index only narrows down the candidates by host, so callers still have
+// to match the patterns of each candidate in full.
+template <typename Value>
+class URLPatternIndex {
+ public:
+  URLPatternIndex() {}
+  ~URLPatternIndex() {}
+
+  // Adds |value| to the index under each of |patterns|. A value with no
+  // patterns is a candidate for every URL, like a filter without URLs.
+  void Add(const URLPatternSet& patterns, const Value& value) {
+    if (patterns.is_empty()) {
+      any_host_.insert(value);
+      return;
+    }
+    for (URLPatternSet::const_iterator it = patterns.begin();
+         it != patterns.end(); ++it) {
+      std::string host;
+      BucketMap* buckets = GetBuckets(*it, &host);
+      if (buckets)
+        (*buckets)[host].insert(value);
+      else
+        any_host_.insert(value);
+    }
+  }
+
+  // Removes |value|, which must have been added with the same |patterns|.
+  void Remove(const URLPatternSet& patterns, const Value& value) {
+    if (patterns.is_empty()) {
+      EraseOne(&any_host_, value);
+      return;
+    }
+    for (URLPatternSet::const_iterator it = patterns.begin();
+         it != patterns.end(); ++it) {
+      std::string host;
+      BucketMap* buckets = GetBuckets(*it, &host);
+      if (!buckets) {
+        EraseOne(&any_host_, value);
+        continue;
+      }
+      typename BucketMap::iterator bucket = buckets->find(host);
+      if (bucket == buckets->end())
+        continue;
+      EraseOne(&bucket->second, value);
+      if (bucket->second.empty())
+        buckets->erase(bucket);
+    }
+  }
+
+  // Adds the values which may match |url| to |candidates|.
+  void GetCandidates(const GURL& url, std::set<Value>* candidates) const {
+    candidates->insert(any_host_.begin(), any_host_.end());
+
+    // Patterns match filesystem: URLs by their inner URL.
+    const GURL* test_url = &url;
+    if (url.SchemeIsFileSystem() && url.inner_url())
+      test_url = url.inner_url();
+    const std::string& host = test_url->host();
+
+    typename BucketMap::const_iterator it = hosts_.find(host);
+    if (it != hosts_.end())
+      candidates->insert(it->second.begin(), it->second.end());
+
+    // Walk up the domains the host is in, from the host itself to its TLD.
+    for (size_t begin = 0; !domains_.empty() && begin < host.size();) {
+      it = domains_.find(host.substr(begin));
+      if (it != domains_.end())
+        candidates->insert(it->second.begin(), it->second.end());
+      const size_t dot = host.find('.', begin);
+      if (dot == std::string::npos)
+        break;
+      begin = dot + 1;
+    }
+  }
+
+ private:
+  typedef std::multiset<Value> Bucket;
+  typedef std::map<std::string, Bucket> BucketMap;
+
+  // Returns the buckets |pattern| goes into, and sets |host| to the key of
+  // its bucket. Returns NULL for patterns which match any host, such as
+  // <all_urls> or file patterns, which go into |any_host_|.
+  BucketMap* GetBuckets(const URLPattern& pattern, std::string* host) {
+    *host = StringToLowerASCII(pattern.host());
+    if (pattern.match_all_urls() || host->empty())
+      return NULL;
+    return pattern.match_subdomains() ? &domains_ : &hosts_;
+  }
+
+  static void EraseOne(Bucket* bucket, const Value& value) {
+    typename Bucket::iterator it = bucket->find(value);
+    if (it != bucket->end())
+      bucket->erase(it);
+  }
+
+  // Values by the host of their patterns which match exactly one host, and
+  // by the domain of those which also match its subdomains.
+  BucketMap hosts_;
+  BucketMap domains_;
+
+  // Values which may match any host.
+  Bucket any_host_;
+
+  DISALLOW_COPY_AND_ASSIGN(URLPatternIndex);
+};
+
+}  // namespace extensions
+
+#endif  // CHROME_BROWSER_EXTENSIONS_URL_PATTERN_INDEX_H_
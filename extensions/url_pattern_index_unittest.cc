@@ -0,0 +1,81 @@
+// Copyright 2013 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "chrome/browser/extensions/url_pattern_index.h"
+
+#include <set>
+
+#include "extensions/common/url_pattern.h"
+#include "extensions/common/url_pattern_set.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "url/gurl.h"
+
+namespace extensions {
+
+namespace {
+
+URLPatternSet MakePatterns(const char* pattern1, const char* pattern2) {
+  URLPatternSet patterns;
+  patterns.AddPattern(URLPattern(URLPattern::SCHEME_ALL, pattern1));
+  if (pattern2)
+    patterns.AddPattern(URLPattern(URLPattern::SCHEME_ALL, pattern2));
+  return patterns;
+}
+
+std::set<int> GetCandidates(const URLPatternIndex<int>& index,
+                            const char* url) {
+  std::set<int> candidates;
+  index.GetCandidates(GURL(url), &candidates);
+  return candidates;
+}
+
+}  // namespace
+
+TEST(URLPatternIndexTest, Candidates) {
+  URLPatternIndex<int> index;
+  index.Add(MakePatterns("http://www.google.com/*", "https://a.com/*"), 1);
+  index.Add(MakePatterns("*://*.google.com/*", NULL), 2);
+  index.Add(MakePatterns("<all_urls>", NULL), 3);
+  index.Add(URLPatternSet(), 4);
+  index.Add(MakePatterns("file:///*", NULL), 5);
+
+  std::set<int> candidates = GetCandidates(index, "http://www.google.com/");
+  EXPECT_EQ(5u, candidates.size());
+
+  candidates = GetCandidates(index, "http://mail.google.com/");
+  EXPECT_EQ(4u, candidates.size());
+  EXPECT_EQ(0u, candidates.count(1));
+
+  candidates = GetCandidates(index, "http://google.com/");
+  EXPECT_EQ(1u, candidates.count(2));
+
+  candidates = GetCandidates(index, "http://notgoogle.com/");
+  EXPECT_EQ(0u, candidates.count(1));
+  EXPECT_EQ(0u, candidates.count(2));
+
+  candidates = GetCandidates(index, "https://a.com/");
+  EXPECT_EQ(1u, candidates.count(1));
+  EXPECT_EQ(0u, candidates.count(2));
+}
+
+TEST(URLPatternIndexTest, Remove) {
+  URLPatternIndex<int> index;
+  URLPatternSet patterns1 =
+      MakePatterns("http://www.google.com/*", "https://www.google.com/*");
+  URLPatternSet patterns2 = MakePatterns("http://www.google.com/foo", NULL);
+  index.Add(patterns1, 1);
+  index.Add(patterns2, 2);
+  index.Add(URLPatternSet(), 3);
+
+  index.Remove(patterns1, 1);
+  std::set<int> candidates = GetCandidates(index, "http://www.google.com/");
+  EXPECT_EQ(2u, candidates.size());
+  EXPECT_EQ(0u, candidates.count(1));
+
+  index.Remove(URLPatternSet(), 3);
+  index.Remove(patterns2, 2);
+  EXPECT_TRUE(GetCandidates(index, "http://www.google.com/").empty());
+}
+
+}  // namespace extensions
@@ -54,8 +54,65 @@ static bool GetDeclarationValue(const base::StringPiece& line,
   return true;
 }
 
+// Returns true if |a| and |b| contain the same serialized scripts.
+static bool HaveSameContents(const base::SharedMemory& a,
+                             const base::SharedMemory& b) {
+  return a.mapped_size() == b.mapped_size() &&
+      memcmp(a.memory(), b.memory(), a.mapped_size()) == 0;
+}
+
+UserScriptMaster::ScriptFileCache::Entry::Entry() : size(0), used(false) {}
+
+UserScriptMaster::ScriptFileCache::Entry::~Entry() {}
+
+UserScriptMaster::ScriptFileCache::ScriptFileCache() {}
+
+bool UserScriptMaster::ScriptFileCache::ReadFile(const base::FilePath& path,
+                                                 std::string* content) {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::FILE));
+  base::PlatformFileInfo info;
+  if (!file_util::GetFileInfo(path, &info)) {
+    entries_.erase(path);
+    return false;
+  }
+
+  EntryMap::iterator it = entries_.find(path);
+  if (it == entries_.end() || it->second.last_modified != info.last_modified ||
+      it->second.size != info.size) {
+    if (!base::ReadFileToString(path, content)) {
+      entries_.erase(path);
+      return false;
+    }
+    Entry& entry = entries_[path];
+    entry.last_modified = info.last_modified;
+    entry.size = info.size;
+    entry.content = *content;
+    entry.used = true;
+    return true;
+  }
+
+  *content = it->second.content;
+  it->second.used = true;
+  return true;
+}
+
+void UserScriptMaster::ScriptFileCache::DropUnusedFiles() {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::FILE));
+  for (EntryMap::iterator it = entries_.begin(); it != entries_.end();) {
+    if (it->second.used) {
+      it->second.used = false;
+      ++it;
+    } else {
+      entries_.erase(it++);
+    }
+  }
+}
+
+UserScriptMaster::ScriptFileCache::~ScriptFileCache() {}
+
 UserScriptMaster::ScriptReloader::ScriptReloader(UserScriptMaster* master)
-    : master_(master) {
+    : master_(master),
+      file_cache_(master ? master->file_cache_ : new ScriptFileCache()) {
   CHECK(BrowserThread::GetCurrentThreadIdentifier(&master_thread_id_));
 }
 
@@ -184,7 +241,8 @@ void UserScriptMaster::ScriptReloader::NotifyMaster(
 }
 
 static bool LoadScriptContent(UserScript::File* script_file,
-                              const SubstitutionMap* localization_messages) {
+                              const SubstitutionMap* localization_messages,
+                              UserScriptMaster::ScriptFileCache* file_cache) {
   std::string content;
   const base::FilePath& path = ExtensionResource::GetFilePath(
       script_file->extension_root(), script_file->relative_path(),
@@ -203,7 +261,7 @@ static bool LoadScriptContent(UserScript::File* script_file,
       return false;
     }
   } else {
-    if (!base::ReadFileToString(path, &content)) {
+    if (!file_cache->ReadFile(path, &content)) {
       LOG(WARNING) << "Failed to load user script file: " << path.value();
       return false;
     }
@@ -239,14 +297,17 @@ void UserScriptMaster::ScriptReloader::LoadUserScripts(
     for (size_t k = 0; k < script.js_scripts().size(); ++k) {
       UserScript::File& script_file = script.js_scripts()[k];
       if (script_file.GetContent().empty())
-        LoadScriptContent(&script_file, NULL);
+        LoadScriptContent(&script_file, NULL, file_cache_.get());
     }
     for (size_t k = 0; k < script.css_scripts().size(); ++k) {
       UserScript::File& script_file = script.css_scripts()[k];
-      if (script_file.GetContent().empty())
-        LoadScriptContent(&script_file, localization_messages.get());
+      if (script_file.GetContent().empty()) {
+        LoadScriptContent(&script_file, localization_messages.get(),
+                          file_cache_.get());
+      }
     }
   }
+  file_cache_->DropUnusedFiles();
 }
 
 SubstitutionMap* UserScriptMaster::ScriptReloader::GetLocalizationMessages(
@@ -311,7 +372,8 @@ void UserScriptMaster::ScriptReloader::RunLoad(
 
 
 UserScriptMaster::UserScriptMaster(Profile* profile)
-    : extensions_service_ready_(false),
+    : file_cache_(new ScriptFileCache()),
+      extensions_service_ready_(false),
       pending_load_(false),
       profile_(profile) {
   registrar_.Add(this, chrome::NOTIFICATION_EXTENSIONS_READY,
@@ -341,13 +403,19 @@ void UserScriptMaster::NewScriptsAvailable(base::SharedMemory* handle) {
   } else {
     // We're no longer loading.
     script_reloader_ = NULL;
+    // The renderers already have the scripts if they didn't change, e.g. when
+    // an extension without content scripts was reloaded.
+    bool scripts_changed = !handle || !shared_memory_ ||
+        !HaveSameContents(*handle, *shared_memory_);
     // We've got scripts ready to go.
     shared_memory_.swap(handle_deleter);
 
-    for (content::RenderProcessHost::iterator i(
-            content::RenderProcessHost::AllHostsIterator());
-         !i.IsAtEnd(); i.Advance()) {
-      SendUpdate(i.GetCurrentValue(), handle);
+    if (scripts_changed && handle) {
+      for (content::RenderProcessHost::iterator i(
+              content::RenderProcessHost::AllHostsIterator());
+           !i.IsAtEnd(); i.Advance()) {
+        SendUpdate(i.GetCurrentValue(), handle);
+      }
     }
 
     content::NotificationService::current()->Notify(
@@ -382,7 +450,7 @@ void UserScriptMaster::Observe(int type,
         user_scripts_.push_back(*iter);
         user_scripts_.back().set_incognito_enabled(incognito_enabled);
       }
-      if (extensions_service_ready_)
+      if (extensions_service_ready_ && !scripts.empty())
         should_start_load = true;
       break;
     }
@@ -397,8 +465,10 @@ void UserScriptMaster::Observe(int type,
         if (iter->extension_id() != extension->id())
           new_user_scripts.push_back(*iter);
       }
+      // Unloading an extension without content scripts changes nothing the
+      // renderers have.
+      should_start_load = new_user_scripts.size() != user_scripts_.size();
       user_scripts_ = new_user_scripts;
-      should_start_load = true;
       break;
     }
     case content::NOTIFICATION_RENDERER_PROCESS_CREATED: {
@@ -14,6 +14,7 @@
 #include "base/memory/scoped_ptr.h"
 #include "base/memory/shared_memory.h"
 #include "base/strings/string_piece.h"
+#include "base/time/time.h"
 #include "chrome/browser/extensions/extension_info_map.h"
 #include "chrome/common/extensions/extension_messages.h"
 #include "chrome/common/extensions/extension_set.h"
@@ -55,6 +56,44 @@ class UserScriptMaster : public base::RefCountedThreadSafe<UserScriptMaster>,
   // Return true if we have any scripts ready.
   bool ScriptsReady() const { return shared_memory_.get() != NULL; }
 
+  // The contents of the script files, with the size and modification time
+  // of each file, so that a reload only reads the files which changed. It is
+  // kept by the master across loads, but only used on the file thread.
+  class ScriptFileCache
+      : public base::RefCountedThreadSafe<UserScriptMaster::ScriptFileCache> {
+   public:
+    ScriptFileCache();
+
+    // Sets |content| to the content of the file at |path|, which is only read
+    // if its size or modification time changed since it was cached. Returns
+    // false if the file can't be read.
+    bool ReadFile(const base::FilePath& path, std::string* content);
+
+    // Drops the files which weren't read since the last call, e.g. the files
+    // of the extensions which were unloaded.
+    void DropUnusedFiles();
+
+   private:
+    friend class base::RefCountedThreadSafe<UserScriptMaster::ScriptFileCache>;
+
+    struct Entry {
+      Entry();
+      ~Entry();
+
+      base::Time last_modified;
+      int64 size;
+      std::string content;
+      bool used;
+    };
+    typedef std::map<base::FilePath, Entry> EntryMap;
+
+    ~ScriptFileCache();
+
+    EntryMap entries_;
+
+    DISALLOW_COPY_AND_ASSIGN(ScriptFileCache);
+  };
+
  protected:
   friend class base::RefCountedThreadSafe<UserScriptMaster>;
 
@@ -89,6 +128,7 @@ class UserScriptMaster : public base::RefCountedThreadSafe<UserScriptMaster>,
    private:
     FRIEND_TEST_ALL_PREFIXES(UserScriptMasterTest, SkipBOMAtTheBeginning);
     FRIEND_TEST_ALL_PREFIXES(UserScriptMasterTest, LeaveBOMNotAtTheBeginning);
+    FRIEND_TEST_ALL_PREFIXES(UserScriptMasterTest, RereadsModifiedFiles);
     friend class base::RefCountedThreadSafe<UserScriptMaster::ScriptReloader>;
 
     ~ScriptReloader();
@@ -122,6 +162,9 @@ class UserScriptMaster : public base::RefCountedThreadSafe<UserScriptMaster>,
     // Maps extension info needed for localization to an extension ID.
     ExtensionsInfo extensions_info_;
 
+    // The contents of the files read by the previous loads.
+    scoped_refptr<ScriptFileCache> file_cache_;
+
     // The message loop to call our master back on.
     // Expected to always outlive us.
     content::BrowserThread::ID master_thread_id_;
@@ -148,6 +191,9 @@ class UserScriptMaster : public base::RefCountedThreadSafe<UserScriptMaster>,
   // Contains the scripts that were found the last time scripts were updated.
   scoped_ptr<base::SharedMemory> shared_memory_;
 
+  // The script files read by the loads, shared by the script reloaders.
+  scoped_refptr<ScriptFileCache> file_cache_;
+
   // List of scripts from currently-installed extensions we should load.
   UserScriptList user_scripts_;
 
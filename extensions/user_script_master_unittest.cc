@@ -276,4 +276,58 @@ TEST_F(UserScriptMasterTest, LeaveBOMNotAtTheBeginning) {
   EXPECT_EQ(content, user_scripts[0].js_scripts()[0].GetContent().as_string());
 }
 
+TEST_F(UserScriptMasterTest, RereadsModifiedFiles) {
+  base::FilePath path = temp_dir_.path().AppendASCII("script.user.js");
+  const std::string content("alert('hello');");
+  ASSERT_EQ(static_cast<int>(content.size()),
+            file_util::WriteFile(path, content.c_str(), content.size()));
+  base::PlatformFileInfo info;
+  ASSERT_TRUE(file_util::GetFileInfo(path, &info));
+
+  UserScript user_script;
+  user_script.js_scripts().push_back(UserScript::File(
+      temp_dir_.path(), path.BaseName(), GURL()));
+
+  scoped_refptr<UserScriptMaster::ScriptReloader> script_reloader(
+      new UserScriptMaster::ScriptReloader(NULL));
+  UserScriptList user_scripts(1, user_script);
+  script_reloader->LoadUserScripts(&user_scripts);
+  EXPECT_EQ(content, user_scripts[0].js_scripts()[0].GetContent().as_string());
+
+  // A file whose size and modification time didn't change since the last
+  // load isn't read again.
+  const std::string same_size_content("alert('world');");
+  ASSERT_EQ(content.size(), same_size_content.size());
+  ASSERT_EQ(static_cast<int>(same_size_content.size()),
+            file_util::WriteFile(path, same_size_content.c_str(),
+                                 same_size_content.size()));
+  ASSERT_TRUE(file_util::TouchFile(path, info.last_accessed,
+                                   info.last_modified));
+  user_scripts.assign(1, user_script);
+  script_reloader->LoadUserScripts(&user_scripts);
+  EXPECT_EQ(content, user_scripts[0].js_scripts()[0].GetContent().as_string());
+
+  ASSERT_TRUE(file_util::TouchFile(
+      path, info.last_accessed,
+      info.last_modified + base::TimeDelta::FromSeconds(10)));
+  user_scripts.assign(1, user_script);
+  script_reloader->LoadUserScripts(&user_scripts);
+  EXPECT_EQ(same_size_content,
+            user_scripts[0].js_scripts()[0].GetContent().as_string());
+
+  // A file whose size changed is read again, even if its modification time
+  // is the same, e.g. on file systems with a coarse timestamp granularity.
+  const std::string new_content("alert('bye');");
+  ASSERT_EQ(static_cast<int>(new_content.size()),
+            file_util::WriteFile(path, new_content.c_str(),
+                                 new_content.size()));
+  ASSERT_TRUE(file_util::TouchFile(
+      path, info.last_accessed,
+      info.last_modified + base::TimeDelta::FromSeconds(10)));
+  user_scripts.assign(1, user_script);
+  script_reloader->LoadUserScripts(&user_scripts);
+  EXPECT_EQ(new_content,
+            user_scripts[0].js_scripts()[0].GetContent().as_string());
+}
+
 }  // namespace extensions
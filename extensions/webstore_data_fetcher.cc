@@ -82,6 +82,9 @@ void WebstoreDataFetcher::OnURLFetchComplete(const net::URLFetcher* source) {
                                     AsWeakPtr()),
                          base::Bind(&WebstoreDataFetcher::OnJsonParseFailure,
                                     AsWeakPtr()));
+  // The response comes from the web store, which is trusted not to attack the
+  // parsers of other responses.
+  parser->set_process_mode(BatchedUtilityProcessHost::SHARED_PROCESS);
   // The parser will call us back via one of the callbacks.
   parser->Start();
 }
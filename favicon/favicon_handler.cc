@@ -97,6 +97,20 @@ bool DoUrlsAndIconsMatch(
   return true;
 }
 
+// Matches the FaviconURLs with the same icon URL and icon type as |url|.
+class SameFaviconURL {
+ public:
+  explicit SameFaviconURL(const FaviconURL& url) : url_(url) {}
+
+  bool operator()(const FaviconURL& other) const {
+    return other.icon_url == url_.icon_url &&
+        other.icon_type == url_.icon_type;
+  }
+
+ private:
+  const FaviconURL& url_;
+};
+
 std::string UrlWithoutFragment(const GURL& gurl) {
   GURL::Replacements replacements;
   replacements.ClearRef();
@@ -338,8 +352,15 @@ void FaviconHandler::OnUpdateFaviconURL(
   favicon_candidate_ = FaviconCandidate();
   for (std::vector<FaviconURL>::const_iterator i = candidates.begin();
        i != candidates.end(); ++i) {
-    if (!i->icon_url.is_empty() && (i->icon_type & icon_types_))
-      image_urls_.push_back(*i);
+    if (i->icon_url.is_empty() || !(i->icon_type & icon_types_))
+      continue;
+    // Pages often list the same icon more than once, e.g. once per size.
+    // Downloading it again would not give a better candidate.
+    if (std::find_if(image_urls_.begin(), image_urls_.end(),
+                     SameFaviconURL(*i)) != image_urls_.end()) {
+      continue;
+    }
+    image_urls_.push_back(*i);
   }
 
   // TODO(davemoore) Should clear on empty url. Currently we ignore it.
@@ -1063,6 +1063,29 @@ TEST_F(FaviconHandlerTest, MultipleFavicons) {
             handler4.GetEntry()->GetFavicon().url);
 }
 
+// Test that an icon listed several times by the page is only downloaded once.
+TEST_F(FaviconHandlerTest, IgnoreDuplicateCandidates) {
+  const GURL kPageURL("http://www.google.com");
+  const GURL kIconURL1("http://www.google.com/a");
+  const GURL kIconURL2("http://www.google.com/b");
+
+  Profile* profile = Profile::FromBrowserContext(
+      web_contents()->GetBrowserContext());
+  TestFaviconHandlerDelegate delegate;
+  TestFaviconHandler helper(kPageURL, profile,
+                            &delegate, FaviconHandler::FAVICON);
+
+  std::vector<FaviconURL> urls;
+  urls.push_back(FaviconURL(kIconURL1, FaviconURL::FAVICON));
+  urls.push_back(FaviconURL(kIconURL1, FaviconURL::FAVICON));
+  urls.push_back(FaviconURL(kIconURL2, FaviconURL::FAVICON));
+  helper.OnUpdateFaviconURL(0, urls);
+
+  ASSERT_EQ(2U, helper.image_urls().size());
+  EXPECT_EQ(kIconURL1, helper.image_urls()[0].icon_url);
+  EXPECT_EQ(kIconURL2, helper.image_urls()[1].icon_url);
+}
+
 static BrowserContextKeyedService* BuildFaviconService(
     content::BrowserContext* profile) {
   return new FaviconService(NULL);
@@ -150,13 +150,16 @@ void AuthService::StartAuthentication(const AuthStatusCallback& callback) {
     relay_proxy->PostTask(FROM_HERE,
                           base::Bind(callback, HTTP_SUCCESS, access_token_));
   } else if (HasRefreshToken()) {
-    // We have refresh token, let's get an access token.
+    // We have refresh token, let's get an access token, unless it is already
+    // being fetched for another caller.
+    pending_callbacks_.push_back(callback);
+    if (pending_callbacks_.size() > 1)
+      return;
     new AuthRequest(oauth2_token_service_,
                     account_id_,
                     url_request_context_getter_,
                     base::Bind(&AuthService::OnAuthCompleted,
-                               weak_ptr_factory_.GetWeakPtr(),
-                               callback),
+                               weak_ptr_factory_.GetWeakPtr()),
                     scopes_);
   } else {
     relay_proxy->PostTask(FROM_HERE,
@@ -188,11 +191,10 @@ void AuthService::ClearRefreshToken() {
                     OnOAuth2RefreshTokenChanged());
 }
 
-void AuthService::OnAuthCompleted(const AuthStatusCallback& callback,
-                                  GDataErrorCode error,
+void AuthService::OnAuthCompleted(GDataErrorCode error,
                                   const std::string& access_token) {
   DCHECK(thread_checker_.CalledOnValidThread());
-  DCHECK(!callback.is_null());
+  DCHECK(!pending_callbacks_.empty());
 
   if (error == HTTP_SUCCESS) {
     access_token_ = access_token;
@@ -208,7 +210,10 @@ void AuthService::OnAuthCompleted(const AuthStatusCallback& callback,
   }
 
   // TODO(zelidrag): Add retry, back-off logic when things go wrong here.
-  callback.Run(error, access_token);
+  std::vector<AuthStatusCallback> callbacks;
+  callbacks.swap(pending_callbacks_);
+  for (size_t i = 0; i < callbacks.size(); ++i)
+    callbacks[i].Run(error, access_token);
 }
 
 void AuthService::AddObserver(AuthServiceObserver* observer) {
@@ -58,9 +58,8 @@ class AuthService : public AuthServiceInterface,
   void OnHandleRefreshToken(bool has_refresh_token);
 
   // Called when authentication request from StartAuthentication() is
-  // completed.
-  void OnAuthCompleted(const AuthStatusCallback& callback,
-                       GDataErrorCode error,
+  // completed. Runs all the callbacks in |pending_callbacks_|.
+  void OnAuthCompleted(GDataErrorCode error,
                        const std::string& access_token);
 
   OAuth2TokenService* oauth2_token_service_;
@@ -70,6 +69,10 @@ class AuthService : public AuthServiceInterface,
   std::string access_token_;
   std::vector<std::string> scopes_;
   ObserverList<AuthServiceObserver> observers_;
+
+  // Callbacks of StartAuthentication() waiting for the running authentication
+  // request. All the requests started without an access token share it.
+  std::vector<AuthStatusCallback> pending_callbacks_;
   base::ThreadChecker thread_checker_;
 
   // Note: This should remain the last member so it'll be destroyed and
@@ -65,6 +65,13 @@ scoped_ptr<base::Value> ParseJsonOnBlockingPool(const std::string& json) {
   return value.Pass();
 }
 
+// Same as ParseJsonOnBlockingPool(), but frees |json| as soon as it is parsed.
+scoped_ptr<base::Value> ParseOwnedJsonOnBlockingPool(
+    scoped_ptr<std::string> json) {
+  DCHECK(json);
+  return ParseJsonOnBlockingPool(*json);
+}
+
 // Returns response headers as a string. Returns a warning message if
 // |url_fetcher| does not contain a valid response. Used only for debugging.
 std::string GetResponseHeadersAsString(
@@ -99,6 +106,16 @@ void ParseJson(base::TaskRunner* blocking_task_runner,
       callback);
 }
 
+void ParseJson(base::TaskRunner* blocking_task_runner,
+               scoped_ptr<std::string> json,
+               const ParseJsonCallback& callback) {
+  base::PostTaskAndReplyWithResult(
+      blocking_task_runner,
+      FROM_HERE,
+      base::Bind(&ParseOwnedJsonOnBlockingPool, base::Passed(&json)),
+      callback);
+}
+
 //============================ UrlFetchRequestBase ===========================
 
 UrlFetchRequestBase::UrlFetchRequestBase(RequestSender* sender)
@@ -317,27 +334,31 @@ GetDataRequest::~GetDataRequest() {}
 
 void GetDataRequest::ParseResponse(GDataErrorCode fetch_error_code,
                                    const std::string& data) {
+  ParseResponse(fetch_error_code, make_scoped_ptr(new std::string(data)));
+}
+
+void GetDataRequest::ParseResponse(GDataErrorCode fetch_error_code,
+                                   scoped_ptr<std::string> data) {
   DCHECK(CalledOnValidThread());
 
   VLOG(1) << "JSON received from " << GetURL().spec() << ": "
-          << data.size() << " bytes";
+          << data->size() << " bytes";
   ParseJson(blocking_task_runner(),
-            data,
+            data.Pass(),
             base::Bind(&GetDataRequest::OnDataParsed,
                        weak_ptr_factory_.GetWeakPtr(),
                        fetch_error_code));
 }
 
 void GetDataRequest::ProcessURLFetchResults(const URLFetcher* source) {
-  std::string data;
-  source->GetResponseAsString(&data);
-  scoped_ptr<base::Value> root_value;
+  scoped_ptr<std::string> data(new std::string);
+  source->GetResponseAsString(data.get());
   GDataErrorCode fetch_error_code = GetErrorCode(source);
 
   switch (fetch_error_code) {
     case HTTP_SUCCESS:
     case HTTP_CREATED:
-      ParseResponse(fetch_error_code, data);
+      ParseResponse(fetch_error_code, data.Pass());
       break;
     default:
       RunCallbackOnPrematureFailure(fetch_error_code);
@@ -490,11 +511,11 @@ void UploadRangeRequestBase::ProcessURLFetchResults(
   } else if (code == HTTP_CREATED || code == HTTP_SUCCESS) {
     // The upload is successfully done. Parse the response which should be
     // the entry's metadata.
-    std::string response_content;
-    source->GetResponseAsString(&response_content);
+    scoped_ptr<std::string> response_content(new std::string);
+    source->GetResponseAsString(response_content.get());
 
     ParseJson(blocking_task_runner(),
-              response_content,
+              response_content.Pass(),
               base::Bind(&UploadRangeRequestBase::OnDataParsed,
                          weak_ptr_factory_.GetWeakPtr(),
                          code));
@@ -42,6 +42,12 @@ void ParseJson(base::TaskRunner* blocking_task_runner,
                const std::string& json,
                const ParseJsonCallback& callback);
 
+// Same as above, but takes the ownership of |json|, so that large responses
+// are not copied, and are freed on |blocking_task_runner| right after parsing.
+void ParseJson(base::TaskRunner* blocking_task_runner,
+               scoped_ptr<std::string> json,
+               const ParseJsonCallback& callback);
+
 //======================= AuthenticatedRequestInterface ======================
 
 // An interface class for implementing a request which requires OAuth2
@@ -213,8 +219,11 @@ class GetDataRequest : public UrlFetchRequestBase {
   GetDataRequest(RequestSender* sender, const GetDataCallback& callback);
   virtual ~GetDataRequest();
 
-  // Parses JSON response.
+  // Parses JSON response. The second version takes the ownership of |data|
+  // to avoid copying it.
   void ParseResponse(GDataErrorCode fetch_error_code, const std::string& data);
+  void ParseResponse(GDataErrorCode fetch_error_code,
+                     scoped_ptr<std::string> data);
 
  protected:
   // UrlFetchRequestBase overrides.
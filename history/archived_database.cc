@@ -13,7 +13,7 @@ namespace history {
 
 namespace {
 
-static const int kCurrentVersionNumber = 4;
+static const int kCurrentVersionNumber = 5;
 static const int kCompatibleVersionNumber = 2;
 
 }  // namespace
@@ -139,6 +139,17 @@ sql::InitStatus ArchivedDatabase::EnsureCurrentVersion() {
     meta_table_.SetVersionNumber(cur_version);
   }
 
+  if (cur_version == 4) {
+    // This is the version prior to replacing the index over visits.url with
+    // the one over (url, visit_time).
+    if (!MigrateVisitsURLIndex()) {
+      LOG(WARNING) << "Unable to update archived database to version 5.";
+      return sql::INIT_FAILURE;
+    }
+    ++cur_version;
+    meta_table_.SetVersionNumber(cur_version);
+  }
+
   // Put future migration cases here.
 
   // When the version is too old, we just try to continue anyway, there should
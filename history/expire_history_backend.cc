@@ -14,6 +14,7 @@
 #include "base/files/file_enumerator.h"
 #include "base/logging.h"
 #include "base/message_loop/message_loop.h"
+#include "base/metrics/histogram.h"
 #include "chrome/browser/bookmarks/bookmark_service.h"
 #include "chrome/browser/chrome_notification_types.h"
 #include "chrome/browser/history/archived_database.h"
@@ -136,6 +137,17 @@ const int kExpirationDelaySec = 30;
 // iteration, so we want to wait longer before checking to avoid wasting CPU.
 const int kExpirationEmptyDelayMin = 5;
 
+// The amount of time one archive iteration should keep the database busy for.
+// Iterations that take longer halve the number of visits the next one expires,
+// and iterations that take less than a quarter of this double it again (up to
+// kNumExpirePerIteration).
+const int kExpirationIterationBudgetMs = 100;
+
+// The number of seconds after the user navigates or queries history during
+// which periodic expiration is held off, so it doesn't compete with them for
+// the database.
+const int kExpirationUserActivityDelaySec = 10;
+
 }  // namespace
 
 struct ExpireHistoryBackend::DeleteDependencies {
@@ -172,6 +184,7 @@ ExpireHistoryBackend::ExpireHistoryBackend(
       archived_db_(NULL),
       thumb_db_(NULL),
       weak_factory_(this),
+      visits_per_iteration_(kNumExpirePerIteration),
       bookmark_service_(bookmark_service) {
 }
 
@@ -304,6 +317,10 @@ void ExpireHistoryBackend::ArchiveHistoryBefore(Time end_time) {
   ParanoidExpireHistory();
 }
 
+void ExpireHistoryBackend::OnUserActivity() {
+  last_user_activity_ = base::TimeTicks::Now();
+}
+
 void ExpireHistoryBackend::InitWorkQueue() {
   DCHECK(work_queue_.empty()) << "queue has to be empty prior to init";
 
@@ -596,9 +613,30 @@ void ExpireHistoryBackend::ScheduleArchive() {
 void ExpireHistoryBackend::DoArchiveIteration() {
   DCHECK(!work_queue_.empty()) << "queue has to be non-empty";
 
+  // Don't hold the database while the user is waiting on it; try again once
+  // they've been idle for a bit. Nothing is lost by waiting, the readers pick
+  // up from wherever the last iteration stopped.
+  const base::TimeDelta since_activity =
+      base::TimeTicks::Now() - last_user_activity_;
+  const base::TimeDelta activity_delay =
+      TimeDelta::FromSeconds(kExpirationUserActivityDelaySec);
+  const bool postpone =
+      !last_user_activity_.is_null() && since_activity < activity_delay;
+  UMA_HISTOGRAM_BOOLEAN("History.ExpireIterationPostponed", postpone);
+  if (postpone) {
+    base::MessageLoop::current()->PostDelayedTask(
+        FROM_HERE,
+        base::Bind(&ExpireHistoryBackend::DoArchiveIteration,
+                   weak_factory_.GetWeakPtr()),
+        activity_delay - since_activity);
+    return;
+  }
+
   const ExpiringVisitsReader* reader = work_queue_.front();
+  const base::TimeTicks start_time = base::TimeTicks::Now();
   bool more_to_expire = ArchiveSomeOldHistory(GetCurrentArchiveTime(), reader,
-                                              kNumExpirePerIteration);
+                                              visits_per_iteration_);
+  UpdateVisitsPerIteration(base::TimeTicks::Now() - start_time);
 
   work_queue_.pop();
   // If there are more items to expire, add the reader back to the queue, thus
@@ -609,6 +647,16 @@ void ExpireHistoryBackend::DoArchiveIteration() {
   ScheduleArchive();
 }
 
+void ExpireHistoryBackend::UpdateVisitsPerIteration(base::TimeDelta elapsed) {
+  const TimeDelta budget =
+      TimeDelta::FromMilliseconds(kExpirationIterationBudgetMs);
+  if (elapsed > budget)
+    visits_per_iteration_ = std::max(1, visits_per_iteration_ / 2);
+  else if (elapsed < budget / 4)
+    visits_per_iteration_ =
+        std::min(kNumExpirePerIteration, visits_per_iteration_ * 2);
+}
+
 bool ExpireHistoryBackend::ArchiveSomeOldHistory(
     base::Time end_time,
     const ExpiringVisitsReader* reader,
@@ -616,6 +664,8 @@ bool ExpireHistoryBackend::ArchiveSomeOldHistory(
   if (!main_db_)
     return false;
 
+  const base::TimeTicks start_time = base::TimeTicks::Now();
+
   // Add an extra time unit to given end time, because
   // GetAllVisitsInRange, et al. queries' end value is non-inclusive.
   Time effective_end_time =
@@ -667,6 +717,14 @@ bool ExpireHistoryBackend::ArchiveSomeOldHistory(
   // to not do anything if nothing was deleted.
   BroadcastDeleteNotifications(&deleted_dependencies, DELETION_ARCHIVED);
 
+  UMA_HISTOGRAM_TIMES("History.ExpireIterationTime",
+                      base::TimeTicks::Now() - start_time);
+  UMA_HISTOGRAM_COUNTS_100("History.ExpireIterationVisits",
+                           affected_visits.size());
+  UMA_HISTOGRAM_COUNTS_100("History.ExpireIterationURLs",
+                           deleted_dependencies.deleted_urls.size() +
+                               archived_dependencies.deleted_urls.size());
+
   return more_to_expire;
 }
 
@@ -107,6 +107,11 @@ class ExpireHistoryBackend {
   // probably isn't useful for anything else.
   void ArchiveHistoryBefore(base::Time end_time);
 
+  // Called when the user does something that needs the history database to be
+  // responsive, such as navigating or typing in the omnibox. Periodic
+  // expiration is postponed for a short while afterwards.
+  void OnUserActivity();
+
   // Returns the current time that we are archiving stuff to. This will return
   // the threshold in absolute time rather than a delta, so the caller should
   // not save it.
@@ -119,6 +124,8 @@ class ExpireHistoryBackend {
   FRIEND_TEST_ALL_PREFIXES(ExpireHistoryTest, ArchiveSomeOldHistory);
   FRIEND_TEST_ALL_PREFIXES(ExpireHistoryTest, ExpiringVisitsReader);
   FRIEND_TEST_ALL_PREFIXES(ExpireHistoryTest, ArchiveSomeOldHistoryWithSource);
+  FRIEND_TEST_ALL_PREFIXES(ExpireHistoryTest, UserActivityPostponesArchiving);
+  FRIEND_TEST_ALL_PREFIXES(ExpireHistoryTest, ArchiveIterationBudget);
   friend class ::TestingProfile;
 
   struct DeleteDependencies;
@@ -219,9 +226,13 @@ class ExpireHistoryBackend {
 
   // Calls ArchiveSomeOldHistory to expire some amount of old history, according
   // to the items in work queue, and schedules another call to happen in the
-  // future.
+  // future. If the user was recently active, the work is postponed instead.
   void DoArchiveIteration();
 
+  // Adjusts |visits_per_iteration_| after an iteration that took |elapsed|,
+  // so that iterations stay within their time budget on slow disks.
+  void UpdateVisitsPerIteration(base::TimeDelta elapsed);
+
   // Tries to expire the oldest |max_visits| visits from history that are older
   // than |time_threshold|. The return value indicates if we think there might
   // be more history to expire with the current time threshold (it does not
@@ -275,6 +286,14 @@ class ExpireHistoryBackend {
   // iterations.
   std::queue<const ExpiringVisitsReader*> work_queue_;
 
+  // The number of visits DoArchiveIteration() asks to expire. This is
+  // kNumExpirePerIteration unless iterations have been going over their time
+  // budget, in which case it is reduced until they don't.
+  int visits_per_iteration_;
+
+  // When OnUserActivity() was last called, or null if it never was.
+  base::TimeTicks last_user_activity_;
+
   // Readers for various types of visits.
   // TODO(dglazkov): If you are adding another one, please consider reorganizing
   // into a map.
@@ -897,6 +897,52 @@ TEST_F(ExpireHistoryTest, ArchiveSomeOldHistoryWithSource) {
   EXPECT_EQ(0U, archived_visits.size());
 }
 
+// Periodic expiration should wait while the user is active, and resume from
+// the same spot afterwards.
+TEST_F(ExpireHistoryTest, UserActivityPostponesArchiving) {
+  URLID url_ids[3];
+  Time visit_times[4];
+  AddExampleData(url_ids, visit_times);
+  VisitVector visits;
+  main_db_->GetAllVisitsInRange(Time(), Time(), 0, &visits);
+  ASSERT_EQ(4U, visits.size());
+
+  // Everything older than a day and a half is old enough to expire.
+  expirer_.expiration_threshold_ = TimeDelta::FromHours(36);
+  expirer_.work_queue_.push(expirer_.GetAllVisitsReader());
+
+  expirer_.OnUserActivity();
+  expirer_.DoArchiveIteration();
+  main_db_->GetAllVisitsInRange(Time(), Time(), 0, &visits);
+  EXPECT_EQ(4U, visits.size());
+  EXPECT_EQ(1U, expirer_.work_queue_.size());
+
+  // Pretend the user has been idle for a while.
+  expirer_.last_user_activity_ = base::TimeTicks();
+  expirer_.DoArchiveIteration();
+  main_db_->GetAllVisitsInRange(Time(), Time(), 0, &visits);
+  EXPECT_EQ(2U, visits.size());
+}
+
+// Iterations that go over their time budget should expire fewer visits next
+// time, and quick ones should work back up to the full amount.
+TEST_F(ExpireHistoryTest, ArchiveIterationBudget) {
+  const int full = expirer_.visits_per_iteration_;
+  ASSERT_GT(full, 1);
+
+  expirer_.UpdateVisitsPerIteration(TimeDelta::FromSeconds(1));
+  EXPECT_EQ(full / 2, expirer_.visits_per_iteration_);
+  for (int i = 0; i < 10; ++i)
+    expirer_.UpdateVisitsPerIteration(TimeDelta::FromSeconds(1));
+  EXPECT_EQ(1, expirer_.visits_per_iteration_);
+
+  expirer_.UpdateVisitsPerIteration(TimeDelta());
+  EXPECT_EQ(2, expirer_.visits_per_iteration_);
+  for (int i = 0; i < 10; ++i)
+    expirer_.UpdateVisitsPerIteration(TimeDelta());
+  EXPECT_EQ(full, expirer_.visits_per_iteration_);
+}
+
 // TODO(brettw) add some visits with no URL to make sure everything is updated
 // properly. Have the visits also refer to nonexistent FTS rows.
 //
@@ -343,8 +343,12 @@ SegmentID HistoryBackend::UpdateSegments(
     return 0;
   }
 
-  // Finally, increase the counter for that segment / day.
-  if (!db_->IncreaseSegmentVisitCount(segment_id, ts, 1)) {
+  // Finally, increase the counter for that segment / day. Within a batch of
+  // page adds this is deferred so each counter is only written once.
+  if (pending_segment_visit_counts_.get()) {
+    ++(*pending_segment_visit_counts_)[std::make_pair(
+        segment_id, VisitSegmentDatabase::SegmentTime(ts))];
+  } else if (!db_->IncreaseSegmentVisitCount(segment_id, ts, 1)) {
     NOTREACHED();
     return 0;
   }
@@ -378,6 +382,10 @@ void HistoryBackend::AddPage(const HistoryAddPageArgs& request) {
   if (!db_)
     return;
 
+  // The user is navigating; don't make them wait on periodic expiration.
+  if (request.visit_source == SOURCE_BROWSED)
+    expirer_.OnUserActivity();
+
   // Will be filled with the URL ID and the visit ID of the last addition.
   std::pair<URLID, VisitID> last_ids(0, tracker_.GetLastVisit(
       request.id_scope, request.page_id, request.referrer));
@@ -553,6 +561,28 @@ void HistoryBackend::AddPage(const HistoryAddPageArgs& request) {
   ScheduleCommit();
 }
 
+void HistoryBackend::AddPages(
+    const std::vector<HistoryAddPageArgs>& requests) {
+  UMA_HISTOGRAM_COUNTS_100("History.AddPageBatchSize", requests.size());
+  if (!db_)
+    return;
+
+  DCHECK(!pending_segment_visit_counts_.get());
+  pending_segment_visit_counts_.reset(new SegmentVisitCounts);
+  for (std::vector<HistoryAddPageArgs>::const_iterator i = requests.begin();
+       i != requests.end(); ++i)
+    AddPage(*i);
+
+  scoped_ptr<SegmentVisitCounts> segment_visit_counts(
+      pending_segment_visit_counts_.Pass());
+  for (SegmentVisitCounts::const_iterator i = segment_visit_counts->begin();
+       i != segment_visit_counts->end(); ++i) {
+    if (!db_->IncreaseSegmentVisitCount(i->first.first, i->first.second,
+                                        i->second))
+      NOTREACHED();
+  }
+}
+
 void HistoryBackend::InitImpl(const std::string& languages) {
   DCHECK(!db_) << "Initializing HistoryBackend twice";
   // In the rare case where the db fails to initialize a dialog may get shown
@@ -1375,30 +1405,37 @@ void HistoryBackend::QueryHistoryText(URLDatabase* url_db,
   URLRows text_matches;
   url_db->GetTextMatches(text_query, &text_matches);
 
-  std::vector<URLResult> matching_visits;
+  // Only the visit times are kept for all the matching visits, so that the
+  // URLResults are only built for the visits which fit in the results.
+  // Callers page through the matches by moving |options.end_time| back.
+  typedef std::pair<base::Time, size_t> MatchingVisit;
+  std::vector<MatchingVisit> matching_visits;
   VisitVector visits;    // Declare outside loop to prevent re-construction.
   for (size_t i = 0; i < text_matches.size(); i++) {
-    const URLRow& text_match = text_matches[i];
     // Get all visits for given URL match.
-    visit_db->GetVisitsForURLWithOptions(text_match.id(), options, &visits);
-    for (size_t j = 0; j < visits.size(); j++) {
-      URLResult url_result(text_match);
-      url_result.set_visit_time(visits[j].visit_time);
-      matching_visits.push_back(url_result);
-    }
+    visit_db->GetVisitsForURLWithOptions(text_matches[i].id(), options,
+                                         &visits);
+    for (size_t j = 0; j < visits.size(); j++)
+      matching_visits.push_back(MatchingVisit(visits[j].visit_time, i));
   }
 
-  std::sort(matching_visits.begin(), matching_visits.end(),
-            URLResult::CompareVisitTime);
-
   size_t max_results = options.max_count == 0 ?
       std::numeric_limits<size_t>::max() : static_cast<int>(options.max_count);
-  for (std::vector<URLResult>::iterator it = matching_visits.begin();
-       it != matching_visits.end() && result->size() < max_results; ++it) {
-    result->AppendURLBySwapping(&(*it));
+  size_t num_results = max_results > result->size() ?
+      std::min(max_results - result->size(), matching_visits.size()) : 0;
+
+  // Most recent visits first.
+  std::partial_sort(matching_visits.begin(),
+                    matching_visits.begin() + num_results,
+                    matching_visits.end(),
+                    std::greater<MatchingVisit>());
+  for (size_t i = 0; i < num_results; ++i) {
+    URLResult url_result(text_matches[matching_visits[i].second]);
+    url_result.set_visit_time(matching_visits[i].first);
+    result->AppendURLBySwapping(&url_result);
   }
 
-  if (matching_visits.size() == result->size() &&
+  if (num_results == matching_visits.size() &&
       options.begin_time <= first_recorded_time_)
     result->set_reached_beginning(true);
 }
@@ -1658,6 +1695,8 @@ bool HistoryBackend::GetMostRecentRedirectsTo(
 
 void HistoryBackend::ScheduleAutocomplete(HistoryURLProvider* provider,
                                           HistoryURLProviderParams* params) {
+  // Hold off periodic expiration while the user is typing.
+  expirer_.OnUserActivity();
   // ExecuteWithDB should handle the NULL database case.
   provider->ExecuteWithDB(this, db_.get(), params);
 }
@@ -5,6 +5,7 @@
 #ifndef CHROME_BROWSER_HISTORY_HISTORY_BACKEND_H_
 #define CHROME_BROWSER_HISTORY_HISTORY_BACKEND_H_
 
+#include <map>
 #include <set>
 #include <string>
 #include <utility>
@@ -145,6 +146,12 @@ class HistoryBackend : public base::RefCountedThreadSafe<HistoryBackend>,
 
   // |request.time| must be unique with high probability.
   void AddPage(const HistoryAddPageArgs& request);
+
+  // Adds each of |requests| in order, as AddPage() would. Segment visit
+  // counts bumped by several of the requests are written once per segment
+  // and time slot when the whole batch has been added.
+  void AddPages(const std::vector<HistoryAddPageArgs>& requests);
+
   virtual void SetPageTitle(const GURL& url, const string16& title);
   void AddPageNoVisitForBookmark(const GURL& url, const string16& title);
 
@@ -850,6 +857,12 @@ class HistoryBackend : public base::RefCountedThreadSafe<HistoryBackend>,
   // scheduled commit at a time (see ScheduleCommit).
   scoped_refptr<CommitLaterTask> scheduled_commit_;
 
+  // While AddPages() runs, the segment visit count increments made so far by
+  // its requests, keyed by segment and time slot, for writing at the end of
+  // the batch. NULL outside of AddPages().
+  typedef std::map<std::pair<SegmentID, base::Time>, int> SegmentVisitCounts;
+  scoped_ptr<SegmentVisitCounts> pending_segment_visit_counts_;
+
   // Maps recent redirect destination pages to the chain of redirects that
   // brought us to there. Pages that did not have redirects or were not the
   // final redirect in a chain will not be in this list, as well as pages that
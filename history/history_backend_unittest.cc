@@ -17,6 +17,7 @@
 #include "base/memory/scoped_ptr.h"
 #include "base/path_service.h"
 #include "base/run_loop.h"
+#include "base/stl_util.h"
 #include "base/strings/string16.h"
 #include "base/strings/string_number_conversions.h"
 #include "base/strings/utf_string_conversions.h"
@@ -29,6 +30,7 @@
 #include "chrome/browser/history/history_service_factory.h"
 #include "chrome/browser/history/in_memory_database.h"
 #include "chrome/browser/history/in_memory_history_backend.h"
+#include "chrome/browser/history/page_usage_data.h"
 #include "chrome/browser/history/visit_filter.h"
 #include "chrome/common/chrome_constants.h"
 #include "chrome/common/chrome_paths.h"
@@ -1016,6 +1018,44 @@ TEST_F(HistoryBackendTest, AddPageArgsSource) {
   EXPECT_EQ(history::SOURCE_SYNCED, visit_sources.begin()->second);
 }
 
+// AddPages() should record the same visits and segment usage as the
+// equivalent sequence of AddPage() calls, with the segment counts for the
+// batch written once per segment.
+TEST_F(HistoryBackendTest, AddPagesBatch) {
+  ASSERT_TRUE(backend_.get());
+
+  const GURL batched_url("http://batched.com/");
+  const GURL single_url("http://single.com/");
+  const base::Time now = base::Time::Now();
+
+  std::vector<HistoryAddPageArgs> requests;
+  for (int i = 0; i < 3; ++i) {
+    HistoryAddPageArgs batched(batched_url, now, NULL, 0, GURL(),
+                               history::RedirectList(),
+                               content::PAGE_TRANSITION_TYPED,
+                               history::SOURCE_BROWSED, false);
+    requests.push_back(batched);
+    HistoryAddPageArgs single(single_url, now, NULL, 0, GURL(),
+                              history::RedirectList(),
+                              content::PAGE_TRANSITION_TYPED,
+                              history::SOURCE_BROWSED, false);
+    backend_->AddPage(single);
+  }
+  backend_->AddPages(requests);
+
+  URLRow row;
+  ASSERT_TRUE(backend_->db()->GetRowForURL(batched_url, &row));
+  EXPECT_EQ(3, row.visit_count());
+  EXPECT_EQ(3, row.typed_count());
+
+  std::vector<PageUsageData*> results;
+  backend_->db()->QuerySegmentUsage(now - base::TimeDelta::FromDays(1), 10,
+                                    &results);
+  ASSERT_EQ(2U, results.size());
+  EXPECT_DOUBLE_EQ(results[0]->GetScore(), results[1]->GetScore());
+  STLDeleteElements(&results);
+}
+
 TEST_F(HistoryBackendTest, AddVisitsSource) {
   ASSERT_TRUE(backend_.get());
 
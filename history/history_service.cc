@@ -27,6 +27,7 @@
 #include "base/location.h"
 #include "base/memory/ref_counted.h"
 #include "base/message_loop/message_loop.h"
+#include "base/metrics/histogram.h"
 #include "base/path_service.h"
 #include "base/prefs/pref_service.h"
 #include "base/thread_task_runner_handle.h"
@@ -444,6 +445,7 @@ HistoryService::Handle HistoryService::QuerySegmentDurationSince(
 }
 
 void HistoryService::FlushForTest(const base::Closure& flushed) {
+  FlushPendingPageAdds();
   thread_->message_loop_proxy()->PostTaskAndReply(
       FROM_HERE, base::Bind(&base::DoNothing), flushed);
 }
@@ -508,7 +510,17 @@ void HistoryService::AddPage(const history::HistoryAddPageArgs& add_page_args) {
     }
   }
 
-  ScheduleAndForget(PRIORITY_NORMAL, &HistoryBackend::AddPage, add_page_args);
+  // Queue the add; the first one queued schedules the flush that sends the
+  // whole batch to the backend.
+  pending_page_adds_.push_back(add_page_args);
+  UMA_HISTOGRAM_COUNTS_100("History.AddPageQueueDepth",
+                           pending_page_adds_.size());
+  if (pending_page_adds_.size() == 1) {
+    base::MessageLoop::current()->PostTask(
+        FROM_HERE,
+        base::Bind(&HistoryService::FlushPendingPageAdds,
+                   weak_ptr_factory_.GetWeakPtr()));
+  }
 }
 
 void HistoryService::AddPageNoVisitForBookmark(const GURL& url,
@@ -606,6 +618,7 @@ CancelableTaskTracker::TaskId HistoryService::GetFavicons(
 
   std::vector<chrome::FaviconBitmapResult>* results =
       new std::vector<chrome::FaviconBitmapResult>();
+  FlushPendingPageAdds();
   return tracker->PostTaskAndReply(
       thread_->message_loop_proxy().get(),
       FROM_HERE,
@@ -631,6 +644,7 @@ CancelableTaskTracker::TaskId HistoryService::GetFaviconsForURL(
 
   std::vector<chrome::FaviconBitmapResult>* results =
       new std::vector<chrome::FaviconBitmapResult>();
+  FlushPendingPageAdds();
   return tracker->PostTaskAndReply(
       thread_->message_loop_proxy().get(),
       FROM_HERE,
@@ -655,6 +669,7 @@ CancelableTaskTracker::TaskId HistoryService::GetFaviconForID(
 
   std::vector<chrome::FaviconBitmapResult>* results =
       new std::vector<chrome::FaviconBitmapResult>();
+  FlushPendingPageAdds();
   return tracker->PostTaskAndReply(
       thread_->message_loop_proxy().get(),
       FROM_HERE,
@@ -680,6 +695,7 @@ CancelableTaskTracker::TaskId HistoryService::UpdateFaviconMappingsAndFetch(
 
   std::vector<chrome::FaviconBitmapResult>* results =
       new std::vector<chrome::FaviconBitmapResult>();
+  FlushPendingPageAdds();
   return tracker->PostTaskAndReply(
       thread_->message_loop_proxy().get(),
       FROM_HERE,
@@ -761,6 +777,7 @@ void HistoryService::CreateDownload(
   DCHECK(thread_checker_.CalledOnValidThread());
   LoadBackendIfNecessary();
   bool* success = new bool(false);
+  FlushPendingPageAdds();
   thread_->message_loop_proxy()->PostTaskAndReply(
       FROM_HERE,
       base::Bind(&HistoryBackend::CreateDownload,
@@ -776,6 +793,7 @@ void HistoryService::GetNextDownloadId(
   DCHECK(thread_checker_.CalledOnValidThread());
   LoadBackendIfNecessary();
   uint32* next_id = new uint32(content::DownloadItem::kInvalidId);
+  FlushPendingPageAdds();
   thread_->message_loop_proxy()->PostTaskAndReply(
       FROM_HERE,
       base::Bind(&HistoryBackend::GetNextDownloadId,
@@ -794,6 +812,7 @@ void HistoryService::QueryDownloads(
   std::vector<history::DownloadRow>* rows =
     new std::vector<history::DownloadRow>();
   scoped_ptr<std::vector<history::DownloadRow> > scoped_rows(rows);
+  FlushPendingPageAdds();
   // Beware! The first Bind() does not simply |scoped_rows.get()| because
   // base::Passed(&scoped_rows) nullifies |scoped_rows|, and compilers do not
   // guarantee that the first Bind's arguments are evaluated before the second
@@ -982,10 +1001,25 @@ void HistoryService::ScheduleTask(SchedulePriority priority,
   DCHECK(thread_checker_.CalledOnValidThread());
   CHECK(thread_);
   CHECK(thread_->message_loop());
+  FlushPendingPageAdds();
   // TODO(brettw): Do prioritization.
   thread_->message_loop()->PostTask(FROM_HERE, task);
 }
 
+void HistoryService::FlushPendingPageAdds() {
+  DCHECK(thread_checker_.CalledOnValidThread());
+  if (pending_page_adds_.empty() || !thread_)
+    return;
+  std::vector<history::HistoryAddPageArgs> page_adds;
+  page_adds.swap(pending_page_adds_);
+  LoadBackendIfNecessary();
+  // Posted directly rather than through ScheduleTask() to avoid recursing.
+  thread_->message_loop()->PostTask(
+      FROM_HERE,
+      base::Bind(&HistoryBackend::AddPages, history_backend_.get(),
+                 page_adds));
+}
+
 // static
 bool HistoryService::CanAddURL(const GURL& url) {
   if (!url.is_valid())
@@ -1105,6 +1139,7 @@ void HistoryService::ExpireHistoryBetween(
   DCHECK(thread_);
   DCHECK(thread_checker_.CalledOnValidThread());
   DCHECK(history_backend_.get());
+  FlushPendingPageAdds();
   tracker->PostTaskAndReply(thread_->message_loop_proxy().get(),
                             FROM_HERE,
                             base::Bind(&HistoryBackend::ExpireHistoryBetween,
@@ -1122,6 +1157,7 @@ void HistoryService::ExpireHistory(
   DCHECK(thread_);
   DCHECK(thread_checker_.CalledOnValidThread());
   DCHECK(history_backend_.get());
+  FlushPendingPageAdds();
   tracker->PostTaskAndReply(
       thread_->message_loop_proxy().get(),
       FROM_HERE,
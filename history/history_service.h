@@ -815,6 +815,11 @@ class HistoryService : public CancelableRequestProvider,
   // specified priority. The task will have ownership taken.
   void ScheduleTask(SchedulePriority priority, const base::Closure& task);
 
+  // Hands any page adds queued by AddPage() to the backend as a single batch.
+  // Must be called before posting any other task to the history thread so
+  // that tasks run in the order they were requested.
+  void FlushPendingPageAdds();
+
   // Schedule ------------------------------------------------------------------
   //
   // Functions for scheduling operations on the history thread that have a
@@ -1013,6 +1018,12 @@ class HistoryService : public CancelableRequestProvider,
 
   base::ThreadChecker thread_checker_;
 
+  // Page adds requested since the last FlushPendingPageAdds(). AddPage() can
+  // be called many times in one go (for example when restoring a session), so
+  // rather than posting a history thread task per page they are queued here
+  // until the current task completes or another history task is scheduled.
+  std::vector<history::HistoryAddPageArgs> pending_page_adds_;
+
   content::NotificationRegistrar registrar_;
 
   // Some void primitives require some internal processing in the main thread
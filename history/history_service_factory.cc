@@ -8,6 +8,7 @@
 #include "chrome/browser/bookmarks/bookmark_model.h"
 #include "chrome/browser/bookmarks/bookmark_model_factory.h"
 #include "chrome/browser/history/history_service.h"
+#include "chrome/browser/performance_monitor/startup_tracer.h"
 #include "chrome/browser/profiles/incognito_helpers.h"
 #include "chrome/common/pref_names.h"
 #include "components/browser_context_keyed_service/browser_context_dependency_manager.h"
@@ -67,6 +68,8 @@ HistoryServiceFactory::~HistoryServiceFactory() {
 BrowserContextKeyedService*
 HistoryServiceFactory::BuildServiceInstanceFor(
     content::BrowserContext* context) const {
+  performance_monitor::ScopedStartupPhase startup_phase(
+      "HistoryServiceFactory::BuildServiceInstanceFor");
   Profile* profile = static_cast<Profile*>(context);
   HistoryService* history_service = new HistoryService(profile);
   if (!history_service->Init(profile->GetPath(),
@@ -4,9 +4,12 @@
 
 #include "chrome/browser/history/in_memory_url_index.h"
 
+#include <algorithm>
+
 #include "base/debug/trace_event.h"
 #include "base/file_util.h"
 #include "base/strings/utf_string_conversions.h"
+#include "base/sys_info.h"
 #include "chrome/browser/bookmarks/bookmark_model.h"
 #include "chrome/browser/bookmarks/bookmark_model_factory.h"
 #include "chrome/browser/bookmarks/bookmark_service.h"
@@ -16,6 +19,7 @@
 #include "chrome/browser/history/history_service_factory.h"
 #include "chrome/browser/history/url_database.h"
 #include "chrome/browser/history/url_index_private_data.h"
+#include "chrome/browser/omnibox/omnibox_field_trial.h"
 #include "chrome/browser/profiles/profile.h"
 #include "chrome/common/url_constants.h"
 #include "content/public/browser/browser_thread.h"
@@ -27,6 +31,10 @@ using in_memory_url_index::InMemoryURLIndexCacheItem;
 
 namespace history {
 
+// The most threads a query's candidates are scored on. Candidate sets are
+// capped at a few hundred items, so more threads buy little.
+const size_t kMaxScoringThreadCount = 4;
+
 // Called by DoSaveToCacheFile to delete any old cache file at |path| when
 // there is no private data to save. Runs on the FILE thread.
 void DeleteCacheFile(const base::FilePath& path) {
@@ -60,10 +68,12 @@ InMemoryURLIndex::RebuildPrivateDataFromHistoryDBTask::
     RebuildPrivateDataFromHistoryDBTask(
         InMemoryURLIndex* index,
         const std::string& languages,
-        const std::set<std::string>& scheme_whitelist)
+        const std::set<std::string>& scheme_whitelist,
+        bool use_compact_index)
     : index_(index),
       languages_(languages),
       scheme_whitelist_(scheme_whitelist),
+      use_compact_index_(use_compact_index),
       succeeded_(false) {
 }
 
@@ -75,6 +85,10 @@ bool InMemoryURLIndex::RebuildPrivateDataFromHistoryDBTask::RunOnDBThread(
   succeeded_ = data_.get() && !data_->Empty();
   if (!succeeded_ && data_.get())
     data_->Clear();
+  // Convert here rather than on the main thread since this is linear in the
+  // size of the index.
+  if (succeeded_)
+    data_->SetUseCompactIndex(use_compact_index_);
   return true;
 }
 
@@ -96,12 +110,20 @@ InMemoryURLIndex::InMemoryURLIndex(Profile* profile,
       history_dir_(history_dir),
       languages_(languages),
       private_data_(new URLIndexPrivateData),
+      use_compact_index_(
+          OmniboxFieldTrial::InHQPCompactIndexFieldTrialExperimentGroup()),
+      scoring_thread_count_(1),
       restore_cache_observer_(NULL),
       save_cache_observer_(NULL),
       shutdown_(false),
       restored_(false),
       needs_to_be_cached_(false) {
   InitializeSchemeWhitelist(&scheme_whitelist_);
+  if (OmniboxFieldTrial::InHQPParallelScoringFieldTrialExperimentGroup()) {
+    scoring_thread_count_ = std::min(
+        static_cast<size_t>(base::SysInfo::NumberOfProcessors()),
+        kMaxScoringThreadCount);
+  }
   if (profile) {
     // TODO(mrossetti): Register for language change notifications.
     content::Source<Profile> source(profile);
@@ -116,6 +138,8 @@ InMemoryURLIndex::InMemoryURLIndex(Profile* profile,
 InMemoryURLIndex::InMemoryURLIndex()
     : profile_(NULL),
       private_data_(new URLIndexPrivateData),
+      use_compact_index_(false),
+      scoring_thread_count_(1),
       restore_cache_observer_(NULL),
       save_cache_observer_(NULL),
       shutdown_(false),
@@ -162,11 +186,20 @@ bool InMemoryURLIndex::GetCacheFilePath(base::FilePath* file_path) {
 ScoredHistoryMatches InMemoryURLIndex::HistoryItemsForTerms(
     const string16& term_string,
     size_t cursor_position) {
+  return HistoryItemsForTerms(term_string, cursor_position, NULL);
+}
+
+ScoredHistoryMatches InMemoryURLIndex::HistoryItemsForTerms(
+    const string16& term_string,
+    size_t cursor_position,
+    ScoringCancellationFlag* cancel_flag) {
   return private_data_->HistoryItemsForTerms(
       term_string,
       cursor_position,
       languages_,
-      BookmarkModelFactory::GetForProfile(profile_));
+      BookmarkModelFactory::GetForProfile(profile_),
+      scoring_thread_count_,
+      cancel_flag);
 }
 
 // Updating --------------------------------------------------------------------
@@ -255,6 +288,7 @@ void InMemoryURLIndex::PostRestoreFromCacheFileTask() {
 void InMemoryURLIndex::OnCacheLoadDone(
     scoped_refptr<URLIndexPrivateData> private_data) {
   if (private_data.get() && !private_data->Empty()) {
+    private_data->SetUseCompactIndex(use_compact_index_);
     private_data_ = private_data;
     restored_ = true;
     if (restore_cache_observer_)
@@ -287,7 +321,7 @@ void InMemoryURLIndex::ScheduleRebuildFromHistory() {
                                            Profile::EXPLICIT_ACCESS);
   service->ScheduleDBTask(
       new InMemoryURLIndex::RebuildPrivateDataFromHistoryDBTask(
-          this, languages_, scheme_whitelist_),
+          this, languages_, scheme_whitelist_, use_compact_index_),
       &cache_reader_consumer_);
 }
 
@@ -312,6 +346,8 @@ void InMemoryURLIndex::RebuildFromHistory(HistoryDatabase* history_db) {
   private_data_ = URLIndexPrivateData::RebuildFromHistory(history_db,
                                                           languages_,
                                                           scheme_whitelist_);
+  if (private_data_.get())
+    private_data_->SetUseCompactIndex(use_compact_index_);
 }
 
 // Saving to Cache -------------------------------------------------------------
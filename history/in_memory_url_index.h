@@ -123,6 +123,13 @@ class InMemoryURLIndex : public content::NotificationObserver,
   ScoredHistoryMatches HistoryItemsForTerms(const string16& term_string,
                                             size_t cursor_position);
 
+  // As above, but gives up on scoring and returns no matches once
+  // |cancel_flag| is set.
+  ScoredHistoryMatches HistoryItemsForTerms(
+      const string16& term_string,
+      size_t cursor_position,
+      ScoringCancellationFlag* cancel_flag);
+
   // Deletes the index entry, if any, for the given |url|.
   void DeleteURL(const GURL& url);
 
@@ -156,7 +163,8 @@ class InMemoryURLIndex : public content::NotificationObserver,
     explicit RebuildPrivateDataFromHistoryDBTask(
         InMemoryURLIndex* index,
         const std::string& languages,
-        const std::set<std::string>& scheme_whitelist);
+        const std::set<std::string>& scheme_whitelist,
+        bool use_compact_index);
 
     virtual bool RunOnDBThread(HistoryBackend* backend,
                                history::HistoryDatabase* db) OVERRIDE;
@@ -168,6 +176,7 @@ class InMemoryURLIndex : public content::NotificationObserver,
     InMemoryURLIndex* index_;  // Call back to this index at completion.
     std::string languages_;  // Languages for word-breaking.
     std::set<std::string> scheme_whitelist_;  // Schemes to be indexed.
+    bool use_compact_index_;  // Whether to convert to the compact index.
     bool succeeded_;  // Indicates if the rebuild was successful.
     scoped_refptr<URLIndexPrivateData> data_;  // The rebuilt private data.
 
@@ -251,6 +260,17 @@ class InMemoryURLIndex : public content::NotificationObserver,
   // Returns the set of whitelisted schemes. For unit testing only.
   const std::set<std::string>& scheme_whitelist() { return scheme_whitelist_; }
 
+  // Selects the representation used by private data restored or rebuilt from
+  // here on. For unit testing only.
+  void set_use_compact_index(bool use_compact_index) {
+    use_compact_index_ = use_compact_index;
+  }
+
+  // Sets the number of threads queries are scored on. For unit testing only.
+  void set_scoring_thread_count(size_t scoring_thread_count) {
+    scoring_thread_count_ = scoring_thread_count;
+  }
+
   // The profile, may be null when testing.
   Profile* profile_;
 
@@ -268,6 +288,13 @@ class InMemoryURLIndex : public content::NotificationObserver,
   // The index's durable private data.
   scoped_refptr<URLIndexPrivateData> private_data_;
 
+  // Whether |private_data_| should use its compact index representation.
+  bool use_compact_index_;
+
+  // The number of threads, including the calling one, across which the
+  // candidates of a query are scored.
+  size_t scoring_thread_count_;
+
   // Observers to notify upon restoral or save of the private data cache.
   RestoreCacheObserver* restore_cache_observer_;
   SaveCacheObserver* save_cache_observer_;
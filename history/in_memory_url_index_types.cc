@@ -144,6 +144,27 @@ Char16Set Char16SetFromString16(const string16& term) {
   return characters;
 }
 
+namespace {
+
+// Orders CompactCharWordIDMap entries by their character.
+bool CharWordEntryLess(const std::pair<char16, WordIDVector>& entry,
+                       char16 uni_char) {
+  return entry.first < uni_char;
+}
+
+}  // namespace
+
+const WordIDVector* FindInCompactCharWordIDMap(
+    const CompactCharWordIDMap& char_word_map,
+    char16 uni_char) {
+  CompactCharWordIDMap::const_iterator pos =
+      std::lower_bound(char_word_map.begin(), char_word_map.end(), uni_char,
+                       CharWordEntryLess);
+  if (pos == char_word_map.end() || pos->first != uni_char)
+    return NULL;
+  return &pos->second;
+}
+
 // HistoryInfoMapValue ---------------------------------------------------------
 
 HistoryInfoMapValue::HistoryInfoMapValue() {}
@@ -5,11 +5,17 @@
 #ifndef CHROME_BROWSER_HISTORY_IN_MEMORY_URL_INDEX_TYPES_H_
 #define CHROME_BROWSER_HISTORY_IN_MEMORY_URL_INDEX_TYPES_H_
 
+#include <algorithm>
+#include <iterator>
 #include <map>
 #include <set>
+#include <utility>
 #include <vector>
 
+#include "base/logging.h"
+#include "base/memory/ref_counted.h"
 #include "base/strings/string16.h"
+#include "base/synchronization/cancellation_flag.h"
 #include "chrome/browser/autocomplete/history_provider_util.h"
 #include "chrome/browser/history/history_types.h"
 #include "url/gurl.h"
@@ -150,6 +156,98 @@ typedef std::vector<HistoryID> HistoryIDVector;
 typedef std::map<WordID, HistoryIDSet> WordIDHistoryMap;
 typedef std::map<HistoryID, WordIDSet> HistoryIDWordMap;
 
+// Compact index representation. Rather than using red-black trees for the
+// character and word indexes, these keep each set of IDs in a contiguous,
+// sorted and duplicate-free vector. This drastically reduces the per-entry
+// overhead and improves cache locality during set intersection.
+
+// A sorted vector of WordIDs.
+typedef std::vector<WordID> WordIDVector;
+
+// A vector of (character, words containing that character) pairs sorted by
+// character. The WordIDVector of each entry is sorted.
+typedef std::vector<std::pair<char16, WordIDVector> > CompactCharWordIDMap;
+
+// A vector indexed by WordID giving the sorted HistoryIDs of the history
+// items containing that word. Unused word slots have empty vectors.
+typedef std::vector<HistoryIDVector> CompactWordIDHistoryMap;
+
+// Inserts |value| into the sorted vector |ids| if not already present.
+// Returns true if |value| was inserted.
+template<typename T>
+bool InsertIntoSortedVector(std::vector<T>* ids, const T& value) {
+  typename std::vector<T>::iterator pos =
+      std::lower_bound(ids->begin(), ids->end(), value);
+  if (pos != ids->end() && *pos == value)
+    return false;
+  ids->insert(pos, value);
+  return true;
+}
+
+// Removes |value| from the sorted vector |ids|. Returns true if |value| was
+// present.
+template<typename T>
+bool EraseFromSortedVector(std::vector<T>* ids, const T& value) {
+  typename std::vector<T>::iterator pos =
+      std::lower_bound(ids->begin(), ids->end(), value);
+  if (pos == ids->end() || *pos != value)
+    return false;
+  ids->erase(pos);
+  return true;
+}
+
+// Intersects the two sorted vectors |a| and |b|, replacing the contents of
+// |result| with the sorted intersection. |result| must not alias either
+// input. When one input is much smaller than the other this gallops through
+// the larger input (exponential probe followed by a binary search) so that
+// the cost is O(small * log(large)) rather than O(small + large).
+template<typename T>
+void IntersectSortedVectors(const std::vector<T>& a,
+                            const std::vector<T>& b,
+                            std::vector<T>* result) {
+  DCHECK(result != &a && result != &b);
+  result->clear();
+  const std::vector<T>& smaller = (a.size() <= b.size()) ? a : b;
+  const std::vector<T>& larger = (a.size() <= b.size()) ? b : a;
+  if (smaller.empty())
+    return;
+  result->reserve(smaller.size());
+
+  // A roughly even split is handled best by a plain linear merge.
+  const size_t kGallopRatio = 8;
+  if (larger.size() < smaller.size() * kGallopRatio) {
+    std::set_intersection(smaller.begin(), smaller.end(),
+                          larger.begin(), larger.end(),
+                          std::back_inserter(*result));
+    return;
+  }
+
+  typename std::vector<T>::const_iterator low = larger.begin();
+  for (typename std::vector<T>::const_iterator iter = smaller.begin();
+       iter != smaller.end() && low != larger.end(); ++iter) {
+    // Gallop forward until we bracket the value being sought.
+    size_t step = 1;
+    typename std::vector<T>::const_iterator high = low;
+    while (high != larger.end() && *high < *iter) {
+      low = high;
+      size_t remaining = larger.end() - high;
+      high += std::min(step, remaining);
+      step <<= 1;
+    }
+    low = std::lower_bound(low, high, *iter);
+    if (low != larger.end() && *low == *iter) {
+      result->push_back(*iter);
+      ++low;
+    }
+  }
+}
+
+// Returns the entry for |uni_char| in |char_word_map| or NULL if there is
+// none.
+const WordIDVector* FindInCompactCharWordIDMap(
+    const CompactCharWordIDMap& char_word_map,
+    char16 uni_char);
+
 
 // Information used in scoring a particular URL.
 typedef std::vector<VisitInfo> VisitInfoVector;
@@ -183,6 +281,10 @@ struct RowWordStarts {
 };
 typedef std::map<HistoryID, RowWordStarts> WordStartsMap;
 
+// A flag shared between a query and the threads scoring its candidates.
+// Setting it abandons any scoring that has not yet been done.
+typedef base::RefCountedData<base::CancellationFlag> ScoringCancellationFlag;
+
 }  // namespace history
 
 #endif  // CHROME_BROWSER_HISTORY_IN_MEMORY_URL_INDEX_TYPES_H_
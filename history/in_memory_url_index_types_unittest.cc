@@ -3,6 +3,7 @@
 // found in the LICENSE file.
 
 #include <algorithm>
+#include <iterator>
 
 #include "base/strings/string16.h"
 #include "base/strings/utf_string_conversions.h"
@@ -144,4 +145,69 @@ TEST_F(InMemoryURLIndexTypesTest, OffsetsAndTermMatches) {
     EXPECT_EQ(expected_offsets_b[i], matches_b[i].offset);
 }
 
+TEST_F(InMemoryURLIndexTypesTest, SortedVectorFunctions) {
+  // Test InsertIntoSortedVector and EraseFromSortedVector.
+  HistoryIDVector ids;
+  EXPECT_TRUE(InsertIntoSortedVector(&ids, static_cast<HistoryID>(7)));
+  EXPECT_TRUE(InsertIntoSortedVector(&ids, static_cast<HistoryID>(3)));
+  EXPECT_TRUE(InsertIntoSortedVector(&ids, static_cast<HistoryID>(5)));
+  EXPECT_FALSE(InsertIntoSortedVector(&ids, static_cast<HistoryID>(5)));
+  ASSERT_EQ(3U, ids.size());
+  EXPECT_EQ(3, ids[0]);
+  EXPECT_EQ(5, ids[1]);
+  EXPECT_EQ(7, ids[2]);
+  EXPECT_TRUE(EraseFromSortedVector(&ids, static_cast<HistoryID>(5)));
+  EXPECT_FALSE(EraseFromSortedVector(&ids, static_cast<HistoryID>(5)));
+  ASSERT_EQ(2U, ids.size());
+  EXPECT_EQ(3, ids[0]);
+  EXPECT_EQ(7, ids[1]);
+
+  // Test IntersectSortedVectors with similarly sized inputs, which uses a
+  // linear merge.
+  const size_t a_array[] = {1, 3, 5, 7, 9};
+  const size_t b_array[] = {2, 3, 4, 5, 6};
+  WordIDVector a(a_array, a_array + arraysize(a_array));
+  WordIDVector b(b_array, b_array + arraysize(b_array));
+  WordIDVector result;
+  IntersectSortedVectors(a, b, &result);
+  const size_t expected_ab[] = {3, 5};
+  EXPECT_TRUE(IntArraysEqual(expected_ab, arraysize(expected_ab), result));
+
+  // Test IntersectSortedVectors with very different sizes, which gallops
+  // through the larger input. Compare against std::set_intersection.
+  WordIDVector short_ids;
+  short_ids.push_back(0);
+  short_ids.push_back(17);
+  short_ids.push_back(500);
+  short_ids.push_back(998);
+  short_ids.push_back(1001);
+  WordIDVector long_ids;
+  for (WordID i = 0; i < 1000; i += 2)
+    long_ids.push_back(i);
+  IntersectSortedVectors(short_ids, long_ids, &result);
+  WordIDVector expected;
+  std::set_intersection(short_ids.begin(), short_ids.end(),
+                        long_ids.begin(), long_ids.end(),
+                        std::back_inserter(expected));
+  EXPECT_EQ(expected, result);
+  // The order of the arguments does not matter.
+  IntersectSortedVectors(long_ids, short_ids, &result);
+  EXPECT_EQ(expected, result);
+
+  // An empty input gives an empty result.
+  IntersectSortedVectors(WordIDVector(), long_ids, &result);
+  EXPECT_TRUE(result.empty());
+
+  // Test FindInCompactCharWordIDMap.
+  CompactCharWordIDMap char_word_map;
+  char_word_map.push_back(std::make_pair(static_cast<char16>('a'), a));
+  char_word_map.push_back(std::make_pair(static_cast<char16>('c'), b));
+  ASSERT_TRUE(FindInCompactCharWordIDMap(char_word_map, 'a'));
+  EXPECT_EQ(a, *FindInCompactCharWordIDMap(char_word_map, 'a'));
+  ASSERT_TRUE(FindInCompactCharWordIDMap(char_word_map, 'c'));
+  EXPECT_EQ(b, *FindInCompactCharWordIDMap(char_word_map, 'c'));
+  EXPECT_FALSE(FindInCompactCharWordIDMap(char_word_map, 'b'));
+  EXPECT_FALSE(FindInCompactCharWordIDMap(char_word_map, 'z'));
+}
+
 }  // namespace history
@@ -13,6 +13,7 @@
 #include "base/path_service.h"
 #include "base/strings/string16.h"
 #include "base/strings/string_util.h"
+#include "base/strings/stringprintf.h"
 #include "base/strings/utf_string_conversions.h"
 #include "chrome/browser/autocomplete/autocomplete_provider.h"
 #include "chrome/browser/bookmarks/bookmark_test_helpers.h"
@@ -99,6 +100,8 @@ class InMemoryURLIndexTest : public testing::Test {
   URLIndexPrivateData* GetPrivateData() const;
   void ClearPrivateData();
   void set_history_dir(const base::FilePath& dir_path);
+  void set_use_compact_index(bool use_compact_index);
+  void set_scoring_thread_count(size_t scoring_thread_count);
   bool GetCacheFilePath(base::FilePath* file_path) const;
   void PostRestoreFromCacheFileTask();
   void PostSaveToCacheFileTask();
@@ -150,6 +153,15 @@ void InMemoryURLIndexTest::set_history_dir(const base::FilePath& dir_path) {
   return url_index_->set_history_dir(dir_path);
 }
 
+void InMemoryURLIndexTest::set_use_compact_index(bool use_compact_index) {
+  url_index_->set_use_compact_index(use_compact_index);
+}
+
+void InMemoryURLIndexTest::set_scoring_thread_count(
+    size_t scoring_thread_count) {
+  url_index_->set_scoring_thread_count(scoring_thread_count);
+}
+
 bool InMemoryURLIndexTest::GetCacheFilePath(base::FilePath* file_path) const {
   DCHECK(file_path);
   return url_index_->GetCacheFilePath(file_path);
@@ -667,6 +679,49 @@ TEST_F(InMemoryURLIndexTest, HugeResultSet) {
             private_data.post_scoring_item_count_);
 }
 
+TEST_F(InMemoryURLIndexTest, ParallelScoring) {
+  // Create a large set of qualifying history items with a spread of scores,
+  // including plenty of ties.
+  for (URLID row_id = 5000; row_id < 5400; ++row_id) {
+    URLRow new_row(GURL(base::StringPrintf(
+        "http://www.brokeandaloneinmanitoba.com/page%d", row_id % 50)),
+        row_id);
+    new_row.set_visit_count(row_id % 7 + 1);
+    new_row.set_typed_count(row_id % 3);
+    new_row.set_last_visit(
+        base::Time::Now() - base::TimeDelta::FromDays(row_id % 11));
+    EXPECT_TRUE(UpdateURL(new_row));
+  }
+
+  const char* kQueries[] = { "b", "broke manitoba", "page1", "www.b" };
+  for (size_t i = 0; i < arraysize(kQueries); ++i) {
+    SCOPED_TRACE(kQueries[i]);
+    set_scoring_thread_count(1);
+    ScoredHistoryMatches sequential = url_index_->HistoryItemsForTerms(
+        ASCIIToUTF16(kQueries[i]), string16::npos);
+    set_scoring_thread_count(4);
+    ScoredHistoryMatches parallel = url_index_->HistoryItemsForTerms(
+        ASCIIToUTF16(kQueries[i]), string16::npos);
+    ASSERT_EQ(sequential.size(), parallel.size());
+    for (size_t j = 0; j < sequential.size(); ++j) {
+      EXPECT_EQ(sequential[j].url_info.id(), parallel[j].url_info.id());
+      EXPECT_EQ(sequential[j].raw_score, parallel[j].raw_score);
+    }
+  }
+
+  // A query whose scoring has been canceled returns nothing, however it was
+  // scored.
+  scoped_refptr<ScoringCancellationFlag> cancel_flag(
+      new ScoringCancellationFlag);
+  cancel_flag->data.Set();
+  set_scoring_thread_count(1);
+  EXPECT_TRUE(url_index_->HistoryItemsForTerms(
+      ASCIIToUTF16("b"), string16::npos, cancel_flag.get()).empty());
+  set_scoring_thread_count(4);
+  EXPECT_TRUE(url_index_->HistoryItemsForTerms(
+      ASCIIToUTF16("b"), string16::npos, cancel_flag.get()).empty());
+}
+
 TEST_F(InMemoryURLIndexTest, TitleSearch) {
   // Signal if someone has changed the test DB.
   EXPECT_EQ(29U, GetPrivateData()->history_info_map_.size());
@@ -807,6 +862,53 @@ TEST_F(InMemoryURLIndexTest, TypedCharacterCaching) {
   CheckTerm(cache, ASCIIToUTF16("rec"));
 }
 
+TEST_F(InMemoryURLIndexTest, TypedCharacterCachingAcrossUpdates) {
+  URLIndexPrivateData& private_data(*GetPrivateData());
+  URLIndexPrivateData::SearchTermCacheMap& cache(
+      private_data.search_term_cache_);
+
+  ScoredHistoryMatches matches =
+      url_index_->HistoryItemsForTerms(ASCIIToUTF16("mo"), string16::npos);
+  size_t initial_match_count = matches.size();
+  EXPECT_EQ(0U, private_data.search_term_cache_hits());
+  EXPECT_EQ(1U, private_data.search_term_cache_misses());
+
+  // A row visited in the background between keystrokes is patched into the
+  // cached term rather than flushing it.
+  URLRow new_row(GURL("http://www.mortgagemonkeys.com/"), 87654321);
+  new_row.set_last_visit(base::Time::Now());
+  EXPECT_TRUE(UpdateURL(new_row));
+  ASSERT_EQ(1U, cache.size());
+  CheckTerm(cache, ASCIIToUTF16("mo"));
+  EXPECT_EQ(1U, cache[ASCIIToUTF16("mo")].history_id_set_.count(87654321));
+
+  // The next keystroke starts from the cached "mo".
+  matches =
+      url_index_->HistoryItemsForTerms(ASCIIToUTF16("mor"), string16::npos);
+  EXPECT_EQ(1U, private_data.search_term_cache_hits());
+  EXPECT_EQ(1U, private_data.search_term_cache_misses());
+  URLIndexPrivateData::SearchTermCacheItem patched_item(
+      cache[ASCIIToUTF16("mor")]);
+  EXPECT_EQ(1U, patched_item.history_id_set_.count(87654321));
+
+  // The patched entry must match what a query without the cache would find.
+  cache.clear();
+  url_index_->HistoryItemsForTerms(ASCIIToUTF16("mor"), string16::npos);
+  EXPECT_TRUE(patched_item.history_id_set_ ==
+              cache[ASCIIToUTF16("mor")].history_id_set_);
+  EXPECT_TRUE(patched_item.word_id_set_ ==
+              cache[ASCIIToUTF16("mor")].word_id_set_);
+
+  // Deleting the row removes it, and its now unused words, from the cache.
+  EXPECT_TRUE(url_index_->DeleteURL(new_row.url()));
+  EXPECT_EQ(0U, cache[ASCIIToUTF16("mor")].history_id_set_.count(87654321));
+  matches =
+      url_index_->HistoryItemsForTerms(ASCIIToUTF16("mo"), string16::npos);
+  EXPECT_EQ(initial_match_count, matches.size());
+  EXPECT_EQ(1U, private_data.search_term_cache_hits());
+  EXPECT_EQ(3U, private_data.search_term_cache_misses());
+}
+
 TEST_F(InMemoryURLIndexTest, AddNewRows) {
   // Verify that the row we're going to add does not already exist.
   URLID new_row_id = 87654321;
@@ -1057,6 +1159,146 @@ TEST_F(InMemoryURLIndexTest, CacheSaveRestore) {
   ExpectPrivateDataEqual(*old_data.get(), new_data);
 }
 
+TEST_F(InMemoryURLIndexTest, CompactIndex) {
+  // A selection of terms exercising single characters, cached prefixes,
+  // multiple terms and terms with no results.
+  const char* kTerms[] = {
+    "b", "r", "re", "reco", "mort", "mortgage rate", "drudge", "ABRA",
+    "ABRACADABRA", "http www", "atdmt view", "view.atdmt", "zzzzzz",
+    "lebronomics could high taxes influence",
+  };
+  // The terms are queried twice, the second time from the search term cache.
+  const size_t kIterations = 2;
+
+  // Capture the results using the std::map-based index.
+  URLIndexPrivateData& private_data(*GetPrivateData());
+  ASSERT_FALSE(private_data.use_compact_index());
+  std::vector<ScoredHistoryMatches> expected_matches;
+  for (size_t i = 0; i < kIterations; ++i) {
+    for (size_t j = 0; j < arraysize(kTerms); ++j) {
+      ScoredHistoryMatches matches = url_index_->HistoryItemsForTerms(
+          ASCIIToUTF16(kTerms[j]), string16::npos);
+      if (i == 0)
+        expected_matches.push_back(matches);
+    }
+  }
+  size_t map_bytes = private_data.EstimateIndexMemoryUsage();
+  scoped_refptr<URLIndexPrivateData> map_data(private_data.Duplicate());
+
+  // Switch to the compact index and verify that the results are identical.
+  private_data.SetUseCompactIndex(true);
+  EXPECT_TRUE(private_data.use_compact_index());
+  EXPECT_TRUE(private_data.char_word_map_.empty());
+  EXPECT_TRUE(private_data.word_id_history_map_.empty());
+  EXPECT_FALSE(private_data.compact_char_word_map_.empty());
+  EXPECT_FALSE(private_data.compact_word_id_history_map_.empty());
+  for (size_t i = 0; i < kIterations; ++i) {
+    for (size_t j = 0; j < arraysize(kTerms); ++j) {
+      ScoredHistoryMatches matches = url_index_->HistoryItemsForTerms(
+          ASCIIToUTF16(kTerms[j]), string16::npos);
+      const ScoredHistoryMatches& expected(expected_matches[j]);
+      ASSERT_EQ(expected.size(), matches.size()) << kTerms[j];
+      for (size_t k = 0; k < matches.size(); ++k) {
+        EXPECT_EQ(expected[k].url_info.id(), matches[k].url_info.id());
+        EXPECT_EQ(expected[k].raw_score, matches[k].raw_score);
+      }
+    }
+  }
+  EXPECT_LT(private_data.EstimateIndexMemoryUsage(), map_bytes);
+
+  // Updates made while in compact mode must leave the index in the same state
+  // as the same updates made to the std::map-based index.
+  URLRow new_row(GURL("http://www.brokeandaloneinmanitoba.com/"), 87654321);
+  new_row.set_last_visit(base::Time::Now());
+  EXPECT_TRUE(UpdateURL(new_row));
+  EXPECT_EQ(1U, url_index_->HistoryItemsForTerms(
+      ASCIIToUTF16("brokeandalone"), string16::npos).size());
+  ScoredHistoryMatches matches = url_index_->HistoryItemsForTerms(
+      ASCIIToUTF16("DrudgeReport"), string16::npos);
+  ASSERT_EQ(1U, matches.size());
+  GURL deleted_url(matches[0].url_info.url());
+  EXPECT_TRUE(DeleteURL(deleted_url));
+  EXPECT_TRUE(url_index_->HistoryItemsForTerms(
+      ASCIIToUTF16("DrudgeReport"), string16::npos).empty());
+
+  EXPECT_TRUE(map_data->UpdateURL(history_service_, new_row, "en,ja,hi,zh",
+                                  scheme_whitelist()));
+  EXPECT_TRUE(map_data->DeleteURL(deleted_url));
+  private_data.SetUseCompactIndex(false);
+  EXPECT_TRUE(private_data.compact_char_word_map_.empty());
+  EXPECT_TRUE(private_data.compact_word_id_history_map_.empty());
+  ExpectPrivateDataEqual(*map_data.get(), private_data);
+}
+
+TEST_F(InMemoryURLIndexTest, FlatCacheSaveRestore) {
+  base::ScopedTempDir temp_directory;
+  ASSERT_TRUE(temp_directory.CreateUniqueTempDir());
+  set_history_dir(temp_directory.path());
+  base::FilePath cache_path;
+  ASSERT_TRUE(GetCacheFilePath(&cache_path));
+
+  // Start by saving a protobuf cache using the std::map-based index.
+  scoped_refptr<URLIndexPrivateData> old_data(GetPrivateData()->Duplicate());
+  CacheFileSaverObserver save_observer(&message_loop_);
+  url_index_->set_save_cache_observer(&save_observer);
+  PostSaveToCacheFileTask();
+  message_loop_.Run();
+  EXPECT_TRUE(save_observer.succeeded_);
+  std::string contents;
+  ASSERT_TRUE(base::ReadFileToString(cache_path, &contents));
+  EXPECT_FALSE(URLIndexPrivateData::IsFlatCacheData(
+      reinterpret_cast<const uint8*>(contents.data()), contents.size()));
+
+  // Restoring the protobuf cache with the compact index enabled migrates the
+  // data to the compact index.
+  set_use_compact_index(true);
+  ClearPrivateData();
+  HistoryIndexRestoreObserver restore_observer(
+      base::Bind(&base::MessageLoop::Quit, base::Unretained(&message_loop_)));
+  url_index_->set_restore_cache_observer(&restore_observer);
+  PostRestoreFromCacheFileTask();
+  message_loop_.Run();
+  EXPECT_TRUE(restore_observer.succeeded());
+  EXPECT_TRUE(GetPrivateData()->use_compact_index());
+
+  // Saving now writes the flat format.
+  PostSaveToCacheFileTask();
+  message_loop_.Run();
+  EXPECT_TRUE(save_observer.succeeded_);
+  ASSERT_TRUE(base::ReadFileToString(cache_path, &contents));
+  EXPECT_TRUE(URLIndexPrivateData::IsFlatCacheData(
+      reinterpret_cast<const uint8*>(contents.data()), contents.size()));
+
+  // Restore from the flat cache and verify the contents.
+  ClearPrivateData();
+  HistoryIndexRestoreObserver flat_restore_observer(
+      base::Bind(&base::MessageLoop::Quit, base::Unretained(&message_loop_)));
+  url_index_->set_restore_cache_observer(&flat_restore_observer);
+  PostRestoreFromCacheFileTask();
+  message_loop_.Run();
+  EXPECT_TRUE(flat_restore_observer.succeeded());
+  URLIndexPrivateData& new_data(*GetPrivateData());
+  EXPECT_TRUE(new_data.use_compact_index());
+  EXPECT_EQ(kCurrentCacheFileVersion, new_data.restored_cache_version_);
+  EXPECT_EQ(old_data->last_time_rebuilt_from_history_,
+            new_data.last_time_rebuilt_from_history_);
+  EXPECT_EQ(1U, url_index_->HistoryItemsForTerms(
+      ASCIIToUTF16("MORTGAGE RATE DROPS"), string16::npos).size());
+  new_data.SetUseCompactIndex(false);
+  ExpectPrivateDataEqual(*old_data.get(), new_data);
+
+  // A truncated flat cache must be rejected rather than partially restored.
+  ASSERT_GT(contents.size(), 16U);
+  scoped_refptr<URLIndexPrivateData> truncated_data(new URLIndexPrivateData);
+  EXPECT_FALSE(truncated_data->RestoreFromFlatData(
+      reinterpret_cast<const uint8*>(contents.data()), contents.size() - 1));
+  ASSERT_EQ(static_cast<int>(contents.size() / 2),
+            file_util::WriteFile(cache_path, contents.data(),
+                                 contents.size() / 2));
+  EXPECT_FALSE(URLIndexPrivateData::RestoreFromFile(cache_path,
+                                                    "en,ja,hi,zh").get());
+}
+
 TEST_F(InMemoryURLIndexTest, RebuildFromHistoryIfCacheOld) {
   base::ScopedTempDir temp_directory;
   ASSERT_TRUE(temp_directory.CreateUniqueTempDir());
@@ -243,6 +243,29 @@ bool ScoredHistoryMatch::MatchScoreGreater(const ScoredHistoryMatch& m1,
   return m1.url_info.last_visit() > m2.url_info.last_visit();
 }
 
+// static
+bool ScoredHistoryMatch::MatchScoreGreaterWithIDTieBreak(
+    const ScoredHistoryMatch& m1,
+    const ScoredHistoryMatch& m2) {
+  if (MatchScoreGreater(m1, m2))
+    return true;
+  if (MatchScoreGreater(m2, m1))
+    return false;
+  return m1.url_info.id() < m2.url_info.id();
+}
+
+// static
+void ScoredHistoryMatch::InitializeStaticTables() {
+  if (!initialized_) {
+    InitializeAlsoDoHUPLikeScoringFieldAndMaxScoreField();
+    initialized_ = true;
+  }
+  // Looking up any score builds the corresponding table.
+  GetRecencyScore(0);
+  GetTopicalityScore(1, string16(), TermMatches(), TermMatches(),
+                     RowWordStarts());
+}
+
 // static
 float ScoredHistoryMatch::GetTopicalityScore(
     const int num_terms,
@@ -250,16 +273,16 @@ float ScoredHistoryMatch::GetTopicalityScore(
     const TermMatches& url_matches,
     const TermMatches& title_matches,
     const RowWordStarts& word_starts) {
-  // Because the below thread is not thread safe, we check that we're
-  // only calling it from one thread: the UI thread.  Specifically,
-  // we check "if we've heard of the UI thread then we'd better
-  // be on it."  The first part is necessary so unit tests pass.  (Many
-  // unit tests don't set up the threading naming system; hence
-  // CurrentlyOn(UI thread) will fail.)
-  DCHECK(!content::BrowserThread::IsThreadInitialized(
-             content::BrowserThread::UI) ||
-         content::BrowserThread::CurrentlyOn(content::BrowserThread::UI));
   if (raw_term_score_to_topicality_score == NULL) {
+    // Because the below code is not thread safe, we check that we're
+    // only calling it from one thread: the UI thread.  Specifically,
+    // we check "if we've heard of the UI thread then we'd better
+    // be on it."  The first part is necessary so unit tests pass.  (Many
+    // unit tests don't set up the threading naming system; hence
+    // CurrentlyOn(UI thread) will fail.)
+    DCHECK(!content::BrowserThread::IsThreadInitialized(
+               content::BrowserThread::UI) ||
+           content::BrowserThread::CurrentlyOn(content::BrowserThread::UI));
     raw_term_score_to_topicality_score = new float[kMaxRawTermScore];
     FillInTermScoreToTopicalityScoreArray();
   }
@@ -394,16 +417,16 @@ float* ScoredHistoryMatch::days_ago_to_recency_score = NULL;
 
 // static
 float ScoredHistoryMatch::GetRecencyScore(int last_visit_days_ago) {
-  // Because the below thread is not thread safe, we check that we're
-  // only calling it from one thread: the UI thread.  Specifically,
-  // we check "if we've heard of the UI thread then we'd better
-  // be on it."  The first part is necessary so unit tests pass.  (Many
-  // unit tests don't set up the threading naming system; hence
-  // CurrentlyOn(UI thread) will fail.)
-  DCHECK(!content::BrowserThread::IsThreadInitialized(
-             content::BrowserThread::UI) ||
-         content::BrowserThread::CurrentlyOn(content::BrowserThread::UI));
   if (days_ago_to_recency_score == NULL) {
+    // Because the below code is not thread safe, we check that we're
+    // only calling it from one thread: the UI thread.  Specifically,
+    // we check "if we've heard of the UI thread then we'd better
+    // be on it."  The first part is necessary so unit tests pass.  (Many
+    // unit tests don't set up the threading naming system; hence
+    // CurrentlyOn(UI thread) will fail.)
+    DCHECK(!content::BrowserThread::IsThreadInitialized(
+               content::BrowserThread::UI) ||
+           content::BrowserThread::CurrentlyOn(content::BrowserThread::UI));
     days_ago_to_recency_score = new float[kDaysToPrecomputeRecencyScoresFor];
     FillInDaysAgoToRecencyScoreArray();
   }
@@ -49,6 +49,16 @@ struct ScoredHistoryMatch : public history::HistoryMatch {
   static bool MatchScoreGreater(const ScoredHistoryMatch& m1,
                                 const ScoredHistoryMatch& m2);
 
+  // Like MatchScoreGreater() but breaks any remaining ties by URL ID so that
+  // the resulting order does not depend on the order in which the matches
+  // were produced.
+  static bool MatchScoreGreaterWithIDTieBreak(const ScoredHistoryMatch& m1,
+                                              const ScoredHistoryMatch& m2);
+
+  // Builds the lazily-computed lookup tables used during scoring. Must be
+  // called on the UI thread before matches are scored on any other thread.
+  static void InitializeStaticTables();
+
   // Return a topicality score based on how many matches appear in the
   // |url| and the page's title and where they are (e.g., at word
   // boundaries).  |url_matches| and |title_matches| provide details
@@ -4,6 +4,8 @@
 
 #include "chrome/browser/history/shortcuts_backend.h"
 
+#include <algorithm>
+#include <cmath>
 #include <map>
 #include <string>
 #include <vector>
@@ -12,6 +14,7 @@
 #include "base/bind_helpers.h"
 #include "base/guid.h"
 #include "base/i18n/case_conversion.h"
+#include "base/logging.h"
 #include "base/strings/string_util.h"
 #include "chrome/browser/autocomplete/autocomplete_match.h"
 #include "chrome/browser/autocomplete/autocomplete_result.h"
@@ -43,6 +46,10 @@ ACMatchClassifications StripMatchMarkers(
   return unmatched;
 }
 
+// See ShortcutsBackend::GetDecaySpeedDivisor().
+const double kMaxDecaySpeedDivisor = 5.0;
+const double kNumUsesPerDecaySpeedDivisorIncrement = 5.0;
+
 }  // namespace
 
 namespace history {
@@ -126,8 +133,19 @@ ShortcutsBackend::Shortcut::~Shortcut() {
 }
 
 
+// ShortcutsBackend::RankedShortcuts ------------------------------------------
+
+ShortcutsBackend::RankedShortcuts::RankedShortcuts() : count(0) {
+}
+
+ShortcutsBackend::RankedShortcuts::~RankedShortcuts() {
+}
+
 // ShortcutsBackend -----------------------------------------------------------
 
+const size_t ShortcutsBackend::kMaxShortcutsToScan = 50;
+const size_t ShortcutsBackend::kMaxCandidatesPerDecayRate = 3;
+
 ShortcutsBackend::ShortcutsBackend(Profile* profile, bool suppress_db)
     : current_state_(NOT_INITIALIZED),
       no_db_access_(suppress_db) {
@@ -162,8 +180,7 @@ bool ShortcutsBackend::AddShortcut(const Shortcut& shortcut) {
   if (!initialized())
     return false;
   DCHECK(guid_map_.find(shortcut.id) == guid_map_.end());
-  guid_map_[shortcut.id] = shortcuts_map_.insert(
-      std::make_pair(base::i18n::ToLower(shortcut.text), shortcut));
+  guid_map_[shortcut.id] = InsertShortcut(shortcut);
   FOR_EACH_OBSERVER(ShortcutsBackendObserver, observer_list_,
                     OnShortcutsChanged());
   return no_db_access_ || BrowserThread::PostTask(BrowserThread::DB, FROM_HERE,
@@ -176,9 +193,8 @@ bool ShortcutsBackend::UpdateShortcut(const Shortcut& shortcut) {
     return false;
   GuidMap::iterator it(guid_map_.find(shortcut.id));
   if (it != guid_map_.end())
-    shortcuts_map_.erase(it->second);
-  guid_map_[shortcut.id] = shortcuts_map_.insert(
-      std::make_pair(base::i18n::ToLower(shortcut.text), shortcut));
+    EraseShortcut(it->second);
+  guid_map_[shortcut.id] = InsertShortcut(shortcut);
   FOR_EACH_OBSERVER(ShortcutsBackendObserver, observer_list_,
                     OnShortcutsChanged());
   return no_db_access_ || BrowserThread::PostTask(BrowserThread::DB, FROM_HERE,
@@ -193,7 +209,7 @@ bool ShortcutsBackend::DeleteShortcutsWithIds(
   for (size_t i = 0; i < shortcut_ids.size(); ++i) {
     GuidMap::iterator it(guid_map_.find(shortcut_ids[i]));
     if (it != guid_map_.end()) {
-      shortcuts_map_.erase(it->second);
+      EraseShortcut(it->second);
       guid_map_.erase(it);
     }
   }
@@ -213,6 +229,7 @@ bool ShortcutsBackend::DeleteAllShortcuts() {
     return false;
   shortcuts_map_.clear();
   guid_map_.clear();
+  prefix_index_.clear();
   FOR_EACH_OBSERVER(ShortcutsBackendObserver, observer_list_,
                     OnShortcutsChanged());
   return no_db_access_ || BrowserThread::PostTask(BrowserThread::DB, FROM_HERE,
@@ -220,6 +237,52 @@ bool ShortcutsBackend::DeleteAllShortcuts() {
                  db_.get()));
 }
 
+void ShortcutsBackend::GetShortcutsForPrefix(
+    const string16& prefix,
+    std::vector<const Shortcut*>* shortcuts) {
+  PrefixIndex::iterator indexed = prefix_index_.find(prefix);
+  if (indexed == prefix_index_.end()) {
+    ShortcutMap::iterator begin = shortcuts_map_.lower_bound(prefix);
+    ShortcutMap::iterator end = begin;
+    size_t num_matches = 0;
+    for (; end != shortcuts_map_.end() && StartsWith(end->first, prefix, true);
+         ++end) {
+      if (++num_matches > kMaxShortcutsToScan)
+        break;
+    }
+    if (num_matches <= kMaxShortcutsToScan) {
+      for (ShortcutMap::iterator it = begin; it != end; ++it)
+        shortcuts->push_back(&it->second);
+      return;
+    }
+    // Too many to score on every keystroke: rank them once and keep the
+    // ranking up to date from now on.
+    indexed = prefix_index_.insert(
+        std::make_pair(prefix, PrefixCandidates())).first;
+    for (ShortcutMap::iterator it = begin; it != shortcuts_map_.end() &&
+             StartsWith(it->first, prefix, true); ++it)
+      AddCandidate(it, &indexed->second);
+  }
+
+  for (PrefixCandidates::const_iterator it = indexed->second.begin();
+       it != indexed->second.end(); ++it) {
+    const std::vector<ShortcutMap::iterator>& best = it->second.best;
+    for (size_t i = 0; i < std::min(best.size(), kMaxCandidatesPerDecayRate);
+         ++i)
+      shortcuts->push_back(&best[i]->second);
+  }
+}
+
+// static
+double ShortcutsBackend::GetDecaySpeedDivisor(int number_of_hits) {
+  // Newly created shortcuts decay at full speed; otherwise, decaying by half
+  // takes |n| times as much time, where n increases by (1.0 / each 5
+  // additional hits), up to a maximum of 5x as long.
+  return std::min(kMaxDecaySpeedDivisor,
+      (number_of_hits + kNumUsesPerDecaySpeedDivisorIncrement - 1) /
+      kNumUsesPerDecaySpeedDivisorIncrement);
+}
+
 void ShortcutsBackend::AddObserver(ShortcutsBackendObserver* obs) {
   observer_list_.AddObserver(obs);
 }
@@ -326,7 +389,7 @@ bool ShortcutsBackend::DeleteShortcutsWithUrl(const GURL& url,
         StartsWithASCII(it->second->second.match_core.destination_url.spec(),
                         url_spec, true)) {
       shortcut_ids.push_back(it->first);
-      shortcuts_map_.erase(it->second);
+      EraseShortcut(it->second);
       guid_map_.erase(it++);
     } else {
       ++it;
@@ -342,4 +405,86 @@ bool ShortcutsBackend::DeleteShortcutsWithUrl(const GURL& url,
               db_.get(), url_spec));
 }
 
+// static
+int ShortcutsBackend::GetDecayRateBucket(int number_of_hits) {
+  const int kHitsAtMaxDecaySpeedDivisor = static_cast<int>(
+      (kMaxDecaySpeedDivisor - 1) * kNumUsesPerDecaySpeedDivisorIncrement + 1);
+  return std::min(number_of_hits, kHitsAtMaxDecaySpeedDivisor);
+}
+
+// static
+double ShortcutsBackend::GetRankKey(const Shortcut& shortcut) {
+  // The log of CalculateScore() is, up to terms that only depend on the input
+  // and the current time, the log of the time decay term minus half the log
+  // of the text length. The decay term grows with the last access time at a
+  // rate fixed by the decay speed divisor.
+  const double kLn2 = 0.6931471805599453;
+  return kLn2 * shortcut.last_access_time.ToInternalValue() /
+      base::Time::kMicrosecondsPerWeek /
+      GetDecaySpeedDivisor(shortcut.number_of_hits) -
+      0.5 * log(static_cast<double>(std::max<size_t>(shortcut.text.length(),
+                                                     1)));
+}
+
+// static
+void ShortcutsBackend::AddCandidate(ShortcutMap::iterator it,
+                                    PrefixCandidates* candidates) {
+  RankedShortcuts& ranked =
+      (*candidates)[GetDecayRateBucket(it->second.number_of_hits)];
+  ++ranked.count;
+  const size_t kMaxKept = 2 * kMaxCandidatesPerDecayRate;
+  double rank_key = GetRankKey(it->second);
+  std::vector<ShortcutMap::iterator>::iterator position = ranked.best.begin();
+  while (position != ranked.best.end() &&
+         GetRankKey((*position)->second) >= rank_key)
+    ++position;
+  if (position - ranked.best.begin() >= static_cast<ptrdiff_t>(kMaxKept))
+    return;
+  ranked.best.insert(position, it);
+  if (ranked.best.size() > kMaxKept)
+    ranked.best.pop_back();
+}
+
+ShortcutsBackend::ShortcutMap::iterator ShortcutsBackend::InsertShortcut(
+    const Shortcut& shortcut) {
+  ShortcutMap::iterator it = shortcuts_map_.insert(
+      std::make_pair(base::i18n::ToLower(shortcut.text), shortcut));
+  for (size_t length = 1;
+       !prefix_index_.empty() && length <= it->first.length(); ++length) {
+    PrefixIndex::iterator indexed =
+        prefix_index_.find(it->first.substr(0, length));
+    if (indexed != prefix_index_.end())
+      AddCandidate(it, &indexed->second);
+  }
+  return it;
+}
+
+void ShortcutsBackend::EraseShortcut(ShortcutMap::iterator it) {
+  int bucket = GetDecayRateBucket(it->second.number_of_hits);
+  for (size_t length = 1;
+       !prefix_index_.empty() && length <= it->first.length(); ++length) {
+    PrefixIndex::iterator indexed =
+        prefix_index_.find(it->first.substr(0, length));
+    if (indexed == prefix_index_.end())
+      continue;
+    PrefixCandidates::iterator candidates = indexed->second.find(bucket);
+    DCHECK(candidates != indexed->second.end());
+    RankedShortcuts& ranked = candidates->second;
+    --ranked.count;
+    std::vector<ShortcutMap::iterator>::iterator found =
+        std::find(ranked.best.begin(), ranked.best.end(), it);
+    if (found != ranked.best.end())
+      ranked.best.erase(found);
+    if (ranked.count == 0) {
+      indexed->second.erase(candidates);
+    } else if (ranked.best.size() < kMaxCandidatesPerDecayRate &&
+               ranked.best.size() < ranked.count) {
+      // The next best shortcuts are unknown; rank the prefix again when it is
+      // next looked up.
+      prefix_index_.erase(indexed);
+    }
+  }
+  shortcuts_map_.erase(it);
+}
+
 }  // namespace history
@@ -84,6 +84,11 @@ class ShortcutsBackend : public RefcountedBrowserContextKeyedService,
 
   typedef std::multimap<string16, ShortcutsBackend::Shortcut> ShortcutMap;
 
+  // When more shortcuts than this start with a prefix, GetShortcutsForPrefix()
+  // returns only those that can score in the top kMaxCandidatesPerDecayRate.
+  static const size_t kMaxShortcutsToScan;
+  static const size_t kMaxCandidatesPerDecayRate;
+
   // |profile| is necessary for profile notifications only and can be NULL in
   // unit-tests. For unit testing, set |suppress_db| to true to prevent creation
   // of the database, in which case all operations are performed in memory only.
@@ -126,6 +131,19 @@ class ShortcutsBackend : public RefcountedBrowserContextKeyedService,
   // Deletes all of the shortcuts.
   bool DeleteAllShortcuts();
 
+  // Appends to |shortcuts| the shortcuts whose lowercased text starts with
+  // |prefix|. If there are more than kMaxShortcutsToScan, only the
+  // kMaxCandidatesPerDecayRate highest ranked ones of each decay rate are
+  // returned; these include the kMaxCandidatesPerDecayRate shortcuts the
+  // ShortcutsProvider would score highest at any time. The pointers are valid
+  // until the shortcuts change.
+  void GetShortcutsForPrefix(const string16& prefix,
+                             std::vector<const Shortcut*>* shortcuts);
+
+  // Returns how many times longer than a new shortcut a shortcut selected
+  // |number_of_hits| times takes for its score to decay by half.
+  static double GetDecaySpeedDivisor(int number_of_hits);
+
   void AddObserver(ShortcutsBackendObserver* obs);
   void RemoveObserver(ShortcutsBackendObserver* obs);
 
@@ -141,6 +159,25 @@ class ShortcutsBackend : public RefcountedBrowserContextKeyedService,
 
   typedef std::map<std::string, ShortcutMap::iterator> GuidMap;
 
+  // The highest ranked of the |count| shortcuts that share a prefix and a
+  // decay rate, best first. Up to 2 * kMaxCandidatesPerDecayRate are kept so
+  // that deleting or updating one rarely requires rescanning the prefix.
+  struct RankedShortcuts {
+    RankedShortcuts();
+    ~RankedShortcuts();
+
+    size_t count;
+    std::vector<ShortcutMap::iterator> best;
+  };
+
+  // The ranked shortcuts of a prefix, keyed by GetDecayRateBucket().
+  typedef std::map<int, RankedShortcuts> PrefixCandidates;
+
+  // Maps a lowercased prefix, shared by more than kMaxShortcutsToScan
+  // shortcuts, to its candidates. Entries are created when the prefix is
+  // first looked up and kept up to date as shortcuts are added and removed.
+  typedef std::map<string16, PrefixCandidates> PrefixIndex;
+
   virtual ~ShortcutsBackend();
 
   // RefcountedBrowserContextKeyedService:
@@ -162,6 +199,24 @@ class ShortcutsBackend : public RefcountedBrowserContextKeyedService,
   // true, only shortcuts from exactly |url| are deleted.
   bool DeleteShortcutsWithUrl(const GURL& url, bool exact_match);
 
+  // Shortcuts with the same number of hits, up to the point where the decay
+  // speed stops growing, decay at the same rate.
+  static int GetDecayRateBucket(int number_of_hits);
+
+  // Returns a key ordering shortcuts with the same decay rate by the score
+  // ShortcutsProvider::CalculateScore() gives them, for any input and time.
+  static double GetRankKey(const Shortcut& shortcut);
+
+  // Adds |it| to |candidates| if it ranks among the best kept.
+  static void AddCandidate(ShortcutMap::iterator it,
+                           PrefixCandidates* candidates);
+
+  // Inserts |shortcut| into |shortcuts_map_| and |prefix_index_|.
+  ShortcutMap::iterator InsertShortcut(const Shortcut& shortcut);
+
+  // Erases |it| from |shortcuts_map_| and |prefix_index_|.
+  void EraseShortcut(ShortcutMap::iterator it);
+
   CurrentState current_state_;
   ObserverList<ShortcutsBackendObserver> observer_list_;
   scoped_refptr<ShortcutsDatabase> db_;
@@ -175,6 +230,8 @@ class ShortcutsBackend : public RefcountedBrowserContextKeyedService,
   ShortcutMap shortcuts_map_;
   // This is a helper map for quick access to a shortcut by guid.
   GuidMap guid_map_;
+  // The best shortcuts for the prefixes that match many of them.
+  PrefixIndex prefix_index_;
 
   content::NotificationRegistrar notification_registrar_;
 
@@ -2,9 +2,14 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#include <algorithm>
+#include <cmath>
+#include <set>
+
 #include "base/files/scoped_temp_dir.h"
 #include "base/message_loop/message_loop.h"
 #include "base/path_service.h"
+#include "base/strings/string_util.h"
 #include "base/strings/stringprintf.h"
 #include "base/strings/utf_string_conversions.h"
 #include "chrome/browser/history/shortcuts_backend.h"
@@ -31,6 +36,24 @@ ShortcutsBackend::Shortcut::MatchCore MatchCoreForTesting(
   return ShortcutsBackend::Shortcut::MatchCore(match);
 }
 
+// Mirrors ShortcutsProvider::CalculateScore(), without the constant factor.
+double ScoreForTesting(const ShortcutsBackend::Shortcut& shortcut,
+                       size_t typed_length,
+                       base::Time now) {
+  const double kLn2 = 0.6931471805599453;
+  double decay_exponent = kLn2 *
+      (now - shortcut.last_access_time).InMicroseconds() /
+      base::Time::kMicrosecondsPerWeek /
+      ShortcutsBackend::GetDecaySpeedDivisor(shortcut.number_of_hits);
+  return sqrt(static_cast<double>(typed_length) / shortcut.text.length()) /
+      exp(decay_exponent);
+}
+
+bool ScoreGreater(const std::pair<double, std::string>& a,
+                  const std::pair<double, std::string>& b) {
+  return a.first > b.first;
+}
+
 }  // namespace
 
 
@@ -53,6 +76,10 @@ class ShortcutsBackendTest : public testing::Test,
 
   void InitBackend();
 
+  // Checks that GetShortcutsForPrefix() returns the shortcuts starting with
+  // |prefix| that score highest at |now|.
+  void ExpectTopShortcutsForPrefix(const string16& prefix, base::Time now);
+
   TestingProfile profile_;
   scoped_refptr<ShortcutsBackend> backend_;
   base::MessageLoopForUI ui_message_loop_;
@@ -86,6 +113,30 @@ void ShortcutsBackendTest::OnShortcutsChanged() {
   changed_notified_ = true;
 }
 
+void ShortcutsBackendTest::ExpectTopShortcutsForPrefix(const string16& prefix,
+                                                      base::Time now) {
+  std::vector<const ShortcutsBackend::Shortcut*> results;
+  backend_->GetShortcutsForPrefix(prefix, &results);
+  std::set<std::string> result_ids;
+  for (size_t i = 0; i < results.size(); ++i)
+    result_ids.insert(results[i]->id);
+
+  std::vector<std::pair<double, std::string> > scores;
+  const ShortcutsBackend::ShortcutMap& shortcuts = backend_->shortcuts_map();
+  for (ShortcutsBackend::ShortcutMap::const_iterator it =
+           shortcuts.lower_bound(prefix);
+       it != shortcuts.end() && StartsWith(it->first, prefix, true); ++it) {
+    scores.push_back(std::make_pair(
+        ScoreForTesting(it->second, prefix.length(), now), it->second.id));
+  }
+  std::sort(scores.begin(), scores.end(), &ScoreGreater);
+  for (size_t i = 0; i < std::min(
+           scores.size(), ShortcutsBackend::kMaxCandidatesPerDecayRate); ++i) {
+    EXPECT_TRUE(result_ids.count(scores[i].second))
+        << "Missing " << scores[i].second << " for " << prefix;
+  }
+}
+
 void ShortcutsBackendTest::InitBackend() {
   ShortcutsBackend* backend =
       ShortcutsBackendFactory::GetForProfile(&profile_).get();
@@ -173,4 +224,61 @@ TEST_F(ShortcutsBackendTest, DeleteShortcuts) {
   ASSERT_EQ(0U, shortcuts.size());
 }
 
+TEST_F(ShortcutsBackendTest, GetShortcutsForPrefix) {
+  InitBackend();
+  const int kNumShortcuts = 200;
+  base::Time now = base::Time::Now();
+  for (int i = 0; i < kNumShortcuts; ++i) {
+    ShortcutsBackend::Shortcut shortcut(
+        base::StringPrintf("BD85DBA2-8C29-49F9-84AE-%012d", i),
+        ASCIIToUTF16(base::StringPrintf("Shortcut%d", i)),
+        MatchCoreForTesting(base::StringPrintf("http://www.test%d.com", i)),
+        now - base::TimeDelta::FromHours((i * 7) % 500), 1 + (i * 13) % 30);
+    EXPECT_TRUE(backend_->AddShortcut(shortcut));
+  }
+
+  // Few enough shortcuts start with "shortcut19" to return all of them.
+  std::vector<const ShortcutsBackend::Shortcut*> results;
+  backend_->GetShortcutsForPrefix(ASCIIToUTF16("shortcut19"), &results);
+  EXPECT_EQ(11u, results.size());
+
+  // All of them start with "short"; only the best candidates are returned.
+  const string16 prefix(ASCIIToUTF16("short"));
+  results.clear();
+  backend_->GetShortcutsForPrefix(prefix, &results);
+  EXPECT_LT(results.size(), static_cast<size_t>(kNumShortcuts));
+  ExpectTopShortcutsForPrefix(prefix, now);
+  ExpectTopShortcutsForPrefix(prefix, now + base::TimeDelta::FromDays(60));
+
+  // The index follows deletions, including of the best shortcuts...
+  std::vector<std::string> deleted_ids;
+  for (size_t i = 0; i < results.size(); i += 2)
+    deleted_ids.push_back(results[i]->id);
+  EXPECT_TRUE(backend_->DeleteShortcutsWithIds(deleted_ids));
+  ExpectTopShortcutsForPrefix(prefix, now);
+  ExpectTopShortcutsForPrefix(prefix, now + base::TimeDelta::FromDays(60));
+
+  // ...and updates and additions. "shortcut60" is the oldest of the shortcuts
+  // with one hit, so it was not a candidate before.
+  ASSERT_TRUE(backend_->shortcuts_map().end() !=
+              backend_->shortcuts_map().find(ASCIIToUTF16("shortcut60")));
+  ShortcutsBackend::Shortcut updated(
+      backend_->shortcuts_map().find(ASCIIToUTF16("shortcut60"))->second);
+  updated.last_access_time = now;
+  updated.number_of_hits = 100;
+  EXPECT_TRUE(backend_->UpdateShortcut(updated));
+  EXPECT_TRUE(backend_->AddShortcut(ShortcutsBackend::Shortcut(
+      "BD85DBA2-8C29-49F9-84AE-48E1E90880DF", ASCIIToUTF16("shorts"),
+      MatchCoreForTesting("http://www.shorts.com"), now, 1)));
+  ExpectTopShortcutsForPrefix(prefix, now);
+  ExpectTopShortcutsForPrefix(prefix, now + base::TimeDelta::FromDays(60));
+  results.clear();
+  backend_->GetShortcutsForPrefix(prefix, &results);
+  std::set<std::string> result_ids;
+  for (size_t i = 0; i < results.size(); ++i)
+    result_ids.insert(results[i]->id);
+  EXPECT_TRUE(result_ids.count(updated.id));
+  EXPECT_TRUE(result_ids.count("BD85DBA2-8C29-49F9-84AE-48E1E90880DF"));
+}
+
 }  // namespace history
@@ -0,0 +1,294 @@
+// Copyright 2013 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "chrome/browser/history/synthetic_history_generator.h"
+
+#include <algorithm>
+
+#include "base/logging.h"
+#include "base/memory/ref_counted_memory.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/strings/stringprintf.h"
+#include "base/strings/utf_string_conversions.h"
+#include "chrome/browser/autocomplete/autocomplete_match.h"
+#include "chrome/browser/history/history_database.h"
+#include "chrome/browser/history/shortcuts_backend.h"
+#include "chrome/browser/history/shortcuts_database.h"
+#include "chrome/browser/history/thumbnail_database.h"
+#include "chrome/browser/history/top_sites_database.h"
+#include "content/public/common/page_transition_types.h"
+#include "ui/gfx/size.h"
+#include "url/gurl.h"
+
+namespace history {
+
+namespace {
+
+const char* kSyllables[] = {
+  "ka", "lo", "mi", "ne", "ro", "ta", "vu", "shi", "pe", "do", "ar", "en",
+  "il", "on", "us", "bra", "cle", "dri", "fo", "gan", "hu", "jo", "qua", "ze",
+};
+
+const char* kTopLevelDomains[] = {
+  "com", "com", "com", "com", "org", "net", "de", "co.uk", "fr", "io",
+};
+
+// Size of the generated favicon and thumbnail payloads, in bytes. They are
+// not valid images; the databases store them as opaque blobs.
+const size_t kFaviconSize = 600;
+const size_t kThumbnailSize = 6 * 1024;
+
+// Fills |weights| with the cumulative Zipf(1) weights of |n| ranks.
+void BuildZipfWeights(size_t n, std::vector<double>* weights) {
+  weights->resize(n);
+  double total = 0;
+  for (size_t i = 0; i < n; ++i) {
+    total += 1.0 / (i + 1);
+    (*weights)[i] = total;
+  }
+}
+
+}  // namespace
+
+SyntheticHistoryGenerator::Params::Params()
+    : num_urls(10000),
+      num_hosts(1000),
+      num_words(3000),
+      history_days(90),
+      max_visits_per_url(500),
+      num_top_sites(20),
+      num_shortcuts(500),
+      seed(1),
+      now(base::Time::Now()) {
+}
+
+SyntheticHistoryGenerator::SyntheticHistoryGenerator(const Params& params)
+    : params_(params),
+      random_state_(params.seed ? params.seed : 1) {
+  DCHECK_GT(params_.num_urls, 0u);
+  DCHECK_GT(params_.num_hosts, 0u);
+  DCHECK_GT(params_.num_words, 0u);
+  Generate();
+}
+
+SyntheticHistoryGenerator::~SyntheticHistoryGenerator() {
+}
+
+bool SyntheticHistoryGenerator::PopulateHistoryDatabase(HistoryDatabase* db) {
+  HistoryDatabase::TransactionScoper transaction(db);
+  for (size_t i = 0; i < url_rows_.size(); ++i) {
+    URLID url_id = db->AddURL(url_rows_[i]);
+    if (!url_id)
+      return false;
+    url_rows_[i].set_id(url_id);
+    content::PageTransition transition = url_rows_[i].typed_count() ?
+        content::PAGE_TRANSITION_TYPED : content::PAGE_TRANSITION_LINK;
+    for (size_t j = 0; j < visit_times_[i].size(); ++j) {
+      VisitRow visit(url_id, visit_times_[i][j], 0,
+                     content::PageTransitionFromInt(
+                         transition | content::PAGE_TRANSITION_CHAIN_START |
+                         content::PAGE_TRANSITION_CHAIN_END),
+                     0);
+      if (!db->AddVisit(&visit, SOURCE_BROWSED))
+        return false;
+    }
+  }
+  return true;
+}
+
+bool SyntheticHistoryGenerator::PopulateThumbnailDatabase(
+    ThumbnailDatabase* db) {
+  std::vector<unsigned char> default_icon(kFaviconSize);
+  for (size_t i = 0; i < default_icon.size(); ++i)
+    default_icon[i] = static_cast<unsigned char>(NextRandom());
+
+  db->BeginTransaction();
+  std::vector<chrome::FaviconID> host_icons(hosts_.size());
+  for (size_t i = 0; i < hosts_.size(); ++i) {
+    std::vector<unsigned char> icon(default_icon);
+    if (i % 10) {
+      for (size_t j = 0; j < icon.size(); ++j)
+        icon[j] = static_cast<unsigned char>(NextRandom());
+    }
+    host_icons[i] = db->AddFavicon(
+        GURL("http://" + hosts_[i] + "/favicon.ico"), chrome::FAVICON,
+        base::RefCountedBytes::TakeVector(&icon), params_.now,
+        gfx::Size(16, 16));
+    if (!host_icons[i]) {
+      db->CommitTransaction();
+      return false;
+    }
+  }
+  bool success = true;
+  for (size_t i = 0; i < url_rows_.size() && success; ++i)
+    success = db->AddIconMapping(url_rows_[i].url(),
+                                 host_icons[host_of_url_[i]]) != 0;
+  db->CommitTransaction();
+  return success;
+}
+
+void SyntheticHistoryGenerator::PopulateTopSitesDatabase(TopSitesDatabase* db) {
+  std::vector<std::pair<int, size_t> > by_visits;
+  for (size_t i = 0; i < url_rows_.size(); ++i)
+    by_visits.push_back(std::make_pair(-url_rows_[i].visit_count(), i));
+  size_t num_top_sites = std::min(params_.num_top_sites, by_visits.size());
+  std::partial_sort(by_visits.begin(), by_visits.begin() + num_top_sites,
+                    by_visits.end());
+
+  for (size_t i = 0; i < num_top_sites; ++i) {
+    const URLRow& row = url_rows_[by_visits[i].second];
+    MostVisitedURL url(row.url(), row.title());
+    url.redirects.push_back(row.url());
+    std::vector<unsigned char> thumbnail(kThumbnailSize);
+    for (size_t j = 0; j < thumbnail.size(); ++j)
+      thumbnail[j] = static_cast<unsigned char>(NextRandom());
+    Images images;
+    images.thumbnail = base::RefCountedBytes::TakeVector(&thumbnail);
+    images.thumbnail_score.good_clipping = true;
+    images.thumbnail_score.load_completed = true;
+    images.thumbnail_score.time_at_snapshot = params_.now;
+    db->SetPageThumbnail(url, static_cast<int>(i), images);
+  }
+}
+
+bool SyntheticHistoryGenerator::PopulateShortcutsDatabase(
+    ShortcutsDatabase* db) {
+  for (size_t i = 0; i < params_.num_shortcuts; ++i) {
+    size_t index = NextRandom() % url_rows_.size();
+    const URLRow& row = url_rows_[index];
+    string16 title_word = row.title().substr(0, row.title().find(' '));
+    string16 text = title_word.substr(0, 1 + NextRandom() % title_word.size());
+    string16 contents = UTF8ToUTF16(row.url().spec());
+    ShortcutsBackend::Shortcut shortcut(
+        base::StringPrintf("%08X-0000-4000-8000-%012X",
+                           static_cast<unsigned int>(params_.seed),
+                           static_cast<unsigned int>(i)),
+        text,
+        ShortcutsBackend::Shortcut::MatchCore(
+            contents, row.url(), contents,
+            AutocompleteMatch::ClassificationsFromString("0,1"),
+            row.title(), AutocompleteMatch::ClassificationsFromString("0,0"),
+            content::PAGE_TRANSITION_TYPED, AutocompleteMatchType::HISTORY_URL,
+            string16()),
+        row.last_visit(), 1 + NextRandom() % 20);
+    if (!db->AddShortcut(shortcut))
+      return false;
+  }
+  return true;
+}
+
+std::vector<string16> SyntheticHistoryGenerator::GenerateSearchTerms(
+    size_t count) {
+  std::vector<string16> terms;
+  for (size_t i = 0; i < count; ++i) {
+    // Half of the inputs name a site, the others a word from a page title.
+    if (NextRandom() % 2) {
+      // Strip the "www.".
+      terms.push_back(UTF8ToUTF16(hosts_[NextRank(host_weights_)].substr(4)));
+      continue;
+    }
+    const string16& title = url_rows_[NextRandom() % url_rows_.size()].title();
+    size_t start = 0;
+    for (int words = NextRandom() % 3; words > 0; --words) {
+      size_t space = title.find(' ', start);
+      if (space == string16::npos)
+        break;
+      start = space + 1;
+    }
+    terms.push_back(title.substr(start, title.find(' ', start) - start));
+  }
+  return terms;
+}
+
+uint32 SyntheticHistoryGenerator::NextRandom() {
+  // xorshift32; its quality is ample for picking synthetic data.
+  random_state_ ^= random_state_ << 13;
+  random_state_ ^= random_state_ >> 17;
+  random_state_ ^= random_state_ << 5;
+  return random_state_;
+}
+
+double SyntheticHistoryGenerator::NextDouble() {
+  return NextRandom() / 4294967296.0;
+}
+
+size_t SyntheticHistoryGenerator::NextRank(
+    const std::vector<double>& cumulative) {
+  DCHECK(!cumulative.empty());
+  double target = NextDouble() * cumulative.back();
+  return std::min(static_cast<size_t>(
+      std::upper_bound(cumulative.begin(), cumulative.end(), target) -
+          cumulative.begin()),
+      cumulative.size() - 1);
+}
+
+std::string SyntheticHistoryGenerator::MakeWord() {
+  std::string word;
+  for (int syllables = 2 + NextRandom() % 3; syllables > 0; --syllables)
+    word += kSyllables[NextRandom() % arraysize(kSyllables)];
+  return word;
+}
+
+void SyntheticHistoryGenerator::Generate() {
+  BuildZipfWeights(params_.num_hosts, &host_weights_);
+  BuildZipfWeights(params_.num_words, &word_weights_);
+
+  for (size_t i = 0; i < params_.num_words; ++i)
+    words_.push_back(MakeWord());
+  for (size_t i = 0; i < params_.num_hosts; ++i) {
+    hosts_.push_back(base::StringPrintf(
+        "www.%s%s.%s", MakeWord().c_str(), base::Uint64ToString(i).c_str(),
+        kTopLevelDomains[NextRandom() % arraysize(kTopLevelDomains)]));
+  }
+
+  const int64 history_us =
+      base::TimeDelta::FromDays(params_.history_days).InMicroseconds();
+  for (size_t i = 0; i < params_.num_urls; ++i) {
+    // Every host gets its root page before the popular hosts get more.
+    size_t host = i < hosts_.size() ? i : NextRank(host_weights_);
+    std::string spec = "http://" + hosts_[host] + "/";
+    if (i >= hosts_.size()) {
+      for (int depth = 1 + NextRandom() % 3; depth > 0; --depth)
+        spec += words_[NextRank(word_weights_)] + "/";
+      // Keep the URL unique even if the path repeats.
+      spec += base::StringPrintf("%s?id=%d", words_[NextRank(word_weights_)]
+                                     .c_str(), static_cast<int>(i));
+    }
+
+    string16 title;
+    for (int words = 3 + NextRandom() % 6; words > 0; --words) {
+      if (!title.empty())
+        title += ' ';
+      title += UTF8ToUTF16(words_[NextRank(word_weights_)]);
+    }
+
+    // Visit counts follow a power law: most pages are seen once or twice.
+    double u = std::max(NextDouble(), 1e-6);
+    int visit_count = static_cast<int>(std::min(
+        1.0 / (u * u * u), static_cast<double>(params_.max_visits_per_url)));
+    visit_count = std::max(visit_count, 1);
+    // Root pages are the ones people type.
+    int typed_count = (i < hosts_.size() && NextRandom() % 4 == 0) ?
+        1 + visit_count / 3 : 0;
+
+    std::vector<base::Time> visits;
+    for (int j = 0; j < visit_count; ++j) {
+      double age = NextDouble();
+      visits.push_back(params_.now - base::TimeDelta::FromMicroseconds(
+          static_cast<int64>(age * age * history_us)));
+    }
+    std::sort(visits.begin(), visits.end());
+
+    URLRow row((GURL(spec)));
+    row.set_title(title);
+    row.set_visit_count(visit_count);
+    row.set_typed_count(typed_count);
+    row.set_last_visit(visits.back());
+    url_rows_.push_back(row);
+    host_of_url_.push_back(host);
+    visit_times_.push_back(visits);
+  }
+}
+
+}  // namespace history
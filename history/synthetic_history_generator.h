@@ -0,0 +1,109 @@
+// Copyright 2013 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CHROME_BROWSER_HISTORY_SYNTHETIC_HISTORY_GENERATOR_H_
+#define CHROME_BROWSER_HISTORY_SYNTHETIC_HISTORY_GENERATOR_H_
+
+#include <string>
+#include <vector>
+
+#include "base/basictypes.h"
+#include "base/strings/string16.h"
+#include "base/time/time.h"
+#include "chrome/browser/history/history_types.h"
+
+class ShortcutsDatabase;
+
+namespace history {
+
+class HistoryDatabase;
+class ThumbnailDatabase;
+class TopSitesDatabase;
+
+// Generates a synthetic browsing profile for benchmarking the history and
+// omnibox code at realistic sizes. The output depends only on the Params, so
+// two runs with the same params produce identical databases (apart from
+// |now|, which all times are relative to).
+//
+// Host popularity and title words are Zipf distributed, visit counts are
+// heavy tailed and visit times are biased towards the recent past, roughly
+// matching what is seen in real profiles.
+class SyntheticHistoryGenerator {
+ public:
+  struct Params {
+    Params();
+
+    size_t num_urls;
+    size_t num_hosts;
+    size_t num_words;         // Size of the title vocabulary.
+    int history_days;         // Visits are spread over this many days.
+    int max_visits_per_url;   // Nobody visits a page more often than this.
+    size_t num_top_sites;
+    size_t num_shortcuts;
+    uint32 seed;
+    base::Time now;
+  };
+
+  explicit SyntheticHistoryGenerator(const Params& params);
+  ~SyntheticHistoryGenerator();
+
+  // Adds the URLs and their visits to |db|. Returns false on failure.
+  bool PopulateHistoryDatabase(HistoryDatabase* db);
+
+  // Adds one favicon per host, mapped from every page on the host. A tenth of
+  // the hosts share the same default icon bitmap.
+  bool PopulateThumbnailDatabase(ThumbnailDatabase* db);
+
+  // Adds the most visited URLs with thumbnails to |db|.
+  void PopulateTopSitesDatabase(TopSitesDatabase* db);
+
+  // Adds shortcuts whose text is a prefix of the first title word of a
+  // random page.
+  bool PopulateShortcutsDatabase(ShortcutsDatabase* db);
+
+  // Returns |count| omnibox inputs, each either the name of a host, picked
+  // with the hosts' popularity, or a word from a random page's title.
+  std::vector<string16> GenerateSearchTerms(size_t count);
+
+  const URLRows& url_rows() const { return url_rows_; }
+
+ private:
+  // Returns the next value from the generator's pseudo random sequence.
+  uint32 NextRandom();
+
+  // Returns a uniformly distributed value in [0, 1).
+  double NextDouble();
+
+  // Returns a rank in [0, cumulative.size()) drawn from the distribution whose
+  // cumulative weights are |cumulative|.
+  size_t NextRank(const std::vector<double>& cumulative);
+
+  // Returns a pronounceable made-up word.
+  std::string MakeWord();
+
+  // Fills in |words_|, |hosts_|, |url_rows_| and |visit_times_|.
+  void Generate();
+
+  Params params_;
+  uint32 random_state_;
+
+  // Cumulative Zipf weights over the hosts and the vocabulary.
+  std::vector<double> host_weights_;
+  std::vector<double> word_weights_;
+
+  std::vector<std::string> words_;
+  std::vector<std::string> hosts_;
+
+  // The generated pages, with |host_of_url_[i]| the index into |hosts_| of
+  // |url_rows_[i]|'s host and |visit_times_[i]| its visits, oldest first.
+  URLRows url_rows_;
+  std::vector<size_t> host_of_url_;
+  std::vector<std::vector<base::Time> > visit_times_;
+
+  DISALLOW_COPY_AND_ASSIGN(SyntheticHistoryGenerator);
+};
+
+}  // namespace history
+
+#endif  // CHROME_BROWSER_HISTORY_SYNTHETIC_HISTORY_GENERATOR_H_
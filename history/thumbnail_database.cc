@@ -14,6 +14,7 @@
 #include "base/memory/ref_counted_memory.h"
 #include "base/metrics/histogram.h"
 #include "base/rand_util.h"
+#include "base/sha1.h"
 #include "base/strings/string_util.h"
 #include "base/strings/stringprintf.h"
 #include "base/time/time.h"
@@ -61,9 +62,23 @@
 //  last_updated      The time at which this favicon was inserted into the
 //                    table. This is used to determine if it needs to be
 //                    redownloaded from the web.
+//  data_id           The ID of the row in |favicon_bitmap_data| holding the
+//                    PNG encoded data of the favicon, or 0 if there is none.
+//  width             Pixel width of the bitmap.
+//  height            Pixel height of the bitmap.
+//
+// favicon_bitmap_data This table contains the PNG encoded data of the favicon
+//                    bitmaps. Identical data is stored once and shared by all
+//                    the |favicon_bitmaps| rows that use it; many sites serve
+//                    the same default icon, and multi-size icons often repeat
+//                    a size.
+//
+//  id                Unique ID.
+//  hash              The leading bytes of the SHA-1 of |image_data|, used to
+//                    find existing copies of data being added.
 //  image_data        PNG encoded data of the favicon.
-//  width             Pixel width of |image_data|.
-//  height            Pixel height of |image_data|.
+//  ref_count         The number of |favicon_bitmaps| rows with this |data_id|.
+//                    The row is deleted when this drops to 0.
 
 namespace {
 
@@ -282,13 +297,24 @@ bool InitTables(sql::Connection* db) {
       "id INTEGER PRIMARY KEY,"
       "icon_id INTEGER NOT NULL,"
       "last_updated INTEGER DEFAULT 0,"
-      "image_data BLOB,"
+      "data_id INTEGER DEFAULT 0,"
       "width INTEGER DEFAULT 0,"
       "height INTEGER DEFAULT 0"
       ")";
   if (!db->Execute(kFaviconBitmapsSql))
     return false;
 
+  const char kFaviconBitmapDataSql[] =
+      "CREATE TABLE IF NOT EXISTS favicon_bitmap_data"
+      "("
+      "id INTEGER PRIMARY KEY,"
+      "hash INTEGER NOT NULL,"
+      "image_data BLOB NOT NULL,"
+      "ref_count INTEGER DEFAULT 0"
+      ")";
+  if (!db->Execute(kFaviconBitmapDataSql))
+    return false;
+
   return true;
 }
 
@@ -315,9 +341,55 @@ bool InitIndices(sql::Connection* db) {
   if (!db->Execute(kFaviconBitmapsIndexSql))
     return false;
 
+  const char kFaviconBitmapDataIndexSql[] =
+      "CREATE INDEX IF NOT EXISTS favicon_bitmap_data_hash ON "
+      "favicon_bitmap_data(hash)";
+  if (!db->Execute(kFaviconBitmapDataIndexSql))
+    return false;
+
   return true;
 }
 
+// Returns the key used to look for existing copies of |data| in the
+// favicon_bitmap_data table. Rows with a matching key are compared byte for
+// byte before being shared, so a collision only costs an extra comparison.
+int64 HashBitmapData(const base::RefCountedMemory& data) {
+  unsigned char hash[base::kSHA1Length];
+  base::SHA1HashBytes(data.front(), data.size(), hash);
+  int64 key;
+  memcpy(&key, hash, sizeof(key));
+  return key;
+}
+
+// Sets the favicon_bitmap_data reference counts from scratch, deleting data
+// which is no longer referenced and clearing references to data which is
+// missing. Used after favicon_bitmaps has been rebuilt wholesale.
+bool RecomputeBitmapDataRefCounts(sql::Connection* db) {
+  const char kClearMissingSql[] =
+      "UPDATE favicon_bitmaps SET data_id = 0 "
+      "WHERE data_id NOT IN (SELECT id FROM favicon_bitmap_data)";
+  const char kResetSql[] = "UPDATE favicon_bitmap_data SET ref_count = 0";
+  if (!db->Execute(kClearMissingSql) || !db->Execute(kResetSql))
+    return false;
+
+  sql::Statement counts(db->GetUniqueStatement(
+      "SELECT data_id, COUNT(*) FROM favicon_bitmaps "
+      "WHERE data_id != 0 GROUP BY data_id"));
+  sql::Statement update(db->GetUniqueStatement(
+      "UPDATE favicon_bitmap_data SET ref_count = ? WHERE id = ?"));
+  while (counts.Step()) {
+    update.Reset(true);
+    update.BindInt(0, counts.ColumnInt(1));
+    update.BindInt64(1, counts.ColumnInt64(0));
+    if (!update.Run())
+      return false;
+  }
+  if (!counts.Succeeded())
+    return false;
+
+  return db->Execute("DELETE FROM favicon_bitmap_data WHERE ref_count = 0");
+}
+
 enum RecoveryEventType {
   RECOVERY_EVENT_RECOVERED = 0,
   RECOVERY_EVENT_FAILED_SCOPER,
@@ -335,6 +407,9 @@ enum RecoveryEventType {
   RECOVERY_EVENT_FAILED_FAVICON_BITMAPS_INSERT,
   RECOVERY_EVENT_FAILED_RECOVER_ICON_MAPPING,
   RECOVERY_EVENT_FAILED_ICON_MAPPING_INSERT,
+  RECOVERY_EVENT_FAILED_META_WRONG_VERSION7,
+  RECOVERY_EVENT_FAILED_RECOVER_FAVICON_BITMAP_DATA,
+  RECOVERY_EVENT_FAILED_FAVICON_BITMAP_DATA_INSERT,
 
   // Always keep this at the end.
   RECOVERY_EVENT_MAX,
@@ -411,11 +486,14 @@ void RecoverDatabaseOrRaze(sql::Connection* db, const base::FilePath& db_path) {
         recovery_version.Clear();
         sql::Recovery::Rollback(recovery.Pass());
         return;
-      } else if (7 != recovery_version.ColumnInt(0)) {
+      } else if (8 != recovery_version.ColumnInt(0)) {
         // TODO(shess): Recovery code is generally schema-dependent.
-        // Version 6 should be easy, if the numbers warrant it.
+        // Versions 6 and 7 should be easy, if the numbers warrant it.
         // Version 5 is probably not warranted.
         switch (recovery_version.ColumnInt(0)) {
+          case 7 :
+            RecordRecoveryEvent(RECOVERY_EVENT_FAILED_META_WRONG_VERSION7);
+            break;
           case 6 :
             RecordRecoveryEvent(RECOVERY_EVENT_FAILED_META_WRONG_VERSION6);
             break;
@@ -503,7 +581,7 @@ void RecoverDatabaseOrRaze(sql::Connection* db, const base::FilePath& db_path) {
         "id ROWID,"
         "icon_id INTEGER STRICT NOT NULL,"
         "last_updated INTEGER,"
-        "image_data BLOB,"
+        "data_id INTEGER,"
         "width INTEGER,"
         "height INTEGER"
         ")";
@@ -517,8 +595,8 @@ void RecoverDatabaseOrRaze(sql::Connection* db, const base::FilePath& db_path) {
 
     const char kCopySql[] =
         "INSERT OR REPLACE INTO favicon_bitmaps "
-        "SELECT id, icon_id, COALESCE(last_updated, 0), image_data, "
-        " COALESCE(width, 0), COALESCE(height, 0) "
+        "SELECT id, icon_id, COALESCE(last_updated, 0), "
+        " COALESCE(data_id, 0), COALESCE(width, 0), COALESCE(height, 0) "
         "FROM recover_favicons_bitmaps";
     if (!recovery->db()->Execute(kCopySql)) {
       // TODO(shess): The recover_faviconbitmaps table should mask
@@ -530,6 +608,36 @@ void RecoverDatabaseOrRaze(sql::Connection* db, const base::FilePath& db_path) {
     }
   }
 
+  // Setup favicon_bitmap_data table.
+  {
+    const char kRecoverySql[] =
+        "CREATE VIRTUAL TABLE temp.recover_favicon_bitmap_data USING recover"
+        "("
+        "corrupt.favicon_bitmap_data,"
+        "id ROWID,"
+        "hash INTEGER STRICT NOT NULL,"
+        "image_data BLOB STRICT NOT NULL,"
+        "ref_count INTEGER"
+        ")";
+    if (!recovery->db()->Execute(kRecoverySql)) {
+      sql::Recovery::Rollback(recovery.Pass());
+      RecordRecoveryEvent(RECOVERY_EVENT_FAILED_RECOVER_FAVICON_BITMAP_DATA);
+      return;
+    }
+
+    // The reference counts are recomputed from the recovered
+    // favicon_bitmaps rather than trusted.
+    const char kCopySql[] =
+        "INSERT OR REPLACE INTO favicon_bitmap_data "
+        "SELECT id, hash, image_data, 0 FROM recover_favicon_bitmap_data";
+    if (!recovery->db()->Execute(kCopySql) ||
+        !RecomputeBitmapDataRefCounts(recovery->db())) {
+      sql::Recovery::Rollback(recovery.Pass());
+      RecordRecoveryEvent(RECOVERY_EVENT_FAILED_FAVICON_BITMAP_DATA_INSERT);
+      return;
+    }
+  }
+
   // Setup icon_mapping table.
   {
     const char kRecoverySql[] =
@@ -632,8 +740,8 @@ namespace history {
 // Version number of the database.
 // NOTE(shess): When changing the version, add a new golden file for
 // the new version and a test to verify that Init() works with it.
-static const int kCurrentVersionNumber = 7;
-static const int kCompatibleVersionNumber = 7;
+static const int kCurrentVersionNumber = 8;
+static const int kCompatibleVersionNumber = 8;
 static const int kDeprecatedVersionNumber = 4;  // and earlier.
 
 ThumbnailDatabase::IconMappingEnumerator::IconMappingEnumerator() {
@@ -737,6 +845,12 @@ sql::InitStatus ThumbnailDatabase::Init(const base::FilePath& db_name) {
       return CantUpgradeToVersion(cur_version);
   }
 
+  if (cur_version == 7) {
+    ++cur_version;
+    if (!UpgradeToVersion8())
+      return CantUpgradeToVersion(cur_version);
+  }
+
   LOG_IF(WARNING, cur_version < kCurrentVersionNumber) <<
       "Thumbnail database version " << cur_version << " is too old to handle.";
 
@@ -795,6 +909,29 @@ void ThumbnailDatabase::ComputeDatabaseMetrics() {
   UMA_HISTOGRAM_COUNTS_10000(
       "History.NumFaviconsInDB",
       favicon_count.Step() ? favicon_count.ColumnInt(0) : 0);
+
+  // Report the size of the file, how much of it is bitmap data, and how much
+  // more the bitmap data would take if identical bitmaps weren't shared.
+  sql::Statement page_count(db_.GetUniqueStatement("PRAGMA page_count"));
+  sql::Statement page_size(db_.GetUniqueStatement("PRAGMA page_size"));
+  if (page_count.Step() && page_size.Step()) {
+    UMA_HISTOGRAM_MEMORY_KB(
+        "History.FaviconsDatabaseSize",
+        static_cast<int>(
+            page_count.ColumnInt64(0) * page_size.ColumnInt64(0) / 1024));
+  }
+
+  sql::Statement bitmap_data_size(db_.GetCachedStatement(SQL_FROM_HERE,
+      "SELECT SUM(LENGTH(image_data)), "
+      "SUM(LENGTH(image_data) * (ref_count - 1)) FROM favicon_bitmap_data"));
+  if (bitmap_data_size.Step()) {
+    UMA_HISTOGRAM_MEMORY_KB(
+        "History.FaviconBitmapDataSize",
+        static_cast<int>(bitmap_data_size.ColumnInt64(0) / 1024));
+    UMA_HISTOGRAM_MEMORY_KB(
+        "History.FaviconBitmapDataSharedSize",
+        static_cast<int>(bitmap_data_size.ColumnInt64(1) / 1024));
+  }
 }
 
 bool ThumbnailDatabase::IsFaviconDBStructureIncorrect() {
@@ -851,8 +988,10 @@ bool ThumbnailDatabase::GetFaviconBitmaps(
     std::vector<FaviconBitmap>* favicon_bitmaps) {
   DCHECK(icon_id);
   sql::Statement statement(db_.GetCachedStatement(SQL_FROM_HERE,
-      "SELECT id, last_updated, image_data, width, height FROM favicon_bitmaps "
-      "WHERE icon_id=?"));
+      "SELECT b.id, b.last_updated, d.image_data, b.width, b.height "
+      "FROM favicon_bitmaps b LEFT JOIN favicon_bitmap_data d "
+      "ON b.data_id = d.id "
+      "WHERE b.icon_id=?"));
   statement.BindInt64(0, icon_id);
 
   bool result = false;
@@ -885,8 +1024,10 @@ bool ThumbnailDatabase::GetFaviconBitmap(
     gfx::Size* pixel_size) {
   DCHECK(bitmap_id);
   sql::Statement statement(db_.GetCachedStatement(SQL_FROM_HERE,
-      "SELECT last_updated, image_data, width, height FROM favicon_bitmaps "
-      "WHERE id=?"));
+      "SELECT b.last_updated, d.image_data, b.width, b.height "
+      "FROM favicon_bitmaps b LEFT JOIN favicon_bitmap_data d "
+      "ON b.data_id = d.id "
+      "WHERE b.id=?"));
   statement.BindInt64(0, bitmap_id);
 
   if (!statement.Step())
@@ -914,16 +1055,15 @@ FaviconBitmapID ThumbnailDatabase::AddFaviconBitmap(
     base::Time time,
     const gfx::Size& pixel_size) {
   DCHECK(icon_id);
+  int64 data_id = 0;
+  if (!AddFaviconBitmapDataRef(icon_data, &data_id))
+    return 0;
+
   sql::Statement statement(db_.GetCachedStatement(SQL_FROM_HERE,
-      "INSERT INTO favicon_bitmaps (icon_id, image_data, last_updated, width, "
+      "INSERT INTO favicon_bitmaps (icon_id, data_id, last_updated, width, "
       "height) VALUES (?, ?, ?, ?, ?)"));
   statement.BindInt64(0, icon_id);
-  if (icon_data.get() && icon_data->size()) {
-    statement.BindBlob(1, icon_data->front(),
-                       static_cast<int>(icon_data->size()));
-  } else {
-    statement.BindNull(1);
-  }
+  statement.BindInt64(1, data_id);
   statement.BindInt64(2, time.ToInternalValue());
   statement.BindInt(3, pixel_size.width());
   statement.BindInt(4, pixel_size.height());
@@ -938,18 +1078,29 @@ bool ThumbnailDatabase::SetFaviconBitmap(
     scoped_refptr<base::RefCountedMemory> bitmap_data,
     base::Time time) {
   DCHECK(bitmap_id);
+  const int64 old_data_id = GetFaviconBitmapDataID(bitmap_id);
+
+  // Refetched favicons are usually identical to what is stored already; only
+  // the time needs writing then.
+  const bool unchanged = old_data_id && bitmap_data.get() &&
+      bitmap_data->size() &&
+      FindFaviconBitmapData(HashBitmapData(*bitmap_data), *bitmap_data) ==
+          old_data_id;
+  UMA_HISTOGRAM_BOOLEAN("History.FaviconBitmapUnchanged", unchanged);
+  if (unchanged)
+    return SetFaviconBitmapLastUpdateTime(bitmap_id, time);
+
+  int64 data_id = 0;
+  if (!AddFaviconBitmapDataRef(bitmap_data, &data_id))
+    return false;
+
   sql::Statement statement(db_.GetCachedStatement(SQL_FROM_HERE,
-      "UPDATE favicon_bitmaps SET image_data=?, last_updated=? WHERE id=?"));
-  if (bitmap_data.get() && bitmap_data->size()) {
-    statement.BindBlob(0, bitmap_data->front(),
-                       static_cast<int>(bitmap_data->size()));
-  } else {
-    statement.BindNull(0);
-  }
+      "UPDATE favicon_bitmaps SET data_id=?, last_updated=? WHERE id=?"));
+  statement.BindInt64(0, data_id);
   statement.BindInt64(1, time.ToInternalValue());
   statement.BindInt64(2, bitmap_id);
 
-  return statement.Run();
+  return statement.Run() && ReleaseFaviconBitmapData(old_data_id);
 }
 
 bool ThumbnailDatabase::SetFaviconBitmapLastUpdateTime(
@@ -964,10 +1115,11 @@ bool ThumbnailDatabase::SetFaviconBitmapLastUpdateTime(
 }
 
 bool ThumbnailDatabase::DeleteFaviconBitmap(FaviconBitmapID bitmap_id) {
+  const int64 data_id = GetFaviconBitmapDataID(bitmap_id);
   sql::Statement statement(db_.GetCachedStatement(SQL_FROM_HERE,
       "DELETE FROM favicon_bitmaps WHERE id=?"));
   statement.BindInt64(0, bitmap_id);
-  return statement.Run();
+  return statement.Run() && ReleaseFaviconBitmapData(data_id);
 }
 
 bool ThumbnailDatabase::SetFaviconOutOfDate(chrome::FaviconID icon_id) {
@@ -1052,10 +1204,24 @@ bool ThumbnailDatabase::DeleteFavicon(chrome::FaviconID id) {
   if (!statement.Run())
     return false;
 
+  std::vector<int64> data_ids;
+  statement.Assign(db_.GetCachedStatement(SQL_FROM_HERE,
+      "SELECT data_id FROM favicon_bitmaps WHERE icon_id = ?"));
+  statement.BindInt64(0, id);
+  while (statement.Step())
+    data_ids.push_back(statement.ColumnInt64(0));
+
   statement.Assign(db_.GetCachedStatement(SQL_FROM_HERE,
       "DELETE FROM favicon_bitmaps WHERE icon_id = ?"));
   statement.BindInt64(0, id);
-  return statement.Run();
+  if (!statement.Run())
+    return false;
+
+  for (size_t i = 0; i < data_ids.size(); ++i) {
+    if (!ReleaseFaviconBitmapData(data_ids[i]))
+      return false;
+  }
+  return true;
 }
 
 bool ThumbnailDatabase::GetIconMappingsForPageURL(
@@ -1239,9 +1405,9 @@ bool ThumbnailDatabase::RetainDataForPageUrls(
       "ALTER TABLE favicon_bitmaps RENAME TO old_favicon_bitmaps";
   const char kCopyFaviconBitmaps[] =
       "INSERT INTO favicon_bitmaps "
-      "  (icon_id, last_updated, image_data, width, height) "
+      "  (icon_id, last_updated, data_id, width, height) "
       "SELECT mapping.new_icon_id, old.last_updated, "
-      "    old.image_data, old.width, old.height "
+      "    old.data_id, old.width, old.height "
       "FROM old_favicon_bitmaps AS old "
       "JOIN temp.icon_id_mapping AS mapping "
       "ON (old.icon_id = mapping.old_icon_id)";
@@ -1281,6 +1447,10 @@ bool ThumbnailDatabase::RetainDataForPageUrls(
   if (!InitIndices(&db_))
     return false;
 
+  // Drop the bitmap data only the deleted favicons were using.
+  if (!RecomputeBitmapDataRefCounts(&db_))
+    return false;
+
   const char kIconMappingDrop[] = "DROP TABLE temp.icon_id_mapping";
   if (!db_.Execute(kIconMappingDrop))
     return false;
@@ -1302,13 +1472,91 @@ IconMappingID ThumbnailDatabase::AddIconMapping(const GURL& page_url,
   return db_.GetLastInsertRowId();
 }
 
+int64 ThumbnailDatabase::FindFaviconBitmapData(
+    int64 hash,
+    const base::RefCountedMemory& data) {
+  sql::Statement statement(db_.GetCachedStatement(SQL_FROM_HERE,
+      "SELECT id, image_data FROM favicon_bitmap_data WHERE hash=?"));
+  statement.BindInt64(0, hash);
+  while (statement.Step()) {
+    if (statement.ColumnByteLength(1) == static_cast<int>(data.size()) &&
+        !memcmp(statement.ColumnBlob(1), data.front(), data.size())) {
+      return statement.ColumnInt64(0);
+    }
+  }
+  return 0;
+}
+
+bool ThumbnailDatabase::AddFaviconBitmapDataRef(
+    const scoped_refptr<base::RefCountedMemory>& data,
+    int64* data_id) {
+  *data_id = 0;
+  if (!data.get() || !data->size())
+    return true;
+
+  const int64 hash = HashBitmapData(*data);
+  const int64 existing_id = FindFaviconBitmapData(hash, *data);
+  if (existing_id) {
+    sql::Statement statement(db_.GetCachedStatement(SQL_FROM_HERE,
+        "UPDATE favicon_bitmap_data SET ref_count=ref_count+1 WHERE id=?"));
+    statement.BindInt64(0, existing_id);
+    if (!statement.Run())
+      return false;
+    *data_id = existing_id;
+    return true;
+  }
+
+  sql::Statement statement(db_.GetCachedStatement(SQL_FROM_HERE,
+      "INSERT INTO favicon_bitmap_data (hash, image_data, ref_count) "
+      "VALUES (?, ?, 1)"));
+  statement.BindInt64(0, hash);
+  statement.BindBlob(1, data->front(), static_cast<int>(data->size()));
+  if (!statement.Run())
+    return false;
+  *data_id = db_.GetLastInsertRowId();
+  return true;
+}
+
+bool ThumbnailDatabase::ReleaseFaviconBitmapData(int64 data_id) {
+  if (!data_id)
+    return true;
+
+  sql::Statement statement(db_.GetCachedStatement(SQL_FROM_HERE,
+      "UPDATE favicon_bitmap_data SET ref_count=ref_count-1 WHERE id=?"));
+  statement.BindInt64(0, data_id);
+  if (!statement.Run())
+    return false;
+
+  statement.Assign(db_.GetCachedStatement(SQL_FROM_HERE,
+      "DELETE FROM favicon_bitmap_data WHERE id=? AND ref_count<=0"));
+  statement.BindInt64(0, data_id);
+  return statement.Run();
+}
+
+int64 ThumbnailDatabase::GetFaviconBitmapDataID(FaviconBitmapID bitmap_id) {
+  sql::Statement statement(db_.GetCachedStatement(SQL_FROM_HERE,
+      "SELECT data_id FROM favicon_bitmaps WHERE id=?"));
+  statement.BindInt64(0, bitmap_id);
+  return statement.Step() ? statement.ColumnInt64(0) : 0;
+}
+
 bool ThumbnailDatabase::IsLatestVersion() {
   return meta_table_.GetVersionNumber() == kCurrentVersionNumber;
 }
 
 bool ThumbnailDatabase::UpgradeToVersion6() {
-  // Move bitmap data from favicons to favicon_bitmaps.
+  // Move bitmap data from favicons to favicon_bitmaps. InitTables() created
+  // favicon_bitmaps in its current form, so replace it with the version 6
+  // form first; UpgradeToVersion8() converts it back.
   bool success =
+      db_.Execute("DROP TABLE favicon_bitmaps") &&
+      db_.Execute("CREATE TABLE favicon_bitmaps ("
+                  "id INTEGER PRIMARY KEY,"
+                  "icon_id INTEGER NOT NULL,"
+                  "last_updated INTEGER DEFAULT 0,"
+                  "image_data BLOB,"
+                  "width INTEGER DEFAULT 0,"
+                  "height INTEGER DEFAULT 0)") &&
       db_.Execute("INSERT INTO favicon_bitmaps (icon_id, last_updated, "
                   "image_data, width, height)"
                   "SELECT id, last_updated, image_data, 0, 0 FROM favicons") &&
@@ -1354,4 +1602,50 @@ bool ThumbnailDatabase::UpgradeToVersion7() {
   return true;
 }
 
+bool ThumbnailDatabase::UpgradeToVersion8() {
+  // Move the bitmap data out of favicon_bitmaps and into the shared
+  // favicon_bitmap_data table. The hashes can't be computed in SQL, so the
+  // rows are copied over one at a time.
+  const char kRenameSql[] =
+      "ALTER TABLE favicon_bitmaps RENAME TO old_favicon_bitmaps";
+  if (!db_.Execute(kRenameSql) || !InitTables(&db_))
+    return false;
+
+  sql::Statement old_bitmaps(db_.GetUniqueStatement(
+      "SELECT id, icon_id, last_updated, image_data, width, height "
+      "FROM old_favicon_bitmaps"));
+  sql::Statement insert(db_.GetUniqueStatement(
+      "INSERT INTO favicon_bitmaps "
+      "(id, icon_id, last_updated, data_id, width, height) "
+      "VALUES (?, ?, ?, ?, ?, ?)"));
+  while (old_bitmaps.Step()) {
+    scoped_refptr<base::RefCountedBytes> data(new base::RefCountedBytes());
+    old_bitmaps.ColumnBlobAsVector(3, &data->data());
+    int64 data_id = 0;
+    if (!AddFaviconBitmapDataRef(data, &data_id))
+      return false;
+
+    insert.Reset(true);
+    insert.BindInt64(0, old_bitmaps.ColumnInt64(0));
+    insert.BindInt64(1, old_bitmaps.ColumnInt64(1));
+    insert.BindInt64(2, old_bitmaps.ColumnInt64(2));
+    insert.BindInt64(3, data_id);
+    insert.BindInt(4, old_bitmaps.ColumnInt(4));
+    insert.BindInt(5, old_bitmaps.ColumnInt(5));
+    if (!insert.Run())
+      return false;
+  }
+  if (!old_bitmaps.Succeeded())
+    return false;
+  old_bitmaps.Clear();
+
+  // Dropping the old table also drops its index, so recreate it.
+  if (!db_.Execute("DROP TABLE old_favicon_bitmaps") || !InitIndices(&db_))
+    return false;
+
+  meta_table_.SetVersionNumber(8);
+  meta_table_.SetCompatibleVersionNumber(std::min(8, kCompatibleVersionNumber));
+  return true;
+}
+
 }  // namespace history
@@ -105,7 +105,8 @@ class ThumbnailDatabase {
       const gfx::Size& pixel_size);
 
   // Sets the bitmap data and the last updated time for the favicon bitmap at
-  // |bitmap_id|.
+  // |bitmap_id|. If |bitmap_data| is the data the bitmap already has, only the
+  // time is written.
   // Returns true if successful.
   bool SetFaviconBitmap(FaviconBitmapID bitmap_id,
                         scoped_refptr<base::RefCountedMemory> bitmap_data,
@@ -243,6 +244,7 @@ class ThumbnailDatabase {
   FRIEND_TEST_ALL_PREFIXES(ThumbnailDatabaseTest, Version6);
   FRIEND_TEST_ALL_PREFIXES(ThumbnailDatabaseTest, Version7);
   FRIEND_TEST_ALL_PREFIXES(ThumbnailDatabaseTest, RetainDataForPageUrls);
+  FRIEND_TEST_ALL_PREFIXES(ThumbnailDatabaseTest, SharedBitmapData);
 
   // Creates the thumbnail table, returning true if the table already exists
   // or was successfully created.
@@ -257,6 +259,29 @@ class ThumbnailDatabase {
   // Removes sizes column.
   bool UpgradeToVersion7();
 
+  // Moves the bitmap data into the shared favicon_bitmap_data table.
+  bool UpgradeToVersion8();
+
+  // Returns the id of the favicon_bitmap_data row holding exactly |data|,
+  // whose hash is |hash|, or 0 if there is none.
+  int64 FindFaviconBitmapData(int64 hash, const base::RefCountedMemory& data);
+
+  // Sets |data_id| to a favicon_bitmap_data row holding |data|, adding one if
+  // needed, and takes a reference to it. Sets |data_id| to 0 if |data| is
+  // empty. Returns true if successful.
+  bool AddFaviconBitmapDataRef(
+      const scoped_refptr<base::RefCountedMemory>& data,
+      int64* data_id);
+
+  // Drops a reference to the favicon_bitmap_data row |data_id|, deleting the
+  // row once nothing refers to it. Does nothing if |data_id| is 0.
+  // Returns true if successful.
+  bool ReleaseFaviconBitmapData(int64 data_id);
+
+  // Returns the favicon_bitmap_data id used by the bitmap at |bitmap_id|, or 0
+  // if it has no data.
+  int64 GetFaviconBitmapDataID(FaviconBitmapID bitmap_id);
+
   // Returns true if the |favicons| database is missing a column.
   bool IsFaviconDBStructureIncorrect();
 
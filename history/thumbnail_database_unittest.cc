@@ -99,12 +99,14 @@ bool WritePage(const base::FilePath& path, size_t page_no,
 // present.  Any extraneous items have the potential to interact
 // negatively with future schema changes.
 void VerifyTablesAndColumns(sql::Connection* db) {
-  // [meta], [favicons], [favicon_bitmaps], and [icon_mapping].
-  EXPECT_EQ(4u, sql::test::CountSQLTables(db));
+  // [meta], [favicons], [favicon_bitmaps], [favicon_bitmap_data], and
+  // [icon_mapping].
+  EXPECT_EQ(5u, sql::test::CountSQLTables(db));
 
   // Implicit index on [meta], index on [favicons], index on
-  // [favicon_bitmaps], two indices on [icon_mapping].
-  EXPECT_EQ(5u, sql::test::CountSQLIndices(db));
+  // [favicon_bitmaps], index on [favicon_bitmap_data], two indices on
+  // [icon_mapping].
+  EXPECT_EQ(6u, sql::test::CountSQLIndices(db));
 
   // [key] and [value].
   EXPECT_EQ(2u, sql::test::CountTableColumns(db, "meta"));
@@ -112,9 +114,12 @@ void VerifyTablesAndColumns(sql::Connection* db) {
   // [id], [url], and [icon_type].
   EXPECT_EQ(3u, sql::test::CountTableColumns(db, "favicons"));
 
-  // [id], [icon_id], [last_updated], [image_data], [width], and [height].
+  // [id], [icon_id], [last_updated], [data_id], [width], and [height].
   EXPECT_EQ(6u, sql::test::CountTableColumns(db, "favicon_bitmaps"));
 
+  // [id], [hash], [image_data], and [ref_count].
+  EXPECT_EQ(4u, sql::test::CountTableColumns(db, "favicon_bitmap_data"));
+
   // [id], [page_url], and [icon_id].
   EXPECT_EQ(3u, sql::test::CountTableColumns(db, "icon_mapping"));
 }
@@ -125,6 +130,8 @@ void VerifyDatabaseEmpty(sql::Connection* db) {
   EXPECT_EQ(0u, rows);
   EXPECT_TRUE(sql::test::CountTableRows(db, "favicon_bitmaps", &rows));
   EXPECT_EQ(0u, rows);
+  EXPECT_TRUE(sql::test::CountTableRows(db, "favicon_bitmap_data", &rows));
+  EXPECT_EQ(0u, rows);
   EXPECT_TRUE(sql::test::CountTableRows(db, "icon_mapping", &rows));
   EXPECT_EQ(0u, rows);
 }
@@ -422,6 +429,63 @@ TEST_F(ThumbnailDatabaseTest, DeleteFavicon) {
   EXPECT_FALSE(db.GetFaviconBitmaps(id, NULL));
 }
 
+// Identical bitmaps should share one copy of their data, which goes away with
+// the last bitmap using it.
+TEST_F(ThumbnailDatabaseTest, SharedBitmapData) {
+  ThumbnailDatabase db;
+  ASSERT_EQ(sql::INIT_OK, db.Init(file_name_));
+  db.BeginTransaction();
+
+  std::vector<unsigned char> data1(kBlob1, kBlob1 + sizeof(kBlob1));
+  scoped_refptr<base::RefCountedBytes> favicon1(
+      new base::RefCountedBytes(data1));
+  std::vector<unsigned char> data2(kBlob2, kBlob2 + sizeof(kBlob2));
+  scoped_refptr<base::RefCountedBytes> favicon2(
+      new base::RefCountedBytes(data2));
+
+  base::Time time = base::Time::Now();
+  chrome::FaviconID id1 =
+      db.AddFavicon(GURL("http://google.com/favicon.ico"), chrome::FAVICON);
+  chrome::FaviconID id2 =
+      db.AddFavicon(GURL("http://yahoo.com/favicon.ico"), chrome::FAVICON);
+  FaviconBitmapID bitmap1 =
+      db.AddFaviconBitmap(id1, favicon1, time, kSmallSize);
+  FaviconBitmapID bitmap2 =
+      db.AddFaviconBitmap(id2, favicon1, time, kSmallSize);
+  ASSERT_NE(0, bitmap1);
+  ASSERT_NE(0, bitmap2);
+
+  size_t rows = 0;
+  EXPECT_TRUE(sql::test::CountTableRows(&db.db_, "favicon_bitmap_data", &rows));
+  EXPECT_EQ(1u, rows);
+
+  // Rewriting the same data only updates the time.
+  base::Time later = time + base::TimeDelta::FromMinutes(1);
+  EXPECT_TRUE(db.SetFaviconBitmap(bitmap1, favicon1, later));
+  base::Time last_updated;
+  EXPECT_TRUE(db.GetFaviconBitmap(bitmap1, &last_updated, NULL, NULL));
+  EXPECT_EQ(later, last_updated);
+  EXPECT_TRUE(sql::test::CountTableRows(&db.db_, "favicon_bitmap_data", &rows));
+  EXPECT_EQ(1u, rows);
+
+  // Changing one bitmap leaves the other's data alone.
+  EXPECT_TRUE(db.SetFaviconBitmap(bitmap1, favicon2, later));
+  EXPECT_TRUE(sql::test::CountTableRows(&db.db_, "favicon_bitmap_data", &rows));
+  EXPECT_EQ(2u, rows);
+  scoped_refptr<base::RefCountedMemory> png;
+  EXPECT_TRUE(db.GetFaviconBitmap(bitmap2, NULL, &png, NULL));
+  ASSERT_TRUE(png.get());
+  EXPECT_TRUE(png->Equals(favicon1));
+
+  // The data goes once nothing uses it.
+  EXPECT_TRUE(db.DeleteFavicon(id2));
+  EXPECT_TRUE(sql::test::CountTableRows(&db.db_, "favicon_bitmap_data", &rows));
+  EXPECT_EQ(1u, rows);
+  EXPECT_TRUE(db.DeleteFaviconBitmap(bitmap1));
+  EXPECT_TRUE(sql::test::CountTableRows(&db.db_, "favicon_bitmap_data", &rows));
+  EXPECT_EQ(0u, rows);
+}
+
 TEST_F(ThumbnailDatabaseTest, GetIconMappingsForPageURLForReturnOrder) {
   ThumbnailDatabase db;
   ASSERT_EQ(sql::INIT_OK, db.Init(file_name_));
@@ -4,6 +4,8 @@
 
 #include "chrome/browser/history/top_sites_cache.h"
 
+#include <algorithm>
+
 #include "base/logging.h"
 #include "base/memory/ref_counted_memory.h"
 #include "url/gurl.h"
@@ -17,8 +19,26 @@ TopSitesCache::~TopSitesCache() {
 }
 
 void TopSitesCache::SetTopSites(const MostVisitedURLList& top_sites) {
+  // Only the sites whose redirects changed (or that were added or removed)
+  // need re-indexing; TopSites typically calls this after a small reordering
+  // or a single new visit.
+  std::vector<size_t> changed;
+  size_t max_size = std::max(top_sites_.size(), top_sites.size());
+  for (size_t i = 0; i < max_size; ++i) {
+    if (i >= top_sites_.size() || i >= top_sites.size() ||
+        top_sites_[i].redirects != top_sites[i].redirects) {
+      changed.push_back(i);
+    }
+  }
+  for (size_t i = 0; i < changed.size(); ++i) {
+    if (changed[i] < top_sites_.size())
+      RemoveRedirectChain(changed[i]);
+  }
   top_sites_ = top_sites;
-  GenerateCanonicalURLs();
+  for (size_t i = 0; i < changed.size(); ++i) {
+    if (changed[i] < top_sites_.size())
+      AddRedirectChain(changed[i]);
+  }
 }
 
 void TopSitesCache::SetThumbnails(const URLToImagesMap& images) {
@@ -56,76 +76,69 @@ bool TopSitesCache::GetPageThumbnailScore(const GURL& url,
 }
 
 const GURL& TopSitesCache::GetCanonicalURL(const GURL& url) const {
-  CanonicalURLs::const_iterator it = GetCanonicalURLsIterator(url);
-  return it == canonical_urls_.end() ? url : it->first.first->url;
+  const SiteIndices* indices = GetSiteIndices(url);
+  return indices ? top_sites_[*indices->begin()].url : url;
 }
 
 const GURL& TopSitesCache::GetCanonicalURLForPrefix(const GURL& url) const {
-  CanonicalURLs::const_iterator it = GetCanonicalURLsIteratorForPrefix(url);
-  return it == canonical_urls_.end() ? url : it->first.first->url;
+  const SiteIndices* indices = GetSiteIndicesForPrefix(url);
+  return indices ? top_sites_[*indices->begin()].url : url;
 }
 
 bool TopSitesCache::IsKnownURL(const GURL& url) const {
-  return GetCanonicalURLsIterator(url) != canonical_urls_.end();
+  return GetSiteIndices(url) != NULL;
 }
 
 size_t TopSitesCache::GetURLIndex(const GURL& url) const {
   DCHECK(IsKnownURL(url));
-  return GetCanonicalURLsIterator(url)->second;
+  return *GetSiteIndices(url)->begin();
 }
 
-void TopSitesCache::GenerateCanonicalURLs() {
-  canonical_urls_.clear();
-  for (size_t i = 0; i < top_sites_.size(); i++)
-    StoreRedirectChain(top_sites_[i].redirects, i);
-}
-
-void TopSitesCache::StoreRedirectChain(const RedirectList& redirects,
-                                       size_t destination) {
+void TopSitesCache::AddRedirectChain(size_t index) {
   // |redirects| is empty if the user pinned a site and there are not enough top
   // sites before the pinned site.
+  const RedirectList& redirects = top_sites_[index].redirects;
+  for (size_t i = 0; i < redirects.size(); ++i) {
+    std::pair<CanonicalURLs::iterator, bool> result = canonical_urls_.insert(
+        std::make_pair(redirects[i].spec(), SiteIndices()));
+    if (result.second)
+      sorted_canonical_urls_.insert(&result.first->first);
+    // If this redirect is already known, the lowest index keeps it.
+    result.first->second.insert(index);
+  }
+}
 
-  // Map all the redirected URLs to the destination.
-  for (size_t i = 0; i < redirects.size(); i++) {
-    // If this redirect is already known, don't replace it with a new one.
-    if (!IsKnownURL(redirects[i])) {
-      CanonicalURLEntry entry;
-      entry.first = &(top_sites_[destination]);
-      entry.second = i;
-      canonical_urls_[entry] = destination;
+void TopSitesCache::RemoveRedirectChain(size_t index) {
+  const RedirectList& redirects = top_sites_[index].redirects;
+  for (size_t i = 0; i < redirects.size(); ++i) {
+    CanonicalURLs::iterator it = canonical_urls_.find(redirects[i].spec());
+    if (it == canonical_urls_.end())
+      continue;  // The chain listed this URL more than once.
+    it->second.erase(index);
+    if (it->second.empty()) {
+      sorted_canonical_urls_.erase(&it->first);
+      canonical_urls_.erase(it);
     }
   }
 }
 
-TopSitesCache::CanonicalURLs::const_iterator
-    TopSitesCache::GetCanonicalURLsIterator(const GURL& url) const {
-  MostVisitedURL most_visited_url;
-  most_visited_url.redirects.push_back(url);
-  CanonicalURLEntry entry;
-  entry.first = &most_visited_url;
-  entry.second = 0u;
-  return canonical_urls_.find(entry);
+const TopSitesCache::SiteIndices* TopSitesCache::GetSiteIndices(
+    const GURL& url) const {
+  CanonicalURLs::const_iterator it = canonical_urls_.find(url.spec());
+  return it == canonical_urls_.end() ? NULL : &it->second;
 }
 
-TopSitesCache::CanonicalURLs::const_iterator
-    TopSitesCache::GetCanonicalURLsIteratorForPrefix(const GURL& prefix_url)
-        const {
-  MostVisitedURL most_visited_url;
-  most_visited_url.redirects.push_back(prefix_url);
-  CanonicalURLEntry entry;
-  entry.first = &most_visited_url;
-  entry.second = 0u;
-
+const TopSitesCache::SiteIndices* TopSitesCache::GetSiteIndicesForPrefix(
+    const GURL& prefix_url) const {
   // Perform effective binary search for URL prefix search.
-  TopSitesCache::CanonicalURLs::const_iterator it =
-      canonical_urls_.lower_bound(entry);
+  SortedCanonicalURLs::const_iterator it =
+      sorted_canonical_urls_.lower_bound(&prefix_url.spec());
   // Perform prefix match.
-  if (it != canonical_urls_.end()) {
-    const GURL& comp_url = it->first.first->redirects[it->first.second];
-    if (!UrlIsPrefix(prefix_url, comp_url))
-      it = canonical_urls_.end();
+  if (it == sorted_canonical_urls_.end() ||
+      !UrlIsPrefix(prefix_url, GURL(**it))) {
+    return NULL;
   }
-  return it;
+  return &canonical_urls_.find(**it)->second;
 }
 
 }  // namespace history
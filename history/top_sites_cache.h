@@ -5,9 +5,11 @@
 #ifndef CHROME_BROWSER_HISTORY_TOP_SITES_CACHE_H_
 #define CHROME_BROWSER_HISTORY_TOP_SITES_CACHE_H_
 
-#include <map>
-#include <utility>
+#include <set>
+#include <string>
+#include <vector>
 
+#include "base/containers/hash_tables.h"
 #include "base/memory/ref_counted.h"
 #include "chrome/browser/history/history_types.h"
 #include "chrome/browser/history/url_utils.h"
@@ -21,17 +23,18 @@ namespace history {
 //
 //   input URL --(map 1)--> canonical URL --(map 2)--> image.
 //
-// (map 1) searches input URL in |canonical_urls_|. canonical URL is
+// (map 1) looks up input URL in the hashed |canonical_urls_|. canonical URL is
 // assigned to the resulting value if found; else input URL.
 //
 // (map 2) simply looks up canonical URL in |images_|.
 //
-// TopSiteCache also provides GetCanonicalURLsIteratorForPrefix(), which is an
+// TopSiteCache also provides GetCanonicalURLForPrefix(), which is an
 // alternative implementation of (map 1) that does the following:
 // - if canonical URL is a key in |canonical_urls_|, return the value.
 // - else if canonical URL is a "URL prefix" (see comment in url_utils.h) of
 //   some key in |canonical_urls_|, return the value corresponding to the key.
 // - else return input URL.
+// The prefix search uses |sorted_canonical_urls_|, which orders the same keys.
 
 // TopSitesCache caches the top sites and thumbnails for TopSites.
 class TopSitesCache {
@@ -39,7 +42,8 @@ class TopSitesCache {
   TopSitesCache();
   ~TopSitesCache();
 
-  // The top sites.
+  // The top sites. Only the entries whose redirects changed since the last
+  // call are re-indexed.
   void SetTopSites(const MostVisitedURLList& top_sites);
   const MostVisitedURLList& top_sites() const { return top_sites_; }
 
@@ -76,43 +80,44 @@ class TopSitesCache {
   size_t GetURLIndex(const GURL& url) const;
 
  private:
-  // The entries in CanonicalURLs, see CanonicalURLs for details. The second
-  // argument gives the index of the URL into MostVisitedURLs redirects.
-  typedef std::pair<MostVisitedURL*, size_t> CanonicalURLEntry;
-
-  // Comparator used for CanonicalURLs.
+  // The indices into |top_sites_| of the sites whose redirects contain a given
+  // URL. The URL is canonicalized to the first of these, so that when several
+  // sites redirect from the same URL the higher ranked one wins.
+  typedef std::set<size_t> SiteIndices;
+
+  // Maps each redirect URL spec to the sites it redirects to. Looking up the
+  // spec directly avoids the ordered string comparisons of a tree lookup for
+  // GetCanonicalURL() and IsKnownURL(), which run on the UI thread for every
+  // thumbnail request.
+  typedef base::hash_map<std::string, SiteIndices> CanonicalURLs;
+
+  // Comparator ordering |sorted_canonical_urls_| as CanonicalURLStringCompare
+  // orders the specs pointed to.
   class CanonicalURLComparator {
    public:
-    bool operator()(const CanonicalURLEntry& e1,
-                    const CanonicalURLEntry& e2) const {
-      return CanonicalURLStringCompare(e1.first->redirects[e1.second].spec(),
-                                       e2.first->redirects[e2.second].spec());
+    bool operator()(const std::string* s1, const std::string* s2) const {
+      return CanonicalURLStringCompare(*s1, *s2);
     }
   };
 
-  // This is used to map from redirect url to the MostVisitedURL the redirect is
-  // from. Ideally this would be map<GURL, size_t> (second param indexing into
-  // top_sites_), but this results in duplicating all redirect urls. As some
-  // sites have a lot of redirects, we instead use the MostVisitedURL* and the
-  // index of the redirect as the key, and the index into top_sites_ as the
-  // value. This way we aren't duplicating GURLs. CanonicalURLComparator
-  // enforces the ordering as if we were using GURLs.
-  typedef std::map<CanonicalURLEntry, size_t,
-                   CanonicalURLComparator> CanonicalURLs;
+  // The keys of |canonical_urls_| in an order that makes a URL prefix sort
+  // just before the URLs it is a prefix of. The pointers stay valid as long as
+  // the keys are in |canonical_urls_|.
+  typedef std::set<const std::string*,
+                   CanonicalURLComparator> SortedCanonicalURLs;
 
-  // Generates the set of canonical urls from |top_sites_|.
-  void GenerateCanonicalURLs();
+  // Adds the redirects of |top_sites_[index]| to the canonical URL indices.
+  void AddRedirectChain(size_t index);
 
-  // Stores a set of redirects. This is used by GenerateCanonicalURLs.
-  void StoreRedirectChain(const RedirectList& redirects, size_t destination);
+  // Removes the redirects of |top_sites_[index]| from them.
+  void RemoveRedirectChain(size_t index);
 
-  // Returns the iterator into |canonical_urls_| for the |url|.
-  CanonicalURLs::const_iterator GetCanonicalURLsIterator(const GURL& url) const;
+  // Returns the entry in |canonical_urls_| for the |url|, or NULL.
+  const SiteIndices* GetSiteIndices(const GURL& url) const;
 
-  // Returns the first iterator into |canonical_urls_| for which |prefix_url|
-  // is a URL prefix. Returns |canonical_urls_.end()| if no match is found.
-  CanonicalURLs::const_iterator GetCanonicalURLsIteratorForPrefix(
-      const GURL& prefix_url) const;
+  // Returns the entry in |canonical_urls_| for the first key for which
+  // |prefix_url| is a URL prefix, or NULL if there is none.
+  const SiteIndices* GetSiteIndicesForPrefix(const GURL& prefix_url) const;
 
   // The top sites.
   MostVisitedURLList top_sites_;
@@ -121,8 +126,9 @@ class TopSitesCache {
   URLToImagesMap images_;
 
   // Generated from the redirects to and from the most visited pages. See
-  // description above typedef for details.
+  // description above the typedefs for details.
   CanonicalURLs canonical_urls_;
+  SortedCanonicalURLs sorted_canonical_urls_;
 
   DISALLOW_COPY_AND_ASSIGN(TopSitesCache);
 };
@@ -0,0 +1,104 @@
+// Copyright 2013 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Benchmarks the canonical URL lookups of |TopSitesCache|, which run for every
+// thumbnail request, and the incremental updates done when the top sites
+// change. Results are printed in the perf_test RESULT format so that they can
+// be tracked by the perf bots.
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "base/compiler_specific.h"
+#include "base/strings/string16.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/time/time.h"
+#include "chrome/browser/history/top_sites_cache.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_test.h"
+#include "url/gurl.h"
+
+using base::TimeTicks;
+
+namespace history {
+
+namespace {
+
+// The number of top sites, as shown on the New Tab page, and of redirects
+// leading to each of them.
+const size_t kNumSites = 20;
+const size_t kRedirectsPerSite = 5;
+
+// The number of times all the queries are run.
+const int kNumIterations = 10000;
+
+class TopSitesCachePerfTest : public testing::Test {
+ protected:
+  virtual void SetUp() OVERRIDE {
+    for (size_t i = 0; i < kNumSites; ++i) {
+      std::string site = "http://www.site" + base::Uint64ToString(i) + ".com/";
+      top_sites_.push_back(MostVisitedURL(GURL(site), string16()));
+      for (size_t j = 0; j < kRedirectsPerSite; ++j) {
+        GURL redirect(site + "redirect/" + base::Uint64ToString(j));
+        top_sites_.back().redirects.push_back(redirect);
+        queries_.push_back(redirect);
+      }
+      queries_.push_back(GURL(site + "unknown"));
+    }
+    cache_.SetTopSites(top_sites_);
+  }
+
+  // Prints |time| in microseconds per each of |count| operations.
+  void PrintTimePerOperation(const std::string& trace,
+                             base::TimeDelta time,
+                             size_t count) {
+    perf_test::PrintResult("TopSitesCache", std::string(), trace,
+                           time.InMicrosecondsF() / count, "us", true);
+  }
+
+  MostVisitedURLList top_sites_;
+  std::vector<GURL> queries_;
+  TopSitesCache cache_;
+};
+
+}  // namespace
+
+TEST_F(TopSitesCachePerfTest, Lookup) {
+  size_t known = 0;
+  const TimeTicks start = TimeTicks::Now();
+  for (int i = 0; i < kNumIterations; ++i) {
+    for (size_t j = 0; j < queries_.size(); ++j) {
+      if (cache_.IsKnownURL(queries_[j]))
+        ++known;
+      cache_.GetCanonicalURL(queries_[j]);
+    }
+  }
+  PrintTimePerOperation("lookup", TimeTicks::Now() - start,
+                        kNumIterations * queries_.size());
+  EXPECT_EQ(kNumIterations * kNumSites * kRedirectsPerSite, known);
+}
+
+TEST_F(TopSitesCachePerfTest, PrefixLookup) {
+  const TimeTicks start = TimeTicks::Now();
+  for (int i = 0; i < kNumIterations; ++i) {
+    for (size_t j = 0; j < queries_.size(); ++j)
+      cache_.GetCanonicalURLForPrefix(queries_[j]);
+  }
+  PrintTimePerOperation("prefix_lookup", TimeTicks::Now() - start,
+                        kNumIterations * queries_.size());
+}
+
+// Rotating the last two sites re-indexes just those two chains.
+TEST_F(TopSitesCachePerfTest, Update) {
+  const int kNumUpdates = kNumIterations / 10;
+  const TimeTicks start = TimeTicks::Now();
+  for (int i = 0; i < kNumUpdates; ++i) {
+    std::swap(top_sites_[kNumSites - 1], top_sites_[kNumSites - 2]);
+    cache_.SetTopSites(top_sites_);
+  }
+  PrintTimePerOperation("update", TimeTicks::Now() - start, kNumUpdates);
+}
+
+}  // namespace history
@@ -4,7 +4,10 @@
 
 #include "chrome/browser/history/top_sites_cache.h"
 
+#include <algorithm>
 #include <set>
+#include <string>
+#include <vector>
 
 #include "base/basictypes.h"
 #include "base/logging.h"
@@ -170,6 +173,55 @@ TEST_F(TopSitesCacheTest, GetCanonicalURLForPrefix) {
   }
 }
 
+// Tests that updating the top sites in place re-indexes the redirects so that
+// lookups match a cache built from scratch.
+TEST_F(TopSitesCacheTest, IncrementalUpdate) {
+  InitTopSiteCache(kTopSitesSpecBasic, arraysize(kTopSitesSpecBasic));
+
+  // Make youtube share a redirect with google, drop the last site and swap
+  // the secure google and youtube entries.
+  MostVisitedURLList updated(top_sites_);
+  updated[1].redirects.push_back(GURL("http://www.gogle.com"));
+  updated.pop_back();
+  std::swap(updated[1], updated[2]);
+  cache_.SetTopSites(updated);
+
+  TopSitesCache fresh;
+  fresh.SetTopSites(updated);
+
+  const char* queries[] = {
+    "http://www.google.com",
+    "http://www.gogle.com",
+    "http://www.youtube.com/a/b",
+    "http://www.youtube.com/a/b?test=1",
+    "https://www.google.com/",
+    "https://www.gogle.com",
+    "http://www.example.com:3141/",
+    "http://www.youtube.com/",
+  };
+  for (size_t i = 0; i < arraysize(queries); ++i) {
+    GURL url(queries[i]);
+    EXPECT_EQ(fresh.IsKnownURL(url), cache_.IsKnownURL(url)) << queries[i];
+    EXPECT_EQ(fresh.GetCanonicalURL(url), cache_.GetCanonicalURL(url))
+        << queries[i];
+    EXPECT_EQ(fresh.GetCanonicalURLForPrefix(url),
+              cache_.GetCanonicalURLForPrefix(url)) << queries[i];
+    if (fresh.IsKnownURL(url))
+      EXPECT_EQ(fresh.GetURLIndex(url), cache_.GetURLIndex(url)) << queries[i];
+  }
+  // The shared redirect stays with the higher ranked site.
+  EXPECT_EQ("http://www.google.com/",
+            cache_.GetCanonicalURL(GURL("http://www.gogle.com")).spec());
+  EXPECT_FALSE(cache_.IsKnownURL(GURL("http://www.example.com:3141/")));
+
+  // Dropping the higher ranked site hands the shared redirect to youtube.
+  updated.erase(updated.begin());
+  cache_.SetTopSites(updated);
+  EXPECT_EQ("http://www.youtube.com/a/b",
+            cache_.GetCanonicalURL(GURL("http://www.gogle.com")).spec());
+  EXPECT_FALSE(cache_.IsKnownURL(GURL("http://www.gooogle.com")));
+}
+
 }  // namespace
 
 }  // namespace history
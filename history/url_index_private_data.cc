@@ -5,19 +5,28 @@
 #include "chrome/browser/history/url_index_private_data.h"
 
 #include <algorithm>
+#include <cstring>
 #include <functional>
 #include <iterator>
 #include <limits>
 #include <numeric>
+#include <set>
 #include <string>
 #include <vector>
 
 #include "base/basictypes.h"
+#include "base/bind.h"
 #include "base/file_util.h"
+#include "base/files/memory_mapped_file.h"
 #include "base/i18n/case_conversion.h"
+#include "base/memory/scoped_ptr.h"
 #include "base/metrics/histogram.h"
 #include "base/strings/string_util.h"
 #include "base/strings/utf_string_conversions.h"
+#include "base/synchronization/lock.h"
+#include "base/synchronization/waitable_event.h"
+#include "base/threading/thread_restrictions.h"
+#include "base/threading/worker_pool.h"
 #include "base/time/time.h"
 #include "chrome/browser/autocomplete/autocomplete_provider.h"
 #include "chrome/browser/autocomplete/url_prefix.h"
@@ -44,6 +53,161 @@ using in_memory_url_index::InMemoryURLIndexCacheItem;
 
 namespace {
 static const size_t kMaxVisitsToStoreInCache = 10u;
+
+// The first four bytes of a flat cache file ("HQPF" when read as
+// little-endian). A file starting with anything else is treated as a
+// protobuf cache. A byte-swapped magic number (a file written on a machine of
+// the other endianness) is also rejected.
+const uint32 kFlatCacheMagic = 0x46505148;
+
+// Flat cache file header.
+struct FlatCacheHeader {
+  uint32 magic;
+  int32 layout_version;
+  int32 cache_version;
+  int32 padding;
+  int64 last_rebuild_timestamp;
+};
+
+// Appends the raw bytes of |value| to |data|.
+template<typename T>
+void AppendPOD(std::string* data, const T& value) {
+  data->append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+// Appends the element count of |values| followed by each element stored as a
+// FileType.
+template<typename FileType, typename T>
+void AppendArray(std::string* data, const std::vector<T>& values) {
+  AppendPOD(data, static_cast<uint32>(values.size()));
+  if (sizeof(FileType) == sizeof(T)) {
+    if (!values.empty()) {
+      data->append(reinterpret_cast<const char*>(&values[0]),
+                   values.size() * sizeof(T));
+    }
+    return;
+  }
+  for (typename std::vector<T>::const_iterator iter = values.begin();
+       iter != values.end(); ++iter)
+    AppendPOD(data, static_cast<FileType>(*iter));
+}
+
+void AppendString16(std::string* data, const string16& value) {
+  AppendPOD(data, static_cast<uint32>(value.length()));
+  data->append(reinterpret_cast<const char*>(value.data()),
+               value.length() * sizeof(char16));
+}
+
+void AppendString(std::string* data, const std::string& value) {
+  AppendPOD(data, static_cast<uint32>(value.length()));
+  data->append(value);
+}
+
+// Reads values out of a flat cache buffer. Every read is bounds checked and
+// a failed read leaves the reader in a failed state.
+class FlatCacheReader {
+ public:
+  FlatCacheReader(const uint8* data, size_t length)
+      : data_(data), length_(length), offset_(0) {}
+
+  template<typename T>
+  bool ReadPOD(T* value) {
+    if (!Has(sizeof(T)))
+      return false;
+    memcpy(value, data_ + offset_, sizeof(T));
+    offset_ += sizeof(T);
+    return true;
+  }
+
+  // Reads an array written by AppendArray<FileType>(). Arrays whose in-memory
+  // element type matches the file element type are copied in one block.
+  template<typename FileType, typename T>
+  bool ReadArray(std::vector<T>* values) {
+    uint32 count = 0;
+    if (!ReadPOD(&count) || count > (length_ - offset_) / sizeof(FileType))
+      return false;
+    values->resize(count);
+    if (sizeof(FileType) == sizeof(T)) {
+      if (count)
+        memcpy(&(*values)[0], data_ + offset_, count * sizeof(T));
+      offset_ += count * sizeof(T);
+      return true;
+    }
+    for (uint32 i = 0; i < count; ++i) {
+      FileType value;
+      ReadPOD(&value);
+      (*values)[i] = static_cast<T>(value);
+    }
+    return true;
+  }
+
+  bool ReadString16(string16* value) {
+    uint32 length = 0;
+    if (!ReadPOD(&length) || length > (length_ - offset_) / sizeof(char16))
+      return false;
+    value->resize(length);
+    if (length)
+      memcpy(&(*value)[0], data_ + offset_, length * sizeof(char16));
+    offset_ += length * sizeof(char16);
+    return true;
+  }
+
+  bool ReadString(std::string* value) {
+    uint32 length = 0;
+    if (!ReadPOD(&length) || !Has(length))
+      return false;
+    value->assign(reinterpret_cast<const char*>(data_ + offset_), length);
+    offset_ += length;
+    return true;
+  }
+
+  bool AtEnd() const { return offset_ == length_; }
+
+ private:
+  bool Has(size_t bytes) const { return bytes <= length_ - offset_; }
+
+  const uint8* data_;
+  const size_t length_;
+  size_t offset_;
+
+  DISALLOW_COPY_AND_ASSIGN(FlatCacheReader);
+};
+
+// Returns true if |values| is sorted and free of duplicates.
+template<typename T>
+bool IsStrictlyIncreasing(const std::vector<T>& values) {
+  return std::adjacent_find(values.begin(), values.end(),
+                            std::greater_equal<T>()) == values.end();
+}
+
+// A BookmarkService answering IsBookmarked() from a fixed set of URLs. Used
+// to hand bookmark state to scoring threads, which may not call into the real
+// BookmarkService without blocking until it has loaded.
+class BookmarkedURLSnapshot : public BookmarkService {
+ public:
+  BookmarkedURLSnapshot() {}
+  virtual ~BookmarkedURLSnapshot() {}
+
+  void AddURL(const GURL& url) { urls_.insert(url); }
+
+  virtual bool IsBookmarked(const GURL& url) OVERRIDE {
+    return urls_.find(url) != urls_.end();
+  }
+  virtual void GetBookmarks(std::vector<URLAndTitle>* bookmarks) OVERRIDE {
+    NOTREACHED();
+  }
+  virtual void BlockTillLoaded() OVERRIDE {}
+
+ private:
+  std::set<GURL> urls_;
+
+  DISALLOW_COPY_AND_ASSIGN(BookmarkedURLSnapshot);
+};
+
+// Scoring is only spread across threads when there are at least this many
+// candidates; below that the cost of handing out the work dominates.
+const size_t kMinCandidatesForParallelScoring = 200;
+
 }  // anonymous namespace
 
 namespace history {
@@ -77,6 +241,18 @@ bool LengthGreater(const string16& string_a, const string16& string_b) {
   return string_a.length() > string_b.length();
 }
 
+// Comparison function for sorting word vectors by ascending size.
+bool VectorSizeLess(const WordIDVector* vector_a,
+                    const WordIDVector* vector_b) {
+  return vector_a->size() < vector_b->size();
+}
+
+// Orders CompactCharWordIDMap entries by their character.
+bool CharWordEntryLess(const CompactCharWordIDMap::value_type& entry_a,
+                       const CompactCharWordIDMap::value_type& entry_b) {
+  return entry_a.first < entry_b.first;
+}
+
 
 // UpdateRecentVisitsFromHistoryDBTask -----------------------------------------
 
@@ -143,7 +319,10 @@ UpdateRecentVisitsFromHistoryDBTask::~UpdateRecentVisitsFromHistoryDBTask() {
 // URLIndexPrivateData ---------------------------------------------------------
 
 URLIndexPrivateData::URLIndexPrivateData()
-    : restored_cache_version_(0),
+    : search_term_cache_hits_(0),
+      search_term_cache_misses_(0),
+      use_compact_index_(false),
+      restored_cache_version_(0),
       saved_cache_version_(kCurrentCacheFileVersion),
       pre_filter_item_count_(0),
       post_filter_item_count_(0),
@@ -154,7 +333,9 @@ ScoredHistoryMatches URLIndexPrivateData::HistoryItemsForTerms(
     string16 search_string,
     size_t cursor_position,
     const std::string& languages,
-    BookmarkService* bookmark_service) {
+    BookmarkService* bookmark_service,
+    size_t scoring_thread_count,
+    ScoringCancellationFlag* cancel_flag) {
   // If cursor position is set and useful (not at either end of the
   // string), allow the search string to be broken at cursor position.
   // We do this by pretending there's a space where the cursor is.
@@ -244,21 +425,53 @@ ScoredHistoryMatches URLIndexPrivateData::HistoryItemsForTerms(
     // but this is such a rare edge case that it's not worth the time.
     return scored_items;
   }
-  scored_items = std::for_each(history_id_set.begin(), history_id_set.end(),
-      AddHistoryMatch(*this, languages, bookmark_service, lower_raw_string,
-                      lower_raw_terms, base::Time::Now())).ScoredMatches();
+  if (scoring_thread_count > 1 &&
+      history_id_set.size() >= kMinCandidatesForParallelScoring) {
+    // The scoring tables are built lazily and not thread safe, so make sure
+    // they exist before any other thread gets to them.
+    ScoredHistoryMatch::InitializeStaticTables();
+    HistoryIDVector candidates(history_id_set.begin(), history_id_set.end());
+    scoped_refptr<ParallelScorer> scorer(new ParallelScorer(
+        *this, languages, bookmark_service, lower_raw_string, lower_raw_terms,
+        base::Time::Now(), candidates, scoring_thread_count, cancel_flag));
+    for (size_t i = 1; i < scoring_thread_count; ++i) {
+      base::WorkerPool::PostTask(
+          FROM_HERE, base::Bind(&ParallelScorer::ScoreChunks, scorer), false);
+    }
+    // Score alongside the workers; this also covers any chunk whose worker
+    // has not been scheduled yet.
+    scorer->ScoreChunks();
+    scored_items = scorer->WaitForMatches();
+  } else {
+    AddHistoryMatch add_match(*this, languages, bookmark_service,
+                              lower_raw_string, lower_raw_terms,
+                              base::Time::Now());
+    for (HistoryIDSet::const_iterator iter = history_id_set.begin();
+         iter != history_id_set.end(); ++iter) {
+      if (cancel_flag && cancel_flag->data.IsSet())
+        break;
+      add_match(*iter);
+    }
+    scored_items = add_match.ScoredMatches();
+  }
+  if (cancel_flag && cancel_flag->data.IsSet()) {
+    // The query has been superseded; its results would go unused.
+    post_scoring_item_count_ = 0;
+    return ScoredHistoryMatches();
+  }
 
-  // Select and sort only the top kMaxMatches results.
+  // Select and sort only the top kMaxMatches results. Ties are broken by
+  // URL ID so the order does not depend on how the candidates were scored.
   if (scored_items.size() > AutocompleteProvider::kMaxMatches) {
     std::partial_sort(scored_items.begin(),
                       scored_items.begin() +
                           AutocompleteProvider::kMaxMatches,
                       scored_items.end(),
-                      ScoredHistoryMatch::MatchScoreGreater);
+                      ScoredHistoryMatch::MatchScoreGreaterWithIDTieBreak);
       scored_items.resize(AutocompleteProvider::kMaxMatches);
   } else {
     std::sort(scored_items.begin(), scored_items.end(),
-              ScoredHistoryMatch::MatchScoreGreater);
+              ScoredHistoryMatch::MatchScoreGreaterWithIDTieBreak);
   }
   post_scoring_item_count_ = scored_items.size();
 
@@ -330,8 +543,7 @@ bool URLIndexPrivateData::UpdateURL(
     RemoveRowFromIndex(row);
     row_was_updated = true;
   }
-  if (row_was_updated)
-    search_term_cache_.clear();  // This invalidates the cache.
+  // Any word changes have already been patched into the search term cache.
   return row_was_updated;
 }
 
@@ -387,7 +599,6 @@ bool URLIndexPrivateData::DeleteURL(const GURL& url) {
   if (pos == history_info_map_.end())
     return false;
   RemoveRowFromIndex(pos->second.url_row);
-  search_term_cache_.clear();  // This invalidates the cache.
   return true;
 }
 
@@ -398,32 +609,50 @@ scoped_refptr<URLIndexPrivateData> URLIndexPrivateData::RestoreFromFile(
   base::TimeTicks beginning_time = base::TimeTicks::Now();
   if (!base::PathExists(file_path))
     return NULL;
-  std::string data;
   // If there is no cache file then simply give up. This will cause us to
   // attempt to rebuild from the history database.
-  if (!base::ReadFileToString(file_path, &data))
+  base::MemoryMappedFile mapped_file;
+  if (!mapped_file.Initialize(file_path) || !mapped_file.IsValid())
     return NULL;
+  const uint8* data = mapped_file.data();
+  const size_t length = mapped_file.length();
 
   scoped_refptr<URLIndexPrivateData> restored_data(new URLIndexPrivateData);
-  InMemoryURLIndexCacheItem index_cache;
-  if (!index_cache.ParseFromArray(data.c_str(), data.size())) {
-    LOG(WARNING) << "Failed to parse URLIndexPrivateData cache data read from "
-                 << file_path.value();
-    return restored_data;
-  }
+  const bool is_flat_cache = IsFlatCacheData(data, length);
+  if (is_flat_cache) {
+    if (!restored_data->RestoreFromFlatData(data, length))
+      return NULL;
+  } else {
+    // Older cache files are protobufs. These are still read so that an
+    // existing cache is migrated to the flat format the next time it is
+    // saved with the compact index in use.
+    InMemoryURLIndexCacheItem index_cache;
+    if (!index_cache.ParseFromArray(data, length)) {
+      LOG(WARNING) << "Failed to parse URLIndexPrivateData cache data read "
+                   << "from " << file_path.value();
+      return restored_data;
+    }
 
-  if (!restored_data->RestorePrivateData(index_cache, languages))
-    return NULL;
+    if (!restored_data->RestorePrivateData(index_cache, languages))
+      return NULL;
+  }
 
-  UMA_HISTOGRAM_TIMES("History.InMemoryURLIndexRestoreCacheTime",
-                      base::TimeTicks::Now() - beginning_time);
+  if (is_flat_cache) {
+    UMA_HISTOGRAM_TIMES("History.InMemoryURLIndexRestoreFlatCacheTime",
+                        base::TimeTicks::Now() - beginning_time);
+  } else {
+    UMA_HISTOGRAM_TIMES("History.InMemoryURLIndexRestoreCacheTime",
+                        base::TimeTicks::Now() - beginning_time);
+  }
   UMA_HISTOGRAM_COUNTS("History.InMemoryURLHistoryItems",
                        restored_data->history_id_word_map_.size());
-  UMA_HISTOGRAM_COUNTS("History.InMemoryURLCacheSize", data.size());
+  UMA_HISTOGRAM_COUNTS("History.InMemoryURLCacheSize", length);
   UMA_HISTOGRAM_COUNTS_10000("History.InMemoryURLWords",
                              restored_data->word_map_.size());
   UMA_HISTOGRAM_COUNTS_10000("History.InMemoryURLChars",
-                             restored_data->char_word_map_.size());
+                             restored_data->use_compact_index_ ?
+                                 restored_data->compact_char_word_map_.size() :
+                                 restored_data->char_word_map_.size());
   if (restored_data->Empty())
     return NULL;  // 'No data' is the same as a failed reload.
   return restored_data;
@@ -482,6 +711,9 @@ scoped_refptr<URLIndexPrivateData> URLIndexPrivateData::Duplicate() const {
   data_copy->word_map_ = word_map_;
   data_copy->char_word_map_ = char_word_map_;
   data_copy->word_id_history_map_ = word_id_history_map_;
+  data_copy->use_compact_index_ = use_compact_index_;
+  data_copy->compact_char_word_map_ = compact_char_word_map_;
+  data_copy->compact_word_id_history_map_ = compact_word_id_history_map_;
   data_copy->history_id_word_map_ = history_id_word_map_;
   data_copy->history_info_map_ = history_info_map_;
   data_copy->word_starts_map_ = word_starts_map_;
@@ -504,11 +736,103 @@ void URLIndexPrivateData::Clear() {
   word_map_.clear();
   char_word_map_.clear();
   word_id_history_map_.clear();
+  compact_char_word_map_.clear();
+  compact_word_id_history_map_.clear();
   history_id_word_map_.clear();
   history_info_map_.clear();
   word_starts_map_.clear();
 }
 
+void URLIndexPrivateData::SetUseCompactIndex(bool use_compact_index) {
+  if (use_compact_index == use_compact_index_)
+    return;
+  if (use_compact_index)
+    ConvertToCompactIndex();
+  else
+    ConvertFromCompactIndex();
+  use_compact_index_ = use_compact_index;
+  // The cached word sets remain valid but are cheap to rebuild; start afresh
+  // so that no state straddles the two representations.
+  search_term_cache_.clear();
+}
+
+size_t URLIndexPrivateData::EstimateIndexMemoryUsage() const {
+  // Each std::map and std::set element lives in its own red-black tree node
+  // holding a color and three pointers in addition to the value.
+  const size_t kTreeNodeOverhead = sizeof(int) + 3 * sizeof(void*);
+  size_t bytes = 0;
+  if (use_compact_index_) {
+    bytes += compact_char_word_map_.capacity() *
+        sizeof(CompactCharWordIDMap::value_type);
+    for (CompactCharWordIDMap::const_iterator iter =
+         compact_char_word_map_.begin();
+         iter != compact_char_word_map_.end(); ++iter)
+      bytes += iter->second.capacity() * sizeof(WordID);
+    bytes += compact_word_id_history_map_.capacity() * sizeof(HistoryIDVector);
+    for (CompactWordIDHistoryMap::const_iterator iter =
+         compact_word_id_history_map_.begin();
+         iter != compact_word_id_history_map_.end(); ++iter)
+      bytes += iter->capacity() * sizeof(HistoryID);
+    return bytes;
+  }
+  for (CharWordIDMap::const_iterator iter = char_word_map_.begin();
+       iter != char_word_map_.end(); ++iter) {
+    bytes += kTreeNodeOverhead + sizeof(CharWordIDMap::value_type);
+    bytes += iter->second.size() * (kTreeNodeOverhead + sizeof(WordID));
+  }
+  for (WordIDHistoryMap::const_iterator iter = word_id_history_map_.begin();
+       iter != word_id_history_map_.end(); ++iter) {
+    bytes += kTreeNodeOverhead + sizeof(WordIDHistoryMap::value_type);
+    bytes += iter->second.size() * (kTreeNodeOverhead + sizeof(HistoryID));
+  }
+  return bytes;
+}
+
+void URLIndexPrivateData::ConvertToCompactIndex() {
+  compact_char_word_map_.clear();
+  compact_char_word_map_.reserve(char_word_map_.size());
+  for (CharWordIDMap::const_iterator iter = char_word_map_.begin();
+       iter != char_word_map_.end(); ++iter) {
+    // std::map iteration is ordered so the result is sorted by character.
+    compact_char_word_map_.push_back(std::make_pair(
+        iter->first, WordIDVector(iter->second.begin(), iter->second.end())));
+  }
+  CharWordIDMap().swap(char_word_map_);
+
+  compact_word_id_history_map_.clear();
+  compact_word_id_history_map_.resize(word_list_.size());
+  for (WordIDHistoryMap::const_iterator iter = word_id_history_map_.begin();
+       iter != word_id_history_map_.end(); ++iter) {
+    if (iter->first >= compact_word_id_history_map_.size())
+      compact_word_id_history_map_.resize(iter->first + 1);
+    compact_word_id_history_map_[iter->first].assign(iter->second.begin(),
+                                                     iter->second.end());
+  }
+  WordIDHistoryMap().swap(word_id_history_map_);
+}
+
+void URLIndexPrivateData::ConvertFromCompactIndex() {
+  char_word_map_.clear();
+  for (CompactCharWordIDMap::const_iterator iter =
+       compact_char_word_map_.begin();
+       iter != compact_char_word_map_.end(); ++iter) {
+    char_word_map_[iter->first] =
+        WordIDSet(iter->second.begin(), iter->second.end());
+  }
+  CompactCharWordIDMap().swap(compact_char_word_map_);
+
+  word_id_history_map_.clear();
+  for (size_t word_id = 0; word_id < compact_word_id_history_map_.size();
+       ++word_id) {
+    const HistoryIDVector& history_ids(compact_word_id_history_map_[word_id]);
+    if (!history_ids.empty()) {
+      word_id_history_map_[word_id] =
+          HistoryIDSet(history_ids.begin(), history_ids.end());
+    }
+  }
+  CompactWordIDHistoryMap().swap(compact_word_id_history_map_);
+}
+
 URLIndexPrivateData::~URLIndexPrivateData() {}
 
 HistoryIDSet URLIndexPrivateData::HistoryIDSetFromWords(
@@ -572,7 +896,10 @@ HistoryIDSet URLIndexPrivateData::HistoryIDsForTerm(
     // for further refining the results from that prefix.
     Char16Set prefix_chars;
     string16 leftovers(term);
-    if (best_prefix != search_term_cache_.end()) {
+    if (best_prefix == search_term_cache_.end()) {
+      ++search_term_cache_misses_;
+    } else {
+      ++search_term_cache_hits_;
       // If the prefix is an exact match for the term then grab the cached
       // results and we're done.
       size_t prefix_length = best_prefix->first.length();
@@ -635,18 +962,8 @@ HistoryIDSet URLIndexPrivateData::HistoryIDsForTerm(
   // If any words resulted then we can compose a set of history IDs by unioning
   // the sets from each word.
   HistoryIDSet history_id_set;
-  if (!word_id_set.empty()) {
-    for (WordIDSet::iterator word_id_iter = word_id_set.begin();
-         word_id_iter != word_id_set.end(); ++word_id_iter) {
-      WordID word_id = *word_id_iter;
-      WordIDHistoryMap::iterator word_iter = word_id_history_map_.find(word_id);
-      if (word_iter != word_id_history_map_.end()) {
-        HistoryIDSet& word_history_id_set(word_iter->second);
-        history_id_set.insert(word_history_id_set.begin(),
-                              word_history_id_set.end());
-      }
-    }
-  }
+  if (!word_id_set.empty())
+    AddHistoryIDsForWords(word_id_set, &history_id_set);
 
   // Record a new cache entry for this word if the term is longer than
   // a single character.
@@ -658,6 +975,9 @@ HistoryIDSet URLIndexPrivateData::HistoryIDsForTerm(
 
 WordIDSet URLIndexPrivateData::WordIDSetForTermChars(
     const Char16Set& term_chars) {
+  if (use_compact_index_)
+    return CompactWordIDSetForTermChars(term_chars);
+
   WordIDSet word_id_set;
   for (Char16Set::const_iterator c_iter = term_chars.begin();
        c_iter != term_chars.end(); ++c_iter) {
@@ -691,6 +1011,70 @@ WordIDSet URLIndexPrivateData::WordIDSetForTermChars(
   return word_id_set;
 }
 
+WordIDSet URLIndexPrivateData::CompactWordIDSetForTermChars(
+    const Char16Set& term_chars) {
+  // Gather the word vector for each character. Intersecting the shortest
+  // vectors first keeps the intermediate results as small as possible.
+  std::vector<const WordIDVector*> char_word_ids;
+  char_word_ids.reserve(term_chars.size());
+  for (Char16Set::const_iterator c_iter = term_chars.begin();
+       c_iter != term_chars.end(); ++c_iter) {
+    const WordIDVector* word_ids =
+        FindInCompactCharWordIDMap(compact_char_word_map_, *c_iter);
+    // A character was not found so there are no matching results: bail.
+    if (!word_ids || word_ids->empty())
+      return WordIDSet();
+    char_word_ids.push_back(word_ids);
+  }
+  if (char_word_ids.empty())
+    return WordIDSet();
+  std::sort(char_word_ids.begin(), char_word_ids.end(), VectorSizeLess);
+
+  WordIDVector word_ids(*char_word_ids[0]);
+  WordIDVector intersection;
+  for (size_t i = 1; i < char_word_ids.size() && !word_ids.empty(); ++i) {
+    IntersectSortedVectors(word_ids, *char_word_ids[i], &intersection);
+    word_ids.swap(intersection);
+  }
+  // The input is sorted so each insertion is amortized constant time.
+  return WordIDSet(word_ids.begin(), word_ids.end());
+}
+
+void URLIndexPrivateData::AddHistoryIDsForWords(
+    const WordIDSet& word_id_set,
+    HistoryIDSet* history_id_set) const {
+  if (!use_compact_index_) {
+    for (WordIDSet::const_iterator word_id_iter = word_id_set.begin();
+         word_id_iter != word_id_set.end(); ++word_id_iter) {
+      WordIDHistoryMap::const_iterator word_iter =
+          word_id_history_map_.find(*word_id_iter);
+      if (word_iter != word_id_history_map_.end()) {
+        const HistoryIDSet& word_history_id_set(word_iter->second);
+        history_id_set->insert(word_history_id_set.begin(),
+                               word_history_id_set.end());
+      }
+    }
+    return;
+  }
+
+  // Concatenate the posting lists and then sort and unique them in a single
+  // pass rather than doing a tree insertion per element.
+  HistoryIDVector history_ids;
+  for (WordIDSet::const_iterator word_id_iter = word_id_set.begin();
+       word_id_iter != word_id_set.end(); ++word_id_iter) {
+    if (*word_id_iter >= compact_word_id_history_map_.size())
+      continue;
+    const HistoryIDVector& word_history_ids(
+        compact_word_id_history_map_[*word_id_iter]);
+    history_ids.insert(history_ids.end(), word_history_ids.begin(),
+                       word_history_ids.end());
+  }
+  std::sort(history_ids.begin(), history_ids.end());
+  history_ids.erase(std::unique(history_ids.begin(), history_ids.end()),
+                    history_ids.end());
+  history_id_set->insert(history_ids.begin(), history_ids.end());
+}
+
 bool URLIndexPrivateData::IndexRow(
     HistoryDatabase* history_db,
     HistoryService* history_service,
@@ -767,8 +1151,6 @@ void URLIndexPrivateData::AddRowWordsToIndex(const URLRow& row,
   for (String16Set::iterator word_iter = words.begin();
        word_iter != words.end(); ++word_iter)
     AddWordToIndex(*word_iter, history_id);
-
-  search_term_cache_.clear();  // Invalidate the term cache.
 }
 
 void URLIndexPrivateData::AddWordToIndex(const string16& term,
@@ -792,17 +1174,45 @@ void URLIndexPrivateData::AddWordHistory(const string16& term,
   }
   word_map_[term] = word_id;
 
-  HistoryIDSet history_id_set;
-  history_id_set.insert(history_id);
-  word_id_history_map_[word_id] = history_id_set;
+  if (use_compact_index_) {
+    if (word_id >= compact_word_id_history_map_.size())
+      compact_word_id_history_map_.resize(word_id + 1);
+    HistoryIDVector& history_ids(compact_word_id_history_map_[word_id]);
+    DCHECK(history_ids.empty());
+    history_ids.push_back(history_id);
+  } else {
+    HistoryIDSet history_id_set;
+    history_id_set.insert(history_id);
+    word_id_history_map_[word_id] = history_id_set;
+  }
   AddToHistoryIDWordMap(history_id, word_id);
+  AddWordHistoryToSearchTermCache(word_id, history_id);
 
   // For each character in the newly added word (i.e. a word that is not
   // already in the word index), add the word to the character index.
-  Char16Set characters = Char16SetFromString16(term);
+  AddWordToCharIndex(term, word_id);
+}
+
+void URLIndexPrivateData::AddWordToCharIndex(const string16& word,
+                                             WordID word_id) {
+  Char16Set characters = Char16SetFromString16(word);
   for (Char16Set::iterator uni_char_iter = characters.begin();
        uni_char_iter != characters.end(); ++uni_char_iter) {
     char16 uni_char = *uni_char_iter;
+    if (use_compact_index_) {
+      CompactCharWordIDMap::iterator char_iter =
+          std::lower_bound(compact_char_word_map_.begin(),
+                           compact_char_word_map_.end(),
+                           std::make_pair(uni_char, WordIDVector()),
+                           CharWordEntryLess);
+      if (char_iter == compact_char_word_map_.end() ||
+          char_iter->first != uni_char) {
+        char_iter = compact_char_word_map_.insert(
+            char_iter, std::make_pair(uni_char, WordIDVector()));
+      }
+      InsertIntoSortedVector(&char_iter->second, word_id);
+      continue;
+    }
     CharWordIDMap::iterator char_iter = char_word_map_.find(uni_char);
     if (char_iter != char_word_map_.end()) {
       // Update existing entry in the char/word index.
@@ -817,13 +1227,46 @@ void URLIndexPrivateData::AddWordHistory(const string16& term,
   }
 }
 
+void URLIndexPrivateData::RemoveWordFromCharIndex(const string16& word,
+                                                  WordID word_id) {
+  Char16Set characters = Char16SetFromString16(word);
+  for (Char16Set::iterator uni_char_iter = characters.begin();
+       uni_char_iter != characters.end(); ++uni_char_iter) {
+    char16 uni_char = *uni_char_iter;
+    if (use_compact_index_) {
+      CompactCharWordIDMap::iterator char_iter =
+          std::lower_bound(compact_char_word_map_.begin(),
+                           compact_char_word_map_.end(),
+                           std::make_pair(uni_char, WordIDVector()),
+                           CharWordEntryLess);
+      if (char_iter == compact_char_word_map_.end() ||
+          char_iter->first != uni_char)
+        continue;
+      EraseFromSortedVector(&char_iter->second, word_id);
+      if (char_iter->second.empty())
+        compact_char_word_map_.erase(char_iter);  // No longer in use.
+      continue;
+    }
+    char_word_map_[uni_char].erase(word_id);
+    if (char_word_map_[uni_char].empty())
+      char_word_map_.erase(uni_char);  // No longer in use.
+  }
+}
+
 void URLIndexPrivateData::UpdateWordHistory(WordID word_id,
                                             HistoryID history_id) {
-  WordIDHistoryMap::iterator history_pos = word_id_history_map_.find(word_id);
-  DCHECK(history_pos != word_id_history_map_.end());
-  HistoryIDSet& history_id_set(history_pos->second);
-  history_id_set.insert(history_id);
+  if (use_compact_index_) {
+    DCHECK_LT(word_id, compact_word_id_history_map_.size());
+    InsertIntoSortedVector(&compact_word_id_history_map_[word_id], history_id);
+  } else {
+    WordIDHistoryMap::iterator history_pos =
+        word_id_history_map_.find(word_id);
+    DCHECK(history_pos != word_id_history_map_.end());
+    HistoryIDSet& history_id_set(history_pos->second);
+    history_id_set.insert(history_id);
+  }
   AddToHistoryIDWordMap(history_id, word_id);
+  AddWordHistoryToSearchTermCache(word_id, history_id);
 }
 
 void URLIndexPrivateData::AddToHistoryIDWordMap(HistoryID history_id,
@@ -853,27 +1296,38 @@ void URLIndexPrivateData::RemoveRowWordsFromIndex(const URLRow& row) {
   WordIDSet word_id_set = history_id_word_map_[history_id];
   history_id_word_map_.erase(history_id);
 
+  // The row no longer contains any word, so it no longer matches any of the
+  // cached search terms.
+  for (SearchTermCacheMap::iterator cache_iter = search_term_cache_.begin();
+       cache_iter != search_term_cache_.end(); ++cache_iter)
+    cache_iter->second.history_id_set_.erase(history_id);
+
   // Reconcile any changes to word usage.
   for (WordIDSet::iterator word_id_iter = word_id_set.begin();
        word_id_iter != word_id_set.end(); ++word_id_iter) {
     WordID word_id = *word_id_iter;
-    word_id_history_map_[word_id].erase(history_id);
-    if (!word_id_history_map_[word_id].empty())
-      continue;  // The word is still in use.
+    if (use_compact_index_) {
+      DCHECK_LT(word_id, compact_word_id_history_map_.size());
+      HistoryIDVector& history_ids(compact_word_id_history_map_[word_id]);
+      EraseFromSortedVector(&history_ids, history_id);
+      if (!history_ids.empty())
+        continue;  // The word is still in use.
+      HistoryIDVector().swap(history_ids);  // Release the storage.
+    } else {
+      word_id_history_map_[word_id].erase(history_id);
+      if (!word_id_history_map_[word_id].empty())
+        continue;  // The word is still in use.
+      word_id_history_map_.erase(word_id);
+    }
 
     // The word is no longer in use. Reconcile any changes to character usage.
     string16 word = word_list_[word_id];
-    Char16Set characters = Char16SetFromString16(word);
-    for (Char16Set::iterator uni_char_iter = characters.begin();
-         uni_char_iter != characters.end(); ++uni_char_iter) {
-      char16 uni_char = *uni_char_iter;
-      char_word_map_[uni_char].erase(word_id);
-      if (char_word_map_[uni_char].empty())
-        char_word_map_.erase(uni_char);  // No longer in use.
-    }
+    RemoveWordFromCharIndex(word, word_id);
+    for (SearchTermCacheMap::iterator cache_iter = search_term_cache_.begin();
+         cache_iter != search_term_cache_.end(); ++cache_iter)
+      cache_iter->second.word_id_set_.erase(word_id);
 
     // Complete the removal of references to the word.
-    word_id_history_map_.erase(word_id);
     word_map_.erase(word);
     word_list_[word_id] = string16();
     available_words_.insert(word_id);
@@ -886,14 +1340,33 @@ void URLIndexPrivateData::ResetSearchTermCache() {
     iter->second.used_ = false;
 }
 
+void URLIndexPrivateData::AddWordHistoryToSearchTermCache(
+    WordID word_id,
+    HistoryID history_id) {
+  // The cache only holds the terms of the most recent query, so checking
+  // each of them is cheap.
+  const string16& word(word_list_[word_id]);
+  for (SearchTermCacheMap::iterator cache_iter = search_term_cache_.begin();
+       cache_iter != search_term_cache_.end(); ++cache_iter) {
+    if (word.find(cache_iter->first) == string16::npos)
+      continue;
+    cache_iter->second.word_id_set_.insert(word_id);
+    cache_iter->second.history_id_set_.insert(history_id);
+  }
+}
+
 bool URLIndexPrivateData::SaveToFile(const base::FilePath& file_path) {
   base::TimeTicks beginning_time = base::TimeTicks::Now();
-  InMemoryURLIndexCacheItem index_cache;
-  SavePrivateData(&index_cache);
   std::string data;
-  if (!index_cache.SerializeToString(&data)) {
-    LOG(WARNING) << "Failed to serialize the InMemoryURLIndex cache.";
-    return false;
+  if (use_compact_index_) {
+    SaveToFlatData(&data);
+  } else {
+    InMemoryURLIndexCacheItem index_cache;
+    SavePrivateData(&index_cache);
+    if (!index_cache.SerializeToString(&data)) {
+      LOG(WARNING) << "Failed to serialize the InMemoryURLIndex cache.";
+      return false;
+    }
   }
 
   int size = data.size();
@@ -948,6 +1421,24 @@ void URLIndexPrivateData::SaveWordMap(InMemoryURLIndexCacheItem* cache) const {
 
 void URLIndexPrivateData::SaveCharWordMap(
     InMemoryURLIndexCacheItem* cache) const {
+  if (use_compact_index_) {
+    if (compact_char_word_map_.empty())
+      return;
+    CharWordMapItem* map_item = cache->mutable_char_word_map();
+    map_item->set_item_count(compact_char_word_map_.size());
+    for (CompactCharWordIDMap::const_iterator iter =
+         compact_char_word_map_.begin();
+         iter != compact_char_word_map_.end(); ++iter) {
+      CharWordMapEntry* map_entry = map_item->add_char_word_map_entry();
+      map_entry->set_char_16(iter->first);
+      const WordIDVector& word_ids(iter->second);
+      map_entry->set_item_count(word_ids.size());
+      for (WordIDVector::const_iterator id_iter = word_ids.begin();
+           id_iter != word_ids.end(); ++id_iter)
+        map_entry->add_word_id(*id_iter);
+    }
+    return;
+  }
   if (char_word_map_.empty())
     return;
   CharWordMapItem* map_item = cache->mutable_char_word_map();
@@ -966,6 +1457,33 @@ void URLIndexPrivateData::SaveCharWordMap(
 
 void URLIndexPrivateData::SaveWordIDHistoryMap(
     InMemoryURLIndexCacheItem* cache) const {
+  if (use_compact_index_) {
+    size_t item_count = 0;
+    for (CompactWordIDHistoryMap::const_iterator iter =
+         compact_word_id_history_map_.begin();
+         iter != compact_word_id_history_map_.end(); ++iter) {
+      if (!iter->empty())
+        ++item_count;
+    }
+    if (item_count == 0)
+      return;
+    WordIDHistoryMapItem* map_item = cache->mutable_word_id_history_map();
+    map_item->set_item_count(item_count);
+    for (size_t word_id = 0; word_id < compact_word_id_history_map_.size();
+         ++word_id) {
+      const HistoryIDVector& history_ids(compact_word_id_history_map_[word_id]);
+      if (history_ids.empty())
+        continue;
+      WordIDHistoryMapEntry* map_entry =
+          map_item->add_word_id_history_map_entry();
+      map_entry->set_word_id(word_id);
+      map_entry->set_item_count(history_ids.size());
+      for (HistoryIDVector::const_iterator id_iter = history_ids.begin();
+           id_iter != history_ids.end(); ++id_iter)
+        map_entry->add_history_id(*id_iter);
+    }
+    return;
+  }
   if (word_id_history_map_.empty())
     return;
   WordIDHistoryMapItem* map_item = cache->mutable_word_id_history_map();
@@ -1039,22 +1557,238 @@ void URLIndexPrivateData::SaveWordStartsMap(
   }
 }
 
+void URLIndexPrivateData::SaveToFlatData(std::string* data) const {
+  DCHECK(use_compact_index_);
+  data->clear();
+  FlatCacheHeader header;
+  header.magic = kFlatCacheMagic;
+  header.layout_version = kCurrentFlatCacheFileVersion;
+  header.cache_version = saved_cache_version_;
+  header.padding = 0;
+  header.last_rebuild_timestamp =
+      last_time_rebuilt_from_history_.ToInternalValue();
+  AppendPOD(data, header);
+
+  // The word list. Unused slots are stored as empty words.
+  AppendPOD(data, static_cast<uint32>(word_list_.size()));
+  for (String16Vector::const_iterator iter = word_list_.begin();
+       iter != word_list_.end(); ++iter)
+    AppendString16(data, *iter);
+
+  // The character index, in character order.
+  AppendPOD(data, static_cast<uint32>(compact_char_word_map_.size()));
+  for (CompactCharWordIDMap::const_iterator iter =
+       compact_char_word_map_.begin();
+       iter != compact_char_word_map_.end(); ++iter) {
+    AppendPOD(data, static_cast<uint32>(iter->first));
+    AppendArray<uint32>(data, iter->second);
+  }
+
+  // The word index, one posting list per word slot.
+  AppendPOD(data, static_cast<uint32>(compact_word_id_history_map_.size()));
+  for (CompactWordIDHistoryMap::const_iterator iter =
+       compact_word_id_history_map_.begin();
+       iter != compact_word_id_history_map_.end(); ++iter)
+    AppendArray<int64>(data, *iter);
+
+  // The words of each history item.
+  AppendPOD(data, static_cast<uint32>(history_id_word_map_.size()));
+  for (HistoryIDWordMap::const_iterator iter = history_id_word_map_.begin();
+       iter != history_id_word_map_.end(); ++iter) {
+    AppendPOD(data, static_cast<int64>(iter->first));
+    AppendArray<uint32>(data,
+                        WordIDVector(iter->second.begin(), iter->second.end()));
+  }
+
+  // The history items and their recent visits.
+  AppendPOD(data, static_cast<uint32>(history_info_map_.size()));
+  for (HistoryInfoMap::const_iterator iter = history_info_map_.begin();
+       iter != history_info_map_.end(); ++iter) {
+    const URLRow& url_row(iter->second.url_row);
+    AppendPOD(data, static_cast<int64>(iter->first));
+    AppendPOD(data, static_cast<int32>(url_row.visit_count()));
+    AppendPOD(data, static_cast<int32>(url_row.typed_count()));
+    AppendPOD(data, url_row.last_visit().ToInternalValue());
+    AppendString(data, url_row.url().spec());
+    AppendString16(data, url_row.title());
+    const VisitInfoVector& visits(iter->second.visits);
+    AppendPOD(data, static_cast<uint32>(visits.size()));
+    for (VisitInfoVector::const_iterator visit_iter = visits.begin();
+         visit_iter != visits.end(); ++visit_iter) {
+      AppendPOD(data, visit_iter->first.ToInternalValue());
+      AppendPOD(data, static_cast<int32>(visit_iter->second));
+    }
+  }
+
+  // The word starts of each history item.
+  AppendPOD(data, static_cast<uint32>(word_starts_map_.size()));
+  for (WordStartsMap::const_iterator iter = word_starts_map_.begin();
+       iter != word_starts_map_.end(); ++iter) {
+    AppendPOD(data, static_cast<int64>(iter->first));
+    AppendArray<uint32>(data, iter->second.url_word_starts_);
+    AppendArray<uint32>(data, iter->second.title_word_starts_);
+  }
+}
+
+bool URLIndexPrivateData::RestoreFromFlatData(const uint8* data,
+                                              size_t length) {
+  FlatCacheReader reader(data, length);
+  FlatCacheHeader header;
+  if (!reader.ReadPOD(&header) || header.magic != kFlatCacheMagic ||
+      header.layout_version != kCurrentFlatCacheFileVersion ||
+      header.cache_version < kCurrentCacheFileVersion)
+    return false;
+  last_time_rebuilt_from_history_ =
+      base::Time::FromInternalValue(header.last_rebuild_timestamp);
+  if (!RebuildTimeIsRecent())
+    return false;
+  restored_cache_version_ = header.cache_version;
+  use_compact_index_ = true;
+
+  // The word list, from which the word map and the free slots are derived.
+  uint32 word_count = 0;
+  if (!reader.ReadPOD(&word_count) || word_count == 0)
+    return false;
+  word_list_.resize(word_count);
+  for (WordID word_id = 0; word_id < word_count; ++word_id) {
+    string16& word(word_list_[word_id]);
+    if (!reader.ReadString16(&word))
+      return false;
+    if (word.empty())
+      available_words_.insert(available_words_.end(), word_id);
+    else
+      word_map_[word] = word_id;
+  }
+
+  // The character index.
+  uint32 char_count = 0;
+  if (!reader.ReadPOD(&char_count) || char_count == 0)
+    return false;
+  compact_char_word_map_.resize(char_count);
+  for (uint32 i = 0; i < char_count; ++i) {
+    uint32 uni_char = 0;
+    WordIDVector& word_ids(compact_char_word_map_[i].second);
+    if (!reader.ReadPOD(&uni_char) || !reader.ReadArray<uint32>(&word_ids) ||
+        word_ids.empty() || !IsStrictlyIncreasing(word_ids) ||
+        word_ids.back() >= word_count ||
+        (i > 0 && uni_char <= compact_char_word_map_[i - 1].first))
+      return false;
+    compact_char_word_map_[i].first = static_cast<char16>(uni_char);
+  }
+
+  // The word index.
+  uint32 posting_list_count = 0;
+  if (!reader.ReadPOD(&posting_list_count) ||
+      posting_list_count != word_count)
+    return false;
+  compact_word_id_history_map_.resize(posting_list_count);
+  for (uint32 i = 0; i < posting_list_count; ++i) {
+    HistoryIDVector& history_ids(compact_word_id_history_map_[i]);
+    if (!reader.ReadArray<int64>(&history_ids) ||
+        !IsStrictlyIncreasing(history_ids))
+      return false;
+  }
+
+  // The words of each history item. The entries were written in order so
+  // each insertion is at the end of the map.
+  uint32 history_count = 0;
+  if (!reader.ReadPOD(&history_count))
+    return false;
+  WordIDVector word_ids;
+  for (uint32 i = 0; i < history_count; ++i) {
+    int64 history_id = 0;
+    if (!reader.ReadPOD(&history_id) || !reader.ReadArray<uint32>(&word_ids) ||
+        word_ids.empty() || !IsStrictlyIncreasing(word_ids) ||
+        word_ids.back() >= word_count)
+      return false;
+    history_id_word_map_.insert(history_id_word_map_.end(), std::make_pair(
+        history_id, WordIDSet(word_ids.begin(), word_ids.end())));
+  }
+
+  // The history items.
+  uint32 info_count = 0;
+  if (!reader.ReadPOD(&info_count) || info_count == 0)
+    return false;
+  for (uint32 i = 0; i < info_count; ++i) {
+    int64 history_id = 0;
+    int32 visit_count = 0;
+    int32 typed_count = 0;
+    int64 last_visit = 0;
+    std::string url;
+    string16 title;
+    uint32 visits_count = 0;
+    if (!reader.ReadPOD(&history_id) || !reader.ReadPOD(&visit_count) ||
+        !reader.ReadPOD(&typed_count) || !reader.ReadPOD(&last_visit) ||
+        !reader.ReadString(&url) || !reader.ReadString16(&title) ||
+        !reader.ReadPOD(&visits_count))
+      return false;
+    HistoryInfoMapValue& value(history_info_map_.insert(
+        history_info_map_.end(),
+        std::make_pair(history_id, HistoryInfoMapValue()))->second);
+    value.url_row = URLRow(GURL(url), history_id);
+    value.url_row.set_visit_count(visit_count);
+    value.url_row.set_typed_count(typed_count);
+    value.url_row.set_last_visit(base::Time::FromInternalValue(last_visit));
+    value.url_row.set_title(title);
+    for (uint32 j = 0; j < visits_count; ++j) {
+      int64 visit_time = 0;
+      int32 transition = 0;
+      if (!reader.ReadPOD(&visit_time) || !reader.ReadPOD(&transition))
+        return false;
+      value.visits.push_back(std::make_pair(
+          base::Time::FromInternalValue(visit_time),
+          static_cast<content::PageTransition>(transition)));
+    }
+  }
+
+  // The word starts.
+  uint32 starts_count = 0;
+  if (!reader.ReadPOD(&starts_count))
+    return false;
+  for (uint32 i = 0; i < starts_count; ++i) {
+    int64 history_id = 0;
+    if (!reader.ReadPOD(&history_id))
+      return false;
+    RowWordStarts& word_starts(word_starts_map_.insert(
+        word_starts_map_.end(),
+        std::make_pair(history_id, RowWordStarts()))->second);
+    if (!reader.ReadArray<uint32>(&word_starts.url_word_starts_) ||
+        !reader.ReadArray<uint32>(&word_starts.title_word_starts_))
+      return false;
+  }
+
+  // Anything left over means the file does not match the layout we expect.
+  return reader.AtEnd();
+}
+
+// static
+bool URLIndexPrivateData::IsFlatCacheData(const uint8* data, size_t length) {
+  uint32 magic = 0;
+  if (length < sizeof(magic))
+    return false;
+  memcpy(&magic, data, sizeof(magic));
+  return magic == kFlatCacheMagic;
+}
+
+bool URLIndexPrivateData::RebuildTimeIsRecent() const {
+  const base::TimeDelta rebuilt_ago =
+      base::Time::Now() - last_time_rebuilt_from_history_;
+  // If the cache is more than a week old or, somehow, from some time in the
+  // future, it's probably a good time to rebuild the index from history to
+  // allow synced entries to now appear, expired entries to disappear, etc.
+  // Allow one day in the future to make the cache not rebuild on simple
+  // system clock changes such as time zone changes.
+  return (rebuilt_ago <= base::TimeDelta::FromDays(7)) &&
+      (rebuilt_ago >= base::TimeDelta::FromDays(-1));
+}
+
 bool URLIndexPrivateData::RestorePrivateData(
     const InMemoryURLIndexCacheItem& cache,
     const std::string& languages) {
   last_time_rebuilt_from_history_ =
       base::Time::FromInternalValue(cache.last_rebuild_timestamp());
-  const base::TimeDelta rebuilt_ago =
-      base::Time::Now() - last_time_rebuilt_from_history_;
-  if ((rebuilt_ago > base::TimeDelta::FromDays(7)) ||
-      (rebuilt_ago < base::TimeDelta::FromDays(-1))) {
-    // Cache is more than a week old or, somehow, from some time in the future.
-    // It's probably a good time to rebuild the index from history to
-    // allow synced entries to now appear, expired entries to disappear, etc.
-    // Allow one day in the future to make the cache not rebuild on simple
-    // system clock changes such as time zone changes.
+  if (!RebuildTimeIsRecent())
     return false;
-  }
   if (cache.has_version()) {
     if (cache.version() < kCurrentCacheFileVersion) {
       // Don't try to restore an old format cache file.  (This will cause
@@ -1305,6 +2039,160 @@ void URLIndexPrivateData::AddHistoryMatch::operator()(
 }
 
 
+// URLIndexPrivateData::ParallelScorer -----------------------------------------
+
+class URLIndexPrivateData::ParallelScorer
+    : public base::RefCountedThreadSafe<ParallelScorer> {
+ public:
+  // Scores |candidates| in |chunk_count| chunks. |private_data| must outlive
+  // the call to WaitForMatches(); nothing else needs to outlive the
+  // constructor.
+  ParallelScorer(const URLIndexPrivateData& private_data,
+                 const std::string& languages,
+                 BookmarkService* bookmark_service,
+                 const string16& lower_string,
+                 const String16Vector& lower_terms,
+                 const base::Time now,
+                 const HistoryIDVector& candidates,
+                 size_t chunk_count,
+                 ScoringCancellationFlag* cancel_flag);
+
+  // Claims and scores chunks until none are left. Run on each participating
+  // thread, including the one that created the scorer.
+  void ScoreChunks();
+
+  // Blocks until every claimed chunk has been scored, then returns the best
+  // matches of all chunks (in no particular order).
+  ScoredHistoryMatches WaitForMatches();
+
+ private:
+  friend class base::RefCountedThreadSafe<ParallelScorer>;
+
+  ~ParallelScorer();
+
+  // Scores the candidates of |chunk| and keeps its top kMaxMatches.
+  void ScoreChunk(size_t chunk);
+
+  bool IsCanceled() const {
+    return cancel_flag_.get() && cancel_flag_->data.IsSet();
+  }
+
+  const URLIndexPrivateData& private_data_;
+  const std::string languages_;
+  BookmarkService* bookmark_service_;
+  scoped_ptr<BookmarkedURLSnapshot> bookmarked_urls_;
+  const string16 lower_string_;
+  const String16Vector lower_terms_;
+  const base::Time now_;
+  const HistoryIDVector candidates_;
+  const size_t chunk_count_;
+  scoped_refptr<ScoringCancellationFlag> cancel_flag_;
+
+  // Guards |next_chunk_| and |chunks_done_|.
+  base::Lock lock_;
+  size_t next_chunk_;
+  size_t chunks_done_;
+  base::WaitableEvent all_chunks_done_;
+
+  // Each chunk's matches, written only by the thread that claimed it.
+  std::vector<ScoredHistoryMatches> chunk_matches_;
+
+  DISALLOW_COPY_AND_ASSIGN(ParallelScorer);
+};
+
+URLIndexPrivateData::ParallelScorer::ParallelScorer(
+    const URLIndexPrivateData& private_data,
+    const std::string& languages,
+    BookmarkService* bookmark_service,
+    const string16& lower_string,
+    const String16Vector& lower_terms,
+    const base::Time now,
+    const HistoryIDVector& candidates,
+    size_t chunk_count,
+    ScoringCancellationFlag* cancel_flag)
+    : private_data_(private_data),
+      languages_(languages),
+      bookmark_service_(NULL),
+      lower_string_(lower_string),
+      lower_terms_(lower_terms),
+      now_(now),
+      candidates_(candidates),
+      chunk_count_(std::max<size_t>(1, std::min(chunk_count,
+                                                candidates.size()))),
+      cancel_flag_(cancel_flag),
+      next_chunk_(0),
+      chunks_done_(0),
+      all_chunks_done_(false, false),
+      chunk_matches_(chunk_count_) {
+  // The real BookmarkService may only be queried off the main thread after
+  // blocking until it has loaded, so look up the candidates' bookmark state
+  // here instead.
+  if (bookmark_service) {
+    bookmarked_urls_.reset(new BookmarkedURLSnapshot);
+    for (HistoryIDVector::const_iterator iter = candidates_.begin();
+         iter != candidates_.end(); ++iter) {
+      HistoryInfoMap::const_iterator hist_pos =
+          private_data_.history_info_map_.find(*iter);
+      if (hist_pos != private_data_.history_info_map_.end() &&
+          bookmark_service->IsBookmarked(hist_pos->second.url_row.url()))
+        bookmarked_urls_->AddURL(hist_pos->second.url_row.url());
+    }
+    bookmark_service_ = bookmarked_urls_.get();
+  }
+}
+
+URLIndexPrivateData::ParallelScorer::~ParallelScorer() {}
+
+void URLIndexPrivateData::ParallelScorer::ScoreChunks() {
+  while (true) {
+    size_t chunk;
+    {
+      base::AutoLock lock(lock_);
+      if (next_chunk_ == chunk_count_)
+        return;
+      chunk = next_chunk_++;
+    }
+    ScoreChunk(chunk);
+    base::AutoLock lock(lock_);
+    if (++chunks_done_ == chunk_count_)
+      all_chunks_done_.Signal();
+  }
+}
+
+ScoredHistoryMatches URLIndexPrivateData::ParallelScorer::WaitForMatches() {
+  {
+    // Every chunk has been claimed by the time the creating thread gets here,
+    // so this only waits for chunks that are being scored right now.
+    base::ThreadRestrictions::ScopedAllowWait allow_wait;
+    all_chunks_done_.Wait();
+  }
+  ScoredHistoryMatches matches;
+  for (size_t i = 0; i < chunk_count_; ++i)
+    matches.insert(matches.end(), chunk_matches_[i].begin(),
+                   chunk_matches_[i].end());
+  return matches;
+}
+
+void URLIndexPrivateData::ParallelScorer::ScoreChunk(size_t chunk) {
+  const size_t begin = chunk * candidates_.size() / chunk_count_;
+  const size_t end = (chunk + 1) * candidates_.size() / chunk_count_;
+  AddHistoryMatch add_match(private_data_, languages_, bookmark_service_,
+                            lower_string_, lower_terms_, now_);
+  for (size_t i = begin; i < end && !IsCanceled(); ++i)
+    add_match(candidates_[i]);
+  ScoredHistoryMatches matches(add_match.ScoredMatches());
+  // Only a chunk's own top matches can make the overall top matches.
+  if (matches.size() > AutocompleteProvider::kMaxMatches) {
+    std::partial_sort(matches.begin(),
+                      matches.begin() + AutocompleteProvider::kMaxMatches,
+                      matches.end(),
+                      ScoredHistoryMatch::MatchScoreGreaterWithIDTieBreak);
+    matches.resize(AutocompleteProvider::kMaxMatches);
+  }
+  chunk_matches_[chunk].swap(matches);
+}
+
+
 // URLIndexPrivateData::HistoryItemFactorGreater -------------------------------
 
 URLIndexPrivateData::HistoryItemFactorGreater::HistoryItemFactorGreater(
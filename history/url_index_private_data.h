@@ -36,6 +36,11 @@ class RefCountedBool;
 // Current version of the cache file.
 static const int kCurrentCacheFileVersion = 3;
 
+// Current version of the flat (memory-mappable) cache file layout. This is
+// independent of kCurrentCacheFileVersion, which describes the content of the
+// index, and is bumped whenever the binary layout changes.
+static const int kCurrentFlatCacheFileVersion = 1;
+
 // A structure private to InMemoryURLIndex describing its internal data and
 // providing for restoring, rebuilding and updating that internal data. As
 // this class is for exclusive use by the InMemoryURLIndex class there should
@@ -67,10 +72,20 @@ class URLIndexPrivateData
   // to this function. |bookmark_service| is used to boost a result's score if
   // its URL is referenced by one or more of the user's bookmarks.  |languages|
   // is used to help parse/format the URLs in the history index.
-  ScoredHistoryMatches HistoryItemsForTerms(string16 term_string,
-                                            size_t cursor_position,
-                                            const std::string& languages,
-                                            BookmarkService* bookmark_service);
+  //
+  // If |scoring_thread_count| is greater than one and there are enough
+  // candidates, scoring is split across that many threads (this one
+  // included) from the worker pool and the partial results are merged; the
+  // results are the same as for single-threaded scoring.  If |cancel_flag| is
+  // non-NULL and becomes set, outstanding scoring is abandoned and no results
+  // are returned.
+  ScoredHistoryMatches HistoryItemsForTerms(
+      string16 term_string,
+      size_t cursor_position,
+      const std::string& languages,
+      BookmarkService* bookmark_service,
+      size_t scoring_thread_count,
+      ScoringCancellationFlag* cancel_flag);
 
   // Adds the history item in |row| to the index if it does not already already
   // exist and it meets the minimum 'quick' criteria. If the row already exists
@@ -108,8 +123,11 @@ class URLIndexPrivateData
   // Constructs a new object by restoring its contents from the cache file
   // at |path|. Returns the new URLIndexPrivateData which on success will
   // contain the restored data but upon failure will be empty.  |languages|
-  // is used to break URLs and page titles into words.  This function
-  // should be run on the the file thread.
+  // is used to break URLs and page titles into words.  The file is memory
+  // mapped; if it is in the flat format the index arrays are copied directly
+  // out of the mapping, otherwise it is parsed as a protobuf.  A private data
+  // restored from a flat file uses the compact index.  This function should
+  // be run on the the file thread.
   static scoped_refptr<URLIndexPrivateData> RestoreFromFile(
       const base::FilePath& path,
       const std::string& languages);
@@ -143,14 +161,36 @@ class URLIndexPrivateData
   // from the cache or a complete rebuild from the history database.
   void Clear();
 
+  // Switches the character and word indexes between the std::map/std::set
+  // representation used while building the index and the compact
+  // representation which keeps each set of IDs in a sorted vector. The two
+  // representations produce identical search results; the compact one uses
+  // considerably less memory on large profiles. Converting is linear in the
+  // size of the index.
+  void SetUseCompactIndex(bool use_compact_index);
+  bool use_compact_index() const { return use_compact_index_; }
+
+  // Returns an estimate of the number of bytes used by the character and word
+  // indexes in their current representation.
+  size_t EstimateIndexMemoryUsage() const;
+
+  // The number of multi-character search terms which were, and were not,
+  // answered starting from a cached term (the term itself or a prefix of it)
+  // since this instance was created.
+  size_t search_term_cache_hits() const { return search_term_cache_hits_; }
+  size_t search_term_cache_misses() const { return search_term_cache_misses_; }
+
  private:
   friend class base::RefCountedThreadSafe<URLIndexPrivateData>;
   ~URLIndexPrivateData();
 
   friend class AddHistoryMatch;
+  friend class ParallelScorer;
   friend class ::HistoryQuickProviderTest;
   friend class InMemoryURLIndexTest;
   FRIEND_TEST_ALL_PREFIXES(InMemoryURLIndexTest, CacheSaveRestore);
+  FRIEND_TEST_ALL_PREFIXES(InMemoryURLIndexTest, CompactIndex);
+  FRIEND_TEST_ALL_PREFIXES(InMemoryURLIndexTest, FlatCacheSaveRestore);
   FRIEND_TEST_ALL_PREFIXES(InMemoryURLIndexTest, HugeResultSet);
   FRIEND_TEST_ALL_PREFIXES(InMemoryURLIndexTest, ReadVisitsFromHistory);
   FRIEND_TEST_ALL_PREFIXES(InMemoryURLIndexTest, RebuildFromHistoryIfCacheOld);
@@ -217,6 +257,12 @@ class URLIndexPrivateData
     const base::Time now_;
   };
 
+  // Scores the candidates of a single query on several threads. The
+  // candidates are split into contiguous chunks which participating threads
+  // claim in order; each chunk keeps its own top matches, and the chunks are
+  // merged in order once they have all been scored.
+  class ParallelScorer;
+
   // A helper predicate class used to filter excess history items when the
   // candidate results set is too large.
   class HistoryItemFactorGreater
@@ -244,6 +290,27 @@ class URLIndexPrivateData
   // Given a set of Char16s, finds words containing those characters.
   WordIDSet WordIDSetForTermChars(const Char16Set& term_chars);
 
+  // The compact index counterpart of WordIDSetForTermChars. Intersects the
+  // word vectors of each character, smallest first.
+  WordIDSet CompactWordIDSetForTermChars(const Char16Set& term_chars);
+
+  // Adds to |history_id_set| the history IDs of all items containing any of
+  // the words in |word_id_set|.
+  void AddHistoryIDsForWords(const WordIDSet& word_id_set,
+                             HistoryIDSet* history_id_set) const;
+
+  // Adds |word_id| to the character index entry of each character in |word|.
+  void AddWordToCharIndex(const string16& word, WordID word_id);
+
+  // Removes |word_id| from the character index entry of each character in
+  // |word|, dropping entries which become empty.
+  void RemoveWordFromCharIndex(const string16& word, WordID word_id);
+
+  // Moves the contents of |char_word_map_| and |word_id_history_map_| into
+  // their compact counterparts, and back again.
+  void ConvertToCompactIndex();
+  void ConvertFromCompactIndex();
+
   // Indexes one URL history item as described by |row|. Returns true if the
   // row was actually indexed. |languages| gives a list of language encodings by
   // which the URLs and page titles are broken down into words and characters.
@@ -293,10 +360,32 @@ class URLIndexPrivateData
   // Clears |used_| for each item in the search term cache.
   void ResetSearchTermCache();
 
+  // Brings the search term cache up to date after |history_id| has been added
+  // to the rows containing the word |word_id|. Removals are patched in by
+  // RemoveRowWordsFromIndex().
+  void AddWordHistoryToSearchTermCache(WordID word_id, HistoryID history_id);
+
   // Caches the index private data and writes the cache file to the profile
-  // directory.  Called by WritePrivateDataToCacheFileTask.
+  // directory.  Called by WritePrivateDataToCacheFileTask.  When the compact
+  // index is in use the flat format is written, otherwise the protobuf one.
   bool SaveToFile(const base::FilePath& file_path);
 
+  // Serializes the private data into the flat cache format. Requires the
+  // compact index to be in use.
+  void SaveToFlatData(std::string* data) const;
+
+  // Restores the private data from the flat cache contents in |data|. Returns
+  // false if the data is malformed, stale or of an unknown layout version.
+  // On success the compact index is in use.
+  bool RestoreFromFlatData(const uint8* data, size_t length);
+
+  // Returns true if |data| starts with the flat cache file header.
+  static bool IsFlatCacheData(const uint8* data, size_t length);
+
+  // Returns false if |last_time_rebuilt_from_history_| is too long ago for the
+  // cached data to be trusted.
+  bool RebuildTimeIsRecent() const;
+
   // Encode a data structure into the protobuf |cache|.
   void SavePrivateData(imui::InMemoryURLIndexCacheItem* cache) const;
   void SaveWordList(imui::InMemoryURLIndexCacheItem* cache) const;
@@ -323,12 +412,20 @@ class URLIndexPrivateData
   static bool URLSchemeIsWhitelisted(const GURL& gurl,
                                      const std::set<std::string>& whitelist);
 
-  // Cache of search terms.
+  // Cache of search terms. Kept up to date as rows are added, updated and
+  // removed so that it survives history changes between keystrokes.
   SearchTermCacheMap search_term_cache_;
+  size_t search_term_cache_hits_;
+  size_t search_term_cache_misses_;
 
   // Allows canceling pending requests to update recent visits information.
   CancelableRequestConsumer recent_visits_consumer_;
 
+  // Whether the compact index representations are in use. Exactly one of
+  // |char_word_map_| and |compact_char_word_map_| (and likewise for the word
+  // to history maps) is populated at any time.
+  bool use_compact_index_;
+
   // Start of data members that are cached -------------------------------------
 
   // The version of the cache file most recently used to restore this instance
@@ -366,6 +463,13 @@ class URLIndexPrivateData
   // used in the history database) of history items in which the word occurs.
   WordIDHistoryMap word_id_history_map_;
 
+  // Compact counterparts of |char_word_map_| and |word_id_history_map_|, used
+  // in their place when |use_compact_index_| is set. These are serialized
+  // exactly as their std::map equivalents so the cache file format does not
+  // depend on the representation.
+  CompactCharWordIDMap compact_char_word_map_;
+  CompactWordIDHistoryMap compact_word_id_history_map_;
+
   // A one-to-many mapping from a HistoryID to all WordIDs of words that occur
   // in the URL and/or page title of the history item referenced by that
   // HistoryID.
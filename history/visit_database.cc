@@ -51,9 +51,10 @@ bool VisitDatabase::InitVisitTable() {
         return false;
   }
 
-  // Index over url so we can quickly find visits for a page.
-  if (!GetDB().Execute(
-          "CREATE INDEX IF NOT EXISTS visits_url_index ON visits (url)"))
+  // Index over url and time so we can quickly find visits for a page, and
+  // seek straight to the visits for a page in a given time range (text
+  // history queries look up the visits of each matching URL this way).
+  if (!CreateVisitsURLTimeIndex())
     return false;
 
   // Create an index over from visits so that we can efficiently find
@@ -73,6 +74,12 @@ bool VisitDatabase::InitVisitTable() {
   return true;
 }
 
+bool VisitDatabase::CreateVisitsURLTimeIndex() {
+  return GetDB().Execute(
+      "CREATE INDEX IF NOT EXISTS visits_url_time_index ON "
+      "visits (url, visit_time)");
+}
+
 bool VisitDatabase::DropVisitTable() {
   // This will also drop the indices over the table.
   return
@@ -600,6 +607,18 @@ bool VisitDatabase::MigrateVisitsWithoutDuration() {
   return true;
 }
 
+bool VisitDatabase::MigrateVisitsURLIndex() {
+  if (!GetDB().DoesTableExist("visits")) {
+    NOTREACHED() << " Visits table should exist before migration";
+    return false;
+  }
+
+  // The (url, visit_time) index serves every lookup the url-only index did,
+  // so the old one is only costing space and write time.
+  return CreateVisitsURLTimeIndex() &&
+      GetDB().Execute("DROP INDEX IF EXISTS visits_url_index");
+}
+
 void VisitDatabase::GetBriefVisitInfoOfMostRecentVisits(
     int max_visits,
     std::vector<BriefVisitInfo>* result_vector) {
@@ -218,7 +218,13 @@ class VisitDatabase {
   // don't have visit_duration column yet.
   bool MigrateVisitsWithoutDuration();
 
+  // Called by the derived classes to replace the index over visits.url with
+  // the index over (url, visit_time) used by databases created since.
+  bool MigrateVisitsURLIndex();
+
  private:
+  // Creates the index over (url, visit_time) if it does not exist yet.
+  bool CreateVisitsURLTimeIndex();
 
   DISALLOW_COPY_AND_ASSIGN(VisitDatabase);
 };
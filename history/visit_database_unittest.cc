@@ -3,6 +3,7 @@
 // found in the LICENSE file.
 
 #include <set>
+#include <string>
 #include <vector>
 
 #include "base/files/file_path.h"
@@ -13,6 +14,7 @@
 #include "chrome/browser/history/url_database.h"
 #include "chrome/browser/history/visit_database.h"
 #include "sql/connection.h"
+#include "sql/statement.h"
 #include "testing/gtest/include/gtest/gtest.h"
 #include "testing/platform_test.h"
 
@@ -60,11 +62,13 @@ class VisitDatabaseTest : public PlatformTest,
     PlatformTest::TearDown();
   }
 
+ protected:
   // Provided for URL/VisitDatabase.
   virtual sql::Connection& GetDB() OVERRIDE {
     return db_;
   }
 
+ private:
   base::ScopedTempDir temp_dir_;
   sql::Connection db_;
 };
@@ -385,4 +389,29 @@ TEST_F(VisitDatabaseTest, VisitSource) {
   EXPECT_EQ(SOURCE_EXTENSION, sources[matches[0].visit_id]);
 }
 
+TEST_F(VisitDatabaseTest, URLTimeIndex) {
+  // New databases only get the index over (url, visit_time).
+  EXPECT_TRUE(GetDB().DoesIndexExist("visits_url_time_index"));
+  EXPECT_FALSE(GetDB().DoesIndexExist("visits_url_index"));
+
+  // Per-URL time range queries should seek into that index rather than scan
+  // all the visits to the URL.
+  sql::Statement plan(GetDB().GetUniqueStatement(
+      "EXPLAIN QUERY PLAN SELECT id FROM visits "
+      "WHERE url=? AND visit_time >= ? AND visit_time < ? "
+      "ORDER BY visit_time DESC"));
+  std::string details;
+  while (plan.Step())
+    details += plan.ColumnString(plan.ColumnCount() - 1);
+  EXPECT_NE(std::string::npos, details.find("visits_url_time_index"))
+      << details;
+
+  // Migrating a database with the old url-only index replaces it.
+  ASSERT_TRUE(GetDB().Execute("DROP INDEX visits_url_time_index"));
+  ASSERT_TRUE(GetDB().Execute("CREATE INDEX visits_url_index ON visits (url)"));
+  ASSERT_TRUE(MigrateVisitsURLIndex());
+  EXPECT_TRUE(GetDB().DoesIndexExist("visits_url_time_index"));
+  EXPECT_FALSE(GetDB().DoesIndexExist("visits_url_index"));
+}
+
 }  // namespace history
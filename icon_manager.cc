@@ -30,6 +30,12 @@ struct IconManager::ClientRequest {
   IconLoader::IconSize size;
 };
 
+IconManager::PendingIcon::PendingIcon() : loader(NULL) {
+}
+
+IconManager::PendingIcon::~PendingIcon() {
+}
+
 IconManager::IconManager() {
 }
 
@@ -85,31 +91,38 @@ bool IconManager::OnGroupLoaded(IconLoader* loader,
   }
 
   gfx::Image* result = LookupIconFromGroup(group, rit->second.size);
-  if (!result) {
-    return false;
+  if (result)
+    return OnImageLoaded(loader, result, group);
+
+  // Wait for the icon if another loader is already extracting it; the request
+  // is completed in OnImageLoaded() for that loader.
+  CacheKey key(group, rit->second.size);
+  PendingIconMap::iterator pit = pending_icons_.find(key);
+  if (pit != pending_icons_.end()) {
+    pit->second.waiting_loaders.push_back(loader);
+    group_cache_[rit->second.file_path] = group;
+    return true;
   }
 
-  return OnImageLoaded(loader, result, group);
+  pending_icons_[key].loader = loader;
+  return false;
 }
 
 bool IconManager::OnImageLoaded(
     IconLoader* loader, gfx::Image* result, const IconGroupID& group) {
   ClientRequests::iterator rit = requests_.find(loader);
 
-  // Balances the AddRef() in LoadIcon().
-  loader->Release();
-
   // Look up our client state.
   if (rit == requests_.end()) {
     NOTREACHED();
+    // Balances the AddRef() in LoadIcon().
+    loader->Release();
     return false;  // Return false to indicate result should be deleted.
   }
 
-  const ClientRequest& client_request = rit->second;
-
   // Cache the bitmap. Watch out: |result| or the cached bitmap may be NULL to
   // indicate a current or past failure.
-  CacheKey key(group, client_request.size);
+  CacheKey key(group, rit->second.size);
   IconMap::iterator it = icon_cache_.find(key);
   if (it != icon_cache_.end() && result && it->second) {
     if (it->second != result) {
@@ -121,13 +134,32 @@ bool IconManager::OnImageLoaded(
     icon_cache_[key] = result;
   }
 
-  group_cache_[client_request.file_path] = group;
+  group_cache_[rit->second.file_path] = group;
+
+  // Complete the requests which waited for this icon, then this one.
+  std::vector<IconLoader*> waiting_loaders;
+  PendingIconMap::iterator pit = pending_icons_.find(key);
+  if (pit != pending_icons_.end() && pit->second.loader == loader) {
+    waiting_loaders.swap(pit->second.waiting_loaders);
+    pending_icons_.erase(pit);
+  }
+  for (size_t i = 0; i < waiting_loaders.size(); ++i)
+    CompleteRequest(waiting_loaders[i], result);
+  CompleteRequest(loader, result);
+
+  return true;  // Indicates we took ownership of result.
+}
+
+void IconManager::CompleteRequest(IconLoader* loader, gfx::Image* result) {
+  ClientRequests::iterator rit = requests_.find(loader);
+  DCHECK(rit != requests_.end());
 
   // Inform our client that the request has completed.
-  client_request.callback.Run(result);
+  rit->second.callback.Run(result);
   requests_.erase(rit);
 
-  return true;  // Indicates we took ownership of result.
+  // Balances the AddRef() in LoadIcon().
+  loader->Release();
 }
 
 IconManager::CacheKey::CacheKey(const IconGroupID& group,
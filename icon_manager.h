@@ -39,6 +39,9 @@
 // cache the results of the icon extraction so that subsequent lookups will be
 // fast.
 //
+// Concurrent loads of the same icon group and size, such as those for the
+// items of a long download list, share a single icon extraction.
+//
 // Icon bitmaps returned should be treated as const since they may be referenced
 // by other clients. Make a copy of the icon if you need to modify it.
 
@@ -46,6 +49,7 @@
 #define CHROME_BROWSER_ICON_MANAGER_H_
 
 #include <map>
+#include <vector>
 
 #include "base/files/file_path.h"
 #include "chrome/browser/icon_loader.h"
@@ -114,6 +118,23 @@ class IconManager : public IconLoader::Delegate {
   typedef std::map<IconLoader*, ClientRequest> ClientRequests;
   ClientRequests requests_;
 
+  // Runs the callback of the request of |loader| with |result| and forgets
+  // the request.
+  void CompleteRequest(IconLoader* loader, gfx::Image* result);
+
+  // The loaders that are extracting an icon, and the loaders of the other
+  // requests for the same icon which wait for it instead of extracting it
+  // again.
+  struct PendingIcon {
+    PendingIcon();
+    ~PendingIcon();
+
+    IconLoader* loader;
+    std::vector<IconLoader*> waiting_loaders;
+  };
+  typedef std::map<CacheKey, PendingIcon> PendingIconMap;
+  PendingIconMap pending_icons_;
+
   DISALLOW_COPY_AND_ASSIGN(IconManager);
 };
 
@@ -8,10 +8,9 @@
 #include "chrome/browser/browser_process.h"
 #include "chrome/common/chrome_utility_messages.h"
 #include "content/public/browser/browser_thread.h"
-#include "content/public/browser/utility_process_host.h"
+#include "third_party/skia/include/core/SkBitmap.h"
 
 using content::BrowserThread;
-using content::UtilityProcessHost;
 
 ImageDecoder::ImageDecoder(Delegate* delegate,
                            const std::string& image_data,
@@ -19,6 +18,7 @@ ImageDecoder::ImageDecoder(Delegate* delegate,
     : delegate_(delegate),
       image_data_(image_data.begin(), image_data.end()),
       image_codec_(image_codec),
+      process_mode_(BatchedUtilityProcessHost::DEDICATED_PROCESS),
       task_runner_(NULL) {
 }
 
@@ -28,19 +28,7 @@ void ImageDecoder::Start(scoped_refptr<base::SequencedTaskRunner> task_runner) {
   task_runner_ = task_runner;
   BrowserThread::PostTask(
      BrowserThread::IO, FROM_HERE,
-     base::Bind(&ImageDecoder::DecodeImageInSandbox, this, image_data_));
-}
-
-bool ImageDecoder::OnMessageReceived(const IPC::Message& message) {
-  bool handled = true;
-  IPC_BEGIN_MESSAGE_MAP(ImageDecoder, message)
-    IPC_MESSAGE_HANDLER(ChromeUtilityHostMsg_DecodeImage_Succeeded,
-                        OnDecodeImageSucceeded)
-    IPC_MESSAGE_HANDLER(ChromeUtilityHostMsg_DecodeImage_Failed,
-                        OnDecodeImageFailed)
-    IPC_MESSAGE_UNHANDLED(handled = false)
-  IPC_END_MESSAGE_MAP()
-  return handled;
+     base::Bind(&ImageDecoder::DecodeImageInSandbox, this));
 }
 
 void ImageDecoder::OnDecodeImageSucceeded(const SkBitmap& decoded_image) {
@@ -55,16 +43,43 @@ void ImageDecoder::OnDecodeImageFailed() {
     delegate_->OnDecodeImageFailed(this);
 }
 
-void ImageDecoder::DecodeImageInSandbox(
-    const std::vector<unsigned char>& image_data) {
+void ImageDecoder::DecodeImageInSandbox() {
   DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
-  UtilityProcessHost* utility_process_host;
-  utility_process_host = UtilityProcessHost::Create(this, task_runner_.get());
-  utility_process_host->EnableZygote();
-  if (image_codec_ == ROBUST_JPEG_CODEC) {
-    utility_process_host->Send(
-        new ChromeUtilityMsg_RobustJPEGDecodeImage(image_data));
-  } else {
-    utility_process_host->Send(new ChromeUtilityMsg_DecodeImage(image_data));
-  }
+  IPC::Message* message = NULL;
+  if (image_codec_ == ROBUST_JPEG_CODEC)
+    message = new ChromeUtilityMsg_RobustJPEGDecodeImage(image_data_);
+  else
+    message = new ChromeUtilityMsg_DecodeImage(image_data_);
+  BatchedUtilityProcessHost::Send(
+      process_mode_, message,
+      base::Bind(&ImageDecoder::OnUtilityProcessReply, this),
+      base::Bind(&ImageDecoder::OnUtilityProcessCrashed, this));
+}
+
+bool ImageDecoder::OnUtilityProcessReply(const IPC::Message& message) {
+  bool handled = true;
+  IPC_BEGIN_MESSAGE_MAP(ImageDecoder, message)
+    IPC_MESSAGE_HANDLER(ChromeUtilityHostMsg_DecodeImage_Succeeded,
+                        OnDecodeImageSucceededOnIOThread)
+    IPC_MESSAGE_HANDLER(ChromeUtilityHostMsg_DecodeImage_Failed,
+                        OnDecodeImageFailedOnIOThread)
+    IPC_MESSAGE_UNHANDLED(handled = false)
+  IPC_END_MESSAGE_MAP()
+  return handled;
+}
+
+void ImageDecoder::OnUtilityProcessCrashed() {
+  OnDecodeImageFailedOnIOThread();
+}
+
+void ImageDecoder::OnDecodeImageSucceededOnIOThread(
+    const SkBitmap& decoded_image) {
+  task_runner_->PostTask(
+      FROM_HERE,
+      base::Bind(&ImageDecoder::OnDecodeImageSucceeded, this, decoded_image));
+}
+
+void ImageDecoder::OnDecodeImageFailedOnIOThread() {
+  task_runner_->PostTask(
+      FROM_HERE, base::Bind(&ImageDecoder::OnDecodeImageFailed, this));
 }
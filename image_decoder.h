@@ -11,12 +11,18 @@
 #include "base/compiler_specific.h"
 #include "base/memory/ref_counted.h"
 #include "base/threading/sequenced_worker_pool.h"
-#include "content/public/browser/utility_process_host_client.h"
+#include "chrome/browser/batched_utility_process_host.h"
 
 class SkBitmap;
 
-// Decodes an image in a sandboxed process.
-class ImageDecoder : public content::UtilityProcessHostClient {
+namespace IPC {
+class Message;
+}
+
+// Decodes an image in a sandboxed process. By default each decoder gets a
+// utility process of its own. Callers that decode images from a trusted source
+// in bursts can share one with set_process_mode().
+class ImageDecoder : public base::RefCountedThreadSafe<ImageDecoder> {
  public:
   class Delegate {
    public:
@@ -53,23 +59,36 @@ class ImageDecoder : public content::UtilityProcessHostClient {
 
   void set_delegate(Delegate* delegate) { delegate_ = delegate; }
 
+  // Must be called before Start(). Defaults to DEDICATED_PROCESS.
+  void set_process_mode(BatchedUtilityProcessHost::ProcessMode process_mode) {
+    process_mode_ = process_mode;
+  }
+
  private:
-  // It's a reference counted object, so destructor is private.
-  virtual ~ImageDecoder();
+  friend class base::RefCountedThreadSafe<ImageDecoder>;
 
-  // Overidden from UtilityProcessHostClient:
-  virtual bool OnMessageReceived(const IPC::Message& message) OVERRIDE;
+  // It's a reference counted object, so destructor is private.
+  ~ImageDecoder();
 
-  // IPC message handlers.
+  // Called on |task_runner_| with the result of the decode.
   void OnDecodeImageSucceeded(const SkBitmap& decoded_image);
   void OnDecodeImageFailed();
 
-  // Launches sandboxed process that will decode the image.
-  void DecodeImageInSandbox(const std::vector<unsigned char>& image_data);
+  // Sends the image to the sandboxed process that decodes it.
+  void DecodeImageInSandbox();
+
+  // Handles the reply of the utility process, on the IO thread.
+  bool OnUtilityProcessReply(const IPC::Message& message);
+  void OnUtilityProcessCrashed();
+
+  // IPC message handlers.
+  void OnDecodeImageSucceededOnIOThread(const SkBitmap& decoded_image);
+  void OnDecodeImageFailedOnIOThread();
 
   Delegate* delegate_;
   std::vector<unsigned char> image_data_;
   const ImageCodec image_codec_;
+  BatchedUtilityProcessHost::ProcessMode process_mode_;
   scoped_refptr<base::SequencedTaskRunner> task_runner_;
 
   DISALLOW_COPY_AND_ASSIGN(ImageDecoder);
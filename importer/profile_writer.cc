@@ -62,6 +62,27 @@ string16 GenerateUniqueFolderName(BookmarkModel* model,
   return folder_name;
 }
 
+// The folder children of bookmark folders, by title. Only the first folder
+// with a given title is kept, as that's the one bookmarks are imported into.
+typedef std::map<string16, const BookmarkNode*> FolderMap;
+typedef std::map<const BookmarkNode*, FolderMap> ChildFolderMap;
+
+// Returns the folder children of |parent|, looking them up the first time.
+FolderMap* GetChildFolders(const BookmarkNode* parent,
+                           ChildFolderMap* child_folders) {
+  ChildFolderMap::iterator it = child_folders->find(parent);
+  if (it != child_folders->end())
+    return &it->second;
+
+  FolderMap* folders = &(*child_folders)[parent];
+  for (int index = 0; index < parent->child_count(); ++index) {
+    const BookmarkNode* node = parent->GetChild(index);
+    if (node->is_folder())
+      folders->insert(std::make_pair(node->GetTitle(), node));
+  }
+  return folders;
+}
+
 // Shows the bookmarks toolbar.
 void ShowBookmarkBar(Profile* profile) {
   profile->GetPrefs()->SetBoolean(prefs::kShowBookmarkBar, true);
@@ -145,6 +166,10 @@ void ProfileWriter::AddBookmarks(
   model->BeginExtensiveChanges();
 
   std::set<const BookmarkNode*> folders_added_to;
+  // Caches the folders under each parent, so that finding the enclosing
+  // folders of a bookmark doesn't scan the children of each folder on its
+  // path.
+  ChildFolderMap child_folders;
   const BookmarkNode* top_level_folder = NULL;
   for (std::vector<ImportedBookmarkEntry>::const_iterator bookmark =
            reordered_bookmarks.begin();
@@ -165,6 +190,8 @@ void ProfileWriter::AddBookmarks(
         top_level_folder = model->AddFolder(bookmark_bar,
                                             bookmark_bar->child_count(),
                                             name);
+        GetChildFolders(bookmark_bar, &child_folders)->insert(
+            std::make_pair(name, top_level_folder));
       }
       parent = top_level_folder;
     }
@@ -182,22 +209,21 @@ void ProfileWriter::AddBookmarks(
         continue;
       }
 
-      const BookmarkNode* child = NULL;
-      for (int index = 0; index < parent->child_count(); ++index) {
-        const BookmarkNode* node = parent->GetChild(index);
-        if (node->is_folder() && node->GetTitle() == *folder_name) {
-          child = node;
-          break;
-        }
+      FolderMap* folders = GetChildFolders(parent, &child_folders);
+      FolderMap::const_iterator child = folders->find(*folder_name);
+      if (child == folders->end()) {
+        child = folders->insert(std::make_pair(*folder_name, model->AddFolder(
+            parent, parent->child_count(), *folder_name))).first;
       }
-      if (!child)
-        child = model->AddFolder(parent, parent->child_count(), *folder_name);
-      parent = child;
+      parent = child->second;
     }
 
     folders_added_to.insert(parent);
     if (bookmark->is_folder) {
-      model->AddFolder(parent, parent->child_count(), bookmark->title);
+      const BookmarkNode* folder =
+          model->AddFolder(parent, parent->child_count(), bookmark->title);
+      GetChildFolders(parent, &child_folders)->insert(
+          std::make_pair(bookmark->title, folder));
     } else {
       model->AddURLWithCreationTime(parent, parent->child_count(),
                                     bookmark->title, bookmark->url,
@@ -9,6 +9,7 @@
 #include "base/callback.h"
 #include "base/location.h"
 #include "base/logging.h"
+#include "base/message_loop/message_loop.h"
 #include "base/metrics/histogram.h"
 #include "base/prefs/pref_service.h"
 #include "base/strings/string_number_conversions.h"
@@ -113,28 +114,28 @@ void InvalidatorStorage::RegisterProfilePrefs(
 }
 
 InvalidatorStorage::InvalidatorStorage(PrefService* pref_service)
-    : pref_service_(pref_service) {
+    : pref_service_(pref_service),
+      state_map_write_pending_(false) {
   // TODO(tim): Create a Mock instead of maintaining the if(!pref_service_) case
   // throughout this file.  This is a problem now due to lack of injection at
   // ProfileSyncService. Bug 130176.
-  if (pref_service_)
+  if (pref_service_) {
     MigrateMaxInvalidationVersionsPref();
+    const base::ListValue* state_map_list =
+        pref_service_->GetList(prefs::kInvalidatorMaxInvalidationVersions);
+    CHECK(state_map_list);
+    DeserializeFromList(*state_map_list, &state_map_);
+  }
 }
 
 InvalidatorStorage::~InvalidatorStorage() {
+  if (state_map_write_pending_)
+    WriteStateMap();
 }
 
 InvalidationStateMap InvalidatorStorage::GetAllInvalidationStates() const {
   DCHECK(thread_checker_.CalledOnValidThread());
-  InvalidationStateMap state_map;
-  if (!pref_service_) {
-    return state_map;
-  }
-  const base::ListValue* state_map_list =
-      pref_service_->GetList(prefs::kInvalidatorMaxInvalidationVersions);
-  CHECK(state_map_list);
-  DeserializeFromList(*state_map_list, &state_map);
-  return state_map;
+  return state_map_;
 }
 
 void InvalidatorStorage::SetMaxVersionAndPayload(
@@ -143,34 +144,24 @@ void InvalidatorStorage::SetMaxVersionAndPayload(
     const std::string& payload) {
   DCHECK(thread_checker_.CalledOnValidThread());
   CHECK(pref_service_);
-  InvalidationStateMap state_map = GetAllInvalidationStates();
-  InvalidationStateMap::iterator it = state_map.find(id);
-  if ((it != state_map.end()) && (max_version <= it->second.version)) {
+  InvalidationStateMap::iterator it = state_map_.find(id);
+  if ((it != state_map_.end()) && (max_version <= it->second.version)) {
     NOTREACHED();
     return;
   }
-  state_map[id].version = max_version;
-  state_map[id].payload = payload;
-
-  base::ListValue state_map_list;
-  SerializeToList(state_map, &state_map_list);
-  pref_service_->Set(prefs::kInvalidatorMaxInvalidationVersions,
-                     state_map_list);
+  state_map_[id].version = max_version;
+  state_map_[id].payload = payload;
+  ScheduleStateMapWrite();
 }
 
 void InvalidatorStorage::Forget(const syncer::ObjectIdSet& ids) {
   DCHECK(thread_checker_.CalledOnValidThread());
   CHECK(pref_service_);
-  InvalidationStateMap state_map = GetAllInvalidationStates();
   for (syncer::ObjectIdSet::const_iterator it = ids.begin(); it != ids.end();
        ++it) {
-    state_map.erase(*it);
+    state_map_.erase(*it);
   }
-
-  base::ListValue state_map_list;
-  SerializeToList(state_map, &state_map_list);
-  pref_service_->Set(prefs::kInvalidatorMaxInvalidationVersions,
-                     state_map_list);
+  ScheduleStateMapWrite();
 }
 
 // static
@@ -297,6 +288,8 @@ std::string InvalidatorStorage::GetBootstrapData() const {
 
 void InvalidatorStorage::Clear() {
   DCHECK(thread_checker_.CalledOnValidThread());
+  state_map_.clear();
+  state_map_write_pending_ = false;
   pref_service_->ClearPref(prefs::kInvalidatorMaxInvalidationVersions);
   pref_service_->ClearPref(prefs::kInvalidatorClientId);
   pref_service_->ClearPref(prefs::kInvalidatorInvalidationState);
@@ -308,19 +301,14 @@ void InvalidatorStorage::GenerateAckHandles(
     const base::Callback<void(const syncer::AckHandleMap&)> callback) {
   DCHECK(thread_checker_.CalledOnValidThread());
   CHECK(pref_service_);
-  InvalidationStateMap state_map = GetAllInvalidationStates();
 
   syncer::AckHandleMap ack_handles;
   for (syncer::ObjectIdSet::const_iterator it = ids.begin(); it != ids.end();
        ++it) {
-    state_map[*it].expected = syncer::AckHandle::CreateUnique();
-    ack_handles.insert(std::make_pair(*it, state_map[*it].expected));
+    state_map_[*it].expected = syncer::AckHandle::CreateUnique();
+    ack_handles.insert(std::make_pair(*it, state_map_[*it].expected));
   }
-
-  base::ListValue state_map_list;
-  SerializeToList(state_map, &state_map_list);
-  pref_service_->Set(prefs::kInvalidatorMaxInvalidationVersions,
-                     state_map_list);
+  ScheduleStateMapWrite();
 
   ignore_result(task_runner->PostTask(FROM_HERE,
                                       base::Bind(callback, ack_handles)));
@@ -330,17 +318,36 @@ void InvalidatorStorage::Acknowledge(const invalidation::ObjectId& id,
                                      const syncer::AckHandle& ack_handle) {
   DCHECK(thread_checker_.CalledOnValidThread());
   CHECK(pref_service_);
-  InvalidationStateMap state_map = GetAllInvalidationStates();
 
-  InvalidationStateMap::iterator it = state_map.find(id);
+  InvalidationStateMap::iterator it = state_map_.find(id);
   // This could happen if the acknowledgement is delayed and Forget() has
   // already been called.
-  if (it == state_map.end())
+  if (it == state_map_.end())
     return;
   it->second.current = ack_handle;
+  ScheduleStateMapWrite();
+}
+
+void InvalidatorStorage::ScheduleStateMapWrite() {
+  if (state_map_write_pending_)
+    return;
+  state_map_write_pending_ = true;
+  base::MessageLoop::current()->PostTask(
+      FROM_HERE, base::Bind(&InvalidatorStorage::WriteStateMapIfPending,
+                            AsWeakPtr()));
+}
+
+void InvalidatorStorage::WriteStateMapIfPending() {
+  DCHECK(thread_checker_.CalledOnValidThread());
+  // Clear() may have dropped the pending write.
+  if (state_map_write_pending_)
+    WriteStateMap();
+}
 
+void InvalidatorStorage::WriteStateMap() {
+  state_map_write_pending_ = false;
   base::ListValue state_map_list;
-  SerializeToList(state_map, &state_map_list);
+  SerializeToList(state_map_, &state_map_list);
   pref_service_->Set(prefs::kInvalidatorMaxInvalidationVersions,
                      state_map_list);
 }
@@ -93,9 +93,21 @@ class InvalidatorStorage : public base::SupportsWeakPtr<InvalidatorStorage>,
   static void DeserializeMap(const base::DictionaryValue* max_versions_dict,
                              syncer::InvalidationStateMap* map);
 
+  // The state map is written to prefs from a posted task, so that a burst of
+  // updates results in a single write.
+  void ScheduleStateMapWrite();
+  void WriteStateMapIfPending();
+  void WriteStateMap();
+
   // May be NULL.
   PrefService* const pref_service_;
 
+  // The invalidation states. Prefs are updated from it.
+  syncer::InvalidationStateMap state_map_;
+
+  // Whether |state_map_| has changes that are not written to prefs yet.
+  bool state_map_write_pending_;
+
   DISALLOW_COPY_AND_ASSIGN(InvalidatorStorage);
 };
 
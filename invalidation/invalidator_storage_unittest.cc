@@ -110,6 +110,32 @@ TEST_F(InvalidatorStorageTest, Forget) {
   EXPECT_EQ(expected_states, storage.GetAllInvalidationStates());
 }
 
+// Updates made in a row should be written to prefs together, and pending
+// updates should be written when the storage goes away.
+TEST_F(InvalidatorStorageTest, BatchesStateWrites) {
+  InvalidationStateMap expected_states;
+  expected_states[kBookmarksId_].version = 2;
+  expected_states[kPreferencesId_].version = 5;
+  {
+    InvalidatorStorage storage(&pref_service_);
+    storage.SetMaxVersionAndPayload(kBookmarksId_, 2, std::string());
+    storage.SetMaxVersionAndPayload(kPreferencesId_, 5, std::string());
+    EXPECT_EQ(expected_states, storage.GetAllInvalidationStates());
+    EXPECT_TRUE(pref_service_.GetList(
+        prefs::kInvalidatorMaxInvalidationVersions)->empty());
+
+    loop_.RunUntilIdle();
+    EXPECT_EQ(2U, pref_service_.GetList(
+        prefs::kInvalidatorMaxInvalidationVersions)->GetSize());
+
+    expected_states[kBookmarksId_].version = 3;
+    storage.SetMaxVersionAndPayload(kBookmarksId_, 3, std::string());
+  }
+
+  InvalidatorStorage storage(&pref_service_);
+  EXPECT_EQ(expected_states, storage.GetAllInvalidationStates());
+}
+
 // Clearing the storage should erase all version map entries, bootstrap data,
 // and the client ID.
 TEST_F(InvalidatorStorageTest, Clear) {
@@ -15,9 +15,11 @@
 #include "base/metrics/stats_counters.h"
 #include "base/pending_task.h"
 #include "base/strings/string_util.h"
+#include "base/synchronization/lock.h"
 #include "base/threading/thread.h"
 #include "base/threading/watchdog.h"
 #include "base/time/time.h"
+#include "base/tracked_objects.h"
 #include "build/build_config.h"
 #include "chrome/browser/browser_process.h"
 #include "chrome/common/chrome_switches.h"
@@ -63,15 +65,36 @@ class JankWatchdog : public base::Watchdog {
                bool enabled)
       : Watchdog(duration, thread_watched_name, enabled),
         thread_name_watched_(thread_watched_name),
-        alarm_count_(0) {
+        alarm_count_(0),
+        has_current_task_(false) {
   }
 
   virtual ~JankWatchdog() {}
 
+  // Records the task the watched thread is running, so that an alarm can tell
+  // which task is slow. Called on the watched thread.
+  void SetCurrentTask(const tracked_objects::Location& posted_from) {
+    base::AutoLock lock(current_task_lock_);
+    current_task_ = posted_from;
+    has_current_task_ = true;
+  }
+
+  void ClearCurrentTask() {
+    base::AutoLock lock(current_task_lock_);
+    has_current_task_ = false;
+  }
+
   virtual void Alarm() OVERRIDE {
     // Put break point here if you want to stop threads and look at what caused
     // the jankiness.
     alarm_count_++;
+    {
+      base::AutoLock lock(current_task_lock_);
+      if (has_current_task_) {
+        LOG(WARNING) << thread_name_watched_ << " thread is running the task "
+                     << "posted from " << current_task_.ToString();
+      }
+    }
     Watchdog::Alarm();
   }
 
@@ -79,6 +102,12 @@ class JankWatchdog : public base::Watchdog {
   std::string thread_name_watched_;
   int alarm_count_;
 
+  // The task that the watched thread is running, if any. Set on the watched
+  // thread and read on the watchdog thread.
+  base::Lock current_task_lock_;
+  tracked_objects::Location current_task_;
+  bool has_current_task_;
+
   DISALLOW_COPY_AND_ASSIGN(JankWatchdog);
 };
 
@@ -92,6 +121,10 @@ class JankObserverHelper {
   void StartProcessingTimers(const TimeDelta& queueing_time);
   void EndProcessingTimers();
 
+  // Called after StartProcessingTimers() when the message is a task. When the
+  // watchdog is enabled, the task is reported if it turns out to be slow.
+  void SetCurrentTask(const tracked_objects::Location& posted_from);
+
   // Indicate if we will bother to measuer this message.
   bool MessageWillBeMeasured();
 
@@ -124,6 +157,10 @@ class JankObserverHelper {
   base::HistogramBase* const total_times_;  // Total queueing plus proc.
   JankWatchdog total_time_watchdog_;  // Watching for excessive total_time.
 
+  // Whether slow tasks are reported, and where the current one was posted.
+  const bool watchdog_enabled_;
+  const tracked_objects::Location* current_task_;
+
   DISALLOW_COPY_AND_ASSIGN(JankObserverHelper);
 };
 
@@ -142,7 +179,9 @@ JankObserverHelper::JankObserverHelper(
       total_times_(base::Histogram::FactoryGet(
           std::string("Chrome.TotalMsgL ") + thread_name,
           1, 3600000, 50, base::Histogram::kUmaTargetedHistogramFlag)),
-      total_time_watchdog_(excessive_duration, thread_name, watchdog_enable) {
+      total_time_watchdog_(excessive_duration, thread_name, watchdog_enable),
+      watchdog_enabled_(watchdog_enable),
+      current_task_(NULL) {
   if (discard_count_ > 0) {
     // Select a vaguely random sample-start-point.
     events_till_measurement_ = static_cast<int>(
@@ -187,6 +226,13 @@ void JankObserverHelper::EndProcessingTimers() {
       TimeDelta::FromMilliseconds(kMaxMessageProcessingMs)) {
     // Message took too long to process.
     slow_processing_counter_.Increment();
+    if (current_task_) {
+      LOG(WARNING) << "Task posted from " << current_task_->ToString()
+                   << " took "
+                   << (now - begin_process_message_).InMilliseconds()
+                   << " ms, after waiting " << queueing_time_.InMilliseconds()
+                   << " ms in the queue";
+    }
 #if defined(OS_WIN)
     if (kPlaySounds)
       MessageBeep(MB_ICONHAND);
@@ -196,6 +242,20 @@ void JankObserverHelper::EndProcessingTimers() {
   // Reset message specific times.
   begin_process_message_ = base::TimeTicks();
   queueing_time_ = base::TimeDelta();
+  if (current_task_) {
+    current_task_ = NULL;
+    total_time_watchdog_.ClearCurrentTask();
+  }
+}
+
+void JankObserverHelper::SetCurrentTask(
+    const tracked_objects::Location& posted_from) {
+  if (!watchdog_enabled_)
+    return;
+  // |posted_from| belongs to the task, which is alive until
+  // EndProcessingTimers() is called for it.
+  current_task_ = &posted_from;
+  total_time_watchdog_.SetCurrentTask(posted_from);
 }
 
 bool JankObserverHelper::MessageWillBeMeasured() {
@@ -250,6 +310,7 @@ class IOJankObserver : public base::RefCountedThreadSafe<IOJankObserver>,
     base::TimeTicks now = base::TimeTicks::Now();
     const base::TimeDelta queueing_time = now - pending_task.time_posted;
     helper_.StartProcessingTimers(queueing_time);
+    helper_.SetCurrentTask(pending_task.posted_from);
   }
 
   virtual void DidProcessTask(const base::PendingTask& pending_task) OVERRIDE {
@@ -298,6 +359,7 @@ class UIJankObserver : public base::RefCountedThreadSafe<UIJankObserver>,
     base::TimeTicks now = base::TimeTicks::Now();
     const base::TimeDelta queueing_time = now - pending_task.time_posted;
     helper_.StartProcessingTimers(queueing_time);
+    helper_.SetCurrentTask(pending_task.posted_from);
   }
 
   virtual void DidProcessTask(const base::PendingTask& pending_task) OVERRIDE {
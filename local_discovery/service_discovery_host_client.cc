@@ -4,6 +4,7 @@
 
 #include "chrome/browser/local_discovery/service_discovery_host_client.h"
 
+#include "base/metrics/histogram.h"
 #include "chrome/common/local_discovery/local_discovery_messages.h"
 #include "content/public/browser/browser_thread.h"
 #include "content/public/browser/utility_process_host.h"
@@ -18,6 +19,14 @@ namespace local_discovery {
 using content::BrowserThread;
 using content::UtilityProcessHost;
 
+namespace {
+
+// Queries of a watcher sent less than this long after its last one are
+// dropped, since the replies to the last one are still coming in.
+const int kMinQueryIntervalMs = 1000;
+
+}  // namespace
+
 class ServiceDiscoveryHostClient::ServiceWatcherProxy : public ServiceWatcher {
  public:
   ServiceWatcherProxy(ServiceDiscoveryHostClient* host,
@@ -46,7 +55,8 @@ class ServiceDiscoveryHostClient::ServiceWatcherProxy : public ServiceWatcher {
   virtual void DiscoverNewServices(bool force_update) OVERRIDE {
     DVLOG(1) << "ServiceWatcher::DiscoverNewServices with id " << id_;
     DCHECK(started_);
-    host_->Send(new LocalDiscoveryMsg_DiscoverServices(id_, force_update));
+    if (host_->ShouldSendQuery(id_, force_update))
+      host_->Send(new LocalDiscoveryMsg_DiscoverServices(id_, force_update));
   }
 
   virtual std::string GetServiceType() const OVERRIDE {
@@ -195,9 +205,24 @@ uint64 ServiceDiscoveryHostClient::RegisterLocalDomainResolverCallback(
   return current_id_;
 }
 
+bool ServiceDiscoveryHostClient::ShouldSendQuery(uint64 id,
+                                                 bool force_update) {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
+  base::TimeTicks now = base::TimeTicks::Now();
+  base::TimeTicks& last_query_time = last_query_times_[id];
+  bool send = force_update || last_query_time.is_null() ||
+      now - last_query_time >=
+          base::TimeDelta::FromMilliseconds(kMinQueryIntervalMs);
+  UMA_HISTOGRAM_BOOLEAN("LocalDiscovery.QueryCoalesced", !send);
+  if (send)
+    last_query_time = now;
+  return send;
+}
+
 void ServiceDiscoveryHostClient::UnregisterWatcherCallback(uint64 id) {
   DCHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
   service_watcher_callbacks_.erase(id);
+  last_query_times_.erase(id);
 }
 
 void ServiceDiscoveryHostClient::UnregisterResolverCallback(uint64 id) {
@@ -309,6 +334,7 @@ void ServiceDiscoveryHostClient::InvalidateWatchers() {
   service_watcher_callbacks_.swap(service_watcher_callbacks);
   service_resolver_callbacks_.clear();
   domain_resolver_callbacks_.clear();
+  last_query_times_.clear();
 
   for (WatcherCallbacks::iterator i = service_watcher_callbacks.begin();
        i != service_watcher_callbacks.end(); i++) {
@@ -8,6 +8,7 @@
 #include <map>
 #include <string>
 
+#include "base/time/time.h"
 #include "chrome/common/local_discovery/service_discovery_client.h"
 #include "content/public/browser/utility_process_host_client.h"
 
@@ -59,6 +60,7 @@ class ServiceDiscoveryHostClient
   class ServiceResolverProxy;
   class LocalDomainResolverProxy;
   friend class ServiceDiscoveryClientMdns;
+  friend class ServiceDiscoveryHostClientTest;
 
   typedef std::map<uint64, ServiceWatcher::UpdatedCallback> WatcherCallbacks;
   typedef std::map<uint64, ServiceResolver::ResolveCompleteCallback>
@@ -81,6 +83,12 @@ class ServiceDiscoveryHostClient
   uint64 RegisterLocalDomainResolverCallback(
       const LocalDomainResolver::IPAddressCallback& callback);
 
+  // Returns whether a query of the watcher |id| should be sent, or dropped
+  // because the replies to its own recent query will do. The queries of
+  // different watchers are always sent, since each watcher only gets the
+  // results of its own queries from the utility process.
+  bool ShouldSendQuery(uint64 id, bool force_update);
+
   void UnregisterWatcherCallback(uint64 id);
   void UnregisterResolverCallback(uint64 id);
   void UnregisterLocalDomainResolverCallback(uint64 id);
@@ -122,6 +130,8 @@ class ServiceDiscoveryHostClient
   WatcherCallbacks service_watcher_callbacks_;
   ResolverCallbacks service_resolver_callbacks_;
   DomainResolverCallbacks domain_resolver_callbacks_;
+  // When the last query of each watcher was sent.
+  std::map<uint64, base::TimeTicks> last_query_times_;
   scoped_refptr<base::TaskRunner> callback_runner_;
   scoped_refptr<base::TaskRunner> io_runner_;
 
@@ -0,0 +1,51 @@
+// Copyright 2013 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "chrome/browser/local_discovery/service_discovery_host_client.h"
+
+#include "base/memory/ref_counted.h"
+#include "content/public/test/test_browser_thread_bundle.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace local_discovery {
+
+class ServiceDiscoveryHostClientTest : public testing::Test {
+ protected:
+  ServiceDiscoveryHostClientTest() : client_(new ServiceDiscoveryHostClient) {}
+
+  bool ShouldSendQuery(uint64 id, bool force_update) {
+    return client_->ShouldSendQuery(id, force_update);
+  }
+
+  void UnregisterWatcherCallback(uint64 id) {
+    client_->UnregisterWatcherCallback(id);
+  }
+
+  content::TestBrowserThreadBundle thread_bundle_;
+  scoped_refptr<ServiceDiscoveryHostClient> client_;
+};
+
+TEST_F(ServiceDiscoveryHostClientTest, DropsRepeatQueriesOfSameWatcher) {
+  EXPECT_TRUE(ShouldSendQuery(1, false));
+  EXPECT_FALSE(ShouldSendQuery(1, false));
+  // Forced queries are always sent.
+  EXPECT_TRUE(ShouldSendQuery(1, true));
+}
+
+TEST_F(ServiceDiscoveryHostClientTest, SendsQueriesOfEachWatcher) {
+  // Each watcher only gets the results of its own queries, so a query of
+  // another watcher doesn't stand in for it.
+  EXPECT_TRUE(ShouldSendQuery(1, false));
+  EXPECT_TRUE(ShouldSendQuery(2, false));
+  EXPECT_FALSE(ShouldSendQuery(2, false));
+}
+
+TEST_F(ServiceDiscoveryHostClientTest, ForgetsUnregisteredWatchers) {
+  EXPECT_TRUE(ShouldSendQuery(1, false));
+  UnregisterWatcherCallback(1);
+  EXPECT_TRUE(ShouldSendQuery(1, false));
+  UnregisterWatcherCallback(1);
+}
+
+}  // namespace local_discovery
@@ -33,6 +33,25 @@ struct ManagedModeURLFilter::Contents {
   std::vector<ManagedModeSiteList::Site> sites;
 };
 
+struct ManagedModeURLFilter::HostPatterns {
+  // Adds |pattern|, as described for HostMatchesPattern(). Patterns without
+  // a wildcard are ignored, as they are looked up in the host map directly.
+  void AddPattern(const std::string& pattern);
+
+  // Returns true if |host| matches any of the patterns. This is the same as
+  // calling HostMatchesPattern() for each of them, but only takes a lookup
+  // per label of |host|.
+  bool Matches(const std::string& host) const;
+
+  // Patterns of the form "*.<suffix>", keyed by their suffix.
+  base::hash_set<std::string> subdomain_patterns;
+
+  // Patterns of the form "<host>.*" and "*.<suffix>.*", keyed by <host> and
+  // <suffix> respectively.
+  base::hash_set<std::string> registry_patterns;
+  base::hash_set<std::string> registry_subdomain_patterns;
+};
+
 namespace {
 
 const char* kStandardSchemes[] = {
@@ -165,11 +184,71 @@ scoped_ptr<ManagedModeURLFilter::Contents> LoadWhitelistsOnBlockingPoolThread(
   return builder.Build();
 }
 
+// Returns true if |host| or one of its parent domains is in |suffixes|.
+bool HostOrParentDomainIsIn(const base::hash_set<std::string>& suffixes,
+                            const std::string& host) {
+  if (suffixes.empty())
+    return false;
+  for (size_t pos = 0; pos != std::string::npos; ) {
+    if (suffixes.count(host.substr(pos)))
+      return true;
+    pos = host.find('.', pos);
+    if (pos != std::string::npos)
+      ++pos;
+  }
+  return false;
+}
+
 }  // namespace
 
+void ManagedModeURLFilter::HostPatterns::AddPattern(
+    const std::string& pattern) {
+  std::string trimmed_pattern = pattern;
+  bool any_registry = EndsWith(trimmed_pattern, ".*", true);
+  if (any_registry)
+    trimmed_pattern.erase(trimmed_pattern.length() - 2);
+
+  if (StartsWithASCII(trimmed_pattern, "*.", true)) {
+    trimmed_pattern.erase(0, 2);
+    // See HostMatchesPattern() for the patterns which never match.
+    if (trimmed_pattern.empty() ||
+        trimmed_pattern.find('*') != std::string::npos) {
+      return;
+    }
+    if (any_registry)
+      registry_subdomain_patterns.insert(trimmed_pattern);
+    else
+      subdomain_patterns.insert(trimmed_pattern);
+  } else if (any_registry) {
+    registry_patterns.insert(trimmed_pattern);
+  }
+}
+
+bool ManagedModeURLFilter::HostPatterns::Matches(
+    const std::string& host) const {
+  if (HostOrParentDomainIsIn(subdomain_patterns, host))
+    return true;
+
+  if (registry_patterns.empty() && registry_subdomain_patterns.empty())
+    return false;
+
+  size_t registry_length = GetRegistryLength(
+      host, EXCLUDE_UNKNOWN_REGISTRIES, EXCLUDE_PRIVATE_REGISTRIES);
+  // A host without a known registry part does not match.
+  if (registry_length == 0 || registry_length >= host.length())
+    return false;
+
+  std::string trimmed_host =
+      host.substr(0, host.length() - (registry_length + 1));
+  return registry_patterns.count(trimmed_host) ||
+         HostOrParentDomainIsIn(registry_subdomain_patterns, trimmed_host);
+}
+
 ManagedModeURLFilter::ManagedModeURLFilter()
     : default_behavior_(ALLOW),
-      contents_(new Contents()) {
+      contents_(new Contents()),
+      allowed_host_patterns_(new HostPatterns()),
+      blocked_host_patterns_(new HostPatterns()) {
   // Detach from the current thread so we can be constructed on a different
   // thread than the one where we're used.
   DetachFromThread();
@@ -266,13 +345,12 @@ ManagedModeURLFilter::GetFilteringBehaviorForURL(const GURL& url) const {
     return host_it->second ? ALLOW : BLOCK;
 
   // Look for patterns matching the hostname, with a value that is different
-  // from the default (a value of true in the map meaning allowed).
-  for (std::map<std::string, bool>::const_iterator host_it =
-      host_map_.begin(); host_it != host_map_.end(); ++host_it) {
-    if ((host_it->second == (default_behavior_ == BLOCK)) &&
-        HostMatchesPattern(host, host_it->first)) {
-      return host_it->second ? ALLOW : BLOCK;
-    }
+  // from the default.
+  if (default_behavior_ == BLOCK) {
+    if (allowed_host_patterns_->Matches(host))
+      return ALLOW;
+  } else if (blocked_host_patterns_->Matches(host)) {
+    return BLOCK;
   }
 
   // If the default behavior is to allow, we don't need to check anything else.
@@ -354,6 +432,15 @@ void ManagedModeURLFilter::SetManualHosts(
     const std::map<std::string, bool>* host_map) {
   DCHECK(CalledOnValidThread());
   host_map_ = *host_map;
+  allowed_host_patterns_.reset(new HostPatterns());
+  blocked_host_patterns_.reset(new HostPatterns());
+  for (std::map<std::string, bool>::const_iterator it = host_map_.begin();
+       it != host_map_.end(); ++it) {
+    if (it->second)
+      allowed_host_patterns_->AddPattern(it->first);
+    else
+      blocked_host_patterns_->AddPattern(it->first);
+  }
   UMA_HISTOGRAM_CUSTOM_COUNTS("ManagedMode.ManualHostsEntries",
                               host_map->size(), 1, 1000, 50);
 }
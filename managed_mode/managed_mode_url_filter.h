@@ -106,6 +106,9 @@ class ManagedModeURLFilter
   friend class base::RefCountedThreadSafe<ManagedModeURLFilter>;
   ~ManagedModeURLFilter();
 
+  // The manually allowed or blocked host patterns, indexed for lookup.
+  struct HostPatterns;
+
   void SetContents(scoped_ptr<Contents> url_matcher);
 
   ObserverList<Observer> observers_;
@@ -121,6 +124,10 @@ class ManagedModeURLFilter
   // (false).
   std::map<std::string, bool> host_map_;
 
+  // The patterns from |host_map_| that are allowed or blocked, respectively.
+  scoped_ptr<HostPatterns> allowed_host_patterns_;
+  scoped_ptr<HostPatterns> blocked_host_patterns_;
+
   DISALLOW_COPY_AND_ASSIGN(ManagedModeURLFilter);
 };
 
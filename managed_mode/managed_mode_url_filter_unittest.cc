@@ -309,6 +309,7 @@ TEST_F(ManagedModeURLFilterTest, Patterns) {
 
   hosts["accounts.google.com"] = false;
   hosts["mail.google.com"] = true;
+  hosts["*.youtube.*"] = true;
   filter_->SetManualHosts(&hosts);
 
   // Initially, the default filtering behavior is BLOCK.
@@ -316,6 +317,9 @@ TEST_F(ManagedModeURLFilterTest, Patterns) {
   EXPECT_FALSE(IsURLWhitelisted("http://accounts.google.com/bar/"));
   EXPECT_FALSE(IsURLWhitelisted("http://www.google.co.uk/blurp/"));
   EXPECT_TRUE(IsURLWhitelisted("http://mail.google.com/moose/"));
+  EXPECT_TRUE(IsURLWhitelisted("http://youtube.com/"));
+  EXPECT_TRUE(IsURLWhitelisted("http://m.youtube.co.uk/"));
+  EXPECT_FALSE(IsURLWhitelisted("http://notyoutube.com/"));
 
   filter_->SetDefaultFilteringBehavior(ManagedModeURLFilter::ALLOW);
   EXPECT_FALSE(IsURLWhitelisted("http://www.google.com/foo/"));
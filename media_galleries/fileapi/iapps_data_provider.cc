@@ -8,6 +8,7 @@
 
 #include "base/bind.h"
 #include "base/callback.h"
+#include "base/file_util.h"
 #include "base/format_macros.h"
 #include "base/location.h"
 #include "base/logging.h"
@@ -25,9 +26,19 @@
 
 namespace iapps {
 
+namespace {
+
+// A library file modified more recently than this before it is parsed may
+// still be written to within the file system's time resolution, so its size
+// and modification time are not trusted to detect later changes.
+const int kMinStableLibraryAgeSeconds = 2;
+
+}  // namespace
+
 IAppsDataProvider::IAppsDataProvider(const base::FilePath& library_path)
     : library_path_(library_path),
       needs_refresh_(true),
+      parsed_size_(-1),
       is_valid_(false),
       weak_factory_(this) {
   DCHECK(MediaFileSystemBackend::CurrentlyOnMediaTaskRunnerThread());
@@ -60,6 +71,25 @@ void IAppsDataProvider::RefreshData(const ReadyCallback& ready_callback) {
 
   // TODO(gbillock): this needs re-examination. Could be a refresh bug.
   needs_refresh_ = false;
+
+  base::PlatformFileInfo file_info;
+  if (!file_util::GetFileInfo(library_path_, &file_info)) {
+    parsed_size_ = -1;
+    parsed_last_modified_ = base::Time();
+  } else if (valid() && !parsed_last_modified_.is_null() &&
+             file_info.size == parsed_size_ &&
+             file_info.last_modified == parsed_last_modified_) {
+    ready_callback.Run(true);
+    return;
+  } else {
+    parsed_size_ = file_info.size;
+    parsed_last_modified_ = file_info.last_modified;
+    if (base::Time::Now() - file_info.last_modified <
+        base::TimeDelta::FromSeconds(kMinStableLibraryAgeSeconds)) {
+      parsed_last_modified_ = base::Time();
+    }
+  }
+
   DoParseLibrary(library_path_, ready_callback);
 }
 
@@ -14,6 +14,7 @@
 #include "base/files/file_path.h"
 #include "base/files/file_path_watcher.h"
 #include "base/memory/weak_ptr.h"
+#include "base/time/time.h"
 
 namespace iapps {
 
@@ -60,6 +61,13 @@ class IAppsDataProvider {
   // True if the data needs to be refreshed from disk.
   bool needs_refresh_;
 
+  // Size and modification time of |library_path_| when it was last parsed.
+  // The watcher also fires when the file is touched or rewritten as is, so
+  // these let RefreshData() skip parsing a large library whose file did not
+  // change. |parsed_last_modified_| is null if the file was not stable yet.
+  int64 parsed_size_;
+  base::Time parsed_last_modified_;
+
   // True if |library_| contains valid data. False at construction and if
   // reading or parsing the XML file fails.
   bool is_valid_;
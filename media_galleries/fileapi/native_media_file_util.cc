@@ -530,18 +530,19 @@ base::PlatformFileError NativeMediaFileUtil::ReadDirectorySync(
   for (base::FilePath enum_path = file_enum.Next();
        !enum_path.empty();
        enum_path = file_enum.Next()) {
-    // Skip symlinks.
-    if (file_util::IsLink(enum_path))
-      continue;
-
     base::FileEnumerator::FileInfo info = file_enum.GetInfo();
 
-    // NativeMediaFileUtil skip criteria.
+    // NativeMediaFileUtil skip criteria. Filter by name first, so that the
+    // symlink check below only stats entries which may be returned.
     if (ShouldSkip(enum_path))
       continue;
     if (!info.IsDirectory() && !media_path_filter_->Match(enum_path))
       continue;
 
+    // Skip symlinks.
+    if (file_util::IsLink(enum_path))
+      continue;
+
     fileapi::DirectoryEntry entry;
     entry.is_directory = info.IsDirectory();
     entry.name = enum_path.BaseName().value();
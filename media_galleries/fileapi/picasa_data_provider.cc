@@ -163,6 +163,8 @@ void PicasaDataProvider::DoRefreshIfNecessary() {
     if (albums_indexer_)
       return;
     albums_indexer_ = new SafePicasaAlbumsIndexer(album_map_, folder_map_);
+    if (last_albums_indexer_)
+      albums_indexer_->SetPreviousResult(last_albums_indexer_, albums_images_);
     albums_indexer_->Start(base::Bind(&PicasaDataProvider::OnAlbumsIndexerDone,
                                       weak_factory_.GetWeakPtr(),
                                       albums_indexer_));
@@ -219,6 +221,7 @@ void PicasaDataProvider::OnAlbumsIndexerDone(
     state_ = ALBUMS_IMAGES_FRESH_STATE;
 
     albums_images_ = albums_images;
+    last_albums_indexer_ = indexer;
   }
 
   RunAllCallbacks(&albums_index_ready_callbacks_, success);
@@ -106,6 +106,10 @@ class PicasaDataProvider {
   scoped_refptr<SafePicasaAlbumTableReader> album_table_reader_;
   scoped_refptr<SafePicasaAlbumsIndexer> albums_indexer_;
 
+  // The indexer which produced |albums_images_|, so that re-indexing after
+  // the data goes stale can reuse it if the INI files did not change.
+  scoped_refptr<SafePicasaAlbumsIndexer> last_albums_indexer_;
+
   // We watch the temp dir, as we can't detect database file modifications on
   // Mac, but we are able to detect creation and deletion of temporary files.
   scoped_ptr<base::FilePathWatcher> temp_dir_watcher_;
@@ -42,6 +42,16 @@ SafePicasaAlbumsIndexer::SafePicasaAlbumsIndexer(const AlbumMap& albums,
     folders_queue_.push(it->second.path);
 }
 
+void SafePicasaAlbumsIndexer::SetPreviousResult(
+    scoped_refptr<SafePicasaAlbumsIndexer> previous_indexer,
+    const AlbumImagesMap& previous_albums_images) {
+  DCHECK(MediaFileSystemBackend::CurrentlyOnMediaTaskRunnerThread());
+  DCHECK(previous_indexer);
+  DCHECK(callback_.is_null());
+  previous_indexer_ = previous_indexer;
+  previous_albums_images_ = previous_albums_images;
+}
+
 void SafePicasaAlbumsIndexer::Start(const DoneCallback& callback) {
   DCHECK(MediaFileSystemBackend::CurrentlyOnMediaTaskRunnerThread());
   DCHECK(!callback.is_null());
@@ -82,7 +92,16 @@ void SafePicasaAlbumsIndexer::ProcessFoldersBatch() {
     MediaFileSystemBackend::MediaTaskRunner()->PostTask(
         FROM_HERE,
         base::Bind(&SafePicasaAlbumsIndexer::ProcessFoldersBatch, this));
+  } else if (previous_indexer_ && HasSameInputAsPreviousIndexer()) {
+    parser_state_ = FINISHED_PARSING_STATE;
+    previous_indexer_ = NULL;
+    MediaFileSystemBackend::MediaTaskRunner()->PostTask(
+        FROM_HERE,
+        base::Bind(callback_, true, previous_albums_images_));
+    previous_albums_images_.clear();
   } else {
+    previous_indexer_ = NULL;
+    previous_albums_images_.clear();
     BrowserThread::PostTask(
         BrowserThread::IO,
         FROM_HERE,
@@ -90,6 +109,24 @@ void SafePicasaAlbumsIndexer::ProcessFoldersBatch() {
   }
 }
 
+bool SafePicasaAlbumsIndexer::HasSameInputAsPreviousIndexer() const {
+  DCHECK(MediaFileSystemBackend::CurrentlyOnMediaTaskRunnerThread());
+  DCHECK(previous_indexer_);
+  const std::vector<FolderINIContents>& previous_inis =
+      previous_indexer_->folders_inis_;
+  if (album_uids_ != previous_indexer_->album_uids_ ||
+      folders_inis_.size() != previous_inis.size()) {
+    return false;
+  }
+  for (size_t i = 0; i < folders_inis_.size(); ++i) {
+    if (folders_inis_[i].folder_path != previous_inis[i].folder_path ||
+        folders_inis_[i].ini_contents != previous_inis[i].ini_contents) {
+      return false;
+    }
+  }
+  return true;
+}
+
 void SafePicasaAlbumsIndexer::StartWorkOnIOThread() {
   DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
   DCHECK_EQ(INITIAL_STATE, parser_state_);
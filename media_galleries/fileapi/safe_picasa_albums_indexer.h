@@ -37,6 +37,14 @@ class SafePicasaAlbumsIndexer : public content::UtilityProcessHostClient {
 
   SafePicasaAlbumsIndexer(const AlbumMap& albums, const AlbumMap& folders);
 
+  // Makes the indexer reuse |previous_albums_images|, the result of
+  // |previous_indexer|, instead of starting the utility process, if the albums
+  // and the contents of the folders' INI files did not change since then.
+  // Must be called before Start().
+  void SetPreviousResult(
+      scoped_refptr<SafePicasaAlbumsIndexer> previous_indexer,
+      const AlbumImagesMap& previous_albums_images);
+
   void Start(const DoneCallback& callback);
 
  private:
@@ -52,6 +60,10 @@ class SafePicasaAlbumsIndexer : public content::UtilityProcessHostClient {
   // Processes a batch of folders. Reposts itself until done, then starts IPC.
   void ProcessFoldersBatch();
 
+  // Returns true if the albums and INI files to index are the same as those
+  // of |previous_indexer_|.
+  bool HasSameInputAsPreviousIndexer() const;
+
   // Launches the utility process.  Must run on the IO thread.
   void StartWorkOnIOThread();
 
@@ -72,6 +84,10 @@ class SafePicasaAlbumsIndexer : public content::UtilityProcessHostClient {
 
   std::vector<picasa::FolderINIContents> folders_inis_;
 
+  // Set by SetPreviousResult(). Only accessed on the Media Task Runner.
+  scoped_refptr<SafePicasaAlbumsIndexer> previous_indexer_;
+  AlbumImagesMap previous_albums_images_;
+
   // Only accessed on the Media Task Runner.
   DoneCallback callback_;
 
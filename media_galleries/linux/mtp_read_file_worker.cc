@@ -37,7 +37,10 @@ uint32 WriteDataChunkIntoSnapshotFileOnFileThread(
 
 MTPReadFileWorker::MTPReadFileWorker(const std::string& device_handle)
     : device_handle_(device_handle),
-      weak_ptr_factory_(this) {
+      read_ahead_in_progress_(false),
+      read_ahead_error_(false),
+      weak_ptr_factory_(this),
+      read_ahead_weak_ptr_factory_(this) {
   DCHECK(content::BrowserThread::CurrentlyOn(content::BrowserThread::UI));
   DCHECK(!device_handle_.empty());
 }
@@ -88,6 +91,16 @@ void MTPReadFileWorker::OnDidReadDataChunkFromDeviceFile(
     return;
   }
 
+  // Keep the device busy while this chunk is written to the snapshot file.
+  uint32 next_offset = snapshot_file_details->bytes_written() +
+      base::checked_numeric_cast<uint32>(data.size());
+  if (next_offset < snapshot_file_details->file_info().size) {
+    ReadAheadDataChunkFromDeviceFile(
+        snapshot_file_details->device_file_path(),
+        next_offset,
+        snapshot_file_details->BytesToReadAt(next_offset));
+  }
+
   // To avoid calling |snapshot_file_details| methods and passing ownership of
   // |snapshot_file_details| in the same_line.
   SnapshotFileDetails* snapshot_file_details_ptr = snapshot_file_details.get();
@@ -109,7 +122,15 @@ void MTPReadFileWorker::OnDidWriteDataChunkIntoSnapshotFile(
   DCHECK(snapshot_file_details.get());
   if (snapshot_file_details->AddBytesWritten(bytes_written)) {
     if (!snapshot_file_details->IsSnapshotFileWriteComplete()) {
-      ReadDataChunkFromDeviceFile(snapshot_file_details.Pass());
+      // The next chunk was requested by OnDidReadDataChunkFromDeviceFile().
+      if (read_ahead_in_progress_) {
+        snapshot_file_details_waiting_for_read_ = snapshot_file_details.Pass();
+        return;
+      }
+      std::string data;
+      data.swap(read_ahead_data_);
+      OnDidReadDataChunkFromDeviceFile(snapshot_file_details.Pass(), data,
+                                       read_ahead_error_);
       return;
     }
   } else {
@@ -118,11 +139,50 @@ void MTPReadFileWorker::OnDidWriteDataChunkIntoSnapshotFile(
   OnDidWriteIntoSnapshotFile(snapshot_file_details.Pass());
 }
 
+void MTPReadFileWorker::ReadAheadDataChunkFromDeviceFile(
+    const std::string& device_file_path,
+    uint32 offset,
+    uint32 chunk_size) {
+  DCHECK(content::BrowserThread::CurrentlyOn(content::BrowserThread::UI));
+  DCHECK(!read_ahead_in_progress_);
+  read_ahead_in_progress_ = true;
+
+  device::MediaTransferProtocolManager* mtp_device_manager =
+      StorageMonitor::GetInstance()->media_transfer_protocol_manager();
+  mtp_device_manager->ReadFileChunkByPath(
+      device_handle_,
+      device_file_path,
+      offset,
+      chunk_size,
+      base::Bind(&MTPReadFileWorker::OnDidReadAheadDataChunkFromDeviceFile,
+                 read_ahead_weak_ptr_factory_.GetWeakPtr()));
+}
+
+void MTPReadFileWorker::OnDidReadAheadDataChunkFromDeviceFile(
+    const std::string& data,
+    bool error) {
+  DCHECK(content::BrowserThread::CurrentlyOn(content::BrowserThread::UI));
+  DCHECK(read_ahead_in_progress_);
+  read_ahead_in_progress_ = false;
+  if (snapshot_file_details_waiting_for_read_) {
+    OnDidReadDataChunkFromDeviceFile(
+        snapshot_file_details_waiting_for_read_.Pass(), data, error);
+    return;
+  }
+  read_ahead_data_ = data;
+  read_ahead_error_ = error;
+}
+
 void MTPReadFileWorker::OnDidWriteIntoSnapshotFile(
     scoped_ptr<SnapshotFileDetails> snapshot_file_details) {
   DCHECK(content::BrowserThread::CurrentlyOn(content::BrowserThread::UI));
   DCHECK(snapshot_file_details.get());
 
+  // Drop the read ahead request left over after an error.
+  read_ahead_weak_ptr_factory_.InvalidateWeakPtrs();
+  read_ahead_in_progress_ = false;
+  read_ahead_data_.clear();
+
   if (snapshot_file_details->error_occurred()) {
     content::BrowserThread::PostTask(
         content::BrowserThread::IO,
@@ -77,12 +77,39 @@ class MTPReadFileWorker {
       scoped_ptr<SnapshotFileDetails> snapshot_file_details,
       uint32 bytes_written);
 
+  // Dispatches the request to read the |chunk_size| bytes at |offset| of
+  // |device_file_path|, while the previous chunk is written to the snapshot
+  // file.
+  void ReadAheadDataChunkFromDeviceFile(const std::string& device_file_path,
+                                        uint32 offset,
+                                        uint32 chunk_size);
+
+  // Called when ReadAheadDataChunkFromDeviceFile() completes. |data| and
+  // |error| are as in OnDidReadDataChunkFromDeviceFile().
+  void OnDidReadAheadDataChunkFromDeviceFile(const std::string& data,
+                                             bool error);
+
   // The device unique identifier to query the device.
   const std::string device_handle_;
 
+  // True while a read ahead request is dispatched to the device.
+  bool read_ahead_in_progress_;
+
+  // Result of the last completed read ahead request.
+  std::string read_ahead_data_;
+  bool read_ahead_error_;
+
+  // Set when the previous chunk is written before the read ahead request
+  // completes, to resume the snapshot file once it does.
+  scoped_ptr<SnapshotFileDetails> snapshot_file_details_waiting_for_read_;
+
   // For callbacks that may run after destruction.
   base::WeakPtrFactory<MTPReadFileWorker> weak_ptr_factory_;
 
+  // For read ahead callbacks, which are dropped when a snapshot file request
+  // completes.
+  base::WeakPtrFactory<MTPReadFileWorker> read_ahead_weak_ptr_factory_;
+
   DISALLOW_COPY_AND_ASSIGN(MTPReadFileWorker);
 };
 
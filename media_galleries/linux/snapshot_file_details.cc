@@ -4,6 +4,7 @@
 
 #include "chrome/browser/media_galleries/linux/snapshot_file_details.h"
 
+#include "base/logging.h"
 #include "base/safe_numerics.h"
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -60,9 +61,14 @@ bool SnapshotFileDetails::IsSnapshotFileWriteComplete() const {
 }
 
 uint32 SnapshotFileDetails::BytesToRead() const {
+  return BytesToReadAt(bytes_written_);
+}
+
+uint32 SnapshotFileDetails::BytesToReadAt(uint32 offset) const {
   // Read data in 1MB chunks.
   static const uint32 kReadChunkSize = 1024 * 1024;
+  DCHECK_LE(offset, file_info_.size);
   return std::min(
       kReadChunkSize,
-      base::checked_numeric_cast<uint32>(file_info_.size) - bytes_written_);
+      base::checked_numeric_cast<uint32>(file_info_.size) - offset);
 }
@@ -91,7 +91,10 @@ class SnapshotFileDetails {
   // operation is required to complete the snapshot file).
   bool IsSnapshotFileWriteComplete() const;
 
+  // Returns the size of the next chunk to read from the device, starting at
+  // |bytes_written_|, or at |offset| for the variant taking it.
   uint32 BytesToRead() const;
+  uint32 BytesToReadAt(uint32 offset) const;
 
  private:
   // Snapshot file request params.
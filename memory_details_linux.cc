@@ -84,6 +84,9 @@ struct Process {
 
 typedef std::map<pid_t, Process> ProcessMap;
 
+// Maps a pid to the pids of its child processes.
+typedef std::multimap<pid_t, pid_t> ChildrenMap;
+
 // Get information on all the processes running on the system.
 static ProcessMap GetProcesses() {
   ProcessMap map;
@@ -137,28 +140,31 @@ static ProcessData GetProcessDataMemoryInformation(
   return process_data;
 }
 
-// Find all children of the given process with pid |root|.
-static std::vector<pid_t> GetAllChildren(const ProcessMap& processes,
+// Index the processes in |processes| by their parent.
+static ChildrenMap GetChildrenMap(const ProcessMap& processes) {
+  ChildrenMap children;
+  for (ProcessMap::const_iterator iter = processes.begin();
+       iter != processes.end();
+       ++iter) {
+    children.insert(std::make_pair(iter->second.parent, iter->second.pid));
+  }
+  return children;
+}
+
+// Find all children of the given process with pid |root|, in breadth-first
+// order, starting with |root| itself.
+static std::vector<pid_t> GetAllChildren(const ChildrenMap& children_map,
                                          const pid_t root) {
   std::vector<pid_t> children;
   children.push_back(root);
 
-  std::set<pid_t> wavefront, next_wavefront;
-  wavefront.insert(root);
-
-  while (wavefront.size()) {
-    for (ProcessMap::const_iterator iter = processes.begin();
-         iter != processes.end();
-         ++iter) {
-      const Process& process = iter->second;
-      if (wavefront.count(process.parent)) {
-        children.push_back(process.pid);
-        next_wavefront.insert(process.pid);
-      }
+  for (size_t i = 0; i < children.size(); ++i) {
+    std::pair<ChildrenMap::const_iterator, ChildrenMap::const_iterator> range =
+        children_map.equal_range(children[i]);
+    for (ChildrenMap::const_iterator iter = range.first;
+         iter != range.second; ++iter) {
+      children.push_back(iter->second);
     }
-
-    wavefront.clear();
-    wavefront.swap(next_wavefront);
   }
   return children;
 }
@@ -195,23 +201,29 @@ void MemoryDetails::CollectProcessData(
     }
   }
 
+  const ChildrenMap children_map = GetChildrenMap(process_map);
+
   ProcessData current_browser =
-      GetProcessDataMemoryInformation(GetAllChildren(process_map, getpid()));
+      GetProcessDataMemoryInformation(GetAllChildren(children_map, getpid()));
   current_browser.name = l10n_util::GetStringUTF16(IDS_SHORT_PRODUCT_NAME);
   current_browser.process_name = ASCIIToUTF16("chrome");
 
+  // Index the child processes whose data we collected on the IO thread.
+  std::map<base::ProcessId, size_t> child_info_index;
+  for (size_t child = 0; child < child_info.size(); child++)
+    child_info_index.insert(std::make_pair(child_info[child].pid, child));
+
   for (std::vector<ProcessMemoryInformation>::iterator
        i = current_browser.processes.begin();
        i != current_browser.processes.end(); ++i) {
     // Check if this is one of the child processes whose data we collected
     // on the IO thread, and if so copy over that data.
-    for (size_t child = 0; child < child_info.size(); child++) {
-      if (child_info[child].pid != i->pid)
-        continue;
-      i->titles = child_info[child].titles;
-      i->process_type = child_info[child].process_type;
-      break;
-    }
+    std::map<base::ProcessId, size_t>::const_iterator child =
+        child_info_index.find(i->pid);
+    if (child == child_info_index.end())
+      continue;
+    i->titles = child_info[child->second].titles;
+    i->process_type = child_info[child->second].process_type;
   }
 
   process_data_.push_back(current_browser);
@@ -221,7 +233,8 @@ void MemoryDetails::CollectProcessData(
   for (std::set<pid_t>::const_iterator iter = browsers_found.begin();
        iter != browsers_found.end();
        ++iter) {
-    std::vector<pid_t> browser_processes = GetAllChildren(process_map, *iter);
+    std::vector<pid_t> browser_processes =
+        GetAllChildren(children_map, *iter);
     ProcessData browser = GetProcessDataMemoryInformation(browser_processes);
 
     ProcessMap::const_iterator process_iter = process_map.find(*iter);
@@ -161,3 +161,31 @@ void MemoryPurger::PurgeRendererForHost(content::RenderProcessHost* host) {
   // Direct the renderer to free everything it can.
   host->Send(new ChromeViewMsg_PurgeMemory());
 }
+
+// static
+void MemoryPurger::StartPurgingOnMemoryPressure() {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
+  static base::MemoryPressureListener* listener = NULL;
+  if (!listener) {
+    // Leaked, so that it is still registered during shutdown.
+    listener = new base::MemoryPressureListener(
+        base::Bind(&MemoryPurger::OnMemoryPressure));
+  }
+}
+
+// static
+void MemoryPurger::OnMemoryPressure(
+    base::MemoryPressureListener::MemoryPressureLevel memory_pressure_level) {
+  // The web cache, the history databases and the extension images trim
+  // themselves on memory pressure. Unloading the browser databases as
+  // PurgeBrowser() does would slow the browser down long after the pressure
+  // is gone, so only the renderers and the backing stores are purged, and
+  // only when the pressure is critical.
+  if (memory_pressure_level !=
+      base::MemoryPressureListener::MEMORY_PRESSURE_CRITICAL)
+    return;
+
+  content::RenderWidgetHost::RemoveAllBackingStores();
+  PurgeRenderers();
+  base::allocator::ReleaseFreeMemory();
+}
@@ -14,6 +14,7 @@
 #define CHROME_BROWSER_MEMORY_PURGER_H_
 
 #include "base/basictypes.h"
+#include "base/memory/memory_pressure_listener.h"
 
 namespace content {
 class RenderProcessHost;
@@ -27,7 +28,14 @@ class MemoryPurger {
   static void PurgeRenderers();
   static void PurgeRendererForHost(content::RenderProcessHost* host);
 
+  // Call on the UI thread to purge the renderers whenever the system reports
+  // critical memory pressure, until shutdown. Calling it again does nothing.
+  static void StartPurgingOnMemoryPressure();
+
  private:
+  static void OnMemoryPressure(
+      base::MemoryPressureListener::MemoryPressureLevel memory_pressure_level);
+
   DISALLOW_IMPLICIT_CONSTRUCTORS(MemoryPurger);
 };
 
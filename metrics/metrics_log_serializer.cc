@@ -72,9 +72,16 @@ void MetricsLogSerializer::SerializeLogs(const std::vector<std::string>& logs,
       return;
   };
 
-  ListPrefUpdate update(local_state, pref);
+  // Most calls store the same logs as the last one, so only rewrite the pref,
+  // and schedule a write of Local State, when the list actually changed.
+  base::ListValue new_list;
   WriteLogsToPrefList(logs, store_length_limit, kStorageByteLimitPerLogType,
-                      update.Get());
+                      &new_list);
+  if (local_state->GetList(pref)->Equals(&new_list))
+    return;
+
+  ListPrefUpdate update(local_state, pref);
+  update->Swap(&new_list);
 }
 
 void MetricsLogSerializer::DeserializeLogs(MetricsLogManager::LogType log_type,
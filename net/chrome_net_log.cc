@@ -11,14 +11,23 @@
 #include "base/strings/string_number_conversions.h"
 #include "base/strings/string_util.h"
 #include "base/values.h"
+#include "chrome/browser/net/net_log_ring_buffer.h"
 #include "chrome/browser/net/net_log_temp_file.h"
 #include "chrome/browser/ui/webui/net_internals/net_internals_ui.h"
 #include "chrome/common/chrome_switches.h"
 #include "content/public/common/content_switches.h"
 #include "net/base/net_log_logger.h"
 
+namespace {
+
+// The number of recent entries kept for chrome://net-export.
+const size_t kMaxRecentEntries = 5000;
+
+}  // namespace
+
 ChromeNetLog::ChromeNetLog()
-    : net_log_temp_file_(new NetLogTempFile(this)) {
+    : net_log_ring_buffer_(new NetLogRingBuffer(kMaxRecentEntries)),
+      net_log_temp_file_(new NetLogTempFile(this)) {
   const CommandLine* command_line = CommandLine::ForCurrentProcess();
   // Adjust base log level based on command line switch, if present.
   // This is done before adding any observers so the call to UpdateLogLevel when
@@ -59,6 +68,8 @@ ChromeNetLog::ChromeNetLog()
       net_log_logger_->StartObserving(this);
     }
   }
+
+  net_log_ring_buffer_->StartObserving(this);
 }
 
 ChromeNetLog::~ChromeNetLog() {
@@ -66,5 +77,6 @@ ChromeNetLog::~ChromeNetLog() {
   // Remove the observers we own before we're destroyed.
   if (net_log_logger_)
     RemoveThreadSafeObserver(net_log_logger_.get());
+  net_log_ring_buffer_->StopObserving();
 }
 
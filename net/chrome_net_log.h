@@ -15,10 +15,12 @@ namespace net {
 class NetLogLogger;
 }
 
+class NetLogRingBuffer;
 class NetLogTempFile;
 
 // ChromeNetLog is an implementation of NetLog that adds file loggers
-// as its observers.
+// as its observers. It also always keeps the most recent entries in a
+// NetLogRingBuffer, so they can be exported through chrome://net-export.
 class ChromeNetLog : public net::NetLog {
  public:
   ChromeNetLog();
@@ -28,8 +30,13 @@ class ChromeNetLog : public net::NetLog {
     return net_log_temp_file_.get();
   }
 
+  NetLogRingBuffer* net_log_ring_buffer() {
+    return net_log_ring_buffer_.get();
+  }
+
  private:
   scoped_ptr<net::NetLogLogger> net_log_logger_;
+  scoped_ptr<NetLogRingBuffer> net_log_ring_buffer_;
   scoped_ptr<NetLogTempFile> net_log_temp_file_;
 
   DISALLOW_COPY_AND_ASSIGN(ChromeNetLog);
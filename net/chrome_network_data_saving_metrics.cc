@@ -4,6 +4,9 @@
 
 #include "chrome/browser/net/chrome_network_data_saving_metrics.h"
 
+#include <algorithm>
+
+#include "base/logging.h"
 #include "base/metrics/histogram.h"
 #include "base/prefs/pref_service.h"
 #include "base/strings/string_number_conversions.h"
@@ -319,7 +322,7 @@ void UpdateContentLengthPrefsForDataReductionProxy(
 void UpdateContentLengthPrefs(
     int received_content_length, int original_content_length,
     bool with_data_reduction_proxy_enabled, bool via_data_reduction_proxy,
-    PrefService* prefs) {
+    base::Time now, PrefService* prefs) {
   int64 total_received = prefs->GetInt64(prefs::kHttpReceivedContentLength);
   int64 total_original = prefs->GetInt64(prefs::kHttpOriginalContentLength);
   total_received += received_content_length;
@@ -333,10 +336,71 @@ void UpdateContentLengthPrefs(
       original_content_length,
       with_data_reduction_proxy_enabled,
       via_data_reduction_proxy,
-      base::Time::Now(),
+      now,
       prefs);
 #endif  // defined(OS_ANDROID)
 
 }
 
+PendingContentLengths::Sums::Sums() {
+  std::fill(received, received + arraysize(received), 0);
+  std::fill(original, original + arraysize(original), 0);
+}
+
+PendingContentLengths::PendingContentLengths() : response_count_(0) {}
+
+PendingContentLengths::~PendingContentLengths() {}
+
+bool PendingContentLengths::Add(int received_content_length,
+                                int original_content_length,
+                                bool via_data_reduction_proxy,
+                                base::Time now) {
+  DCHECK_GE(received_content_length, 0);
+  DCHECK_GE(original_content_length, 0);
+  const int index = via_data_reduction_proxy ? 1 : 0;
+
+  base::AutoLock lock(lock_);
+  if (sums_.empty() ||
+      now.LocalMidnight() != sums_.back().last_time.LocalMidnight() ||
+      sums_.back().received[index] >
+          kint32max - received_content_length ||
+      sums_.back().original[index] >
+          kint32max - original_content_length) {
+    sums_.push_back(Sums());
+  }
+  Sums& sums = sums_.back();
+  sums.received[index] += received_content_length;
+  sums.original[index] += original_content_length;
+  sums.last_time = now;
+  return response_count_++ == 0;
+}
+
+void PendingContentLengths::Flush(bool with_data_reduction_proxy_enabled,
+                                  PrefService* prefs) {
+  std::vector<Sums> sums;
+  int response_count = 0;
+  {
+    base::AutoLock lock(lock_);
+    sums.swap(sums_);
+    std::swap(response_count, response_count_);
+  }
+  if (response_count == 0)
+    return;
+
+  UMA_HISTOGRAM_COUNTS_1000("Net.ContentLengthPrefs.ResponsesPerFlush",
+                            response_count);
+  for (size_t i = 0; i < sums.size(); ++i) {
+    for (size_t j = 0; j < arraysize(sums[i].received); ++j) {
+      if (sums[i].received[j] == 0 && sums[i].original[j] == 0)
+        continue;
+      UpdateContentLengthPrefs(static_cast<int>(sums[i].received[j]),
+                               static_cast<int>(sums[i].original[j]),
+                               with_data_reduction_proxy_enabled,
+                               j == 1,
+                               sums[i].last_time,
+                               prefs);
+    }
+  }
+}
+
 }  // namespace chrome_browser_net
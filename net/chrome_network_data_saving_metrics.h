@@ -5,6 +5,10 @@
 #ifndef CHROME_BROWSER_NET_CHROME_NETWORK_DATA_SAVING_METRICS_H_
 #define CHROME_BROWSER_NET_CHROME_NETWORK_DATA_SAVING_METRICS_H_
 
+#include <vector>
+
+#include "base/basictypes.h"
+#include "base/synchronization/lock.h"
 #include "base/time/time.h"
 
 class PrefService;
@@ -21,13 +25,58 @@ void UpdateContentLengthPrefsForDataReductionProxy(
 #endif
 
 // Records daily data savings statistics to prefs and reports data savings UMA.
+// The content lengths are credited to the day of |now|.
 void UpdateContentLengthPrefs(
     int received_content_length,
     int original_content_length,
     bool with_data_reduction_proxy_enabled,
     bool via_data_reduction_proxy,
+    base::Time now,
     PrefService* prefs);
 
+// Sums the content lengths of responses until they are added to the prefs
+// together, so that the prefs are not updated for every response. The sums
+// are kept per local day, so the daily statistics come out the same as if
+// each response had been added on its own. Add() may be called on any thread.
+class PendingContentLengths {
+ public:
+  PendingContentLengths();
+  ~PendingContentLengths();
+
+  // Adds the lengths of a response received at |now|. Returns true if nothing
+  // was pending before, in which case the caller should schedule a Flush().
+  bool Add(int received_content_length,
+           int original_content_length,
+           bool via_data_reduction_proxy,
+           base::Time now);
+
+  // Adds the pending sums to |prefs| with UpdateContentLengthPrefs(), and
+  // clears them.
+  void Flush(bool with_data_reduction_proxy_enabled, PrefService* prefs);
+
+ private:
+  // The sums of the responses of one local day, indexed by whether they were
+  // received via the data reduction proxy.
+  struct Sums {
+    Sums();
+
+    int64 received[2];
+    int64 original[2];
+    // When the last of the responses was received.
+    base::Time last_time;
+  };
+
+  // Protects the members below.
+  base::Lock lock_;
+
+  // Oldest first. A day can have more than one entry, once a sum nears the
+  // range of an int.
+  std::vector<Sums> sums_;
+  int response_count_;
+
+  DISALLOW_COPY_AND_ASSIGN(PendingContentLengths);
+};
+
 }  // namespace chrome_browser_net
 
 #endif  // CHROME_BROWSER_NET_CHROME_NETWORK_DATA_SAVING_METRICS_H_
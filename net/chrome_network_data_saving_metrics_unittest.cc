@@ -65,7 +65,7 @@ TEST_F(ChromeNetworkDataSavingMetricsTest, TotalLengths) {
 
   chrome_browser_net::UpdateContentLengthPrefs(
       kReceivedLength, kOriginalLength,
-      false, false, &pref_service_);
+      false, false, base::Time::Now(), &pref_service_);
   EXPECT_EQ(kReceivedLength,
             pref_service_.GetInt64(prefs::kHttpReceivedContentLength));
   EXPECT_EQ(kOriginalLength,
@@ -74,13 +74,39 @@ TEST_F(ChromeNetworkDataSavingMetricsTest, TotalLengths) {
   // Record the same numbers again, and total lengths should be dobuled.
   chrome_browser_net::UpdateContentLengthPrefs(
       kReceivedLength, kOriginalLength,
-      false, false, &pref_service_);
+      false, false, base::Time::Now(), &pref_service_);
   EXPECT_EQ(kReceivedLength * 2,
             pref_service_.GetInt64(prefs::kHttpReceivedContentLength));
   EXPECT_EQ(kOriginalLength * 2,
             pref_service_.GetInt64(prefs::kHttpOriginalContentLength));
 }
 
+TEST_F(ChromeNetworkDataSavingMetricsTest, PendingContentLengths) {
+  const int kOriginalLength = 200;
+  const int kReceivedLength = 100;
+  const base::Time now = base::Time::Now();
+  chrome_browser_net::PendingContentLengths pending;
+
+  // Only the first response asks for a flush.
+  EXPECT_TRUE(pending.Add(kReceivedLength, kOriginalLength, false, now));
+  EXPECT_FALSE(pending.Add(kReceivedLength, kOriginalLength, true, now));
+  EXPECT_FALSE(pending.Add(kReceivedLength, kOriginalLength, false, now));
+  EXPECT_EQ(0, pref_service_.GetInt64(prefs::kHttpReceivedContentLength));
+  EXPECT_EQ(0, pref_service_.GetInt64(prefs::kHttpOriginalContentLength));
+
+  pending.Flush(false, &pref_service_);
+  EXPECT_EQ(kReceivedLength * 3,
+            pref_service_.GetInt64(prefs::kHttpReceivedContentLength));
+  EXPECT_EQ(kOriginalLength * 3,
+            pref_service_.GetInt64(prefs::kHttpOriginalContentLength));
+
+  // The sums were cleared.
+  pending.Flush(false, &pref_service_);
+  EXPECT_EQ(kReceivedLength * 3,
+            pref_service_.GetInt64(prefs::kHttpReceivedContentLength));
+  EXPECT_TRUE(pending.Add(kReceivedLength, kOriginalLength, false, now));
+}
+
 #if defined(OS_ANDROID)
 
 // The initial last update time used in test. There is no leap second a few
@@ -478,6 +504,24 @@ TEST_F(ChromeNetworkDailyDataSavingMetricsTest, BackwardTwoDays) {
       original, 1, received, 1,
       original, 1, received, 1);
 }
+TEST_F(ChromeNetworkDailyDataSavingMetricsTest, PendingContentLengthsTwoDays) {
+  const int kOriginalLength = 200;
+  const int kReceivedLength = 100;
+  chrome_browser_net::PendingContentLengths pending;
+
+  pending.Add(kReceivedLength, kOriginalLength, false, FakeNow());
+  AddFakeTimeDeltaInHours(24);
+  pending.Add(kReceivedLength, kOriginalLength, false, FakeNow());
+  pending.Add(kReceivedLength, kOriginalLength, false, FakeNow());
+  pending.Flush(false, &pref_service_);
+
+  // Each day is credited with its own responses.
+  int64 original[] = {kOriginalLength, kOriginalLength * 2};
+  int64 received[] = {kReceivedLength, kReceivedLength * 2};
+  VerifyDailyContentLengthPrefLists(
+      original, 2, received, 2,
+      NULL, 0, NULL, 0, NULL, 0, NULL, 0);
+}
 #endif  // defined(OS_ANDROID)
 
 }  // namespace
@@ -6,10 +6,12 @@
 
 #include <stdlib.h>
 
+#include <algorithm>
 #include <vector>
 
 #include "base/base_paths.h"
 #include "base/debug/trace_event.h"
+#include "base/lazy_instance.h"
 #include "base/logging.h"
 #include "base/metrics/histogram.h"
 #include "base/path_service.h"
@@ -82,6 +84,23 @@ namespace {
 
 const char kDNTHeader[] = "DNT";
 
+// How long content lengths are accumulated before they are added to the data
+// saving prefs.
+const int kContentLengthFlushDelaySeconds = 60;
+
+// The content lengths of all the delegates that are not in the prefs yet.
+base::LazyInstance<chrome_browser_net::PendingContentLengths>::Leaky
+    g_pending_content_lengths = LAZY_INSTANCE_INITIALIZER;
+
+// Names of the ChromeNetworkDelegate::DelegateHook values, as shown on
+// chrome://net-internals.
+const char* const kDelegateHookNames[] = {
+  "OnBeforeURLRequest",
+  "OnBeforeSendHeaders",
+  "OnHeadersReceived",
+  "OnCanGetCookies",
+};
+
 // If the |request| failed due to problems with a proxy, forward the error to
 // the proxy extension API.
 void ForwardProxyErrors(net::URLRequest* request,
@@ -215,45 +234,6 @@ void ForwardRequestStatus(
   }
 }
 
-void UpdateContentLengthPrefs(int received_content_length,
-                              int original_content_length,
-                              bool via_data_reduction_proxy) {
-  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
-  DCHECK_GE(received_content_length, 0);
-  DCHECK_GE(original_content_length, 0);
-
-  // Can be NULL in a unit test.
-  if (!g_browser_process)
-    return;
-
-  PrefService* prefs = g_browser_process->local_state();
-  if (!prefs)
-    return;
-
-#if defined(OS_ANDROID)
-  bool with_data_reduction_proxy_enabled =
-      g_browser_process->profile_manager()->GetDefaultProfile()->
-      GetPrefs()->GetBoolean(prefs::kSpdyProxyAuthEnabled);
-#else
-  bool with_data_reduction_proxy_enabled = false;
-#endif
-
-  chrome_browser_net::UpdateContentLengthPrefs(
-      received_content_length,
-      original_content_length,
-      with_data_reduction_proxy_enabled,
-      via_data_reduction_proxy, prefs);
-}
-
-void StoreAccumulatedContentLength(int received_content_length,
-                                   int original_content_length,
-                                   bool data_reduction_proxy_was_used) {
-  BrowserThread::PostTask(BrowserThread::UI, FROM_HERE,
-      base::Bind(&UpdateContentLengthPrefs,
-                 received_content_length, original_content_length,
-                 data_reduction_proxy_was_used));
-}
-
 void RecordContentLengthHistograms(
     int64 received_content_length,
     int64 original_content_length,
@@ -315,6 +295,7 @@ ChromeNetworkDelegate::ChromeNetworkDelegate(
       original_content_length_(0) {
   DCHECK(event_router);
   DCHECK(enable_referrers);
+  std::fill(hook_calls_, hook_calls_ + HOOK_MAX, 0);
 }
 
 ChromeNetworkDelegate::~ChromeNetworkDelegate() {}
@@ -367,6 +348,27 @@ void ChromeNetworkDelegate::InitializePrefsOnUIThread(
   }
 }
 
+// static
+void ChromeNetworkDelegate::FlushContentLengthPrefs() {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
+  // Can be NULL in a unit test.
+  PrefService* prefs =
+      g_browser_process ? g_browser_process->local_state() : NULL;
+  if (!prefs)
+    return;
+
+#if defined(OS_ANDROID)
+  bool with_data_reduction_proxy_enabled =
+      g_browser_process->profile_manager()->GetDefaultProfile()->
+      GetPrefs()->GetBoolean(prefs::kSpdyProxyAuthEnabled);
+#else
+  bool with_data_reduction_proxy_enabled = false;
+#endif
+
+  g_pending_content_lengths.Get().Flush(with_data_reduction_proxy_enabled,
+                                        prefs);
+}
+
 // static
 void ChromeNetworkDelegate::AllowAccessToAllFiles() {
   g_allow_file_access_ = true;
@@ -375,6 +377,7 @@ void ChromeNetworkDelegate::AllowAccessToAllFiles() {
 // static
 Value* ChromeNetworkDelegate::HistoricNetworkStatsInfoToValue() {
   DCHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
+  FlushContentLengthPrefs();
   PrefService* prefs = g_browser_process->local_state();
   int64 total_received = prefs->GetInt64(prefs::kHttpReceivedContentLength);
   int64 total_original = prefs->GetInt64(prefs::kHttpOriginalContentLength);
@@ -395,6 +398,17 @@ Value* ChromeNetworkDelegate::SessionNetworkStatsInfoToValue() const {
                   base::Int64ToString(received_content_length_));
   dict->SetString("session_original_content_length",
                   base::Int64ToString(original_content_length_));
+
+  ListValue* hooks = new ListValue();
+  for (int i = 0; i < HOOK_MAX; ++i) {
+    DictionaryValue* hook = new DictionaryValue();
+    hook->SetString("name", kDelegateHookNames[i]);
+    hook->SetString("calls", base::Int64ToString(hook_calls_[i]));
+    hook->SetString("total_us",
+                    base::Int64ToString(hook_times_[i].InMicroseconds()));
+    hooks->Append(hook);
+  }
+  dict->Set("delegate_hooks", hooks);
   return dict;
 }
 
@@ -402,18 +416,26 @@ int ChromeNetworkDelegate::OnBeforeURLRequest(
     net::URLRequest* request,
     const net::CompletionCallback& callback,
     GURL* new_url) {
+  TRACE_EVENT0("net", "ChromeNetworkDelegate::OnBeforeURLRequest");
+  base::TimeTicks start = base::TimeTicks::Now();
 #if defined(ENABLE_CONFIGURATION_POLICY)
   // TODO(joaodasilva): This prevents extensions from seeing URLs that are
   // blocked. However, an extension might redirect the request to another URL,
   // which is not blocked.
-  if (url_blacklist_manager_ &&
-      url_blacklist_manager_->IsRequestBlocked(*request)) {
-    // URL access blocked by policy.
-    request->net_log().AddEvent(
-        net::NetLog::TYPE_CHROME_POLICY_ABORTED_REQUEST,
-        net::NetLog::StringCallback("url",
-                                    &request->url().possibly_invalid_spec()));
-    return net::ERR_BLOCKED_BY_ADMINISTRATOR;
+  if (url_blacklist_manager_) {
+    TRACE_EVENT0("net", "URLBlacklistManager::IsRequestBlocked");
+    bool blocked = url_blacklist_manager_->IsRequestBlocked(*request);
+    UMA_HISTOGRAM_TIMES("Net.ChromeNetworkDelegate.OnBeforeURLRequest.Policy",
+                        base::TimeTicks::Now() - start);
+    if (blocked) {
+      // URL access blocked by policy.
+      request->net_log().AddEvent(
+          net::NetLog::TYPE_CHROME_POLICY_ABORTED_REQUEST,
+          net::NetLog::StringCallback(
+              "url", &request->url().possibly_invalid_spec()));
+      RecordHookTime(HOOK_BEFORE_URL_REQUEST, base::TimeTicks::Now() - start);
+      return net::ERR_BLOCKED_BY_ADMINISTRATOR;
+    }
   }
 #endif
 
@@ -441,16 +463,31 @@ int ChromeNetworkDelegate::OnBeforeURLRequest(
                                   base::Unretained(new_url));
   }
 
-  int rv = ExtensionWebRequestEventRouter::GetInstance()->OnBeforeRequest(
-      profile_, extension_info_map_.get(), request, wrapped_callback,
-      new_url);
+  int rv;
+  {
+    TRACE_EVENT0("net", "ExtensionWebRequestEventRouter::OnBeforeRequest");
+    base::TimeTicks extensions_start = base::TimeTicks::Now();
+    rv = ExtensionWebRequestEventRouter::GetInstance()->OnBeforeRequest(
+        profile_, extension_info_map_.get(), request, wrapped_callback,
+        new_url);
+    UMA_HISTOGRAM_TIMES(
+        "Net.ChromeNetworkDelegate.OnBeforeURLRequest.Extensions",
+        base::TimeTicks::Now() - extensions_start);
+  }
 
   if (force_safe_search && rv == net::OK && new_url->is_empty())
     ForceGoogleSafeSearch(request, new_url);
 
-  if (connect_interceptor_)
+  if (connect_interceptor_) {
+    TRACE_EVENT0("net", "ConnectInterceptor::WitnessURLRequest");
+    base::TimeTicks predictor_start = base::TimeTicks::Now();
     connect_interceptor_->WitnessURLRequest(request);
+    UMA_HISTOGRAM_TIMES(
+        "Net.ChromeNetworkDelegate.OnBeforeURLRequest.Predictor",
+        base::TimeTicks::Now() - predictor_start);
+  }
 
+  RecordHookTime(HOOK_BEFORE_URL_REQUEST, base::TimeTicks::Now() - start);
   return rv;
 }
 
@@ -459,8 +496,12 @@ int ChromeNetworkDelegate::OnBeforeSendHeaders(
     const net::CompletionCallback& callback,
     net::HttpRequestHeaders* headers) {
   TRACE_EVENT_ASYNC_STEP0("net", "URLRequest", request, "SendRequest");
-  return ExtensionWebRequestEventRouter::GetInstance()->OnBeforeSendHeaders(
+  TRACE_EVENT0("net", "ChromeNetworkDelegate::OnBeforeSendHeaders");
+  base::TimeTicks start = base::TimeTicks::Now();
+  int rv = ExtensionWebRequestEventRouter::GetInstance()->OnBeforeSendHeaders(
       profile_, extension_info_map_.get(), request, callback, headers);
+  RecordHookTime(HOOK_BEFORE_SEND_HEADERS, base::TimeTicks::Now() - start);
+  return rv;
 }
 
 void ChromeNetworkDelegate::OnSendHeaders(
@@ -475,9 +516,13 @@ int ChromeNetworkDelegate::OnHeadersReceived(
     const net::CompletionCallback& callback,
     const net::HttpResponseHeaders* original_response_headers,
     scoped_refptr<net::HttpResponseHeaders>* override_response_headers) {
-  return ExtensionWebRequestEventRouter::GetInstance()->OnHeadersReceived(
+  TRACE_EVENT0("net", "ChromeNetworkDelegate::OnHeadersReceived");
+  base::TimeTicks start = base::TimeTicks::Now();
+  int rv = ExtensionWebRequestEventRouter::GetInstance()->OnHeadersReceived(
       profile_, extension_info_map_.get(), request, callback,
       original_response_headers, override_response_headers);
+  RecordHookTime(HOOK_HEADERS_RECEIVED, base::TimeTicks::Now() - start);
+  return rv;
 }
 
 void ChromeNetworkDelegate::OnBeforeRedirect(net::URLRequest* request,
@@ -599,6 +644,8 @@ bool ChromeNetworkDelegate::OnCanGetCookies(
   if (!cookie_settings_.get())
     return true;
 
+  TRACE_EVENT0("net", "ChromeNetworkDelegate::OnCanGetCookies");
+  base::TimeTicks start = base::TimeTicks::Now();
   bool allow = cookie_settings_->IsReadingCookieAllowed(
       request.url(), request.first_party_for_cookies());
 
@@ -614,6 +661,7 @@ bool ChromeNetworkDelegate::OnCanGetCookies(
                    cookie_list, !allow));
   }
 
+  RecordHookTime(HOOK_CAN_GET_COOKIES, base::TimeTicks::Now() - start);
   return allow;
 }
 
@@ -751,9 +799,49 @@ void ChromeNetworkDelegate::AccumulateContentLength(
     bool via_data_reduction_proxy) {
   DCHECK_GE(received_content_length, 0);
   DCHECK_GE(original_content_length, 0);
-  StoreAccumulatedContentLength(received_content_length,
-                                original_content_length,
-                                via_data_reduction_proxy);
+
+  if (g_pending_content_lengths.Get().Add(
+          static_cast<int>(received_content_length),
+          static_cast<int>(original_content_length),
+          via_data_reduction_proxy,
+          base::Time::Now())) {
+    BrowserThread::PostDelayedTask(
+        BrowserThread::UI, FROM_HERE,
+        base::Bind(&ChromeNetworkDelegate::FlushContentLengthPrefs),
+        base::TimeDelta::FromSeconds(kContentLengthFlushDelaySeconds));
+  }
+
   received_content_length_ += received_content_length;
   original_content_length_ += original_content_length;
 }
+
+void ChromeNetworkDelegate::RecordHookTime(DelegateHook hook,
+                                           base::TimeDelta elapsed) {
+  COMPILE_ASSERT(arraysize(kDelegateHookNames) == HOOK_MAX,
+                 delegate_hook_names_mismatch);
+  DCHECK_GE(hook, 0);
+  DCHECK_LT(hook, HOOK_MAX);
+  ++hook_calls_[hook];
+  hook_times_[hook] += elapsed;
+
+  switch (hook) {
+    case HOOK_BEFORE_URL_REQUEST:
+      UMA_HISTOGRAM_TIMES("Net.ChromeNetworkDelegate.OnBeforeURLRequest",
+                          elapsed);
+      break;
+    case HOOK_BEFORE_SEND_HEADERS:
+      UMA_HISTOGRAM_TIMES("Net.ChromeNetworkDelegate.OnBeforeSendHeaders",
+                          elapsed);
+      break;
+    case HOOK_HEADERS_RECEIVED:
+      UMA_HISTOGRAM_TIMES("Net.ChromeNetworkDelegate.OnHeadersReceived",
+                          elapsed);
+      break;
+    case HOOK_CAN_GET_COOKIES:
+      UMA_HISTOGRAM_TIMES("Net.ChromeNetworkDelegate.OnCanGetCookies",
+                          elapsed);
+      break;
+    default:
+      NOTREACHED();
+  }
+}
@@ -11,6 +11,7 @@
 #include "base/compiler_specific.h"
 #include "base/memory/ref_counted.h"
 #include "base/memory/scoped_ptr.h"
+#include "base/time/time.h"
 #include "base/values.h"
 #include "net/base/network_delegate.h"
 
@@ -99,6 +100,13 @@ class ChromeNetworkDelegate : public net::NetworkDelegate {
   // instances of this object.
   static void NeverThrottleRequests();
 
+  // Adds the content lengths that all the instances accumulated since the
+  // last flush to the data saving prefs. This is done at most
+  // kContentLengthFlushDelaySeconds after a response, and must also be done
+  // on shutdown, before the local state is written for the last time. Must
+  // be called on the UI thread.
+  static void FlushContentLengthPrefs();
+
   // Binds the pref members to |pref_service| and moves them to the IO thread.
   // |enable_referrers| cannot be NULL, the others can.
   // This method should be called on the UI thread.
@@ -117,13 +125,23 @@ class ChromeNetworkDelegate : public net::NetworkDelegate {
   // Must be called on the UI thread.
   static Value* HistoricNetworkStatsInfoToValue();
 
-  // Creates a Value summary of the state of the network session. The caller is
-  // responsible for deleting the returned value.
+  // Creates a Value summary of the state of the network session, including
+  // the time spent in the hooks of this delegate. The caller is responsible
+  // for deleting the returned value.
   Value* SessionNetworkStatsInfoToValue() const;
 
  private:
   friend class ChromeNetworkDelegateTest;
 
+  // The hooks whose time is accounted for in |hook_times_|.
+  enum DelegateHook {
+    HOOK_BEFORE_URL_REQUEST,
+    HOOK_BEFORE_SEND_HEADERS,
+    HOOK_HEADERS_RECEIVED,
+    HOOK_CAN_GET_COOKIES,
+    HOOK_MAX
+  };
+
   // NetworkDelegate implementation.
   virtual int OnBeforeURLRequest(net::URLRequest* request,
                                  const net::CompletionCallback& callback,
@@ -175,6 +193,10 @@ class ChromeNetworkDelegate : public net::NetworkDelegate {
       int64 received_payload_byte_count, int64 original_payload_byte_count,
       bool data_reduction_proxy_was_used);
 
+  // Adds |elapsed| to the time spent in |hook| this session, and records it
+  // in the histogram of |hook|.
+  void RecordHookTime(DelegateHook hook, base::TimeDelta elapsed);
+
   scoped_refptr<extensions::EventRouterForwarder> event_router_;
   void* profile_;
   scoped_refptr<CookieSettings> cookie_settings_;
@@ -214,6 +236,11 @@ class ChromeNetworkDelegate : public net::NetworkDelegate {
 
   scoped_ptr<ClientHints> client_hints_;
 
+  // The number of calls to, and the total time spent in, each DelegateHook
+  // this session.
+  int64 hook_calls_[HOOK_MAX];
+  base::TimeDelta hook_times_[HOOK_MAX];
+
   DISALLOW_COPY_AND_ASSIGN(ChromeNetworkDelegate);
 };
 
@@ -279,6 +279,61 @@ TEST_F(ChromeNetworkDelegateSafeSearchTest, SafeSearchOff) {
                        "q=google&safe=active");
 }
 
+class ChromeNetworkDelegateHookStatsTest : public testing::Test {
+ public:
+  ChromeNetworkDelegateHookStatsTest()
+      : thread_bundle_(content::TestBrowserThreadBundle::IO_MAINLOOP),
+        forwarder_(new extensions::EventRouterForwarder()) {
+  }
+
+  virtual void SetUp() OVERRIDE {
+    ChromeNetworkDelegate::InitializePrefsOnUIThread(
+        &enable_referrers_, NULL, NULL, profile_.GetTestingPrefService());
+    network_delegate_.reset(
+        new ChromeNetworkDelegate(forwarder_.get(), &enable_referrers_));
+    context_.set_network_delegate(network_delegate_.get());
+  }
+
+ protected:
+  // Does a request of |url_string| through |network_delegate_|.
+  void DoRequest(const std::string& url_string) {
+    net::TestURLRequest request(
+        GURL(url_string), &delegate_, &context_, network_delegate_.get());
+    request.Start();
+    base::MessageLoop::current()->RunUntilIdle();
+  }
+
+  content::TestBrowserThreadBundle thread_bundle_;
+  scoped_refptr<extensions::EventRouterForwarder> forwarder_;
+  TestingProfile profile_;
+  BooleanPrefMember enable_referrers_;
+  net::TestURLRequestContext context_;
+  net::TestDelegate delegate_;
+  scoped_ptr<ChromeNetworkDelegate> network_delegate_;
+};
+
+// The delegate accounts for the calls to its hooks on chrome://net-internals.
+TEST_F(ChromeNetworkDelegateHookStatsTest, DelegateHookStats) {
+  DoRequest("http://google.com/search?q=google");
+
+  scoped_ptr<base::Value> value(
+      network_delegate_->SessionNetworkStatsInfoToValue());
+  base::DictionaryValue* dict = NULL;
+  ASSERT_TRUE(value->GetAsDictionary(&dict));
+  base::ListValue* hooks = NULL;
+  ASSERT_TRUE(dict->GetList("delegate_hooks", &hooks));
+  ASSERT_EQ(4u, hooks->GetSize());
+
+  base::DictionaryValue* hook = NULL;
+  ASSERT_TRUE(hooks->GetDictionary(0, &hook));
+  std::string name;
+  std::string calls;
+  EXPECT_TRUE(hook->GetString("name", &name));
+  EXPECT_TRUE(hook->GetString("calls", &calls));
+  EXPECT_EQ("OnBeforeURLRequest", name);
+  EXPECT_EQ("1", calls);
+}
+
 // Privacy Mode disables Channel Id if cookies are blocked (cr223191)
 class ChromeNetworkDelegatePrivacyModeTest : public testing::Test {
  public:
@@ -12,7 +12,8 @@ namespace chrome_browser_net {
 
 ConnectInterceptor::ConnectInterceptor(Predictor* predictor)
     : timed_cache_(base::TimeDelta::FromSeconds(
-          Predictor::kMaxUnusedSocketLifetimeSecondsWithoutAGet)),
+                       Predictor::kMaxUnusedSocketLifetimeSecondsWithoutAGet),
+                   Predictor::GetMaxRecentlySeenHosts()),
       predictor_(predictor) {
   DCHECK(predictor);
 }
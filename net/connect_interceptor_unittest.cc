@@ -12,7 +12,7 @@ namespace chrome_browser_net {
 // These tests are all focused ConnectInterceptor::TimedCache.
 TEST(ConnectInterceptorTest, TimedCacheRecall) {
   // Creat a cache that has a long expiration so that we can test basic recall.
-  ConnectInterceptor::TimedCache cache(base::TimeDelta::FromHours(1));
+  TimedCache cache(base::TimeDelta::FromHours(1), 10);
 
   GURL url("http://google.com/anypath");
   GURL ssl_url("https://ssl_google.com/anypath");
@@ -57,7 +57,7 @@ TEST(ConnectInterceptorTest, TimedCacheRecall) {
 
 TEST(ConnectInterceptorTest, TimedCacheEviction) {
   // Creat a cache that has a short expiration so that we can force evictions.
-  ConnectInterceptor::TimedCache cache(base::TimeDelta::FromMilliseconds(1));
+  TimedCache cache(base::TimeDelta::FromMilliseconds(1), 10);
 
   GURL url("http://google.com/anypath");
   EXPECT_FALSE(cache.WasRecentlySeen(url));
@@ -70,4 +70,28 @@ TEST(ConnectInterceptorTest, TimedCacheEviction) {
   EXPECT_FALSE(cache.WasRecentlySeen(url));
 }
 
+TEST(ConnectInterceptorTest, TimedCacheSizeLimit) {
+  // Create a cache that has a long expiration but only room for two urls.
+  TimedCache cache(base::TimeDelta::FromHours(1), 2);
+
+  GURL url1("http://google.com/");
+  GURL url2("http://chromium.org/");
+  GURL url3("https://google.com/");
+  cache.SetRecentlySeen(url1);
+  cache.SetRecentlySeen(url2);
+  EXPECT_TRUE(cache.WasRecentlySeen(url1));
+  EXPECT_TRUE(cache.WasRecentlySeen(url2));
+
+  // Seeing a url again doesn't take up more room.
+  cache.SetRecentlySeen(url1);
+  EXPECT_EQ(2u, cache.size());
+
+  // The least recently seen url makes room for a new one.
+  cache.SetRecentlySeen(url3);
+  EXPECT_EQ(2u, cache.size());
+  EXPECT_TRUE(cache.WasRecentlySeen(url1));
+  EXPECT_FALSE(cache.WasRecentlySeen(url2));
+  EXPECT_TRUE(cache.WasRecentlySeen(url3));
+}
+
 }  // namespace chrome_browser_net.
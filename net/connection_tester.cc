@@ -4,6 +4,8 @@
 
 #include "chrome/browser/net/connection_tester.h"
 
+#include <algorithm>
+
 #include "base/bind.h"
 #include "base/command_line.h"
 #include "base/compiler_specific.h"
@@ -13,6 +15,7 @@
 #include "base/strings/utf_string_conversions.h"
 #include "base/thread_task_runner_handle.h"
 #include "base/threading/thread_restrictions.h"
+#include "base/timer/timer.h"
 #include "chrome/common/chrome_switches.h"
 #include "content/public/browser/browser_thread.h"
 #include "net/base/io_buffer.h"
@@ -297,11 +300,16 @@ class ConnectionTester::TestRunner : public net::URLRequest::Delegate {
  public:
   // |tester| must remain alive throughout the TestRunner's lifetime.
   // |tester| will be notified of completion.
-  TestRunner(ConnectionTester* tester, net::NetLog* net_log)
+  TestRunner(ConnectionTester* tester,
+             const Experiment& experiment,
+             net::NetLog* net_log)
       : tester_(tester),
+        experiment_(experiment),
         net_log_(net_log),
         weak_factory_(this) {}
 
+  const Experiment& experiment() const { return experiment_; }
+
   // Finish running |experiment| once a ProxyConfigService has been created.
   // In the case of a FirefoxProxyConfigService, this will be called back
   // after disk access has completed.
@@ -309,9 +317,9 @@ class ConnectionTester::TestRunner : public net::URLRequest::Delegate {
     const Experiment& experiment,
     scoped_ptr<net::ProxyConfigService>* proxy_config_service, int status);
 
-  // Starts running |experiment|. Notifies tester->OnExperimentCompleted() when
-  // it is done.
-  void Run(const Experiment& experiment);
+  // Starts running the experiment. Notifies tester->OnExperimentCompleted()
+  // when it is done, or once it has taken kExperimentTimeoutSeconds.
+  void Run();
 
   // Overridden from net::URLRequest::Delegate:
   virtual void OnResponseStarted(net::URLRequest* request) OVERRIDE;
@@ -329,12 +337,20 @@ class ConnectionTester::TestRunner : public net::URLRequest::Delegate {
 
   // Called when the request has completed (for both success and failure).
   void OnResponseCompleted(net::URLRequest* request);
+
+  // Notifies the tester of |result| from a separate task.
+  void PostExperimentCompleted(int result);
   void OnExperimentCompletedWithResult(int result);
 
+  // Called when the experiment has taken too long.
+  void OnTimeout();
+
   ConnectionTester* tester_;
+  const Experiment experiment_;
   scoped_ptr<ExperimentURLRequestContext> request_context_;
   scoped_ptr<net::URLRequest> request_;
   net::NetLog* net_log_;
+  base::OneShotTimer<TestRunner> timeout_timer_;
 
   base::WeakPtrFactory<TestRunner> weak_factory_;
 
@@ -382,6 +398,11 @@ void ConnectionTester::TestRunner::OnResponseCompleted(
     DCHECK_NE(net::ERR_IO_PENDING, request->status().error());
     result = request->status().error();
   }
+  PostExperimentCompleted(result);
+}
+
+void ConnectionTester::TestRunner::PostExperimentCompleted(int result) {
+  timeout_timer_.Stop();
 
   // Post a task to notify the parent rather than handling it right away,
   // to avoid re-entrancy problems with URLRequest. (Don't want the caller
@@ -393,7 +414,12 @@ void ConnectionTester::TestRunner::OnResponseCompleted(
 }
 
 void ConnectionTester::TestRunner::OnExperimentCompletedWithResult(int result) {
-  tester_->OnExperimentCompleted(result);
+  tester_->OnExperimentCompleted(this, result);
+}
+
+void ConnectionTester::TestRunner::OnTimeout() {
+  // The tester deletes this runner, which abandons the request.
+  tester_->OnExperimentCompleted(this, net::ERR_TIMED_OUT);
 }
 
 void ConnectionTester::TestRunner::ProxyConfigServiceCreated(
@@ -405,7 +431,7 @@ void ConnectionTester::TestRunner::ProxyConfigServiceCreated(
                                     proxy_config_service,
                                     net_log_);
   if (status != net::OK) {
-    tester_->OnExperimentCompleted(status);
+    PostExperimentCompleted(status);
     return;
   }
   // Fetch a request using the experimental context.
@@ -413,7 +439,11 @@ void ConnectionTester::TestRunner::ProxyConfigServiceCreated(
   request_->Start();
 }
 
-void ConnectionTester::TestRunner::Run(const Experiment& experiment) {
+void ConnectionTester::TestRunner::Run() {
+  const Experiment& experiment = experiment_;
+  timeout_timer_.Start(FROM_HERE, tester_->experiment_timeout_,
+                       this, &TestRunner::OnTimeout);
+
   // Try to create a net::URLRequestContext for this experiment.
   request_context_.reset(
       new ExperimentURLRequestContext(tester_->proxy_request_context_));
@@ -438,13 +468,15 @@ ConnectionTester::ConnectionTester(
     net::NetLog* net_log)
     : delegate_(delegate),
       proxy_request_context_(proxy_request_context),
-      net_log_(net_log) {
+      net_log_(net_log),
+      experiment_timeout_(
+          base::TimeDelta::FromSeconds(kExperimentTimeoutSeconds)) {
   DCHECK(delegate);
   DCHECK(proxy_request_context);
 }
 
 ConnectionTester::~ConnectionTester() {
-  // Cancellation happens automatically by deleting test_runner_.
+  // Cancellation happens automatically by deleting test_runners_.
 }
 
 void ConnectionTester::RunAllTests(const GURL& url) {
@@ -453,7 +485,7 @@ void ConnectionTester::RunAllTests(const GURL& url) {
   GetAllPossibleExperimentCombinations(url, &remaining_experiments_);
 
   delegate_->OnStartConnectionTestSuite();
-  StartNextExperiment();
+  StartExperiments();
 }
 
 // static
@@ -512,29 +544,35 @@ void ConnectionTester::GetAllPossibleExperimentCombinations(
   }
 }
 
-void ConnectionTester::StartNextExperiment() {
-  DCHECK(!remaining_experiments_.empty());
-  DCHECK(!current_test_runner_.get());
+void ConnectionTester::StartExperiments() {
+  while (!remaining_experiments_.empty() &&
+         test_runners_.size() < kMaxConcurrentExperiments) {
+    Experiment experiment = remaining_experiments_.front();
+    remaining_experiments_.erase(remaining_experiments_.begin());
 
-  delegate_->OnStartConnectionTestExperiment(current_experiment());
+    delegate_->OnStartConnectionTestExperiment(experiment);
 
-  current_test_runner_.reset(new TestRunner(this, net_log_));
-  current_test_runner_->Run(current_experiment());
+    TestRunner* test_runner = new TestRunner(this, experiment, net_log_);
+    test_runners_.push_back(test_runner);
+    test_runner->Run();
+  }
 }
 
-void ConnectionTester::OnExperimentCompleted(int result) {
-  Experiment current = current_experiment();
+void ConnectionTester::OnExperimentCompleted(TestRunner* test_runner,
+                                             int result) {
+  Experiment experiment = test_runner->experiment();
 
-  // Advance to the next experiment.
-  remaining_experiments_.erase(remaining_experiments_.begin());
-  current_test_runner_.reset();
+  ScopedVector<TestRunner>::iterator it =
+      std::find(test_runners_.begin(), test_runners_.end(), test_runner);
+  DCHECK(it != test_runners_.end());
+  test_runners_.erase(it);
 
   // Notify the delegate of completion.
-  delegate_->OnCompletedConnectionTestExperiment(current, result);
+  delegate_->OnCompletedConnectionTestExperiment(experiment, result);
 
-  if (remaining_experiments_.empty()) {
+  if (remaining_experiments_.empty() && test_runners_.empty()) {
     delegate_->OnCompletedConnectionTestSuite();
   } else {
-    StartNextExperiment();
+    StartExperiments();
   }
 }
@@ -9,6 +9,8 @@
 
 #include "base/basictypes.h"
 #include "base/memory/scoped_ptr.h"
+#include "base/memory/scoped_vector.h"
+#include "base/time/time.h"
 #include "net/base/completion_callback.h"
 #include "url/gurl.h"
 
@@ -34,12 +36,15 @@ class URLRequestContext;
 // To run the test suite, create an instance of ConnectionTester and then call
 // RunAllTests().
 //
-// This starts a sequence of tests, which will complete asynchronously.
-// The ConnectionTester object can be deleted at any time, and it will abort
-// any of the in-progress tests.
+// This starts the tests, which will complete asynchronously. Up to
+// kMaxConcurrentExperiments of them run at the same time, and each is given at
+// most kExperimentTimeoutSeconds to complete before it fails with
+// net::ERR_TIMED_OUT. The ConnectionTester object can be deleted at any time,
+// and it will abort any of the in-progress tests.
 //
 // As tests are started or completed, notification will be sent through the
-// "Delegate" object.
+// "Delegate" object. Since tests run concurrently, an experiment may be
+// started before the previously started ones have completed.
 
 class ConnectionTester {
  public:
@@ -125,6 +130,12 @@ class ConnectionTester {
     virtual ~Delegate() {}
   };
 
+  // The most experiments to run at the same time.
+  static const size_t kMaxConcurrentExperiments = 4;
+
+  // How long an experiment may take before it is failed.
+  static const int kExperimentTimeoutSeconds = 30;
+
   // Constructs a ConnectionTester that notifies test progress to |delegate|.
   // |delegate| is owned by the caller, and must remain valid for the lifetime
   // of ConnectionTester.
@@ -139,6 +150,12 @@ class ConnectionTester {
   // |delegate_|.
   void RunAllTests(const GURL& url);
 
+  // Overrides kExperimentTimeoutSeconds for the experiments started after
+  // this call.
+  void SetExperimentTimeoutForTesting(base::TimeDelta timeout) {
+    experiment_timeout_ = timeout;
+  }
+
   // Returns a text string explaining what |experiment| is testing.
   static string16 ProxySettingsExperimentDescription(
       ProxySettingsExperiment experiment);
@@ -155,31 +172,29 @@ class ConnectionTester {
   static void GetAllPossibleExperimentCombinations(const GURL& url,
                                                    ExperimentList* list);
 
-  // Starts the next experiment from |remaining_experiments_|.
-  void StartNextExperiment();
+  // Starts experiments from |remaining_experiments_| until as many as allowed
+  // are running.
+  void StartExperiments();
 
-  // Callback for when |current_test_runner_| finishes.
-  void OnExperimentCompleted(int result);
-
-  // Returns the experiment at the front of our list.
-  const Experiment& current_experiment() const {
-    return remaining_experiments_.front();
-  }
+  // Callback for when |test_runner| finishes.
+  void OnExperimentCompleted(TestRunner* test_runner, int result);
 
   // The object to notify test progress to.
   Delegate* delegate_;
 
-  // The current in-progress test, or NULL if there is no active test.
-  scoped_ptr<TestRunner> current_test_runner_;
+  // The in-progress tests.
+  ScopedVector<TestRunner> test_runners_;
 
-  // The ordered list of experiments to try next. The experiment at the front
-  // of the list is the one currently in progress.
+  // The ordered list of experiments which have not been started yet.
   ExperimentList remaining_experiments_;
 
   net::URLRequestContext* const proxy_request_context_;
 
   net::NetLog* net_log_;
 
+  // How long each experiment may take before it is failed.
+  base::TimeDelta experiment_timeout_;
+
   DISALLOW_COPY_AND_ASSIGN(ConnectionTester);
 };
 
@@ -6,6 +6,7 @@
 
 #include "base/prefs/testing_pref_service.h"
 #include "content/public/test/test_browser_thread.h"
+#include "net/base/net_errors.h"
 #include "net/cert/mock_cert_verifier.h"
 #include "net/cookies/cookie_monster.h"
 #include "net/dns/mock_host_resolver.h"
@@ -35,6 +36,7 @@ class ConnectionTesterDelegate : public ConnectionTester::Delegate {
      : start_connection_test_suite_count_(0),
        start_connection_test_experiment_count_(0),
        completed_connection_test_experiment_count_(0),
+       timed_out_connection_test_experiment_count_(0),
        completed_connection_test_suite_count_(0) {
   }
 
@@ -51,6 +53,8 @@ class ConnectionTesterDelegate : public ConnectionTester::Delegate {
       const ConnectionTester::Experiment& experiment,
       int result) OVERRIDE {
     completed_connection_test_experiment_count_++;
+    if (result == net::ERR_TIMED_OUT)
+      timed_out_connection_test_experiment_count_++;
   }
 
   virtual void OnCompletedConnectionTestSuite() OVERRIDE {
@@ -70,6 +74,10 @@ class ConnectionTesterDelegate : public ConnectionTester::Delegate {
     return completed_connection_test_experiment_count_;
   }
 
+  int timed_out_connection_test_experiment_count() const {
+    return timed_out_connection_test_experiment_count_;
+  }
+
   int completed_connection_test_suite_count() const {
     return completed_connection_test_suite_count_;
   }
@@ -78,6 +86,7 @@ class ConnectionTesterDelegate : public ConnectionTester::Delegate {
   int start_connection_test_suite_count_;
   int start_connection_test_experiment_count_;
   int completed_connection_test_experiment_count_;
+  int timed_out_connection_test_experiment_count_;
   int completed_connection_test_suite_count_;
 };
 
@@ -178,6 +187,32 @@ TEST_F(ConnectionTesterTest, RunAllTests) {
   EXPECT_EQ(1, test_delegate_.completed_connection_test_suite_count());
 }
 
+// The experiments whose requests do get to the server all fail with
+// net::ERR_TIMED_OUT, since the server waits longer than the timeout before it
+// replies. The others fail while they are set up. Either way, the suite
+// completes.
+TEST_F(ConnectionTesterTest, Timeout) {
+  ASSERT_TRUE(test_server_.Start());
+
+  ConnectionTester tester(&test_delegate_,
+                          proxy_script_fetcher_context_.get(),
+                          NULL);
+  tester.SetExperimentTimeoutForTesting(base::TimeDelta::FromMilliseconds(50));
+  tester.RunAllTests(test_server_.GetURL("slow?5"));
+
+  // Wait for all the tests to complete.
+  base::MessageLoop::current()->Run();
+
+  const int kNumExperiments =
+      ConnectionTester::PROXY_EXPERIMENT_COUNT *
+      ConnectionTester::HOST_RESOLVER_EXPERIMENT_COUNT;
+
+  EXPECT_EQ(kNumExperiments,
+            test_delegate_.completed_connection_test_experiment_count());
+  EXPECT_LT(0, test_delegate_.timed_out_connection_test_experiment_count());
+  EXPECT_EQ(1, test_delegate_.completed_connection_test_suite_count());
+}
+
 TEST_F(ConnectionTesterTest, DeleteWhileInProgress) {
   ASSERT_TRUE(test_server_.Start());
 
@@ -194,8 +229,10 @@ TEST_F(ConnectionTesterTest, DeleteWhileInProgress) {
   // complete and post a task to run the next experiment before we quit the
   // message loop.
 
+  // The first experiments are all started at once.
   EXPECT_EQ(1, test_delegate_.start_connection_test_suite_count());
-  EXPECT_EQ(1, test_delegate_.start_connection_test_experiment_count());
+  EXPECT_EQ(static_cast<int>(ConnectionTester::kMaxConcurrentExperiments),
+            test_delegate_.start_connection_test_experiment_count());
   EXPECT_EQ(0, test_delegate_.completed_connection_test_experiment_count());
   EXPECT_EQ(0, test_delegate_.completed_connection_test_suite_count());
 
@@ -12,6 +12,7 @@
 #include "base/strings/stringprintf.h"
 #include "base/values.h"
 #include "chrome/browser/chrome_notification_types.h"
+#include "chrome/browser/prefs/scoped_user_pref_update.h"
 #include "chrome/common/pref_names.h"
 #include "components/user_prefs/pref_registry_syncable.h"
 #include "content/public/browser/browser_thread.h"
@@ -41,6 +42,10 @@ const int kMissingVersion = 0;
 // The version number of persisted http_server_properties.
 const int kVersionNumber = 2;
 
+// Every this many updates of the preferences, all entries are rewritten
+// instead of only those of the servers which changed.
+const int kFullPrefsUpdateInterval = 10;
+
 typedef std::vector<std::string> StringVector;
 
 }  // namespace
@@ -51,7 +56,9 @@ typedef std::vector<std::string> StringVector;
 HttpServerPropertiesManager::HttpServerPropertiesManager(
     PrefService* pref_service)
     : pref_service_(pref_service),
-      setting_prefs_(false) {
+      setting_prefs_(false),
+      all_servers_dirty_(false),
+      partial_prefs_updates_(0) {
   DCHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
   DCHECK(pref_service);
   ui_weak_ptr_factory_.reset(
@@ -129,6 +136,7 @@ void HttpServerPropertiesManager::Clear(const base::Closure& completion) {
   DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
 
   http_server_properties_impl_->Clear();
+  all_servers_dirty_ = true;
   UpdatePrefsFromCacheOnIO(completion);
 }
 
@@ -144,7 +152,7 @@ void HttpServerPropertiesManager::SetSupportsSpdy(
   DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
 
   http_server_properties_impl_->SetSupportsSpdy(server, support_spdy);
-  ScheduleUpdatePrefsOnIO();
+  MarkServerDirtyOnIO(server);
 }
 
 bool HttpServerPropertiesManager::HasAlternateProtocol(
@@ -167,14 +175,14 @@ void HttpServerPropertiesManager::SetAlternateProtocol(
   DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
   http_server_properties_impl_->SetAlternateProtocol(
       server, alternate_port, alternate_protocol);
-  ScheduleUpdatePrefsOnIO();
+  MarkServerDirtyOnIO(server);
 }
 
 void HttpServerPropertiesManager::SetBrokenAlternateProtocol(
     const net::HostPortPair& server) {
   DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
   http_server_properties_impl_->SetBrokenAlternateProtocol(server);
-  ScheduleUpdatePrefsOnIO();
+  MarkServerDirtyOnIO(server);
 }
 
 const net::AlternateProtocolMap&
@@ -199,7 +207,7 @@ bool HttpServerPropertiesManager::SetSpdySetting(
   bool persist = http_server_properties_impl_->SetSpdySetting(
       host_port_pair, id, flags, value);
   if (persist)
-    ScheduleUpdatePrefsOnIO();
+    MarkServerDirtyOnIO(host_port_pair);
   return persist;
 }
 
@@ -207,13 +215,13 @@ void HttpServerPropertiesManager::ClearSpdySettings(
     const net::HostPortPair& host_port_pair) {
   DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
   http_server_properties_impl_->ClearSpdySettings(host_port_pair);
-  ScheduleUpdatePrefsOnIO();
+  MarkServerDirtyOnIO(host_port_pair);
 }
 
 void HttpServerPropertiesManager::ClearAllSpdySettings() {
   DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
   http_server_properties_impl_->ClearAllSpdySettings();
-  ScheduleUpdatePrefsOnIO();
+  MarkAllServersDirtyOnIO();
 }
 
 const net::SpdySettingsMap&
@@ -234,13 +242,13 @@ void HttpServerPropertiesManager::SetPipelineCapability(
     net::HttpPipelinedHostCapability capability) {
   DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
   http_server_properties_impl_->SetPipelineCapability(origin, capability);
-  ScheduleUpdatePrefsOnIO();
+  MarkServerDirtyOnIO(origin);
 }
 
 void HttpServerPropertiesManager::ClearPipelineCapabilities() {
   DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
   http_server_properties_impl_->ClearPipelineCapabilities();
-  ScheduleUpdatePrefsOnIO();
+  MarkAllServersDirtyOnIO();
 }
 
 net::PipelineCapabilityMap
@@ -457,7 +465,7 @@ void HttpServerPropertiesManager::UpdateCacheFromPrefsOnIO(
 
   // Update the prefs with what we have read (delete all corrupted prefs).
   if (detected_corrupted_prefs)
-    ScheduleUpdatePrefsOnIO();
+    MarkAllServersDirtyOnIO();
 }
 
 
@@ -491,20 +499,56 @@ void HttpServerPropertiesManager::UpdatePrefsFromCacheOnIO(
   DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
 
   base::ListValue* spdy_server_list = new base::ListValue;
-  http_server_properties_impl_->GetSpdyServerList(spdy_server_list);
-
   net::SpdySettingsMap* spdy_settings_map = new net::SpdySettingsMap;
-  *spdy_settings_map = http_server_properties_impl_->spdy_settings_map();
-
   net::AlternateProtocolMap* alternate_protocol_map =
       new net::AlternateProtocolMap;
-  *alternate_protocol_map =
-      http_server_properties_impl_->alternate_protocol_map();
-
   net::PipelineCapabilityMap* pipeline_capability_map =
       new net::PipelineCapabilityMap;
-  *pipeline_capability_map =
-      http_server_properties_impl_->GetPipelineCapabilityMap();
+
+  // Unless everything has to be rewritten, only send the properties of the
+  // servers which changed.
+  std::set<net::HostPortPair>* dirty_servers = NULL;
+  if (!all_servers_dirty_ &&
+      ++partial_prefs_updates_ < kFullPrefsUpdateInterval) {
+    dirty_servers = new std::set<net::HostPortPair>;
+    dirty_servers->swap(dirty_servers_);
+  } else {
+    partial_prefs_updates_ = 0;
+    all_servers_dirty_ = false;
+    dirty_servers_.clear();
+  }
+
+  if (dirty_servers) {
+    for (std::set<net::HostPortPair>::const_iterator it =
+             dirty_servers->begin();
+         it != dirty_servers->end(); ++it) {
+      const net::HostPortPair& server = *it;
+      if (http_server_properties_impl_->SupportsSpdy(server))
+        spdy_server_list->Append(new base::StringValue(server.ToString()));
+
+      const net::SettingsMap& settings_map =
+          http_server_properties_impl_->GetSpdySettings(server);
+      if (!settings_map.empty())
+        (*spdy_settings_map)[server] = settings_map;
+
+      if (http_server_properties_impl_->HasAlternateProtocol(server)) {
+        (*alternate_protocol_map)[server] =
+            http_server_properties_impl_->GetAlternateProtocol(server);
+      }
+
+      net::HttpPipelinedHostCapability pipeline_capability =
+          http_server_properties_impl_->GetPipelineCapability(server);
+      if (pipeline_capability != net::PIPELINE_UNKNOWN)
+        (*pipeline_capability_map)[server] = pipeline_capability;
+    }
+  } else {
+    http_server_properties_impl_->GetSpdyServerList(spdy_server_list);
+    *spdy_settings_map = http_server_properties_impl_->spdy_settings_map();
+    *alternate_protocol_map =
+        http_server_properties_impl_->alternate_protocol_map();
+    *pipeline_capability_map =
+        http_server_properties_impl_->GetPipelineCapabilityMap();
+  }
 
   // Update the preferences on the UI thread.
   BrowserThread::PostTask(
@@ -516,6 +560,7 @@ void HttpServerPropertiesManager::UpdatePrefsFromCacheOnIO(
                  base::Owned(spdy_settings_map),
                  base::Owned(alternate_protocol_map),
                  base::Owned(pipeline_capability_map),
+                 base::Owned(dirty_servers),
                  completion));
 }
 
@@ -543,14 +588,68 @@ struct ServerPref {
   net::HttpPipelinedHostCapability pipeline_capability;
 };
 
+typedef std::map<net::HostPortPair, ServerPref> ServerPrefMap;
+
+// Adds an entry for each server of |server_pref_map| to |servers_dict|.
+static void AddServerPrefsToDictionary(const ServerPrefMap& server_pref_map,
+                                       base::DictionaryValue* servers_dict) {
+  for (ServerPrefMap::const_iterator map_it =
+       server_pref_map.begin();
+       map_it != server_pref_map.end(); ++map_it) {
+    const net::HostPortPair& server = map_it->first;
+    const ServerPref& server_pref = map_it->second;
+
+    base::DictionaryValue* server_pref_dict = new base::DictionaryValue;
+
+    // Save supports_spdy.
+    server_pref_dict->SetBoolean("supports_spdy", server_pref.supports_spdy);
+
+    // Save SPDY settings.
+    if (server_pref.settings_map) {
+      base::DictionaryValue* spdy_settings_dict = new base::DictionaryValue;
+      for (net::SettingsMap::const_iterator it =
+           server_pref.settings_map->begin();
+           it != server_pref.settings_map->end(); ++it) {
+        net::SpdySettingsIds id = it->first;
+        uint32 value = it->second.second;
+        std::string key = base::StringPrintf("%u", id);
+        spdy_settings_dict->SetInteger(key, value);
+      }
+      server_pref_dict->SetWithoutPathExpansion("settings", spdy_settings_dict);
+    }
+
+    // Save alternate_protocol.
+    if (server_pref.alternate_protocol) {
+      base::DictionaryValue* port_alternate_protocol_dict =
+          new base::DictionaryValue;
+      const net::PortAlternateProtocolPair* port_alternate_protocol =
+          server_pref.alternate_protocol;
+      port_alternate_protocol_dict->SetInteger(
+          "port", port_alternate_protocol->port);
+      const char* protocol_str =
+          net::AlternateProtocolToString(port_alternate_protocol->protocol);
+      port_alternate_protocol_dict->SetString("protocol_str", protocol_str);
+      server_pref_dict->SetWithoutPathExpansion(
+          "alternate_protocol", port_alternate_protocol_dict);
+    }
+
+    if (server_pref.pipeline_capability != net::PIPELINE_UNKNOWN) {
+      server_pref_dict->SetInteger("pipeline_capability",
+                                   server_pref.pipeline_capability);
+    }
+
+    servers_dict->SetWithoutPathExpansion(server.ToString(), server_pref_dict);
+  }
+}
+
 void HttpServerPropertiesManager::UpdatePrefsOnUI(
     base::ListValue* spdy_server_list,
     net::SpdySettingsMap* spdy_settings_map,
     net::AlternateProtocolMap* alternate_protocol_map,
     net::PipelineCapabilityMap* pipeline_capability_map,
+    std::set<net::HostPortPair>* dirty_servers,
     const base::Closure& completion) {
 
-  typedef std::map<net::HostPortPair, ServerPref> ServerPrefMap;
   ServerPrefMap server_pref_map;
 
   DCHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
@@ -625,61 +724,32 @@ void HttpServerPropertiesManager::UpdatePrefsOnUI(
   }
 
   // Persist the prefs::kHttpServerProperties.
-  base::DictionaryValue http_server_properties_dict;
-  base::DictionaryValue* servers_dict = new base::DictionaryValue;
-  for (ServerPrefMap::const_iterator map_it =
-       server_pref_map.begin();
-       map_it != server_pref_map.end(); ++map_it) {
-    const net::HostPortPair& server = map_it->first;
-    const ServerPref& server_pref = map_it->second;
-
-    base::DictionaryValue* server_pref_dict = new base::DictionaryValue;
-
-    // Save supports_spdy.
-    server_pref_dict->SetBoolean("supports_spdy", server_pref.supports_spdy);
-
-    // Save SPDY settings.
-    if (server_pref.settings_map) {
-      base::DictionaryValue* spdy_settings_dict = new base::DictionaryValue;
-      for (net::SettingsMap::const_iterator it =
-           server_pref.settings_map->begin();
-           it != server_pref.settings_map->end(); ++it) {
-        net::SpdySettingsIds id = it->first;
-        uint32 value = it->second.second;
-        std::string key = base::StringPrintf("%u", id);
-        spdy_settings_dict->SetInteger(key, value);
-      }
-      server_pref_dict->SetWithoutPathExpansion("settings", spdy_settings_dict);
-    }
-
-    // Save alternate_protocol.
-    if (server_pref.alternate_protocol) {
-      base::DictionaryValue* port_alternate_protocol_dict =
-          new base::DictionaryValue;
-      const net::PortAlternateProtocolPair* port_alternate_protocol =
-          server_pref.alternate_protocol;
-      port_alternate_protocol_dict->SetInteger(
-          "port", port_alternate_protocol->port);
-      const char* protocol_str =
-          net::AlternateProtocolToString(port_alternate_protocol->protocol);
-      port_alternate_protocol_dict->SetString("protocol_str", protocol_str);
-      server_pref_dict->SetWithoutPathExpansion(
-          "alternate_protocol", port_alternate_protocol_dict);
+  setting_prefs_ = true;
+  if (dirty_servers) {
+    // Replace just the entries of the servers which changed, in place.
+    DictionaryPrefUpdate update(pref_service_, prefs::kHttpServerProperties);
+    base::DictionaryValue* servers_dict = NULL;
+    if (!update->GetDictionaryWithoutPathExpansion("servers", &servers_dict)) {
+      servers_dict = new base::DictionaryValue;
+      update->SetWithoutPathExpansion("servers", servers_dict);
     }
-
-    if (server_pref.pipeline_capability != net::PIPELINE_UNKNOWN) {
-      server_pref_dict->SetInteger("pipeline_capability",
-                                   server_pref.pipeline_capability);
+    for (std::set<net::HostPortPair>::const_iterator it =
+             dirty_servers->begin();
+         it != dirty_servers->end(); ++it) {
+      servers_dict->RemoveWithoutPathExpansion(it->ToString(), NULL);
     }
-
-    servers_dict->SetWithoutPathExpansion(server.ToString(), server_pref_dict);
+    AddServerPrefsToDictionary(server_pref_map, servers_dict);
+    SetVersion(update.Get(), kVersionNumber);
+  } else {
+    base::DictionaryValue http_server_properties_dict;
+    base::DictionaryValue* servers_dict = new base::DictionaryValue;
+    AddServerPrefsToDictionary(server_pref_map, servers_dict);
+    http_server_properties_dict.SetWithoutPathExpansion("servers",
+                                                        servers_dict);
+    SetVersion(&http_server_properties_dict, kVersionNumber);
+    pref_service_->Set(prefs::kHttpServerProperties,
+                       http_server_properties_dict);
   }
-
-  http_server_properties_dict.SetWithoutPathExpansion("servers", servers_dict);
-  SetVersion(&http_server_properties_dict, kVersionNumber);
-  setting_prefs_ = true;
-  pref_service_->Set(prefs::kHttpServerProperties,
-                     http_server_properties_dict);
   setting_prefs_ = false;
 
   // Note that |completion| will be fired after we have written everything to
@@ -690,6 +760,19 @@ void HttpServerPropertiesManager::UpdatePrefsOnUI(
     completion.Run();
 }
 
+void HttpServerPropertiesManager::MarkServerDirtyOnIO(
+    const net::HostPortPair& server) {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
+  dirty_servers_.insert(server);
+  ScheduleUpdatePrefsOnIO();
+}
+
+void HttpServerPropertiesManager::MarkAllServersDirtyOnIO() {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
+  all_servers_dirty_ = true;
+  ScheduleUpdatePrefsOnIO();
+}
+
 void HttpServerPropertiesManager::OnHttpServerPropertiesChanged() {
   DCHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
   if (!setting_prefs_)
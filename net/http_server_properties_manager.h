@@ -5,6 +5,7 @@
 #ifndef CHROME_BROWSER_NET_HTTP_SERVER_PROPERTIES_MANAGER_H_
 #define CHROME_BROWSER_NET_HTTP_SERVER_PROPERTIES_MANAGER_H_
 
+#include <set>
 #include <string>
 #include <vector>
 #include "base/basictypes.h"
@@ -197,18 +198,27 @@ class HttpServerPropertiesManager
   // when finished. Virtual for testing.
   virtual void UpdatePrefsFromCacheOnIO(const base::Closure& completion);
 
-  // Update prefs::kHttpServerProperties preferences on UI thread. Executes an
-  // optional |completion| callback when finished. Protected for testing.
+  // Update prefs::kHttpServerProperties preferences on UI thread. If
+  // |dirty_servers| is NULL, the preferences are rewritten with the given
+  // data. Otherwise only the entries of |dirty_servers| are replaced by the
+  // given data, which covers just those servers. Executes an optional
+  // |completion| callback when finished. Protected for testing.
   void UpdatePrefsOnUI(
       base::ListValue* spdy_server_list,
       net::SpdySettingsMap* spdy_settings_map,
       net::AlternateProtocolMap* alternate_protocol_map,
       net::PipelineCapabilityMap* pipeline_capability_map,
+      std::set<net::HostPortPair>* dirty_servers,
       const base::Closure& completion);
 
  private:
   void OnHttpServerPropertiesChanged();
 
+  // Records that the properties of |server|, or of all servers, changed, and
+  // schedules an update of the preferences.
+  void MarkServerDirtyOnIO(const net::HostPortPair& server);
+  void MarkAllServersDirtyOnIO();
+
   // ---------
   // UI thread
   // ---------
@@ -242,6 +252,15 @@ class HttpServerPropertiesManager
 
   scoped_ptr<net::HttpServerPropertiesImpl> http_server_properties_impl_;
 
+  // The servers whose properties changed since the preferences were last
+  // updated, so that only their entries have to be sent to the UI thread and
+  // rewritten. All entries are rewritten instead when |all_servers_dirty_| is
+  // set, and every few updates, to drop the entries of servers which
+  // |http_server_properties_impl_| no longer remembers.
+  std::set<net::HostPortPair> dirty_servers_;
+  bool all_servers_dirty_;
+  int partial_prefs_updates_;
+
   DISALLOW_COPY_AND_ASSIGN(HttpServerPropertiesManager);
 };
 
@@ -67,11 +67,12 @@ class TestingHttpServerPropertiesManager : public HttpServerPropertiesManager {
                     net::AlternateProtocolMap* alternate_protocol_map,
                     net::PipelineCapabilityMap* pipeline_capability_map,
                     bool detected_corrupted_prefs));
-  MOCK_METHOD4(UpdatePrefsOnUI,
+  MOCK_METHOD5(UpdatePrefsOnUI,
                void(base::ListValue* spdy_server_list,
                     net::SpdySettingsMap* spdy_settings_map,
                     net::AlternateProtocolMap* alternate_protocol_map,
-                    net::PipelineCapabilityMap* pipeline_capability_map));
+                    net::PipelineCapabilityMap* pipeline_capability_map,
+                    std::set<net::HostPortPair>* dirty_servers));
 
  private:
   DISALLOW_COPY_AND_ASSIGN(TestingHttpServerPropertiesManager);
@@ -461,6 +462,36 @@ TEST_F(HttpServerPropertiesManagerTest, Clear) {
   Mock::VerifyAndClearExpectations(http_server_props_manager_.get());
 }
 
+TEST_F(HttpServerPropertiesManagerTest, UpdatePrefsOfChangedServers) {
+  ExpectPrefsUpdateRepeatedly();
+
+  net::HostPortPair spdy_server_mail("mail.google.com", 443);
+  net::HostPortPair spdy_server_docs("docs.google.com", 443);
+  http_server_props_manager_->SetSupportsSpdy(spdy_server_mail, true);
+  loop_.RunUntilIdle();
+  http_server_props_manager_->SetSupportsSpdy(spdy_server_docs, true);
+  loop_.RunUntilIdle();
+
+  // The second update only rewrote the entry of docs.google.com, and kept the
+  // one of mail.google.com.
+  const base::DictionaryValue* servers_dict = NULL;
+  ASSERT_TRUE(pref_service_.GetDictionary(prefs::kHttpServerProperties)->
+      GetDictionaryWithoutPathExpansion("servers", &servers_dict));
+  EXPECT_EQ(2u, servers_dict->size());
+  EXPECT_TRUE(servers_dict->HasKey(spdy_server_mail.ToString()));
+  EXPECT_TRUE(servers_dict->HasKey(spdy_server_docs.ToString()));
+
+  // A server without any properties left loses its entry.
+  http_server_props_manager_->SetSupportsSpdy(spdy_server_mail, false);
+  loop_.RunUntilIdle();
+  ASSERT_TRUE(pref_service_.GetDictionary(prefs::kHttpServerProperties)->
+      GetDictionaryWithoutPathExpansion("servers", &servers_dict));
+  EXPECT_EQ(1u, servers_dict->size());
+  EXPECT_TRUE(servers_dict->HasKey(spdy_server_docs.ToString()));
+
+  Mock::VerifyAndClearExpectations(http_server_props_manager_.get());
+}
+
 TEST_F(HttpServerPropertiesManagerTest, ShutdownWithPendingUpdateCache0) {
   // Post an update task to the UI thread.
   http_server_props_manager_->ScheduleUpdateCacheOnUI();
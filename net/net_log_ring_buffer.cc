@@ -0,0 +1,93 @@
+// Copyright 2013 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "chrome/browser/net/net_log_ring_buffer.h"
+
+#include "base/logging.h"
+#include "base/values.h"
+
+NetLogRingBuffer::RecentEntry::RecentEntry(const net::NetLog::Entry& entry,
+                                           base::TimeTicks time)
+    : source_(entry.source()),
+      type_(entry.type()),
+      phase_(entry.phase()),
+      time_(time),
+      params_(entry.ParametersToValue()) {
+}
+
+NetLogRingBuffer::RecentEntry::~RecentEntry() {}
+
+base::Value* NetLogRingBuffer::RecentEntry::ToValue() const {
+  // Mirrors net::NetLog::Entry::ToValue().
+  base::DictionaryValue* entry_dict = new base::DictionaryValue();
+  entry_dict->SetString("time", net::NetLog::TickCountToString(time_));
+  entry_dict->Set("source", source_.ToValue());
+  entry_dict->SetInteger("type", static_cast<int>(type_));
+  entry_dict->SetInteger("phase", static_cast<int>(phase_));
+  if (params_)
+    entry_dict->Set("params", params_->DeepCopy());
+  return entry_dict;
+}
+
+NetLogRingBuffer::NetLogRingBuffer(size_t max_entries)
+    : max_entries_(max_entries),
+      oldest_entry_(0),
+      off_the_record_sessions_(0) {
+  DCHECK_GT(max_entries_, 0u);
+}
+
+NetLogRingBuffer::~NetLogRingBuffer() {
+  DCHECK(!net_log());
+}
+
+void NetLogRingBuffer::StartObserving(net::NetLog* net_log) {
+  net_log->AddThreadSafeObserver(this, net::NetLog::LOG_BASIC);
+}
+
+void NetLogRingBuffer::StopObserving() {
+  net_log()->RemoveThreadSafeObserver(this);
+}
+
+void NetLogRingBuffer::OnOffTheRecordSessionStarted() {
+  base::AutoLock lock(lock_);
+  ++off_the_record_sessions_;
+}
+
+void NetLogRingBuffer::OnOffTheRecordSessionEnded() {
+  base::AutoLock lock(lock_);
+  DCHECK_GT(off_the_record_sessions_, 0);
+  --off_the_record_sessions_;
+}
+
+base::ListValue* NetLogRingBuffer::GetEntries() const {
+  // Only take references under the lock, and build the values after
+  // releasing it, so that logging is not held up while saving.
+  std::vector<scoped_refptr<RecentEntry> > entries;
+  {
+    base::AutoLock lock(lock_);
+    entries.reserve(entries_.size());
+    for (size_t i = 0; i < entries_.size(); ++i)
+      entries.push_back(entries_[(oldest_entry_ + i) % entries_.size()]);
+  }
+
+  base::ListValue* list = new base::ListValue;
+  for (size_t i = 0; i < entries.size(); ++i)
+    list->Append(entries[i]->ToValue());
+  return list;
+}
+
+void NetLogRingBuffer::OnAddEntry(const net::NetLog::Entry& entry) {
+  // Build the entry before taking the lock, to keep the lock held briefly.
+  scoped_refptr<RecentEntry> recent_entry(
+      new RecentEntry(entry, base::TimeTicks::Now()));
+  base::AutoLock lock(lock_);
+  if (off_the_record_sessions_ > 0)
+    return;
+  if (entries_.size() < max_entries_) {
+    entries_.push_back(recent_entry);
+    return;
+  }
+  entries_[oldest_entry_] = recent_entry;
+  oldest_entry_ = (oldest_entry_ + 1) % max_entries_;
+}
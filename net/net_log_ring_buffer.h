@@ -0,0 +1,99 @@
+// Copyright 2013 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CHROME_BROWSER_NET_NET_LOG_RING_BUFFER_H_
+#define CHROME_BROWSER_NET_NET_LOG_RING_BUFFER_H_
+
+#include <vector>
+
+#include "base/basictypes.h"
+#include "base/compiler_specific.h"
+#include "base/memory/ref_counted.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/synchronization/lock.h"
+#include "base/time/time.h"
+#include "net/base/net_log.h"
+
+namespace base {
+class ListValue;
+class Value;
+}
+
+// NetLogRingBuffer keeps the most recent NetLog entries in memory, so that the
+// events leading up to a problem can be exported after the fact, without a
+// NetLogLogger having written every event to a file all along.
+//
+// Entries are observed at LOG_BASIC, so neither the transferred bytes nor
+// cookies and credentials are kept. Once |max_entries| entries are buffered,
+// each new entry replaces the oldest one. Only the parameters of an entry are
+// built as a Value when it is added; the dictionary a NetLogLogger writes is
+// built by GetEntries(), off the thread that logged the entry.
+//
+// NetLog sources do not say which profile they belong to, so no entries are
+// kept at all while an off-the-record profile is in use.
+//
+// All methods may be called on any thread.
+class NetLogRingBuffer : public net::NetLog::ThreadSafeObserver {
+ public:
+  explicit NetLogRingBuffer(size_t max_entries);
+  virtual ~NetLogRingBuffer();
+
+  void StartObserving(net::NetLog* net_log);
+  void StopObserving();
+
+  // Called when an off-the-record profile starts and stops using the NetLog.
+  // Entries are dropped as long as at least one of them is in use.
+  void OnOffTheRecordSessionStarted();
+  void OnOffTheRecordSessionEnded();
+
+  // Returns a list of the buffered entries, oldest first, in the format a
+  // NetLogLogger writes them. The caller takes ownership.
+  base::ListValue* GetEntries() const;
+
+  // net::NetLog::ThreadSafeObserver implementation:
+  virtual void OnAddEntry(const net::NetLog::Entry& entry) OVERRIDE;
+
+ private:
+  // The raw fields of an entry. Immutable once created, so that GetEntries()
+  // can share them with the buffer rather than copy them under |lock_|.
+  class RecentEntry : public base::RefCountedThreadSafe<RecentEntry> {
+   public:
+    RecentEntry(const net::NetLog::Entry& entry, base::TimeTicks time);
+
+    // Returns the entry as a NetLogLogger writes it. The caller takes
+    // ownership.
+    base::Value* ToValue() const;
+
+   private:
+    friend class base::RefCountedThreadSafe<RecentEntry>;
+
+    ~RecentEntry();
+
+    const net::NetLog::Source source_;
+    const net::NetLog::EventType type_;
+    const net::NetLog::EventPhase phase_;
+    const base::TimeTicks time_;
+    // NULL if the entry has no parameters.
+    const scoped_ptr<base::Value> params_;
+
+    DISALLOW_COPY_AND_ASSIGN(RecentEntry);
+  };
+
+  const size_t max_entries_;
+
+  // Protects the members below.
+  mutable base::Lock lock_;
+
+  // The buffered entries. Once there are |max_entries_| of them, the oldest
+  // one is at |oldest_entry_| and is the next one to be replaced.
+  std::vector<scoped_refptr<RecentEntry> > entries_;
+  size_t oldest_entry_;
+
+  // The number of off-the-record profiles using the NetLog.
+  int off_the_record_sessions_;
+
+  DISALLOW_COPY_AND_ASSIGN(NetLogRingBuffer);
+};
+
+#endif  // CHROME_BROWSER_NET_NET_LOG_RING_BUFFER_H_
@@ -0,0 +1,65 @@
+// Copyright 2013 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Benchmarks the overhead |NetLogRingBuffer| adds to each NetLog event, which
+// is paid on the IO thread whether or not the entries are ever exported, and
+// the time taken to export a full buffer. Results are printed in the
+// perf_test RESULT format so that they can be tracked by the perf bots.
+
+#include <string>
+
+#include "base/memory/scoped_ptr.h"
+#include "base/strings/stringprintf.h"
+#include "base/time/time.h"
+#include "base/values.h"
+#include "chrome/browser/net/net_log_ring_buffer.h"
+#include "net/base/net_log.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_test.h"
+
+using base::TimeTicks;
+
+namespace {
+
+// The size of the buffer ChromeNetLog uses.
+const size_t kMaxEntries = 5000;
+
+// The number of events timed per benchmark.
+const int kNumEvents = 100000;
+
+// Adds |kNumEvents| events with parameters, as a URL request logs them, and
+// returns the time per event in microseconds.
+double TimeEvents(net::NetLog* net_log) {
+  net::BoundNetLog bound_net_log =
+      net::BoundNetLog::Make(net_log, net::NetLog::SOURCE_URL_REQUEST);
+  const TimeTicks start = TimeTicks::Now();
+  for (int i = 0; i < kNumEvents; ++i)
+    bound_net_log.AddEventWithNetErrorCode(net::NetLog::TYPE_FAILED, -2);
+  return (TimeTicks::Now() - start).InMicrosecondsF() / kNumEvents;
+}
+
+}  // namespace
+
+TEST(NetLogRingBufferPerfTest, AddEntry) {
+  // Without any observer, NetLog does not even build the entries.
+  net::NetLog net_log;
+  perf_test::PrintResult("NetLogAddEntry", std::string(), "no_observer",
+                         TimeEvents(&net_log), "us", true);
+
+  NetLogRingBuffer ring_buffer(kMaxEntries);
+  ring_buffer.StartObserving(&net_log);
+  perf_test::PrintResult("NetLogAddEntry", std::string(), "ring_buffer",
+                         TimeEvents(&net_log), "us", true);
+
+  const TimeTicks start = TimeTicks::Now();
+  scoped_ptr<base::ListValue> entries(ring_buffer.GetEntries());
+  perf_test::PrintResult("NetLogRingBufferGetEntries", std::string(),
+                         base::StringPrintf("%d_entries",
+                                            static_cast<int>(kMaxEntries)),
+                         (TimeTicks::Now() - start).InMillisecondsF(), "ms",
+                         true);
+  EXPECT_EQ(kMaxEntries, entries->GetSize());
+
+  ring_buffer.StopObserving();
+}
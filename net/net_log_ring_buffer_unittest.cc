@@ -0,0 +1,91 @@
+// Copyright 2013 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "chrome/browser/net/net_log_ring_buffer.h"
+
+#include <string>
+
+#include "base/memory/scoped_ptr.h"
+#include "base/values.h"
+#include "net/base/net_log.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace {
+
+int GetEntryType(const base::ListValue& entries, size_t index) {
+  const base::DictionaryValue* entry = NULL;
+  int type = -1;
+  EXPECT_TRUE(entries.GetDictionary(index, &entry));
+  EXPECT_TRUE(entry->GetInteger("type", &type));
+  return type;
+}
+
+}  // namespace
+
+TEST(NetLogRingBufferTest, KeepsMostRecentEntries) {
+  net::NetLog net_log;
+  NetLogRingBuffer ring_buffer(2);
+  ring_buffer.StartObserving(&net_log);
+
+  net_log.AddGlobalEntry(net::NetLog::TYPE_CANCELLED);
+  scoped_ptr<base::ListValue> entries(ring_buffer.GetEntries());
+  ASSERT_EQ(1u, entries->GetSize());
+  EXPECT_EQ(net::NetLog::TYPE_CANCELLED, GetEntryType(*entries, 0));
+
+  net_log.AddGlobalEntry(net::NetLog::TYPE_FAILED);
+  net_log.AddGlobalEntry(net::NetLog::TYPE_REQUEST_ALIVE);
+  entries.reset(ring_buffer.GetEntries());
+  ASSERT_EQ(2u, entries->GetSize());
+  EXPECT_EQ(net::NetLog::TYPE_FAILED, GetEntryType(*entries, 0));
+  EXPECT_EQ(net::NetLog::TYPE_REQUEST_ALIVE, GetEntryType(*entries, 1));
+
+  ring_buffer.StopObserving();
+}
+
+TEST(NetLogRingBufferTest, KeepsParameters) {
+  net::NetLog net_log;
+  NetLogRingBuffer ring_buffer(2);
+  ring_buffer.StartObserving(&net_log);
+
+  net::BoundNetLog bound_net_log = net::BoundNetLog::Make(
+      &net_log, net::NetLog::SOURCE_URL_REQUEST);
+  bound_net_log.AddEventWithNetErrorCode(net::NetLog::TYPE_FAILED, -2);
+
+  scoped_ptr<base::ListValue> entries(ring_buffer.GetEntries());
+  ASSERT_EQ(1u, entries->GetSize());
+  const base::DictionaryValue* entry = NULL;
+  ASSERT_TRUE(entries->GetDictionary(0, &entry));
+  std::string time;
+  EXPECT_TRUE(entry->GetString("time", &time));
+  int source_id = -1;
+  EXPECT_TRUE(entry->GetInteger("source.id", &source_id));
+  EXPECT_EQ(static_cast<int>(bound_net_log.source().id), source_id);
+  int net_error = 0;
+  EXPECT_TRUE(entry->GetInteger("params.net_error", &net_error));
+  EXPECT_EQ(-2, net_error);
+
+  ring_buffer.StopObserving();
+}
+
+TEST(NetLogRingBufferTest, DropsEntriesWhileOffTheRecord) {
+  net::NetLog net_log;
+  NetLogRingBuffer ring_buffer(10);
+  ring_buffer.StartObserving(&net_log);
+
+  net_log.AddGlobalEntry(net::NetLog::TYPE_CANCELLED);
+  ring_buffer.OnOffTheRecordSessionStarted();
+  ring_buffer.OnOffTheRecordSessionStarted();
+  net_log.AddGlobalEntry(net::NetLog::TYPE_FAILED);
+  ring_buffer.OnOffTheRecordSessionEnded();
+  net_log.AddGlobalEntry(net::NetLog::TYPE_FAILED);
+  ring_buffer.OnOffTheRecordSessionEnded();
+  net_log.AddGlobalEntry(net::NetLog::TYPE_REQUEST_ALIVE);
+
+  scoped_ptr<base::ListValue> entries(ring_buffer.GetEntries());
+  ASSERT_EQ(2u, entries->GetSize());
+  EXPECT_EQ(net::NetLog::TYPE_CANCELLED, GetEntryType(*entries, 0));
+  EXPECT_EQ(net::NetLog::TYPE_REQUEST_ALIVE, GetEntryType(*entries, 1));
+
+  ring_buffer.StopObserving();
+}
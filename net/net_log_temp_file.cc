@@ -5,8 +5,10 @@
 #include "chrome/browser/net/net_log_temp_file.h"
 
 #include "base/file_util.h"
+#include "base/json/json_writer.h"
 #include "base/values.h"
 #include "chrome/browser/net/chrome_net_log.h"
+#include "chrome/browser/net/net_log_ring_buffer.h"
 #include "chrome/browser/ui/webui/net_internals/net_internals_ui.h"
 #include "content/public/browser/browser_thread.h"
 #include "net/base/net_log_logger.h"
@@ -36,6 +38,9 @@ void NetLogTempFile::ProcessCommand(Command command) {
     case DO_STOP:
       StopNetLog();
       break;
+    case DO_SAVE_RECENT:
+      SaveRecentNetLog();
+      break;
     default:
       NOTREACHED();
       break;
@@ -116,6 +121,28 @@ void NetLogTempFile::StopNetLog() {
   state_ = STATE_ALLOW_START_SEND;
 }
 
+void NetLogTempFile::SaveRecentNetLog() {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::FILE_USER_BLOCKING));
+  if (state_ == STATE_ALLOW_STOP)
+    return;
+
+  DCHECK_NE(STATE_UNINITIALIZED, state_);
+  DCHECK(!log_path_.empty());
+
+  // Write the same format as a NetLogLogger, so that the file can be loaded
+  // in net-internals just the same.
+  base::DictionaryValue log;
+  log.Set("constants", NetInternalsUI::GetConstants());
+  log.Set("events", chrome_net_log_->net_log_ring_buffer()->GetEntries());
+  std::string json;
+  base::JSONWriter::Write(&log, &json);
+  if (file_util::WriteFile(log_path_, json.data(), json.size()) !=
+      static_cast<int>(json.size())) {
+    return;
+  }
+  state_ = STATE_ALLOW_START_SEND;
+}
+
 bool NetLogTempFile::GetFilePath(base::FilePath* path) {
   DCHECK(BrowserThread::CurrentlyOn(BrowserThread::FILE_USER_BLOCKING));
   if (state_ != STATE_ALLOW_START_SEND)
@@ -24,6 +24,8 @@ class ChromeNetLog;
 
 // NetLogTempFile logs all the NetLog entries into a temporary file
 // "chrome-net-export-log.json" created in file_util::GetTempDir() directory.
+// Instead of logging from now on, it can also save the recent entries kept by
+// the NetLogRingBuffer of ChromeNetLog into that file.
 //
 // NetLogTempFile maintains the current state (state_) of the logging into a
 // chrome-net-export-log.json file.
@@ -32,6 +34,7 @@ class ChromeNetLog;
 // a) Only Start is allowed (state_ == STATE_UNINITIALIZED).
 // b) Only Stop is allowed (state_ == STATE_ALLOW_STOP).
 // c) Either Send or Start is allowed (state_ == STATE_ALLOW_START_SEND).
+// Saving the recent entries is allowed whenever Start is.
 //
 // This is created/destroyed on the UI thread, but all other function calls
 // occur on the FILE_USER_BLOCKING thread.
@@ -42,8 +45,9 @@ class NetLogTempFile {
  public:
   // This enum lists the UI button commands it could receive.
   enum Command {
-    DO_START,  // Call StartLog.
-    DO_STOP,   // Call StopLog.
+    DO_START,        // Call StartLog.
+    DO_STOP,         // Call StopLog.
+    DO_SAVE_RECENT,  // Call SaveRecentNetLog.
   };
 
   virtual ~NetLogTempFile();  // Destructs a NetLogTempFile.
@@ -83,6 +87,7 @@ class NetLogTempFile {
   FRIEND_TEST_ALL_PREFIXES(NetLogTempFileTest, ProcessCommandDoStartAndStop);
   FRIEND_TEST_ALL_PREFIXES(NetLogTempFileTest, DoStartClearsFile);
   FRIEND_TEST_ALL_PREFIXES(NetLogTempFileTest, CheckAddEvent);
+  FRIEND_TEST_ALL_PREFIXES(NetLogTempFileTest, SaveRecentEvents);
 
   // This enum lists the possible state NetLogTempFile could be in. It is used
   // to enable/disable "Start", "Stop" and "Send" (email) UI actions.
@@ -108,6 +113,10 @@ class NetLogTempFile {
   // are not collecting data into a file.
   void StopNetLog();
 
+  // Writes the recent NetLog entries into the temporary file, replacing its
+  // contents. It is a no-op if we are collecting data into the file.
+  void SaveRecentNetLog();
+
   // Updates |log_path_| with base::FilePath to |log_filename_| in the
   // file_util::GetTempDir() directory. Returns false if file_util::GetTempDir()
   // fails.
@@ -7,6 +7,7 @@
 #include "base/basictypes.h"
 #include "base/file_util.h"
 #include "base/files/file_path.h"
+#include "base/json/json_reader.h"
 #include "base/message_loop/message_loop.h"
 #include "base/values.h"
 #include "build/build_config.h"
@@ -285,3 +286,27 @@ TEST_F(NetLogTempFileTest, CheckAddEvent) {
   EXPECT_TRUE(file_util::GetFileSize(net_export_log_, &new_stop_file_size));
   EXPECT_GE(new_stop_file_size, stop_file_size);
 }
+
+TEST_F(NetLogTempFileTest, SaveRecentEvents) {
+  // Entries are buffered even though nothing is logging to the file.
+  net_log_->AddGlobalEntry(net::NetLog::TYPE_CANCELLED);
+
+  net_log_temp_file_->ProcessCommand(NetLogTempFile::DO_SAVE_RECENT);
+  VerifyFileAndStateAfterDoStop();
+
+  std::string contents;
+  ASSERT_TRUE(base::ReadFileToString(net_export_log_, &contents));
+  scoped_ptr<base::Value> value(base::JSONReader::Read(contents));
+  base::DictionaryValue* dict = NULL;
+  ASSERT_TRUE(value && value->GetAsDictionary(&dict));
+  EXPECT_TRUE(dict->HasKey("constants"));
+  base::ListValue* events = NULL;
+  ASSERT_TRUE(dict->GetList("events", &events));
+  EXPECT_GE(events->GetSize(), 1u);
+
+  // Saving is a no-op while logging to the file.
+  net_log_temp_file_->ProcessCommand(NetLogTempFile::DO_START);
+  net_log_temp_file_->ProcessCommand(NetLogTempFile::DO_SAVE_RECENT);
+  VerifyFileAndStateAfterDoStart();
+  net_log_temp_file_->ProcessCommand(NetLogTempFile::DO_STOP);
+}
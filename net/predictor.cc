@@ -17,6 +17,7 @@
 #include "base/metrics/histogram.h"
 #include "base/prefs/pref_service.h"
 #include "base/stl_util.h"
+#include "base/strings/string_number_conversions.h"
 #include "base/strings/string_split.h"
 #include "base/strings/string_util.h"
 #include "base/strings/stringprintf.h"
@@ -31,6 +32,7 @@
 #include "chrome/common/chrome_switches.h"
 #include "chrome/common/pref_names.h"
 #include "components/user_prefs/pref_registry_syncable.h"
+#include "components/variations/variations_associated_data.h"
 #include "content/public/browser/browser_thread.h"
 #include "net/base/address_list.h"
 #include "net/base/completion_callback.h"
@@ -65,8 +67,10 @@ const double Predictor::kReferrerTrimRatio = 0.97153;
 const int64 Predictor::kDurationBetweenTrimmingsHours = 1;
 const int64 Predictor::kDurationBetweenTrimmingIncrementsSeconds = 15;
 const size_t Predictor::kUrlsTrimmedPerIncrement = 5u;
+const size_t Predictor::kMaxReferrers = 1000u;
 const size_t Predictor::kMaxSpeculativeParallelResolves = 3;
 const int Predictor::kMaxUnusedSocketLifetimeSecondsWithoutAGet = 10;
+const size_t Predictor::kDefaultMaxRecentlySeenHosts = 1000u;
 // To control our congestion avoidance system, which discards a queue when
 // resolutions are "taking too long," we need an expected resolution time.
 // Common average is in the range of 300-500ms.
@@ -172,12 +176,19 @@ class Predictor::PreconnectUsage {
     bool was_used_;
   };
 
+  // Removes the eldest entry from mru_preconnects_, and records whether it
+  // was used.
+  void EvictEldestPreconnect();
+
   typedef base::MRUCache<GURL, PreconnectPrecisionStat> MRUPreconnects;
   MRUPreconnects mru_preconnects_;
 
   // The longest time an entry can persist in mru_preconnect_
   const base::TimeDelta max_duration_;
 
+  // The most entries mru_preconnects_ can hold.
+  const size_t max_size_;
+
   std::vector<GURL> recent_navigation_chain_;
 
   DISALLOW_COPY_AND_ASSIGN(PreconnectUsage);
@@ -186,7 +197,8 @@ class Predictor::PreconnectUsage {
 Predictor::PreconnectUsage::PreconnectUsage()
     : mru_preconnects_(MRUPreconnects::NO_AUTO_EVICT),
       max_duration_(base::TimeDelta::FromSeconds(
-          Predictor::kMaxUnusedSocketLifetimeSecondsWithoutAGet)) {
+          Predictor::kMaxUnusedSocketLifetimeSecondsWithoutAGet)),
+      max_size_(Predictor::GetMaxRecentlySeenHosts()) {
 }
 
 Predictor::PreconnectUsage::~PreconnectUsage() {}
@@ -194,24 +206,28 @@ Predictor::PreconnectUsage::~PreconnectUsage() {}
 void Predictor::PreconnectUsage::ObservePreconnect(const GURL& url) {
   // Evict any overly old entries and record stats.
   base::TimeTicks now = base::TimeTicks::Now();
-
-  MRUPreconnects::reverse_iterator eldest_preconnect =
-      mru_preconnects_.rbegin();
-  while (!mru_preconnects_.empty()) {
-    DCHECK(eldest_preconnect == mru_preconnects_.rbegin());
-    if (now - eldest_preconnect->second.timestamp() < max_duration_)
-      break;
-
-    UMA_HISTOGRAM_BOOLEAN("Net.PreconnectTriggerUsed",
-                          eldest_preconnect->second.was_used());
-    eldest_preconnect = mru_preconnects_.Erase(eldest_preconnect);
+  while (!mru_preconnects_.empty() &&
+         now - mru_preconnects_.rbegin()->second.timestamp() >= max_duration_) {
+    EvictEldestPreconnect();
   }
 
-  // Add new entry.
+  // Add new entry, making room for it if needed.
   GURL canonical_url(Predictor::CanonicalizeUrl(url));
+  if (mru_preconnects_.Peek(canonical_url) == mru_preconnects_.end()) {
+    while (mru_preconnects_.size() >= max_size_)
+      EvictEldestPreconnect();
+  }
   mru_preconnects_.Put(canonical_url, PreconnectPrecisionStat());
 }
 
+void Predictor::PreconnectUsage::EvictEldestPreconnect() {
+  MRUPreconnects::reverse_iterator eldest_preconnect =
+      mru_preconnects_.rbegin();
+  UMA_HISTOGRAM_BOOLEAN("Net.PreconnectTriggerUsed",
+                        eldest_preconnect->second.was_used());
+  mru_preconnects_.Erase(eldest_preconnect);
+}
+
 void Predictor::PreconnectUsage::ObserveNavigationChain(
     const std::vector<GURL>& url_chain,
     bool is_subresource) {
@@ -259,12 +275,23 @@ void Predictor::PreconnectUsage::ObserveLinkNavigation(const GURL& url) {
   UMA_HISTOGRAM_BOOLEAN("Net.PreconnectedLinkNavigations", did_use_preconnect);
 }
 
+// static
+size_t Predictor::GetMaxRecentlySeenHosts() {
+  std::string value = chrome_variations::GetVariationParamValue(
+      "NetworkPredictorCaches", "max_recently_seen_hosts");
+  unsigned max_hosts;
+  if (!value.empty() && base::StringToUint(value, &max_hosts) && max_hosts > 0)
+    return max_hosts;
+  return kDefaultMaxRecentlySeenHosts;
+}
+
 Predictor::Predictor(bool preconnect_enabled)
     : url_request_context_getter_(NULL),
       predictor_enabled_(true),
       peak_pending_lookups_(0),
       shutdown_(false),
       max_concurrent_dns_lookups_(g_max_parallel_resolves),
+      parallel_resolves_limit_(max_concurrent_dns_lookups_),
       max_dns_queue_delay_(
           TimeDelta::FromMilliseconds(g_max_queueing_delay_ms)),
       host_resolver_(NULL),
@@ -273,6 +300,9 @@ Predictor::Predictor(bool preconnect_enabled)
       next_trim_time_(base::TimeTicks::Now() +
                       TimeDelta::FromHours(kDurationBetweenTrimmingsHours)) {
   DCHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
+  std::fill(found_resolves_, found_resolves_ + arraysize(found_resolves_), 0);
+  std::fill(useful_resolves_, useful_resolves_ + arraysize(useful_resolves_),
+            0);
 }
 
 Predictor::~Predictor() {
@@ -577,7 +607,8 @@ void Predictor::LearnFromNavigation(const GURL& referring_url,
   DCHECK_EQ(target_url, Predictor::CanonicalizeUrl(target_url));
   DCHECK_NE(target_url, GURL::EmptyGURL());
 
-  referrers_[referring_url].SuggestHost(target_url);
+  RecordResolveUse(target_url);
+  GetOrAddReferrer(referring_url)->SuggestHost(target_url);
   // Possibly do some referrer trimming.
   TrimReferrers();
 }
@@ -677,12 +708,61 @@ void Predictor::GetHtmlReferrerLists(std::string* output) {
   output->append("</table>");
 }
 
+static const char* GetMotivationName(
+    UrlInfo::ResolutionMotivation motivation) {
+  switch (motivation) {
+    case UrlInfo::MOUSE_OVER_MOTIVATED:
+      return "mouse-over";
+    case UrlInfo::PAGE_SCAN_MOTIVATED:
+      return "page scan";
+    case UrlInfo::OMNIBOX_MOTIVATED:
+      return "omnibox";
+    case UrlInfo::STARTUP_LIST_MOTIVATED:
+      return "startup list";
+    case UrlInfo::EARLY_LOAD_MOTIVATED:
+      return "early load";
+    case UrlInfo::STATIC_REFERAL_MOTIVATED:
+      return "static referrer";
+    case UrlInfo::LEARNED_REFERAL_MOTIVATED:
+      return "learned referrer";
+    case UrlInfo::SELF_REFERAL_MOTIVATED:
+      return "self referrer";
+    default:
+      return "other";
+  }
+}
+
+void Predictor::GetHtmlResolveUsefulness(std::string* output) {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
+  base::StringAppendF(output,
+                      "<br>Speculative lookups allowed in parallel: %d of %d"
+                      "<br><table border>",
+                      static_cast<int>(parallel_resolves_limit_),
+                      static_cast<int>(max_concurrent_dns_lookups_));
+  output->append(
+      "<tr><th>Motivation</th>"
+      "<th>Resolved</th>"
+      "<th>Useful</th>"
+      "<th>Wasted</th></tr>");
+  for (int i = 0; i < UrlInfo::MAX_MOTIVATED; ++i) {
+    if (!found_resolves_[i])
+      continue;
+    base::StringAppendF(output,
+        "<tr align=right><td>%s</td><td>%d</td><td>%d</td><td>%d</td></tr>",
+        GetMotivationName(static_cast<UrlInfo::ResolutionMotivation>(i)),
+        found_resolves_[i], useful_resolves_[i],
+        found_resolves_[i] - useful_resolves_[i]);
+  }
+  output->append("</table>");
+}
+
 void Predictor::GetHtmlInfo(std::string* output) {
   DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
   if (initial_observer_.get())
     initial_observer_->GetFirstResolutionsHtml(output);
   // Show list of subresource predictions and stats.
   GetHtmlReferrerLists(output);
+  GetHtmlResolveUsefulness(output);
 
   // Local lists for calling UrlInfo
   UrlInfo::UrlInfoTable name_not_found;
@@ -769,7 +849,8 @@ void Predictor::DeserializeReferrers(const base::ListValue& referral_list) {
         return;
       }
 
-      referrers_[GURL(motivating_url_spec)].Deserialize(*subresource_list);
+      GetOrAddReferrer(GURL(motivating_url_spec))->Deserialize(
+          *subresource_list);
     }
   }
 }
@@ -1039,6 +1120,7 @@ void Predictor::PrepareFrameSubresources(const GURL& url,
                                          const GURL& first_party_for_cookies) {
   DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
   DCHECK_EQ(url.GetWithEmptyPath(), url);
+  RecordResolveUse(url);
   Referrers::iterator it = referrers_.find(url);
   if (referrers_.end() == it) {
     // Only when we don't know anything about this url, make 2 connections
@@ -1107,10 +1189,16 @@ void Predictor::LookupFinished(LookupRequest* request, const GURL& url,
   if (info->is_marked_to_delete()) {
     results_.erase(url);
   } else {
-    if (found)
+    if (found) {
       info->SetFoundState();
-    else
+      ++found_resolves_[info->motivation()];
+      if (info->queue_duration() < max_dns_queue_delay_ / 2 &&
+          parallel_resolves_limit_ < max_concurrent_dns_lookups_) {
+        ++parallel_resolves_limit_;
+      }
+    } else {
       info->SetNoSuchNameState();
+    }
   }
 }
 
@@ -1146,6 +1234,9 @@ bool Predictor::CongestionControlPerformed(UrlInfo* info) {
   // Note: queue_duration is ONLY valid after we go to assigned state.
   if (info->queue_duration() < max_dns_queue_delay_)
     return false;
+  // Back off, so that we don't keep competing with the lookups the user is
+  // actually waiting for.
+  parallel_resolves_limit_ = std::max<size_t>(1, parallel_resolves_limit_ / 2);
   // We need to discard all entries in our queue, as we're keeping them waiting
   // too long.  By doing this, we'll have a chance to quickly service urgent
   // resolutions, and not have a bogged down system.
@@ -1159,11 +1250,17 @@ bool Predictor::CongestionControlPerformed(UrlInfo* info) {
   return true;
 }
 
+void Predictor::RecordResolveUse(const GURL& url) {
+  Results::iterator it = results_.find(url);
+  if (it != results_.end() && it->second.RecordUse())
+    ++useful_resolves_[it->second.motivation()];
+}
+
 void Predictor::StartSomeQueuedResolutions() {
   DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
 
   while (!work_queue_.IsEmpty() &&
-         pending_lookups_.size() < max_concurrent_dns_lookups_) {
+         pending_lookups_.size() < parallel_resolves_limit_) {
     const GURL url(work_queue_.Pop());
     UrlInfo* info = &results_[url];
     DCHECK(info->HasUrl(url));
@@ -1191,6 +1288,30 @@ void Predictor::StartSomeQueuedResolutions() {
   }
 }
 
+Referrer* Predictor::GetOrAddReferrer(const GURL& url) {
+  Referrers::iterator it = referrers_.find(url);
+  if (it != referrers_.end())
+    return &it->second;
+  if (referrers_.size() >= kMaxReferrers)
+    DiscardLeastUsefulReferrer();
+  return &referrers_[url];
+}
+
+void Predictor::DiscardLeastUsefulReferrer() {
+  Referrers::iterator least_useful = referrers_.end();
+  double lowest_rate_seen = 0.0;
+  for (Referrers::iterator it = referrers_.begin(); it != referrers_.end();
+       ++it) {
+    double rate = it->second.GetTotalSubresourceUseRate();
+    if (least_useful == referrers_.end() || rate < lowest_rate_seen) {
+      least_useful = it;
+      lowest_rate_seen = rate;
+    }
+  }
+  if (least_useful != referrers_.end())
+    referrers_.erase(least_useful);
+}
+
 void Predictor::TrimReferrers() {
   DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
   if (!urls_being_trimmed_.empty())
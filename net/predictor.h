@@ -99,6 +99,12 @@ class Predictor {
   // TODO(jar): We should do a persistent field trial to validate/optimize this.
   static const int kMaxUnusedSocketLifetimeSecondsWithoutAGet;
 
+  // The most hosts to remember as recently navigated to or preconnected to,
+  // for at most kMaxUnusedSocketLifetimeSecondsWithoutAGet. Can be set through
+  // the NetworkPredictorCaches field trial.
+  static const size_t kDefaultMaxRecentlySeenHosts;
+  static size_t GetMaxRecentlySeenHosts();
+
   // |max_concurrent| specifies how many concurrent (parallel) prefetches will
   // be performed. Host lookups will be issued through |host_resolver|.
   explicit Predictor(bool preconnect_enabled);
@@ -169,6 +175,10 @@ class Predictor {
   // Dump HTML table containing list of referrers for about:dns.
   void GetHtmlReferrerLists(std::string* output);
 
+  // Dump HTML table of useful and wasted prefetches by motivation for
+  // about:dns.
+  void GetHtmlResolveUsefulness(std::string* output);
+
   // Dump the list of currently known referrer domains and related prefetchable
   // domains for about:dns.
   void GetHtmlInfo(std::string* output);
@@ -271,6 +281,8 @@ class Predictor {
     return max_concurrent_dns_lookups_;
   }
   // Used for testing.
+  size_t parallel_resolves_limit() const { return parallel_resolves_limit_; }
+  // Used for testing.
   void SetShutdown(bool shutdown) {
     shutdown_ = shutdown;
   }
@@ -292,9 +304,11 @@ class Predictor {
   FRIEND_TEST_ALL_PREFIXES(PredictorTest, SingleLookupTest);
   FRIEND_TEST_ALL_PREFIXES(PredictorTest, ConcurrentLookupTest);
   FRIEND_TEST_ALL_PREFIXES(PredictorTest, MassiveConcurrentLookupTest);
+  FRIEND_TEST_ALL_PREFIXES(PredictorTest, ParallelResolvesLimitTest);
   FRIEND_TEST_ALL_PREFIXES(PredictorTest, PriorityQueuePushPopTest);
   FRIEND_TEST_ALL_PREFIXES(PredictorTest, PriorityQueueReorderTest);
   FRIEND_TEST_ALL_PREFIXES(PredictorTest, ReferrerSerializationTrimTest);
+  FRIEND_TEST_ALL_PREFIXES(PredictorTest, ReferrerLimitTest);
   friend class WaitForResolutionHelper;  // For testing.
 
   class LookupRequest;
@@ -386,6 +400,10 @@ class Predictor {
   // Number of referring URLs processed in an incremental trimming.
   static const size_t kUrlsTrimmedPerIncrement;
 
+  // Hard limit on the number of referrers we remember, so that the list (and
+  // the pref it is persisted to) can't grow without bound between trimmings.
+  static const size_t kMaxReferrers;
+
   // Only for testing. Returns true if hostname has been successfully resolved
   // (name found).
   bool WasFound(const GURL& url) const {
@@ -439,10 +457,22 @@ class Predictor {
   // helpful manner.
   bool CongestionControlPerformed(UrlInfo* info);
 
+  // Records that a navigation needed the host of |url|, crediting the
+  // prefetch of that host (if any) as useful.
+  void RecordResolveUse(const GURL& url);
+
   // Take lookup requests from work_queue_ and tell HostResolver to look them up
   // asynchronously, provided we don't exceed concurrent resolution limit.
   void StartSomeQueuedResolutions();
 
+  // Returns the Referrer for |url|, adding one if there is none yet.  When
+  // that would exceed kMaxReferrers, the least useful referrer is discarded
+  // first.
+  Referrer* GetOrAddReferrer(const GURL& url);
+
+  // Discards the referrer whose subresources are least expected to be used.
+  void DiscardLeastUsefulReferrer();
+
   // Performs trimming similar to TrimReferrersNow(), except it does it as a
   // series of short tasks by posting continuations again an again until done.
   void TrimReferrers();
@@ -490,10 +520,23 @@ class Predictor {
   // sub-resource speculation, and retard resolutions suggested by page scans.
   const size_t max_concurrent_dns_lookups_;
 
+  // The number of concurrent speculative lookups we currently send, which is
+  // at most max_concurrent_dns_lookups_.  It is halved each time congestion
+  // control discards the queue, and grows back by one for each lookup that
+  // spent less than half of max_dns_queue_delay_ in the queue, so speculation
+  // backs off on networks where it competes with real lookups.
+  size_t parallel_resolves_limit_;
+
   // The maximum queueing delay that is acceptable before we enter congestion
   // reduction mode, and discard all queued (but not yet assigned) resolutions.
   const base::TimeDelta max_dns_queue_delay_;
 
+  // The number of prefetches which found their host, and the number of those
+  // which a navigation then needed while they were still cached, by the
+  // motivation of the prefetch.  Shown in about:dns.
+  int found_resolves_[UrlInfo::MAX_MOTIVATED];
+  int useful_resolves_[UrlInfo::MAX_MOTIVATED];
+
   // The host resolver we warm DNS entries for.
   net::HostResolver* host_resolver_;
 
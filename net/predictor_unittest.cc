@@ -241,6 +241,38 @@ TEST_F(PredictorTest, MassiveConcurrentLookupTest) {
   testing_master.Shutdown();
 }
 
+// Congestion control halves the number of parallel lookups, and lookups that
+// were not held up in the queue let it grow back.
+TEST_F(PredictorTest, ParallelResolvesLimitTest) {
+  UrlList names;
+  names.push_back(GURL("http://www.google.com:80"));
+  names.push_back(GURL("http://mail.google.com:80"));
+
+  // Every lookup waited too long for a queue delay of zero.
+  Predictor::set_max_queueing_delay(0);
+  Predictor congested_master(true);
+  congested_master.SetHostResolver(host_resolver_.get());
+  EXPECT_EQ(congested_master.max_concurrent_dns_lookups(),
+            congested_master.parallel_resolves_limit());
+  congested_master.ResolveList(names, UrlInfo::PAGE_SCAN_MOTIVATED);
+  EXPECT_EQ(1u, congested_master.parallel_resolves_limit());
+  congested_master.Shutdown();
+  Predictor::set_max_queueing_delay(
+      Predictor::kMaxSpeculativeResolveQueueDelayMs);
+
+  Predictor testing_master(true);
+  testing_master.SetHostResolver(host_resolver_.get());
+  testing_master.parallel_resolves_limit_ = 1;
+  testing_master.ResolveList(names, UrlInfo::PAGE_SCAN_MOTIVATED);
+  WaitForResolution(&testing_master, names);
+  EXPECT_EQ(1u, testing_master.peak_pending_lookups());
+  EXPECT_EQ(testing_master.max_concurrent_dns_lookups(),
+            testing_master.parallel_resolves_limit());
+
+  base::MessageLoop::current()->RunUntilIdle();
+  testing_master.Shutdown();
+}
+
 //------------------------------------------------------------------------------
 // Functions to help synthesize and test serializations of subresource referrer
 // lists.
@@ -550,6 +582,34 @@ TEST_F(PredictorTest, ReferrerSerializationTrimTest) {
   predictor.Shutdown();
 }
 
+// Make sure the number of referrers is bounded, and that the least useful
+// referrer is the one discarded to make room for a new one.
+TEST_F(PredictorTest, ReferrerLimitTest) {
+  Predictor predictor(true);
+  predictor.SetHostResolver(host_resolver_.get());
+  const GURL subresource_url("http://cdn.google.com:80");
+  const GURL least_useful_url("http://least-useful.com:80");
+
+  scoped_ptr<ListValue> referral_list(NewEmptySerializationList());
+  AddToSerializedList(least_useful_url, subresource_url,
+                      Predictor::kDiscardableExpectedValue,
+                      referral_list.get());
+  for (size_t i = 1; i < Predictor::kMaxReferrers; ++i) {
+    GURL motivation_url("http://a" + base::Uint64ToString(i) + ".com:80");
+    AddToSerializedList(motivation_url, subresource_url, 1.0,
+                        referral_list.get());
+  }
+  predictor.DeserializeReferrers(*referral_list.get());
+  EXPECT_EQ(Predictor::kMaxReferrers, predictor.referrers_.size());
+
+  predictor.LearnFromNavigation(GURL("http://new.com:80"), subresource_url);
+  EXPECT_EQ(Predictor::kMaxReferrers, predictor.referrers_.size());
+  EXPECT_EQ(0u, predictor.referrers_.count(least_useful_url));
+  EXPECT_EQ(1u, predictor.referrers_.count(GURL("http://new.com:80")));
+
+  predictor.Shutdown();
+}
+
 
 TEST_F(PredictorTest, PriorityQueuePushPopTest) {
   Predictor::HostNameQueue queue;
@@ -114,6 +114,13 @@ bool Referrer::Trim(double reduce_rate, double threshold) {
   return size() > 0;
 }
 
+double Referrer::GetTotalSubresourceUseRate() const {
+  double total = 0.0;
+  for (const_iterator it = begin(); it != end(); ++it)
+    total += it->second.subresource_use_rate();
+  return total;
+}
+
 bool ReferrerValue::Trim(double reduce_rate, double threshold) {
   subresource_use_rate_ *= reduce_rate;
   return subresource_use_rate_ > threshold;
@@ -114,6 +114,10 @@ class Referrer : public SubresourceMap {
   // Returns true if expected use rate is greater than the threshold.
   bool Trim(double reduce_rate, double threshold);
 
+  // Returns the sum of the expected use rates of all subresources, which is
+  // how many connections navigating to this referrer is expected to need.
+  double GetTotalSubresourceUseRate() const;
+
   // Provide methods for persisting, and restoring contents into a Value class.
   base::Value* Serialize() const;
   void Deserialize(const base::Value& referrers);
@@ -4,10 +4,15 @@
 
 #include "chrome/browser/net/sdch_dictionary_fetcher.h"
 
+#include <algorithm>
+
 #include "base/bind.h"
 #include "base/compiler_specific.h"
 #include "base/message_loop/message_loop.h"
+#include "base/metrics/histogram.h"
+#include "base/strings/string_number_conversions.h"
 #include "chrome/browser/profiles/profile.h"
+#include "components/variations/variations_associated_data.h"
 #include "net/base/load_flags.h"
 #include "net/url_request/url_fetcher.h"
 #include "net/url_request/url_request_context_getter.h"
@@ -15,7 +20,8 @@
 
 SdchDictionaryFetcher::SdchDictionaryFetcher(
     net::URLRequestContextGetter* context)
-    : weak_factory_(this),
+    : max_concurrent_fetches_(GetMaxConcurrentFetches()),
+      weak_factory_(this),
       task_is_pending_(false),
       context_(context) {
   DCHECK(CalledOnValidThread());
@@ -30,13 +36,25 @@ void SdchDictionaryFetcher::Shutdown() {
   net::SdchManager::Shutdown();
 }
 
+// static
+size_t SdchDictionaryFetcher::GetMaxConcurrentFetches() {
+  std::string value = chrome_variations::GetVariationParamValue(
+      "SdchDictionaryFetch", "max_concurrent_fetches");
+  unsigned max_fetches;
+  if (!value.empty() && base::StringToUint(value, &max_fetches) &&
+      max_fetches > 0) {
+    return max_fetches;
+  }
+  return kDefaultMaxConcurrentFetches;
+}
+
 void SdchDictionaryFetcher::Schedule(const GURL& dictionary_url) {
   DCHECK(CalledOnValidThread());
 
   // Avoid pushing duplicate copy onto queue.  We may fetch this url again later
   // and get a different dictionary, but there is no reason to have it in the
   // queue twice at one time.
-  if (!fetch_queue_.empty() && fetch_queue_.back() == dictionary_url) {
+  if (!fetch_queue_.empty() && fetch_queue_.back().first == dictionary_url) {
     net::SdchManager::SdchErrorRecovery(
         net::SdchManager::DICTIONARY_ALREADY_SCHEDULED_TO_DOWNLOAD);
     return;
@@ -47,13 +65,16 @@ void SdchDictionaryFetcher::Schedule(const GURL& dictionary_url) {
     return;
   }
   attempted_load_.insert(dictionary_url);
-  fetch_queue_.push(dictionary_url);
+  fetch_queue_.push(std::make_pair(dictionary_url, base::TimeTicks::Now()));
   ScheduleDelayedRun();
 }
 
 void SdchDictionaryFetcher::ScheduleDelayedRun() {
-  if (fetch_queue_.empty() || current_fetch_.get() || task_is_pending_)
+  if (fetch_queue_.empty() ||
+      current_fetches_.size() >= max_concurrent_fetches_ ||
+      task_is_pending_) {
     return;
+  }
   base::MessageLoop::current()->PostDelayedTask(FROM_HERE,
       base::Bind(&SdchDictionaryFetcher::StartFetching,
                  weak_factory_.GetWeakPtr()),
@@ -66,13 +87,20 @@ void SdchDictionaryFetcher::StartFetching() {
   task_is_pending_ = false;
 
   DCHECK(context_.get());
-  current_fetch_.reset(net::URLFetcher::Create(
-      fetch_queue_.front(), net::URLFetcher::GET, this));
+  DCHECK(!fetch_queue_.empty());
+  UMA_HISTOGRAM_TIMES("Sdch3.Dictionary_Fetch_Queue_Time",
+                      base::TimeTicks::Now() - fetch_queue_.front().second);
+  net::URLFetcher* fetch = net::URLFetcher::Create(
+      fetch_queue_.front().first, net::URLFetcher::GET, this);
   fetch_queue_.pop();
-  current_fetch_->SetRequestContext(context_.get());
-  current_fetch_->SetLoadFlags(net::LOAD_DO_NOT_SEND_COOKIES |
-                               net::LOAD_DO_NOT_SAVE_COOKIES);
-  current_fetch_->Start();
+  current_fetches_.push_back(fetch);
+  fetch->SetRequestContext(context_.get());
+  fetch->SetLoadFlags(net::LOAD_DO_NOT_SEND_COOKIES |
+                      net::LOAD_DO_NOT_SAVE_COOKIES);
+  fetch->Start();
+
+  // Spread out the remaining fetches too.
+  ScheduleDelayedRun();
 }
 
 void SdchDictionaryFetcher::OnURLFetchComplete(
@@ -83,6 +111,9 @@ void SdchDictionaryFetcher::OnURLFetchComplete(
     source->GetResponseAsString(&data);
     net::SdchManager::Global()->AddSdchDictionary(data, source->GetURL());
   }
-  current_fetch_.reset(NULL);
+  ScopedVector<net::URLFetcher>::iterator it = std::find(
+      current_fetches_.begin(), current_fetches_.end(), source);
+  DCHECK(it != current_fetches_.end());
+  current_fetches_.erase(it);
   ScheduleDelayedRun();
 }
@@ -12,10 +12,13 @@
 #include <queue>
 #include <set>
 #include <string>
+#include <utility>
 
 #include "base/memory/scoped_ptr.h"
+#include "base/memory/scoped_vector.h"
 #include "base/memory/weak_ptr.h"
 #include "base/threading/non_thread_safe.h"
+#include "base/time/time.h"
 #include "net/base/sdch_manager.h"
 #include "net/url_request/url_fetcher_delegate.h"
 
@@ -48,26 +51,36 @@ class SdchDictionaryFetcher
   // page subresources (or tabs opened in parallel) all suggest the dictionary.
   static const int kMsDelayFromRequestTillDownload = 100;
 
-  // Ensure the download after the above delay.
+  // The default number of dictionaries to download at the same time. Can be
+  // set through the SdchDictionaryFetch field trial.
+  static const size_t kDefaultMaxConcurrentFetches = 2;
+
+  // Returns the number of dictionaries to download at the same time.
+  static size_t GetMaxConcurrentFetches();
+
+  // Ensure the download after the above delay, unless as many downloads as
+  // allowed are already outstanding.
   void ScheduleDelayedRun();
 
-  // Make sure we're processing (or waiting for) the the arrival of the next URL
-  // in the  |fetch_queue_|.
+  // Start fetching the next URL in the |fetch_queue_|, and schedule the fetch
+  // of the one after it.
   void StartFetching();
 
   // Implementation of net::URLFetcherDelegate. Called after transmission
   // completes (either successfully or with failure).
   virtual void OnURLFetchComplete(const net::URLFetcher* source) OVERRIDE;
 
-  // A queue of URLs that are being used to download dictionaries.
-  std::queue<GURL> fetch_queue_;
-  // The currently outstanding URL fetch of a dicitonary.
-  // If this is null, then there is no outstanding request.
-  scoped_ptr<net::URLFetcher> current_fetch_;
+  // A queue of URLs that are being used to download dictionaries, with the
+  // times they were scheduled.
+  std::queue<std::pair<GURL, base::TimeTicks> > fetch_queue_;
+  // The currently outstanding URL fetches of dictionaries.
+  ScopedVector<net::URLFetcher> current_fetches_;
+  const size_t max_concurrent_fetches_;
 
   // Always spread out the dictionary fetches, so that they don't steal
   // bandwidth from the actual page load.  Create delayed tasks to spread out
-  // the download.
+  // the download, and don't start more than |max_concurrent_fetches_| of them
+  // at a time.
   base::WeakPtrFactory<SdchDictionaryFetcher> weak_factory_;
   bool task_is_pending_;
 
@@ -0,0 +1,139 @@
+// Copyright 2013 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "chrome/browser/net/sdch_dictionary_fetcher.h"
+
+#include <vector>
+
+#include "base/callback.h"
+#include "base/compiler_specific.h"
+#include "base/memory/ref_counted.h"
+#include "base/message_loop/message_loop.h"
+#include "base/message_loop/message_loop_proxy.h"
+#include "base/run_loop.h"
+#include "base/time/time.h"
+#include "net/url_request/test_url_fetcher_factory.h"
+#include "net/url_request/url_fetcher_delegate.h"
+#include "net/url_request/url_request_test_util.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "url/gurl.h"
+
+namespace {
+
+// Keeps the URLs of all the fetchers it creates, and quits the running loop
+// as soon as one is created.
+class RecordingURLFetcherFactory : public net::TestURLFetcherFactory {
+ public:
+  RecordingURLFetcherFactory() {}
+
+  virtual net::URLFetcher* CreateURLFetcher(
+      int id,
+      const GURL& url,
+      net::URLFetcher::RequestType request_type,
+      net::URLFetcherDelegate* d) OVERRIDE {
+    net::TestURLFetcher* fetcher = static_cast<net::TestURLFetcher*>(
+        net::TestURLFetcherFactory::CreateURLFetcher(id, url, request_type,
+                                                     d));
+    fetchers_.push_back(fetcher);
+    fetched_urls_.push_back(url);
+    if (!quit_closure_.is_null())
+      quit_closure_.Run();
+    return fetcher;
+  }
+
+  // Runs the loop until the next fetcher is created.
+  void WaitForFetcher() {
+    base::RunLoop run_loop;
+    quit_closure_ = run_loop.QuitClosure();
+    run_loop.Run();
+    quit_closure_.Reset();
+  }
+
+  // Fails the fetch of |fetcher|, so that the dictionary is not handed to the
+  // SdchManager. |fetcher| is deleted by its delegate.
+  void FailFetch(net::TestURLFetcher* fetcher) {
+    fetcher->set_response_code(404);
+    fetcher->delegate()->OnURLFetchComplete(fetcher);
+  }
+
+  // The fetchers created so far. Completed ones are no longer valid.
+  const std::vector<net::TestURLFetcher*>& fetchers() const {
+    return fetchers_;
+  }
+  const std::vector<GURL>& fetched_urls() const { return fetched_urls_; }
+
+ private:
+  std::vector<net::TestURLFetcher*> fetchers_;
+  std::vector<GURL> fetched_urls_;
+  base::Closure quit_closure_;
+
+  DISALLOW_COPY_AND_ASSIGN(RecordingURLFetcherFactory);
+};
+
+class SdchDictionaryFetcherTest : public testing::Test {
+ protected:
+  SdchDictionaryFetcherTest()
+      : fetcher_(new net::TestURLRequestContextGetter(
+            base::MessageLoopProxy::current())) {}
+
+  // Runs the loop for several times the delay between two fetches, to check
+  // that no fetch is started meanwhile.
+  void RunForSeveralFetchDelays() {
+    base::RunLoop run_loop;
+    base::MessageLoop::current()->PostDelayedTask(
+        FROM_HERE, run_loop.QuitClosure(),
+        base::TimeDelta::FromMilliseconds(500));
+    run_loop.Run();
+  }
+
+  base::MessageLoopForIO message_loop_;
+  RecordingURLFetcherFactory factory_;
+  SdchDictionaryFetcher fetcher_;
+};
+
+}  // namespace
+
+// At most two dictionaries are downloaded at the same time, and the next one
+// is started once one of them completes.
+TEST_F(SdchDictionaryFetcherTest, FetchesInParallel) {
+  const GURL kUrl1("http://www.example.com/dict1");
+  const GURL kUrl2("http://www.example.com/dict2");
+  const GURL kUrl3("http://www.example.com/dict3");
+  fetcher_.Schedule(kUrl1);
+  fetcher_.Schedule(kUrl2);
+  fetcher_.Schedule(kUrl3);
+
+  factory_.WaitForFetcher();
+  factory_.WaitForFetcher();
+  ASSERT_EQ(2u, factory_.fetched_urls().size());
+  EXPECT_EQ(kUrl1, factory_.fetched_urls()[0]);
+  EXPECT_EQ(kUrl2, factory_.fetched_urls()[1]);
+
+  RunForSeveralFetchDelays();
+  EXPECT_EQ(2u, factory_.fetched_urls().size());
+
+  factory_.FailFetch(factory_.fetchers()[0]);
+  factory_.WaitForFetcher();
+  ASSERT_EQ(3u, factory_.fetched_urls().size());
+  EXPECT_EQ(kUrl3, factory_.fetched_urls()[2]);
+}
+
+// A dictionary URL is only fetched once, even when scheduled again after its
+// fetch completed.
+TEST_F(SdchDictionaryFetcherTest, FetchesUrlOnce) {
+  const GURL kUrl1("http://www.example.com/dict1");
+  const GURL kUrl2("http://www.example.com/dict2");
+  fetcher_.Schedule(kUrl1);
+  fetcher_.Schedule(kUrl1);
+  factory_.WaitForFetcher();
+  factory_.FailFetch(factory_.fetchers()[0]);
+
+  fetcher_.Schedule(kUrl1);
+  fetcher_.Schedule(kUrl2);
+  factory_.WaitForFetcher();
+  RunForSeveralFetchDelays();
+  ASSERT_EQ(2u, factory_.fetched_urls().size());
+  EXPECT_EQ(kUrl1, factory_.fetched_urls()[0]);
+  EXPECT_EQ(kUrl2, factory_.fetched_urls()[1]);
+}
@@ -5,6 +5,7 @@
 #include "chrome/browser/net/sqlite_server_bound_cert_store.h"
 
 #include <list>
+#include <map>
 #include <set>
 
 #include "base/basictypes.h"
@@ -14,6 +15,7 @@
 #include "base/logging.h"
 #include "base/memory/scoped_ptr.h"
 #include "base/metrics/histogram.h"
+#include "base/stl_util.h"
 #include "base/strings/string_util.h"
 #include "base/threading/thread.h"
 #include "base/threading/thread_restrictions.h"
@@ -30,6 +32,8 @@
 
 // This class is designed to be shared between any calling threads and the
 // background task runner. It batches operations and commits them on a timer.
+// Only the last operation on the cert of a server is kept in a batch, since
+// adding a cert replaces any cert the server already has.
 class SQLiteServerBoundCertStore::Backend
     : public base::RefCountedThreadSafe<SQLiteServerBoundCertStore::Backend> {
  public:
@@ -39,6 +43,7 @@ class SQLiteServerBoundCertStore::Backend
       quota::SpecialStoragePolicy* special_storage_policy)
       : path_(path),
         num_pending_(0),
+        num_coalesced_(0),
         force_keep_session_state_(false),
         background_task_runner_(background_task_runner),
         special_storage_policy_(special_storage_policy),
@@ -65,12 +70,22 @@ class SQLiteServerBoundCertStore::Backend
   void LoadOnDBThread(
       ScopedVector<net::DefaultServerBoundCertStore::ServerBoundCert>* certs);
 
+  // Records how long the caller of Load() waited for the certs, including
+  // the time the load waited for the background task runner, and passes
+  // them on to |loaded_callback|.
+  static void OnLoaded(
+      const LoadedCallback& loaded_callback,
+      base::TimeTicks start,
+      scoped_ptr<ScopedVector<
+          net::DefaultServerBoundCertStore::ServerBoundCert> > certs);
+
   friend class base::RefCountedThreadSafe<SQLiteServerBoundCertStore::Backend>;
 
   // You should call Close() before destructing this object.
   ~Backend() {
     DCHECK(!db_.get()) << "Close should have already been called.";
-    DCHECK(num_pending_ == 0 && pending_.empty());
+    DCHECK(num_pending_ == 0 && pending_.empty() &&
+           pending_by_origin_.empty());
   }
 
   // Database upgrade statements.
@@ -92,6 +107,9 @@ class SQLiteServerBoundCertStore::Backend
     const net::DefaultServerBoundCertStore::ServerBoundCert& cert() const {
         return cert_;
     }
+    const std::string& server_identifier() const {
+      return cert_.server_identifier();
+    }
 
    private:
     OperationType op_;
@@ -99,7 +117,8 @@ class SQLiteServerBoundCertStore::Backend
   };
 
  private:
-  // Batch a server bound cert operation (add or delete).
+  // Batch a server bound cert operation (add or delete), replacing any
+  // pending operation on the cert of the same server.
   void BatchOperation(
       PendingOperation::OperationType op,
       const net::DefaultServerBoundCertStore::ServerBoundCert& cert);
@@ -120,9 +139,16 @@ class SQLiteServerBoundCertStore::Backend
   typedef std::list<PendingOperation*> PendingOperationsList;
   PendingOperationsList pending_;
   PendingOperationsList::size_type num_pending_;
+  // The operations in |pending_| by the server whose cert they change.
+  typedef std::map<std::string, PendingOperationsList::iterator>
+      PendingOperationsMap;
+  PendingOperationsMap pending_by_origin_;
+  // Number of operations replaced by a later one in the current batch.
+  int num_coalesced_;
   // True if the persistent store should skip clear on exit rules.
   bool force_keep_session_state_;
-  // Guard |pending_|, |num_pending_| and |force_keep_session_state_|.
+  // Guard |pending_|, |num_pending_|, |pending_by_origin_|, |num_coalesced_|
+  // and |force_keep_session_state_|.
   base::Lock lock_;
 
   // Cache of origins we have certificates stored for.
@@ -178,7 +204,24 @@ void SQLiteServerBoundCertStore::Backend::Load(
   background_task_runner_->PostTaskAndReply(
       FROM_HERE,
       base::Bind(&Backend::LoadOnDBThread, this, certs_ptr),
-      base::Bind(loaded_callback, base::Passed(&certs)));
+      base::Bind(&Backend::OnLoaded, loaded_callback, base::TimeTicks::Now(),
+                 base::Passed(&certs)));
+}
+
+// static
+void SQLiteServerBoundCertStore::Backend::OnLoaded(
+    const LoadedCallback& loaded_callback,
+    base::TimeTicks start,
+    scoped_ptr<ScopedVector<
+        net::DefaultServerBoundCertStore::ServerBoundCert> > certs) {
+  // Requests for channel IDs wait for the load, so this is the delay the
+  // first connections to channel ID domains see.
+  UMA_HISTOGRAM_CUSTOM_TIMES("DomainBoundCerts.DBLoadWaitTime",
+                             base::TimeTicks::Now() - start,
+                             base::TimeDelta::FromMilliseconds(1),
+                             base::TimeDelta::FromMinutes(1),
+                             50);
+  loaded_callback.Run(certs.Pass());
 }
 
 void SQLiteServerBoundCertStore::Backend::LoadOnDBThread(
@@ -455,7 +498,18 @@ void SQLiteServerBoundCertStore::Backend::BatchOperation(
   PendingOperationsList::size_type num_pending;
   {
     base::AutoLock locked(lock_);
-    pending_.push_back(po.release());
+    PendingOperationsMap::iterator existing =
+        pending_by_origin_.find(cert.server_identifier());
+    if (existing != pending_by_origin_.end()) {
+      // The batch already has a commit scheduled, so just replace the
+      // operation in place.
+      delete *existing->second;
+      *existing->second = po.release();
+      ++num_coalesced_;
+      return;
+    }
+    pending_by_origin_[cert.server_identifier()] =
+        pending_.insert(pending_.end(), po.release());
     num_pending = ++num_pending_;
   }
 
@@ -476,19 +530,30 @@ void SQLiteServerBoundCertStore::Backend::Commit() {
   DCHECK(background_task_runner_->RunsTasksOnCurrentThread());
 
   PendingOperationsList ops;
+  int num_coalesced;
   {
     base::AutoLock locked(lock_);
     pending_.swap(ops);
+    pending_by_origin_.clear();
     num_pending_ = 0;
+    num_coalesced = num_coalesced_;
+    num_coalesced_ = 0;
   }
 
   // Maybe an old timer fired or we are already Close()'ed.
-  if (!db_.get() || ops.empty())
+  if (!db_.get() || ops.empty()) {
+    STLDeleteElements(&ops);
     return;
+  }
+
+  UMA_HISTOGRAM_COUNTS_1000("DomainBoundCerts.CommitCoalescedCount",
+                            num_coalesced);
 
+  // Replaces the cert of the server if it has one, since earlier operations
+  // on it may have been coalesced away.
   sql::Statement add_smt(db_->GetCachedStatement(SQL_FROM_HERE,
-      "INSERT INTO origin_bound_certs (origin, private_key, cert, cert_type, "
-      "expiration_time, creation_time) VALUES (?,?,?,?,?,?)"));
+      "INSERT OR REPLACE INTO origin_bound_certs (origin, private_key, cert, "
+      "cert_type, expiration_time, creation_time) VALUES (?,?,?,?,?,?)"));
   if (!add_smt.is_valid())
     return;
 
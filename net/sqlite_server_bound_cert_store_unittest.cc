@@ -158,6 +158,50 @@ TEST_F(SQLiteServerBoundCertStoreTest, TestPersistence) {
   ASSERT_EQ(0U, certs.size());
 }
 
+// Test that only the last of several operations on the cert of a server in
+// one batch takes effect.
+TEST_F(SQLiteServerBoundCertStoreTest, TestCoalescedOperations) {
+  net::DefaultServerBoundCertStore::ServerBoundCert foo_cert(
+      "foo.com",
+      base::Time::FromInternalValue(3),
+      base::Time::FromInternalValue(4),
+      "c", "d");
+  net::DefaultServerBoundCertStore::ServerBoundCert new_foo_cert(
+      "foo.com",
+      base::Time::FromInternalValue(5),
+      base::Time::FromInternalValue(6),
+      "e", "f");
+  store_->AddServerBoundCert(foo_cert);
+  store_->DeleteServerBoundCert(foo_cert);
+  store_->AddServerBoundCert(new_foo_cert);
+  net::DefaultServerBoundCertStore::ServerBoundCert bar_cert(
+      "bar.com",
+      base::Time::FromInternalValue(7),
+      base::Time::FromInternalValue(8),
+      "g", "h");
+  store_->AddServerBoundCert(bar_cert);
+  store_->DeleteServerBoundCert(bar_cert);
+
+  store_ = NULL;
+  // Make sure we wait until the destructor has run.
+  base::RunLoop().RunUntilIdle();
+  store_ = new SQLiteServerBoundCertStore(
+      temp_dir_.path().Append(chrome::kOBCertFilename),
+      base::MessageLoopProxy::current(),
+      NULL);
+
+  ScopedVector<net::DefaultServerBoundCertStore::ServerBoundCert> certs;
+  Load(&certs);
+  ASSERT_EQ(2U, certs.size());
+  net::DefaultServerBoundCertStore::ServerBoundCert* cert =
+      certs[0]->server_identifier() == "foo.com" ? certs[0] : certs[1];
+  ASSERT_EQ("foo.com", cert->server_identifier());
+  EXPECT_STREQ("e", cert->private_key().c_str());
+  EXPECT_STREQ("f", cert->cert().c_str());
+  EXPECT_EQ(5, cert->creation_time().ToInternalValue());
+  EXPECT_EQ(6, cert->expiration_time().ToInternalValue());
+}
+
 TEST_F(SQLiteServerBoundCertStoreTest, TestUpgradeV1) {
   // Reset the store.  We'll be using a different database for this test.
   store_ = NULL;
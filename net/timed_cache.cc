@@ -8,8 +8,8 @@
 
 namespace chrome_browser_net {
 
-TimedCache::TimedCache(const base::TimeDelta& max_duration)
-    : mru_cache_(UrlMruTimedCache::NO_AUTO_EVICT),
+TimedCache::TimedCache(const base::TimeDelta& max_duration, size_t max_size)
+    : mru_cache_(max_size),
       max_duration_(max_duration) {
 }
 
@@ -18,8 +18,18 @@ TimedCache::~TimedCache() {}
 
 bool TimedCache::WasRecentlySeen(const GURL& url) {
   DCHECK_EQ(url.GetWithEmptyPath(), url);
-  // Evict any overly old entries.
+  EvictExpiredEntries(base::TimeTicks::Now());
+  return mru_cache_.end() != mru_cache_.Peek(url.spec());
+}
+
+void TimedCache::SetRecentlySeen(const GURL& url) {
+  DCHECK_EQ(url.GetWithEmptyPath(), url);
   base::TimeTicks now = base::TimeTicks::Now();
+  EvictExpiredEntries(now);
+  mru_cache_.Put(url.spec(), now);
+}
+
+void TimedCache::EvictExpiredEntries(base::TimeTicks now) {
   UrlMruTimedCache::reverse_iterator eldest = mru_cache_.rbegin();
   while (!mru_cache_.empty()) {
     DCHECK(eldest == mru_cache_.rbegin());
@@ -27,12 +37,6 @@ bool TimedCache::WasRecentlySeen(const GURL& url) {
       break;
     eldest = mru_cache_.Erase(eldest);
   }
-  return mru_cache_.end() != mru_cache_.Peek(url);
-}
-
-void TimedCache::SetRecentlySeen(const GURL& url) {
-  DCHECK_EQ(url.GetWithEmptyPath(), url);
-  mru_cache_.Put(url, base::TimeTicks::Now());
 }
 
 }  // namespace chrome_browser_net
@@ -5,6 +5,8 @@
 #ifndef CHROME_BROWSER_NET_TIMED_CACHE_H_
 #define CHROME_BROWSER_NET_TIMED_CACHE_H_
 
+#include <string>
+
 #include "base/basictypes.h"
 #include "base/containers/mru_cache.h"
 #include "base/time/time.h"
@@ -18,23 +20,32 @@ namespace chrome_browser_net {
 // waste to preconnect when the original navigation was too long ago.  Any
 // connected, but unused TCP/IP connection, will generally be reset by the
 // server if it is not used quickly (i.e., GET or POST is sent).
+// The cache holds at most max_size entries, so that a burst of navigations to
+// distinct hosts can't make it grow without bound; the least recently seen
+// entries are dropped first.
 class TimedCache {
  public:
-  explicit TimedCache(const base::TimeDelta& max_duration);
+  TimedCache(const base::TimeDelta& max_duration, size_t max_size);
   ~TimedCache();
 
   // Evicts any entries that have been in the FIFO "too long," and then checks
   // to see if the given url is (still) in the FIFO cache.
   bool WasRecentlySeen(const GURL& url);
 
-  // Adds the given url to the cache, where it will remain for max_duration_.
+  // Adds the given url to the cache, where it will remain for max_duration_,
+  // unless it is pushed out by more recently seen urls first.
   void SetRecentlySeen(const GURL& url);
 
+  size_t size() const { return mru_cache_.size(); }
+
  private:
-  // Our cache will be keyed on a URL (actually, just a scheme/host/port).
-  // We will always track the time it was last added to the FIFO cache by
-  // remembering a TimeTicks value.
-  typedef base::MRUCache<GURL, base::TimeTicks> UrlMruTimedCache;
+  // Evicts any entries that have been in the cache longer than max_duration_.
+  void EvictExpiredEntries(base::TimeTicks now);
+
+  // Our cache will be keyed on the spec of a URL (actually, just a
+  // scheme/host/port). We will always track the time it was last added to the
+  // FIFO cache by remembering a TimeTicks value.
+  typedef base::HashingMRUCache<std::string, base::TimeTicks> UrlMruTimedCache;
   UrlMruTimedCache mru_cache_;
 
   // The longest time an entry can persist in the cache, and still be found.
@@ -0,0 +1,91 @@
+// Copyright 2013 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Benchmarks |TimedCache|, which ConnectInterceptor consults on the IO thread
+// for every request, when it is kept at its size cap by navigations to many
+// distinct hosts. Results are printed in the perf_test RESULT format so that
+// they can be tracked by the perf bots.
+
+#include <string>
+#include <vector>
+
+#include "base/compiler_specific.h"
+#include "base/strings/stringprintf.h"
+#include "base/time/time.h"
+#include "chrome/browser/net/timed_cache.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_test.h"
+#include "url/gurl.h"
+
+using base::TimeTicks;
+
+namespace chrome_browser_net {
+
+namespace {
+
+// The default cap of Predictor::GetMaxRecentlySeenHosts(), and the number of
+// distinct hosts seen, so that most of them push out an older one.
+const size_t kMaxSize = 1000;
+const size_t kNumHosts = 10 * kMaxSize;
+
+// The number of times all the hosts are looked up.
+const int kNumIterations = 100;
+
+class TimedCachePerfTest : public testing::Test {
+ protected:
+  TimedCachePerfTest() : cache_(base::TimeDelta::FromMinutes(1), kMaxSize) {}
+
+  virtual void SetUp() OVERRIDE {
+    for (size_t i = 0; i < kNumHosts; ++i) {
+      hosts_.push_back(GURL(base::StringPrintf(
+          "http://www.host%d.com/", static_cast<int>(i))));
+    }
+  }
+
+  // Prints |time| in microseconds per each of |count| operations.
+  void PrintTimePerOperation(const std::string& trace,
+                             base::TimeDelta time,
+                             size_t count) {
+    perf_test::PrintResult("TimedCache", std::string(), trace,
+                           time.InMicrosecondsF() / count, "us", true);
+  }
+
+  std::vector<GURL> hosts_;
+  TimedCache cache_;
+};
+
+}  // namespace
+
+TEST_F(TimedCachePerfTest, SetRecentlySeen) {
+  const TimeTicks start = TimeTicks::Now();
+  for (int i = 0; i < kNumIterations; ++i) {
+    for (size_t j = 0; j < hosts_.size(); ++j)
+      cache_.SetRecentlySeen(hosts_[j]);
+  }
+  PrintTimePerOperation("set_recently_seen", TimeTicks::Now() - start,
+                        kNumIterations * hosts_.size());
+  perf_test::PrintResult("TimedCache", std::string(), "entries",
+                         cache_.size(), "entries", true);
+  EXPECT_EQ(kMaxSize, cache_.size());
+}
+
+// Only the last |kMaxSize| hosts are still in the cache.
+TEST_F(TimedCachePerfTest, WasRecentlySeen) {
+  for (size_t i = 0; i < hosts_.size(); ++i)
+    cache_.SetRecentlySeen(hosts_[i]);
+
+  size_t seen = 0;
+  const TimeTicks start = TimeTicks::Now();
+  for (int i = 0; i < kNumIterations; ++i) {
+    for (size_t j = 0; j < hosts_.size(); ++j) {
+      if (cache_.WasRecentlySeen(hosts_[j]))
+        ++seen;
+    }
+  }
+  PrintTimePerOperation("was_recently_seen", TimeTicks::Now() - start,
+                        kNumIterations * hosts_.size());
+  EXPECT_EQ(kNumIterations * kMaxSize, seen);
+}
+
+}  // namespace chrome_browser_net
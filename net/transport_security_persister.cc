@@ -4,6 +4,8 @@
 
 #include "chrome/browser/net/transport_security_persister.h"
 
+#include <set>
+
 #include "base/base64.h"
 #include "base/bind.h"
 #include "base/file_util.h"
@@ -94,7 +96,11 @@ class TransportSecurityPersister::Loader {
 
   void Load() {
     DCHECK(BrowserThread::CurrentlyOn(BrowserThread::FILE));
-    state_valid_ = base::ReadFileToString(path_, &state_);
+    std::string state;
+    state_valid_ = base::ReadFileToString(path_, &state);
+    // Parse here, so that only merging the entries is left to the IO thread.
+    if (state_valid_)
+      value_.reset(base::JSONReader::Read(state));
   }
 
   void CompleteLoad() {
@@ -105,7 +111,7 @@ class TransportSecurityPersister::Loader {
 
     if (!persister_.get() || !state_valid_)
       return;
-    persister_->CompleteLoad(state_);
+    persister_->CompleteLoad(value_.get());
   }
 
  private:
@@ -113,7 +119,7 @@ class TransportSecurityPersister::Loader {
 
   base::FilePath path_;
 
-  std::string state_;
+  scoped_ptr<base::Value> value_;
   bool state_valid_;
 
   DISALLOW_COPY_AND_ASSIGN(Loader);
@@ -222,10 +228,28 @@ bool TransportSecurityPersister::Deserialize(const std::string& serialized,
                                              bool* dirty,
                                              TransportSecurityState* state) {
   scoped_ptr<Value> value(base::JSONReader::Read(serialized));
-  DictionaryValue* dict_value = NULL;
-  if (!value.get() || !value->GetAsDictionary(&dict_value))
+  if (!value.get())
+    return false;
+  return DeserializeValue(*value, false, dirty, state);
+}
+
+// static
+bool TransportSecurityPersister::DeserializeValue(
+    const Value& value,
+    bool merge,
+    bool* dirty,
+    TransportSecurityState* state) {
+  const DictionaryValue* dict_value = NULL;
+  if (!value.GetAsDictionary(&dict_value))
     return false;
 
+  std::set<std::string> existing_hosts;
+  if (merge) {
+    TransportSecurityState::Iterator it(*state);
+    for (; it.HasNext(); it.Advance())
+      existing_hosts.insert(it.hostname());
+  }
+
   const base::Time current_time(base::Time::Now());
   bool dirtied = false;
 
@@ -319,6 +343,12 @@ bool TransportSecurityPersister::Deserialize(const std::string& serialized,
       continue;
     }
 
+    if (existing_hosts.count(hashed)) {
+      // Keep the newer state, and make sure it gets written out.
+      dirtied = true;
+      continue;
+    }
+
     state->AddOrUpdateEnabledHosts(hashed, domain_state);
   }
 
@@ -326,12 +356,13 @@ bool TransportSecurityPersister::Deserialize(const std::string& serialized,
   return true;
 }
 
-void TransportSecurityPersister::CompleteLoad(const std::string& state) {
+void TransportSecurityPersister::CompleteLoad(const Value* value) {
   DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
 
   bool dirty = false;
-  if (!LoadEntries(state, &dirty)) {
-    LOG(ERROR) << "Failed to deserialize state: " << state;
+  if (!value ||
+      !DeserializeValue(*value, true, &dirty, transport_security_state_)) {
+    LOG(ERROR) << "Failed to deserialize state.";
     return;
   }
   if (dirty)
@@ -13,8 +13,10 @@
 // This means that it's possible for pages opened very quickly not to get the
 // correct transport security information.
 //
-// To load the state, we schedule a Task on the file thread which loads,
-// deserializes and configures the TransportSecurityState.
+// To load the state, we schedule a Task on the file thread which loads and
+// parses the file, and then merges the entries into the TransportSecurityState
+// on the IO thread. Entries which were added in the meantime are newer than the
+// persisted ones, so they are kept.
 //
 // The TransportSecurityState object supports running a callback function
 // when it changes. This object registers the callback, pointing at itself.
@@ -40,6 +42,10 @@
 #include "base/memory/weak_ptr.h"
 #include "net/http/transport_security_state.h"
 
+namespace base {
+class Value;
+}
+
 // Reads and updates on-disk TransportSecurity state.
 // Must be created, used and destroyed only on the IO thread.
 class TransportSecurityPersister
@@ -105,7 +111,18 @@ class TransportSecurityPersister
                           bool* dirty,
                           net::TransportSecurityState* state);
 
-  void CompleteLoad(const std::string& state);
+  // Like Deserialize(), but from the parsed JSON |value|. If |merge| is true,
+  // entries for hosts which |state| already has dynamic state for are skipped,
+  // since that state is newer than the persisted one.
+  static bool DeserializeValue(const base::Value& value,
+                               bool merge,
+                               bool* dirty,
+                               net::TransportSecurityState* state);
+
+  // Merges the entries of the parsed state file into
+  // |transport_security_state_|. |value| is NULL if the file couldn't be
+  // parsed.
+  void CompleteLoad(const base::Value* value);
 
   net::TransportSecurityState* transport_security_state_;
 
@@ -209,3 +209,30 @@ TEST_F(TransportSecurityPersisterTest, PublicKeyHashes) {
   EXPECT_EQ(0, memcmp(domain_state.dynamic_spki_hashes[0].data(), sha1.data(),
                       sha1.size()));
 }
+
+TEST_F(TransportSecurityPersisterTest, LoadKeepsNewerEntries) {
+  const base::Time expiry =
+      base::Time::Now() + base::TimeDelta::FromSeconds(1000);
+  static const char kPersistedDomain[] = "example.com";
+  static const char kNewDomain[] = "example.org";
+  state_.AddHSTS(kPersistedDomain, expiry, true);
+  state_.AddHSTS(kNewDomain, expiry, true);
+
+  std::string output;
+  ASSERT_TRUE(persister_->SerializeData(&output));
+  const base::FilePath path =
+      temp_dir_.path().AppendASCII("TransportSecurity");
+  ASSERT_EQ(static_cast<int>(output.size()),
+            file_util::WriteFile(path, output.data(), output.size()));
+
+  // The new state learns about |kNewDomain| before the file is loaded.
+  TransportSecurityState state;
+  TransportSecurityPersister persister(&state, temp_dir_.path(), true);
+  state.AddHSTS(kNewDomain, expiry, false);
+  message_loop_.RunUntilIdle();
+
+  TransportSecurityState::DomainState domain_state;
+  EXPECT_TRUE(state.GetDomainState(kPersistedDomain, true, &domain_state));
+  EXPECT_TRUE(state.GetDomainState(kNewDomain, true, &domain_state));
+  EXPECT_FALSE(domain_state.sts_include_subdomains);
+}
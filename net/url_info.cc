@@ -73,7 +73,8 @@ UrlInfo::UrlInfo()
       queue_duration_(NullDuration()),
       sequence_number_(0),
       motivation_(NO_PREFETCH_MOTIVATION),
-      was_linked_(false) {
+      was_linked_(false),
+      was_used_(false) {
 }
 
 UrlInfo::~UrlInfo() {}
@@ -155,6 +156,7 @@ void UrlInfo::SetPendingDeleteState() {
 void UrlInfo::SetFoundState() {
   DCHECK(ASSIGNED == state_);
   state_ = FOUND;
+  was_used_ = false;
   resolve_duration_ = GetDuration();
   const TimeDelta max_duration = MaxNonNetworkDnsLookupDuration();
   if (max_duration <= resolve_duration_) {
@@ -183,6 +185,13 @@ void UrlInfo::SetUrl(const GURL& url) {
     DCHECK_EQ(url_, url);
 }
 
+bool UrlInfo::RecordUse() {
+  if (FOUND != state_ || was_used_ || !IsStillCached())
+    return false;
+  was_used_ = true;
+  return true;
+}
+
 // IsStillCached() guesses if the DNS cache still has IP data,
 // or at least remembers results about "not finding host."
 bool UrlInfo::IsStillCached() const {
@@ -111,6 +111,12 @@ class UrlInfo {
   }
   bool is_marked_to_delete() const { return ASSIGNED_BUT_MARKED == state_; }
   const GURL url() const { return url_; }
+  ResolutionMotivation motivation() const { return motivation_; }
+
+  // Records that a navigation needed the host of this instance.  Returns true
+  // the first time this happens after a successful prefetch, while the result
+  // is still likely to be cached (i.e., the prefetch saved a lookup).
+  bool RecordUse();
 
   bool HasUrl(const GURL& url) const {
     return url_ == url;
@@ -173,6 +179,9 @@ class UrlInfo {
   // Record if the motivation for prefetching was ever a page-link-scan.
   bool was_linked_;
 
+  // Record if a navigation needed the result of the last prefetch.
+  bool was_used_;
+
   // If this instance holds data about a navigation, we store the referrer.
   // If this instance hold data about a prefetch, and the prefetch was
   // instigated by a referrer, we store it here (for use in about:dns).
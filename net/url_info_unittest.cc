@@ -123,6 +123,29 @@ TEST(UrlHostInfoTest, CongestionResetStateTest) {
   EXPECT_TRUE(info.was_found());  // Back to what it was before being queued.
 }
 
+// Make sure a prefetch is only credited once for being used, and only after it
+// found the host.
+TEST(UrlHostInfoTest, RecordUseTest) {
+  UrlInfo info;
+  GURL url("http://domain1.com:80");
+
+  info.SetUrl(url);
+  EXPECT_FALSE(info.RecordUse());
+  info.SetQueuedState(UrlInfo::OMNIBOX_MOTIVATED);
+  info.SetAssignedState();
+  EXPECT_FALSE(info.RecordUse());
+  info.SetFoundState();
+  EXPECT_EQ(UrlInfo::OMNIBOX_MOTIVATED, info.motivation());
+  EXPECT_TRUE(info.RecordUse());
+  EXPECT_FALSE(info.RecordUse());
+
+  // A new prefetch can be credited again.
+  info.SetQueuedState(UrlInfo::PAGE_SCAN_MOTIVATED);
+  info.SetAssignedState();
+  info.SetFoundState();
+  EXPECT_TRUE(info.RecordUse());
+}
+
 
 // TODO(jar): Add death test for illegal state changes, and also for setting
 // hostname when already set.
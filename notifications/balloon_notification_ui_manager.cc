@@ -43,6 +43,8 @@ class QueuedNotification {
   DISALLOW_COPY_AND_ASSIGN(QueuedNotification);
 };
 
+const int BalloonNotificationUIManager::kMaxQueuedNotificationsPerOrigin = 100;
+
 BalloonNotificationUIManager::BalloonNotificationUIManager(
     PrefService* local_state)
     : NotificationPrefsManager(local_state),
@@ -82,6 +84,7 @@ void BalloonNotificationUIManager::Add(const Notification& notification,
 
   VLOG(1) << "Added notification. URL: "
           << notification.content_url().spec();
+  DropQueuedNotificationIfFull(notification.origin_url(), profile);
   show_queue_.push_back(linked_ptr<QueuedNotification>(
       new QueuedNotification(notification, profile)));
   CheckAndShowNotifications();
@@ -287,6 +290,30 @@ void BalloonNotificationUIManager::ShowNotifications() {
   }
 }
 
+void BalloonNotificationUIManager::DropQueuedNotificationIfFull(
+    const GURL& origin,
+    Profile* profile) {
+  // Keeps a site which floods notifications from growing the queue, and
+  // every lookup in it, without bound.
+  int queued_count = 0;
+  NotificationDeque::iterator oldest = show_queue_.end();
+  for (NotificationDeque::iterator iter = show_queue_.begin();
+       iter != show_queue_.end(); ++iter) {
+    if (profile == (*iter)->profile() &&
+        origin == (*iter)->notification().origin_url()) {
+      if (oldest == show_queue_.end())
+        oldest = iter;
+      ++queued_count;
+    }
+  }
+  if (queued_count < kMaxQueuedNotificationsPerOrigin)
+    return;
+
+  Notification dropped_notification((*oldest)->notification());
+  show_queue_.erase(oldest);
+  dropped_notification.Close(false);
+}
+
 // static
 BalloonNotificationUIManager*
     BalloonNotificationUIManager::GetInstanceForTesting() {
@@ -70,6 +70,10 @@ class BalloonNotificationUIManager
   void GetQueuedNotificationsForTesting(
     std::vector<const Notification*>* notifications);
 
+  // The most notifications of one origin and profile waiting to be shown.
+  // When a site shows more, the oldest waiting one is closed.
+  static const int kMaxQueuedNotificationsPerOrigin;
+
  private:
   bool ShowNotification(const Notification& notification, Profile* profile);
   bool UpdateNotification(const Notification& notification, Profile* profile);
@@ -81,6 +85,10 @@ class BalloonNotificationUIManager
 
   void ShowNotifications();
 
+  // Closes the oldest waiting notification of |origin| and |profile| if there
+  // are already kMaxQueuedNotificationsPerOrigin of them.
+  void DropQueuedNotificationIfFull(const GURL& origin, Profile* profile);
+
   void OnDesktopNotificationPositionChanged();
 
   // BalloonCollectionObserver overrides:
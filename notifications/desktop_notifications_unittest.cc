@@ -426,6 +426,36 @@ TEST_F(DesktopNotificationsTest, TestQueueing) {
   EXPECT_EQ(0, balloon_collection_->count());
 }
 
+TEST_F(DesktopNotificationsTest, TestQueueLimitPerOrigin) {
+  int process_id = 0;
+  int route_id = 0;
+
+  // Fill the balloon space and the queue, and then show one more.
+  content::ShowDesktopNotificationHostMsgParams params =
+      StandardTestNotification();
+  const int kQueueLimit =
+      BalloonNotificationUIManager::kMaxQueuedNotificationsPerOrigin;
+  const int kTotal = balloon_collection_->max_balloon_count() + kQueueLimit;
+  for (int id = 1; id <= kTotal + 1; ++id) {
+    params.notification_id = id;
+    EXPECT_TRUE(service_->ShowDesktopNotification(
+        params, process_id, route_id,
+        DesktopNotificationService::PageNotification));
+  }
+  base::MessageLoopForUI::current()->RunUntilIdle();
+
+  // The oldest waiting notification was closed to make room for the last.
+  std::string expected_log;
+  for (int i = 0; i < balloon_collection_->max_balloon_count(); ++i)
+    expected_log.append("notification displayed\n");
+  expected_log.append("notification closed by script\n");
+  EXPECT_EQ(expected_log, log_output_);
+
+  std::vector<const Notification*> queued;
+  ui_manager_->GetQueuedNotificationsForTesting(&queued);
+  EXPECT_EQ(static_cast<size_t>(kQueueLimit), queued.size());
+}
+
 TEST_F(DesktopNotificationsTest, TestEarlyDestruction) {
   // Create some toasts and then prematurely delete the notification service,
   // just to make sure nothing crashes/leaks.
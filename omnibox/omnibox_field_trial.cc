@@ -24,6 +24,8 @@ const char kHUPCullRedirectsFieldTrialName[] = "OmniboxHUPCullRedirects";
 const char kHUPCreateShorterMatchFieldTrialName[] =
     "OmniboxHUPCreateShorterMatch";
 const char kStopTimerFieldTrialName[] = "OmniboxStopTimer";
+const char kHQPCompactIndexFieldTrialName[] = "OmniboxHQPCompactIndex";
+const char kHQPParallelScoringFieldTrialName[] = "OmniboxHQPParallelScoring";
 const char kEnableZeroSuggestGroupPrefix[] = "EnableZeroSuggest";
 const char kEnableZeroSuggestMostVisitedGroupPrefix[] =
     "EnableZeroSuggestMostVisited";
@@ -58,6 +60,8 @@ const base::FieldTrial::Probability
 // Experiment group names.
 
 const char kStopTimerExperimentGroupName[] = "UseStopTimer";
+const char kHQPCompactIndexExperimentGroupName[] = "UseCompactIndex";
+const char kHQPParallelScoringExperimentGroupName[] = "ScoreInParallel";
 
 // Field trial IDs.
 // Though they are not literally "const", they are set only once, in
@@ -184,6 +188,17 @@ bool OmniboxFieldTrial::InStopTimerFieldTrialExperimentGroup() {
           kStopTimerExperimentGroupName);
 }
 
+bool OmniboxFieldTrial::InHQPCompactIndexFieldTrialExperimentGroup() {
+  return (base::FieldTrialList::FindFullName(kHQPCompactIndexFieldTrialName) ==
+          kHQPCompactIndexExperimentGroupName);
+}
+
+bool OmniboxFieldTrial::InHQPParallelScoringFieldTrialExperimentGroup() {
+  return (base::FieldTrialList::FindFullName(
+              kHQPParallelScoringFieldTrialName) ==
+          kHQPParallelScoringExperimentGroupName);
+}
+
 bool OmniboxFieldTrial::HasDynamicFieldTrialGroupPrefix(
     const char* group_prefix) {
   // Make sure that Autocomplete dynamic field trials are activated.  It's OK to
@@ -272,6 +287,37 @@ bool OmniboxFieldTrial::ReorderForLegalDefaultMatch(
       kReorderForLegalDefaultMatchRuleEnabled;
 }
 
+void OmniboxFieldTrial::GetProviderDeadlines(
+    AutocompleteInput::PageClassification current_page_classification,
+    ProviderDeadlinesMs* deadlines) {
+  deadlines->clear();
+  const std::string deadlines_rule =
+      OmniboxFieldTrial::GetValueForRuleInContext(
+          kProviderDeadlinesRule,
+          current_page_classification);
+  // The value of the ProviderDeadlines rule is a comma-separated list of
+  // {ProviderType + ":" + Number} where ProviderType is an
+  // AutocompleteProvider::Type enum represented as an integer and Number is
+  // the provider's deadline in milliseconds.
+  base::StringPairs kv_pairs;
+  if (base::SplitStringIntoKeyValuePairs(deadlines_rule, ':', ',', &kv_pairs)) {
+    for (base::StringPairs::const_iterator it = kv_pairs.begin();
+         it != kv_pairs.end(); ++it) {
+      int k, v;
+      if (base::StringToInt(it->first, &k) &&
+          base::StringToInt(it->second, &v) && (v > 0))
+        (*deadlines)[k] = v;
+    }
+  }
+}
+
+bool OmniboxFieldTrial::KeepVisibleOrder(
+    AutocompleteInput::PageClassification current_page_classification) {
+  return OmniboxFieldTrial::GetValueForRuleInContext(
+      kKeepVisibleOrderRule, current_page_classification) ==
+      kKeepVisibleOrderRuleEnabled;
+}
+
 const char OmniboxFieldTrial::kBundledExperimentFieldTrialName[] =
     "OmniboxBundledExperimentV1";
 const char OmniboxFieldTrial::kShortcutsScoringMaxRelevanceRule[] =
@@ -280,8 +326,12 @@ const char OmniboxFieldTrial::kSearchHistoryRule[] = "SearchHistory";
 const char OmniboxFieldTrial::kDemoteByTypeRule[] = "DemoteByType";
 const char OmniboxFieldTrial::kReorderForLegalDefaultMatchRule[] =
     "ReorderForLegalDefaultMatch";
+const char OmniboxFieldTrial::kProviderDeadlinesRule[] = "ProviderDeadlines";
+const char OmniboxFieldTrial::kKeepVisibleOrderRule[] = "KeepVisibleOrder";
 const char OmniboxFieldTrial::kReorderForLegalDefaultMatchRuleEnabled[] =
     "ReorderForLegalDefaultMatch";
+const char OmniboxFieldTrial::kKeepVisibleOrderRuleEnabled[] =
+    "KeepVisibleOrder";
 
 // Background and implementation details:
 //
@@ -22,6 +22,11 @@ class OmniboxFieldTrial {
   // given number.  Omitted types are assumed to have multipliers of 1.0.
   typedef std::map<AutocompleteMatchType::Type, float> DemotionMultipliers;
 
+  // A mapping from AutocompleteProvider::Type values to the time, in
+  // milliseconds, a provider is given to finish a query before it is stopped.
+  // Omitted providers have no deadline.
+  typedef std::map<int, int> ProviderDeadlinesMs;
+
   // Creates the static field trial groups.
   // *** MUST NOT BE CALLED MORE THAN ONCE. ***
   static void ActivateStaticTrials();
@@ -89,6 +94,21 @@ class OmniboxFieldTrial {
   // they're arriving so late.
   static bool InStopTimerFieldTrialExperimentGroup();
 
+  // ---------------------------------------------------------
+  // For the HistoryQuick provider compact index field trial.
+
+  // Returns whether the InMemoryURLIndex should keep its character and word
+  // indexes in the compact, sorted-vector representation rather than in
+  // std::map/std::set trees.
+  static bool InHQPCompactIndexFieldTrialExperimentGroup();
+
+  // ---------------------------------------------------------
+  // For the HistoryQuick provider parallel scoring field trial.
+
+  // Returns whether the InMemoryURLIndex should spread the scoring of large
+  // candidate sets across several threads.
+  static bool InHQPParallelScoringFieldTrialExperimentGroup();
+
   // ---------------------------------------------------------
   // For the ZeroSuggestProvider field trial.
 
@@ -161,6 +181,28 @@ class OmniboxFieldTrial {
   static bool ReorderForLegalDefaultMatch(
       AutocompleteInput::PageClassification current_page_classification);
 
+  // ---------------------------------------------------------
+  // For the ProviderDeadlines experiment that's part of the bundled omnibox
+  // field trial.
+
+  // If the user is in an experiment group that, in the provided
+  // |current_page_classification| context, limits how long providers may
+  // take to finish a query, populates |deadlines| appropriately.  Otherwise,
+  // clears |deadlines|.
+  static void GetProviderDeadlines(
+      AutocompleteInput::PageClassification current_page_classification,
+      ProviderDeadlinesMs* deadlines);
+
+  // ---------------------------------------------------------
+  // For the KeepVisibleOrder experiment that's part of the bundled omnibox
+  // field trial.
+
+  // Returns true if, in the provided |current_page_classification| context,
+  // matches that arrive after the popup has been shown should be merged in
+  // below the matches already shown rather than being sorted among them.
+  static bool KeepVisibleOrder(
+      AutocompleteInput::PageClassification current_page_classification);
+
   // ---------------------------------------------------------
   // Exposed publicly for the sake of unittests.
   static const char kBundledExperimentFieldTrialName[];
@@ -169,8 +211,11 @@ class OmniboxFieldTrial {
   static const char kSearchHistoryRule[];
   static const char kDemoteByTypeRule[];
   static const char kReorderForLegalDefaultMatchRule[];
+  static const char kProviderDeadlinesRule[];
+  static const char kKeepVisibleOrderRule[];
   // Rule values.
   static const char kReorderForLegalDefaultMatchRuleEnabled[];
+  static const char kKeepVisibleOrderRuleEnabled[];
 
  private:
   friend class OmniboxFieldTrialTest;
@@ -188,6 +188,31 @@ TEST_F(OmniboxFieldTrialTest, GetDemotionsByTypeWithFallback) {
   VerifyDemotion(demotions_by_type, AutocompleteMatchType::HISTORY_URL, 0.25);
 }
 
+TEST_F(OmniboxFieldTrialTest, GetProviderDeadlines) {
+  {
+    std::map<std::string, std::string> params;
+    params[std::string(OmniboxFieldTrial::kProviderDeadlinesRule) + ":1:*"] =
+        "4:300,16:abc,64:0";
+    params[std::string(OmniboxFieldTrial::kProviderDeadlinesRule) + ":*:*"] =
+        "4:800,2:150";
+    ASSERT_TRUE(chrome_variations::AssociateVariationParams(
+        OmniboxFieldTrial::kBundledExperimentFieldTrialName, "A", params));
+  }
+  base::FieldTrialList::CreateFieldTrial(
+      OmniboxFieldTrial::kBundledExperimentFieldTrialName, "A");
+  OmniboxFieldTrial::ProviderDeadlinesMs deadlines;
+  // Malformed and non-positive deadlines are ignored.
+  OmniboxFieldTrial::GetProviderDeadlines(
+      AutocompleteInput::NEW_TAB_PAGE, &deadlines);
+  ASSERT_EQ(1u, deadlines.size());
+  EXPECT_EQ(300, deadlines[4]);
+  OmniboxFieldTrial::GetProviderDeadlines(
+      AutocompleteInput::BLANK, &deadlines);
+  ASSERT_EQ(2u, deadlines.size());
+  EXPECT_EQ(800, deadlines[4]);
+  EXPECT_EQ(150, deadlines[2]);
+}
+
 TEST_F(OmniboxFieldTrialTest, GetValueForRuleInContext) {
   // This test starts with Instant Extended off (the default state), then
   // enables Instant Extended and tests again on the same rules.
@@ -182,6 +182,7 @@ bool LoginDatabase::Init(const base::FilePath& db_path) {
   }
 
   public_suffix_domain_matching_ = IsPublicSuffixDomainMatchingEnabled();
+  LoadRegistryControlledDomains();
 
   return true;
 }
@@ -257,6 +258,16 @@ bool LoginDatabase::InitLoginsTable() {
   return true;
 }
 
+void LoginDatabase::LoadRegistryControlledDomains() {
+  registry_controlled_domains_.clear();
+  sql::Statement s(db_.GetUniqueStatement(
+      "SELECT DISTINCT signon_realm FROM logins"));
+  while (s.Step()) {
+    registry_controlled_domains_.insert(
+        GetRegistryControlledDomain(s.ColumnString(0)));
+  }
+}
+
 void LoginDatabase::ReportMetrics() {
   sql::Statement s(db_.GetCachedStatement(
       SQL_FROM_HERE,
@@ -348,7 +359,11 @@ bool LoginDatabase::AddLogin(const PasswordForm& form) {
              form_data_pickle.data(),
              form_data_pickle.size());
 
-  return s.Run();
+  if (!s.Run())
+    return false;
+  registry_controlled_domains_.insert(
+      GetRegistryControlledDomain(form.signon_realm));
+  return true;
 }
 
 bool LoginDatabase::UpdateLogin(const PasswordForm& form, int* items_changed) {
@@ -485,8 +500,11 @@ bool LoginDatabase::GetLogins(const PasswordForm& form,
   const GURL signon_realm(form.signon_realm);
   std::string registered_domain = GetRegistryControlledDomain(signon_realm);
   PSLDomainMatchMetric psl_domain_match_metric = PSL_DOMAIN_MATCH_NONE;
+  // The regexp query can't use the signon_realm index, so only run it when
+  // some stored login is under the same registry controlled domain.
   if (public_suffix_domain_matching_ &&
-      ShouldPSLDomainMatchingApply(registered_domain)) {
+      ShouldPSLDomainMatchingApply(registered_domain) &&
+      registry_controlled_domains_.count(registered_domain)) {
     // We are extending the original SQL query with one that includes more
     // possible matches based on public suffix domain matching. Using a regexp
     // here is just an optimization to not have to parse all the stored entries
@@ -516,7 +534,10 @@ bool LoginDatabase::GetLogins(const PasswordForm& form,
     s.BindString(0, form.signon_realm);
     s.BindString(1, regexp);
   } else {
-    psl_domain_match_metric = PSL_DOMAIN_MATCH_DISABLED;
+    if (!public_suffix_domain_matching_ ||
+        !ShouldPSLDomainMatchingApply(registered_domain)) {
+      psl_domain_match_metric = PSL_DOMAIN_MATCH_DISABLED;
+    }
     s.Assign(db_.GetCachedStatement(SQL_FROM_HERE, sql_query.c_str()));
     s.BindString(0, form.signon_realm);
   }
@@ -5,6 +5,7 @@
 #ifndef CHROME_BROWSER_PASSWORD_MANAGER_LOGIN_DATABASE_H_
 #define CHROME_BROWSER_PASSWORD_MANAGER_LOGIN_DATABASE_H_
 
+#include <set>
 #include <string>
 #include <vector>
 
@@ -110,6 +111,9 @@ class LoginDatabase {
   bool InitLoginsTable();
   bool MigrateOldVersionsAsNeeded();
 
+  // Fills |registry_controlled_domains_| from the stored logins.
+  void LoadRegistryControlledDomains();
+
   // Fills |form| from the values in the given statement (which is assumed to
   // be of the form used by the Get*Logins methods).
   // Returns the EncryptionResult from decrypting the password in |s|; if not
@@ -133,6 +137,11 @@ class LoginDatabase {
   // Set to true if the public suffix based domain matching is enabled.
   bool public_suffix_domain_matching_;
 
+  // The registry controlled domains of the stored logins, to skip the public
+  // suffix domain matching query for the other domains. Removing logins does
+  // not update it, so it may contain domains no login is stored for anymore.
+  std::set<std::string> registry_controlled_domains_;
+
   DISALLOW_COPY_AND_ASSIGN(LoginDatabase);
 };
 
@@ -38,7 +38,11 @@ class LoginDatabaseTest : public testing::Test {
   }
 
   void SetPublicSuffixMatching(bool enabled) {
-    db_.public_suffix_domain_matching_ = enabled;
+    SetPublicSuffixMatching(&db_, enabled);
+  }
+
+  void SetPublicSuffixMatching(LoginDatabase* db, bool enabled) {
+    db->public_suffix_domain_matching_ = enabled;
   }
 
   void FormsAreEqual(const PasswordForm& expected, const PasswordForm& actual) {
@@ -246,6 +250,38 @@ TEST_F(LoginDatabaseTest, TestPublicSuffixDomainMatching) {
   result.clear();
 }
 
+TEST_F(LoginDatabaseTest, TestPublicSuffixDomainMatchingAfterReopen) {
+  base::FilePath file = temp_dir_.path().AppendASCII("TestReopenDatabase");
+  PasswordForm form;
+  form.origin = GURL("https://foo.com/");
+  form.action = GURL("https://foo.com/login");
+  form.username_element = ASCIIToUTF16("username");
+  form.username_value = ASCIIToUTF16("test@gmail.com");
+  form.password_element = ASCIIToUTF16("password");
+  form.password_value = ASCIIToUTF16("test");
+  form.signon_realm = "https://foo.com/";
+  form.scheme = PasswordForm::SCHEME_HTML;
+  {
+    LoginDatabase db;
+    ASSERT_TRUE(db.Init(file));
+    EXPECT_TRUE(db.AddLogin(form));
+  }
+
+  // The domains of the logins stored before Init() are matched too.
+  LoginDatabase db;
+  ASSERT_TRUE(db.Init(file));
+  SetPublicSuffixMatching(&db, true);
+  PasswordForm form2(form);
+  form2.origin = GURL("https://mobile.foo.com/");
+  form2.action = GURL("https://mobile.foo.com/login");
+  form2.signon_realm = "https://mobile.foo.com/";
+  std::vector<PasswordForm*> result;
+  EXPECT_TRUE(db.GetLogins(form2, &result));
+  ASSERT_EQ(1U, result.size());
+  EXPECT_EQ("https://foo.com/", result[0]->original_signon_realm);
+  delete result[0];
+}
+
 TEST_F(LoginDatabaseTest, TestPublicSuffixDomainMatchingShouldMatchingApply) {
   SetPublicSuffixMatching(true);
   std::vector<PasswordForm*> result;
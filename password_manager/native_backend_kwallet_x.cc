@@ -8,11 +8,13 @@
 
 #include "base/bind.h"
 #include "base/logging.h"
+#include "base/metrics/histogram.h"
 #include "base/pickle.h"
 #include "base/stl_util.h"
 #include "base/strings/stringprintf.h"
 #include "base/synchronization/waitable_event.h"
 #include "base/threading/thread_restrictions.h"
+#include "base/time/time.h"
 #include "content/public/browser/browser_thread.h"
 #include "dbus/bus.h"
 #include "dbus/message.h"
@@ -426,10 +428,14 @@ bool NativeBackendKWallet::RemoveLoginsCreatedBetween(
 
 bool NativeBackendKWallet::GetLogins(const PasswordForm& form,
                                      PasswordFormList* forms) {
+  base::TimeTicks start_time = base::TimeTicks::Now();
   int wallet_handle = WalletHandle();
   if (wallet_handle == kInvalidKWalletHandle)
     return false;
-  return GetLoginsList(forms, form.signon_realm, wallet_handle);
+  bool ok = GetLoginsList(forms, form.signon_realm, wallet_handle);
+  UMA_HISTOGRAM_TIMES("PasswordManager.KWalletGetLoginsTime",
+                      base::TimeTicks::Now() - start_time);
+  return ok;
 }
 
 bool NativeBackendKWallet::GetLoginsCreatedBetween(const base::Time& get_begin,
@@ -570,7 +576,69 @@ bool NativeBackendKWallet::GetLoginsList(PasswordFormList* forms,
 
 bool NativeBackendKWallet::GetAllLogins(PasswordFormList* forms,
                                         int wallet_handle) {
-  // We could probably also use readEntryList here.
+  base::TimeTicks start_time = base::TimeTicks::Now();
+  // Older versions of kwalletd don't have readEntryList, so fall back to
+  // reading the entries one by one if it fails.
+  bool ok = ReadEntryList(forms, wallet_handle) ||
+            ReadEachEntry(forms, wallet_handle);
+  UMA_HISTOGRAM_TIMES("PasswordManager.KWalletGetAllLoginsTime",
+                      base::TimeTicks::Now() - start_time);
+  return ok;
+}
+
+bool NativeBackendKWallet::ReadEntryList(PasswordFormList* forms,
+                                         int wallet_handle) {
+  dbus::MethodCall method_call(kKWalletInterface, "readEntryList");
+  dbus::MessageWriter builder(&method_call);
+  builder.AppendInt32(wallet_handle);  // handle
+  builder.AppendString(folder_name_);  // folder
+  builder.AppendString("*");           // key
+  builder.AppendString(app_name_);     // appid
+  scoped_ptr<dbus::Response> response(
+      kwallet_proxy_->CallMethodAndBlock(
+          &method_call, dbus::ObjectProxy::TIMEOUT_USE_DEFAULT));
+  if (!response.get()) {
+    LOG(WARNING) << "Error contacting kwalletd (readEntryList)";
+    return false;
+  }
+  dbus::MessageReader reader(response.get());
+  dbus::MessageReader array_reader(NULL);
+  if (!reader.PopArray(&array_reader)) {
+    LOG(ERROR) << "Error reading response from kwalletd (readEntryList): "
+               << response->ToString();
+    return false;
+  }
+
+  // Only add the forms once the whole response has been read, so that the
+  // caller can fall back to ReadEachEntry() on error.
+  PasswordFormList all_forms;
+  while (array_reader.HasMoreData()) {
+    dbus::MessageReader entry_reader(NULL);
+    dbus::MessageReader variant_reader(NULL);
+    std::string signon_realm;
+    uint8_t* bytes = NULL;
+    size_t length = 0;
+    if (!array_reader.PopDictEntry(&entry_reader) ||
+        !entry_reader.PopString(&signon_realm) ||
+        !entry_reader.PopVariant(&variant_reader) ||
+        !variant_reader.PopArrayOfBytes(&bytes, &length)) {
+      LOG(ERROR) << "Error reading response from kwalletd (readEntryList): "
+                 << response->ToString();
+      STLDeleteElements(&all_forms);
+      return false;
+    }
+    if (!bytes || !CheckSerializedValue(bytes, length, signon_realm))
+      continue;
+
+    Pickle pickle(reinterpret_cast<const char*>(bytes), length);
+    DeserializeValue(signon_realm, pickle, &all_forms);
+  }
+  forms->insert(forms->end(), all_forms.begin(), all_forms.end());
+  return true;
+}
+
+bool NativeBackendKWallet::ReadEachEntry(PasswordFormList* forms,
+                                         int wallet_handle) {
   std::vector<std::string> realm_list;
   {
     dbus::MethodCall method_call(kKWalletInterface, "entryList");
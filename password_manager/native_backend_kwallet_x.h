@@ -99,6 +99,13 @@ class NativeBackendKWallet : public PasswordStoreX::NativeBackend {
   // Helper for some of the above GetLoginsList() methods.
   bool GetAllLogins(PasswordFormList* forms, int wallet_handle);
 
+  // Reads all the PasswordForms from the wallet in a single call to kwalletd.
+  // Returns false, leaving |forms| unchanged, if the call fails.
+  bool ReadEntryList(PasswordFormList* forms, int wallet_handle);
+
+  // Reads all the PasswordForms from the wallet one signon_realm at a time.
+  bool ReadEachEntry(PasswordFormList* forms, int wallet_handle);
+
   // Writes a list of PasswordForms to the wallet with the given signon_realm.
   // Overwrites any existing list for this signon_realm. Removes the entry if
   // |forms| is empty. Returns true on success.
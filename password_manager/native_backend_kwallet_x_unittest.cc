@@ -413,6 +413,38 @@ dbus::Response* NativeBackendKWalletTest::KWalletMethodCall(
       dbus::MessageWriter writer(response.get());
       writer.AppendArrayOfBytes(value.data(), value.size());
     }
+  } else if (method_call->GetMember() == "readEntryList") {
+    dbus::MessageReader reader(method_call);
+    int handle = NativeBackendKWalletStub::kInvalidKWalletHandle;
+    std::string folder_name;
+    std::string pattern;
+    std::string app_name;
+    EXPECT_TRUE(reader.PopInt32(&handle));
+    EXPECT_TRUE(reader.PopString(&folder_name));
+    EXPECT_TRUE(reader.PopString(&pattern));
+    EXPECT_TRUE(reader.PopString(&app_name));
+    EXPECT_NE(NativeBackendKWalletStub::kInvalidKWalletHandle, handle);
+    EXPECT_EQ("*", pattern);
+    std::vector<std::string> entries;
+    if (wallet_.entryList(folder_name, &entries)) {
+      response = dbus::Response::CreateEmpty();
+      dbus::MessageWriter writer(response.get());
+      dbus::MessageWriter array_writer(NULL);
+      writer.OpenArray("{sv}", &array_writer);
+      for (size_t i = 0; i < entries.size(); ++i) {
+        TestKWallet::Blob value;
+        EXPECT_TRUE(wallet_.readEntry(folder_name, entries[i], &value));
+        dbus::MessageWriter entry_writer(NULL);
+        dbus::MessageWriter variant_writer(NULL);
+        array_writer.OpenDictEntry(&entry_writer);
+        entry_writer.AppendString(entries[i]);
+        entry_writer.OpenVariant("ay", &variant_writer);
+        variant_writer.AppendArrayOfBytes(value.data(), value.size());
+        entry_writer.CloseContainer(&variant_writer);
+        array_writer.CloseContainer(&entry_writer);
+      }
+      writer.CloseContainer(&array_writer);
+    }
   } else if (method_call->GetMember() == "writeEntry") {
     dbus::MessageReader reader(method_call);
     int handle = NativeBackendKWalletStub::kInvalidKWalletHandle;
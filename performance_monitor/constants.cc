@@ -13,6 +13,10 @@ const char kMetricNotFoundError[] = "Metric details not found.";
 // its activity.
 const char kProcessChromeAggregate[] = "chrome_aggregate";
 
+// The startup time metrics of the phases on the startup critical path use the
+// name of the phase, with this prefix, as their activity.
+const char kStartupPhaseActivityPrefix[] = "startup_phase:";
+
 // Tokens to retrieve state values from the database.
 
 // Stores information about the previous chrome version.
@@ -21,4 +25,12 @@ const char kStateChromeVersion[] = "chrome_version";
 // collisions in the database.
 const char kStateProfilePrefix[] = "profile";
 
+namespace switches {
+
+// Writes the phases of startup to the given file, in the trace format of
+// chrome://tracing.
+const char kStartupTraceFile[] = "startup-trace-file";
+
+}  // namespace switches
+
 }  // namespace performance_monitor
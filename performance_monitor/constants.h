@@ -16,11 +16,17 @@ namespace performance_monitor {
 
 extern const char kMetricNotFoundError[];
 extern const char kProcessChromeAggregate[];
+extern const char kStartupPhaseActivityPrefix[];
 
 // State tokens
 extern const char kStateChromeVersion[];
 extern const char kStateProfilePrefix[];
 
+// Switches
+namespace switches {
+extern const char kStartupTraceFile[];
+}  // namespace switches
+
 // The interval the watched processes are sampled for performance metrics.
 const int kSampleIntervalInSeconds = 10;
 // The default interval at which PerformanceMonitor performs its timed
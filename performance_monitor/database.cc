@@ -4,14 +4,19 @@
 
 #include "chrome/browser/performance_monitor/database.h"
 
+#include <algorithm>
+
 #include "base/file_util.h"
 #include "base/files/file_path.h"
+#include "base/format_macros.h"
 #include "base/json/json_reader.h"
 #include "base/json/json_writer.h"
 #include "base/logging.h"
 #include "base/path_service.h"
 #include "base/stl_util.h"
 #include "base/strings/string_number_conversions.h"
+#include "base/strings/string_split.h"
+#include "base/strings/stringprintf.h"
 #include "base/strings/utf_string_conversions.h"
 #include "base/time/time.h"
 #include "chrome/browser/performance_monitor/key_builder.h"
@@ -30,11 +35,62 @@ const char kEventDb[] = "Events";
 const char kStateDb[] = "Configuration";
 const char kActiveIntervalDb[] = "Active Interval";
 const char kMetricDb[] = "Metrics";
+const char kRollupDb[] = "Metric Rollups";
 const double kDefaultMaxValue = 0.0;
 
 // If the db is quiet for this number of minutes, then it is considered down.
 const base::TimeDelta kActiveIntervalTimeout = base::TimeDelta::FromMinutes(5);
 
+// Statistics are kept in the metric db for this number of days. Older ones are
+// only available as the means of the rollup db.
+const int kRawMetricRetentionDays = 90;
+
+// The number of hours between two deletions of old statistics.
+const int kMetricDeletionIntervalHours = 24;
+
+// The delimiter of the fields of the rollup db values.
+const char kRollupDelimiter = ' ';
+
+// The accumulated statistics of a rollup db entry.
+struct Rollup {
+  Rollup() : count(0), sum(0.0) {}
+
+  int count;
+  double sum;
+  base::Time last_time;
+};
+
+// Parses a rollup db value. Returns false if it is malformed.
+bool RollupFromString(const std::string& value, Rollup* rollup) {
+  std::vector<std::string> fields;
+  base::SplitString(value, kRollupDelimiter, &fields);
+  int64 last_time = 0;
+  if (fields.size() != 3u ||
+      !base::StringToInt(fields[0], &rollup->count) ||
+      !base::StringToDouble(fields[1], &rollup->sum) ||
+      !base::StringToInt64(fields[2], &last_time) ||
+      rollup->count <= 0) {
+    return false;
+  }
+  rollup->last_time = base::Time::FromInternalValue(last_time);
+  return true;
+}
+
+std::string RollupToString(const Rollup& rollup) {
+  return base::StringPrintf("%d%c%s%c%" PRId64, rollup.count, kRollupDelimiter,
+                            base::DoubleToString(rollup.sum).c_str(),
+                            kRollupDelimiter,
+                            rollup.last_time.ToInternalValue());
+}
+
+// Returns the start of the rollup interval containing |time|.
+base::Time GetRollupIntervalStart(const base::Time& time) {
+  int64 interval = base::TimeDelta::FromMinutes(
+      Database::kRollupIntervalMinutes).ToInternalValue();
+  int64 value = time.ToInternalValue();
+  return base::Time::FromInternalValue(value - value % interval);
+}
+
 TimeRange ActiveIntervalToTimeRange(const std::string& start_time,
                                     const std::string& end_time) {
   int64 start_time_int = 0;
@@ -68,6 +124,8 @@ scoped_ptr<Event> EventFromJSON(const std::string& data) {
 const char Database::kDatabaseSequenceToken[] =
     "_performance_monitor_db_sequence_token_";
 
+const int Database::kRollupIntervalMinutes;
+
 TimeRange::TimeRange() {
 }
 
@@ -237,7 +295,60 @@ bool Database::AddMetric(const std::string& activity,
 
   bool max_value_success =
       UpdateMaxValue(activity, metric.type, metric.ValueAsString());
-  return recent_status.ok() && metric_status.ok() && max_value_success;
+  bool rollup_success = UpdateRollup(activity, metric);
+  MaybeDeleteOldMetrics();
+  return recent_status.ok() && metric_status.ok() && max_value_success &&
+         rollup_success;
+}
+
+bool Database::UpdateRollup(const std::string& activity,
+                            const Metric& metric) {
+  std::string rollup_key = key_builder_->CreateMetricKey(
+      GetRollupIntervalStart(metric.time), metric.type, activity);
+  std::string value;
+  Rollup rollup;
+  if (rollup_db_->Get(read_options_, rollup_key, &value).ok() &&
+      !RollupFromString(value, &rollup)) {
+    LOG(ERROR) << "Found bad rollup in the database: '" << value
+               << "'. Overwriting it.";
+    rollup = Rollup();
+  }
+  rollup.count++;
+  rollup.sum += metric.value;
+  rollup.last_time = std::max(rollup.last_time, metric.time);
+  return rollup_db_->Put(write_options_, rollup_key,
+                         RollupToString(rollup)).ok();
+}
+
+void Database::MaybeDeleteOldMetrics() {
+  base::Time current_time = clock_->GetTime();
+  if (!last_metric_deletion_time_.is_null() &&
+      current_time - last_metric_deletion_time_ <
+          base::TimeDelta::FromHours(kMetricDeletionIntervalHours)) {
+    return;
+  }
+  last_metric_deletion_time_ = current_time;
+  DeleteMetricsBefore(
+      current_time - base::TimeDelta::FromDays(kRawMetricRetentionDays));
+}
+
+void Database::DeleteMetricsBefore(const base::Time& time) {
+  leveldb::WriteBatch old_entries;
+  scoped_ptr<leveldb::Iterator> it(metric_db_->NewIterator(read_options_));
+  // The metric db is sorted by metric first, so the old statistics of each
+  // metric form a separate range.
+  for (int type = 0; type < METRIC_NUMBER_OF_METRICS; ++type) {
+    MetricType metric_type = static_cast<MetricType>(type);
+    std::string end_key =
+        key_builder_->CreateMetricKey(time, metric_type, std::string());
+    for (it->Seek(key_builder_->CreateMetricKey(base::Time(), metric_type,
+                                                std::string()));
+         it->Valid() && it->key().ToString() < end_key;
+         it->Next()) {
+      old_entries.Delete(it->key());
+    }
+  }
+  metric_db_->Write(write_options_, &old_entries);
 }
 
 bool Database::UpdateMaxValue(const std::string& activity,
@@ -387,6 +498,43 @@ scoped_ptr<Database::MetricVector> Database::GetStatsForActivityAndMetric(
   return results.Pass();
 }
 
+scoped_ptr<Database::MetricVector>
+Database::GetRollupStatsForActivityAndMetric(const std::string& activity,
+                                             MetricType metric_type,
+                                             const base::Time& start,
+                                             const base::Time& end) {
+  CHECK(!content::BrowserThread::CurrentlyOn(content::BrowserThread::UI));
+  scoped_ptr<MetricVector> results(new MetricVector());
+  std::string start_key = key_builder_->CreateMetricKey(
+      GetRollupIntervalStart(start), metric_type, activity);
+  std::string end_key =
+      key_builder_->CreateMetricKey(end, metric_type, activity);
+  leveldb::WriteBatch invalid_entries;
+  scoped_ptr<leveldb::Iterator> it(rollup_db_->NewIterator(read_options_));
+  for (it->Seek(start_key);
+       it->Valid() && it->key().ToString() <= end_key;
+       it->Next()) {
+    MetricKey split_key =
+        key_builder_->SplitMetricKey(it->key().ToString());
+    if (split_key.activity != activity)
+      continue;
+    Rollup rollup;
+    if (!RollupFromString(it->value().ToString(), &rollup)) {
+      invalid_entries.Delete(it->key());
+      LOG(ERROR) << "Found bad rollup in the database: '"
+                 << it->value().ToString()
+                 << "'. Erasing rollup from database.";
+      continue;
+    }
+    if (rollup.last_time < start || rollup.last_time > end)
+      continue;
+    results->push_back(
+        Metric(metric_type, rollup.last_time, rollup.sum / rollup.count));
+  }
+  rollup_db_->Write(write_options_, &invalid_entries);
+  return results.Pass();
+}
+
 Database::MetricVectorMap Database::GetStatsForMetricByActivity(
     MetricType metric_type,
     const base::Time& start,
@@ -464,8 +612,11 @@ bool Database::InitDBs() {
   event_db_ = SafelyOpenDatabase(open_options,
                                  kEventDb,
                                  true);  // fix if damaged
+  rollup_db_ = SafelyOpenDatabase(open_options,
+                                  kRollupDb,
+                                  true);  // fix if damaged
   return recent_db_ && max_value_db_ && state_db_ &&
-         active_interval_db_ && metric_db_ && event_db_;
+         active_interval_db_ && metric_db_ && event_db_ && rollup_db_;
 }
 
 scoped_ptr<leveldb::DB> Database::SafelyOpenDatabase(
@@ -536,6 +687,7 @@ scoped_ptr<leveldb::DB> Database::SafelyOpenDatabase(
 bool Database::Close() {
   CHECK(!content::BrowserThread::CurrentlyOn(content::BrowserThread::UI));
   metric_db_.reset();
+  rollup_db_.reset();
   event_db_.reset();
   recent_db_.reset();
   max_value_db_.reset();
@@ -96,6 +96,17 @@ class DatabaseTestHelper;
 // interval.
 // Key: Metric - Time - Activity
 // Value: Statistic
+// Statistics older than kRawMetricRetentionDays are deleted, but remain
+// available through the rollup db.
+//
+// Rollup DB:
+// Stores, for each (metric, activity) pair and each interval of
+// kRollupIntervalMinutes, the number and the sum of the statistics inserted for
+// that interval, as well as the time of the last one. It is updated on every
+// insert, so that the mean statistics over long time ranges can be retrieved
+// without reading every statistic.
+// Key: Metric - Start of Interval - Activity
+// Value: Count - Sum - Time of Last Statistic
 class Database {
  public:
   typedef std::set<EventType> EventTypeSet;
@@ -106,6 +117,9 @@ class Database {
 
   static const char kDatabaseSequenceToken[];
 
+  // The number of minutes covered by each entry of the rollup db.
+  static const int kRollupIntervalMinutes = 60;
+
   // The class that the database will use to infer time. Abstracting out the
   // time mechanism allows for easy testing and mock data insetion.
   class Clock {
@@ -214,6 +228,23 @@ class Database {
                                         base::Time(), clock_->GetTime());
   }
 
+  // Query the mean statistics of |metric_type| and |activity| for each rollup
+  // interval between |start| and |end|. Each mean is timed at the last
+  // statistic it includes. Use this instead of GetStatsForActivityAndMetric()
+  // when the statistics are aggregated to a resolution of at least
+  // kRollupIntervalMinutes.
+  scoped_ptr<MetricVector> GetRollupStatsForActivityAndMetric(
+      const std::string& activity,
+      MetricType metric_type,
+      const base::Time& start,
+      const base::Time& end);
+
+  scoped_ptr<MetricVector> GetRollupStatsForActivityAndMetric(
+      MetricType metric_type, const base::Time& start, const base::Time& end) {
+    return GetRollupStatsForActivityAndMetric(kProcessChromeAggregate,
+                                              metric_type, start, end);
+  }
+
   // Query given |metric_type|. The returned map is keyed by activity.
   MetricVectorMap GetStatsForMetricByActivity(MetricType metric_type,
                                               const base::Time& start,
@@ -275,6 +306,14 @@ class Database {
   bool UpdateMaxValue(const std::string& activity,
                       MetricType metric,
                       const std::string& value);
+  // Adds |metric| to the rollup db entry of its interval.
+  bool UpdateRollup(const std::string& activity, const Metric& metric);
+
+  // Deletes the statistics from the metric db which are older than
+  // kRawMetricRetentionDays, at most once a day.
+  void MaybeDeleteOldMetrics();
+  // Deletes the statistics from the metric db which are older than |time|.
+  void DeleteMetricsBefore(const base::Time& time);
 
   scoped_ptr<KeyBuilder> key_builder_;
 
@@ -294,6 +333,9 @@ class Database {
   // The last time the database had a transaction.
   base::Time last_update_time_;
 
+  // The last time old statistics were deleted from the metric db.
+  base::Time last_metric_deletion_time_;
+
   scoped_ptr<Clock> clock_;
 
   scoped_ptr<leveldb::DB> recent_db_;
@@ -306,6 +348,8 @@ class Database {
 
   scoped_ptr<leveldb::DB> metric_db_;
 
+  scoped_ptr<leveldb::DB> rollup_db_;
+
   scoped_ptr<leveldb::DB> event_db_;
 
   leveldb::ReadOptions read_options_;
@@ -58,6 +58,10 @@ class DatabaseTestHelper {
     return status.ok();
   }
 
+  void DeleteMetricsBefore(const base::Time& time) {
+    database_->DeleteMetricsBefore(time);
+  }
+
   size_t GetNumberOfMetricEntries() {
     return GetNumberOfEntries(database_->metric_db_.get());
   }
@@ -531,4 +535,32 @@ TEST_F(PerformanceMonitorDatabaseMetricTest, GetRange) {
   ASSERT_EQ(9, stats[1].value);
 }
 
+TEST_F(PerformanceMonitorDatabaseMetricTest, GetRollupStats) {
+  const std::string kActivity("B");
+  base::Time start = base::Time::FromInternalValue(0) +
+      base::TimeDelta::FromMinutes(Database::kRollupIntervalMinutes);
+  base::TimeDelta interval =
+      base::TimeDelta::FromMinutes(Database::kRollupIntervalMinutes);
+  db_->AddMetric(kActivity, Metric(METRIC_CPU_USAGE, start, 2.0));
+  db_->AddMetric(kActivity,
+                 Metric(METRIC_CPU_USAGE, start + interval / 2, 4.0));
+  db_->AddMetric(kActivity, Metric(METRIC_CPU_USAGE, start + interval, 9.0));
+
+  Database::MetricVector stats = *db_->GetRollupStatsForActivityAndMetric(
+      kActivity, METRIC_CPU_USAGE, start, start + interval * 2);
+  ASSERT_EQ(2u, stats.size());
+  EXPECT_EQ(3.0, stats[0].value);
+  EXPECT_EQ(start + interval / 2, stats[0].time);
+  EXPECT_EQ(9.0, stats[1].value);
+  EXPECT_EQ(start + interval, stats[1].time);
+
+  // The rollups outlive the statistics they were built from.
+  DatabaseTestHelper helper(db_.get());
+  helper.DeleteMetricsBefore(start + interval);
+  EXPECT_EQ(1u, db_->GetStatsForActivityAndMetric(
+      kActivity, METRIC_CPU_USAGE, start, start + interval * 2)->size());
+  EXPECT_EQ(2u, db_->GetRollupStatsForActivityAndMetric(
+      kActivity, METRIC_CPU_USAGE, start, start + interval * 2)->size());
+}
+
 }  // namespace performance_monitor
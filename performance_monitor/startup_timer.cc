@@ -4,12 +4,18 @@
 
 #include "chrome/browser/performance_monitor/startup_timer.h"
 
+#include <map>
+
 #include "base/bind.h"
+#include "base/command_line.h"
+#include "base/files/file_path.h"
 #include "base/logging.h"
 #include "base/strings/string_number_conversions.h"
 #include "chrome/browser/chrome_notification_types.h"
+#include "chrome/browser/performance_monitor/constants.h"
 #include "chrome/browser/performance_monitor/database.h"
 #include "chrome/browser/performance_monitor/performance_monitor.h"
+#include "chrome/browser/performance_monitor/startup_tracer.h"
 #include "content/public/browser/browser_thread.h"
 #include "content/public/browser/notification_details.h"
 #include "content/public/browser/notification_service.h"
@@ -25,6 +31,17 @@ void AddMetricToDatabaseOnBackgroundThread(Database* database,
   database->AddMetric(metric);
 }
 
+void AddActivityMetricToDatabaseOnBackgroundThread(Database* database,
+                                                   const std::string& activity,
+                                                   const Metric& metric) {
+  database->AddMetric(activity, metric);
+}
+
+void WriteStartupTraceOnBackgroundThread(const base::FilePath& path) {
+  if (!StartupTracer::GetInstance()->WriteTrace(path))
+    LOG(WARNING) << "Failed to write the startup trace to " << path.value();
+}
+
 }  // namespace
 
 // static
@@ -32,10 +49,14 @@ StartupTimer* StartupTimer::g_startup_timer_ = NULL;
 
 StartupTimer::StartupTimer() : startup_begin_(base::TimeTicks::Now()),
                                startup_type_(STARTUP_NORMAL),
+                               startup_trace_complete_(false),
                                performance_monitor_initialized_(false) {
   CHECK(!g_startup_timer_);
   g_startup_timer_ = this;
 
+  // Startup phases are traced from now on.
+  StartupTracer::GetInstance();
+
   // We need this check because, under certain rare circumstances,
   // NotificationService::current() will return null, and this will cause a
   // segfault in NotificationServiceImpl::AddObserver(). Currently, this only
@@ -63,6 +84,9 @@ bool StartupTimer::SignalStartupComplete(StartupType startup_type) {
   if (performance_monitor_initialized_)
     InsertElapsedStartupTime();
 
+  StartupTracer::GetInstance()->Finish(
+      base::Bind(&StartupTimer::OnStartupTraceComplete));
+
   return true;
 }
 
@@ -96,6 +120,8 @@ void StartupTimer::Observe(int type,
       InsertElapsedStartupTime();
     if (elapsed_session_restore_times_.size())
       InsertElapsedSessionRestoreTime();
+    if (startup_trace_complete_)
+      InsertStartupPhaseTimes();
   }
 }
 
@@ -111,6 +137,28 @@ void StartupTimer::SetElapsedSessionRestoreTime(
   }
 }
 
+// static
+void StartupTimer::OnStartupTraceComplete() {
+  const CommandLine* command_line = CommandLine::ForCurrentProcess();
+  if (command_line->HasSwitch(switches::kStartupTraceFile)) {
+    content::BrowserThread::PostBlockingPoolTask(
+        FROM_HERE,
+        base::Bind(&WriteStartupTraceOnBackgroundThread,
+                   command_line->GetSwitchValuePath(
+                       switches::kStartupTraceFile)));
+  }
+
+  // The first paint may come after the timer is gone.
+  if (!g_startup_timer_)
+    return;
+
+  g_startup_timer_->startup_trace_complete_ = true;
+  if (g_startup_timer_->performance_monitor_initialized_ &&
+      PerformanceMonitor::GetInstance()->database_logging_enabled()) {
+    g_startup_timer_->InsertStartupPhaseTimes();
+  }
+}
+
 void StartupTimer::InsertElapsedStartupTime() {
   content::BrowserThread::PostBlockingPoolSequencedTask(
       Database::kDatabaseSequenceToken,
@@ -141,4 +189,32 @@ void StartupTimer::InsertElapsedSessionRestoreTime() {
   }
 }
 
+void StartupTimer::InsertStartupPhaseTimes() {
+  // The time of a phase which is on the path more than once, e.g. because
+  // more than one profile is created, is the sum of its times.
+  const StartupTracer::Phases critical_path =
+      StartupTracer::GetInstance()->GetCriticalPath();
+  std::map<std::string, base::TimeDelta> phase_times;
+  for (StartupTracer::Phases::const_iterator iter = critical_path.begin();
+       iter != critical_path.end(); ++iter) {
+    phase_times[iter->name] += iter->end - iter->begin;
+  }
+
+  for (std::map<std::string, base::TimeDelta>::const_iterator iter =
+           phase_times.begin();
+       iter != phase_times.end(); ++iter) {
+    content::BrowserThread::PostBlockingPoolSequencedTask(
+        Database::kDatabaseSequenceToken,
+        FROM_HERE,
+        base::Bind(
+            &AddActivityMetricToDatabaseOnBackgroundThread,
+            base::Unretained(PerformanceMonitor::GetInstance()->database()),
+            kStartupPhaseActivityPrefix + iter->first,
+            Metric(startup_type_ == STARTUP_NORMAL ? METRIC_STARTUP_TIME
+                                                   : METRIC_TEST_STARTUP_TIME,
+                   base::Time::Now(),
+                   static_cast<double>(iter->second.ToInternalValue()))));
+  }
+}
+
 }  // namespace performance_monitor
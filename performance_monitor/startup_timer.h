@@ -54,9 +54,13 @@ class StartupTimer : public content::NotificationObserver {
       const base::TimeDelta& elapsed_session_restore_time);
 
  private:
+  // Invoked by the StartupTracer once the phases of startup are complete.
+  static void OnStartupTraceComplete();
+
   // Insert the elapsed time measures into PerformanceMonitor's database.
   void InsertElapsedStartupTime();
   void InsertElapsedSessionRestoreTime();
+  void InsertStartupPhaseTimes();
 
   // The time at which the startup process begins (the creation of
   // ChromeBrowserMain).
@@ -87,6 +91,9 @@ class StartupTimer : public content::NotificationObserver {
   //   with startup timing.
   std::vector<base::TimeDelta> elapsed_session_restore_times_;
 
+  // Flag whether or not the StartupTracer has completed.
+  bool startup_trace_complete_;
+
   // Flag whether or not PerformanceMonitor has been fully started.
   bool performance_monitor_initialized_;
 
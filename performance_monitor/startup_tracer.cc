@@ -0,0 +1,255 @@
+// Copyright 2013 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "chrome/browser/performance_monitor/startup_tracer.h"
+
+#include <algorithm>
+
+#include "base/file_util.h"
+#include "base/files/file_path.h"
+#include "base/json/json_writer.h"
+#include "base/lazy_instance.h"
+#include "base/logging.h"
+#include "base/values.h"
+
+namespace performance_monitor {
+
+namespace {
+
+base::LazyInstance<StartupTracer>::Leaky g_startup_tracer =
+    LAZY_INSTANCE_INITIALIZER;
+
+}  // namespace
+
+const size_t StartupTracer::kMaxPhases;
+
+StartupTracer::Phase::Phase() : thread_id(0), parent(-1) {}
+
+StartupTracer::Phase::~Phase() {}
+
+StartupTracer::StartupTracer()
+    : finishing_(false),
+      complete_(false),
+      start_(base::TimeTicks::Now()) {
+}
+
+StartupTracer::~StartupTracer() {}
+
+// static
+StartupTracer* StartupTracer::GetInstance() {
+  return g_startup_tracer.Pointer();
+}
+
+void StartupTracer::BeginPhase(const std::string& name) {
+  base::AutoLock locked(lock_);
+  if (complete_ || phases_.size() >= kMaxPhases)
+    return;
+
+  const base::PlatformThreadId thread_id = base::PlatformThread::CurrentId();
+  std::vector<int>& open = open_phases_[thread_id];
+  Phase phase;
+  phase.name = name;
+  const char* thread_name = base::PlatformThread::GetName();
+  if (thread_name)
+    phase.thread_name = thread_name;
+  phase.thread_id = thread_id;
+  phase.parent = open.empty() ? -1 : open.back();
+  phase.begin = base::TimeTicks::Now();
+  open.push_back(static_cast<int>(phases_.size()));
+  phases_.push_back(phase);
+}
+
+void StartupTracer::EndPhase(const std::string& name) {
+  base::AutoLock locked(lock_);
+  if (complete_)
+    return;
+
+  // The phase was dropped if it began past |kMaxPhases|.
+  std::vector<int>& open = open_phases_[base::PlatformThread::CurrentId()];
+  for (std::vector<int>::reverse_iterator it = open.rbegin();
+       it != open.rend(); ++it) {
+    if (phases_[*it].name == name) {
+      phases_[*it].end = base::TimeTicks::Now();
+      open.erase(--it.base());
+      return;
+    }
+  }
+}
+
+void StartupTracer::BeginAsyncPhase(const std::string& name) {
+  base::AutoLock locked(lock_);
+  if (complete_ || phases_.size() >= kMaxPhases)
+    return;
+
+  Phase phase;
+  phase.name = name;
+  const char* thread_name = base::PlatformThread::GetName();
+  if (thread_name)
+    phase.thread_name = thread_name;
+  phase.thread_id = base::PlatformThread::CurrentId();
+  phase.begin = base::TimeTicks::Now();
+  open_async_phases_.push_back(static_cast<int>(phases_.size()));
+  phases_.push_back(phase);
+}
+
+void StartupTracer::EndAsyncPhase(const std::string& name) {
+  base::Closure callback;
+  {
+    base::AutoLock locked(lock_);
+    if (complete_)
+      return;
+
+    for (std::vector<int>::iterator it = open_async_phases_.begin();
+         it != open_async_phases_.end(); ++it) {
+      if (phases_[*it].name == name) {
+        phases_[*it].end = base::TimeTicks::Now();
+        open_async_phases_.erase(it);
+        break;
+      }
+    }
+    if (!finishing_ || !open_async_phases_.empty())
+      return;
+
+    CompleteLocked(base::TimeTicks::Now());
+    callback = callback_;
+    callback_.Reset();
+  }
+  // Outside of |lock_|, |callback| will want the phases.
+  callback.Run();
+}
+
+void StartupTracer::Finish(const base::Closure& callback) {
+  {
+    base::AutoLock locked(lock_);
+    DCHECK(!finishing_);
+    finishing_ = true;
+    if (!open_async_phases_.empty()) {
+      callback_ = callback;
+      return;
+    }
+    CompleteLocked(base::TimeTicks::Now());
+  }
+  callback.Run();
+}
+
+bool StartupTracer::IsComplete() const {
+  base::AutoLock locked(lock_);
+  return complete_;
+}
+
+StartupTracer::Phases StartupTracer::GetPhases() const {
+  base::AutoLock locked(lock_);
+  DCHECK(complete_);
+  return phases_;
+}
+
+StartupTracer::Phases StartupTracer::GetCriticalPath() const {
+  base::AutoLock locked(lock_);
+  DCHECK(complete_);
+  Phases path;
+  AppendCriticalPath(-1, start_, end_, &path);
+  return path;
+}
+
+bool StartupTracer::WriteTrace(const base::FilePath& path) const {
+  base::ListValue* events = new base::ListValue;
+  {
+    base::AutoLock locked(lock_);
+    DCHECK(complete_);
+
+    std::map<base::PlatformThreadId, std::string> thread_names;
+    for (Phases::const_iterator it = phases_.begin(); it != phases_.end();
+         ++it) {
+      thread_names[it->thread_id] = it->thread_name;
+
+      base::DictionaryValue* event = new base::DictionaryValue;
+      event->SetString("cat", "startup");
+      event->SetString("name", it->name);
+      event->SetString("ph", "X");
+      event->SetInteger("pid", 0);
+      event->SetInteger("tid", static_cast<int>(it->thread_id));
+      event->SetDouble("ts", (it->begin - start_).InMicroseconds());
+      event->SetDouble("dur", (it->end - it->begin).InMicroseconds());
+      events->Append(event);
+    }
+
+    for (std::map<base::PlatformThreadId, std::string>::const_iterator it =
+             thread_names.begin();
+         it != thread_names.end(); ++it) {
+      base::DictionaryValue* event = new base::DictionaryValue;
+      event->SetString("name", "thread_name");
+      event->SetString("ph", "M");
+      event->SetInteger("pid", 0);
+      event->SetInteger("tid", static_cast<int>(it->first));
+      event->SetString("args.name", it->second);
+      events->Append(event);
+    }
+  }
+
+  base::DictionaryValue trace;
+  trace.Set("traceEvents", events);
+  std::string json;
+  base::JSONWriter::Write(&trace, &json);
+  return file_util::WriteFile(path, json.data(), json.size()) ==
+      static_cast<int>(json.size());
+}
+
+void StartupTracer::CompleteLocked(base::TimeTicks end) {
+  lock_.AssertAcquired();
+  DCHECK(!complete_);
+
+  // Phases still open end with startup.
+  for (Phases::iterator it = phases_.begin(); it != phases_.end(); ++it) {
+    if (it->end.is_null())
+      it->end = end;
+  }
+  open_phases_.clear();
+  open_async_phases_.clear();
+  end_ = end;
+  complete_ = true;
+}
+
+void StartupTracer::AppendCriticalPath(int parent,
+                                       base::TimeTicks begin,
+                                       base::TimeTicks end,
+                                       Phases* path) const {
+  std::vector<int> chain;
+  base::TimeTicks time = end;
+  for (;;) {
+    int latest = -1;
+    for (size_t i = 0; i < phases_.size(); ++i) {
+      const Phase& phase = phases_[i];
+      if (phase.parent != parent || phase.begin < begin || phase.end > time ||
+          std::find(chain.begin(), chain.end(), static_cast<int>(i)) !=
+              chain.end()) {
+        continue;
+      }
+      // Of the phases ending together, the last one began last.
+      if (latest == -1 || phase.end >= phases_[latest].end)
+        latest = static_cast<int>(i);
+    }
+    if (latest == -1)
+      break;
+    chain.push_back(latest);
+    time = phases_[latest].begin;
+  }
+
+  for (std::vector<int>::reverse_iterator it = chain.rbegin();
+       it != chain.rend(); ++it) {
+    const Phase& phase = phases_[*it];
+    path->push_back(phase);
+    AppendCriticalPath(*it, phase.begin, phase.end, path);
+  }
+}
+
+ScopedStartupPhase::ScopedStartupPhase(const std::string& name)
+    : name_(name) {
+  StartupTracer::GetInstance()->BeginPhase(name_);
+}
+
+ScopedStartupPhase::~ScopedStartupPhase() {
+  StartupTracer::GetInstance()->EndPhase(name_);
+}
+
+}  // namespace performance_monitor
@@ -0,0 +1,141 @@
+// Copyright 2013 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CHROME_BROWSER_PERFORMANCE_MONITOR_STARTUP_TRACER_H_
+#define CHROME_BROWSER_PERFORMANCE_MONITOR_STARTUP_TRACER_H_
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "base/basictypes.h"
+#include "base/callback.h"
+#include "base/synchronization/lock.h"
+#include "base/threading/platform_thread.h"
+#include "base/time/time.h"
+
+namespace base {
+class FilePath;
+}  // namespace base
+
+namespace performance_monitor {
+
+// Records the phases of startup on all threads, from the creation of
+// ChromeBrowserMain until the UI message loop starts and the async phases
+// begun by then (e.g. the first paint of a restored tab) have ended. The
+// StartupTimer finishes the tracer, and persists the critical path through
+// the phases once it is complete.
+//
+// Phases are begun and ended on the same thread, and nest within the phases
+// open on that thread. Async phases don't nest; they are begun and ended by
+// different tasks on the UI thread.
+class StartupTracer {
+ public:
+  struct Phase {
+    Phase();
+    ~Phase();
+
+    std::string name;
+    std::string thread_name;
+    base::PlatformThreadId thread_id;
+
+    // The index of the phase this one is nested in, or -1.
+    int parent;
+
+    base::TimeTicks begin;
+    base::TimeTicks end;
+  };
+  typedef std::vector<Phase> Phases;
+
+  // No more phases are recorded after this many.
+  static const size_t kMaxPhases = 1000;
+
+  StartupTracer();
+  ~StartupTracer();
+
+  // The tracer used by startup.
+  static StartupTracer* GetInstance();
+
+  // Begins and ends the phase |name| on the current thread. Ignored once
+  // the tracer is complete.
+  void BeginPhase(const std::string& name);
+  void EndPhase(const std::string& name);
+
+  // Begins and ends the async phase |name|. Ignored once the tracer is
+  // complete.
+  void BeginAsyncPhase(const std::string& name);
+  void EndAsyncPhase(const std::string& name);
+
+  // Signals that the UI message loop starts. |callback| is run on the UI
+  // thread once the open async phases have ended, which may be right away.
+  // Phases still open on other threads at that point end with startup.
+  void Finish(const base::Closure& callback);
+
+  // Whether startup is over, after which the phases don't change.
+  bool IsComplete() const;
+
+  // Returns the phases, in the order they began. Only valid once complete.
+  Phases GetPhases() const;
+
+  // Returns the critical path through the phases: going back from the end of
+  // startup, the phase that ended last before, then the phase that ended last
+  // before that one began, and so on, across threads. Within each phase on
+  // the path, the phases nested in it are walked the same way, and follow it.
+  // Only valid once complete.
+  Phases GetCriticalPath() const;
+
+  // Writes the phases to |path| as a trace which chrome://tracing can load.
+  // Only valid once complete. Returns false on error.
+  bool WriteTrace(const base::FilePath& path) const;
+
+ private:
+  // Ends startup at |end|. |lock_| must be held.
+  void CompleteLocked(base::TimeTicks end);
+
+  // Appends the critical path through the phases nested in |parent| that lie
+  // between |begin| and |end| to |path|.
+  void AppendCriticalPath(int parent,
+                          base::TimeTicks begin,
+                          base::TimeTicks end,
+                          Phases* path) const;
+
+  mutable base::Lock lock_;
+
+  Phases phases_;
+
+  // The indexes of the phases open on each thread, innermost last.
+  std::map<base::PlatformThreadId, std::vector<int> > open_phases_;
+
+  // The indexes of the async phases which are open.
+  std::vector<int> open_async_phases_;
+
+  // Whether |Finish()| was called, and whether startup is over.
+  bool finishing_;
+  bool complete_;
+
+  // When the tracer was created and when startup was over.
+  base::TimeTicks start_;
+  base::TimeTicks end_;
+
+  // Run once complete.
+  base::Closure callback_;
+
+  DISALLOW_COPY_AND_ASSIGN(StartupTracer);
+};
+
+// Records the phase |name| of startup for the lifetime of the object.
+class ScopedStartupPhase {
+ public:
+  explicit ScopedStartupPhase(const std::string& name);
+  ~ScopedStartupPhase();
+
+ private:
+  const std::string name_;
+
+  DISALLOW_COPY_AND_ASSIGN(ScopedStartupPhase);
+};
+
+}  // namespace performance_monitor
+
+#endif  // CHROME_BROWSER_PERFORMANCE_MONITOR_STARTUP_TRACER_H_
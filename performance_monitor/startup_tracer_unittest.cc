@@ -0,0 +1,96 @@
+// Copyright 2013 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "chrome/browser/performance_monitor/startup_tracer.h"
+
+#include "base/bind.h"
+#include "base/callback.h"
+#include "base/threading/platform_thread.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace performance_monitor {
+
+namespace {
+
+void SetTrue(bool* value) {
+  *value = true;
+}
+
+// Makes sure the phases around a call don't begin or end together.
+void Tick() {
+  base::PlatformThread::Sleep(base::TimeDelta::FromMilliseconds(1));
+}
+
+// Returns the names of |phases|, separated by spaces.
+std::string JoinNames(const StartupTracer::Phases& phases) {
+  std::string names;
+  for (size_t i = 0; i < phases.size(); ++i) {
+    if (i)
+      names += " ";
+    names += phases[i].name;
+  }
+  return names;
+}
+
+}  // namespace
+
+TEST(StartupTracerTest, CriticalPath) {
+  StartupTracer tracer;
+  tracer.BeginAsyncPhase("Async");
+  tracer.BeginPhase("A");
+  tracer.BeginPhase("A1");
+  Tick();
+  tracer.EndAsyncPhase("Async");
+  tracer.EndPhase("A1");
+  tracer.BeginPhase("A2");
+  tracer.EndPhase("A2");
+  tracer.EndPhase("A");
+  tracer.BeginPhase("B");
+  tracer.EndPhase("B");
+
+  bool complete = false;
+  tracer.Finish(base::Bind(&SetTrue, &complete));
+  EXPECT_TRUE(complete);
+  ASSERT_TRUE(tracer.IsComplete());
+
+  StartupTracer::Phases phases = tracer.GetPhases();
+  EXPECT_EQ("Async A A1 A2 B", JoinNames(phases));
+  EXPECT_EQ(-1, phases[1].parent);
+  EXPECT_EQ(1, phases[2].parent);
+  EXPECT_EQ(1, phases[3].parent);
+
+  // The async phase doesn't hold up startup, since it ended while A was
+  // still running.
+  EXPECT_EQ("A A1 A2 B", JoinNames(tracer.GetCriticalPath()));
+}
+
+TEST(StartupTracerTest, AsyncPhaseDelaysCompletion) {
+  StartupTracer tracer;
+  tracer.BeginAsyncPhase("Paint");
+  tracer.BeginPhase("Open");
+  Tick();
+
+  bool complete = false;
+  tracer.Finish(base::Bind(&SetTrue, &complete));
+  EXPECT_FALSE(complete);
+  EXPECT_FALSE(tracer.IsComplete());
+
+  // Phases are still recorded until the async phase ends.
+  tracer.BeginPhase("Late");
+  tracer.EndPhase("Late");
+  tracer.EndAsyncPhase("Paint");
+  EXPECT_TRUE(complete);
+  ASSERT_TRUE(tracer.IsComplete());
+
+  // Nothing is recorded once complete, and the phase still open ended with
+  // startup.
+  tracer.BeginPhase("Ignored");
+  tracer.EndPhase("Open");
+  StartupTracer::Phases phases = tracer.GetPhases();
+  EXPECT_EQ("Paint Open Late", JoinNames(phases));
+  EXPECT_FALSE(phases[1].end.is_null());
+  EXPECT_EQ("Open Late", JoinNames(tracer.GetCriticalPath()));
+}
+
+}  // namespace performance_monitor
@@ -4,6 +4,8 @@
 
 #include "chrome/browser/policy/cloud/external_policy_data_updater.h"
 
+#include <vector>
+
 #include "base/bind.h"
 #include "base/bind_helpers.h"
 #include "base/callback.h"
@@ -123,6 +125,10 @@ class ExternalPolicyDataUpdater::FetchJob
 
   void Start();
 
+  // Hands |data| fetched by another job for the same request to the callback.
+  // Returns true if the callback accepted it, in which case this job is done.
+  bool OnDataFetchedElsewhere(const std::string& data);
+
   void OnFetchFinished(ExternalPolicyDataFetcher::Result result,
                        scoped_ptr<std::string> data);
 
@@ -215,6 +221,13 @@ void ExternalPolicyDataUpdater::FetchJob::Start() {
                  base::Unretained(this)));
 }
 
+bool ExternalPolicyDataUpdater::FetchJob::OnDataFetchedElsewhere(
+    const std::string& data) {
+  if (static_cast<int64>(data.size()) > request_.max_size)
+    return false;
+  return callback_.Run(data);
+}
+
 void ExternalPolicyDataUpdater::FetchJob::OnFetchFinished(
     ExternalPolicyDataFetcher::Result result,
     scoped_ptr<std::string> data) {
@@ -268,7 +281,7 @@ void ExternalPolicyDataUpdater::FetchJob::OnFetchFinished(
   }
 
   // Signal success.
-  updater_->OnJobSucceeded(this);
+  updater_->OnJobSucceeded(this, *data);
 }
 
 void ExternalPolicyDataUpdater::FetchJob::OnFailed(net::BackoffEntry* entry) {
@@ -375,10 +388,37 @@ void ExternalPolicyDataUpdater::ScheduleJob(FetchJob* job) {
   StartNextJobs();
 }
 
-void ExternalPolicyDataUpdater::OnJobSucceeded(FetchJob* job) {
+void ExternalPolicyDataUpdater::OnJobSucceeded(FetchJob* job,
+                                               const std::string& data) {
   DCHECK(running_jobs_);
   DCHECK_EQ(job_map_[job->key()], job);
 
+  // Several keys may reference the same data. The |data| has been verified
+  // against the hash, so hand it to the other jobs for the same URL and hash
+  // instead of downloading it again. The keys are collected first because
+  // deleting a running job calls back into OnJobFailed().
+  const Request& request = job->request();
+  std::vector<std::string> duplicate_keys;
+  for (std::map<std::string, FetchJob*>::const_iterator it = job_map_.begin();
+       it != job_map_.end(); ++it) {
+    if (it->second != job && it->second->request().url == request.url &&
+        it->second->request().hash == request.hash) {
+      duplicate_keys.push_back(it->first);
+    }
+  }
+  for (std::vector<std::string>::const_iterator it = duplicate_keys.begin();
+       it != duplicate_keys.end(); ++it) {
+    std::map<std::string, FetchJob*>::iterator duplicate = job_map_.find(*it);
+    if (duplicate == job_map_.end() ||
+        !duplicate->second->OnDataFetchedElsewhere(data)) {
+      continue;
+    }
+    // If the duplicate is queued, its WeakPtr will be invalidated and skipped
+    // by StartNextJobs(). If it is running, it will call OnJobFailed().
+    delete duplicate->second;
+    job_map_.erase(duplicate);
+  }
+
   --running_jobs_;
   job_map_.erase(job->key());
   delete job;
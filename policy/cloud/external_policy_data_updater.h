@@ -91,8 +91,9 @@ class ExternalPolicyDataUpdater {
   // |max_parallel_jobs_| are running.
   void ScheduleJob(FetchJob* job);
 
-  // Callback for jobs that succeeded.
-  void OnJobSucceeded(FetchJob* job);
+  // Callback for jobs that succeeded with |data|. Other jobs for the same URL
+  // and hash are satisfied with |data| as well.
+  void OnJobSucceeded(FetchJob* job, const std::string& data);
 
   // Callback for jobs that failed.
   void OnJobFailed(FetchJob* job);
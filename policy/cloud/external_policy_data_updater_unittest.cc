@@ -156,6 +156,44 @@ TEST_F(ExternalPolicyDataUpdaterTest, FetchSuccess) {
   EXPECT_TRUE(backend_task_runner_->GetPendingTasks().empty());
 }
 
+TEST_F(ExternalPolicyDataUpdaterTest, FetchSuccessSharedWithSameRequest) {
+  // Create an updater that runs one fetch at a time.
+  CreateUpdater(1);
+
+  // Make two fetch requests with different keys for the same URL.
+  RequestExternalDataFetch(0);
+  RequestExternalDataFetch(1, 0);
+
+  // Complete the first fetch.
+  net::TestURLFetcher* fetcher = fetcher_factory_.GetFetcherByID(0);
+  ASSERT_TRUE(fetcher);
+  fetcher->set_response_code(200);
+  fetcher->SetResponseString(kExternalPolicyDataPayload);
+  fetcher->delegate()->OnURLFetchComplete(fetcher);
+
+  // Verify that the data is handed to both callbacks.
+  EXPECT_CALL(callback_listener_,
+              OnFetchSuccess(kExternalPolicyDataKeys[0],
+                             kExternalPolicyDataPayload))
+      .Times(1)
+      .WillOnce(Return(true));
+  EXPECT_CALL(callback_listener_,
+              OnFetchSuccess(kExternalPolicyDataKeys[1],
+                             kExternalPolicyDataPayload))
+      .Times(1)
+      .WillOnce(Return(true));
+  backend_task_runner_->RunPendingTasks();
+  Mock::VerifyAndClearExpectations(&callback_listener_);
+  io_task_runner_->RunUntilIdle();
+
+  // Verify that the second fetch has not been started.
+  EXPECT_FALSE(fetcher_factory_.GetFetcherByID(0));
+  EXPECT_FALSE(fetcher_factory_.GetFetcherByID(1));
+
+  // Verify that no retries have been scheduled.
+  EXPECT_TRUE(backend_task_runner_->GetPendingTasks().empty());
+}
+
 TEST_F(ExternalPolicyDataUpdaterTest, PayloadSizeExceedsLimit) {
   // Create an updater that runs one fetch at a time.
   CreateUpdater(1);
@@ -81,9 +81,17 @@ bool ResourceCache::Store(const std::string& key,
   // to protect against such races, especially as the cache is cross-platform
   // and therefore cannot use any POSIX-only tricks.
   int size = base::checked_numeric_cast<int>(data.size());
-  return VerifyKeyPathAndGetSubkeyPath(key, true, subkey, &subkey_path) &&
-         base::DeleteFile(subkey_path, false) &&
-         (file_util::WriteFile(subkey_path, data.data(), size) == size);
+  if (!VerifyKeyPathAndGetSubkeyPath(key, true, subkey, &subkey_path))
+    return false;
+  std::set<std::string>* subkeys = GetIndexedSubkeys(subkey_path.DirName());
+  const std::string name(subkey_path.BaseName().MaybeAsASCII());
+  if (!base::DeleteFile(subkey_path, false) ||
+      file_util::WriteFile(subkey_path, data.data(), size) != size) {
+    subkeys->erase(name);
+    return false;
+  }
+  subkeys->insert(name);
+  return true;
 }
 
 bool ResourceCache::Load(const std::string& key,
@@ -109,10 +117,11 @@ void ResourceCache::LoadAllSubkeys(
   if (!VerifyKeyPath(key, false, &key_path))
     return;
 
-  base::FileEnumerator enumerator(key_path, false, base::FileEnumerator::FILES);
-  for (base::FilePath path = enumerator.Next(); !path.empty();
-       path = enumerator.Next()) {
-    const std::string encoded_subkey = path.BaseName().MaybeAsASCII();
+  const std::set<std::string>* subkeys = GetIndexedSubkeys(key_path);
+  for (std::set<std::string>::const_iterator it = subkeys->begin();
+       it != subkeys->end(); ++it) {
+    const std::string& encoded_subkey = *it;
+    const base::FilePath path = key_path.AppendASCII(encoded_subkey);
     std::string subkey;
     std::string data;
     // Only read from |subkey_path| if it is not a symlink and its name is
@@ -128,8 +137,11 @@ void ResourceCache::LoadAllSubkeys(
 void ResourceCache::Delete(const std::string& key, const std::string& subkey) {
   DCHECK(task_runner_->RunsTasksOnCurrentThread());
   base::FilePath subkey_path;
-  if (VerifyKeyPathAndGetSubkeyPath(key, false, subkey, &subkey_path))
+  if (VerifyKeyPathAndGetSubkeyPath(key, false, subkey, &subkey_path)) {
     base::DeleteFile(subkey_path, false);
+    GetIndexedSubkeys(subkey_path.DirName())->erase(
+        subkey_path.BaseName().MaybeAsASCII());
+  }
   // Delete() does nothing if the directory given to it is not empty. Hence, the
   // call below deletes the directory representing |key| if its last subkey was
   // just removed and does nothing otherwise.
@@ -147,8 +159,10 @@ void ResourceCache::PurgeOtherKeys(const std::set<std::string>& keys_to_keep) {
   for (base::FilePath path = enumerator.Next(); !path.empty();
        path = enumerator.Next()) {
     const std::string name(path.BaseName().MaybeAsASCII());
-    if (encoded_keys_to_keep.find(name) == encoded_keys_to_keep.end())
+    if (encoded_keys_to_keep.find(name) == encoded_keys_to_keep.end()) {
       base::DeleteFile(path, true);
+      subkey_index_.erase(name);
+    }
   }
 }
 
@@ -164,12 +178,15 @@ void ResourceCache::PurgeOtherSubkeys(
   if (!Base64Encode(subkeys_to_keep, &encoded_subkeys_to_keep))
     return;
 
-  base::FileEnumerator enumerator(key_path, false, base::FileEnumerator::FILES);
-  for (base::FilePath path = enumerator.Next(); !path.empty();
-       path = enumerator.Next()) {
-    const std::string name(path.BaseName().MaybeAsASCII());
-    if (encoded_subkeys_to_keep.find(name) == encoded_subkeys_to_keep.end())
-      base::DeleteFile(path, false);
+  std::set<std::string>* subkeys = GetIndexedSubkeys(key_path);
+  for (std::set<std::string>::iterator it = subkeys->begin();
+       it != subkeys->end();) {
+    if (encoded_subkeys_to_keep.find(*it) == encoded_subkeys_to_keep.end()) {
+      base::DeleteFile(key_path.AppendASCII(*it), false);
+      subkeys->erase(it++);
+    } else {
+      ++it;
+    }
   }
   // Delete() does nothing if the directory given to it is not empty. Hence, the
   // call below deletes the directory representing |key| if all of its subkeys
@@ -177,6 +194,22 @@ void ResourceCache::PurgeOtherSubkeys(
   base::DeleteFile(key_path, false);
 }
 
+std::set<std::string>* ResourceCache::GetIndexedSubkeys(
+    const base::FilePath& key_path) {
+  const std::string name(key_path.BaseName().MaybeAsASCII());
+  SubkeyIndex::iterator it = subkey_index_.find(name);
+  if (it != subkey_index_.end())
+    return &it->second;
+
+  std::set<std::string>* subkeys = &subkey_index_[name];
+  base::FileEnumerator enumerator(key_path, false, base::FileEnumerator::FILES);
+  for (base::FilePath path = enumerator.Next(); !path.empty();
+       path = enumerator.Next()) {
+    subkeys->insert(path.BaseName().MaybeAsASCII());
+  }
+  return subkeys;
+}
+
 bool ResourceCache::VerifyKeyPath(const std::string& key,
                                   bool allow_create,
                                   base::FilePath* path) {
@@ -23,6 +23,10 @@ namespace policy {
 // a subkey, and can be queried by (key, subkey) or (key) lookups.
 // The contents of the cache have to be manually cleared using Delete() or
 // PurgeOtherSubkeys().
+// The names of the subkeys stored under each key are indexed in memory the
+// first time that key is accessed, so that later loads and purges don't
+// enumerate the cache directory again. Hence the cache must be the only writer
+// to |cache_path|.
 // The class can be instantiated on any thread but from then on, it must be
 // accessed via the |task_runner| only. The |task_runner| must support file I/O.
 class ResourceCache {
@@ -59,6 +63,14 @@ class ResourceCache {
                          const std::set<std::string>& subkeys_to_keep);
 
  private:
+  // Maps the base64-encoded name of a key directory to the names of the subkey
+  // files in it.
+  typedef std::map<std::string, std::set<std::string> > SubkeyIndex;
+
+  // Returns the names of the files in the directory at |key_path|. The
+  // directory is enumerated the first time only.
+  std::set<std::string>* GetIndexedSubkeys(const base::FilePath& key_path);
+
   // Points |path| at the cache directory for |key| and returns whether the
   // directory exists. If |allow_create| is |true|, the directory is created if
   // it did not exist yet.
@@ -77,6 +89,8 @@ class ResourceCache {
 
   base::FilePath cache_dir_;
 
+  SubkeyIndex subkey_index_;
+
   // Task runner that |this| runs on.
   scoped_refptr<base::SequencedTaskRunner> task_runner_;
 
@@ -109,4 +109,38 @@ TEST(ResourceCacheTest, StoreAndLoad) {
   EXPECT_EQ(kData1, contents[kSubB]);
 }
 
+TEST(ResourceCacheTest, IndexLoadedFromDisk) {
+  base::ScopedTempDir temp_dir;
+  ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
+  scoped_refptr<base::TestSimpleTaskRunner> task_runner(
+      new base::TestSimpleTaskRunner);
+  {
+    ResourceCache cache(temp_dir.path(), task_runner);
+    EXPECT_TRUE(cache.Store(kKey1, kSubA, kData0));
+    EXPECT_TRUE(cache.Store(kKey1, kSubB, kData1));
+  }
+
+  // A new cache for the same directory finds the stored subkeys.
+  ResourceCache cache(temp_dir.path(), task_runner);
+  std::map<std::string, std::string> contents;
+  cache.LoadAllSubkeys(kKey1, &contents);
+  EXPECT_EQ(2u, contents.size());
+  EXPECT_EQ(kData0, contents[kSubA]);
+  EXPECT_EQ(kData1, contents[kSubB]);
+
+  // Subkeys stored and purged after the index was loaded are reflected too.
+  EXPECT_TRUE(cache.Store(kKey1, kSubC, kData1));
+  std::set<std::string> keep;
+  keep.insert(kSubC);
+  cache.PurgeOtherSubkeys(kKey1, keep);
+  cache.LoadAllSubkeys(kKey1, &contents);
+  EXPECT_EQ(1u, contents.size());
+  EXPECT_EQ(kData1, contents[kSubC]);
+
+  // The purged subkeys are gone from disk as well.
+  std::string data;
+  EXPECT_FALSE(cache.Load(kKey1, kSubA, &data));
+  EXPECT_FALSE(cache.Load(kKey1, kSubB, &data));
+}
+
 }  // namespace policy
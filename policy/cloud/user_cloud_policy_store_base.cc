@@ -41,9 +41,13 @@ scoped_ptr<UserCloudPolicyValidator> UserCloudPolicyStoreBase::CreateValidator(
 void UserCloudPolicyStoreBase::InstallPolicy(
     scoped_ptr<enterprise_management::PolicyData> policy_data,
     scoped_ptr<enterprise_management::CloudPolicySettings> payload) {
-  // Decode the payload.
-  policy_map_.Clear();
-  DecodePolicy(*payload, external_data_manager(), &policy_map_);
+  // Decode the payload, unless it did not change since the active policy.
+  // Refreshes usually fetch the same policy again with only a new timestamp,
+  // and |policy_map_| then already holds the decoded values.
+  if (!policy_ || policy_->policy_value() != policy_data->policy_value()) {
+    policy_map_.Clear();
+    DecodePolicy(*payload, external_data_manager(), &policy_map_);
+  }
   policy_ = policy_data.Pass();
 }
 
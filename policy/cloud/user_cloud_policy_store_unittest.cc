@@ -270,6 +270,30 @@ TEST_F(UserCloudPolicyStoreTest, StoreTwoTimes) {
   EXPECT_EQ(CloudPolicyStore::STATUS_OK, store_->status());
 }
 
+TEST_F(UserCloudPolicyStoreTest, StoreUnchangedPayload) {
+  EXPECT_CALL(*external_data_manager_, OnPolicyStoreLoaded()).Times(2);
+  EXPECT_CALL(observer_, OnStoreLoaded(store_.get())).Times(2);
+  store_->Store(policy_.policy());
+  RunUntilIdle();
+  VerifyPolicyMap(store_.get());
+
+  // Store the same payload again with a newer timestamp, as a policy refresh
+  // does. The new policy data should be active and the map still complete.
+  UserPolicyBuilder newer_policy;
+  newer_policy.payload().CopyFrom(policy_.payload());
+  newer_policy.policy_data().set_timestamp(
+      PolicyBuilder::kFakeTimestamp + 1000);
+  newer_policy.Build();
+  store_->Store(newer_policy.policy());
+  RunUntilIdle();
+
+  ASSERT_TRUE(store_->policy());
+  EXPECT_EQ(newer_policy.policy_data().SerializeAsString(),
+            store_->policy()->SerializeAsString());
+  VerifyPolicyMap(store_.get());
+  EXPECT_EQ(CloudPolicyStore::STATUS_OK, store_->status());
+}
+
 TEST_F(UserCloudPolicyStoreTest, StoreThenLoad) {
   // Store a simple policy and make sure it can be read back in.
   // policy.
@@ -4,6 +4,7 @@
 
 #include "chrome/browser/policy/configuration_policy_pref_store.h"
 
+#include <set>
 #include <string>
 #include <vector>
 
@@ -80,7 +81,22 @@ void ConfigurationPolicyPrefStore::OnPolicyUpdated(
     const PolicyMap& current) {
   DCHECK_EQ(POLICY_DOMAIN_CHROME, ns.domain);
   DCHECK(ns.component_id.empty());
-  Refresh();
+
+  // The prefs of |level_| only depend on the policies of that level, and
+  // recomputing them takes running every handler. Skip that if only policies
+  // of the other level changed.
+  std::set<std::string> changed_policies;
+  current.GetDifferingKeys(previous, &changed_policies);
+  for (std::set<std::string>::const_iterator it = changed_policies.begin();
+       it != changed_policies.end(); ++it) {
+    const PolicyMap::Entry* previous_entry = previous.Get(*it);
+    const PolicyMap::Entry* current_entry = current.Get(*it);
+    if ((previous_entry && previous_entry->level == level_) ||
+        (current_entry && current_entry->level == level_)) {
+      Refresh();
+      return;
+    }
+  }
 }
 
 void ConfigurationPolicyPrefStore::OnPolicyServiceInitialized(
@@ -112,6 +112,14 @@ bool IsSpeculativeResourcePrefetchingEnabled(
 
     config->max_resources_per_entry = 100;
     return true;
+  } else if (trial == "PrefetchingDelayedWrites") {
+    config->mode |= ResourcePrefetchPredictorConfig::URL_LEARNING;
+    config->mode |= ResourcePrefetchPredictorConfig::HOST_LEARNING;
+    config->mode |= ResourcePrefetchPredictorConfig::URL_PREFETCHING;
+    config->mode |= ResourcePrefetchPredictorConfig::HOST_PRFETCHING;
+
+    config->write_back_delay_seconds = 60;
+    return true;
   } else if (trial == "LearningSmallDB") {
     config->mode |= ResourcePrefetchPredictorConfig::URL_LEARNING;
     config->mode |= ResourcePrefetchPredictorConfig::HOST_LEARNING;
@@ -207,6 +215,7 @@ ResourcePrefetchPredictorConfig::ResourcePrefetchPredictorConfig()
       min_url_visit_count(2),
       max_resources_per_entry(50),
       max_consecutive_misses(3),
+      write_back_delay_seconds(0),
       min_resource_confidence_to_trigger_prefetch(0.8f),
       min_resource_hits_to_trigger_prefetch(3),
       max_prefetches_inflight_per_navigation(24),
@@ -98,6 +98,11 @@ struct ResourcePrefetchPredictorConfig {
   // The number of consecutive misses after we stop tracking a resource URL.
   int max_consecutive_misses;
 
+  // How long changes to the URL and host data may wait before they are written
+  // to the database, so that several navigations to the same URL or host are
+  // written once. If 0, changes are written after every navigation.
+  int write_back_delay_seconds;
+
   // The minimum confidence (accuracy of hits) required for a resource to be
   // prefetched.
   float min_resource_confidence_to_trigger_prefetch;
@@ -442,6 +442,11 @@ void ResourcePrefetchPredictor::Observe(
 }
 
 void ResourcePrefetchPredictor::Shutdown() {
+  if (write_back_timer_.IsRunning()) {
+    write_back_timer_.Stop();
+    WriteBackDirtyEntries();
+  }
+
   if (prefetch_manager_.get()) {
     prefetch_manager_->ShutdownOnUIThread();
     prefetch_manager_ = NULL;
@@ -1010,12 +1015,71 @@ void ResourcePrefetchPredictor::LearnNavigation(
                    key,
                    key_type));
   } else {
-    bool is_host = key_type == PREFETCH_KEY_TYPE_HOST;
-    PrefetchData empty_data(
-        !is_host ? PREFETCH_KEY_TYPE_HOST : PREFETCH_KEY_TYPE_URL,
-        std::string());
-    const PrefetchData& host_data = is_host ? cache_entry->second : empty_data;
-    const PrefetchData& url_data = is_host ? empty_data : cache_entry->second;
+    UpdateDataInDB(key, key_type);
+  }
+}
+
+void ResourcePrefetchPredictor::UpdateDataInDB(const std::string& key,
+                                               PrefetchKeyType key_type) {
+  bool is_host = key_type == PREFETCH_KEY_TYPE_HOST;
+  if (config_.write_back_delay_seconds > 0) {
+    if (is_host)
+      dirty_hosts_.insert(key);
+    else
+      dirty_urls_.insert(key);
+    if (!write_back_timer_.IsRunning()) {
+      write_back_timer_.Start(
+          FROM_HERE,
+          base::TimeDelta::FromSeconds(config_.write_back_delay_seconds),
+          this, &ResourcePrefetchPredictor::WriteBackDirtyEntries);
+    }
+    return;
+  }
+
+  const PrefetchDataMap& data_map =
+      is_host ? *host_table_cache_ : *url_table_cache_;
+  PrefetchDataMap::const_iterator it = data_map.find(key);
+  DCHECK(it != data_map.end());
+  PrefetchData empty_data(
+      !is_host ? PREFETCH_KEY_TYPE_HOST : PREFETCH_KEY_TYPE_URL,
+      std::string());
+  const PrefetchData& host_data = is_host ? it->second : empty_data;
+  const PrefetchData& url_data = is_host ? empty_data : it->second;
+  BrowserThread::PostTask(
+      BrowserThread::DB, FROM_HERE,
+      base::Bind(&ResourcePrefetchPredictorTables::UpdateData,
+                 tables_,
+                 url_data,
+                 host_data));
+}
+
+void ResourcePrefetchPredictor::WriteBackDirtyEntries() {
+  CHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
+
+  UMA_HISTOGRAM_COUNTS_1000("ResourcePrefetchPredictor.WriteBackEntryCount",
+                            dirty_urls_.size() + dirty_hosts_.size());
+
+  // Pair up a URL and a host in each update, like the eager writes do.
+  std::set<std::string>::const_iterator url_it = dirty_urls_.begin();
+  std::set<std::string>::const_iterator host_it = dirty_hosts_.begin();
+  while (url_it != dirty_urls_.end() || host_it != dirty_hosts_.end()) {
+    PrefetchData url_data(PREFETCH_KEY_TYPE_URL, std::string());
+    for (; url_it != dirty_urls_.end() && url_data.primary_key.empty();
+         ++url_it) {
+      PrefetchDataMap::const_iterator it = url_table_cache_->find(*url_it);
+      if (it != url_table_cache_->end())
+        url_data = it->second;
+    }
+    PrefetchData host_data(PREFETCH_KEY_TYPE_HOST, std::string());
+    for (; host_it != dirty_hosts_.end() && host_data.primary_key.empty();
+         ++host_it) {
+      PrefetchDataMap::const_iterator it = host_table_cache_->find(*host_it);
+      if (it != host_table_cache_->end())
+        host_data = it->second;
+    }
+    if (url_data.primary_key.empty() && host_data.primary_key.empty())
+      break;
+
     BrowserThread::PostTask(
         BrowserThread::DB, FROM_HERE,
         base::Bind(&ResourcePrefetchPredictorTables::UpdateData,
@@ -1023,6 +1087,9 @@ void ResourcePrefetchPredictor::LearnNavigation(
                    url_data,
                    host_data));
   }
+
+  dirty_urls_.clear();
+  dirty_hosts_.clear();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -1043,6 +1110,9 @@ void ResourcePrefetchPredictor::ReportAccuracyStats(
   // 'a_' -> actual, 'p_' -> predicted.
   int p_cache_a_cache = 0, p_cache_a_network = 0, p_cache_a_notused = 0,
       p_network_a_cache = 0, p_network_a_network = 0, p_network_a_notused = 0;
+  // Bytes the prefetches fetched from the network, and whether the page used
+  // them.
+  int64 network_bytes_used = 0, network_bytes_wasted = 0;
 
   for (ResourcePrefetcher::RequestVector::iterator it = prefetched->begin();
        it != prefetched->end(); ++it) {
@@ -1096,6 +1166,11 @@ void ResourcePrefetchPredictor::ReportAccuracyStats(
             ++p_network_a_network;
           else
             ++p_network_a_notused;
+          if (req->usage_status ==
+              ResourcePrefetcher::Request::USAGE_STATUS_NOT_REQUESTED)
+            network_bytes_wasted += req->bytes_read;
+          else
+            network_bytes_used += req->bytes_read;
         break;
 
       case ResourcePrefetcher::Request::PREFETCH_STATUS_NOT_STARTED:
@@ -1148,6 +1223,11 @@ void ResourcePrefetchPredictor::ReportAccuracyStats(
       prefetch_not_started * 100.0 / (prefetch_not_started + total_prefetched));
 
 #undef RPP_HISTOGRAM_PERCENTAGE
+
+  UMA_HISTOGRAM_COUNTS("ResourcePrefetchPredictor.PrefetchFromNetworkUsedKB",
+                       network_bytes_used / 1024);
+  UMA_HISTOGRAM_COUNTS("ResourcePrefetchPredictor.PrefetchFromNetworkNotUsedKB",
+                       network_bytes_wasted / 1024);
 }
 
 void ResourcePrefetchPredictor::ReportPredictedAccuracyStats(
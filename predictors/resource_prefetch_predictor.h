@@ -6,6 +6,7 @@
 #define CHROME_BROWSER_PREDICTORS_RESOURCE_PREFETCH_PREDICTOR_H_
 
 #include <map>
+#include <set>
 #include <string>
 #include <vector>
 
@@ -14,6 +15,7 @@
 #include "base/memory/scoped_ptr.h"
 #include "base/memory/weak_ptr.h"
 #include "base/time/time.h"
+#include "base/timer/timer.h"
 #include "chrome/browser/common/cancelable_request.h"
 #include "chrome/browser/history/history_types.h"
 #include "chrome/browser/predictors/resource_prefetch_common.h"
@@ -139,6 +141,7 @@ class ResourcePrefetchPredictor
   FRIEND_TEST_ALL_PREFIXES(ResourcePrefetchPredictorTest, OnMainFrameRedirect);
   FRIEND_TEST_ALL_PREFIXES(ResourcePrefetchPredictorTest,
                            OnSubresourceResponse);
+  FRIEND_TEST_ALL_PREFIXES(ResourcePrefetchPredictorTest, DelayedWriteBack);
 
   enum InitializationState {
     NOT_INITIALIZED = 0,
@@ -262,6 +265,16 @@ class ResourcePrefetchPredictor
                        int max_data_map_size,
                        PrefetchDataMap* data_map);
 
+  // Writes the entry for |key| in the cache for |key_type| to the predictor
+  // database, either right away or with the other changed entries when
+  // |write_back_timer_| fires, depending on config_.write_back_delay_seconds.
+  void UpdateDataInDB(const std::string& key, PrefetchKeyType key_type);
+
+  // Writes the entries changed since the last write back to the predictor
+  // database. Entries deleted from the caches in the meantime have already
+  // been deleted from the database and are skipped.
+  void WriteBackDirtyEntries();
+
   // Reports accuracy by comparing prefetched resources with resources that are
   // actually used by the page.
   void ReportAccuracyStats(PrefetchKeyType key_type,
@@ -301,6 +314,12 @@ class ResourcePrefetchPredictor
   scoped_ptr<PrefetchDataMap> url_table_cache_;
   scoped_ptr<PrefetchDataMap> host_table_cache_;
 
+  // Keys of the entries in the caches changed since they were last written to
+  // the predictor database. Only used if writes are delayed.
+  std::set<std::string> dirty_urls_;
+  std::set<std::string> dirty_hosts_;
+  base::OneShotTimer<ResourcePrefetchPredictor> write_back_timer_;
+
   ResultsMap results_map_;
   STLValueDeleter<ResultsMap> results_map_deleter_;
 
@@ -923,4 +923,45 @@ TEST_F(ResourcePrefetchPredictorTest, OnSubresourceResponse) {
       predictor_->inflight_navigations_[main_frame1.navigation_id]->at(2)));
 }
 
+TEST_F(ResourcePrefetchPredictorTest, DelayedWriteBack) {
+  // Tests that with delayed writes, several navigations to a host are written
+  // to the database once, when the write back timer fires.
+  ResourcePrefetchPredictorConfig config;
+  config.mode |= ResourcePrefetchPredictorConfig::HOST_LEARNING;
+  config.write_back_delay_seconds = 60;
+  predictor_.reset(new ResourcePrefetchPredictor(config, profile_.get()));
+  predictor_->set_mock_tables(mock_tables_);
+  EXPECT_CALL(*mock_tables_.get(),
+              GetAllData(Pointee(ContainerEq(PrefetchDataMap())),
+                         Pointee(ContainerEq(PrefetchDataMap()))));
+  InitializePredictor();
+
+  std::vector<URLRequestSummary> resources;
+  resources.push_back(CreateURLRequestSummary(
+      1, 1, "http://www.google.com", "http://google.com/style1.css",
+      ResourceType::STYLESHEET, "text/css", false));
+  predictor_->LearnNavigation("www.google.com", PREFETCH_KEY_TYPE_HOST,
+                              resources, config.max_hosts_to_track,
+                              predictor_->host_table_cache_.get());
+  predictor_->LearnNavigation("www.google.com", PREFETCH_KEY_TYPE_HOST,
+                              resources, config.max_hosts_to_track,
+                              predictor_->host_table_cache_.get());
+  loop_.RunUntilIdle();
+  EXPECT_TRUE(predictor_->write_back_timer_.IsRunning());
+
+  PrefetchData host_data(PREFETCH_KEY_TYPE_HOST, "www.google.com");
+  host_data.resources.push_back(ResourceRow(std::string(),
+                                            "http://google.com/style1.css",
+                                            ResourceType::STYLESHEET,
+                                            2,
+                                            0,
+                                            0,
+                                            1.0));
+  EXPECT_CALL(*mock_tables_.get(), UpdateData(empty_url_data_, host_data));
+
+  predictor_->write_back_timer_.Stop();
+  predictor_->WriteBackDirtyEntries();
+  loop_.RunUntilIdle();
+}
+
 }  // namespace predictors
@@ -2,6 +2,7 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#include <algorithm>
 #include <iterator>
 
 #include "chrome/browser/predictors/resource_prefetcher.h"
@@ -15,6 +16,14 @@ namespace {
 // The size of the buffer used to read the resource.
 static const size_t kResourceBufferSizeBytes = 50000;
 
+// The response bytes the prefetches need to have fetched from the network
+// before their throughput is used to detect a slow connection.
+static const int64 kMinBytesToEstimateThroughput = 32 * 1024;
+
+// Below this throughput per prefetch, the connection is considered slow and
+// only one prefetch is allowed in flight at a time.
+static const int64 kSlowThroughputBytesPerSecond = 16 * 1024;
+
 }  // namespace
 
 namespace predictors {
@@ -22,13 +31,15 @@ namespace predictors {
 ResourcePrefetcher::Request::Request(const GURL& i_resource_url)
     : resource_url(i_resource_url),
       prefetch_status(PREFETCH_STATUS_NOT_STARTED),
-      usage_status(USAGE_STATUS_NOT_REQUESTED) {
+      usage_status(USAGE_STATUS_NOT_REQUESTED),
+      bytes_read(0) {
 }
 
 ResourcePrefetcher::Request::Request(const Request& other)
     : resource_url(other.resource_url),
       prefetch_status(other.prefetch_status),
-      usage_status(other.usage_status) {
+      usage_status(other.usage_status),
+      bytes_read(other.bytes_read) {
 }
 
 ResourcePrefetcher::ResourcePrefetcher(
@@ -42,7 +53,8 @@ ResourcePrefetcher::ResourcePrefetcher(
           config_(config),
           navigation_id_(navigation_id),
           key_type_(key_type),
-          request_vector_(requests.Pass()) {
+          request_vector_(requests.Pass()),
+          network_bytes_read_(0) {
   CHECK(content::BrowserThread::CurrentlyOn(content::BrowserThread::IO));
   DCHECK(request_vector_.get());
 
@@ -85,8 +97,9 @@ void ResourcePrefetcher::TryToLaunchPrefetchRequests() {
     // max_prefetches_inflight_per_host_per_navigation limit, looking for a URL
     // for which the max_prefetches_inflight_per_host_per_navigation limit has
     // not been reached. Try to launch as many requests as possible.
+    const int max_prefetches_inflight = GetMaxPrefetchesInflight();
     while ((static_cast<int>(inflight_requests_.size()) <
-                config_.max_prefetches_inflight_per_navigation) &&
+                max_prefetches_inflight) &&
            request_available) {
       std::list<Request*>::iterator request_it = request_queue_.begin();
       for (; request_it != request_queue_.end(); ++request_it) {
@@ -118,6 +131,20 @@ void ResourcePrefetcher::TryToLaunchPrefetchRequests() {
   }
 }
 
+int ResourcePrefetcher::GetMaxPrefetchesInflight() const {
+  if (network_bytes_read_ < kMinBytesToEstimateThroughput ||
+      network_time_ <= base::TimeDelta()) {
+    return config_.max_prefetches_inflight_per_navigation;
+  }
+
+  int64 throughput =
+      network_bytes_read_ * base::Time::kMicrosecondsPerSecond /
+      network_time_.InMicroseconds();
+  if (throughput < kSlowThroughputBytesPerSecond)
+    return std::min(1, config_.max_prefetches_inflight_per_navigation);
+  return config_.max_prefetches_inflight_per_navigation;
+}
+
 void ResourcePrefetcher::SendRequest(Request* request) {
   request->prefetch_status = Request::PREFETCH_STATUS_STARTED;
 
@@ -127,11 +154,12 @@ void ResourcePrefetcher::SendRequest(Request* request) {
                           delegate_->GetURLRequestContext());
   inflight_requests_[url_request] = request;
   host_inflight_counts_[url_request->original_url().host()] += 1;
+  request_start_times_[url_request] = base::TimeTicks::Now();
 
   url_request->set_method("GET");
   url_request->set_first_party_for_cookies(navigation_id_.main_frame_url);
   url_request->SetReferrer(navigation_id_.main_frame_url.spec());
-  url_request->SetPriority(net::LOW);
+  url_request->SetPriority(net::IDLE);
   StartURLRequest(url_request);
 }
 
@@ -153,6 +181,15 @@ void ResourcePrefetcher::FinishRequest(net::URLRequest* request,
   if (host_it->second == 0)
     host_inflight_counts_.erase(host);
 
+  std::map<net::URLRequest*, base::TimeTicks>::iterator start_it =
+      request_start_times_.find(request);
+  DCHECK(start_it != request_start_times_.end());
+  if (status == Request::PREFETCH_STATUS_FROM_NETWORK) {
+    network_bytes_read_ += request_it->second->bytes_read;
+    network_time_ += base::TimeTicks::Now() - start_it->second;
+  }
+  request_start_times_.erase(start_it);
+
   request_it->second->prefetch_status = status;
   inflight_requests_.erase(request_it);
 
@@ -180,6 +217,9 @@ void ResourcePrefetcher::ReadFullResponse(net::URLRequest* request) {
 
 bool ResourcePrefetcher::ShouldContinueReadingRequest(net::URLRequest* request,
                                                       int bytes_read) {
+  if (bytes_read > 0)
+    inflight_requests_[request]->bytes_read += bytes_read;
+
   if (bytes_read == 0) {  // When bytes_read == 0, no more data.
     if (request->was_cached())
       FinishRequest(request, Request::PREFETCH_STATUS_FROM_CACHE);
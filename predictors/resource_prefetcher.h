@@ -12,6 +12,7 @@
 #include "base/gtest_prod_util.h"
 #include "base/memory/scoped_ptr.h"
 #include "base/memory/scoped_vector.h"
+#include "base/time/time.h"
 #include "base/threading/non_thread_safe.h"
 #include "chrome/browser/predictors/resource_prefetch_common.h"
 #include "net/url_request/url_request.h"
@@ -26,7 +27,10 @@ namespace predictors {
 // Responsible for prefetching resources for a single navigation based on the
 // input list of resources.
 //  - Limits the max number of resources in flight for any host and also across
-//    hosts.
+//    hosts, and to one once the resources fetched from the network show that
+//    the connection is slow.
+//  - Fetches the resources at idle priority, so that they do not compete with
+//    the resources the page requests itself.
 //  - When stopped, will wait for the pending requests to finish.
 //  - Lives entirely on the IO thread.
 class ResourcePrefetcher : public base::NonThreadSafe,
@@ -64,6 +68,8 @@ class ResourcePrefetcher : public base::NonThreadSafe,
     GURL resource_url;
     PrefetchStatus prefetch_status;
     UsageStatus usage_status;
+    // Number of bytes of the response body read by the prefetch.
+    int64 bytes_read;
   };
   typedef ScopedVector<Request> RequestVector;
 
@@ -104,6 +110,10 @@ class ResourcePrefetcher : public base::NonThreadSafe,
   // Launches new prefetch requests if possible.
   void TryToLaunchPrefetchRequests();
 
+  // Returns the number of prefetches allowed in flight, which depends on the
+  // throughput seen so far by the prefetches fetched from the network.
+  int GetMaxPrefetchesInflight() const;
+
   // Starts a net::URLRequest for the input |request|.
   void SendRequest(Request* request);
 
@@ -155,6 +165,11 @@ class ResourcePrefetcher : public base::NonThreadSafe,
   std::map<net::URLRequest*, Request*> inflight_requests_;
   std::list<Request*> request_queue_;
   std::map<std::string, int> host_inflight_counts_;
+  std::map<net::URLRequest*, base::TimeTicks> request_start_times_;
+
+  // Total response bytes and time of the prefetches fetched from the network.
+  int64 network_bytes_read_;
+  base::TimeDelta network_time_;
 
   DISALLOW_COPY_AND_ASSIGN(ResourcePrefetcher);
 };
@@ -128,6 +128,13 @@ class ResourcePrefetcherTest : public testing::Test {
     prefetcher_->OnResponseStarted(GetInFlightRequest(url));
   }
 
+  // Makes the prefetcher act as if it had read |bytes| from the network in
+  // |time|.
+  void SetNetworkThroughput(int64 bytes, base::TimeDelta time) {
+    prefetcher_->network_bytes_read_ = bytes;
+    prefetcher_->network_time_ = time;
+  }
+
   base::MessageLoop loop_;
   content::TestBrowserThread io_thread_;
   ResourcePrefetchPredictorConfig config_;
@@ -343,4 +350,49 @@ TEST_F(ResourcePrefetcherTest, TestPrefetcherStopped) {
   delete requests_ptr;
 }
 
+TEST_F(ResourcePrefetcherTest, TestPrefetcherThrottledOnSlowConnection) {
+  scoped_ptr<ResourcePrefetcher::RequestVector> requests(
+      new ResourcePrefetcher::RequestVector);
+  requests->push_back(new ResourcePrefetcher::Request(GURL(
+      "http://www.google.com/resource1.html")));
+  requests->push_back(new ResourcePrefetcher::Request(GURL(
+      "http://yahoo.com/resource1.png")));
+
+  NavigationID navigation_id;
+  navigation_id.render_process_id = 1;
+  navigation_id.render_view_id = 2;
+  navigation_id.main_frame_url = GURL("http://www.google.com");
+
+  // Needed later for comparison.
+  ResourcePrefetcher::RequestVector* requests_ptr = requests.get();
+
+  prefetcher_.reset(new TestResourcePrefetcher(&prefetcher_delegate_,
+                                               config_,
+                                               navigation_id,
+                                               PREFETCH_KEY_TYPE_URL,
+                                               requests.Pass()));
+
+  // 64KB in 10 seconds is a slow connection, so only one prefetch is allowed
+  // in flight.
+  SetNetworkThroughput(64 * 1024, base::TimeDelta::FromSeconds(10));
+
+  AddStartUrlRequestExpectation("http://www.google.com/resource1.html");
+  prefetcher_->Start();
+  CheckPrefetcherState(1, 1, 1);
+
+  AddStartUrlRequestExpectation("http://yahoo.com/resource1.png");
+  OnResponse("http://www.google.com/resource1.html");
+  CheckPrefetcherState(1, 0, 1);
+
+  // Expect the final call.
+  EXPECT_CALL(prefetcher_delegate_,
+              ResourcePrefetcherFinished(Eq(prefetcher_.get()),
+                                         Eq(requests_ptr)));
+
+  OnResponse("http://yahoo.com/resource1.png");
+  CheckPrefetcherState(0, 0, 0);
+
+  delete requests_ptr;
+}
+
 }  // namespace predictors
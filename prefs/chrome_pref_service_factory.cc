@@ -19,7 +19,9 @@
 #include "chrome/browser/prefs/command_line_pref_store.h"
 #include "chrome/browser/prefs/pref_model_associator.h"
 #include "chrome/browser/prefs/pref_service_syncable_builder.h"
+#include "chrome/browser/prefs/sharded_pref_store.h"
 #include "chrome/browser/ui/profile_error_dialog.h"
+#include "chrome/common/pref_names.h"
 #include "components/user_prefs/pref_registry_syncable.h"
 #include "content/public/browser/browser_context.h"
 #include "content/public/browser/browser_thread.h"
@@ -41,6 +43,22 @@ using content::BrowserThread;
 
 namespace {
 
+// The subtrees of the profile preferences which change often enough to be
+// kept in files of their own, next to the preferences file.
+struct PrefShard {
+  const base::FilePath::CharType* extension;
+  // NULL-terminated.
+  const char* roots[3];
+};
+
+const PrefShard kProfilePrefShards[] = {
+  { FILE_PATH_LITERAL("extensions"), { prefs::kExtensionsPref, NULL } },
+  { FILE_PATH_LITERAL("content_settings"),
+    { prefs::kContentSettingsPatternPairs, prefs::kDefaultContentSettings,
+      NULL } },
+  { FILE_PATH_LITERAL("net"), { prefs::kHttpServerProperties, NULL } },
+};
+
 // Shows notifications which correspond to PersistentPrefStore's reading errors.
 void HandleReadError(PersistentPrefStore::PrefReadError error) {
   // Sample the histogram also for the successful case in order to get a
@@ -74,7 +92,7 @@ void HandleReadError(PersistentPrefStore::PrefReadError error) {
 void PrepareBuilder(
     PrefServiceSyncableBuilder* builder,
     const base::FilePath& pref_filename,
-    base::SequencedTaskRunner* pref_io_task_runner,
+    PersistentPrefStore* user_pref_store,
     policy::PolicyService* policy_service,
     ManagedUserSettingsService* managed_user_settings,
     const scoped_refptr<PrefStore>& extension_prefs,
@@ -116,7 +134,32 @@ void PrepareBuilder(
   builder->WithCommandLinePrefs(
       new CommandLinePrefStore(CommandLine::ForCurrentProcess()));
   builder->WithReadErrorCallback(base::Bind(&HandleReadError));
-  builder->WithUserPrefs(new JsonPrefStore(pref_filename, pref_io_task_runner));
+  builder->WithUserPrefs(user_pref_store);
+}
+
+// Returns the store for the profile preferences in |pref_filename|, with the
+// subtrees of |kProfilePrefShards| in shards. Each shard has a sequence of
+// its own on the blocking pool, so it is read in parallel with the others and
+// written on its own commit timer.
+PersistentPrefStore* CreateProfilePrefStore(
+    const base::FilePath& pref_filename,
+    base::SequencedTaskRunner* pref_io_task_runner) {
+  ShardedPrefStore* store = new ShardedPrefStore(
+      new JsonPrefStore(pref_filename, pref_io_task_runner));
+  for (size_t i = 0; i < arraysize(kProfilePrefShards); ++i) {
+    std::vector<std::string> roots;
+    for (const char* const* root = kProfilePrefShards[i].roots; *root; ++root)
+      roots.push_back(*root);
+    base::FilePath shard_filename =
+        pref_filename.AddExtension(kProfilePrefShards[i].extension);
+    store->AddShard(
+        roots,
+        new JsonPrefStore(shard_filename,
+                          JsonPrefStore::GetTaskRunnerForFile(
+                              shard_filename,
+                              BrowserThread::GetBlockingPool()).get()));
+  }
+  return store;
 }
 
 }  // namespace
@@ -132,7 +175,7 @@ PrefService* CreateLocalState(
   PrefServiceSyncableBuilder builder;
   PrepareBuilder(&builder,
                  pref_filename,
-                 pref_io_task_runner,
+                 new JsonPrefStore(pref_filename, pref_io_task_runner),
                  policy_service,
                  NULL,
                  NULL,
@@ -152,7 +195,7 @@ PrefServiceSyncable* CreateProfilePrefs(
   PrefServiceSyncableBuilder builder;
   PrepareBuilder(&builder,
                  pref_filename,
-                 pref_io_task_runner,
+                 CreateProfilePrefStore(pref_filename, pref_io_task_runner),
                  policy_service,
                  managed_user_settings,
                  extension_prefs,
@@ -9,6 +9,7 @@
 #include "base/json/json_string_value_serializer.h"
 #include "base/location.h"
 #include "base/logging.h"
+#include "base/memory/scoped_vector.h"
 #include "base/prefs/pref_service.h"
 #include "base/stl_util.h"
 #include "base/strings/utf_string_conversions.h"
@@ -359,18 +360,31 @@ syncer::SyncError PrefModelAssociator::ProcessSyncChanges(
     return error;
   }
   base::AutoReset<bool> processing_changes(&processing_syncer_changes_, true);
-  syncer::SyncChangeList::const_iterator iter;
-  for (iter = change_list.begin(); iter != change_list.end(); ++iter) {
-    DCHECK_EQ(type_, iter->sync_data().GetDataType());
 
-    std::string name;
-    const sync_pb::PreferenceSpecifics& pref_specifics =
-        GetSpecifics(iter->sync_data());
+  // Only the last valid change to each preference is applied, so that a
+  // preference changed several times in the same batch is set and observed
+  // only once. The values are read first to find it.
+  ScopedVector<Value> values;
+  std::map<std::string, size_t> last_changes;
+  for (size_t i = 0; i < change_list.size(); ++i) {
+    Value* value = NULL;
+    if (change_list[i].change_type() != syncer::SyncChange::ACTION_DELETE) {
+      std::string name;
+      value = ReadPreferenceSpecifics(
+          GetSpecifics(change_list[i].sync_data()), &name);
+      if (value)
+        last_changes[name] = i;
+    }
+    values.push_back(value);
+  }
+
+  for (size_t i = 0; i < change_list.size(); ++i) {
+    const syncer::SyncChange& change = change_list[i];
+    DCHECK_EQ(type_, change.sync_data().GetDataType());
 
-    scoped_ptr<Value> value(ReadPreferenceSpecifics(pref_specifics,
-                                                    &name));
+    const std::string& name = GetSpecifics(change.sync_data()).name();
 
-    if (iter->change_type() == syncer::SyncChange::ACTION_DELETE) {
+    if (change.change_type() == syncer::SyncChange::ACTION_DELETE) {
       // We never delete preferences.
       NOTREACHED() << "Attempted to process sync delete change for " << name
                    << ". Skipping.";
@@ -380,7 +394,8 @@ syncer::SyncError PrefModelAssociator::ProcessSyncChanges(
     // Skip values we can't deserialize.
     // TODO(zea): consider taking some further action such as erasing the bad
     // data.
-    if (!value.get())
+    const Value* value = values[i];
+    if (!value)
       continue;
 
     // It is possible that we may receive a change to a preference we do not
@@ -391,6 +406,13 @@ syncer::SyncError PrefModelAssociator::ProcessSyncChanges(
     if (!IsPrefRegistered(pref_name))
       continue;
 
+    if (last_changes[name] != i) {
+      // Superseded by a later change, but sync still knows about it.
+      if (change.change_type() == syncer::SyncChange::ACTION_ADD)
+        synced_preferences_.insert(name);
+      continue;
+    }
+
     const PrefService::Preference* pref =
         pref_service_->FindPreference(pref_name);
     DCHECK(pref);
@@ -403,7 +425,7 @@ syncer::SyncError PrefModelAssociator::ProcessSyncChanges(
     NotifySyncedPrefObservers(name, true /*from_sync*/);
 
     // Keep track of any newly synced preferences.
-    if (iter->change_type() == syncer::SyncChange::ACTION_ADD) {
+    if (change.change_type() == syncer::SyncChange::ACTION_ADD) {
       synced_preferences_.insert(name);
     }
   }
@@ -0,0 +1,197 @@
+// Copyright 2013 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "chrome/browser/prefs/sharded_pref_store.h"
+
+#include "base/logging.h"
+#include "base/strings/string_util.h"
+#include "base/values.h"
+
+ShardedPrefStore::Shard::Shard() {}
+
+ShardedPrefStore::Shard::~Shard() {}
+
+ShardedPrefStore::ShardedPrefStore(
+    const scoped_refptr<PersistentPrefStore>& main_store)
+    : main_store_(main_store),
+      initialized_stores_(0),
+      initialization_succeeded_(true),
+      initialized_(false) {
+  main_store_->AddObserver(this);
+}
+
+void ShardedPrefStore::AddShard(
+    const std::vector<std::string>& roots,
+    const scoped_refptr<PersistentPrefStore>& store) {
+  DCHECK(!initialized_stores_);
+  DCHECK(!roots.empty());
+  Shard shard;
+  shard.roots = roots;
+  shard.store = store;
+  shards_.push_back(shard);
+  store->AddObserver(this);
+}
+
+void ShardedPrefStore::AddObserver(PrefStore::Observer* observer) {
+  observers_.AddObserver(observer);
+}
+
+void ShardedPrefStore::RemoveObserver(PrefStore::Observer* observer) {
+  observers_.RemoveObserver(observer);
+}
+
+bool ShardedPrefStore::HasObservers() const {
+  return observers_.might_have_observers();
+}
+
+bool ShardedPrefStore::IsInitializationComplete() const {
+  return initialized_;
+}
+
+bool ShardedPrefStore::GetValue(const std::string& key,
+                                const base::Value** result) const {
+  return StoreForKey(key)->GetValue(key, result);
+}
+
+bool ShardedPrefStore::GetMutableValue(const std::string& key,
+                                       base::Value** result) {
+  return StoreForKey(key)->GetMutableValue(key, result);
+}
+
+void ShardedPrefStore::SetValue(const std::string& key, base::Value* value) {
+  StoreForKey(key)->SetValue(key, value);
+}
+
+void ShardedPrefStore::SetValueSilently(const std::string& key,
+                                        base::Value* value) {
+  StoreForKey(key)->SetValueSilently(key, value);
+}
+
+void ShardedPrefStore::RemoveValue(const std::string& key) {
+  StoreForKey(key)->RemoveValue(key);
+}
+
+void ShardedPrefStore::MarkNeedsEmptyValue(const std::string& key) {
+  StoreForKey(key)->MarkNeedsEmptyValue(key);
+}
+
+bool ShardedPrefStore::ReadOnly() const {
+  if (main_store_->ReadOnly())
+    return true;
+  for (size_t i = 0; i < shards_.size(); ++i) {
+    if (shards_[i].store->ReadOnly())
+      return true;
+  }
+  return false;
+}
+
+PersistentPrefStore::PrefReadError ShardedPrefStore::GetReadError() const {
+  PrefReadError error = main_store_->GetReadError();
+  if (error != PREF_READ_ERROR_NONE)
+    return error;
+  // A shard without a file is expected until it has been written once.
+  for (size_t i = 0; i < shards_.size(); ++i) {
+    error = shards_[i].store->GetReadError();
+    if (error != PREF_READ_ERROR_NONE && error != PREF_READ_ERROR_NO_FILE)
+      return error;
+  }
+  return PREF_READ_ERROR_NONE;
+}
+
+PersistentPrefStore::PrefReadError ShardedPrefStore::ReadPrefs() {
+  main_store_->ReadPrefs();
+  for (size_t i = 0; i < shards_.size(); ++i)
+    shards_[i].store->ReadPrefs();
+  return GetReadError();
+}
+
+void ShardedPrefStore::ReadPrefsAsync(ReadErrorDelegate* error_delegate) {
+  error_delegate_.reset(error_delegate);
+  // Each store reads its file on its own task runner, so the files are
+  // parsed in parallel.
+  main_store_->ReadPrefsAsync(NULL);
+  for (size_t i = 0; i < shards_.size(); ++i)
+    shards_[i].store->ReadPrefsAsync(NULL);
+}
+
+void ShardedPrefStore::CommitPendingWrite() {
+  main_store_->CommitPendingWrite();
+  for (size_t i = 0; i < shards_.size(); ++i)
+    shards_[i].store->CommitPendingWrite();
+}
+
+void ShardedPrefStore::ReportValueChanged(const std::string& key) {
+  StoreForKey(key)->ReportValueChanged(key);
+}
+
+void ShardedPrefStore::OnPrefValueChanged(const std::string& key) {
+  // Changes made while migrating are not visible to the observers.
+  if (!initialized_)
+    return;
+  FOR_EACH_OBSERVER(PrefStore::Observer, observers_, OnPrefValueChanged(key));
+}
+
+void ShardedPrefStore::OnInitializationCompleted(bool succeeded) {
+  initialization_succeeded_ &= succeeded;
+  ++initialized_stores_;
+  DCHECK_LE(initialized_stores_, shards_.size() + 1);
+  if (initialized_stores_ <= shards_.size())
+    return;
+
+  if (initialization_succeeded_)
+    MigrateFromMainStore();
+  initialized_ = true;
+
+  if (error_delegate_.get()) {
+    PrefReadError error = GetReadError();
+    if (error != PREF_READ_ERROR_NONE)
+      error_delegate_->OnError(error);
+  }
+
+  FOR_EACH_OBSERVER(PrefStore::Observer, observers_,
+                    OnInitializationCompleted(initialization_succeeded_));
+}
+
+ShardedPrefStore::~ShardedPrefStore() {
+  main_store_->RemoveObserver(this);
+  for (size_t i = 0; i < shards_.size(); ++i)
+    shards_[i].store->RemoveObserver(this);
+}
+
+PersistentPrefStore* ShardedPrefStore::StoreForKey(
+    const std::string& key) const {
+  for (size_t i = 0; i < shards_.size(); ++i) {
+    const std::vector<std::string>& roots = shards_[i].roots;
+    for (size_t j = 0; j < roots.size(); ++j) {
+      if (key == roots[j] || StartsWithASCII(key, roots[j] + ".", true))
+        return shards_[i].store.get();
+    }
+  }
+  return main_store_.get();
+}
+
+void ShardedPrefStore::MigrateFromMainStore() {
+  for (size_t i = 0; i < shards_.size(); ++i) {
+    PersistentPrefStore* store = shards_[i].store.get();
+    if (store->ReadOnly())
+      continue;
+    if (store->GetReadError() != PREF_READ_ERROR_NO_FILE)
+      continue;
+    // The values are copied rather than moved, so that a browser which
+    // doesn't know about the shards still finds them in the main store. The
+    // copies can be removed once the versions without shards are no longer
+    // supported.
+    bool copied = false;
+    const std::vector<std::string>& roots = shards_[i].roots;
+    for (size_t j = 0; j < roots.size(); ++j) {
+      const base::Value* value = NULL;
+      if (!main_store_->GetValue(roots[j], &value))
+        continue;
+      store->SetValueSilently(roots[j], value->DeepCopy());
+      copied = true;
+    }
+    if (copied)
+      store->CommitPendingWrite();
+  }
+}
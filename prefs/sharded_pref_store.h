@@ -0,0 +1,99 @@
+// Copyright 2013 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CHROME_BROWSER_PREFS_SHARDED_PREF_STORE_H_
+#define CHROME_BROWSER_PREFS_SHARDED_PREF_STORE_H_
+
+#include <string>
+#include <vector>
+
+#include "base/basictypes.h"
+#include "base/memory/ref_counted.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/observer_list.h"
+#include "base/prefs/persistent_pref_store.h"
+#include "base/prefs/pref_store.h"
+
+// A PersistentPrefStore which keeps the subtrees of the preferences that
+// change often (e.g. "extensions.settings") in stores of their own, so that
+// a change to one of them doesn't rewrite the rest. Each shard owns the
+// preferences under its roots; everything else goes to the main store.
+//
+// The stores are read together, and the store is initialized once all of
+// them are. A shard which has no file yet copies its roots from the main
+// store, which migrates a profile from a single preferences file. The main
+// store keeps its copy, which is no longer read or written, so that an older
+// browser can still use the profile.
+class ShardedPrefStore : public PersistentPrefStore,
+                         public PrefStore::Observer {
+ public:
+  explicit ShardedPrefStore(
+      const scoped_refptr<PersistentPrefStore>& main_store);
+
+  // Moves the preferences under |roots| to |store|. Must be called before
+  // the store is read.
+  void AddShard(const std::vector<std::string>& roots,
+                const scoped_refptr<PersistentPrefStore>& store);
+
+  // PrefStore implementation:
+  virtual void AddObserver(PrefStore::Observer* observer) OVERRIDE;
+  virtual void RemoveObserver(PrefStore::Observer* observer) OVERRIDE;
+  virtual bool HasObservers() const OVERRIDE;
+  virtual bool IsInitializationComplete() const OVERRIDE;
+  virtual bool GetValue(const std::string& key,
+                        const base::Value** result) const OVERRIDE;
+
+  // PersistentPrefStore implementation:
+  virtual bool GetMutableValue(const std::string& key,
+                               base::Value** result) OVERRIDE;
+  virtual void SetValue(const std::string& key, base::Value* value) OVERRIDE;
+  virtual void SetValueSilently(const std::string& key,
+                                base::Value* value) OVERRIDE;
+  virtual void RemoveValue(const std::string& key) OVERRIDE;
+  virtual void MarkNeedsEmptyValue(const std::string& key) OVERRIDE;
+  virtual bool ReadOnly() const OVERRIDE;
+  virtual PrefReadError GetReadError() const OVERRIDE;
+  virtual PrefReadError ReadPrefs() OVERRIDE;
+  virtual void ReadPrefsAsync(ReadErrorDelegate* error_delegate) OVERRIDE;
+  virtual void CommitPendingWrite() OVERRIDE;
+  virtual void ReportValueChanged(const std::string& key) OVERRIDE;
+
+  // PrefStore::Observer implementation:
+  virtual void OnPrefValueChanged(const std::string& key) OVERRIDE;
+  virtual void OnInitializationCompleted(bool succeeded) OVERRIDE;
+
+ private:
+  struct Shard {
+    Shard();
+    ~Shard();
+
+    std::vector<std::string> roots;
+    scoped_refptr<PersistentPrefStore> store;
+  };
+
+  virtual ~ShardedPrefStore();
+
+  // Returns the store which owns |key|.
+  PersistentPrefStore* StoreForKey(const std::string& key) const;
+
+  // Copies the roots of the shards which had no file from the main store.
+  void MigrateFromMainStore();
+
+  scoped_refptr<PersistentPrefStore> main_store_;
+  std::vector<Shard> shards_;
+
+  // The number of stores whose initialization completed, and whether all of
+  // them succeeded.
+  size_t initialized_stores_;
+  bool initialization_succeeded_;
+  bool initialized_;
+
+  scoped_ptr<ReadErrorDelegate> error_delegate_;
+
+  ObserverList<PrefStore::Observer, true> observers_;
+
+  DISALLOW_COPY_AND_ASSIGN(ShardedPrefStore);
+};
+
+#endif  // CHROME_BROWSER_PREFS_SHARDED_PREF_STORE_H_
@@ -0,0 +1,154 @@
+// Copyright 2013 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "chrome/browser/prefs/sharded_pref_store.h"
+
+#include <string>
+#include <vector>
+
+#include "base/file_util.h"
+#include "base/files/file_path.h"
+#include "base/files/scoped_temp_dir.h"
+#include "base/json/json_reader.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/message_loop/message_loop.h"
+#include "base/message_loop/message_loop_proxy.h"
+#include "base/prefs/json_pref_store.h"
+#include "base/values.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace {
+
+const char kMainPrefs[] =
+    "{\"homepage\": \"http://example.com/\","
+    " \"extensions\": {\"settings\": {\"id\": {\"state\": 1}},"
+    "                  \"toolbar\": [\"id\"]}}";
+
+class ShardedPrefStoreTest : public testing::Test {
+ protected:
+  virtual void SetUp() OVERRIDE {
+    ASSERT_TRUE(temp_dir_.CreateUniqueTempDir());
+    main_path_ = temp_dir_.path().AppendASCII("Preferences");
+    shard_path_ = main_path_.AddExtension(FILE_PATH_LITERAL("extensions"));
+  }
+
+  scoped_refptr<ShardedPrefStore> CreateStore() {
+    scoped_refptr<ShardedPrefStore> store(new ShardedPrefStore(
+        new JsonPrefStore(main_path_, message_loop_.message_loop_proxy())));
+    std::vector<std::string> roots;
+    roots.push_back("extensions.settings");
+    store->AddShard(
+        roots,
+        new JsonPrefStore(shard_path_, message_loop_.message_loop_proxy()));
+    return store;
+  }
+
+  // Returns the contents of the file at |path|, parsed.
+  scoped_ptr<base::DictionaryValue> ReadFile(const base::FilePath& path) {
+    std::string json;
+    if (!base::ReadFileToString(path, &json))
+      return scoped_ptr<base::DictionaryValue>();
+    scoped_ptr<base::Value> value(base::JSONReader::Read(json));
+    if (!value || !value->IsType(base::Value::TYPE_DICTIONARY))
+      return scoped_ptr<base::DictionaryValue>();
+    return scoped_ptr<base::DictionaryValue>(
+        static_cast<base::DictionaryValue*>(value.release()));
+  }
+
+  base::MessageLoop message_loop_;
+  base::ScopedTempDir temp_dir_;
+  base::FilePath main_path_;
+  base::FilePath shard_path_;
+};
+
+}  // namespace
+
+TEST_F(ShardedPrefStoreTest, MigratesFromMainFile) {
+  ASSERT_EQ(static_cast<int>(arraysize(kMainPrefs) - 1),
+            file_util::WriteFile(main_path_, kMainPrefs,
+                                 arraysize(kMainPrefs) - 1));
+
+  scoped_refptr<ShardedPrefStore> store(CreateStore());
+  EXPECT_EQ(PersistentPrefStore::PREF_READ_ERROR_NONE, store->ReadPrefs());
+  EXPECT_TRUE(store->IsInitializationComplete());
+
+  // The values read the same as before, wherever they are kept.
+  const base::Value* value = NULL;
+  EXPECT_TRUE(store->GetValue("homepage", &value));
+  EXPECT_TRUE(store->GetValue("extensions.settings.id.state", &value));
+  EXPECT_TRUE(store->GetValue("extensions.toolbar", &value));
+
+  store->CommitPendingWrite();
+  message_loop_.RunUntilIdle();
+
+  scoped_ptr<base::DictionaryValue> main_prefs(ReadFile(main_path_));
+  ASSERT_TRUE(main_prefs);
+  EXPECT_TRUE(main_prefs->HasKey("homepage"));
+  EXPECT_TRUE(main_prefs->HasKey("extensions.toolbar"));
+  // The main file keeps its copy, for the versions without shards.
+  EXPECT_TRUE(main_prefs->HasKey("extensions.settings.id.state"));
+
+  scoped_ptr<base::DictionaryValue> shard_prefs(ReadFile(shard_path_));
+  ASSERT_TRUE(shard_prefs);
+  int state = 0;
+  EXPECT_TRUE(shard_prefs->GetInteger("extensions.settings.id.state", &state));
+  EXPECT_EQ(1, state);
+  EXPECT_FALSE(shard_prefs->HasKey("homepage"));
+}
+
+TEST_F(ShardedPrefStoreTest, WritesToOwningFile) {
+  scoped_refptr<ShardedPrefStore> store(CreateStore());
+  EXPECT_EQ(PersistentPrefStore::PREF_READ_ERROR_NO_FILE, store->ReadPrefs());
+
+  store->SetValue("homepage", new base::StringValue("http://example.com/"));
+  store->SetValue("extensions.settings.id.state",
+                  new base::FundamentalValue(2));
+  store->CommitPendingWrite();
+  message_loop_.RunUntilIdle();
+
+  scoped_ptr<base::DictionaryValue> main_prefs(ReadFile(main_path_));
+  ASSERT_TRUE(main_prefs);
+  EXPECT_TRUE(main_prefs->HasKey("homepage"));
+  EXPECT_FALSE(main_prefs->HasKey("extensions"));
+
+  scoped_ptr<base::DictionaryValue> shard_prefs(ReadFile(shard_path_));
+  ASSERT_TRUE(shard_prefs);
+  EXPECT_TRUE(shard_prefs->HasKey("extensions.settings.id.state"));
+  EXPECT_FALSE(shard_prefs->HasKey("homepage"));
+
+  // Reading the files back doesn't move anything.
+  store = CreateStore();
+  EXPECT_EQ(PersistentPrefStore::PREF_READ_ERROR_NONE, store->ReadPrefs());
+  const base::Value* value = NULL;
+  EXPECT_TRUE(store->GetValue("extensions.settings.id.state", &value));
+  EXPECT_TRUE(store->GetValue("homepage", &value));
+}
+
+TEST_F(ShardedPrefStoreTest, IgnoresMainFileCopyOnceMigrated) {
+  ASSERT_EQ(static_cast<int>(arraysize(kMainPrefs) - 1),
+            file_util::WriteFile(main_path_, kMainPrefs,
+                                 arraysize(kMainPrefs) - 1));
+
+  scoped_refptr<ShardedPrefStore> store(CreateStore());
+  EXPECT_EQ(PersistentPrefStore::PREF_READ_ERROR_NONE, store->ReadPrefs());
+  store->SetValue("extensions.settings.id.state",
+                  new base::FundamentalValue(2));
+  store->CommitPendingWrite();
+  message_loop_.RunUntilIdle();
+
+  // The main file still has the value from before the migration.
+  scoped_ptr<base::DictionaryValue> main_prefs(ReadFile(main_path_));
+  ASSERT_TRUE(main_prefs);
+  int state = 0;
+  EXPECT_TRUE(main_prefs->GetInteger("extensions.settings.id.state", &state));
+  EXPECT_EQ(1, state);
+
+  // The shard is not migrated again, and its value wins.
+  store = CreateStore();
+  EXPECT_EQ(PersistentPrefStore::PREF_READ_ERROR_NONE, store->ReadPrefs());
+  const base::Value* value = NULL;
+  ASSERT_TRUE(store->GetValue("extensions.settings.id.state", &value));
+  EXPECT_TRUE(value->GetAsInteger(&state));
+  EXPECT_EQ(2, state);
+}
@@ -19,6 +19,10 @@ struct Config {
   // Maximum memory use for a prerendered page until it is killed.
   size_t max_bytes;
 
+  // Maximum memory use of all prerendered pages together. A new prerender is
+  // not started if the memory its host is expected to use does not fit.
+  size_t max_total_bytes;
+
   // Number of simultaneous prerender pages from link elements allowed. Enforced
   // by PrerenderLinkManager.
   size_t max_link_concurrency;
@@ -197,7 +197,8 @@ PrerenderContents::PrerenderContents(
       route_id_(-1),
       origin_(origin),
       experiment_id_(experiment_id),
-      creator_child_id_(-1) {
+      creator_child_id_(-1),
+      max_private_bytes_(0) {
   DCHECK(prerender_manager != NULL);
 }
 
@@ -357,6 +358,10 @@ PrerenderContents::~PrerenderContents() {
 
   prerender_manager_->RecordFinalStatusWithMatchCompleteStatus(
       origin(), experiment_id(), match_complete_status(), final_status());
+  if (max_private_bytes_ > 0) {
+    prerender_manager_->RecordPrerenderMemoryUse(
+        origin(), prerender_url(), max_private_bytes_);
+  }
 
   // Broadcast the removal of aliases.
   for (content::RenderProcessHost::iterator host_iterator =
@@ -653,10 +658,11 @@ void PrerenderContents::DestroyWhenUsingTooManyResources() {
     return;
 
   size_t private_bytes, shared_bytes;
-  if (metrics->GetMemoryBytes(&private_bytes, &shared_bytes) &&
-      private_bytes > prerender_manager_->config().max_bytes) {
+  if (!metrics->GetMemoryBytes(&private_bytes, &shared_bytes))
+    return;
+  max_private_bytes_ = std::max(max_private_bytes_, private_bytes);
+  if (private_bytes > prerender_manager_->config().max_bytes)
     Destroy(FINAL_STATUS_MEMORY_LIMIT_EXCEEDED);
-  }
 }
 
 WebContents* PrerenderContents::ReleasePrerenderContents() {
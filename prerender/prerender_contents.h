@@ -206,6 +206,10 @@ class PrerenderContents : public content::NotificationObserver,
 
   base::TimeTicks load_start_time() const { return load_start_time_; }
 
+  // The largest private memory use of the prerender process seen so far, or
+  // 0 if it has not been measured yet.
+  size_t max_private_bytes() const { return max_private_bytes_; }
+
   // Indicates whether this prerendered page can be used for the provided
   // |url| and |session_storage_namespace|.
   bool Matches(
@@ -413,6 +417,9 @@ class PrerenderContents : public content::NotificationObserver,
   // The process that created the child id.
   int creator_child_id_;
 
+  // See max_private_bytes().
+  size_t max_private_bytes_;
+
   // The size of the WebView from the launching page.
   gfx::Size size_;
 
@@ -57,6 +57,7 @@ const char* kFinalStatusNames[] = {
   "Creating Audio Stream",
   "Page Being Captured",
   "Bad Deferred Redirect",
+  "Memory Budget Exceeded",
   "Max",
 };
 COMPILE_ASSERT(arraysize(kFinalStatusNames) == FINAL_STATUS_MAX + 1,
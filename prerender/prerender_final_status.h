@@ -58,6 +58,7 @@ enum FinalStatus {
   FINAL_STATUS_CREATING_AUDIO_STREAM = 43,
   FINAL_STATUS_PAGE_BEING_CAPTURED = 44,
   FINAL_STATUS_BAD_DEFERRED_REDIRECT = 45,
+  FINAL_STATUS_MEMORY_BUDGET_EXCEEDED = 46,
   FINAL_STATUS_MAX,
 };
 
@@ -357,6 +357,18 @@ void PrerenderHistograms::RecordTimeBetweenPrerenderRequests(
       UMA_HISTOGRAM_TIMES(name, time));
 }
 
+void PrerenderHistograms::RecordMemoryEstimate(Origin origin,
+                                               size_t estimated_bytes,
+                                               size_t actual_bytes) const {
+  if (actual_bytes == 0)
+    return;
+  int percent = static_cast<int>(
+      static_cast<uint64>(estimated_bytes) * 100 / actual_bytes);
+  PREFIXED_HISTOGRAM(
+      "MemoryEstimatePercent", origin,
+      UMA_HISTOGRAM_CUSTOM_COUNTS(name, percent, 1, 1000, 50));
+}
+
 void PrerenderHistograms::RecordFinalStatus(
     Origin origin,
     uint8 experiment_id,
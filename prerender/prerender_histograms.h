@@ -60,6 +60,12 @@ class PrerenderHistograms {
   void RecordTimeBetweenPrerenderRequests(Origin origin,
                                           base::TimeDelta time) const;
 
+  // Record how the memory a prerender was expected to use compares to the
+  // memory it actually used, as a percentage of the latter.
+  void RecordMemoryEstimate(Origin origin,
+                            size_t estimated_bytes,
+                            size_t actual_bytes) const;
+
   // Record a final status of a prerendered page in a histogram.
   void RecordFinalStatus(Origin origin,
                          uint8 experiment_id,
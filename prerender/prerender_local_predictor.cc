@@ -27,6 +27,7 @@
 #include "chrome/browser/prerender/prerender_handle.h"
 #include "chrome/browser/prerender/prerender_histograms.h"
 #include "chrome/browser/prerender/prerender_manager.h"
+#include "chrome/browser/prerender/prerender_transition_index.h"
 #include "chrome/browser/profiles/profile.h"
 #include "chrome/browser/safe_browsing/database_manager.h"
 #include "chrome/browser/safe_browsing/safe_browsing_service.h"
@@ -192,42 +193,9 @@ class GetURLForURLIDTask : public history::HistoryDBTask {
   DISALLOW_COPY_AND_ASSIGN(GetURLForURLIDTask);
 };
 
-// Task to load history from the visit database on startup.
-class GetVisitHistoryTask : public history::HistoryDBTask {
- public:
-  GetVisitHistoryTask(PrerenderLocalPredictor* local_predictor,
-                      int max_visits)
-      : local_predictor_(local_predictor),
-        max_visits_(max_visits),
-        visit_history_(new vector<history::BriefVisitInfo>) {
-  }
-
-  virtual bool RunOnDBThread(history::HistoryBackend* backend,
-                             history::HistoryDatabase* db) OVERRIDE {
-    db->GetBriefVisitInfoOfMostRecentVisits(max_visits_, visit_history_.get());
-    return true;
-  }
-
-  virtual void DoneRunOnMainThread() OVERRIDE {
-    local_predictor_->OnGetInitialVisitHistory(visit_history_.Pass());
-  }
-
- private:
-  virtual ~GetVisitHistoryTask() {}
-
-  PrerenderLocalPredictor* local_predictor_;
-  int max_visits_;
-  scoped_ptr<vector<history::BriefVisitInfo> > visit_history_;
-  DISALLOW_COPY_AND_ASSIGN(GetVisitHistoryTask);
-};
-
 // Maximum visit history to retrieve from the visit database.
 const int kMaxVisitHistory = 100 * 1000;
 
-// Visit history size at which to trigger pruning, and number of items to prune.
-const int kVisitHistoryPruneThreshold = 120 * 1000;
-const int kVisitHistoryPruneAmount = 20 * 1000;
-
 const int kMinLocalPredictionTimeMs = 500;
 
 int GetMaxLocalPredictionTimeMs() {
@@ -256,6 +224,55 @@ bool ShouldExcludeTransitionForPrediction(PageTransition transition) {
       IsIntermediateRedirect(transition);
 }
 
+// Adds |visit| to |transition_index|, unless its transition is not used for
+// predictions.
+void AddVisitToTransitionIndex(const history::BriefVisitInfo& visit,
+                               PrerenderTransitionIndex* transition_index) {
+  if (ShouldExcludeTransitionForPrediction(visit.transition))
+    return;
+  transition_index->AddVisit(visit.url_id, visit.time,
+                             !IsFormSubmit(visit.transition));
+}
+
+// Task to build the transition index from the visit database on startup.
+class GetVisitHistoryTask : public history::HistoryDBTask {
+ public:
+  GetVisitHistoryTask(PrerenderLocalPredictor* local_predictor,
+                      int max_visits)
+      : local_predictor_(local_predictor),
+        max_visits_(max_visits),
+        transition_index_(new PrerenderTransitionIndex(
+            base::TimeDelta::FromMilliseconds(kMinLocalPredictionTimeMs),
+            base::TimeDelta::FromMilliseconds(
+                GetMaxLocalPredictionTimeMs()))) {
+  }
+
+  virtual bool RunOnDBThread(history::HistoryBackend* backend,
+                             history::HistoryDatabase* db) OVERRIDE {
+    vector<history::BriefVisitInfo> visit_history;
+    db->GetBriefVisitInfoOfMostRecentVisits(max_visits_, &visit_history);
+    // Since the visit history has descending timestamps, we must reverse it.
+    for (vector<history::BriefVisitInfo>::const_reverse_iterator it =
+             visit_history.rbegin();
+         it != visit_history.rend(); ++it) {
+      AddVisitToTransitionIndex(*it, transition_index_.get());
+    }
+    return true;
+  }
+
+  virtual void DoneRunOnMainThread() OVERRIDE {
+    local_predictor_->OnGetInitialTransitionIndex(transition_index_.Pass());
+  }
+
+ private:
+  virtual ~GetVisitHistoryTask() {}
+
+  PrerenderLocalPredictor* local_predictor_;
+  int max_visits_;
+  scoped_ptr<PrerenderTransitionIndex> transition_index_;
+  DISALLOW_COPY_AND_ASSIGN(GetVisitHistoryTask);
+};
+
 base::Time GetCurrentTime() {
   return base::Time::Now();
 }
@@ -453,13 +470,9 @@ void PrerenderLocalPredictor::Shutdown() {
 void PrerenderLocalPredictor::OnAddVisit(const history::BriefVisitInfo& info) {
   DCHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
   RecordEvent(EVENT_ADD_VISIT);
-  if (!visit_history_.get())
+  if (!transition_index_.get())
     return;
-  visit_history_->push_back(info);
-  if (static_cast<int>(visit_history_->size()) > kVisitHistoryPruneThreshold) {
-    visit_history_->erase(visit_history_->begin(),
-                          visit_history_->begin() + kVisitHistoryPruneAmount);
-  }
+  AddVisitToTransitionIndex(info, transition_index_.get());
   RecordEvent(EVENT_ADD_VISIT_INITIALIZED);
   if (current_prerender_.get() &&
       current_prerender_->url_id == info.url_id &&
@@ -476,44 +489,12 @@ void PrerenderLocalPredictor::OnAddVisit(const history::BriefVisitInfo& info) {
   if (ShouldExcludeTransitionForPrediction(info.transition))
     return;
   RecordEvent(EVENT_ADD_VISIT_RELEVANT_TRANSITION);
-  base::TimeDelta max_age =
-      base::TimeDelta::FromMilliseconds(GetMaxLocalPredictionTimeMs());
-  base::TimeDelta min_age =
-      base::TimeDelta::FromMilliseconds(kMinLocalPredictionTimeMs);
-  std::set<URLID> next_urls_currently_found;
-  std::map<URLID, int> next_urls_num_found;
-  int num_occurrences_of_current_visit = 0;
-  base::Time last_visited;
   scoped_ptr<CandidatePrerenderInfo> lookup_info(
       new CandidatePrerenderInfo(info.url_id));
-  const vector<history::BriefVisitInfo>& visits = *(visit_history_.get());
-  for (int i = 0; i < static_cast<int>(visits.size()); i++) {
-    if (!ShouldExcludeTransitionForPrediction(visits[i].transition)) {
-      if (visits[i].url_id == info.url_id) {
-        last_visited = visits[i].time;
-        num_occurrences_of_current_visit++;
-        next_urls_currently_found.clear();
-        continue;
-      }
-      if (!last_visited.is_null() &&
-          last_visited > visits[i].time - max_age &&
-          last_visited < visits[i].time - min_age) {
-        if (!IsFormSubmit(visits[i].transition))
-          next_urls_currently_found.insert(visits[i].url_id);
-      }
-    }
-    if (i == static_cast<int>(visits.size()) - 1 ||
-        visits[i+1].url_id == info.url_id) {
-      for (std::set<URLID>::iterator it = next_urls_currently_found.begin();
-           it != next_urls_currently_found.end();
-           ++it) {
-        std::pair<std::map<URLID, int>::iterator, bool> insert_ret =
-            next_urls_num_found.insert(std::pair<URLID, int>(*it, 0));
-        std::map<URLID, int>::iterator num_found_it = insert_ret.first;
-        num_found_it->second++;
-      }
-    }
-  }
+  const PrerenderTransitionIndex::Entry* entry =
+      transition_index_->FindEntry(info.url_id);
+  DCHECK(entry);
+  int num_occurrences_of_current_visit = entry->visit_count;
 
   if (num_occurrences_of_current_visit > 1) {
     RecordEvent(EVENT_ADD_VISIT_RELEVANT_TRANSITION_REPEAT_URL);
@@ -521,18 +502,19 @@ void PrerenderLocalPredictor::OnAddVisit(const history::BriefVisitInfo& info) {
     RecordEvent(EVENT_ADD_VISIT_RELEVANT_TRANSITION_NEW_URL);
   }
 
-  for (std::map<URLID, int>::const_iterator it = next_urls_num_found.begin();
-       it != next_urls_num_found.end();
+  for (vector<PrerenderTransitionIndex::NextURL>::const_iterator it =
+           entry->next_urls.begin();
+       it != entry->next_urls.end();
        ++it) {
     // Only consider a candidate next page for prerendering if it was viewed
     // at least twice, and at least 10% of the time.
     if (num_occurrences_of_current_visit > 0 &&
-        it->second > 1 &&
-        it->second * 10 >= num_occurrences_of_current_visit) {
+        it->count > 1 &&
+        it->count * 10 >= num_occurrences_of_current_visit) {
       RecordEvent(EVENT_ADD_VISIT_IDENTIFIED_PRERENDER_CANDIDATE);
-      double priority = static_cast<double>(it->second) /
+      double priority = static_cast<double>(it->count) /
           static_cast<double>(num_occurrences_of_current_visit);
-      lookup_info->MaybeAddCandidateURLFromLocalData(it->first, priority);
+      lookup_info->MaybeAddCandidateURLFromLocalData(it->url_id, priority);
     }
   }
 
@@ -951,14 +933,12 @@ void PrerenderLocalPredictor::LogCandidateURLStats(const GURL& url) const {
     RecordEvent(EVENT_PRERENDER_URL_LOOKUP_RESULT_CONTAINS_LOGIN);
 }
 
-void PrerenderLocalPredictor::OnGetInitialVisitHistory(
-    scoped_ptr<vector<history::BriefVisitInfo> > visit_history) {
+void PrerenderLocalPredictor::OnGetInitialTransitionIndex(
+    scoped_ptr<PrerenderTransitionIndex> transition_index) {
   DCHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
-  DCHECK(!visit_history_.get());
+  DCHECK(!transition_index_.get());
   RecordEvent(EVENT_INIT_SUCCEEDED);
-  // Since the visit history has descending timestamps, we must reverse it.
-  visit_history_.reset(new vector<history::BriefVisitInfo>(
-      visit_history->rbegin(), visit_history->rend()));
+  transition_index_ = transition_index.Pass();
 }
 
 HistoryService* PrerenderLocalPredictor::GetHistoryIfExists() const {
@@ -36,6 +36,7 @@ namespace prerender {
 
 class PrerenderHandle;
 class PrerenderManager;
+class PrerenderTransitionIndex;
 
 // PrerenderLocalPredictor maintains local browsing history to make prerender
 // predictions.
@@ -134,8 +135,8 @@ class PrerenderLocalPredictor : public history::VisitDatabaseObserver,
   // history::VisitDatabaseObserver implementation
   virtual void OnAddVisit(const history::BriefVisitInfo& info) OVERRIDE;
 
-  void OnGetInitialVisitHistory(
-      scoped_ptr<std::vector<history::BriefVisitInfo> > visit_history);
+  void OnGetInitialTransitionIndex(
+      scoped_ptr<PrerenderTransitionIndex> transition_index);
 
   void OnPLTEventForURL(const GURL& url, base::TimeDelta page_load_time);
 
@@ -197,7 +198,9 @@ class PrerenderLocalPredictor : public history::VisitDatabaseObserver,
 
   CancelableRequestConsumer history_db_consumer_;
 
-  scoped_ptr<std::vector<history::BriefVisitInfo> > visit_history_;
+  // Likely next URLs of the URLs in the visit history. NULL until it has been
+  // built from the visit database.
+  scoped_ptr<PrerenderTransitionIndex> transition_index_;
 
   scoped_ptr<PrerenderProperties> current_prerender_;
   scoped_ptr<PrerenderProperties> last_swapped_in_prerender_;
@@ -17,6 +17,7 @@
 #include "base/prefs/pref_service.h"
 #include "base/stl_util.h"
 #include "base/strings/utf_string_conversions.h"
+#include "base/sys_info.h"
 #include "base/time/time.h"
 #include "base/values.h"
 #include "chrome/browser/browser_process.h"
@@ -87,6 +88,12 @@ const char* const kValidHttpMethods[] = {
 // Length of prerender history, for display in chrome://net-internals
 const int kHistoryLength = 100;
 
+// Number of hosts to keep prerender memory estimates for.
+const size_t kMaxMemoryEstimates = 100;
+
+// Fraction of physical memory all prerenders together may use.
+const int64 kPhysicalMemoryDivisor = 8;
+
 // Indicates whether a Prerender has been cancelled such that we need
 // a dummy replacement for the purpose of recording the correct PPLT for
 // the Match Complete case.
@@ -275,6 +282,14 @@ PrerenderManager::PrerenderManager(Profile* profile,
       break;
   }
 
+  // Don't let prerenders crowd out the rest of the browser on small devices.
+  int64 memory_budget =
+      base::SysInfo::AmountOfPhysicalMemory() / kPhysicalMemoryDivisor;
+  if (memory_budget > 0 &&
+      static_cast<uint64>(memory_budget) < config_.max_total_bytes) {
+    config_.max_total_bytes = static_cast<size_t>(memory_budget);
+  }
+
   notification_registrar_.Add(
       this, chrome::NOTIFICATION_COOKIE_CHANGED,
       content::NotificationService::AllBrowserContextsAndSources());
@@ -974,6 +989,7 @@ PrerenderManager::PrerenderData::PrerenderData(PrerenderManager* manager,
     : manager_(manager),
       contents_(contents),
       handle_count_(0),
+      abandoned_(false),
       expiry_time_(expiry_time) {
   DCHECK_NE(static_cast<PrerenderContents*>(NULL), contents_);
 }
@@ -1067,6 +1083,7 @@ void PrerenderManager::SourceNavigatedAway(PrerenderData* prerender_data) {
   if (it == active_prerenders_.end())
     return;
 
+  (*it)->set_abandoned();
   (*it)->set_expiry_time(
       std::min((*it)->expiry_time(),
                GetExpiryTimeForNavigatedAwayPrerender()));
@@ -1138,6 +1155,13 @@ PrerenderHandle* PrerenderManager::AddPrerender(
     return NULL;
   }
 
+  // Don't start a prerender which is likely to be killed for its memory use,
+  // or to push the prerenders together over their memory budget.
+  if (!DoesMemoryBudgetAllowPrerender(url)) {
+    RecordFinalStatus(origin, experiment, FINAL_STATUS_MEMORY_BUDGET_EXCEEDED);
+    return NULL;
+  }
+
   PrerenderContents* prerender_contents = CreatePrerenderContents(
       url, referrer, origin, experiment);
   DCHECK(prerender_contents);
@@ -1322,6 +1346,52 @@ bool PrerenderManager::DoesRateLimitAllowPrerender(Origin origin) const {
       base::TimeDelta::FromMilliseconds(kMinTimeBetweenPrerendersMs);
 }
 
+size_t PrerenderManager::GetMemoryEstimate(const GURL& url) const {
+  MemoryEstimateMap::const_iterator it = memory_estimates_.find(url.host());
+  return it == memory_estimates_.end() ? 0 : it->second;
+}
+
+bool PrerenderManager::DoesMemoryBudgetAllowPrerender(const GURL& url) const {
+  DCHECK(CalledOnValidThread());
+  size_t estimate = GetMemoryEstimate(url);
+  if (estimate > config_.max_bytes)
+    return false;
+
+  // Active prerenders which have not been measured yet are counted at their
+  // estimate. Abandoned prerenders are not counted, since they are destroyed
+  // within abandon_time_to_live unless a navigation ends up at them.
+  size_t total_bytes = estimate;
+  for (ScopedVector<PrerenderData>::const_iterator it =
+           active_prerenders_.begin();
+       it != active_prerenders_.end(); ++it) {
+    if ((*it)->abandoned())
+      continue;
+    PrerenderContents* contents = (*it)->contents();
+    total_bytes += std::max(contents->max_private_bytes(),
+                            GetMemoryEstimate(contents->prerender_url()));
+  }
+  return total_bytes <= config_.max_total_bytes;
+}
+
+void PrerenderManager::RecordPrerenderMemoryUse(Origin origin,
+                                                const GURL& url,
+                                                size_t private_bytes) {
+  DCHECK(CalledOnValidThread());
+  const std::string& host = url.host();
+  MemoryEstimateMap::iterator it = memory_estimates_.find(host);
+  if (it == memory_estimates_.end()) {
+    // Make room by forgetting an arbitrary host; estimates are cheap to
+    // rebuild from the next prerender.
+    if (memory_estimates_.size() >= kMaxMemoryEstimates)
+      memory_estimates_.erase(memory_estimates_.begin());
+    memory_estimates_[host] = private_bytes;
+    return;
+  }
+
+  histograms_->RecordMemoryEstimate(origin, it->second, private_bytes);
+  it->second = (it->second * 3 + private_bytes) / 4;
+}
+
 void PrerenderManager::DeleteOldWebContents() {
   while (!old_web_contents_list_.empty()) {
     WebContents* web_contents = old_web_contents_list_.front();
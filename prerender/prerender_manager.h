@@ -359,6 +359,10 @@ class PrerenderManager : public base::SupportsWeakPtr<PrerenderManager>,
 
     int handle_count() const { return handle_count_; }
 
+    // Whether the launcher of this prerender has navigated away from it.
+    bool abandoned() const { return abandoned_; }
+    void set_abandoned() { abandoned_ = true; }
+
     base::TimeTicks expiry_time() const { return expiry_time_; }
     void set_expiry_time(base::TimeTicks expiry_time) {
       expiry_time_ = expiry_time;
@@ -375,6 +379,9 @@ class PrerenderManager : public base::SupportsWeakPtr<PrerenderManager>,
     // only merges handles of running prerenders.
     int handle_count_;
 
+    // See abandoned().
+    bool abandoned_;
+
     // After this time, this prerender is no longer fresh, and should be
     // removed.
     base::TimeTicks expiry_time_;
@@ -509,6 +516,22 @@ class PrerenderManager : public base::SupportsWeakPtr<PrerenderManager>,
 
   bool DoesRateLimitAllowPrerender(Origin origin) const;
 
+  // Returns the memory a prerender of |url| is expected to use, based on the
+  // prerenders of its host seen so far, or 0 if there is no estimate.
+  size_t GetMemoryEstimate(const GURL& url) const;
+
+  // Returns false if a prerender of |url| is expected to exceed the memory
+  // limit of a single prerender, or to not fit in the memory left over by the
+  // active prerenders which have not been abandoned.
+  bool DoesMemoryBudgetAllowPrerender(const GURL& url) const;
+
+  // Called by a PrerenderContents on destruction with the most private memory
+  // it was seen using. Records how good the estimate for |url| was, and
+  // updates the estimate for its host.
+  void RecordPrerenderMemoryUse(Origin origin,
+                                const GURL& url,
+                                size_t private_bytes);
+
   // Deletes old WebContents that have been replaced by prerendered ones.  This
   // is needed because they're replaced in a callback from the old WebContents,
   // so cannot immediately be deleted.
@@ -615,6 +638,11 @@ class PrerenderManager : public base::SupportsWeakPtr<PrerenderManager>,
   // Track time of last prerender to limit prerender spam.
   base::TimeTicks last_prerender_start_time_;
 
+  // Expected memory use of a prerender by host, as a moving average of the
+  // memory used by its previous prerenders.
+  typedef std::map<std::string, size_t> MemoryEstimateMap;
+  MemoryEstimateMap memory_estimates_;
+
   std::list<content::WebContents*> old_web_contents_list_;
 
   ScopedVector<OnCloseWebContentsDeleter> on_close_web_contents_deleters_;
@@ -0,0 +1,139 @@
+// Copyright 2013 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "chrome/browser/prerender/prerender_transition_index.h"
+
+#include <algorithm>
+
+#include "base/logging.h"
+
+using history::URLID;
+
+namespace prerender {
+
+namespace {
+
+// Orders next URLs from the least to the most useful to keep.
+bool IsLessUseful(const PrerenderTransitionIndex::NextURL& a,
+                  const PrerenderTransitionIndex::NextURL& b) {
+  if (a.count != b.count)
+    return a.count < b.count;
+  return a.last_visit_time < b.last_visit_time;
+}
+
+}  // namespace
+
+const size_t PrerenderTransitionIndex::kMaxSourceURLs;
+const size_t PrerenderTransitionIndex::kMaxNextURLs;
+
+PrerenderTransitionIndex::NextURL::NextURL(URLID url_id,
+                                           base::Time last_visit_time)
+    : url_id(url_id),
+      count(1),
+      last_visit_time(last_visit_time) {
+}
+
+PrerenderTransitionIndex::Entry::Entry() : visit_count(0) {
+}
+
+PrerenderTransitionIndex::Entry::~Entry() {
+}
+
+PrerenderTransitionIndex::PrerenderTransitionIndex(base::TimeDelta min_age,
+                                                   base::TimeDelta max_age)
+    : min_age_(min_age),
+      max_age_(max_age) {
+  DCHECK(min_age_ < max_age_);
+}
+
+PrerenderTransitionIndex::~PrerenderTransitionIndex() {
+}
+
+void PrerenderTransitionIndex::AddVisit(URLID url_id,
+                                        base::Time time,
+                                        bool can_be_next) {
+  // Expire the visits which are too old for this and later visits to be
+  // counted for.
+  while (!open_visit_times_.empty() &&
+         open_visit_times_.front().first <= time - max_age_) {
+    OpenVisitMap::iterator it =
+        open_visits_.find(open_visit_times_.front().second);
+    if (it != open_visits_.end() &&
+        it->second.time == open_visit_times_.front().first) {
+      open_visits_.erase(it);
+    }
+    open_visit_times_.pop_front();
+  }
+
+  if (can_be_next) {
+    for (OpenVisitMap::iterator it = open_visits_.begin();
+         it != open_visits_.end(); ++it) {
+      if (it->first == url_id || it->second.time >= time - min_age_)
+        continue;
+      if (!it->second.counted_urls.insert(url_id).second)
+        continue;
+      EntryMap::iterator source = entries_.find(it->first);
+      if (source != entries_.end())
+        AddNextURL(&source->second, url_id, time);
+    }
+  }
+
+  Entry& entry = entries_[url_id];
+  entry.visit_count++;
+  entry.last_visit_time = time;
+
+  OpenVisit& open_visit = open_visits_[url_id];
+  open_visit.time = time;
+  open_visit.counted_urls.clear();
+  open_visit_times_.push_back(std::make_pair(time, url_id));
+
+  MaybePrune();
+}
+
+const PrerenderTransitionIndex::Entry* PrerenderTransitionIndex::FindEntry(
+    URLID url_id) const {
+  EntryMap::const_iterator it = entries_.find(url_id);
+  return it == entries_.end() ? NULL : &it->second;
+}
+
+void PrerenderTransitionIndex::AddNextURL(Entry* entry,
+                                          URLID url_id,
+                                          base::Time time) {
+  std::vector<NextURL>& next_urls = entry->next_urls;
+  for (std::vector<NextURL>::iterator it = next_urls.begin();
+       it != next_urls.end(); ++it) {
+    if (it->url_id == url_id) {
+      it->count++;
+      it->last_visit_time = time;
+      return;
+    }
+  }
+
+  if (next_urls.size() < kMaxNextURLs) {
+    next_urls.push_back(NextURL(url_id, time));
+    return;
+  }
+  *std::min_element(next_urls.begin(), next_urls.end(), IsLessUseful) =
+      NextURL(url_id, time);
+}
+
+void PrerenderTransitionIndex::MaybePrune() {
+  if (entries_.size() <= kMaxSourceURLs)
+    return;
+
+  // Prune a tenth more than needed, so that this only runs every so often.
+  std::vector<std::pair<base::Time, URLID> > by_time;
+  by_time.reserve(entries_.size());
+  for (EntryMap::const_iterator it = entries_.begin(); it != entries_.end();
+       ++it) {
+    by_time.push_back(std::make_pair(it->second.last_visit_time, it->first));
+  }
+  size_t prune_count = entries_.size() - kMaxSourceURLs + kMaxSourceURLs / 10;
+  std::nth_element(by_time.begin(), by_time.begin() + prune_count,
+                   by_time.end());
+  for (size_t i = 0; i < prune_count; ++i)
+    entries_.erase(by_time[i].second);
+}
+
+}  // namespace prerender
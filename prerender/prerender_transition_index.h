@@ -0,0 +1,103 @@
+// Copyright 2013 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CHROME_BROWSER_PRERENDER_PRERENDER_TRANSITION_INDEX_H_
+#define CHROME_BROWSER_PRERENDER_PRERENDER_TRANSITION_INDEX_H_
+
+#include <deque>
+#include <map>
+#include <set>
+#include <utility>
+#include <vector>
+
+#include "base/basictypes.h"
+#include "base/time/time.h"
+#include "chrome/browser/history/history_types.h"
+
+namespace prerender {
+
+// PrerenderTransitionIndex counts, for each URL, how often each other URL was
+// visited shortly after it. It is built incrementally from visits, so that
+// the likely next pages of a URL can be looked up without scanning the visit
+// history.
+//
+// A URL B counts as visited after a visit of A if it was visited between
+// |min_age| and |max_age| after it, and before A was visited again. B is
+// counted at most once per visit of A.
+class PrerenderTransitionIndex {
+ public:
+  struct NextURL {
+    NextURL(history::URLID url_id, base::Time last_visit_time);
+
+    history::URLID url_id;
+
+    // Number of visits of the source URL after which this URL was visited.
+    int count;
+
+    base::Time last_visit_time;
+  };
+
+  struct Entry {
+    Entry();
+    ~Entry();
+
+    // Number of visits of the source URL.
+    int visit_count;
+
+    base::Time last_visit_time;
+
+    // The most frequently visited next URLs, in no particular order.
+    std::vector<NextURL> next_urls;
+  };
+
+  // Maximum number of source URLs, and of next URLs per source URL, to keep.
+  static const size_t kMaxSourceURLs = 20 * 1000;
+  static const size_t kMaxNextURLs = 20;
+
+  PrerenderTransitionIndex(base::TimeDelta min_age, base::TimeDelta max_age);
+  ~PrerenderTransitionIndex();
+
+  // Adds a visit of |url_id| at |time|. Visits are expected in the order of
+  // their times. If |can_be_next| is false, the visit is only counted as a
+  // visit of a source URL, not as a next URL of the URLs visited before it.
+  void AddVisit(history::URLID url_id, base::Time time, bool can_be_next);
+
+  // Returns the entry for |url_id|, or NULL if it was not visited.
+  const Entry* FindEntry(history::URLID url_id) const;
+
+  size_t size() const { return entries_.size(); }
+
+ private:
+  // A visit of a source URL which later visits may be counted for.
+  struct OpenVisit {
+    base::Time time;
+    std::set<history::URLID> counted_urls;
+  };
+
+  typedef std::map<history::URLID, Entry> EntryMap;
+  typedef std::map<history::URLID, OpenVisit> OpenVisitMap;
+
+  // Counts |url_id| visited at |time| as a next URL of |entry|.
+  void AddNextURL(Entry* entry, history::URLID url_id, base::Time time);
+
+  // Removes the least recently visited source URLs once there are more than
+  // kMaxSourceURLs of them.
+  void MaybePrune();
+
+  const base::TimeDelta min_age_;
+  const base::TimeDelta max_age_;
+
+  EntryMap entries_;
+
+  // The last visit of each URL visited less than |max_age_| ago, and the
+  // visits in the order of their times, to expire them.
+  OpenVisitMap open_visits_;
+  std::deque<std::pair<base::Time, history::URLID> > open_visit_times_;
+
+  DISALLOW_COPY_AND_ASSIGN(PrerenderTransitionIndex);
+};
+
+}  // namespace prerender
+
+#endif  // CHROME_BROWSER_PRERENDER_PRERENDER_TRANSITION_INDEX_H_
@@ -0,0 +1,97 @@
+// Copyright 2013 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "chrome/browser/prerender/prerender_transition_index.h"
+
+#include "testing/gtest/include/gtest/gtest.h"
+
+using base::Time;
+using base::TimeDelta;
+using history::URLID;
+
+namespace prerender {
+
+namespace {
+
+class PrerenderTransitionIndexTest : public testing::Test {
+ protected:
+  PrerenderTransitionIndexTest()
+      : index_(TimeDelta::FromSeconds(1), TimeDelta::FromMinutes(1)),
+        now_(Time::Now()) {
+  }
+
+  void Visit(URLID url_id, TimeDelta delay) {
+    now_ += delay;
+    index_.AddVisit(url_id, now_, true);
+  }
+
+  // Returns how often |next_url_id| was visited after |url_id|, or 0.
+  int GetNextURLCount(URLID url_id, URLID next_url_id) const {
+    const PrerenderTransitionIndex::Entry* entry = index_.FindEntry(url_id);
+    if (!entry)
+      return 0;
+    for (size_t i = 0; i < entry->next_urls.size(); ++i) {
+      if (entry->next_urls[i].url_id == next_url_id)
+        return entry->next_urls[i].count;
+    }
+    return 0;
+  }
+
+  PrerenderTransitionIndex index_;
+  Time now_;
+};
+
+}  // namespace
+
+TEST_F(PrerenderTransitionIndexTest, CountsNextURLsInWindow) {
+  const TimeDelta kShortDelay = TimeDelta::FromMilliseconds(100);
+  const TimeDelta kDelay = TimeDelta::FromSeconds(5);
+
+  Visit(1, kDelay);
+  Visit(2, kShortDelay);  // Too soon after 1.
+  Visit(3, kDelay);
+  Visit(3, kDelay);  // Counted once per visit of 1.
+  Visit(1, TimeDelta::FromMinutes(2));
+  Visit(3, kDelay);
+
+  const PrerenderTransitionIndex::Entry* entry = index_.FindEntry(1);
+  ASSERT_TRUE(entry);
+  EXPECT_EQ(2, entry->visit_count);
+  EXPECT_EQ(0, GetNextURLCount(1, 2));
+  EXPECT_EQ(2, GetNextURLCount(1, 3));
+  EXPECT_EQ(1, GetNextURLCount(2, 3));
+  EXPECT_FALSE(index_.FindEntry(4));
+}
+
+TEST_F(PrerenderTransitionIndexTest, IgnoresExpiredVisits) {
+  Visit(1, TimeDelta());
+  Visit(2, TimeDelta::FromMinutes(2));
+  EXPECT_EQ(0, GetNextURLCount(1, 2));
+
+  // A visit which can't be a next URL still starts a window of its own.
+  now_ += TimeDelta::FromSeconds(5);
+  index_.AddVisit(3, now_, false);
+  Visit(4, TimeDelta::FromSeconds(5));
+  EXPECT_EQ(0, GetNextURLCount(2, 3));
+  EXPECT_EQ(1, GetNextURLCount(3, 4));
+}
+
+TEST_F(PrerenderTransitionIndexTest, KeepsMostFrequentNextURLs) {
+  const TimeDelta kDelay = TimeDelta::FromSeconds(2);
+  for (int i = 0; i < 3; ++i) {
+    Visit(1, TimeDelta::FromMinutes(2));
+    Visit(2, kDelay);
+  }
+  Visit(1, TimeDelta::FromMinutes(2));
+  for (size_t i = 0; i < PrerenderTransitionIndex::kMaxNextURLs; ++i)
+    Visit(100 + i, kDelay);
+
+  const PrerenderTransitionIndex::Entry* entry = index_.FindEntry(1);
+  ASSERT_TRUE(entry);
+  EXPECT_EQ(PrerenderTransitionIndex::kMaxNextURLs, entry->next_urls.size());
+  EXPECT_EQ(3, GetNextURLCount(1, 2));
+  EXPECT_EQ(0, GetNextURLCount(1, 100));
+}
+
+}  // namespace prerender
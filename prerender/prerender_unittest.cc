@@ -190,6 +190,10 @@ class UnitTestPrerenderManager : public PrerenderManager {
     mutable_config().rate_limit_enabled = enabled;
   }
 
+  void SetMemoryEstimate(const GURL& url, size_t bytes) {
+    memory_estimates_[url.host()] = bytes;
+  }
+
   PrerenderContents* next_prerender_contents() {
     return next_prerender_contents_.get();
   }
@@ -754,6 +758,73 @@ TEST_F(PrerenderTest, SourceRenderViewClosed) {
   EXPECT_FALSE(LauncherHasRunningPrerender(100, last_prerender_id()));
 }
 
+// Tests that a prerender is not started for a host whose prerenders are known
+// to use more memory than a single prerender may.
+TEST_F(PrerenderTest, MemoryEstimateTooLarge) {
+  GURL url("http://www.google.com/");
+  prerender_manager()->SetMemoryEstimate(
+      url, prerender_manager()->config().max_bytes + 1);
+  DummyPrerenderContents* prerender_contents =
+      prerender_manager()->CreateNextPrerenderContents(
+          url,
+          FINAL_STATUS_MANAGER_SHUTDOWN);
+  EXPECT_FALSE(AddSimplePrerender(url));
+  EXPECT_FALSE(prerender_contents->prerendering_has_started());
+}
+
+// Tests that prerenders which are expected to not fit in the memory budget
+// together are not started.
+TEST_F(PrerenderTest, MemoryBudgetExceeded) {
+  SetConcurrency(2);
+  const size_t kMegabyte = 1024 * 1024;
+  prerender_manager()->mutable_config().max_total_bytes = 100 * kMegabyte;
+
+  GURL url1("http://www.google.com/");
+  GURL url2("http://www.chromium.org/");
+  prerender_manager()->SetMemoryEstimate(url1, 60 * kMegabyte);
+  prerender_manager()->SetMemoryEstimate(url2, 60 * kMegabyte);
+
+  DummyPrerenderContents* prerender_contents1 =
+      prerender_manager()->CreateNextPrerenderContents(
+          url1, FINAL_STATUS_MANAGER_SHUTDOWN);
+  EXPECT_TRUE(AddSimplePrerender(url1));
+  EXPECT_TRUE(prerender_contents1->prerendering_has_started());
+
+  DummyPrerenderContents* prerender_contents2 =
+      prerender_manager()->CreateNextPrerenderContents(
+          url2, FINAL_STATUS_MANAGER_SHUTDOWN);
+  EXPECT_FALSE(AddSimplePrerender(url2));
+  EXPECT_FALSE(prerender_contents2->prerendering_has_started());
+}
+
+// Tests that abandoned prerenders do not count against the memory budget of
+// new prerenders.
+TEST_F(PrerenderTest, MemoryBudgetIgnoresAbandoned) {
+  SetConcurrency(2);
+  const size_t kMegabyte = 1024 * 1024;
+  prerender_manager()->mutable_config().max_total_bytes = 100 * kMegabyte;
+
+  GURL url1("http://www.google.com/");
+  GURL url2("http://www.chromium.org/");
+  prerender_manager()->SetMemoryEstimate(url1, 60 * kMegabyte);
+  prerender_manager()->SetMemoryEstimate(url2, 60 * kMegabyte);
+
+  DummyPrerenderContents* prerender_contents1 =
+      prerender_manager()->CreateNextPrerenderContents(
+          url1, FINAL_STATUS_MANAGER_SHUTDOWN);
+  EXPECT_TRUE(AddSimplePrerender(url1));
+  EXPECT_TRUE(prerender_contents1->prerendering_has_started());
+  prerender_link_manager()->OnAbandonPrerender(kDefaultChildId,
+                                               last_prerender_id());
+  EXPECT_EQ(prerender_contents1, prerender_manager()->FindEntry(url1));
+
+  DummyPrerenderContents* prerender_contents2 =
+      prerender_manager()->CreateNextPrerenderContents(
+          url2, FINAL_STATUS_MANAGER_SHUTDOWN);
+  EXPECT_TRUE(AddSimplePrerender(url2));
+  EXPECT_TRUE(prerender_contents2->prerendering_has_started());
+}
+
 // Tests that prerendering is cancelled when we launch a second prerender of
 // the same target within a short time interval.
 TEST_F(PrerenderTest, RecentlyVisited) {
@@ -51,6 +51,7 @@ void NotificationCallback(PrintJobWorkerOwner* print_job,
 PrintJobWorker::PrintJobWorker(PrintJobWorkerOwner* owner)
     : Thread("Printing_Worker"),
       owner_(owner),
+      page_poll_pending_(false),
       weak_factory_(this) {
   // The object is created in the IO thread.
   DCHECK_EQ(owner_->message_loop(), base::MessageLoop::current());
@@ -266,11 +267,16 @@ void PrintJobWorker::OnNewPage() {
     // Is the page available?
     scoped_refptr<PrintedPage> page;
     if (!document_->GetPage(page_number_.ToInt(), &page)) {
-      // We need to wait for the page to be available.
-      base::MessageLoop::current()->PostDelayedTask(
-          FROM_HERE,
-          base::Bind(&PrintJobWorker::OnNewPage, weak_factory_.GetWeakPtr()),
-          base::TimeDelta::FromMilliseconds(500));
+      // We need to wait for the page to be available. PrintJob calls
+      // OnNewPage() as soon as a page arrives, so the poll is only a fallback.
+      if (!page_poll_pending_) {
+        page_poll_pending_ = true;
+        base::MessageLoop::current()->PostDelayedTask(
+            FROM_HERE,
+            base::Bind(&PrintJobWorker::PollForNewPage,
+                       weak_factory_.GetWeakPtr()),
+            base::TimeDelta::FromMilliseconds(500));
+      }
       break;
     }
     // The page is there, print it.
@@ -284,6 +290,11 @@ void PrintJobWorker::OnNewPage() {
   }
 }
 
+void PrintJobWorker::PollForNewPage() {
+  page_poll_pending_ = false;
+  OnNewPage();
+}
+
 void PrintJobWorker::Cancel() {
   // This is the only function that can be called from any thread.
   printing_context_->Cancel();
@@ -62,9 +62,9 @@ class PrintJobWorker : public base::Thread {
   // Updates the printed document.
   void OnDocumentChanged(PrintedDocument* new_document);
 
-  // Dequeues waiting pages. Called when PrintJob receives a
-  // NOTIFY_PRINTED_DOCUMENT_UPDATED notification. It's time to look again if
-  // the next page can be printed.
+  // Dequeues waiting pages. Called by PrintJob::OnPageAdded() when the
+  // document gets a new page. It's time to look again if the next page can be
+  // printed.
   void OnNewPage();
 
   // This is the only function that can be called in a thread.
@@ -82,6 +82,9 @@ class PrintJobWorker : public base::Thread {
   // and DEFAULT_INIT_DONE. These three are sent through PrintJob::InitDone().
   class NotificationTask;
 
+  // Calls OnNewPage() for the poll scheduled while waiting for a page.
+  void PollForNewPage();
+
   // Renders a page in the printer.
   void SpoolPage(PrintedPage* page);
 
@@ -132,6 +135,10 @@ class PrintJobWorker : public base::Thread {
   // Current page number to print.
   PageNumber page_number_;
 
+  // True if PollForNewPage() is scheduled, so that the pages which arrive
+  // while waiting don't each schedule another poll.
+  bool page_poll_pending_;
+
   // Used to generate a WeakPtr for callbacks.
   base::WeakPtrFactory<PrintJobWorker> weak_factory_;
 
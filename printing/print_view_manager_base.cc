@@ -181,12 +181,13 @@ void PrintViewManagerBase::OnDidPrintPage(
   }
 #endif
 
-  // Update the rendered document. It will send notifications to the listener.
+  // Update the rendered document, and let the worker spool the new page.
   document->SetPage(params.page_number,
                     metafile.release(),
                     params.actual_shrink,
                     params.page_size,
                     params.content_area);
+  print_job_->OnPageAdded();
 
   ShouldQuitFromInnerMessageLoop();
 }
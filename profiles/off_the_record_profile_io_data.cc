@@ -19,6 +19,7 @@
 #include "chrome/browser/net/chrome_net_log.h"
 #include "chrome/browser/net/chrome_network_delegate.h"
 #include "chrome/browser/net/chrome_url_request_context.h"
+#include "chrome/browser/net/net_log_ring_buffer.h"
 #include "chrome/browser/profiles/profile.h"
 #include "chrome/common/chrome_switches.h"
 #include "chrome/common/extensions/extension.h"
@@ -154,9 +155,12 @@ void OffTheRecordProfileIOData::Handle::LazyInitialize() const {
 }
 
 OffTheRecordProfileIOData::OffTheRecordProfileIOData()
-    : ProfileIOData(true) {}
+    : ProfileIOData(true),
+      net_log_(NULL) {}
 OffTheRecordProfileIOData::~OffTheRecordProfileIOData() {
   DestroyResourceContext();
+  if (net_log_)
+    net_log_->net_log_ring_buffer()->OnOffTheRecordSessionEnded();
 }
 
 void OffTheRecordProfileIOData::InitializeInternal(
@@ -172,6 +176,9 @@ void OffTheRecordProfileIOData::InitializeInternal(
   main_context->set_transport_security_state(transport_security_state());
 
   main_context->set_net_log(io_thread->net_log());
+  // Keep the requests of this profile out of chrome://net-export.
+  net_log_ = io_thread->net_log();
+  net_log_->net_log_ring_buffer()->OnOffTheRecordSessionStarted();
 
   main_context->set_network_delegate(network_delegate());
 
@@ -15,6 +15,7 @@
 #include "chrome/browser/profiles/profile_io_data.h"
 #include "chrome/browser/profiles/storage_partition_descriptor.h"
 
+class ChromeNetLog;
 class ChromeURLRequestContext;
 class ChromeURLRequestContextGetter;
 class Profile;
@@ -143,6 +144,10 @@ class OffTheRecordProfileIOData : public ProfileIOData {
   mutable scoped_ptr<net::URLRequestJobFactory> main_job_factory_;
   mutable scoped_ptr<net::URLRequestJobFactory> extensions_job_factory_;
 
+  // The NetLog this profile was registered with as an off-the-record
+  // session, or NULL if it was never initialized.
+  mutable ChromeNetLog* net_log_;
+
   DISALLOW_COPY_AND_ASSIGN(OffTheRecordProfileIOData);
 };
 
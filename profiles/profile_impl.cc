@@ -53,6 +53,7 @@
 #include "chrome/browser/net/pref_proxy_config_tracker.h"
 #include "chrome/browser/net/proxy_service_factory.h"
 #include "chrome/browser/net/ssl_config_service_manager.h"
+#include "chrome/browser/performance_monitor/startup_tracer.h"
 #include "chrome/browser/plugins/chrome_plugin_service_filter.h"
 #include "chrome/browser/plugins/plugin_prefs.h"
 #include "chrome/browser/policy/profile_policy_connector.h"
@@ -783,8 +784,12 @@ void ProfileImpl::OnPrefsLoaded(bool success) {
   // TODO(sky): remove this in a couple of releases (m28ish).
   prefs_->SetBoolean(prefs::kSessionExitedCleanly, true);
 
-  BrowserContextDependencyManager::GetInstance()->CreateBrowserContextServices(
-      this);
+  {
+    performance_monitor::ScopedStartupPhase startup_phase(
+        "ProfileImpl::CreateBrowserContextServices");
+    BrowserContextDependencyManager::GetInstance()->
+        CreateBrowserContextServices(this);
+  }
 
   DCHECK(!net_pref_observer_);
   {
@@ -504,8 +504,14 @@ void ProfileInfoCache::SetUserNameOfProfileAtIndex(size_t index,
 
 void ProfileInfoCache::SetAvatarIconOfProfileAtIndex(size_t index,
                                                      size_t icon_index) {
+  std::string icon_url = GetDefaultAvatarIconUrl(icon_index);
+  std::string current_icon_url;
+  GetInfoForProfileAtIndex(index)->GetString(kAvatarIconKey, &current_icon_url);
+  if (icon_url == current_icon_url)
+    return;
+
   scoped_ptr<DictionaryValue> info(GetInfoForProfileAtIndex(index)->DeepCopy());
-  info->SetString(kAvatarIconKey, GetDefaultAvatarIconUrl(icon_index));
+  info->SetString(kAvatarIconKey, icon_url);
   // This takes ownership of |info|.
   SetInfoForProfileAtIndex(index, info.release());
 
@@ -517,6 +523,9 @@ void ProfileInfoCache::SetAvatarIconOfProfileAtIndex(size_t index,
 
 void ProfileInfoCache::SetManagedUserIdOfProfileAtIndex(size_t index,
                                                         const std::string& id) {
+  if (id == GetManagedUserIdOfProfileAtIndex(index))
+    return;
+
   scoped_ptr<DictionaryValue> info(GetInfoForProfileAtIndex(index)->DeepCopy());
   info->SetString(kManagedUserId, id);
   // This takes ownership of |info|.
@@ -593,18 +602,23 @@ void ProfileInfoCache::SetGAIAPictureOfProfileAtIndex(size_t index,
   base::FilePath path = GetPathOfProfileAtIndex(index);
   std::string key = CacheKeyFromProfilePath(path);
 
-  // Delete the old bitmap from cache.
+  std::string old_file_name;
+  GetInfoForProfileAtIndex(index)->GetString(
+      kGAIAPictureFileNameKey, &old_file_name);
+  std::string new_file_name;
+
+  // Every GAIA info refresh of a profile without a picture clears it again,
+  // which would otherwise rewrite Local State and update the avatars.
   std::map<std::string, gfx::Image*>::iterator it = gaia_pictures_.find(key);
+  if (!image && old_file_name.empty() && it == gaia_pictures_.end())
+    return;
+
+  // Delete the old bitmap from cache.
   if (it != gaia_pictures_.end()) {
     delete it->second;
     gaia_pictures_.erase(it);
   }
 
-  std::string old_file_name;
-  GetInfoForProfileAtIndex(index)->GetString(
-      kGAIAPictureFileNameKey, &old_file_name);
-  std::string new_file_name;
-
   if (!image) {
     // Delete the old bitmap from disk.
     if (!old_file_name.empty()) {
@@ -644,6 +658,9 @@ void ProfileInfoCache::SetGAIAPictureOfProfileAtIndex(size_t index,
 
 void ProfileInfoCache::SetIsUsingGAIAPictureOfProfileAtIndex(size_t index,
                                                              bool value) {
+  if (value == IsUsingGAIAPictureOfProfileAtIndex(index))
+    return;
+
   scoped_ptr<DictionaryValue> info(GetInfoForProfileAtIndex(index)->DeepCopy());
   info->SetBoolean(kUseGAIAPictureKey, value);
   // This takes ownership of |info|.
@@ -114,6 +114,23 @@ void ProfileInfoCacheTest::ResetCache() {
 
 namespace {
 
+// Counts the avatar changes of all the profiles.
+class AvatarChangeCounter : public ProfileInfoCacheObserver {
+ public:
+  AvatarChangeCounter() : count_(0) {}
+  virtual ~AvatarChangeCounter() {}
+
+  virtual void OnProfileAvatarChanged(
+      const base::FilePath& profile_path) OVERRIDE {
+    ++count_;
+  }
+
+  int count_;
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(AvatarChangeCounter);
+};
+
 TEST_F(ProfileInfoCacheTest, AddProfiles) {
   EXPECT_EQ(0u, GetCache()->GetNumberOfProfiles());
 
@@ -446,6 +463,26 @@ TEST_F(ProfileInfoCacheTest, EmptyGAIAInfo) {
       profile_image, GetCache()->GetAvatarIconOfProfileAtIndex(0)));
 }
 
+TEST_F(ProfileInfoCacheTest, UnchangedAvatarIsNotUpdated) {
+  AvatarChangeCounter counter;
+
+  GetCache()->AddProfileToCache(
+      GetProfilePath("path_1"), ASCIIToUTF16("name_1"),
+      string16(), 0, std::string());
+  GetCache()->AddObserver(&counter);
+
+  GetCache()->SetAvatarIconOfProfileAtIndex(0, 0);
+  GetCache()->SetGAIAPictureOfProfileAtIndex(0, NULL);
+  GetCache()->SetIsUsingGAIAPictureOfProfileAtIndex(0, false);
+  EXPECT_EQ(0, counter.count_);
+
+  GetCache()->SetAvatarIconOfProfileAtIndex(0, 1);
+  GetCache()->SetIsUsingGAIAPictureOfProfileAtIndex(0, true);
+  EXPECT_EQ(2, counter.count_);
+
+  GetCache()->RemoveObserver(&counter);
+}
+
 TEST_F(ProfileInfoCacheTest, CreateManagedTestingProfile) {
   testing_profile_manager_.CreateTestingProfile("default");
   string16 managed_user_name = ASCIIToUTF16("Supervised User");
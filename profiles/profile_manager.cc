@@ -24,6 +24,7 @@
 #include "chrome/browser/browser_process.h"
 #include "chrome/browser/chrome_notification_types.h"
 #include "chrome/browser/content_settings/host_content_settings_map.h"
+#include "chrome/browser/performance_monitor/startup_tracer.h"
 #include "chrome/browser/prefs/incognito_mode_prefs.h"
 #include "chrome/browser/prefs/scoped_user_pref_update.h"
 #include "chrome/browser/profiles/bookmark_model_loaded_observer.h"
@@ -758,8 +759,12 @@ void ProfileManager::DoFinalInitForServices(Profile* profile,
     defer_creation = trial->group() == defer_creation_group;
   }
 
-  extensions::ExtensionSystem::Get(profile)->InitForRegularProfile(
-      !go_off_the_record, defer_creation);
+  {
+    performance_monitor::ScopedStartupPhase startup_phase(
+        "ExtensionSystem::InitForRegularProfile");
+    extensions::ExtensionSystem::Get(profile)->InitForRegularProfile(
+        !go_off_the_record, defer_creation);
+  }
   // During tests, when |profile| is an instance of TestingProfile,
   // ExtensionSystem might not create an ExtensionService.
   if (extensions::ExtensionSystem::Get(profile)->extension_service()) {
@@ -795,6 +800,8 @@ void ProfileManager::DoFinalInitLogging(Profile* profile) {
 }
 
 Profile* ProfileManager::CreateProfileHelper(const base::FilePath& path) {
+  performance_monitor::ScopedStartupPhase startup_phase(
+      "ProfileManager::CreateProfileHelper");
   return Profile::CreateProfile(path, NULL, Profile::CREATE_MODE_SYNCHRONOUS);
 }
 
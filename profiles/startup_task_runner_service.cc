@@ -6,7 +6,12 @@
 
 #include "base/deferred_sequenced_task_runner.h"
 #include "base/logging.h"
+#include "base/prefs/json_pref_store.h"
 #include "chrome/browser/profiles/profile.h"
+#include "chrome/common/chrome_constants.h"
+#include "content/public/browser/browser_thread.h"
+
+using content::BrowserThread;
 
 StartupTaskRunnerService::StartupTaskRunnerService(Profile* profile)
     : profile_(profile) {
@@ -19,8 +24,10 @@ scoped_refptr<base::DeferredSequencedTaskRunner>
     StartupTaskRunnerService::GetBookmarkTaskRunner() {
   DCHECK(CalledOnValidThread());
   if (!bookmark_task_runner_.get()) {
-    bookmark_task_runner_ =
-        new base::DeferredSequencedTaskRunner(profile_->GetIOTaskRunner());
+    bookmark_task_runner_ = new base::DeferredSequencedTaskRunner(
+        JsonPrefStore::GetTaskRunnerForFile(
+            profile_->GetPath().Append(chrome::kBookmarksFileName),
+            BrowserThread::GetBlockingPool()));
   }
   return bookmark_task_runner_;
 }
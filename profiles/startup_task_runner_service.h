@@ -32,7 +32,10 @@ class StartupTaskRunnerService : public base::NonThreadSafe,
   // bookmarks only after the history finished).
   scoped_refptr<base::DeferredSequencedTaskRunner> GetBookmarkTaskRunner();
 
-  // Starts the task runners that are deferred during start-up.
+  // Starts the task runners that are deferred during start-up. Each one is
+  // sequenced on the file of its service rather than on the profile's I/O
+  // task runner, so the deferred loads don't wait on each other or on the
+  // preference writes, and run in parallel on the blocking pool.
   void StartDeferredTaskRunners();
 
  private:
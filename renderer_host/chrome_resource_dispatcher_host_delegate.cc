@@ -476,10 +476,12 @@ void ChromeResourceDispatcherHostDelegate::AppendStandardResourceThrottles(
 #endif
 
 #if defined(ENABLE_MANAGED_USERS)
-  bool is_subresource_request = resource_type != ResourceType::MAIN_FRAME;
-  throttles->push_back(new ManagedModeResourceThrottle(
-        request, !is_subresource_request,
-        io_data->managed_mode_url_filter()));
+  // The managed mode throttle only filters main frame requests, so don't add
+  // it to the much more frequent subresource requests.
+  if (resource_type == ResourceType::MAIN_FRAME) {
+    throttles->push_back(new ManagedModeResourceThrottle(
+          request, true, io_data->managed_mode_url_filter()));
+  }
 #endif
 
   content::ResourceThrottle* throttle =
@@ -69,6 +69,9 @@ WebCacheManager* WebCacheManager::GetInstance() {
 
 WebCacheManager::WebCacheManager()
     : global_size_limit_(GetDefaultGlobalSizeLimit()),
+      memory_pressure_critical_(false),
+      memory_pressure_listener_(base::Bind(&WebCacheManager::OnMemoryPressure,
+                                           base::Unretained(this))),
       weak_factory_(this) {
   registrar_.Add(this, content::NOTIFICATION_RENDERER_PROCESS_CREATED,
                  content::NotificationService::AllBrowserContextsAndSources());
@@ -251,11 +254,12 @@ bool WebCacheManager::AttemptTactic(
   size_t inactive_size = GetSize(inactive_tactic, inactive_stats);
 
   // Give up if we don't have enough space to use this tactic.
-  if (global_size_limit_ < active_size + inactive_size)
+  size_t size_limit = GetAvailableSizeLimit();
+  if (size_limit < active_size + inactive_size)
     return false;
 
   // Compute the unreserved space available.
-  size_t total_extra = global_size_limit_ - (active_size + inactive_size);
+  size_t total_extra = size_limit - (active_size + inactive_size);
 
   // The plan for the extra space is to divide it evenly amoung the active
   // renderers.
@@ -431,6 +435,31 @@ void WebCacheManager::ReviseAllocationStrategyLater() {
       base::TimeDelta::FromMilliseconds(kReviseAllocationDelayMS));
 }
 
+void WebCacheManager::OnMemoryPressure(
+    base::MemoryPressureListener::MemoryPressureLevel memory_pressure_level) {
+  memory_pressure_time_ = Time::Now();
+  memory_pressure_critical_ = memory_pressure_level ==
+      base::MemoryPressureListener::MEMORY_PRESSURE_CRITICAL;
+  ReviseAllocationStrategy();
+
+  // Give the memory back once the pressure is over.
+  base::MessageLoop::current()->PostDelayedTask(FROM_HERE,
+      base::Bind(
+          &WebCacheManager::ReviseAllocationStrategy,
+          weak_factory_.GetWeakPtr()),
+      TimeDelta::FromMinutes(kMemoryPressureRecoveryMinutes));
+}
+
+size_t WebCacheManager::GetAvailableSizeLimit() const {
+  if (memory_pressure_time_.is_null() ||
+      Time::Now() - memory_pressure_time_ >=
+          TimeDelta::FromMinutes(kMemoryPressureRecoveryMinutes)) {
+    return global_size_limit_;
+  }
+  // Under critical pressure, shrink the caches further.
+  return global_size_limit_ / (memory_pressure_critical_ ? 4 : 2);
+}
+
 void WebCacheManager::FindInactiveRenderers() {
   std::set<int>::const_iterator iter = active_renderers_.begin();
   while (iter != active_renderers_.end()) {
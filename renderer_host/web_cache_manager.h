@@ -15,6 +15,7 @@
 #include "base/basictypes.h"
 #include "base/compiler_specific.h"
 #include "base/gtest_prod_util.h"
+#include "base/memory/memory_pressure_listener.h"
 #include "base/memory/weak_ptr.h"
 #include "base/time/time.h"
 #include "content/public/browser/notification_observer.h"
@@ -86,6 +87,10 @@ class WebCacheManager : public content::NotificationObserver {
   // The amount of idle time before we consider a tab to be "inactive"
   static const int kRendererInactiveThresholdMinutes = 5;
 
+  // The amount of time without memory pressure before the caches may use all
+  // of |global_size_limit_| again.
+  static const int kMemoryPressureRecoveryMinutes = 2;
+
   // Keep track of some renderer information.
   struct RendererInfo : WebKit::WebCache::UsageStats {
     // The access time for this renderer.
@@ -115,6 +120,15 @@ class WebCacheManager : public content::NotificationObserver {
   // Schedules a call to ReviseAllocationStrategy after a short delay.
   void ReviseAllocationStrategyLater();
 
+  // Shrinks the cache allocations right away when the system is low on
+  // memory, so that the renderers evict objects before the OS starts paging.
+  void OnMemoryPressure(
+      base::MemoryPressureListener::MemoryPressureLevel memory_pressure_level);
+
+  // Returns the number of bytes the allocation strategy may hand out: the
+  // |global_size_limit_|, or a fraction of it after recent memory pressure.
+  size_t GetAvailableSizeLimit() const;
+
   // The various tactics used as part of an allocation strategy.  To decide
   // how many resources a given renderer should be allocated, we consider its
   // usage statistics.  Each tactic specifies the function that maps usage
@@ -200,6 +214,13 @@ class WebCacheManager : public content::NotificationObserver {
   // The global size limit for all in-memory caches.
   size_t global_size_limit_;
 
+  // When the system last reported memory pressure, and whether it was
+  // critical.
+  base::Time memory_pressure_time_;
+  bool memory_pressure_critical_;
+
+  base::MemoryPressureListener memory_pressure_listener_;
+
   // Maps every renderer_id our most recent copy of its statistics.
   StatsMap stats_;
 
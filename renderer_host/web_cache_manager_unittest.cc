@@ -41,6 +41,21 @@ class WebCacheManagerTest : public testing::Test {
     h->FindInactiveRenderers();
   }
 
+  static void SimulateMemoryPressure(
+      WebCacheManager* h,
+      base::MemoryPressureListener::MemoryPressureLevel level) {
+    h->OnMemoryPressure(level);
+  }
+
+  static void SimulateMemoryPressureRecovery(WebCacheManager* h) {
+    h->memory_pressure_time_ = Time::Now() - TimeDelta::FromMinutes(
+        WebCacheManager::kMemoryPressureRecoveryMinutes);
+  }
+
+  static size_t GetAvailableSizeLimit(WebCacheManager* h) {
+    return h->GetAvailableSizeLimit();
+  }
+
   static std::set<int>& active_renderers(WebCacheManager* h) {
     return h->active_renderers_;
   }
@@ -179,6 +194,35 @@ TEST_F(WebCacheManagerTest, SetGlobalSizeLimitTest) {
   EXPECT_EQ(0U, manager()->global_size_limit());
 }
 
+TEST_F(WebCacheManagerTest, MemoryPressureTest) {
+  manager()->SetGlobalSizeLimit(8 * 1024 * 1024);
+  EXPECT_EQ(8U * 1024 * 1024, GetAvailableSizeLimit(manager()));
+
+  manager()->Add(kRendererID);
+  manager()->ObserveStats(kRendererID, kStats);
+
+  SimulateMemoryPressure(manager(),
+      base::MemoryPressureListener::MEMORY_PRESSURE_MODERATE);
+  EXPECT_EQ(4U * 1024 * 1024, GetAvailableSizeLimit(manager()));
+
+  // The allocation only gets the reduced limit.
+  WebCache::UsageStats empty_stats = {0};
+  AllocationStrategy strategy;
+  EXPECT_TRUE(AttemptTactic(manager(), DIVIDE_EVENLY, kStats,
+                            DIVIDE_EVENLY, empty_stats, &strategy));
+  ASSERT_EQ(1U, strategy.size());
+  EXPECT_EQ(4U * 1024 * 1024, strategy.front().second);
+
+  SimulateMemoryPressure(manager(),
+      base::MemoryPressureListener::MEMORY_PRESSURE_CRITICAL);
+  EXPECT_EQ(2U * 1024 * 1024, GetAvailableSizeLimit(manager()));
+
+  SimulateMemoryPressureRecovery(manager());
+  EXPECT_EQ(8U * 1024 * 1024, GetAvailableSizeLimit(manager()));
+
+  manager()->Remove(kRendererID);
+}
+
 TEST_F(WebCacheManagerTest, GatherStatsTest) {
   manager()->Add(kRendererID);
   manager()->Add(kRendererID2);
@@ -0,0 +1,69 @@
+// Copyright 2013 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+/**
+ * Javascript for extensions_internals.html, served from
+ * chrome://extensions-internals/
+ * Shows how long the extension API calls of each extension took to be
+ * created, checked against the quota and run, and how large their responses
+ * were.
+ */
+
+cr.define('extensionsInternals', function() {
+  'use strict';
+
+  var appendRow = internalsTable.appendRow;
+
+  /**
+   * Renders the stats sent by the browser.
+   * @param {Array} stats the stats of each function called by each extension.
+   */
+  function onFunctionStats(stats) {
+    var container = $('function-stats');
+    container.textContent = '';
+    if (!stats.length) {
+      container.textContent = 'No extension has called an API yet.';
+      return;
+    }
+
+    stats.sort(function(a, b) {
+      return b.runTime - a.runTime;
+    });
+
+    var table = document.createElement('table');
+    var thead = document.createElement('thead');
+    appendRow(thead, 'th', ['Extension', 'Function', 'Calls', 'Create',
+                            'Quota', 'Run', 'Responses', 'Response bytes']);
+    table.appendChild(thead);
+
+    var tbody = document.createElement('tbody');
+    for (var i = 0; i < stats.length; ++i) {
+      var entry = stats[i];
+      appendRow(tbody, 'td', [entry.name, entry.function, entry.calls,
+                              entry.createTime.toFixed(1),
+                              entry.quotaTime.toFixed(1),
+                              entry.runTime.toFixed(1), entry.responses,
+                              entry.responseBytes]);
+    }
+    table.appendChild(tbody);
+
+    container.appendChild(table);
+  }
+
+  function requestFunctionStats() {
+    chrome.send('requestFunctionStats');
+  }
+
+  function initialize() {
+    $('refresh').onclick = requestFunctionStats;
+    requestFunctionStats();
+  }
+
+  return {
+    initialize: initialize,
+    onFunctionStats: onFunctionStats
+  };
+});
+
+document.addEventListener('DOMContentLoaded', extensionsInternals.initialize);
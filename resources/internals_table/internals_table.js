@@ -0,0 +1,32 @@
+// Copyright 2013 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+/**
+ * Helpers shared by the internals pages which show their stats in tables,
+ * chrome://extensions-internals/ and chrome://webrequest-internals/
+ */
+
+cr.define('internalsTable', function() {
+  'use strict';
+
+  /**
+   * Appends a row of cells with |values| to |parent|.
+   * @param {Element} parent the element to append to.
+   * @param {string} cellType 'td' or 'th'.
+   * @param {Array} values the contents of the cells.
+   */
+  function appendRow(parent, cellType, values) {
+    var tr = document.createElement('tr');
+    for (var i = 0; i < values.length; ++i) {
+      var cell = document.createElement(cellType);
+      cell.textContent = values[i];
+      tr.appendChild(cell);
+    }
+    parent.appendChild(tr);
+  }
+
+  return {
+    appendRow: appendRow
+  };
+});
@@ -29,6 +29,7 @@ var NetExportView = (function() {
 
   /** @const */ var START_DATA_BUTTON_ID = 'export-view-start-data';
   /** @const */ var STOP_DATA_BUTTON_ID = 'export-view-stop-data';
+  /** @const */ var SAVE_RECENT_DATA_BUTTON_ID = 'export-view-save-recent-data';
   /** @const */ var SEND_DATA_BUTTON_ID = 'export-view-send-data';
   /** @const */ var FILE_PATH_TEXT_ID = 'export-view-file-path-text';
 
@@ -40,6 +41,7 @@ var NetExportView = (function() {
   function NetExportView() {
     $(START_DATA_BUTTON_ID).onclick = this.onStartData_.bind(this);
     $(STOP_DATA_BUTTON_ID).onclick = this.onStopData_.bind(this);
+    $(SAVE_RECENT_DATA_BUTTON_ID).onclick = this.onSaveRecentData_.bind(this);
     $(SEND_DATA_BUTTON_ID).onclick = this.onSendData_.bind(this);
 
     window.setInterval(function() { chrome.send('getExportNetLogInfo'); },
@@ -65,6 +67,13 @@ var NetExportView = (function() {
       chrome.send('stopNetLog');
     },
 
+    /**
+     * Saves the recently collected NetLog data to a file.
+     */
+    onSaveRecentData_: function() {
+      chrome.send('saveRecentNetLog');
+    },
+
     /**
      * Sends NetLog data via email from browser.
      */
@@ -73,9 +82,9 @@ var NetExportView = (function() {
     },
 
     /**
-     * Enable or disable START_DATA_BUTTON_ID, STOP_DATA_BUTTON_ID and
-     * SEND_DATA_BUTTON_ID buttons. Displays the path name of the file where
-     * NetLog data is collected.
+     * Enable or disable START_DATA_BUTTON_ID, STOP_DATA_BUTTON_ID,
+     * SAVE_RECENT_DATA_BUTTON_ID and SEND_DATA_BUTTON_ID buttons. Displays
+     * the path name of the file where NetLog data is collected.
      */
     onExportNetLogInfoChanged: function(exportNetLogInfo) {
       if (exportNetLogInfo.file) {
@@ -91,13 +100,16 @@ var NetExportView = (function() {
 
       $(START_DATA_BUTTON_ID).disabled = true;
       $(STOP_DATA_BUTTON_ID).disabled = true;
+      $(SAVE_RECENT_DATA_BUTTON_ID).disabled = true;
       $(SEND_DATA_BUTTON_ID).disabled = true;
       if (exportNetLogInfo.state == 'ALLOW_START') {
         $(START_DATA_BUTTON_ID).disabled = false;
+        $(SAVE_RECENT_DATA_BUTTON_ID).disabled = false;
       } else if (exportNetLogInfo.state == 'ALLOW_STOP') {
         $(STOP_DATA_BUTTON_ID).disabled = false;
       } else if (exportNetLogInfo.state == 'ALLOW_START_SEND') {
         $(START_DATA_BUTTON_ID).disabled = false;
+        $(SAVE_RECENT_DATA_BUTTON_ID).disabled = false;
         $(SEND_DATA_BUTTON_ID).disabled = false;
       } else if (exportNetLogInfo.state == 'UNINITIALIZED') {
         $(FILE_PATH_TEXT_ID).textContent =
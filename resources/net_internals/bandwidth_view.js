@@ -2,7 +2,10 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
-/** This view displays summary statistics on bandwidth usage. */
+/**
+ * This view displays summary statistics on bandwidth usage, and on the time
+ * spent in the hooks of the network delegate.
+ */
 var BandwidthView = (function() {
   'use strict';
 
@@ -102,12 +105,42 @@ var BandwidthView = (function() {
                                             historicReceived)
       });
 
-      var input = new JsEvalContext({rows: rows});
+      var input = new JsEvalContext({
+          rows: rows,
+          hooks: getDelegateHookRows_(sessionNetworkStats.delegate_hooks)
+      });
       jstProcess(input, $(BandwidthView.MAIN_BOX_ID));
       return true;
     }
   };
 
+  /**
+   * Returns the rows of the network delegate overhead table for |hooks|, as
+   * sent by the browser.  The time spent per request is relative to the
+   * number of calls to the first hook, OnBeforeURLRequest, which is called
+   * once per request.
+   */
+  function getDelegateHookRows_(hooks) {
+    var rows = [];
+    if (!hooks || hooks.length == 0)
+      return rows;
+
+    var requests = parseInt(hooks[0].calls);
+    for (var i = 0; i < hooks.length; ++i) {
+      var calls = parseInt(hooks[i].calls);
+      var totalMs = parseInt(hooks[i].total_us) / 1000;
+      rows.push({
+          name: hooks[i].name,
+          calls: calls,
+          totalMs: totalMs.toFixed(1),
+          averageMs: calls > 0 ? (totalMs / calls).toFixed(3) : '0.000',
+          perRequestMs:
+              requests > 0 ? (totalMs / requests).toFixed(3) : '0.000'
+      });
+    }
+    return rows;
+  }
+
   /**
    * Converts bytes to kilobytes rounded to one decimal place.
    */
@@ -77,6 +77,10 @@ var TestView = (function() {
                         '<th>Error</th><th>Time (ms)</th></tr>';
 
       this.tbody_ = addNode(table, 'tbody');
+
+      // Rows of the experiments which are in progress, keyed by their
+      // serialized experiment. Several experiments may run at the same time.
+      this.experimentRows_ = {};
     },
 
     /**
@@ -98,7 +102,7 @@ var TestView = (function() {
       // We will fill in result cells with actual values (to replace the
       // placeholder '?') once the test has completed. For now we just
       // save references to these cells.
-      this.currentExperimentRow_ = {
+      this.experimentRows_[JSON.stringify(experiment)] = {
         experimentCell: experimentCell,
         dtCell: dtCell,
         resultCell: resultCell,
@@ -128,7 +132,10 @@ var TestView = (function() {
      * Callback for when an individual test in the suite has finished.
      */
     onCompletedConnectionTestExperiment: function(experiment, result) {
-      var r = this.currentExperimentRow_;
+      var key = JSON.stringify(experiment);
+      var r = this.experimentRows_[key];
+      if (!r)
+        return;
 
       var endTime = timeutil.getCurrentTime();
 
@@ -147,7 +154,7 @@ var TestView = (function() {
         addTextNode(r.passFailCell, 'FAIL');
       }
 
-      this.currentExperimentRow_ = null;
+      delete this.experimentRows_[key];
     },
 
     /**
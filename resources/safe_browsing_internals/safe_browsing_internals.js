@@ -0,0 +1,123 @@
+// Copyright 2013 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+/**
+ * Javascript for safe_browsing_internals.html, served from
+ * chrome://safe-browsing-internals/
+ * Shows the time spent in each phase of the last safe browsing update
+ * cycles, broken down by list or store.
+ */
+
+cr.define('safeBrowsingInternals', function() {
+  'use strict';
+
+  /**
+   * The phases, in the order they are shown.  The keys match the ones
+   * of SafeBrowsingUpdateProfiler.
+   */
+  var PHASES = [
+    ['download', 'Download'],
+    ['parse', 'Parse'],
+    ['insert', 'Insert'],
+    ['processSubs', 'Process subs'],
+    ['buildPrefixSet', 'Build prefix set'],
+    ['write', 'Write'],
+    ['swap', 'Swap'],
+  ];
+
+  /**
+   * Appends a row of cells with |values| to |parent|.
+   * @param {Element} parent the element to append to.
+   * @param {string} cellType 'td' or 'th'.
+   * @param {Array} values the contents of the cells.
+   */
+  function appendRow(parent, cellType, values) {
+    var tr = document.createElement('tr');
+    for (var i = 0; i < values.length; ++i) {
+      var cell = document.createElement(cellType);
+      cell.textContent = values[i];
+      tr.appendChild(cell);
+    }
+    parent.appendChild(tr);
+  }
+
+  /**
+   * Formats a phase of one source as 'time ms (bytes B)'.
+   * @param {Object} phase the phase stats, or undefined.
+   * @return {string} the text of the cell.
+   */
+  function formatPhase(phase) {
+    if (!phase)
+      return '';
+    var text = phase.time.toFixed(1);
+    if (phase.bytes)
+      text += ' (' + phase.bytes + ' B)';
+    return text;
+  }
+
+  /**
+   * Renders the update cycles sent by the browser.
+   * @param {Array} cycles the cycles, most recent first.
+   */
+  function onUpdateCycles(cycles) {
+    var container = $('update-cycles');
+    container.textContent = '';
+    if (!cycles.length) {
+      container.textContent = 'No update cycles have finished yet.';
+      return;
+    }
+
+    var header = ['Source'];
+    for (var i = 0; i < PHASES.length; ++i)
+      header.push(PHASES[i][1]);
+
+    for (var i = 0; i < cycles.length; ++i) {
+      var cycle = cycles[i];
+      var title = document.createElement('h2');
+      title.textContent = new Date(cycle.startTime).toLocaleString() +
+          ', ' + cycle.duration.toFixed(0) + ' ms' +
+          (cycle.success ? '' : ', failed');
+      if (!cycle.success)
+        title.className = 'failed';
+      container.appendChild(title);
+
+      var table = document.createElement('table');
+      var thead = document.createElement('thead');
+      appendRow(thead, 'th', header);
+      table.appendChild(thead);
+
+      var tbody = document.createElement('tbody');
+      for (var j = 0; j < cycle.sources.length; ++j) {
+        var source = cycle.sources[j];
+        var row = [source.name];
+        for (var k = 0; k < PHASES.length; ++k)
+          row.push(formatPhase(source[PHASES[k][0]]));
+        appendRow(tbody, 'td', row);
+      }
+      var totals = ['Total'];
+      for (var k = 0; k < PHASES.length; ++k)
+        totals.push(cycle.totals[PHASES[k][0]].toFixed(1));
+      appendRow(tbody, 'th', totals);
+      table.appendChild(tbody);
+
+      container.appendChild(table);
+    }
+  }
+
+  function requestUpdateCycles() {
+    chrome.send('requestUpdateCycles');
+  }
+
+  function initialize() {
+    $('refresh').onclick = requestUpdateCycles;
+    requestUpdateCycles();
+  }
+
+  return {
+    initialize: initialize,
+    onUpdateCycles: onUpdateCycles
+  };
+});
+
+document.addEventListener('DOMContentLoaded', safeBrowsingInternals.initialize);
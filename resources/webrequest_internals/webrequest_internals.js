@@ -0,0 +1,64 @@
+// Copyright 2013 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+/**
+ * Javascript for webrequest_internals.html, served from
+ * chrome://webrequest-internals/
+ * Shows the median and 99th percentile of the delays that each extension
+ * using the blocking webRequest API recently added to requests.
+ */
+
+cr.define('webRequestInternals', function() {
+  'use strict';
+
+  var appendRow = internalsTable.appendRow;
+
+  /**
+   * Renders the delays sent by the browser.
+   * @param {Array} delays the delays of each extension.
+   */
+  function onExtensionDelays(delays) {
+    var container = $('extension-delays');
+    container.textContent = '';
+    if (!delays.length) {
+      container.textContent = 'No extension has delayed a request yet.';
+      return;
+    }
+
+    delays.sort(function(a, b) {
+      return b.p99 - a.p99;
+    });
+
+    var table = document.createElement('table');
+    var thead = document.createElement('thead');
+    appendRow(thead, 'th', ['Extension', 'ID', 'Requests', 'Median', '99%']);
+    table.appendChild(thead);
+
+    var tbody = document.createElement('tbody');
+    for (var i = 0; i < delays.length; ++i) {
+      var delay = delays[i];
+      appendRow(tbody, 'td', [delay.name, delay.id, delay.count,
+                              delay.p50.toFixed(1), delay.p99.toFixed(1)]);
+    }
+    table.appendChild(tbody);
+
+    container.appendChild(table);
+  }
+
+  function requestExtensionDelays() {
+    chrome.send('requestExtensionDelays');
+  }
+
+  function initialize() {
+    $('refresh').onclick = requestExtensionDelays;
+    requestExtensionDelays();
+  }
+
+  return {
+    initialize: initialize,
+    onExtensionDelays: onExtensionDelays
+  };
+});
+
+document.addEventListener('DOMContentLoaded', webRequestInternals.initialize);
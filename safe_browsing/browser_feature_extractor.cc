@@ -10,6 +10,7 @@
 #include "base/bind.h"
 #include "base/bind_helpers.h"
 #include "base/format_macros.h"
+#include "base/metrics/histogram.h"
 #include "base/stl_util.h"
 #include "base/strings/stringprintf.h"
 #include "base/time/time.h"
@@ -36,11 +37,17 @@ using content::WebContents;
 namespace safe_browsing {
 
 const int BrowserFeatureExtractor::kMaxMalwareIPPerRequest = 5;
+const int BrowserFeatureExtractor::kHistoryLookupBudgetMs = 2000;
+const int BrowserFeatureExtractor::kHostVisitsCacheTTLMinutes = 10;
 
 BrowseInfo::BrowseInfo() : http_status_code(0) {}
 
 BrowseInfo::~BrowseInfo() {}
 
+BrowserFeatureExtractor::HostVisits::HostVisits()
+    : http_visits(0),
+      https_visits(0) {}
+
 static void AddFeature(const std::string& feature_name,
                        double feature_value,
                        ClientPhishingRequest* request) {
@@ -135,7 +142,10 @@ BrowserFeatureExtractor::BrowserFeatureExtractor(
     ClientSideDetectionService* service)
     : tab_(tab),
       service_(service),
-      weak_factory_(this) {
+      weak_factory_(this),
+      next_extraction_id_(0),
+      history_lookup_budget_(
+          base::TimeDelta::FromMilliseconds(kHistoryLookupBudgetMs)) {
   DCHECK(tab);
 }
 
@@ -299,6 +309,15 @@ void BrowserFeatureExtractor::StartExtractFeatures(
     callback.Run(false, request);
     return;
   }
+  ExtractionState& state = extraction_states_[request];
+  state.id = ++next_extraction_id_;
+  state.start_time = base::TimeTicks::Now();
+  base::MessageLoop::current()->PostDelayedTask(
+      FROM_HERE,
+      base::Bind(&BrowserFeatureExtractor::ExtractionTimedOut,
+                 weak_factory_.GetWeakPtr(), request, state.id),
+      history_lookup_budget_);
+
   CancelableRequestProvider::Handle handle = history->QueryURL(
       GURL(request->url()),
       true /* wants_visits */,
@@ -327,7 +346,7 @@ void BrowserFeatureExtractor::QueryUrlHistoryDone(
     // URL is not found in the history.  In practice this should not
     // happen (unless there is a real error) because we just visited
     // that URL.
-    callback.Run(false, request);
+    FinishExtraction(false, request, callback);
     return;
   }
   AddFeature(features::kUrlHistoryVisitCount,
@@ -364,10 +383,20 @@ void BrowserFeatureExtractor::QueryUrlHistoryDone(
              static_cast<double>(num_visits_link),
              request);
 
+  // The host visit counts change slowly, so use the cached ones if they are
+  // fresh.
+  const bool cache_hit = SetCachedHostVisitsFeatures(request);
+  UMA_HISTOGRAM_BOOLEAN("SBClientPhishing.BrowserFeatureHostCacheHit",
+                        cache_hit);
+  if (cache_hit) {
+    FinishExtraction(true, request, callback);
+    return;
+  }
+
   // Issue next history lookup for host visits.
   HistoryService* history;
   if (!GetHistoryService(&history)) {
-    callback.Run(false, request);
+    FinishExtraction(false, request, callback);
     return;
   }
   CancelableRequestProvider::Handle next_handle =
@@ -394,15 +423,20 @@ void BrowserFeatureExtractor::QueryHttpHostVisitsDone(
   DCHECK(request);
   DCHECK(!callback.is_null());
   if (!success) {
-    callback.Run(false, request);
+    FinishExtraction(false, request, callback);
     return;
   }
   SetHostVisitsFeatures(num_visits, first_visit, true, request);
 
+  HostVisits& host_visits = host_visits_cache_[GURL(request->url()).host()];
+  host_visits.http_visits = num_visits;
+  host_visits.first_http_visit = first_visit;
+  host_visits.fetch_time = base::Time();
+
   // Same lookup but for the HTTPS URL.
   HistoryService* history;
   if (!GetHistoryService(&history)) {
-    callback.Run(false, request);
+    FinishExtraction(false, request, callback);
     return;
   }
   std::string https_url = request->url();
@@ -430,11 +464,21 @@ void BrowserFeatureExtractor::QueryHttpsHostVisitsDone(
   DCHECK(request);
   DCHECK(!callback.is_null());
   if (!success) {
-    callback.Run(false, request);
+    FinishExtraction(false, request, callback);
     return;
   }
   SetHostVisitsFeatures(num_visits, first_visit, false, request);
-  callback.Run(true, request);  // We're done with all the history lookups.
+
+  // The entry the HTTP lookup started may have been dropped meanwhile.
+  HostVisitsCache::iterator host_visits =
+      host_visits_cache_.find(GURL(request->url()).host());
+  if (host_visits != host_visits_cache_.end()) {
+    host_visits->second.https_visits = num_visits;
+    host_visits->second.first_https_visit = first_visit;
+    host_visits->second.fetch_time = base::Time::Now();
+  }
+  // We're done with all the history lookups.
+  FinishExtraction(true, request, callback);
 }
 
 void BrowserFeatureExtractor::SetHostVisitsFeatures(
@@ -458,6 +502,72 @@ void BrowserFeatureExtractor::SetHostVisitsFeatures(
   }
 }
 
+void BrowserFeatureExtractor::FinishExtraction(
+    bool success,
+    ClientPhishingRequest* request,
+    const DoneCallback& callback) {
+  ExtractionStateMap::iterator it = extraction_states_.find(request);
+  DCHECK(it != extraction_states_.end());
+  if (it != extraction_states_.end()) {
+    UMA_HISTOGRAM_TIMES("SBClientPhishing.BrowserFeatureHistoryTime",
+                        base::TimeTicks::Now() - it->second.start_time);
+    extraction_states_.erase(it);
+  }
+  callback.Run(success, request);
+}
+
+void BrowserFeatureExtractor::ExtractionTimedOut(
+    ClientPhishingRequest* request,
+    int extraction_id) {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
+  ExtractionStateMap::iterator state = extraction_states_.find(request);
+  if (state == extraction_states_.end() || state->second.id != extraction_id)
+    return;  // The extraction is done.
+
+  for (PendingQueriesMap::iterator it = pending_queries_.begin();
+       it != pending_queries_.end(); ++it) {
+    if (it->second.first != request)
+      continue;
+    HistoryService* history;
+    if (GetHistoryService(&history))
+      history->CancelRequest(it->first);
+    DoneCallback callback = it->second.second;
+    pending_queries_.erase(it);
+    UMA_HISTOGRAM_COUNTS("SBClientPhishing.BrowserFeatureHistoryTimeout", 1);
+    // The request keeps the features which were already extracted.
+    FinishExtraction(false, request, callback);
+    return;
+  }
+  NOTREACHED();
+}
+
+bool BrowserFeatureExtractor::SetCachedHostVisitsFeatures(
+    ClientPhishingRequest* request) {
+  const base::Time now = base::Time::Now();
+  for (HostVisitsCache::iterator it = host_visits_cache_.begin();
+       it != host_visits_cache_.end();) {
+    // Drop the stale entries as we go, and the ones whose HTTPS lookup failed
+    // or timed out.
+    if (it->second.fetch_time.is_null() ||
+        now - it->second.fetch_time >
+        base::TimeDelta::FromMinutes(kHostVisitsCacheTTLMinutes)) {
+      host_visits_cache_.erase(it++);
+    } else {
+      ++it;
+    }
+  }
+
+  HostVisitsCache::const_iterator it =
+      host_visits_cache_.find(GURL(request->url()).host());
+  if (it == host_visits_cache_.end() || it->second.fetch_time.is_null())
+    return false;
+  SetHostVisitsFeatures(it->second.http_visits, it->second.first_http_visit,
+                        true, request);
+  SetHostVisitsFeatures(it->second.https_visits, it->second.first_https_visit,
+                        false, request);
+  return true;
+}
+
 void BrowserFeatureExtractor::StorePendingQuery(
     CancelableRequestProvider::Handle handle,
     ClientPhishingRequest* request,
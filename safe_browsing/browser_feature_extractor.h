@@ -98,12 +98,39 @@ class BrowserFeatureExtractor {
   virtual void ExtractMalwareFeatures(const BrowseInfo* info,
                                       ClientMalwareRequest* request);
 
+  void set_history_lookup_budget_for_testing(base::TimeDelta budget) {
+    history_lookup_budget_ = budget;
+  }
+
  private:
   friend class base::DeleteHelper<BrowserFeatureExtractor>;
   typedef std::pair<ClientPhishingRequest*, DoneCallback> ExtractionData;
   typedef std::map<CancelableRequestProvider::Handle,
                    ExtractionData> PendingQueriesMap;
 
+  // The host visit counts of a host, which |QueryHttpHostVisitsDone()| and
+  // |QueryHttpsHostVisitsDone()| fill in.  |fetch_time| is null until both
+  // are known.
+  struct HostVisits {
+    HostVisits();
+
+    int http_visits;
+    base::Time first_http_visit;
+    int https_visits;
+    base::Time first_https_visit;
+    base::Time fetch_time;
+  };
+  typedef std::map<std::string, HostVisits> HostVisitsCache;
+
+  // Identifies an extraction between StartExtractFeatures() and its
+  // callback, so that its deadline can't apply to a later request which
+  // reuses the same ClientPhishingRequest pointer.
+  struct ExtractionState {
+    int id;
+    base::TimeTicks start_time;
+  };
+  typedef std::map<ClientPhishingRequest*, ExtractionState> ExtractionStateMap;
+
   // Synchronous browser feature extraction.
   void ExtractBrowseInfoFeatures(const BrowseInfo& info,
                                  ClientPhishingRequest* request);
@@ -133,6 +160,21 @@ class BrowserFeatureExtractor {
                                 int num_visits,
                                 base::Time first_visit);
 
+  // Runs |callback| for |request| and records how long the history lookups
+  // took.  All of the history lookups end here.
+  void FinishExtraction(bool success,
+                        ClientPhishingRequest* request,
+                        const DoneCallback& callback);
+
+  // Called when the history lookups for the extraction |extraction_id| of
+  // |request| have used up their time budget.  Cancels the pending lookup
+  // and finishes with the features which are known so far.
+  void ExtractionTimedOut(ClientPhishingRequest* request, int extraction_id);
+
+  // Sets the host visit features of |request| from |host_visits_cache_| if
+  // there is a fresh entry for its host.  Returns false otherwise.
+  bool SetCachedHostVisitsFeatures(ClientPhishingRequest* request);
+
   // Helper function which sets the host history features given the
   // number of host visits and the time of the fist host visit.  Set
   // |is_http_query| to true if the URL scheme is HTTP and to false if
@@ -172,6 +214,27 @@ class BrowserFeatureExtractor {
   // the history callback hasn't been invoked yet).
   PendingQueriesMap pending_queries_;
 
+  // Extractions which have started their history lookups, and the id the
+  // next one gets.
+  ExtractionStateMap extraction_states_;
+  int next_extraction_id_;
+
+  // Time budget for the history lookups of an extraction, which defaults to
+  // |kHistoryLookupBudgetMs|.
+  base::TimeDelta history_lookup_budget_;
+
+  // Host visit counts, by host, which are reused for
+  // |kHostVisitsCacheTTLMinutes| instead of querying the history again.
+  // Entries whose HTTPS lookup didn't complete are dropped on the next
+  // lookup.
+  HostVisitsCache host_visits_cache_;
+
+  // Default time budget for the history lookups of an extraction.
+  static const int kHistoryLookupBudgetMs;
+
+  // How long the host visit counts of a host are cached.
+  static const int kHostVisitsCacheTTLMinutes;
+
   // Max number of malware IPs can be sent in one malware request
   static const int kMaxMalwareIPPerRequest;
 
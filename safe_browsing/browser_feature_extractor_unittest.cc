@@ -258,6 +258,87 @@ TEST_F(BrowserFeatureExtractorTest, UrlInHistory) {
   EXPECT_FALSE(features.count(features::kFirstHttpsHostVisitMoreThan24hAgo));
 }
 
+// The host visit counts are looked up once per host, and reused for the
+// next pages on that host.
+TEST_F(BrowserFeatureExtractorTest, HostVisitsCached) {
+  history_service()->AddPage(GURL("http://www.foo.com/bar.html"),
+                             base::Time::Now(),
+                             history::SOURCE_BROWSED);
+  history_service()->AddPage(GURL("http://www.foo.com/gaa.html"),
+                             base::Time::Now(),
+                             history::SOURCE_BROWSED);
+
+  ClientPhishingRequest request;
+  request.set_url("http://www.foo.com/bar.html");
+  request.set_client_score(0.5);
+  EXPECT_TRUE(ExtractFeatures(&request));
+  std::map<std::string, double> features;
+  GetFeatureMap(request, &features);
+  EXPECT_DOUBLE_EQ(2.0, features[features::kHttpHostVisitCount]);
+  EXPECT_DOUBLE_EQ(0.0, features[features::kHttpsHostVisitCount]);
+
+  // The new visit isn't counted, since the counts come from the cache.
+  history_service()->AddPage(GURL("http://www.foo.com/goo.html"),
+                             base::Time::Now(),
+                             history::SOURCE_BROWSED);
+  request.Clear();
+  request.set_url("http://www.foo.com/gaa.html");
+  request.set_client_score(0.5);
+  EXPECT_TRUE(ExtractFeatures(&request));
+  features.clear();
+  GetFeatureMap(request, &features);
+  EXPECT_DOUBLE_EQ(1.0, features[features::kUrlHistoryVisitCount]);
+  EXPECT_DOUBLE_EQ(2.0, features[features::kHttpHostVisitCount]);
+  EXPECT_DOUBLE_EQ(0.0, features[features::kHttpsHostVisitCount]);
+  EXPECT_FALSE(features.count(features::kFirstHttpsHostVisitMoreThan24hAgo));
+
+  // Other hosts are still looked up.
+  request.Clear();
+  request.set_url("http://bar.foo.com/gaa.html");
+  request.set_client_score(0.5);
+  history_service()->AddPage(GURL("http://bar.foo.com/gaa.html"),
+                             base::Time::Now(),
+                             history::SOURCE_BROWSED);
+  EXPECT_TRUE(ExtractFeatures(&request));
+  features.clear();
+  GetFeatureMap(request, &features);
+  EXPECT_DOUBLE_EQ(1.0, features[features::kHttpHostVisitCount]);
+}
+
+// An extraction whose history lookups use up their time budget finishes
+// without waiting for them, and doesn't leave host visit counts behind.
+TEST_F(BrowserFeatureExtractorTest, HistoryLookupTimeout) {
+  history_service()->AddPage(GURL("http://www.foo.com/bar.html"),
+                             base::Time::Now(),
+                             history::SOURCE_BROWSED);
+
+  extractor_->set_history_lookup_budget_for_testing(base::TimeDelta());
+  ClientPhishingRequest request;
+  request.set_url("http://www.foo.com/bar.html");
+  request.set_client_score(0.5);
+  EXPECT_FALSE(ExtractFeatures(&request));
+  std::map<std::string, double> features;
+  GetFeatureMap(request, &features);
+  EXPECT_FALSE(features.count(features::kUrlHistoryVisitCount));
+  EXPECT_FALSE(features.count(features::kHttpHostVisitCount));
+
+  // The next extraction looks the host visits up again.
+  history_service()->AddPage(GURL("http://www.foo.com/gaa.html"),
+                             base::Time::Now(),
+                             history::SOURCE_BROWSED);
+  extractor_->set_history_lookup_budget_for_testing(
+      base::TimeDelta::FromMinutes(1));
+  request.Clear();
+  request.set_url("http://www.foo.com/bar.html");
+  request.set_client_score(0.5);
+  EXPECT_TRUE(ExtractFeatures(&request));
+  features.clear();
+  GetFeatureMap(request, &features);
+  EXPECT_DOUBLE_EQ(1.0, features[features::kUrlHistoryVisitCount]);
+  EXPECT_DOUBLE_EQ(2.0, features[features::kHttpHostVisitCount]);
+  EXPECT_DOUBLE_EQ(0.0, features[features::kHttpsHostVisitCount]);
+}
+
 TEST_F(BrowserFeatureExtractorTest, MultipleRequestsAtOnce) {
   history_service()->AddPage(GURL("http://www.foo.com/bar.html"),
                              base::Time::Now(),
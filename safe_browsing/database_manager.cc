@@ -27,6 +27,7 @@
 #include "chrome/browser/safe_browsing/safe_browsing_database.h"
 #include "chrome/browser/safe_browsing/safe_browsing_service.h"
 #include "chrome/browser/safe_browsing/ui_manager.h"
+#include "chrome/browser/safe_browsing/update_profiler.h"
 #include "chrome/common/chrome_constants.h"
 #include "chrome/common/chrome_paths.h"
 #include "chrome/common/chrome_switches.h"
@@ -83,6 +84,7 @@ SafeBrowsingDatabaseManager::SafeBrowsingCheck::SafeBrowsingCheck(
       full_hash_results(full_hashes.size(), SB_THREAT_TYPE_SAFE),
       client(client),
       need_get_hash(false),
+      is_url_batch(false),
       check_type(check_type),
       expected_threats(expected_threats) {
   DCHECK_EQ(urls.empty(), !full_hashes.empty())
@@ -100,6 +102,10 @@ void SafeBrowsingDatabaseManager::Client::OnSafeBrowsingResult(
     switch (check.check_type) {
       case safe_browsing_util::MALWARE:
       case safe_browsing_util::PHISH:
+        if (check.is_url_batch) {
+          OnCheckBrowseUrlsResult(check.urls, check.url_results);
+          break;
+        }
         DCHECK_EQ(1u, check.urls.size());
         OnCheckBrowseUrlResult(check.urls[0], check.url_results[0]);
         break;
@@ -348,7 +354,8 @@ bool SafeBrowsingDatabaseManager::CheckBrowseUrl(const GURL& url,
   if (!MakeDatabaseAvailable()) {
     QueuedCheck queued_check(safe_browsing_util::MALWARE,  // or PHISH
                              client,
-                             url,
+                             std::vector<GURL>(1, url),
+                             false,
                              expected_threats,
                              start);
     queued_checks_.push_back(queued_check);
@@ -387,6 +394,79 @@ bool SafeBrowsingDatabaseManager::CheckBrowseUrl(const GURL& url,
   return false;
 }
 
+bool SafeBrowsingDatabaseManager::CheckBrowseUrls(const std::vector<GURL>& urls,
+                                                  Client* client) {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
+  if (!enabled_)
+    return true;
+
+  // The results stay parallel to |urls|, the URLs which can't be checked
+  // are safe.
+  std::vector<GURL> checked_urls;
+  for (size_t i = 0; i < urls.size(); ++i) {
+    if (CanCheckUrl(urls[i]))
+      checked_urls.push_back(urls[i]);
+  }
+  if (checked_urls.empty())
+    return true;
+
+  std::vector<SBThreatType> expected_threats;
+  expected_threats.push_back(SB_THREAT_TYPE_URL_MALWARE);
+  expected_threats.push_back(SB_THREAT_TYPE_URL_PHISHING);
+
+  const base::TimeTicks start = base::TimeTicks::Now();
+  if (!MakeDatabaseAvailable()) {
+    QueuedCheck queued_check(safe_browsing_util::MALWARE,  // or PHISH
+                             client,
+                             urls,
+                             true,
+                             expected_threats,
+                             start);
+    queued_checks_.push_back(queued_check);
+    return false;
+  }
+
+  std::vector<SBPrefix> prefix_hits;
+  std::vector<SBFullHashResult> full_hits;
+
+  bool prefix_match =
+      database_->ContainsBrowseUrls(checked_urls, &prefix_hits, &full_hits,
+          sb_service_->protocol_manager()->last_update());
+
+  UMA_HISTOGRAM_TIMES("SB2.FilterCheckBatch", base::TimeTicks::Now() - start);
+  UMA_HISTOGRAM_COUNTS_100("SB2.FilterCheckBatchSize", checked_urls.size());
+
+  if (!prefix_match)
+    return true;  // URLs are okay.
+
+  SafeBrowsingCheck* check = new SafeBrowsingCheck(urls,
+                                                   std::vector<SBFullHash>(),
+                                                   client,
+                                                   safe_browsing_util::MALWARE,
+                                                   expected_threats);
+  check->is_url_batch = true;
+
+  // Only the prefixes without cached full hashes are sent in the GetHash
+  // request.  HandleOneCheck() checks the URLs against the cached full
+  // hashes along with the results.
+  for (size_t i = 0; i < prefix_hits.size(); ++i) {
+    bool cached = false;
+    for (size_t j = 0; j < full_hits.size() && !cached; ++j)
+      cached = full_hits[j].hash.prefix == prefix_hits[i];
+    if (!cached)
+      check->prefix_hits.push_back(prefix_hits[i]);
+  }
+  check->need_get_hash = !check->prefix_hits.empty();
+  check->full_hits.swap(full_hits);
+  checks_.insert(check);
+
+  BrowserThread::PostTask(
+      BrowserThread::IO, FROM_HERE,
+      base::Bind(&SafeBrowsingDatabaseManager::OnCheckDone, this, check));
+
+  return false;
+}
+
 void SafeBrowsingDatabaseManager::CancelCheck(Client* client) {
   DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
   for (CurrentChecks::iterator i = checks_.begin(); i != checks_.end(); ++i) {
@@ -446,14 +526,14 @@ void SafeBrowsingDatabaseManager::GetChunks(GetChunksCallback callback) {
 }
 
 void SafeBrowsingDatabaseManager::AddChunks(const std::string& list,
-                                            SBChunkList* chunks,
+                                            std::string* chunk_data,
                                             AddChunksCallback callback) {
   DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
   DCHECK(enabled_);
   DCHECK(!callback.is_null());
   safe_browsing_thread_->message_loop()->PostTask(FROM_HERE, base::Bind(
       &SafeBrowsingDatabaseManager::AddDatabaseChunks, this, list,
-      chunks, callback));
+      chunk_data, callback));
 }
 
 void SafeBrowsingDatabaseManager::DeleteChunks(
@@ -532,12 +612,14 @@ void SafeBrowsingDatabaseManager::NotifyDatabaseUpdateFinished(
 SafeBrowsingDatabaseManager::QueuedCheck::QueuedCheck(
     const safe_browsing_util::ListType check_type,
     Client* client,
-    const GURL& url,
+    const std::vector<GURL>& urls,
+    bool is_url_batch,
     const std::vector<SBThreatType>& expected_threats,
     const base::TimeTicks& start)
     : check_type(check_type),
       client(client),
-      url(url),
+      urls(urls),
+      is_url_batch(is_url_batch),
       expected_threats(expected_threats),
       start(start) {
 }
@@ -556,11 +638,12 @@ void SafeBrowsingDatabaseManager::DoStopOnIOThread() {
   while (!queued_checks_.empty()) {
     QueuedCheck queued = queued_checks_.front();
     if (queued.client) {
-      SafeBrowsingCheck sb_check(std::vector<GURL>(1, queued.url),
+      SafeBrowsingCheck sb_check(queued.urls,
                                  std::vector<SBFullHash>(),
                                  queued.client,
                                  queued.check_type,
                                  queued.expected_threats);
+      sb_check.is_url_batch = queued.is_url_batch;
       queued.client->OnSafeBrowsingResult(sb_check);
     }
     queued_checks_.pop_front();
@@ -791,12 +874,15 @@ void SafeBrowsingDatabaseManager::DatabaseLoadComplete() {
     // If CheckUrl() determines the URL is safe immediately, it doesn't call the
     // client's handler function (because normally it's being directly called by
     // the client).  Since we're not the client, we have to convey this result.
-    if (check.client && CheckBrowseUrl(check.url, check.client)) {
-      SafeBrowsingCheck sb_check(std::vector<GURL>(1, check.url),
+    if (check.client && (check.is_url_batch ?
+                         CheckBrowseUrls(check.urls, check.client) :
+                         CheckBrowseUrl(check.urls[0], check.client))) {
+      SafeBrowsingCheck sb_check(check.urls,
                                  std::vector<SBFullHash>(),
                                  check.client,
                                  check.check_type,
                                  check.expected_threats);
+      sb_check.is_url_batch = check.is_url_batch;
       check.client->OnSafeBrowsingResult(sb_check);
     }
     queued_checks_.pop_front();
@@ -804,13 +890,13 @@ void SafeBrowsingDatabaseManager::DatabaseLoadComplete() {
 }
 
 void SafeBrowsingDatabaseManager::AddDatabaseChunks(
-    const std::string& list_name, SBChunkList* chunks,
+    const std::string& list_name, std::string* chunk_data,
     AddChunksCallback callback) {
   DCHECK_EQ(base::MessageLoop::current(),
             safe_browsing_thread_->message_loop());
-  if (chunks) {
-    GetDatabase()->InsertChunks(list_name, *chunks);
-    delete chunks;
+  if (chunk_data) {
+    GetDatabase()->InsertChunkData(list_name, *chunk_data);
+    delete chunk_data;
   }
   BrowserThread::PostTask(
       BrowserThread::IO, FROM_HERE,
@@ -859,6 +945,7 @@ void SafeBrowsingDatabaseManager::DatabaseUpdateFinished(
   DCHECK_EQ(base::MessageLoop::current(),
             safe_browsing_thread_->message_loop());
   GetDatabase()->UpdateFinished(update_succeeded);
+  SafeBrowsingUpdateProfiler::GetInstance()->FinishCycle(update_succeeded);
   DCHECK(database_update_in_progress_);
   database_update_in_progress_ = false;
   BrowserThread::PostTask(
@@ -931,15 +1018,26 @@ bool SafeBrowsingDatabaseManager::HandleOneCheck(
   DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
   DCHECK(check);
 
+  // A batch which fetched the full hashes of some of its prefixes is
+  // checked against those cached for the others, too.
+  std::vector<SBFullHashResult> all_hashes;
+  const std::vector<SBFullHashResult>* url_hashes = &full_hashes;
+  if (check->need_get_hash && !check->full_hits.empty()) {
+    all_hashes = full_hashes;
+    all_hashes.insert(all_hashes.end(), check->full_hits.begin(),
+                      check->full_hits.end());
+    url_hashes = &all_hashes;
+  }
+
   bool is_threat = false;
 
   for (size_t i = 0; i < check->urls.size(); ++i) {
     int index =
-        safe_browsing_util::GetUrlHashIndex(check->urls[i], full_hashes);
+        safe_browsing_util::GetUrlHashIndex(check->urls[i], *url_hashes);
     if (index == -1)
       continue;
     SBThreatType threat =
-        GetThreatTypeFromListname(full_hashes[index].list_name);
+        GetThreatTypeFromListname((*url_hashes)[index].list_name);
     if (threat != SB_THREAT_TYPE_SAFE &&
         IsExpectedThreat(threat, check->expected_threats)) {
       check->url_results[i] = threat;
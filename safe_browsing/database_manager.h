@@ -72,6 +72,9 @@ class SafeBrowsingDatabaseManager
 
     Client* client;
     bool need_get_hash;
+    // Set for checks from CheckBrowseUrls(), whose results are passed to
+    // OnCheckBrowseUrlsResult().
+    bool is_url_batch;
     base::TimeTicks start;  // When check was sent to SB service.
     safe_browsing_util::ListType check_type;  // See comment in constructor.
     std::vector<SBThreatType> expected_threats;
@@ -102,6 +105,12 @@ class SafeBrowsingDatabaseManager
     virtual void OnCheckBrowseUrlResult(const GURL& url,
                                         SBThreatType threat_type) {}
 
+    // Called when the results of checking a batch of browse URLs are known.
+    // |threat_types| is parallel to |urls|.
+    virtual void OnCheckBrowseUrlsResult(
+        const std::vector<GURL>& urls,
+        const std::vector<SBThreatType>& threat_types) {}
+
     // Called when the result of checking a download URL is known.
     virtual void OnCheckDownloadUrlResult(const std::vector<GURL>& url_chain,
                                           SBThreatType threat_type) {}
@@ -133,6 +142,14 @@ class SafeBrowsingDatabaseManager
   // result when it is ready.
   virtual bool CheckBrowseUrl(const GURL& url, Client* client);
 
+  // Like CheckBrowseUrl(), for all of |urls| at once, such as the URLs of a
+  // redirect chain.  The URLs are looked up in one pass over the database,
+  // and the full hashes of all their prefix hits which are not cached are
+  // fetched with a single GetHash request.  Returns true if all of |urls|
+  // are known to be safe.  Otherwise "client" is called asynchronously with
+  // the results of all of them.
+  virtual bool CheckBrowseUrls(const std::vector<GURL>& urls, Client* client);
+
   // Check if the prefix for |url| is in safebrowsing download add lists.
   // Result will be passed to callback in |client|.
   virtual bool CheckDownloadUrl(const std::vector<GURL>& url_chain,
@@ -228,13 +245,15 @@ class SafeBrowsingDatabaseManager
   struct QueuedCheck {
     QueuedCheck(const safe_browsing_util::ListType check_type,
                 Client* client,
-                const GURL& url,
+                const std::vector<GURL>& urls,
+                bool is_url_batch,
                 const std::vector<SBThreatType>& expected_threats,
                 const base::TimeTicks& start);
     ~QueuedCheck();
     safe_browsing_util::ListType check_type;
     Client* client;
-    GURL url;
+    std::vector<GURL> urls;  // One URL, unless |is_url_batch|.
+    bool is_url_batch;
     std::vector<SBThreatType> expected_threats;
     base::TimeTicks start;  // When check was queued.
   };
@@ -287,7 +306,7 @@ class SafeBrowsingDatabaseManager
 
   // Called on the database thread to add/remove chunks and host keys.
   // Callee will free the data when it's done.
-  void AddDatabaseChunks(const std::string& list, SBChunkList* chunks,
+  void AddDatabaseChunks(const std::string& list, std::string* chunk_data,
                          AddChunksCallback callback);
 
   void DeleteDatabaseChunks(std::vector<SBChunkDelete>* chunk_deletes);
@@ -352,7 +371,7 @@ class SafeBrowsingDatabaseManager
   virtual void UpdateStarted() OVERRIDE;
   virtual void UpdateFinished(bool success) OVERRIDE;
   virtual void GetChunks(GetChunksCallback callback) OVERRIDE;
-  virtual void AddChunks(const std::string& list, SBChunkList* chunks,
+  virtual void AddChunks(const std::string& list, std::string* chunk_data,
                          AddChunksCallback callback) OVERRIDE;
   virtual void DeleteChunks(
       std::vector<SBChunkDelete>* delete_chunks) OVERRIDE;
@@ -285,6 +285,8 @@ class DownloadProtectionService::CheckClientDownloadRequest
         url_chain_(item->GetUrlChain()),
         referrer_url_(item->GetReferrerUrl()),
         zipped_executable_(false),
+        url_whitelist_checked_(false),
+        url_whitelist_reason_(REASON_MAX),
         callback_(callback),
         service_(service),
         signature_util_(signature_util),
@@ -335,6 +337,13 @@ class DownloadProtectionService::CheckClientDownloadRequest
     } else {
       DCHECK(!download_protection_util::IsArchiveFile(
           item_->GetTargetFilePath()));
+      // Binaries always need the URL whitelist checks, so run them on the IO
+      // thread while the signature is checked.  They finish first, since
+      // CheckWhitelists() is posted after them.
+      BrowserThread::PostTask(
+          BrowserThread::IO,
+          FROM_HERE,
+          base::Bind(&CheckClientDownloadRequest::CheckUrlWhitelists, this));
       StartExtractSignatureFeatures();
     }
   }
@@ -564,32 +573,41 @@ class DownloadProtectionService::CheckClientDownloadRequest
     OnFileFeatureExtractionDone();
   }
 
-  void CheckWhitelists() {
+  // Checks the URL chain and the referrer against the download whitelist.
+  void CheckUrlWhitelists() {
     DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
-    DownloadCheckResultReason reason = REASON_MAX;
+    DCHECK(!url_whitelist_checked_);
+    url_whitelist_checked_ = true;
     if (!database_manager_.get()) {
-      reason = REASON_SB_DISABLED;
-    } else {
-      for (size_t i = 0; i < url_chain_.size(); ++i) {
-        const GURL& url = url_chain_[i];
-        if (url.is_valid() &&
-            database_manager_->MatchDownloadWhitelistUrl(url)) {
-          VLOG(2) << url << " is on the download whitelist.";
-          reason = REASON_WHITELISTED_URL;
-          break;
-        }
-      }
-      if (referrer_url_.is_valid() && reason == REASON_MAX &&
-          database_manager_->MatchDownloadWhitelistUrl(
-              referrer_url_)) {
-        VLOG(2) << "Referrer url " << referrer_url_
-                << " is on the download whitelist.";
-        reason = REASON_WHITELISTED_REFERRER;
-      }
-      if (reason != REASON_MAX || signature_info_.trusted()) {
-        UMA_HISTOGRAM_COUNTS("SBClientDownload.SignedOrWhitelistedDownload", 1);
+      url_whitelist_reason_ = REASON_SB_DISABLED;
+      return;
+    }
+    for (size_t i = 0; i < url_chain_.size(); ++i) {
+      const GURL& url = url_chain_[i];
+      if (url.is_valid() &&
+          database_manager_->MatchDownloadWhitelistUrl(url)) {
+        VLOG(2) << url << " is on the download whitelist.";
+        url_whitelist_reason_ = REASON_WHITELISTED_URL;
+        return;
       }
     }
+    if (referrer_url_.is_valid() &&
+        database_manager_->MatchDownloadWhitelistUrl(referrer_url_)) {
+      VLOG(2) << "Referrer url " << referrer_url_
+              << " is on the download whitelist.";
+      url_whitelist_reason_ = REASON_WHITELISTED_REFERRER;
+    }
+  }
+
+  void CheckWhitelists() {
+    DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
+    if (!url_whitelist_checked_)
+      CheckUrlWhitelists();
+    DownloadCheckResultReason reason = url_whitelist_reason_;
+    if (database_manager_.get() &&
+        (reason != REASON_MAX || signature_info_.trusted())) {
+      UMA_HISTOGRAM_COUNTS("SBClientDownload.SignedOrWhitelistedDownload", 1);
+    }
     if (reason == REASON_MAX && signature_info_.trusted()) {
       for (int i = 0; i < signature_info_.certificate_chain_size(); ++i) {
         if (CertificateChainIsWhitelisted(
@@ -698,6 +716,8 @@ class DownloadProtectionService::CheckClientDownloadRequest
       UMA_HISTOGRAM_ENUMERATION("SBClientDownload.CheckDownloadStats",
                                 reason,
                                 REASON_MAX);
+      UMA_HISTOGRAM_TIMES("SBClientDownload.DownloadCheckVerdictTime",
+                          base::TimeTicks::Now() - start_time_);
       callback_.Run(result);
       item_->RemoveObserver(this);
       item_ = NULL;
@@ -760,6 +780,10 @@ class DownloadProtectionService::CheckClientDownloadRequest
   GURL referrer_url_;
 
   bool zipped_executable_;
+  // Set by CheckUrlWhitelists() on the IO thread.  The reason is REASON_MAX
+  // unless the URLs are whitelisted or SafeBrowsing is disabled.
+  bool url_whitelist_checked_;
+  DownloadCheckResultReason url_whitelist_reason_;
   ClientDownloadRequest_SignatureInfo signature_info_;
   CheckDownloadCallback callback_;
   // Will be NULL if the request has been canceled.
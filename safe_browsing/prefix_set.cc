@@ -8,6 +8,7 @@
 #include <math.h>
 
 #include "base/file_util.h"
+#include "base/files/memory_mapped_file.h"
 #include "base/logging.h"
 #include "base/md5.h"
 #include "base/metrics/histogram.h"
@@ -19,8 +20,12 @@ namespace {
 // md5 -qs chrome/browser/safe_browsing/prefix_set.cc | colrm 9
 static uint32 kMagic = 0x864088dd;
 
+// Version 1 stored the index as |std::pair<SBPrefix,size_t>|, so its
+// files depend on the size of |size_t|.  It is still read.
+static uint32 kVersion1 = 0x1;
+
 // Current version the code writes out.
-static uint32 kVersion = 0x1;
+static uint32 kVersion = 0x2;
 
 typedef struct {
   uint32 magic;
@@ -29,10 +34,57 @@ typedef struct {
   uint32 deltas_size;
 } FileHeader;
 
-// For |std::upper_bound()| to find a prefix w/in a vector of pairs.
-bool PrefixLess(const std::pair<SBPrefix,size_t>& a,
-                const std::pair<SBPrefix,size_t>& b) {
-  return a.first < b.first;
+// The layout of |std::pair<SBPrefix,size_t>|, as written by version 1.
+typedef struct {
+  SBPrefix prefix;
+  size_t offset;
+} IndexPairV1;
+
+// The sections of the version 2 format start on this boundary, so
+// that every index block of a mapped file is one cache line.
+const size_t kSectionAlignment = 64;
+
+// The header padded to |kSectionAlignment|.
+const size_t kHeaderBytes = kSectionAlignment;
+
+// Fills the index blocks past the last entry.  Only |Exists()| looks
+// at the padding, and it clamps to the real entries.
+const SBPrefix kPaddingPrefix = kint32max;
+
+// Number of entries of the padded index sections.
+size_t PaddedIndexSize(size_t index_size, size_t block_size) {
+  return (index_size + block_size - 1) / block_size * block_size;
+}
+
+// Sanity-check the index read from disk, so that a bad file can't make
+// the lookups run off the deltas.
+bool IndexIsValid(const SBPrefix* index_prefixes,
+                  const uint32* index_offsets,
+                  size_t index_size,
+                  size_t deltas_size) {
+  if (!index_size)
+    return deltas_size == 0;
+  if (index_offsets[0] != 0)
+    return false;
+  for (size_t ii = 1; ii < index_size; ++ii) {
+    if (index_prefixes[ii] <= index_prefixes[ii - 1] ||
+        index_offsets[ii] < index_offsets[ii - 1]) {
+      return false;
+    }
+  }
+  return index_offsets[index_size - 1] <= deltas_size;
+}
+
+// Write |bytes| from |data| to |file|, adding them to |context|.
+bool WriteAndDigest(FILE* file, const void* data, size_t bytes,
+                    base::MD5Context* context) {
+  if (!bytes)
+    return true;
+  if (fwrite(data, 1, bytes, file) != bytes)
+    return false;
+  base::MD5Update(context,
+                  base::StringPiece(static_cast<const char*>(data), bytes));
+  return true;
 }
 
 }  // namespace
@@ -42,16 +94,18 @@ namespace safe_browsing {
 PrefixSet::PrefixSet(const std::vector<SBPrefix>& sorted_prefixes) {
   if (sorted_prefixes.size()) {
     // Estimate the resulting vector sizes.  There will be strictly
-    // more than |min_runs| entries in |index_|, but there generally
-    // aren't many forced breaks.
+    // more than |min_runs| index entries, but there generally aren't
+    // many forced breaks.
     const size_t min_runs = sorted_prefixes.size() / kMaxRun;
-    index_.reserve(min_runs);
-    deltas_.reserve(sorted_prefixes.size() - min_runs);
+    index_prefixes_vector_.reserve(min_runs);
+    index_offsets_vector_.reserve(min_runs);
+    deltas_vector_.reserve(sorted_prefixes.size() - min_runs);
 
     // Lead with the first prefix.
     SBPrefix prev_prefix = sorted_prefixes[0];
     size_t run_length = 0;
-    index_.push_back(std::make_pair(prev_prefix, deltas_.size()));
+    index_prefixes_vector_.push_back(prev_prefix);
+    index_offsets_vector_.push_back(0);
 
     for (size_t i = 1; i < sorted_prefixes.size(); ++i) {
       // Skip duplicates.
@@ -67,23 +121,29 @@ PrefixSet::PrefixSet(const std::vector<SBPrefix>& sorted_prefixes) {
       // New index ref if the delta doesn't fit, or if too many
       // consecutive deltas have been encoded.
       if (delta != static_cast<unsigned>(delta16) || run_length >= kMaxRun) {
-        index_.push_back(std::make_pair(sorted_prefixes[i], deltas_.size()));
+        index_prefixes_vector_.push_back(sorted_prefixes[i]);
+        index_offsets_vector_.push_back(
+            static_cast<uint32>(deltas_vector_.size()));
         run_length = 0;
       } else {
         // Continue the run of deltas.
-        deltas_.push_back(delta16);
-        DCHECK_EQ(static_cast<unsigned>(deltas_.back()), delta);
+        deltas_vector_.push_back(delta16);
+        DCHECK_EQ(static_cast<unsigned>(deltas_vector_.back()), delta);
         ++run_length;
       }
 
       prev_prefix = sorted_prefixes[i];
     }
+  }
+  UseVectors();
 
+  if (index_size_) {
     // Send up some memory-usage stats.  Bits because fractional bytes
     // are weird.
-    const size_t bits_used = index_.size() * sizeof(index_[0]) * CHAR_BIT +
-        deltas_.size() * sizeof(deltas_[0]) * CHAR_BIT;
-    const size_t unique_prefixes = index_.size() + deltas_.size();
+    const size_t bits_used =
+        index_size_ * (sizeof(SBPrefix) + sizeof(uint32)) * CHAR_BIT +
+        deltas_size_ * sizeof(uint16) * CHAR_BIT;
+    const size_t unique_prefixes = index_size_ + deltas_size_;
     static const size_t kMaxBitsPerPrefix = sizeof(SBPrefix) * CHAR_BIT;
     UMA_HISTOGRAM_ENUMERATION("SB2.PrefixSetBitsPerPrefix",
                               bits_used / unique_prefixes,
@@ -91,42 +151,90 @@ PrefixSet::PrefixSet(const std::vector<SBPrefix>& sorted_prefixes) {
   }
 }
 
-PrefixSet::PrefixSet(std::vector<std::pair<SBPrefix,size_t> > *index,
-                     std::vector<uint16> *deltas) {
-  DCHECK(index && deltas);
-  index_.swap(*index);
-  deltas_.swap(*deltas);
+PrefixSet::PrefixSet(std::vector<SBPrefix>* index_prefixes,
+                     std::vector<uint32>* index_offsets,
+                     std::vector<uint16>* deltas) {
+  DCHECK(index_prefixes && index_offsets && deltas);
+  index_prefixes_vector_.swap(*index_prefixes);
+  index_offsets_vector_.swap(*index_offsets);
+  deltas_vector_.swap(*deltas);
+  UseVectors();
+}
+
+PrefixSet::PrefixSet(scoped_ptr<base::MemoryMappedFile> file,
+                     const SBPrefix* index_prefixes,
+                     const uint32* index_offsets,
+                     size_t index_size,
+                     const uint16* deltas,
+                     size_t deltas_size)
+    : file_(file.Pass()),
+      index_prefixes_(index_prefixes),
+      index_offsets_(index_offsets),
+      index_size_(index_size),
+      deltas_(deltas),
+      deltas_size_(deltas_size) {
+  BuildBlockPrefixes();
 }
 
 PrefixSet::~PrefixSet() {}
 
+void PrefixSet::UseVectors() {
+  DCHECK_EQ(index_prefixes_vector_.size(), index_offsets_vector_.size());
+  index_size_ = index_prefixes_vector_.size();
+  deltas_size_ = deltas_vector_.size();
+
+  const size_t padded_size = PaddedIndexSize(index_size_, kIndexBlockSize);
+  index_prefixes_vector_.resize(padded_size, kPaddingPrefix);
+  index_offsets_vector_.resize(padded_size, 0);
+
+  index_prefixes_ = index_size_ ? &index_prefixes_vector_[0] : NULL;
+  index_offsets_ = index_size_ ? &index_offsets_vector_[0] : NULL;
+  deltas_ = deltas_size_ ? &deltas_vector_[0] : NULL;
+  BuildBlockPrefixes();
+}
+
+void PrefixSet::BuildBlockPrefixes() {
+  block_prefixes_.clear();
+  block_prefixes_.reserve(PaddedIndexSize(index_size_, kIndexBlockSize) /
+                          kIndexBlockSize);
+  for (size_t ii = 0; ii < index_size_; ii += kIndexBlockSize)
+    block_prefixes_.push_back(index_prefixes_[ii]);
+}
+
 bool PrefixSet::Exists(SBPrefix prefix) const {
-  if (index_.empty())
+  if (!index_size_)
     return false;
 
-  // Find the first position after |prefix| in |index_|.
-  std::vector<std::pair<SBPrefix,size_t> >::const_iterator
-      iter = std::upper_bound(index_.begin(), index_.end(),
-                              std::pair<SBPrefix,size_t>(prefix, 0),
-                              PrefixLess);
+  // Find the first block after |prefix|.
+  std::vector<SBPrefix>::const_iterator block_iter =
+      std::upper_bound(block_prefixes_.begin(), block_prefixes_.end(), prefix);
 
   // |prefix| comes before anything that's in the set.
-  if (iter == index_.begin())
+  if (block_iter == block_prefixes_.begin())
     return false;
 
-  // Capture the upper bound of our target entry's deltas.
-  const size_t bound = (iter == index_.end() ? deltas_.size() : iter->second);
-
-  // Back up to the entry our target is in.
-  --iter;
-
-  // All prefixes in |index_| are in the set.
-  SBPrefix current = iter->first;
+  // Count the entries of the preceding block which are not after
+  // |prefix|.  Comparing the whole cache line is cheaper than more
+  // steps of binary search, which would mispredict half the time.
+  const size_t block_start =
+      (block_iter - block_prefixes_.begin() - 1) * kIndexBlockSize;
+  const SBPrefix* block = index_prefixes_ + block_start;
+  size_t count = 0;
+  for (size_t i = 0; i < kIndexBlockSize; ++i)
+    count += block[i] <= prefix ? 1 : 0;
+
+  // The entry our target is in.  The padding of the last block counts
+  // for the largest prefix, so clamp to the real entries.
+  const size_t ii = std::min(block_start + count, index_size_) - 1;
+
+  // All prefixes in the index are in the set.
+  SBPrefix current = index_prefixes_[ii];
   if (current == prefix)
     return true;
 
   // Scan forward accumulating deltas while a match is possible.
-  for (size_t di = iter->second; di < bound && current < prefix; ++di) {
+  const size_t bound = DeltasEnd(ii);
+  for (size_t di = index_offsets_[ii]; di < bound && current < prefix; ++di) {
     current += deltas_[di];
   }
 
@@ -134,17 +242,16 @@ bool PrefixSet::Exists(SBPrefix prefix) const {
 }
 
 void PrefixSet::GetPrefixes(std::vector<SBPrefix>* prefixes) const {
-  prefixes->reserve(index_.size() + deltas_.size());
+  prefixes->reserve(index_size_ + deltas_size_);
 
-  for (size_t ii = 0; ii < index_.size(); ++ii) {
-    // The deltas for this |index_| entry run to the next index entry,
-    // or the end of the deltas.
-    const size_t deltas_end =
-        (ii + 1 < index_.size()) ? index_[ii + 1].second : deltas_.size();
+  for (size_t ii = 0; ii < index_size_; ++ii) {
+    // The deltas for this index entry run to the next index entry, or
+    // the end of the deltas.
+    const size_t deltas_end = DeltasEnd(ii);
 
-    SBPrefix current = index_[ii].first;
+    SBPrefix current = index_prefixes_[ii];
     prefixes->push_back(current);
-    for (size_t di = index_[ii].second; di < deltas_end; ++di) {
+    for (size_t di = index_offsets_[ii]; di < deltas_end; ++di) {
       current += deltas_[di];
       prefixes->push_back(current);
     }
@@ -153,92 +260,107 @@ void PrefixSet::GetPrefixes(std::vector<SBPrefix>* prefixes) const {
 
 // static
 PrefixSet* PrefixSet::LoadFile(const base::FilePath& filter_name) {
-  int64 size_64;
-  if (!file_util::GetFileSize(filter_name, &size_64))
-    return NULL;
-  using base::MD5Digest;
-  if (size_64 < static_cast<int64>(sizeof(FileHeader) + sizeof(MD5Digest)))
+  scoped_ptr<base::MemoryMappedFile> file(new base::MemoryMappedFile);
+  if (!file->Initialize(filter_name))
     return NULL;
 
-  file_util::ScopedFILE file(file_util::OpenFile(filter_name, "rb"));
-  if (!file.get())
+  using base::MD5Digest;
+  const char* data = reinterpret_cast<const char*>(file->data());
+  const size_t size = file->length();
+  if (size < sizeof(FileHeader) + sizeof(MD5Digest))
     return NULL;
 
   FileHeader header;
-  size_t read = fread(&header, sizeof(header), 1, file.get());
-  if (read != 1)
+  memcpy(&header, data, sizeof(header));
+  if (header.magic != kMagic)
     return NULL;
 
-  if (header.magic != kMagic || header.version != kVersion)
+  // Every entry takes more than a byte, which keeps bogus sizes from
+  // overflowing the computations below.
+  if (header.index_size > size || header.deltas_size > size)
     return NULL;
 
-  std::vector<std::pair<SBPrefix,size_t> > index;
-  const size_t index_bytes = sizeof(index[0]) * header.index_size;
-
-  std::vector<uint16> deltas;
-  const size_t deltas_bytes = sizeof(deltas[0]) * header.deltas_size;
+  // Work out where the sections are.
+  const uint64 deltas_bytes =
+      sizeof(uint16) * static_cast<uint64>(header.deltas_size);
+  uint64 index_bytes;
+  uint64 deltas_start;
+  if (header.version == kVersion1) {
+    index_bytes = sizeof(IndexPairV1) * static_cast<uint64>(header.index_size);
+    deltas_start = sizeof(header) + index_bytes;
+  } else if (header.version == kVersion) {
+    // The size of each of the two index sections.
+    index_bytes = sizeof(SBPrefix) * static_cast<uint64>(
+        PaddedIndexSize(header.index_size, kIndexBlockSize));
+    deltas_start = kHeaderBytes + 2 * index_bytes;
+  } else {
+    return NULL;
+  }
 
-  // Check for bogus sizes before allocating any space.
-  const size_t expected_bytes =
-      sizeof(header) + index_bytes + deltas_bytes + sizeof(MD5Digest);
-  if (static_cast<int64>(expected_bytes) != size_64)
+  // Check for bogus sizes before looking at any of the data.
+  if (deltas_start + deltas_bytes + sizeof(MD5Digest) != size)
     return NULL;
 
-  // The file looks valid, start building the digest.
-  base::MD5Context context;
-  base::MD5Init(&context);
-  base::MD5Update(&context, base::StringPiece(reinterpret_cast<char*>(&header),
-                                              sizeof(header)));
-
-  // Read the index vector.  Herb Sutter indicates that vectors are
-  // guaranteed to be contiuguous, so reading to where element 0 lives
-  // is valid.
-  if (header.index_size) {
-    index.resize(header.index_size);
-    read = fread(&(index[0]), sizeof(index[0]), index.size(), file.get());
-    if (read != index.size())
-      return NULL;
-    base::MD5Update(&context,
-                    base::StringPiece(reinterpret_cast<char*>(&(index[0])),
-                                      index_bytes));
+  // The digest covers everything before it.
+  base::MD5Digest calculated_digest;
+  base::MD5Sum(data, size - sizeof(MD5Digest), &calculated_digest);
+  if (0 != memcmp(data + size - sizeof(MD5Digest), &calculated_digest,
+                  sizeof(calculated_digest))) {
+    return NULL;
   }
 
-  // Read vector of deltas.
-  if (header.deltas_size) {
-    deltas.resize(header.deltas_size);
-    read = fread(&(deltas[0]), sizeof(deltas[0]), deltas.size(), file.get());
-    if (read != deltas.size())
-      return NULL;
-    base::MD5Update(&context,
-                    base::StringPiece(reinterpret_cast<char*>(&(deltas[0])),
-                                      deltas_bytes));
-  }
+  if (header.version == kVersion1) {
+    // The index has the wrong layout, so this one is read into memory.
+    std::vector<SBPrefix> index_prefixes(header.index_size);
+    std::vector<uint32> index_offsets(header.index_size);
+    for (size_t ii = 0; ii < header.index_size; ++ii) {
+      IndexPairV1 pair;
+      memcpy(&pair, data + sizeof(header) + ii * sizeof(pair), sizeof(pair));
+      if (pair.offset > header.deltas_size)
+        return NULL;
+      index_prefixes[ii] = pair.prefix;
+      index_offsets[ii] = static_cast<uint32>(pair.offset);
+    }
+    std::vector<uint16> deltas(header.deltas_size);
+    if (header.deltas_size) {
+      memcpy(&deltas[0], data + deltas_start,
+             deltas.size() * sizeof(deltas[0]));
+    }
 
-  base::MD5Digest calculated_digest;
-  base::MD5Final(&calculated_digest, &context);
+    if (!IndexIsValid(header.index_size ? &index_prefixes[0] : NULL,
+                      header.index_size ? &index_offsets[0] : NULL,
+                      header.index_size, header.deltas_size)) {
+      return NULL;
+    }
 
-  base::MD5Digest file_digest;
-  read = fread(&file_digest, sizeof(file_digest), 1, file.get());
-  if (read != 1)
-    return NULL;
+    // Steals contents of the vectors via swap().
+    return new PrefixSet(&index_prefixes, &index_offsets, &deltas);
+  }
 
-  if (0 != memcmp(&file_digest, &calculated_digest, sizeof(file_digest)))
+  const SBPrefix* index_prefixes =
+      reinterpret_cast<const SBPrefix*>(data + kHeaderBytes);
+  const uint32* index_offsets =
+      reinterpret_cast<const uint32*>(data + kHeaderBytes + index_bytes);
+  const uint16* deltas = reinterpret_cast<const uint16*>(data + deltas_start);
+  if (!IndexIsValid(index_prefixes, index_offsets, header.index_size,
+                    header.deltas_size)) {
     return NULL;
+  }
 
-  // Steals contents of |index| and |deltas| via swap().
-  return new PrefixSet(&index, &deltas);
+  return new PrefixSet(file.Pass(), index_prefixes, index_offsets,
+                       header.index_size, deltas, header.deltas_size);
 }
 
 bool PrefixSet::WriteFile(const base::FilePath& filter_name) const {
   FileHeader header;
   header.magic = kMagic;
   header.version = kVersion;
-  header.index_size = static_cast<uint32>(index_.size());
-  header.deltas_size = static_cast<uint32>(deltas_.size());
+  header.index_size = static_cast<uint32>(index_size_);
+  header.deltas_size = static_cast<uint32>(deltas_size_);
 
   // Sanity check that the 32-bit values never mess things up.
-  if (static_cast<size_t>(header.index_size) != index_.size() ||
-      static_cast<size_t>(header.deltas_size) != deltas_.size()) {
+  if (static_cast<size_t>(header.index_size) != index_size_ ||
+      static_cast<size_t>(header.deltas_size) != deltas_size_) {
     NOTREACHED();
     return false;
   }
@@ -252,41 +374,28 @@ bool PrefixSet::WriteFile(const base::FilePath& filter_name) const {
 
   // TODO(shess): The I/O code in safe_browsing_store_file.cc would
   // sure be useful about now.
-  size_t written = fwrite(&header, sizeof(header), 1, file.get());
-  if (written != 1)
+  char padded_header[kHeaderBytes] = { 0 };
+  memcpy(padded_header, &header, sizeof(header));
+  if (!WriteAndDigest(file.get(), padded_header, sizeof(padded_header),
+                      &context)) {
     return false;
-  base::MD5Update(&context, base::StringPiece(reinterpret_cast<char*>(&header),
-                                              sizeof(header)));
-
-  // As for reads, the standard guarantees the ability to access the
-  // contents of the vector by a pointer to an element.
-  if (index_.size()) {
-    const size_t index_bytes = sizeof(index_[0]) * index_.size();
-    written = fwrite(&(index_[0]), sizeof(index_[0]), index_.size(),
-                     file.get());
-    if (written != index_.size())
-      return false;
-    base::MD5Update(&context,
-                    base::StringPiece(
-                        reinterpret_cast<const char*>(&(index_[0])),
-                        index_bytes));
   }
 
-  if (deltas_.size()) {
-    const size_t deltas_bytes = sizeof(deltas_[0]) * deltas_.size();
-    written = fwrite(&(deltas_[0]), sizeof(deltas_[0]), deltas_.size(),
-                     file.get());
-    if (written != deltas_.size())
-      return false;
-    base::MD5Update(&context,
-                    base::StringPiece(
-                        reinterpret_cast<const char*>(&(deltas_[0])),
-                        deltas_bytes));
+  // Whether in memory or mapped, the index arrays are already padded
+  // to whole blocks.
+  const size_t padded_size = PaddedIndexSize(index_size_, kIndexBlockSize);
+  if (!WriteAndDigest(file.get(), index_prefixes_,
+                      padded_size * sizeof(SBPrefix), &context) ||
+      !WriteAndDigest(file.get(), index_offsets_,
+                      padded_size * sizeof(uint32), &context) ||
+      !WriteAndDigest(file.get(), deltas_, deltas_size_ * sizeof(uint16),
+                      &context)) {
+    return false;
   }
 
   base::MD5Digest digest;
   base::MD5Final(&digest, &context);
-  written = fwrite(&digest, sizeof(digest), 1, file.get());
+  size_t written = fwrite(&digest, sizeof(digest), 1, file.get());
   if (written != 1)
     return false;
 
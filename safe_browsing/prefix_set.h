@@ -9,11 +9,11 @@
 //
 // For example, the sequence {20, 25, 41, 65432, 150000, 160000} would
 // be stored as:
-//  A pair {20, 0} in |index_|.
+//  20 in |index_prefixes_| and 0 in |index_offsets_|.
 //  5, 16, 65391 in |deltas_|.
-//  A pair {150000, 3} in |index_|.
+//  150000 in |index_prefixes_| and 3 in |index_offsets_|.
 //  10000 in |deltas_|.
-// |index_.size()| will be 2, |deltas_.size()| will be 4.
+// |index_size_| will be 2, |deltas_size_| will be 4.
 //
 // This structure is intended for storage of sparse uniform sets of
 // prefixes of a certain size.  As of this writing, my safe-browsing
@@ -37,24 +37,39 @@
 // 2^16 apart, which would need 512k (versus 256k to store the raw
 // data).
 //
-// The on-disk format looks like:
+// The index prefixes are kept apart from their offsets, in blocks of
+// |kIndexBlockSize| which each fill one cache line.  |Exists()|
+// binary-searches the first prefix of every block, which is a small
+// array that stays in cache, and then compares against the whole
+// block without branching.
+//
+// The on-disk format is laid out so that |LoadFile()| can use the
+// file in place through a read-only mapping.  Each section starts on
+// a 64-byte boundary:
 //         4 byte magic number
 //         4 byte version number
-//         4 byte |index_.size()|
-//         4 byte |deltas_.size()|
-//     n * 8 byte |&index_[0]..&index_[n]|
-//     m * 2 byte |&deltas_[0]..&deltas_[m]|
+//         4 byte |index_size_|
+//         4 byte |deltas_size_|
+//        48 byte padding
+//     n * 4 byte |index_prefixes_[0]..index_prefixes_[n]|
+//     n * 4 byte |index_offsets_[0]..index_offsets_[n]|
+//     m * 2 byte |deltas_[0]..deltas_[m]|
 //        16 byte digest
+// The index sections are padded to a multiple of |kIndexBlockSize|
+// entries.  Version 1 files, which stored the index as pairs of
+// prefix and |size_t|, are still read into memory.
 
 #ifndef CHROME_BROWSER_SAFE_BROWSING_PREFIX_SET_H_
 #define CHROME_BROWSER_SAFE_BROWSING_PREFIX_SET_H_
 
 #include <vector>
 
+#include "base/memory/scoped_ptr.h"
 #include "chrome/browser/safe_browsing/safe_browsing_util.h"
 
 namespace base {
 class FilePath;
+class MemoryMappedFile;
 }
 
 namespace safe_browsing {
@@ -67,7 +82,9 @@ class PrefixSet {
   // |true| if |prefix| was in |prefixes| passed to the constructor.
   bool Exists(SBPrefix prefix) const;
 
-  // Persist the set on disk.
+  // Persist the set on disk.  A set returned by |LoadFile()| reads
+  // the file in place, so the file must not be modified while the set
+  // exists.
   static PrefixSet* LoadFile(const base::FilePath& filter_name);
   bool WriteFile(const base::FilePath& filter_name) const;
 
@@ -81,21 +98,60 @@ class PrefixSet {
   // for |Exists()| under control.
   static const size_t kMaxRun = 100;
 
-  // Helper for |LoadFile()|.  Steals the contents of |index| and
-  // |deltas| using |swap()|.
-  PrefixSet(std::vector<std::pair<SBPrefix,size_t> > *index,
-            std::vector<uint16> *deltas);
-
-  // Top-level index of prefix to offset in |deltas_|.  Each pair
-  // indicates a base prefix and where the deltas from that prefix
-  // begin in |deltas_|.  The deltas for a pair end at the next pair's
-  // index into |deltas_|.
-  std::vector<std::pair<SBPrefix,size_t> > index_;
-
-  // Deltas which are added to the prefix in |index_| to generate
-  // prefixes.  Deltas are only valid between consecutive items from
-  // |index_|, or the end of |deltas_| for the last |index_| pair.
-  std::vector<uint16> deltas_;
+  // Number of |index_prefixes_| which fit in a 64-byte cache line.
+  static const size_t kIndexBlockSize = 16;
+
+  // Helper for |LoadFile()| for version 1 files.  Steals the contents
+  // of |index_prefixes|, |index_offsets| and |deltas| using |swap()|.
+  PrefixSet(std::vector<SBPrefix>* index_prefixes,
+            std::vector<uint32>* index_offsets,
+            std::vector<uint16>* deltas);
+
+  // Helper for |LoadFile()|.  The arrays point into |file|.
+  PrefixSet(scoped_ptr<base::MemoryMappedFile> file,
+            const SBPrefix* index_prefixes,
+            const uint32* index_offsets,
+            size_t index_size,
+            const uint16* deltas,
+            size_t deltas_size);
+
+  // Pads the index vectors to whole blocks and points the arrays at
+  // the vectors.
+  void UseVectors();
+
+  // Fills in |block_prefixes_| from |index_prefixes_|.
+  void BuildBlockPrefixes();
+
+  // Returns the end of the deltas of index entry |ii|, which is the
+  // start of the next entry's deltas.
+  size_t DeltasEnd(size_t ii) const {
+    return ii + 1 < index_size_ ? index_offsets_[ii + 1] : deltas_size_;
+  }
+
+  // The mapped file when the set was loaded by |LoadFile()|, in which
+  // case the vectors below are empty.
+  scoped_ptr<base::MemoryMappedFile> file_;
+  std::vector<SBPrefix> index_prefixes_vector_;
+  std::vector<uint32> index_offsets_vector_;
+  std::vector<uint16> deltas_vector_;
+
+  // Top-level index of prefix to offset in |deltas_|.  Each entry
+  // holds a base prefix and where the deltas from that prefix begin in
+  // |deltas_|.  The deltas for an entry end at the next entry's offset
+  // into |deltas_|.  Both arrays hold |index_size_| entries, padded to
+  // a multiple of |kIndexBlockSize|.
+  const SBPrefix* index_prefixes_;
+  const uint32* index_offsets_;
+  size_t index_size_;
+
+  // Deltas which are added to the prefix in |index_prefixes_| to
+  // generate prefixes.  Deltas are only valid between consecutive
+  // index entries, or the end of |deltas_| for the last entry.
+  const uint16* deltas_;
+  size_t deltas_size_;
+
+  // The first prefix of each block of |index_prefixes_|.
+  std::vector<SBPrefix> block_prefixes_;
 
   DISALLOW_COPY_AND_ASSIGN(PrefixSet);
 };
@@ -0,0 +1,218 @@
+// Copyright 2013 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Benchmarks |PrefixSet| against the layout it had before the index was
+// split into cache-line blocks and mapped from disk, on a set the size
+// of the real browse list.  Results are printed in the perf_test RESULT
+// format so that they can be tracked by the perf bots.
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "base/file_util.h"
+#include "base/files/file_path.h"
+#include "base/files/scoped_temp_dir.h"
+#include "base/md5.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/rand_util.h"
+#include "base/time/time.h"
+#include "chrome/browser/safe_browsing/prefix_set.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_test.h"
+
+using base::TimeDelta;
+using base::TimeTicks;
+
+namespace {
+
+// The number of add prefixes in the browse list, see prefix_set.h.
+const size_t kNumPrefixes = 653132;
+
+// The number of |Exists()| calls timed per benchmark.
+const size_t kNumLookups = 2000000;
+
+// The old layout: one vector of (prefix, offset) pairs which is
+// binary-searched, read from a version 1 file into the heap.
+class ReferencePrefixSet {
+ public:
+  explicit ReferencePrefixSet(const std::vector<SBPrefix>& sorted_prefixes) {
+    SBPrefix prev_prefix = sorted_prefixes[0];
+    size_t run_length = 0;
+    index_.push_back(std::make_pair(prev_prefix, deltas_.size()));
+    for (size_t i = 1; i < sorted_prefixes.size(); ++i) {
+      if (sorted_prefixes[i] == prev_prefix)
+        continue;
+      const unsigned delta = sorted_prefixes[i] - prev_prefix;
+      const uint16 delta16 = static_cast<uint16>(delta);
+      if (delta != static_cast<unsigned>(delta16) || run_length >= 100) {
+        index_.push_back(std::make_pair(sorted_prefixes[i], deltas_.size()));
+        run_length = 0;
+      } else {
+        deltas_.push_back(delta16);
+        ++run_length;
+      }
+      prev_prefix = sorted_prefixes[i];
+    }
+  }
+
+  bool Exists(SBPrefix prefix) const {
+    std::vector<std::pair<SBPrefix,size_t> >::const_iterator
+        iter = std::upper_bound(index_.begin(), index_.end(),
+                                std::pair<SBPrefix,size_t>(prefix, 0),
+                                PrefixLess);
+    if (iter == index_.begin())
+      return false;
+    const size_t bound = (iter == index_.end() ? deltas_.size() : iter->second);
+    --iter;
+    SBPrefix current = iter->first;
+    if (current == prefix)
+      return true;
+    for (size_t di = iter->second; di < bound && current < prefix; ++di)
+      current += deltas_[di];
+    return current == prefix;
+  }
+
+  // Writes the version 1 file format, which |PrefixSet::LoadFile()|
+  // still reads into memory.
+  bool WriteFile(const base::FilePath& filter_name) const {
+    const uint32 header[] = {
+      0x864088dd, 1, static_cast<uint32>(index_.size()),
+      static_cast<uint32>(deltas_.size()),
+    };
+    std::string contents(reinterpret_cast<const char*>(header),
+                         sizeof(header));
+    contents.append(reinterpret_cast<const char*>(&index_[0]),
+                    index_.size() * sizeof(index_[0]));
+    contents.append(reinterpret_cast<const char*>(&deltas_[0]),
+                    deltas_.size() * sizeof(deltas_[0]));
+    base::MD5Digest digest;
+    base::MD5Sum(contents.data(), contents.size(), &digest);
+    contents.append(reinterpret_cast<const char*>(&digest), sizeof(digest));
+    return file_util::WriteFile(filter_name, contents.data(),
+                                contents.size()) ==
+        static_cast<int>(contents.size());
+  }
+
+ private:
+  static bool PrefixLess(const std::pair<SBPrefix,size_t>& a,
+                         const std::pair<SBPrefix,size_t>& b) {
+    return a.first < b.first;
+  }
+
+  std::vector<std::pair<SBPrefix,size_t> > index_;
+  std::vector<uint16> deltas_;
+
+  DISALLOW_COPY_AND_ASSIGN(ReferencePrefixSet);
+};
+
+void PrintTime(const std::string& measurement,
+               const std::string& trace,
+               TimeDelta time) {
+  perf_test::PrintResult(measurement, std::string(), trace,
+                         static_cast<size_t>(time.InMicroseconds()), "us",
+                         true);
+}
+
+// Times |kNumLookups| calls of |set.Exists()| over |queries|.
+template <class Set>
+void TimeLookups(const std::string& trace,
+                 const Set& set,
+                 const std::vector<SBPrefix>& queries,
+                 size_t* found) {
+  *found = 0;
+  const TimeTicks start = TimeTicks::Now();
+  for (size_t i = 0; i < kNumLookups; ++i) {
+    if (set.Exists(queries[i % queries.size()]))
+      ++*found;
+  }
+  PrintTime("PrefixSetExists", trace, TimeTicks::Now() - start);
+}
+
+}  // namespace
+
+class PrefixSetPerfTest : public testing::Test {
+ protected:
+  // Random prefixes are a close match to the real list, where almost
+  // every prefix is within 2^16 of the prior one.
+  static void SetUpTestCase() {
+    prefixes_ = new std::vector<SBPrefix>;
+    for (size_t i = 0; i < kNumPrefixes; ++i)
+      prefixes_->push_back(static_cast<SBPrefix>(base::RandUint64()));
+    std::sort(prefixes_->begin(), prefixes_->end());
+
+    // Most URL checks miss; have one in four hit.
+    queries_ = new std::vector<SBPrefix>;
+    for (size_t i = 0; i < kNumPrefixes; ++i) {
+      queries_->push_back(i % 4 ? static_cast<SBPrefix>(base::RandUint64()) :
+                          (*prefixes_)[base::RandGenerator(kNumPrefixes)]);
+    }
+  }
+
+  static void TearDownTestCase() {
+    delete prefixes_;
+    prefixes_ = NULL;
+    delete queries_;
+    queries_ = NULL;
+  }
+
+  virtual void SetUp() OVERRIDE {
+    ASSERT_TRUE(temp_dir_.CreateUniqueTempDir());
+  }
+
+  static std::vector<SBPrefix>* prefixes_;
+  static std::vector<SBPrefix>* queries_;
+  base::ScopedTempDir temp_dir_;
+};
+
+std::vector<SBPrefix>* PrefixSetPerfTest::prefixes_ = NULL;
+std::vector<SBPrefix>* PrefixSetPerfTest::queries_ = NULL;
+
+TEST_F(PrefixSetPerfTest, Exists) {
+  ReferencePrefixSet reference_set(*prefixes_);
+  size_t reference_found = 0;
+  TimeLookups("reference", reference_set, *queries_, &reference_found);
+
+  safe_browsing::PrefixSet prefix_set(*prefixes_);
+  size_t found = 0;
+  TimeLookups("blocked", prefix_set, *queries_, &found);
+  EXPECT_EQ(reference_found, found);
+
+  base::FilePath filename = temp_dir_.path().AppendASCII("PrefixSet");
+  ASSERT_TRUE(prefix_set.WriteFile(filename));
+  scoped_ptr<safe_browsing::PrefixSet>
+      mapped_set(safe_browsing::PrefixSet::LoadFile(filename));
+  ASSERT_TRUE(mapped_set.get());
+  TimeLookups("mapped", *mapped_set, *queries_, &found);
+  EXPECT_EQ(reference_found, found);
+}
+
+TEST_F(PrefixSetPerfTest, LoadFile) {
+  base::FilePath v1_filename = temp_dir_.path().AppendASCII("PrefixSetV1");
+  {
+    ReferencePrefixSet reference_set(*prefixes_);
+    ASSERT_TRUE(reference_set.WriteFile(v1_filename));
+  }
+  TimeTicks start = TimeTicks::Now();
+  scoped_ptr<safe_browsing::PrefixSet>
+      prefix_set(safe_browsing::PrefixSet::LoadFile(v1_filename));
+  PrintTime("PrefixSetLoad", "copied", TimeTicks::Now() - start);
+  ASSERT_TRUE(prefix_set.get());
+
+  base::FilePath filename = temp_dir_.path().AppendASCII("PrefixSet");
+  ASSERT_TRUE(prefix_set->WriteFile(filename));
+  prefix_set.reset();
+  start = TimeTicks::Now();
+  prefix_set.reset(safe_browsing::PrefixSet::LoadFile(filename));
+  PrintTime("PrefixSetLoad", "mapped", TimeTicks::Now() - start);
+  ASSERT_TRUE(prefix_set.get());
+
+  int64 size = 0;
+  ASSERT_TRUE(file_util::GetFileSize(filename, &size));
+  perf_test::PrintResult("PrefixSetFileSize", std::string(), "mapped",
+                         static_cast<size_t>(size), "bytes", false);
+  ASSERT_TRUE(file_util::GetFileSize(v1_filename, &size));
+  perf_test::PrintResult("PrefixSetFileSize", std::string(), "copied",
+                         static_cast<size_t>(size), "bytes", false);
+}
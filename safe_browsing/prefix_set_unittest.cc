@@ -6,6 +6,7 @@
 
 #include <algorithm>
 #include <iterator>
+#include <string>
 
 #include "base/file_util.h"
 #include "base/files/scoped_temp_dir.h"
@@ -20,7 +21,7 @@ namespace {
 
 class PrefixSetTest : public PlatformTest {
  protected:
-  // Constants for the v1 format.
+  // Offsets of the file header, which is the same in all versions.
   static const size_t kMagicOffset = 0 * sizeof(uint32);
   static const size_t kVersionOffset = 1 * sizeof(uint32);
   static const size_t kIndexSizeOffset = 2 * sizeof(uint32);
@@ -208,6 +209,29 @@ TEST_F(PrefixSetTest, IntMinMax) {
   ASSERT_EQ(prefixes_copy.size(), prefixes.size());
   EXPECT_TRUE(std::equal(prefixes.begin(), prefixes.end(),
                          prefixes_copy.begin()));
+
+  for (size_t i = 0; i < prefixes.size(); ++i) {
+    EXPECT_TRUE(prefix_set.Exists(prefixes[i]));
+  }
+}
+
+// The last block of the index is padded with the largest prefix,
+// which must not be found unless it is in the set.
+TEST_F(PrefixSetTest, IndexPadding) {
+  std::vector<SBPrefix> prefixes;
+  prefixes.push_back(-1000 * 1000 * 1000);
+  prefixes.push_back(1000 * 1000 * 1000);
+
+  safe_browsing::PrefixSet prefix_set(prefixes);
+  EXPECT_FALSE(prefix_set.Exists(0x7FFFFFFF));
+  EXPECT_FALSE(prefix_set.Exists(0x7FFFFFFE));
+  CheckPrefixes(prefix_set, prefixes);
+
+  prefixes.push_back(0x7FFFFFFF);
+  safe_browsing::PrefixSet prefix_set_with_max(prefixes);
+  EXPECT_TRUE(prefix_set_with_max.Exists(0x7FFFFFFF));
+  EXPECT_FALSE(prefix_set_with_max.Exists(0x7FFFFFFE));
+  CheckPrefixes(prefix_set_with_max, prefixes);
 }
 
 // A range with only large deltas.
@@ -350,6 +374,74 @@ TEST_F(PrefixSetTest, ReadWrite) {
   }
 }
 
+// A set loaded from a file reads it in place, and can be written to
+// another file.
+TEST_F(PrefixSetTest, WriteLoadedSet) {
+  base::FilePath filename;
+  ASSERT_TRUE(GetPrefixSetFile(&filename));
+  scoped_ptr<safe_browsing::PrefixSet>
+      prefix_set(safe_browsing::PrefixSet::LoadFile(filename));
+  ASSERT_TRUE(prefix_set.get());
+
+  base::FilePath copy_filename = filename.AddExtension("copy");
+  ASSERT_TRUE(prefix_set->WriteFile(copy_filename));
+  std::string contents, copy_contents;
+  ASSERT_TRUE(base::ReadFileToString(filename, &contents));
+  ASSERT_TRUE(base::ReadFileToString(copy_filename, &copy_contents));
+  EXPECT_EQ(contents, copy_contents);
+
+  prefix_set.reset(safe_browsing::PrefixSet::LoadFile(copy_filename));
+  ASSERT_TRUE(prefix_set.get());
+  CheckPrefixes(*prefix_set, shared_prefixes_);
+}
+
+// Files written before the index was split into blocks are still read.
+TEST_F(PrefixSetTest, ReadVersion1) {
+  ASSERT_TRUE(temp_dir_.CreateUniqueTempDir());
+  base::FilePath filename = temp_dir_.path().AppendASCII("PrefixSetTest");
+
+  // The example from prefix_set.h.
+  std::vector<SBPrefix> prefixes;
+  prefixes.push_back(20);
+  prefixes.push_back(25);
+  prefixes.push_back(41);
+  prefixes.push_back(65432);
+  prefixes.push_back(150000);
+  prefixes.push_back(160000);
+
+  const uint32 kHeader[] = { 0x864088dd, 1, 2, 4 };
+  const std::pair<SBPrefix,size_t> kIndex[] = {
+    std::make_pair(20, 0), std::make_pair(150000, 3),
+  };
+  const uint16 kDeltas[] = { 5, 16, 65391, 10000 };
+
+  std::string contents(reinterpret_cast<const char*>(kHeader),
+                       sizeof(kHeader));
+  contents.append(reinterpret_cast<const char*>(kIndex), sizeof(kIndex));
+  contents.append(reinterpret_cast<const char*>(kDeltas), sizeof(kDeltas));
+  base::MD5Digest digest;
+  base::MD5Sum(contents.data(), contents.size(), &digest);
+  contents.append(reinterpret_cast<const char*>(&digest), sizeof(digest));
+  ASSERT_EQ(static_cast<int>(contents.size()),
+            file_util::WriteFile(filename, contents.data(), contents.size()));
+
+  scoped_ptr<safe_browsing::PrefixSet>
+      prefix_set(safe_browsing::PrefixSet::LoadFile(filename));
+  ASSERT_TRUE(prefix_set.get());
+  CheckPrefixes(*prefix_set, prefixes);
+
+  // Saving it again writes the current version.
+  ASSERT_TRUE(prefix_set->WriteFile(filename));
+  prefix_set.reset(safe_browsing::PrefixSet::LoadFile(filename));
+  ASSERT_TRUE(prefix_set.get());
+  CheckPrefixes(*prefix_set, prefixes);
+  file_util::ScopedFILE file(file_util::OpenFile(filename, "rb"));
+  uint32 version = 0;
+  ASSERT_NE(-1, fseek(file.get(), kVersionOffset, SEEK_SET));
+  ASSERT_EQ(1U, fread(&version, sizeof(version), 1, file.get()));
+  EXPECT_EQ(2U, version);
+}
+
 // Check that |CleanChecksum()| makes an acceptable checksum.
 TEST_F(PrefixSetTest, CorruptionHelpers) {
   base::FilePath filename;
@@ -420,6 +512,30 @@ TEST_F(PrefixSetTest, CorruptionDeltasSize) {
   ASSERT_FALSE(prefix_set.get());
 }
 
+// Out of order |index_offsets_| are caught by the sanity check, even
+// with a valid digest.
+TEST_F(PrefixSetTest, CorruptionIndexOffsets) {
+  base::FilePath filename;
+  ASSERT_TRUE(GetPrefixSetFile(&filename));
+
+  file_util::ScopedFILE file(file_util::OpenFile(filename, "rb"));
+  uint32 index_size = 0;
+  ASSERT_NE(-1, fseek(file.get(), kIndexSizeOffset, SEEK_SET));
+  ASSERT_EQ(1U, fread(&index_size, sizeof(index_size), 1, file.get()));
+  file.reset();
+  ASSERT_GT(index_size, 2U);
+
+  // The offsets follow the 64-byte header and the prefixes, which are
+  // padded to 16 entries.
+  const long offsets_offset = 64 + (index_size + 15) / 16 * 16 * 4;
+  ASSERT_NO_FATAL_FAILURE(ModifyAndCleanChecksum(
+      filename, offsets_offset + static_cast<long>(sizeof(uint32)),
+      1000 * 1000));
+  scoped_ptr<safe_browsing::PrefixSet>
+      prefix_set(safe_browsing::PrefixSet::LoadFile(filename));
+  ASSERT_FALSE(prefix_set.get());
+}
+
 // Test that the digest catches corruption in the middle of the file
 // (in the payload between the header and the digest).
 TEST_F(PrefixSetTest, CorruptionPayload) {
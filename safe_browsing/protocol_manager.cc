@@ -16,6 +16,7 @@
 #include "base/strings/stringprintf.h"
 #include "base/timer/timer.h"
 #include "chrome/browser/safe_browsing/protocol_parser.h"
+#include "chrome/browser/safe_browsing/update_profiler.h"
 #include "chrome/common/chrome_version_info.h"
 #include "chrome/common/env_vars.h"
 #include "google_apis/google_api_keys.h"
@@ -413,15 +414,27 @@ bool SafeBrowsingProtocolManager::HandleServiceResponse(const GURL& url,
       break;
     }
     case CHUNK_REQUEST: {
-      UMA_HISTOGRAM_TIMES("SB2.ChunkRequest",
-                          base::Time::Now() - chunk_request_start_);
+      const base::TimeDelta download_time =
+          base::Time::Now() - chunk_request_start_;
+      UMA_HISTOGRAM_TIMES("SB2.ChunkRequest", download_time);
 
       const ChunkUrl chunk_url = chunk_request_urls_.front();
-      scoped_ptr<SBChunkList> chunks(new SBChunkList);
       UMA_HISTOGRAM_COUNTS("SB2.ChunkSize", length);
       update_size_ += length;
-      if (!parser.ParseChunk(chunk_url.list_name, data, length,
-                             chunks.get())) {
+      SafeBrowsingUpdateProfiler* profiler =
+          SafeBrowsingUpdateProfiler::GetInstance();
+      profiler->RecordPhase(SafeBrowsingUpdateProfiler::PHASE_DOWNLOAD,
+                            chunk_url.list_name, download_time, length);
+
+      // Only check the chunks here; the database parses them again as it
+      // writes them, rather than having every host copied into an SBEntry.
+      const base::TimeTicks parse_start = base::TimeTicks::Now();
+      const bool parsed =
+          parser.VisitChunks(chunk_url.list_name, data, length, NULL);
+      profiler->RecordPhase(SafeBrowsingUpdateProfiler::PHASE_PARSE,
+                            chunk_url.list_name,
+                            base::TimeTicks::Now() - parse_start, length);
+      if (!parsed) {
 #ifndef NDEBUG
         std::string data_str;
         data_str.assign(data, length);
@@ -434,11 +447,11 @@ bool SafeBrowsingProtocolManager::HandleServiceResponse(const GURL& url,
         return false;
       }
 
-      // Chunks to add to storage.  Pass ownership of |chunks|.
-      if (!chunks->empty()) {
+      // Chunks to add to storage.  Pass ownership of the copy of |data|.
+      if (length > 0) {
         chunk_pending_to_write_ = true;
         delegate_->AddChunks(
-            chunk_url.list_name, chunks.release(),
+            chunk_url.list_name, new std::string(data, length),
             base::Bind(&SafeBrowsingProtocolManager::OnAddChunksComplete,
                        base::Unretained(this)));
       }
@@ -530,6 +543,7 @@ base::TimeDelta SafeBrowsingProtocolManager::GetNextBackOffInterval(
 void SafeBrowsingProtocolManager::IssueUpdateRequest() {
   DCHECK(CalledOnValidThread());
   request_type_ = UPDATE_REQUEST;
+  SafeBrowsingUpdateProfiler::GetInstance()->StartCycle();
   delegate_->UpdateStarted();
   delegate_->GetChunks(
       base::Bind(&SafeBrowsingProtocolManager::OnGetChunksComplete,
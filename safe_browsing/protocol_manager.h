@@ -419,9 +419,11 @@ class SafeBrowsingProtocolManagerDelegate {
   // may be made to GetChunks at a time.
   virtual void GetChunks(GetChunksCallback callback) = 0;
 
-  // Add new chunks to the database. Invokes |callback| when complete, but must
+  // Add new chunks to the database. |chunk_data| is a chunk response which
+  // has been checked by SafeBrowsingProtocolParser::VisitChunks(), to be
+  // parsed straight into storage. Invokes |callback| when complete, but must
   // call at a later time.
-  virtual void AddChunks(const std::string& list, SBChunkList* chunks,
+  virtual void AddChunks(const std::string& list, std::string* chunk_data,
                          AddChunksCallback callback) = 0;
 
   // Delete chunks from the database.
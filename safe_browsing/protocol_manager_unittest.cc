@@ -272,7 +272,7 @@ class MockProtocolDelegate : public SafeBrowsingProtocolManagerDelegate {
   MOCK_METHOD1(UpdateFinished, void(bool));
   MOCK_METHOD0(ResetDatabase, void());
   MOCK_METHOD1(GetChunks, void(GetChunksCallback));
-  MOCK_METHOD3(AddChunks, void(const std::string&, SBChunkList*,
+  MOCK_METHOD3(AddChunks, void(const std::string&, std::string*,
                                AddChunksCallback));
   MOCK_METHOD1(DeleteChunks, void(std::vector<SBChunkDelete>*));
 };
@@ -287,15 +287,15 @@ void InvokeGetChunksCallback(
   callback.Run(ranges, database_error);
 }
 
-// |HandleAddChunks| deletes the chunks and asynchronously invokes
+// |HandleAddChunks| deletes the chunk data and asynchronously invokes
 // |callback| since SafeBrowsingProtocolManager is not re-entrant at the time
 // this is called. This guarantee is part of the
 // SafeBrowsingProtocolManagerDelegate contract.
 void HandleAddChunks(
     const std::string& unused_list,
-    SBChunkList* chunks,
+    std::string* chunk_data,
     SafeBrowsingProtocolManagerDelegate::AddChunksCallback callback) {
-  delete chunks;
+  delete chunk_data;
   scoped_refptr<base::SingleThreadTaskRunner> task_runner(
       base::ThreadTaskRunnerHandle::Get());
   if (!task_runner.get())
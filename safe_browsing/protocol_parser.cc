@@ -198,48 +198,61 @@ bool SafeBrowsingProtocolParser::ParseChunk(const std::string& list_name,
   const char* chunk_data = data;
 
   while (remaining > 0) {
-    std::string cmd_line;
-    if (!GetLine(chunk_data, remaining, &cmd_line))
-      return false;  // Error: bad chunk format!
-
-    const int line_len = static_cast<int>(cmd_line.length()) + 1;
-    chunk_data += line_len;
-    remaining -= line_len;
-    std::vector<std::string> cmd_parts;
-    base::SplitString(cmd_line, ':', &cmd_parts);
-    if (cmd_parts.size() != 4) {
-      return false;
-    }
-
-    // Process the chunk data.
-    const int chunk_number = atoi(cmd_parts[1].c_str());
-    const int hash_len = atoi(cmd_parts[2].c_str());
-    if (hash_len != sizeof(SBPrefix) && hash_len != sizeof(SBFullHash)) {
-      VLOG(1) << "ParseChunk got unknown hashlen " << hash_len;
-      return false;
-    }
-
-    const int chunk_len = atoi(cmd_parts[3].c_str());
-
-    if (remaining < chunk_len)
-      return false;  // parse error.
+    bool is_add;
+    int chunk_number, hash_len, chunk_len;
+    if (!ReadChunkHeader(&chunk_data, &remaining, &is_add, &chunk_number,
+                         &hash_len, &chunk_len))
+      return false;  // Parse error.
 
     chunks->push_back(SBChunk());
     chunks->back().chunk_number = chunk_number;
+    chunks->back().is_add = is_add;
 
-    if (cmd_parts[0] == "a") {
-      chunks->back().is_add = true;
+    if (is_add) {
       if (!ParseAddChunk(list_name, chunk_data, chunk_len, hash_len,
                          &chunks->back().hosts))
         return false;  // Parse error.
-    } else if (cmd_parts[0] == "s") {
-      chunks->back().is_add = false;
+    } else {
       if (!ParseSubChunk(list_name, chunk_data, chunk_len, hash_len,
                          &chunks->back().hosts))
         return false;  // Parse error.
+    }
+
+    chunk_data += chunk_len;
+    remaining -= chunk_len;
+    DCHECK_LE(0, remaining);
+  }
+
+  DCHECK(remaining == 0);
+
+  return true;
+}
+
+bool SafeBrowsingProtocolParser::VisitChunks(const std::string& list_name,
+                                             const char* data,
+                                             int length,
+                                             ChunkVisitor* visitor) {
+  int remaining = length;
+  const char* chunk_data = data;
+
+  while (remaining > 0) {
+    bool is_add;
+    int chunk_number, hash_len, chunk_len;
+    if (!ReadChunkHeader(&chunk_data, &remaining, &is_add, &chunk_number,
+                         &hash_len, &chunk_len))
+      return false;  // Parse error.
+
+    // A skipped chunk is walked without a visitor, to check it all the same.
+    ChunkVisitor* chunk_visitor =
+        visitor && visitor->OnChunk(chunk_number, is_add) ? visitor : NULL;
+    if (is_add) {
+      if (!VisitAddChunk(list_name, chunk_data, chunk_len, hash_len,
+                         chunk_visitor))
+        return false;  // Parse error.
     } else {
-      NOTREACHED();
-      return false;
+      if (!VisitSubChunk(list_name, chunk_data, chunk_len, hash_len,
+                         chunk_visitor))
+        return false;  // Parse error.
     }
 
     chunk_data += chunk_len;
@@ -252,6 +265,49 @@ bool SafeBrowsingProtocolParser::ParseChunk(const std::string& list_name,
   return true;
 }
 
+bool SafeBrowsingProtocolParser::ReadChunkHeader(const char** data,
+                                                 int* remaining,
+                                                 bool* is_add,
+                                                 int* chunk_number,
+                                                 int* hash_len,
+                                                 int* chunk_len) {
+  std::string cmd_line;
+  if (!GetLine(*data, *remaining, &cmd_line))
+    return false;  // Error: bad chunk format!
+
+  const int line_len = static_cast<int>(cmd_line.length()) + 1;
+  *data += line_len;
+  *remaining -= line_len;
+  std::vector<std::string> cmd_parts;
+  base::SplitString(cmd_line, ':', &cmd_parts);
+  if (cmd_parts.size() != 4) {
+    return false;
+  }
+
+  // Process the chunk data.
+  *chunk_number = atoi(cmd_parts[1].c_str());
+  *hash_len = atoi(cmd_parts[2].c_str());
+  if (*hash_len != sizeof(SBPrefix) && *hash_len != sizeof(SBFullHash)) {
+    VLOG(1) << "ParseChunk got unknown hashlen " << *hash_len;
+    return false;
+  }
+
+  *chunk_len = atoi(cmd_parts[3].c_str());
+
+  if (*remaining < *chunk_len)
+    return false;  // parse error.
+
+  if (cmd_parts[0] == "a") {
+    *is_add = true;
+  } else if (cmd_parts[0] == "s") {
+    *is_add = false;
+  } else {
+    NOTREACHED();
+    return false;
+  }
+  return true;
+}
+
 bool SafeBrowsingProtocolParser::ParseAddChunk(const std::string& list_name,
                                                const char* data,
                                                int data_len,
@@ -354,6 +410,96 @@ bool SafeBrowsingProtocolParser::ParseSubChunk(const std::string& list_name,
   return remaining == 0;
 }
 
+bool SafeBrowsingProtocolParser::VisitAddChunk(const std::string& list_name,
+                                               const char* data,
+                                               int data_len,
+                                               int hash_len,
+                                               ChunkVisitor* visitor) {
+  const char* chunk_data = data;
+  int remaining = data_len;
+  int prefix_count;
+
+  if (list_name == safe_browsing_util::kBinHashList ||
+      list_name == safe_browsing_util::kDownloadWhiteList ||
+      list_name == safe_browsing_util::kExtensionBlacklist) {
+    // These lists only contain prefixes, no HOSTKEY and COUNT.  An empty
+    // chunk has a single host 0 without prefixes, as in ParseAddChunk.
+    DCHECK_EQ(0, remaining % hash_len);
+    prefix_count = remaining / hash_len;
+    if (!prefix_count && visitor)
+      visitor->OnAddPrefix(0);
+    if (!VisitPrefixes(&chunk_data, &remaining, false, hash_len, prefix_count,
+                       visitor))
+      return false;
+    DCHECK_GE(remaining, 0);
+  } else {
+    SBPrefix host;
+    const int min_size = sizeof(SBPrefix) + 1;
+    while (remaining >= min_size) {
+      if (!ReadHostAndPrefixCount(&chunk_data, &remaining,
+                                  &host, &prefix_count)) {
+        return false;
+      }
+      DCHECK_GE(remaining, 0);
+      if (!prefix_count && visitor)
+        visitor->OnAddPrefix(host);
+      if (!VisitPrefixes(&chunk_data, &remaining, false, hash_len,
+                         prefix_count, visitor))
+        return false;
+      DCHECK_GE(remaining, 0);
+    }
+  }
+  return remaining == 0;
+}
+
+bool SafeBrowsingProtocolParser::VisitSubChunk(const std::string& list_name,
+                                               const char* data,
+                                               int data_len,
+                                               int hash_len,
+                                               ChunkVisitor* visitor) {
+  int remaining = data_len;
+  const char* chunk_data = data;
+  int prefix_count;
+
+  if (list_name == safe_browsing_util::kBinHashList ||
+      list_name == safe_browsing_util::kDownloadWhiteList ||
+      list_name == safe_browsing_util::kExtensionBlacklist) {
+    // (add_chunk_number, prefix) pairs only, see ParseSubChunk.
+    prefix_count = remaining / (sizeof(int32) + hash_len);
+    if (!prefix_count && visitor)
+      visitor->OnSubPrefix(0, 0);
+    if (!VisitPrefixes(&chunk_data, &remaining, true, hash_len, prefix_count,
+                       visitor))
+      return false;
+    DCHECK_GE(remaining, 0);
+  } else {
+    SBPrefix host;
+    const int min_size = 2 * sizeof(SBPrefix) + 1;
+    while (remaining >= min_size) {
+      if (!ReadHostAndPrefixCount(&chunk_data, &remaining,
+                                  &host, &prefix_count)) {
+        return false;
+      }
+      DCHECK_GE(remaining, 0);
+      if (prefix_count == 0) {
+        // There is only an add chunk number (no prefixes).
+        int chunk_id;
+        if (!ReadChunkId(&chunk_data, &remaining, &chunk_id))
+          return false;
+        DCHECK_GE(remaining, 0);
+        if (visitor)
+          visitor->OnSubPrefix(chunk_id, host);
+        continue;
+      }
+      if (!VisitPrefixes(&chunk_data, &remaining, true, hash_len,
+                         prefix_count, visitor))
+        return false;
+      DCHECK_GE(remaining, 0);
+    }
+  }
+  return remaining == 0;
+}
+
 bool SafeBrowsingProtocolParser::ReadHostAndPrefixCount(
     const char** data, int* remaining, SBPrefix* host, int* count) {
   if (static_cast<size_t>(*remaining) < sizeof(SBPrefix) + 1)
@@ -418,3 +564,45 @@ bool SafeBrowsingProtocolParser::ReadPrefixes(
 
   return true;
 }
+
+bool SafeBrowsingProtocolParser::VisitPrefixes(const char** data,
+                                               int* remaining,
+                                               bool is_sub,
+                                               int hash_len,
+                                               int count,
+                                               ChunkVisitor* visitor) {
+  for (int i = 0; i < count; ++i) {
+    int chunk_id = 0;
+    if (is_sub) {
+      if (!ReadChunkId(data, remaining, &chunk_id))
+        return false;
+      DCHECK_GE(*remaining, 0);
+    }
+
+    if (*remaining < hash_len)
+      return false;
+    if (visitor) {
+      if (hash_len == sizeof(SBPrefix)) {
+        SBPrefix prefix;
+        memcpy(&prefix, *data, sizeof(prefix));
+        if (is_sub)
+          visitor->OnSubPrefix(chunk_id, prefix);
+        else
+          visitor->OnAddPrefix(prefix);
+      } else {
+        SBFullHash hash;
+        DCHECK_EQ(hash_len, (int)sizeof(hash));
+        memcpy(&hash, *data, sizeof(hash));
+        if (is_sub)
+          visitor->OnSubFullHash(chunk_id, hash);
+        else
+          visitor->OnAddFullHash(hash);
+      }
+    }
+    *data += hash_len;
+    *remaining -= hash_len;
+    DCHECK_GE(*remaining, 0);
+  }
+
+  return true;
+}
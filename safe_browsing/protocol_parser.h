@@ -50,6 +50,26 @@
 
 class SafeBrowsingProtocolParser {
  public:
+  // Receives the contents of a chunk response from |VisitChunks()|, which
+  // reads them in place instead of building an SBChunkList.
+  class ChunkVisitor {
+   public:
+    // Called at the start of each chunk.  Returning false skips the chunk's
+    // contents, which are still checked.
+    virtual bool OnChunk(int chunk_number, bool is_add) = 0;
+
+    // Called for each prefix or full hash of the current chunk.  A host
+    // without prefixes is passed as a prefix of its own.
+    virtual void OnAddPrefix(SBPrefix prefix) = 0;
+    virtual void OnAddFullHash(const SBFullHash& full_hash) = 0;
+    virtual void OnSubPrefix(int add_chunk_number, SBPrefix prefix) = 0;
+    virtual void OnSubFullHash(int add_chunk_number,
+                               const SBFullHash& full_hash) = 0;
+
+   protected:
+    virtual ~ChunkVisitor() {}
+  };
+
   SafeBrowsingProtocolParser();
 
   // Parse the response of an update request. Results for chunk deletions (both
@@ -74,6 +94,17 @@ class SafeBrowsingProtocolParser {
                   int chunk_len,
                   SBChunkList* chunks);
 
+  // Walks the same response as |ParseChunk()|, handing each chunk's prefixes
+  // and full hashes to |visitor| as they are read from |chunk_data|, so that
+  // nothing is allocated per chunk or per host.  |visitor| may be NULL to only
+  // check the format.  Returns 'false' on the first parse error, by which time
+  // |visitor| may have been given part of the response, so a response which
+  // has not been checked beforehand should not be visited into storage.
+  bool VisitChunks(const std::string& list_name,
+                   const char* chunk_data,
+                   int chunk_len,
+                   ChunkVisitor* visitor);
+
   // Parse the result of a GetHash request, returning the list of full hashes.
   bool ParseGetHash(const char* chunk_data,
                     int chunk_len,
@@ -95,6 +126,26 @@ class SafeBrowsingProtocolParser {
                      int hash_len,
                      std::deque<SBChunkHost>* hosts);
 
+  bool VisitAddChunk(const std::string& list_name,
+                     const char* data,
+                     int data_len,
+                     int hash_len,
+                     ChunkVisitor* visitor);
+  bool VisitSubChunk(const std::string& list_name,
+                     const char* data,
+                     int data_len,
+                     int hash_len,
+                     ChunkVisitor* visitor);
+
+  // Reads the "<chunk_type>:<chunk_number>:<prefix_len>:<chunk_bytes>\n"
+  // line in front of each chunk, used by ParseChunk and VisitChunks.
+  static bool ReadChunkHeader(const char** data,
+                              int* remaining,
+                              bool* is_add,
+                              int* chunk_number,
+                              int* hash_len,
+                              int* chunk_len);
+
   // Helper functions used by ParseAddChunk and ParseSubChunk.
   static bool ReadHostAndPrefixCount(const char** data,
                                      int* remaining,
@@ -104,6 +155,14 @@ class SafeBrowsingProtocolParser {
   static bool ReadPrefixes(
       const char** data, int* remaining, SBEntry* entry, int count);
 
+  // Like ReadPrefixes, for VisitAddChunk and VisitSubChunk.
+  static bool VisitPrefixes(const char** data,
+                            int* remaining,
+                            bool is_sub,
+                            int hash_len,
+                            int count,
+                            ChunkVisitor* visitor);
+
   // The name of the current list
   std::string list_name_;
 
@@ -0,0 +1,136 @@
+// Copyright 2013 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Benchmarks parsing the chunk responses of a full initial update into an
+// SBChunkList against walking them in place with |VisitChunks()|.  Results
+// are printed in the perf_test RESULT format so that they can be tracked by
+// the perf bots.
+
+#include <string>
+
+#include "base/rand_util.h"
+#include "base/strings/stringprintf.h"
+#include "base/time/time.h"
+#include "chrome/browser/safe_browsing/protocol_parser.h"
+#include "chrome/browser/safe_browsing/safe_browsing_util.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_test.h"
+
+using base::TimeDelta;
+using base::TimeTicks;
+
+namespace {
+
+// The number of add prefixes in the browse list, see prefix_set.h.
+const int kNumPrefixes = 653132;
+
+// Hosts per chunk and prefixes per host, close to what the server sends.
+const int kHostsPerChunk = 250;
+const int kPrefixesPerHost = 2;
+
+// Counts what it is given, so that the walk can't be optimized away.
+class CountingChunkVisitor : public SafeBrowsingProtocolParser::ChunkVisitor {
+ public:
+  CountingChunkVisitor() : chunks_(0), prefixes_(0) {}
+  virtual ~CountingChunkVisitor() {}
+
+  virtual bool OnChunk(int chunk_number, bool is_add) OVERRIDE {
+    ++chunks_;
+    return true;
+  }
+  virtual void OnAddPrefix(SBPrefix prefix) OVERRIDE {
+    ++prefixes_;
+  }
+  virtual void OnAddFullHash(const SBFullHash& full_hash) OVERRIDE {
+    ++prefixes_;
+  }
+  virtual void OnSubPrefix(int add_chunk_number, SBPrefix prefix) OVERRIDE {
+    ++prefixes_;
+  }
+  virtual void OnSubFullHash(int add_chunk_number,
+                             const SBFullHash& full_hash) OVERRIDE {
+    ++prefixes_;
+  }
+
+  int chunks() const { return chunks_; }
+  int prefixes() const { return prefixes_; }
+
+ private:
+  int chunks_;
+  int prefixes_;
+
+  DISALLOW_COPY_AND_ASSIGN(CountingChunkVisitor);
+};
+
+// Builds add chunks holding |kNumPrefixes| random prefixes.
+std::string MakeChunkResponse() {
+  std::string response;
+  int chunk_number = 1;
+  for (int prefixes = 0; prefixes < kNumPrefixes; ++chunk_number) {
+    std::string body;
+    for (int i = 0; i < kHostsPerChunk && prefixes < kNumPrefixes; ++i) {
+      const SBPrefix host = static_cast<SBPrefix>(base::RandUint64());
+      body.append(reinterpret_cast<const char*>(&host), sizeof(host));
+      body.push_back(kPrefixesPerHost);
+      for (int j = 0; j < kPrefixesPerHost; ++j, ++prefixes) {
+        const SBPrefix prefix = static_cast<SBPrefix>(base::RandUint64());
+        body.append(reinterpret_cast<const char*>(&prefix), sizeof(prefix));
+      }
+    }
+    response.append(base::StringPrintf("a:%d:4:%d\n", chunk_number,
+                                       static_cast<int>(body.size())));
+    response.append(body);
+  }
+  return response;
+}
+
+void PrintTime(const std::string& trace, TimeDelta time) {
+  perf_test::PrintResult("ChunkParse", std::string(), trace,
+                         static_cast<size_t>(time.InMicroseconds()), "us",
+                         true);
+}
+
+}  // namespace
+
+TEST(SafeBrowsingProtocolParserPerfTest, FullUpdate) {
+  const std::string response = MakeChunkResponse();
+  SafeBrowsingProtocolParser parser;
+
+  // Copying makes an SBEntry allocation per host, all alive until the
+  // chunks have been inserted.
+  TimeTicks start = TimeTicks::Now();
+  SBChunkList chunks;
+  ASSERT_TRUE(parser.ParseChunk(safe_browsing_util::kMalwareList,
+                                response.data(),
+                                static_cast<int>(response.size()), &chunks));
+  PrintTime("copied", TimeTicks::Now() - start);
+
+  size_t entries = 0;
+  int prefixes = 0;
+  for (SBChunkList::const_iterator citer = chunks.begin();
+       citer != chunks.end(); ++citer) {
+    for (std::deque<SBChunkHost>::const_iterator hiter = citer->hosts.begin();
+         hiter != citer->hosts.end(); ++hiter) {
+      ++entries;
+      prefixes += hiter->entry->prefix_count();
+    }
+  }
+  EXPECT_EQ(kNumPrefixes, prefixes);
+
+  // Walking in place allocates nothing past the response itself.
+  start = TimeTicks::Now();
+  CountingChunkVisitor visitor;
+  ASSERT_TRUE(parser.VisitChunks(safe_browsing_util::kMalwareList,
+                                 response.data(),
+                                 static_cast<int>(response.size()),
+                                 &visitor));
+  PrintTime("visited", TimeTicks::Now() - start);
+  EXPECT_EQ(static_cast<int>(chunks.size()), visitor.chunks());
+  EXPECT_EQ(kNumPrefixes, visitor.prefixes());
+
+  perf_test::PrintResult("ChunkParseSize", std::string(), "response",
+                         response.size(), "bytes", false);
+  perf_test::PrintResult("ChunkParseAllocations", std::string(), "copied",
+                         entries, "entries", false);
+}
@@ -9,6 +9,52 @@
 #include "chrome/browser/safe_browsing/safe_browsing_util.h"
 #include "testing/gtest/include/gtest/gtest.h"
 
+namespace {
+
+// Records what |SafeBrowsingProtocolParser::VisitChunks()| reports, one
+// space-separated token per call.
+class RecordingChunkVisitor : public SafeBrowsingProtocolParser::ChunkVisitor {
+ public:
+  RecordingChunkVisitor() : skip_chunk_(-1) {}
+  virtual ~RecordingChunkVisitor() {}
+
+  virtual bool OnChunk(int chunk_number, bool is_add) OVERRIDE {
+    Record(base::StringPrintf("%s%d", is_add ? "a" : "s", chunk_number));
+    return chunk_number != skip_chunk_;
+  }
+  virtual void OnAddPrefix(SBPrefix prefix) OVERRIDE {
+    Record(base::StringPrintf("%08x", prefix));
+  }
+  virtual void OnAddFullHash(const SBFullHash& full_hash) OVERRIDE {
+    Record(base::StringPrintf("h%08x", full_hash.prefix));
+  }
+  virtual void OnSubPrefix(int add_chunk_number, SBPrefix prefix) OVERRIDE {
+    Record(base::StringPrintf("%08x:%08x", add_chunk_number, prefix));
+  }
+  virtual void OnSubFullHash(int add_chunk_number,
+                             const SBFullHash& full_hash) OVERRIDE {
+    Record(base::StringPrintf("%08x:h%08x", add_chunk_number,
+                              full_hash.prefix));
+  }
+
+  void set_skip_chunk(int chunk_number) { skip_chunk_ = chunk_number; }
+  const std::string& log() const { return log_; }
+
+ private:
+  void Record(const std::string& token) {
+    if (!log_.empty())
+      log_.push_back(' ');
+    log_.append(token);
+  }
+
+  int skip_chunk_;
+  std::string log_;
+
+  DISALLOW_COPY_AND_ASSIGN(RecordingChunkVisitor);
+};
+
+}  // namespace
+
 // Test parsing one add chunk.
 TEST(SafeBrowsingProtocolParsingTest, TestAddChunk) {
   std::string add_chunk("a:1:4:35\naaaax1111\0032222333344447777\00288889999");
@@ -782,3 +828,85 @@ TEST(SafeBrowsingProtocolParsingTest, TestSubDownloadWhitelistChunk) {
   memcpy(full.full_hash, "xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx", 32);
   EXPECT_TRUE(entry->FullHashAt(0) == full);
 }
+
+// Test visiting add chunks in place.  A host without prefixes is reported as
+// a prefix of its own.
+TEST(SafeBrowsingProtocolParsingTest, TestVisitAddChunks) {
+  std::string add_chunk("a:1:4:35\naaaax1111\0032222333344447777\00288889999"
+                        "a:2:4:13\n5555\002ppppgggg");
+  add_chunk[13] = '\0';
+
+  SafeBrowsingProtocolParser parser;
+  RecordingChunkVisitor visitor;
+  EXPECT_TRUE(parser.VisitChunks(safe_browsing_util::kMalwareList,
+                                 add_chunk.data(),
+                                 static_cast<int>(add_chunk.length()),
+                                 &visitor));
+  EXPECT_EQ("a1 61616161 32323232 33333333 34343434 38383838 39393939 "
+            "a2 70707070 67676767", visitor.log());
+
+  // A skipped chunk is still walked, but not reported.
+  RecordingChunkVisitor skipping_visitor;
+  skipping_visitor.set_skip_chunk(1);
+  EXPECT_TRUE(parser.VisitChunks(safe_browsing_util::kMalwareList,
+                                 add_chunk.data(),
+                                 static_cast<int>(add_chunk.length()),
+                                 &skipping_visitor));
+  EXPECT_EQ("a1 a2 70707070 67676767", skipping_visitor.log());
+
+  // Without a visitor the chunks are only checked.
+  EXPECT_TRUE(parser.VisitChunks(safe_browsing_util::kMalwareList,
+                                 add_chunk.data(),
+                                 static_cast<int>(add_chunk.length()),
+                                 NULL));
+  EXPECT_FALSE(parser.VisitChunks(safe_browsing_util::kMalwareList,
+                                  add_chunk.data(),
+                                  static_cast<int>(add_chunk.length()) - 1,
+                                  NULL));
+}
+
+// Test visiting sub chunks of prefixes and full hashes in place.
+TEST(SafeBrowsingProtocolParsingTest, TestVisitSubChunks) {
+  std::string sub_chunk("s:9:4:59\naaaaxkkkk1111\003"
+                        "zzzz2222zzzz3333zzzz4444"
+                        "7777\002yyyy8888yyyy9999");
+  sub_chunk[13] = '\0';
+
+  SafeBrowsingProtocolParser parser;
+  RecordingChunkVisitor visitor;
+  EXPECT_TRUE(parser.VisitChunks(safe_browsing_util::kMalwareList,
+                                 sub_chunk.data(),
+                                 static_cast<int>(sub_chunk.length()),
+                                 &visitor));
+  EXPECT_EQ("s9 6b6b6b6b:61616161 7a7a7a7a:32323232 7a7a7a7a:33333333 "
+            "7a7a7a7a:34343434 79797979:38383838 79797979:39393939",
+            visitor.log());
+
+  std::string full_chunk("s:1:32:77\naaaa");
+  full_chunk.push_back(2);
+  SBFullHash full_hash1, full_hash2;
+  for (int i = 0; i < 32; ++i) {
+    full_hash1.full_hash[i] = 1;
+    full_hash2.full_hash[i] = 2;
+  }
+  full_chunk.append("yyyy");
+  full_chunk.append(full_hash1.full_hash, 32);
+  full_chunk.append("zzzz");
+  full_chunk.append(full_hash2.full_hash, 32);
+
+  RecordingChunkVisitor full_visitor;
+  EXPECT_TRUE(parser.VisitChunks(safe_browsing_util::kMalwareList,
+                                 full_chunk.data(),
+                                 static_cast<int>(full_chunk.length()),
+                                 &full_visitor));
+  EXPECT_EQ("s1 79797979:h01010101 7a7a7a7a:h02020202", full_visitor.log());
+
+  // Prefix-only lists have (add_chunk_number, prefix) pairs.
+  std::string bin_chunk("s:9:4:16\n1111mmmm2222nnnn");
+  RecordingChunkVisitor bin_visitor;
+  EXPECT_TRUE(parser.VisitChunks(safe_browsing_util::kBinHashList,
+                                 bin_chunk.data(),
+                                 static_cast<int>(bin_chunk.length()),
+                                 &bin_visitor));
+  EXPECT_EQ("s9 31313131:6d6d6d6d 32323232:6e6e6e6e", bin_visitor.log());
+}
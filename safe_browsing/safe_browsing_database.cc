@@ -16,7 +16,9 @@
 #include "base/process/process_metrics.h"
 #include "base/time/time.h"
 #include "chrome/browser/safe_browsing/prefix_set.h"
+#include "chrome/browser/safe_browsing/protocol_parser.h"
 #include "chrome/browser/safe_browsing/safe_browsing_store_file.h"
+#include "chrome/browser/safe_browsing/update_profiler.h"
 #include "content/public/browser/browser_thread.h"
 #include "crypto/sha2.h"
 #include "url/gurl.h"
@@ -324,6 +326,73 @@ int64 GetFileSizeOrZero(const base::FilePath& file_path) {
   return size_64;
 }
 
+// Writes the chunks of a response to |store| as the parser reads them,
+// the way |InsertAddChunks()| and |InsertSubChunks()| write parsed ones.
+class StoreChunkWriter : public SafeBrowsingProtocolParser::ChunkVisitor {
+ public:
+  StoreChunkWriter(SafeBrowsingStore* store, int list_id)
+      : store_(store),
+        list_id_(list_id),
+        encoded_chunk_id_(0),
+        receive_time_(base::Time::Now()) {
+  }
+  virtual ~StoreChunkWriter() {}
+
+  virtual bool OnChunk(int chunk_number, bool is_add) OVERRIDE {
+    // The server can give us a chunk that we already have because
+    // it's part of a range.  Don't add it again.
+    encoded_chunk_id_ = EncodeChunkId(chunk_number, list_id_);
+    if (is_add) {
+      if (store_->CheckAddChunk(encoded_chunk_id_))
+        return false;
+      store_->SetAddChunk(encoded_chunk_id_);
+    } else {
+      if (store_->CheckSubChunk(encoded_chunk_id_))
+        return false;
+      store_->SetSubChunk(encoded_chunk_id_);
+    }
+    return true;
+  }
+
+  virtual void OnAddPrefix(SBPrefix prefix) OVERRIDE {
+    STATS_COUNTER("SB.PrefixAdd", 1);
+    store_->WriteAddPrefix(encoded_chunk_id_, prefix);
+  }
+
+  virtual void OnAddFullHash(const SBFullHash& full_hash) OVERRIDE {
+    STATS_COUNTER("SB.PrefixAdd", 1);
+    store_->WriteAddPrefix(encoded_chunk_id_, full_hash.prefix);
+
+    STATS_COUNTER("SB.PrefixAddFull", 1);
+    store_->WriteAddHash(encoded_chunk_id_, receive_time_, full_hash);
+  }
+
+  virtual void OnSubPrefix(int add_chunk_number, SBPrefix prefix) OVERRIDE {
+    STATS_COUNTER("SB.PrefixSub", 1);
+    store_->WriteSubPrefix(encoded_chunk_id_,
+                           EncodeChunkId(add_chunk_number, list_id_), prefix);
+  }
+
+  virtual void OnSubFullHash(int add_chunk_number,
+                             const SBFullHash& full_hash) OVERRIDE {
+    const int add_chunk_id = EncodeChunkId(add_chunk_number, list_id_);
+
+    STATS_COUNTER("SB.PrefixSub", 1);
+    store_->WriteSubPrefix(encoded_chunk_id_, add_chunk_id, full_hash.prefix);
+
+    STATS_COUNTER("SB.PrefixSubFull", 1);
+    store_->WriteSubHash(encoded_chunk_id_, add_chunk_id, full_hash);
+  }
+
+ private:
+  SafeBrowsingStore* store_;
+  const int list_id_;
+  int encoded_chunk_id_;
+  const base::Time receive_time_;
+
+  DISALLOW_COPY_AND_ASSIGN(StoreChunkWriter);
+};
+
 }  // namespace
 
 // The default SafeBrowsingDatabaseFactory.
@@ -377,6 +446,43 @@ SafeBrowsingDatabase* SafeBrowsingDatabase::Create(
 SafeBrowsingDatabase::~SafeBrowsingDatabase() {
 }
 
+bool SafeBrowsingDatabase::ContainsBrowseUrls(
+    const std::vector<GURL>& urls,
+    std::vector<SBPrefix>* prefix_hits,
+    std::vector<SBFullHashResult>* full_hits,
+    base::Time last_update) {
+  prefix_hits->clear();
+  full_hits->clear();
+
+  for (size_t i = 0; i < urls.size(); ++i) {
+    std::string matching_list;
+    std::vector<SBPrefix> url_prefix_hits;
+    std::vector<SBFullHashResult> url_full_hits;
+    if (ContainsBrowseUrl(urls[i], &matching_list, &url_prefix_hits,
+                          &url_full_hits, last_update)) {
+      prefix_hits->insert(prefix_hits->end(), url_prefix_hits.begin(),
+                          url_prefix_hits.end());
+      full_hits->insert(full_hits->end(), url_full_hits.begin(),
+                        url_full_hits.end());
+    }
+  }
+
+  std::sort(prefix_hits->begin(), prefix_hits->end());
+  prefix_hits->erase(std::unique(prefix_hits->begin(), prefix_hits->end()),
+                     prefix_hits->end());
+  return !prefix_hits->empty();
+}
+
+void SafeBrowsingDatabase::InsertChunkData(const std::string& list_name,
+                                           const std::string& chunk_data) {
+  SafeBrowsingProtocolParser parser;
+  SBChunkList chunks;
+  if (parser.ParseChunk(list_name, chunk_data.data(),
+                        static_cast<int>(chunk_data.size()), &chunks)) {
+    InsertChunks(list_name, chunks);
+  }
+}
+
 // static
 base::FilePath SafeBrowsingDatabase::BrowseDBFilename(
     const base::FilePath& db_base_filename) {
@@ -450,9 +556,33 @@ void SafeBrowsingDatabase::RecordFailure(FailureType failure_type) {
                             FAILURE_DATABASE_MAX);
 }
 
+SafeBrowsingDatabaseNew::BrowseFilter::BrowseFilter() {
+}
+
+SafeBrowsingDatabaseNew::BrowseFilter::~BrowseFilter() {
+}
+
+SafeBrowsingDatabaseNew::BrowseSnapshot::BrowseSnapshot(
+    const BrowseFilter* browse_filter)
+    : filter(browse_filter) {
+  DCHECK(browse_filter);
+}
+
+SafeBrowsingDatabaseNew::BrowseSnapshot*
+SafeBrowsingDatabaseNew::BrowseSnapshot::Copy() const {
+  BrowseSnapshot* copy = new BrowseSnapshot(filter.get());
+  copy->pending_hashes = pending_hashes;
+  copy->prefix_misses = prefix_misses;
+  return copy;
+}
+
+SafeBrowsingDatabaseNew::BrowseSnapshot::~BrowseSnapshot() {
+}
+
 SafeBrowsingDatabaseNew::SafeBrowsingDatabaseNew()
     : creation_loop_(base::MessageLoop::current()),
       browse_store_(new SafeBrowsingStoreFile),
+      browse_snapshot_(new BrowseSnapshot(new BrowseFilter)),
       reset_factory_(this),
       corruption_detected_(false),
       change_detected_(false) {
@@ -478,6 +608,7 @@ SafeBrowsingDatabaseNew::SafeBrowsingDatabaseNew(
       download_whitelist_store_(download_whitelist_store),
       extension_blacklist_store_(extension_blacklist_store),
       side_effect_free_whitelist_store_(side_effect_free_whitelist_store),
+      browse_snapshot_(new BrowseSnapshot(new BrowseFilter)),
       reset_factory_(this),
       corruption_detected_(false) {
   DCHECK(browse_store_.get());
@@ -506,16 +637,7 @@ void SafeBrowsingDatabaseNew::Init(const base::FilePath& filename_base) {
                  base::Unretained(this)));
   DVLOG(1) << "Init browse store: " << browse_filename_.value();
 
-  {
-    // NOTE: There is no need to grab the lock in this function, since
-    // until it returns, there are no pointers to this class on other
-    // threads.  Then again, that means there is no possibility of
-    // contention on the lock...
-    base::AutoLock locked(lookup_lock_);
-    full_browse_hashes_.clear();
-    pending_browse_hashes_.clear();
-    LoadPrefixSet();
-  }
+  LoadPrefixSet();
 
   if (download_store_.get()) {
     download_filename_ = DownloadDBFilename(filename_base);
@@ -617,12 +739,12 @@ bool SafeBrowsingDatabaseNew::ResetDatabase() {
     return false;
 
   // Reset objects in memory.
+  {
+    base::AutoLock locked(browse_writer_lock_);
+    PublishBrowseSnapshot(new BrowseSnapshot(new BrowseFilter));
+  }
   {
     base::AutoLock locked(lookup_lock_);
-    full_browse_hashes_.clear();
-    pending_browse_hashes_.clear();
-    prefix_miss_cache_.clear();
-    browse_prefix_set_.reset();
     side_effect_free_whitelist_prefix_set_.reset();
   }
   // Wants to acquire the lock itself.
@@ -644,45 +766,115 @@ bool SafeBrowsingDatabaseNew::ContainsBrowseUrl(
   prefix_hits->clear();
   full_hits->clear();
 
-  std::vector<SBFullHash> full_hashes;
-  BrowseFullHashesToCheck(url, false, &full_hashes);
-  if (full_hashes.empty())
+  // This function is called on the I/O thread.  The snapshot does not
+  // change while it is read, even if an update finishes meanwhile.
+  const scoped_refptr<const BrowseSnapshot> snapshot = GetBrowseSnapshot();
+  if (!GetBrowsePrefixHits(*snapshot, url, prefix_hits))
     return false;
 
-  // This function is called on the I/O thread, prevent changes to
-  // filter and caches.
-  base::AutoLock locked(lookup_lock_);
+  // Find the matching full-hash results.  The filter's full hashes are from
+  // the database, the pending hashes are from GetHash requests between
+  // updates.
+  std::sort(prefix_hits->begin(), prefix_hits->end());
 
-  // |browse_prefix_set_| is empty until it is either read from disk, or the
+  GetCachedFullHashesForBrowse(*prefix_hits, snapshot->filter->full_hashes,
+                               full_hits, last_update);
+  GetCachedFullHashesForBrowse(*prefix_hits, snapshot->pending_hashes,
+                               full_hits, last_update);
+  return true;
+}
+
+bool SafeBrowsingDatabaseNew::ContainsBrowseUrls(
+    const std::vector<GURL>& urls,
+    std::vector<SBPrefix>* prefix_hits,
+    std::vector<SBFullHashResult>* full_hits,
+    base::Time last_update) {
+  prefix_hits->clear();
+  full_hits->clear();
+
+  // All the URLs are checked against the same snapshot, and the caches
+  // are scanned once for all of their hits.
+  const scoped_refptr<const BrowseSnapshot> snapshot = GetBrowseSnapshot();
+  for (size_t i = 0; i < urls.size(); ++i)
+    GetBrowsePrefixHits(*snapshot, urls[i], prefix_hits);
+  if (prefix_hits->empty())
+    return false;
+
+  std::sort(prefix_hits->begin(), prefix_hits->end());
+  prefix_hits->erase(std::unique(prefix_hits->begin(), prefix_hits->end()),
+                     prefix_hits->end());
+
+  GetCachedFullHashesForBrowse(*prefix_hits, snapshot->filter->full_hashes,
+                               full_hits, last_update);
+  GetCachedFullHashesForBrowse(*prefix_hits, snapshot->pending_hashes,
+                               full_hits, last_update);
+  return true;
+}
+
+// static
+bool SafeBrowsingDatabaseNew::GetBrowsePrefixHits(
+    const BrowseSnapshot& snapshot,
+    const GURL& url,
+    std::vector<SBPrefix>* prefix_hits) {
+  // The prefix set is empty until it is either read from disk, or the
   // first update populates it.  Bail out without a hit if not yet
   // available.
-  if (!browse_prefix_set_.get())
+  const safe_browsing::PrefixSet* prefix_set =
+      snapshot.filter->prefix_set.get();
+  if (!prefix_set)
     return false;
 
+  std::vector<SBFullHash> full_hashes;
+  BrowseFullHashesToCheck(url, false, &full_hashes);
+
+  const size_t orig_size = prefix_hits->size();
   size_t miss_count = 0;
   for (size_t i = 0; i < full_hashes.size(); ++i) {
     const SBPrefix prefix = full_hashes[i].prefix;
-    if (browse_prefix_set_->Exists(prefix)) {
+    if (prefix_set->Exists(prefix)) {
       prefix_hits->push_back(prefix);
-      if (prefix_miss_cache_.count(prefix) > 0)
+      if (snapshot.prefix_misses.count(prefix) > 0)
         ++miss_count;
     }
   }
 
   // If all the prefixes are cached as 'misses', don't issue a GetHash.
-  if (miss_count == prefix_hits->size())
+  if (miss_count == prefix_hits->size() - orig_size) {
+    prefix_hits->resize(orig_size);
     return false;
+  }
+  return true;
+}
 
-  // Find the matching full-hash results.  |full_browse_hashes_| are from the
-  // database, |pending_browse_hashes_| are from GetHash requests between
-  // updates.
-  std::sort(prefix_hits->begin(), prefix_hits->end());
+scoped_refptr<const SafeBrowsingDatabaseNew::BrowseSnapshot>
+SafeBrowsingDatabaseNew::GetBrowseSnapshot() {
+  // Publishing only swaps a pointer under the lock, so waiting for it
+  // should be rare and short.  Record how rare and how short.
+  const bool contended = !lookup_lock_.Try();
+  if (contended) {
+    const base::TimeTicks before = base::TimeTicks::Now();
+    lookup_lock_.Acquire();
+    UMA_HISTOGRAM_TIMES("SB2.BrowseSnapshotLockWait",
+                        base::TimeTicks::Now() - before);
+  }
+  scoped_refptr<const BrowseSnapshot> snapshot = browse_snapshot_;
+  lookup_lock_.Release();
+  UMA_HISTOGRAM_BOOLEAN("SB2.BrowseSnapshotLockContended", contended);
+  return snapshot;
+}
 
-  GetCachedFullHashesForBrowse(*prefix_hits, full_browse_hashes_,
-                               full_hits, last_update);
-  GetCachedFullHashesForBrowse(*prefix_hits, pending_browse_hashes_,
-                               full_hits, last_update);
-  return true;
+void SafeBrowsingDatabaseNew::PublishBrowseSnapshot(
+    const BrowseSnapshot* snapshot) {
+  browse_writer_lock_.AssertAcquired();
+  DCHECK(snapshot);
+
+  // Drop the old snapshot outside of the lock, in case this is the
+  // last reference and it has a prefix set to free.
+  scoped_refptr<const BrowseSnapshot> old_snapshot(snapshot);
+  {
+    base::AutoLock locked(lookup_lock_);
+    browse_snapshot_.swap(old_snapshot);
+  }
 }
 
 bool SafeBrowsingDatabaseNew::ContainsDownloadUrl(
@@ -962,7 +1154,44 @@ void SafeBrowsingDatabaseNew::InsertChunks(const std::string& list_name,
   }
   store->FinishChunk();
 
-  UMA_HISTOGRAM_TIMES("SB2.ChunkInsert", base::TimeTicks::Now() - before);
+  const base::TimeDelta insert_time = base::TimeTicks::Now() - before;
+  UMA_HISTOGRAM_TIMES("SB2.ChunkInsert", insert_time);
+  SafeBrowsingUpdateProfiler::GetInstance()->RecordPhase(
+      SafeBrowsingUpdateProfiler::PHASE_INSERT, list_name, insert_time, 0);
+}
+
+void SafeBrowsingDatabaseNew::InsertChunkData(const std::string& list_name,
+                                              const std::string& chunk_data) {
+  DCHECK_EQ(creation_loop_, base::MessageLoop::current());
+
+  if (corruption_detected_ || chunk_data.empty())
+    return;
+
+  const base::TimeTicks before = base::TimeTicks::Now();
+
+  const safe_browsing_util::ListType list_id =
+      safe_browsing_util::GetListId(list_name);
+  DVLOG(2) << list_name << ": " << list_id;
+
+  SafeBrowsingStore* store = GetStore(list_id);
+  if (!store) return;
+
+  change_detected_ = true;
+
+  store->BeginChunk();
+  StoreChunkWriter writer(store, list_id);
+  SafeBrowsingProtocolParser parser;
+  const bool parsed = parser.VisitChunks(
+      list_name, chunk_data.data(), static_cast<int>(chunk_data.size()),
+      &writer);
+  DCHECK(parsed);
+  store->FinishChunk();
+
+  const base::TimeDelta insert_time = base::TimeTicks::Now() - before;
+  UMA_HISTOGRAM_TIMES("SB2.ChunkInsert", insert_time);
+  SafeBrowsingUpdateProfiler::GetInstance()->RecordPhase(
+      SafeBrowsingUpdateProfiler::PHASE_INSERT, list_name, insert_time,
+      chunk_data.size());
 }
 
 void SafeBrowsingDatabaseNew::DeleteChunks(
@@ -997,18 +1226,22 @@ void SafeBrowsingDatabaseNew::DeleteChunks(
 void SafeBrowsingDatabaseNew::CacheHashResults(
     const std::vector<SBPrefix>& prefixes,
     const std::vector<SBFullHashResult>& full_hits) {
-  // This is called on the I/O thread, lock against updates.
-  base::AutoLock locked(lookup_lock_);
+  // This is called on the I/O thread, lock against updates.  Lookups
+  // keep using the current snapshot until the changed copy is published.
+  base::AutoLock locked(browse_writer_lock_);
+  scoped_refptr<BrowseSnapshot> snapshot(GetBrowseSnapshot()->Copy());
 
   if (full_hits.empty()) {
-    prefix_miss_cache_.insert(prefixes.begin(), prefixes.end());
+    snapshot->prefix_misses.insert(prefixes.begin(), prefixes.end());
+    PublishBrowseSnapshot(snapshot.get());
     return;
   }
 
   // TODO(shess): SBFullHashResult and SBAddFullHash are very similar.
   // Refactor to make them identical.
+  std::vector<SBAddFullHash>& pending_hashes = snapshot->pending_hashes;
   const base::Time now = base::Time::Now();
-  const size_t orig_size = pending_browse_hashes_.size();
+  const size_t orig_size = pending_hashes.size();
   for (std::vector<SBFullHashResult>::const_iterator iter = full_hits.begin();
        iter != full_hits.end(); ++iter) {
     const int list_id = safe_browsing_util::GetListId(iter->list_name);
@@ -1016,17 +1249,17 @@ void SafeBrowsingDatabaseNew::CacheHashResults(
         list_id == safe_browsing_util::PHISH) {
       int encoded_chunk_id = EncodeChunkId(iter->add_chunk_id, list_id);
       SBAddFullHash add_full_hash(encoded_chunk_id, now, iter->hash);
-      pending_browse_hashes_.push_back(add_full_hash);
+      pending_hashes.push_back(add_full_hash);
     }
   }
 
   // Sort new entries then merge with the previously-sorted entries.
   std::vector<SBAddFullHash>::iterator
-      orig_end = pending_browse_hashes_.begin() + orig_size;
-  std::sort(orig_end, pending_browse_hashes_.end(), SBAddFullHashPrefixLess);
-  std::inplace_merge(pending_browse_hashes_.begin(),
-                     orig_end, pending_browse_hashes_.end(),
+      orig_end = pending_hashes.begin() + orig_size;
+  std::sort(orig_end, pending_hashes.end(), SBAddFullHashPrefixLess);
+  std::inplace_merge(pending_hashes.begin(), orig_end, pending_hashes.end(),
                      SBAddFullHashPrefixLess);
+  PublishBrowseSnapshot(snapshot.get());
 }
 
 bool SafeBrowsingDatabaseNew::UpdateStarted(
@@ -1294,15 +1527,9 @@ int64 SafeBrowsingDatabaseNew::UpdateHashPrefixStore(
 }
 
 void SafeBrowsingDatabaseNew::UpdateBrowseStore() {
-  // Copy out the pending add hashes.  Copy rather than swapping in
-  // case |ContainsBrowseURL()| is called before the new filter is complete.
-  std::vector<SBAddFullHash> pending_add_hashes;
-  {
-    base::AutoLock locked(lookup_lock_);
-    pending_add_hashes.insert(pending_add_hashes.end(),
-                              pending_browse_hashes_.begin(),
-                              pending_browse_hashes_.end());
-  }
+  // The pending add hashes and misses are read from the current snapshot,
+  // which lookups keep using until the new filter is complete.
+  scoped_refptr<const BrowseSnapshot> old_snapshot = GetBrowseSnapshot();
 
   // Measure the amount of IO during the filter build.
   base::IoCounters io_before, io_after;
@@ -1325,16 +1552,23 @@ void SafeBrowsingDatabaseNew::UpdateBrowseStore() {
 
   SBAddPrefixes add_prefixes;
   std::vector<SBAddFullHash> add_full_hashes;
-  if (!browse_store_->FinishUpdate(pending_add_hashes, prefix_miss_cache_,
+  if (!browse_store_->FinishUpdate(old_snapshot->pending_hashes,
+                                   old_snapshot->prefix_misses,
                                    &add_prefixes, &add_full_hashes)) {
     RecordFailure(FAILURE_BROWSE_DATABASE_UPDATE_FINISH);
     return;
   }
 
+  // The old snapshot's set may be mapped from the prefix set file, which
+  // |WritePrefixSet()| replaces below.  Windows can't replace a mapped
+  // file, so don't keep the mapping alive any longer than needed.
+  old_snapshot = NULL;
+
   // TODO(shess): If |add_prefixes| were sorted by the prefix, it
   // could be passed directly to |PrefixSet()|, removing the need for
   // |prefixes|.  For now, |prefixes| is useful while debugging
   // things.
+  const base::TimeTicks build_start = base::TimeTicks::Now();
   std::vector<SBPrefix> prefixes;
   prefixes.reserve(add_prefixes.size());
   for (SBAddPrefixes::const_iterator iter = add_prefixes.begin();
@@ -1343,35 +1577,41 @@ void SafeBrowsingDatabaseNew::UpdateBrowseStore() {
   }
 
   std::sort(prefixes.begin(), prefixes.end());
-  scoped_ptr<safe_browsing::PrefixSet>
-      prefix_set(new safe_browsing::PrefixSet(prefixes));
+  scoped_refptr<BrowseFilter> filter(new BrowseFilter);
+  filter->prefix_set.reset(new safe_browsing::PrefixSet(prefixes));
 
   // This needs to be in sorted order by prefix for efficient access.
   std::sort(add_full_hashes.begin(), add_full_hashes.end(),
             SBAddFullHashPrefixLess);
+  filter->full_hashes.swap(add_full_hashes);
+
+  SafeBrowsingUpdateProfiler* profiler =
+      SafeBrowsingUpdateProfiler::GetInstance();
+  const std::string source = browse_filename_.BaseName().AsUTF8Unsafe();
+  const base::TimeTicks swap_start = base::TimeTicks::Now();
+  profiler->RecordPhase(SafeBrowsingUpdateProfiler::PHASE_BUILD_PREFIX_SET,
+                        source, swap_start - build_start,
+                        prefixes.size() * sizeof(SBPrefix));
 
   // Swap in the newly built filter and cache.
   {
-    base::AutoLock locked(lookup_lock_);
-    full_browse_hashes_.swap(add_full_hashes);
-
     // TODO(shess): If |CacheHashResults()| is posted between the
-    // earlier lock and this clear, those pending hashes will be lost.
+    // earlier snapshot and this one, those pending hashes will be lost.
     // It could be fixed by only removing hashes which were collected
     // at the earlier point.  I believe that is fail-safe as-is (the
     // hash will be fetched again).
-    pending_browse_hashes_.clear();
-    prefix_miss_cache_.clear();
-    browse_prefix_set_.swap(prefix_set);
+    base::AutoLock locked(browse_writer_lock_);
+    PublishBrowseSnapshot(new BrowseSnapshot(filter.get()));
   }
+  profiler->RecordPhase(SafeBrowsingUpdateProfiler::PHASE_SWAP, source,
+                        base::TimeTicks::Now() - swap_start, 0);
 
   DVLOG(1) << "SafeBrowsingDatabaseImpl built prefix set in "
            << (base::TimeTicks::Now() - before).InMilliseconds()
            << " ms total.  prefix count: " << add_prefixes.size();
   UMA_HISTOGRAM_LONG_TIMES("SB2.BuildFilter", base::TimeTicks::Now() - before);
 
-  // Persist the prefix set to disk.  Since only this thread changes
-  // |browse_prefix_set_|, there is no need to lock.
+  // Persist the prefix set to disk.
   WritePrefixSet();
 
   // Gather statistics.
@@ -1438,6 +1678,10 @@ void SafeBrowsingDatabaseNew::UpdateSideEffectFreeWhitelistStore() {
     side_effect_free_whitelist_prefix_set_.swap(prefix_set);
   }
 
+  // The old set may be reading in place from the file which is about
+  // to be rewritten.
+  prefix_set.reset();
+
   const base::TimeTicks before = base::TimeTicks::Now();
   const bool write_ok = side_effect_free_whitelist_prefix_set_->WriteFile(
       side_effect_free_whitelist_prefix_set_filename_);
@@ -1502,14 +1746,20 @@ void SafeBrowsingDatabaseNew::LoadPrefixSet() {
   base::DeleteFile(bloom_filter_filename, false);
 
   const base::TimeTicks before = base::TimeTicks::Now();
-  browse_prefix_set_.reset(safe_browsing::PrefixSet::LoadFile(
+  scoped_refptr<BrowseFilter> filter(new BrowseFilter);
+  filter->prefix_set.reset(safe_browsing::PrefixSet::LoadFile(
       browse_prefix_set_filename_));
   DVLOG(1) << "SafeBrowsingDatabaseNew read prefix set in "
            << (base::TimeTicks::Now() - before).InMilliseconds() << " ms";
   UMA_HISTOGRAM_TIMES("SB2.PrefixSetLoad", base::TimeTicks::Now() - before);
 
-  if (!browse_prefix_set_.get())
+  if (!filter->prefix_set.get()) {
     RecordFailure(FAILURE_BROWSE_PREFIX_SET_READ);
+    return;
+  }
+
+  base::AutoLock locked(browse_writer_lock_);
+  PublishBrowseSnapshot(new BrowseSnapshot(filter.get()));
 }
 
 bool SafeBrowsingDatabaseNew::Delete() {
@@ -1564,18 +1814,32 @@ bool SafeBrowsingDatabaseNew::Delete() {
 void SafeBrowsingDatabaseNew::WritePrefixSet() {
   DCHECK_EQ(creation_loop_, base::MessageLoop::current());
 
-  if (!browse_prefix_set_.get())
+  const scoped_refptr<const BrowseSnapshot> snapshot = GetBrowseSnapshot();
+  const safe_browsing::PrefixSet* prefix_set =
+      snapshot->filter->prefix_set.get();
+  if (!prefix_set)
     return;
 
+  // A lookup may still be reading a snapshot whose set is mapped from
+  // the current file, so the file is replaced rather than rewritten.
   const base::TimeTicks before = base::TimeTicks::Now();
-  const bool write_ok = browse_prefix_set_->WriteFile(
-      browse_prefix_set_filename_);
+  const base::FilePath new_filename =
+      browse_prefix_set_filename_.AddExtension(FILE_PATH_LITERAL("new"));
+  const bool write_ok = prefix_set->WriteFile(new_filename) &&
+      base::Move(new_filename, browse_prefix_set_filename_);
+  const base::TimeDelta write_time = base::TimeTicks::Now() - before;
   DVLOG(1) << "SafeBrowsingDatabaseNew wrote prefix set in "
-           << (base::TimeTicks::Now() - before).InMilliseconds() << " ms";
-  UMA_HISTOGRAM_TIMES("SB2.PrefixSetWrite", base::TimeTicks::Now() - before);
-
-  if (!write_ok)
+           << write_time.InMilliseconds() << " ms";
+  UMA_HISTOGRAM_TIMES("SB2.PrefixSetWrite", write_time);
+  SafeBrowsingUpdateProfiler::GetInstance()->RecordPhase(
+      SafeBrowsingUpdateProfiler::PHASE_WRITE,
+      browse_prefix_set_filename_.BaseName().AsUTF8Unsafe(), write_time,
+      write_ok ? GetFileSizeOrZero(browse_prefix_set_filename_) : 0);
+
+  if (!write_ok) {
     RecordFailure(FAILURE_BROWSE_PREFIX_SET_WRITE);
+    base::DeleteFile(new_filename, false);
+  }
 
 #if defined(OS_MACOSX)
   base::mac::SetFileBackupExclusion(browse_prefix_set_filename_);
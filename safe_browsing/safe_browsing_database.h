@@ -11,6 +11,7 @@
 
 #include "base/files/file_path.h"
 #include "base/gtest_prod_util.h"
+#include "base/memory/ref_counted.h"
 #include "base/memory/scoped_ptr.h"
 #include "base/memory/weak_ptr.h"
 #include "base/synchronization/lock.h"
@@ -98,6 +99,16 @@ class SafeBrowsingDatabase {
                                  std::vector<SBFullHashResult>* full_hits,
                                  base::Time last_update) = 0;
 
+  // Returns false if none of |urls| are in the browse database.  If it
+  // returns true, |prefix_hits| holds the sorted and unique matching hash
+  // prefixes of all the URLs, and |full_hits| the cached full hashes for
+  // them.  This function is safe to call from threads other than the
+  // creation thread.  The default implementation checks one URL at a time.
+  virtual bool ContainsBrowseUrls(const std::vector<GURL>& urls,
+                                  std::vector<SBPrefix>* prefix_hits,
+                                  std::vector<SBFullHashResult>* full_hits,
+                                  base::Time last_update);
+
   // Returns false if none of |urls| are in Download database. If it returns
   // true, |prefix_hits| should contain the prefixes for the URLs that were in
   // the database.  This function could ONLY be accessed from creation thread.
@@ -160,6 +171,13 @@ class SafeBrowsingDatabase {
   virtual bool UpdateStarted(std::vector<SBListChunkRanges>* lists) = 0;
   virtual void InsertChunks(const std::string& list_name,
                             const SBChunkList& chunks) = 0;
+
+  // Like |InsertChunks()|, for a chunk response which has not been parsed.
+  // |chunk_data| must have been checked by
+  // |SafeBrowsingProtocolParser::VisitChunks()|.  The default implementation
+  // parses it into an SBChunkList.
+  virtual void InsertChunkData(const std::string& list_name,
+                               const std::string& chunk_data);
   virtual void DeleteChunks(
       const std::vector<SBChunkDelete>& chunk_deletes) = 0;
   virtual void UpdateFinished(bool update_succeeded) = 0;
@@ -280,6 +298,10 @@ class SafeBrowsingDatabaseNew : public SafeBrowsingDatabase {
                                  std::vector<SBPrefix>* prefix_hits,
                                  std::vector<SBFullHashResult>* full_hits,
                                  base::Time last_update) OVERRIDE;
+  virtual bool ContainsBrowseUrls(const std::vector<GURL>& urls,
+                                  std::vector<SBPrefix>* prefix_hits,
+                                  std::vector<SBFullHashResult>* full_hits,
+                                  base::Time last_update) OVERRIDE;
   virtual bool ContainsDownloadUrl(const std::vector<GURL>& urls,
                                    std::vector<SBPrefix>* prefix_hits) OVERRIDE;
   virtual bool ContainsDownloadHashPrefix(const SBPrefix& prefix) OVERRIDE;
@@ -294,6 +316,8 @@ class SafeBrowsingDatabaseNew : public SafeBrowsingDatabase {
   virtual bool UpdateStarted(std::vector<SBListChunkRanges>* lists) OVERRIDE;
   virtual void InsertChunks(const std::string& list_name,
                             const SBChunkList& chunks) OVERRIDE;
+  virtual void InsertChunkData(const std::string& list_name,
+                               const std::string& chunk_data) OVERRIDE;
   virtual void DeleteChunks(
       const std::vector<SBChunkDelete>& chunk_deletes) OVERRIDE;
   virtual void UpdateFinished(bool update_succeeded) OVERRIDE;
@@ -307,12 +331,77 @@ class SafeBrowsingDatabaseNew : public SafeBrowsingDatabase {
  private:
   friend class SafeBrowsingDatabaseTest;
   FRIEND_TEST_ALL_PREFIXES(SafeBrowsingDatabaseTest, HashCaching);
+  FRIEND_TEST_ALL_PREFIXES(SafeBrowsingDatabaseTest, BrowseSnapshot);
 
   // A SafeBrowsing whitelist contains a list of whitelisted full-hashes (stored
   // in a sorted vector) as well as a boolean flag indicating whether all
   // lookups in the whitelist should be considered matches for safety.
   typedef std::pair<std::vector<SBFullHash>, bool> SBWhitelist;
 
+  // The filter and full hashes built by an update of the browse store,
+  // shared by the snapshots taken until the next update.
+  struct BrowseFilter : public base::RefCountedThreadSafe<BrowseFilter> {
+    BrowseFilter();
+
+    // NULL until it is either read from disk, or the first update
+    // populates it.
+    scoped_ptr<safe_browsing::PrefixSet> prefix_set;
+
+    // Items from |browse_store_|, ordered by prefix for efficient
+    // scanning.
+    std::vector<SBAddFullHash> full_hashes;
+
+   private:
+    friend class base::RefCountedThreadSafe<BrowseFilter>;
+    ~BrowseFilter();
+
+    DISALLOW_COPY_AND_ASSIGN(BrowseFilter);
+  };
+
+  // Everything that |ContainsBrowseUrl()| reads.  A snapshot is never
+  // changed once it is published.  Updates and |CacheHashResults()|
+  // publish a changed copy instead, so that lookups only hold
+  // |lookup_lock_| while taking a reference to the current snapshot.
+  struct BrowseSnapshot : public base::RefCountedThreadSafe<BrowseSnapshot> {
+    explicit BrowseSnapshot(const BrowseFilter* browse_filter);
+
+    // Returns a copy sharing |filter|, to be changed and published.
+    BrowseSnapshot* Copy() const;
+
+    // Never NULL.
+    scoped_refptr<const BrowseFilter> filter;
+
+    // Items from |CacheHashResults()|, which will be pushed to the
+    // store on the next update.  Ordered by prefix.
+    std::vector<SBAddFullHash> pending_hashes;
+
+    // Cache of prefixes that returned empty results (no full hash
+    // match) to |CacheHashResults()|.  Cached to prevent asking for
+    // them every time.  Cleared on next update.
+    std::set<SBPrefix> prefix_misses;
+
+   private:
+    friend class base::RefCountedThreadSafe<BrowseSnapshot>;
+    ~BrowseSnapshot();
+
+    DISALLOW_COPY_AND_ASSIGN(BrowseSnapshot);
+  };
+
+  // Appends to |prefix_hits| the prefixes of |url| which are in the
+  // filter of |snapshot|.  Returns false, leaving |prefix_hits| alone, if
+  // there are none or all of them are cached misses.
+  static bool GetBrowsePrefixHits(const BrowseSnapshot& snapshot,
+                                  const GURL& url,
+                                  std::vector<SBPrefix>* prefix_hits);
+
+  // Returns the current browse snapshot.  Can be called on any thread.
+  scoped_refptr<const BrowseSnapshot> GetBrowseSnapshot();
+
+  // Makes |snapshot| the one seen by lookups.  Callers hold
+  // |browse_writer_lock_| from taking the snapshot they changed until
+  // publishing it, so that concurrent changes are not lost.
+  void PublishBrowseSnapshot(const BrowseSnapshot* snapshot);
+
   // Returns true if the whitelist is disabled or if any of the given hashes
   // matches the whitelist.
   bool ContainsWhitelistedHashes(const SBWhitelist& whitelist,
@@ -374,10 +463,15 @@ class SafeBrowsingDatabaseNew : public SafeBrowsingDatabase {
   base::MessageLoop* creation_loop_;
 
   // Lock for protecting access to variables that may be used on the
-  // IO thread.  This includes |prefix_set_|, |full_browse_hashes_|,
-  // |pending_browse_hashes_|, |prefix_miss_cache_|, |csd_whitelist_|.
+  // IO thread.  This includes |browse_snapshot_|, |csd_whitelist_|,
+  // |download_whitelist_| and |side_effect_free_whitelist_prefix_set_|.
   base::Lock lookup_lock_;
 
+  // Serializes the changes to |browse_snapshot_|, which are made on
+  // both the IO thread and the safe browsing thread.  Lookups never
+  // take it.
+  base::Lock browse_writer_lock_;
+
   // Underlying persistent store for chunk data.
   // For browsing related (phishing and malware URLs) chunks and prefixes.
   base::FilePath browse_filename_;
@@ -409,18 +503,8 @@ class SafeBrowsingDatabaseNew : public SafeBrowsingDatabase {
   SBWhitelist download_whitelist_;
   SBWhitelist extension_blacklist_;
 
-  // Cached browse store related full-hash items, ordered by prefix for
-  // efficient scanning.
-  // |full_browse_hashes_| are items from |browse_store_|,
-  // |pending_browse_hashes_| are items from |CacheHashResults()|, which
-  // will be pushed to the store on the next update.
-  std::vector<SBAddFullHash> full_browse_hashes_;
-  std::vector<SBAddFullHash> pending_browse_hashes_;
-
-  // Cache of prefixes that returned empty results (no full hash
-  // match) to |CacheHashResults()|.  Cached to prevent asking for
-  // them every time.  Cleared on next update.
-  std::set<SBPrefix> prefix_miss_cache_;
+  // The browse list's filter and caches, never NULL.
+  scoped_refptr<const BrowseSnapshot> browse_snapshot_;
 
   // Used to schedule resetting the database because of corruption.
   base::WeakPtrFactory<SafeBrowsingDatabaseNew> reset_factory_;
@@ -434,9 +518,8 @@ class SafeBrowsingDatabaseNew : public SafeBrowsingDatabase {
   // Used to optimize away database update.
   bool change_detected_;
 
-  // Used to check if a prefix was in the browse database.
+  // Where the prefix set of |browse_snapshot_| is saved.
   base::FilePath browse_prefix_set_filename_;
-  scoped_ptr<safe_browsing::PrefixSet> browse_prefix_set_;
 
   // Used to check if a prefix was in the browse database.
   base::FilePath side_effect_free_whitelist_prefix_set_filename_;
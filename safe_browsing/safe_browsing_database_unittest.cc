@@ -4,11 +4,16 @@
 //
 // Unit tests for the SafeBrowsing storage system.
 
+#include <algorithm>
+
 #include "base/file_util.h"
 #include "base/files/scoped_temp_dir.h"
 #include "base/logging.h"
 #include "base/message_loop/message_loop.h"
+#include "base/strings/stringprintf.h"
+#include "base/sys_byteorder.h"
 #include "base/time/time.h"
+#include "chrome/browser/safe_browsing/prefix_set.h"
 #include "chrome/browser/safe_browsing/safe_browsing_database.h"
 #include "chrome/browser/safe_browsing/safe_browsing_store_file.h"
 #include "chrome/browser/safe_browsing/safe_browsing_store_unittest_helper.h"
@@ -36,6 +41,12 @@ SBFullHash Sha256Hash(const std::string& str) {
   return hash;
 }
 
+// Appends the bytes of |value| to |data|, as they are in a chunk response.
+template <class T>
+void AppendChunkData(std::string* data, const T& value) {
+  data->append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
 // Same as InsertAddChunkHostPrefixUrl, but with pre-computed
 // prefix values.
 void InsertAddChunkHostPrefixValue(SBChunk* chunk,
@@ -852,7 +863,7 @@ TEST_F(SafeBrowsingDatabaseTest, HashCaching) {
   PopulateDatabaseForCacheTest();
 
   // We should have both full hashes in the cache.
-  EXPECT_EQ(database_->pending_browse_hashes_.size(), 2U);
+  EXPECT_EQ(database_->browse_snapshot_->pending_hashes.size(), 2U);
 
   // Test the cache lookup for the first prefix.
   std::string listname;
@@ -918,8 +929,8 @@ TEST_F(SafeBrowsingDatabaseTest, HashCaching) {
       GURL("http://www.evil.com/malware.html"),
       &listname, &prefixes, &full_hashes, Time::Now());
   EXPECT_TRUE(full_hashes.empty());
-  EXPECT_TRUE(database_->full_browse_hashes_.empty());
-  EXPECT_TRUE(database_->pending_browse_hashes_.empty());
+  EXPECT_TRUE(database_->browse_snapshot_->filter->full_hashes.empty());
+  EXPECT_TRUE(database_->browse_snapshot_->pending_hashes.empty());
 
   prefixes.clear();
   full_hashes.clear();
@@ -929,7 +940,9 @@ TEST_F(SafeBrowsingDatabaseTest, HashCaching) {
   // cache insert uses Time::Now(). First, store some entries.
   PopulateDatabaseForCacheTest();
 
-  std::vector<SBAddFullHash>* hash_cache = &database_->pending_browse_hashes_;
+  scoped_refptr<SafeBrowsingDatabaseNew::BrowseSnapshot> snapshot(
+      database_->browse_snapshot_->Copy());
+  std::vector<SBAddFullHash>* hash_cache = &snapshot->pending_hashes;
   EXPECT_EQ(hash_cache->size(), 2U);
 
   // Now adjust one of the entries times to be in the past.
@@ -943,6 +956,10 @@ TEST_F(SafeBrowsingDatabaseTest, HashCaching) {
     }
   }
   EXPECT_TRUE(iter != hash_cache->end());
+  {
+    base::AutoLock locked(database_->browse_writer_lock_);
+    database_->PublishBrowseSnapshot(snapshot.get());
+  }
 
   database_->ContainsBrowseUrl(
       GURL("http://www.evil.com/malware.html"),
@@ -970,13 +987,13 @@ TEST_F(SafeBrowsingDatabaseTest, HashCaching) {
   database_->CacheHashResults(prefix_misses, empty_full_hash);
 
   // Prefixes with no full results are misses.
-  EXPECT_EQ(database_->prefix_miss_cache_.size(), 2U);
+  EXPECT_EQ(database_->browse_snapshot_->prefix_misses.size(), 2U);
 
   // Update the database.
   PopulateDatabaseForCacheTest();
 
   // Prefix miss cache should be cleared.
-  EXPECT_TRUE(database_->prefix_miss_cache_.empty());
+  EXPECT_TRUE(database_->browse_snapshot_->prefix_misses.empty());
 
   // Cache a GetHash miss for a particular prefix, and even though the prefix is
   // in the database, it is flagged as a miss so looking up the associated URL
@@ -1687,3 +1704,163 @@ TEST_F(SafeBrowsingDatabaseTest, FilterFile) {
       GURL("http://www.good.com/goodware.html"),
       &matching_list, &prefix_hits, &full_hashes, now));
 }
+
+// A lookup's snapshot keeps the filter and caches it was taken with,
+// while updates and cached results publish new ones.
+TEST_F(SafeBrowsingDatabaseTest, BrowseSnapshot) {
+  PopulateDatabaseForCacheTest();
+  const SBPrefix phishing_prefix = Sha256Prefix("www.evil.com/phishing.html");
+
+  scoped_refptr<const SafeBrowsingDatabaseNew::BrowseSnapshot> snapshot =
+      database_->GetBrowseSnapshot();
+  ASSERT_TRUE(snapshot->filter->prefix_set.get());
+  EXPECT_TRUE(snapshot->filter->prefix_set->Exists(phishing_prefix));
+  EXPECT_EQ(2U, snapshot->pending_hashes.size());
+
+  // Caching a miss publishes a copy sharing the filter.
+  std::vector<SBPrefix> prefix_misses(1, phishing_prefix);
+  database_->CacheHashResults(prefix_misses,
+                              std::vector<SBFullHashResult>());
+  scoped_refptr<const SafeBrowsingDatabaseNew::BrowseSnapshot> cached =
+      database_->GetBrowseSnapshot();
+  EXPECT_NE(snapshot.get(), cached.get());
+  EXPECT_EQ(snapshot->filter.get(), cached->filter.get());
+  EXPECT_TRUE(snapshot->prefix_misses.empty());
+  EXPECT_EQ(1U, cached->prefix_misses.count(phishing_prefix));
+  EXPECT_EQ(2U, cached->pending_hashes.size());
+
+  // Deleting the chunk publishes a new filter, and leaves the old one
+  // to the snapshots still holding it.
+  std::vector<SBListChunkRanges> lists;
+  EXPECT_TRUE(database_->UpdateStarted(&lists));
+  AddDelChunk(safe_browsing_util::kMalwareList, 1);
+  database_->UpdateFinished(true);
+  scoped_refptr<const SafeBrowsingDatabaseNew::BrowseSnapshot> updated =
+      database_->GetBrowseSnapshot();
+  EXPECT_NE(cached->filter.get(), updated->filter.get());
+  EXPECT_FALSE(updated->filter->prefix_set->Exists(phishing_prefix));
+  EXPECT_TRUE(updated->pending_hashes.empty());
+  EXPECT_TRUE(updated->prefix_misses.empty());
+  EXPECT_TRUE(snapshot->filter->prefix_set->Exists(phishing_prefix));
+  EXPECT_EQ(2U, snapshot->pending_hashes.size());
+}
+
+// A batch of URLs is checked against one snapshot, returning the hits of
+// all of them.
+TEST_F(SafeBrowsingDatabaseTest, ContainsBrowseUrls) {
+  // A prefix without a cached full hash, then two with.
+  SBChunkList chunks;
+  SBChunk chunk;
+  InsertAddChunkHostPrefixUrl(&chunk, 2, "www.bad.com/",
+                              "www.bad.com/bad.html");
+  chunks.push_back(chunk);
+  std::vector<SBListChunkRanges> lists;
+  EXPECT_TRUE(database_->UpdateStarted(&lists));
+  database_->InsertChunks(safe_browsing_util::kMalwareList, chunks);
+  database_->UpdateFinished(true);
+  PopulateDatabaseForCacheTest();
+
+  std::vector<GURL> urls;
+  urls.push_back(GURL("http://www.evil.com/phishing.html"));
+  urls.push_back(GURL("http://www.good.com/goodware.html"));
+  urls.push_back(GURL("http://www.bad.com/bad.html"));
+  urls.push_back(GURL("http://www.evil.com/phishing.html"));
+
+  std::vector<SBPrefix> prefix_hits;
+  std::vector<SBFullHashResult> full_hits;
+  EXPECT_TRUE(database_->ContainsBrowseUrls(urls, &prefix_hits, &full_hits,
+                                            Time::Now()));
+  std::vector<SBPrefix> expected_prefixes;
+  expected_prefixes.push_back(Sha256Prefix("www.evil.com/phishing.html"));
+  expected_prefixes.push_back(Sha256Prefix("www.bad.com/bad.html"));
+  std::sort(expected_prefixes.begin(), expected_prefixes.end());
+  EXPECT_EQ(expected_prefixes, prefix_hits);
+  ASSERT_EQ(1U, full_hits.size());
+  EXPECT_TRUE(SBFullHashEq(full_hits[0].hash,
+                           Sha256Hash("www.evil.com/phishing.html")));
+
+  // The default implementation checks the URLs one at a time, and finds the
+  // same hits.
+  std::vector<SBPrefix> single_prefix_hits;
+  std::vector<SBFullHashResult> single_full_hits;
+  EXPECT_TRUE(database_->SafeBrowsingDatabase::ContainsBrowseUrls(
+      urls, &single_prefix_hits, &single_full_hits, Time::Now()));
+  EXPECT_EQ(prefix_hits, single_prefix_hits);
+  EXPECT_EQ(2U, single_full_hits.size());
+
+  // Cached misses and safe URLs don't hit.
+  std::vector<SBPrefix> prefix_misses(1, Sha256Prefix("www.bad.com/bad.html"));
+  database_->CacheHashResults(prefix_misses, std::vector<SBFullHashResult>());
+  urls.erase(urls.begin());
+  urls.pop_back();
+  EXPECT_FALSE(database_->ContainsBrowseUrls(urls, &prefix_hits, &full_hits,
+                                             Time::Now()));
+  EXPECT_TRUE(prefix_hits.empty());
+  EXPECT_TRUE(full_hits.empty());
+}
+
+// Chunk responses handed to the database without being parsed first are
+// written the same way as parsed chunks.
+TEST_F(SafeBrowsingDatabaseTest, InsertChunkData) {
+  const SBPrefix host = Sha256Prefix("www.evil.com/");
+  const SBPrefix malware = Sha256Prefix("www.evil.com/malware.html");
+  const SBPrefix phishing = Sha256Prefix("www.evil.com/phishing.html");
+
+  // Add chunk 1 has both URLs under one host.
+  std::string add_body;
+  AppendChunkData(&add_body, host);
+  add_body.push_back(2);
+  AppendChunkData(&add_body, malware);
+  AppendChunkData(&add_body, phishing);
+  const std::string add_data =
+      base::StringPrintf("a:1:4:%d\n", static_cast<int>(add_body.size())) +
+      add_body;
+
+  std::vector<SBListChunkRanges> lists;
+  EXPECT_TRUE(database_->UpdateStarted(&lists));
+  database_->InsertChunkData(safe_browsing_util::kMalwareList, add_data);
+  database_->UpdateFinished(true);
+
+  std::string matching_list;
+  std::vector<SBPrefix> prefix_hits;
+  std::vector<SBFullHashResult> full_hashes;
+  const Time now = Time::Now();
+  EXPECT_TRUE(database_->ContainsBrowseUrl(
+      GURL("http://www.evil.com/malware.html"),
+      &matching_list, &prefix_hits, &full_hashes, now));
+  EXPECT_TRUE(database_->ContainsBrowseUrl(
+      GURL("http://www.evil.com/phishing.html"),
+      &matching_list, &prefix_hits, &full_hashes, now));
+
+  // Sub chunk 2 removes the phishing URL.  Add chunk 1 is sent again, as it
+  // can be when part of a range, and is not added twice.
+  std::string sub_body;
+  AppendChunkData(&sub_body, host);
+  sub_body.push_back(1);
+  AppendChunkData(&sub_body, base::HostToNet32(1));
+  AppendChunkData(&sub_body, phishing);
+  const std::string sub_data =
+      base::StringPrintf("s:2:4:%d\n", static_cast<int>(sub_body.size())) +
+      sub_body;
+
+  EXPECT_TRUE(database_->UpdateStarted(&lists));
+  ASSERT_FALSE(lists.empty());
+  EXPECT_TRUE(lists[0].name == safe_browsing_util::kMalwareList);
+  EXPECT_EQ(lists[0].adds, "1");
+  database_->InsertChunkData(safe_browsing_util::kMalwareList, add_data);
+  database_->InsertChunkData(safe_browsing_util::kMalwareList, sub_data);
+  database_->UpdateFinished(true);
+
+  EXPECT_TRUE(database_->ContainsBrowseUrl(
+      GURL("http://www.evil.com/malware.html"),
+      &matching_list, &prefix_hits, &full_hashes, now));
+  EXPECT_FALSE(database_->ContainsBrowseUrl(
+      GURL("http://www.evil.com/phishing.html"),
+      &matching_list, &prefix_hits, &full_hashes, now));
+
+  EXPECT_TRUE(database_->UpdateStarted(&lists));
+  ASSERT_FALSE(lists.empty());
+  EXPECT_EQ(lists[0].adds, "1");
+  EXPECT_EQ(lists[0].subs, "2");
+  database_->UpdateFinished(true);
+}
@@ -6,6 +6,7 @@
 
 #include "base/md5.h"
 #include "base/metrics/histogram.h"
+#include "chrome/browser/safe_browsing/update_profiler.h"
 
 namespace {
 
@@ -28,6 +29,30 @@ struct ChunkHeader {
   uint32 add_hash_count, sub_hash_count;
 };
 
+// NOTE: kLogMagic should not be a byte-wise palindrome either.
+const int32 kLogMagic = 0x106F11E5;
+const int32 kLogVersion = 1;
+
+// Header at the front of the update log.
+struct LogHeader {
+  int32 magic, version;
+  base::MD5Digest main_checksum;
+};
+
+// Header for each segment of the update log.
+struct SegmentHeader {
+  uint32 add_chunk_count, sub_chunk_count;
+  uint32 add_prefix_count, sub_prefix_count;
+  uint32 add_hash_count, sub_hash_count;
+};
+
+// The main file is rewritten once the update log holds this many
+// segments, or once it is more than a quarter of the main file's size.
+// Reading the log costs about as much as reading the main file's data
+// it adds to, so this bounds the extra work done by each update.
+const int kMaxLogSegments = 16;
+const int64 kMaxLogFraction = 4;
+
 // Rewind the file.  Using fseek(2) because rewind(3) errors are
 // weird.
 bool FileRewind(FILE* fp) {
@@ -118,6 +143,218 @@ bool WriteContainer(const CT& values, FILE* fp,
   return true;
 }
 
+// Read the prefix and hash arrays described by |header| from |fp|,
+// appending them to the containers and folding them into the checksum
+// in |context|, if non-NULL.  Returns true on success.
+template <class HeaderT>
+bool ReadPrefixesAndHashes(const HeaderT& header, FILE* fp,
+                           base::MD5Context* context,
+                           SBAddPrefixes* add_prefixes,
+                           SBSubPrefixes* sub_prefixes,
+                           std::vector<SBAddFullHash>* add_full_hashes,
+                           std::vector<SBSubFullHash>* sub_full_hashes) {
+  return ReadToContainer(add_prefixes, header.add_prefix_count,
+                         fp, context) &&
+      ReadToContainer(sub_prefixes, header.sub_prefix_count, fp, context) &&
+      ReadToContainer(add_full_hashes, header.add_hash_count,
+                      fp, context) &&
+      ReadToContainer(sub_full_hashes, header.sub_hash_count, fp, context);
+}
+
+// Write the prefix and hash arrays to |fp|, folding them into the
+// checksum in |context|, if non-NULL.  Returns true on success.
+bool WritePrefixesAndHashes(const SBAddPrefixes& add_prefixes,
+                            const SBSubPrefixes& sub_prefixes,
+                            const std::vector<SBAddFullHash>& add_full_hashes,
+                            const std::vector<SBSubFullHash>& sub_full_hashes,
+                            FILE* fp, base::MD5Context* context) {
+  return WriteContainer(add_prefixes, fp, context) &&
+      WriteContainer(sub_prefixes, fp, context) &&
+      WriteContainer(add_full_hashes, fp, context) &&
+      WriteContainer(sub_full_hashes, fp, context);
+}
+
+// Returns the size of the segment described by |header|, including its
+// checksum.
+int64 SegmentSize(const SegmentHeader& header) {
+  int64 size = sizeof(SegmentHeader);
+  size += header.add_chunk_count * static_cast<int64>(sizeof(int32));
+  size += header.sub_chunk_count * static_cast<int64>(sizeof(int32));
+  size += header.add_prefix_count * static_cast<int64>(sizeof(SBAddPrefix));
+  size += header.sub_prefix_count * static_cast<int64>(sizeof(SBSubPrefix));
+  size += header.add_hash_count * static_cast<int64>(sizeof(SBAddFullHash));
+  size += header.sub_hash_count * static_cast<int64>(sizeof(SBSubFullHash));
+  size += sizeof(base::MD5Digest);
+  return size;
+}
+
+// Read the checksum at the end of the main file |fp|, leaving the read
+// pointer at the end of the file.
+bool ReadMainChecksum(FILE* fp, base::MD5Digest* digest) {
+  const long offset = -static_cast<long>(sizeof(*digest));
+  if (fseek(fp, offset, SEEK_END) != 0)
+    return false;
+  return ReadItem(digest, fp, NULL);
+}
+
+// Read the segments of the update log |log_filename|, appending their
+// chunks and data to the containers.  Nothing is read unless the log
+// was written for the main file whose checksum is |main_checksum|.
+// Reading stops at the first segment which is cut short or does not
+// check out, which happens if the browser goes down while appending.
+// Returns the number of segments read, with the size of the log up to
+// the end of the last of them in |*log_size|, which is 0 if there is
+// no usable log to append to.
+int ReadUpdateLog(const base::FilePath& log_filename,
+                  const base::MD5Digest& main_checksum,
+                  std::set<int32>* add_chunks,
+                  std::set<int32>* sub_chunks,
+                  SBAddPrefixes* add_prefixes,
+                  SBSubPrefixes* sub_prefixes,
+                  std::vector<SBAddFullHash>* add_full_hashes,
+                  std::vector<SBSubFullHash>* sub_full_hashes,
+                  int64* log_size) {
+  *log_size = 0;
+
+  file_util::ScopedFILE file(file_util::OpenFile(log_filename, "rb"));
+  if (file.get() == NULL)
+    return 0;
+
+  int64 file_size = 0;
+  if (!file_util::GetFileSize(log_filename, &file_size))
+    return 0;
+
+  LogHeader header;
+  if (!ReadItem(&header, file.get(), NULL) ||
+      header.magic != kLogMagic || header.version != kLogVersion ||
+      0 != memcmp(&header.main_checksum, &main_checksum,
+                  sizeof(main_checksum))) {
+    return 0;
+  }
+  *log_size = sizeof(header);
+
+  int segment_count = 0;
+  while (*log_size < file_size) {
+    base::MD5Context context;
+    base::MD5Init(&context);
+
+    SegmentHeader segment;
+    if (!ReadItem(&segment, file.get(), &context) ||
+        *log_size + SegmentSize(segment) > file_size) {
+      break;
+    }
+
+    // Only keep the segment's data once it checks out.
+    std::set<int32> segment_add_chunks;
+    std::set<int32> segment_sub_chunks;
+    SBAddPrefixes segment_add_prefixes;
+    SBSubPrefixes segment_sub_prefixes;
+    std::vector<SBAddFullHash> segment_add_full_hashes;
+    std::vector<SBSubFullHash> segment_sub_full_hashes;
+    if (!ReadToContainer(&segment_add_chunks, segment.add_chunk_count,
+                         file.get(), &context) ||
+        !ReadToContainer(&segment_sub_chunks, segment.sub_chunk_count,
+                         file.get(), &context) ||
+        !ReadPrefixesAndHashes(segment, file.get(), &context,
+                               &segment_add_prefixes,
+                               &segment_sub_prefixes,
+                               &segment_add_full_hashes,
+                               &segment_sub_full_hashes)) {
+      break;
+    }
+
+    base::MD5Digest calculated_digest;
+    base::MD5Final(&calculated_digest, &context);
+    base::MD5Digest file_digest;
+    if (!ReadItem(&file_digest, file.get(), NULL) ||
+        0 != memcmp(&file_digest, &calculated_digest, sizeof(file_digest))) {
+      break;
+    }
+
+    add_chunks->insert(segment_add_chunks.begin(), segment_add_chunks.end());
+    sub_chunks->insert(segment_sub_chunks.begin(), segment_sub_chunks.end());
+    add_prefixes->insert(add_prefixes->end(), segment_add_prefixes.begin(),
+                         segment_add_prefixes.end());
+    sub_prefixes->insert(sub_prefixes->end(), segment_sub_prefixes.begin(),
+                         segment_sub_prefixes.end());
+    add_full_hashes->insert(add_full_hashes->end(),
+                            segment_add_full_hashes.begin(),
+                            segment_add_full_hashes.end());
+    sub_full_hashes->insert(sub_full_hashes->end(),
+                            segment_sub_full_hashes.begin(),
+                            segment_sub_full_hashes.end());
+    *log_size += SegmentSize(segment);
+    ++segment_count;
+  }
+
+  return segment_count;
+}
+
+// Append a segment with the given chunks and data to the update log
+// |log_filename|, after the first |log_size| bytes.  If |log_size| is
+// 0, a new log is started for the main file with the checksum
+// |main_checksum|.  Returns true on success.
+bool AppendUpdateLog(const base::FilePath& log_filename,
+                     const base::MD5Digest& main_checksum,
+                     int64 log_size,
+                     const std::set<int32>& add_chunks,
+                     const std::set<int32>& sub_chunks,
+                     const SBAddPrefixes& add_prefixes,
+                     const SBSubPrefixes& sub_prefixes,
+                     const std::vector<SBAddFullHash>& add_full_hashes,
+                     const std::vector<SBSubFullHash>& sub_full_hashes) {
+  file_util::ScopedFILE file;
+  if (log_size) {
+    file.reset(file_util::OpenFile(log_filename, "rb+"));
+    if (file.get() == NULL ||
+        fseek(file.get(), static_cast<long>(log_size), SEEK_SET) != 0) {
+      return false;
+    }
+  } else {
+    file.reset(file_util::OpenFile(log_filename, "wb"));
+    if (file.get() == NULL)
+      return false;
+
+    LogHeader header;
+    header.magic = kLogMagic;
+    header.version = kLogVersion;
+    header.main_checksum = main_checksum;
+    if (!WriteItem(header, file.get(), NULL))
+      return false;
+  }
+
+  base::MD5Context context;
+  base::MD5Init(&context);
+
+  SegmentHeader segment;
+  segment.add_chunk_count = add_chunks.size();
+  segment.sub_chunk_count = sub_chunks.size();
+  segment.add_prefix_count = add_prefixes.size();
+  segment.sub_prefix_count = sub_prefixes.size();
+  segment.add_hash_count = add_full_hashes.size();
+  segment.sub_hash_count = sub_full_hashes.size();
+  if (!WriteItem(segment, file.get(), &context) ||
+      !WriteContainer(add_chunks, file.get(), &context) ||
+      !WriteContainer(sub_chunks, file.get(), &context) ||
+      !WritePrefixesAndHashes(add_prefixes, sub_prefixes,
+                              add_full_hashes, sub_full_hashes,
+                              file.get(), &context)) {
+    return false;
+  }
+
+  base::MD5Digest digest;
+  base::MD5Final(&digest, &context);
+  if (!WriteItem(digest, file.get(), NULL))
+    return false;
+
+  // Trim a segment which was cut short by an earlier crash.
+  if (!file_util::TruncateFile(file.get()))
+    return false;
+
+  file.reset();
+  return true;
+}
+
 // Delete the chunks in |deleted| from |chunks|.
 void DeleteChunksFromSet(const base::hash_set<int32>& deleted,
                          std::set<int32>* chunks) {
@@ -292,28 +529,29 @@ bool SafeBrowsingStoreFile::WriteAddPrefix(int32 chunk_id, SBPrefix prefix) {
 bool SafeBrowsingStoreFile::GetAddPrefixes(SBAddPrefixes* add_prefixes) {
   add_prefixes->clear();
 
-  file_util::ScopedFILE file(file_util::OpenFile(filename_, "rb"));
-  if (file.get() == NULL) return false;
-
-  FileHeader header;
-  if (!ReadAndVerifyHeader(filename_, file.get(), &header, NULL))
-    return OnCorruptDatabase();
-
-  size_t add_prefix_offset = header.add_chunk_count * sizeof(int32) +
-      header.sub_chunk_count * sizeof(int32);
-  if (!FileSkip(add_prefix_offset, file.get()))
-    return false;
-
-  if (!ReadToContainer(add_prefixes, header.add_prefix_count, file.get(), NULL))
-    return false;
-
-  return true;
+  SBSubPrefixes sub_prefixes;
+  std::vector<SBAddFullHash> add_full_hashes;
+  std::vector<SBSubFullHash> sub_full_hashes;
+  return ReadStore(add_prefixes, &sub_prefixes,
+                   &add_full_hashes, &sub_full_hashes);
 }
 
 bool SafeBrowsingStoreFile::GetAddFullHashes(
     std::vector<SBAddFullHash>* add_full_hashes) {
   add_full_hashes->clear();
 
+  SBAddPrefixes add_prefixes;
+  SBSubPrefixes sub_prefixes;
+  std::vector<SBSubFullHash> sub_full_hashes;
+  return ReadStore(&add_prefixes, &sub_prefixes,
+                   add_full_hashes, &sub_full_hashes);
+}
+
+bool SafeBrowsingStoreFile::ReadStore(
+    SBAddPrefixes* add_prefixes,
+    SBSubPrefixes* sub_prefixes,
+    std::vector<SBAddFullHash>* add_full_hashes,
+    std::vector<SBSubFullHash>* sub_full_hashes) {
   file_util::ScopedFILE file(file_util::OpenFile(filename_, "rb"));
   if (file.get() == NULL) return false;
 
@@ -321,18 +559,35 @@ bool SafeBrowsingStoreFile::GetAddFullHashes(
   if (!ReadAndVerifyHeader(filename_, file.get(), &header, NULL))
     return OnCorruptDatabase();
 
-  size_t offset =
-      header.add_chunk_count * sizeof(int32) +
-      header.sub_chunk_count * sizeof(int32) +
-      header.add_prefix_count * sizeof(SBAddPrefix) +
-      header.sub_prefix_count * sizeof(SBSubPrefix);
+  size_t offset = header.add_chunk_count * sizeof(int32) +
+      header.sub_chunk_count * sizeof(int32);
   if (!FileSkip(offset, file.get()))
     return false;
 
-  return ReadToContainer(add_full_hashes,
-                         header.add_hash_count,
-                         file.get(),
-                         NULL);
+  if (!ReadPrefixesAndHashes(header, file.get(), NULL, add_prefixes,
+                             sub_prefixes, add_full_hashes,
+                             sub_full_hashes)) {
+    return false;
+  }
+
+  // The main file's data is already netted out, only the update log's
+  // subs still need applying.
+  base::MD5Digest main_checksum;
+  if (!ReadMainChecksum(file.get(), &main_checksum))
+    return false;
+  std::set<int32> add_chunks;
+  std::set<int32> sub_chunks;
+  int64 log_size = 0;
+  if (ReadUpdateLog(UpdateLogForFilename(filename_), main_checksum,
+                    &add_chunks, &sub_chunks, add_prefixes, sub_prefixes,
+                    add_full_hashes, sub_full_hashes, &log_size)) {
+    const base::hash_set<int32> no_deletions;
+    SBProcessSubs(add_prefixes, sub_prefixes,
+                  add_full_hashes, sub_full_hashes,
+                  no_deletions, no_deletions);
+  }
+
+  return true;
 }
 
 bool SafeBrowsingStoreFile::WriteAddHash(int32 chunk_id,
@@ -444,6 +699,21 @@ bool SafeBrowsingStoreFile::BeginUpdate() {
                        file.get(), NULL))
     return OnCorruptDatabase();
 
+  // The chunks in the update log have also been seen.  Its data is
+  // only needed in FinishUpdate().
+  base::MD5Digest main_checksum;
+  if (!ReadMainChecksum(file.get(), &main_checksum))
+    return OnCorruptDatabase();
+  SBAddPrefixes add_prefixes;
+  SBSubPrefixes sub_prefixes;
+  std::vector<SBAddFullHash> add_full_hashes;
+  std::vector<SBSubFullHash> sub_full_hashes;
+  int64 log_size = 0;
+  ReadUpdateLog(UpdateLogForFilename(filename_), main_checksum,
+                &add_chunks_cache_, &sub_chunks_cache_,
+                &add_prefixes, &sub_prefixes,
+                &add_full_hashes, &sub_full_hashes, &log_size);
+
   file_.swap(file);
   new_file_.swap(new_file);
   return true;
@@ -489,6 +759,14 @@ bool SafeBrowsingStoreFile::DoUpdate(
   std::vector<SBAddFullHash> add_full_hashes;
   std::vector<SBSubFullHash> sub_full_hashes;
 
+  // Checksum and size of the main file, which the update log is tied
+  // to, and the size of the valid part of the log.
+  base::MD5Digest main_checksum;
+  memset(&main_checksum, 0, sizeof(main_checksum));
+  int64 main_size = 0;
+  int log_segments = 0;
+  int64 log_size = 0;
+
   // Read original data into the vectors.
   if (!empty_) {
     DCHECK(file_.get());
@@ -513,32 +791,38 @@ bool SafeBrowsingStoreFile::DoUpdate(
                          file_.get(), &context))
       return OnCorruptDatabase();
 
-    if (!ReadToContainer(&add_prefixes, header.add_prefix_count,
-                         file_.get(), &context) ||
-        !ReadToContainer(&sub_prefixes, header.sub_prefix_count,
-                         file_.get(), &context) ||
-        !ReadToContainer(&add_full_hashes, header.add_hash_count,
-                         file_.get(), &context) ||
-        !ReadToContainer(&sub_full_hashes, header.sub_hash_count,
-                         file_.get(), &context))
+    if (!ReadPrefixesAndHashes(header, file_.get(), &context,
+                               &add_prefixes, &sub_prefixes,
+                               &add_full_hashes, &sub_full_hashes))
       return OnCorruptDatabase();
 
     // Calculate the digest to this point.
-    base::MD5Digest calculated_digest;
-    base::MD5Final(&calculated_digest, &context);
+    base::MD5Final(&main_checksum, &context);
 
     // Read the stored checksum and verify it.
     base::MD5Digest file_digest;
     if (!ReadItem(&file_digest, file_.get(), NULL))
       return OnCorruptDatabase();
 
-    if (0 != memcmp(&file_digest, &calculated_digest, sizeof(file_digest))) {
+    if (0 != memcmp(&file_digest, &main_checksum, sizeof(file_digest))) {
       RecordFormatEvent(FORMAT_EVENT_UPDATE_CHECKSUM_FAILURE);
       return OnCorruptDatabase();
     }
 
     // Close the file so we can later rename over it.
     file_.reset();
+
+    if (!file_util::GetFileSize(filename_, &main_size))
+      return OnCorruptDatabase();
+
+    // Merge in the earlier updates.  These were seen in BeginUpdate(),
+    // so again no new chunks should be added to the sets.
+    log_segments = ReadUpdateLog(UpdateLogForFilename(filename_),
+                                 main_checksum,
+                                 &add_chunks_cache_, &sub_chunks_cache_,
+                                 &add_prefixes, &sub_prefixes,
+                                 &add_full_hashes, &sub_full_hashes,
+                                 &log_size);
   }
   DCHECK(!file_.get());
 
@@ -557,7 +841,12 @@ bool SafeBrowsingStoreFile::DoUpdate(
   UMA_HISTOGRAM_COUNTS("SB2.DatabaseUpdateKilobytes",
                        std::max(static_cast<int>(size / 1024), 1));
 
-  // Append the accumulated chunks onto the vectors read from |file_|.
+  // Collect the accumulated chunks, which are kept apart for the
+  // update log.
+  SBAddPrefixes new_add_prefixes;
+  SBSubPrefixes new_sub_prefixes;
+  std::vector<SBAddFullHash> new_add_full_hashes;
+  std::vector<SBSubFullHash> new_sub_full_hashes;
   for (int i = 0; i < chunks_written_; ++i) {
     ChunkHeader header;
 
@@ -578,89 +867,155 @@ bool SafeBrowsingStoreFile::DoUpdate(
     if (expected_size > size)
       return false;
 
-    // TODO(shess): If the vectors were kept sorted, then this code
-    // could use std::inplace_merge() to merge everything together in
-    // sorted order.  That might still be slower than just sorting at
-    // the end if there were a large number of chunks.  In that case
-    // some sort of recursive binary merge might be in order (merge
-    // chunks pairwise, merge those chunks pairwise, and so on, then
-    // merge the result with the main list).
-    if (!ReadToContainer(&add_prefixes, header.add_prefix_count,
-                         new_file_.get(), NULL) ||
-        !ReadToContainer(&sub_prefixes, header.sub_prefix_count,
-                         new_file_.get(), NULL) ||
-        !ReadToContainer(&add_full_hashes, header.add_hash_count,
-                         new_file_.get(), NULL) ||
-        !ReadToContainer(&sub_full_hashes, header.sub_hash_count,
-                         new_file_.get(), NULL))
+    if (!ReadPrefixesAndHashes(header, new_file_.get(), NULL,
+                               &new_add_prefixes, &new_sub_prefixes,
+                               &new_add_full_hashes, &new_sub_full_hashes))
       return false;
   }
 
-  // Append items from |pending_adds|.
+  // Add items from |pending_adds|.
+  new_add_full_hashes.insert(new_add_full_hashes.end(),
+                             pending_adds.begin(), pending_adds.end());
+
+  // Deletes are applied in order with the subs, so an update with
+  // deletes is never logged.  Otherwise the new data is logged unless
+  // the log is getting expensive to read.
+  const bool unchanged =
+      new_add_chunks_.empty() && new_sub_chunks_.empty() &&
+      new_add_prefixes.empty() && new_sub_prefixes.empty() &&
+      new_add_full_hashes.empty() && new_sub_full_hashes.empty();
+  SegmentHeader segment;
+  segment.add_chunk_count = new_add_chunks_.size();
+  segment.sub_chunk_count = new_sub_chunks_.size();
+  segment.add_prefix_count = new_add_prefixes.size();
+  segment.sub_prefix_count = new_sub_prefixes.size();
+  segment.add_hash_count = new_add_full_hashes.size();
+  segment.sub_hash_count = new_sub_full_hashes.size();
+  const bool rewrite =
+      empty_ || !add_del_cache_.empty() || !sub_del_cache_.empty() ||
+      (!unchanged &&
+       (log_segments + 1 > kMaxLogSegments ||
+        (log_size + SegmentSize(segment)) * kMaxLogFraction > main_size));
+  UMA_HISTOGRAM_BOOLEAN("SB2.StoreRewritten", rewrite);
+
+  // Append the accumulated chunks onto the vectors read from |file_|.
+  // TODO(shess): If the vectors were kept sorted, then this code
+  // could use std::inplace_merge() to merge everything together in
+  // sorted order.  That might still be slower than just sorting at
+  // the end if there were a large number of chunks.  In that case
+  // some sort of recursive binary merge might be in order (merge
+  // chunks pairwise, merge those chunks pairwise, and so on, then
+  // merge the result with the main list).
+  add_prefixes.insert(add_prefixes.end(),
+                      new_add_prefixes.begin(), new_add_prefixes.end());
+  sub_prefixes.insert(sub_prefixes.end(),
+                      new_sub_prefixes.begin(), new_sub_prefixes.end());
   add_full_hashes.insert(add_full_hashes.end(),
-                         pending_adds.begin(), pending_adds.end());
+                         new_add_full_hashes.begin(),
+                         new_add_full_hashes.end());
+  sub_full_hashes.insert(sub_full_hashes.end(),
+                         new_sub_full_hashes.begin(),
+                         new_sub_full_hashes.end());
 
   // Check how often a prefix was checked which wasn't in the
   // database.
   SBCheckPrefixMisses(add_prefixes, prefix_misses);
 
   // Knock the subs from the adds and process deleted chunks.
+  SafeBrowsingUpdateProfiler* profiler =
+      SafeBrowsingUpdateProfiler::GetInstance();
+  const std::string source = filename_.BaseName().AsUTF8Unsafe();
+  const base::TimeTicks process_start = base::TimeTicks::Now();
   SBProcessSubs(&add_prefixes, &sub_prefixes,
                 &add_full_hashes, &sub_full_hashes,
                 add_del_cache_, sub_del_cache_);
+  const base::TimeTicks write_start = base::TimeTicks::Now();
+  profiler->RecordPhase(SafeBrowsingUpdateProfiler::PHASE_PROCESS_SUBS,
+                        source, write_start - process_start, 0);
 
-  // We no longer need to track deleted chunks.
-  DeleteChunksFromSet(add_del_cache_, &add_chunks_cache_);
-  DeleteChunksFromSet(sub_del_cache_, &sub_chunks_cache_);
+  int64 bytes_written = 0;
+  const base::FilePath new_filename = TemporaryFileForFilename(filename_);
+  const base::FilePath log_filename = UpdateLogForFilename(filename_);
+  if (!rewrite) {
+    // The main file stays as it is, only the temporary storage goes.
+    new_file_.reset();
+    if (!base::DeleteFile(new_filename, false) &&
+        base::PathExists(new_filename))
+      return false;
 
-  // Write the new data to new_file_.
-  if (!FileRewind(new_file_.get()))
-    return false;
+    if (!unchanged &&
+        !AppendUpdateLog(log_filename, main_checksum, log_size,
+                         new_add_chunks_, new_sub_chunks_,
+                         new_add_prefixes, new_sub_prefixes,
+                         new_add_full_hashes, new_sub_full_hashes))
+      return false;
+    if (!unchanged)
+      bytes_written = SegmentSize(segment);
+  } else {
+    // We no longer need to track deleted chunks.
+    DeleteChunksFromSet(add_del_cache_, &add_chunks_cache_);
+    DeleteChunksFromSet(sub_del_cache_, &sub_chunks_cache_);
+
+    // Write the new data to new_file_.
+    if (!FileRewind(new_file_.get()))
+      return false;
 
-  base::MD5Context context;
-  base::MD5Init(&context);
+    base::MD5Context context;
+    base::MD5Init(&context);
 
-  // Write a file header.
-  FileHeader header;
-  header.magic = kFileMagic;
-  header.version = kFileVersion;
-  header.add_chunk_count = add_chunks_cache_.size();
-  header.sub_chunk_count = sub_chunks_cache_.size();
-  header.add_prefix_count = add_prefixes.size();
-  header.sub_prefix_count = sub_prefixes.size();
-  header.add_hash_count = add_full_hashes.size();
-  header.sub_hash_count = sub_full_hashes.size();
-  if (!WriteItem(header, new_file_.get(), &context))
-    return false;
+    // Write a file header.
+    FileHeader header;
+    header.magic = kFileMagic;
+    header.version = kFileVersion;
+    header.add_chunk_count = add_chunks_cache_.size();
+    header.sub_chunk_count = sub_chunks_cache_.size();
+    header.add_prefix_count = add_prefixes.size();
+    header.sub_prefix_count = sub_prefixes.size();
+    header.add_hash_count = add_full_hashes.size();
+    header.sub_hash_count = sub_full_hashes.size();
+    if (!WriteItem(header, new_file_.get(), &context))
+      return false;
 
-  // Write all the chunk data.
-  if (!WriteContainer(add_chunks_cache_, new_file_.get(), &context) ||
-      !WriteContainer(sub_chunks_cache_, new_file_.get(), &context) ||
-      !WriteContainer(add_prefixes, new_file_.get(), &context) ||
-      !WriteContainer(sub_prefixes, new_file_.get(), &context) ||
-      !WriteContainer(add_full_hashes, new_file_.get(), &context) ||
-      !WriteContainer(sub_full_hashes, new_file_.get(), &context))
-    return false;
+    // Write all the chunk data.
+    if (!WriteContainer(add_chunks_cache_, new_file_.get(), &context) ||
+        !WriteContainer(sub_chunks_cache_, new_file_.get(), &context) ||
+        !WritePrefixesAndHashes(add_prefixes, sub_prefixes,
+                                add_full_hashes, sub_full_hashes,
+                                new_file_.get(), &context))
+      return false;
 
-  // Write the checksum at the end.
-  base::MD5Digest digest;
-  base::MD5Final(&digest, &context);
-  if (!WriteItem(digest, new_file_.get(), NULL))
-    return false;
+    // Write the checksum at the end.
+    base::MD5Digest digest;
+    base::MD5Final(&digest, &context);
+    if (!WriteItem(digest, new_file_.get(), NULL))
+      return false;
 
-  // Trim any excess left over from the temporary chunk data.
-  if (!file_util::TruncateFile(new_file_.get()))
-    return false;
+    // Trim any excess left over from the temporary chunk data.
+    if (!file_util::TruncateFile(new_file_.get()))
+      return false;
+    bytes_written = ftell(new_file_.get());
+
+    // The log's data is in the new file.  Drop the log first, as the
+    // new file can have the same checksum as the old one when the
+    // update deleted everything the log added.  Crashing before the
+    // new file is in place loses the log's chunks, which are fetched
+    // again.
+    new_file_.reset();
+    if (!base::DeleteFile(log_filename, false) &&
+        base::PathExists(log_filename))
+      return false;
 
-  // Close the file handle and swizzle the file into place.
-  new_file_.reset();
-  if (!base::DeleteFile(filename_, false) &&
-      base::PathExists(filename_))
-    return false;
+    // Swizzle the file into place.
+    if (!base::DeleteFile(filename_, false) &&
+        base::PathExists(filename_))
+      return false;
 
-  const base::FilePath new_filename = TemporaryFileForFilename(filename_);
-  if (!base::Move(new_filename, filename_))
-    return false;
+    if (!base::Move(new_filename, filename_))
+      return false;
+  }
+
+  profiler->RecordPhase(SafeBrowsingUpdateProfiler::PHASE_WRITE, source,
+                        base::TimeTicks::Now() - write_start, bytes_written);
 
   // Record counts before swapping to caller.
   UMA_HISTOGRAM_COUNTS("SB2.AddPrefixes", add_prefixes.size());
@@ -700,7 +1055,8 @@ bool SafeBrowsingStoreFile::CancelUpdate() {
 }
 
 void SafeBrowsingStoreFile::SetAddChunk(int32 chunk_id) {
-  add_chunks_cache_.insert(chunk_id);
+  if (add_chunks_cache_.insert(chunk_id).second)
+    new_add_chunks_.insert(chunk_id);
 }
 
 bool SafeBrowsingStoreFile::CheckAddChunk(int32 chunk_id) {
@@ -713,7 +1069,8 @@ void SafeBrowsingStoreFile::GetAddChunks(std::vector<int32>* out) {
 }
 
 void SafeBrowsingStoreFile::SetSubChunk(int32 chunk_id) {
-  sub_chunks_cache_.insert(chunk_id);
+  if (sub_chunks_cache_.insert(chunk_id).second)
+    new_sub_chunks_.insert(chunk_id);
 }
 
 bool SafeBrowsingStoreFile::CheckSubChunk(int32 chunk_id) {
@@ -748,6 +1105,13 @@ bool SafeBrowsingStoreFile::DeleteStore(const base::FilePath& basename) {
     return false;
   }
 
+  const base::FilePath log_filename = UpdateLogForFilename(basename);
+  if (!base::DeleteFile(log_filename, false) &&
+      base::PathExists(log_filename)) {
+    NOTREACHED();
+    return false;
+  }
+
   // With SQLite support gone, one way to get to this code is if the
   // existing file is a SQLite file.  Make sure the journal file is
   // also removed.
@@ -85,17 +85,54 @@
 //   }
 // }
 //
+// Rewriting the main file on every update costs a lot of I/O for what
+// is usually a small change, so most updates are instead appended to
+// an update log next to the main file.  The log starts with a header
+// tying it to the main file it applies to:
+//
+// int32 magic;             // magic number "validating" file
+// int32 version;           // format version
+// MD5Digest main_checksum; // Checksum at the end of the main file.
+//
+// followed by a segment for each update:
+//
+// uint32 add_chunk_count;   // Chunks first seen in the update.
+// uint32 sub_chunk_count;   // Ditto.
+// uint32 add_prefix_count;
+// uint32 sub_prefix_count;
+// uint32 add_hash_count;
+// uint32 sub_hash_count;
+// The same arrays as in the main file, with only the new data.
+// MD5Digest checksum;      // Checksum over the segment.
+//
+// The subs in the log are applied when the store is read.  Since each
+// update nets the subs and adds out in memory, the data returned from
+// FinishUpdate() is the same either way.  Updates which delete chunks
+// are not logged, so that the order of deletes and subs never matters
+// when reading.  The log is deleted before a rewritten main file is
+// moved into place, and should it survive anyway, its checksum no
+// longer matches and it is ignored.  So is a segment which was being
+// appended when the browser went down.  Its chunks are not recorded
+// as seen, so they are fetched again.
+//
 // The overall transaction works like this:
-// - Open the original file to get the chunks-seen data.
+// - Open the original file to get the chunks-seen data, adding the
+//   chunks seen in the update log.
 // - Open a temp file for storing new chunk info.
 // - Write new chunks to the temp file.
 // - When the transaction is finished:
 //   - Read the rest of the original file's data into buffers.
+//   - Merge the update log's data into buffers.
 //   - Rewind the temp file and merge the new data into buffers.
 //   - Process buffers for deletions and apply subs.
-//   - Rewind and write the buffers out to temp file.
-//   - Delete original file.
-//   - Rename temp file to original filename.
+//   - If the update deleted chunks, or the log has grown too large
+//     (compaction):
+//     - Rewind and write the buffers out to temp file.
+//     - Delete the update log.
+//     - Delete original file.
+//     - Rename temp file to original filename.
+//   - Otherwise, append the new data to the update log and delete the
+//     temp file.
 
 // TODO(shess): By using a checksum, this code can avoid doing an
 // fsync(), at the possible cost of more frequently retrieving the
@@ -163,6 +200,13 @@ class SafeBrowsingStoreFile : public SafeBrowsingStore {
     return base::FilePath(filename.value() + FILE_PATH_LITERAL("_new"));
   }
 
+  // Returns the name of the update log for |filename|.  Exported for
+  // unit tests.
+  static const base::FilePath UpdateLogForFilename(
+      const base::FilePath& filename) {
+    return base::FilePath(filename.value() + FILE_PATH_LITERAL("_log"));
+  }
+
   // Delete any on-disk files, including the permanent storage.
   static bool DeleteStore(const base::FilePath& basename);
 
@@ -222,6 +266,15 @@ class SafeBrowsingStoreFile : public SafeBrowsingStore {
   // Close all files and clear all buffers.
   bool Close();
 
+  // Read all the data of the main file and the update log into the
+  // containers, netting out the subs against the adds.  Returns false
+  // if the data cannot be read, without calling the corruption
+  // callback, which is left to the caller.
+  bool ReadStore(SBAddPrefixes* add_prefixes,
+                 SBSubPrefixes* sub_prefixes,
+                 std::vector<SBAddFullHash>* add_full_hashes,
+                 std::vector<SBSubFullHash>* sub_full_hashes);
+
   // Calls |corruption_callback_| if non-NULL, always returns false as
   // a convenience to the caller.
   bool OnCorruptDatabase();
@@ -249,6 +302,8 @@ class SafeBrowsingStoreFile : public SafeBrowsingStore {
     chunks_written_ = 0;
     std::set<int32>().swap(add_chunks_cache_);
     std::set<int32>().swap(sub_chunks_cache_);
+    std::set<int32>().swap(new_add_chunks_);
+    std::set<int32>().swap(new_sub_chunks_);
     base::hash_set<int32>().swap(add_del_cache_);
     base::hash_set<int32>().swap(sub_del_cache_);
   }
@@ -278,6 +333,11 @@ class SafeBrowsingStoreFile : public SafeBrowsingStore {
   std::set<int32> add_chunks_cache_;
   std::set<int32> sub_chunks_cache_;
 
+  // The chunks first seen in this update, which go into the update
+  // log.
+  std::set<int32> new_add_chunks_;
+  std::set<int32> new_sub_chunks_;
+
   // Cache the set of deleted chunks during a transaction, applied on
   // FinishUpdate().
   // TODO(shess): If the set is small enough, hash_set<> might be
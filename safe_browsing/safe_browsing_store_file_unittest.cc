@@ -4,7 +4,10 @@
 
 #include "chrome/browser/safe_browsing/safe_browsing_store_file.h"
 
+#include <string>
+
 #include "base/bind.h"
+#include "base/file_util.h"
 #include "base/files/scoped_temp_dir.h"
 #include "base/md5.h"
 #include "chrome/browser/safe_browsing/safe_browsing_store_unittest_helper.h"
@@ -41,12 +44,76 @@ class SafeBrowsingStoreFileTest : public PlatformTest {
     corruption_detected_ = true;
   }
 
+  // Runs an update which adds |count| prefixes starting at |prefix|
+  // in |add_chunk|, and subs out |sub_prefix| of |add_chunk_to_sub| in
+  // |sub_chunk| if that is non-zero.  Returns the resulting prefixes.
+  SBAddPrefixes Update(int32 add_chunk, SBPrefix prefix, size_t count,
+                       int32 sub_chunk, int32 add_chunk_to_sub,
+                       SBPrefix sub_prefix) {
+    EXPECT_TRUE(store_->BeginUpdate());
+    EXPECT_TRUE(store_->BeginChunk());
+    store_->SetAddChunk(add_chunk);
+    for (size_t i = 0; i < count; ++i)
+      EXPECT_TRUE(store_->WriteAddPrefix(add_chunk, prefix + i));
+    if (sub_chunk) {
+      store_->SetSubChunk(sub_chunk);
+      EXPECT_TRUE(store_->WriteSubPrefix(sub_chunk, add_chunk_to_sub,
+                                         sub_prefix));
+    }
+    EXPECT_TRUE(store_->FinishChunk());
+
+    std::vector<SBAddFullHash> pending_adds;
+    std::set<SBPrefix> prefix_misses;
+    SBAddPrefixes add_prefixes;
+    std::vector<SBAddFullHash> add_hashes;
+    EXPECT_TRUE(store_->FinishUpdate(pending_adds, prefix_misses,
+                                     &add_prefixes, &add_hashes));
+    return add_prefixes;
+  }
+
+  // Reopens the store and returns its prefixes.
+  SBAddPrefixes Reopen() {
+    store_.reset(new SafeBrowsingStoreFile());
+    store_->Init(filename_,
+                 base::Bind(&SafeBrowsingStoreFileTest::OnCorruptionDetected,
+                            base::Unretained(this)));
+    SBAddPrefixes add_prefixes;
+    EXPECT_TRUE(store_->GetAddPrefixes(&add_prefixes));
+    return add_prefixes;
+  }
+
+  static bool HasPrefix(const SBAddPrefixes& add_prefixes, int32 chunk_id,
+                        SBPrefix prefix) {
+    for (SBAddPrefixes::const_iterator iter = add_prefixes.begin();
+         iter != add_prefixes.end(); ++iter) {
+      if (iter->chunk_id == chunk_id && iter->prefix == prefix)
+        return true;
+    }
+    return false;
+  }
+
+  std::string ReadFile(const base::FilePath& path) {
+    std::string contents;
+    EXPECT_TRUE(base::ReadFileToString(path, &contents));
+    return contents;
+  }
+
+  void WriteFile(const base::FilePath& path, const std::string& contents) {
+    ASSERT_EQ(static_cast<int>(contents.size()),
+              file_util::WriteFile(path, contents.data(), contents.size()));
+  }
+
   base::ScopedTempDir temp_dir_;
   base::FilePath filename_;
   scoped_ptr<SafeBrowsingStoreFile> store_;
   bool corruption_detected_;
 };
 
+// Enough prefixes that small updates go to the update log.
+const size_t kBasePrefixes = 1000;
+const SBPrefix kBasePrefix = 1000;
+const SBPrefix kNewPrefix = 5;
+
 TEST_STORE(SafeBrowsingStoreFileTest, store_.get(), filename_);
 
 // Test that Delete() deletes the temporary store, if present.
@@ -190,4 +257,136 @@ TEST_F(SafeBrowsingStoreFileTest, CheckValidityChecksum) {
   EXPECT_TRUE(store_->CancelUpdate());
 }
 
+// Small updates are appended to the update log, leaving the main file
+// alone, and are read back with the main file's data.
+TEST_F(SafeBrowsingStoreFileTest, UpdateLog) {
+  const base::FilePath log_file =
+      SafeBrowsingStoreFile::UpdateLogForFilename(filename_);
+
+  EXPECT_EQ(kBasePrefixes, Update(1, kBasePrefix, kBasePrefixes, 0, 0, 0)
+            .size());
+  EXPECT_FALSE(base::PathExists(log_file));
+  const std::string main_contents = ReadFile(filename_);
+
+  // A new add, and a sub knocking out one of the main file's adds.
+  SBAddPrefixes add_prefixes = Update(2, kNewPrefix, 1, 3, 1, kBasePrefix);
+  EXPECT_EQ(kBasePrefixes, add_prefixes.size());
+  EXPECT_TRUE(HasPrefix(add_prefixes, 2, kNewPrefix));
+  EXPECT_FALSE(HasPrefix(add_prefixes, 1, kBasePrefix));
+  EXPECT_TRUE(base::PathExists(log_file));
+  EXPECT_EQ(main_contents, ReadFile(filename_));
+
+  // An update without changes leaves the log alone.
+  const std::string log_contents = ReadFile(log_file);
+  EXPECT_TRUE(store_->BeginUpdate());
+  std::vector<SBAddFullHash> pending_adds;
+  std::set<SBPrefix> prefix_misses;
+  std::vector<SBAddFullHash> add_hashes;
+  EXPECT_TRUE(store_->FinishUpdate(pending_adds, prefix_misses,
+                                   &add_prefixes, &add_hashes));
+  EXPECT_EQ(kBasePrefixes, add_prefixes.size());
+  EXPECT_EQ(log_contents, ReadFile(log_file));
+
+  // The log is read by a new store, along with its chunks.
+  add_prefixes = Reopen();
+  EXPECT_EQ(kBasePrefixes, add_prefixes.size());
+  EXPECT_TRUE(HasPrefix(add_prefixes, 2, kNewPrefix));
+  EXPECT_FALSE(HasPrefix(add_prefixes, 1, kBasePrefix));
+  EXPECT_TRUE(store_->BeginUpdate());
+  EXPECT_TRUE(store_->CheckAddChunk(1));
+  EXPECT_TRUE(store_->CheckAddChunk(2));
+  EXPECT_TRUE(store_->CheckSubChunk(3));
+  EXPECT_TRUE(store_->CheckValidity());
+  EXPECT_TRUE(store_->CancelUpdate());
+  EXPECT_FALSE(corruption_detected_);
+
+  // Deleting a chunk rewrites the main file, which drops the log.
+  EXPECT_TRUE(store_->BeginUpdate());
+  store_->DeleteAddChunk(2);
+  EXPECT_TRUE(store_->FinishUpdate(pending_adds, prefix_misses,
+                                   &add_prefixes, &add_hashes));
+  EXPECT_EQ(kBasePrefixes - 1, add_prefixes.size());
+  EXPECT_FALSE(base::PathExists(log_file));
+  EXPECT_NE(main_contents, ReadFile(filename_));
+
+  // Enough small updates are compacted into the main file.
+  for (int32 chunk_id = 10; chunk_id < 30; ++chunk_id)
+    Update(chunk_id, kNewPrefix + chunk_id, 1, 0, 0, 0);
+  EXPECT_NE(main_contents, ReadFile(filename_));
+  EXPECT_EQ(kBasePrefixes + 19, Reopen().size());
+
+  // Delete() also deletes the log.
+  Update(4, kNewPrefix, 1, 0, 0, 0);
+  EXPECT_TRUE(base::PathExists(log_file));
+  EXPECT_TRUE(store_->Delete());
+  EXPECT_FALSE(base::PathExists(filename_));
+  EXPECT_FALSE(base::PathExists(log_file));
+}
+
+// A segment torn by a crash is ignored, and written over by the next
+// update.
+TEST_F(SafeBrowsingStoreFileTest, UpdateLogTornSegment) {
+  const base::FilePath log_file =
+      SafeBrowsingStoreFile::UpdateLogForFilename(filename_);
+
+  Update(1, kBasePrefix, kBasePrefixes, 0, 0, 0);
+  Update(2, kNewPrefix, 1, 0, 0, 0);
+  Update(3, kNewPrefix + 1, 1, 0, 0, 0);
+  std::string log_contents = ReadFile(log_file);
+  log_contents.resize(log_contents.size() - 1);
+  WriteFile(log_file, log_contents);
+
+  SBAddPrefixes add_prefixes = Reopen();
+  EXPECT_EQ(kBasePrefixes + 1, add_prefixes.size());
+  EXPECT_TRUE(HasPrefix(add_prefixes, 2, kNewPrefix));
+  EXPECT_TRUE(store_->BeginUpdate());
+  EXPECT_TRUE(store_->CheckAddChunk(2));
+  EXPECT_FALSE(store_->CheckAddChunk(3));
+  EXPECT_TRUE(store_->CancelUpdate());
+
+  add_prefixes = Update(3, kNewPrefix + 1, 1, 0, 0, 0);
+  EXPECT_EQ(kBasePrefixes + 2, add_prefixes.size());
+  EXPECT_EQ(kBasePrefixes + 2, Reopen().size());
+  EXPECT_FALSE(corruption_detected_);
+}
+
+// A log left over from before the main file was rewritten is ignored.
+TEST_F(SafeBrowsingStoreFileTest, UpdateLogStale) {
+  const base::FilePath log_file =
+      SafeBrowsingStoreFile::UpdateLogForFilename(filename_);
+
+  Update(1, kBasePrefix, kBasePrefixes, 0, 0, 0);
+  Update(2, kNewPrefix, 1, 0, 0, 0);
+  const std::string log_contents = ReadFile(log_file);
+
+  // Rewrite the main file with another prefix, then put the log back.
+  EXPECT_TRUE(store_->BeginUpdate());
+  store_->DeleteAddChunk(2);
+  EXPECT_TRUE(store_->BeginChunk());
+  store_->SetAddChunk(3);
+  EXPECT_TRUE(store_->WriteAddPrefix(3, kNewPrefix + 1));
+  EXPECT_TRUE(store_->FinishChunk());
+  std::vector<SBAddFullHash> pending_adds;
+  std::set<SBPrefix> prefix_misses;
+  SBAddPrefixes add_prefixes;
+  std::vector<SBAddFullHash> add_hashes;
+  EXPECT_TRUE(store_->FinishUpdate(pending_adds, prefix_misses,
+                                   &add_prefixes, &add_hashes));
+  EXPECT_FALSE(base::PathExists(log_file));
+  WriteFile(log_file, log_contents);
+
+  add_prefixes = Reopen();
+  EXPECT_EQ(kBasePrefixes + 1, add_prefixes.size());
+  EXPECT_FALSE(HasPrefix(add_prefixes, 2, kNewPrefix));
+  EXPECT_TRUE(store_->BeginUpdate());
+  EXPECT_FALSE(store_->CheckAddChunk(2));
+  EXPECT_TRUE(store_->CancelUpdate());
+
+  // The next update replaces the stale log.
+  add_prefixes = Update(4, kNewPrefix, 1, 0, 0, 0);
+  EXPECT_EQ(kBasePrefixes + 2, add_prefixes.size());
+  EXPECT_EQ(kBasePrefixes + 2, Reopen().size());
+  EXPECT_FALSE(corruption_detected_);
+}
+
 }  // namespace
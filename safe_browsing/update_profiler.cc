@@ -0,0 +1,164 @@
+// Copyright 2013 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "chrome/browser/safe_browsing/update_profiler.h"
+
+#include "base/lazy_instance.h"
+#include "base/metrics/histogram.h"
+#include "base/values.h"
+
+namespace {
+
+// Keys of the phases in the internals page.
+const char* const kPhaseNames[] = {
+  "download",
+  "parse",
+  "insert",
+  "processSubs",
+  "buildPrefixSet",
+  "write",
+  "swap",
+};
+COMPILE_ASSERT(arraysize(kPhaseNames) == SafeBrowsingUpdateProfiler::PHASE_MAX,
+               phase_names_mismatch);
+
+base::LazyInstance<SafeBrowsingUpdateProfiler>::Leaky g_profiler =
+    LAZY_INSTANCE_INITIALIZER;
+
+}  // namespace
+
+const size_t SafeBrowsingUpdateProfiler::kMaxCycles;
+
+SafeBrowsingUpdateProfiler::PhaseStats::PhaseStats()
+    : bytes(0),
+      count(0) {
+}
+
+SafeBrowsingUpdateProfiler::Cycle::Cycle() : success(false) {}
+
+SafeBrowsingUpdateProfiler::Cycle::~Cycle() {}
+
+SafeBrowsingUpdateProfiler::SafeBrowsingUpdateProfiler() : in_cycle_(false) {}
+
+SafeBrowsingUpdateProfiler::~SafeBrowsingUpdateProfiler() {}
+
+// static
+SafeBrowsingUpdateProfiler* SafeBrowsingUpdateProfiler::GetInstance() {
+  return g_profiler.Pointer();
+}
+
+void SafeBrowsingUpdateProfiler::StartCycle() {
+  base::AutoLock locked(lock_);
+  if (in_cycle_)
+    FinishCycleLocked(false);
+
+  current_ = Cycle();
+  current_.start_time = base::Time::Now();
+  current_.start_ticks = base::TimeTicks::Now();
+  in_cycle_ = true;
+}
+
+void SafeBrowsingUpdateProfiler::RecordPhase(Phase phase,
+                                             const std::string& source,
+                                             base::TimeDelta time,
+                                             int64 bytes) {
+  DCHECK_GE(phase, 0);
+  DCHECK_LT(phase, PHASE_MAX);
+
+  base::AutoLock locked(lock_);
+  if (!in_cycle_)
+    return;
+
+  PhaseStats* stats[] = {
+    &current_.totals[phase],
+    &current_.sources[source].phases[phase],
+  };
+  for (size_t i = 0; i < arraysize(stats); ++i) {
+    stats[i]->time += time;
+    stats[i]->bytes += bytes;
+    ++stats[i]->count;
+  }
+}
+
+void SafeBrowsingUpdateProfiler::FinishCycle(bool success) {
+  base::AutoLock locked(lock_);
+  if (!in_cycle_)
+    return;
+
+  const PhaseStats* totals = current_.totals;
+  UMA_HISTOGRAM_LONG_TIMES("SB2.UpdateCycle.Download",
+                           totals[PHASE_DOWNLOAD].time);
+  UMA_HISTOGRAM_LONG_TIMES("SB2.UpdateCycle.Parse",
+                           totals[PHASE_PARSE].time);
+  UMA_HISTOGRAM_LONG_TIMES("SB2.UpdateCycle.Insert",
+                           totals[PHASE_INSERT].time);
+  UMA_HISTOGRAM_LONG_TIMES("SB2.UpdateCycle.ProcessSubs",
+                           totals[PHASE_PROCESS_SUBS].time);
+  UMA_HISTOGRAM_LONG_TIMES("SB2.UpdateCycle.BuildPrefixSet",
+                           totals[PHASE_BUILD_PREFIX_SET].time);
+  UMA_HISTOGRAM_LONG_TIMES("SB2.UpdateCycle.Write",
+                           totals[PHASE_WRITE].time);
+  UMA_HISTOGRAM_TIMES("SB2.UpdateCycle.Swap", totals[PHASE_SWAP].time);
+  UMA_HISTOGRAM_COUNTS("SB2.UpdateCycle.DownloadKilobytes",
+                       static_cast<int>(totals[PHASE_DOWNLOAD].bytes / 1024));
+  UMA_HISTOGRAM_COUNTS("SB2.UpdateCycle.WriteKilobytes",
+                       static_cast<int>(totals[PHASE_WRITE].bytes / 1024));
+
+  FinishCycleLocked(success);
+}
+
+base::ListValue* SafeBrowsingUpdateProfiler::GetCyclesAsValue() const {
+  base::AutoLock locked(lock_);
+
+  base::ListValue* cycles = new base::ListValue;
+  for (std::deque<Cycle>::const_reverse_iterator it = cycles_.rbegin();
+       it != cycles_.rend(); ++it) {
+    base::DictionaryValue* cycle = new base::DictionaryValue;
+    cycle->SetDouble("startTime", it->start_time.ToJsTime());
+    cycle->SetDouble("duration", it->duration.InMillisecondsF());
+    cycle->SetBoolean("success", it->success);
+
+    base::ListValue* sources = new base::ListValue;
+    for (std::map<std::string, SourceStats>::const_iterator
+             source = it->sources.begin();
+         source != it->sources.end(); ++source) {
+      base::DictionaryValue* source_value = new base::DictionaryValue;
+      source_value->SetString("name", source->first);
+      for (int phase = 0; phase < PHASE_MAX; ++phase) {
+        const PhaseStats& stats = source->second.phases[phase];
+        if (!stats.count)
+          continue;
+        base::DictionaryValue* phase_value = new base::DictionaryValue;
+        phase_value->SetDouble("time", stats.time.InMillisecondsF());
+        phase_value->SetDouble("bytes", static_cast<double>(stats.bytes));
+        phase_value->SetInteger("count", stats.count);
+        source_value->Set(kPhaseNames[phase], phase_value);
+      }
+      sources->Append(source_value);
+    }
+    cycle->Set("sources", sources);
+
+    base::DictionaryValue* totals = new base::DictionaryValue;
+    for (int phase = 0; phase < PHASE_MAX; ++phase) {
+      totals->SetDouble(kPhaseNames[phase],
+                        it->totals[phase].time.InMillisecondsF());
+    }
+    cycle->Set("totals", totals);
+
+    cycles->Append(cycle);
+  }
+  return cycles;
+}
+
+void SafeBrowsingUpdateProfiler::FinishCycleLocked(bool success) {
+  lock_.AssertAcquired();
+  DCHECK(in_cycle_);
+
+  current_.duration = base::TimeTicks::Now() - current_.start_ticks;
+  current_.success = success;
+  cycles_.push_back(current_);
+  if (cycles_.size() > kMaxCycles)
+    cycles_.pop_front();
+  in_cycle_ = false;
+}
@@ -0,0 +1,115 @@
+// Copyright 2013 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CHROME_BROWSER_SAFE_BROWSING_UPDATE_PROFILER_H_
+#define CHROME_BROWSER_SAFE_BROWSING_UPDATE_PROFILER_H_
+
+// Breaks the time of the safe browsing update cycles down into phases.
+//
+// An update cycle starts when the protocol manager asks the database
+// for its chunks, and ends when the database has finished the update.
+// The phases run on the IO thread (download, parse) and on the safe
+// browsing thread (insert, and everything done in |UpdateFinished()|),
+// so the profiler is shared and locked.  Each phase is broken down by
+// source, which is the list name for the network and insert phases and
+// the name of the file for the phases which work on a whole store.
+//
+// The totals of each cycle go to UMA, and the last |kMaxCycles| cycles
+// are kept for chrome://safe-browsing-internals.
+
+#include <deque>
+#include <map>
+#include <string>
+
+#include "base/basictypes.h"
+#include "base/synchronization/lock.h"
+#include "base/time/time.h"
+
+namespace base {
+class ListValue;
+}  // namespace base
+
+class SafeBrowsingUpdateProfiler {
+ public:
+  enum Phase {
+    PHASE_DOWNLOAD,
+    PHASE_PARSE,
+    PHASE_INSERT,
+    PHASE_PROCESS_SUBS,
+    PHASE_BUILD_PREFIX_SET,
+    PHASE_WRITE,
+    PHASE_SWAP,
+
+    // Memory space for phases is allocated according to this value.
+    PHASE_MAX
+  };
+
+  // How many finished cycles are kept.
+  static const size_t kMaxCycles = 10;
+
+  SafeBrowsingUpdateProfiler();
+  ~SafeBrowsingUpdateProfiler();
+
+  // The profiler used by the safe browsing code.
+  static SafeBrowsingUpdateProfiler* GetInstance();
+
+  // Starts a new cycle.  A cycle which is still open is kept as an
+  // unsuccessful one.
+  void StartCycle();
+
+  // Adds |time| spent and |bytes| handled in |phase| for |source| to the
+  // current cycle.  Ignored when no cycle is open.
+  void RecordPhase(Phase phase,
+                   const std::string& source,
+                   base::TimeDelta time,
+                   int64 bytes);
+
+  // Closes the current cycle and records its totals to UMA.
+  void FinishCycle(bool success);
+
+  // Returns the finished cycles, most recent first, for the internals
+  // page.  The caller takes ownership.
+  base::ListValue* GetCyclesAsValue() const;
+
+ private:
+  struct PhaseStats {
+    PhaseStats();
+
+    base::TimeDelta time;
+    int64 bytes;
+    int count;
+  };
+
+  struct SourceStats {
+    PhaseStats phases[PHASE_MAX];
+  };
+
+  struct Cycle {
+    Cycle();
+    ~Cycle();
+
+    base::Time start_time;
+    base::TimeTicks start_ticks;
+    base::TimeDelta duration;
+    bool success;
+    PhaseStats totals[PHASE_MAX];
+    std::map<std::string, SourceStats> sources;
+  };
+
+  // Moves |current_| into |cycles_|.  |lock_| must be held.
+  void FinishCycleLocked(bool success);
+
+  mutable base::Lock lock_;
+
+  // The cycle in progress, if |in_cycle_|.
+  bool in_cycle_;
+  Cycle current_;
+
+  // Finished cycles, oldest first.
+  std::deque<Cycle> cycles_;
+
+  DISALLOW_COPY_AND_ASSIGN(SafeBrowsingUpdateProfiler);
+};
+
+#endif  // CHROME_BROWSER_SAFE_BROWSING_UPDATE_PROFILER_H_
@@ -0,0 +1,137 @@
+// Copyright 2013 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "chrome/browser/safe_browsing/update_profiler.h"
+
+#include "base/memory/scoped_ptr.h"
+#include "base/strings/stringprintf.h"
+#include "base/values.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace {
+
+const char kMalwareList[] = "goog-malware-shavar";
+const char kPhishingList[] = "goog-phish-shavar";
+
+base::TimeDelta Ms(int ms) {
+  return base::TimeDelta::FromMilliseconds(ms);
+}
+
+}  // namespace
+
+TEST(SafeBrowsingUpdateProfilerTest, Empty) {
+  SafeBrowsingUpdateProfiler profiler;
+  scoped_ptr<base::ListValue> cycles(profiler.GetCyclesAsValue());
+  EXPECT_TRUE(cycles->empty());
+
+  // Nothing is recorded outside of a cycle.
+  profiler.RecordPhase(SafeBrowsingUpdateProfiler::PHASE_DOWNLOAD,
+                       kMalwareList, Ms(10), 100);
+  profiler.FinishCycle(true);
+  cycles.reset(profiler.GetCyclesAsValue());
+  EXPECT_TRUE(cycles->empty());
+}
+
+TEST(SafeBrowsingUpdateProfilerTest, Breakdown) {
+  SafeBrowsingUpdateProfiler profiler;
+  profiler.StartCycle();
+  profiler.RecordPhase(SafeBrowsingUpdateProfiler::PHASE_DOWNLOAD,
+                       kMalwareList, Ms(10), 100);
+  profiler.RecordPhase(SafeBrowsingUpdateProfiler::PHASE_DOWNLOAD,
+                       kMalwareList, Ms(20), 200);
+  profiler.RecordPhase(SafeBrowsingUpdateProfiler::PHASE_DOWNLOAD,
+                       kPhishingList, Ms(5), 50);
+  profiler.RecordPhase(SafeBrowsingUpdateProfiler::PHASE_INSERT,
+                       kPhishingList, Ms(7), 50);
+  profiler.FinishCycle(true);
+
+  scoped_ptr<base::ListValue> cycles(profiler.GetCyclesAsValue());
+  ASSERT_EQ(1U, cycles->GetSize());
+  base::DictionaryValue* cycle = NULL;
+  ASSERT_TRUE(cycles->GetDictionary(0, &cycle));
+  bool success = false;
+  EXPECT_TRUE(cycle->GetBoolean("success", &success));
+  EXPECT_TRUE(success);
+
+  double time = 0;
+  EXPECT_TRUE(cycle->GetDouble("totals.download", &time));
+  EXPECT_DOUBLE_EQ(35.0, time);
+  EXPECT_TRUE(cycle->GetDouble("totals.insert", &time));
+  EXPECT_DOUBLE_EQ(7.0, time);
+  EXPECT_TRUE(cycle->GetDouble("totals.write", &time));
+  EXPECT_DOUBLE_EQ(0.0, time);
+
+  // Sources come back sorted by name.
+  base::ListValue* sources = NULL;
+  ASSERT_TRUE(cycle->GetList("sources", &sources));
+  ASSERT_EQ(2U, sources->GetSize());
+
+  base::DictionaryValue* source = NULL;
+  ASSERT_TRUE(sources->GetDictionary(0, &source));
+  std::string name;
+  EXPECT_TRUE(source->GetString("name", &name));
+  EXPECT_EQ(kMalwareList, name);
+  EXPECT_TRUE(source->GetDouble("download.time", &time));
+  EXPECT_DOUBLE_EQ(30.0, time);
+  double bytes = 0;
+  EXPECT_TRUE(source->GetDouble("download.bytes", &bytes));
+  EXPECT_DOUBLE_EQ(300.0, bytes);
+  int count = 0;
+  EXPECT_TRUE(source->GetInteger("download.count", &count));
+  EXPECT_EQ(2, count);
+  EXPECT_FALSE(source->HasKey("insert"));
+
+  ASSERT_TRUE(sources->GetDictionary(1, &source));
+  EXPECT_TRUE(source->GetString("name", &name));
+  EXPECT_EQ(kPhishingList, name);
+  EXPECT_TRUE(source->GetDouble("insert.time", &time));
+  EXPECT_DOUBLE_EQ(7.0, time);
+}
+
+// An open cycle is kept as unsuccessful once the next one starts, and
+// only the last |kMaxCycles| are kept, most recent first.
+TEST(SafeBrowsingUpdateProfilerTest, History) {
+  SafeBrowsingUpdateProfiler profiler;
+  profiler.StartCycle();
+  profiler.StartCycle();
+  profiler.FinishCycle(true);
+
+  scoped_ptr<base::ListValue> cycles(profiler.GetCyclesAsValue());
+  ASSERT_EQ(2U, cycles->GetSize());
+  base::DictionaryValue* cycle = NULL;
+  bool success = false;
+  ASSERT_TRUE(cycles->GetDictionary(0, &cycle));
+  EXPECT_TRUE(cycle->GetBoolean("success", &success));
+  EXPECT_TRUE(success);
+  ASSERT_TRUE(cycles->GetDictionary(1, &cycle));
+  EXPECT_TRUE(cycle->GetBoolean("success", &success));
+  EXPECT_FALSE(success);
+
+  for (size_t i = 0; i < SafeBrowsingUpdateProfiler::kMaxCycles; ++i) {
+    profiler.StartCycle();
+    profiler.RecordPhase(SafeBrowsingUpdateProfiler::PHASE_WRITE,
+                         base::StringPrintf("store%d", static_cast<int>(i)),
+                         Ms(1), 0);
+    profiler.FinishCycle(true);
+  }
+  cycles.reset(profiler.GetCyclesAsValue());
+  ASSERT_EQ(SafeBrowsingUpdateProfiler::kMaxCycles, cycles->GetSize());
+
+  base::ListValue* sources = NULL;
+  base::DictionaryValue* source = NULL;
+  std::string name;
+  ASSERT_TRUE(cycles->GetDictionary(0, &cycle));
+  ASSERT_TRUE(cycle->GetList("sources", &sources));
+  ASSERT_TRUE(sources->GetDictionary(0, &source));
+  EXPECT_TRUE(source->GetString("name", &name));
+  EXPECT_EQ(base::StringPrintf(
+      "store%d", static_cast<int>(SafeBrowsingUpdateProfiler::kMaxCycles - 1)),
+            name);
+
+  ASSERT_TRUE(cycles->GetDictionary(cycles->GetSize() - 1, &cycle));
+  ASSERT_TRUE(cycle->GetList("sources", &sources));
+  ASSERT_TRUE(sources->GetDictionary(0, &source));
+  EXPECT_TRUE(source->GetString("name", &name));
+  EXPECT_EQ("store0", name);
+}
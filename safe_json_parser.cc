@@ -4,19 +4,20 @@
 
 #include "chrome/browser/safe_json_parser.h"
 
+#include "base/bind.h"
+#include "base/values.h"
 #include "chrome/common/chrome_utility_messages.h"
 #include "content/public/browser/browser_thread.h"
-#include "content/public/browser/utility_process_host.h"
 
 using content::BrowserThread;
-using content::UtilityProcessHost;
 
 SafeJsonParser::SafeJsonParser(const std::string& unsafe_json,
                                const SuccessCallback& success_callback,
                                const ErrorCallback& error_callback)
     : unsafe_json_(unsafe_json),
       success_callback_(success_callback),
-      error_callback_(error_callback) {}
+      error_callback_(error_callback),
+      process_mode_(BatchedUtilityProcessHost::DEDICATED_PROCESS) {}
 
 void SafeJsonParser::Start() {
   DCHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
@@ -30,10 +31,26 @@ SafeJsonParser::~SafeJsonParser() {}
 
 void SafeJsonParser::StartWorkOnIOThread() {
   DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
-  UtilityProcessHost* host =
-      UtilityProcessHost::Create(this, base::MessageLoopProxy::current().get());
-  host->EnableZygote();
-  host->Send(new ChromeUtilityMsg_ParseJSON(unsafe_json_));
+  BatchedUtilityProcessHost::Send(
+      process_mode_, new ChromeUtilityMsg_ParseJSON(unsafe_json_),
+      base::Bind(&SafeJsonParser::OnUtilityProcessReply, this),
+      base::Bind(&SafeJsonParser::OnUtilityProcessCrashed, this));
+}
+
+bool SafeJsonParser::OnUtilityProcessReply(const IPC::Message& message) {
+  bool handled = true;
+  IPC_BEGIN_MESSAGE_MAP(SafeJsonParser, message)
+    IPC_MESSAGE_HANDLER(ChromeUtilityHostMsg_ParseJSON_Succeeded,
+                        OnJSONParseSucceeded)
+    IPC_MESSAGE_HANDLER(ChromeUtilityHostMsg_ParseJSON_Failed,
+                        OnJSONParseFailed)
+    IPC_MESSAGE_UNHANDLED(handled = false)
+  IPC_END_MESSAGE_MAP()
+  return handled;
+}
+
+void SafeJsonParser::OnUtilityProcessCrashed() {
+  OnJSONParseFailed("Utility process crashed");
 }
 
 void SafeJsonParser::OnJSONParseSucceeded(const base::ListValue& wrapper) {
@@ -70,15 +87,3 @@ void SafeJsonParser::ReportResultOnUIThread() {
       error_callback_.Run(error_);
   }
 }
-
-bool SafeJsonParser::OnMessageReceived(const IPC::Message& message) {
-  bool handled = true;
-  IPC_BEGIN_MESSAGE_MAP(SafeJsonParser, message)
-    IPC_MESSAGE_HANDLER(ChromeUtilityHostMsg_ParseJSON_Succeeded,
-                        OnJSONParseSucceeded)
-    IPC_MESSAGE_HANDLER(ChromeUtilityHostMsg_ParseJSON_Failed,
-                        OnJSONParseFailed)
-    IPC_MESSAGE_UNHANDLED(handled = false)
-  IPC_END_MESSAGE_MAP()
-  return handled;
-}
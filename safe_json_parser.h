@@ -9,8 +9,9 @@
 
 #include "base/basictypes.h"
 #include "base/callback.h"
+#include "base/memory/ref_counted.h"
 #include "base/memory/scoped_ptr.h"
-#include "content/public/browser/utility_process_host_client.h"
+#include "chrome/browser/batched_utility_process_host.h"
 
 namespace base {
 class ListValue;
@@ -23,8 +24,10 @@ class Message;
 
 // SafeJsonParser parses a given JSON safely via a utility process. The object
 // is ref-counted and kept alive after Start() is called until one of the two
-// callbacks is called.
-class SafeJsonParser : public content::UtilityProcessHostClient {
+// callbacks is called. By default each parser gets a utility process of its
+// own. Callers that parse JSON from a trusted source in bursts can share one
+// with set_process_mode().
+class SafeJsonParser : public base::RefCountedThreadSafe<SafeJsonParser> {
  public:
   typedef base::Callback<void(scoped_ptr<base::Value>)> SuccessCallback;
   typedef base::Callback<void(const std::string&)> ErrorCallback;
@@ -35,23 +38,31 @@ class SafeJsonParser : public content::UtilityProcessHostClient {
 
   void Start();
 
+  // Must be called before Start(). Defaults to DEDICATED_PROCESS.
+  void set_process_mode(BatchedUtilityProcessHost::ProcessMode process_mode) {
+    process_mode_ = process_mode;
+  }
+
  private:
-  virtual ~SafeJsonParser();
+  friend class base::RefCountedThreadSafe<SafeJsonParser>;
+
+  ~SafeJsonParser();
 
   void StartWorkOnIOThread();
 
+  bool OnUtilityProcessReply(const IPC::Message& message);
+  void OnUtilityProcessCrashed();
+
   void OnJSONParseSucceeded(const base::ListValue& wrapper);
   void OnJSONParseFailed(const std::string& error_message);
 
   void ReportResults();
   void ReportResultOnUIThread();
 
-  // Implementing pieces of the UtilityProcessHostClient interface.
-  virtual bool OnMessageReceived(const IPC::Message& message) OVERRIDE;
-
   const std::string unsafe_json_;
   SuccessCallback success_callback_;
   ErrorCallback error_callback_;
+  BatchedUtilityProcessHost::ProcessMode process_mode_;
 
   scoped_ptr<base::Value> parsed_json_;
   std::string error_;
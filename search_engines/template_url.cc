@@ -765,7 +765,14 @@ void TemplateURLRef::HandleReplacement(const std::string& name,
     DCHECK(!post_params_[pos].first.empty());
     post_params_[pos].second = value;
   } else {
-    url->insert(pos, name.empty() ? value : (name + "=" + value + "&"));
+    if (name.empty()) {
+      url->append(value);
+    } else {
+      url->append(name);
+      url->push_back('=');
+      url->append(value);
+      url->push_back('&');
+    }
   }
 }
 
@@ -798,12 +805,21 @@ std::string TemplateURLRef::HandleReplacements(
   owner_->EncodeSearchTerms(search_terms_args, is_in_query, &input_encoding,
                             &encoded_terms, &encoded_original_query);
 
-  std::string url = parsed_url_;
-
-  // replacements_ is ordered in ascending order, as such we need to iterate
-  // from the back.
-  for (Replacements::reverse_iterator i = replacements_.rbegin();
-       i != replacements_.rend(); ++i) {
+  // Build the URL in one pass: copy each literal part of |parsed_url_| and
+  // append the value of the replacement which follows it.  The URL
+  // replacements are ordered by position, and come before the post parameter
+  // ones.
+  std::string url;
+  url.reserve(parsed_url_.length() + encoded_terms.length() +
+              encoded_original_query.length());
+  size_t copied = 0;
+  for (Replacements::iterator i = replacements_.begin();
+       i != replacements_.end(); ++i) {
+    if (!i->is_post_param) {
+      DCHECK_GE(i->index, copied);
+      url.append(parsed_url_, copied, i->index - copied);
+      copied = i->index;
+    }
     switch (i->type) {
       case ENCODING:
         HandleReplacement(std::string(), input_encoding, *i, &url);
@@ -1006,6 +1022,7 @@ std::string TemplateURLRef::HandleReplacements(
         break;
     }
   }
+  url.append(parsed_url_, copied, std::string::npos);
 
   if (!post_params_.empty())
     EncodeFormData(post_params_, post_content);
@@ -335,8 +335,8 @@ class TemplateURLRef {
 
   // Handles a replacement by using real term data. If the replacement
   // belongs to a PostParam, the PostParam will be replaced by the term data.
-  // Otherwise, the term data will be inserted at the place that the
-  // replacement points to.
+  // Otherwise, the term data will be appended to |url|, which the caller has
+  // filled up to the place that the replacement points to.
   void HandleReplacement(const std::string& name,
                          const std::string& value,
                          const Replacement& replacement,
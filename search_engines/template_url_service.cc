@@ -277,31 +277,6 @@ TemplateURLService::ExtensionKeyword::ExtensionKeyword(
 TemplateURLService::ExtensionKeyword::~ExtensionKeyword() {}
 
 
-// TemplateURLService::LessWithPrefix -----------------------------------------
-
-class TemplateURLService::LessWithPrefix {
- public:
-  // We want to find the set of keywords that begin with a prefix.  The STL
-  // algorithms will return the set of elements that are "equal to" the
-  // prefix, where "equal(x, y)" means "!(cmp(x, y) || cmp(y, x))".  When
-  // cmp() is the typical std::less<>, this results in lexicographic equality;
-  // we need to extend this to mark a prefix as "not less than" a keyword it
-  // begins, which will cause the desired elements to be considered "equal to"
-  // the prefix.  Note: this is still a strict weak ordering, as required by
-  // equal_range() (though I will not prove that here).
-  //
-  // Unfortunately the calling convention is not "prefix and element" but
-  // rather "two elements", so we pass the prefix as a fake "element" which has
-  // a NULL KeywordDataElement pointer.
-  bool operator()(const KeywordToTemplateMap::value_type& elem1,
-                  const KeywordToTemplateMap::value_type& elem2) const {
-    return (elem1.second == NULL) ?
-        (elem2.first.compare(0, elem1.first.length(), elem1.first) > 0) :
-        (elem1.first < elem2.first);
-  }
-};
-
-
 // TemplateURLService ---------------------------------------------------------
 
 TemplateURLService::TemplateURLService(Profile* profile)
@@ -458,22 +433,14 @@ void TemplateURLService::FindMatchingKeywords(
   DCHECK(matches != NULL);
   DCHECK(matches->empty());  // The code for exact matches assumes this.
 
-  // Required for VS2010: http://connect.microsoft.com/VisualStudio/feedback/details/520043/error-converting-from-null-to-a-pointer-type-in-std-pair
-  TemplateURL* const kNullTemplateURL = NULL;
-
-  // Find matching keyword range.  Searches the element map for keywords
-  // beginning with |prefix| and stores the endpoints of the resulting set in
-  // |match_range|.
-  const std::pair<KeywordToTemplateMap::const_iterator,
-                  KeywordToTemplateMap::const_iterator> match_range(
-      std::equal_range(
-          keyword_to_template_map_.begin(), keyword_to_template_map_.end(),
-          KeywordToTemplateMap::value_type(prefix, kNullTemplateURL),
-          LessWithPrefix()));
-
-  // Return vector of matching keywords.
-  for (KeywordToTemplateMap::const_iterator i(match_range.first);
-       i != match_range.second; ++i) {
+  // Find matching keyword range.  Keywords beginning with |prefix| sort right
+  // after it, so walk the map from there until a keyword doesn't begin with
+  // |prefix|.  This uses the map's own lookup, as std::equal_range() would
+  // take linear time to advance the map's iterators.
+  for (KeywordToTemplateMap::const_iterator i(
+           keyword_to_template_map_.lower_bound(prefix));
+       i != keyword_to_template_map_.end() &&
+       i->first.compare(0, prefix.length(), prefix) == 0; ++i) {
     if (!support_replacement_only || i->second->url_ref().SupportsReplacement())
       matches->push_back(i->second);
   }
@@ -420,10 +420,6 @@ class TemplateURLService : public WebDataServiceConsumer,
     DSP_CHANGE_MAX,
   };
 
-  // Helper functor for FindMatchingKeywords(), for finding the range of
-  // keywords which begin with a prefix.
-  class LessWithPrefix;
-
   void Init(const Initializer* initializers, int num_initializers);
 
   void RemoveFromMaps(TemplateURL* template_url);
@@ -9,6 +9,7 @@
 #include "base/prefs/pref_service.h"
 #include "chrome/browser/google/google_url_tracker_factory.h"
 #include "chrome/browser/history/history_service_factory.h"
+#include "chrome/browser/performance_monitor/startup_tracer.h"
 #include "chrome/browser/profiles/incognito_helpers.h"
 #include "chrome/browser/search_engines/template_url_service.h"
 #include "chrome/browser/webdata/web_data_service_factory.h"
@@ -46,6 +47,8 @@ TemplateURLServiceFactory::~TemplateURLServiceFactory() {}
 
 BrowserContextKeyedService* TemplateURLServiceFactory::BuildServiceInstanceFor(
     content::BrowserContext* profile) const {
+  performance_monitor::ScopedStartupPhase startup_phase(
+      "TemplateURLServiceFactory::BuildServiceInstanceFor");
   return BuildInstanceFor(static_cast<Profile*>(profile));
 }
 
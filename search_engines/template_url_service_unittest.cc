@@ -578,6 +578,38 @@ TEST_F(TemplateURLServiceTest, AddSameKeywordWithExtensionPresent) {
             model()->GetTemplateURLForKeyword(ASCIIToUTF16("keyword_")));
 }
 
+TEST_F(TemplateURLServiceTest, FindMatchingKeywords) {
+  test_util_.VerifyLoad();
+  TemplateURL* foo = AddKeywordWithDate(
+      "foo", "foo", "http://foo/{searchTerms}", std::string(), std::string(),
+      std::string(), true, "UTF-8", Time(), Time());
+  TemplateURL* foobar = AddKeywordWithDate(
+      "foobar", "foobar", "http://foobar/", std::string(), std::string(),
+      std::string(), true, "UTF-8", Time(), Time());
+  AddKeywordWithDate(
+      "fo", "fo", "http://fo/{searchTerms}", std::string(), std::string(),
+      std::string(), true, "UTF-8", Time(), Time());
+  AddKeywordWithDate(
+      "fop", "fop", "http://fop/{searchTerms}", std::string(), std::string(),
+      std::string(), true, "UTF-8", Time(), Time());
+
+  TemplateURLService::TemplateURLVector matches;
+  model()->FindMatchingKeywords(ASCIIToUTF16("foo"), false, &matches);
+  ASSERT_EQ(2U, matches.size());
+  EXPECT_EQ(foo, matches[0]);
+  EXPECT_EQ(foobar, matches[1]);
+
+  // Only the keywords which support replacement.
+  matches.clear();
+  model()->FindMatchingKeywords(ASCIIToUTF16("foo"), true, &matches);
+  ASSERT_EQ(1U, matches.size());
+  EXPECT_EQ(foo, matches[0]);
+
+  matches.clear();
+  model()->FindMatchingKeywords(ASCIIToUTF16("fooz"), false, &matches);
+  EXPECT_TRUE(matches.empty());
+}
+
 TEST_F(TemplateURLServiceTest, GenerateKeyword) {
   ASSERT_EQ(ASCIIToUTF16("foo"),
             TemplateURLService::GenerateKeyword(GURL("http://foo")));
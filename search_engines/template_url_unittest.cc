@@ -561,6 +561,10 @@ TEST_F(TemplateURLTest, ReplaceCursorPosition) {
       15,
       "{google:baseURL}?{searchTerms}&{google:cursorPosition}",
       "http://www.google.com/?foo&cp=15&" },
+    { ASCIIToUTF16("foo"),
+      2,
+      "{google:baseURL}?{google:cursorPosition}{searchTerms}",
+      "http://www.google.com/?cp=2&foo" },
   };
   TemplateURLData data;
   data.input_encodings.push_back("UTF-8");
@@ -177,8 +177,8 @@ class PersistentTabRestoreService::Delegate
   int GetSelectedNavigationIndexToPersist(const Tab& tab);
 
   // Invoked when we've loaded the session commands that identify the previously
-  // closed tabs. This creates entries, adds them to staging_entries_, and
-  // invokes LoadState.
+  // closed tabs. This creates entries, adds them with AddLoadedEntries, and
+  // invokes LoadStateChanged.
   void OnGotLastSessionCommands(ScopedVector<SessionCommand> commands);
 
   // Populates |loaded_entries| with Entries from |commands|.
@@ -190,9 +190,9 @@ class PersistentTabRestoreService::Delegate
   static void ValidateAndDeleteEmptyEntries(std::vector<Entry*>* entries);
 
   // Callback from SessionService when we've received the windows from the
-  // previous session. This creates and add entries to |staging_entries_| and
-  // invokes LoadStateChanged. |ignored_active_window| is ignored because we
-  // don't need to restore activation.
+  // previous session. This creates entries, adds them with AddLoadedEntries,
+  // and invokes LoadStateChanged. |ignored_active_window| is ignored because
+  // we don't need to restore activation.
   void OnGotPreviousSession(ScopedVector<SessionWindow> windows,
                             SessionID::id_type ignored_active_window);
 
@@ -201,9 +201,14 @@ class PersistentTabRestoreService::Delegate
   static bool ConvertSessionWindowToWindow(SessionWindow* session_window,
                                            Window* window);
 
+  // Adds |loaded_entries| from the previous tabs or session to the entries
+  // and notifies observers, without waiting for the other one to load. The
+  // previous session is |newer| than the tabs closed in it, so it goes ahead
+  // of them if they are loaded first.
+  void AddLoadedEntries(std::vector<Entry*>* loaded_entries, bool newer);
+
   // Invoked when previous tabs or session is loaded. If both have finished
-  // loading the entries in |staging_entries_| are added to entries and
-  // observers are notified.
+  // loading observers are notified that the service has loaded.
   void LoadStateChanged();
 
   // If |id_to_entry| contains an entry for |id| the corresponding entry is
@@ -225,11 +230,6 @@ class PersistentTabRestoreService::Delegate
   // Whether we've loaded the last session.
   int load_state_;
 
-  // Results from previously closed tabs/sessions is first added here. When the
-  // results from both us and the session restore service have finished loading
-  // LoadStateChanged is invoked, which adds these entries to entries_.
-  ScopedVector<Entry> staging_entries_;
-
   // Used when loading previous tabs/session and open tabs/session.
   CancelableTaskTracker cancelable_task_tracker_;
 
@@ -553,8 +553,7 @@ void PersistentTabRestoreService::Delegate::OnGotLastSessionCommands(
   std::vector<Entry*> entries;
   CreateEntriesFromCommands(commands.get(), &entries);
   // Closed tabs always go to the end.
-  staging_entries_.insert(staging_entries_.end(), entries.begin(),
-                          entries.end());
+  AddLoadedEntries(&entries, false);
   load_state_ |= LOADED_LAST_TABS;
   LoadStateChanged();
 }
@@ -781,8 +780,7 @@ void PersistentTabRestoreService::Delegate::OnGotPreviousSession(
   std::vector<Entry*> entries;
   CreateEntriesFromWindows(&windows.get(), &entries);
   // Previous session tabs go first.
-  staging_entries_.insert(staging_entries_.begin(), entries.begin(),
-                          entries.end());
+  AddLoadedEntries(&entries, true);
   load_state_ |= LOADED_LAST_SESSION;
   LoadStateChanged();
 }
@@ -812,52 +810,39 @@ bool PersistentTabRestoreService::Delegate::ConvertSessionWindowToWindow(
   return true;
 }
 
-void PersistentTabRestoreService::Delegate::LoadStateChanged() {
-  if ((load_state_ & (LOADED_LAST_TABS | LOADED_LAST_SESSION)) !=
-      (LOADED_LAST_TABS | LOADED_LAST_SESSION)) {
-    // Still waiting on previous session or previous tabs.
+void PersistentTabRestoreService::Delegate::AddLoadedEntries(
+    std::vector<Entry*>* loaded_entries,
+    bool newer) {
+  if (loaded_entries->empty())
     return;
-  }
 
-  // We're done loading.
-  load_state_ ^= LOADING;
-
-  const Entries& entries = tab_restore_service_helper_->entries();
-  if (staging_entries_.empty() || entries.size() >= kMaxEntries) {
-    staging_entries_.clear();
-    tab_restore_service_helper_->NotifyLoaded();
+  if (!newer &&
+      tab_restore_service_helper_->entries().size() >= kMaxEntries) {
+    // Older entries would be pruned right away.
+    STLDeleteElements(loaded_entries);
     return;
   }
 
-  if (staging_entries_.size() + entries.size() > kMaxEntries) {
-    // If we add all the staged entries we'll end up with more than
-    // kMaxEntries. Delete entries such that we only end up with at most
-    // kMaxEntries.
-    int surplus = kMaxEntries - entries.size();
-    CHECK_LE(0, surplus);
-    CHECK_GE(static_cast<int>(staging_entries_.size()), surplus);
-    staging_entries_.erase(
-        staging_entries_.begin() + (kMaxEntries - entries.size()),
-        staging_entries_.end());
-  }
+  // Takes ownership of the entries and prunes them to kMaxEntries.
+  tab_restore_service_helper_->AddLastSessionEntries(loaded_entries, newer);
 
-  // And add them.
-  for (size_t i = 0; i < staging_entries_.size(); ++i) {
-    staging_entries_[i]->from_last_session = true;
-    tab_restore_service_helper_->AddEntry(staging_entries_[i], false, false);
-  }
+  // The loaded entries are not written again, Save starts from the front and
+  // they are at the end.
+  entries_to_write_ = 0;
 
-  // AddEntry takes ownership of the entry, need to clear out entries so that
-  // it doesn't delete them.
-  staging_entries_.weak_clear();
+  tab_restore_service_helper_->NotifyTabsChanged();
+}
 
-  // Make it so we rewrite all the tabs. We need to do this otherwise we won't
-  // correctly write out the entries when Save is invoked (Save starts from
-  // the front, not the end and we just added the entries to the end).
-  entries_to_write_ = staging_entries_.size();
+void PersistentTabRestoreService::Delegate::LoadStateChanged() {
+  if ((load_state_ & (LOADED_LAST_TABS | LOADED_LAST_SESSION)) !=
+      (LOADED_LAST_TABS | LOADED_LAST_SESSION)) {
+    // Still waiting on previous session or previous tabs. Whatever has been
+    // loaded is already in the entries.
+    return;
+  }
 
-  tab_restore_service_helper_->PruneEntries();
-  tab_restore_service_helper_->NotifyTabsChanged();
+  // We're done loading.
+  load_state_ ^= LOADING;
 
   tab_restore_service_helper_->NotifyLoaded();
 }
@@ -16,6 +16,7 @@
 #include "chrome/browser/sessions/session_service_factory.h"
 #include "chrome/browser/sessions/session_types.h"
 #include "chrome/browser/sessions/tab_restore_service_factory.h"
+#include "chrome/browser/sessions/tab_restore_service_helper.h"
 #include "chrome/browser/sessions/tab_restore_service_observer.h"
 #include "chrome/browser/ui/browser_window.h"
 #include "chrome/common/url_constants.h"
@@ -757,6 +758,38 @@ TEST_F(PersistentTabRestoreServiceTest, PruneEntries) {
           navigations[1].virtual_url(), profile()));
 }
 
+// Makes sure entries from the previous session can be added as each file is
+// read, and still end up newest first.
+TEST_F(PersistentTabRestoreServiceTest, AddLastSessionEntries) {
+  TabRestoreServiceHelper helper(service_.get(), NULL, profile(),
+                                 time_factory_);
+  const GURL urls[] = { url1_, url2_, url3_ };
+  Tab* tabs[arraysize(urls)];
+  for (size_t i = 0; i < arraysize(urls); ++i) {
+    tabs[i] = new Tab();
+    tabs[i]->navigations.push_back(
+        SerializedNavigationEntryTestHelper::CreateNavigation(
+            urls[i].spec(), "title"));
+    tabs[i]->current_navigation_index = 0;
+  }
+
+  // A tab closed in this session, then the tabs closed in the previous one,
+  // then the tabs open when the previous session ended.
+  helper.AddEntry(tabs[0], false, true);
+  std::vector<TabRestoreService::Entry*> entries(1, tabs[2]);
+  helper.AddLastSessionEntries(&entries, false);
+  EXPECT_TRUE(entries.empty());
+  entries.push_back(tabs[1]);
+  helper.AddLastSessionEntries(&entries, true);
+
+  ASSERT_EQ(3U, helper.entries().size());
+  TabRestoreService::Entries::const_iterator i = helper.entries().begin();
+  for (size_t j = 0; j < arraysize(urls); ++i, ++j) {
+    EXPECT_EQ(j != 0, (*i)->from_last_session);
+    EXPECT_EQ(urls[j], static_cast<Tab*>(*i)->navigations[0].virtual_url());
+  }
+}
+
 // Regression test for crbug.com/106082
 TEST_F(PersistentTabRestoreServiceTest, PruneIsCalled) {
   CreateSessionServiceWithOneWindow(false);
@@ -7,6 +7,7 @@
 #include <limits>
 
 #include "base/file_util.h"
+#include "base/files/memory_mapped_file.h"
 #include "base/memory/scoped_vector.h"
 #include "base/metrics/histogram.h"
 #include "base/threading/thread_restrictions.h"
@@ -30,27 +31,37 @@ struct FileHeader {
   int32 version;
 };
 
+// Writes |buffer| to |file| and clears it. Returns false if not all of
+// |buffer| could be written.
+bool FlushBuffer(net::FileStream* file, std::string* buffer) {
+  if (buffer->empty())
+    return true;
+  const int size = static_cast<int>(buffer->size());
+  const int wrote = file->WriteSync(buffer->data(), size);
+  buffer->clear();
+  if (wrote != size) {
+    NOTREACHED() << "error writing";
+    return false;
+  }
+  return true;
+}
+
 // SessionFileReader ----------------------------------------------------------
 
 // SessionFileReader is responsible for reading the set of SessionCommands that
 // describe a Session back from a file. SessionFileRead does minimal error
 // checking on the file (pretty much only that the header is valid).
+//
+// The file is mapped into memory and the commands are copied straight out of
+// the mapping, rather than through an intermediate read buffer.
 
 class SessionFileReader {
  public:
   typedef SessionCommand::id_type id_type;
   typedef SessionCommand::size_type size_type;
 
-  explicit SessionFileReader(const base::FilePath& path)
-      : errored_(false),
-        buffer_(SessionBackend::kFileReadBufferSize, 0),
-        buffer_position_(0),
-        available_count_(0) {
-    file_.reset(new net::FileStream(NULL));
-    if (base::PathExists(path))
-      file_->OpenSync(path,
-                      base::PLATFORM_FILE_OPEN | base::PLATFORM_FILE_READ);
-  }
+  explicit SessionFileReader(const base::FilePath& path) : path_(path) {}
+
   // Reads the contents of the file specified in the constructor, returning
   // true on success. It is up to the caller to free all SessionCommands
   // added to commands.
@@ -58,55 +69,39 @@ class SessionFileReader {
             std::vector<SessionCommand*>* commands);
 
  private:
-  // Reads a single command, returning it. A return value of NULL indicates
-  // either there are no commands, or there was an error. Use errored_ to
-  // distinguish the two. If NULL is returned, and there is no error, it means
-  // the end of file was successfully reached.
-  SessionCommand* ReadCommand();
-
-  // Shifts the unused portion of buffer_ to the beginning and fills the
-  // remaining portion with data from the file. Returns false if the buffer
-  // couldn't be filled. A return value of false only signals an error if
-  // errored_ is set to true.
-  bool FillBuffer();
-
-  // Whether an error condition has been detected (
-  bool errored_;
+  // Reads a single command from |*data|, returning it and advancing |*data|
+  // and |*available| past it. A return value of NULL indicates there are no
+  // more commands. As writes may be cut short, a command which doesn't fit in
+  // |*available| ends the commands rather than being an error.
+  static SessionCommand* ReadCommand(const char** data, size_t* available);
 
-  // As we read from the file, data goes here.
-  std::string buffer_;
-
-  // The file.
-  scoped_ptr<net::FileStream> file_;
-
-  // Position in buffer_ of the data.
-  size_t buffer_position_;
-
-  // Number of available bytes; relative to buffer_position_.
-  size_t available_count_;
+  const base::FilePath path_;
 
   DISALLOW_COPY_AND_ASSIGN(SessionFileReader);
 };
 
 bool SessionFileReader::Read(BaseSessionService::SessionType type,
                              std::vector<SessionCommand*>* commands) {
-  if (!file_->IsOpen())
+  base::MemoryMappedFile file;
+  if (!base::PathExists(path_) || !file.Initialize(path_))
     return false;
-  FileHeader header;
-  int read_count;
   TimeTicks start_time = TimeTicks::Now();
-  read_count = file_->ReadUntilComplete(reinterpret_cast<char*>(&header),
-                                        sizeof(header));
-  if (read_count != sizeof(header) || header.signature != kFileSignature ||
+  FileHeader header;
+  if (file.length() < sizeof(header))
+    return false;
+  memcpy(&header, file.data(), sizeof(header));
+  if (header.signature != kFileSignature ||
       header.version != kFileCurrentVersion)
     return false;
 
+  const char* data = reinterpret_cast<const char*>(file.data()) +
+      sizeof(header);
+  size_t available = file.length() - sizeof(header);
   ScopedVector<SessionCommand> read_commands;
   SessionCommand* command;
-  while ((command = ReadCommand()) && !errored_)
+  while ((command = ReadCommand(&data, &available)))
     read_commands.push_back(command);
-  if (!errored_)
-    read_commands.swap(*commands);
+  read_commands.swap(*commands);
   if (type == BaseSessionService::TAB_RESTORE) {
     UMA_HISTOGRAM_TIMES("TabRestore.read_session_file_time",
                         TimeTicks::Now() - start_time);
@@ -114,26 +109,25 @@ bool SessionFileReader::Read(BaseSessionService::SessionType type,
     UMA_HISTOGRAM_TIMES("SessionRestore.read_session_file_time",
                         TimeTicks::Now() - start_time);
   }
-  return !errored_;
+  return true;
 }
 
-SessionCommand* SessionFileReader::ReadCommand() {
-  // Make sure there is enough in the buffer for the size of the next command.
-  if (available_count_ < sizeof(size_type)) {
-    if (!FillBuffer())
-      return NULL;
-    if (available_count_ < sizeof(size_type)) {
+// static
+SessionCommand* SessionFileReader::ReadCommand(const char** data,
+                                               size_t* available) {
+  // Make sure there is enough data for the size of the next command.
+  if (*available < sizeof(size_type)) {
+    if (*available > 0)
       VLOG(1) << "SessionFileReader::ReadCommand, file incomplete";
-      // Still couldn't read a valid size for the command, assume write was
-      // incomplete and return NULL.
-      return NULL;
-    }
+    // Couldn't read a valid size for the command, assume write was
+    // incomplete and return NULL.
+    return NULL;
   }
   // Get the size of the command.
   size_type command_size;
-  memcpy(&command_size, &(buffer_[buffer_position_]), sizeof(command_size));
-  buffer_position_ += sizeof(command_size);
-  available_count_ -= sizeof(command_size);
+  memcpy(&command_size, *data, sizeof(command_size));
+  *data += sizeof(command_size);
+  *available -= sizeof(command_size);
 
   if (command_size == 0) {
     VLOG(1) << "SessionFileReader::ReadCommand, empty command";
@@ -141,51 +135,26 @@ SessionCommand* SessionFileReader::ReadCommand() {
     return NULL;
   }
 
-  // Make sure buffer has the complete contents of the command.
-  if (command_size > available_count_) {
-    if (command_size > buffer_.size())
-      buffer_.resize((command_size / 1024 + 1) * 1024, 0);
-    if (!FillBuffer() || command_size > available_count_) {
-      // Again, assume the file was ok, and just the last chunk was lost.
-      VLOG(1) << "SessionFileReader::ReadCommand, last chunk lost";
-      return NULL;
-    }
+  // Make sure the file has the complete contents of the command.
+  if (command_size > *available) {
+    // Again, assume the file was ok, and just the last chunk was lost.
+    VLOG(1) << "SessionFileReader::ReadCommand, last chunk lost";
+    return NULL;
   }
-  const id_type command_id = buffer_[buffer_position_];
+  const id_type command_id = (*data)[0];
   // NOTE: command_size includes the size of the id, which is not part of
   // the contents of the SessionCommand.
   SessionCommand* command =
       new SessionCommand(command_id, command_size - sizeof(id_type));
   if (command_size > sizeof(id_type)) {
-    memcpy(command->contents(),
-           &(buffer_[buffer_position_ + sizeof(id_type)]),
+    memcpy(command->contents(), *data + sizeof(id_type),
            command_size - sizeof(id_type));
   }
-  buffer_position_ += command_size;
-  available_count_ -= command_size;
+  *data += command_size;
+  *available -= command_size;
   return command;
 }
 
-bool SessionFileReader::FillBuffer() {
-  if (available_count_ > 0 && buffer_position_ > 0) {
-    // Shift buffer to beginning.
-    memmove(&(buffer_[0]), &(buffer_[buffer_position_]), available_count_);
-  }
-  buffer_position_ = 0;
-  DCHECK(buffer_position_ + available_count_ < buffer_.size());
-  int to_read = static_cast<int>(buffer_.size() - available_count_);
-  int read_count = file_->ReadUntilComplete(&(buffer_[available_count_]),
-                                            to_read);
-  if (read_count < 0) {
-    errored_ = true;
-    return false;
-  }
-  if (read_count == 0)
-    return false;
-  available_count_ += read_count;
-  return true;
-}
-
 }  // namespace
 
 // SessionBackend -------------------------------------------------------------
@@ -199,7 +168,7 @@ static const char* kCurrentSessionFileName = "Current Session";
 static const char* kLastSessionFileName = "Last Session";
 
 // static
-const int SessionBackend::kFileReadBufferSize = 1024;
+const size_t SessionBackend::kFileWriteBufferSize = 32 * 1024;
 
 SessionBackend::SessionBackend(BaseSessionService::SessionType type,
                                const base::FilePath& path_to_dir)
@@ -306,42 +275,37 @@ bool SessionBackend::ReadCurrentSessionCommandsImpl(
 
 bool SessionBackend::AppendCommandsToFile(net::FileStream* file,
     const std::vector<SessionCommand*>& commands) {
+  // The commands are batched up, so that a reset which writes out the whole
+  // session costs a write per kFileWriteBufferSize bytes rather than three
+  // per command.
+  std::string buffer;
+  buffer.reserve(kFileWriteBufferSize);
   for (std::vector<SessionCommand*>::const_iterator i = commands.begin();
        i != commands.end(); ++i) {
-    int wrote;
     const size_type content_size = static_cast<size_type>((*i)->size());
     const size_type total_size =  content_size + sizeof(id_type);
     if (type_ == BaseSessionService::TAB_RESTORE)
       UMA_HISTOGRAM_COUNTS("TabRestore.command_size", total_size);
     else
       UMA_HISTOGRAM_COUNTS("SessionRestore.command_size", total_size);
-    wrote = file->WriteSync(reinterpret_cast<const char*>(&total_size),
-                            sizeof(total_size));
-    if (wrote != sizeof(total_size)) {
-      NOTREACHED() << "error writing";
-      return false;
-    }
-    id_type command_id = (*i)->id();
-    wrote = file->WriteSync(reinterpret_cast<char*>(&command_id),
-                            sizeof(command_id));
-    if (wrote != sizeof(command_id)) {
-      NOTREACHED() << "error writing";
+    if (buffer.size() + sizeof(total_size) + total_size >
+        kFileWriteBufferSize && !FlushBuffer(file, &buffer)) {
       return false;
     }
-    if (content_size > 0) {
-      wrote = file->WriteSync(reinterpret_cast<char*>((*i)->contents()),
-                              content_size);
-      if (wrote != content_size) {
-        NOTREACHED() << "error writing";
-        return false;
-      }
-    }
+    const id_type command_id = (*i)->id();
+    buffer.append(reinterpret_cast<const char*>(&total_size),
+                  sizeof(total_size));
+    buffer.append(reinterpret_cast<const char*>(&command_id),
+                  sizeof(command_id));
+    buffer.append((*i)->contents(), content_size);
+  }
+  if (!FlushBuffer(file, &buffer))
+    return false;
 #if defined(OS_CHROMEOS)
-    // TODO(gspencer): Remove this once we find a better place to do it.
-    // See issue http://crbug.com/245015
-    file->FlushSync();
+  // TODO(gspencer): Remove this once we find a better place to do it.
+  // See issue http://crbug.com/245015
+  file->FlushSync();
 #endif
-  }
   return true;
 }
 
@@ -129,7 +129,7 @@ TEST_F(SessionBackendTest, BigData) {
   std::vector<SessionCommand*> commands;
   commands.push_back(CreateCommandFromData(data[0]));
   const SessionCommand::size_type big_size =
-      SessionBackend::kFileReadBufferSize + 100;
+      SessionBackend::kFileWriteBufferSize + 100;
   const SessionCommand::id_type big_id = 50;
   SessionCommand* big_command = new SessionCommand(big_id, big_size);
   reinterpret_cast<char*>(big_command->contents())[0] = 'a';
@@ -201,3 +201,67 @@ TEST_F(SessionBackendTest, Truncate) {
 
   STLDeleteElements(&commands);
 }
+
+// Writes enough commands to need several writes, resetting the file first,
+// and makes sure they all come back in order.
+TEST_F(SessionBackendTest, ManyCommands) {
+  scoped_refptr<SessionBackend> backend(
+      new SessionBackend(BaseSessionService::SESSION_RESTORE, path_));
+  struct TestData first_data = { 1,  "a" };
+  std::vector<SessionCommand*> commands;
+  commands.push_back(CreateCommandFromData(first_data));
+  backend->AppendCommands(new SessionCommands(commands), false);
+  commands.clear();
+
+  const size_t kCommandCount = 2000;
+  std::vector<TestData> data(kCommandCount);
+  for (size_t i = 0; i < kCommandCount; ++i) {
+    data[i].command_id = static_cast<SessionCommand::id_type>(i % 200);
+    data[i].data = std::string(i % 50, 'a' + static_cast<char>(i % 26));
+    commands.push_back(CreateCommandFromData(data[i]));
+  }
+  backend->AppendCommands(new SessionCommands(commands), true);
+  commands.clear();
+
+  backend = NULL;
+  backend = new SessionBackend(BaseSessionService::SESSION_RESTORE, path_);
+  backend->ReadLastSessionCommandsImpl(&commands);
+  ASSERT_EQ(kCommandCount, commands.size());
+  for (size_t i = 0; i < kCommandCount; ++i)
+    AssertCommandEqualsData(data[i], commands[i]);
+  STLDeleteElements(&commands);
+}
+
+// A command cut short by an incomplete write ends the commands, without
+// losing the ones before it.
+TEST_F(SessionBackendTest, IncompleteCommand) {
+  struct TestData data[] = {
+    { 1,  "a" },
+    { 2,  "abc" },
+  };
+
+  scoped_refptr<SessionBackend> backend(
+      new SessionBackend(BaseSessionService::SESSION_RESTORE, path_));
+  std::vector<SessionCommand*> commands;
+  for (size_t i = 0; i < arraysize(data); ++i)
+    commands.push_back(CreateCommandFromData(data[i]));
+  backend->AppendCommands(new SessionCommands(commands), false);
+  commands.clear();
+  backend = NULL;
+
+  // Drop the last byte of the second command.
+  const base::FilePath session_path =
+      path_.AppendASCII("Current Session");
+  std::string contents;
+  ASSERT_TRUE(base::ReadFileToString(session_path, &contents));
+  contents.resize(contents.size() - 1);
+  ASSERT_EQ(static_cast<int>(contents.size()),
+            file_util::WriteFile(session_path, contents.data(),
+                                 static_cast<int>(contents.size())));
+
+  backend = new SessionBackend(BaseSessionService::SESSION_RESTORE, path_);
+  EXPECT_TRUE(backend->ReadLastSessionCommandsImpl(&commands));
+  ASSERT_EQ(1U, commands.size());
+  AssertCommandEqualsData(data[0], commands[0]);
+  STLDeleteElements(&commands);
+}
@@ -13,16 +13,19 @@
 #include "base/bind_helpers.h"
 #include "base/callback.h"
 #include "base/command_line.h"
+#include "base/memory/memory_pressure_listener.h"
 #include "base/memory/scoped_ptr.h"
 #include "base/memory/scoped_vector.h"
 #include "base/metrics/histogram.h"
 #include "base/platform_file.h"
 #include "base/stl_util.h"
 #include "base/strings/stringprintf.h"
+#include "base/sys_info.h"
 #include "chrome/browser/browser_process.h"
 #include "chrome/browser/chrome_notification_types.h"
 #include "chrome/browser/extensions/extension_service.h"
 #include "chrome/browser/performance_monitor/startup_timer.h"
+#include "chrome/browser/performance_monitor/startup_tracer.h"
 #include "chrome/browser/profiles/profile.h"
 #include "chrome/browser/sessions/session_service.h"
 #include "chrome/browser/sessions/session_service_factory.h"
@@ -80,11 +83,27 @@ std::set<SessionRestoreImpl*>* active_session_restorers = NULL;
 // Initial delay (see class decription for details).
 static const int kInitialDelayTimerMS = 100;
 
+// The delay stops doubling once it reaches this, so that a run of slow tabs
+// can't hold the remaining ones back for minutes.
+static const int kMaxDelayTimerMS = 5000;
+
+// The startup phase which lasts until a restored tab paints.
+static const char kFirstTabPaintedPhase[] = "SessionRestore::FirstTabPainted";
+
+// Physical memory per tab that may be loading at once, see
+// |MaxParallelTabLoads()|.
+static const int kPhysicalMemoryMBPerTabLoad = 512;
+
 // TabLoader is responsible for loading tabs after session restore creates
 // tabs. New tabs are loaded after the current tab finishes loading, or a delay
 // is reached (initially kInitialDelayTimerMS). If the delay is reached before
 // a tab finishes loading a new tab is loaded and the time of the delay
-// doubled.
+// doubled, up to kMaxDelayTimerMS.
+//
+// The most recently used tabs are loaded first, and no more tabs are loaded
+// at once than the machine has processors, or than fit in its memory at
+// kPhysicalMemoryMBPerTabLoad each. Under memory pressure the tabs which
+// haven't started loading are left alone; they load when they are selected.
 //
 // TabLoader keeps a reference to itself when it's loading. When it has finished
 // loading, it drops the reference. If another profile is restored while the
@@ -102,8 +121,9 @@ class TabLoader : public content::NotificationObserver,
   // starting timestamp is set to |restore_started|.
   static TabLoader* GetTabLoader(base::TimeTicks restore_started);
 
-  // Schedules a tab for loading.
-  void ScheduleLoad(NavigationController* controller);
+  // Schedules a tab for loading. Tabs with a more recent |last_used| time
+  // are loaded first.
+  void ScheduleLoad(NavigationController* controller, base::Time last_used);
 
   // Notifies the loader that a tab has been scheduled for loading through
   // some other mechanism.
@@ -117,8 +137,18 @@ class TabLoader : public content::NotificationObserver,
  private:
   friend class base::RefCounted<TabLoader>;
 
+  struct TabToLoad {
+    TabToLoad(NavigationController* controller, base::Time last_used)
+        : controller(controller),
+          last_used(last_used) {
+    }
+
+    NavigationController* controller;
+    base::Time last_used;
+  };
+
   typedef std::set<NavigationController*> TabsLoading;
-  typedef std::list<NavigationController*> TabsToLoad;
+  typedef std::list<TabToLoad> TabsToLoad;
   typedef std::set<RenderWidgetHost*> RenderWidgetHostSet;
 
   explicit TabLoader(base::TimeTicks restore_started);
@@ -143,10 +173,24 @@ class TabLoader : public content::NotificationObserver,
   // from.
   void RemoveTab(NavigationController* tab);
 
-  // Invoked from |force_load_timer_|. Doubles |force_load_delay_| and invokes
-  // |LoadNextTab| to load the next tab
+  // Invoked from |force_load_timer_|. Doubles |force_load_delay_|, up to
+  // kMaxDelayTimerMS, and invokes |LoadNextTab| to load the next tab
   void ForceLoadTimerFired();
 
+  // Invoked from |memory_pressure_listener_|. Leaves the tabs which haven't
+  // started loading to load when they are selected.
+  void OnMemoryPressure(
+      base::MemoryPressureListener::MemoryPressureLevel memory_pressure_level);
+
+  // Returns how many tabs may be loading at once.
+  static size_t MaxParallelTabLoads();
+
+  // Returns the position in |tabs_to_load_| of |tab|.
+  TabsToLoad::iterator FindTabToLoad(NavigationController* tab);
+
+  // Ends the startup phase for the first paint, if it is running.
+  void EndFirstPaintPhase();
+
   // Returns the RenderWidgetHost associated with a tab if there is one,
   // NULL otherwise.
   static RenderWidgetHost* GetRenderWidgetHost(NavigationController* tab);
@@ -157,6 +201,9 @@ class TabLoader : public content::NotificationObserver,
   // Called when a tab goes away or a load completes.
   void HandleTabClosedOrLoaded(NavigationController* controller);
 
+  // Records the load metrics once no tab is loading or left to load.
+  void RecordMetricsIfDone();
+
   content::NotificationRegistrar registrar_;
 
   // Current delay before a new tab is loaded. See class description for
@@ -169,6 +216,12 @@ class TabLoader : public content::NotificationObserver,
   // Have we recorded the times for a tab paint?
   bool got_first_paint_;
 
+  // Have we recorded the time for a visible tab to finish loading?
+  bool got_first_visible_load_;
+
+  // Is the first paint traced as a phase of startup?
+  bool tracing_first_paint_;
+
   // The set of tabs we've initiated loading on. This does NOT include the
   // selected tabs.
   TabsLoading tabs_loading_;
@@ -193,6 +246,11 @@ class TabLoader : public content::NotificationObserver,
   // Max number of tabs that were loaded in parallel (for metrics).
   size_t max_parallel_tab_loads_;
 
+  // The number of tabs left to load when selected (for metrics).
+  int deferred_tab_count_;
+
+  scoped_ptr<base::MemoryPressureListener> memory_pressure_listener_;
+
   // For keeping TabLoader alive while it's loading even if no
   // SessionRestoreImpls reference it.
   scoped_refptr<TabLoader> this_retainer_;
@@ -207,11 +265,15 @@ TabLoader* TabLoader::GetTabLoader(base::TimeTicks restore_started) {
   return shared_tab_loader;
 }
 
-void TabLoader::ScheduleLoad(NavigationController* controller) {
+void TabLoader::ScheduleLoad(NavigationController* controller,
+                             base::Time last_used) {
   DCHECK(controller);
-  DCHECK(find(tabs_to_load_.begin(), tabs_to_load_.end(), controller) ==
-         tabs_to_load_.end());
-  tabs_to_load_.push_back(controller);
+  DCHECK(FindTabToLoad(controller) == tabs_to_load_.end());
+  // Tabs used at the same time keep their order.
+  TabsToLoad::iterator i = tabs_to_load_.begin();
+  while (i != tabs_to_load_.end() && i->last_used >= last_used)
+    ++i;
+  tabs_to_load_.insert(i, TabToLoad(controller, last_used));
   RegisterForNotifications(controller);
 }
 
@@ -238,6 +300,14 @@ void TabLoader::StartLoading() {
       content::NOTIFICATION_RENDER_WIDGET_HOST_DID_UPDATE_BACKING_STORE,
       content::NotificationService::AllSources());
   this_retainer_ = this;
+  memory_pressure_listener_.reset(new base::MemoryPressureListener(
+      base::Bind(&TabLoader::OnMemoryPressure, base::Unretained(this))));
+  if (!got_first_paint_ && !tracing_first_paint_ &&
+      !performance_monitor::StartupTracer::GetInstance()->IsComplete()) {
+    tracing_first_paint_ = true;
+    performance_monitor::StartupTracer::GetInstance()->BeginAsyncPhase(
+        kFirstTabPaintedPhase);
+  }
 #if defined(OS_CHROMEOS)
   if (!net::NetworkChangeNotifier::IsOffline()) {
     loading_ = true;
@@ -255,21 +325,25 @@ TabLoader::TabLoader(base::TimeTicks restore_started)
     : force_load_delay_(kInitialDelayTimerMS),
       loading_(false),
       got_first_paint_(false),
+      got_first_visible_load_(false),
+      tracing_first_paint_(false),
       tab_count_(0),
       restore_started_(restore_started),
-      max_parallel_tab_loads_(0) {
+      max_parallel_tab_loads_(0),
+      deferred_tab_count_(0) {
 }
 
 TabLoader::~TabLoader() {
   DCHECK((got_first_paint_ || render_widget_hosts_to_paint_.empty()) &&
           tabs_loading_.empty() && tabs_to_load_.empty());
+  EndFirstPaintPhase();
   net::NetworkChangeNotifier::RemoveConnectionTypeObserver(this);
   shared_tab_loader = NULL;
 }
 
 void TabLoader::LoadNextTab() {
-  if (!tabs_to_load_.empty()) {
-    NavigationController* tab = tabs_to_load_.front();
+  if (!tabs_to_load_.empty() && tabs_loading_.size() < MaxParallelTabLoads()) {
+    NavigationController* tab = tabs_to_load_.front().controller;
     DCHECK(tab);
     tabs_loading_.insert(tab);
     if (tabs_loading_.size() > max_parallel_tab_loads_)
@@ -340,7 +414,20 @@ void TabLoader::Observe(int type,
     case content::NOTIFICATION_LOAD_STOP: {
       NavigationController* tab =
           content::Source<NavigationController>(source).ptr();
-      render_widget_hosts_to_paint_.insert(GetRenderWidgetHost(tab));
+      RenderWidgetHost* render_widget_host = GetRenderWidgetHost(tab);
+      if (!got_first_visible_load_ && render_widget_host &&
+          render_widget_host->GetView() &&
+          render_widget_host->GetView()->IsShowing()) {
+        // The first tab the user can interact with.
+        got_first_visible_load_ = true;
+        UMA_HISTOGRAM_CUSTOM_TIMES(
+            "SessionRestore.FirstVisibleTabLoaded",
+            base::TimeTicks::Now() - restore_started_,
+            base::TimeDelta::FromMilliseconds(10),
+            base::TimeDelta::FromSeconds(100),
+            100);
+      }
+      render_widget_hosts_to_paint_.insert(render_widget_host);
       HandleTabClosedOrLoaded(tab);
       break;
     }
@@ -382,6 +469,8 @@ void TabLoader::Observe(int type,
           // to an already existing browser and an existing tab painted.
           got_first_paint_ = true;
         }
+        if (got_first_paint_)
+          EndFirstPaintPhase();
       }
       break;
     }
@@ -421,15 +510,58 @@ void TabLoader::RemoveTab(NavigationController* tab) {
   if (i != tabs_loading_.end())
     tabs_loading_.erase(i);
 
-  TabsToLoad::iterator j =
-      find(tabs_to_load_.begin(), tabs_to_load_.end(), tab);
+  TabsToLoad::iterator j = FindTabToLoad(tab);
   if (j != tabs_to_load_.end())
     tabs_to_load_.erase(j);
 }
 
 void TabLoader::ForceLoadTimerFired() {
-  force_load_delay_ *= 2;
+  force_load_delay_ = SessionRestore::GetNextTabLoadDelayMS(force_load_delay_);
+  LoadNextTab();
+}
+
+void TabLoader::OnMemoryPressure(
+    base::MemoryPressureListener::MemoryPressureLevel memory_pressure_level) {
+  if (tabs_to_load_.empty())
+    return;
+
+  // The tabs are already marked as needing a reload, which happens once they
+  // are selected, so all there is to do is to stop tracking them.
+  deferred_tab_count_ += tabs_to_load_.size();
+  while (!tabs_to_load_.empty())
+    RemoveTab(tabs_to_load_.front().controller);
+  force_load_timer_.Stop();
   LoadNextTab();
+  RecordMetricsIfDone();
+
+  // As in |Observe()|, this may be the last reference.
+  if ((got_first_paint_ || render_widget_hosts_to_paint_.empty()) &&
+      tabs_loading_.empty())
+    this_retainer_ = NULL;
+}
+
+// static
+size_t TabLoader::MaxParallelTabLoads() {
+  const int by_memory =
+      base::SysInfo::AmountOfPhysicalMemoryMB() / kPhysicalMemoryMBPerTabLoad;
+  return static_cast<size_t>(
+      std::max(1, std::min(base::SysInfo::NumberOfProcessors(), by_memory)));
+}
+
+void TabLoader::EndFirstPaintPhase() {
+  if (!tracing_first_paint_)
+    return;
+  tracing_first_paint_ = false;
+  performance_monitor::StartupTracer::GetInstance()->EndAsyncPhase(
+      kFirstTabPaintedPhase);
+}
+
+TabLoader::TabsToLoad::iterator TabLoader::FindTabToLoad(
+    NavigationController* tab) {
+  TabsToLoad::iterator i = tabs_to_load_.begin();
+  while (i != tabs_to_load_.end() && i->controller != tab)
+    ++i;
+  return i;
 }
 
 RenderWidgetHost* TabLoader::GetRenderWidgetHost(NavigationController* tab) {
@@ -457,6 +589,10 @@ void TabLoader::HandleTabClosedOrLoaded(NavigationController* tab) {
   RemoveTab(tab);
   if (loading_)
     LoadNextTab();
+  RecordMetricsIfDone();
+}
+
+void TabLoader::RecordMetricsIfDone() {
   if (tabs_loading_.empty() && tabs_to_load_.empty()) {
     base::TimeDelta time_to_load =
         base::TimeTicks::Now() - restore_started_;
@@ -482,6 +618,10 @@ void TabLoader::HandleTabClosedOrLoaded(NavigationController* tab) {
 
     UMA_HISTOGRAM_COUNTS_100("SessionRestore.ParallelTabLoads",
                              max_parallel_tab_loads_);
+    UMA_HISTOGRAM_COUNTS_100("SessionRestore.TabsLoaded",
+                             tab_count_ - deferred_tab_count_);
+    UMA_HISTOGRAM_COUNTS_100("SessionRestore.TabsDeferred",
+                             deferred_tab_count_);
   }
 }
 
@@ -974,6 +1114,7 @@ class SessionRestoreImpl : public content::NotificationObserver {
                            int selected_tab_index) {
     VLOG(1) << "RestoreTabsToBrowser " << window.tabs.size();
     DCHECK(!window.tabs.empty());
+    browser->tab_strip_model()->BeginBatchUpdate();
     if (initial_tab_count == 0) {
       for (int i = 0; i < static_cast<int>(window.tabs.size()); ++i) {
         const SessionTab& tab = *(window.tabs[i]);
@@ -1001,6 +1142,7 @@ class SessionRestoreImpl : public content::NotificationObserver {
         RestoreTab(tab, tab_index_offset + i, browser, true);
       }
     }
+    browser->tab_strip_model()->EndBatchUpdate();
   }
 
   // |tab_index| is ignored for pinned tabs which will always be pushed behind
@@ -1061,7 +1203,8 @@ class SessionRestoreImpl : public content::NotificationObserver {
     }
 
     if (schedule_load)
-      tab_loader_->ScheduleLoad(&web_contents->GetController());
+      tab_loader_->ScheduleLoad(&web_contents->GetController(),
+                                tab.timestamp);
     return web_contents;
   }
 
@@ -1274,3 +1417,8 @@ bool SessionRestore::IsRestoringSynchronously() {
   }
   return false;
 }
+
+// static
+int64 SessionRestore::GetNextTabLoadDelayMS(int64 delay_ms) {
+  return std::min(delay_ms * 2, static_cast<int64>(kMaxDelayTimerMS));
+}
@@ -77,6 +77,11 @@ class SessionRestore {
   // Returns true if synchronously restoring a session.
   static bool IsRestoringSynchronously();
 
+  // Returns the delay after which the next tab is loaded if the tabs loading
+  // take longer than |delay_ms|: twice as long, up to a cap. Exposed for
+  // testing.
+  static int64 GetNextTabLoadDelayMS(int64 delay_ms);
+
   // The max number of non-selected tabs SessionRestore loads when restoring
   // a session. A value of 0 indicates all tabs are loaded at once.
   static size_t num_tabs_to_load_;
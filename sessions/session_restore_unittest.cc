@@ -0,0 +1,25 @@
+// Copyright 2013 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "chrome/browser/sessions/session_restore.h"
+
+#include "testing/gtest/include/gtest/gtest.h"
+
+// The delay before the next tab is loaded doubles until it reaches the cap,
+// where it then stays.
+TEST(SessionRestoreTest, TabLoadDelayIsCapped) {
+  EXPECT_EQ(200, SessionRestore::GetNextTabLoadDelayMS(100));
+  EXPECT_EQ(3200, SessionRestore::GetNextTabLoadDelayMS(1600));
+
+  int64 delay_ms = 100;
+  int64 previous_delay_ms = 0;
+  while (delay_ms != previous_delay_ms) {
+    previous_delay_ms = delay_ms;
+    delay_ms = SessionRestore::GetNextTabLoadDelayMS(delay_ms);
+    EXPECT_GE(delay_ms, previous_delay_ms);
+  }
+  EXPECT_EQ(5000, delay_ms);
+  EXPECT_EQ(5000, SessionRestore::GetNextTabLoadDelayMS(3200));
+  EXPECT_EQ(5000, SessionRestore::GetNextTabLoadDelayMS(delay_ms));
+}
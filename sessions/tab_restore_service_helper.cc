@@ -347,6 +347,32 @@ void TabRestoreServiceHelper::AddEntry(Entry* entry,
     observer_->OnAddEntry();
 }
 
+void TabRestoreServiceHelper::AddLastSessionEntries(
+    std::vector<Entry*>* entries,
+    bool newer) {
+  Entries::iterator position = entries_.end();
+  if (newer) {
+    position = entries_.begin();
+    while (position != entries_.end() && !(*position)->from_last_session)
+      ++position;
+  }
+
+  for (size_t i = 0; i < entries->size(); ++i) {
+    Entry* entry = (*entries)[i];
+    if (!FilterEntry(entry)) {
+      delete entry;
+      continue;
+    }
+    entry->from_last_session = true;
+    entries_.insert(position, entry);
+    if (observer_)
+      observer_->OnAddEntry();
+  }
+  entries->clear();
+
+  PruneEntries();
+}
+
 void TabRestoreServiceHelper::PruneEntries() {
   Entries new_entries;
 
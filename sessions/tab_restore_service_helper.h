@@ -102,6 +102,13 @@ class TabRestoreServiceHelper {
   // tab/window closes from the previous session are added to the back.
   void AddEntry(Entry* entry, bool prune, bool to_front);
 
+  // Adds |entries| loaded from the previous session and takes ownership,
+  // leaving |entries| empty. They go behind the entries of this session, and
+  // if |newer| ahead of the entries already added from the previous session,
+  // which lets each file be added as soon as it is read. Prunes the entries,
+  // but doesn't notify the observers.
+  void AddLastSessionEntries(std::vector<Entry*>* entries, bool newer);
+
   // Prunes |entries_| to contain only kMaxEntries, and removes uninteresting
   // entries.
   void PruneEntries();
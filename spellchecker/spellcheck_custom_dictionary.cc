@@ -167,6 +167,43 @@ int SanitizeWordsToRemove(const WordSet& existing, WordList& to_remove) {
   return result;
 }
 
+// Returns a change which has the same effect on the dictionary file as
+// |earlier| followed by |later|. Assumes that both changes have been sanitized.
+// The words of the returned change are sorted.
+SpellcheckCustomDictionary::Change MergeChanges(
+    const SpellcheckCustomDictionary::Change& earlier,
+    const SpellcheckCustomDictionary::Change& later) {
+  // Since both changes are sanitized, a word added by one change and removed
+  // by the other one was in the file before |earlier| if it was removed
+  // first, and was not if it was added first. Either way, the file is left
+  // as it was, so such a word is in neither of the merged lists. Adding it
+  // again would store it twice.
+  WordSet earlier_to_add(earlier.to_add().begin(), earlier.to_add().end());
+  WordSet earlier_to_remove(earlier.to_remove().begin(),
+                            earlier.to_remove().end());
+  WordSet later_to_add(later.to_add().begin(), later.to_add().end());
+  WordSet later_to_remove(later.to_remove().begin(), later.to_remove().end());
+  WordSet to_add =
+      base::STLSetDifference<WordSet>(earlier_to_add, later_to_remove);
+  WordSet later_added =
+      base::STLSetDifference<WordSet>(later_to_add, earlier_to_remove);
+  to_add.insert(later_added.begin(), later_added.end());
+  WordSet to_remove =
+      base::STLSetDifference<WordSet>(earlier_to_remove, later_to_add);
+  WordSet later_removed =
+      base::STLSetDifference<WordSet>(later_to_remove, earlier_to_add);
+  to_remove.insert(later_removed.begin(), later_removed.end());
+
+  SpellcheckCustomDictionary::Change merged;
+  for (WordSet::const_iterator it = to_add.begin(); it != to_add.end(); ++it)
+    merged.AddWord(*it);
+  for (WordSet::const_iterator it = to_remove.begin(); it != to_remove.end();
+       ++it) {
+    merged.RemoveWord(*it);
+  }
+  return merged;
+}
+
 }  // namespace
 
 
@@ -219,12 +256,22 @@ SpellcheckCustomDictionary::SpellcheckCustomDictionary(
     const base::FilePath& path)
     : custom_dictionary_path_(),
       is_loaded_(false),
+      is_save_scheduled_(false),
       weak_ptr_factory_(this) {
   custom_dictionary_path_ =
       path.Append(chrome::kCustomDictionaryFileName);
 }
 
 SpellcheckCustomDictionary::~SpellcheckCustomDictionary() {
+  // Do not lose the changes which were not written yet.
+  if (!pending_change_.empty()) {
+    BrowserThread::PostTask(
+        BrowserThread::FILE,
+        FROM_HERE,
+        base::Bind(&SpellcheckCustomDictionary::UpdateDictionaryFile,
+                   pending_change_,
+                   custom_dictionary_path_));
+  }
 }
 
 const WordSet& SpellcheckCustomDictionary::GetWords() const {
@@ -458,12 +505,34 @@ void SpellcheckCustomDictionary::Apply(
 void SpellcheckCustomDictionary::Save(
     const SpellcheckCustomDictionary::Change& dictionary_change) {
   DCHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
+  if (dictionary_change.empty())
+    return;
+  pending_change_ = MergeChanges(pending_change_, dictionary_change);
+  if (is_save_scheduled_)
+    return;
+
+  // Each write reads and rewrites the whole file, so collect the changes made
+  // until the UI thread is done with the current batch of tasks.
+  is_save_scheduled_ = true;
+  BrowserThread::PostTask(
+      BrowserThread::UI,
+      FROM_HERE,
+      base::Bind(&SpellcheckCustomDictionary::SavePendingChange,
+                 weak_ptr_factory_.GetWeakPtr()));
+}
+
+void SpellcheckCustomDictionary::SavePendingChange() {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
+  is_save_scheduled_ = false;
+  if (pending_change_.empty())
+    return;
   BrowserThread::PostTask(
       BrowserThread::FILE,
       FROM_HERE,
       base::Bind(&SpellcheckCustomDictionary::UpdateDictionaryFile,
-                 dictionary_change,
+                 pending_change_,
                  custom_dictionary_path_));
+  pending_change_ = Change();
 }
 
 syncer::SyncError SpellcheckCustomDictionary::Sync(
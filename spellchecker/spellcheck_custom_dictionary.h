@@ -148,9 +148,13 @@ class SpellcheckCustomDictionary : public SpellcheckDictionary,
   void Apply(const Change& dictionary_change);
 
   // Schedules a write of |dictionary_change| to disk. Assumes that words in
-  // |dictionary_change| are sorted.
+  // |dictionary_change| are sorted. The changes saved in a row are merged into
+  // a single write.
   void Save(const Change& dictionary_change);
 
+  // Writes the changes merged by Save() to disk.
+  void SavePendingChange();
+
   // Notifies the sync service of the |dictionary_change|. Syncs up to the
   // maximum syncable words on the server. Disables syncing of this dictionary
   // if the server contains the maximum number of syncable words.
@@ -178,6 +182,12 @@ class SpellcheckCustomDictionary : public SpellcheckDictionary,
   // True if the dictionary has been loaded. Otherwise false.
   bool is_loaded_;
 
+  // The changes to be written to disk by SavePendingChange().
+  Change pending_change_;
+
+  // True if SavePendingChange() has been posted and has not run yet.
+  bool is_save_scheduled_;
+
   // Used to create weak pointers for an instance of this class.
   base::WeakPtrFactory<SpellcheckCustomDictionary> weak_ptr_factory_;
 
@@ -7,6 +7,7 @@
 #include "base/file_util.h"
 #include "base/metrics/histogram_samples.h"
 #include "base/metrics/statistics_recorder.h"
+#include "base/run_loop.h"
 #include "base/strings/string_number_conversions.h"
 #include "chrome/browser/spellchecker/spellcheck_custom_dictionary.h"
 #include "chrome/browser/spellchecker/spellcheck_factory.h"
@@ -1141,3 +1142,53 @@ TEST_F(SpellcheckCustomDictionaryTest, HasWord) {
   EXPECT_TRUE(custom_dictionary->HasWord("foo"));
   EXPECT_FALSE(custom_dictionary->HasWord("bar"));
 }
+
+TEST_F(SpellcheckCustomDictionaryTest, SaveMergesChanges) {
+  SpellcheckService* spellcheck_service =
+      SpellcheckServiceFactory::GetForContext(&profile_);
+  SpellcheckCustomDictionary* custom_dictionary =
+      spellcheck_service->GetCustomDictionary();
+  base::RunLoop().RunUntilIdle();
+
+  custom_dictionary->AddWord("foo");
+  custom_dictionary->AddWord("bar");
+  custom_dictionary->RemoveWord("foo");
+  custom_dictionary->AddWord("baz");
+  base::RunLoop().RunUntilIdle();
+
+  WordList expected;
+  expected.push_back("bar");
+  expected.push_back("baz");
+  EXPECT_EQ(expected, LoadDictionaryFile(
+      profile_.GetPath().Append(chrome::kCustomDictionaryFileName)));
+}
+
+// Removing and adding back a word in the same burst of changes leaves the
+// dictionary file as it was.
+TEST_F(SpellcheckCustomDictionaryTest, SaveMergesRemoveThenAdd) {
+  SpellcheckService* spellcheck_service =
+      SpellcheckServiceFactory::GetForContext(&profile_);
+  SpellcheckCustomDictionary* custom_dictionary =
+      spellcheck_service->GetCustomDictionary();
+  base::RunLoop().RunUntilIdle();
+  base::FilePath path =
+      profile_.GetPath().Append(chrome::kCustomDictionaryFileName);
+
+  custom_dictionary->AddWord("foo");
+  base::RunLoop().RunUntilIdle();
+
+  custom_dictionary->RemoveWord("foo");
+  custom_dictionary->AddWord("foo");
+  custom_dictionary->AddWord("bar");
+  custom_dictionary->RemoveWord("bar");
+  base::RunLoop().RunUntilIdle();
+
+  WordList expected;
+  expected.push_back("foo");
+  EXPECT_EQ(expected, LoadDictionaryFile(path));
+
+  // The word is stored once, so removing it once removes it for good.
+  custom_dictionary->RemoveWord("foo");
+  base::RunLoop().RunUntilIdle();
+  EXPECT_TRUE(LoadDictionaryFile(path).empty());
+}
@@ -36,6 +36,7 @@ SpellcheckService::EventType g_status_type =
 
 SpellcheckService::SpellcheckService(content::BrowserContext* context)
     : context_(context),
+      is_hunspell_dictionary_initialized_(false),
       weak_ptr_factory_(this) {
   DCHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
   PrefService* prefs = user_prefs::UserPrefs::Get(context);
@@ -228,7 +229,7 @@ void SpellcheckService::Observe(int type,
 }
 
 void SpellcheckService::OnCustomDictionaryLoaded() {
-  InitForAllRenderers();
+  MaybeInitForAllRenderers();
 }
 
 void SpellcheckService::OnCustomDictionaryChanged(
@@ -243,7 +244,8 @@ void SpellcheckService::OnCustomDictionaryChanged(
 }
 
 void SpellcheckService::OnHunspellDictionaryInitialized() {
-  InitForAllRenderers();
+  is_hunspell_dictionary_initialized_ = true;
+  MaybeInitForAllRenderers();
 }
 
 void SpellcheckService::OnHunspellDictionaryDownloadBegin() {
@@ -279,6 +281,15 @@ void SpellcheckService::InitForAllRenderers() {
   }
 }
 
+void SpellcheckService::MaybeInitForAllRenderers() {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
+  if (!is_hunspell_dictionary_initialized_ || !custom_dictionary_ ||
+      !custom_dictionary_->IsLoaded()) {
+    return;
+  }
+  InitForAllRenderers();
+}
+
 void SpellcheckService::OnEnableAutoSpellCorrectChanged() {
   bool enabled = pref_change_registrar_.prefs()->GetBoolean(
       prefs::kEnableAutoSpellCorrect);
@@ -298,6 +309,7 @@ void SpellcheckService::OnSpellCheckDictionaryChanged() {
 
   std::string dictionary =
       prefs->GetString(prefs::kSpellCheckDictionary);
+  is_hunspell_dictionary_initialized_ = false;
   hunspell_dictionary_.reset(new SpellcheckHunspellDictionary(
       dictionary, context_->GetRequestContext(), this));
   hunspell_dictionary_->AddObserver(this);
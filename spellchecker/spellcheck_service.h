@@ -136,6 +136,13 @@ class SpellcheckService : public BrowserContextKeyedService,
   // Pass all renderers some basic initialization information.
   void InitForAllRenderers();
 
+  // Passes all renderers the initialization information once both the custom
+  // and the Hunspell dictionaries have finished loading. Each initialization
+  // makes the renderers rebuild their spellchecker, so the renderers which
+  // were created while the dictionaries were loading are initialized once
+  // rather than once per dictionary.
+  void MaybeInitForAllRenderers();
+
   // Reacts to a change in user preferences on whether auto-spell-correct should
   // be enabled.
   void OnEnableAutoSpellCorrectChanged();
@@ -159,6 +166,10 @@ class SpellcheckService : public BrowserContextKeyedService,
 
   scoped_ptr<SpellcheckHunspellDictionary> hunspell_dictionary_;
 
+  // True once |hunspell_dictionary_| has finished initializing, whether or not
+  // it found a dictionary file.
+  bool is_hunspell_dictionary_initialized_;
+
   scoped_ptr<spellcheck::FeedbackSender> feedback_sender_;
 
   base::WeakPtrFactory<SpellcheckService> weak_ptr_factory_;
@@ -4,10 +4,13 @@
 
 #include "chrome/browser/spellchecker/spelling_service_client.h"
 
+#include "base/bind.h"
 #include "base/command_line.h"
 #include "base/json/json_reader.h"
 #include "base/json/string_escape.h"
 #include "base/logging.h"
+#include "base/message_loop/message_loop.h"
+#include "base/metrics/histogram.h"
 #include "base/prefs/pref_service.h"
 #include "base/stl_util.h"
 #include "base/strings/string_util.h"
@@ -37,9 +40,14 @@ const char kMisspellingsPath[] = "result.spellingCheckResponse.misspellings";
 // The location of error messages in JSON response from spelling service.
 const char kErrorPath[] = "error";
 
+// The number of successful requests whose results are kept.
+const size_t kMaxCachedResults = 100;
+
 }  // namespace
 
-SpellingServiceClient::SpellingServiceClient() {
+SpellingServiceClient::SpellingServiceClient()
+    : result_cache_(kMaxCachedResults),
+      weak_ptr_factory_(this) {
 }
 
 SpellingServiceClient::~SpellingServiceClient() {
@@ -92,13 +100,34 @@ bool SpellingServiceClient::RequestTextCheck(
       country_code.c_str(),
       api_key.c_str());
 
+  // Reuse the results of an identical request, or wait for its response if it
+  // is still being sent.
+  ResultCache::iterator cached = result_cache_.Get(request);
+  if (cached != result_cache_.end()) {
+    base::MessageLoop::current()->PostTask(
+        FROM_HERE,
+        base::Bind(&SpellingServiceClient::OnCachedResults,
+                   weak_ptr_factory_.GetWeakPtr(), callback, text,
+                   cached->second));
+    return true;
+  }
+  for (std::map<const net::URLFetcher*, TextCheckCallbackData*>::iterator it =
+           spellcheck_fetchers_.begin();
+       it != spellcheck_fetchers_.end(); ++it) {
+    if (it->second->request == request) {
+      it->second->callbacks.push_back(callback);
+      return true;
+    }
+  }
+
   GURL url = GURL(kSpellingServiceURL);
   net::URLFetcher* fetcher = CreateURLFetcher(url);
   fetcher->SetRequestContext(context->GetRequestContext());
   fetcher->SetUploadData("application/json", request);
   fetcher->SetLoadFlags(
       net::LOAD_DO_NOT_SEND_COOKIES | net::LOAD_DO_NOT_SAVE_COOKIES);
-  spellcheck_fetchers_[fetcher] = new TextCheckCallbackData(callback, text);
+  spellcheck_fetchers_[fetcher] =
+      new TextCheckCallbackData(callback, text, request);
   fetcher->Start();
   return true;
 }
@@ -234,9 +263,12 @@ bool SpellingServiceClient::ParseResponse(
 
 SpellingServiceClient::TextCheckCallbackData::TextCheckCallbackData(
     TextCheckCompleteCallback callback,
-    string16 text)
-      : callback(callback),
-        text(text) {
+    string16 text,
+    std::string request)
+      : callbacks(1, callback),
+        text(text),
+        request(request),
+        start_time(base::TimeTicks::Now()) {
 }
 
 SpellingServiceClient::TextCheckCallbackData::~TextCheckCallbackData() {
@@ -248,6 +280,9 @@ void SpellingServiceClient::OnURLFetchComplete(
   scoped_ptr<const net::URLFetcher> fetcher(source);
   scoped_ptr<TextCheckCallbackData>
       callback_data(spellcheck_fetchers_[fetcher.get()]);
+  spellcheck_fetchers_.erase(fetcher.get());
+  UMA_HISTOGRAM_TIMES("SpellCheck.SpellingServiceRequestTime",
+                      base::TimeTicks::Now() - callback_data->start_time);
   bool success = false;
   std::vector<SpellCheckResult> results;
   if (fetcher->GetResponseCode() / 100 == 2) {
@@ -255,8 +290,20 @@ void SpellingServiceClient::OnURLFetchComplete(
     fetcher->GetResponseAsString(&data);
     success = ParseResponse(data, &results);
   }
-  callback_data->callback.Run(success, callback_data->text, results);
-  spellcheck_fetchers_.erase(fetcher.get());
+  if (success)
+    result_cache_.Put(callback_data->request, results);
+
+  // A callback may delete this object, which cancels the remaining ones.
+  base::WeakPtr<SpellingServiceClient> client = weak_ptr_factory_.GetWeakPtr();
+  for (size_t i = 0; i < callback_data->callbacks.size() && client; ++i)
+    callback_data->callbacks[i].Run(success, callback_data->text, results);
+}
+
+void SpellingServiceClient::OnCachedResults(
+    const TextCheckCompleteCallback& callback,
+    const string16& text,
+    const std::vector<SpellCheckResult>& results) {
+  callback.Run(true, text, results);
 }
 
 net::URLFetcher* SpellingServiceClient::CreateURLFetcher(const GURL& url) {
@@ -11,13 +11,16 @@
 
 #include "base/callback.h"
 #include "base/compiler_specific.h"
+#include "base/containers/mru_cache.h"
 #include "base/memory/scoped_ptr.h"
+#include "base/memory/weak_ptr.h"
 #include "base/strings/string16.h"
+#include "base/time/time.h"
+#include "chrome/common/spellcheck_result.h"
 #include "net/url_request/url_fetcher_delegate.h"
 
 class GURL;
 class TextCheckClientDelegate;
-struct SpellCheckResult;
 
 namespace content {
 class BrowserContext;
@@ -82,6 +85,9 @@ class SpellingServiceClient : public net::URLFetcherDelegate {
   // to the Spelling service successfully, this function returns true. (This
   // does not mean the service finishes checking text successfully.) We will
   // call |callback| when we receive a text-check response from the service.
+  // A request for the same text, type and language as a request which is still
+  // being sent is not sent again, and the results of the last successful
+  // requests are reused; |callback| is called asynchronously in either case.
   bool RequestTextCheck(content::BrowserContext* context,
                         ServiceType type,
                         const string16& text,
@@ -97,17 +103,34 @@ class SpellingServiceClient : public net::URLFetcherDelegate {
 
  private:
   struct TextCheckCallbackData {
-    TextCheckCallbackData(TextCheckCompleteCallback callback, string16 text);
+    TextCheckCallbackData(TextCheckCompleteCallback callback,
+                          string16 text,
+                          std::string request);
     ~TextCheckCallbackData();
 
-    // The callback function to be called when we receive a response from the
-    // Spelling service and parse it.
-    TextCheckCompleteCallback callback;
+    // The callback functions to be called when we receive a response from the
+    // Spelling service and parse it, one per request for this text.
+    std::vector<TextCheckCompleteCallback> callbacks;
 
     // The text checked by the Spelling service.
     string16 text;
+
+    // The JSON-RPC request sent to the Spelling service.
+    std::string request;
+
+    // The time the request was sent.
+    base::TimeTicks start_time;
   };
 
+  // The results of the last successful requests, keyed by JSON-RPC request.
+  typedef base::MRUCache<std::string, std::vector<SpellCheckResult> >
+      ResultCache;
+
+  // Calls |callback| with the cached |results| for |text|.
+  void OnCachedResults(const TextCheckCompleteCallback& callback,
+                       const string16& text,
+                       const std::vector<SpellCheckResult>& results);
+
   // net::URLFetcherDelegate implementation.
   virtual void OnURLFetchComplete(const net::URLFetcher* source) OVERRIDE;
 
@@ -118,6 +141,10 @@ class SpellingServiceClient : public net::URLFetcherDelegate {
 
   // The URLFetcher object used for sending a JSON-RPC request.
   std::map<const net::URLFetcher*, TextCheckCallbackData*> spellcheck_fetchers_;
+
+  ResultCache result_cache_;
+
+  base::WeakPtrFactory<SpellingServiceClient> weak_ptr_factory_;
 };
 
 #endif  // CHROME_BROWSER_SPELLCHECKER_SPELLING_SERVICE_CLIENT_H_
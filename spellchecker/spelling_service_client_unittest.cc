@@ -9,6 +9,7 @@
 #include "base/json/json_reader.h"
 #include "base/memory/scoped_ptr.h"
 #include "base/prefs/pref_service.h"
+#include "base/run_loop.h"
 #include "base/strings/stringprintf.h"
 #include "base/strings/utf_string_conversions.h"
 #include "base/values.h"
@@ -120,7 +121,8 @@ class TestingSpellingServiceClient : public SpellingServiceClient {
       : request_type_(0),
         response_status_(0),
         success_(false),
-        fetcher_(NULL) {
+        fetcher_(NULL),
+        fetcher_count_(0) {
   }
   virtual ~TestingSpellingServiceClient() {
   }
@@ -162,6 +164,8 @@ class TestingSpellingServiceClient : public SpellingServiceClient {
     EXPECT_EQ(corrected_text_, text);
   }
 
+  int fetcher_count() const { return fetcher_count_; }
+
   bool ParseResponseSuccess(const std::string& data) {
     std::vector<SpellCheckResult> results;
     return ParseResponse(data, &results);
@@ -174,6 +178,7 @@ class TestingSpellingServiceClient : public SpellingServiceClient {
                                           request_type_, request_text_,
                                           request_language_,
                                           response_status_, response_data_);
+    ++fetcher_count_;
     return fetcher_;
   }
 
@@ -185,6 +190,7 @@ class TestingSpellingServiceClient : public SpellingServiceClient {
   bool success_;
   string16 corrected_text_;
   TestSpellingURLFetcher* fetcher_;  // weak
+  int fetcher_count_;
 };
 
 // A test class used for testing the SpellingServiceClient class. This class
@@ -192,14 +198,18 @@ class TestingSpellingServiceClient : public SpellingServiceClient {
 // monitor the class calls the callback with expected results.
 class SpellingServiceClientTest : public testing::Test {
  public:
+  SpellingServiceClientTest() : completed_count_(0) {}
+
   void OnTextCheckComplete(int tag,
                            bool success,
                            const string16& text,
                            const std::vector<SpellCheckResult>& results) {
     client_.VerifyResponse(success, text, results);
+    ++completed_count_;
   }
 
  protected:
+  int completed_count_;
   content::TestBrowserThreadBundle thread_bundle_;
   TestingSpellingServiceClient client_;
   TestingProfile profile_;
@@ -386,3 +396,48 @@ TEST_F(SpellingServiceClientTest, ResponseErrorTest) {
   EXPECT_TRUE(client_.ParseResponseSuccess("{\"result\": {}}"));
   EXPECT_FALSE(client_.ParseResponseSuccess("{\"error\": {}}"));
 }
+
+// Verify that identical requests are sent to the Spelling service only once,
+// both while the first one is being sent and after it succeeded.
+TEST_F(SpellingServiceClientTest, ReuseIdenticalRequests) {
+  PrefService* pref = profile_.GetPrefs();
+  pref->SetBoolean(prefs::kEnableContinuousSpellcheck, true);
+  pref->SetBoolean(prefs::kSpellCheckUseSpellingService, true);
+  pref->SetString(prefs::kSpellCheckDictionary, "en");
+
+  const char kText[] = "I have bean to USA.";
+  client_.SetHTTPRequest(SpellingServiceClient::SPELLCHECK, kText, "en");
+  client_.SetHTTPResponse(200,
+      "{\n"
+      "  \"result\": {\n"
+      "    \"spellingCheckResponse\": {\n"
+      "      \"misspellings\": [{\n"
+      "        \"charStart\": 7,\n"
+      "        \"charLength\": 4,\n"
+      "        \"suggestions\": [{ \"suggestion\": \"been\" }],\n"
+      "        \"canAutoCorrect\": false\n"
+      "      }]\n"
+      "    }\n"
+      "  }\n"
+      "}");
+  client_.SetExpectedTextCheckResult(true, "I have been to USA.");
+
+  for (int i = 0; i < 2; ++i) {
+    EXPECT_TRUE(client_.RequestTextCheck(
+        &profile_, SpellingServiceClient::SPELLCHECK, ASCIIToUTF16(kText),
+        base::Bind(&SpellingServiceClientTest::OnTextCheckComplete,
+                   base::Unretained(this), 0)));
+  }
+  EXPECT_EQ(1, client_.fetcher_count());
+  client_.CallOnURLFetchComplete();
+  EXPECT_EQ(2, completed_count_);
+
+  EXPECT_TRUE(client_.RequestTextCheck(
+      &profile_, SpellingServiceClient::SPELLCHECK, ASCIIToUTF16(kText),
+      base::Bind(&SpellingServiceClientTest::OnTextCheckComplete,
+                 base::Unretained(this), 0)));
+  EXPECT_EQ(2, completed_count_);
+  base::RunLoop().RunUntilIdle();
+  EXPECT_EQ(3, completed_count_);
+  EXPECT_EQ(1, client_.fetcher_count());
+}
@@ -33,6 +33,7 @@ const char* const kKnownFileSystems[] = {
 MtabWatcherLinux::MtabWatcherLinux(const base::FilePath& mtab_path,
                                    base::WeakPtr<Delegate> delegate)
     : mtab_path_(mtab_path),
+      mtab_read_(false),
       delegate_(delegate),
       weak_ptr_factory_(this) {
   DCHECK(content::BrowserThread::CurrentlyOn(content::BrowserThread::FILE));
@@ -52,7 +53,7 @@ MtabWatcherLinux::~MtabWatcherLinux() {
   DCHECK(content::BrowserThread::CurrentlyOn(content::BrowserThread::FILE));
 }
 
-void MtabWatcherLinux::ReadMtab() const {
+void MtabWatcherLinux::ReadMtab() {
   DCHECK(content::BrowserThread::CurrentlyOn(content::BrowserThread::FILE));
 
   FILE* fp = setmntent(mtab_path_.value().c_str(), "r");
@@ -77,6 +78,11 @@ void MtabWatcherLinux::ReadMtab() const {
   }
   endmntent(fp);
 
+  if (mtab_read_ && device_map == last_device_map_)
+    return;
+  mtab_read_ = true;
+  last_device_map_ = device_map;
+
   content::BrowserThread::PostTask(
       content::BrowserThread::UI, FROM_HERE,
       base::Bind(&Delegate::UpdateMtab, delegate_, device_map));
@@ -40,8 +40,8 @@ class MtabWatcherLinux {
   ~MtabWatcherLinux();
 
  private:
-  // Reads mtab file entries into |mtab|.
-  void ReadMtab() const;
+  // Reads mtab file entries and passes them to |delegate_| if they changed.
+  void ReadMtab();
 
   // Called when |mtab_path_| changes.
   void OnFilePathChanged(const base::FilePath& path, bool error);
@@ -52,6 +52,12 @@ class MtabWatcherLinux {
   // Watcher for |mtab_path_|.
   base::FilePathWatcher file_watcher_;
 
+  // The entries last passed to |delegate_|. Mtab also changes when file
+  // systems this class ignores are mounted, so this avoids sending the same
+  // entries again. |mtab_read_| is false until the first read.
+  MountPointDeviceMap last_device_map_;
+  bool mtab_read_;
+
   base::WeakPtr<Delegate> delegate_;
 
   base::WeakPtrFactory<MtabWatcherLinux> weak_ptr_factory_;
@@ -265,6 +265,8 @@ StorageMonitorLinux::~StorageMonitorLinux() {
 void StorageMonitorLinux::Init() {
   DCHECK(!mtab_path_.empty());
 
+  init_start_time_ = base::TimeTicks::Now();
+
   BrowserThread::PostTaskAndReplyWithResult(
       BrowserThread::FILE, FROM_HERE,
       base::Bind(&CreateMtabWatcherLinuxOnFileThread,
@@ -469,7 +471,7 @@ void StorageMonitorLinux::UpdateMtab(const MountPointDeviceMap& new_mtab) {
     BrowserThread::PostTaskAndReply(
         BrowserThread::FILE, FROM_HERE,
         base::Bind(&base::DoNothing),
-        base::Bind(&StorageMonitorLinux::MarkInitialized,
+        base::Bind(&StorageMonitorLinux::OnInitialMountsProbed,
                    weak_ptr_factory_.GetWeakPtr()));
   }
 }
@@ -513,6 +515,18 @@ void StorageMonitorLinux::AddNewMount(const base::FilePath& mount_device,
   receiver()->ProcessAttach(*storage_info);
 }
 
+void StorageMonitorLinux::OnInitialMountsProbed() {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
+  if (IsInitialized())
+    return;
+
+  if (!init_start_time_.is_null()) {
+    UMA_HISTOGRAM_TIMES("RemovableDeviceNotificationsLinux.InitializationTime",
+                        base::TimeTicks::Now() - init_start_time_);
+  }
+  MarkInitialized();
+}
+
 StorageMonitor* StorageMonitor::Create() {
   const base::FilePath kDefaultMtabPath("/etc/mtab");
   return new StorageMonitorLinux(kDefaultMtabPath);
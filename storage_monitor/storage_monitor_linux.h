@@ -24,6 +24,7 @@
 #include "base/files/file_path_watcher.h"
 #include "base/memory/scoped_ptr.h"
 #include "base/memory/weak_ptr.h"
+#include "base/time/time.h"
 #include "chrome/browser/storage_monitor/mtab_watcher_linux.h"
 #include "chrome/browser/storage_monitor/storage_monitor.h"
 #include "content/public/browser/browser_thread.h"
@@ -109,6 +110,9 @@ class StorageMonitorLinux : public StorageMonitor,
   void AddNewMount(const base::FilePath& mount_device,
                    scoped_ptr<StorageInfo> storage_info);
 
+  // Called when the mounts found on the first mtab read have been probed.
+  void OnInitialMountsProbed();
+
   // Mtab file that lists the mount points.
   const base::FilePath mtab_path_;
 
@@ -134,6 +138,9 @@ class StorageMonitorLinux : public StorageMonitor,
 
   scoped_ptr<MtabWatcherLinux, MtabWatcherLinuxDeleter> mtab_watcher_;
 
+  // When Init() was called, to record how long initialization takes.
+  base::TimeTicks init_start_time_;
+
   base::WeakPtrFactory<StorageMonitorLinux> weak_ptr_factory_;
 
   DISALLOW_COPY_AND_ASSIGN(StorageMonitorLinux);
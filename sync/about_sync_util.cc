@@ -9,6 +9,8 @@
 #include "base/strings/string16.h"
 #include "base/values.h"
 #include "chrome/browser/signin/signin_manager.h"
+#include "chrome/browser/sync/glue/favicon_cache.h"
+#include "chrome/browser/sync/glue/session_model_associator.h"
 #include "chrome/browser/sync/profile_sync_service.h"
 #include "chrome/common/chrome_version_info.h"
 #include "sync/api/time.h"
@@ -265,6 +267,10 @@ scoped_ptr<DictionaryValue> ConstructAboutInformation(
   IntSyncStat nudge_source_local(section_nudge_info, "Local Changes");
   IntSyncStat nudge_source_local_refresh(section_nudge_info, "Local Refreshes");
 
+  ListValue* section_favicons = AddSection(stats_list, "Synced Favicons");
+  IntSyncStat favicons_in_memory(section_favicons, "Favicons In Memory");
+  IntSyncStat favicon_image_bytes(section_favicons, "Favicon Image Bytes");
+
   // This list of sections belongs in the 'details' field of the returned
   // message.
   about_info->Set(kDetailsKey, stats_list);
@@ -393,6 +399,17 @@ scoped_ptr<DictionaryValue> ConstructAboutInformation(
     entries.SetValue(snapshot.num_entries());
   }
 
+  browser_sync::SessionModelAssociator* session_associator =
+      service->GetSessionModelAssociator();
+  if (session_associator) {
+    size_t num_favicons = 0;
+    size_t image_bytes = 0;
+    session_associator->GetFaviconCache()->GetMemoryUsage(&num_favicons,
+                                                          &image_bytes);
+    favicons_in_memory.SetValue(static_cast<int>(num_favicons));
+    favicon_image_bytes.SetValue(static_cast<int>(image_bytes));
+  }
+
   // The values set from this point onwards do not belong in the
   // details list.
 
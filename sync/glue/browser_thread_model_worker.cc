@@ -6,6 +6,7 @@
 
 #include "base/bind.h"
 #include "base/synchronization/waitable_event.h"
+#include "chrome/browser/sync/glue/model_worker_timing.h"
 #include "content/public/browser/browser_thread.h"
 
 using base::WaitableEvent;
@@ -32,7 +33,7 @@ syncer::SyncerError BrowserThreadModelWorker::DoWorkAndWaitUntilDoneImpl(
       thread_,
       FROM_HERE,
       base::Bind(&BrowserThreadModelWorker::CallDoWorkAndSignalTask,
-                 this, work,
+                 this, WrapWorkWithTiming(group_, work),
                  work_done_or_stopped(), &error))) {
     DLOG(WARNING) << "Failed to post task to thread " << thread_;
     error = syncer::CANNOT_DO_WORK;
@@ -14,7 +14,10 @@ using syncer::ModelType;
 namespace browser_sync {
 
 FakeDataTypeController::FakeDataTypeController(ModelType type)
-      : state_(NOT_RUNNING), model_load_delayed_(false), type_(type) {}
+      : state_(NOT_RUNNING),
+        model_load_delayed_(false),
+        type_(type),
+        model_safe_group_(syncer::GROUP_PASSIVE) {}
 
 FakeDataTypeController::~FakeDataTypeController() {
 }
@@ -115,10 +118,8 @@ std::string FakeDataTypeController::name() const {
   return ModelTypeToString(type_);
 }
 
-// This isn't called by the DTM.
 syncer::ModelSafeGroup FakeDataTypeController::model_safe_group() const {
-  ADD_FAILURE();
-  return syncer::GROUP_PASSIVE;
+  return model_safe_group_;
 }
 
 DataTypeController::State FakeDataTypeController::state() const {
@@ -146,4 +147,8 @@ void FakeDataTypeController::SimulateModelLoadFinishing() {
   model_load_callback.Run(type(), syncer::SyncError());
 }
 
+void FakeDataTypeController::SetModelSafeGroup(syncer::ModelSafeGroup group) {
+  model_safe_group_ = group;
+}
+
 }  // namespace browser_sync
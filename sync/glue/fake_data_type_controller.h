@@ -53,6 +53,8 @@ class FakeDataTypeController : public DataTypeController {
 
   virtual void SimulateModelLoadFinishing();
 
+  void SetModelSafeGroup(syncer::ModelSafeGroup group);
+
  protected:
   virtual ~FakeDataTypeController();
 
@@ -60,6 +62,7 @@ class FakeDataTypeController : public DataTypeController {
   DataTypeController::State state_;
   bool model_load_delayed_;
   syncer::ModelType type_;
+  syncer::ModelSafeGroup model_safe_group_;
   StartCallback last_start_callback_;
   ModelLoadCallback model_load_callback_;
 };
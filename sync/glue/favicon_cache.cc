@@ -4,6 +4,8 @@
 
 #include "chrome/browser/sync/glue/favicon_cache.h"
 
+#include <string.h>
+
 #include "base/message_loop/message_loop.h"
 #include "base/metrics/histogram.h"
 #include "chrome/browser/chrome_notification_types.h"
@@ -134,6 +136,23 @@ chrome::FaviconBitmapResult GetImageDataFromSpecifics(
   return bitmap_result;
 }
 
+// Updates |bitmap_result| with the protobuf image data, keeping the bytes it
+// already holds if they are the same. Remote updates mostly echo images we
+// already have, and this avoids copying them again.
+void UpdateImageDataFromSpecifics(const sync_pb::FaviconData& favicon_data,
+                                  chrome::FaviconBitmapResult* bitmap_result) {
+  const std::string& bytes = favicon_data.favicon();
+  const base::RefCountedMemory* old_data = bitmap_result->bitmap_data.get();
+  if (old_data && old_data->size() == bytes.size() &&
+      (bytes.empty() ||
+       memcmp(old_data->front(), bytes.data(), bytes.size()) == 0)) {
+    bitmap_result->pixel_size.set_height(favicon_data.height());
+    bitmap_result->pixel_size.set_width(favicon_data.width());
+    return;
+  }
+  *bitmap_result = GetImageDataFromSpecifics(favicon_data);
+}
+
 // Convert a FaviconBitmapResult into protobuf image data.
 void FillSpecificsWithImageData(
     const chrome::FaviconBitmapResult& bitmap_result,
@@ -845,20 +864,20 @@ void FaviconCache::MergeSyncFavicon(const syncer::SyncData& sync_favicon,
     // Remote image data always clobbers local image data.
     bool needs_update = false;
     if (image_specifics.has_favicon_web()) {
-      favicon_info->bitmap_data[SIZE_16] = GetImageDataFromSpecifics(
-          image_specifics.favicon_web());
+      UpdateImageDataFromSpecifics(image_specifics.favicon_web(),
+                                   &favicon_info->bitmap_data[SIZE_16]);
     } else if (favicon_info->bitmap_data[SIZE_16].bitmap_data.get()) {
       needs_update = true;
     }
     if (image_specifics.has_favicon_web_32()) {
-      favicon_info->bitmap_data[SIZE_32] = GetImageDataFromSpecifics(
-          image_specifics.favicon_web_32());
+      UpdateImageDataFromSpecifics(image_specifics.favicon_web_32(),
+                                   &favicon_info->bitmap_data[SIZE_32]);
     } else if (favicon_info->bitmap_data[SIZE_32].bitmap_data.get()) {
       needs_update = true;
     }
     if (image_specifics.has_favicon_touch_64()) {
-      favicon_info->bitmap_data[SIZE_64] = GetImageDataFromSpecifics(
-          image_specifics.favicon_touch_64());
+      UpdateImageDataFromSpecifics(image_specifics.favicon_touch_64(),
+                                   &favicon_info->bitmap_data[SIZE_64]);
     } else if (favicon_info->bitmap_data[SIZE_64].bitmap_data.get()) {
       needs_update = true;
     }
@@ -1031,6 +1050,24 @@ void FaviconCache::DropSyncedFavicon(FaviconMap::iterator favicon_iter) {
   synced_favicons_.erase(favicon_iter);
 }
 
+void FaviconCache::GetMemoryUsage(size_t* num_favicons,
+                                  size_t* image_bytes) const {
+  // Image data may be shared (e.g. with the favicon service results it was
+  // loaded from), so count each buffer once.
+  std::set<const base::RefCountedMemory*> counted_images;
+  *image_bytes = 0;
+  for (FaviconMap::const_iterator iter = synced_favicons_.begin();
+       iter != synced_favicons_.end(); ++iter) {
+    for (int i = 0; i < NUM_SIZES; ++i) {
+      const base::RefCountedMemory* image =
+          iter->second->bitmap_data[i].bitmap_data.get();
+      if (image && counted_images.insert(image).second)
+        *image_bytes += image->size();
+    }
+  }
+  *num_favicons = synced_favicons_.size();
+}
+
 size_t FaviconCache::NumFaviconsForTest() const {
   return synced_favicons_.size();
 }
@@ -6,6 +6,7 @@
 #define CHROME_BROWSER_SYNC_GLUE_FAVICON_CACHE_H_
 
 #include <map>
+#include <set>
 #include <string>
 
 #include "base/basictypes.h"
@@ -97,6 +98,10 @@ class FaviconCache : public syncer::SyncableService,
                              const std::string& icon_bytes,
                              int64 visit_time_ms);
 
+  // Fills |num_favicons| with the number of favicons held in memory and
+  // |image_bytes| with the size of their image data.
+  void GetMemoryUsage(size_t* num_favicons, size_t* image_bytes) const;
+
   // NotificationObserver implementation.
   virtual void Observe(int type,
                        const content::NotificationSource& source,
@@ -542,6 +542,29 @@ TEST_F(SyncFaviconCacheTest, MultipleMappings) {
   EXPECT_TRUE(ExpectFaviconEquals(page2_url, bytes));
 }
 
+// Memory usage should count every favicon and its image bytes.
+TEST_F(SyncFaviconCacheTest, MemoryUsage) {
+  size_t num_favicons = 1;
+  size_t image_bytes = 1;
+  cache()->GetMemoryUsage(&num_favicons, &image_bytes);
+  EXPECT_EQ(0U, num_favicons);
+  EXPECT_EQ(0U, image_bytes);
+
+  std::string bytes = "bytes";
+  std::string bytes2 = "more bytes";
+  TriggerSyncFaviconReceived(GURL("http://www.google.com"),
+                             GURL("http://www.google.com/favicon.ico"),
+                             bytes,
+                             0);
+  TriggerSyncFaviconReceived(GURL("http://www.bing.com"),
+                             GURL("http://www.bing.com/favicon.ico"),
+                             bytes2,
+                             0);
+  cache()->GetMemoryUsage(&num_favicons, &image_bytes);
+  EXPECT_EQ(2U, num_favicons);
+  EXPECT_EQ(bytes.size() + bytes2.size(), image_bytes);
+}
+
 TEST_F(SyncFaviconCacheTest, SyncEmpty) {
   syncer::SyncMergeResult merge_result =
       cache()->MergeDataAndStartSyncing(syncer::FAVICON_IMAGES,
@@ -957,11 +980,20 @@ TEST_F(SyncFaviconCacheTest, ReceiveSameImages) {
   }
 
   SetUpInitialSync(initial_image_data, initial_tracking_data);
+  scoped_refptr<base::RefCountedMemory> old_favicon;
+  ASSERT_TRUE(cache()->GetSyncedFaviconForFaviconURL(
+      BuildFaviconData(0).icon_url, &old_favicon));
 
   // Now receive the new icons as an update.
   cache()->ProcessSyncChanges(FROM_HERE, same_changes);
   EXPECT_EQ(0U, processor()->GetAndResetChangeList().size());
   ASSERT_TRUE(VerifyLocalIcons(expected_icons));
+
+  // The unchanged image data should not have been copied.
+  scoped_refptr<base::RefCountedMemory> new_favicon;
+  ASSERT_TRUE(cache()->GetSyncedFaviconForFaviconURL(
+      BuildFaviconData(0).icon_url, &new_favicon));
+  EXPECT_EQ(old_favicon.get(), new_favicon.get());
 }
 
 // Receiving stale tracking (old visit times) should result in pushing back
@@ -5,8 +5,11 @@
 #include "chrome/browser/sync/glue/generic_change_processor.h"
 
 #include "base/location.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/metrics/histogram.h"
 #include "base/strings/string_number_conversions.h"
 #include "base/strings/utf_string_conversions.h"
+#include "base/time/time.h"
 #include "content/public/browser/browser_thread.h"
 #include "sync/api/sync_change.h"
 #include "sync/api/sync_error.h"
@@ -319,15 +322,26 @@ syncer::SyncError GenericChangeProcessor::ProcessSyncChanges(
     const tracked_objects::Location& from_here,
     const syncer::SyncChangeList& list_of_changes) {
   DCHECK(CalledOnValidThread());
+  base::TimeTicks start_time = base::TimeTicks::Now();
   syncer::WriteTransaction trans(from_here, share_handle());
 
+  // The root node of the type of the last added entry. The changes of a
+  // batch are normally all of one type, so it is only looked up once.
+  scoped_ptr<syncer::ReadNode> root_node;
+  syncer::ModelType root_node_type = syncer::UNSPECIFIED;
+  syncer::ModelType last_type = syncer::UNSPECIFIED;
+  std::string type_str;
+
   for (syncer::SyncChangeList::const_iterator iter = list_of_changes.begin();
        iter != list_of_changes.end();
        ++iter) {
     const syncer::SyncChange& change = *iter;
     DCHECK_NE(change.sync_data().GetDataType(), syncer::UNSPECIFIED);
     syncer::ModelType type = change.sync_data().GetDataType();
-    std::string type_str = syncer::ModelTypeToString(type);
+    if (type != last_type) {
+      type_str = syncer::ModelTypeToString(type);
+      last_type = type;
+    }
     syncer::WriteNode sync_node(&trans);
     if (change.change_type() == syncer::SyncChange::ACTION_DELETE) {
       syncer::SyncError error =
@@ -344,10 +358,15 @@ syncer::SyncError GenericChangeProcessor::ProcessSyncChanges(
     } else if (change.change_type() == syncer::SyncChange::ACTION_ADD) {
       // TODO(sync): Handle other types of creation (custom parents, folders,
       // etc.).
-      syncer::ReadNode root_node(&trans);
-      if (root_node.InitByTagLookup(
-              syncer::ModelTypeToRootTag(change.sync_data().GetDataType())) !=
-                  syncer::BaseNode::INIT_OK) {
+      if (root_node_type != type) {
+        root_node.reset(new syncer::ReadNode(&trans));
+        root_node_type = syncer::UNSPECIFIED;
+        if (root_node->InitByTagLookup(syncer::ModelTypeToRootTag(type)) ==
+                syncer::BaseNode::INIT_OK) {
+          root_node_type = type;
+        }
+      }
+      if (root_node_type != type) {
         syncer::SyncError error(FROM_HERE,
                                 syncer::SyncError::DATATYPE_ERROR,
                                 "Failed to look up root node for type " +
@@ -361,7 +380,7 @@ syncer::SyncError GenericChangeProcessor::ProcessSyncChanges(
       }
       syncer::WriteNode::InitUniqueByCreationResult result =
           sync_node.InitUniqueByCreation(change.sync_data().GetDataType(),
-                                         root_node,
+                                         *root_node,
                                          change.sync_data().GetTag());
       if (result != syncer::WriteNode::INIT_SUCCESS) {
         std::string error_prefix = "Failed to create " + type_str + " node: " +
@@ -526,6 +545,11 @@ syncer::SyncError GenericChangeProcessor::ProcessSyncChanges(
       return error;
     }
   }
+
+  UMA_HISTOGRAM_TIMES("Sync.ProcessSyncChangesTime",
+                      base::TimeTicks::Now() - start_time);
+  UMA_HISTOGRAM_COUNTS("Sync.ProcessSyncChangesBatchSize",
+                       list_of_changes.size());
   return syncer::SyncError();
 }
 
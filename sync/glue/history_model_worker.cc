@@ -7,6 +7,7 @@
 #include "base/memory/ref_counted.h"
 #include "base/message_loop/message_loop.h"
 #include "base/synchronization/waitable_event.h"
+#include "chrome/browser/sync/glue/model_worker_timing.h"
 #include "content/public/browser/browser_thread.h"
 
 using base::WaitableEvent;
@@ -105,9 +106,12 @@ void HistoryModelWorker::RegisterOnDBThread() {
 syncer::SyncerError HistoryModelWorker::DoWorkAndWaitUntilDoneImpl(
     const syncer::WorkCallback& work) {
   syncer::SyncerError error = syncer::UNSET;
+  // The time spent queued includes the hop through the UI thread.
+  syncer::WorkCallback timed_work =
+      WrapWorkWithTiming(syncer::GROUP_HISTORY, work);
   if (BrowserThread::PostTask(BrowserThread::UI, FROM_HERE,
                               base::Bind(&PostWorkerTask, history_service_,
-                                         work, &cancelable_consumer_,
+                                         timed_work, &cancelable_consumer_,
                                          work_done_or_stopped(),
                                          &error))) {
     work_done_or_stopped()->Wait();
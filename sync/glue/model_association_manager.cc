@@ -12,6 +12,7 @@
 #include "base/message_loop/message_loop.h"
 #include "base/metrics/histogram.h"
 #include "sync/internal_api/public/base/model_type.h"
+#include "sync/util/data_type_histogram.h"
 
 using content::BrowserThread;
 using syncer::ModelTypeSet;
@@ -121,7 +122,6 @@ ModelAssociationManager::ModelAssociationManager(
     const DataTypeController::TypeMap* controllers,
     ModelAssociationResultProcessor* processor)
     : state_(IDLE),
-      currently_associating_(NULL),
       controllers_(controllers),
       result_processor_(processor),
       weak_ptr_factory_(this) {
@@ -168,7 +168,8 @@ void ModelAssociationManager::Initialize(syncer::ModelTypeSet desired_types) {
 
   pending_model_load_.clear();
   waiting_to_associate_.clear();
-  currently_associating_ = NULL;
+  currently_associating_.clear();
+  fatal_result_.reset();
 
   // Add any data type controllers into that needs_stop_ list that are
   // currently MODEL_STARTING, ASSOCIATING, RUNNING or DISABLED.
@@ -216,6 +217,7 @@ void ModelAssociationManager::ResetForReconfiguration() {
   associating_types_.Clear();
   failed_data_types_info_.clear();
   needs_crypto_types_.Clear();
+  fatal_result_.reset();
 }
 
 void ModelAssociationManager::StopDisabledTypes() {
@@ -235,19 +237,25 @@ void ModelAssociationManager::Stop() {
     DVLOG(1) << "ModelAssociationManager: In the middle of configuration while"
              << " stopping";
     state_ = ABORTED;
-    DCHECK(currently_associating_ != NULL ||
+    DCHECK(!currently_associating_.empty() ||
            needs_start_.size() > 0 ||
            pending_model_load_.size() > 0 ||
            waiting_to_associate_.size() > 0);
-
-    if (currently_associating_) {
-      TRACE_EVENT_ASYNC_END1("sync", "ModelAssociation",
-                             currently_associating_,
-                             "DataType",
-                             ModelTypeToString(currently_associating_->type()));
-      DVLOG(1) << "ModelAssociationManager: stopping "
-               << currently_associating_->name();
-      currently_associating_->Stop();
+    fatal_result_.reset();
+
+    if (!currently_associating_.empty()) {
+      // Stopping a type runs its TypeStartCallback, which removes it from
+      // |currently_associating_|, so stop a copy.
+      std::vector<DataTypeController*> associating;
+      for (AssociatingMap::const_iterator it = currently_associating_.begin();
+           it != currently_associating_.end(); ++it) {
+        associating.push_back(it->first);
+      }
+      for (size_t i = 0; i < associating.size(); ++i) {
+        DVLOG(1) << "ModelAssociationManager: stopping "
+                 << associating[i]->name();
+        associating[i]->Stop();
+      }
     } else {
       // DTCs in other lists would be stopped below.
       state_ = IDLE;
@@ -324,31 +332,41 @@ void ModelAssociationManager::AppendToFailedDatatypesAndLogError(
 }
 
 void ModelAssociationManager::TypeStartCallback(
+    syncer::ModelType type,
     DataTypeController::StartResult start_result,
     const syncer::SyncMergeResult& local_merge_result,
     const syncer::SyncMergeResult& syncer_merge_result) {
   DCHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
-  TRACE_EVENT_ASYNC_END1("sync", "ModelAssociation",
-                         currently_associating_,
-                         "DataType",
-                         ModelTypeToString(currently_associating_->type()));
+  DataTypeController::TypeMap::const_iterator dtc_it = controllers_->find(type);
+  DCHECK(dtc_it != controllers_->end());
+  DataTypeController* started_dtc = dtc_it->second.get();
+
+  // We are done with this type. Clear it. Types which failed to load never
+  // started associating.
+  base::Time type_association_start_time = base::Time::Now();
+  AssociatingMap::iterator it = currently_associating_.find(started_dtc);
+  if (it != currently_associating_.end()) {
+    TRACE_EVENT_ASYNC_END1("sync", "ModelAssociation",
+                           started_dtc,
+                           "DataType",
+                           ModelTypeToString(type));
+    type_association_start_time = it->second;
+    currently_associating_.erase(it);
+  }
 
   DVLOG(1) << "ModelAssociationManager: TypeStartCallback";
   if (state_ == ABORTED) {
-    // Now that we have finished with the current type we can stop
+    // Now that we have finished with the types associating we can stop
     // if abort was called.
     DVLOG(1) << "ModelAssociationManager: Doing an early return"
              << " because of abort";
-    state_ = IDLE;
+    if (currently_associating_.empty())
+      state_ = IDLE;
     return;
   }
 
   DCHECK(state_ == CONFIGURING);
 
-  // We are done with this type. Clear it.
-  DataTypeController* started_dtc = currently_associating_;
-  currently_associating_ = NULL;
-
   if (start_result == DataTypeController::ASSOCIATION_FAILED) {
     DVLOG(1) << "ModelAssociationManager: Encountered a failed type";
     AppendToFailedDatatypesAndLogError(start_result,
@@ -364,9 +382,14 @@ void ModelAssociationManager::TypeStartCallback(
        start_result == DataTypeController::ASSOCIATION_FAILED) &&
       syncer::ProtocolTypes().Has(local_merge_result.model_type())) {
     base::TimeDelta association_wait_time =
-        current_type_association_start_time_ - association_start_time_;
+        type_association_start_time - association_start_time_;
     base::TimeDelta association_time =
-        base::Time::Now() - current_type_association_start_time_;
+        base::Time::Now() - type_association_start_time;
+#define PER_DATA_TYPE_MACRO(type_str) \
+    UMA_HISTOGRAM_LONG_TIMES("Sync." type_str "AssociationWaitTime", \
+                             association_wait_time);
+    SYNC_DATA_TYPE_HISTOGRAM(type);
+#undef PER_DATA_TYPE_MACRO
     syncer::DataTypeAssociationStats stats =
         BuildAssociationStatsFromMergeResults(local_merge_result,
                                               syncer_merge_result,
@@ -411,20 +434,22 @@ void ModelAssociationManager::TypeStartCallback(
   std::map<syncer::ModelType, syncer::SyncError> errors;
   errors[local_merge_result.model_type()] = local_merge_result.error();
 
-  // Put our state to idle.
-  state_ = IDLE;
-
-  DataTypeManager::ConfigureResult configure_result(configure_status,
-                                                    associating_types_,
-                                                    errors,
-                                                    syncer::ModelTypeSet(),
-                                                    needs_crypto_types_);
-  result_processor_->OnModelAssociationDone(configure_result);
+  // Only the first such failure is reported, once the types of other model
+  // safe groups that are still associating are done.
+  if (!fatal_result_) {
+    fatal_result_.reset(new DataTypeManager::ConfigureResult(
+        configure_status,
+        associating_types_,
+        errors,
+        syncer::ModelTypeSet(),
+        needs_crypto_types_));
+  }
+  StartAssociatingNextType();
 }
 
 void ModelAssociationManager::LoadModelForNextType() {
   DVLOG(1) << "ModelAssociationManager: LoadModelForNextType";
-  if (!needs_start_.empty()) {
+  if (!needs_start_.empty() && !fatal_result_) {
     DVLOG(1) << "ModelAssociationManager: Starting " << needs_start_[0]->name();
 
     DataTypeController* dtc = needs_start_[0];
@@ -468,11 +493,13 @@ void ModelAssociationManager::ModelLoadCallback(
         // the timer, if the type that loaded is the same as the type that
         // we started the timer for(as indicated by the type on the head
         // of the list).
-        // Note: Regardless of this timer value the associations will always
-        // take place serially. The only thing this timer controls is how serial
-        // the model load is. If this timer has a value of zero seconds then
-        // the model loads will all be parallel.
-        if (it == pending_model_load_.begin()) {
+        // Note: Regardless of this timer value the associations of types of
+        // the same model safe group will always take place serially. The only
+        // thing this timer controls is how serial the model load is. If this
+        // timer has a value of zero seconds then the model loads will all be
+        // parallel.
+        bool was_timed = (it == pending_model_load_.begin());
+        if (was_timed) {
           DVLOG(1) << "ModelAssociationManager: Stopping timer";
           timer_.Stop();
         }
@@ -483,11 +510,16 @@ void ModelAssociationManager::ModelLoadCallback(
                   << " Calling StartAssociatingNextType";
           waiting_to_associate_.push_back(dtc);
           StartAssociatingNextType();
+          // Load the next type while this one associates, so that it can
+          // associate alongside if it belongs to another model safe group.
+          if (was_timed && state_ == CONFIGURING)
+            LoadModelForNextType();
         } else {
           DVLOG(1) << "ModelAssociationManager: Encountered error loading";
           syncer::SyncMergeResult local_merge_result(type);
           local_merge_result.set_error(error);
-          TypeStartCallback(DataTypeController::ASSOCIATION_FAILED,
+          TypeStartCallback(type,
+                            DataTypeController::ASSOCIATION_FAILED,
                             local_merge_result,
                             syncer::SyncMergeResult(type));
        }
@@ -513,24 +545,52 @@ void ModelAssociationManager::ModelLoadCallback(
 }
 
 void ModelAssociationManager::StartAssociatingNextType() {
-  DCHECK_EQ(state_, CONFIGURING);
-  DCHECK_EQ(currently_associating_, static_cast<DataTypeController*>(NULL));
+  // A type may finish associating synchronously and finish the configuration
+  // from a nested call.
+  if (state_ != CONFIGURING)
+    return;
 
   DVLOG(1) << "ModelAssociationManager: StartAssociatingNextType";
-  if (!waiting_to_associate_.empty()) {
-    DVLOG(1) << "ModelAssociationManager: Starting "
-            << waiting_to_associate_[0]->name();
-    DataTypeController* dtc = waiting_to_associate_[0];
-    waiting_to_associate_.erase(waiting_to_associate_.begin());
-    currently_associating_ = dtc;
-    current_type_association_start_time_ = base::Time::Now();
+  while (!fatal_result_) {
+    // Start the first waiting type whose model safe group is free. Types of
+    // the same group keep their relative order.
+    std::vector<DataTypeController*>::iterator it =
+        waiting_to_associate_.begin();
+    while (it != waiting_to_associate_.end() &&
+           IsGroupAssociating((*it)->model_safe_group())) {
+      ++it;
+    }
+    if (it == waiting_to_associate_.end())
+      break;
+
+    DataTypeController* dtc = *it;
+    DVLOG(1) << "ModelAssociationManager: Starting " << dtc->name();
+    waiting_to_associate_.erase(it);
+    currently_associating_[dtc] = base::Time::Now();
     TRACE_EVENT_ASYNC_BEGIN1("sync", "ModelAssociation",
-                             currently_associating_,
+                             dtc,
                              "DataType",
-                             ModelTypeToString(currently_associating_->type()));
+                             ModelTypeToString(dtc->type()));
     dtc->StartAssociating(base::Bind(
         &ModelAssociationManager::TypeStartCallback,
-        weak_ptr_factory_.GetWeakPtr()));
+        weak_ptr_factory_.GetWeakPtr(),
+        dtc->type()));
+    if (state_ != CONFIGURING)
+      return;
+  }
+
+  // Wait for the types still associating, and for the type whose model load
+  // is being waited for.
+  if (!currently_associating_.empty())
+    return;
+  if (fatal_result_) {
+    state_ = IDLE;
+    scoped_ptr<DataTypeManager::ConfigureResult> result(fatal_result_.Pass());
+    result_processor_->OnModelAssociationDone(*result);
+    return;
+  }
+  if (!waiting_to_associate_.empty() || !needs_start_.empty() ||
+      timer_.IsRunning()) {
     return;
   }
 
@@ -570,6 +630,16 @@ void ModelAssociationManager::StartAssociatingNextType() {
   return;
 }
 
+bool ModelAssociationManager::IsGroupAssociating(
+    syncer::ModelSafeGroup group) const {
+  for (AssociatingMap::const_iterator it = currently_associating_.begin();
+       it != currently_associating_.end(); ++it) {
+    if (it->first->model_safe_group() == group)
+      return true;
+  }
+  return false;
+}
+
 syncer::ModelTypeSet ModelAssociationManager::GetTypesWaitingToLoad() {
   syncer::ModelTypeSet result;
   for (std::vector<DataTypeController*>::const_iterator it =
@@ -7,6 +7,7 @@
 
 #include <map>
 
+#include "base/memory/scoped_ptr.h"
 #include "base/memory/weak_ptr.h"
 #include "base/timer/timer.h"
 
@@ -101,8 +102,9 @@ class ModelAssociationManager {
       std::vector<DataTypeController*>* needs_start);
 
   // Callback passed to each data type controller on starting association. This
-  // callback will be invoked when the model association is done.
-  void TypeStartCallback(DataTypeController::StartResult start_result,
+  // callback will be invoked when the model association of |type| is done.
+  void TypeStartCallback(syncer::ModelType type,
+                         DataTypeController::StartResult start_result,
                          const syncer::SyncMergeResult& local_merge_result,
                          const syncer::SyncMergeResult& syncer_merge_result);
 
@@ -113,10 +115,14 @@ class ModelAssociationManager {
   // Calls the |LoadModels| method on the next controller waiting to start.
   void LoadModelForNextType();
 
-  // Calls |StartAssociating| on the next available controller whose models are
-  // loaded.
+  // Calls |StartAssociating| on the controllers whose models are loaded and
+  // whose model safe group has no other type associating, and reports the
+  // result once all types are done.
   void StartAssociatingNextType();
 
+  // Returns true if a type of |group| is currently doing model association.
+  bool IsGroupAssociating(syncer::ModelSafeGroup group) const;
+
   // When a type fails to load or fails associating this method is invoked to
   // do the book keeping and do the UMA reporting.
   void AppendToFailedDatatypesAndLogError(
@@ -154,7 +160,7 @@ class ModelAssociationManager {
   //    |waiting_to_associate_|
   // Step 4 : |StartAssociatingNextType| - |waiting_to_associate_| ->
   //    |currently_associating_|
-  // Step 5 : |TypeStartCallback| - |currently_associating_| set to NULL.
+  // Step 5 : |TypeStartCallback| - removed from |currently_associating_|.
 
   // Controllers that need to be started during a config cycle.
   std::vector<DataTypeController*> needs_start_;
@@ -176,9 +182,16 @@ class ModelAssociationManager {
   // types.
   base::Time association_start_time_;
 
-  // Controller currently doing model association.
-  DataTypeController* currently_associating_;
-  base::Time current_type_association_start_time_;
+  // Controllers currently doing model association, with the time each of
+  // them started. Types of different model safe groups run on different
+  // threads, so one type per group may associate at a time.
+  typedef std::map<DataTypeController*, base::Time> AssociatingMap;
+  AssociatingMap currently_associating_;
+
+  // Set when a type failed in a way that requires reconfiguration. No more
+  // types are started, and this is reported once the types still associating
+  // are done.
+  scoped_ptr<DataTypeManager::ConfigureResult> fatal_result_;
 
   // Set of all registered controllers.
   const DataTypeController::TypeMap* controllers_;
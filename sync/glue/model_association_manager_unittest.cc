@@ -97,6 +97,58 @@ TEST_F(SyncModelAssociationManagerTest, SimpleModelStart) {
       DataTypeController::OK);
 }
 
+// Start types of two model safe groups and make sure a type of each group
+// associates at the same time, while types of the same group wait.
+TEST_F(SyncModelAssociationManagerTest, ConcurrentAssociationAcrossGroups) {
+  controllers_[syncer::BOOKMARKS] =
+      new FakeDataTypeController(syncer::BOOKMARKS);
+  controllers_[syncer::APPS] =
+      new FakeDataTypeController(syncer::APPS);
+  controllers_[syncer::AUTOFILL] =
+      new FakeDataTypeController(syncer::AUTOFILL);
+  GetController(controllers_, syncer::BOOKMARKS)->SetModelSafeGroup(
+      syncer::GROUP_UI);
+  GetController(controllers_, syncer::APPS)->SetModelSafeGroup(
+      syncer::GROUP_UI);
+  GetController(controllers_, syncer::AUTOFILL)->SetModelSafeGroup(
+      syncer::GROUP_DB);
+  ModelAssociationManager model_association_manager(&controllers_,
+                                                    &result_processor_);
+  syncer::ModelTypeSet types(syncer::BOOKMARKS, syncer::APPS,
+                             syncer::AUTOFILL);
+  DataTypeManager::ConfigureResult expected_result(
+      DataTypeManager::OK,
+      types,
+      std::map<syncer::ModelType, syncer::SyncError>(),
+      syncer::ModelTypeSet(),
+      syncer::ModelTypeSet());
+
+  model_association_manager.Initialize(types);
+  model_association_manager.StopDisabledTypes();
+  model_association_manager.StartAssociationAsync(types);
+
+  EXPECT_EQ(GetController(controllers_, syncer::BOOKMARKS)->state(),
+            DataTypeController::ASSOCIATING);
+  EXPECT_EQ(GetController(controllers_, syncer::APPS)->state(),
+            DataTypeController::MODEL_LOADED);
+  EXPECT_EQ(GetController(controllers_, syncer::AUTOFILL)->state(),
+            DataTypeController::ASSOCIATING);
+
+  GetController(controllers_, syncer::AUTOFILL)->FinishStart(
+      DataTypeController::OK);
+  EXPECT_EQ(GetController(controllers_, syncer::APPS)->state(),
+            DataTypeController::MODEL_LOADED);
+  GetController(controllers_, syncer::BOOKMARKS)->FinishStart(
+      DataTypeController::OK);
+  EXPECT_EQ(GetController(controllers_, syncer::APPS)->state(),
+            DataTypeController::ASSOCIATING);
+
+  EXPECT_CALL(result_processor_, OnModelAssociationDone(_)).
+              WillOnce(VerifyResult(expected_result));
+  GetController(controllers_, syncer::APPS)->FinishStart(
+      DataTypeController::OK);
+}
+
 // Start a type and call stop before it finishes associating.
 TEST_F(SyncModelAssociationManagerTest, StopModelBeforeFinish) {
   controllers_[syncer::BOOKMARKS] =
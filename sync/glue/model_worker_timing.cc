@@ -0,0 +1,48 @@
+// Copyright 2013 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "chrome/browser/sync/glue/model_worker_timing.h"
+
+#include <string>
+
+#include "base/bind.h"
+#include "base/metrics/histogram.h"
+#include "base/time/time.h"
+
+namespace browser_sync {
+
+namespace {
+
+void RecordTime(const std::string& name, base::TimeDelta time) {
+  // Equivalent to UMA_HISTOGRAM_TIMES, which needs a constant name.
+  base::HistogramBase* histogram = base::Histogram::FactoryTimeGet(
+      name,
+      base::TimeDelta::FromMilliseconds(1),
+      base::TimeDelta::FromSeconds(10),
+      50,
+      base::HistogramBase::kUmaTargetedHistogramFlag);
+  histogram->AddTime(time);
+}
+
+syncer::SyncerError RunWorkWithTiming(syncer::ModelSafeGroup group,
+                                      base::TimeTicks post_time,
+                                      const syncer::WorkCallback& work) {
+  const std::string group_name = syncer::ModelSafeGroupToString(group);
+  base::TimeTicks start_time = base::TimeTicks::Now();
+  RecordTime("Sync.ModelWorkerQueueTime." + group_name,
+             start_time - post_time);
+  syncer::SyncerError error = work.Run();
+  RecordTime("Sync.ModelWorkerRunTime." + group_name,
+             base::TimeTicks::Now() - start_time);
+  return error;
+}
+
+}  // namespace
+
+syncer::WorkCallback WrapWorkWithTiming(syncer::ModelSafeGroup group,
+                                        const syncer::WorkCallback& work) {
+  return base::Bind(&RunWorkWithTiming, group, base::TimeTicks::Now(), work);
+}
+
+}  // namespace browser_sync
@@ -0,0 +1,20 @@
+// Copyright 2013 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CHROME_BROWSER_SYNC_GLUE_MODEL_WORKER_TIMING_H_
+#define CHROME_BROWSER_SYNC_GLUE_MODEL_WORKER_TIMING_H_
+
+#include "sync/internal_api/public/engine/model_safe_worker.h"
+
+namespace browser_sync {
+
+// Returns a callback which runs |work| and records, per |group|, how long it
+// waited between this call and being run, and how long it ran. To be called
+// on the sync thread just before |work| is posted to the model thread.
+syncer::WorkCallback WrapWorkWithTiming(syncer::ModelSafeGroup group,
+                                        const syncer::WorkCallback& work);
+
+}  // namespace browser_sync
+
+#endif  // CHROME_BROWSER_SYNC_GLUE_MODEL_WORKER_TIMING_H_
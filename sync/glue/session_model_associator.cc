@@ -11,6 +11,7 @@
 #include "base/bind.h"
 #include "base/location.h"
 #include "base/logging.h"
+#include "base/metrics/histogram.h"
 #include "base/safe_numerics.h"
 #include "base/strings/utf_string_conversions.h"
 #include "base/threading/sequenced_worker_pool.h"
@@ -108,6 +109,11 @@ static const int kMaxSyncNavigationCount = 6;
 // stale and becomes a candidate for garbage collection.
 static const size_t kDefaultStaleSessionThresholdDays = 14;  // 2 weeks.
 
+// Unchanged tabs and headers are still rewritten after this many minutes, so
+// that the modification time of their sync nodes, which other clients use to
+// order the tabs and to expire stale sessions, stays current.
+static const int kUnchangedRewriteIntervalMinutes = 5;
+
 // Maximum number of favicons to sync.
 // TODO(zea): pull this from the server.
 static const int kMaxSyncFavicons = 200;
@@ -121,6 +127,8 @@ SessionModelAssociator::SessionModelAssociator(
       local_session_syncid_(syncer::kInvalidId),
       sync_service_(sync_service),
       stale_session_threshold_days_(kDefaultStaleSessionThresholdDays),
+      unchanged_rewrite_interval_(
+          base::TimeDelta::FromMinutes(kUnchangedRewriteIntervalMinutes)),
       setup_for_test_(false),
       waiting_for_change_(false),
       test_weak_factory_(this),
@@ -139,6 +147,8 @@ SessionModelAssociator::SessionModelAssociator(ProfileSyncService* sync_service,
       local_session_syncid_(syncer::kInvalidId),
       sync_service_(sync_service),
       stale_session_threshold_days_(kDefaultStaleSessionThresholdDays),
+      unchanged_rewrite_interval_(
+          base::TimeDelta::FromMinutes(kUnchangedRewriteIntervalMinutes)),
       setup_for_test_(setup_for_test),
       waiting_for_change_(false),
       test_weak_factory_(this),
@@ -292,6 +302,16 @@ bool SessionModelAssociator::AssociateWindows(bool reload_tabs,
   // Free memory for closed windows and tabs.
   synced_session_tracker_.CleanupSession(local_tag);
 
+  // Most tab events don't change the window layout, so only rewrite the
+  // header when its data did, or to refresh its modification time.
+  std::string serialized_header = specifics.SerializeAsString();
+  const base::Time now = base::Time::Now();
+  if (serialized_header == last_synced_header_ &&
+      now - last_synced_header_time_ < unchanged_rewrite_interval_) {
+    if (waiting_for_change_) QuitLoopForSubtleTesting();
+    return true;
+  }
+
   syncer::WriteTransaction trans(FROM_HERE, sync_service_->GetUserShare());
   syncer::WriteNode header_node(&trans);
   if (header_node.InitByIdLookup(local_session_syncid_) !=
@@ -305,6 +325,10 @@ bool SessionModelAssociator::AssociateWindows(bool reload_tabs,
     return false;
   }
   header_node.SetSessionSpecifics(specifics);
+  UMA_HISTOGRAM_COUNTS("Sync.SessionHeaderBytesCommitted",
+                       serialized_header.size());
+  last_synced_header_.swap(serialized_header);
+  last_synced_header_time_ = now;
   if (waiting_for_change_) QuitLoopForSubtleTesting();
   return true;
 }
@@ -426,7 +450,29 @@ bool SessionModelAssociator::WriteTabContentsToSyncModel(
   DVLOG(1) << "Local tab " << tab_delegate.GetSessionId()
            << " now has URL " << new_url.spec();
 
-  SessionTab* session_tab = NULL;
+  base::TimeTicks start_time = base::TimeTicks::Now();
+
+  // Build the new tab data from the in-memory tracker before touching the
+  // sync model, so that tabs whose synced data did not change (e.g. a title
+  // update for an entry outside the synced navigation window, or a load
+  // progress notification) don't open a write transaction at all. They are
+  // still rewritten once in a while to keep the node's modification time
+  // current.
+  const base::Time now = base::Time::Now();
+  SessionTab* session_tab =
+      synced_session_tracker_.GetTab(GetCurrentMachineTag(),
+                                     tab_delegate.GetSessionId(),
+                                     tab_node_id);
+  SetSessionTabFromDelegate(tab_delegate, now, session_tab);
+  sync_pb::SessionTab tab_s = session_tab->ToSyncData();
+  std::string serialized_tab = tab_s.SerializeAsString();
+  bool unchanged = new_url == old_tab_url &&
+      serialized_tab == tab_link->last_synced_tab() &&
+      now - tab_link->last_synced_time() < unchanged_rewrite_interval_;
+  UMA_HISTOGRAM_BOOLEAN("Sync.SessionTabUnchanged", unchanged);
+  if (unchanged)
+    return true;
+
   {
     syncer::WriteTransaction trans(FROM_HERE, sync_service_->GetUserShare());
     syncer::WriteNode tab_node(&trans);
@@ -443,17 +489,10 @@ bool SessionModelAssociator::WriteTabContentsToSyncModel(
       return false;
     }
 
-    // Load the last stored version of this tab so we can compare changes. If
-    // this is a new tab, session_tab will be a new, blank SessionTab object.
+    // Load the last stored version of this tab to carry over its favicon.
     sync_pb::SessionSpecifics specifics = tab_node.GetSessionSpecifics();
     const int s_tab_node_id(specifics.tab_node_id());
     DCHECK_EQ(tab_node_id, s_tab_node_id);
-    session_tab =
-        synced_session_tracker_.GetTab(GetCurrentMachineTag(),
-                                       tab_delegate.GetSessionId(),
-                                       specifics.tab_node_id());
-    SetSessionTabFromDelegate(tab_delegate, base::Time::Now(), session_tab);
-    sync_pb::SessionTab tab_s = session_tab->ToSyncData();
 
     if (new_url == old_tab_url) {
       // Load the old specifics and copy over the favicon data if needed.
@@ -468,11 +507,16 @@ bool SessionModelAssociator::WriteTabContentsToSyncModel(
 
     // Write into the actual sync model.
     tab_node.SetSessionSpecifics(specifics);
+    UMA_HISTOGRAM_COUNTS("Sync.SessionTabBytesCommitted", specifics.ByteSize());
   }
+  UMA_HISTOGRAM_TIMES("Sync.SessionTabWriteTime",
+                      base::TimeTicks::Now() - start_time);
 
   // Trigger the favicon load if needed. We do this outside the write
   // transaction to avoid jank.
   tab_link->set_url(new_url);
+  tab_link->set_last_synced_tab(serialized_tab);
+  tab_link->set_last_synced_time(now);
   if (new_url != old_tab_url) {
     favicon_cache_.OnFaviconVisited(new_url,
                                     GetCurrentFaviconURL(tab_delegate));
@@ -581,6 +625,8 @@ syncer::SyncError SessionModelAssociator::AssociateModels(
   DCHECK_EQ(0U, local_tab_pool_.Capacity());
 
   local_session_syncid_ = syncer::kInvalidId;
+  last_synced_header_.clear();
+  last_synced_header_time_ = base::Time();
 
   scoped_ptr<DeviceInfo> local_device_info(sync_service_->GetLocalDeviceInfo());
 
@@ -675,6 +721,8 @@ syncer::SyncError SessionModelAssociator::DisassociateModels() {
   local_tab_map_.clear();
   local_tab_pool_.Clear();
   local_session_syncid_ = syncer::kInvalidId;
+  last_synced_header_.clear();
+  last_synced_header_time_ = base::Time();
   current_machine_tag_ = "";
   current_session_name_ = "";
 
@@ -174,6 +174,11 @@ class SessionModelAssociator
   // stale.
   void SetStaleSessionThreshold(size_t stale_session_threshold_days);
 
+  // Sets how long unchanged tabs and headers go without being rewritten.
+  void set_unchanged_rewrite_interval_for_testing(base::TimeDelta interval) {
+    unchanged_rewrite_interval_ = interval;
+  }
+
   // Delete a foreign session and all its sync data.
   void DeleteForeignSession(const std::string& tag);
 
@@ -245,10 +250,18 @@ class SessionModelAssociator
 
     void set_tab(const SyncedTabDelegate* tab) { tab_ = tab; }
     void set_url(const GURL& url) { url_ = url; }
+    void set_last_synced_tab(const std::string& last_synced_tab) {
+      last_synced_tab_ = last_synced_tab;
+    }
+    void set_last_synced_time(base::Time last_synced_time) {
+      last_synced_time_ = last_synced_time;
+    }
 
     int tab_node_id() const { return tab_node_id_; }
     const SyncedTabDelegate* tab() const { return tab_; }
     const GURL& url() const { return url_; }
+    const std::string& last_synced_tab() const { return last_synced_tab_; }
+    base::Time last_synced_time() const { return last_synced_time_; }
 
    private:
     DISALLOW_COPY_AND_ASSIGN(TabLink);
@@ -261,6 +274,13 @@ class SessionModelAssociator
 
     // The currently visible url of the tab (used for syncing favicons).
     GURL url_;
+
+    // The serialized sync_pb::SessionTab last written to the tab's sync node,
+    // without favicon data. Empty until the tab is first written.
+    std::string last_synced_tab_;
+
+    // When |last_synced_tab_| was written.
+    base::Time last_synced_time_;
   };
 
   // Container for accessing local tab data by tab id.
@@ -354,6 +374,11 @@ class SessionModelAssociator
   // client.
   int64 local_session_syncid_;
 
+  // The serialized header specifics last written to |local_session_syncid_|,
+  // used to skip rewriting an unchanged header, and when it was written.
+  std::string last_synced_header_;
+  base::Time last_synced_header_time_;
+
   // Mapping of current open (local) tabs to their sync identifiers.
   TabLinksMap local_tab_map_;
 
@@ -366,6 +391,9 @@ class SessionModelAssociator
   // stale and a candidate for garbage collection.
   size_t stale_session_threshold_days_;
 
+  // How long unchanged tabs and headers go without being rewritten.
+  base::TimeDelta unchanged_rewrite_interval_;
+
   // To avoid certain checks not applicable to tests.
   bool setup_for_test_;
 
@@ -11,6 +11,7 @@
 #include "base/logging.h"
 #include "base/metrics/histogram.h"
 #include "base/strings/utf_string_conversions.h"
+#include "base/time/time.h"
 #include "chrome/browser/history/history_backend.h"
 #include "chrome/browser/sync/profile_sync_service.h"
 #include "net/base/net_util.h"
@@ -155,7 +156,10 @@ syncer::SyncError TypedUrlModelAssociator::AssociateModels(
     syncer::SyncMergeResult* local_merge_result,
     syncer::SyncMergeResult* syncer_merge_result) {
   ClearErrorStats();
+  base::TimeTicks start_time = base::TimeTicks::Now();
   syncer::SyncError error = DoAssociateModels();
+  UMA_HISTOGRAM_TIMES("Sync.TypedUrlAssociationTime",
+                      base::TimeTicks::Now() - start_time);
   UMA_HISTOGRAM_PERCENTAGE("Sync.TypedUrlModelAssociationErrors",
                            GetErrorPercentage());
   ClearErrorStats();
@@ -201,10 +205,16 @@ syncer::SyncError TypedUrlModelAssociator::DoAssociateModels() {
           model_type());
     }
 
-    // Get all the visits.
+    // Get all the visits, except for the URLs which haven't changed since
+    // they were last merged.
+    std::set<std::string> unchanged_urls = GetUnchangedUrls(typed_urls);
     std::map<history::URLID, history::VisitVector> visit_vectors;
     for (history::URLRows::iterator ix = typed_urls.begin();
          ix != typed_urls.end();) {
+      if (unchanged_urls.count(ix->url().spec())) {
+        ++ix;
+        continue;
+      }
       DCHECK_EQ(0U, visit_vectors.count(ix->id()));
       if (!FixupURLAndGetVisits(&(*ix), &(visit_vectors[ix->id()])) ||
           ShouldIgnoreUrl(ix->url()) ||
@@ -216,6 +226,10 @@ syncer::SyncError TypedUrlModelAssociator::DoAssociateModels() {
         ++ix;
       }
     }
+    UMA_HISTOGRAM_COUNTS("Sync.TypedUrlAssociationUnchangedUrls",
+                         unchanged_urls.size());
+    UMA_HISTOGRAM_COUNTS("Sync.TypedUrlAssociationVisitFetches",
+                         visit_vectors.size());
 
     syncer::WriteTransaction trans(FROM_HERE, sync_service_->GetUserShare());
     syncer::ReadNode typed_url_root(&trans);
@@ -234,6 +248,10 @@ syncer::SyncError TypedUrlModelAssociator::DoAssociateModels() {
       std::string tag = ix->url().spec();
       // Empty URLs should be filtered out by ShouldIgnoreUrl() previously.
       DCHECK(!tag.empty());
+      if (unchanged_urls.count(tag)) {
+        current_urls.insert(tag);
+        continue;
+      }
       history::VisitVector& visits = visit_vectors[ix->id()];
 
       syncer::ReadNode node(&trans);
@@ -396,6 +414,39 @@ syncer::SyncError TypedUrlModelAssociator::DoAssociateModels() {
   return syncer::SyncError();
 }
 
+std::set<std::string> TypedUrlModelAssociator::GetUnchangedUrls(
+    const history::URLRows& typed_urls) {
+  std::set<std::string> unchanged_urls;
+  syncer::ReadTransaction trans(FROM_HERE, sync_service_->GetUserShare());
+  for (history::URLRows::const_iterator ix = typed_urls.begin();
+       ix != typed_urls.end(); ++ix) {
+    if (ShouldIgnoreUrl(ix->url()))
+      continue;
+    std::string tag = ix->url().spec();
+    syncer::ReadNode node(&trans);
+    if (node.InitByClientTagLookup(syncer::TYPED_URLS, tag) !=
+            syncer::BaseNode::INIT_OK) {
+      continue;
+    }
+    const sync_pb::TypedUrlSpecifics& typed_url = node.GetTypedUrlSpecifics();
+    // Nodes with expired visits are merged so that the visits are dropped.
+    if (typed_url.visits_size() == 0 ||
+        typed_url.visits_size() != typed_url.visit_transitions_size() ||
+        history_backend_->IsExpiredVisitTime(
+            base::Time::FromInternalValue(typed_url.visits(0)))) {
+      continue;
+    }
+    if (typed_url.visits(typed_url.visits_size() - 1) !=
+            ix->last_visit().ToInternalValue() ||
+        UTF8ToUTF16(typed_url.title()) != ix->title() ||
+        typed_url.hidden() != ix->hidden()) {
+      continue;
+    }
+    unchanged_urls.insert(tag);
+  }
+  return unchanged_urls;
+}
+
 void TypedUrlModelAssociator::UpdateFromSyncDB(
     const sync_pb::TypedUrlSpecifics& typed_url,
     TypedUrlVisitVector* visits_to_add,
@@ -6,6 +6,7 @@
 #define CHROME_BROWSER_SYNC_GLUE_TYPED_URL_MODEL_ASSOCIATOR_H_
 
 #include <map>
+#include <set>
 #include <string>
 #include <utility>
 #include <vector>
@@ -184,6 +185,12 @@ class TypedUrlModelAssociator : public AssociatorInterface {
   // of sync, based on the visits the URL had.
   bool ShouldIgnoreVisits(const history::VisitVector& visits);
 
+  // Returns the specs of the URLs in |typed_urls| whose sync node has the
+  // same last visit, title and hidden state as the history DB. Neither side
+  // has had a visit since such a node was last merged, so the visits of these
+  // URLs don't have to be fetched and merged again.
+  std::set<std::string> GetUnchangedUrls(const history::URLRows& typed_urls);
+
   ProfileSyncService* sync_service_;
   history::HistoryBackend* history_backend_;
 
@@ -14,6 +14,7 @@
 #include "chrome/browser/history/history_service_factory.h"
 #include "chrome/browser/invalidation/invalidation_service_factory.h"
 #include "chrome/browser/password_manager/password_store_factory.h"
+#include "chrome/browser/performance_monitor/startup_tracer.h"
 #include "chrome/browser/profiles/profile.h"
 #include "chrome/browser/profiles/profile_manager.h"
 #include "chrome/browser/search_engines/template_url_service_factory.h"
@@ -83,6 +84,8 @@ ProfileSyncServiceFactory::~ProfileSyncServiceFactory() {
 
 BrowserContextKeyedService* ProfileSyncServiceFactory::BuildServiceInstanceFor(
     content::BrowserContext* context) const {
+  performance_monitor::ScopedStartupPhase startup_phase(
+      "ProfileSyncServiceFactory::BuildServiceInstanceFor");
   Profile* profile = static_cast<Profile*>(context);
 
   ProfileSyncService::StartBehavior behavior =
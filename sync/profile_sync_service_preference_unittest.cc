@@ -31,6 +31,7 @@
 #include "chrome/test/base/testing_profile.h"
 #include "components/user_prefs/pref_registry_syncable.h"
 #include "google_apis/gaia/gaia_constants.h"
+#include "sync/api/sync_change.h"
 #include "sync/api/sync_data.h"
 #include "sync/internal_api/public/base/model_type.h"
 #include "sync/internal_api/public/change_record.h"
@@ -40,6 +41,7 @@
 #include "sync/internal_api/public/write_node.h"
 #include "sync/internal_api/public/write_transaction.h"
 #include "sync/protocol/preference_specifics.pb.h"
+#include "sync/protocol/sync.pb.h"
 #include "testing/gmock/include/gmock/gmock.h"
 #include "testing/gtest/include/gtest/gtest.h"
 
@@ -483,6 +485,37 @@ TEST_F(ProfileSyncServicePreferenceTest, UpdatedSyncNodeActionAdd) {
       pref_sync_service_->registered_preferences().count(prefs::kHomePage));
 }
 
+// Only the last change to a preference in a batch is applied, unless its
+// value can't be read. The last valid change is applied then.
+TEST_F(ProfileSyncServicePreferenceTest, ProcessSyncChangesLastValidChange) {
+  CreateRootHelper create_root(this, syncer::PREFERENCES);
+  ASSERT_TRUE(StartSyncService(create_root.callback(), false));
+  ASSERT_TRUE(create_root.success());
+
+  sync_pb::EntitySpecifics specifics;
+  sync_pb::PreferenceSpecifics* pref_specifics =
+      specifics.mutable_preference();
+  pref_specifics->set_name(prefs::kHomePage);
+  syncer::SyncChangeList changes;
+  const std::string values[] = {
+    ValueString(base::StringValue(example_url0_)),
+    ValueString(base::StringValue(example_url1_)),
+    "not json",
+  };
+  for (size_t i = 0; i < arraysize(values); ++i) {
+    pref_specifics->set_value(values[i]);
+    changes.push_back(syncer::SyncChange(
+        FROM_HERE, syncer::SyncChange::ACTION_UPDATE,
+        syncer::SyncData::CreateLocalData(
+            prefs::kHomePage, prefs::kHomePage, specifics)));
+  }
+  EXPECT_FALSE(
+      pref_sync_service_->ProcessSyncChanges(FROM_HERE, changes).IsSet());
+
+  base::StringValue expected(example_url1_);
+  EXPECT_TRUE(expected.Equals(&GetPreferenceValue(prefs::kHomePage)));
+}
+
 TEST_F(ProfileSyncServicePreferenceTest, UpdatedSyncNodeUnknownPreference) {
   CreateRootHelper create_root(this, syncer::PREFERENCES);
   ASSERT_TRUE(StartSyncService(create_root.callback(), false));
@@ -1216,6 +1216,119 @@ TEST_F(ProfileSyncServiceSessionTest, CheckPrerenderedWebContentsSwap) {
   ASSERT_FALSE(error.IsSet());
 }
 
+// Test that tabs and headers are only written to the sync model when their
+// synced data changed.
+TEST_F(ProfileSyncServiceSessionTest, UnchangedTabsNotRewritten) {
+  AddTab(browser(), GURL("http://foo1"));
+  NavigateAndCommitActiveTab(GURL("http://foo2"));
+  CreateRootHelper create_root(this);
+  ASSERT_TRUE(StartSyncService(create_root.callback(), false));
+  std::string local_tag = model_associator_->GetCurrentMachineTag();
+  std::string tab_tag = TabNodePool::TabIdToTag(local_tag, 0);
+  syncer::SyncError error;
+
+  // Mark the nodes behind the associator's back, so that any rewrite of them
+  // is visible.
+  {
+    syncer::WriteTransaction trans(FROM_HERE, sync_service_->GetUserShare());
+    syncer::WriteNode header_node(&trans);
+    ASSERT_EQ(syncer::BaseNode::INIT_OK,
+              header_node.InitByClientTagLookup(syncer::SESSIONS, local_tag));
+    sync_pb::SessionSpecifics header_specifics =
+        header_node.GetSessionSpecifics();
+    header_specifics.mutable_header()->set_client_name("marked");
+    header_node.SetSessionSpecifics(header_specifics);
+
+    syncer::WriteNode tab_node(&trans);
+    ASSERT_EQ(syncer::BaseNode::INIT_OK,
+              tab_node.InitByClientTagLookup(syncer::SESSIONS, tab_tag));
+    sync_pb::SessionSpecifics tab_specifics = tab_node.GetSessionSpecifics();
+    tab_specifics.mutable_tab()->set_pinned(true);
+    tab_node.SetSessionSpecifics(tab_specifics);
+  }
+
+  // Nothing changed, so nothing is rewritten.
+  EXPECT_TRUE(model_associator_->AssociateWindows(true, &error));
+  ASSERT_FALSE(error.IsSet());
+  {
+    syncer::ReadTransaction trans(FROM_HERE, sync_service_->GetUserShare());
+    syncer::ReadNode header_node(&trans);
+    ASSERT_EQ(syncer::BaseNode::INIT_OK,
+              header_node.InitByClientTagLookup(syncer::SESSIONS, local_tag));
+    EXPECT_EQ("marked",
+              header_node.GetSessionSpecifics().header().client_name());
+    syncer::ReadNode tab_node(&trans);
+    ASSERT_EQ(syncer::BaseNode::INIT_OK,
+              tab_node.InitByClientTagLookup(syncer::SESSIONS, tab_tag));
+    EXPECT_TRUE(tab_node.GetSessionSpecifics().tab().pinned());
+  }
+
+  // A navigation rewrites the tab, but not the unchanged header.
+  NavigateAndCommitActiveTab(GURL("http://foo3"));
+  EXPECT_TRUE(model_associator_->AssociateWindows(true, &error));
+  ASSERT_FALSE(error.IsSet());
+  {
+    syncer::ReadTransaction trans(FROM_HERE, sync_service_->GetUserShare());
+    syncer::ReadNode header_node(&trans);
+    ASSERT_EQ(syncer::BaseNode::INIT_OK,
+              header_node.InitByClientTagLookup(syncer::SESSIONS, local_tag));
+    EXPECT_EQ("marked",
+              header_node.GetSessionSpecifics().header().client_name());
+    syncer::ReadNode tab_node(&trans);
+    ASSERT_EQ(syncer::BaseNode::INIT_OK,
+              tab_node.InitByClientTagLookup(syncer::SESSIONS, tab_tag));
+    EXPECT_FALSE(tab_node.GetSessionSpecifics().tab().pinned());
+  }
+}
+
+// Test that unchanged tabs and headers are still rewritten once the rewrite
+// interval has passed, which keeps the modification time of their nodes
+// current.
+TEST_F(ProfileSyncServiceSessionTest, UnchangedTabsRewrittenAfterInterval) {
+  AddTab(browser(), GURL("http://foo1"));
+  NavigateAndCommitActiveTab(GURL("http://foo2"));
+  CreateRootHelper create_root(this);
+  ASSERT_TRUE(StartSyncService(create_root.callback(), false));
+  std::string local_tag = model_associator_->GetCurrentMachineTag();
+  std::string tab_tag = TabNodePool::TabIdToTag(local_tag, 0);
+  syncer::SyncError error;
+
+  {
+    syncer::WriteTransaction trans(FROM_HERE, sync_service_->GetUserShare());
+    syncer::WriteNode header_node(&trans);
+    ASSERT_EQ(syncer::BaseNode::INIT_OK,
+              header_node.InitByClientTagLookup(syncer::SESSIONS, local_tag));
+    sync_pb::SessionSpecifics header_specifics =
+        header_node.GetSessionSpecifics();
+    header_specifics.mutable_header()->set_client_name("marked");
+    header_node.SetSessionSpecifics(header_specifics);
+
+    syncer::WriteNode tab_node(&trans);
+    ASSERT_EQ(syncer::BaseNode::INIT_OK,
+              tab_node.InitByClientTagLookup(syncer::SESSIONS, tab_tag));
+    sync_pb::SessionSpecifics tab_specifics = tab_node.GetSessionSpecifics();
+    tab_specifics.mutable_tab()->set_pinned(true);
+    tab_node.SetSessionSpecifics(tab_specifics);
+  }
+
+  model_associator_->set_unchanged_rewrite_interval_for_testing(
+      base::TimeDelta());
+  EXPECT_TRUE(model_associator_->AssociateWindows(true, &error));
+  ASSERT_FALSE(error.IsSet());
+  {
+    syncer::ReadTransaction trans(FROM_HERE, sync_service_->GetUserShare());
+    syncer::ReadNode header_node(&trans);
+    ASSERT_EQ(syncer::BaseNode::INIT_OK,
+              header_node.InitByClientTagLookup(syncer::SESSIONS, local_tag));
+    EXPECT_NE("marked",
+              header_node.GetSessionSpecifics().header().client_name());
+    syncer::ReadNode tab_node(&trans);
+    ASSERT_EQ(syncer::BaseNode::INIT_OK,
+              tab_node.InitByClientTagLookup(syncer::SESSIONS, tab_tag));
+    EXPECT_FALSE(tab_node.GetSessionSpecifics().tab().pinned());
+  }
+}
+
 TEST_F(ProfileSyncServiceSessionTest, TabPoolFreeNodeLimits) {
   CreateRootHelper create_root(this);
   ASSERT_TRUE(StartSyncService(create_root.callback(), false));
@@ -464,6 +464,29 @@ TEST_F(ProfileSyncServiceTypedUrlTest, HasNativeHasSyncNoMerge) {
   }
 }
 
+TEST_F(ProfileSyncServiceTypedUrlTest, HasNativeHasSyncUnchanged) {
+  history::VisitVector native_visits;
+  history::URLRow native_entry(MakeTypedUrlEntry("http://native.com", "entry",
+                                                 2, 15, false, &native_visits));
+
+  history::URLRows native_entries;
+  native_entries.push_back(native_entry);
+  EXPECT_CALL((*history_backend_.get()), GetAllTypedURLs(_)).
+      WillOnce(DoAll(SetArgumentPointee<0>(native_entries), Return(true)));
+  // The sync node matches the history DB, so no visits are fetched or merged.
+  EXPECT_CALL((*history_backend_.get()), GetMostRecentVisitsForURL(_, _, _)).
+      Times(0);
+  EXPECT_CALL((*history_backend_.get()), AddVisits(_, _, _)).Times(0);
+  SetIdleChangeProcessorExpectations();
+
+  StartSyncService(base::Bind(&AddTypedUrlEntries, this, native_entries));
+
+  history::URLRows new_sync_entries;
+  GetTypedUrlsFromSyncDB(&new_sync_entries);
+  ASSERT_EQ(1U, new_sync_entries.size());
+  EXPECT_TRUE(URLsEqual(native_entry, new_sync_entries[0]));
+}
+
 TEST_F(ProfileSyncServiceTypedUrlTest, EmptyNativeExpiredSync) {
   history::VisitVector sync_visits;
   history::URLRow sync_entry(MakeTypedUrlEntry("http://sync.com", "entry",
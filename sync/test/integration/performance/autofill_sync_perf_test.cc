@@ -33,6 +33,10 @@ using autofill_helper::SetProfiles;
 static const int kNumKeys = 163;
 static const int kNumProfiles = 163;
 
+// Number of autofill profiles in the synthetic account used to time initial
+// sync.
+static const int kNumLargeAccountProfiles = 5000;
+
 class AutofillSyncPerfTest : public SyncTest {
  public:
   AutofillSyncPerfTest()
@@ -208,3 +212,25 @@ IN_PROC_BROWSER_TEST_F(AutofillSyncPerfTest, Autofill_P0) {
   ASSERT_EQ(0, GetKeyCount(1));
   SyncTimingHelper::PrintResult("autofill", "delete_autofill_keys", dt);
 }
+
+IN_PROC_BROWSER_TEST_F(AutofillSyncPerfTest, AutofillProfilesLargeAccount) {
+  ASSERT_TRUE(SetupClients()) << "SetupClients() failed.";
+  DisableVerifier();
+  AddProfiles(0, kNumLargeAccountProfiles);
+
+  size_t memory_before = SyncTimingHelper::GetMemoryUsage();
+  base::TimeTicks start = base::TimeTicks::Now();
+  ASSERT_TRUE(SetupSync()) << "SetupSync() failed.";
+  ASSERT_TRUE(AwaitQuiescence());
+  base::TimeDelta dt = base::TimeTicks::Now() - start;
+  ASSERT_EQ(kNumLargeAccountProfiles, GetProfileCount(1));
+  SyncTimingHelper::PrintResult("autofill", "initial_sync_large_account", dt);
+  SyncTimingHelper::PrintMemoryResult("autofill", "memory_large_account",
+                                      memory_before,
+                                      SyncTimingHelper::GetMemoryUsage());
+
+  AddProfiles(0, 1);
+  dt = SyncTimingHelper::TimeMutualSyncCycle(GetClient(0), GetClient(1));
+  ASSERT_EQ(kNumLargeAccountProfiles + 1, GetProfileCount(1));
+  SyncTimingHelper::PrintResult("autofill", "commit_large_account", dt);
+}
@@ -7,9 +7,11 @@
 #include "chrome/browser/sync/test/integration/performance/sync_timing_helper.h"
 #include "chrome/browser/sync/test/integration/sync_test.h"
 
+using bookmarks_helper::AddFolder;
 using bookmarks_helper::AddURL;
 using bookmarks_helper::AllModelsMatch;
 using bookmarks_helper::GetBookmarkBarNode;
+using bookmarks_helper::IndexedFolderName;
 using bookmarks_helper::IndexedURL;
 using bookmarks_helper::IndexedURLTitle;
 using bookmarks_helper::Remove;
@@ -17,6 +19,13 @@ using bookmarks_helper::SetURL;
 
 static const int kNumBookmarks = 150;
 
+// Size of the tree used to time the association of two large bookmark models.
+static const int kNumLargeTreeFolders = 50;
+static const int kNumLargeTreeBookmarksPerFolder = 100;
+
+// Size of the synthetic account used to time initial sync.
+static const int kNumLargeAccountFolders = 500;
+
 class BookmarksSyncPerfTest : public SyncTest {
  public:
   BookmarksSyncPerfTest()
@@ -36,6 +45,11 @@ class BookmarksSyncPerfTest : public SyncTest {
   // Returns the number of bookmarks stored in the bookmark bar for |profile|.
   int GetURLCount(int profile);
 
+  // Adds |num_folders| folders of kNumLargeTreeBookmarksPerFolder bookmarks
+  // each to the bookmark bar for |profile|. The tree is the same for every
+  // profile.
+  void AddLargeTree(int profile, int num_folders);
+
  private:
   // Returns a new unique bookmark URL.
   std::string NextIndexedURL();
@@ -75,6 +89,18 @@ int BookmarksSyncPerfTest::GetURLCount(int profile) {
   return GetBookmarkBarNode(profile)->child_count();
 }
 
+void BookmarksSyncPerfTest::AddLargeTree(int profile, int num_folders) {
+  for (int i = 0; i < num_folders; ++i) {
+    const BookmarkNode* folder = AddFolder(profile, i, IndexedFolderName(i));
+    ASSERT_TRUE(folder != NULL);
+    for (int j = 0; j < kNumLargeTreeBookmarksPerFolder; ++j) {
+      int url_index = i * kNumLargeTreeBookmarksPerFolder + j;
+      ASSERT_TRUE(AddURL(profile, folder, j, IndexedURLTitle(url_index),
+                         GURL(IndexedURL(url_index))) != NULL);
+    }
+  }
+}
+
 std::string BookmarksSyncPerfTest::NextIndexedURL() {
   return IndexedURL(url_number_++);
 }
@@ -105,3 +131,42 @@ IN_PROC_BROWSER_TEST_F(BookmarksSyncPerfTest, P0) {
   ASSERT_EQ(0, GetURLCount(1));
   SyncTimingHelper::PrintResult("bookmarks", "delete_bookmarks", dt);
 }
+
+IN_PROC_BROWSER_TEST_F(BookmarksSyncPerfTest, LargeTreeAssociation) {
+  ASSERT_TRUE(SetupClients()) << "SetupClients() failed.";
+  DisableVerifier();
+
+  // Both clients start with the same tree, so that the second one to sync
+  // has to match every one of its bookmarks with a sync node.
+  AddLargeTree(0, kNumLargeTreeFolders);
+  AddLargeTree(1, kNumLargeTreeFolders);
+
+  base::TimeTicks start = base::TimeTicks::Now();
+  ASSERT_TRUE(SetupSync()) << "SetupSync() failed.";
+  base::TimeDelta dt = base::TimeTicks::Now() - start;
+  ASSERT_TRUE(AllModelsMatch());
+  ASSERT_EQ(kNumLargeTreeFolders, GetURLCount(1));
+  SyncTimingHelper::PrintResult("bookmarks", "associate_large_tree", dt);
+}
+
+IN_PROC_BROWSER_TEST_F(BookmarksSyncPerfTest, LargeAccount) {
+  ASSERT_TRUE(SetupClients()) << "SetupClients() failed.";
+  DisableVerifier();
+  AddLargeTree(0, kNumLargeAccountFolders);
+
+  size_t memory_before = SyncTimingHelper::GetMemoryUsage();
+  base::TimeTicks start = base::TimeTicks::Now();
+  ASSERT_TRUE(SetupSync()) << "SetupSync() failed.";
+  ASSERT_TRUE(AwaitQuiescence());
+  base::TimeDelta dt = base::TimeTicks::Now() - start;
+  ASSERT_TRUE(AllModelsMatch());
+  SyncTimingHelper::PrintResult("bookmarks", "initial_sync_large_account", dt);
+  SyncTimingHelper::PrintMemoryResult("bookmarks", "memory_large_account",
+                                      memory_before,
+                                      SyncTimingHelper::GetMemoryUsage());
+
+  AddURLs(0, 1);
+  dt = SyncTimingHelper::TimeMutualSyncCycle(GetClient(0), GetClient(1));
+  ASSERT_EQ(kNumLargeAccountFolders + 1, GetURLCount(1));
+  SyncTimingHelper::PrintResult("bookmarks", "commit_large_account", dt);
+}
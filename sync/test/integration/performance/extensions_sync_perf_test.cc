@@ -3,17 +3,22 @@
 // found in the LICENSE file.
 
 #include "base/strings/stringprintf.h"
+#include "base/values.h"
 #include "chrome/browser/sync/profile_sync_service_harness.h"
+#include "chrome/browser/sync/test/integration/extension_settings_helper.h"
 #include "chrome/browser/sync/test/integration/extensions_helper.h"
 #include "chrome/browser/sync/test/integration/performance/sync_timing_helper.h"
 #include "chrome/browser/sync/test/integration/sync_test.h"
 
+using extension_settings_helper::AllExtensionSettingsSameAsVerifier;
+using extension_settings_helper::SetExtensionSettings;
 using extensions_helper::AllProfilesHaveSameExtensions;
 using extensions_helper::AllProfilesHaveSameExtensionsAsVerifier;
 using extensions_helper::DisableExtension;
 using extensions_helper::EnableExtension;
 using extensions_helper::GetInstalledExtensions;
 using extensions_helper::InstallExtension;
+using extensions_helper::InstallExtensionForAllProfiles;
 using extensions_helper::InstallExtensionsPendingForSync;
 using extensions_helper::IsExtensionEnabled;
 using extensions_helper::UninstallExtension;
@@ -22,6 +27,12 @@ using extensions_helper::UninstallExtension;
 
 static const int kNumExtensions = 150;
 
+// Size of the synthetic account used to time initial sync of extension
+// settings: kNumSettingsExtensions extensions with kNumSettingsPerExtension
+// settings each.
+static const int kNumSettingsExtensions = 10;
+static const int kNumSettingsPerExtension = 100;
+
 class ExtensionsSyncPerfTest : public SyncTest {
  public:
   ExtensionsSyncPerfTest()
@@ -100,3 +111,40 @@ IN_PROC_BROWSER_TEST_F(ExtensionsSyncPerfTest, P0) {
   ASSERT_EQ(num_default_extensions, GetExtensionCount(1));
   SyncTimingHelper::PrintResult("extensions", "delete_extensions", dt);
 }
+
+IN_PROC_BROWSER_TEST_F(ExtensionsSyncPerfTest, SettingsLargeAccount) {
+  ASSERT_TRUE(SetupClients()) << "SetupClients() failed.";
+  std::vector<std::string> extension_ids;
+  for (int i = 0; i < kNumSettingsExtensions; ++i) {
+    extension_ids.push_back(InstallExtensionForAllProfiles(i));
+    DictionaryValue settings;
+    for (int j = 0; j < kNumSettingsPerExtension; ++j) {
+      settings.SetString(base::StringPrintf("key%d", j),
+                         base::StringPrintf("value%d", j));
+    }
+    SetExtensionSettings(verifier(), extension_ids.back(), settings);
+    SetExtensionSettings(GetProfile(0), extension_ids.back(), settings);
+  }
+
+  size_t memory_before = SyncTimingHelper::GetMemoryUsage();
+  base::TimeTicks start = base::TimeTicks::Now();
+  ASSERT_TRUE(SetupSync()) << "SetupSync() failed.";
+  ASSERT_TRUE(AwaitQuiescence());
+  base::TimeDelta dt = base::TimeTicks::Now() - start;
+  ASSERT_TRUE(AllExtensionSettingsSameAsVerifier());
+  SyncTimingHelper::PrintResult("extension_settings",
+                                "initial_sync_large_account", dt);
+  SyncTimingHelper::PrintMemoryResult("extension_settings",
+                                      "memory_large_account",
+                                      memory_before,
+                                      SyncTimingHelper::GetMemoryUsage());
+
+  DictionaryValue changed_settings;
+  changed_settings.SetString("key0", "changed");
+  SetExtensionSettings(verifier(), extension_ids[0], changed_settings);
+  SetExtensionSettings(GetProfile(0), extension_ids[0], changed_settings);
+  dt = SyncTimingHelper::TimeMutualSyncCycle(GetClient(0), GetClient(1));
+  ASSERT_TRUE(AllExtensionSettingsSameAsVerifier());
+  SyncTimingHelper::PrintResult("extension_settings", "commit_large_account",
+                                dt);
+}
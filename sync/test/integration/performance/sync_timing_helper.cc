@@ -4,6 +4,9 @@
 
 #include "chrome/browser/sync/test/integration/performance/sync_timing_helper.h"
 
+#include "base/memory/scoped_ptr.h"
+#include "base/process/process_handle.h"
+#include "base/process/process_metrics.h"
 #include "base/strings/string_number_conversions.h"
 #include "base/time/time.h"
 #include "chrome/browser/sync/profile_sync_service_harness.h"
@@ -44,3 +47,29 @@ void SyncTimingHelper::PrintResult(const std::string& measurement,
   printf("*RESULT %s: %s= %s ms\n", measurement.c_str(), trace.c_str(),
          base::IntToString(dt.InMillisecondsF()).c_str());
 }
+
+// static
+size_t SyncTimingHelper::GetMemoryUsage() {
+  scoped_ptr<base::ProcessMetrics> metrics(
+#if !defined(OS_MACOSX)
+      base::ProcessMetrics::CreateProcessMetrics(
+          base::GetCurrentProcessHandle())
+#else
+      // Only the current process is measured, so NULL is fine.
+      base::ProcessMetrics::CreateProcessMetrics(
+          base::GetCurrentProcessHandle(), NULL)
+#endif
+  );
+  return metrics->GetWorkingSetSize();
+}
+
+// static
+void SyncTimingHelper::PrintMemoryResult(const std::string& measurement,
+                                         const std::string& trace,
+                                         size_t bytes_before,
+                                         size_t bytes_after) {
+  // The working set can shrink as other memory is released meanwhile.
+  size_t growth = bytes_after > bytes_before ? bytes_after - bytes_before : 0;
+  printf("*RESULT %s: %s= %s bytes\n", measurement.c_str(), trace.c_str(),
+         base::Uint64ToString(growth).c_str());
+}
@@ -41,6 +41,18 @@ class SyncTimingHelper {
                           const std::string& trace,
                           const base::TimeDelta& dt);
 
+  // Returns the working set size of the browser process, in bytes. All the
+  // clients of a test share the process, so compare values taken around the
+  // step to measure.
+  static size_t GetMemoryUsage();
+
+  // Print the memory growth from |bytes_before| to |bytes_after| in the same
+  // format as PrintResult.
+  static void PrintMemoryResult(const std::string& measurement,
+                                const std::string& trace,
+                                size_t bytes_before,
+                                size_t bytes_after);
+
  private:
   DISALLOW_COPY_AND_ASSIGN(SyncTimingHelper);
 };
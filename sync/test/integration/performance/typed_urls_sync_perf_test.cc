@@ -29,6 +29,15 @@ COMPILE_ASSERT(
      ((syncer::kDefaultMaxCommitBatchSize + 1) / 2)),
     kNumUrlsShouldBeBetweenTwoMultiplesOfkDefaultMaxCommitBatchSize);
 
+// Number of typed urls committed in a single cycle to time the cost of
+// doing many units of work on the history thread.
+static const int kNumLargeBatchUrls = 1000;
+
+// Number of typed urls in the synthetic account used to time initial sync.
+// Each one is a separate history write before sync starts, so the account is
+// kept to a size the perf bots can set up in seconds.
+static const int kNumLargeAccountUrls = 10000;
+
 class TypedUrlsSyncPerfTest : public SyncTest {
  public:
   TypedUrlsSyncPerfTest()
@@ -116,3 +125,35 @@ IN_PROC_BROWSER_TEST_F(TypedUrlsSyncPerfTest, P0) {
   ASSERT_EQ(0, GetURLCount(1));
   SyncTimingHelper::PrintResult("typed_urls", "delete_typed_urls", dt);
 }
+
+IN_PROC_BROWSER_TEST_F(TypedUrlsSyncPerfTest, LargeBatch) {
+  ASSERT_TRUE(SetupSync()) << "SetupSync() failed.";
+
+  AddURLs(0, kNumLargeBatchUrls);
+  base::TimeDelta dt =
+      SyncTimingHelper::TimeMutualSyncCycle(GetClient(0), GetClient(1));
+  ASSERT_EQ(kNumLargeBatchUrls, GetURLCount(1));
+  SyncTimingHelper::PrintResult("typed_urls", "add_typed_urls_large_batch", dt);
+}
+
+IN_PROC_BROWSER_TEST_F(TypedUrlsSyncPerfTest, LargeAccount) {
+  ASSERT_TRUE(SetupClients()) << "SetupClients() failed.";
+  DisableVerifier();
+  AddURLs(0, kNumLargeAccountUrls);
+
+  size_t memory_before = SyncTimingHelper::GetMemoryUsage();
+  base::TimeTicks start = base::TimeTicks::Now();
+  ASSERT_TRUE(SetupSync()) << "SetupSync() failed.";
+  ASSERT_TRUE(AwaitQuiescence());
+  base::TimeDelta dt = base::TimeTicks::Now() - start;
+  ASSERT_EQ(kNumLargeAccountUrls, GetURLCount(1));
+  SyncTimingHelper::PrintResult("typed_urls", "initial_sync_large_account", dt);
+  SyncTimingHelper::PrintMemoryResult("typed_urls", "memory_large_account",
+                                      memory_before,
+                                      SyncTimingHelper::GetMemoryUsage());
+
+  AddURLs(0, 1);
+  dt = SyncTimingHelper::TimeMutualSyncCycle(GetClient(0), GetClient(1));
+  ASSERT_EQ(kNumLargeAccountUrls + 1, GetURLCount(1));
+  SyncTimingHelper::PrintResult("typed_urls", "commit_large_account", dt);
+}
@@ -7,6 +7,7 @@
 #include <algorithm>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "base/bind.h"
 #include "base/file_util.h"
@@ -878,6 +879,8 @@ void DriveFileSyncService::DidGetDirectoryContentForBatchSync(
     return;
   }
 
+  DriveMetadataStore::URLAndDriveMetadataList to_be_fetched_files;
+  std::vector<std::pair<base::FilePath, SyncFileType> > fetch_changes;
   typedef ScopedVector<google_apis::ResourceEntry>::const_iterator iterator;
   for (iterator itr = feed->entries().begin();
        itr != feed->entries().end(); ++itr) {
@@ -911,13 +914,26 @@ void DriveFileSyncService::DidGetDirectoryContentForBatchSync(
     base::FilePath path = TitleToPath(entry.title());
     fileapi::FileSystemURL url(CreateSyncableFileSystemURL(
         origin, path));
-    // TODO(calvinlo): Write metadata and origin data as single batch command
-    // so it's not possible for the DB to contain a DriveMetadata with an
-    // unknown origin.
-    metadata_store_->UpdateEntry(url, metadata,
-                                 base::Bind(&EmptyStatusCallback));
+    to_be_fetched_files.push_back(std::make_pair(url, metadata));
+    fetch_changes.push_back(std::make_pair(path, file_type));
+  }
+
+  // Write the whole page of entries at once rather than issuing a database
+  // write per file.
+  // TODO(calvinlo): Write metadata and origin data as single batch command
+  // so it's not possible for the DB to contain a DriveMetadata with an
+  // unknown origin.
+  if (!to_be_fetched_files.empty()) {
+    metadata_store_->UpdateEntries(to_be_fetched_files,
+                                   base::Bind(&EmptyStatusCallback));
+  }
 
-    AppendFetchChange(origin, path, entry.resource_id(), file_type);
+  // The fetch changes are appended only now, since AppendFetchChange() reads
+  // the metadata entries written above.
+  for (size_t i = 0; i < fetch_changes.size(); ++i) {
+    AppendFetchChange(origin, fetch_changes[i].first,
+                      to_be_fetched_files[i].second.resource_id(),
+                      fetch_changes[i].second);
   }
 
   GURL next_feed_url;
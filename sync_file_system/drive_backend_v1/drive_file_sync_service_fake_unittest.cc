@@ -443,6 +443,7 @@ class DriveFileSyncServiceFakeTest : public testing::Test {
 
   void TestRegisterNewOrigin();
   void TestRegisterExistingOrigin();
+  void TestRegisterExistingOriginWithStaleEntry();
   void TestRegisterOriginWithSyncDisabled();
   void TestUninstallOrigin();
   void TestUpdateRegisteredOrigins();
@@ -530,6 +531,51 @@ void DriveFileSyncServiceFakeTest::TestRegisterExistingOrigin() {
   EXPECT_EQ(3u, remote_change_handler().ChangesSize());
 }
 
+void DriveFileSyncServiceFakeTest::TestRegisterExistingOriginWithStaleEntry() {
+  const GURL origin = ExtensionNameToGURL(kExtensionName1);
+  const std::string origin_resource_id =
+      SetUpOriginRootDirectory(kExtensionName1);
+
+  std::string file_id;
+  EXPECT_EQ(google_apis::HTTP_SUCCESS,
+            fake_drive_helper_->AddFile(
+                origin_resource_id, "1.txt", "data1", &file_id));
+  EXPECT_EQ(google_apis::HTTP_SUCCESS,
+            fake_drive_helper_->AddFile(
+                origin_resource_id, "2.txt", "data2", &file_id));
+
+  // An entry left for a file which was since replaced on the server.
+  DriveMetadata metadata;
+  metadata.set_resource_id("file:stale");
+  metadata.set_md5_checksum("stale_md5");
+  metadata.set_conflicted(false);
+  metadata.set_to_be_fetched(false);
+  metadata.set_type(DriveMetadata::RESOURCE_TYPE_FILE);
+  bool done = false;
+  metadata_store()->UpdateEntry(
+      CreateURL(origin, "1.txt"), metadata,
+      base::Bind(&ExpectEqStatus, &done, SYNC_STATUS_OK));
+  base::RunLoop().RunUntilIdle();
+  ASSERT_TRUE(done);
+
+  SetUpDriveSyncService(true);
+
+  done = false;
+  sync_service()->RegisterOrigin(
+      origin, base::Bind(&ExpectEqStatus, &done, SYNC_STATUS_OK));
+  base::RunLoop().RunUntilIdle();
+  EXPECT_TRUE(done);
+
+  // The batch sync replaces the stale entry before it appends the fetch
+  // changes, so neither of them is dropped.
+  EXPECT_EQ(2u, remote_change_handler().ChangesSize());
+  ASSERT_EQ(SYNC_STATUS_OK,
+            metadata_store()->ReadEntry(CreateURL(origin, "1.txt"),
+                                        &metadata));
+  EXPECT_NE("file:stale", metadata.resource_id());
+  EXPECT_TRUE(metadata.to_be_fetched());
+}
+
 void DriveFileSyncServiceFakeTest::TestRegisterOriginWithSyncDisabled() {
   // Usually the sync service starts here, but since we're setting up a drive
   // service with sync disabled sync doesn't start (while register origin should
@@ -838,6 +884,17 @@ TEST_F(DriveFileSyncServiceFakeTest, RegisterExistingOrigin_WAPI) {
   TestRegisterExistingOrigin();
 }
 
+TEST_F(DriveFileSyncServiceFakeTest, RegisterExistingOriginWithStaleEntry) {
+  ASSERT_FALSE(IsDriveAPIDisabled());
+  TestRegisterExistingOriginWithStaleEntry();
+}
+
+TEST_F(DriveFileSyncServiceFakeTest,
+       RegisterExistingOriginWithStaleEntry_WAPI) {
+  ScopedDisableDriveAPI disable_drive_api;
+  TestRegisterExistingOriginWithStaleEntry();
+}
+
 TEST_F(DriveFileSyncServiceFakeTest, RegisterOriginWithSyncDisabled) {
   ASSERT_FALSE(IsDriveAPIDisabled());
   TestRegisterOriginWithSyncDisabled();
@@ -8,6 +8,7 @@
 #include <vector>
 
 #include "base/bind.h"
+#include "base/bind_helpers.h"
 #include "base/callback.h"
 #include "base/files/file_path.h"
 #include "base/location.h"
@@ -354,6 +355,27 @@ std::string DriveTypeToString(DriveMetadata_ResourceType drive_type) {
   return "unknown";
 }
 
+// Appends the operations of the batch it is iterated over to |batch|.
+class BatchAppender : public leveldb::WriteBatch::Handler {
+ public:
+  explicit BatchAppender(leveldb::WriteBatch* batch) : batch_(batch) {}
+  virtual ~BatchAppender() {}
+
+  virtual void Put(const leveldb::Slice& key,
+                   const leveldb::Slice& value) OVERRIDE {
+    batch_->Put(key, value);
+  }
+
+  virtual void Delete(const leveldb::Slice& key) OVERRIDE {
+    batch_->Delete(key);
+  }
+
+ private:
+  leveldb::WriteBatch* batch_;
+
+  DISALLOW_COPY_AND_ASSIGN(BatchAppender);
+};
+
 }  // namespace
 
 DriveMetadataStore::DriveMetadataStore(
@@ -362,12 +384,23 @@ DriveMetadataStore::DriveMetadataStore(
     : file_task_runner_(file_task_runner),
       base_dir_(base_dir),
       db_status_(SYNC_STATUS_UNKNOWN),
-      largest_changestamp_(0) {
+      largest_changestamp_(0),
+      write_in_progress_(false) {
   DCHECK(file_task_runner);
 }
 
 DriveMetadataStore::~DriveMetadataStore() {
   DCHECK(CalledOnValidThread());
+  // Don't lose the writes that were waiting for the running one. Their
+  // callbacks are dropped like those of any write still in flight.
+  if (pending_batch_) {
+    file_task_runner_->PostTask(
+        FROM_HERE,
+        base::Bind(base::IgnoreResult(&leveldb::DB::Write),
+                   base::Unretained(db_.get()),
+                   leveldb::WriteOptions(),
+                   base::Owned(pending_batch_.release())));
+  }
   file_task_runner_->DeleteSoon(FROM_HERE, db_.release());
 }
 
@@ -432,6 +465,29 @@ void DriveMetadataStore::UpdateEntry(
     const SyncStatusCallback& callback) {
   DCHECK(CalledOnValidThread());
   DCHECK_EQ(SYNC_STATUS_OK, db_status_);
+
+  scoped_ptr<leveldb::WriteBatch> batch(new leveldb::WriteBatch);
+  PutEntryToBatch(url, metadata, batch.get());
+  WriteToDB(batch.Pass(), callback);
+}
+
+void DriveMetadataStore::UpdateEntries(
+    const URLAndDriveMetadataList& entries,
+    const SyncStatusCallback& callback) {
+  DCHECK(CalledOnValidThread());
+  DCHECK_EQ(SYNC_STATUS_OK, db_status_);
+
+  scoped_ptr<leveldb::WriteBatch> batch(new leveldb::WriteBatch);
+  for (URLAndDriveMetadataList::const_iterator itr = entries.begin();
+       itr != entries.end(); ++itr) {
+    PutEntryToBatch(itr->first, itr->second, batch.get());
+  }
+  WriteToDB(batch.Pass(), callback);
+}
+
+void DriveMetadataStore::PutEntryToBatch(const FileSystemURL& url,
+                                         const DriveMetadata& metadata,
+                                         leveldb::WriteBatch* batch) {
   DCHECK(!metadata.conflicted() || !metadata.to_be_fetched());
 
   std::pair<PathToMetadata::iterator, bool> result =
@@ -451,9 +507,7 @@ void DriveMetadataStore::UpdateEntry(
     DCHECK(success);
   }
 
-  scoped_ptr<leveldb::WriteBatch> batch(new leveldb::WriteBatch);
   batch->Put(FileSystemURLToMetadataKey(url), value);
-  WriteToDB(batch.Pass(), callback);
 }
 
 void DriveMetadataStore::DeleteEntry(
@@ -644,6 +698,27 @@ void DriveMetadataStore::DidUpdateOrigin(
 
 void DriveMetadataStore::WriteToDB(scoped_ptr<leveldb::WriteBatch> batch,
                                    const SyncStatusCallback& callback) {
+  DCHECK(CalledOnValidThread());
+  if (write_in_progress_) {
+    // Merge this write into the next commit, which is issued as soon as the
+    // running one finishes.
+    if (!pending_batch_)
+      pending_batch_.reset(new leveldb::WriteBatch);
+    BatchAppender appender(pending_batch_.get());
+    leveldb::Status status = batch->Iterate(&appender);
+    DCHECK(status.ok());
+    pending_callbacks_.push_back(callback);
+    return;
+  }
+
+  CommitBatch(batch.Pass(), std::vector<SyncStatusCallback>(1, callback));
+}
+
+void DriveMetadataStore::CommitBatch(
+    scoped_ptr<leveldb::WriteBatch> batch,
+    const std::vector<SyncStatusCallback>& callbacks) {
+  DCHECK(!write_in_progress_);
+  write_in_progress_ = true;
   base::PostTaskAndReplyWithResult(
       file_task_runner_.get(),
       FROM_HERE,
@@ -651,9 +726,28 @@ void DriveMetadataStore::WriteToDB(scoped_ptr<leveldb::WriteBatch> batch,
                  base::Unretained(db_.get()),
                  leveldb::WriteOptions(),
                  base::Owned(batch.release())),
-      base::Bind(&DriveMetadataStore::UpdateDBStatusAndInvokeCallback,
+      base::Bind(&DriveMetadataStore::DidCommitBatch,
                  AsWeakPtr(),
-                 callback));
+                 callbacks));
+}
+
+void DriveMetadataStore::DidCommitBatch(
+    const std::vector<SyncStatusCallback>& callbacks,
+    const leveldb::Status& leveldb_status) {
+  DCHECK(CalledOnValidThread());
+  write_in_progress_ = false;
+  if (pending_batch_) {
+    std::vector<SyncStatusCallback> pending_callbacks;
+    pending_callbacks.swap(pending_callbacks_);
+    CommitBatch(pending_batch_.Pass(), pending_callbacks);
+  }
+
+  SyncStatusCode status = LevelDBStatusToSyncStatusCode(leveldb_status);
+  UpdateDBStatus(status);
+  for (std::vector<SyncStatusCallback>::const_iterator itr =
+           callbacks.begin(); itr != callbacks.end(); ++itr) {
+    itr->Run(status);
+  }
 }
 
 void DriveMetadataStore::UpdateDBStatus(SyncStatusCode status) {
@@ -671,14 +765,6 @@ void DriveMetadataStore::UpdateDBStatus(SyncStatusCode status) {
   db_status_ = SYNC_STATUS_OK;
 }
 
-void DriveMetadataStore::UpdateDBStatusAndInvokeCallback(
-    const SyncStatusCallback& callback,
-    const leveldb::Status& leveldb_status) {
-  SyncStatusCode status = LevelDBStatusToSyncStatusCode(leveldb_status);
-  UpdateDBStatus(status);
-  callback.Run(status);
-}
-
 SyncStatusCode DriveMetadataStore::GetConflictURLs(
     fileapi::FileSystemURLSet* urls) const {
   DCHECK(CalledOnValidThread());
@@ -27,6 +27,7 @@ class SequencedTaskRunner;
 
 namespace leveldb {
 class DB;
+class Status;
 class WriteBatch;
 }
 
@@ -71,6 +72,11 @@ class DriveMetadataStore
                    const DriveMetadata& metadata,
                    const SyncStatusCallback& callback);
 
+  // Updates the database entries for all of |entries| in a single database
+  // write. Invokes |callback|, upon completion.
+  void UpdateEntries(const URLAndDriveMetadataList& entries,
+                     const SyncStatusCallback& callback);
+
   // Deletes database entry for |url|. Invokes |callback|, upon completion.
   void DeleteEntry(const fileapi::FileSystemURL& url,
                    const SyncStatusCallback& callback);
@@ -154,12 +160,22 @@ class DriveMetadataStore
  private:
   friend class DriveMetadataStoreTest;
 
+  // Updates the in-memory entry for |url| and adds its database update to
+  // |batch|.
+  void PutEntryToBatch(const fileapi::FileSystemURL& url,
+                       const DriveMetadata& metadata,
+                       leveldb::WriteBatch* batch);
+
+  // Writes |batch| to the database, or merges it into the next commit if a
+  // write is already in progress.
   void WriteToDB(scoped_ptr<leveldb::WriteBatch> batch,
                  const SyncStatusCallback& callback);
+  void CommitBatch(scoped_ptr<leveldb::WriteBatch> batch,
+                   const std::vector<SyncStatusCallback>& callbacks);
+  void DidCommitBatch(const std::vector<SyncStatusCallback>& callbacks,
+                      const leveldb::Status& leveldb_status);
 
   void UpdateDBStatus(SyncStatusCode status);
-  void UpdateDBStatusAndInvokeCallback(const SyncStatusCallback& callback,
-                                       const leveldb::Status& status);
   void DidInitialize(const InitializationCallback& callback,
                      scoped_ptr<DBContents> contents);
   void DidUpdateOrigin(const SyncStatusCallback& callback,
@@ -181,6 +197,14 @@ class DriveMetadataStore
 
   OriginByResourceId origin_by_resource_id_;
 
+  // Only one write to |db_| runs at a time. Writes issued meanwhile are
+  // accumulated in |pending_batch_| and committed together when it finishes,
+  // so that a burst of updates costs two database writes instead of one per
+  // update.
+  bool write_in_progress_;
+  scoped_ptr<leveldb::WriteBatch> pending_batch_;
+  std::vector<SyncStatusCallback> pending_callbacks_;
+
   DISALLOW_COPY_AND_ASSIGN(DriveMetadataStore);
 };
 
@@ -51,6 +51,8 @@ std::string GetResourceID(const ResourceIdByOrigin& sync_origins,
   return itr->second;
 }
 
+void EmptyStatusCallback(SyncStatusCode status) {}
+
 std::string CreateResourceId(const std::string& resource_id) {
   return IsDriveAPIDisabled() ? resource_id
                               : drive_backend::RemoveWapiIdPrefix(resource_id);
@@ -171,6 +173,17 @@ class DriveMetadataStoreTest : public testing::Test {
     return status;
   }
 
+  SyncStatusCode UpdateEntries(
+      const DriveMetadataStore::URLAndDriveMetadataList& entries) {
+    SyncStatusCode status = SYNC_STATUS_UNKNOWN;
+    drive_metadata_store_->UpdateEntries(
+        entries,
+        base::Bind(&DriveMetadataStoreTest::DidFinishDBTask,
+                   base::Unretained(this), &status));
+    message_loop_.Run();
+    return status;
+  }
+
   SyncStatusCode DeleteEntry(const fileapi::FileSystemURL& url) {
     SyncStatusCode status = SYNC_STATUS_UNKNOWN;
     drive_metadata_store_->DeleteEntry(
@@ -196,6 +209,31 @@ class DriveMetadataStoreTest : public testing::Test {
     message_loop_.Quit();
   }
 
+  void DidFinishOneOfDBTasks(int* remaining_tasks,
+                             SyncStatusCode* status_out,
+                             SyncStatusCode status) {
+    if (status != SYNC_STATUS_OK)
+      *status_out = status;
+    if (--*remaining_tasks == 0)
+      message_loop_.Quit();
+  }
+
+  // Issues updates of all of |entries| without waiting for each other, then
+  // waits for all of them.
+  SyncStatusCode UpdateEntriesConcurrently(
+      const DriveMetadataStore::URLAndDriveMetadataList& entries) {
+    SyncStatusCode status = SYNC_STATUS_OK;
+    int remaining_tasks = static_cast<int>(entries.size());
+    for (size_t i = 0; i < entries.size(); ++i) {
+      drive_metadata_store_->UpdateEntry(
+          entries[i].first, entries[i].second,
+          base::Bind(&DriveMetadataStoreTest::DidFinishOneOfDBTasks,
+                     base::Unretained(this), &remaining_tasks, &status));
+    }
+    message_loop_.Run();
+    return status;
+  }
+
   void MarkAsCreated() {
     created_ = true;
   }
@@ -257,6 +295,8 @@ class DriveMetadataStoreTest : public testing::Test {
   }
 
   void ReadWrite_Body();
+  void UpdateEntries_Body();
+  void ConcurrentWrites_Body();
   void GetConflictURLs_Body();
   void GetToBeFetchedFiles_Body();
   void StoreSyncRootDirectory_Body();
@@ -339,6 +379,75 @@ void DriveMetadataStoreTest::ReadWrite_Body() {
   VerifyReverseMap();
 }
 
+void DriveMetadataStoreTest::UpdateEntries_Body() {
+  InitializeDatabase();
+
+  const fileapi::FileSystemURL url1 = URL(base::FilePath(FPL("file1")));
+  const fileapi::FileSystemURL url2 = URL(base::FilePath(FPL("file2")));
+  DriveMetadataStore::URLAndDriveMetadataList entries;
+  entries.push_back(std::make_pair(
+      url1, CreateMetadata("file:1", "1", false, true,
+                           DriveMetadata_ResourceType_RESOURCE_TYPE_FILE)));
+  entries.push_back(std::make_pair(
+      url2, CreateMetadata("file:2", "2", false, true,
+                           DriveMetadata_ResourceType_RESOURCE_TYPE_FILE)));
+  EXPECT_EQ(SYNC_STATUS_OK, UpdateEntries(entries));
+
+  DropDatabase();
+  InitializeDatabase();
+
+  DriveMetadata metadata;
+  EXPECT_EQ(SYNC_STATUS_OK, metadata_store()->ReadEntry(url1, &metadata));
+  EXPECT_EQ(entries[0].second.resource_id(), metadata.resource_id());
+  EXPECT_EQ(SYNC_STATUS_OK, metadata_store()->ReadEntry(url2, &metadata));
+  EXPECT_EQ(entries[1].second.resource_id(), metadata.resource_id());
+  EXPECT_EQ("2", metadata.md5_checksum());
+
+  VerifyReverseMap();
+}
+
+void DriveMetadataStoreTest::ConcurrentWrites_Body() {
+  InitializeDatabase();
+
+  DriveMetadataStore::URLAndDriveMetadataList entries;
+  for (int i = 0; i < 5; ++i) {
+    std::string index = base::IntToString(i);
+    entries.push_back(std::make_pair(
+        URL(base::FilePath().AppendASCII("file" + index)),
+        CreateMetadata("file:" + index, index, false, false,
+                       DriveMetadata_ResourceType_RESOURCE_TYPE_FILE)));
+  }
+  EXPECT_EQ(SYNC_STATUS_OK, UpdateEntriesConcurrently(entries));
+
+  // Writes still pending when the store goes away are not lost.
+  metadata_store()->UpdateEntry(
+      URL(base::FilePath(FPL("file0"))),
+      CreateMetadata("file:0", "updated", false, false,
+                     DriveMetadata_ResourceType_RESOURCE_TYPE_FILE),
+      base::Bind(&EmptyStatusCallback));
+  metadata_store()->UpdateEntry(
+      URL(base::FilePath(FPL("file1"))),
+      CreateMetadata("file:1", "updated", false, false,
+                     DriveMetadata_ResourceType_RESOURCE_TYPE_FILE),
+      base::Bind(&EmptyStatusCallback));
+
+  DropDatabase();
+  InitializeDatabase();
+
+  DriveMetadata metadata;
+  for (size_t i = 0; i < entries.size(); ++i) {
+    EXPECT_EQ(SYNC_STATUS_OK,
+              metadata_store()->ReadEntry(entries[i].first, &metadata));
+    EXPECT_EQ(entries[i].second.resource_id(), metadata.resource_id());
+    if (i < 2)
+      EXPECT_EQ("updated", metadata.md5_checksum());
+    else
+      EXPECT_EQ(entries[i].second.md5_checksum(), metadata.md5_checksum());
+  }
+
+  VerifyReverseMap();
+}
+
 void DriveMetadataStoreTest::GetConflictURLs_Body() {
   InitializeDatabase();
 
@@ -648,6 +757,26 @@ TEST_F(DriveMetadataStoreTest, ReadWrite_WAPI) {
   ReadWrite_Body();
 }
 
+TEST_F(DriveMetadataStoreTest, UpdateEntries) {
+  ASSERT_FALSE(IsDriveAPIDisabled());
+  UpdateEntries_Body();
+}
+
+TEST_F(DriveMetadataStoreTest, UpdateEntries_WAPI) {
+  SetDisableDriveAPI(true);
+  UpdateEntries_Body();
+}
+
+TEST_F(DriveMetadataStoreTest, ConcurrentWrites) {
+  ASSERT_FALSE(IsDriveAPIDisabled());
+  ConcurrentWrites_Body();
+}
+
+TEST_F(DriveMetadataStoreTest, ConcurrentWrites_WAPI) {
+  SetDisableDriveAPI(true);
+  ConcurrentWrites_Body();
+}
+
 TEST_F(DriveMetadataStoreTest, GetConflictURLs) {
   ASSERT_FALSE(IsDriveAPIDisabled());
   GetConflictURLs_Body();
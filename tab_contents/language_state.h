@@ -8,6 +8,7 @@
 #include <string>
 
 #include "base/basictypes.h"
+#include "base/time/time.h"
 
 namespace content {
 class NavigationController;
@@ -63,6 +64,14 @@ class LanguageState {
   bool translation_pending() const { return translation_pending_; }
   void set_translation_pending(bool value) { translation_pending_ = value; }
 
+  // The time the translation of the page was last requested.
+  base::TimeTicks translation_start_time() const {
+    return translation_start_time_;
+  }
+  void set_translation_start_time(base::TimeTicks time) {
+    translation_start_time_ = time;
+  }
+
   // Whether the user has already declined to translate the page.
   bool translation_declined() const { return translation_declined_; }
   void set_translation_declined(bool value) { translation_declined_ = value; }
@@ -101,6 +110,10 @@ class LanguageState {
   //                then we can get rid of that state.
   bool translation_pending_;
 
+  // The time the translation of the page was last requested, used to measure
+  // how long the page takes to be translated.
+  base::TimeTicks translation_start_time_;
+
   // Whether the user has declined to translate the page (by closing the infobar
   // for example).  This is necessary as a new infobar could be shown if a new
   // load happens in the page after the user closed the infobar.
@@ -35,15 +35,20 @@ RendererResource::~RendererResource() {
 }
 
 void RendererResource::Refresh() {
-  if (!pending_stats_update_) {
-    render_view_host_->Send(new ChromeViewMsg_GetCacheResourceStats);
-    pending_stats_update_ = true;
-  }
   if (!pending_fps_update_) {
     render_view_host_->Send(
         new ChromeViewMsg_GetFPS(render_view_host_->GetRoutingID()));
     pending_fps_update_ = true;
   }
+}
+
+void RendererResource::RefreshProcessStats() {
+  // The replies are passed to every resource of the process, so one request
+  // per process is enough.
+  if (!pending_stats_update_) {
+    render_view_host_->Send(new ChromeViewMsg_GetCacheResourceStats);
+    pending_stats_update_ = true;
+  }
   if (!pending_v8_memory_allocated_update_) {
     render_view_host_->Send(new ChromeViewMsg_GetV8HeapStats);
     pending_v8_memory_allocated_update_ = true;
@@ -48,6 +48,7 @@ class RendererResource : public Resource,
   virtual void SetSupportNetworkUsage() OVERRIDE { }
 
   virtual void Refresh() OVERRIDE;
+  virtual void RefreshProcessStats() OVERRIDE;
 
   virtual void NotifyResourceTypeStats(
       const WebKit::WebCache::ResourceTypeStats& stats) OVERRIDE;
@@ -73,7 +74,8 @@ class RendererResource : public Resource,
   // RenderViewHost we use to fetch stats.
   content::RenderViewHost* render_view_host_;
   // The stats_ field holds information about resource usage in the renderer
-  // process and so it is updated asynchronously by the Refresh() call.
+  // process and so it is updated asynchronously by the RefreshProcessStats()
+  // call.
   WebKit::WebCache::ResourceTypeStats stats_;
   // This flag is true if we are waiting for the renderer to report its stats.
   bool pending_stats_update_;
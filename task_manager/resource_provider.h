@@ -106,6 +106,10 @@ class Resource {
   // on all live resources.
   virtual void Refresh() {}
 
+  // Called after Refresh() on one live resource of each process, to refresh
+  // the values that all the resources of the process share.
+  virtual void RefreshProcessStats() {}
+
   virtual void NotifyResourceTypeStats(
       const WebKit::WebCache::ResourceTypeStats& stats) {}
   virtual void NotifyFPS(float fps) {}
@@ -4,6 +4,8 @@
 
 #include "chrome/browser/task_manager/task_manager.h"
 
+#include <set>
+
 #include "base/bind.h"
 #include "base/i18n/number_formatting.h"
 #include "base/i18n/rtl.h"
@@ -1205,10 +1207,14 @@ void TaskManagerModel::Refresh() {
     iter->second = 0;
   }
 
-  // Let resources update themselves if they need to.
+  // Let resources update themselves if they need to, and the values they
+  // share with the other resources of their process once per process.
+  std::set<base::ProcessHandle> refreshed_processes;
   for (ResourceList::iterator iter = resources_.begin();
        iter != resources_.end(); ++iter) {
      (*iter)->Refresh();
+     if (refreshed_processes.insert((*iter)->GetProcess()).second)
+       (*iter)->RefreshProcessStats();
   }
 
   if (!resources_.empty()) {
@@ -28,7 +28,7 @@ const char* kZeroCPUUsage = "0";
 
 class TestResource : public task_manager::Resource {
  public:
-  TestResource() : refresh_called_(false) {}
+  TestResource() : refresh_called_(false), process_stats_refresh_count_(0) {}
 
   virtual string16 GetTitle() const OVERRIDE {
     return ASCIIToUTF16("test title");
@@ -53,9 +53,16 @@ class TestResource : public task_manager::Resource {
   void set_refresh_called(bool refresh_called) {
     refresh_called_ = refresh_called;
   }
+  virtual void RefreshProcessStats() OVERRIDE {
+    process_stats_refresh_count_++;
+  }
+  int process_stats_refresh_count() const {
+    return process_stats_refresh_count_;
+  }
 
  private:
   bool refresh_called_;
+  int process_stats_refresh_count_;
 };
 
 }  // namespace
@@ -122,3 +129,22 @@ TEST_F(TaskManagerTest, RefreshCalled) {
   ASSERT_TRUE(resource.refresh_called());
   task_manager.RemoveResource(&resource);
 }
+
+TEST_F(TaskManagerTest, RefreshProcessStatsOncePerProcess) {
+  base::MessageLoop loop;
+  TaskManager task_manager;
+  TaskManagerModel* model = task_manager.model_.get();
+  // Both resources are in the current process.
+  TestResource resource1, resource2;
+
+  task_manager.AddResource(&resource1);
+  task_manager.AddResource(&resource2);
+  model->update_state_ = TaskManagerModel::TASK_PENDING;
+  model->Refresh();
+  EXPECT_TRUE(resource1.refresh_called());
+  EXPECT_TRUE(resource2.refresh_called());
+  EXPECT_EQ(1, resource1.process_stats_refresh_count() +
+               resource2.process_stats_refresh_count());
+  task_manager.RemoveResource(&resource1);
+  task_manager.RemoveResource(&resource2);
+}
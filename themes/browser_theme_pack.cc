@@ -636,6 +636,16 @@ BrowserThemePack::~BrowserThemePack() {
 scoped_refptr<BrowserThemePack> BrowserThemePack::BuildFromExtension(
     const Extension* extension) {
   DCHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
+  scoped_refptr<BrowserThemePack> pack(LoadFromExtension(extension));
+  if (!pack.get())
+    return NULL;
+  FinishBuildFromExtension(pack.get());
+  return pack;
+}
+
+// static
+scoped_refptr<BrowserThemePack> BrowserThemePack::LoadFromExtension(
+    const Extension* extension) {
   DCHECK(extension);
   DCHECK(extension->is_theme());
 
@@ -657,6 +667,19 @@ scoped_refptr<BrowserThemePack> BrowserThemePack::BuildFromExtension(
   if (!pack->LoadRawBitmapsTo(file_paths, &pack->images_on_ui_thread_))
     return NULL;
 
+  // The decoded images are used on the UI thread from now on.
+  for (ImageCache::iterator it = pack->images_on_ui_thread_.begin();
+       it != pack->images_on_ui_thread_.end(); ++it) {
+    gfx::ImageSkia* image_skia =
+        const_cast<gfx::ImageSkia*>(it->second.ToImageSkia());
+    image_skia->DetachStorageFromThread();
+  }
+  return pack;
+}
+
+// static
+void BrowserThemePack::FinishBuildFromExtension(BrowserThemePack* pack) {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
   pack->CreateImages(&pack->images_on_ui_thread_);
 
   // Make sure the |images_on_file_thread_| has bitmaps for supported
@@ -690,7 +713,6 @@ scoped_refptr<BrowserThemePack> BrowserThemePack::BuildFromExtension(
   }
 
   // The BrowserThemePack is now in a consistent state.
-  return pack;
 }
 
 // static
@@ -757,6 +779,7 @@ scoped_refptr<BrowserThemePack> BrowserThemePack::BuildFromDataPack(
   if (!InputScalesValid(pointer, pack->scale_factors_)) {
     DLOG(ERROR) << "BuildFromDataPack failure! The pack scale factors differ "
                 << "from those supported by platform.";
+    pack->scale_factors_stale_ = true;
   }
   return pack;
 }
@@ -926,7 +949,8 @@ BrowserThemePack::BrowserThemePack()
       tints_(NULL),
       colors_(NULL),
       display_properties_(NULL),
-      source_images_(NULL) {
+      source_images_(NULL),
+      scale_factors_stale_(false) {
   scale_factors_ = ui::GetSupportedScaleFactors();
 }
 
@@ -61,6 +61,17 @@ class BrowserThemePack : public CustomThemeSupplier {
   static scoped_refptr<BrowserThemePack> BuildFromExtension(
       const extensions::Extension* extension);
 
+  // Does the part of BuildFromExtension() which reads and decodes the images
+  // of |extension|. Unlike the rest, it may run on any thread. The returned
+  // pack must be passed to FinishBuildFromExtension() on the UI thread before
+  // it is used. Returns NULL if an image could not be read.
+  static scoped_refptr<BrowserThemePack> LoadFromExtension(
+      const extensions::Extension* extension);
+
+  // Completes a pack returned by LoadFromExtension() by creating the images
+  // derived from those of the theme, such as the tinted frames.
+  static void FinishBuildFromExtension(BrowserThemePack* pack);
+
   // Builds the theme pack from a previously performed WriteToDisk(). This
   // operation should be relatively fast, as it should be an mmap() and some
   // pointer swizzling. Returns NULL on any error attempting to read |path|.
@@ -78,6 +89,11 @@ class BrowserThemePack : public CustomThemeSupplier {
   // destruction.
   bool WriteToDisk(const base::FilePath& path) const;
 
+  // Returns true if this pack was read from a data pack written for other
+  // scale factors than the supported ones. Images for the missing scale
+  // factors are then computed when first used, so the pack should be rebuilt.
+  bool scale_factors_stale() const { return scale_factors_stale_; }
+
   // Overridden from CustomThemeSupplier:
   virtual bool GetTint(int id, color_utils::HSL* hsl) const OVERRIDE;
   virtual bool GetColor(int id, SkColor* color) const OVERRIDE;
@@ -254,6 +270,9 @@ class BrowserThemePack : public CustomThemeSupplier {
   // The scale factors represented by the images in the theme pack.
   std::vector<ui::ScaleFactor> scale_factors_;
 
+  // Whether the scale factors of the data pack differ from |scale_factors_|.
+  bool scale_factors_stale_;
+
   // References to raw PNG data. This map isn't touched when |data_pack_| is
   // non-NULL; |image_memory_| is only filled during BuildFromExtension(). Any
   // image data that needs to be written to the DataPack during WriteToDisk()
@@ -584,9 +584,33 @@ TEST_F(BrowserThemePackTest, CanBuildAndReadPack) {
             file, "mblmlcbknbnfebdfjnolmcapmdofhmme");
     ASSERT_TRUE(pack.get());
     VerifyStarGazing(pack.get());
+    EXPECT_FALSE(pack->scale_factors_stale());
   }
 }
 
+TEST_F(BrowserThemePackTest, DetectsStaleScaleFactors) {
+  base::ScopedTempDir dir;
+  ASSERT_TRUE(dir.CreateUniqueTempDir());
+  base::FilePath file = dir.path().AppendASCII("data.pak");
+
+  // Write the pack while only 1x is supported.
+  {
+    std::vector<ui::ScaleFactor> scale_factors;
+    scale_factors.push_back(ui::SCALE_FACTOR_100P);
+    ui::test::ScopedSetSupportedScaleFactors only_100p(scale_factors);
+    scoped_refptr<BrowserThemePack> pack;
+    BuildFromUnpackedExtension(GetStarGazingPath(), pack);
+    ASSERT_TRUE(pack->WriteToDisk(file));
+  }
+
+  // The pack is still usable once 2x is supported as well, but stale.
+  scoped_refptr<BrowserThemePack> pack =
+      BrowserThemePack::BuildFromDataPack(
+          file, "mblmlcbknbnfebdfjnolmcapmdofhmme");
+  ASSERT_TRUE(pack.get());
+  EXPECT_TRUE(pack->scale_factors_stale());
+}
+
 TEST_F(BrowserThemePackTest, HiDpiThemeTest) {
   base::ScopedTempDir dir;
   ASSERT_TRUE(dir.CreateUniqueTempDir());
@@ -11,6 +11,7 @@
 #include "base/sequenced_task_runner.h"
 #include "base/strings/string_util.h"
 #include "base/strings/utf_string_conversions.h"
+#include "base/task_runner_util.h"
 #include "chrome/browser/chrome_notification_types.h"
 #include "chrome/browser/extensions/extension_service.h"
 #include "chrome/browser/extensions/extension_system.h"
@@ -61,6 +62,10 @@ const char* kDefaultThemeGalleryID = "hkacjpbfdknhflllbcmjibkdeoafencn";
 // ExtensionService::GarbageCollectExtensions() does something similar.
 const int kRemoveUnusedThemesStartupDelay = 30;
 
+// Wait this many seconds after startup to rebuild a theme pack which was
+// written for other scale factors, for the same reason.
+const int kRebuildStaleThemePackStartupDelay = 10;
+
 SkColor TintForUnderline(SkColor input) {
   return SkColorSetA(input, SkColorGetA(input) / 3);
 }
@@ -85,6 +90,7 @@ ThemeService::ThemeService()
     : ready_(false),
       rb_(ResourceBundle::GetSharedInstance()),
       profile_(NULL),
+      theme_pack_stale_(false),
       installed_pending_load_id_(kDefaultThemeID),
       number_of_infobars_(0),
       weak_ptr_factory_(this) {
@@ -437,8 +443,11 @@ void ThemeService::LoadThemePrefs() {
   // If we don't have a file pack, we're updating from an old version.
   base::FilePath path = prefs->GetFilePath(prefs::kCurrentThemePackFilename);
   if (path != base::FilePath()) {
-    SwapThemeSupplier(BrowserThemePack::BuildFromDataPack(path, current_id));
+    scoped_refptr<BrowserThemePack> pack(
+        BrowserThemePack::BuildFromDataPack(path, current_id));
+    SwapThemeSupplier(pack);
     loaded_pack = theme_supplier_.get() != NULL;
+    theme_pack_stale_ = loaded_pack && pack->scale_factors_stale();
   }
 
   if (loaded_pack) {
@@ -506,6 +515,13 @@ void ThemeService::OnExtensionServiceReady() {
                  weak_ptr_factory_.GetWeakPtr(),
                  false),
       base::TimeDelta::FromSeconds(kRemoveUnusedThemesStartupDelay));
+
+  if (theme_pack_stale_) {
+    base::MessageLoop::current()->PostDelayedTask(FROM_HERE,
+        base::Bind(&ThemeService::RebuildStaleThemePack,
+                   weak_ptr_factory_.GetWeakPtr()),
+        base::TimeDelta::FromSeconds(kRebuildStaleThemePackStartupDelay));
+  }
 }
 
 void ThemeService::MigrateTheme() {
@@ -526,8 +542,53 @@ void ThemeService::MigrateTheme() {
   }
 }
 
+void ThemeService::RebuildStaleThemePack() {
+  // The theme may have changed since startup.
+  if (!theme_pack_stale_)
+    return;
+
+  // Unlike MigrateTheme(), keep using the stale pack if the extension is not
+  // found: it is still complete, only slower to draw.
+  ExtensionService* service =
+      extensions::ExtensionSystem::Get(profile_)->extension_service();
+  const Extension* extension = service ?
+      service->GetExtensionById(GetThemeID(), false) : NULL;
+  if (!extension)
+    return;
+
+  // Reading and decoding the images is the slow part, so it is done on the
+  // file thread.
+  base::PostTaskAndReplyWithResult(
+      service->GetFileTaskRunner(),
+      FROM_HERE,
+      base::Bind(&BrowserThemePack::LoadFromExtension,
+                 make_scoped_refptr(extension)),
+      base::Bind(&ThemeService::OnStaleThemePackLoaded,
+                 weak_ptr_factory_.GetWeakPtr(),
+                 extension->id(),
+                 extension->path()));
+}
+
+void ThemeService::OnStaleThemePackLoaded(
+    const std::string& extension_id,
+    const base::FilePath& extension_path,
+    scoped_refptr<BrowserThemePack> pack) {
+  // The theme may have changed while the pack was loading.
+  if (!theme_pack_stale_ || GetThemeID() != extension_id)
+    return;
+  if (!pack.get()) {
+    LOG(ERROR) << "Could not rebuild theme pack.";
+    return;
+  }
+
+  BrowserThemePack::FinishBuildFromExtension(pack.get());
+  UseNewThemePack(pack, extension_path);
+  NotifyThemeChanged();
+}
+
 void ThemeService::SwapThemeSupplier(
     scoped_refptr<CustomThemeSupplier> theme_supplier) {
+  theme_pack_stale_ = false;
   if (theme_supplier_.get())
     theme_supplier_->StopUsingTheme();
   theme_supplier_ = theme_supplier;
@@ -554,14 +615,18 @@ void ThemeService::BuildFromExtension(const Extension* extension) {
     return;
   }
 
+  UseNewThemePack(pack, extension->path());
+}
+
+void ThemeService::UseNewThemePack(scoped_refptr<BrowserThemePack> pack,
+                                   const base::FilePath& extension_path) {
   ExtensionService* service =
       extensions::ExtensionSystem::Get(profile_)->extension_service();
   if (!service)
     return;
 
   // Write the packed file to disk.
-  base::FilePath pack_path =
-      extension->path().Append(chrome::kThemePackFilename);
+  base::FilePath pack_path = extension_path.Append(chrome::kThemePackFilename);
   service->GetFileTaskRunner()->PostTask(
       FROM_HERE,
       base::Bind(&WritePackToDiskCallback, pack, pack_path));
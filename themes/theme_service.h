@@ -199,6 +199,16 @@ class ThemeService : public base::NonThreadSafe,
   // from the extension.
   void MigrateTheme();
 
+  // Rebuilds the theme pack loaded at startup if it was written for other
+  // scale factors, so that the next startup doesn't have to scale its images.
+  void RebuildStaleThemePack();
+
+  // Called when the images of the theme |extension_id| at |extension_path|
+  // have been loaded into |pack| off the UI thread by RebuildStaleThemePack().
+  void OnStaleThemePackLoaded(const std::string& extension_id,
+                              const base::FilePath& extension_path,
+                              scoped_refptr<BrowserThemePack> pack);
+
   // Replaces the current theme supplier with a new one and calls
   // StopUsingTheme() or StartUsingTheme() as appropriate.
   void SwapThemeSupplier(scoped_refptr<CustomThemeSupplier> theme_supplier);
@@ -213,6 +223,11 @@ class ThemeService : public base::NonThreadSafe,
   // case we don't have a theme pack).
   void BuildFromExtension(const extensions::Extension* extension);
 
+  // Writes |pack|, built from the theme at |extension_path|, to disk and
+  // makes it the current theme supplier.
+  void UseNewThemePack(scoped_refptr<BrowserThemePack> pack,
+                       const base::FilePath& extension_path);
+
   // Returns true if the profile belongs to a managed user.
   bool IsManagedUser() const;
 
@@ -249,6 +264,10 @@ class ThemeService : public base::NonThreadSafe,
 
   scoped_refptr<CustomThemeSupplier> theme_supplier_;
 
+  // True if |theme_supplier_| is a theme pack loaded from disk which was
+  // written for other scale factors than the supported ones.
+  bool theme_pack_stale_;
+
   // The id of the theme extension which has just been installed but has not
   // been loaded yet. The theme extension with |installed_pending_load_id_| may
   // never be loaded if the install is due to updating a disabled theme.
@@ -607,6 +607,37 @@ TEST_F(ThumbnailContentAnalysisTest, ComputeDecimatedImage) {
                                     gfx::Point(0, 100)));
 }
 
+TEST_F(ThumbnailContentAnalysisTest, ComputeDecimatedImageKeepsRightEdge) {
+  gfx::Size image_size(800, 600);
+  gfx::Canvas canvas(image_size, 1.0f, true);
+  canvas.FillRect(gfx::Rect(0, 0, 100, 100), SkColorSetRGB(125, 0, 0));
+  canvas.FillRect(gfx::Rect(700, 0, 100, 100), SkColorSetRGB(0, 200, 0));
+
+  std::vector<bool> rows(image_size.height(), false);
+  std::fill_n(rows.begin(), 100, true);
+
+  // Keep the columns at both edges of the image.
+  std::vector<bool> columns(image_size.width(), false);
+  std::fill_n(columns.begin(), 100, true);
+  std::fill_n(columns.begin() + 700, 100, true);
+
+  SkBitmap source =
+      skia::GetTopDevice(*canvas.sk_canvas())->accessBitmap(false);
+  SkBitmap result = ComputeDecimatedImage(source, rows, columns);
+  EXPECT_EQ(200, result.width());
+  EXPECT_EQ(100, result.height());
+  ASSERT_TRUE(CompareImageFragments(source,
+                                    result,
+                                    gfx::Size(100, 100),
+                                    gfx::Point(0, 0),
+                                    gfx::Point(0, 0)));
+  ASSERT_TRUE(CompareImageFragments(source,
+                                    result,
+                                    gfx::Size(100, 100),
+                                    gfx::Point(700, 0),
+                                    gfx::Point(100, 0)));
+}
+
 TEST_F(ThumbnailContentAnalysisTest, CreateRetargetedThumbnailImage) {
   gfx::Size image_size(1200, 1300);
   gfx::Canvas canvas(image_size, 1.0f, true);
@@ -21,13 +21,6 @@ const char kThumbnailHistogramName[] = "Thumbnail.RetargetMS";
 const char kFailureHistogramName[] = "Thumbnail.FailedRetargetMS";
 const float kScoreBoostFromSuccessfulRetargeting = 1.1f;
 
-void CallbackInvocationAdapter(
-    const thumbnails::ThumbnailingAlgorithm::ConsumerCallback& callback,
-    scoped_refptr<thumbnails::ThumbnailingContext> context,
-    const SkBitmap& source_bitmap) {
-  callback.Run(*context.get(), source_bitmap);
-}
-
 }  // namespace
 
 namespace thumbnails {
@@ -192,10 +185,7 @@ void ContentBasedThumbnailingAlgorithm::CreateRetargetedThumbnail(
        context->clip_result == CLIP_RESULT_NOT_CLIPPED ||
        context->clip_result == CLIP_RESULT_SOURCE_SAME_AS_TARGET);
   // Post the result (the bitmap) back to the callback.
-  BrowserThread::PostTask(
-      BrowserThread::UI,
-      FROM_HERE,
-      base::Bind(&CallbackInvocationAdapter, callback, context, thumbnail));
+  SimpleThumbnailCrop::PostConsumerCallback(callback, context, thumbnail);
 }
 
 ContentBasedThumbnailingAlgorithm::~ContentBasedThumbnailingAlgorithm() {
@@ -4,7 +4,9 @@
 
 #include "chrome/browser/thumbnails/simple_thumbnail_crop.h"
 
+#include "base/bind.h"
 #include "base/metrics/histogram.h"
+#include "base/threading/sequenced_worker_pool.h"
 #include "content/public/browser/browser_thread.h"
 #include "skia/ext/platform_canvas.h"
 #include "ui/gfx/color_utils.h"
@@ -16,10 +18,20 @@
 
 namespace {
 static const char kThumbnailHistogramName[] = "Thumbnail.ComputeMS";
+
+void CallbackInvocationAdapter(
+    const thumbnails::ThumbnailingAlgorithm::ConsumerCallback& callback,
+    scoped_refptr<thumbnails::ThumbnailingContext> context,
+    const SkBitmap& thumbnail) {
+  callback.Run(*context.get(), thumbnail);
+}
+
 }
 
 namespace thumbnails {
 
+using content::BrowserThread;
+
 SimpleThumbnailCrop::SimpleThumbnailCrop(const gfx::Size& target_size)
     : target_size_(target_size) {
   DCHECK(!target_size.IsEmpty());
@@ -41,22 +53,32 @@ void SimpleThumbnailCrop::ProcessBitmap(
     scoped_refptr<ThumbnailingContext> context,
     const ConsumerCallback& callback,
     const SkBitmap& bitmap) {
-  DCHECK(content::BrowserThread::CurrentlyOn(content::BrowserThread::UI));
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
   if (bitmap.isNull() || bitmap.empty())
     return;
 
-  SkBitmap thumbnail = CreateThumbnail(
-      bitmap,
-      ComputeTargetSizeAtMaximumScale(target_size_),
-      &context->clip_result);
-
-  context->score.boring_score = CalculateBoringScore(thumbnail);
-  context->score.good_clipping =
-      (context->clip_result == CLIP_RESULT_WIDER_THAN_TALL ||
-       context->clip_result == CLIP_RESULT_TALLER_THAN_WIDE ||
-       context->clip_result == CLIP_RESULT_NOT_CLIPPED);
+  SkBitmap source_bitmap = bitmap;
+#if !defined(USE_AURA)
+  // The bitmap may be one of the magic ones in PlatformCanvas, which can't be
+  // refcounted and therefore can't be handed to another thread (see
+  // CreateThumbnail()). The copy is cheap since the backing store has been
+  // copied at about the size of the thumbnail already.
+  bitmap.copyTo(&source_bitmap, SkBitmap::kARGB_8888_Config);
+#endif
 
-  callback.Run(*context.get(), thumbnail);
+  // Clipping, downsampling and scoring the bitmap are done in the blocking
+  // pool so that they don't add to the cost of switching tabs.
+  if (!BrowserThread::GetBlockingPool()->PostWorkerTaskWithShutdownBehavior(
+          FROM_HERE,
+          base::Bind(&ProcessBitmapOnWorker,
+                     source_bitmap,
+                     ComputeTargetSizeAtMaximumScale(target_size_),
+                     context,
+                     callback),
+          base::SequencedWorkerPool::SKIP_ON_SHUTDOWN)) {
+    LOG(WARNING) << "PostSequencedWorkerTask failed. The thumbnail for "
+                 << context->url << " will not be created.";
+  }
 }
 
 double SimpleThumbnailCrop::CalculateBoringScore(const SkBitmap& bitmap) {
@@ -188,9 +210,38 @@ gfx::Size SimpleThumbnailCrop::ComputeTargetSizeAtMaximumScale(
   return gfx::ToFlooredSize(gfx::ScaleSize(given_size, max_scale_factor));
 }
 
+// static
+void SimpleThumbnailCrop::PostConsumerCallback(
+    const ConsumerCallback& callback,
+    scoped_refptr<ThumbnailingContext> context,
+    const SkBitmap& thumbnail) {
+  BrowserThread::PostTask(
+      BrowserThread::UI,
+      FROM_HERE,
+      base::Bind(&CallbackInvocationAdapter, callback, context, thumbnail));
+}
+
 SimpleThumbnailCrop::~SimpleThumbnailCrop() {
 }
 
+// static
+void SimpleThumbnailCrop::ProcessBitmapOnWorker(
+    const SkBitmap& bitmap,
+    const gfx::Size& desired_size,
+    scoped_refptr<ThumbnailingContext> context,
+    const ConsumerCallback& callback) {
+  SkBitmap thumbnail =
+      CreateThumbnail(bitmap, desired_size, &context->clip_result);
+
+  context->score.boring_score = CalculateBoringScore(thumbnail);
+  context->score.good_clipping =
+      (context->clip_result == CLIP_RESULT_WIDER_THAN_TALL ||
+       context->clip_result == CLIP_RESULT_TALLER_THAN_WIDE ||
+       context->clip_result == CLIP_RESULT_NOT_CLIPPED);
+
+  PostConsumerCallback(callback, context, thumbnail);
+}
+
 // Creates a downsampled thumbnail from the given bitmap.
 // store. The returned bitmap will be isNull if there was an error creating it.
 SkBitmap SimpleThumbnailCrop::CreateThumbnail(const SkBitmap& bitmap,
@@ -56,10 +56,24 @@ class SimpleThumbnailCrop : public ThumbnailingAlgorithm {
   // bumping the resolution up to the maximum scale factor.
   static gfx::Size ComputeTargetSizeAtMaximumScale(const gfx::Size& given_size);
 
+  // Posts a task to the UI thread which runs |callback| with |context| and
+  // |thumbnail|. Used by the algorithms which process bitmaps in the blocking
+  // pool.
+  static void PostConsumerCallback(const ConsumerCallback& callback,
+                                   scoped_refptr<ThumbnailingContext> context,
+                                   const SkBitmap& thumbnail);
+
  protected:
   virtual ~SimpleThumbnailCrop();
 
  private:
+  // Creates and scores the thumbnail of |bitmap| and posts it to |callback| on
+  // the UI thread. Runs in the blocking pool.
+  static void ProcessBitmapOnWorker(const SkBitmap& bitmap,
+                                    const gfx::Size& desired_size,
+                                    scoped_refptr<ThumbnailingContext> context,
+                                    const ConsumerCallback& callback);
+
   static SkBitmap CreateThumbnail(const SkBitmap& bitmap,
                                   const gfx::Size& desired_size,
                                   ClipResult* clip_result);
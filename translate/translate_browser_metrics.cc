@@ -25,6 +25,7 @@ const char kTranslateUndisplayableLanguage[] =
     "Translate.UndisplayableLanguage";
 const char kTranslateUnsupportedLanguageAtInitiation[] =
     "Translate.UnsupportedLanguageAtInitiation";
+const char kTranslateTimeToTranslatePage[] = "Translate.TimeToTranslatePage";
 
 struct MetricsEntry {
   TranslateBrowserMetrics::MetricsNameIndex index;
@@ -43,6 +44,8 @@ const MetricsEntry kMetricsEntries[] = {
     kTranslateUndisplayableLanguage },
   { TranslateBrowserMetrics::UMA_UNSUPPORTED_LANGUAGE_AT_INITIATION,
     kTranslateUnsupportedLanguageAtInitiation },
+  { TranslateBrowserMetrics::UMA_TIME_TO_TRANSLATE_PAGE,
+    kTranslateTimeToTranslatePage },
 };
 
 COMPILE_ASSERT(arraysize(kMetricsEntries) == TranslateBrowserMetrics::UMA_MAX,
@@ -79,6 +82,10 @@ void ReportUnsupportedLanguageAtInitiation(const std::string& language) {
                               language_code);
 }
 
+void ReportTimeToTranslatePage(base::TimeDelta time) {
+  UMA_HISTOGRAM_MEDIUM_TIMES(kTranslateTimeToTranslatePage, time);
+}
+
 const char* GetMetricsName(MetricsNameIndex index) {
   for (size_t i = 0; i < arraysize(kMetricsEntries); ++i) {
     if (kMetricsEntries[i].index == index)
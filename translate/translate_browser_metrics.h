@@ -7,6 +7,8 @@
 
 #include <string>
 
+#include "base/time/time.h"
+
 namespace TranslateBrowserMetrics {
 
 // An indexing type to query each UMA entry name via GetMetricsName() function.
@@ -17,6 +19,7 @@ enum MetricsNameIndex {
   UMA_LOCALES_ON_DISABLED_BY_PREFS,
   UMA_UNDISPLAYABLE_LANGUAGE,
   UMA_UNSUPPORTED_LANGUAGE_AT_INITIATION,
+  UMA_TIME_TO_TRANSLATE_PAGE,
   UMA_MAX,
 };
 
@@ -54,6 +57,10 @@ void ReportUndisplayableLanguage(const std::string& language);
 
 void ReportUnsupportedLanguageAtInitiation(const std::string& language);
 
+// Called when a page has been translated to report how long it took from the
+// request to translate it, which includes fetching the translate script.
+void ReportTimeToTranslatePage(base::TimeDelta time);
+
 // Provides UMA entry names for unit tests.
 const char* GetMetricsName(MetricsNameIndex index);
 
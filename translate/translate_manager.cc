@@ -410,6 +410,15 @@ void TranslateManager::InitiateTranslation(WebContents* web_contents,
     return;
   }
 
+  // Fetch the translate script while the user looks at the infobar, so that
+  // the page can be translated right away if they accept.
+  if (script_.get() && script_->data().empty() &&
+      !script_->HasPendingRequest()) {
+    script_->Request(
+        base::Bind(&TranslateManager::OnTranslateScriptFetchComplete,
+                   base::Unretained(this)));
+  }
+
   // Prompts the user if he/she wants the page translated.
   TranslateBrowserMetrics::ReportInitiationStatus(
       TranslateBrowserMetrics::INITIATION_STATUS_SHOW_INFOBAR);
@@ -468,6 +477,13 @@ void TranslateManager::TranslatePage(WebContents* web_contents,
   if (!IsSupportedLanguage(source_lang))
     source_lang = std::string(translate::kUnknownLanguageCode);
 
+  TranslateTabHelper* translate_tab_helper =
+      TranslateTabHelper::FromWebContents(web_contents);
+  if (translate_tab_helper) {
+    translate_tab_helper->language_state().set_translation_start_time(
+        base::TimeTicks::Now());
+  }
+
   Profile* profile =
       Profile::FromBrowserContext(web_contents->GetBrowserContext());
   TranslateInfoBarDelegate::Create(
@@ -585,6 +601,18 @@ void TranslateManager::PageTranslated(WebContents* web_contents,
     details->error_type = TranslateErrors::UNSUPPORTED_LANGUAGE;
   }
 
+  TranslateTabHelper* translate_tab_helper =
+      TranslateTabHelper::FromWebContents(web_contents);
+  if (translate_tab_helper) {
+    LanguageState& language_state = translate_tab_helper->language_state();
+    if (details->error_type == TranslateErrors::NONE &&
+        !language_state.translation_start_time().is_null()) {
+      TranslateBrowserMetrics::ReportTimeToTranslatePage(
+          base::TimeTicks::Now() - language_state.translation_start_time());
+    }
+    language_state.set_translation_start_time(base::TimeTicks());
+  }
+
   PrefService* prefs = Profile::FromBrowserContext(
       web_contents->GetBrowserContext())->GetPrefs();
   TranslateInfoBarDelegate::Create(
@@ -6,7 +6,9 @@
 
 #include <string>
 
+#include "base/metrics/histogram.h"
 #include "base/strings/utf_string_conversions.h"
+#include "base/time/time.h"
 #include "chrome/browser/chrome_notification_types.h"
 #include "chrome/browser/extensions/extension_service.h"
 #include "chrome/browser/extensions/extension_system_factory.h"
@@ -52,13 +54,23 @@ AppSearchProvider::AppSearchProvider(
 AppSearchProvider::~AppSearchProvider() {}
 
 void AppSearchProvider::Start(const string16& query) {
+  const base::TimeTicks start_time = base::TimeTicks::Now();
   const TokenizedString query_terms(query);
 
   ClearResults();
 
+  if (query_terms.tokens().empty() || query_terms.tokens()[0].empty())
+    return;
+
+  AppsByInitial::const_iterator candidates =
+      apps_by_initial_.find(query_terms.tokens()[0][0]);
+  if (candidates == apps_by_initial_.end())
+    return;
+
   TokenizedStringMatch match;
-  for (Apps::const_iterator app_it = apps_.begin();
-       app_it != apps_.end();
+  const std::vector<const App*>& apps = candidates->second;
+  for (std::vector<const App*>::const_iterator app_it = apps.begin();
+       app_it != apps.end();
        ++app_it) {
     if (!match.Calculate(query_terms, (*app_it)->indexed_name()))
       continue;
@@ -68,6 +80,9 @@ void AppSearchProvider::Start(const string16& query) {
     result->UpdateFromMatch((*app_it)->indexed_name(), match);
     Add(result.PassAs<ChromeSearchResult>());
   }
+
+  UMA_HISTOGRAM_TIMES("Apps.AppListSearchAppsTime",
+                      base::TimeTicks::Now() - start_time);
 }
 
 void AppSearchProvider::Stop() {}
@@ -85,6 +100,19 @@ void AppSearchProvider::AddApps(const ExtensionSet* extensions,
         !service->CanLoadInIncognito(app))
       continue;
     apps_.push_back(new App(app));
+    IndexApp(apps_.back());
+  }
+}
+
+void AppSearchProvider::IndexApp(const App* app) {
+  const TokenizedString::Tokens& tokens = app->indexed_name().tokens();
+  for (size_t i = 0; i < tokens.size(); ++i) {
+    if (tokens[i].empty())
+      continue;
+
+    std::vector<const App*>& apps = apps_by_initial_[tokens[i][0]];
+    if (apps.empty() || apps.back() != app)
+      apps.push_back(app);
   }
 }
 
@@ -96,6 +124,7 @@ void AppSearchProvider::RefreshApps() {
     return;  // During testing, there is no extension service.
 
   apps_.clear();
+  apps_by_initial_.clear();
 
   AddApps(extension_service->extensions(), extension_service);
   AddApps(extension_service->disabled_extensions(), extension_service);
@@ -5,6 +5,9 @@
 #ifndef CHROME_BROWSER_UI_APP_LIST_SEARCH_APP_SEARCH_PROVIDER_H_
 #define CHROME_BROWSER_UI_APP_LIST_SEARCH_APP_SEARCH_PROVIDER_H_
 
+#include <map>
+#include <vector>
+
 #include "base/basictypes.h"
 #include "base/memory/scoped_vector.h"
 #include "chrome/browser/ui/app_list/search/search_provider.h"
@@ -32,11 +35,16 @@ class AppSearchProvider : public SearchProvider,
  private:
   class App;
   typedef ScopedVector<App> Apps;
+  typedef std::map<base::char16, std::vector<const App*> > AppsByInitial;
 
   // Adds extensions to apps container if they should be displayed.
   void AddApps(const ExtensionSet* extensions, ExtensionService* service);
   void RefreshApps();
 
+  // Adds |app| to |apps_by_initial_| under the first character of each of its
+  // name's tokens.
+  void IndexApp(const App* app);
+
   // content::NotificationObserver overrides:
   virtual void Observe(int type,
                        const content::NotificationSource& source,
@@ -48,6 +56,12 @@ class AppSearchProvider : public SearchProvider,
 
   Apps apps_;
 
+  // The apps in |apps_|, in the same order, keyed by the first characters of
+  // their name's tokens. A query can only match an app name that has a token
+  // starting with the query's first character, so Start() only needs to look
+  // at the apps under that character.
+  AppsByInitial apps_by_initial_;
+
   DISALLOW_COPY_AND_ASSIGN(AppSearchProvider);
 };
 
@@ -88,6 +88,13 @@ TEST_F(AppSearchProviderTest, Basic) {
   EXPECT_EQ("Hosted App", RunQuery("host"));
 }
 
+TEST_F(AppSearchProviderTest, MatchesFromAnyToken) {
+  // Queries may start matching at any token of the name.
+  EXPECT_EQ("Packaged App 2", RunQuery("app 2"));
+  EXPECT_EQ("Packaged App 1", RunQuery("1"));
+  EXPECT_EQ("", RunQuery("ost"));
+}
+
 TEST_F(AppSearchProviderTest, DisableAndEnable) {
   EXPECT_EQ("Hosted App", RunQuery("host"));
 
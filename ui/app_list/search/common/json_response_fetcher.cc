@@ -83,6 +83,8 @@ void JSONResponseFetcher::OnURLFetchComplete(
                          base::Bind(
                              &JSONResponseFetcher::OnJsonParseError,
                              weak_factory_.GetWeakPtr()));
+  // Searches send a response per keystroke, all from the same trusted server.
+  parser->set_process_mode(BatchedUtilityProcessHost::SHARED_PROCESS);
   // The parser will call us back via one of the callbacks.
   parser->Start();
 }
@@ -74,6 +74,9 @@ void UrlIconSource::OnURLFetchComplete(
 
   image_decoder_ =
       new ImageDecoder(this, unsafe_icon_data, ImageDecoder::DEFAULT_CODEC);
+  // Search results load their icons in bursts, from the same server as the
+  // results.
+  image_decoder_->set_process_mode(BatchedUtilityProcessHost::SHARED_PROCESS);
   image_decoder_->Start(
       BrowserThread::GetMessageLoopProxyForThread(BrowserThread::UI));
 }
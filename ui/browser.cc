@@ -333,6 +333,7 @@ Browser::Browser(const CreateParams& params)
       override_bounds_(params.initial_bounds),
       initial_show_state_(params.initial_show_state),
       is_session_restore_(params.is_session_restore),
+      pending_history_sync_index_(-1),
       host_desktop_type_(params.host_desktop_type),
       content_setting_bubble_model_delegate_(
           new BrowserContentSettingBubbleModelDelegate(this)),
@@ -1180,6 +1181,14 @@ void Browser::TabStripEmpty() {
   instant_controller_.reset();
 }
 
+void Browser::TabStripBatchUpdateEnded(TabStripModel* tab_strip_model) {
+  if (pending_history_sync_index_ < 0)
+    return;
+  int index = pending_history_sync_index_;
+  pending_history_sync_index_ = -1;
+  SyncHistoryWithTabs(index);
+}
+
 bool Browser::CanOverscrollContent() const {
 #if defined(USE_AURA)
   bool overscroll_enabled = CommandLine::ForCurrentProcess()->
@@ -2041,6 +2050,12 @@ StatusBubble* Browser::GetStatusBubble() {
 // Browser, Session restore functions (private):
 
 void Browser::SyncHistoryWithTabs(int index) {
+  if (tab_strip_model_->in_batch_update()) {
+    if (pending_history_sync_index_ < 0 || index < pending_history_sync_index_)
+      pending_history_sync_index_ = index;
+    return;
+  }
+
   SessionService* session_service =
       SessionServiceFactory::GetForProfileIfExisting(profile());
   if (session_service) {
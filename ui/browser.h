@@ -451,6 +451,8 @@ class Browser : public TabStripModelObserver,
   virtual void TabPinnedStateChanged(content::WebContents* contents,
                                      int index) OVERRIDE;
   virtual void TabStripEmpty() OVERRIDE;
+  virtual void TabStripBatchUpdateEnded(TabStripModel* tab_strip_model)
+      OVERRIDE;
 
   // Overridden from content::WebContentsDelegate:
   virtual bool CanOverscrollContent() const OVERRIDE;
@@ -745,7 +747,8 @@ class Browser : public TabStripModelObserver,
   // Session restore functions ////////////////////////////////////////////////
 
   // Notifies the history database of the index for all tabs whose index is
-  // >= index.
+  // >= index. During a batch update of the tab strip this is deferred until the
+  // batch ends, since each sync touches all the tabs after |index|.
   void SyncHistoryWithTabs(int index);
 
   // In-progress download termination handling /////////////////////////////////
@@ -887,6 +890,10 @@ class Browser : public TabStripModelObserver,
   // Tracks when this browser is being created by session restore.
   bool is_session_restore_;
 
+  // The lowest index passed to SyncHistoryWithTabs() during the current batch
+  // update of the tab strip, or -1 if there was none.
+  int pending_history_sync_index_;
+
   const chrome::HostDesktopType host_desktop_type_;
 
   scoped_ptr<chrome::UnloadController> unload_controller_;
@@ -40,6 +40,7 @@
 #include "chrome/browser/net/predictor.h"
 #include "chrome/browser/notifications/desktop_notification_service.h"
 #include "chrome/browser/performance_monitor/startup_timer.h"
+#include "chrome/browser/performance_monitor/startup_tracer.h"
 #include "chrome/browser/prefs/incognito_mode_prefs.h"
 #include "chrome/browser/prefs/session_startup_pref.h"
 #include "chrome/browser/profiles/profile.h"
@@ -696,9 +697,14 @@ bool StartupBrowserCreatorImpl::ProcessStartupURLs(
 
     // The startup code only executes for browsers launched in desktop mode.
     // i.e. HOST_DESKTOP_TYPE_NATIVE. Ash should never get here.
-    Browser* browser = SessionRestore::RestoreSession(
-        profile_, NULL, desktop_type, restore_behavior,
-        urls_to_open);
+    Browser* browser = NULL;
+    {
+      performance_monitor::ScopedStartupPhase startup_phase(
+          "SessionRestore::RestoreSession");
+      browser = SessionRestore::RestoreSession(
+          profile_, NULL, desktop_type, restore_behavior,
+          urls_to_open);
+    }
 
     performance_monitor::StartupTimer::UnpauseTimer();
 
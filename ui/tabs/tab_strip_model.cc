@@ -116,6 +116,7 @@ TabStripModel::TabStripModel(TabStripModelDelegate* delegate, Profile* profile)
     : delegate_(delegate),
       profile_(profile),
       closing_all_(false),
+      batch_update_depth_(0),
       in_notify_(false) {
   DCHECK(delegate_);
   registrar_.Add(this, content::NOTIFICATION_WEB_CONTENTS_DESTROYED,
@@ -360,6 +361,8 @@ void TabStripModel::MoveSelectedTabsTo(int index) {
     selected_mini_count++;
   }
 
+  BeginBatchUpdate();
+
   // To maintain that all mini-tabs occur before non-mini-tabs we move them
   // first.
   if (selected_mini_count > 0) {
@@ -374,13 +377,14 @@ void TabStripModel::MoveSelectedTabsTo(int index) {
       index += selected_mini_count;
     }
   }
-  if (selected_mini_count == selected_count)
-    return;
+  if (selected_mini_count != selected_count) {
+    // Then move the non-pinned tabs.
+    MoveSelectedTabsToImpl(std::max(index, total_mini_count),
+                           selected_mini_count,
+                           selected_count - selected_mini_count);
+  }
 
-  // Then move the non-pinned tabs.
-  MoveSelectedTabsToImpl(std::max(index, total_mini_count),
-                         selected_mini_count,
-                         selected_count - selected_mini_count);
+  EndBatchUpdate();
 }
 
 WebContents* TabStripModel::GetActiveWebContents() const {
@@ -420,6 +424,21 @@ void TabStripModel::CloseAllTabs() {
   InternalCloseTabs(closing_tabs, CLOSE_CREATE_HISTORICAL_TAB);
 }
 
+void TabStripModel::BeginBatchUpdate() {
+  if (batch_update_depth_++ == 0) {
+    FOR_EACH_OBSERVER(TabStripModelObserver, observers_,
+                      TabStripBatchUpdateStarted(this));
+  }
+}
+
+void TabStripModel::EndBatchUpdate() {
+  DCHECK_GT(batch_update_depth_, 0);
+  if (--batch_update_depth_ == 0) {
+    FOR_EACH_OBSERVER(TabStripModelObserver, observers_,
+                      TabStripBatchUpdateEnded(this));
+  }
+}
+
 bool TabStripModel::CloseWebContentsAt(int index, uint32 close_types) {
   DCHECK(ContainsIndex(index));
   std::vector<int> closing_tabs;
@@ -1111,6 +1130,9 @@ bool TabStripModel::InternalCloseTabs(const std::vector<int>& indices,
   }
 
   // We now return to our regularly scheduled shutdown procedure.
+  const bool batch_update = indices.size() > 1;
+  if (batch_update)
+    BeginBatchUpdate();
   bool retval = true;
   while (close_tracker.HasNext()) {
     WebContents* closing_contents = close_tracker.Next();
@@ -1140,6 +1162,8 @@ bool TabStripModel::InternalCloseTabs(const std::vector<int>& indices,
     InternalCloseTab(closing_contents, index,
                      (close_types & CLOSE_CREATE_HISTORICAL_TAB) != 0);
   }
+  if (batch_update)
+    EndBatchUpdate();
 
   return retval;
 }
@@ -151,6 +151,9 @@ class TabStripModel : public content::NotificationObserver {
   // avoid doing meaningless or unhelpful work.
   bool closing_all() const { return closing_all_; }
 
+  // Returns true between BeginBatchUpdate() and the matching EndBatchUpdate().
+  bool in_batch_update() const { return batch_update_depth_ > 0; }
+
   // Access the order controller. Exposed only for unit tests.
   TabStripModelOrderController* order_controller() const {
     return order_controller_.get();
@@ -266,6 +269,13 @@ class TabStripModel : public content::NotificationObserver {
   // notifications this method causes.
   void CloseAllTabs();
 
+  // Start and end a batch of changes to several tabs. Observers are sent
+  // TabStripBatchUpdateStarted() and TabStripBatchUpdateEnded() around the
+  // outermost pair of calls, so that they can defer work until the end of the
+  // batch. Calls may be nested.
+  void BeginBatchUpdate();
+  void EndBatchUpdate();
+
   // Returns true if there are any WebContentses that are currently loading.
   bool TabsAreLoading() const;
 
@@ -629,6 +639,9 @@ class TabStripModel : public content::NotificationObserver {
   // True if all tabs are currently being closed via CloseAllTabs.
   bool closing_all_;
 
+  // Number of BeginBatchUpdate() calls without a matching EndBatchUpdate().
+  int batch_update_depth_;
+
   // An object that determines where new Tabs should be inserted and where
   // selection should move when a Tab is closed.
   scoped_ptr<TabStripModelOrderController> order_controller_;
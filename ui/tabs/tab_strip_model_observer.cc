@@ -65,3 +65,11 @@ void TabStripModelObserver::TabBlockedStateChanged(WebContents* contents,
 void TabStripModelObserver::TabStripEmpty() {}
 
 void TabStripModelObserver::TabStripModelDeleted() {}
+
+void TabStripModelObserver::TabStripBatchUpdateStarted(
+    TabStripModel* tab_strip_model) {
+}
+
+void TabStripModelObserver::TabStripBatchUpdateEnded(
+    TabStripModel* tab_strip_model) {
+}
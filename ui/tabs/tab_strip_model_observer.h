@@ -150,6 +150,13 @@ class TabStripModelObserver {
   // must be dropped.
   virtual void TabStripModelDeleted();
 
+  // Sent before and after a batch of changes to several tabs, e.g. closing or
+  // restoring many tabs at once. The usual notifications are still sent for
+  // each tab in between, but implementers may defer work that only depends on
+  // the final state of the model until TabStripBatchUpdateEnded().
+  virtual void TabStripBatchUpdateStarted(TabStripModel* tab_strip_model);
+  virtual void TabStripBatchUpdateEnded(TabStripModel* tab_strip_model);
+
  protected:
   virtual ~TabStripModelObserver() {}
 };
@@ -2300,6 +2300,74 @@ TEST_F(TabStripModelTest, CloseSelectedTabs) {
   strip.CloseAllTabs();
 }
 
+namespace {
+
+// Counts the batch updates of a TabStripModel, and the tabs closed during them.
+class BatchUpdateObserver : public TabStripModelObserver {
+ public:
+  BatchUpdateObserver()
+      : started_count_(0),
+        ended_count_(0),
+        closed_in_batch_count_(0) {}
+
+  virtual void TabClosingAt(TabStripModel* tab_strip_model,
+                            WebContents* contents,
+                            int index) OVERRIDE {
+    if (tab_strip_model->in_batch_update())
+      ++closed_in_batch_count_;
+  }
+  virtual void TabStripBatchUpdateStarted(
+      TabStripModel* tab_strip_model) OVERRIDE {
+    ++started_count_;
+  }
+  virtual void TabStripBatchUpdateEnded(
+      TabStripModel* tab_strip_model) OVERRIDE {
+    EXPECT_FALSE(tab_strip_model->in_batch_update());
+    ++ended_count_;
+  }
+
+  int started_count_;
+  int ended_count_;
+  int closed_in_batch_count_;
+};
+
+}  // namespace
+
+TEST_F(TabStripModelTest, CloseSelectedTabsInBatch) {
+  TabStripDummyDelegate delegate;
+  TabStripModel strip(&delegate, profile());
+  strip.AppendWebContents(CreateWebContents(), true);
+  strip.AppendWebContents(CreateWebContents(), true);
+  strip.AppendWebContents(CreateWebContents(), true);
+  BatchUpdateObserver observer;
+  strip.AddObserver(&observer);
+
+  // Closing a single tab is not a batch.
+  strip.CloseWebContentsAt(2, TabStripModel::CLOSE_NONE);
+  EXPECT_EQ(0, observer.started_count_);
+  EXPECT_EQ(0, observer.closed_in_batch_count_);
+
+  // Closing several tabs at once is.
+  strip.ToggleSelectionAt(0);
+  strip.CloseSelectedTabs();
+  EXPECT_EQ(0, strip.count());
+  EXPECT_EQ(1, observer.started_count_);
+  EXPECT_EQ(1, observer.ended_count_);
+  EXPECT_EQ(2, observer.closed_in_batch_count_);
+  EXPECT_FALSE(strip.in_batch_update());
+
+  // Nested batches are reported once.
+  strip.BeginBatchUpdate();
+  strip.BeginBatchUpdate();
+  strip.EndBatchUpdate();
+  EXPECT_TRUE(strip.in_batch_update());
+  strip.EndBatchUpdate();
+  EXPECT_EQ(2, observer.started_count_);
+  EXPECT_EQ(2, observer.ended_count_);
+
+  strip.RemoveObserver(&observer);
+}
+
 TEST_F(TabStripModelTest, MultipleSelection) {
   typedef MockTabStripModelObserver::State State;
 
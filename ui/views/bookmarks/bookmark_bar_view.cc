@@ -1403,7 +1403,10 @@ void BookmarkBarView::ConfigureButton(const BookmarkNode* node,
   button->set_context_menu_controller(this);
   button->set_drag_controller(this);
   if (node->is_url()) {
-    const gfx::Image& favicon = model_->GetFavicon(node);
+    // Favicons are only requested once the button is laid out visible; see
+    // LayoutItems(). BookmarkNodeFaviconChanged() reconfigures the button once
+    // the favicon has loaded.
+    const gfx::Image& favicon = node->favicon();
     if (!favicon.IsEmpty())
       button->SetIcon(*favicon.ToImageSkia());
     else
@@ -1412,6 +1415,13 @@ void BookmarkBarView::ConfigureButton(const BookmarkNode* node,
   button->set_max_width(kMaxButtonWidth);
 }
 
+void BookmarkBarView::LoadFaviconIfNeeded(const BookmarkNode* node) {
+  if (node->is_url() &&
+      node->favicon_state() == BookmarkNode::INVALID_FAVICON) {
+    model_->GetFavicon(node);
+  }
+}
+
 void BookmarkBarView::BookmarkNodeAddedImpl(BookmarkModel* model,
                                             const BookmarkNode* parent,
                                             int index) {
@@ -1788,6 +1798,8 @@ gfx::Size BookmarkBarView::LayoutItems(bool compute_bounds_only) {
       if (!compute_bounds_only) {
         child->SetVisible(next_x < max_x);
         child->SetBounds(x, y, pref.width(), height);
+        if (child->visible())
+          LoadFaviconIfNeeded(model_->bookmark_bar_node()->GetChild(i));
       }
       x = next_x;
     }
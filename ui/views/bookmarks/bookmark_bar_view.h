@@ -307,6 +307,10 @@ class BookmarkBarView : public DetachableToolbarView,
   // and icon.
   void ConfigureButton(const BookmarkNode* node, views::TextButton* button);
 
+  // Starts loading the favicon of |node| if it is a URL whose favicon hasn't
+  // been requested yet.
+  void LoadFaviconIfNeeded(const BookmarkNode* node);
+
   // Implementation for BookmarkNodeAddedImpl.
   void BookmarkNodeAddedImpl(BookmarkModel* model,
                              const BookmarkNode* parent,
@@ -46,6 +46,31 @@ const char16 kEllipsis[] = { 0x2026, 0x0 };
 const int kMinimumIconVerticalPadding = 2;
 const int kMinimumTextVerticalPadding = 3;
 
+bool ClassificationsEqual(const ACMatchClassifications& a,
+                          const ACMatchClassifications& b) {
+  if (a.size() != b.size())
+    return false;
+  for (size_t i = 0; i < a.size(); ++i) {
+    if (a[i].offset != b[i].offset || a[i].style != b[i].style)
+      return false;
+  }
+  return true;
+}
+
+// Returns true if |a| and |b| are painted the same way, so that a row showing
+// one needs no update to show the other.
+bool MatchesLookAlike(const AutocompleteMatch& a, const AutocompleteMatch& b) {
+  if (a.type != b.type || a.starred != b.starred ||
+      a.destination_url != b.destination_url ||
+      a.contents != b.contents || a.description != b.description ||
+      !ClassificationsEqual(a.contents_class, b.contents_class) ||
+      !ClassificationsEqual(a.description_class, b.description_class))
+    return false;
+  if (!a.associated_keyword.get() || !b.associated_keyword.get())
+    return !a.associated_keyword.get() && !b.associated_keyword.get();
+  return MatchesLookAlike(*a.associated_keyword, *b.associated_keyword);
+}
+
 }  // namespace
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -180,6 +205,12 @@ SkColor OmniboxResultView::GetColor(
 }
 
 void OmniboxResultView::SetMatch(const AutocompleteMatch& match) {
+  // Providers often update the results without changing what this row shows,
+  // e.g. only changing relevance scores. Keep the row as it is then, unless
+  // the keyword needs to be hidden.
+  if (animation_->GetCurrentValue() == 0 && MatchesLookAlike(match, match_))
+    return;
+
   match_ = match;
   animation_->Reset();
 
@@ -305,6 +305,15 @@ chrome::HostDesktopType GetHostDesktopType(views::View* view) {
       widget ? widget->GetNativeView() : NULL);
 }
 
+// Returns true if |data| differs from |old| only in what is painted in the
+// icon area, so that neither the layout nor the rest of the tab changes.
+bool OnlyIconChanged(const TabRendererData& old, const TabRendererData& data) {
+  TabRendererData icon_only(old);
+  icon_only.favicon = data.favicon;
+  icon_only.network_state = data.network_state;
+  return icon_only.Equals(data);
+}
+
 }  // namespace
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -512,6 +521,18 @@ void Tab::SetData(const TabRendererData& data) {
   if (data_.Equals(data))
     return;
 
+  // Favicon and network state updates are frequent while pages load, and only
+  // affect the icon, so repaint just that instead of the whole tab. Immersive
+  // tabs show the network state in their bar instead.
+  if (OnlyIconChanged(data_, data) && !data_.IsCrashed() &&
+      !IsPerformingCrashAnimation()) {
+    data_ = data;
+    ScheduleIconPaint();
+    if (controller() && controller()->IsImmersiveStyle())
+      SchedulePaintInRect(GetImmersiveBarRect());
+    return;
+  }
+
   TabRendererData old(data_);
   data_ = data;
 
@@ -1707,8 +1707,15 @@ void TabStrip::ScheduleRemoveTabAnimation(Tab* tab) {
 void TabStrip::AnimateToIdealBounds() {
   for (int i = 0; i < tab_count(); ++i) {
     Tab* tab = tab_at(i);
-    if (!tab->dragging())
-      bounds_animator_.AnimateViewTo(tab, ideal_bounds(i));
+    // Most operations only move some of the tabs. Don't start animations for
+    // the tabs that are already where they should be, which would otherwise
+    // cost an animation and a relayout of every tab in a long tab strip.
+    if (tab->dragging() ||
+        (tab->bounds() == ideal_bounds(i) &&
+         !bounds_animator_.IsAnimating(tab))) {
+      continue;
+    }
+    bounds_animator_.AnimateViewTo(tab, ideal_bounds(i));
   }
 
   bounds_animator_.AnimateViewTo(newtab_button_, newtab_button_bounds_);
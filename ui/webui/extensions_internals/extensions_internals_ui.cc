@@ -0,0 +1,87 @@
+// Copyright 2013 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "chrome/browser/ui/webui/extensions_internals/extensions_internals_ui.h"
+
+#include <string>
+
+#include "base/bind.h"
+#include "base/compiler_specific.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/values.h"
+#include "chrome/browser/extensions/extension_function_stats.h"
+#include "chrome/browser/extensions/extension_service.h"
+#include "chrome/browser/extensions/extension_system.h"
+#include "chrome/browser/profiles/profile.h"
+#include "chrome/common/extensions/extension.h"
+#include "content/public/browser/web_ui.h"
+#include "content/public/browser/web_ui_data_source.h"
+#include "content/public/browser/web_ui_message_handler.h"
+#include "grit/browser_resources.h"
+
+const char kChromeUIExtensionsInternalsHost[] = "extensions-internals";
+
+namespace {
+
+// Hands the stats of the extension functions to the page when it asks for
+// them.
+class ExtensionsInternalsHandler : public content::WebUIMessageHandler {
+ public:
+  ExtensionsInternalsHandler() {}
+  virtual ~ExtensionsInternalsHandler() {}
+
+  // WebUIMessageHandler implementation.
+  virtual void RegisterMessages() OVERRIDE {
+    web_ui()->RegisterMessageCallback(
+        "requestFunctionStats",
+        base::Bind(&ExtensionsInternalsHandler::HandleRequestFunctionStats,
+                   base::Unretained(this)));
+  }
+
+ private:
+  // Adds the names of the extensions to the stats of the calls made from
+  // profiles of the same kind as this page's, and sends them to the page.
+  void HandleRequestFunctionStats(const base::ListValue* args) {
+    Profile* profile = Profile::FromWebUI(web_ui());
+    scoped_ptr<base::ListValue> stats(
+        ExtensionFunctionStats::GetInstance()->GetStatsAsValue(
+            profile->IsOffTheRecord()));
+    ExtensionService* service =
+        extensions::ExtensionSystem::Get(profile)->extension_service();
+    for (size_t i = 0; i < stats->GetSize(); ++i) {
+      base::DictionaryValue* function_stats = NULL;
+      std::string id;
+      if (!stats->GetDictionary(i, &function_stats) ||
+          !function_stats->GetString("id", &id)) {
+        continue;
+      }
+      const extensions::Extension* extension =
+          service ? service->GetExtensionById(id, true) : NULL;
+      function_stats->SetString("name", extension ? extension->name() : id);
+    }
+    web_ui()->CallJavascriptFunction(
+        "extensionsInternals.onFunctionStats", *stats);
+  }
+
+  DISALLOW_COPY_AND_ASSIGN(ExtensionsInternalsHandler);
+};
+
+}  // namespace
+
+ExtensionsInternalsUI::ExtensionsInternalsUI(content::WebUI* web_ui)
+    : content::WebUIController(web_ui) {
+  content::WebUIDataSource* html_source =
+      content::WebUIDataSource::Create(kChromeUIExtensionsInternalsHost);
+  html_source->SetDefaultResource(IDR_EXTENSIONS_INTERNALS_HTML);
+  html_source->AddResourcePath("extensions_internals.js",
+                               IDR_EXTENSIONS_INTERNALS_JS);
+
+  Profile* profile = Profile::FromWebUI(web_ui);
+  content::WebUIDataSource::Add(profile, html_source);
+
+  // AddMessageHandler takes ownership of ExtensionsInternalsHandler.
+  web_ui->AddMessageHandler(new ExtensionsInternalsHandler());
+}
+
+ExtensionsInternalsUI::~ExtensionsInternalsUI() {}
@@ -0,0 +1,25 @@
+// Copyright 2013 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CHROME_BROWSER_UI_WEBUI_EXTENSIONS_INTERNALS_EXTENSIONS_INTERNALS_UI_H_
+#define CHROME_BROWSER_UI_WEBUI_EXTENSIONS_INTERNALS_EXTENSIONS_INTERNALS_UI_H_
+
+#include "base/basictypes.h"
+#include "content/public/browser/web_ui_controller.h"
+
+// The host of chrome://extensions-internals/.
+extern const char kChromeUIExtensionsInternalsHost[];
+
+// The UI for chrome://extensions-internals/, which shows how much time the
+// extension API calls of each extension took since the browser started.
+class ExtensionsInternalsUI : public content::WebUIController {
+ public:
+  explicit ExtensionsInternalsUI(content::WebUI* web_ui);
+  virtual ~ExtensionsInternalsUI();
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(ExtensionsInternalsUI);
+};
+
+#endif  // CHROME_BROWSER_UI_WEBUI_EXTENSIONS_INTERNALS_EXTENSIONS_INTERNALS_UI_H_
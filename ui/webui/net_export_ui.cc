@@ -62,10 +62,12 @@ class NetExportMessageHandler
   void OnGetExportNetLogInfo(const ListValue* list);
   void OnStartNetLog(const ListValue* list);
   void OnStopNetLog(const ListValue* list);
+  void OnSaveRecentNetLog(const ListValue* list);
   void OnSendNetLog(const ListValue* list);
 
  private:
-  // Calls NetLogTempFile's ProcessCommand with DO_START and DO_STOP commands.
+  // Calls NetLogTempFile's ProcessCommand with DO_START, DO_STOP and
+  // DO_SAVE_RECENT commands.
   static void ProcessNetLogCommand(
       base::WeakPtr<NetExportMessageHandler> net_export_message_handler,
       NetLogTempFile* net_log_temp_file,
@@ -124,6 +126,10 @@ void NetExportMessageHandler::RegisterMessages() {
       "stopNetLog",
       base::Bind(&NetExportMessageHandler::OnStopNetLog,
                  base::Unretained(this)));
+  web_ui()->RegisterMessageCallback(
+      "saveRecentNetLog",
+      base::Bind(&NetExportMessageHandler::OnSaveRecentNetLog,
+                 base::Unretained(this)));
   web_ui()->RegisterMessageCallback(
       "sendNetLog",
       base::Bind(&NetExportMessageHandler::OnSendNetLog,
@@ -151,6 +157,12 @@ void NetExportMessageHandler::OnStopNetLog(const ListValue* list) {
                        NetLogTempFile::DO_STOP);
 }
 
+void NetExportMessageHandler::OnSaveRecentNetLog(const ListValue* list) {
+  ProcessNetLogCommand(weak_ptr_factory_.GetWeakPtr(),
+                       net_log_temp_file_,
+                       NetLogTempFile::DO_SAVE_RECENT);
+}
+
 void NetExportMessageHandler::OnSendNetLog(const ListValue* list) {
   content::BrowserThread::PostTaskAndReplyWithResult(
     content::BrowserThread::FILE_USER_BLOCKING,
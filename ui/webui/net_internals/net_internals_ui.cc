@@ -613,9 +613,23 @@ class NetInternalsMessageHandler::IOThreadImpl
   // Sends all pending entries to the page via Javascript, and clears the list
   // of pending entries.  Sending multiple entries at once results in a
   // significant reduction of CPU usage when a lot of events are happening.
-  // Must be called on the IO Thread.
+  // If the previous entries have not been sent by the UI thread yet, keeps
+  // collecting entries and tries again later instead.  Must be called on the
+  // IO Thread.
   void PostPendingEntries();
 
+  // Like PostPendingEntries, but sends the pending entries even if the
+  // previous ones have not been sent yet.  Must be called on the IO Thread.
+  void SendPendingEntries();
+
+  // Sends |entries| to the page, and lets the IO thread know that it can send
+  // more.  Must be called on the UI Thread.
+  void SendEntriesOnUIThread(ListValue* entries);
+
+  // Called on the IO Thread once the UI thread has sent the entries passed to
+  // it by SendPendingEntries.
+  void OnEntriesSent();
+
   // Adds entries with the states of ongoing URL requests.
   void PrePopulateEventList();
 
@@ -649,6 +663,10 @@ class NetInternalsMessageHandler::IOThreadImpl
   // PostPendingEntries.  Read and written to exclusively on the IO Thread.
   scoped_ptr<ListValue> pending_entries_;
 
+  // Number of lists of entries sent to the UI thread that it has not passed
+  // along to the page yet.  Only accessed on the IO Thread.
+  int entries_in_flight_;
+
   // Used for getting current status of URLRequests when net-internals is
   // opened.  |main_context_getter_| is automatically added on construction.
   // Duplicates are allowed.
@@ -1017,7 +1035,8 @@ NetInternalsMessageHandler::IOThreadImpl::IOThreadImpl(
     : handler_(handler),
       io_thread_(io_thread),
       main_context_getter_(main_context_getter),
-      was_webui_deleted_(false) {
+      was_webui_deleted_(false),
+      entries_in_flight_(0) {
   DCHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
   AddRequestContextGetter(main_context_getter);
 }
@@ -1070,7 +1089,7 @@ void NetInternalsMessageHandler::IOThreadImpl::OnRendererReady(
   // If we have any pending entries, go ahead and get rid of them, so they won't
   // appear before the REQUEST_ALIVE events we add for currently active
   // URLRequests.
-  PostPendingEntries();
+  SendPendingEntries();
 
   SendJavascriptCommand("receivedConstants", NetInternalsUI::GetConstants());
 
@@ -1770,8 +1789,48 @@ void NetInternalsMessageHandler::IOThreadImpl::AddEntryToQueue(Value* entry) {
 
 void NetInternalsMessageHandler::IOThreadImpl::PostPendingEntries() {
   DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
-  if (pending_entries_.get())
-    SendJavascriptCommand("receivedLogEntries", pending_entries_.release());
+  if (!pending_entries_.get())
+    return;
+  if (entries_in_flight_ > 0) {
+    // The UI thread is falling behind, so let the next list of entries grow
+    // rather than queueing up more tasks for it.
+    BrowserThread::PostDelayedTask(
+        BrowserThread::IO, FROM_HERE,
+        base::Bind(&IOThreadImpl::PostPendingEntries, this),
+        base::TimeDelta::FromMilliseconds(kNetLogEventDelayMilliseconds));
+    return;
+  }
+  SendPendingEntries();
+}
+
+void NetInternalsMessageHandler::IOThreadImpl::SendPendingEntries() {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
+  if (!pending_entries_.get())
+    return;
+  ListValue* entries = pending_entries_.release();
+  if (!BrowserThread::PostTask(
+      BrowserThread::UI, FROM_HERE,
+      base::Bind(&IOThreadImpl::SendEntriesOnUIThread, this, entries))) {
+    // Failed posting the task, avoid leaking.
+    delete entries;
+    return;
+  }
+  ++entries_in_flight_;
+}
+
+void NetInternalsMessageHandler::IOThreadImpl::SendEntriesOnUIThread(
+    ListValue* entries) {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
+  SendJavascriptCommand("receivedLogEntries", entries);
+  BrowserThread::PostTask(
+      BrowserThread::IO, FROM_HERE,
+      base::Bind(&IOThreadImpl::OnEntriesSent, this));
+}
+
+void NetInternalsMessageHandler::IOThreadImpl::OnEntriesSent() {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
+  DCHECK_GT(entries_in_flight_, 0);
+  --entries_in_flight_;
 }
 
 void NetInternalsMessageHandler::IOThreadImpl::PrePopulateEventList() {
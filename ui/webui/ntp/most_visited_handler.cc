@@ -54,6 +54,9 @@ using content::UserMetricsAction;
 
 MostVisitedHandler::MostVisitedHandler()
     : got_first_most_visited_request_(false),
+      last_sent_has_blacklisted_urls_(false),
+      pages_requested_(false),
+      creation_time_(base::TimeTicks::Now()),
       most_visited_viewed_(false),
       user_action_logged_(false),
       weak_ptr_factory_(this) {
@@ -133,6 +136,7 @@ void MostVisitedHandler::RegisterMessages() {
 }
 
 void MostVisitedHandler::HandleGetMostVisited(const ListValue* args) {
+  pages_requested_ = true;
   if (!got_first_most_visited_request_) {
     // If our initial data is already here, return it.
     SendPagesValue();
@@ -155,11 +159,27 @@ void MostVisitedHandler::SendPagesValue() {
       MaybeRemovePageValues();
     }
 
+    // TopSites changes often without changing the pages, for instance when a
+    // thumbnail is updated.
+    if (!pages_requested_ && last_sent_pages_value_ &&
+        last_sent_has_blacklisted_urls_ == has_blacklisted_urls &&
+        last_sent_pages_value_->Equals(pages_value_.get())) {
+      pages_value_.reset();
+      return;
+    }
+
+    if (!last_sent_pages_value_) {
+      UMA_HISTOGRAM_TIMES("NewTabPage.MostVisitedTime",
+                          base::TimeTicks::Now() - creation_time_);
+    }
+
     base::FundamentalValue has_blacklisted_urls_value(has_blacklisted_urls);
     web_ui()->CallJavascriptFunction("ntp.setMostVisitedPages",
                                      *pages_value_,
                                      has_blacklisted_urls_value);
-    pages_value_.reset();
+    last_sent_pages_value_ = pages_value_.Pass();
+    last_sent_has_blacklisted_urls_ = has_blacklisted_urls;
+    pages_requested_ = false;
   }
 }
 
@@ -9,6 +9,7 @@
 #include <vector>
 
 #include "base/memory/weak_ptr.h"
+#include "base/time/time.h"
 #include "chrome/browser/common/cancelable_request.h"
 #include "chrome/browser/history/history_types.h"
 #include "content/public/browser/notification_observer.h"
@@ -112,6 +113,19 @@ class MostVisitedHandler : public content::WebUIMessageHandler,
   // Keep the results of the db query here.
   scoped_ptr<base::ListValue> pages_value_;
 
+  // The pages last sent to the javascript side, and whether there were
+  // blacklisted URLs then. Unchanged pages are not sent again when TopSites
+  // changes, unless the page asked for them.
+  scoped_ptr<base::ListValue> last_sent_pages_value_;
+  bool last_sent_has_blacklisted_urls_;
+
+  // Whether the page asked for the pages with getMostVisited() since they were
+  // last sent.
+  bool pages_requested_;
+
+  // When the handler was created, to record how long the first pages took.
+  base::TimeTicks creation_time_;
+
   // Whether the user has viewed the 'most visited' pane.
   bool most_visited_viewed_;
 
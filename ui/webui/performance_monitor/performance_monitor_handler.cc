@@ -329,9 +329,18 @@ void DoGetMetrics(ListValue* results,
         db->GetMaxStatsForActivityAndMetric(*metric_type) * conversion_factor);
 
     // Retrieve all metrics in the database, and aggregate them into a series
-    // of points for each active interval.
-    scoped_ptr<Database::MetricVector> metric_vector =
-        db->GetStatsForActivityAndMetric(*metric_type, start, end);
+    // of points for each active interval. Means at a coarse enough resolution
+    // are computed from the rollups rather than from every metric.
+    scoped_ptr<Database::MetricVector> metric_vector;
+    if (aggregation_method == AGGREGATION_METHOD_MEAN &&
+        resolution >= base::TimeDelta::FromMinutes(
+            Database::kRollupIntervalMinutes)) {
+      metric_vector =
+          db->GetRollupStatsForActivityAndMetric(*metric_type, start, end);
+    } else {
+      metric_vector =
+          db->GetStatsForActivityAndMetric(*metric_type, start, end);
+    }
 
     scoped_ptr<VectorOfMetricVectors> aggregated_metrics =
         AggregateMetric(*metric_type,
@@ -0,0 +1,66 @@
+// Copyright 2013 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "chrome/browser/ui/webui/safe_browsing_internals/safe_browsing_internals_ui.h"
+
+#include "base/bind.h"
+#include "base/compiler_specific.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/values.h"
+#include "chrome/browser/profiles/profile.h"
+#include "chrome/browser/safe_browsing/update_profiler.h"
+#include "content/public/browser/web_ui.h"
+#include "content/public/browser/web_ui_data_source.h"
+#include "content/public/browser/web_ui_message_handler.h"
+#include "grit/browser_resources.h"
+
+const char kChromeUISafeBrowsingInternalsHost[] = "safe-browsing-internals";
+
+namespace {
+
+// Hands the recorded update cycles to the page when it asks for them.
+class SafeBrowsingInternalsHandler : public content::WebUIMessageHandler {
+ public:
+  SafeBrowsingInternalsHandler() {}
+  virtual ~SafeBrowsingInternalsHandler() {}
+
+  // WebUIMessageHandler implementation.
+  virtual void RegisterMessages() OVERRIDE {
+    web_ui()->RegisterMessageCallback(
+        "requestUpdateCycles",
+        base::Bind(&SafeBrowsingInternalsHandler::HandleRequestUpdateCycles,
+                   base::Unretained(this)));
+  }
+
+ private:
+  void HandleRequestUpdateCycles(const base::ListValue* args) {
+    scoped_ptr<base::ListValue> cycles(
+        SafeBrowsingUpdateProfiler::GetInstance()->GetCyclesAsValue());
+    web_ui()->CallJavascriptFunction("safeBrowsingInternals.onUpdateCycles",
+                                     *cycles);
+  }
+
+  DISALLOW_COPY_AND_ASSIGN(SafeBrowsingInternalsHandler);
+};
+
+}  // namespace
+
+SafeBrowsingInternalsUI::SafeBrowsingInternalsUI(content::WebUI* web_ui)
+    : content::WebUIController(web_ui) {
+  content::WebUIDataSource* html_source =
+      content::WebUIDataSource::Create(kChromeUISafeBrowsingInternalsHost);
+  html_source->SetDefaultResource(IDR_SAFE_BROWSING_INTERNALS_HTML);
+  html_source->AddResourcePath("safe_browsing_internals.css",
+                               IDR_SAFE_BROWSING_INTERNALS_CSS);
+  html_source->AddResourcePath("safe_browsing_internals.js",
+                               IDR_SAFE_BROWSING_INTERNALS_JS);
+
+  Profile* profile = Profile::FromWebUI(web_ui);
+  content::WebUIDataSource::Add(profile, html_source);
+
+  // AddMessageHandler takes ownership of SafeBrowsingInternalsHandler.
+  web_ui->AddMessageHandler(new SafeBrowsingInternalsHandler());
+}
+
+SafeBrowsingInternalsUI::~SafeBrowsingInternalsUI() {}
@@ -0,0 +1,25 @@
+// Copyright 2013 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CHROME_BROWSER_UI_WEBUI_SAFE_BROWSING_INTERNALS_SAFE_BROWSING_INTERNALS_UI_H_
+#define CHROME_BROWSER_UI_WEBUI_SAFE_BROWSING_INTERNALS_SAFE_BROWSING_INTERNALS_UI_H_
+
+#include "base/basictypes.h"
+#include "content/public/browser/web_ui_controller.h"
+
+// The host of chrome://safe-browsing-internals/.
+extern const char kChromeUISafeBrowsingInternalsHost[];
+
+// The UI for chrome://safe-browsing-internals/, which shows where the time
+// of the last safe browsing update cycles went.
+class SafeBrowsingInternalsUI : public content::WebUIController {
+ public:
+  explicit SafeBrowsingInternalsUI(content::WebUI* web_ui);
+  virtual ~SafeBrowsingInternalsUI();
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(SafeBrowsingInternalsUI);
+};
+
+#endif  // CHROME_BROWSER_UI_WEBUI_SAFE_BROWSING_INTERNALS_SAFE_BROWSING_INTERNALS_UI_H_
@@ -0,0 +1,109 @@
+// Copyright 2013 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "chrome/browser/ui/webui/webrequest_internals/webrequest_internals_ui.h"
+
+#include <string>
+
+#include "base/bind.h"
+#include "base/compiler_specific.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/memory/weak_ptr.h"
+#include "base/values.h"
+#include "chrome/browser/extensions/api/web_request/web_request_api.h"
+#include "chrome/browser/extensions/extension_service.h"
+#include "chrome/browser/extensions/extension_system.h"
+#include "chrome/browser/profiles/profile.h"
+#include "chrome/common/extensions/extension.h"
+#include "content/public/browser/browser_thread.h"
+#include "content/public/browser/web_ui.h"
+#include "content/public/browser/web_ui_data_source.h"
+#include "content/public/browser/web_ui_message_handler.h"
+#include "grit/browser_resources.h"
+
+using content::BrowserThread;
+
+const char kChromeUIWebRequestInternalsHost[] = "webrequest-internals";
+
+namespace {
+
+base::ListValue* GetExtensionDelaysOnIO() {
+  return ExtensionWebRequestEventRouter::GetInstance()->
+      GetExtensionDelaysAsValue();
+}
+
+// Hands the recent delays of each extension to the page when it asks for
+// them. The delays are kept on the IO thread by the webRequest event router.
+class WebRequestInternalsHandler : public content::WebUIMessageHandler {
+ public:
+  WebRequestInternalsHandler() : weak_ptr_factory_(this) {}
+  virtual ~WebRequestInternalsHandler() {}
+
+  // WebUIMessageHandler implementation.
+  virtual void RegisterMessages() OVERRIDE {
+    web_ui()->RegisterMessageCallback(
+        "requestExtensionDelays",
+        base::Bind(&WebRequestInternalsHandler::HandleRequestExtensionDelays,
+                   base::Unretained(this)));
+  }
+
+ private:
+  // Takes ownership of |delays|, which is deleted even if |handler| is gone.
+  static void OnExtensionDelays(
+      base::WeakPtr<WebRequestInternalsHandler> handler,
+      base::ListValue* delays) {
+    scoped_ptr<base::ListValue> owned_delays(delays);
+    if (handler.get())
+      handler->SendExtensionDelays(owned_delays.get());
+  }
+
+  void HandleRequestExtensionDelays(const base::ListValue* args) {
+    BrowserThread::PostTaskAndReplyWithResult(
+        BrowserThread::IO,
+        FROM_HERE,
+        base::Bind(&GetExtensionDelaysOnIO),
+        base::Bind(&WebRequestInternalsHandler::OnExtensionDelays,
+                   weak_ptr_factory_.GetWeakPtr()));
+  }
+
+  // Adds the names of the extensions to |delays| and sends them to the page.
+  void SendExtensionDelays(base::ListValue* delays) {
+    ExtensionService* service = extensions::ExtensionSystem::Get(
+        Profile::FromWebUI(web_ui()))->extension_service();
+    for (size_t i = 0; i < delays->GetSize(); ++i) {
+      base::DictionaryValue* delay = NULL;
+      std::string id;
+      if (!delays->GetDictionary(i, &delay) || !delay->GetString("id", &id))
+        continue;
+      const extensions::Extension* extension =
+          service ? service->GetExtensionById(id, true) : NULL;
+      delay->SetString("name", extension ? extension->name() : id);
+    }
+    web_ui()->CallJavascriptFunction(
+        "webRequestInternals.onExtensionDelays", *delays);
+  }
+
+  base::WeakPtrFactory<WebRequestInternalsHandler> weak_ptr_factory_;
+
+  DISALLOW_COPY_AND_ASSIGN(WebRequestInternalsHandler);
+};
+
+}  // namespace
+
+WebRequestInternalsUI::WebRequestInternalsUI(content::WebUI* web_ui)
+    : content::WebUIController(web_ui) {
+  content::WebUIDataSource* html_source =
+      content::WebUIDataSource::Create(kChromeUIWebRequestInternalsHost);
+  html_source->SetDefaultResource(IDR_WEBREQUEST_INTERNALS_HTML);
+  html_source->AddResourcePath("webrequest_internals.js",
+                               IDR_WEBREQUEST_INTERNALS_JS);
+
+  Profile* profile = Profile::FromWebUI(web_ui);
+  content::WebUIDataSource::Add(profile, html_source);
+
+  // AddMessageHandler takes ownership of WebRequestInternalsHandler.
+  web_ui->AddMessageHandler(new WebRequestInternalsHandler());
+}
+
+WebRequestInternalsUI::~WebRequestInternalsUI() {}
@@ -0,0 +1,25 @@
+// Copyright 2013 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CHROME_BROWSER_UI_WEBUI_WEBREQUEST_INTERNALS_WEBREQUEST_INTERNALS_UI_H_
+#define CHROME_BROWSER_UI_WEBUI_WEBREQUEST_INTERNALS_WEBREQUEST_INTERNALS_UI_H_
+
+#include "base/basictypes.h"
+#include "content/public/browser/web_ui_controller.h"
+
+// The host of chrome://webrequest-internals/.
+extern const char kChromeUIWebRequestInternalsHost[];
+
+// The UI for chrome://webrequest-internals/, which shows how long the
+// extensions using the blocking webRequest API recently delayed requests.
+class WebRequestInternalsUI : public content::WebUIController {
+ public:
+  explicit WebRequestInternalsUI(content::WebUI* web_ui);
+  virtual ~WebRequestInternalsUI();
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(WebRequestInternalsUI);
+};
+
+#endif  // CHROME_BROWSER_UI_WEBUI_WEBREQUEST_INTERNALS_WEBREQUEST_INTERNALS_UI_H_
@@ -410,13 +410,17 @@ bool NotificationPromo::CheckAppLauncher() const {
 }
 
 bool NotificationPromo::CanShow() const {
-  return !closed_ &&
-         !promo_text_.empty() &&
-         !ExceedsMaxGroup() &&
-         !ExceedsMaxViews() &&
-         CheckAppLauncher() &&
-         base::Time::FromDoubleT(StartTimeForGroup()) < base::Time::Now() &&
-         base::Time::FromDoubleT(EndTime()) > base::Time::Now();
+  if (closed_ || promo_text_.empty() || ExceedsMaxGroup() ||
+      ExceedsMaxViews()) {
+    return false;
+  }
+
+  // Check the time window against a single time, so that a promo ending
+  // right now can't be found both started and not yet ended.
+  const base::Time now = base::Time::Now();
+  return base::Time::FromDoubleT(StartTimeForGroup()) < now &&
+         base::Time::FromDoubleT(EndTime()) > now &&
+         CheckAppLauncher();
 }
 
 // static
@@ -7,6 +7,7 @@
 #include "base/bind.h"
 #include "base/files/file_path.h"
 #include "chrome/browser/browser_process.h"
+#include "chrome/browser/performance_monitor/startup_tracer.h"
 #include "chrome/browser/profiles/incognito_helpers.h"
 #include "chrome/browser/sync/glue/sync_start_util.h"
 #include "chrome/browser/ui/profile_error_dialog.h"
@@ -228,6 +229,8 @@ content::BrowserContext* WebDataServiceFactory::GetBrowserContextToUse(
 
 BrowserContextKeyedService* WebDataServiceFactory::BuildServiceInstanceFor(
     content::BrowserContext* profile) const {
+  performance_monitor::ScopedStartupPhase startup_phase(
+      "WebDataServiceFactory::BuildServiceInstanceFor");
   return new WebDataServiceWrapper(static_cast<Profile*>(profile));
 }
 